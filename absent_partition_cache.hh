@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <variant>
+
+#include "dht/i_partitioner.hh"
+#include "utils/allocation_strategy.hh"
+#include "utils/two_choice_cache.hh"
+
+// Remembers the keys of partitions which a row_cache found to be absent in
+// its underlying source, so that reading them again doesn't go to sstables
+// after the cache evicted that information.
+//
+// Holds up to a fixed number of keys, each of which can be in one of two slots
+// picked from its token, see utils::two_choice_cache. Inserting a key when both
+// slots are taken replaces the key which was inserted earlier. Keys are compared
+// exactly, so a partition is never reported absent unless it was inserted.
+//
+// Doesn't know about the underlying source, the owner must erase keys which may
+// have been written to it. Keys live in the standard allocator.
+class absent_partition_cache {
+    utils::two_choice_cache<dht::decorated_key, std::monostate> _keys;
+private:
+    static uint64_t hash_of(const dht::decorated_key& dk) noexcept {
+        return dk.token().raw();
+    }
+
+    static auto key_equal(const schema& s, const dht::decorated_key& dk) noexcept {
+        return [&s, &dk] (const dht::decorated_key& k) { return k.equal(s, dk); };
+    }
+public:
+    // capacity is rounded up to a power of two, 0 disables the cache.
+    explicit absent_partition_cache(size_t capacity) noexcept
+        : _keys(capacity)
+    { }
+
+    bool contains(const schema& s, const dht::decorated_key& dk) const noexcept {
+        return _keys.find(hash_of(dk), key_equal(s, dk));
+    }
+
+    // Best effort, the key is not inserted if memory can't be allocated for it.
+    void insert(const schema& s, const dht::decorated_key& dk) noexcept {
+        if (!_keys.enabled() || contains(s, dk)) {
+            return;
+        }
+        try {
+            with_allocator(standard_allocator(), [&] {
+                _keys.insert(hash_of(dk), key_equal(s, dk), dk, std::monostate{});
+            });
+        } catch (...) {
+            // Not remembering the key is fine.
+        }
+    }
+
+    void erase(const schema& s, const dht::decorated_key& dk) noexcept {
+        with_allocator(standard_allocator(), [&] {
+            _keys.erase(hash_of(dk), key_equal(s, dk));
+        });
+    }
+
+    void erase(const schema& s, const dht::partition_range& range) noexcept {
+        dht::ring_position_comparator cmp(s);
+        auto start = dht::ring_position_view::for_range_start(range);
+        auto end = dht::ring_position_view::for_range_end(range);
+        with_allocator(standard_allocator(), [&] {
+            _keys.erase_if([&] (const auto& e) {
+                return cmp(start, e.key) <= 0 && cmp(e.key, end) < 0;
+            });
+        });
+    }
+
+    void clear() noexcept {
+        with_allocator(standard_allocator(), [&] {
+            _keys.clear();
+        });
+    }
+
+    size_t size() const noexcept {
+        return _keys.size();
+    }
+};
@@ -42,6 +42,10 @@ namespace qos {
 class service_level_controller;
 }
 
+namespace netw {
+class messaging_service;
+}
+
 namespace alternator {
 
 // This is the official DynamoDB API version.
@@ -63,6 +67,7 @@ class controller : public protocol_server {
     sharded<service::memory_limiter>& _memory_limiter;
     sharded<auth::service>& _auth_service;
     sharded<qos::service_level_controller>& _sl_controller;
+    sharded<netw::messaging_service>& _ms;
     const db::config& _config;
 
     std::vector<socket_address> _listen_addresses;
@@ -80,6 +85,7 @@ class controller : public protocol_server {
         sharded<service::memory_limiter>& memory_limiter,
         sharded<auth::service>& auth_service,
         sharded<qos::service_level_controller>& sl_controller,
+        sharded<netw::messaging_service>& ms,
         const db::config& config);
 
     virtual sstring name() const override;
@@ -18,6 +18,7 @@
 #include "exceptions/exceptions.hh"
 #include "timestamp.hh"
 #include "types/map.hh"
+#include "types/listlike_partial_deserializing_iterator.hh"
 #include "schema/schema.hh"
 #include "query-request.hh"
 #include "query-result-reader.hh"
@@ -51,10 +52,20 @@
 #include <unordered_set>
 #include "service/storage_proxy.hh"
 #include "gms/gossiper.hh"
+#include "gms/feature_service.hh"
 #include "schema/schema_registry.hh"
 #include "utils/error_injection.hh"
 #include "db/schema_tables.hh"
 #include "utils/rjson.hh"
+#include "replica/database.hh"
+#include "locator/abstract_replication_strategy.hh"
+#include <seastar/coroutine/parallel_for_each.hh>
+#include <seastar/util/defer.hh>
+#include "message/messaging_service.hh"
+#include "idl/alternator.dist.hh"
+#include "tracing/trace_state.hh"
+#include "tracing/tracing.hh"
+#include "utils/fb_utilities.hh"
 
 using namespace std::chrono_literals;
 
@@ -75,6 +86,36 @@ static const column_definition& attrs_column(const schema& schema) {
     return *cdef;
 }
 
+// Whether cdef is a column of the attributes listed in the table's
+// PROMOTED_ATTRIBUTES_TAG_KEY tag. Like ATTRS_COLUMN_NAME, it's a map column
+// of serialized attributes, which holds just that attribute.
+static bool is_promoted_column(const column_definition& cdef) {
+    return cdef.is_regular() && cdef.type->is_map() && cdef.name() != executor::ATTRS_COLUMN_NAME;
+}
+
+// Whether the items read into the given columns may have attributes in more
+// than one map column, that is when the table has promoted attributes.
+static bool has_promoted_columns(const std::vector<const column_definition*>& columns) {
+    return std::any_of(columns.begin(), columns.end(), [] (const column_definition* cdef) {
+        return is_promoted_column(*cdef);
+    });
+}
+
+// Adds to item the attribute attr_name, read from the map column cdef. The
+// items written before the attribute was promoted keep it in
+// ATTRS_COLUMN_NAME until it's written again, and the value read from its
+// own column, if any, is the current one.
+static void add_map_attribute(rjson::value& item, const column_definition& cdef, std::string_view attr_name, rjson::value&& v, bool promoted_columns) {
+    if (!promoted_columns) {
+        // attribute names are unique so add() makes sense
+        rjson::add_with_string_name(item, attr_name, std::move(v));
+    } else if (is_promoted_column(cdef)) {
+        rjson::replace_with_string_name(item, attr_name, std::move(v));
+    } else if (!rjson::find(item, attr_name)) {
+        rjson::add_with_string_name(item, attr_name, std::move(v));
+    }
+}
+
 make_jsonable::make_jsonable(rjson::value&& value)
     : _value(std::move(value))
 {}
@@ -107,6 +148,29 @@ json::json_return_type make_streamed(rjson::value&& value) {
     return func;
 }
 
+json::json_return_type make_streamed(rjson::chunked_content&& content) {
+    auto rs = make_shared<rjson::chunked_content>(std::move(content));
+    std::function<future<>(output_stream<char>&&)> func = [rs](output_stream<char>&& os) mutable -> future<> {
+        // move objects to coroutine frame.
+        auto los = std::move(os);
+        auto lrs = std::move(rs);
+        try {
+            for (auto& buf : *lrs) {
+                co_await los.write(buf.get(), buf.size());
+            }
+            co_await los.flush();
+            co_await los.close();
+        } catch (...) {
+            // As above, HTTP headers and a portion of the content were
+            // possibly written already.
+            elogger.error("Unhandled exception in data streaming: {}", std::current_exception());
+            throw;
+        }
+        co_return;
+    };
+    return func;
+}
+
 json_string::json_string(std::string&& value)
     : _value(std::move(value))
 {}
@@ -679,6 +743,7 @@ static const std::unordered_set<std::string_view> allowed_write_isolation_values
     "a", "always", "always_use_lwt",
     "o", "only_rmw_uses_lwt",
     "u", "unsafe", "unsafe_rmw",
+    "l", "leader", "leader_rmw",
 };
 
 static void validate_tags(const std::map<sstring, sstring>& tags) {
@@ -703,6 +768,8 @@ static rmw_operation::write_isolation parse_write_isolation(std::string_view val
             return rmw_operation::write_isolation::LWT_RMW_ONLY;
         case 'u':
             return rmw_operation::write_isolation::UNSAFE_RMW;
+        case 'l':
+            return rmw_operation::write_isolation::LEADER_RMW;
         }
     }
     // Shouldn't happen as validate_tags() / set_default_write_isolation()
@@ -710,6 +777,17 @@ static rmw_operation::write_isolation parse_write_isolation(std::string_view val
     return rmw_operation::default_write_isolation;
 
 }
+
+// The leaders of items of tables using the LEADER_RMW write isolation
+// policy can only run their RMW operations once all nodes know the
+// ALTERNATOR_LEADER_RMW verb.
+static void check_write_isolation_supported(const std::map<sstring, sstring>& tags, const gms::feature_service& features) {
+    auto it = tags.find(rmw_operation::WRITE_ISOLATION_TAG_KEY);
+    if (it != tags.end() && parse_write_isolation(it->second) == rmw_operation::write_isolation::LEADER_RMW
+            && !features.alternator_leader_rmw) {
+        throw api_error::validation("The leader_rmw write isolation policy cannot be used until all nodes of the cluster support it");
+    }
+}
 // This default_write_isolation is always overwritten in main.cc, which calls
 // set_default_write_isolation().
 rmw_operation::write_isolation rmw_operation::default_write_isolation =
@@ -766,6 +844,71 @@ const std::map<sstring, sstring>& get_tags_of_table_or_throw(schema_ptr schema)
     }
 }
 
+static std::vector<std::string_view> promoted_attributes(const std::map<sstring, sstring>& tags) {
+    std::vector<std::string_view> ret;
+    auto it = tags.find(executor::PROMOTED_ATTRIBUTES_TAG_KEY);
+    if (it != tags.end()) {
+        std::string_view value = it->second;
+        while (!value.empty()) {
+            auto end = std::min(value.find(' '), value.size());
+            if (end) {
+                ret.push_back(value.substr(0, end));
+            }
+            value.remove_prefix(std::min(end + 1, value.size()));
+        }
+    }
+    return ret;
+}
+
+bool is_promoted_attribute(const std::map<sstring, sstring>& tags, std::string_view attribute_name) {
+    return std::ranges::count(promoted_attributes(tags), attribute_name);
+}
+
+// Adds to builder, the builder of the schema s with the given tags, the
+// columns of the attributes newly listed in its PROMOTED_ATTRIBUTES_TAG_KEY
+// tag, and returns the schemas of its views with them added, since the
+// views have all the regular columns of their base table.
+static std::vector<view_ptr> add_promoted_attribute_columns(const schema& s, const std::vector<view_ptr>& views,
+        const std::map<sstring, sstring>& tags, schema_builder& builder) {
+    auto names = promoted_attributes(tags);
+    for (const column_definition& cdef : s.regular_columns()) {
+        if (is_promoted_column(cdef) && !std::ranges::count(names, std::string_view(cdef.name_as_text()))) {
+            throw api_error::validation(format("Promoted attribute {} can't be removed from the {} tag",
+                    cdef.name_as_text(), executor::PROMOTED_ATTRIBUTES_TAG_KEY));
+        }
+    }
+    auto ttl = tags.find(executor::TTL_TAG_KEY);
+    std::vector<bytes> added;
+    for (auto name : names) {
+        if (ttl != tags.end() && ttl->second == name) {
+            throw api_error::validation(format("The TTL attribute {} can't be promoted", name));
+        }
+        bytes column_name = to_bytes(name);
+        const column_definition* cdef = s.get_column_definition(column_name);
+        if (!cdef) {
+            if (std::ranges::count(added, column_name)) {
+                throw api_error::validation(format("Duplicate promoted attribute {}", name));
+            }
+            builder.with_column(column_name, attrs_type(), column_kind::regular_column);
+            added.push_back(std::move(column_name));
+        } else if (!is_promoted_column(*cdef)) {
+            throw api_error::validation(format("Attribute {} is a key attribute of the table or of one of its indexes and can't be promoted", name));
+        }
+    }
+    std::vector<view_ptr> view_updates;
+    if (added.empty()) {
+        return view_updates;
+    }
+    for (const view_ptr& v : views) {
+        schema_builder view_builder(v);
+        for (const bytes& column_name : added) {
+            view_builder.with_column(column_name, attrs_type(), column_kind::regular_column);
+        }
+        view_updates.push_back(view_ptr(view_builder.build()));
+    }
+    return view_updates;
+}
+
 future<executor::request_return_type> executor::tag_resource(client_state& client_state, service_permit permit, rjson::value request) {
     _stats.api_operations.tag_resource++;
 
@@ -781,9 +924,10 @@ future<executor::request_return_type> executor::tag_resource(client_state& clien
     if (tags->Size() < 1) {
         co_return api_error::validation("The number of tags must be at least 1") ;
     }
-    co_await db::modify_tags(_mm, schema->ks_name(), schema->cf_name(), [tags](std::map<sstring, sstring>& tags_map) {
+    co_await db::modify_tags(_mm, schema->ks_name(), schema->cf_name(), [tags, &features = _proxy.features()](std::map<sstring, sstring>& tags_map) {
         update_tags_map(*tags, tags_map, update_tags_action::add_tags);
-    });
+        check_write_isolation_supported(tags_map, features);
+    }, add_promoted_attribute_columns);
     co_return json_string("");
 }
 
@@ -803,7 +947,7 @@ future<executor::request_return_type> executor::untag_resource(client_state& cli
 
     co_await db::modify_tags(_mm, schema->ks_name(), schema->cf_name(), [tags](std::map<sstring, sstring>& tags_map) {
         update_tags_map(*tags, tags_map, update_tags_action::delete_tags);
-    });
+    }, add_promoted_attribute_columns);
     co_return json_string("");
 }
 
@@ -1035,7 +1179,9 @@ static future<executor::request_return_type> create_table_on_shard0(tracing::tra
     std::map<sstring, sstring> tags_map;
     if (tags && tags->IsArray()) {
         update_tags_map(*tags, tags_map, update_tags_action::add_tags);
+        check_write_isolation_supported(tags_map, sp.features());
     }
+    add_promoted_attribute_columns(*builder.build(), {}, tags_map, builder);
     builder.add_extension(db::tags_extension::NAME, ::make_shared<db::tags_extension>(tags_map));
 
     schema_ptr schema = builder.build();
@@ -1201,6 +1347,20 @@ class attribute_collector {
     }
 };
 
+// Writes the serialized value of the attribute of the promoted column cdef.
+static void put_promoted_attribute(row& cells, const column_definition& cdef, const bytes& value, api::timestamp_type ts) {
+    collection_mutation_description mut;
+    mut.cells.emplace_back(cdef.name(), atomic_cell::make_live(*bytes_type, ts, value, atomic_cell::collection_member::yes));
+    cells.apply(cdef, mut.serialize(*cdef.type));
+}
+
+// Deletes the attribute of the promoted column cdef.
+static void delete_promoted_attribute(row& cells, const column_definition& cdef, api::timestamp_type ts) {
+    collection_mutation_description mut;
+    mut.tomb = tombstone(ts, gc_clock::now());
+    cells.apply(cdef, mut.serialize(*cdef.type));
+}
+
 // After calling pk_from_json() and ck_from_json() to extract the pk and ck
 // components of a key, and if that succeeded, call check_key() to further
 // check that the key doesn't have any spurious components.
@@ -1281,10 +1441,11 @@ put_or_delete_item::put_or_delete_item(const rjson::value& key, schema_ptr schem
 }
 
 // find_attribute() checks whether the named attribute is stored in the
-// schema as a real column (we do this for key attribute, and for a GSI key)
-// and if so, returns that column. If not, the function returns nullptr,
-// telling the caller that the attribute is stored serialized in the
-// ATTRS_COLUMN_NAME map - not in a stand-alone column in the schema.
+// schema as a real column (we do this for key attribute, and for a GSI key,
+// and for promoted attributes, see is_promoted_column()) and if so, returns
+// that column. If not, the function returns nullptr, telling the caller that
+// the attribute is stored serialized in the ATTRS_COLUMN_NAME map - not in a
+// stand-alone column in the schema.
 static inline const column_definition* find_attribute(const schema& schema, const bytes& attribute_name) {
     const column_definition* cdef = schema.get_column_definition(attribute_name);
     // Although ATTRS_COLUMN_NAME exists as an actual column, when used as an
@@ -1304,8 +1465,7 @@ put_or_delete_item::put_or_delete_item(const rjson::value& item, schema_ptr sche
         bytes column_name = to_bytes(it->name.GetString());
         validate_value(it->value, "PutItem");
         const column_definition* cdef = find_attribute(*schema, column_name);
-        if (!cdef) {
-            bytes value = serialize_item(it->value);
+        if (!cdef || is_promoted_column(*cdef)) {
             _cells->push_back({std::move(column_name), serialize_item(it->value)});
         } else if (!cdef->is_primary_key()) {
             // Fixed-type regular column can be used for GSI key
@@ -1338,6 +1498,8 @@ mutation put_or_delete_item::build(schema_ptr schema, api::timestamp_type ts) co
         const column_definition* cdef = find_attribute(*schema, c.column_name);
         if (!cdef) {
             attrs_collector.put(c.column_name, c.value, ts);
+        } else if (is_promoted_column(*cdef)) {
+            put_promoted_attribute(row.cells(), *cdef, c.value, ts);
         } else {
             row.cells().apply(*cdef, atomic_cell::make_live(*cdef->type, ts, std::move(c.value)));
         }
@@ -1460,6 +1622,10 @@ std::optional<mutation> rmw_operation::apply(foreign_ptr<lw_shared_ptr<query::re
     return apply(std::unique_ptr<rjson::value>(), ts);
 }
 
+dht::token rmw_operation::token() const {
+    return dht::get_token(*_schema, _pk);
+}
+
 rmw_operation::write_isolation rmw_operation::get_write_isolation_for_schema(schema_ptr schema) {
     const auto& tags = get_tags_of_table_or_throw(schema);
     auto it = tags.find(WRITE_ISOLATION_TAG_KEY);
@@ -1473,6 +1639,9 @@ rmw_operation::write_isolation rmw_operation::get_write_isolation_for_schema(sch
 // other shard. Running execute() on a specific shard is necessary only if it
 // will use LWT (storage_proxy::cas()). This is because cas() can only be
 // called on the specific shard owning (as per cas_shard()) _pk's token.
+// The same goes for RMW operations of the LEADER_RMW policy, which the
+// leader of the item runs on that shard, and which are forwarded to the
+// leader from that shard.
 // Knowing if execute() will call cas() or not may depend on whether there is
 // a read-before-write, but not just on it - depending on configuration,
 // execute() may unconditionally use cas() for every write. Unfortunately,
@@ -1480,12 +1649,13 @@ rmw_operation::write_isolation rmw_operation::get_write_isolation_for_schema(sch
 std::optional<shard_id> rmw_operation::shard_for_execute(bool needs_read_before_write) {
     if (_write_isolation == write_isolation::FORBID_RMW ||
         (_write_isolation == write_isolation::LWT_RMW_ONLY && !needs_read_before_write) ||
+        (_write_isolation == write_isolation::LEADER_RMW && !needs_read_before_write) ||
         _write_isolation == write_isolation::UNSAFE_RMW) {
         return {};
     }
     // If we're still here, cas() *will* be called by execute(), so let's
     // find the appropriate shard to run it on:
-    auto token = dht::get_token(*_schema, _pk);
+    auto token = this->token();
     auto desired_shard = service::storage_proxy::cas_shard(*_schema, token);
     if (desired_shard == this_shard_id()) {
         return {};
@@ -1530,12 +1700,83 @@ static future<std::unique_ptr<rjson::value>> get_previous_item(
     });
 }
 
-future<executor::request_return_type> rmw_operation::execute(service::storage_proxy& proxy,
+future<bool> rmw_operation::execute_on_leader(executor& exec,
+        service::client_state& client_state,
+        tracing::trace_state_ptr trace_state,
+        service_permit permit) {
+    exec._stats.write_on_leader++;
+    auto timeout = executor::default_timeout();
+    auto dk = dht::decorate_key(*_schema, _pk);
+    auto& locker = exec._leader_rmw_lockers.try_emplace(_schema->id(), _schema).first->second;
+    locker.upgrade(_schema);
+    row_locker::lock_holder lock;
+    auto drop_locker = defer([&] () noexcept {
+        lock = {};
+        auto it = exec._leader_rmw_lockers.find(_schema->id());
+        if (it != exec._leader_rmw_lockers.end() && it->second.empty()) {
+            exec._leader_rmw_lockers.erase(it);
+        }
+    });
+    // The locker isn't empty, and so isn't dropped, while the lock is
+    // waited for or held.
+    lock = co_await locker.lock_ck(dk, _ck, true, timeout, exec._leader_rmw_lock_stats);
+    auto previous_item = co_await get_previous_item(exec._proxy, client_state, schema(), _pk, _ck, permit, exec._stats);
+    auto ts = std::max(api::new_timestamp(), exec._last_leader_rmw_timestamp + 1);
+    std::optional<mutation> m = apply(std::move(previous_item), ts);
+    if (!m) {
+        co_return false;
+    }
+    exec._last_leader_rmw_timestamp = ts;
+    co_await exec._proxy.mutate(std::vector<mutation>{std::move(*m)}, db::consistency_level::LOCAL_QUORUM, timeout, trace_state, std::move(permit), db::allow_per_partition_rate_limit::yes);
+    co_return true;
+}
+
+// The leader of an item is the first of its natural replicas in the local
+// data center, so that all coordinators of the data center agree on it for
+// as long as the replicas of the item don't change.
+static std::optional<gms::inet_address> leader_of(service::storage_proxy& proxy, const schema& schema, dht::token token) {
+    auto erm = proxy.local_db().find_keyspace(schema.ks_name()).get_effective_replication_map();
+    auto is_local = erm->get_topology().get_local_dc_filter();
+    for (auto& ep : erm->get_natural_endpoints(token)) {
+        if (is_local(ep)) {
+            return ep;
+        }
+    }
+    return std::nullopt;
+}
+
+future<executor::request_return_type> rmw_operation::execute_with_leader(executor& exec,
+        service::client_state& client_state,
+        tracing::trace_state_ptr trace_state,
+        service_permit permit) {
+    auto leader = leader_of(exec._proxy, *_schema, token());
+    if (!leader) {
+        co_return api_error::internal("No replica of the item in the local data center can run its read-modify-write operation");
+    }
+    if (*leader == utils::fb_utilities::get_broadcast_address()) {
+        if (!co_await execute_on_leader(exec, client_state, trace_state, std::move(permit))) {
+            co_return api_error::conditional_check_failed("Failed condition.");
+        }
+        co_return co_await rmw_operation_return(std::move(_return_attributes));
+    }
+    exec._stats.write_forwarded_to_leader++;
+    tracing::trace(trace_state, "Forwarding {} to leader {}", operation_name(), *leader);
+    auto&& [attributes, error_type, error_message, http_code] = co_await ser::alternator_rpc_verbs::send_alternator_leader_rmw(
+            &exec._ms, netw::msg_addr(*leader), executor::default_timeout(),
+            sstring(operation_name()), sstring(rjson::print(_request)), tracing::make_trace_info(trace_state));
+    if (!error_type.empty()) {
+        co_return api_error(std::move(error_type), std::move(error_message), api_error::status_type(http_code));
+    }
+    co_return co_await rmw_operation_return(attributes.empty() ? rjson::value() : rjson::parse(attributes));
+}
+
+future<executor::request_return_type> rmw_operation::execute(executor& exec,
         service::client_state& client_state,
         tracing::trace_state_ptr trace_state,
         service_permit permit,
-        bool needs_read_before_write,
-        stats& stats) {
+        bool needs_read_before_write) {
+    auto& proxy = exec._proxy;
+    auto& stats = exec._stats;
     if (needs_read_before_write) {
         if (_write_isolation == write_isolation::FORBID_RMW) {
             throw api_error::validation("Read-modify-write operations are disabled by 'forbid_rmw' write isolation policy. Refer to https://github.com/scylladb/scylla/blob/master/docs/alternator/alternator.md#write-isolation-policies for more information.");
@@ -1555,6 +1796,9 @@ future<executor::request_return_type> rmw_operation::execute(service::storage_pr
                 });
             });
         }
+        if (_write_isolation == write_isolation::LEADER_RMW) {
+            return execute_with_leader(exec, client_state, std::move(trace_state), std::move(permit));
+        }
     } else if (_write_isolation != write_isolation::LWT_ALWAYS) {
         std::optional<mutation> m = apply(nullptr, api::new_timestamp());
         assert(m); // !needs_read_before_write, so apply() did not check a condition
@@ -1675,6 +1919,9 @@ class put_item_operation : public rmw_operation {
         }
         return _mutation_builder.build(_schema, ts);
     }
+    virtual std::string_view operation_name() const override {
+        return "PutItem";
+    }
     virtual ~put_item_operation() = default;
 };
 
@@ -1702,7 +1949,7 @@ future<executor::request_return_type> executor::put_item(client_state& client_st
             });
         });
     }
-    return op->execute(_proxy, client_state, trace_state, std::move(permit), needs_read_before_write, _stats).finally([op, start_time, this] {
+    return op->execute(*this, client_state, trace_state, std::move(permit), needs_read_before_write).finally([op, start_time, this] {
         _stats.api_operations.put_item_latency.add(std::chrono::steady_clock::now() - start_time);
     });
 }
@@ -1760,6 +2007,9 @@ class delete_item_operation : public rmw_operation {
         }
         return _mutation_builder.build(_schema, ts);
     }
+    virtual std::string_view operation_name() const override {
+        return "DeleteItem";
+    }
     virtual ~delete_item_operation() = default;
 };
 
@@ -1787,7 +2037,7 @@ future<executor::request_return_type> executor::delete_item(client_state& client
             });
         });
     }
-    return op->execute(_proxy, client_state, trace_state, std::move(permit), needs_read_before_write, _stats).finally([op, start_time, this] {
+    return op->execute(*this, client_state, trace_state, std::move(permit), needs_read_before_write).finally([op, start_time, this] {
         _stats.api_operations.delete_item_latency.add(std::chrono::steady_clock::now() - start_time);
     });
 }
@@ -1893,11 +2143,21 @@ static future<> do_batch_write(service::storage_proxy& proxy,
     });
     if (!needs_lwt) {
         // Do a normal write, without LWT:
+        // Items of the same partition are joined in one mutation, so that
+        // they are sent to its replicas, and applied there, together.
         std::vector<mutation> mutations;
         mutations.reserve(mutation_builders.size());
+        std::unordered_map<schema_decorated_key, size_t, schema_decorated_key_hash, schema_decorated_key_equal>
+            key_mutations(mutation_builders.size(), schema_decorated_key_hash{}, schema_decorated_key_equal{});
         api::timestamp_type now = api::new_timestamp();
         for (auto& b : mutation_builders) {
-            mutations.push_back(b.second.build(b.first, now));
+            mutation m = b.second.build(b.first, now);
+            auto [it, added] = key_mutations.try_emplace(schema_decorated_key{b.first, m.decorated_key()}, mutations.size());
+            if (added) {
+                mutations.push_back(std::move(m));
+            } else {
+                mutations[it->second].apply(std::move(m));
+            }
         }
         return proxy.mutate(std::move(mutations),
                 db::consistency_level::LOCAL_QUORUM,
@@ -2306,10 +2566,11 @@ void executor::describe_single_item(const cql3::selection::selection& selection,
     bool include_all_embedded_attributes) 
 {
     const auto& columns = selection.get_columns();
+    const bool promoted_columns = has_promoted_columns(columns);
     auto column_it = columns.begin();
     for (const bytes_opt& cell : result_row) {
         std::string column_name = (*column_it)->name_as_text();
-        if (cell && column_name != executor::ATTRS_COLUMN_NAME) {
+        if (cell && column_name != executor::ATTRS_COLUMN_NAME && !is_promoted_column(**column_it)) {
             if (!attrs_to_get || attrs_to_get->contains(column_name)) {
                 // item is expected to start empty, and column_name are unique
                 // so add() makes sense
@@ -2336,9 +2597,7 @@ void executor::describe_single_item(const cql3::selection::selection& selection,
                             }
                         }
                     }
-                    // item is expected to start empty, and attribute
-                    // names are unique so add() makes sense
-                    rjson::add_with_string_name(item, attr_name, std::move(v));
+                    add_map_attribute(item, **column_it, attr_name, std::move(v), promoted_columns);
                 }
             }
         }
@@ -2444,6 +2703,9 @@ class update_item_operation  : public rmw_operation {
     parsed::condition_expression _condition_expression;
 
     update_item_operation(service::storage_proxy& proxy, rjson::value&& request);
+    virtual std::string_view operation_name() const override {
+        return "UpdateItem";
+    }
     virtual ~update_item_operation() = default;
     virtual std::optional<mutation> apply(std::unique_ptr<rjson::value> previous_item, api::timestamp_type ts) const override;
     bool needs_read_before_write() const;
@@ -2791,7 +3053,11 @@ update_item_operation::apply(std::unique_ptr<rjson::value> previous_item, api::t
             }
         }
         const column_definition* cdef = find_attribute(*_schema, column_name);
-        if (cdef) {
+        if (cdef && is_promoted_column(*cdef)) {
+            put_promoted_attribute(row.cells(), *cdef, serialize_item(json_value), ts);
+            // Deletes the value of items written before the promotion.
+            attrs_collector.del(std::move(column_name), ts);
+        } else if (cdef) {
             bytes column_value = get_key_from_typed_value(json_value, *cdef);
             row.cells().apply(*cdef, atomic_cell::make_live(*cdef->type, ts, column_value));
         } else {
@@ -2813,7 +3079,10 @@ update_item_operation::apply(std::unique_ptr<rjson::value> previous_item, api::t
             }
         }
         const column_definition* cdef = find_attribute(*_schema, column_name);
-        if (cdef) {
+        if (cdef && is_promoted_column(*cdef)) {
+            delete_promoted_attribute(row.cells(), *cdef, ts);
+            attrs_collector.del(std::move(column_name), ts);
+        } else if (cdef) {
             row.cells().apply(*cdef, atomic_cell::make_dead(ts, gc_clock::now()));
         } else {
             attrs_collector.del(std::move(column_name), ts);
@@ -3031,7 +3300,7 @@ future<executor::request_return_type> executor::update_item(client_state& client
             });
         });
     }
-    return op->execute(_proxy, client_state, trace_state, std::move(permit), needs_read_before_write, _stats).finally([op, start_time, this] {
+    return op->execute(*this, client_state, trace_state, std::move(permit), needs_read_before_write).finally([op, start_time, this] {
         _stats.api_operations.update_item_latency.add(std::chrono::steady_clock::now() - start_time);
     });
 }
@@ -3196,7 +3465,8 @@ future<executor::request_return_type> executor::batch_get_item(client_state& cli
         // be sorted for the read below (see #10827). Additionally each
         // clustering key is mapped to the original rjson::value "Key".
         using clustering_keys = std::map<clustering_key, rjson::value*, clustering_key::less_compare>;
-        std::unordered_map<partition_key, clustering_keys, partition_key::hashing, partition_key::equality> requests;
+        using partition_requests = std::unordered_map<partition_key, clustering_keys, partition_key::hashing, partition_key::equality>;
+        partition_requests requests;
         table_requests(schema_ptr s)
             : schema(std::move(s))
             , requests(8, partition_key::hashing(*schema), partition_key::equality(*schema))
@@ -3230,43 +3500,49 @@ future<executor::request_return_type> executor::batch_get_item(client_state& cli
         requests.emplace_back(std::move(rs));
     }
 
-    // If we got here, all "requests" are valid, so let's start the
-    // requests for the different partitions all in parallel.
-    std::vector<future<std::vector<rjson::value>>> response_futures;
+    // If we got here, all "requests" are valid, so let's start the reads.
+    // Reads of a table without a clustering key each read a whole partition,
+    // so those of partitions owned by the same replicas, and by the same
+    // shard on them, are sent together in one read command, of up to
+    // max_partitions_per_read partitions. The slice of a read command can
+    // only give the rows to read of one partition, so the reads of tables
+    // with a clustering key are sent one per partition.
+    static constexpr size_t max_partitions_per_read = 16;
+    struct read_group {
+        const table_requests* rs;
+        std::vector<const table_requests::partition_requests::value_type*> partitions;
+    };
+    std::vector<read_group> groups;
     for (const auto& rs : requests) {
-        for (const auto &r : rs.requests) {
-            auto& pk = r.first;
-            auto& cks = r.second;
-            dht::partition_range_vector partition_ranges{dht::partition_range(dht::decorate_key(*rs.schema, pk))};
-            std::vector<query::clustering_range> bounds;
-            if (rs.schema->clustering_key_size() == 0) {
-                bounds.push_back(query::clustering_range::make_open_ended_both_sides());
-            } else {
-                for (auto& ck : cks) {
-                    bounds.push_back(query::clustering_range::make_singular(ck.first));
-                }
+        if (rs.schema->clustering_key_size() != 0) {
+            for (const auto& r : rs.requests) {
+                groups.push_back(read_group{&rs, {&r}});
             }
-            auto regular_columns = boost::copy_range<query::column_id_vector>(
-                    rs.schema->regular_columns() | boost::adaptors::transformed([] (const column_definition& cdef) { return cdef.id; }));
-            auto selection = cql3::selection::selection::wildcard(rs.schema);
-            auto partition_slice = query::partition_slice(std::move(bounds), {}, std::move(regular_columns), selection->get_query_options());
-            auto command = ::make_lw_shared<query::read_command>(rs.schema->id(), rs.schema->version(), partition_slice, _proxy.get_max_result_size(partition_slice),
-                    query::tombstone_limit(_proxy.get_tombstone_limit()));
-            command->allow_limit = db::allow_per_partition_rate_limit::yes;
-            future<std::vector<rjson::value>> f = _proxy.query(rs.schema, std::move(command), std::move(partition_ranges), rs.cl,
-                    service::storage_proxy::coordinator_query_options(executor::default_timeout(), permit, client_state, trace_state)).then(
-                    [schema = rs.schema, partition_slice = std::move(partition_slice), selection = std::move(selection), attrs_to_get = rs.attrs_to_get] (service::storage_proxy::coordinator_query_result qr) mutable {
-                utils::get_local_injector().inject("alternator_batch_get_item", [] { throw std::runtime_error("batch_get_item injection"); });
-                std::vector<rjson::value> jsons = describe_multi_item(schema, partition_slice, *selection, *qr.query_result, *attrs_to_get);
-                return make_ready_future<std::vector<rjson::value>>(std::move(jsons));
-            });
-            response_futures.push_back(std::move(f));
+            continue;
+        }
+        auto erm = _proxy.local_db().find_keyspace(rs.schema->ks_name()).get_effective_replication_map();
+        std::map<std::pair<std::vector<gms::inet_address>, unsigned>, size_t> group_of;
+        for (const auto& r : rs.requests) {
+            auto token = dht::get_token(*rs.schema, r.first);
+            auto eps = erm->get_natural_endpoints(token);
+            std::vector<gms::inet_address> replicas(eps.begin(), eps.end());
+            std::sort(replicas.begin(), replicas.end());
+            auto [it, inserted] = group_of.try_emplace({std::move(replicas), dht::shard_of(*rs.schema, token)}, groups.size());
+            if (!inserted && groups[it->second].partitions.size() == max_partitions_per_read) {
+                it->second = groups.size();
+                inserted = true;
+            }
+            if (inserted) {
+                groups.push_back(read_group{&rs, {}});
+            }
+            groups[it->second].partitions.push_back(&r);
         }
     }
 
-    // Wait for all requests to complete, and then return the response.
-    // In case of full failure (no reads succeeded), an arbitrary error
-    // from one of the operations will be returned.
+    // All the reads are sent in parallel, and the items of each are added to
+    // the response as soon as it completes. In case of full failure (no
+    // reads succeeded), an arbitrary error from one of the operations will
+    // be returned.
     bool some_succeeded = false;
     std::exception_ptr eptr;
 
@@ -3274,48 +3550,67 @@ future<executor::request_return_type> executor::batch_get_item(client_state& cli
     rjson::add(response, "Responses", rjson::empty_object());
     rjson::add(response, "UnprocessedKeys", rjson::empty_object());
 
-    auto fut_it = response_futures.begin();
-    for (const auto& rs : requests) {
+    co_await coroutine::parallel_for_each(groups, [&] (const read_group& g) -> future<> {
+        const auto& rs = *g.rs;
+        dht::partition_range_vector partition_ranges;
+        partition_ranges.reserve(g.partitions.size());
+        for (auto p : g.partitions) {
+            partition_ranges.push_back(dht::partition_range(dht::decorate_key(*rs.schema, p->first)));
+        }
+        std::vector<query::clustering_range> bounds;
+        if (rs.schema->clustering_key_size() == 0) {
+            bounds.push_back(query::clustering_range::make_open_ended_both_sides());
+        } else {
+            for (auto& ck : g.partitions.front()->second) {
+                bounds.push_back(query::clustering_range::make_singular(ck.first));
+            }
+        }
+        auto regular_columns = boost::copy_range<query::column_id_vector>(
+                rs.schema->regular_columns() | boost::adaptors::transformed([] (const column_definition& cdef) { return cdef.id; }));
+        auto selection = cql3::selection::selection::wildcard(rs.schema);
+        auto partition_slice = query::partition_slice(std::move(bounds), {}, std::move(regular_columns), selection->get_query_options());
+        auto command = ::make_lw_shared<query::read_command>(rs.schema->id(), rs.schema->version(), partition_slice, _proxy.get_max_result_size(partition_slice),
+                query::tombstone_limit(_proxy.get_tombstone_limit()));
+        command->allow_limit = db::allow_per_partition_rate_limit::yes;
         auto table = table_name(*rs.schema);
-        for (const auto &r : rs.requests) {
-            auto& pk = r.first;
-            auto& cks = r.second;
-            auto& fut = *fut_it;
-            ++fut_it;
-            try {
-                std::vector<rjson::value> results = co_await std::move(fut);
-                some_succeeded = true;
-                if (!response["Responses"].HasMember(table)) {
-                    rjson::add_with_string_name(response["Responses"], table, rjson::empty_array());
-                }
-                for (rjson::value& json : results) {
-                    rjson::push_back(response["Responses"][table], std::move(json));
-                }
-            } catch(...) {
-                eptr = std::current_exception();
-                // This read of potentially several rows in one partition,
-                // failed. We need to add the row key(s) to UnprocessedKeys.
-                if (!response["UnprocessedKeys"].HasMember(table)) {
-                    // Add the table's entry in UnprocessedKeys. Need to copy
-                    // all the table's parameters from the request except the
-                    // Keys field, which we start empty and then build below.
-                    rjson::add_with_string_name(response["UnprocessedKeys"], table, rjson::empty_object());
-                    rjson::value& unprocessed_item = response["UnprocessedKeys"][table];
-                    rjson::value& request_item = request_items[table];
-                    for (auto it = request_item.MemberBegin(); it != request_item.MemberEnd(); ++it) {
-                        if (it->name != "Keys") {
-                            rjson::add_with_string_name(unprocessed_item,
-                                rjson::to_string_view(it->name), rjson::copy(it->value));
-                        }
+        try {
+            auto qr = co_await _proxy.query(rs.schema, std::move(command), std::move(partition_ranges), rs.cl,
+                    service::storage_proxy::coordinator_query_options(executor::default_timeout(), permit, client_state, trace_state));
+            utils::get_local_injector().inject("alternator_batch_get_item", [] { throw std::runtime_error("batch_get_item injection"); });
+            std::vector<rjson::value> results = describe_multi_item(rs.schema, partition_slice, *selection, *qr.query_result, *rs.attrs_to_get);
+            some_succeeded = true;
+            if (!response["Responses"].HasMember(table)) {
+                rjson::add_with_string_name(response["Responses"], table, rjson::empty_array());
+            }
+            for (rjson::value& json : results) {
+                rjson::push_back(response["Responses"][table], std::move(json));
+            }
+        } catch(...) {
+            eptr = std::current_exception();
+            // This read of potentially several rows in several partitions
+            // failed. We need to add the row key(s) to UnprocessedKeys.
+            if (!response["UnprocessedKeys"].HasMember(table)) {
+                // Add the table's entry in UnprocessedKeys. Need to copy
+                // all the table's parameters from the request except the
+                // Keys field, which we start empty and then build below.
+                rjson::add_with_string_name(response["UnprocessedKeys"], table, rjson::empty_object());
+                rjson::value& unprocessed_item = response["UnprocessedKeys"][table];
+                rjson::value& request_item = request_items[table];
+                for (auto it = request_item.MemberBegin(); it != request_item.MemberEnd(); ++it) {
+                    if (it->name != "Keys") {
+                        rjson::add_with_string_name(unprocessed_item,
+                            rjson::to_string_view(it->name), rjson::copy(it->value));
                     }
-                    rjson::add_with_string_name(unprocessed_item, "Keys", rjson::empty_array());
                 }
-                for (auto& ck : cks) {
+                rjson::add_with_string_name(unprocessed_item, "Keys", rjson::empty_array());
+            }
+            for (auto p : g.partitions) {
+                for (auto& ck : p->second) {
                     rjson::push_back(response["UnprocessedKeys"][table]["Keys"], std::move(*ck.second));
                 }
             }
         }
-    }
+    });
     elogger.trace("Unprocessed keys: {}", response["UnprocessedKeys"]);
     if (!some_succeeded && eptr) {
         co_await coroutine::return_exception_ptr(std::move(eptr));
@@ -3469,6 +3764,7 @@ class describe_items_visitor {
     rjson::value _item;
     rjson::value _items;
     size_t _scanned_count;
+    bool _promoted_columns;
 
 public:
     describe_items_visitor(const columns_t& columns, const std::optional<attrs_to_get>& attrs_to_get, filter& filter)
@@ -3479,6 +3775,7 @@ class describe_items_visitor {
             , _item(rjson::empty_object())
             , _items(rjson::empty_array())
             , _scanned_count(0)
+            , _promoted_columns(has_promoted_columns(columns))
     {
         // _filter.check() may need additional attributes not listed in
         // _attrs_to_get (i.e., not requested as part of the output).
@@ -3505,7 +3802,7 @@ class describe_items_visitor {
         }
         result_bytes_view->with_linearized([this] (bytes_view bv) {
             std::string column_name = (*_column_it)->name_as_text();
-            if (column_name != executor::ATTRS_COLUMN_NAME) {
+            if (column_name != executor::ATTRS_COLUMN_NAME && !is_promoted_column(**_column_it)) {
                 if (!_attrs_to_get || _attrs_to_get->contains(column_name) || _extra_filter_attrs.contains(column_name)) {
                     if (!_item.HasMember(column_name.c_str())) {
                         rjson::add_with_string_name(_item, column_name, rjson::empty_object());
@@ -3526,7 +3823,7 @@ class describe_items_visitor {
                         // need the other parts (it was easier for us to keep
                         // extra_filter_attrs at top-level granularity). We'll
                         // filter the unneeded parts after item filtering.
-                        rjson::add_with_string_name(_item, attr_name, deserialize_item(value));
+                        add_map_attribute(_item, **_column_it, attr_name, deserialize_item(value), _promoted_columns);
                     }
                 }
             }
@@ -3593,6 +3890,90 @@ static std::tuple<rjson::value, size_t> describe_items(const cql3::selection::se
     return {std::move(items_descr), size};
 }
 
+// Writes the items of a result set directly as JSON text, the same text as
+// describe_items_visitor would build, without building values for them.
+// Items which need to be filtered, or of which only parts of attributes are
+// needed, do need the values, so they are left to describe_items_visitor.
+// So are the items of tables with promoted attributes, which may have
+// attributes in two columns, until the attribute is written again.
+class write_items_visitor {
+    typedef std::vector<const column_definition*> columns_t;
+    const columns_t& _columns;
+    const std::optional<attrs_to_get>& _attrs_to_get;
+    rjson::streaming_writer& _writer;
+    typename columns_t::const_iterator _column_it;
+    size_t _count = 0;
+
+    bool wanted(std::string_view attr_name) const {
+        return !_attrs_to_get || _attrs_to_get->contains(std::string(attr_name));
+    }
+public:
+    write_items_visitor(const columns_t& columns, const std::optional<attrs_to_get>& attrs_to_get, rjson::streaming_writer& writer)
+            : _columns(columns)
+            , _attrs_to_get(attrs_to_get)
+            , _writer(writer)
+            , _column_it(columns.begin())
+    { }
+
+    static bool can_write(const columns_t& columns, const std::optional<attrs_to_get>& attrs_to_get, const filter& filter) {
+        if (filter || has_promoted_columns(columns)) {
+            return false;
+        }
+        // Select=COUNT, which returns no Items, asks for no attributes.
+        return !attrs_to_get || (!attrs_to_get->empty() && std::ranges::all_of(*attrs_to_get, [] (const auto& attr) {
+            return attr.second.has_value();
+        }));
+    }
+
+    void start_row() {
+        _column_it = _columns.begin();
+        _writer.start_object();
+    }
+
+    void accept_value(const std::optional<query::result_bytes_view>& result_bytes_view) {
+        if (!result_bytes_view) {
+            ++_column_it;
+            return;
+        }
+        result_bytes_view->with_linearized([this] (bytes_view bv) {
+            std::string_view column_name = (*_column_it)->name_as_text();
+            if (column_name != executor::ATTRS_COLUMN_NAME) {
+                if (wanted(column_name)) {
+                    _writer.key(column_name);
+                    _writer.start_object();
+                    _writer.key(type_to_string((*_column_it)->type));
+                    _writer.value(json_key_column_value(bv, **_column_it));
+                    _writer.end_object();
+                }
+            } else {
+                // Reads the serialized map of attributes in place, instead
+                // of deserializing it into values first.
+                auto in = bv;
+                auto size = read_collection_size(in);
+                for (int i = 0; i < size; ++i) {
+                    auto key = read_collection_key(in);
+                    auto value = read_collection_value_nonnull(in);
+                    auto attr_name = std::string_view(reinterpret_cast<const char*>(key.data()), key.size());
+                    if (wanted(attr_name)) {
+                        _writer.key(attr_name);
+                        write_item(_writer, value);
+                    }
+                }
+            }
+        });
+        ++_column_it;
+    }
+
+    void end_row() {
+        _writer.end_object();
+        ++_count;
+    }
+
+    size_t get_count() const {
+        return _count;
+    }
+};
+
 static rjson::value encode_paging_state(const schema& schema, const service::pager::paging_state& paging_state) {
     rjson::value last_evaluated_key = rjson::empty_object();
     std::vector<bytes> exploded_pk = paging_state.get_partition_key().explode();
@@ -3684,6 +4065,34 @@ static future<executor::request_return_type> do_query(service::storage_proxy& pr
             rs->get_metadata().set_paging_state(p->state());
         }
         auto paging_state = rs->get_metadata().paging_state();
+        if (write_items_visitor::can_write(selection->get_columns(), attrs_to_get, filter)) {
+            rjson::streaming_writer writer;
+            writer.start_object();
+            writer.key("Items");
+            writer.start_array();
+            write_items_visitor visitor(selection->get_columns(), attrs_to_get, writer);
+            rs->visit(visitor);
+            writer.end_array();
+            // Without a filter, all the items scanned are returned.
+            writer.key("Count");
+            writer.number(visitor.get_count());
+            writer.key("ScannedCount");
+            writer.number(visitor.get_count());
+            if (paging_state) {
+                writer.key("LastEvaluatedKey");
+                writer.value(encode_paging_state(*schema, *paging_state));
+            }
+            writer.end_object();
+            if (writer.size() > 100'000) {
+                return make_ready_future<executor::request_return_type>(make_streamed(std::move(writer).finish()));
+            }
+            std::string response;
+            response.reserve(writer.size());
+            for (auto& buf : std::move(writer).finish()) {
+                response.append(buf.get(), buf.size());
+            }
+            return make_ready_future<executor::request_return_type>(json_string(std::move(response)));
+        }
         bool has_filter = filter;
         auto [items, size] = describe_items(*selection, std::move(rs), std::move(attrs_to_get), std::move(filter));
         if (paging_state) {
@@ -4403,10 +4812,73 @@ static future<std::vector<mutation>> create_keyspace(std::string_view keyspace_n
     co_return mm.prepare_new_keyspace_announcement(ksm, ts);
 }
 
+// Builds the RMW operation of a request forwarded to the leader of its item,
+// given the name of the operation, see operation_name().
+static shared_ptr<rmw_operation> make_rmw_operation(service::storage_proxy& proxy, std::string_view operation, rjson::value&& request) {
+    if (operation == "PutItem") {
+        return make_shared<put_item_operation>(proxy, std::move(request));
+    } else if (operation == "DeleteItem") {
+        return make_shared<delete_item_operation>(proxy, std::move(request));
+    } else if (operation == "UpdateItem") {
+        return make_shared<update_item_operation>(proxy, std::move(request));
+    }
+    throw api_error::unknown_operation(format("Unsupported read-modify-write operation {}", operation));
+}
+
+using leader_rmw_result = rpc::tuple<sstring, sstring, sstring, uint16_t>;
+
+static leader_rmw_result leader_rmw_error(const api_error& e) {
+    return leader_rmw_result(sstring(), sstring(e._type), sstring(e._msg), uint16_t(e._http_code));
+}
+
+// Runs the RMW operation of a request forwarded by its coordinator, as the
+// leader of its item, on the shard the item's row lock is taken on.
+static future<leader_rmw_result> handle_leader_rmw(executor& exec, service::storage_proxy& proxy, smp_service_group ssg,
+        sstring operation, sstring request, std::optional<tracing::trace_info> trace_info) {
+    shared_ptr<rmw_operation> op;
+    try {
+        op = make_rmw_operation(proxy, operation, rjson::parse(request));
+    } catch (api_error& e) {
+        co_return leader_rmw_error(e);
+    }
+    auto shard = service::storage_proxy::cas_shard(*op->schema(), op->token());
+    if (shard != this_shard_id()) {
+        co_return co_await exec.container().invoke_on(shard, ssg,
+                [&proxies = proxy.container(), ssg, operation = std::move(operation), request = std::move(request), trace_info = std::move(trace_info)] (executor& exec) mutable {
+            return handle_leader_rmw(exec, proxies.local(), ssg, std::move(operation), std::move(request), std::move(trace_info));
+        });
+    }
+    tracing::trace_state_ptr trace_state;
+    if (trace_info) {
+        trace_state = tracing::tracing::get_local_tracing_instance().create_session(*trace_info);
+        tracing::begin(trace_state);
+        tracing::trace(trace_state, "Running {} as the leader of the item", operation);
+    }
+    std::optional<api_error> error;
+    try {
+        if (co_await op->execute_on_leader(exec, service::client_state::for_internal_calls(), trace_state, empty_service_permit())) {
+            const rjson::value& attributes = op->return_attributes();
+            co_return leader_rmw_result(attributes.IsNull() ? sstring() : sstring(rjson::print(attributes)), sstring(), sstring(), uint16_t(0));
+        }
+        error = api_error::conditional_check_failed("Failed condition.");
+    } catch (api_error& e) {
+        error = std::move(e);
+    }
+    co_return leader_rmw_error(*error);
+}
+
 future<> executor::start() {
-    // Currently, nothing to do on initialization. We delay the keyspace
-    // creation (create_keyspace()) until a table is actually created.
+    // We delay the keyspace creation (create_keyspace()) until a table is
+    // actually created.
+    ser::alternator_rpc_verbs::register_alternator_leader_rmw(&_ms,
+            [this] (rpc::opt_time_point, sstring operation, sstring request, std::optional<tracing::trace_info> trace_info) {
+        return handle_leader_rmw(*this, _proxy, _ssg, std::move(operation), std::move(request), std::move(trace_info));
+    });
     return make_ready_future<>();
 }
 
+future<> executor::stop() {
+    return ser::alternator_rpc_verbs::unregister(&_ms);
+}
+
 }
@@ -18,6 +18,8 @@
 #include "service/client_state.hh"
 #include "service_permit.hh"
 #include "db/timeout_clock.hh"
+#include "db/view/row_locking.hh"
+#include "message/messaging_service_fwd.hh"
 
 #include "alternator/error.hh"
 #include "stats.hh"
@@ -69,6 +71,8 @@ struct make_jsonable : public json::jsonable {
  * help avoid large allocations/many re-allocs
  */ 
 json::json_return_type make_streamed(rjson::value&&);
+// Same, for JSON text already written by an rjson::streaming_writer.
+json::json_return_type make_streamed(rjson::chunked_content&&);
 
 struct json_string : public json::jsonable {
     std::string _value;
@@ -85,6 +89,8 @@ schema_ptr get_table(service::storage_proxy& proxy, const rjson::value& request)
 bool is_alternator_keyspace(const sstring& ks_name);
 // Wraps the db::get_tags_of_table and throws if the table is missing the tags extension.
 const std::map<sstring, sstring>& get_tags_of_table_or_throw(schema_ptr schema);
+// Whether the tags of a table list attribute_name in PROMOTED_ATTRIBUTES_TAG_KEY.
+bool is_promoted_attribute(const std::map<sstring, sstring>& tags, std::string_view attribute_name);
 
 // An attribute_path_map object is used to hold data for various attributes
 // paths (parsed::path) in a hierarchy of attribute paths. Each attribute path
@@ -161,17 +167,34 @@ class executor : public peering_sharded_service<executor> {
     // An smp_service_group to be used for limiting the concurrency when
     // forwarding Alternator request between shards - if necessary for LWT.
     smp_service_group _ssg;
+    netw::messaging_service& _ms;
+    // The row locks of the items this shard is the leader of, for tables
+    // using the LEADER_RMW write isolation policy. Lockers of tables with
+    // no locks held are dropped.
+    std::unordered_map<table_id, row_locker> _leader_rmw_lockers;
+    row_locker::stats _leader_rmw_lock_stats;
+    // The RMW operations of an item run on the same shard of its leader,
+    // which gives their writes increasing timestamps.
+    api::timestamp_type _last_leader_rmw_timestamp = api::missing_timestamp;
 
 public:
     using client_state = service::client_state;
     using request_return_type = std::variant<json::json_return_type, api_error>;
     stats _stats;
     static constexpr auto ATTRS_COLUMN_NAME = ":attrs";
+    // The value of this tag lists, separated by spaces, attributes of the
+    // table which are stored each in a column of their own, of the same
+    // type as ATTRS_COLUMN_NAME, instead of in ATTRS_COLUMN_NAME. Reading
+    // and writing them then doesn't touch the other attributes. Attributes
+    // can be added to the list but not removed from it.
+    static constexpr auto PROMOTED_ATTRIBUTES_TAG_KEY = "system:promoted_attributes";
+    // The name of the expiration-time attribute of the table, see ttl.cc.
+    static constexpr auto TTL_TAG_KEY = "system:ttl_attribute";
     static constexpr auto KEYSPACE_NAME_PREFIX = "alternator_";
     static constexpr std::string_view INTERNAL_TABLE_PREFIX = ".scylla.alternator.";
 
-    executor(gms::gossiper& gossiper, service::storage_proxy& proxy, service::migration_manager& mm, db::system_distributed_keyspace& sdks, cdc::metadata& cdc_metadata, smp_service_group ssg)
-        : _gossiper(gossiper), _proxy(proxy), _mm(mm), _sdks(sdks), _cdc_metadata(cdc_metadata), _ssg(ssg) {}
+    executor(gms::gossiper& gossiper, service::storage_proxy& proxy, service::migration_manager& mm, db::system_distributed_keyspace& sdks, cdc::metadata& cdc_metadata, smp_service_group ssg, netw::messaging_service& ms)
+        : _gossiper(gossiper), _proxy(proxy), _mm(mm), _sdks(sdks), _cdc_metadata(cdc_metadata), _ssg(ssg), _ms(ms) {}
 
     future<request_return_type> create_table(client_state& client_state, tracing::trace_state_ptr trace_state, service_permit permit, rjson::value request);
     future<request_return_type> describe_table(client_state& client_state, tracing::trace_state_ptr trace_state, service_permit permit, rjson::value request);
@@ -199,7 +222,7 @@ class executor : public peering_sharded_service<executor> {
     future<request_return_type> describe_continuous_backups(client_state& client_state, service_permit permit, rjson::value request);
 
     future<> start();
-    future<> stop() { return make_ready_future<>(); }
+    future<> stop();
 
     static sstring table_name(const schema&);
     static db::timeout_clock::time_point default_timeout();
@@ -42,8 +42,17 @@ class rmw_operation : public service::cas_request, public enable_shared_from_thi
     // * The UNSAFE_RMW option does read-modify-write operations as separate
     //   read and write. It is unsafe - concurrent RMW operations are not
     //   isolated at all. This option will likely be removed in the future.
+    // * The LEADER_RMW option does read-modify-write operations as separate
+    //   read and write, but serializes the operations of each item on its
+    //   leader - the first of its replicas in the local data center - which
+    //   runs them one by one under a row lock. It saves LWT's round trips,
+    //   but the item's RMW operations fail while its leader is unreachable,
+    //   and are not isolated from each other while the replicas of the item
+    //   change. Like LWT_RMW_ONLY, write-only operations are ordinary quorum
+    //   writes, so this option is not safe if the user may send both RMW and
+    //   write-only operations on the same item.
     enum class write_isolation {
-        FORBID_RMW, LWT_ALWAYS, LWT_RMW_ONLY, UNSAFE_RMW
+        FORBID_RMW, LWT_ALWAYS, LWT_RMW_ONLY, UNSAFE_RMW, LEADER_RMW
     };
     static constexpr auto WRITE_ISOLATION_TAG_KEY = "system:write_isolation";
 
@@ -102,13 +111,32 @@ class rmw_operation : public service::cas_request, public enable_shared_from_thi
     schema_ptr schema() const { return _schema; }
     const rjson::value& request() const { return _request; }
     rjson::value&& move_request() && { return std::move(_request); }
-    future<executor::request_return_type> execute(service::storage_proxy& proxy,
+    const rjson::value& return_attributes() const { return _return_attributes; }
+    // The name of the operation, as in the request's X-Amz-Target, which
+    // the leader of the item is given by the LEADER_RMW policy.
+    virtual std::string_view operation_name() const = 0;
+    dht::token token() const;
+    future<executor::request_return_type> execute(executor& exec,
             service::client_state& client_state,
             tracing::trace_state_ptr trace_state,
             service_permit permit,
-            bool needs_read_before_write,
-            stats& stats);
+            bool needs_read_before_write);
     std::optional<shard_id> shard_for_execute(bool needs_read_before_write);
+    // Does the read-modify-write on this node, which must be the leader of
+    // the item, under the item's row lock, on the shard returned by
+    // shard_for_execute(). Returns whether the condition of the operation
+    // held.
+    future<bool> execute_on_leader(executor& exec,
+            service::client_state& client_state,
+            tracing::trace_state_ptr trace_state,
+            service_permit permit);
+private:
+    // Does the read-modify-write of the LEADER_RMW policy on the leader of
+    // the item, forwarding it there if it isn't this node.
+    future<executor::request_return_type> execute_with_leader(executor& exec,
+            service::client_state& client_state,
+            tracing::trace_state_ptr trace_state,
+            service_permit permit);
 };
 
 } // namespace alternator
@@ -141,6 +141,39 @@ rjson::value deserialize_item(bytes_view bv) {
     return deserialized;
 }
 
+void write_item(rjson::streaming_writer& writer, bytes_view bv) {
+    if (bv.empty()) {
+        throw api_error::validation("Serialized value empty");
+    }
+
+    alternator_type atype = alternator_type(bv[0]);
+    bv.remove_prefix(1);
+
+    // Values of these types are stored as the JSON text of their value.
+    if (atype == alternator_type::NOT_SUPPORTED_YET) {
+        writer.raw(std::string_view(reinterpret_cast<const char *>(bv.data()), bv.size()));
+        return;
+    }
+    type_representation type_representation = represent_type(atype);
+    writer.start_object();
+    writer.key(type_representation.ident);
+    switch (atype) {
+    case alternator_type::S:
+        writer.string(std::string_view(reinterpret_cast<const char *>(bv.data()), bv.size()));
+        break;
+    case alternator_type::B:
+        writer.string(base64_encode(bv));
+        break;
+    case alternator_type::N:
+        writer.string(to_json_string(*decimal_type, bytes(bv)));
+        break;
+    default:
+        writer.raw(to_json_string(*type_representation.dtype, bytes(bv)));
+        break;
+    }
+    writer.end_object();
+}
+
 std::string type_to_string(data_type type) {
     static thread_local std::unordered_map<data_type, std::string> types = {
         {utf8_type, "S"},
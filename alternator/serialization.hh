@@ -43,6 +43,8 @@ type_representation represent_type(alternator_type atype);
 
 bytes serialize_item(const rjson::value& item);
 rjson::value deserialize_item(bytes_view bv);
+// Writes the JSON deserialize_item() would return, without building it.
+void write_item(rjson::streaming_writer& writer, bytes_view bv);
 
 std::string type_to_string(data_type type);
 
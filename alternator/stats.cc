@@ -82,6 +82,10 @@ stats::stats() : api_operations{} {
                     seastar::metrics::description("number of writes that used LWT")),
             seastar::metrics::make_total_operations("shard_bounce_for_lwt", shard_bounce_for_lwt,
                     seastar::metrics::description("number writes that had to be bounced from this shard because of LWT requirements")),
+            seastar::metrics::make_total_operations("write_on_leader", write_on_leader,
+                    seastar::metrics::description("number of read-modify-write operations done by this shard as the leader of their item")),
+            seastar::metrics::make_total_operations("write_forwarded_to_leader", write_forwarded_to_leader,
+                    seastar::metrics::description("number of read-modify-write operations forwarded to the leader of their item")),
             seastar::metrics::make_total_operations("requests_blocked_memory", requests_blocked_memory,
                     seastar::metrics::description("Counts a number of requests blocked due to memory pressure.")),
             seastar::metrics::make_total_operations("requests_shed", requests_shed,
@@ -78,6 +78,8 @@ class stats {
     uint64_t reads_before_write = 0;
     uint64_t write_using_lwt = 0;
     uint64_t shard_bounce_for_lwt = 0;
+    uint64_t write_on_leader = 0;
+    uint64_t write_forwarded_to_leader = 0;
     uint64_t requests_blocked_memory = 0;
     uint64_t requests_shed = 0;
     // CQL-derived stats
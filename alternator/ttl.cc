@@ -6,17 +6,22 @@
  * SPDX-License-Identifier: AGPL-3.0-or-later
  */
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <exception>
 #include <optional>
+#include <ranges>
+#include <unordered_map>
 #include <seastar/core/sstring.hh>
 #include <seastar/core/coroutine.hh>
 #include <seastar/core/sleep.hh>
 #include <seastar/core/future.hh>
 #include <seastar/core/lowres_clock.hh>
 #include <seastar/coroutine/maybe_yield.hh>
+#include <seastar/coroutine/parallel_for_each.hh>
 #include <boost/multiprecision/cpp_int.hpp>
+#include <boost/range/irange.hpp>
 
 #include "exceptions/exceptions.hh"
 #include "gms/gossiper.hh"
@@ -29,8 +34,6 @@
 #include "service_permit.hh"
 #include "timestamp.hh"
 #include "service/storage_proxy.hh"
-#include "service/pager/paging_state.hh"
-#include "service/pager/query_pagers.hh"
 #include "gms/feature_service.hh"
 #include "sstables/types.hh"
 #include "mutation/mutation.hh"
@@ -40,6 +43,8 @@
 #include "utils/big_decimal.hh"
 #include "utils/fb_utilities.hh"
 #include "cql3/selection/selection.hh"
+#include "cql3/result_set.hh"
+#include "query-result-reader.hh"
 #include "cql3/values.hh"
 #include "cql3/query_options.hh"
 #include "cql3/column_identifier.hh"
@@ -63,7 +68,7 @@ namespace alternator {
 // It can refer to a real column or if that doesn't exist, to a member of
 // the ":attrs" map column. Although this is designed for Alternator, it may
 // be good enough for CQL as well (there, the ":attrs" column won't exist).
-static const sstring TTL_TAG_KEY("system:ttl_attribute");
+static const sstring TTL_TAG_KEY(executor::TTL_TAG_KEY);
 
 future<executor::request_return_type> executor::update_time_to_live(client_state& client_state, service_permit permit, rjson::value request) {
     _stats.api_operations.update_time_to_live++;
@@ -99,6 +104,12 @@ future<executor::request_return_type> executor::update_time_to_live(client_state
             if (tags_map.contains(TTL_TAG_KEY)) {
                 throw api_error::validation("TTL is already enabled");
             }
+            // The expiration scanner reads the expiration time from a single
+            // column, but the items written before an attribute was promoted
+            // keep it in ATTRS_COLUMN_NAME until they are written again.
+            if (is_promoted_attribute(tags_map, attribute_name)) {
+                throw api_error::validation(format("TTL can't be enabled on the promoted attribute {}", attribute_name));
+            }
             tags_map[TTL_TAG_KEY] = attribute_name;
         } else {
             auto i = tags_map.find(TTL_TAG_KEY);
@@ -156,12 +167,17 @@ future<executor::request_return_type> executor::describe_time_to_live(client_sta
 // with this range), but when this node is down, the secondary owner (the
 // second in the ring) may take over.
 // An expiration thread is reponsible for all tables which need expiration
-// scans. Currently, the different tables are scanned sequentially (not in
-// parallel).
-// The expiration thread scans item using CL=QUORUM to ensures that it reads
-// a consistent expiration-time attribute. This means that the items are read
-// locally and in addition QUORUM-1 additional nodes (one additional node
-// when RF=3) need to read the data and send digests.
+// scans. The different tables are scanned sequentially, but the token ranges
+// of a table are scanned by several workers in parallel, paced by a
+// ttl_scan_controller: it backs them off while user reads are queueing, and
+// limits the rate of items they read.
+// The expiration thread reads the items of its ranges from this shard's
+// replica only, bypassing the coordinator: reading them at CL=QUORUM would
+// have QUORUM-1 additional nodes read all of them and send digests, while
+// most pages usually hold no expired item at all. An item found expired
+// locally is read again with CL=LOCAL_QUORUM before being deleted, to ensure
+// that it is deleted per a consistent expiration-time attribute - the local
+// replica may have missed a write which changed it.
 // When the expiration thread decides that an item has expired and wants
 // to delete it, it does it using a CL=QUORUM write. This allows this
 // deletion to be visible for consistent (quorum) reads. The deletion,
@@ -172,6 +188,8 @@ expiration_service::expiration_service(data_dictionary::database db, service::st
         : _db(db)
         , _proxy(proxy)
         , _gossiper(g)
+        , _scan_controller(db.get_config().alternator_ttl_scan_parallelism())
+        , _adjust_timer([this] { adjust_scan_controller(); })
 {
 }
 
@@ -236,41 +254,32 @@ static bool is_expired(const rjson::value& expiration_time, gc_clock::time_point
     return n && is_expired(*n, now);
 }
 
-// expire_item() expires an item - i.e., deletes it as appropriate for
-// expiration - with CL=QUORUM and (FIXME!) in a way Alternator Streams
-// understands it is an expiration event - not a user-initiated deletion.
-static future<> expire_item(service::storage_proxy& proxy,
-                            const service::query_state& qs,
-                            const std::vector<bytes_opt>& row,
-                            schema_ptr schema,
-                            api::timestamp_type ts) {
-    // Prepare the row key to delete
-    // NOTICE: the order of columns is guaranteed by the fact that selection::wildcard
-    // is used, which indicates that columns appear in the order defined by
-    // schema::all_columns_in_select_order() - partition key columns goes first,
-    // immediately followed by clustering key columns
+// The key of the item in a row read by the scan.
+// NOTICE: the order of columns is guaranteed by the fact that selection::wildcard
+// is used, which indicates that columns appear in the order defined by
+// schema::all_columns_in_select_order() - partition key columns goes first,
+// immediately followed by clustering key columns
+struct item_key {
+    partition_key pk;
+    std::optional<clustering_key> ck;
+};
+
+static std::optional<item_key> get_item_key(const schema& schema, const std::vector<bytes_opt>& row) {
     std::vector<bytes> exploded_pk;
-    const unsigned pk_size = schema->partition_key_size();
-    const unsigned ck_size = schema->clustering_key_size();
+    const unsigned pk_size = schema.partition_key_size();
+    const unsigned ck_size = schema.clustering_key_size();
     for (unsigned c = 0; c < pk_size; ++c) {
         const auto& row_c = row[c];
         if (!row_c) {
             // This shouldn't happen - all key columns must have values.
             // But if it ever happens, let's just *not* expire the item.
             // FIXME: log or increment a metric if this happens.
-            return make_ready_future<>();
+            return std::nullopt;
         }
         exploded_pk.push_back(*row_c);
     }
-    auto pk = partition_key::from_exploded(exploded_pk);
-    mutation m(schema, pk);
-    // If there's no clustering key, a tombstone should be created directly
-    // on a partition, not on a clustering row - otherwise it will look like
-    // an open-ended range tombstone, which will crash on KA/LA sstable format.
-    // See issue #6035
-    if (ck_size == 0) {
-        m.partition().apply(tombstone(ts, gc_clock::now()));
-    } else {
+    item_key key{partition_key::from_exploded(exploded_pk), std::nullopt};
+    if (ck_size != 0) {
         std::vector<bytes> exploded_ck;
         for (unsigned c = pk_size; c < pk_size + ck_size; ++c) {
             const auto& row_c = row[c];
@@ -278,12 +287,32 @@ static future<> expire_item(service::storage_proxy& proxy,
                 // This shouldn't happen - all key columns must have values.
                 // But if it ever happens, let's just *not* expire the item.
                 // FIXME: log or increment a metric if this happens.
-                return make_ready_future<>();
+                return std::nullopt;
             }
             exploded_ck.push_back(*row_c);
         }
-        auto ck = clustering_key::from_exploded(exploded_ck);
-        m.partition().clustered_row(*schema, ck).apply(tombstone(ts, gc_clock::now()));
+        key.ck = clustering_key::from_exploded(exploded_ck);
+    }
+    return key;
+}
+
+// expire_item() expires an item - i.e., deletes it as appropriate for
+// expiration - with CL=QUORUM and (FIXME!) in a way Alternator Streams
+// understands it is an expiration event - not a user-initiated deletion.
+static future<> expire_item(service::storage_proxy& proxy,
+                            const service::query_state& qs,
+                            const item_key& key,
+                            schema_ptr schema,
+                            api::timestamp_type ts) {
+    mutation m(schema, key.pk);
+    // If there's no clustering key, a tombstone should be created directly
+    // on a partition, not on a clustering row - otherwise it will look like
+    // an open-ended range tombstone, which will crash on KA/LA sstable format.
+    // See issue #6035
+    if (!key.ck) {
+        m.partition().apply(tombstone(ts, gc_clock::now()));
+    } else {
+        m.partition().clustered_row(*schema, *key.ck).apply(tombstone(ts, gc_clock::now()));
     }
     std::vector<mutation> mutations;
     mutations.push_back(std::move(m));
@@ -489,16 +518,19 @@ struct scan_ranges_context {
     schema_ptr s;
     bytes column_name;
     std::optional<std::string> member;
+    // The type and the index in the rows read of column_name.
+    data_type column_type;
+    unsigned expiration_column;
 
     ::shared_ptr<cql3::selection::selection> selection;
     std::unique_ptr<service::query_state> query_state_ptr;
-    std::unique_ptr<cql3::query_options> query_options;
     ::lw_shared_ptr<query::read_command> command;
 
-    scan_ranges_context(schema_ptr s, service::storage_proxy& proxy, bytes column_name, std::optional<std::string> member)
+    scan_ranges_context(schema_ptr s, service::storage_proxy& proxy, const column_definition& cd, std::optional<std::string> member)
         : s(s)
-        , column_name(column_name)
+        , column_name(cd.name())
         , member(member)
+        , column_type(cd.type)
     {
         // FIXME: don't read the entire items - read only parts of it.
         // We must read the key columns (to be able to delete) and also
@@ -506,55 +538,165 @@ struct scan_ranges_context {
         // member we may be forced to read the entire map - but it would
         // be good if we can read only the single item of the map - it
         // should be possible (and a must for issue #7751!).
-        lw_shared_ptr<service::pager::paging_state> paging_state = nullptr;
         auto regular_columns = boost::copy_range<query::column_id_vector>(
             s->regular_columns() | boost::adaptors::transformed([] (const column_definition& cdef) { return cdef.id; }));
         selection = cql3::selection::selection::wildcard(s);
+        expiration_column = selection->index_of(cd);
         query::partition_slice::option_set opts = selection->get_query_options();
         opts.set<query::partition_slice::option::allow_short_read>();
         // It is important that the scan bypass cache to avoid polluting it:
         opts.set<query::partition_slice::option::bypass_cache>();
+        // The keys are needed to know where the next page starts.
+        opts.set<query::partition_slice::option::send_partition_key>();
+        opts.set<query::partition_slice::option::send_clustering_key>();
         std::vector<query::clustering_range> ck_bounds{query::clustering_range::make_open_ended_both_sides()};
         auto partition_slice = query::partition_slice(std::move(ck_bounds), {}, std::move(regular_columns), opts);
         command = ::make_lw_shared<query::read_command>(s->id(), s->version(), partition_slice, proxy.get_max_result_size(partition_slice), query::tombstone_limit(proxy.get_tombstone_limit()));
         executor::client_state client_state{executor::client_state::internal_tag()};
         tracing::trace_state_ptr trace_state;
-        // NOTICE: empty_service_permit is used because the TTL service has fixed parallelism
+        // NOTICE: empty_service_permit is used because the TTL service is
+        // paced by its own ttl_scan_controller
         query_state_ptr = std::make_unique<service::query_state>(client_state, trace_state, empty_service_permit());
-        // FIXME: What should we do on multi-DC? Will we run the expiration on the same ranges on all
-        // DCs or only once for each range? If the latter, we need to change the CLs in the
-        // scanner and deleter.
-        db::consistency_level cl = db::consistency_level::LOCAL_QUORUM;
-        query_options = std::make_unique<cql3::query_options>(cl, std::vector<cql3::raw_value>{});
-        query_options = std::make_unique<cql3::query_options>(std::move(query_options), std::move(paging_state));
     }
 };
 
-// Scan data in a list of token ranges in one table, looking for expired
-// items and deleting them.
-// Because of issue #9167, partition_ranges must have a single partition
-// range for this code to work correctly.
-static future<> scan_table_ranges(
+static std::unique_ptr<cql3::result_set> to_result_set(const scan_ranges_context& scan_ctx,
+        const query::partition_slice& slice, const query::result& result) {
+    cql3::selection::result_set_builder builder(*scan_ctx.selection, gc_clock::now());
+    query::result_view::consume(result, slice, cql3::selection::result_set_builder::visitor(builder, *scan_ctx.s, *scan_ctx.selection));
+    return builder.build();
+}
+
+// Checks if the item in a row read by the scan has expired, according to
+// its expiration-time attribute.
+static bool is_expired(const scan_ranges_context& scan_ctx, const std::vector<bytes_opt>& row, gc_clock::time_point now) {
+    const bytes_opt& cell = row[scan_ctx.expiration_column];
+    if (!cell) {
+        return false;
+    }
+    auto v = scan_ctx.column_type->deserialize(*cell);
+    if (scan_ctx.member) {
+        // In this case, the expiration-time attribute we're
+        // looking for is a member in a map, saved serialized
+        // into bytes using Alternator's serialization (basically
+        // a JSON serialized into bytes)
+        // FIXME: is it possible to find a specific member of a map
+        // without iterating through it like we do here and compare
+        // the key?
+        for (const auto& entry : value_cast<map_type_impl::native_type>(v)) {
+            if (value_cast<sstring>(entry.first) == *scan_ctx.member) {
+                bytes value = value_cast<bytes>(entry.second);
+                rjson::value json = deserialize_item(value);
+                return is_expired(json, now);
+            }
+        }
+        return false;
+    }
+    // For a real column to contain an expiration time, it
+    // must be a numeric type.
+    // FIXME: Currently we only support decimal_type (which is
+    // what Alternator uses), but other numeric types can be
+    // supported as well to make this feature more useful in CQL.
+    // Note that kind::decimal is also checked in scan_table().
+    big_decimal n = value_cast<big_decimal>(v);
+    return is_expired(n, now);
+}
+
+// Reads the item again with CL=LOCAL_QUORUM, and returns whether it is still
+// expired: the local replica the scan read the item from may have missed a
+// write which removed or postponed its expiration time.
+static future<bool> is_still_expired(service::storage_proxy& proxy, const scan_ranges_context& scan_ctx, const item_key& key) {
+    const schema& s = *scan_ctx.s;
+    std::vector<query::clustering_range> ck_bounds{key.ck
+            ? query::clustering_range::make_singular(*key.ck)
+            : query::clustering_range::make_open_ended_both_sides()};
+    auto partition_slice = query::partition_slice(std::move(ck_bounds), {}, scan_ctx.command->slice.regular_columns, scan_ctx.selection->get_query_options());
+    auto command = ::make_lw_shared<query::read_command>(s.id(), s.version(), partition_slice, proxy.get_max_result_size(partition_slice), query::tombstone_limit(proxy.get_tombstone_limit()));
+    dht::partition_range_vector partition_ranges{dht::partition_range::make_singular(dht::decorate_key(s, key.pk))};
+    // FIXME: What should we do on multi-DC? Will we run the expiration on the same ranges on all
+    // DCs or only once for each range? If the latter, we need to change the CLs in the
+    // scanner and deleter.
+    auto qr = co_await proxy.query(scan_ctx.s, command, std::move(partition_ranges), db::consistency_level::LOCAL_QUORUM,
+            service::storage_proxy::coordinator_query_options(executor::default_timeout(), empty_service_permit(), scan_ctx.query_state_ptr->get_client_state()));
+    auto rs = to_result_set(scan_ctx, command->slice, *qr.query_result);
+    auto now = gc_clock::now();
+    co_return std::ranges::any_of(rs->rows(), [&] (const std::vector<bytes_opt>& row) {
+        return is_expired(scan_ctx, row, now);
+    });
+}
+
+// Reads the items of a token range owned by this shard from this shard's
+// replica, a page at a time, resuming each page after the last item of the
+// previous one like the coordinator's query pagers do.
+class local_range_pager {
+    replica::database& _db;
+    const scan_ranges_context& _scan_ctx;
+    dht::partition_range _range;
+    std::optional<partition_key> _last_pkey;
+    position_in_partition _last_pos = position_in_partition::for_partition_start();
+    bool _exhausted = false;
+public:
+    local_range_pager(replica::database& db, const scan_ranges_context& scan_ctx, dht::partition_range range)
+        : _db(db)
+        , _scan_ctx(scan_ctx)
+        , _range(std::move(range))
+    { }
+
+    bool is_exhausted() const {
+        return _exhausted;
+    }
+
+    future<std::unique_ptr<cql3::result_set>> fetch_page(uint64_t max_rows, db::timeout_clock::time_point timeout) {
+        const schema& s = *_scan_ctx.s;
+        query::read_command cmd = *_scan_ctx.command;
+        dht::partition_range range = _range;
+        if (_last_pkey) {
+            // Without a clustering position, the last page ended with the
+            // whole last partition, so the next one starts after it.
+            const bool has_ck = s.clustering_key_size() > 0 && _last_pos.region() == partition_region::clustered;
+            range = dht::partition_range(dht::partition_range::bound(dht::ring_position(dht::decorate_key(s, *_last_pkey)), has_ck), _range.end());
+            if (has_ck) {
+                query::clustering_row_ranges row_ranges = cmd.slice.default_row_ranges();
+                query::trim_clustering_row_ranges_to(s, row_ranges, position_in_partition::after_key(s, _last_pos));
+                cmd.slice.set_range(s, *_last_pkey, std::move(row_ranges));
+            }
+        }
+        cmd.set_row_limit(max_rows);
+        auto [result, cache_temperature] = co_await _db.query(_scan_ctx.s, cmd, query::result_options::only_result(), {range}, nullptr, timeout);
+        auto rs = to_result_set(_scan_ctx, cmd.slice, *result);
+        if (!result->is_short_read() && rs->size() < max_rows) {
+            _exhausted = true;
+        } else {
+            auto last_pos = result->get_or_calculate_last_position();
+            _last_pkey = std::move(last_pos.partition);
+            _last_pos = std::move(last_pos.position);
+        }
+        co_return rs;
+    }
+};
+
+// The number of items read at a time by a scan, small enough for pages to
+// be charged to the ttl_scan_controller at a fine granularity. Pages are
+// also limited by the size of their results.
+static constexpr uint64_t scan_page_rows = 1000;
+
+// Scan data in a token range owned by this shard in one table, looking for
+// expired items and deleting them.
+static future<> scan_table_range(
         service::storage_proxy& proxy,
         const scan_ranges_context& scan_ctx,
-        dht::partition_range_vector&& partition_ranges,
+        dht::partition_range range,
         abort_source& abort_source,
-        named_semaphore& page_sem,
-        expiration_service::stats& expiration_stats)
+        ttl_scan_controller& controller,
+        expiration_service::stats& expiration_stats,
+        expiration_service::table_stats& table_stats)
 {
-    const schema_ptr& s = scan_ctx.s;
-    assert (partition_ranges.size() == 1); // otherwise issue #9167 will cause incorrect results.
-    auto p = service::pager::query_pagers::pager(proxy, s, scan_ctx.selection, *scan_ctx.query_state_ptr,
-            *scan_ctx.query_options, scan_ctx.command, std::move(partition_ranges), nullptr);
-    while (!p->is_exhausted()) {
+    local_range_pager p(proxy.local_db(), scan_ctx, std::move(range));
+    while (!p.is_exhausted()) {
         if (abort_source.abort_requested()) {
             co_return;
         }
-        auto units = co_await get_units(page_sem, 1);
-        // We don't need to limit page size in number of rows because there is
-        // a builtin limit of the page's size in bytes. Setting this limit to
-        // 1 is useful for debugging the paging code with moderate-size data.
-        uint32_t limit = std::numeric_limits<uint32_t>::max();
+        auto permit = co_await controller.acquire();
         // Read a page, and if that times out, try again after a small sleep.
         // If we didn't catch the timeout exception, it would cause the scan
         // be aborted and only be restarted at the next scanning period.
@@ -563,80 +705,54 @@ static future<> scan_table_ranges(
         for (int retries=0; ; retries++) {
             try {
                 // FIXME: which timeout?
-                rs = co_await p->fetch_page(limit, gc_clock::now(), executor::default_timeout());
+                rs = co_await p.fetch_page(scan_page_rows, executor::default_timeout());
                 break;
-            } catch(exceptions::read_timeout_exception&) {
+            } catch (seastar::timed_out_error&) {
                 tlogger.warn("expiration scanner read timed out, will retry: {}",
                     std::current_exception());
             }
             // If we didn't break out of this loop, add a minimal sleep
             if (retries >= 10) {
                 // Don't get stuck forever asking the same page, maybe there's
-                // a bug or a real problem in several replicas. Give up on
+                // a bug or a real problem in the replica. Give up on
                 // this scan an retry the scan from a random position later,
                 // in the next scan period.
                 throw runtime_exception("scanner thread failed after too many timeouts for the same page");
             }
             co_await sleep_abortable(std::chrono::seconds(1), abort_source);
         }
-        auto rows = rs->rows();
-        auto meta = rs->get_metadata().get_names();
-        std::optional<unsigned> expiration_column;
-        for (unsigned i = 0; i < meta.size(); i++) {
-            const cql3::column_specification& col = *meta[i];
-            if (col.name->name() == scan_ctx.column_name) {
-                expiration_column = i;
-                break;
-            }
-        }
-        if (!expiration_column) {
-            continue;
-        }
-        for (const auto& row : rows) {
-            const bytes_opt& cell = row[*expiration_column];
-            if (!cell) {
+        uint64_t expired = 0;
+        auto now = gc_clock::now();
+        for (const auto& row : rs->rows()) {
+            if (!is_expired(scan_ctx, row, now)) {
                 continue;
             }
-            auto v = meta[*expiration_column]->type->deserialize(*cell);
-            bool expired = false;
-            // FIXME: don't recalculate "now" all the time
-            auto now = gc_clock::now();
-            if (scan_ctx.member) {
-                // In this case, the expiration-time attribute we're
-                // looking for is a member in a map, saved serialized
-                // into bytes using Alternator's serialization (basically
-                // a JSON serialized into bytes)
-                // FIXME: is it possible to find a specific member of a map
-                // without iterating through it like we do here and compare
-                // the key?
-                for (const auto& entry : value_cast<map_type_impl::native_type>(v)) {
-                    std::string attr_name = value_cast<sstring>(entry.first);
-                    if (value_cast<sstring>(entry.first) == *scan_ctx.member) {
-                        bytes value = value_cast<bytes>(entry.second);
-                        rjson::value json = deserialize_item(value);
-                        expired = is_expired(json, now);
-                        break;
-                    }
-                }
-            } else {
-                // For a real column to contain an expiration time, it
-                // must be a numeric type.
-                // FIXME: Currently we only support decimal_type (which is
-                // what Alternator uses), but other numeric types can be
-                // supported as well to make this feature more useful in CQL.
-                // Note that kind::decimal is also checked above.
-                big_decimal n = value_cast<big_decimal>(v);
-                expired = is_expired(n, now);
+            auto key = get_item_key(*scan_ctx.s, row);
+            if (!key) {
+                continue;
             }
-            if (expired) {
-                expiration_stats.items_deleted++;
-                // FIXME: maybe don't recalculate new_timestamp() all the time
-                // FIXME: if expire_item() throws on timeout, we need to retry it.
-                auto ts = api::new_timestamp();
-                co_await expire_item(proxy, *scan_ctx.query_state_ptr, row, s, ts);
+            ++expired;
+            // FIXME: if is_still_expired() or expire_item() throws on
+            // timeout, we need to retry it.
+            if (!co_await is_still_expired(proxy, scan_ctx, *key)) {
+                continue;
             }
+            expiration_stats.items_deleted++;
+            table_stats.items_deleted++;
+            // FIXME: maybe don't recalculate new_timestamp() all the time
+            auto ts = api::new_timestamp();
+            co_await expire_item(proxy, *scan_ctx.query_state_ptr, *key, scan_ctx.s, ts);
+        }
+        expiration_stats.items_scanned += rs->size();
+        table_stats.items_scanned += rs->size();
+        controller.observe_page(rs->size(), expired);
+        permit.release();
+        try {
+            co_await controller.throttle(rs->size(), abort_source);
+        } catch (seastar::sleep_aborted&) {
+            co_return;
         }
-        // FIXME: once in a while, persist p->state(), so on reboot
+        // FIXME: once in a while, persist the pager's position, so on reboot
         // we don't start from scratch.
     }
 }
@@ -655,10 +771,10 @@ static future<> scan_table_ranges(
 // table, scan_table() returns false without doing anything. Remember that the
 // TTL feature may be enabled later so this function will need to be called
 // again when the feature is enabled.
-// Currently this function scans the entire table (or, rather the parts owned
-// by this shard) at full rate, once. In the future (FIXME) we should consider
-// how to pace this scan, how and when to repeat it, how to interleave or
-// parallelize scanning of multiple tables, and how to continue scans after a
+// This function scans the entire table (or, rather the parts owned by this
+// shard) once, with up to the controller's parallelism ranges at a time, at
+// the pace it sets. In the future (FIXME) we should consider how to
+// interleave scanning of multiple tables, and how to continue scans after a
 // reboot.
 static future<bool> scan_table(
     service::storage_proxy& proxy,
@@ -666,8 +782,9 @@ static future<bool> scan_table(
     gms::gossiper& gossiper,
     schema_ptr s,
     abort_source& abort_source,
-    named_semaphore& page_sem,
-    expiration_service::stats& expiration_stats)
+    ttl_scan_controller& controller,
+    expiration_service::stats& expiration_stats,
+    std::unordered_map<table_id, expiration_service::table_stats>& tables_stats)
 {
     // Check if an expiration-time attribute is enabled for this table.
     // If not, just return false immediately.
@@ -714,21 +831,11 @@ static future<bool> scan_table(
         co_return false;
     }
     expiration_stats.scan_table++;
-    // FIXME: need to pace the scan, not do it all at once.
-    scan_ranges_context scan_ctx{s, proxy, std::move(column_name), std::move(member)};
+    auto& table_stats = tables_stats.try_emplace(s->id(), *s).first->second;
+    auto start = lowres_clock::now();
+    controller.begin_table();
+    scan_ranges_context scan_ctx{s, proxy, *cd, std::move(member)};
     token_ranges_owned_by_this_shard<primary> my_ranges(db.real_database(), gossiper, s);
-    while (std::optional<dht::partition_range> range = my_ranges.next_partition_range()) {
-        // Note that because of issue #9167 we need to run a separate
-        // query on each partition range, and can't pass several of
-        // them into one partition_range_vector.
-        dht::partition_range_vector partition_ranges;
-        partition_ranges.push_back(std::move(*range));
-        // FIXME: if scanning a single range fails, including network errors,
-        // we fail the entire scan (and rescan from the beginning). Need to
-        // reconsider this. Saving the scan position might be a good enough
-        // solution for this problem.
-        co_await scan_table_ranges(proxy, scan_ctx, std::move(partition_ranges), abort_source, page_sem, expiration_stats);
-    }
     // If each node only scans its own primary ranges, then when any node is
     // down part of the token range will not get scanned. This can be viewed
     // as acceptable (when the comes back online, it will resume its scan),
@@ -737,15 +844,52 @@ static future<bool> scan_table(
     // ranges. What we do here is that this node will also check expiration
     // on its *secondary* ranges - but only those whose primary owner is down.
     token_ranges_owned_by_this_shard<secondary> my_secondary_ranges(db.real_database(), gossiper, s);
-    while (std::optional<dht::partition_range> range = my_secondary_ranges.next_partition_range()) {
-        expiration_stats.secondary_ranges_scanned++;
-        dht::partition_range_vector partition_ranges;
-        partition_ranges.push_back(std::move(*range));
-        co_await scan_table_ranges(proxy, scan_ctx, std::move(partition_ranges), abort_source, page_sem, expiration_stats);
+    // Once a range failed, the other workers don't start new ones.
+    // FIXME: if scanning a single range fails, including network errors,
+    // we fail the entire scan (and rescan from the beginning). Need to
+    // reconsider this. Saving the scan position might be a good enough
+    // solution for this problem.
+    bool failed = false;
+    auto next_range = [&] () -> std::optional<dht::partition_range> {
+        if (failed) {
+            return std::nullopt;
+        }
+        if (auto range = my_ranges.next_partition_range()) {
+            return range;
+        }
+        auto range = my_secondary_ranges.next_partition_range();
+        if (range) {
+            expiration_stats.secondary_ranges_scanned++;
+        }
+        return range;
+    };
+    // Each worker scans one range at a time, the controller decides how many
+    // of them read pages concurrently. Note that because of issue #9167 we
+    // scan each partition range separately.
+    co_await coroutine::parallel_for_each(boost::irange(size_t(0), controller.max_parallelism()), [&] (size_t) -> future<> {
+        try {
+            while (auto range = next_range()) {
+                co_await scan_table_range(proxy, scan_ctx, std::move(*range), abort_source, controller, expiration_stats, table_stats);
+            }
+        } catch (...) {
+            failed = true;
+            throw;
+        }
+    });
+    if (!abort_source.abort_requested()) {
+        table_stats.last_scan_duration = std::chrono::duration<double>(lowres_clock::now() - start).count();
     }
     co_return true;
 }
 
+void expiration_service::adjust_scan_controller() {
+    const auto& cfg = _db.get_config();
+    _scan_controller.set_max_parallelism(cfg.alternator_ttl_scan_parallelism());
+    _scan_controller.set_rate(cfg.alternator_ttl_scan_rows_per_second());
+    // The scans run in the maintenance scheduling group, and so are not
+    // admitted by the user semaphore: its waiters are user reads only.
+    _scan_controller.adjust(_proxy.local_db().user_read_concurrency_semaphore().get_stats().waiters > 0);
+}
 
 future<> expiration_service::run() {
     // FIXME: don't just tight-loop, think about timing, pace, and
@@ -762,13 +906,18 @@ future<> expiration_service::run() {
         for (auto cf : _db.get_tables()) {
             schemas.push_back(cf.schema());
         }
+        std::erase_if(_table_stats, [this] (const auto& x) {
+            return !_db.try_find_table(x.first);
+        });
         for (schema_ptr s : schemas) {
             co_await coroutine::maybe_yield();
             if (shutting_down()) {
                 co_return;
             }
             try {
-                co_await scan_table(_proxy, _db, _gossiper, s, _abort_source, _page_sem, _expiration_stats);
+                if (!co_await scan_table(_proxy, _db, _gossiper, s, _abort_source, _scan_controller, _expiration_stats, _table_stats)) {
+                    _table_stats.erase(s->id());
+                }
             } catch (...) {
                 // The scan of a table may fail in the middle for many
                 // reasons, including network failure and even the table
@@ -788,12 +937,9 @@ future<> expiration_service::run() {
             }
         }
         _expiration_stats.scan_passes++;
-        // The TTL scanner runs above once over all tables, at full steam.
-        // After completing such a scan, we sleep until it's time start
-        // another scan. TODO: If the scan went too fast, we can slow it down
-        // in the next iteration by reducing the scanner's scheduling-group
-        // share (if using a separate scheduling group), or introduce
-        // finer-grain sleeps into the scanning code.
+        // The TTL scanner runs above once over all tables, at the pace set
+        // by _scan_controller. After completing such a scan, we sleep until
+        // it's time start another scan.
         std::chrono::milliseconds scan_duration(std::chrono::duration_cast<std::chrono::milliseconds>(lowres_clock::now() - start));
         std::chrono::milliseconds period(long(_db.get_config().alternator_ttl_period_in_seconds() * 1000));
         if (scan_duration < period) {
@@ -812,6 +958,8 @@ future<> expiration_service::start() {
     // thread. Just runs run() in the background and allows stop().
     if (_db.features().alternator_ttl) {
         if (!shutting_down()) {
+            adjust_scan_controller();
+            _adjust_timer.arm_periodic(std::chrono::seconds(1));
             _end = run().handle_exception([] (std::exception_ptr ep) {
                 tlogger.error("expiration_service failed: {}", ep);
             });
@@ -825,6 +973,7 @@ future<> expiration_service::stop() {
         throw std::logic_error("expiration_service::stop() called a second time");
     }
     _abort_source.request_abort();
+    _adjust_timer.cancel();
     if (!_end) {
         // if _end is was not set, start() was never called
         return make_ready_future<>();
@@ -840,10 +989,26 @@ expiration_service::stats::stats() {
             seastar::metrics::description("number of table scans (counting each scan of each table that enabled expiration)")),
         seastar::metrics::make_total_operations("items_deleted", items_deleted,
             seastar::metrics::description("number of items deleted after expiration")),
+        seastar::metrics::make_total_operations("items_scanned", items_scanned,
+            seastar::metrics::description("number of items read by expiration scans")),
         seastar::metrics::make_total_operations("secondary_ranges_scanned", secondary_ranges_scanned,
             seastar::metrics::description("number of token ranges scanned by this node while their primary owner was down")),
     });
 }
 
+expiration_service::table_stats::table_stats(const schema& s) {
+    static seastar::metrics::label column_family_label("cf");
+    static seastar::metrics::label keyspace_label("ks");
+    auto cf = column_family_label(s.cf_name());
+    auto ks = keyspace_label(s.ks_name());
+    _metrics.add_group("expiration", {
+        seastar::metrics::make_total_operations("table_items_scanned", items_scanned,
+            seastar::metrics::description("number of items of the table read by expiration scans"))(cf)(ks),
+        seastar::metrics::make_total_operations("table_items_deleted", items_deleted,
+            seastar::metrics::description("number of items of the table deleted after expiration"))(cf)(ks),
+        seastar::metrics::make_gauge("table_scan_duration_seconds", last_scan_duration,
+            seastar::metrics::description("how long the last complete expiration scan of the table took, in seconds"))(cf)(ks),
+    });
+}
 
 } // namespace alternator
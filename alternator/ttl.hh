@@ -8,11 +8,14 @@
 
 #pragma once
 
+#include <unordered_map>
 #include "seastarx.hh"
 #include <seastar/core/sharded.hh>
 #include <seastar/core/abort_source.hh>
-#include <seastar/core/semaphore.hh>
+#include <seastar/core/lowres_clock.hh>
+#include <seastar/core/timer.hh>
 #include "data_dictionary/data_dictionary.hh"
+#include "alternator/ttl_scan_controller.hh"
 
 namespace gms {
 class gossiper;
@@ -42,12 +45,25 @@ class expiration_service final : public seastar::peering_sharded_service<expirat
         uint64_t scan_passes = 0;
         uint64_t scan_table = 0;
         uint64_t items_deleted = 0;
+        uint64_t items_scanned = 0;
         uint64_t secondary_ranges_scanned = 0;
     private:
         // The metric_groups object holds this stat object's metrics registered
         // as long as the stats object is alive.
         seastar::metrics::metric_groups _metrics;
     };
+    // Per-shard statistics of the expiration of one table, registered with
+    // the table's keyspace and name as labels. Dropped along with the table.
+    class table_stats {
+    public:
+        explicit table_stats(const schema& s);
+        uint64_t items_scanned = 0;
+        uint64_t items_deleted = 0;
+        // How long the last complete scan of the table took, in seconds.
+        double last_scan_duration = 0;
+    private:
+        seastar::metrics::metric_groups _metrics;
+    };
 private:
     data_dictionary::database _db;
     service::storage_proxy& _proxy;
@@ -57,10 +73,15 @@ class expiration_service final : public seastar::peering_sharded_service<expirat
     // should be triggered. stop() below uses both _abort_source and _end.
     std::optional<future<>> _end;
     abort_source _abort_source;
-    // Ensures that at most 1 page of scan results at a time is processed by the TTL service
-    named_semaphore _page_sem{1, named_semaphore_exception_factory{"alternator_ttl"}};
+    // Paces the scans of this shard, see ttl_scan_controller.
+    ttl_scan_controller _scan_controller;
+    // Adjusts _scan_controller to the user workload and the configuration.
+    timer<lowres_clock> _adjust_timer;
     bool shutting_down() { return _abort_source.abort_requested(); }
     stats _expiration_stats;
+    std::unordered_map<table_id, table_stats> _table_stats;
+private:
+    void adjust_scan_controller();
 public:
     // sharded_service<expiration_service>::start() creates this object on
     // all shards, so calls this constructor on each shard. Later, the
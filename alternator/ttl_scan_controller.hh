@@ -0,0 +1,204 @@
+/*
+ * Copyright 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include <seastar/core/abort_source.hh>
+#include <seastar/core/chunked_fifo.hh>
+#include <seastar/core/future.hh>
+#include <seastar/core/sleep.hh>
+
+namespace alternator {
+
+// Paces the expiration scans of a shard, so that they take the capacity which
+// the user workload leaves to them, and catch up quickly on tables holding
+// many expired items.
+//
+// Up to parallelism() token ranges of the scanned table are read at a time.
+// The parallelism is halved whenever user reads are found queueing, and grows
+// back by one range at a time while they aren't, see adjust(). While the pages
+// read recently were dense with expired items, see observe_page(), it isn't
+// halved below half the maximum: expired items left in place are skipped by
+// every user read of their partitions, so removing them is worth some of the
+// user workload's capacity.
+//
+// Scans also charge the items they read to a token bucket, refilled at the
+// configured rate scaled by the parallelism, and by up to twice that rate as
+// the density of expired items grows.
+class ttl_scan_controller {
+public:
+    using clock_type = std::chrono::steady_clock;
+    // The fraction of expired items read, above which scans are dense.
+    static constexpr double dense = 0.5;
+    struct stats {
+        uint64_t backoffs = 0;
+        uint64_t throttled_items = 0;
+    };
+    // Frees a slot of the controller when destroyed.
+    class permit {
+        ttl_scan_controller* _controller;
+    public:
+        explicit permit(ttl_scan_controller& controller) noexcept : _controller(&controller) {}
+        permit(permit&& o) noexcept : _controller(std::exchange(o._controller, nullptr)) {}
+        permit& operator=(permit&& o) noexcept {
+            if (this != &o) {
+                release();
+                _controller = std::exchange(o._controller, nullptr);
+            }
+            return *this;
+        }
+        ~permit() {
+            release();
+        }
+        void release() noexcept {
+            if (_controller) {
+                std::exchange(_controller, nullptr)->signal();
+            }
+        }
+    };
+private:
+    size_t _max_parallelism;
+    size_t _parallelism;
+    size_t _running = 0;
+    // Not empty only while _running >= _parallelism.
+    seastar::chunked_fifo<seastar::promise<permit>> _waiters;
+    // Items per second refilled at full parallelism, 0 for unlimited.
+    uint64_t _rate = 0;
+    double _tokens = 0;
+    clock_type::time_point _last_refill;
+    // Exponential moving average of the fraction of expired items in the
+    // pages read from the table being scanned.
+    double _density = 0;
+    stats _stats;
+private:
+    void signal() noexcept {
+        --_running;
+        maybe_admit();
+    }
+
+    void maybe_admit() noexcept {
+        while (!_waiters.empty() && _running < _parallelism) {
+            ++_running;
+            _waiters.front().set_value(permit(*this));
+            _waiters.pop_front();
+        }
+    }
+public:
+    explicit ttl_scan_controller(size_t max_parallelism) noexcept
+        : _max_parallelism(std::max(max_parallelism, size_t(1)))
+        , _parallelism(_max_parallelism)
+    { }
+
+    ttl_scan_controller(const ttl_scan_controller&) = delete;
+    ttl_scan_controller& operator=(const ttl_scan_controller&) = delete;
+
+    void set_max_parallelism(size_t max_parallelism) noexcept {
+        _max_parallelism = std::max(max_parallelism, size_t(1));
+        _parallelism = std::min(_parallelism, _max_parallelism);
+        maybe_admit();
+    }
+
+    // Resolves once a page can be read and its expired items deleted, for
+    // as long as the permit is held.
+    seastar::future<permit> acquire() {
+        if (_running < _parallelism) {
+            ++_running;
+            return seastar::make_ready_future<permit>(permit(*this));
+        }
+        _waiters.emplace_back();
+        return _waiters.back().get_future();
+    }
+
+    // Called periodically with whether the user workload is busy.
+    void adjust(bool foreground_busy) noexcept {
+        if (foreground_busy) {
+            auto floor = _density >= dense ? std::max(_max_parallelism / 2, size_t(1)) : size_t(1);
+            if (_parallelism > floor) {
+                _parallelism = std::max(_parallelism / 2, floor);
+                ++_stats.backoffs;
+            }
+        } else if (_parallelism < _max_parallelism) {
+            ++_parallelism;
+            maybe_admit();
+        }
+    }
+
+    // Records that a page of items items, of which expired were expired, was
+    // read from the table being scanned.
+    void observe_page(uint64_t items, uint64_t expired) noexcept {
+        if (items) {
+            _density = 0.75 * _density + 0.25 * double(expired) / items;
+        }
+    }
+
+    // Called when the scan of a table begins, since its density of expired
+    // items says nothing of the previous table's.
+    void begin_table() noexcept {
+        _density = 0;
+    }
+
+    // Sets the rate, in items per second, at which items can be read at full
+    // parallelism, 0 for unlimited.
+    void set_rate(uint64_t items_per_second) noexcept {
+        _rate = items_per_second;
+    }
+
+    double effective_rate() const noexcept {
+        return double(_rate) * _parallelism / _max_parallelism * (1 + _density);
+    }
+
+    // Takes items from the bucket, returning how long the caller has to
+    // wait for them to be refilled. Up to a second worth of items is kept
+    // while scans are idle.
+    clock_type::duration consume(uint64_t items, clock_type::time_point now) noexcept {
+        if (!_rate) {
+            return clock_type::duration::zero();
+        }
+        auto rate = effective_rate();
+        auto elapsed = std::chrono::duration<double>(now - _last_refill).count();
+        _last_refill = now;
+        _tokens = std::min(_tokens + elapsed * rate, rate) - items;
+        if (_tokens >= 0) {
+            return clock_type::duration::zero();
+        }
+        _stats.throttled_items += items;
+        return std::chrono::duration_cast<clock_type::duration>(std::chrono::duration<double>(-_tokens / rate));
+    }
+
+    seastar::future<> throttle(uint64_t items, seastar::abort_source& as) {
+        auto delay = consume(items, clock_type::now());
+        if (delay <= clock_type::duration::zero()) {
+            return seastar::make_ready_future<>();
+        }
+        return seastar::sleep_abortable(delay, as);
+    }
+
+    size_t max_parallelism() const noexcept {
+        return _max_parallelism;
+    }
+
+    size_t parallelism() const noexcept {
+        return _parallelism;
+    }
+
+    double density() const noexcept {
+        return _density;
+    }
+
+    const stats& get_stats() const noexcept {
+        return _stats;
+    }
+};
+
+} // namespace alternator
@@ -66,6 +66,14 @@ future<> set_server_init(http_context& ctx) {
     });
 }
 
+future<> set_server_cpu_profiler(http_context& ctx, sharded<utils::cpu_profiler>& cpu_profiler) {
+    return ctx.http_server.set_routes([&ctx, &cpu_profiler] (routes& r) { set_cpu_profiler(ctx, r, cpu_profiler); });
+}
+
+future<> unset_server_cpu_profiler(http_context& ctx) {
+    return ctx.http_server.set_routes([&ctx] (routes& r) { unset_cpu_profiler(ctx, r); });
+}
+
 future<> set_server_config(http_context& ctx, const db::config& cfg) {
     auto rb02 = std::make_shared < api_registry_builder20 > (ctx.api_doc, "/v2");
     return ctx.http_server.set_routes([&ctx, &cfg, rb02](routes& r) {
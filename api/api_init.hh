@@ -39,6 +39,8 @@ class snitch_ptr;
 
 } // namespace locator
 
+namespace utils { class cpu_profiler; }
+
 namespace cql_transport { class controller; }
 class thrift_controller;
 namespace db {
@@ -84,6 +86,8 @@ struct http_context {
 
 future<> set_server_init(http_context& ctx);
 future<> set_server_config(http_context& ctx, const db::config& cfg);
+future<> set_server_cpu_profiler(http_context& ctx, sharded<utils::cpu_profiler>& cpu_profiler);
+future<> unset_server_cpu_profiler(http_context& ctx);
 future<> set_server_snitch(http_context& ctx, sharded<locator::snitch_ptr>& snitch);
 future<> unset_server_snitch(http_context& ctx);
 future<> set_server_storage_service(http_context& ctx, sharded<service::storage_service>& ss, sharded<gms::gossiper>& g, sharded<cdc::generation_service>& cdc_gs, sharded<db::system_keyspace>& sys_ks);
@@ -432,6 +432,30 @@ void set_column_family(http_context& ctx, routes& r, sharded<db::system_keyspace
         return get_cf_stats(ctx, &replica::column_family_stats::memtable_switch_count);
     });
 
+    cf::get_memtable_flushed_bytes.set(r, [&ctx] (std::unique_ptr<http::request> req) {
+        return get_cf_stats(ctx, req->param["name"], &replica::column_family_stats::memtable_flushed_bytes);
+    });
+
+    cf::get_all_memtable_flushed_bytes.set(r, [&ctx] (std::unique_ptr<http::request> req) {
+        return get_cf_stats(ctx, &replica::column_family_stats::memtable_flushed_bytes);
+    });
+
+    cf::get_compaction_bytes_read.set(r, [&ctx] (std::unique_ptr<http::request> req) {
+        return get_cf_stats(ctx, req->param["name"], &replica::column_family_stats::compaction_bytes_read);
+    });
+
+    cf::get_all_compaction_bytes_read.set(r, [&ctx] (std::unique_ptr<http::request> req) {
+        return get_cf_stats(ctx, &replica::column_family_stats::compaction_bytes_read);
+    });
+
+    cf::get_compaction_bytes_written.set(r, [&ctx] (std::unique_ptr<http::request> req) {
+        return get_cf_stats(ctx, req->param["name"], &replica::column_family_stats::compaction_bytes_written);
+    });
+
+    cf::get_all_compaction_bytes_written.set(r, [&ctx] (std::unique_ptr<http::request> req) {
+        return get_cf_stats(ctx, &replica::column_family_stats::compaction_bytes_written);
+    });
+
     // FIXME: this refers to partitions, not rows.
     cf::get_estimated_row_size_histogram.set(r, [&ctx] (std::unique_ptr<http::request> req) {
         return map_reduce_cf(ctx, req->param["name"], utils::estimated_histogram(0), [](replica::column_family& cf) {
@@ -848,6 +872,27 @@ void set_column_family(http_context& ctx, routes& r, sharded<db::system_keyspace
         utils::estimated_histogram_merge, utils_json::estimated_histogram());
     });
 
+    cf::get_row_cache_miss_sstables_read_histogram.set(r, [&ctx] (std::unique_ptr<http::request> req) {
+        return map_reduce_cf(ctx, req->param["name"], utils::estimated_histogram(0), [](replica::column_family& cf) {
+            return cf.get_row_cache().stats().miss_sstables_read_histogram;
+        },
+        utils::estimated_histogram_merge, utils_json::estimated_histogram());
+    });
+
+    cf::get_row_cache_miss_bytes_read_histogram.set(r, [&ctx] (std::unique_ptr<http::request> req) {
+        return map_reduce_cf(ctx, req->param["name"], utils::estimated_histogram(0), [](replica::column_family& cf) {
+            return cf.get_row_cache().stats().miss_bytes_read_histogram;
+        },
+        utils::estimated_histogram_merge, utils_json::estimated_histogram());
+    });
+
+    cf::get_row_cache_miss_index_pages_read_histogram.set(r, [&ctx] (std::unique_ptr<http::request> req) {
+        return map_reduce_cf(ctx, req->param["name"], utils::estimated_histogram(0), [](replica::column_family& cf) {
+            return cf.get_row_cache().stats().miss_index_pages_read_histogram;
+        },
+        utils::estimated_histogram_merge, utils_json::estimated_histogram());
+    });
+
     cf::get_tombstone_scanned_histogram.set(r, [&ctx] (std::unique_ptr<http::request> req) {
         return get_cf_histogram(ctx, req->param["name"], &replica::column_family_stats::tombstone_scanned);
     });
@@ -1058,6 +1103,12 @@ void unset_column_family(http_context& ctx, routes& r) {
     cf::get_all_cf_all_memtables_live_data_size.unset(r);
     cf::get_memtable_switch_count.unset(r);
     cf::get_all_memtable_switch_count.unset(r);
+    cf::get_memtable_flushed_bytes.unset(r);
+    cf::get_all_memtable_flushed_bytes.unset(r);
+    cf::get_compaction_bytes_read.unset(r);
+    cf::get_all_compaction_bytes_read.unset(r);
+    cf::get_compaction_bytes_written.unset(r);
+    cf::get_all_compaction_bytes_written.unset(r);
     cf::get_estimated_row_size_histogram.unset(r);
     cf::get_estimated_row_count.unset(r);
     cf::get_estimated_column_count_histogram.unset(r);
@@ -1124,6 +1175,9 @@ void unset_column_family(http_context& ctx, routes& r) {
     cf::get_cas_propose.unset(r);
     cf::get_cas_commit.unset(r);
     cf::get_sstables_per_read_histogram.unset(r);
+    cf::get_row_cache_miss_sstables_read_histogram.unset(r);
+    cf::get_row_cache_miss_bytes_read_histogram.unset(r);
+    cf::get_row_cache_miss_index_pages_read_histogram.unset(r);
     cf::get_tombstone_scanned_histogram.unset(r);
     cf::get_live_scanned_histogram.unset(r);
     cf::get_col_update_time_delta_histogram.unset(r);
@@ -75,6 +75,21 @@ future_json_function get_server_getter(sharded<netw::messaging_service>& ms, std
     };
 }
 
+template <typename Result>
+static void set_latencies(Result& res, const messaging_service::verb_send_latencies& l) {
+    res.serialization_samples = l.serialization.count();
+    res.serialization_mean = l.serialization.mean();
+    res.serialization_p99 = l.serialization.quantile(0.99);
+    res.round_trip_samples = l.round_trip.count();
+    res.round_trip_mean = l.round_trip.mean();
+    res.round_trip_p99 = l.round_trip.quantile(0.99);
+}
+
+static void merge(messaging_service::verb_send_latencies& a, const messaging_service::verb_send_latencies& b) {
+    a.serialization.merge(b.serialization);
+    a.round_trip.merge(b.round_trip);
+}
+
 void set_messaging_service(http_context& ctx, routes& r, sharded<netw::messaging_service>& ms) {
     get_timeout_messages.set(r, get_client_getter(ms, [](const shard_info& c) {
         return c.get_stats().timeout;
@@ -111,6 +126,70 @@ void set_messaging_service(http_context& ctx, routes& r, sharded<netw::messaging
         return c.sent_messages;
     }));
 
+    get_verb_latencies.set(r, [&ms](std::unique_ptr<request> req) {
+        using stats_vector = std::vector<messaging_service::verb_stats>;
+        return ms.map_reduce0([] (messaging_service& ms) {
+            stats_vector res(num_verb);
+            for (auto i = 0; i < num_verb; i++) {
+                res[i] = ms.get_verb_stats(messaging_verb(i));
+            }
+            return res;
+        }, stats_vector(num_verb), [] (stats_vector a, const stats_vector& b) {
+            for (auto i = 0; i < num_verb; i++) {
+                a[i].in_flight += b[i].in_flight;
+                a[i].handlers_in_flight += b[i].handlers_in_flight;
+                merge(a[i].send, b[i].send);
+                a[i].handler.merge(b[i].handler);
+            }
+            return a;
+        }).then([] (stats_vector stats) {
+            std::vector<verb_latencies> res;
+            for (auto i = 0; i < num_verb; i++) {
+                auto& st = stats[i];
+                if (!st.in_flight && !st.handlers_in_flight && !st.send.round_trip.count() && !st.handler.count()) {
+                    continue;
+                }
+                verb_latencies l;
+                l.verb = sstring(to_string(messaging_verb(i)));
+                l.in_flight = st.in_flight;
+                l.handlers_in_flight = st.handlers_in_flight;
+                set_latencies(l, st.send);
+                l.handler_samples = st.handler.count();
+                l.handler_mean = st.handler.mean();
+                l.handler_p99 = st.handler.quantile(0.99);
+                res.push_back(std::move(l));
+            }
+            return make_ready_future<json::json_return_type>(std::move(res));
+        });
+    });
+
+    get_peer_verb_latencies.set(r, [&ms](std::unique_ptr<request> req) {
+        using map_type = messaging_service::peer_verb_latencies;
+        return ms.map_reduce0([] (messaging_service& ms) {
+            return ms.get_peer_verb_latencies();
+        }, map_type(), [] (map_type a, const map_type& b) {
+            for (auto& [peer, verbs] : b) {
+                auto& a_verbs = a[peer];
+                for (auto& [verb, l] : verbs) {
+                    merge(a_verbs[verb], l);
+                }
+            }
+            return a;
+        }).then([] (map_type map) {
+            std::vector<peer_verb_latencies> res;
+            for (auto& [peer, verbs] : map) {
+                for (auto& [verb, l] : verbs) {
+                    peer_verb_latencies pl;
+                    pl.peer = fmt::to_string(peer);
+                    pl.verb = sstring(to_string(verb));
+                    set_latencies(pl, l);
+                    res.push_back(std::move(pl));
+                }
+            }
+            return make_ready_future<json::json_return_type>(std::move(res));
+        });
+    });
+
     get_version.set(r, [&ms](const_req req) {
         return ms.local().get_raw_version(req.get_query_param("addr"));
     });
@@ -153,6 +232,8 @@ void unset_messaging_service(http_context& ctx, routes& r) {
     get_pending_messages.unset(r);
     get_respond_pending_messages.unset(r);
     get_respond_completed_messages.unset(r);
+    get_verb_latencies.unset(r);
+    get_peer_verb_latencies.unset(r);
     get_version.unset(r);
     get_dropped_messages_by_ver.unset(r);
 }
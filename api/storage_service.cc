@@ -1433,6 +1433,23 @@ void set_snapshot(http_context& ctx, routes& r, sharded<db::snapshot_ctl>& snap_
         });
     });
 
+    ss::start_backup.set(r, [&snap_ctl](std::unique_ptr<http::request> req) -> future<json::json_return_type> {
+        apilog.info("start_backup: {}", req->query_parameters);
+        auto endpoint = req->get_query_param("endpoint");
+        auto bucket = req->get_query_param("bucket");
+        auto prefix = req->get_query_param("prefix");
+        auto keyspace = req->get_query_param("kn");
+        auto table = req->get_query_param("cf");
+        auto tag = req->get_query_param("tag");
+        try {
+            auto task_id = co_await snap_ctl.local().start_backup(std::move(endpoint), std::move(bucket), std::move(prefix), std::move(keyspace), std::move(table), std::move(tag));
+            co_return json::json_return_type(task_id.to_sstring());
+        } catch (...) {
+            apilog.error("start_backup failed: {}", std::current_exception());
+            throw;
+        }
+    });
+
     ss::scrub.set(r, [&ctx, &snap_ctl] (std::unique_ptr<http::request> req) -> future<json::json_return_type> {
         auto& db = ctx.db;
         auto rp = req_params({
@@ -1533,6 +1550,7 @@ void unset_snapshot(http_context& ctx, routes& r) {
     ss::take_snapshot.unset(r);
     ss::del_snapshot.unset(r);
     ss::true_snapshots_size.unset(r);
+    ss::start_backup.unset(r);
     ss::scrub.unset(r);
 }
 
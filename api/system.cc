@@ -10,9 +10,11 @@
 #include "api/api.hh"
 
 #include <seastar/core/reactor.hh>
+#include <seastar/coroutine/maybe_yield.hh>
 #include <seastar/http/exception.hh>
 #include "log.hh"
 #include "replica/database.hh"
+#include "utils/cpu_profiler.hh"
 
 extern logging::logger apilog;
 
@@ -83,4 +85,54 @@ void set_system(http_context& ctx, routes& r) {
     });
 }
 
+static sstring cpu_profile_frame_name(const seastar::frame& f) {
+    // The addresses of the executable itself are printed alone, as in seastar's backtraces.
+    if (!f.so || f.so->name.empty()) {
+        return format("0x{:x}", f.addr);
+    }
+    return format("{}+0x{:x}", f.so->name, f.addr);
+}
+
+void set_cpu_profiler(http_context& ctx, routes& r, sharded<utils::cpu_profiler>& cpu_profiler) {
+    hs::get_cpu_profile.set(r, [&ctx, &cpu_profiler] (std::unique_ptr<request> req) -> future<json::json_return_type> {
+        bool reset = req->get_query_param("reset") == "true";
+        auto shard_stacks = co_await cpu_profiler.map([reset] (utils::cpu_profiler& p) {
+            auto stacks = p.local_stacks();
+            if (reset) {
+                p.reset();
+            }
+            return stacks;
+        });
+        utils::cpu_profiler::stacks stacks;
+        for (auto& s : shard_stacks) {
+            for (auto& [stack, count] : s) {
+                stacks[stack] += count;
+            }
+            co_await coroutine::maybe_yield();
+        }
+        auto& db = ctx.db.local();
+        std::ostringstream out;
+        for (auto& [stack, count] : stacks) {
+            out << stack.scheduling_group << ';';
+            if (stack.table == utils::UUID()) {
+                out << '-';
+            } else if (auto id = table_id(stack.table); db.column_family_exists(id)) {
+                auto s = db.find_schema(id);
+                out << s->ks_name() << '.' << s->cf_name();
+            } else {
+                out << stack.table;
+            }
+            for (auto& f : stack.frames) {
+                out << ';' << cpu_profile_frame_name(f);
+            }
+            out << ' ' << count << '\n';
+        }
+        co_return json::json_return_type(out.str());
+    });
+}
+
+void unset_cpu_profiler(http_context& ctx, routes& r) {
+    hs::get_cpu_profile.unset(r);
+}
+
 }
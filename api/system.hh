@@ -10,8 +10,14 @@
 
 #include "api.hh"
 
+namespace utils {
+class cpu_profiler;
+}
+
 namespace api {
 
 void set_system(http_context& ctx, httpd::routes& r);
+void set_cpu_profiler(http_context& ctx, httpd::routes& r, sharded<utils::cpu_profiler>& cpu_profiler);
+void unset_cpu_profiler(http_context& ctx, httpd::routes& r);
 
 }
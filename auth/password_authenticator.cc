@@ -17,6 +17,7 @@
 #include <optional>
 
 #include <boost/algorithm/cxx11/all_of.hpp>
+#include <seastar/core/metrics.hh>
 #include <seastar/core/seastar.hh>
 
 #include "auth/authenticated_user.hh"
@@ -24,9 +25,11 @@
 #include "auth/passwords.hh"
 #include "auth/roles-metadata.hh"
 #include "cql3/untyped_result_set.hh"
+#include "db/config.hh"
 #include "log.hh"
 #include "service/migration_manager.hh"
 #include "utils/class_registrator.hh"
+#include "utils/hashers.hh"
 #include "replica/database.hh"
 #include "cql3/query_processor.hh"
 
@@ -57,6 +60,9 @@ password_authenticator::password_authenticator(cql3::query_processor& qp, ::serv
     : _qp(qp)
     , _migration_manager(mm)
     , _stopped(make_ready_future<>()) {
+    std::random_device rd;
+    _digest_key = sstring(32, '\0');
+    std::generate(_digest_key.begin(), _digest_key.end(), [&rd] { return char(rd()); });
 }
 
 static bool has_salted_hash(const cql3::untyped_result_set_row& row) {
@@ -123,6 +129,16 @@ future<> password_authenticator::create_default_if_missing() const {
 }
 
 future<> password_authenticator::start() {
+    namespace sm = seastar::metrics;
+    _metrics.add_group("authentication", {
+        sm::make_counter("password_cache_hits", [this] { return _cache_stats.hits; },
+                sm::description("Counts the logins whose password matched a remembered one, without hashing it.")),
+        sm::make_counter("password_cache_misses", [this] { return _cache_stats.misses; },
+                sm::description("Counts the logins whose password had to be hashed to be verified.")),
+        sm::make_gauge("password_cache_entries", [this] { return _verified_passwords.size(); },
+                sm::description("Holds the number of roles whose password is remembered.")),
+    });
+
      return once_among_shards([this] {
          auto f = create_metadata_table_if_missing(
                  meta::roles_table::name,
@@ -219,7 +235,7 @@ future<authenticated_user> password_authenticator::authenticate(
             if (!res->empty()) {
                 salted_hash = res->one().get_opt<sstring>(SALTED_HASH);
             }
-            if (!salted_hash || !passwords::check(password, *salted_hash)) {
+            if (!salted_hash || !check_password(username, password, *salted_hash)) {
                 throw exceptions::authentication_exception("Username and/or password are incorrect");
             }
             return make_ready_future<authenticated_user>(username);
@@ -235,6 +251,45 @@ future<authenticated_user> password_authenticator::authenticate(
     });
 }
 
+std::array<uint8_t, 32> password_authenticator::password_digest(const sstring& password) const {
+    sha256_hasher h;
+    h.update(_digest_key.data(), _digest_key.size());
+    h.update(password.data(), password.size());
+    return h.finalize_array();
+}
+
+bool password_authenticator::check_password(const sstring& role_name, const sstring& password, const sstring& salted_hash) const {
+    const auto& cfg = _qp.db().get_config();
+    auto validity = std::chrono::milliseconds(cfg.authentication_cache_validity_in_ms());
+    if (validity.count() == 0) {
+        _verified_passwords.clear();
+        return passwords::check(password, salted_hash);
+    }
+
+    auto now = lowres_clock::now();
+    auto digest = password_digest(password);
+    if (auto it = _verified_passwords.find(role_name); it != _verified_passwords.end()) {
+        if (it->second.expiry <= now || it->second.salted_hash != salted_hash) {
+            _verified_passwords.erase(it);
+        } else if (it->second.password_digest == digest) {
+            ++_cache_stats.hits;
+            return true;
+        }
+    }
+
+    ++_cache_stats.misses;
+    if (!passwords::check(password, salted_hash)) {
+        return false;
+    }
+    if (_verified_passwords.size() >= cfg.authentication_cache_max_entries()) {
+        std::erase_if(_verified_passwords, [now] (const auto& e) { return e.second.expiry <= now; });
+    }
+    if (_verified_passwords.size() < cfg.authentication_cache_max_entries()) {
+        _verified_passwords.insert_or_assign(role_name, verified_password{salted_hash, digest, now + validity});
+    }
+    return true;
+}
+
 future<> password_authenticator::create(std::string_view role_name, const authentication_options& options) const {
     if (!options.password) {
         return make_ready_future<>();
@@ -252,6 +307,7 @@ future<> password_authenticator::alter(std::string_view role_name, const authent
     if (!options.password) {
         return make_ready_future<>();
     }
+    _verified_passwords.erase(sstring(role_name));
 
     static const sstring query = format("UPDATE {} SET {} = ? WHERE {} = ?",
             meta::roles_table::qualified_name,
@@ -267,6 +323,7 @@ future<> password_authenticator::alter(std::string_view role_name, const authent
 }
 
 future<> password_authenticator::drop(std::string_view name) const {
+    _verified_passwords.erase(sstring(name));
     static const sstring query = format("DELETE {} FROM {} WHERE {} = ?",
             SALTED_HASH,
             meta::roles_table::qualified_name,
@@ -10,7 +10,11 @@
 
 #pragma once
 
+#include <unordered_map>
+
 #include <seastar/core/abort_source.hh>
+#include <seastar/core/lowres_clock.hh>
+#include <seastar/core/metrics_registration.hh>
 
 #include "auth/authenticator.hh"
 
@@ -29,10 +33,35 @@ namespace auth {
 extern const std::string_view password_authenticator_name;
 
 class password_authenticator : public authenticator {
+public:
+    struct cache_stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+    };
+
+private:
+    // A password which was verified against the salted hash of a role.
+    //
+    // Verifying a password hashes it with the expensive algorithm of the
+    // salted hash, so a storm of reconnections can saturate the CPU. The
+    // salted hash is still read on every login, and a remembered password
+    // matches only as long as it is unchanged, so changing or dropping the
+    // role invalidates the entry on all the shards. The password itself is
+    // kept as a digest keyed with a random per-shard key.
+    struct verified_password {
+        sstring salted_hash;
+        std::array<uint8_t, 32> password_digest;
+        lowres_clock::time_point expiry;
+    };
+
     cql3::query_processor& _qp;
     ::service::migration_manager& _migration_manager;
     future<> _stopped;
     seastar::abort_source _as;
+    sstring _digest_key;
+    mutable std::unordered_map<sstring, verified_password> _verified_passwords;
+    mutable cache_stats _cache_stats;
+    seastar::metrics::metric_groups _metrics;
 
 public:
     static db::consistency_level consistency_for_user(std::string_view role_name);
@@ -67,7 +96,15 @@ class password_authenticator : public authenticator {
 
     virtual ::shared_ptr<sasl_challenge> new_sasl_challenge() const override;
 
+    const cache_stats& get_cache_stats() const noexcept {
+        return _cache_stats;
+    }
+
 private:
+    std::array<uint8_t, 32> password_digest(const sstring& password) const;
+
+    bool check_password(const sstring& role_name, const sstring& password, const sstring& salted_hash) const;
+
     bool legacy_metadata_exists() const;
 
     future<> migrate_legacy_metadata() const;
@@ -35,4 +35,13 @@ future<permission_set> permissions_cache::get(const role_or_anonymous& maybe_rol
     });
 }
 
+future<> permissions_cache::insert(const role_or_anonymous& maybe_role, const resource& r, permission_set perms) {
+    return do_with(key_type(maybe_role, r), [this, perms](const auto& k) {
+        _cache.remove(k);
+        return _cache.get_ptr(k, [perms] (const key_type&) {
+            return make_ready_future<permission_set>(perms);
+        }).discard_result();
+    });
+}
+
 }
@@ -67,6 +67,9 @@ class permissions_cache final {
     bool update_config(utils::loading_cache_config);
     void reset();
     future<permission_set> get(const role_or_anonymous&, const resource&);
+
+    // Replaces the cached permissions of the role on the resource, without loading them.
+    future<> insert(const role_or_anonymous&, const resource&, permission_set);
 };
 
 }
@@ -121,7 +121,8 @@ service::service(
             , _permissions_cache_config_action([this] { update_cache_config(); return make_ready_future<>(); })
             , _permissions_cache_max_entries_observer(_qp.db().get_config().permissions_cache_max_entries.observe(_permissions_cache_cfg_cb))
             , _permissions_cache_update_interval_in_ms_observer(_qp.db().get_config().permissions_update_interval_in_ms.observe(_permissions_cache_cfg_cb))
-            , _permissions_cache_validity_in_ms_observer(_qp.db().get_config().permissions_validity_in_ms.observe(_permissions_cache_cfg_cb)) {}
+            , _permissions_cache_validity_in_ms_observer(_qp.db().get_config().permissions_validity_in_ms.observe(_permissions_cache_cfg_cb))
+            , _permissions_preload_action([this] { return preload_permissions_cache(); }) {}
 
 service::service(
         utils::loading_cache_config c,
@@ -172,15 +173,26 @@ future<> service::start(::service::migration_manager& mm) {
     }).then([this] {
         return once_among_shards([this] {
             _mnotifier.register_listener(_migration_listener.get());
+            _permissions_preloaded = do_after_system_ready(_as, [this] {
+                return preload_permissions_cache();
+            });
             return make_ready_future<>();
         });
     });
 }
 
 future<> service::stop() {
+    _as.request_abort();
     // Only one of the shards has the listener registered, but let's try to
     // unregister on each one just to make sure.
     return _mnotifier.unregister_listener(_migration_listener.get()).then([this] {
+        return std::exchange(_permissions_preloaded, make_ready_future<>()).handle_exception_type([] (const sleep_aborted&) {
+        }).handle_exception_type([] (const abort_requested_exception&) {});
+    }).then([this] {
+        return _permissions_preload_gate.close();
+    }).then([this] {
+        return _permissions_preload_action.join();
+    }).then([this] {
         if (_permissions_cache) {
             return _permissions_cache->stop();
         }
@@ -208,6 +220,81 @@ void service::reset_authorization_cache() {
     _qp.reset_cache();
 }
 
+future<std::vector<permission_details>> service::compute_permissions_to_preload() const {
+    std::vector<permission_details> granted;
+    try {
+        granted = co_await _authorizer->list_all();
+    } catch (const unsupported_authorization_operation&) {
+        co_return std::vector<permission_details>();
+    }
+
+    // The permissions granted directly to each role, and the resources whose
+    // permissions are checked when accessing the ones they were granted on.
+    std::unordered_map<sstring, std::unordered_map<resource, permission_set>> granted_by_role;
+    resource_set resources;
+    for (auto& pd : granted) {
+        granted_by_role[pd.role_name][pd.resource] = pd.permissions;
+        resources.merge(expand_resource_family(pd.resource));
+    }
+
+    const size_t max_entries = _qp.db().get_config().permissions_cache_max_entries();
+    std::vector<permission_details> effective;
+    for (const auto& role_name : co_await _role_manager->query_all()) {
+        const bool superuser = co_await has_superuser(role_name);
+        const auto roles = co_await get_roles(role_name);
+        for (const auto& r : resources) {
+            if (effective.size() == max_entries) {
+                co_return effective;
+            }
+            auto perms = permission_set();
+            if (superuser) {
+                perms = r.applicable_permissions();
+            } else {
+                for (const auto& granted_role : roles) {
+                    if (auto it = granted_by_role.find(granted_role); it != granted_by_role.end()) {
+                        if (auto pit = it->second.find(r); pit != it->second.end()) {
+                            perms = permission_set::from_mask(perms.mask() | pit->second.mask());
+                        }
+                    }
+                }
+            }
+            effective.push_back(permission_details{role_name, r, perms});
+        }
+    }
+    co_return effective;
+}
+
+future<> service::preload_permissions_cache() const {
+    if (_authorizer->qualified_java_name() == allow_all_authorizer_name || !_qp.db().get_config().permissions_validity_in_ms()) {
+        co_return;
+    }
+    const auto& c = container();
+    co_await smp::submit_to(0, [&c] () -> future<> {
+        // Computed once and only copied by the shards.
+        const auto permissions = co_await c.local().compute_permissions_to_preload();
+        co_await smp::invoke_on_all([&c, &permissions] () -> future<> {
+            const auto& s = c.local();
+            for (const auto& pd : permissions) {
+                if (!s._permissions_cache || s._as.abort_requested()) {
+                    co_return;
+                }
+                co_await s._permissions_cache->insert(role_or_anonymous(pd.role_name), pd.resource, pd.permissions);
+            }
+        });
+        log.debug("Preloaded {} permissions", permissions.size());
+    });
+}
+
+void service::request_permissions_cache_preload() const {
+    (void)with_gate(_permissions_preload_gate, [&c = container()] {
+        return smp::submit_to(0, [&c] {
+            return c.local()._permissions_preload_action.trigger_later();
+        });
+    }).handle_exception([] (std::exception_ptr ep) {
+        log.warn("Failed to preload the permissions cache: {}", ep);
+    });
+}
+
 future<bool> service::has_existing_legacy_users() const {
     if (!_qp.db().has_schema(meta::AUTH_KS, meta::USERS_CF)) {
         return make_ready_future<bool>(false);
@@ -491,6 +578,8 @@ future<> drop_role(const service& ser, std::string_view name) {
         return ser.underlying_authenticator().drop(name);
     }).then([&ser, name] {
         return ser.underlying_role_manager().drop(name);
+    }).then([&ser] {
+        ser.request_permissions_cache_preload();
     });
 }
 
@@ -516,6 +605,8 @@ future<> grant_permissions(
         const resource& r) {
     return validate_role_exists(ser, role_name).then([&ser, role_name, perms, &r] {
         return ser.underlying_authorizer().grant(role_name, perms, r);
+    }).then([&ser] {
+        ser.request_permissions_cache_preload();
     });
 }
 
@@ -537,6 +628,8 @@ future<> revoke_permissions(
         const resource& r) {
     return validate_role_exists(ser, role_name).then([&ser, role_name, perms, &r] {
         return ser.underlying_authorizer().revoke(role_name, perms, r);
+    }).then([&ser] {
+        ser.request_permissions_cache_preload();
     });
 }
 
@@ -12,7 +12,9 @@
 #include <memory>
 #include <optional>
 
+#include <seastar/core/abort_source.hh>
 #include <seastar/core/future.hh>
+#include <seastar/core/gate.hh>
 #include <seastar/core/sstring.hh>
 #include <seastar/util/bool_class.hh>
 #include <seastar/core/sharded.hh>
@@ -93,6 +95,12 @@ class service final : public seastar::peering_sharded_service<service> {
     utils::observer<uint32_t> _permissions_cache_update_interval_in_ms_observer;
     utils::observer<uint32_t> _permissions_cache_validity_in_ms_observer;
 
+    // Preloading of the permissions cache, which runs on shard 0.
+    seastar::abort_source _as;
+    future<> _permissions_preloaded = make_ready_future<>();
+    mutable serialized_action _permissions_preload_action;
+    mutable seastar::gate _permissions_preload_gate;
+
 public:
     service(
             utils::loading_cache_config,
@@ -122,6 +130,19 @@ class service final : public seastar::peering_sharded_service<service> {
 
     void reset_authorization_cache();
 
+    ///
+    /// Computes, on shard 0, the permissions of every role on every resource it may have been granted permissions
+    /// on, and loads them into the permissions cache of all the shards, so that requests do not wait for them to be
+    /// loaded. At most permissions_cache_max_entries of them are loaded.
+    ///
+    future<> preload_permissions_cache() const;
+
+    ///
+    /// Schedules a preload of the permissions cache after a change of the permissions or of the role grants.
+    /// Preloads requested while one is running are coalesced into the next one.
+    ///
+    void request_permissions_cache_preload() const;
+
     ///
     /// \returns an exceptional future with \ref nonexistant_role if the named role does not exist.
     ///
@@ -164,6 +185,9 @@ class service final : public seastar::peering_sharded_service<service> {
 private:
     future<bool> has_existing_legacy_users() const;
 
+    // The effective permissions of the roles, aggregated over the granted roles, rather than the granted ones.
+    future<std::vector<permission_details>> compute_permissions_to_preload() const;
+
     future<> create_keyspace_if_missing(::service::migration_manager& mm) const;
 };
 
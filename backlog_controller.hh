@@ -13,6 +13,7 @@
 #include <seastar/core/file.hh>
 #include <chrono>
 #include <cmath>
+#include <optional>
 
 #include "seastarx.hh"
 
@@ -70,6 +71,9 @@ class backlog_controller {
     // When that option is deprecated we should remove this.
     float _static_shares;
 
+    float _last_backlog = 0;
+    float _last_shares = 0;
+
     virtual void update_controller(float quota);
 
     bool controller_disabled() const noexcept {
@@ -96,6 +100,52 @@ class backlog_controller {
 public:
     backlog_controller(backlog_controller&&) = default;
     float backlog_of_shares(float shares) const;
+
+    // The last backlog fed to the controller, and the shares it set in return.
+    float last_backlog() const noexcept {
+        return _last_backlog;
+    }
+    float shares() const noexcept {
+        return _last_shares;
+    }
+};
+
+// Forecasts how much a monotonic counter, like the number of bytes written, grows
+// over a short horizon. Its rate is smoothed with Holt's linear method: both the
+// rate and its trend are smoothed, so that a rising rate is extrapolated forward
+// rather than followed one sample behind.
+class rate_forecaster {
+    using clock = std::chrono::steady_clock;
+    float _alpha;
+    float _beta;
+    std::optional<std::pair<uint64_t, clock::time_point>> _last_sample;
+    // Per second, and per second squared.
+    float _rate = 0;
+    float _trend = 0;
+public:
+    explicit rate_forecaster(float alpha = 0.5, float beta = 0.3) noexcept : _alpha(alpha), _beta(beta) {}
+
+    void sample(uint64_t value, clock::time_point now = clock::now()) noexcept {
+        // A counter which went backwards was reset, and is sampled anew.
+        if (_last_sample && now > _last_sample->second && value >= _last_sample->first) {
+            auto elapsed = std::chrono::duration<float>(now - _last_sample->second).count();
+            auto observed = (value - _last_sample->first) / elapsed;
+            auto previous = _rate;
+            _rate = _alpha * observed + (1 - _alpha) * std::max(0.0f, _rate + _trend * elapsed);
+            _trend = _beta * (_rate - previous) / elapsed + (1 - _beta) * _trend;
+        }
+        _last_sample.emplace(value, now);
+    }
+
+    float rate() const noexcept {
+        return _rate;
+    }
+
+    // Returns how much the counter is expected to grow within horizon.
+    float forecast(std::chrono::duration<float> horizon) const noexcept {
+        auto h = horizon.count();
+        return std::max(0.0f, (_rate + _trend * h / 2) * h);
+    }
 };
 
 // memtable flush CPU controller.
@@ -397,10 +397,40 @@ future<> cache_flat_mutation_reader::read_from_underlying() {
                 auto same_pos = _next_row.maybe_refresh();
                 clogger.trace("csm {}: underlying done, in_range={}, same={}, next={}", fmt::ptr(this), _next_row_in_range, same_pos, _next_row);
                 if (!same_pos) {
-                    _read_context.cache().on_mispopulate(); // FIXME: Insert dummy entry at _lower_bound.
+                    // Rows were inserted or evicted concurrently, so _next_row may no longer be adjacent to
+                    // the range we read from underlying. Close that range with a dummy at _lower_bound,
+                    // so that it stays continuous and only what follows is read from underlying again.
+                    if (!_read_context.is_reversed() && can_populate() && ensure_population_lower_bound()) {
+                        with_allocator(_snp->region().allocator(), [&] {
+                            const schema& table_s = table_schema();
+                            rows_entry::tri_compare cmp(table_s);
+                            auto& rows = _snp->version()->partition().mutable_clustered_rows();
+                            auto e = alloc_strategy_unique_ptr<rows_entry>(
+                                current_allocator().construct<rows_entry>(table_s, to_table_domain(_lower_bound), is_dummy::yes, is_continuous::no));
+                            // Use _next_row iterator only as a hint, because there could be insertions before it.
+                            auto insert_result = rows.insert_before_hint(_next_row.get_iterator_in_latest_version(), std::move(e), cmp);
+                            auto it = insert_result.first;
+                            if (insert_result.second) {
+                                clogger.trace("csm {}: L{}: inserted dummy at {}", fmt::ptr(this), __LINE__, it->position());
+                                _snp->tracker()->insert(*it);
+                            }
+                            clogger.trace("csm {}: set_continuous({}), prev={}, rt={}", fmt::ptr(this), it->position(), _last_row.position(), _current_tombstone);
+                            it->set_continuous(true);
+                            it->set_range_tombstone(_current_tombstone);
+                            with_allocator(standard_allocator(), [&] {
+                                _last_row = partition_snapshot_row_weakref(*_snp, it, true);
+                            });
+                            _population_range_starts_before_all_rows = false;
+                        });
+                        _next_row.maybe_refresh();
+                    } else {
+                        _read_context.cache().on_mispopulate();
+                        if (!_next_row.continuous()) {
+                            _last_row = nullptr; // We did not populate the full range up to _lower_bound, break continuity
+                        }
+                    }
                     _next_row_in_range = !after_current_range(_next_row.position());
                     if (!_next_row.continuous()) {
-                        _last_row = nullptr; // We did not populate the full range up to _lower_bound, break continuity
                         start_reading_from_underlying();
                     }
                     return;
@@ -606,6 +636,9 @@ void cache_flat_mutation_reader::maybe_add_to_cache(const clustering_row& cr) {
         it = insert_result.first;
         if (insert_result.second) {
             _snp->tracker()->insert(*it);
+            if (_snp->tracker()->pack_rows() && !_read_context.digest_requested() && it->pack(table_schema())) {
+                _snp->tracker()->on_row_packed();
+            }
         }
 
         rows_entry& e = *it;
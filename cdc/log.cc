@@ -21,6 +21,7 @@
 #include "cdc/change_visitor.hh"
 #include "cdc/metadata.hh"
 #include "cdc/cdc_partitioner.hh"
+#include "cdc/preimage_cache.hh"
 #include "bytes.hh"
 #include "replica/database.hh"
 #include "db/schema_tables.hh"
@@ -116,6 +117,11 @@ cdc::stats::stats() {
     };
     register_counters(counters_total, "total");
     register_counters(counters_failed, "failed");
+    _metrics.add_group(cdc_group_name, {
+            sm::make_total_operations("preimage_cache_hits", preimage_cache_hits,
+                    sm::description("number of preimages taken from the images of rows written recently, instead of being queried"),
+                    {})
+        });
 }
 
 cdc::operation_result_tracker::~operation_result_tracker() {
@@ -138,12 +144,23 @@ cdc::operation_result_tracker::~operation_result_tracker() {
     if (_failed) {
         update_stats(_stats.counters_failed);
     }
+    for (auto& f : _on_finished) {
+        try {
+            f(_failed);
+        } catch (...) {
+            cdc_log.warn("Failed to complete CDC operation: {}", std::current_exception());
+        }
+    }
 }
 
 class cdc::cdc_service::impl : service::migration_listener::empty_listener {
     friend cdc_service;
     db_context _ctxt;
     bool _stopped = false;
+    // Shared with the operations, which update it once their writes finish.
+    lw_shared_ptr<preimage_cache> _preimage_cache = make_lw_shared<preimage_cache>();
+    // Shared with the operations, which notify them once their writes succeed.
+    lw_shared_ptr<std::vector<change_subscriber*>> _change_subscribers = make_lw_shared<std::vector<change_subscriber*>>();
 public:
     impl(db_context ctxt)
         : _ctxt(std::move(ctxt))
@@ -804,9 +821,6 @@ static managed_bytes merge(const abstract_type& type, const managed_bytes_opt& p
     throw std::runtime_error(format("cdc merge: unknown type {}", type.name()));
 }
 
-using cell_map = std::unordered_map<const column_definition*, managed_bytes_opt>;
-using row_states_map = std::unordered_map<clustering_key, cell_map, clustering_key::hashing, clustering_key::equality>;
-
 static managed_bytes_opt get_col_from_row_state(const cell_map* state, const column_definition& cdef) {
     if (state) {
         if (auto it = state->find(&cdef); it != state->end()) {
@@ -1741,6 +1755,43 @@ class transformer final : public change_processor {
         }
     }
 
+    // Loads the preimage of the rows written by m from their cached image,
+    // which has all of them, instead of the results of pre_image_select().
+    void load_image(const preimage_cache::partition_image& image, const mutation& m) {
+        const auto& p = m.partition();
+        if (!p.static_row().empty()) {
+            _static_row_state = *image.static_row;
+        }
+        for (const rows_entry& r : p.clustered_rows()) {
+            if (auto& cells = image.rows.at(r.key())) {
+                _clustering_row_states.insert_or_assign(r.key(), *cells);
+            }
+        }
+    }
+
+    // The image of the rows written by m once it's applied, taken from the
+    // states which produced its postimage. Must be called after m was
+    // processed, on tables with postimage enabled.
+    preimage_cache::partition_image image_after(const mutation& m) const {
+        preimage_cache::partition_image image(_schema);
+        const auto& p = m.partition();
+        if (!p.static_row().empty()) {
+            image.static_row = _static_row_state;
+        }
+        for (const rows_entry& r : p.clustered_rows()) {
+            auto it = _clustering_row_states.find(r.key());
+            if (it == _clustering_row_states.end()) {
+                image.rows.emplace(r.key(), std::nullopt);
+            } else if (!it->second.empty()) {
+                image.rows.emplace(r.key(), it->second);
+            } else {
+                // The row may or may not exist, depending on its row marker.
+                image.unknown_rows.push_back(r.key());
+            }
+        }
+        return image;
+    }
+
     /** For preimage query use the same CL as for base write, except for CLs ANY and ALL. */
     static db::consistency_level adjust_cl(db::consistency_level write_cl) {
         if (write_cl == db::consistency_level::ANY) {
@@ -1754,6 +1805,44 @@ class transformer final : public change_processor {
     }
 };
 
+// Merges the log mutations, which follow the first base_mutations mutations,
+// of the same stream partition, so that each stream partition is written
+// once per operation, however many base partitions and changes map to it.
+static void coalesce_log_mutations(std::vector<mutation>& mutations, size_t base_mutations) {
+    if (mutations.size() - base_mutations < 2) {
+        return;
+    }
+    auto log_begin = mutations.begin() + base_mutations;
+    // Streams of different log tables may share tokens.
+    std::stable_sort(log_begin, mutations.end(), [] (const mutation& a, const mutation& b) {
+        auto c = dht::tri_compare(a.token(), b.token());
+        return c < 0 || (c == 0 && a.schema()->id() < b.schema()->id());
+    });
+    auto out = log_begin;
+    for (auto it = std::next(log_begin); it != mutations.end(); ++it) {
+        if (out->schema() == it->schema() && out->decorated_key().equal(*out->schema(), it->decorated_key())) {
+            out->apply(std::move(*it));
+        } else if (++out != it) {
+            *out = std::move(*it);
+        }
+    }
+    mutations.erase(std::next(out), mutations.end());
+}
+
+// The streams written to by the log mutations, which follow the first
+// base_mutations mutations and were coalesced, per log table.
+static std::vector<std::pair<schema_ptr, std::vector<bytes>>> changed_streams(const std::vector<mutation>& mutations, size_t base_mutations) {
+    std::vector<std::pair<schema_ptr, std::vector<bytes>>> changes;
+    for (auto it = mutations.begin() + base_mutations; it != mutations.end(); ++it) {
+        auto c = std::find_if(changes.begin(), changes.end(), [&] (const auto& c) { return c.first == it->schema(); });
+        if (c == changes.end()) {
+            c = changes.emplace(changes.end(), it->schema(), std::vector<bytes>());
+        }
+        c->second.push_back(it->key().explode(*it->schema()).front());
+    }
+    return changes;
+}
+
 template <typename Func>
 future<std::vector<mutation>>
 transform_mutations(std::vector<mutation>& muts, decltype(muts.size()) batch_size, Func&& f) {
@@ -1778,11 +1867,14 @@ cdc::cdc_service::impl::augment_mutation_call(lowres_clock::time_point timeout,
     }
 
     tracing::trace(tr_state, "CDC: Started generating mutations for log rows");
+    const auto base_mutations = mutations.size();
     mutations.reserve(2 * mutations.size());
+    const size_t preimage_cache_size = _ctxt._proxy.get_db().local().get_config().cdc_preimage_cache_size();
 
-    return do_with(std::move(mutations), service::query_state(service::client_state::for_internal_calls(), empty_service_permit()), operation_details{},
-            [this, tr_state = std::move(tr_state), write_cl] (std::vector<mutation>& mutations, service::query_state& qs, operation_details& details) {
-        return transform_mutations(mutations, 1, [this, &mutations, &qs, tr_state = tr_state, &details, write_cl] (int idx) mutable {
+    using image_updates = std::vector<std::pair<partition_key, preimage_cache::partition_image>>;
+    return do_with(std::move(mutations), service::query_state(service::client_state::for_internal_calls(), empty_service_permit()), operation_details{}, image_updates{},
+            [this, tr_state = std::move(tr_state), write_cl, base_mutations, preimage_cache_size] (std::vector<mutation>& mutations, service::query_state& qs, operation_details& details, image_updates& images) {
+        return transform_mutations(mutations, 1, [this, &mutations, &qs, tr_state = tr_state, &details, &images, write_cl, preimage_cache_size] (int idx) mutable {
             auto& m = mutations[idx];
             auto s = m.schema();
 
@@ -1792,8 +1884,16 @@ cdc::cdc_service::impl::augment_mutation_call(lowres_clock::time_point timeout,
 
             transformer trans(_ctxt, s, m.decorated_key());
 
+            // The images of rows are complete, and kept up to date by all
+            // the changes of a write, only when postimage is enabled.
+            const bool cache_images = preimage_cache_size && s->cdc_options().postimage();
+            const preimage_cache::partition_image* cached_image = cache_images ? _preimage_cache->find(m, lowres_clock::now()) : nullptr;
             auto f = make_ready_future<lw_shared_ptr<cql3::untyped_result_set>>(nullptr);
-            if (s->cdc_options().preimage() || s->cdc_options().postimage()) {
+            if (cached_image) {
+                tracing::trace(tr_state, "CDC: Taking preimage of {} from the images of rows written recently", m.decorated_key());
+                trans.load_image(*cached_image, m);
+                _ctxt._proxy.get_cdc_stats().preimage_cache_hits++;
+            } else if (s->cdc_options().preimage() || s->cdc_options().postimage()) {
                 // Note: further improvement here would be to coalesce the pre-image selects into one
                 // iff a batch contains several modifications to the same table. Otoh, batch is rare(?)
                 // so this is premature.
@@ -1810,7 +1910,7 @@ cdc::cdc_service::impl::augment_mutation_call(lowres_clock::time_point timeout,
                 tracing::trace(tr_state, "CDC: Preimage not enabled for the table, not querying current value of {}", m.decorated_key());
             }
 
-            return f.then([trans = std::move(trans), &mutations, idx, tr_state, &details] (lw_shared_ptr<cql3::untyped_result_set> rs) mutable {
+            return f.then([this, trans = std::move(trans), &mutations, idx, tr_state, &details, &images, cache_images] (lw_shared_ptr<cql3::untyped_result_set> rs) mutable {
                 auto& m = mutations[idx];
                 auto& s = m.schema();
 
@@ -1833,6 +1933,14 @@ cdc::cdc_service::impl::augment_mutation_call(lowres_clock::time_point timeout,
                     tracing::trace(tr_state, "CDC: No need to split {}", m.decorated_key());
                     process_changes_without_splitting(m, trans, preimage, postimage);
                 }
+                if (cache_images) {
+                    const auto& p = m.partition();
+                    if (p.partition_tombstone() || !p.row_tombstones().empty()) {
+                        _preimage_cache->invalidate(*s, m.key());
+                    } else {
+                        images.emplace_back(m.key(), trans.image_after(m));
+                    }
+                }
                 auto [log_mut, touched_parts] = std::move(trans).finish();
                 const int generated_count = log_mut.size();
                 mutations.insert(mutations.end(), std::make_move_iterator(log_mut.begin()), std::make_move_iterator(log_mut.end()));
@@ -1841,9 +1949,34 @@ cdc::cdc_service::impl::augment_mutation_call(lowres_clock::time_point timeout,
                 tracing::trace(tr_state, "CDC: Generated {} log mutations from {}", generated_count, mutations[idx].decorated_key());
                 details.touched_parts.add(touched_parts);
             });
-        }).then([this, tr_state, &details](std::vector<mutation> mutations) {
+        }).then([this, tr_state, &details, &images, base_mutations, preimage_cache_size](std::vector<mutation> mutations) {
             tracing::trace(tr_state, "CDC: Finished generating all log mutations");
+            coalesce_log_mutations(mutations, base_mutations);
             auto tracker = make_lw_shared<cdc::operation_result_tracker>(_ctxt._proxy.get_cdc_stats(), details);
+            if (!images.empty()) {
+                tracker->on_finished([cache = _preimage_cache, images = std::move(images), preimage_cache_size] (bool failed) mutable {
+                    const auto now = lowres_clock::now();
+                    for (auto& [pk, image] : images) {
+                        if (failed) {
+                            cache->invalidate(*image.schema, pk);
+                        } else {
+                            cache->update(pk, std::move(image), now, preimage_cache_size);
+                        }
+                    }
+                });
+            }
+            if (!_change_subscribers->empty()) {
+                tracker->on_finished([subscribers = _change_subscribers, changes = changed_streams(mutations, base_mutations)] (bool failed) {
+                    if (failed) {
+                        return;
+                    }
+                    for (auto& [log_schema, stream_ids] : changes) {
+                        for (auto subscriber : *subscribers) {
+                            subscriber->on_cdc_change(*log_schema, stream_ids);
+                        }
+                    }
+                });
+            }
             return make_ready_future<std::tuple<std::vector<mutation>, lw_shared_ptr<cdc::operation_result_tracker>>>(std::make_tuple(std::move(mutations), std::move(tracker)));
         });
     });
@@ -1855,6 +1988,14 @@ bool cdc::cdc_service::needs_cdc_augmentation(const std::vector<mutation>& mutat
     });
 }
 
+void cdc::cdc_service::register_change_subscriber(change_subscriber* subscriber) {
+    _impl->_change_subscribers->push_back(subscriber);
+}
+
+void cdc::cdc_service::unregister_change_subscriber(change_subscriber* subscriber) noexcept {
+    std::erase(*_impl->_change_subscribers, subscriber);
+}
+
 future<std::tuple<std::vector<mutation>, lw_shared_ptr<cdc::operation_result_tracker>>>
 cdc::cdc_service::augment_mutation_call(lowres_clock::time_point timeout, std::vector<mutation>&& mutations, tracing::trace_state_ptr tr_state, db::consistency_level write_cl) {
     return _impl->augment_mutation_call(timeout, std::move(mutations), std::move(tr_state), write_cl);
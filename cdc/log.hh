@@ -62,6 +62,22 @@ class metadata;
 
 bool is_log_name(const std::string_view& table_name);
 
+/// \brief Subscriber to the changes written to CDC log tables
+///
+/// Notified of the writes to CDC log tables coordinated by the shard it
+/// subscribed on, once all the writes of their operation succeeded, so that
+/// consumers can learn which streams have new changes instead of polling
+/// all of them. A write may not yet be visible to reads at all consistency
+/// levels when it's notified.
+class change_subscriber {
+public:
+    virtual ~change_subscriber() = default;
+
+    /// \param stream_ids the serialized stream ids of the partitions of the
+    ///        log table log_schema written to, without duplicates.
+    virtual void on_cdc_change(const schema& log_schema, const std::vector<bytes>& stream_ids) = 0;
+};
+
 /// \brief CDC service, responsible for schema listeners
 ///
 /// CDC service will listen for schema changes and iff CDC is enabled/changed
@@ -87,6 +103,10 @@ class cdc_service final : public async_sharded_service<cdc::cdc_service> {
         db::consistency_level write_cl
         );
     bool needs_cdc_augmentation(const std::vector<mutation>&) const;
+
+    // The subscriber must be unregistered before it's destroyed.
+    void register_change_subscriber(change_subscriber*);
+    void unregister_change_subscriber(change_subscriber*) noexcept;
 };
 
 struct db_context final {
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <chrono>
+#include <list>
+#include <optional>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include <seastar/core/lowres_clock.hh>
+
+#include "keys.hh"
+#include "mutation/mutation.hh"
+#include "schema/schema.hh"
+#include "utils/hash.hh"
+#include "utils/managed_bytes.hh"
+
+namespace cdc {
+
+// The values of the columns of a row, as they appear in the images of the log.
+using cell_map = std::unordered_map<const column_definition*, managed_bytes_opt>;
+using row_states_map = std::unordered_map<clustering_key, cell_map, clustering_key::hashing, clustering_key::equality>;
+
+// Remembers the images of the rows of tables with postimage enabled, as they
+// were right after being written through this shard, so that the preimage of
+// the next writes to them doesn't need to be queried.
+//
+// Like the preimage query, which isn't isolated from concurrent writes,
+// images are best effort. They are only remembered once their write
+// succeeded, and only for a short while, since the rows may also be written
+// through other coordinators and their cells may expire. Writes which
+// delete ranges of rows or whole partitions, and failed writes, make the
+// images of their partition forgotten.
+class preimage_cache {
+public:
+    using clock_type = seastar::lowres_clock;
+    static constexpr std::chrono::milliseconds expiry{1000};
+
+    // The images of some rows of a partition.
+    struct partition_image {
+        // Owns the column definitions the cell maps point to.
+        schema_ptr schema;
+        // Engaged if known.
+        std::optional<cell_map> static_row;
+        // Disengaged for rows known not to exist.
+        std::unordered_map<clustering_key, std::optional<cell_map>, clustering_key::hashing, clustering_key::equality> rows;
+        // Rows written, whose image isn't known, see update().
+        std::vector<clustering_key> unknown_rows;
+
+        explicit partition_image(schema_ptr s)
+            : schema(std::move(s))
+            , rows(0, clustering_key::hashing(*schema), clustering_key::equality(*schema))
+        { }
+    };
+private:
+    using key_type = std::tuple<table_id, managed_bytes>;
+    struct entry {
+        key_type key;
+        partition_image image;
+        clock_type::time_point expires;
+    };
+    // Most recently updated first.
+    std::list<entry> _lru;
+    std::unordered_map<key_type, std::list<entry>::iterator, utils::tuple_hash> _entries;
+private:
+    static key_type key_of(const schema& s, const partition_key& pk) {
+        return {s.id(), managed_bytes(pk.representation())};
+    }
+
+    void erase(decltype(_entries)::iterator it) noexcept {
+        _lru.erase(it->second);
+        _entries.erase(it);
+    }
+public:
+    // Returns the image of the partition written by m, if it has all the rows
+    // m writes, and m doesn't delete ranges of them.
+    const partition_image* find(const mutation& m, clock_type::time_point now) {
+        auto it = _entries.find(key_of(*m.schema(), m.key()));
+        if (it == _entries.end()) {
+            return nullptr;
+        }
+        auto& e = *it->second;
+        if (e.expires <= now || e.image.schema != m.schema()) {
+            erase(it);
+            return nullptr;
+        }
+        const auto& p = m.partition();
+        if (p.partition_tombstone() || !p.row_tombstones().empty()) {
+            return nullptr;
+        }
+        if (!p.static_row().empty() && !e.image.static_row) {
+            return nullptr;
+        }
+        for (const rows_entry& r : p.clustered_rows()) {
+            if (!e.image.rows.contains(r.key())) {
+                return nullptr;
+            }
+        }
+        return &e.image;
+    }
+
+    // Records the images of the rows of a partition after a write to them
+    // succeeded, forgetting the images of its unknown_rows. Evicts the least
+    // recently updated partitions beyond capacity.
+    void update(const partition_key& pk, partition_image image, clock_type::time_point now, size_t capacity) {
+        auto key = key_of(*image.schema, pk);
+        auto it = _entries.find(key);
+        if (it != _entries.end() && it->second->image.schema == image.schema && it->second->expires > now) {
+            auto& cached = it->second->image;
+            if (image.static_row) {
+                cached.static_row = std::move(image.static_row);
+            }
+            for (const auto& ck : image.unknown_rows) {
+                cached.rows.erase(ck);
+            }
+            for (auto& [ck, cells] : image.rows) {
+                cached.rows.insert_or_assign(ck, std::move(cells));
+            }
+            it->second->expires = now + expiry;
+            _lru.splice(_lru.begin(), _lru, it->second);
+        } else {
+            if (it != _entries.end()) {
+                erase(it);
+            }
+            image.unknown_rows.clear();
+            _lru.push_front(entry{key, std::move(image), now + expiry});
+            _entries.emplace(std::move(key), _lru.begin());
+        }
+        while (_entries.size() > capacity) {
+            erase(_entries.find(_lru.back().key));
+        }
+    }
+
+    void invalidate(const schema& s, const partition_key& pk) {
+        auto it = _entries.find(key_of(s, pk));
+        if (it != _entries.end()) {
+            erase(it);
+        }
+    }
+
+    size_t size() const noexcept {
+        return _entries.size();
+    }
+};
+
+}
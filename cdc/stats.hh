@@ -11,7 +11,9 @@
 #include <array>
 #include <cstdint>
 #include <string>
+#include <vector>
 #include <seastar/core/metrics_registration.hh>
+#include <seastar/util/noncopyable_function.hh>
 #include "enum_set.hh"
 #include "utils/histogram.hh"
 #include "utils/estimated_histogram.hh"
@@ -72,6 +74,7 @@ class stats final {
 
     counters counters_total;
     counters counters_failed;
+    uint64_t preimage_cache_hits = 0;
 
     stats();
 };
@@ -90,6 +93,7 @@ class operation_result_tracker final {
     stats& _stats;
     operation_details _details;
     bool _failed;
+    std::vector<seastar::noncopyable_function<void(bool)>> _on_finished;
 
 public:
     operation_result_tracker(stats& stats, operation_details details)
@@ -102,6 +106,11 @@ class operation_result_tracker final {
     void on_mutation_failed() {
         _failed = true;
     }
+
+    // Called with whether the operation failed, once all its write handlers finished.
+    void on_finished(seastar::noncopyable_function<void(bool failed)> f) {
+        _on_finished.push_back(std::move(f));
+    }
 };
 
 }
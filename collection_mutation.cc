@@ -365,6 +365,76 @@ collection_mutation difference(const abstract_type& type, collection_mutation_vi
     });
 }
 
+// The comparator of the keys of a collection, or of the field indexes of a user type.
+static const abstract_type& collection_key_type(const abstract_type& type) {
+    return visit(type, make_visitor(
+    [] (const collection_type_impl& ctype) -> const abstract_type& {
+        return *ctype.name_comparator();
+    },
+    [] (const user_type_impl& utype) -> const abstract_type& {
+        return *short_type;
+    },
+    [] (const abstract_type& o) -> const abstract_type& {
+        throw std::runtime_error(format("collection_mutation_view_index: unknown type {}", o.name()));
+    }
+    ));
+}
+
+collection_mutation_view_index::collection_mutation_view_index(const abstract_type& type, collection_mutation_view cmv)
+        : _type(type) {
+    // Validates the type before anything is read.
+    collection_key_type(type);
+
+    auto in = collection_mutation_input_stream(cmv.data);
+    auto has_tomb = in.read_trivial<uint8_t>();
+    if (has_tomb) {
+        auto ts = in.read_trivial<api::timestamp_type>();
+        auto ttl = in.read_trivial<gc_clock::duration::rep>();
+        _tomb = tombstone{ts, gc_clock::time_point(gc_clock::duration(ttl))};
+    }
+
+    auto nr = in.read_trivial<uint32_t>();
+    _entries.reserve(nr);
+    for (uint32_t i = 0; i != nr; ++i) {
+        auto ksize = in.read_trivial<uint32_t>();
+        auto key = in.read_fragmented(ksize);
+        auto vsize = in.read_trivial<uint32_t>();
+        auto value = in.read_fragmented(vsize);
+        _entries.push_back(entry{key, value});
+    }
+}
+
+std::pair<managed_bytes_view, atomic_cell_view> collection_mutation_view_index::operator[](size_t i) const {
+    auto& e = _entries[i];
+    return visit(_type, make_visitor(
+    [&] (const collection_type_impl& ctype) {
+        return std::make_pair(e.key, atomic_cell_view::from_bytes(*ctype.value_comparator(), e.value));
+    },
+    [&] (const user_type_impl& utype) {
+        return std::make_pair(e.key, atomic_cell_view::from_bytes(*utype.type(deserialize_field_index(e.key)), e.value));
+    },
+    [] (const abstract_type& o) -> std::pair<managed_bytes_view, atomic_cell_view> {
+        throw std::runtime_error(format("collection_mutation_view_index: unknown type {}", o.name()));
+    }
+    ));
+}
+
+size_t collection_mutation_view_index::lower_bound(managed_bytes_view key) const {
+    auto& key_type = collection_key_type(_type);
+    auto it = std::partition_point(_entries.begin(), _entries.end(), [&] (const entry& e) {
+        return key_type.compare(e.key, key) < 0;
+    });
+    return it - _entries.begin();
+}
+
+std::optional<atomic_cell_view> collection_mutation_view_index::find(managed_bytes_view key) const {
+    auto i = lower_bound(key);
+    if (i == _entries.size() || !collection_key_type(_type).equal(_entries[i].key, key)) {
+        return std::nullopt;
+    }
+    return (*this)[i].second;
+}
+
 template <typename F>
 requires std::is_invocable_r_v<std::pair<bytes_view, atomic_cell_view>, F, collection_mutation_input_stream&>
 static collection_mutation_view_description
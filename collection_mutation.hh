@@ -14,6 +14,7 @@
 #include "mutation/atomic_cell.hh"
 #include <iosfwd>
 #include <forward_list>
+#include <optional>
 
 class abstract_type;
 class compaction_garbage_collector;
@@ -105,6 +106,34 @@ class collection_mutation_view {
     };
 };
 
+// An index over the cells of a serialized collection mutation, sorted by key like the cells themselves.
+// Building it is a single pass over the length prefixes of the cells which doesn't parse any value;
+// after that, a single element can be looked up in O(log n) without deserializing the whole collection.
+// Observes the serialized data, which has to outlive the index.
+class collection_mutation_view_index {
+    struct entry {
+        managed_bytes_view key;
+        managed_bytes_view value;
+    };
+    const abstract_type& _type;
+    tombstone _tomb;
+    utils::chunked_vector<entry> _entries;
+public:
+    collection_mutation_view_index(const abstract_type&, collection_mutation_view);
+
+    tombstone tomb() const { return _tomb; }
+    size_t size() const { return _entries.size(); }
+
+    // The key and cell at position `i`, in key order.
+    std::pair<managed_bytes_view, atomic_cell_view> operator[](size_t i) const;
+
+    // The position of the first cell whose key is not less than `key`, or size() if there is none.
+    size_t lower_bound(managed_bytes_view key) const;
+
+    // The cell stored under `key`, if any.
+    std::optional<atomic_cell_view> find(managed_bytes_view key) const;
+};
+
 // A serialized mutation of a collection of cells.
 // Used to represent mutations of collections (lists, maps, sets) or non-frozen user defined types.
 // It contains a sequence of cells, each representing a mutation of a single entry (element or field) of the collection.
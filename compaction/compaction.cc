@@ -53,6 +53,7 @@
 #include "utils/error_injection.hh"
 #include "readers/filtering.hh"
 #include "readers/compacting.hh"
+#include "readers/combined.hh"
 #include "tombstone_gc.hh"
 #include "keys.hh"
 
@@ -167,19 +168,28 @@ std::ostream& operator<<(std::ostream& os, pretty_printed_throughput tp) {
     return os;
 }
 
+// max_compacting_timestamp bounds the timestamps of the data being compacted, and
+// so of the tombstones which may be purged.
 static api::timestamp_type get_max_purgeable_timestamp(const table_state& table_s, sstable_set::incremental_selector& selector,
-        const std::unordered_set<shared_sstable>& compacting_set, const dht::decorated_key& dk) {
+        const std::unordered_set<shared_sstable>& compacting_set, const dht::decorated_key& dk, api::timestamp_type max_compacting_timestamp) {
     auto timestamp = table_s.min_memtable_timestamp();
     std::optional<utils::hashed_key> hk;
     for (auto&& sst : boost::range::join(selector.select(dk).sstables, table_s.compacted_undeleted_sstables())) {
         if (compacting_set.contains(sst)) {
             continue;
         }
+        // Probing the filter is the costly part, so skip the sstables which can't change
+        // which tombstones are purged: those whose data is all newer than what already
+        // holds the tombstones back, or than all the data being compacted.
+        auto min_timestamp = sst->get_stats_metadata().min_timestamp;
+        if (min_timestamp >= timestamp || min_timestamp > max_compacting_timestamp) {
+            continue;
+        }
         if (!hk) {
             hk = sstables::sstable::make_hashed_key(*table_s.schema(), dk.key());
         }
         if (sst->filter_has_key(*hk)) {
-            timestamp = std::min(timestamp, sst->get_stats_metadata().min_timestamp);
+            timestamp = min_timestamp;
         }
     }
     return timestamp;
@@ -437,12 +447,93 @@ std::ostream& operator<<(std::ostream& os, const formatted_sstables_list& lst) {
     return os;
 }
 
+// Reads disjoint sstables, sorted by first key, one after the other, moving
+// their buffers as they are, without merging their partitions.
+class concatenated_sstables_reader : public flat_mutation_reader_v2::impl {
+    std::vector<shared_sstable> _sstables;
+    size_t _next = 0;
+    const io_priority_class& _pc;
+    flat_mutation_reader_v2_opt _reader;
+public:
+    concatenated_sstables_reader(schema_ptr s, reader_permit permit, std::vector<shared_sstable> sstables, const io_priority_class& pc)
+        : impl(std::move(s), std::move(permit))
+        , _sstables(std::move(sstables))
+        , _pc(pc)
+    {}
+
+    virtual future<> fill_buffer() override {
+        while (!is_end_of_stream() && !is_buffer_full()) {
+            if (!_reader) {
+                if (_next == _sstables.size()) {
+                    _end_of_stream = true;
+                    break;
+                }
+                // Opened one at a time, so that each sstable is only read once the previous one is done.
+                _reader = _sstables[_next++]->make_reader(_schema, _permit, query::full_partition_range, _schema->full_slice(), _pc,
+                        tracing::trace_state_ptr(), ::streamed_mutation::forwarding::no, ::mutation_reader::forwarding::no);
+            }
+            if (!_reader->is_buffer_empty()) {
+                _reader->move_buffer_content_to(*this);
+            } else if (_reader->is_end_of_stream()) {
+                co_await _reader->close();
+                _reader = std::nullopt;
+            } else {
+                co_await _reader->fill_buffer();
+            }
+        }
+    }
+
+    virtual future<> next_partition() override {
+        clear_buffer_to_next_partition();
+        if (is_buffer_empty() && _reader) {
+            return _reader->next_partition();
+        }
+        return make_ready_future<>();
+    }
+
+    virtual future<> fast_forward_to(const dht::partition_range& pr) override {
+        return make_exception_future<>(make_backtraced_exception_ptr<std::bad_function_call>());
+    }
+
+    virtual future<> fast_forward_to(position_range pr) override {
+        return make_exception_future<>(make_backtraced_exception_ptr<std::bad_function_call>());
+    }
+
+    virtual future<> close() noexcept override {
+        return _reader ? _reader->close() : make_ready_future<>();
+    }
+};
+
+// Splits the sstables into as few chains of disjoint sstables as their overlap allows,
+// each sorted by first key, like streamed sstables which each cover a different range.
+static std::vector<std::vector<shared_sstable>> make_disjoint_chains(const schema& s, std::vector<shared_sstable> sstables) {
+    std::ranges::sort(sstables, [&s] (const shared_sstable& a, const shared_sstable& b) {
+        return a->get_first_decorated_key().tri_compare(s, b->get_first_decorated_key()) < 0;
+    });
+    std::vector<std::vector<shared_sstable>> chains;
+    for (auto& sst : sstables) {
+        // As sstables come by first key, any chain which ends before this one starts will do.
+        auto it = std::ranges::find_if(chains, [&] (const std::vector<shared_sstable>& chain) {
+            return chain.back()->get_last_decorated_key().tri_compare(s, sst->get_first_decorated_key()) < 0;
+        });
+        if (it == chains.end()) {
+            chains.emplace_back();
+            it = std::prev(chains.end());
+        }
+        it->push_back(std::move(sst));
+    }
+    return chains;
+}
+
 class compaction {
 protected:
     compaction_data& _cdata;
     table_state& _table_s;
     compaction_sstable_creator_fn _sstable_creator;
     schema_ptr _schema;
+    // Snapshot of the tombstone gc state, so gc_before of the compacted keys
+    // is looked up in the same flat watermarks for the whole compaction.
+    tombstone_gc_state _tombstone_gc_state;
     reader_permit _permit;
     std::vector<shared_sstable> _sstables;
     std::vector<generation_type> _input_sstable_generations;
@@ -474,11 +565,15 @@ class compaction {
     // optional owned_ranges vector for cleanup;
     owned_ranges_ptr _owned_ranges = {};
     std::optional<dht::incremental_owned_ranges_checker> _owned_ranges_checker;
+    // If engaged, range of the input read by regular compaction.
+    std::optional<dht::partition_range> _partition_range;
     // Garbage collected sstables that are sealed but were not added to SSTable set yet.
     std::vector<shared_sstable> _unused_garbage_collected_sstables;
     // Garbage collected sstables that were added to SSTable set and should be eventually removed from it.
     std::vector<shared_sstable> _used_garbage_collected_sstables;
     utils::observable<> _stop_request_observable;
+    // Input sstables which are copied through to the output, with the sstable each is linked to.
+    std::vector<std::pair<shared_sstable, shared_sstable>> _copied_through;
 private:
     compaction_data& init_compaction_data(compaction_data& cdata, const compaction_descriptor& descriptor) const {
         cdata.compaction_fan_in = descriptor.fan_in();
@@ -490,6 +585,7 @@ class compaction {
         , _table_s(table_s)
         , _sstable_creator(std::move(descriptor.creator))
         , _schema(_table_s.schema())
+        , _tombstone_gc_state(_table_s.get_tombstone_gc_state().with_watermarks(*_schema))
         , _permit(_table_s.make_compaction_reader_permit())
         , _sstables(std::move(descriptor.sstables))
         , _type(descriptor.options.type())
@@ -504,6 +600,7 @@ class compaction {
         , _compacting_for_max_purgeable_func(std::unordered_set<shared_sstable>(_sstables.begin(), _sstables.end()))
         , _owned_ranges(std::move(descriptor.owned_ranges))
         , _owned_ranges_checker(_owned_ranges ? std::optional<dht::incremental_owned_ranges_checker>(*_owned_ranges) : std::nullopt)
+        , _partition_range(std::move(descriptor.partition_range))
     {
         for (auto& sst : _sstables) {
             _stats_collector.update(sst->get_encoding_stats_for_compaction());
@@ -620,7 +717,9 @@ class compaction {
     }
 
     bool enable_garbage_collected_sstable_writer() const noexcept {
-        return _contains_multi_fragment_runs && _max_sstable_size != std::numeric_limits<uint64_t>::max();
+        // A sub-range compaction shares its input with the compactions of the other sub-ranges,
+        // so it can't release input sstables before all of them are done.
+        return _contains_multi_fragment_runs && _max_sstable_size != std::numeric_limits<uint64_t>::max() && !_partition_range;
     }
 
     flat_mutation_reader_v2::filter make_partition_filter() const {
@@ -665,11 +764,76 @@ class compaction {
         return _table_s.get_compaction_strategy().make_sstable_set(_schema);
     }
 
+    // Returns true if input sstables which compaction would rewrite unchanged can be
+    // copied through to the output, see select_sstables_to_copy_through().
+    virtual bool can_copy_through() const {
+        return false;
+    }
+
+    // Picks the input sstables whose partitions compaction would write back unchanged:
+    // those which overlap no other input and have nothing to purge. They fit in a single
+    // output sstable, so they are linked to the output instead of being read and rewritten.
+    // Can't copy through the partitions of an sstable which overlaps another one, as the
+    // data file of the output is encoded against its own serialization header.
+    //
+    // Only sstables promoted to another level are copied through. The copy keeps the run
+    // identifier of its input, so at the same level, it would be left in the shape which
+    // made the strategy pick it, to be picked over and over again.
+    void select_sstables_to_copy_through(const std::unordered_set<shared_sstable>& fully_expired) {
+        if (!can_copy_through()) {
+            return;
+        }
+        auto sorted = _sstables;
+        std::ranges::sort(sorted, [this] (const shared_sstable& a, const shared_sstable& b) {
+            return a->get_first_decorated_key().tri_compare(*_schema, b->get_first_decorated_key()) < 0;
+        });
+        auto now = gc_clock::now();
+        const auto& gc_state = _table_s.get_tombstone_gc_state();
+        std::optional<dht::decorated_key> max_last_key;
+        for (size_t i = 0; i < sorted.size(); ++i) {
+            auto& sst = sorted[i];
+            bool overlaps = (max_last_key && max_last_key->tri_compare(*_schema, sst->get_first_decorated_key()) >= 0)
+                    || (i + 1 < sorted.size() && sorted[i + 1]->get_first_decorated_key().tri_compare(*_schema, sst->get_last_decorated_key()) <= 0);
+            if (!max_last_key || max_last_key->tri_compare(*_schema, sst->get_last_decorated_key()) < 0) {
+                max_last_key = sst->get_last_decorated_key();
+            }
+            if (overlaps || sst->get_sstable_level() == _sstable_level || fully_expired.contains(sst) || sst->is_shared()
+                    || sst->data_size() > _max_sstable_size) {
+                continue;
+            }
+            if (sst->estimate_droppable_tombstone_ratio(sst->get_gc_before_for_drop_estimation(now, gc_state)) > 0) {
+                continue;
+            }
+            auto out = _sstable_creator(this_shard_id());
+            if (!sst->can_link_into(*out)) {
+                continue;
+            }
+            _copied_through.emplace_back(sst, std::move(out));
+        }
+    }
+
+    // Links the sstables picked by select_sstables_to_copy_through() to the output.
+    // Must run in a seastar thread.
+    void copy_through() {
+        for (auto& [sst, out] : _copied_through) {
+            setup_new_sstable(out);
+            sst->link_into(*out, _io_priority).get();
+            out->mutate_sstable_level(_sstable_level).get();
+            log_debug("Copied sstable {} through to {}", sst->get_filename(), out->get_filename());
+            _cdata.total_keys_written += out->get_estimated_key_count();
+            _end_size += out->bytes_on_disk();
+            _new_unused_sstables.push_back(out);
+            _new_partial_sstables.erase(out);
+        }
+    }
+
     future<> setup() {
         auto ssts = make_lw_shared<sstables::sstable_set>(make_sstable_set_for_input());
         formatted_sstables_list formatted_msg;
         auto fully_expired = _table_s.fully_expired_sstables(_sstables, gc_clock::now());
         min_max_tracker<api::timestamp_type> timestamp_tracker;
+        select_sstables_to_copy_through(fully_expired);
+        auto copied_through = boost::copy_range<std::unordered_set<shared_sstable>>(_copied_through | boost::adaptors::map_keys);
 
         _input_sstable_generations.reserve(_sstables.size());
         for (auto& sst : _sstables) {
@@ -691,6 +855,12 @@ class compaction {
                 continue;
             }
 
+            if (copied_through.contains(sst)) {
+                log_debug("Sstable {} will be copied through", sst->get_filename());
+                _rp = std::max(_rp, sst_stats.position);
+                continue;
+            }
+
             // We also capture the sstable, so we keep it alive while the read isn't done
             ssts->insert(sst);
             // FIXME: If the sstables have cardinality estimation bitmaps, use that
@@ -707,9 +877,9 @@ class compaction {
             _rp = std::max(_rp, sst_stats.position);
         }
         log_info("{} {}", report_start_desc(), formatted_msg);
-        if (ssts->size() < _sstables.size()) {
+        if (ssts->size() + _copied_through.size() < _sstables.size()) {
             log_debug("{} out of {} input sstables are fully expired sstables that will not be actually compacted",
-                      _sstables.size() - ssts->size(), _sstables.size());
+                      _sstables.size() - ssts->size() - _copied_through.size(), _sstables.size());
         }
 
         _compacting = std::move(ssts);
@@ -729,8 +899,7 @@ class compaction {
                 reader.consume_in_thread(std::move(cfc));
             });
         });
-        const auto& gc_state = _table_s.get_tombstone_gc_state();
-        return consumer(make_compacting_reader(setup_sstable_reader(), compaction_time, max_purgeable_func(), gc_state));
+        return consumer(make_compacting_reader(setup_sstable_reader(), compaction_time, max_purgeable_func(), _tombstone_gc_state));
     }
 
     future<> consume() {
@@ -750,7 +919,7 @@ class compaction {
                     using compact_mutations = compact_for_compaction_v2<compacted_fragments_writer, compacted_fragments_writer>;
                     auto cfc = compact_mutations(*schema(), now,
                         max_purgeable_func(),
-                        _table_s.get_tombstone_gc_state(),
+                        _tombstone_gc_state,
                         get_compacted_fragments_writer(),
                         get_gc_compacted_fragments_writer());
 
@@ -760,7 +929,7 @@ class compaction {
                 using compact_mutations = compact_for_compaction_v2<compacted_fragments_writer, noop_compacted_fragments_consumer>;
                 auto cfc = compact_mutations(*schema(), now,
                     max_purgeable_func(),
-                    _table_s.get_tombstone_gc_state(),
+                    _tombstone_gc_state,
                     get_compacted_fragments_writer(),
                     noop_compacted_fragments_consumer());
                 reader.consume_in_thread(std::move(cfc));
@@ -784,6 +953,7 @@ class compaction {
                 .ended_at = ended_at,
                 .start_size = _start_size,
                 .end_size = _end_size,
+                .tombstones_retained_for_repair = _tombstone_gc_state.tombstones_retained_for_repair(),
             },
         };
 
@@ -805,6 +975,9 @@ class compaction {
                 _input_sstable_generations.size(), new_sstables_msg, pretty_printed_data_size(_start_size), pretty_printed_data_size(_end_size), int(ratio * 100),
                 std::chrono::duration_cast<std::chrono::milliseconds>(duration).count(), pretty_printed_throughput(_end_size, duration),
                 _cdata.total_partitions, _cdata.total_keys_written);
+        if (ret.stats.tombstones_retained_for_repair) {
+            log_debug("{} tombstones were kept because their token ranges were not repaired yet", ret.stats.tombstones_retained_for_repair);
+        }
 
         return ret;
     }
@@ -823,8 +996,8 @@ class compaction {
                 return api::min_timestamp;
             };
         }
-        return [this] (const dht::decorated_key& dk) {
-            return get_max_purgeable_timestamp(_table_s, *_selector, _compacting_for_max_purgeable_func, dk);
+        return [this, max_compacting_timestamp = _ms_metadata.max_timestamp.value_or(api::max_timestamp)] (const dht::decorated_key& dk) {
+            return get_max_purgeable_timestamp(_table_s, *_selector, _compacting_for_max_purgeable_func, dk, max_compacting_timestamp);
         };
     }
 
@@ -1034,7 +1207,22 @@ class reshape_compaction : public compaction {
         return sstables::make_partitioned_sstable_set(_schema, false);
     }
 
+    // Sstables which don't overlap, like the ones streamed for different ranges, are
+    // concatenated, and only the chains of disjoint sstables are merged.
     flat_mutation_reader_v2 make_sstable_reader() const override {
+        auto all = _compacting->all();
+        auto chains = make_disjoint_chains(*_schema, std::vector<shared_sstable>(all->begin(), all->end()));
+        if (chains.size() < all->size()) {
+            log_debug("Reading {} sstables as {} chains of disjoint sstables", all->size(), chains.size());
+            auto readers = boost::copy_range<std::vector<flat_mutation_reader_v2>>(chains
+                    | boost::adaptors::transformed([this] (std::vector<shared_sstable>& chain) {
+                return make_flat_mutation_reader_v2<concatenated_sstables_reader>(_schema, _permit, std::move(chain), _io_priority);
+            }));
+            if (readers.size() == 1) {
+                return std::move(readers.front());
+            }
+            return make_combined_reader(_schema, _permit, std::move(readers), ::streamed_mutation::forwarding::no, ::mutation_reader::forwarding::no);
+        }
         return _compacting->make_local_shard_sstable_reader(_schema,
                 _permit,
                 query::full_partition_range,
@@ -1083,7 +1271,7 @@ class regular_compaction : public compaction {
     flat_mutation_reader_v2 make_sstable_reader() const override {
         return _compacting->make_local_shard_sstable_reader(_schema,
                 _permit,
-                query::full_partition_range,
+                _partition_range ? *_partition_range : query::full_partition_range,
                 _schema->full_slice(),
                 _io_priority,
                 tracing::trace_state_ptr(),
@@ -1121,6 +1309,12 @@ class regular_compaction : public compaction {
         update_pending_ranges();
     }
 
+    virtual bool can_copy_through() const override {
+        // Cleanup, scrub and the compactions of a sub-range of the input have to read all
+        // of it, and compaction strategies with an interposer may split sstables up.
+        return _type == compaction_type::Compaction && !_owned_ranges && !_partition_range && !use_interposer_consumer();
+    }
+
     virtual void on_end_of_compaction() override {
         replace_remaining_exhausted_sstables();
     }
@@ -1664,11 +1858,11 @@ class resharding_compaction final : public compaction {
 future<compaction_result> compaction::run(std::unique_ptr<compaction> c) {
     return seastar::async([c = std::move(c)] () mutable {
         c->setup().get();
-        auto consumer = c->consume();
 
         auto start_time = db_clock::now();
         try {
-           consumer.get();
+            c->copy_through();
+            c->consume().get();
         } catch (...) {
             c->on_interrupt(std::current_exception());
             c = nullptr; // make sure writers are stopped while running in thread context. This is because of calls to file.close().get();
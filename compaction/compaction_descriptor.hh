@@ -131,6 +131,7 @@ std::ostream& operator<<(std::ostream& os, compaction_type_options::scrub::quara
 
 class dummy_tag {};
 using has_only_fully_expired = seastar::bool_class<dummy_tag>;
+using to_cold_storage = seastar::bool_class<class to_cold_storage_tag>;
 
 struct compaction_descriptor {
     // List of sstables to be compacted.
@@ -151,6 +152,9 @@ struct compaction_descriptor {
     compaction_type_options options = compaction_type_options::make_regular();
     // If engaged, compaction will cleanup the input sstables by skipping non-owned ranges.
     compaction::owned_ranges_ptr owned_ranges;
+    // If engaged, regular compaction only reads the partitions of the input sstables which fall
+    // in this range. Used to split a compaction into concurrent sub-range compactions.
+    std::optional<dht::partition_range> partition_range;
 
     compaction_sstable_creator_fn creator;
     compaction_sstable_replacer_fn replacer;
@@ -160,6 +164,9 @@ struct compaction_descriptor {
     // Denotes if this compaction task is comprised solely of completely expired SSTables
     sstables::has_only_fully_expired has_only_fully_expired = has_only_fully_expired::no;
 
+    // Denotes if the output sstables are to be written to the table's cold storage
+    sstables::to_cold_storage to_cold_storage = to_cold_storage::no;
+
     compaction_descriptor() = default;
 
     static constexpr int default_level = 0;
@@ -24,7 +24,9 @@
 #include "db/system_keyspace.hh"
 #include <cmath>
 #include <boost/algorithm/cxx11/any_of.hpp>
+#include <boost/range/algorithm/count_if.hpp>
 #include <boost/range/algorithm/remove_if.hpp>
+#include <boost/range/irange.hpp>
 
 static logging::logger cmlog("compaction_manager");
 using namespace std::chrono_literals;
@@ -169,6 +171,36 @@ unsigned compaction_manager::current_compaction_fan_in_threshold() const {
     return std::min(unsigned(32), largest_fan_in);
 }
 
+compaction_manager::keyspace_stats& compaction_manager::get_or_create_keyspace_stats(const sstring& ks_name) {
+    auto [it, inserted] = _keyspace_stats.try_emplace(ks_name);
+    auto& ks_stats = it->second;
+    if (inserted && _register_keyspace_metrics) {
+        namespace sm = seastar::metrics;
+        auto ks = sm::label("ks")(ks_name);
+        ks_stats.metrics.add_group("compaction_manager", {
+            sm::make_gauge("keyspace_compactions", [&ks_stats] { return ks_stats.active_tasks; },
+                           sm::description("Holds the number of currently active compactions of the tables of the keyspace."))(ks),
+            sm::make_counter("keyspace_completed_compactions", [&ks_stats] { return ks_stats.completed_tasks; },
+                           sm::description("Holds the number of completed compaction tasks of the tables of the keyspace."))(ks),
+            sm::make_counter("keyspace_compacted_bytes", [&ks_stats] { return ks_stats.compacted_bytes; },
+                           sm::description("Holds the total size of the sstables compacted for the tables of the keyspace."))(ks),
+        });
+    }
+    return ks_stats;
+}
+
+const compaction_manager::keyspace_stats* compaction_manager::get_keyspace_stats(const sstring& ks_name) const {
+    auto it = _keyspace_stats.find(ks_name);
+    return it != _keyspace_stats.end() ? &it->second : nullptr;
+}
+
+size_t compaction_manager::running_regular_compactions(const sstring& ks_name) const {
+    return boost::count_if(_tasks, [&ks_name] (const shared_ptr<compaction_task_executor>& task) {
+        return task->type() == sstables::compaction_type::Compaction && task->compaction_running()
+                && task->compacting_table()->schema()->ks_name() == ks_name;
+    });
+}
+
 bool compaction_manager::can_register_compaction(table_state& t, int weight, unsigned fan_in) const {
     // Only one weight is allowed if parallel compaction is disabled.
     if (!t.get_compaction_strategy().parallel_compaction() && has_table_ongoing_compaction(t)) {
@@ -178,6 +210,11 @@ bool compaction_manager::can_register_compaction(table_state& t, int weight, uns
     if (!weight) {
         return true;
     }
+    // Leave room to the compactions of the other keyspaces, see max_concurrent_compactions_per_keyspace.
+    // The job is reconsidered when one of the running compactions completes.
+    if (auto limit = max_concurrent_compactions_per_keyspace(); limit && running_regular_compactions(t.schema()->ks_name()) >= limit) {
+        return false;
+    }
     // TODO: Maybe allow only *smaller* compactions to start? That can be done
     // by returning true only if weight is not in the set and is lower than any
     // entry in the set.
@@ -291,6 +328,8 @@ compaction_task_executor::compaction_task_executor(compaction_manager& mgr, tabl
     , _compacting_table(t)
     , _compaction_state(_cm.get_compaction_state(t))
     , _type(type)
+    // Exists as long as the table is registered, which the gate holder guarantees.
+    , _keyspace_stats(_cm._keyspace_stats.at(t->schema()->ks_name()))
     , _gate_holder(_compaction_state.gate.hold())
     , _description(std::move(desc))
 {}
@@ -346,20 +385,22 @@ future<sstables::compaction_result> compaction_task_executor::compact_sstables(s
     if (can_purge) {
         descriptor.enable_garbage_collection(t.main_sstable_set());
     }
-    descriptor.creator = [&t] (shard_id dummy) {
-        auto sst = t.make_sstable();
+    descriptor.creator = [&t, cold = descriptor.to_cold_storage] (shard_id dummy) {
+        auto sst = cold ? t.make_cold_sstable() : t.make_sstable();
         return sst;
     };
-    descriptor.replacer = [this, &t, release_exhausted] (sstables::compaction_completion_desc desc) {
-        t.get_compaction_strategy().notify_completion(t, desc.old_sstables, desc.new_sstables);
-        _cm.propagate_replacement(t, desc.old_sstables, desc.new_sstables);
-        auto old_sstables = desc.old_sstables;
-        t.on_compaction_completion(std::move(desc), sstables::offstrategy::no).get();
-        // Calls compaction manager's task for this compaction to release reference to exhausted SSTables.
-        if (release_exhausted) {
-            release_exhausted(old_sstables);
-        }
-    };
+    if (!descriptor.replacer) {
+        descriptor.replacer = [this, &t, release_exhausted] (sstables::compaction_completion_desc desc) {
+            t.get_compaction_strategy().notify_completion(t, desc.old_sstables, desc.new_sstables);
+            _cm.propagate_replacement(t, desc.old_sstables, desc.new_sstables);
+            auto old_sstables = desc.old_sstables;
+            t.on_compaction_completion(std::move(desc), sstables::offstrategy::no).get();
+            // Calls compaction manager's task for this compaction to release reference to exhausted SSTables.
+            if (release_exhausted) {
+                release_exhausted(old_sstables);
+            }
+        };
+    }
 
     // retrieve owned_ranges if_required
     if (!descriptor.owned_ranges) {
@@ -379,7 +420,10 @@ future<sstables::compaction_result> compaction_task_executor::compact_sstables(s
         }
     }
 
-    co_return co_await sstables::compact_sstables(std::move(descriptor), cdata, t);
+    auto res = co_await sstables::compact_sstables(std::move(descriptor), cdata, t);
+    _keyspace_stats.compacted_bytes += res.stats.start_size;
+    _cm._tombstones_retained_for_repair += res.stats.tombstones_retained_for_repair;
+    co_return res;
 }
 future<> compaction_task_executor::update_history(table_state& t, const sstables::compaction_result& res, const sstables::compaction_data& cdata) {
     auto ended_at = std::chrono::duration_cast<std::chrono::milliseconds>(res.stats.ended_at.time_since_epoch());
@@ -422,12 +466,115 @@ class sstables_task_executor : public compaction_task_executor {
     virtual ~sstables_task_executor();
 };
 
+// Splits the token span of the sstables into up to n sub-ranges of about the same width.
+// Returns no ranges if the span can't be split.
+static std::vector<dht::partition_range> split_into_sub_ranges(const std::vector<sstables::shared_sstable>& sstables, unsigned n) {
+    if (sstables.empty() || n <= 1) {
+        return {};
+    }
+    auto first = std::numeric_limits<uint64_t>::max();
+    auto last = std::numeric_limits<uint64_t>::min();
+    for (auto& sst : sstables) {
+        first = std::min(first, dht::unbias(sst->get_first_decorated_key().token()));
+        last = std::max(last, dht::unbias(sst->get_last_decorated_key().token()));
+    }
+    auto width = (last - first) / n;
+    if (width == 0) {
+        return {};
+    }
+    std::vector<dht::partition_range> ranges;
+    ranges.reserve(n);
+    std::optional<dht::partition_range::bound> start;
+    for (unsigned i = 1; i < n; i++) {
+        auto end = dht::ring_position::starting_at(dht::bias(first + i * width));
+        ranges.emplace_back(std::move(start), dht::partition_range::bound(end, false));
+        start = dht::partition_range::bound(std::move(end), true);
+    }
+    ranges.emplace_back(std::move(start), std::nullopt);
+    return ranges;
+}
+
 class major_compaction_task_executor : public compaction_task_executor {
 public:
     major_compaction_task_executor(compaction_manager& mgr, table_state* t)
         : compaction_task_executor(mgr, t, sstables::compaction_type::Compaction, "Major compaction")
     {}
 
+private:
+    // Compacts each of the sub-ranges concurrently, into a run of its own. As the input sstables
+    // are shared by all sub-ranges, they are replaced by the output only once all of them are done.
+    future<> compact_sub_ranges(sstables::compaction_descriptor descriptor, std::vector<dht::partition_range> ranges, release_exhausted_func_t release_exhausted) {
+        table_state& t = *_compacting_table;
+        std::vector<sstables::shared_sstable> new_sstables;
+        std::vector<sstables::compaction_data> cdatas(ranges.size());
+        for (auto& cdata : cdatas) {
+            cdata.compaction_uuid = _compaction_data.compaction_uuid;
+        }
+        auto stop_sub_ranges = [&cdatas] (sstring reason) {
+            for (auto& cdata : cdatas) {
+                cdata.stop(reason);
+            }
+        };
+        auto stop_subscription = _compaction_data.abort.subscribe([this, &stop_sub_ranges] () noexcept {
+            stop_sub_ranges(_compaction_data.stop_requested);
+        });
+        if (stopping()) {
+            stop_sub_ranges(_compaction_data.stop_requested);
+        }
+
+        sstables::compaction_result res;
+        std::exception_ptr ex;
+        co_await coroutine::parallel_for_each(boost::irange(size_t(0), ranges.size()), [&] (size_t i) -> future<> {
+            auto& range = ranges[i];
+            auto overlapping = boost::copy_range<std::vector<sstables::shared_sstable>>(descriptor.sstables
+                    | boost::adaptors::filtered([&] (const sstables::shared_sstable& sst) {
+                auto sst_range = dht::partition_range::make(dht::ring_position(sst->get_first_decorated_key()), dht::ring_position(sst->get_last_decorated_key()));
+                return range.overlaps(sst_range, dht::ring_position_comparator(*t.schema()));
+            }));
+            if (overlapping.empty()) {
+                co_return;
+            }
+            auto desc = sstables::compaction_descriptor(std::move(overlapping), descriptor.io_priority, descriptor.level, descriptor.max_sstable_bytes,
+                    sstables::run_id::create_random_id(), descriptor.options);
+            desc.partition_range = std::move(range);
+            desc.replacer = [&new_sstables] (sstables::compaction_completion_desc completion) {
+                new_sstables.insert(new_sstables.end(), completion.new_sstables.begin(), completion.new_sstables.end());
+            };
+            try {
+                auto sub_range_res = co_await compact_sstables(std::move(desc), cdatas[i], {});
+                res.stats += sub_range_res.stats;
+            } catch (...) {
+                if (!ex) {
+                    ex = std::current_exception();
+                    stop_sub_ranges("Another sub-range of the major compaction failed");
+                }
+            }
+        });
+        if (ex) {
+            // The input sstables weren't replaced, so the output of the sub-ranges that completed is unused.
+            for (auto& sst : new_sstables) {
+                sst->mark_for_deletion();
+            }
+            std::rethrow_exception(ex);
+        }
+
+        auto completion = sstables::compaction_completion_desc{descriptor.sstables, new_sstables};
+        t.get_compaction_strategy().notify_completion(t, completion.old_sstables, completion.new_sstables);
+        _cm.propagate_replacement(t, completion.old_sstables, completion.new_sstables);
+        co_await t.on_compaction_completion(std::move(completion), sstables::offstrategy::no);
+        release_exhausted(descriptor.sstables);
+
+        // Input sstables overlapping with several sub-ranges were accounted by each of them.
+        res.stats.start_size = 0;
+        for (auto& sst : descriptor.sstables) {
+            res.stats.start_size += sst->bytes_on_disk();
+        }
+        res.new_sstables = std::move(new_sstables);
+        if (should_update_history(descriptor.options.type())) {
+            co_await update_history(t, res, _compaction_data);
+        }
+    }
+
 protected:
     // first take major compaction semaphore, then exclusely take compaction lock for table.
     // it cannot be the other way around, or minor compaction for this table would be
@@ -460,7 +607,12 @@ class major_compaction_task_executor : public compaction_task_executor {
         // the exclusive lock can be freed to let regular compaction run in parallel to major
         lock_holder.return_all();
 
-        co_await compact_sstables_and_update_history(std::move(descriptor), _compaction_data, std::move(release_exhausted));
+        auto ranges = split_into_sub_ranges(descriptor.sstables, _cm.major_compaction_parallelism());
+        if (ranges.size() > 1) {
+            co_await compact_sub_ranges(std::move(descriptor), std::move(ranges), std::move(release_exhausted));
+        } else {
+            co_await compact_sstables_and_update_history(std::move(descriptor), _compaction_data, std::move(release_exhausted));
+        }
 
         finish_compaction();
 
@@ -640,6 +792,7 @@ compaction_task_executor::state compaction_task_executor::switch_state(state new
         break;
     case state::active:
         --_cm._stats.active_tasks;
+        --_keyspace_stats.active_tasks;
         break;
     }
     switch (new_state) {
@@ -652,9 +805,11 @@ compaction_task_executor::state compaction_task_executor::switch_state(state new
         break;
     case state::active:
         ++_cm._stats.active_tasks;
+        ++_keyspace_stats.active_tasks;
         break;
     case state::done:
         ++_cm._stats.completed_tasks;
+        ++_keyspace_stats.completed_tasks;
         break;
     }
     cmlog.debug("{}: switch_state: {} -> {}: pending={} active={} done={} errors={}", *this, old_state, new_state,
@@ -728,7 +883,7 @@ compaction_manager::compaction_manager(config cfg, abort_source& as, tasks::task
             // all strategies.
             return compaction_controller::normalization_factor;
         }
-        return b;
+        return b + forecast_backlog();
     }))
     , _backlog_manager(_compaction_controller)
     , _early_abort_subscription(as.subscribe([this] () noexcept {
@@ -790,6 +945,8 @@ future<> compaction_manager::update_throughput(uint32_t value_mbs) {
 void compaction_manager::register_metrics() {
     namespace sm = seastar::metrics;
 
+    _register_keyspace_metrics = true;
+
     _metrics.add_group("compaction_manager", {
         sm::make_gauge("compactions", [this] { return _stats.active_tasks; },
                        sm::description("Holds the number of currently active compactions.")),
@@ -807,6 +964,16 @@ void compaction_manager::register_metrics() {
                        sm::description("Holds the sum of normalized compaction backlog for all tables in the system. Backlog is normalized by dividing backlog by shard's available memory.")),
         sm::make_counter("validation_errors", [this] { return _validation_errors; },
                        sm::description("Holds the number of encountered validation errors.")),
+        sm::make_counter("tombstones_retained_for_repair", [this] { return _tombstones_retained_for_repair; },
+                       sm::description("Holds the number of tombstones kept by compaction because their token range was not repaired yet, with tombstone_gc mode = repair.")),
+        sm::make_gauge("controller_backlog", [this] { return _compaction_controller.last_backlog(); },
+                       sm::description("Holds the last backlog fed to the compaction controller: the normalized backlog, plus the forecast backlog.")),
+        sm::make_gauge("controller_shares", [this] { return _compaction_controller.shares(); },
+                       sm::description("Holds the shares last set by the compaction controller.")),
+        sm::make_gauge("forecast_backlog", [this] { return _last_forecast_backlog; },
+                       sm::description("Holds the normalized backlog expected from the memtable flushes within compaction_backlog_forecast_horizon_in_ms.")),
+        sm::make_gauge("forecast_flush_rate", [this] { return _write_rate_forecaster.rate(); },
+                       sm::description("Holds the smoothed rate, in bytes per second, at which memtables are flushed, from which the forecast backlog is computed.")),
     });
 }
 
@@ -1704,6 +1871,7 @@ void compaction_manager::add(table_state& t) {
         auto s = t.schema();
         on_internal_error(cmlog, format("compaction_state for table {}.{} [{}] already exists", s->ks_name(), s->cf_name(), fmt::ptr(&t)));
     }
+    get_or_create_keyspace_stats(t.schema()->ks_name());
 }
 
 future<> compaction_manager::remove(table_state& t) noexcept {
@@ -1722,6 +1890,13 @@ future<> compaction_manager::remove(table_state& t) noexcept {
 
     _compaction_state.erase(&t);
 
+    const auto& ks_name = t.schema()->ks_name();
+    if (std::none_of(_compaction_state.begin(), _compaction_state.end(), [&ks_name] (const auto& entry) {
+            return entry.first->schema()->ks_name() == ks_name;
+        })) {
+        _keyspace_stats.erase(ks_name);
+    }
+
 #ifdef DEBUG
     auto found = false;
     sstring msg;
@@ -1821,6 +1996,30 @@ void compaction_manager::unplug_system_keyspace() noexcept {
     _sys_ks = nullptr;
 }
 
+void compaction_manager::plug_flushed_bytes_source(std::function<uint64_t()> flushed_bytes) noexcept {
+    _flushed_bytes = std::move(flushed_bytes);
+}
+
+void compaction_manager::unplug_flushed_bytes_source() noexcept {
+    _flushed_bytes = nullptr;
+}
+
+// The controller only sees the backlog of what was flushed, so it lags behind write
+// bursts, and overshoots when it catches up with them. To raise the shares ahead of
+// a burst, the bytes expected to be flushed within the horizon count as backlog, as
+// if they had to be compacted once, which is the least they'll cost.
+double compaction_manager::forecast_backlog() {
+    _last_forecast_backlog = 0;
+    if (!_flushed_bytes) {
+        return 0;
+    }
+    _write_rate_forecaster.sample(_flushed_bytes());
+    if (auto horizon = backlog_forecast_horizon(); horizon.count()) {
+        _last_forecast_backlog = _write_rate_forecaster.forecast(horizon) / available_memory();
+    }
+    return _last_forecast_backlog;
+}
+
 double compaction_backlog_tracker::backlog() const {
     return disabled() ? compaction_controller::disable_backlog : _impl->backlog(_ongoing_writes, _ongoing_compactions);
 }
@@ -77,6 +77,15 @@ class compaction_manager {
         uint64_t active_tasks = 0; // Number of compaction going on.
         int64_t errors = 0;
     };
+    // Compaction work done for the tables of a keyspace, so that the background
+    // work caused by the writes to each keyspace can be told apart.
+    struct keyspace_stats {
+        uint64_t active_tasks = 0;
+        uint64_t completed_tasks = 0;
+        // Total size of the input sstables of the completed compactions.
+        uint64_t compacted_bytes = 0;
+        seastar::metrics::metric_groups metrics;
+    };
     using scheduling_group = backlog_controller::scheduling_group;
     struct config {
         scheduling_group compaction_sched_group;
@@ -84,6 +93,9 @@ class compaction_manager {
         size_t available_memory = 0;
         utils::updateable_value<float> static_shares = utils::updateable_value<float>(0);
         utils::updateable_value<uint32_t> throughput_mb_per_sec = utils::updateable_value<uint32_t>(0);
+        utils::updateable_value<uint32_t> major_compaction_parallelism = utils::updateable_value<uint32_t>(1);
+        utils::updateable_value<uint32_t> backlog_forecast_horizon_in_ms = utils::updateable_value<uint32_t>(0);
+        utils::updateable_value<uint32_t> max_concurrent_compactions_per_keyspace = utils::updateable_value<uint32_t>(0);
     };
 
 public:
@@ -115,6 +127,12 @@ class compaction_manager {
     stats _stats;
     seastar::metrics::metric_groups _metrics;
     double _last_backlog = 0.0f;
+    // Forecast share of the normalized backlog in the last input of the controller.
+    double _last_forecast_backlog = 0.0f;
+
+    // Total of the bytes flushed from memtables, if plugged, from which the write rate is forecast.
+    std::function<uint64_t()> _flushed_bytes;
+    rate_forecaster _write_rate_forecaster;
 
     // Store sstables that are being compacted at the moment. That's needed to prevent
     // a sstable from being compacted twice.
@@ -130,6 +148,11 @@ class compaction_manager {
 
     std::unordered_map<compaction::table_state*, compaction_state> _compaction_state;
 
+    // Indexed by keyspace name. An entry lives as long as the keyspace has a registered table.
+    std::unordered_map<sstring, keyspace_stats> _keyspace_stats;
+    // Set by register_metrics(), so the keyspace metrics are only registered along with the others.
+    bool _register_keyspace_metrics = false;
+
     // Purpose is to serialize all maintenance (non regular) compaction activity to reduce aggressiveness and space requirement.
     // If the operation must be serialized with regular, then the per-table write lock must be taken.
     seastar::named_semaphore _maintenance_ops_sem = {1, named_semaphore_exception_factory{"maintenance operation"}};
@@ -156,6 +179,7 @@ class compaction_manager {
     serialized_action _update_compaction_static_shares_action;
     utils::observer<float> _compaction_static_shares_observer;
     uint64_t _validation_errors = 0;
+    uint64_t _tombstones_retained_for_repair = 0;
 
     class strategy_control;
     std::unique_ptr<strategy_control> _strategy_control;
@@ -171,6 +195,10 @@ class compaction_manager {
     // Return the largest fan-in of currently running compactions
     unsigned current_compaction_fan_in_threshold() const;
 
+    keyspace_stats& get_or_create_keyspace_stats(const sstring& ks_name);
+    // Returns the number of regular compactions running for the tables of the keyspace.
+    size_t running_regular_compactions(const sstring& ks_name) const;
+
     // Return true if compaction can be initiated
     bool can_register_compaction(compaction::table_state& t, int weight, unsigned fan_in) const;
     // Register weight for a table. Do that only if can_register_weight()
@@ -265,6 +293,22 @@ class compaction_manager {
         return _cfg.throughput_mb_per_sec.get();
     }
 
+    uint32_t major_compaction_parallelism() const noexcept {
+        return _cfg.major_compaction_parallelism.get();
+    }
+
+    uint32_t max_concurrent_compactions_per_keyspace() const noexcept {
+        return _cfg.max_concurrent_compactions_per_keyspace.get();
+    }
+
+    std::chrono::milliseconds backlog_forecast_horizon() const noexcept {
+        return std::chrono::milliseconds(_cfg.backlog_forecast_horizon_in_ms.get());
+    }
+
+    // Returns the normalized backlog expected from the bytes memtables will flush within
+    // the forecast horizon.
+    double forecast_backlog();
+
     void register_metrics();
 
     // enable the compaction manager.
@@ -355,6 +399,9 @@ class compaction_manager {
     void plug_system_keyspace(db::system_keyspace& sys_ks) noexcept;
     void unplug_system_keyspace() noexcept;
 
+    void plug_flushed_bytes_source(std::function<uint64_t()> flushed_bytes) noexcept;
+    void unplug_flushed_bytes_source() noexcept;
+
     // Adds a table to the compaction manager.
     // Creates a compaction_state structure that can be used for submitting
     // compaction jobs of all types.
@@ -368,6 +415,9 @@ class compaction_manager {
         return _stats;
     }
 
+    // Returns nullptr if the keyspace has no registered table.
+    const keyspace_stats* get_keyspace_stats(const sstring& ks_name) const;
+
     const std::vector<sstables::compaction_info> get_compactions(compaction::table_state* t = nullptr) const;
 
     // Returns true if table has an ongoing compaction, running on its behalf
@@ -455,6 +505,7 @@ class compaction_task_executor {
     shared_future<compaction_manager::compaction_stats_opt> _compaction_done = make_ready_future<compaction_manager::compaction_stats_opt>();
     exponential_backoff_retry _compaction_retry = exponential_backoff_retry(std::chrono::seconds(5), std::chrono::seconds(300));
     sstables::compaction_type _type;
+    compaction_manager::keyspace_stats& _keyspace_stats;
     sstables::run_id _output_run_identifier;
     gate::holder _gate_holder;
     sstring _description;
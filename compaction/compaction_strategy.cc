@@ -27,6 +27,7 @@
 #include "date_tiered_compaction_strategy.hh"
 #include "leveled_compaction_strategy.hh"
 #include "time_window_compaction_strategy.hh"
+#include "incremental_compaction_strategy.hh"
 #include "backlog_controller.hh"
 #include "compaction_backlog_manager.hh"
 #include "size_tiered_backlog_tracker.hh"
@@ -66,6 +67,36 @@ bool compaction_strategy_impl::worth_dropping_tombstones(const shared_sstable& s
     return sst->estimate_droppable_tombstone_ratio(gc_before) >= _tombstone_threshold;
 }
 
+compaction_descriptor compaction_strategy_impl::get_tombstone_read_compaction_job(table_state& table_s, const std::vector<shared_sstable>& candidates,
+        gc_clock::time_point compaction_time, size_t max_threshold) {
+    if (_disable_tombstone_compaction) {
+        return compaction_descriptor();
+    }
+    // Like in worth_dropping_tombstones(), ignore recent sstables, so that the same
+    // sstables aren't compacted over and over while their tombstones can't be dropped.
+    auto write_time_limit = db_clock::now() - _tombstone_compaction_interval;
+    std::vector<shared_sstable> sstables;
+    for (auto& sst : candidates) {
+        if (sst->tombstones_read() && sst->data_file_write_time() <= write_time_limit) {
+            sstables.push_back(sst);
+        }
+    }
+    if (sstables.empty()) {
+        return compaction_descriptor();
+    }
+    std::sort(sstables.begin(), sstables.end(), [] (const shared_sstable& a, const shared_sstable& b) {
+        return a->tombstones_read() > b->tombstones_read();
+    });
+    sstables.resize(std::min(sstables.size(), std::max<size_t>(max_threshold, 1)));
+    if (sstables.size() == 1) {
+        auto gc_before = sstables.front()->get_gc_before_for_drop_estimation(compaction_time, table_s.get_tombstone_gc_state());
+        if (sstables.front()->estimate_droppable_tombstone_ratio(gc_before) <= 0) {
+            return compaction_descriptor();
+        }
+    }
+    return compaction_descriptor(std::move(sstables), service::get_local_compaction_priority());
+}
+
 uint64_t compaction_strategy_impl::adjust_partition_estimate(const mutation_source_metadata& ms_meta, uint64_t partition_estimate) const {
     return partition_estimate;
 }
@@ -781,6 +812,9 @@ compaction_strategy make_compaction_strategy(compaction_strategy_type strategy,
     case compaction_strategy_type::time_window:
         impl = ::make_shared<time_window_compaction_strategy>(options);
         break;
+    case compaction_strategy_type::incremental:
+        impl = ::make_shared<incremental_compaction_strategy>(options);
+        break;
     default:
         throw std::runtime_error("strategy not supported");
     }
@@ -797,6 +831,7 @@ compaction_strategy_state compaction_strategy_state::make(const compaction_strat
         case compaction_strategy_type::null:
         case compaction_strategy_type::size_tiered:
         case compaction_strategy_type::date_tiered:
+        case compaction_strategy_type::incremental:
             return compaction_strategy_state(default_empty_state{});
         case compaction_strategy_type::leveled:
             return compaction_strategy_state(leveled_compaction_strategy_state{});
@@ -63,6 +63,13 @@ class compaction_strategy_impl {
     // droppable tombstone histogram and gc_before.
     bool worth_dropping_tombstones(const shared_sstable& sst, gc_clock::time_point compaction_time, const tombstone_gc_state& gc_state);
 
+    // Returns a job compacting together, up to max_threshold of them, the candidates
+    // holding partitions which queries found full of tombstones, if any. See
+    // sstable::tombstones_read(). A single sstable is only compacted if it has
+    // droppable tombstones.
+    compaction_descriptor get_tombstone_read_compaction_job(table_state& table_s, const std::vector<shared_sstable>& candidates,
+            gc_clock::time_point compaction_time, size_t max_threshold);
+
     virtual std::unique_ptr<compaction_backlog_tracker::impl> make_backlog_tracker() const = 0;
 
     virtual uint64_t adjust_partition_estimate(const mutation_source_metadata& ms_meta, uint64_t partition_estimate) const;
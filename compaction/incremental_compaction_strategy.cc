@@ -0,0 +1,287 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "sstables/sstables.hh"
+#include "incremental_compaction_strategy.hh"
+#include "compaction_backlog_manager.hh"
+
+#include <boost/range/adaptor/reversed.hpp>
+#include <boost/range/algorithm/remove_if.hpp>
+#include <cmath>
+
+// The backlog of ICS is the one of STCS, as described in size_tiered_backlog_tracker.hh,
+// where each run stands for an sstable of the size of the whole run, as runs are
+// compacted as a whole. The bytes compacted from a fragment count against its run.
+class incremental_backlog_tracker final : public compaction_backlog_tracker::impl {
+    sstables::size_tiered_compaction_strategy_options _stcs_options;
+    int64_t _total_bytes = 0;
+    std::unordered_set<sstables::shared_sstable> _all;
+    // The fragments of the runs which contribute to the backlog, with the size of their run.
+    std::unordered_map<sstables::shared_sstable, uint64_t> _contributing_fragments;
+    uint64_t _contributing_bytes = 0;
+    double _runs_backlog_contribution = 0.0f;
+
+    static double log4(double x) {
+        double inv_log_4 = 1.0f / std::log(4);
+        return log(x) * inv_log_4;
+    }
+
+    void refresh_runs_backlog_contribution() {
+        _contributing_fragments.clear();
+        _contributing_bytes = 0;
+        _runs_backlog_contribution = 0.0f;
+        if (_all.empty()) {
+            return;
+        }
+        using namespace sstables;
+
+        // Like in STCS, low-efficiency jobs, which fan-in is smaller than min-threshold, don't contribute.
+        const auto& newest_sst = std::ranges::max(_all, std::less<generation_type>(), std::mem_fn(&sstable::generation));
+        size_t threshold = newest_sst->get_schema()->min_compaction_threshold();
+
+        auto runs = incremental_compaction_strategy::get_runs(std::vector<shared_sstable>(_all.begin(), _all.end()));
+        for (auto& bucket : incremental_compaction_strategy::get_buckets(runs, _stcs_options)) {
+            if (bucket.size() < threshold) {
+                continue;
+            }
+            for (auto& run : bucket) {
+                auto size = run.data_size();
+                _contributing_bytes += size;
+                _runs_backlog_contribution += size * log4(size);
+                for (auto& sst : run.all()) {
+                    _contributing_fragments.emplace(sst, size);
+                }
+            }
+        }
+    }
+public:
+    explicit incremental_backlog_tracker(sstables::size_tiered_compaction_strategy_options stcs_options) : _stcs_options(stcs_options) {}
+
+    virtual double backlog(const compaction_backlog_tracker::ongoing_writes& ow, const compaction_backlog_tracker::ongoing_compactions& oc) const override {
+        uint64_t compacted_bytes = 0;
+        double compacted_contribution = 0;
+        for (auto const& crp : oc) {
+            auto it = _contributing_fragments.find(crp.first);
+            if (it == _contributing_fragments.end()) {
+                continue;
+            }
+            auto compacted = crp.second->compacted();
+            compacted_bytes += compacted;
+            compacted_contribution += compacted * log4(it->second);
+        }
+        if (_contributing_bytes <= compacted_bytes) {
+            return 0;
+        }
+        auto b = ((_contributing_bytes - compacted_bytes) * log4(_total_bytes)) - (_runs_backlog_contribution - compacted_contribution);
+        return b > 0 ? b : 0;
+    }
+
+    virtual void replace_sstables(std::vector<sstables::shared_sstable> old_ssts, std::vector<sstables::shared_sstable> new_ssts) override {
+        for (auto& sst : old_ssts) {
+            if (sst->data_size() > 0 && _all.erase(sst)) {
+                _total_bytes -= sst->data_size();
+            }
+        }
+        for (auto& sst : new_ssts) {
+            if (sst->data_size() > 0 && _all.insert(sst).second) {
+                _total_bytes += sst->data_size();
+            }
+        }
+        refresh_runs_backlog_contribution();
+    }
+};
+
+namespace sstables {
+
+incremental_compaction_strategy::incremental_compaction_strategy(const std::map<sstring, sstring>& options)
+    : compaction_strategy_impl(options)
+    , _fragment_size(calculate_fragment_size(compaction_strategy_impl::get_value(options, SSTABLE_SIZE_OPTION)))
+    , _stcs_options(options)
+{
+}
+
+uint64_t incremental_compaction_strategy::calculate_fragment_size(std::optional<sstring> option_value) {
+    using namespace cql3::statements;
+    auto size_in_mb = property_definitions::to_long(SSTABLE_SIZE_OPTION, option_value, DEFAULT_MAX_SSTABLE_SIZE_IN_MB);
+    if (size_in_mb <= 0) {
+        throw exceptions::configuration_exception(format("{} must be positive: {}", SSTABLE_SIZE_OPTION, size_in_mb));
+    }
+    return uint64_t(size_in_mb) * 1024 * 1024;
+}
+
+std::vector<sstable_run> incremental_compaction_strategy::get_runs(const std::vector<shared_sstable>& sstables) {
+    std::vector<sstable_run> runs;
+    std::unordered_map<run_id, size_t> run_indexes;
+    for (auto& sst : sstables) {
+        auto [it, inserted] = run_indexes.emplace(sst->run_identifier(), runs.size());
+        if (inserted) {
+            runs.emplace_back();
+        }
+        if (!runs[it->second].insert(sst)) {
+            runs.emplace_back().insert(sst);
+        }
+    }
+    return runs;
+}
+
+std::vector<std::vector<sstable_run>>
+incremental_compaction_strategy::get_buckets(const std::vector<sstable_run>& runs, const size_tiered_compaction_strategy_options& options) {
+    std::vector<std::pair<const sstable_run*, uint64_t>> sorted_runs;
+    sorted_runs.reserve(runs.size());
+    for (auto& run : runs) {
+        sorted_runs.emplace_back(&run, run.data_size());
+    }
+    std::sort(sorted_runs.begin(), sorted_runs.end(), [] (auto& i, auto& j) {
+        return i.second < j.second;
+    });
+
+    std::vector<std::vector<sstable_run>> bucket_list;
+    // Average and smallest run size of each bucket.
+    std::vector<std::pair<double, uint64_t>> bucket_sizes;
+
+    for (auto& [run, size] : sorted_runs) {
+        // Same grouping as size_tiered_compaction_strategy::get_buckets(), see there.
+        if (!bucket_list.empty()) {
+            auto& [bucket_average_size, smallest_run_in_bucket] = bucket_sizes.back();
+
+            if ((size > (bucket_average_size * options.bucket_low) && size < (bucket_average_size * options.bucket_high)) ||
+                    (size < options.min_sstable_size && bucket_average_size < options.min_sstable_size)) {
+                auto& bucket = bucket_list.back();
+                auto total_size = bucket.size() * bucket_average_size;
+                auto new_average_size = (total_size + size) / (bucket.size() + 1);
+
+                if (size < options.min_sstable_size || smallest_run_in_bucket > new_average_size * options.bucket_low) {
+                    bucket.push_back(*run);
+                    bucket_average_size = new_average_size;
+                    continue;
+                }
+            }
+        }
+
+        bucket_list.push_back({*run});
+        bucket_sizes.emplace_back(size, size);
+    }
+
+    return bucket_list;
+}
+
+std::vector<sstable_run>
+incremental_compaction_strategy::most_interesting_bucket(std::vector<std::vector<sstable_run>> buckets, size_t min_threshold, size_t max_threshold) {
+    std::vector<sstable_run>* most_interesting = nullptr;
+    for (auto& bucket : buckets) {
+        if (bucket.size() < min_threshold) {
+            continue;
+        }
+        bucket.resize(std::min(bucket.size(), max_threshold));
+        // Pick the bucket with more runs, as efficiency of same-tier compactions increases with their number.
+        if (!most_interesting || most_interesting->size() < bucket.size()) {
+            most_interesting = &bucket;
+        }
+    }
+    return most_interesting ? std::move(*most_interesting) : std::vector<sstable_run>();
+}
+
+compaction_descriptor incremental_compaction_strategy::make_descriptor(const std::vector<sstable_run>& runs) const {
+    std::vector<shared_sstable> sstables;
+    for (auto& run : runs) {
+        sstables.insert(sstables.end(), run.all().begin(), run.all().end());
+    }
+    return compaction_descriptor(std::move(sstables), service::get_local_compaction_priority(), compaction_descriptor::default_level, _fragment_size);
+}
+
+compaction_descriptor
+incremental_compaction_strategy::get_sstables_for_compaction(table_state& table_s, strategy_control& control, std::vector<sstables::shared_sstable> candidates) {
+    size_t min_threshold = table_s.min_compaction_threshold();
+    size_t max_threshold = table_s.schema()->max_compaction_threshold();
+    auto compaction_time = gc_clock::now();
+
+    // Like STCS, compact first the fragments holding partitions which reads found full of tombstones.
+    if (auto desc = get_tombstone_read_compaction_job(table_s, candidates, compaction_time, max_threshold); !desc.sstables.empty()) {
+        desc.max_sstable_bytes = _fragment_size;
+        return desc;
+    }
+
+    auto buckets = get_buckets(get_runs(candidates), _stcs_options);
+
+    if (auto runs = most_interesting_bucket(buckets, min_threshold, max_threshold); !runs.empty()) {
+        return make_descriptor(runs);
+    }
+
+    // If we are not enforcing min_threshold explicitly, try any pair of runs in the same tier.
+    if (!table_s.compaction_enforce_min_threshold()) {
+        if (auto runs = most_interesting_bucket(buckets, 2, max_threshold); !runs.empty()) {
+            return make_descriptor(runs);
+        }
+    }
+
+    // Otherwise, compact a single run with enough droppable tombstones, preferring
+    // the oldest run of the biggest tiers, like STCS does with sstables.
+    auto min_timestamp = [] (const sstable_run& run) {
+        auto ts = api::max_timestamp;
+        for (auto& sst : run.all()) {
+            ts = std::min(ts, sst->get_stats_metadata().min_timestamp);
+        }
+        return ts;
+    };
+    for (auto&& runs : buckets | boost::adaptors::reversed) {
+        auto e = boost::range::remove_if(runs, [this, compaction_time, &table_s] (const sstable_run& run) {
+            return std::ranges::none_of(run.all(), [&] (const shared_sstable& sst) {
+                return worth_dropping_tombstones(sst, compaction_time, table_s.get_tombstone_gc_state());
+            });
+        });
+        runs.erase(e, runs.end());
+        if (runs.empty()) {
+            continue;
+        }
+        auto it = std::ranges::min_element(runs, std::less<>(), min_timestamp);
+        return make_descriptor({*it});
+    }
+    return compaction_descriptor();
+}
+
+compaction_descriptor incremental_compaction_strategy::get_major_compaction_job(table_state& table_s, std::vector<sstables::shared_sstable> candidates) {
+    return make_major_compaction_job(std::move(candidates), compaction_descriptor::default_level, _fragment_size);
+}
+
+std::vector<compaction_descriptor>
+incremental_compaction_strategy::get_cleanup_compaction_jobs(table_state& table_s, std::vector<shared_sstable> candidates) const {
+    // Clean up one run at a time, which releases its fragments as it goes.
+    std::vector<compaction_descriptor> ret;
+    for (auto& run : get_runs(candidates)) {
+        ret.push_back(make_descriptor({run}));
+    }
+    return ret;
+}
+
+int64_t incremental_compaction_strategy::estimated_pending_compactions(table_state& table_s) const {
+    size_t min_threshold = table_s.min_compaction_threshold();
+    size_t max_threshold = table_s.schema()->max_compaction_threshold();
+    auto all_sstables = table_s.main_sstable_set().all();
+
+    int64_t n = 0;
+    for (auto& bucket : get_buckets(get_runs(std::vector<shared_sstable>(all_sstables->begin(), all_sstables->end())), _stcs_options)) {
+        if (bucket.size() >= min_threshold) {
+            n += std::ceil(double(bucket.size()) / max_threshold);
+        }
+    }
+    return n;
+}
+
+std::unique_ptr<compaction_backlog_tracker::impl> incremental_compaction_strategy::make_backlog_tracker() const {
+    return std::make_unique<incremental_backlog_tracker>(_stcs_options);
+}
+
+compaction_descriptor
+incremental_compaction_strategy::get_reshaping_job(std::vector<shared_sstable> input, schema_ptr schema, const ::io_priority_class& iop, reshape_mode mode) const {
+    // Off-strategy sstables aren't part of runs, so they are reshaped like in STCS, into runs of fragments.
+    auto desc = size_tiered_compaction_strategy(_stcs_options).get_reshaping_job(std::move(input), std::move(schema), iop, mode);
+    desc.max_sstable_bytes = _fragment_size;
+    return desc;
+}
+
+}
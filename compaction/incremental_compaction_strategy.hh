@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include "compaction_strategy_impl.hh"
+#include "size_tiered_compaction_strategy.hh"
+#include "sstables/sstable_set.hh"
+
+namespace sstables {
+
+// Incremental compaction strategy (ICS) tiers sstable runs, the way STCS tiers
+// sstables, and writes the output of each compaction as a run of fragments of
+// at most sstable_size_in_mb. As the input runs are made of fragments too, each
+// input fragment is released as soon as the output has gone past its last key,
+// so a compaction needs about one fragment per input run of temporary space,
+// instead of the size of its whole input.
+class incremental_compaction_strategy : public compaction_strategy_impl {
+    static constexpr uint64_t DEFAULT_MAX_SSTABLE_SIZE_IN_MB = 1000;
+    const sstring SSTABLE_SIZE_OPTION = "sstable_size_in_mb";
+
+    uint64_t _fragment_size;
+    size_tiered_compaction_strategy_options _stcs_options;
+private:
+    static uint64_t calculate_fragment_size(std::optional<sstring> option_value);
+
+    compaction_descriptor make_descriptor(const std::vector<sstable_run>& runs) const;
+
+    static std::vector<sstable_run>
+    most_interesting_bucket(std::vector<std::vector<sstable_run>> buckets, size_t min_threshold, size_t max_threshold);
+public:
+    explicit incremental_compaction_strategy(const std::map<sstring, sstring>& options);
+
+    // Groups sstables by run. Fragments which overlap with the run they claim
+    // to belong to are given a run of their own.
+    static std::vector<sstable_run> get_runs(const std::vector<shared_sstable>& sstables);
+
+    // Groups runs of similar size into buckets, the way STCS groups sstables.
+    static std::vector<std::vector<sstable_run>> get_buckets(const std::vector<sstable_run>& runs, const size_tiered_compaction_strategy_options& options);
+
+    uint64_t fragment_size() const {
+        return _fragment_size;
+    }
+
+    virtual compaction_descriptor get_sstables_for_compaction(table_state& table_s, strategy_control& control, std::vector<sstables::shared_sstable> candidates) override;
+
+    virtual compaction_descriptor get_major_compaction_job(table_state& table_s, std::vector<sstables::shared_sstable> candidates) override;
+
+    virtual std::vector<compaction_descriptor> get_cleanup_compaction_jobs(table_state& table_s, std::vector<shared_sstable> candidates) const override;
+
+    virtual int64_t estimated_pending_compactions(table_state& table_s) const override;
+
+    virtual compaction_strategy_type type() const override {
+        return compaction_strategy_type::incremental;
+    }
+
+    virtual std::unique_ptr<sstable_set_impl> make_sstable_set(schema_ptr schema) const override;
+
+    virtual std::unique_ptr<compaction_backlog_tracker::impl> make_backlog_tracker() const override;
+
+    virtual compaction_descriptor get_reshaping_job(std::vector<shared_sstable> input, schema_ptr schema, const ::io_priority_class& iop, reshape_mode mode) const override;
+};
+
+}
@@ -151,6 +151,11 @@ size_tiered_compaction_strategy::get_sstables_for_compaction(table_state& table_
 
     // TODO: Add support to filter cold sstables (for reference: SizeTieredCompactionStrategy::filterColdSSTables).
 
+    // Tombstones found by reads slow them down until they are compacted away, so they go first.
+    if (auto desc = get_tombstone_read_compaction_job(table_s, candidates, compaction_time, max_threshold); !desc.sstables.empty()) {
+        return desc;
+    }
+
     auto buckets = get_buckets(candidates);
 
     if (is_any_bucket_interesting(buckets, min_threshold)) {
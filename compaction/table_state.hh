@@ -44,6 +44,9 @@ class table_state {
     virtual reader_permit make_compaction_reader_permit() const = 0;
     virtual sstables::sstables_manager& get_sstables_manager() noexcept = 0;
     virtual sstables::shared_sstable make_sstable() const = 0;
+    // Whether the table has cold storage, for make_cold_sstable().
+    virtual bool has_cold_storage() const noexcept = 0;
+    virtual sstables::shared_sstable make_cold_sstable() const = 0;
     virtual sstables::sstable_writer_config configure_writer(sstring origin) const = 0;
     virtual api::timestamp_type min_memtable_timestamp() const = 0;
     virtual future<> on_compaction_completion(sstables::compaction_completion_desc desc, sstables::offstrategy offstrategy) = 0;
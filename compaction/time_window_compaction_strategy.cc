@@ -72,6 +72,20 @@ time_window_compaction_strategy_options::time_window_compaction_strategy_options
         }
     }
 
+    it = options.find(COLD_STORAGE_AGE_SECONDS_KEY);
+    if (it != options.end()) {
+        long age;
+        try {
+            age = std::stol(it->second);
+        } catch (const std::exception& e) {
+            throw exceptions::syntax_exception(sstring("Invalid long value ") + it->second + " for " + COLD_STORAGE_AGE_SECONDS_KEY);
+        }
+        if (age < 0) {
+            throw exceptions::configuration_exception(fmt::format("{} must not be negative: {}", COLD_STORAGE_AGE_SECONDS_KEY, age));
+        }
+        cold_storage_age = std::chrono::seconds(age);
+    }
+
     it = options.find("enable_optimized_twcs_queries");
     if (it != options.end() && it->second == "false") {
         enable_optimized_twcs_queries = false;
@@ -254,9 +268,53 @@ time_window_compaction_strategy::get_sstables_for_compaction(table_state& table_
         clogger.debug("[{}] TWCS skipping check for fully expired SSTables", fmt::ptr(this));
     }
 
+    auto cold_candidates = table_s.has_cold_storage() && _options.cold_storage_age ? candidates : std::vector<shared_sstable>();
     auto compaction_candidates = get_next_non_expired_sstables(table_s, control, std::move(candidates), compaction_time);
+    if (compaction_candidates.empty()) {
+        // Nothing else to do, so move the next cold window to cold storage, if any.
+        compaction_candidates = get_cold_storage_candidates(table_s, std::move(cold_candidates));
+    }
     clogger.debug("[{}] Going to compact {} non-expired sstables", fmt::ptr(this), compaction_candidates.size());
-    return compaction_descriptor(std::move(compaction_candidates), service::get_local_compaction_priority());
+    auto desc = compaction_descriptor(std::move(compaction_candidates), service::get_local_compaction_priority());
+    if (!desc.sstables.empty() && all_in_cold_windows(table_s, desc.sstables)) {
+        desc.to_cold_storage = to_cold_storage::yes;
+    }
+    return desc;
+}
+
+bool time_window_compaction_strategy::is_cold_window(timestamp_type bucket_key, timestamp_type now) const {
+    auto age = std::chrono::duration_cast<std::chrono::microseconds>(*_options.cold_storage_age).count();
+    return bucket_key + get_window_size(_options) <= now - age;
+}
+
+bool time_window_compaction_strategy::all_in_cold_windows(table_state& table_s, const std::vector<shared_sstable>& sstables) const {
+    if (!table_s.has_cold_storage() || !_options.cold_storage_age) {
+        return false;
+    }
+    auto now = api::new_timestamp();
+    return std::ranges::all_of(sstables, [&] (const shared_sstable& sst) {
+        return is_cold_window(get_window_for(_options, sst->get_stats_metadata().max_timestamp), now);
+    });
+}
+
+std::vector<shared_sstable>
+time_window_compaction_strategy::get_cold_storage_candidates(table_state& table_s, std::vector<shared_sstable> candidates) const {
+    auto e = boost::range::remove_if(candidates, [] (const shared_sstable& sst) {
+        return sst->get_storage().is_remote();
+    });
+    candidates.erase(e, candidates.end());
+    if (candidates.empty()) {
+        return {};
+    }
+    auto now = api::new_timestamp();
+    auto buckets = get_buckets(std::move(candidates), _options).first;
+    // Buckets are ordered by window, so the first one is the oldest.
+    auto it = buckets.begin();
+    if (!is_cold_window(it->first, now)) {
+        return {};
+    }
+    clogger.debug("[{}] Moving {} sstables of window {} to cold storage", fmt::ptr(this), it->second.size(), it->first);
+    return trim_to_threshold(std::move(it->second), table_s.schema()->max_compaction_threshold());
 }
 
 time_window_compaction_strategy::bucket_compaction_mode
@@ -36,6 +36,7 @@ class time_window_compaction_strategy_options {
     static constexpr auto COMPACTION_WINDOW_UNIT_KEY = "compaction_window_unit";
     static constexpr auto COMPACTION_WINDOW_SIZE_KEY = "compaction_window_size";
     static constexpr auto EXPIRED_SSTABLE_CHECK_FREQUENCY_SECONDS_KEY = "expired_sstable_check_frequency_seconds";
+    static constexpr auto COLD_STORAGE_AGE_SECONDS_KEY = "cold_storage_age_seconds";
 private:
     const std::unordered_map<sstring, std::chrono::seconds> valid_window_units = { { "MINUTES", 60s }, { "HOURS", 3600s }, { "DAYS", 86400s } };
 
@@ -52,12 +53,15 @@ class time_window_compaction_strategy_options {
     db_clock::duration expired_sstable_check_frequency = DEFAULT_EXPIRED_SSTABLE_CHECK_FREQUENCY_SECONDS();
     timestamp_resolutions timestamp_resolution = timestamp_resolutions::microsecond;
     bool enable_optimized_twcs_queries{true};
+    // Windows which ended longer than this ago are moved to the table's cold storage, if it has one.
+    std::optional<std::chrono::seconds> cold_storage_age;
 public:
     time_window_compaction_strategy_options(const time_window_compaction_strategy_options&);
     time_window_compaction_strategy_options(time_window_compaction_strategy_options&&);
     time_window_compaction_strategy_options(const std::map<sstring, sstring>& options);
 
     std::chrono::seconds get_sstable_window_size() const { return sstable_window_size; }
+    std::optional<std::chrono::seconds> get_cold_storage_age() const { return cold_storage_age; }
 
     friend class time_window_compaction_strategy;
     friend class time_window_backlog_tracker;
@@ -118,6 +122,17 @@ class time_window_compaction_strategy : public compaction_strategy_impl {
     get_next_non_expired_sstables(table_state& table_s, strategy_control& control, std::vector<shared_sstable> non_expiring_sstables, gc_clock::time_point compaction_time);
 
     std::vector<shared_sstable> get_compaction_candidates(table_state& table_s, strategy_control& control, std::vector<shared_sstable> candidate_sstables);
+
+    // Returns true if the window starting at bucket_key ended longer than cold_storage_age ago,
+    // with now in microseconds since the epoch.
+    bool is_cold_window(timestamp_type bucket_key, timestamp_type now) const;
+
+    // Returns true if all the sstables belong to windows which are to be moved to cold storage.
+    bool all_in_cold_windows(table_state& table_s, const std::vector<shared_sstable>& sstables) const;
+
+    // Picks the sstables of the oldest cold window which are still stored locally,
+    // to be rewritten to cold storage.
+    std::vector<shared_sstable> get_cold_storage_candidates(table_state& table_s, std::vector<shared_sstable> candidates) const;
 public:
     // Find the lowest timestamp for window of given size
     static timestamp_type
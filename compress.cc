@@ -60,6 +60,22 @@ std::map<sstring, sstring> compressor::options() const {
     return {};
 }
 
+bool compressor::uses_dictionary() const {
+    return false;
+}
+
+size_t compressor::dictionary_training_size() const {
+    return 0;
+}
+
+future<bytes> compressor::train_dictionary(const std::vector<bytes_view>&) const {
+    return make_ready_future<bytes>();
+}
+
+shared_ptr<compressor> compressor::with_dictionary(bytes_view) const {
+    throw std::logic_error(format("Compressor {} does not support dictionaries", name()));
+}
+
 compressor::ptr_type compressor::create(const sstring& name, const opt_getter& opts) {
     if (name.empty()) {
         return {};
@@ -10,11 +10,13 @@
 
 #include <map>
 #include <set>
+#include <vector>
 
 #include <seastar/core/future.hh>
 #include <seastar/core/shared_ptr.hh>
 #include <seastar/core/sstring.hh>
 
+#include "bytes.hh"
 #include "exceptions/exceptions.hh"
 
 
@@ -51,6 +53,32 @@ class compressor {
      */
     virtual std::map<sstring, sstring> options() const;
 
+    /**
+     * Returns true if this compressor can use a dictionary trained on a sample
+     * of the data it is going to compress. Such compressors are handed samples
+     * via train_dictionary() before compressing anything, and the resulting
+     * dictionary has to be available, through with_dictionary(), in order to
+     * uncompress the data again.
+     */
+    virtual bool uses_dictionary() const;
+    /**
+     * Returns the amount of uncompressed data, in bytes, that should be sampled
+     * before training the dictionary.
+     */
+    virtual size_t dictionary_training_size() const;
+    /**
+     * Trains a dictionary from the given samples. May return an empty dictionary
+     * if training was not possible, in which case the data is compressed without one.
+     * The samples must be kept alive until the returned future resolves.
+     */
+    virtual future<bytes> train_dictionary(const std::vector<bytes_view>& samples) const;
+    /**
+     * Returns a compressor with the same options as this one, which compresses
+     * and uncompresses using the given dictionary. An empty dictionary means
+     * that no dictionary is used.
+     */
+    virtual shared_ptr<compressor> with_dictionary(bytes_view dictionary) const;
+
     /**
      * Compressor class name.
      */
@@ -380,6 +380,8 @@ scylla_tests = set([
     'test/boost/cql_auth_query_test',
     'test/boost/cql_auth_syntax_test',
     'test/boost/cql_query_test',
+    'test/boost/cql_admission_queue_test',
+    'test/boost/cql_segment_test',
     'test/boost/cql_query_large_test',
     'test/boost/cql_query_like_test',
     'test/boost/cql_query_group_test',
@@ -472,6 +474,7 @@ scylla_tests = set([
     'test/boost/storage_proxy_test',
     'test/boost/top_k_test',
     'test/boost/transport_test',
+    'test/boost/two_choice_cache_test',
     'test/boost/types_test',
     'test/boost/user_function_test',
     'test/boost/user_types_test',
@@ -487,6 +490,7 @@ scylla_tests = set([
     'test/boost/virtual_table_test',
     'test/boost/wasm_test',
     'test/boost/wasm_alloc_test',
+    'test/boost/zstd_rpc_compressor_test',
     'test/boost/bptree_test',
     'test/boost/btree_test',
     'test/boost/radix_tree_test',
@@ -507,6 +511,7 @@ scylla_tests = set([
     'test/boost/exceptions_fallback_test',
     'test/boost/s3_test',
     'test/boost/locator_topology_test',
+    'test/boost/tablets_test',
     'test/manual/ec2_snitch_test',
     'test/manual/enormous_table_scan_test',
     'test/manual/gce_snitch_test',
@@ -546,6 +551,7 @@ perf_tests = set([
     'test/perf/perf_idl',
     'test/perf/perf_vint',
     'test/perf/perf_big_decimal',
+    'test/perf/perf_uuid',
 ])
 
 raft_tests = set([
@@ -661,12 +667,14 @@ scylla_raft_core = [
 ]
 
 scylla_core = (['message/messaging_service.cc',
+                'message/zstd_rpc_compressor.cc',
                 'replica/database.cc',
                 'replica/table.cc',
                 'replica/distributed_loader.cc',
                 'replica/memtable.cc',
                 'replica/exceptions.cc',
                 'replica/dirty_memory_manager.cc',
+                'replica/cache_warmup.cc',
                 'mutation/atomic_cell.cc',
                 'mutation/canonical_mutation.cc',
                 'mutation/frozen_mutation.cc',
@@ -704,6 +712,7 @@ scylla_core = (['message/messaging_service.cc',
                 'utils/rjson.cc',
                 'utils/human_readable.cc',
                 'utils/histogram_metrics_helper.cc',
+                'utils/cpu_profiler.cc',
                 'converting_mutation_partition_applier.cc',
                 'readers/combined.cc',
                 'readers/multishard.cc',
@@ -719,14 +728,18 @@ scylla_core = (['message/messaging_service.cc',
                 'sstables/sstable_set.cc',
                 'sstables/mx/partition_reversing_data_source.cc',
                 'sstables/mx/reader.cc',
+                'sstables/mx/row_index.cc',
                 'sstables/mx/writer.cc',
                 'sstables/kl/reader.cc',
                 'sstables/sstable_version.cc',
                 'sstables/compress.cc',
+                'sstables/paged_filter.cc',
+                'sstables/partition_trie.cc',
                 'sstables/sstable_mutation_reader.cc',
                 'compaction/compaction.cc',
                 'compaction/compaction_strategy.cc',
                 'compaction/size_tiered_compaction_strategy.cc',
+                'compaction/incremental_compaction_strategy.cc',
                 'compaction/leveled_compaction_strategy.cc',
                 'compaction/task_manager_module.cc',
                 'compaction/time_window_compaction_strategy.cc',
@@ -742,6 +755,8 @@ scylla_core = (['message/messaging_service.cc',
                 'transport/event.cc',
                 'transport/event_notifier.cc',
                 'transport/server.cc',
+                'transport/admission_queue.cc',
+                'transport/segment.cc',
                 'transport/controller.cc',
                 'transport/messages/result_message.cc',
                 'cdc/cdc_partitioner.cc',
@@ -764,6 +779,7 @@ scylla_core = (['message/messaging_service.cc',
                 'cql3/expr/expression.cc',
                 'cql3/expr/restrictions.cc',
                 'cql3/expr/prepare_expr.cc',
+                'cql3/expr/compiled_restriction.cc',
                 'cql3/functions/user_function.cc',
                 'cql3/functions/functions.cc',
                 'cql3/functions/aggregate_fcts.cc',
@@ -894,6 +910,7 @@ scylla_core = (['message/messaging_service.cc',
                 'db/view/row_locking.cc',
                 'db/sstables-format-selector.cc',
                 'db/snapshot-ctl.cc',
+                'db/snapshot/backup_task.cc',
                 'db/rate_limiter.cc',
                 'db/per_partition_rate_limit_options.cc',
                 'index/secondary_index_manager.cc',
@@ -901,9 +918,11 @@ scylla_core = (['message/messaging_service.cc',
                 'utils/UUID_gen.cc',
                 'utils/i_filter.cc',
                 'utils/bloom_filter.cc',
+                'utils/binary_fuse_filter.cc',
                 'utils/bloom_calculations.cc',
                 'utils/rate_limiter.cc',
                 'utils/file_lock.cc',
+                'utils/alien_worker.cc',
                 'utils/dynamic_bitset.cc',
                 'utils/managed_bytes.cc',
                 'utils/exceptions.cc',
@@ -946,12 +965,14 @@ scylla_core = (['message/messaging_service.cc',
                 'locator/ec2_multi_region_snitch.cc',
                 'locator/gce_snitch.cc',
                 'locator/topology.cc',
+                'locator/tablets.cc',
                 'locator/util.cc',
                 'service/client_state.cc',
                 'service/storage_service.cc',
                 'service/misc_services.cc',
                 'service/pager/paging_state.cc',
                 'service/pager/query_pagers.cc',
+                'service/qos/latency_slo_guard.cc',
                 'service/qos/qos_common.cc',
                 'service/qos/service_level_controller.cc',
                 'service/qos/standard_service_level_distributed_data_accessor.cc',
@@ -995,6 +1016,7 @@ scylla_core = (['message/messaging_service.cc',
                 'auth/sasl_challenge.cc',
                 'tracing/tracing.cc',
                 'tracing/trace_keyspace_helper.cc',
+                'tracing/ring_buffer_backend.cc',
                 'tracing/trace_state.cc',
                 'tracing/traced_file.cc',
                 'table_helper.cc',
@@ -1115,6 +1137,7 @@ redis = [
         'redis/command_factory.cc',
         'redis/commands.cc',
         'redis/lolwut.cc',
+        'redis/write_batch.cc',
         ]
 
 idls = ['idl/gossip_digest.idl.hh',
@@ -1150,6 +1173,7 @@ idls = ['idl/gossip_digest.idl.hh',
         'idl/storage_proxy.idl.hh',
         'idl/group0_state_machine.idl.hh',
         'idl/forward_request.idl.hh',
+        'idl/alternator.idl.hh',
         'idl/replica_exception.idl.hh',
         'idl/per_partition_rate_limit_info.idl.hh',
         'idl/position_in_partition.idl.hh',
@@ -1183,10 +1207,13 @@ scylla_tests_dependencies = scylla_core + idls + scylla_tests_generic_dependenci
 scylla_raft_dependencies = scylla_raft_core + ['utils/uuid.cc', 'utils/error_injection.cc']
 
 scylla_tools = ['tools/scylla-types.cc', 'tools/scylla-sstable.cc', 'tools/schema_loader.cc', 'tools/utils.cc', 'tools/lua_sstable_consumer.cc']
-scylla_perfs = ['test/perf/perf_fast_forward.cc',
+scylla_perfs = ['test/perf/perf_compaction.cc',
+                'test/perf/perf_fast_forward.cc',
                 'test/perf/perf_row_cache_update.cc',
+                'test/perf/perf_schema_merge.cc',
                 'test/perf/perf_simple_query.cc',
                 'test/perf/perf_sstable.cc',
+                'test/perf/perf_workload.cc',
                 'test/perf/perf.cc',
                 'test/lib/alternator_test_env.cc',
                 'test/lib/cql_test_env.cc',
@@ -1232,6 +1259,7 @@ pure_boost_tests = set([
     'test/boost/serialization_test',
     'test/boost/small_vector_test',
     'test/boost/top_k_test',
+    'test/boost/two_choice_cache_test',
     'test/boost/vint_serialization_test',
     'test/boost/bptree_test',
     'test/boost/utf8_test',
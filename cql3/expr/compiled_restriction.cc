@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <boost/algorithm/cxx11/all_of.hpp>
+
+#include "compiled_restriction.hh"
+#include "cql3/selection/selection.hh"
+
+namespace cql3 {
+namespace expr {
+
+static bool is_comparison(oper_t op) {
+    switch (op) {
+    case oper_t::EQ:
+    case oper_t::NEQ:
+    case oper_t::LT:
+    case oper_t::LTE:
+    case oper_t::GT:
+    case oper_t::GTE:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static bool matches(std::strong_ordering cmp, oper_t op) {
+    switch (op) {
+    case oper_t::EQ:
+        return cmp == 0;
+    case oper_t::NEQ:
+        return cmp != 0;
+    case oper_t::LT:
+        return cmp < 0;
+    case oper_t::LTE:
+        return cmp <= 0;
+    case oper_t::GT:
+        return cmp > 0;
+    default:
+        return cmp >= 0;
+    }
+}
+
+static int64_t read_signed_integer(bytes_view v) {
+    int64_t ret = int8_t(v[0]);
+    for (size_t i = 1; i < v.size(); ++i) {
+        ret = (ret << 8) | uint8_t(v[i]);
+    }
+    return ret;
+}
+
+compiled_restriction::compiled_restriction(const expression& restr, const cql3::selection::selection& sel, const query_options& options) {
+    compile(restr, sel, options);
+}
+
+void compiled_restriction::compile(const expression& e, const cql3::selection::selection& sel, const query_options& options) {
+    if (auto conj = as_if<conjunction>(&e)) {
+        for (auto& child : conj->children) {
+            compile(child, sel, options);
+        }
+        return;
+    }
+    auto binop = as_if<binary_operator>(&e);
+    auto col = binop ? as_if<column_value>(&binop->lhs) : nullptr;
+    if (!col || !is_comparison(binop->op) || binop->null_handling != null_handling_style::sql
+            || !(is<constant>(binop->rhs) || is<bind_variable>(binop->rhs))) {
+        _others.push_back(e);
+        return;
+    }
+    auto value = evaluate(binop->rhs, options);
+    if (value.is_null()) {
+        _unsatisfiable = true;
+        return;
+    }
+    auto type = &col->col->type->without_reversed();
+    auto comparator = comparator_kind::generic;
+    switch (type->get_kind()) {
+    case abstract_type::kind::byte:
+    case abstract_type::kind::short_kind:
+    case abstract_type::kind::int32:
+    case abstract_type::kind::long_kind:
+    case abstract_type::kind::timestamp:
+        comparator = comparator_kind::signed_integer;
+        break;
+    case abstract_type::kind::ascii:
+    case abstract_type::kind::utf8:
+    case abstract_type::kind::bytes:
+        comparator = comparator_kind::unsigned_bytes;
+        break;
+    default:
+        break;
+    }
+    auto index = col->col->is_primary_key() ? -1 : sel.index_of(*col->col);
+    if (!col->col->is_primary_key() && index == -1) {
+        _others.push_back(e);
+        return;
+    }
+    _comparisons.push_back(comparison{col->col, binop->op, std::move(value).to_managed_bytes(), type, comparator, index});
+}
+
+bool compiled_restriction::is_satisfied_by(const comparison& c, const evaluation_inputs& inputs) const {
+    managed_bytes_view v;
+    switch (c.column->kind) {
+    case column_kind::partition_key:
+        v = managed_bytes_view(bytes_view((*inputs.partition_key)[c.column->id]));
+        break;
+    case column_kind::clustering_key:
+        if (c.column->id >= inputs.clustering_key->size()) {
+            return false;
+        }
+        v = managed_bytes_view(bytes_view((*inputs.clustering_key)[c.column->id]));
+        break;
+    default: {
+        auto& value = (*inputs.static_and_regular_columns)[c.index];
+        if (!value) {
+            return false;
+        }
+        v = managed_bytes_view(*value);
+    }
+    }
+    managed_bytes_view rhs(c.value);
+    // Empty values and fragmented ones are rare, leave them to the type.
+    if (c.comparator != comparator_kind::generic && v.size_bytes() == v.current_fragment().size() && rhs.size_bytes() == rhs.current_fragment().size()) {
+        auto a = v.current_fragment();
+        auto b = rhs.current_fragment();
+        if (c.comparator == comparator_kind::unsigned_bytes) {
+            return matches(compare_unsigned(a, b), c.op);
+        }
+        if (!a.empty() && a.size() == b.size() && a.size() <= sizeof(int64_t)) {
+            return matches(read_signed_integer(a) <=> read_signed_integer(b), c.op);
+        }
+    }
+    return matches(c.type->compare(v, rhs), c.op);
+}
+
+bool compiled_restriction::is_satisfied_by(const evaluation_inputs& inputs) const {
+    if (_unsatisfiable) {
+        return false;
+    }
+    for (auto& c : _comparisons) {
+        if (!is_satisfied_by(c, inputs)) {
+            return false;
+        }
+    }
+    return boost::algorithm::all_of(_others, [&] (const expression& e) {
+        return expr::is_satisfied_by(e, inputs);
+    });
+}
+
+} // namespace expr
+} // namespace cql3
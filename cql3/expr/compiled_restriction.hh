@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include "expression.hh"
+
+namespace cql3 {
+namespace expr {
+
+/// A restriction prepared for checking it against many rows, like those
+/// scanned by ALLOW FILTERING queries.
+///
+/// Comparisons of a column with a constant or a bind variable are checked
+/// directly on the serialized value of the column, without copying it, with
+/// the value of the other side evaluated once and a comparator picked up
+/// front for the type of the column. Integers are compared as such,
+/// strings and blobs bytewise, other types fall back to their compare().
+/// The rest of the restriction is checked with is_satisfied_by().
+class compiled_restriction {
+    enum class comparator_kind : uint8_t { signed_integer, unsigned_bytes, generic };
+    struct comparison {
+        const column_definition* column;
+        oper_t op;
+        managed_bytes value;
+        const abstract_type* type; // Without reversed.
+        comparator_kind comparator;
+        int32_t index; // In the selection, for static and regular columns.
+    };
+    std::vector<comparison> _comparisons;
+    std::vector<expression> _others;
+    // Compares with null, which is never satisfied.
+    bool _unsatisfiable = false;
+private:
+    void compile(const expression& e, const cql3::selection::selection& sel, const query_options& options);
+    bool is_satisfied_by(const comparison& c, const evaluation_inputs& inputs) const;
+public:
+    /// sel is the selection the rows the restriction is checked against are
+    /// read with, options hold the values of the bind variables.
+    compiled_restriction(const expression& restr, const cql3::selection::selection& sel, const query_options& options);
+
+    /// Same as expr::is_satisfied_by(restr, inputs).
+    bool is_satisfied_by(const evaluation_inputs& inputs) const;
+};
+
+} // namespace expr
+} // namespace cql3
@@ -28,6 +28,7 @@
 #include "types/list.hh"
 #include "types/map.hh"
 #include "types/set.hh"
+#include "types/listlike_partial_deserializing_iterator.hh"
 #include "utils/like_matcher.hh"
 #include "query-result-reader.hh"
 #include "types/user.hh"
@@ -380,26 +381,34 @@ bool_or_null contains(const expression& lhs, const expression& rhs, const evalua
     }
 
     const abstract_type& lhs_type = type_of(lhs)->without_reversed();
-    data_value lhs_collection = lhs_type.deserialize(managed_bytes_view(*sides_bytes.first));
-
     const collection_type_impl* collection_type = dynamic_cast<const collection_type_impl*>(&lhs_type);
     data_type element_type =
         collection_type->is_set() ? collection_type->name_comparator() : collection_type->value_comparator();
+    const managed_bytes_view value(*sides_bytes.second);
 
-    auto exists_in = [&](auto&& range) {
-        auto found = std::find_if(range.begin(), range.end(), [&](auto&& element) {
-            return element_type->compare(managed_bytes_view(element.serialize_nonnull()), *sides_bytes.second) == 0;
-        });
-        return found != range.end();
+    // Elements are compared in their serialized form, as they are found in
+    // the collection, rather than deserializing the whole collection first.
+    managed_bytes_view in(*sides_bytes.first);
+    auto matches = [&] (managed_bytes_view element) {
+        return element_type->compare(element, value) == 0;
     };
-    if (collection_type->is_list()) {
-        return exists_in(value_cast<list_type_impl::native_type>(lhs_collection));
-    } else if (collection_type->is_set()) {
-        return exists_in(value_cast<set_type_impl::native_type>(lhs_collection));
+    const int size = read_collection_size(in);
+    if (collection_type->is_list() || collection_type->is_set()) {
+        for (int i = 0; i < size; ++i) {
+            auto element = read_collection_value(in);
+            if (element && matches(*element)) {
+                return true;
+            }
+        }
+        return false;
     } else if (collection_type->is_map()) {
-        auto data_map = value_cast<map_type_impl::native_type>(lhs_collection);
-        using entry = std::pair<data_value, data_value>;
-        return exists_in(data_map | transformed([](const entry& e) { return e.second; }));
+        for (int i = 0; i < size; ++i) {
+            read_collection_key(in);
+            if (matches(read_collection_value_nonnull(in))) {
+                return true;
+            }
+        }
+        return false;
     } else {
         on_internal_error(expr_logger, "unsupported collection type in a CONTAINS expression");
     }
@@ -415,16 +424,16 @@ bool_or_null contains_key(const expression& lhs, const expression& rhs, const ev
     auto [lhs_bytes, rhs_bytes] = std::move(sides_bytes);
 
     data_type lhs_type = type_of(lhs);
-    const map_type_impl::native_type data_map =
-        value_cast<map_type_impl::native_type>(lhs_type->deserialize(managed_bytes_view(*lhs_bytes)));
     data_type key_type = static_pointer_cast<const collection_type_impl>(lhs_type)->name_comparator();
+    const managed_bytes_view key(*rhs_bytes);
 
-    for (const std::pair<data_value, data_value>& map_element : data_map) {
-        bytes serialized_element_key = map_element.first.serialize_nonnull();
-        if (key_type->compare(managed_bytes_view(*rhs_bytes), managed_bytes_view(bytes_view(serialized_element_key))) ==
-            0) {
+    managed_bytes_view in(*lhs_bytes);
+    const int size = read_collection_size(in);
+    for (int i = 0; i < size; ++i) {
+        if (key_type->compare(key, read_collection_key(in)) == 0) {
             return true;
-        };
+        }
+        read_collection_value_nonnull(in);
     }
 
     return false;
@@ -217,7 +217,9 @@ shared_ptr<function>
 make_to_json_function(data_type t) {
     return make_native_scalar_function<true>("tojson", utf8_type, {t},
             [t](std::span<const bytes_opt> parameters) -> bytes_opt {
-        return utf8_type->decompose(to_json_string(*t, parameters[0]));
+        bytes_ostream out;
+        write_json(out, *t, parameters[0]);
+        return bytes(out.linearize());
     });
 }
 
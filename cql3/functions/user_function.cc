@@ -12,6 +12,7 @@
 #include "lang/wasm.hh"
 
 #include <seastar/core/thread.hh>
+#include <boost/algorithm/cxx11/all_of.hpp>
 
 namespace cql3 {
 namespace functions {
@@ -48,14 +49,7 @@ bytes_opt user_function::execute(std::span<const bytes_opt> parameters) {
     }
     return seastar::visit(_ctx,
         [&] (lua_context& ctx) -> bytes_opt {
-            std::vector<data_value> values;
-            values.reserve(parameters.size());
-            for (int i = 0, n = types.size(); i != n; ++i) {
-                const data_type& type = types[i];
-                const bytes_opt& bytes = parameters[i];
-                values.push_back(bytes ? type->deserialize(*bytes) : data_value::make_null(type));
-            }
-            return lua::run_script(lua::bitcode_view{ctx.bitcode}, values, return_type(), ctx.cfg).get0();
+            return lua::run_script(lua::bitcode_view{ctx.bitcode}, ctx.states, parameters, types, return_type(), ctx.cfg).get0();
         },
         [&] (wasm::context& ctx) -> bytes_opt {
             try {
@@ -66,6 +60,57 @@ bytes_opt user_function::execute(std::span<const bytes_opt> parameters) {
         });
 }
 
+bool user_function::prefers_batch_execution() const {
+    // Each call of a WASM function has to look up and lock its cached instance.
+    return std::holds_alternative<wasm::context>(_ctx);
+}
+
+std::vector<bytes_opt> user_function::execute_batch(std::span<const std::vector<bytes_opt>> rows) {
+    auto* ctx = std::get_if<wasm::context>(&_ctx);
+    if (!ctx || rows.empty()) {
+        return scalar_function::execute_batch(rows);
+    }
+    const auto& types = arg_types();
+    if (!seastar::thread::running_in_thread()) {
+        on_internal_error(log, "User function cannot be executed in this context");
+    }
+
+    // Rows with a null parameter return null without calling the function, unless it is called on null input.
+    std::vector<size_t> called_rows;
+    for (size_t i = 0; i < rows.size(); ++i) {
+        if (rows[i].size() != types.size()) {
+            throw std::logic_error("Wrong number of parameters");
+        }
+        if (_called_on_null_input || boost::algorithm::all_of(rows[i], [] (const bytes_opt& p) { return bool(p); })) {
+            called_rows.push_back(i);
+        }
+    }
+    auto run = [&] (std::span<const std::vector<bytes_opt>> called) {
+        try {
+            return wasm::run_script_batch(name(), *ctx, types, called, return_type(), _called_on_null_input).get0();
+        } catch (const wasm::exception& e) {
+            throw exceptions::invalid_request_exception(format("UDF error: {}", e.what()));
+        }
+    };
+    if (called_rows.size() == rows.size()) {
+        return run(rows);
+    }
+    std::vector<bytes_opt> results(rows.size());
+    if (called_rows.empty()) {
+        return results;
+    }
+    std::vector<std::vector<bytes_opt>> called_parameters;
+    called_parameters.reserve(called_rows.size());
+    for (auto i : called_rows) {
+        called_parameters.push_back(rows[i]);
+    }
+    auto called_results = run(called_parameters);
+    for (size_t i = 0; i < called_rows.size(); ++i) {
+        results[called_rows[i]] = std::move(called_results[i]);
+    }
+    return results;
+}
+
 std::ostream& user_function::describe(std::ostream& os) const {
     auto ks = cql3::util::maybe_quote(name().keyspace);
     auto na = cql3::util::maybe_quote(name().name);
@@ -32,6 +32,8 @@ class user_function final : public abstract_function, public scalar_function, pu
         // lua_runtime in a thread_local variable, but that is one extra
         // global.
         lua::runtime_config cfg;
+        // States which have loaded the bitcode, reused by the calls of the function.
+        lua::state_cache states;
     };
 
     using context = std::variant<lua_context, wasm::context>;
@@ -60,6 +62,8 @@ class user_function final : public abstract_function, public scalar_function, pu
     virtual bool is_aggregate() const override;
     virtual bool requires_thread() const override;
     virtual bytes_opt execute(std::span<const bytes_opt> parameters) override;
+    virtual bool prefers_batch_execution() const override;
+    virtual std::vector<bytes_opt> execute_batch(std::span<const std::vector<bytes_opt>> rows) override;
 
     virtual sstring keypace_name() const override { return name().keyspace; }
     virtual sstring element_name() const override { return name().name; }
@@ -11,6 +11,7 @@
 #include "cql3/query_processor.hh"
 
 #include <seastar/core/metrics.hh>
+#include <seastar/core/coroutine.hh>
 
 #include "lang/wasm_alien_thread_runner.hh"
 #include "lang/wasm_instance_cache.hh"
@@ -72,6 +73,7 @@ query_processor::query_processor(service::storage_proxy& proxy, service::forward
         , _group0_client(group0_client)
         , _internal_state(new internal_state())
         , _prepared_cache(prep_cache_log, _mcfg.prepared_statment_cache_size)
+        , _direct_statements_cache(prep_cache_log, _mcfg.direct_statements_cache_size)
         , _authorized_prepared_cache(std::move(auth_prep_cache_cfg), authorized_prepared_statements_cache_log)
         , _auth_prepared_cache_cfg_cb([this] (uint32_t) { (void) _authorized_prepared_cache_config_action.trigger_later(); })
         , _authorized_prepared_cache_config_action([this] { update_authorized_prepared_cache_config(); return make_ready_future<>(); })
@@ -98,6 +100,15 @@ query_processor::query_processor(service::storage_proxy& proxy, service::forward
         "statements_prepared",
         _stats.prepare_invocations,
         sm::description("Counts the total number of parsed CQL requests.")));
+    qp_group.push_back(sm::make_counter(
+        "prepared_cache_shard_misses",
+        _stats.prepared_cache_shard_misses,
+        sm::description("Counts the executions of prepared statements which were missing from the prepared statements cache of the shard.")));
+    qp_group.push_back(sm::make_counter(
+        "statements_prepared_from_other_shards",
+        _stats.prepared_from_other_shards,
+        sm::description("Counts the prepared statements which were prepared again on the shard from the query string cached by another shard, "
+                        "instead of having the client prepare them again on all shards.")));
     for (auto cl = size_t(clevel::MIN_VALUE); cl <= size_t(clevel::MAX_VALUE); ++cl) {
         qp_group.push_back(
             sm::make_counter(
@@ -346,6 +357,11 @@ query_processor::query_processor(service::storage_proxy& proxy, service::forward
                             [this] { return _prepared_cache.memory_footprint(); },
                             sm::description("Size (in bytes) of the prepared statements cache.")),
 
+                    sm::make_gauge(
+                            "direct_statements_cache_size",
+                            [this] { return _direct_statements_cache.size(); },
+                            sm::description("A number of entries in the cache of statements executed without being prepared.")),
+
                     sm::make_counter(
                             "secondary_index_creates",
                             _cql_stats.secondary_index_creates,
@@ -471,7 +487,11 @@ query_processor::~query_processor() {
 
 future<> query_processor::stop() {
     return _mnotifier.unregister_listener(_migration_subscriber.get()).then([this] {
-        return _authorized_prepared_cache.stop().finally([this] { return _prepared_cache.stop(); });
+        return _authorized_prepared_cache.stop().finally([this] {
+            return _prepared_cache.stop();
+        }).finally([this] {
+            return _direct_statements_cache.stop();
+        });
     }).then([this] {
         return _wasm_instance_cache ? _wasm_instance_cache->stop() : make_ready_future<>();
     });
@@ -481,32 +501,33 @@ future<::shared_ptr<result_message>>
 query_processor::execute_direct_without_checking_exception_message(const sstring_view& query_string, service::query_state& query_state, query_options& options) {
     log.trace("execute_direct: \"{}\"", query_string);
     tracing::trace(query_state.get_trace_state(), "Parsing a statement");
-    auto p = get_statement(query_string, query_state.get_client_state());
-    auto cql_statement = p->statement;
-    const auto warnings = std::move(p->warnings);
-    if (cql_statement->get_bound_terms() != options.get_values_count()) {
-        const auto msg = format("Invalid amount of bind variables: expected {:d} received {:d}",
-                cql_statement->get_bound_terms(),
-                options.get_values_count());
-        throw exceptions::invalid_request_exception(msg);
-    }
-    options.prepare(p->bound_names);
+    return get_direct_statement(sstring(query_string), query_state.get_client_state()).then([this, &query_state, &options] (std::unique_ptr<statements::prepared_statement> p) {
+        auto cql_statement = p->statement;
+        auto warnings = std::move(p->warnings);
+        if (cql_statement->get_bound_terms() != options.get_values_count()) {
+            const auto msg = format("Invalid amount of bind variables: expected {:d} received {:d}",
+                    cql_statement->get_bound_terms(),
+                    options.get_values_count());
+            throw exceptions::invalid_request_exception(msg);
+        }
+        options.prepare(p->bound_names);
 
-    warn(unimplemented::cause::METRICS);
+        warn(unimplemented::cause::METRICS);
 #if 0
         if (!queryState.getClientState().isInternal)
             metrics.regularStatementsExecuted.inc();
 #endif
-    tracing::trace(query_state.get_trace_state(), "Processing a statement");
-    return cql_statement->check_access(*this, query_state.get_client_state()).then(
-            [this, cql_statement, &query_state, &options, warnings = std::move(warnings)] () mutable {
-        return process_authorized_statement(std::move(cql_statement), query_state, options).then(
-                [warnings = std::move(warnings)] (::shared_ptr<result_message> m) {
-                    for (const auto& w : warnings) {
-                        m->add_warning(w);
-                    }
-                    return make_ready_future<::shared_ptr<result_message>>(m);
-                });
+        tracing::trace(query_state.get_trace_state(), "Processing a statement");
+        return cql_statement->check_access(*this, query_state.get_client_state()).then(
+                [this, cql_statement, &query_state, &options, warnings = std::move(warnings)] () mutable {
+            return process_authorized_statement(std::move(cql_statement), query_state, options).then(
+                    [warnings = std::move(warnings)] (::shared_ptr<result_message> m) {
+                        for (const auto& w : warnings) {
+                            m->add_warning(w);
+                        }
+                        return make_ready_future<::shared_ptr<result_message>>(m);
+                    });
+        });
     });
 }
 
@@ -575,6 +596,33 @@ query_processor::prepare(sstring query_string, const service::client_state& clie
     }
 }
 
+future<statements::prepared_statement::checked_weak_ptr>
+query_processor::prepare_from_other_shards(const prepared_cache_key_type& key, const service::client_state& client_state) {
+    ++_stats.prepared_cache_shard_misses;
+    auto query_string = co_await container().map_reduce0([key] (query_processor& qp) -> std::optional<sstring> {
+        auto prepared = qp.get_prepared(key);
+        if (!prepared) {
+            return std::nullopt;
+        }
+        return prepared->statement->raw_cql_statement;
+    }, std::optional<sstring>(), [] (std::optional<sstring> found, std::optional<sstring> query_string) {
+        return found ? std::move(found) : std::move(query_string);
+    });
+    // The identifier also covers the keyspace the statement was prepared in,
+    // which other shards don't know.
+    if (!query_string || compute_id(*query_string, client_state.get_raw_keyspace()) != key) {
+        co_return statements::prepared_statement::checked_weak_ptr();
+    }
+    try {
+        co_await prepare(std::move(*query_string), client_state, false);
+    } catch (...) {
+        log.debug("Failed to prepare statement {} from other shards: {}", prepared_cache_key_type::cql_id(key), std::current_exception());
+        co_return statements::prepared_statement::checked_weak_ptr();
+    }
+    ++_stats.prepared_from_other_shards;
+    co_return get_prepared(key);
+}
+
 static std::string hash_target(std::string_view query_string, std::string_view keyspace) {
     std::string ret(keyspace);
     ret += query_string;
@@ -597,6 +645,26 @@ prepared_cache_key_type query_processor::compute_thrift_id(
     return prepared_cache_key_type(static_cast<int32_t>(h));
 }
 
+future<std::unique_ptr<prepared_statement>>
+query_processor::get_direct_statement(sstring query, const service::client_state& client_state) {
+    if (_mcfg.direct_statements_cache_size) {
+        try {
+            auto cached = co_await _direct_statements_cache.get(compute_id(query, client_state.get_raw_keyspace()), [this, &query, &client_state] {
+                return make_ready_future<std::unique_ptr<prepared_statement>>(get_statement(query, client_state));
+            });
+            // Executing the statement may yield, and the cache may evict it
+            // meanwhile, so give the caller its own copy.
+            if (cached) {
+                co_return std::make_unique<prepared_statement>(cached->statement, cached->bound_names,
+                        cached->partition_key_bind_indices, cached->warnings);
+            }
+        } catch (prepared_statements_cache::statement_is_too_big&) {
+            // Parse it for this execution only.
+        }
+    }
+    co_return get_statement(query, client_state);
+}
+
 std::unique_ptr<prepared_statement>
 query_processor::get_statement(const sstring_view& query, const service::client_state& client_state) {
     std::unique_ptr<raw::parsed_statement> statement = parse_statement(query);
@@ -929,6 +997,9 @@ void query_processor::migration_subscriber::remove_invalid_prepared_statements(
     _qp->_prepared_cache.remove_if([&] (::shared_ptr<cql_statement> stmt) {
         return this->should_invalidate(ks_name, cf_name, stmt);
     });
+    _qp->_direct_statements_cache.remove_if([&] (::shared_ptr<cql_statement> stmt) {
+        return this->should_invalidate(ks_name, cf_name, stmt);
+    });
 }
 
 bool query_processor::migration_subscriber::should_invalidate(
@@ -89,6 +89,7 @@ class query_processor : public seastar::peering_sharded_service<query_processor>
     struct memory_config {
         size_t prepared_statment_cache_size = 0;
         size_t authorized_prepared_cache_size = 0;
+        size_t direct_statements_cache_size = 0;
     };
 
 private:
@@ -104,6 +105,8 @@ class query_processor : public seastar::peering_sharded_service<query_processor>
 
     struct stats {
         uint64_t prepare_invocations = 0;
+        uint64_t prepared_cache_shard_misses = 0;
+        uint64_t prepared_from_other_shards = 0;
         uint64_t queries_by_cl[size_t(db::consistency_level::MAX_VALUE) + 1] = {};
     } _stats;
 
@@ -115,6 +118,9 @@ class query_processor : public seastar::peering_sharded_service<query_processor>
     std::unique_ptr<internal_state> _internal_state;
 
     prepared_statements_cache _prepared_cache;
+    // Statements executed without being prepared first, so that their text
+    // is parsed only once.
+    prepared_statements_cache _direct_statements_cache;
     authorized_prepared_statements_cache _authorized_prepared_cache;
 
     std::function<void(uint32_t)> _auth_prepared_cache_cfg_cb;
@@ -211,6 +217,16 @@ class query_processor : public seastar::peering_sharded_service<query_processor>
         return _prepared_cache.find(key);
     }
 
+    /// Prepares the CQL statement of key on this shard, if it was evicted
+    /// from the cache of this shard but not of some other one, so that the
+    /// client doesn't have to be told to prepare it again on all shards.
+    ///
+    /// \return the prepared statement, or a null pointer if no other shard
+    ///         has it either, or it was prepared in another keyspace than the
+    ///         current one of client_state.
+    future<statements::prepared_statement::checked_weak_ptr> prepare_from_other_shards(
+            const prepared_cache_key_type& key, const service::client_state& client_state);
+
     service::raft_group0_client& get_group0_client() {
         return _group0_client;
     }
@@ -394,6 +410,10 @@ class query_processor : public seastar::peering_sharded_service<query_processor>
             query_options& options,
             std::unordered_map<prepared_cache_key_type, authorized_prepared_statements_cache::value_type> pending_authorization_entries);
 
+    future<std::unique_ptr<statements::prepared_statement>> get_direct_statement(
+            sstring query,
+            const service::client_state& client_state);
+
     std::unique_ptr<statements::prepared_statement> get_statement(
             const std::string_view& query,
             const service::client_state& client_state);
@@ -197,6 +197,27 @@ static std::vector<expr::expression> extract_partition_range(
     return {};
 }
 
+/// Returns the values of `column = value` restrictions of all partition columns, in partition key order, given the
+/// partition range found by extract_partition_range().  Returns an empty vector if some partition column is
+/// restricted otherwise.
+static std::vector<expr::expression> extract_partition_key_values(
+        const std::vector<expr::expression>& partition_range, const schema& schema) {
+    using namespace expr;
+    if (partition_range.size() != schema.partition_key_size()) {
+        return {};
+    }
+    std::vector<const expression*> values(schema.partition_key_size());
+    for (const auto& e : partition_range) {
+        const auto b = as_if<binary_operator>(&e);
+        const auto col = b ? as_if<column_value>(&b->lhs) : nullptr;
+        if (!col || b->op != oper_t::EQ || !(is<constant>(b->rhs) || is<bind_variable>(b->rhs))) {
+            return {};
+        }
+        values[schema.position(*col->col)] = &b->rhs;
+    }
+    return boost::copy_range<std::vector<expression>>(values | boost::adaptors::indirected);
+}
+
 /// Extracts where_clause atoms with clustering-column LHS and copies them to a vector.  These elements define the
 /// boundaries of any clustering slice that can possibly meet where_clause.  This vector can be calculated before
 /// binding expression markers, since LHS and operator are always known.
@@ -367,6 +388,7 @@ statement_restrictions::statement_restrictions(data_dictionary::database db,
         _single_column_nonprimary_key_restrictions = expr::get_single_column_restrictions_map(_nonprimary_key_restrictions);
         _clustering_prefix_restrictions = extract_clustering_prefix_restrictions(*_where, _schema);
         _partition_range_restrictions = extract_partition_range(*_where, _schema);
+        _partition_key_values = extract_partition_key_values(_partition_range_restrictions, *_schema);
     }
     auto cf = db.find_column_family(schema);
     auto& sim = cf.get_index_manager();
@@ -1013,9 +1035,28 @@ dht::partition_range_vector partition_ranges_from_EQs(
     return {range_from_bytes(schema, pk_value)};
 }
 
+/// Computes the partition-key range from the values of all partition columns.  Returns an empty vector if some
+/// value is NULL.
+dht::partition_range_vector partition_range_from_values(
+        const std::vector<expr::expression>& values, const query_options& options, const schema& schema) {
+    std::vector<managed_bytes> pk_value;
+    pk_value.reserve(values.size());
+    for (const auto& e : values) {
+        auto val = expr::evaluate(e, options).to_managed_bytes_opt();
+        if (!val) { // All NULL comparisons fail; no column values match.
+            return {};
+        }
+        pk_value.push_back(std::move(*val));
+    }
+    return {range_from_bytes(schema, pk_value)};
+}
+
 } // anonymous namespace
 
 dht::partition_range_vector statement_restrictions::get_partition_key_ranges(const query_options& options) const {
+    if (!_partition_key_values.empty()) {
+        return partition_range_from_values(_partition_key_values, options, *_schema);
+    }
     if (_partition_range_restrictions.empty()) {
         return {dht::partition_range::make_open_ended_both_sides()};
     }
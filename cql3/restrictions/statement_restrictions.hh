@@ -110,6 +110,10 @@ class statement_restrictions {
 
     bool _partition_range_is_simple; ///< False iff _partition_range_restrictions imply a Cartesian product.
 
+    /// If every partition column is restricted by a single `column = value` restriction, the values, in partition
+    /// key order, so that executions of the statement only need to evaluate them.  Otherwise empty.
+    std::vector<expr::expression> _partition_key_values;
+
 public:
     /**
      * Creates a new empty <code>StatementRestrictions</code>.
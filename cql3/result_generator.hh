@@ -32,6 +32,16 @@ class result_generator {
         Visitor& _visitor;
         const selection::selection& _selection;
     private:
+        // Reuses the storage of the components of the previous key, so that
+        // exploding the keys of most rows doesn't allocate.
+        template <typename Key>
+        void explode_into(std::vector<bytes>& components, const Key& key) {
+            components.clear();
+            for (managed_bytes_view c : key.components(_schema)) {
+                components.emplace_back(to_bytes(c));
+            }
+        }
+
         void accept_cell_value(const column_definition& def, query::result_row_view::iterator_type& i) {
             if (def.is_multi_cell()) {
                 _visitor.accept_value(i.next_collection_cell());
@@ -45,7 +55,7 @@ class result_generator {
             : _schema(s), _visitor(visitor), _selection(select) { }
 
         void accept_new_partition(const partition_key& key, uint64_t row_count) {
-            _partition_key = key.explode(_schema);
+            explode_into(_partition_key, key);
             accept_new_partition(row_count);
         }
         void accept_new_partition(uint64_t row_count) {
@@ -55,7 +65,7 @@ class result_generator {
 
         void accept_new_row(const clustering_key& key, query::result_row_view static_row,
                             query::result_row_view row) {
-            _clustering_key = key.explode(_schema);
+            explode_into(_clustering_key, key);
             accept_new_row(static_row, row);
         }
         void accept_new_row(query::result_row_view static_row, query::result_row_view row) {
@@ -118,6 +118,14 @@ void result_set::add_row(std::vector<bytes_opt> row) {
     _rows.emplace_back(std::move(row));
 }
 
+void result_set::set_column_values(size_t column, std::vector<bytes_opt> values) {
+    assert(column < _metadata->value_count());
+    assert(values.size() == _rows.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+        _rows[i][column] = std::move(values[i]);
+    }
+}
+
 void result_set::add_column_value(bytes_opt value) {
     if (_rows.empty() || _rows.back().size() == _metadata->value_count()) {
         std::vector<bytes_opt> row;
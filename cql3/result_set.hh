@@ -160,6 +160,9 @@ class result_set {
 
     void add_column_value(col_type value);
 
+    // Replaces the values of the given column, values[i] going to the i-th row.
+    void set_column_values(size_t column, std::vector<col_type> values);
+
     void reverse();
 
     void trim(size_t limit);
@@ -172,6 +175,22 @@ class result_set {
         std::sort(_rows.begin(), _rows.end(), cmp);
     }
 
+    // Keeps only the first limit rows in the order of cmp, sorted.
+    // Equivalent to sort() followed by trim(limit), but only orders the
+    // rows kept, in O(n log limit).
+    template<typename RowComparator>
+    requires requires (RowComparator cmp, const row_type& row) {
+        { cmp(row, row) } -> std::same_as<bool>;
+    }
+    void sort_top(const RowComparator& cmp, size_t limit) {
+        if (_rows.size() <= limit) {
+            sort(cmp);
+            return;
+        }
+        std::partial_sort(_rows.begin(), _rows.begin() + limit, _rows.end(), cmp);
+        trim(limit);
+    }
+
     metadata& get_metadata();
 
     const metadata& get_metadata() const;
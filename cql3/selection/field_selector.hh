@@ -11,6 +11,7 @@
 #pragma once
 
 #include "selector.hh"
+#include "simple_selector.hh"
 #include "types/types.hh"
 #include "types/user.hh"
 
@@ -18,10 +19,22 @@ namespace cql3 {
 
 namespace selection {
 
+// The position of a (possibly nested) field of a user type value in the result set:
+// the index of the column holding the value, and the indexes of the fields leading to it.
+struct field_path {
+    uint32_t column_idx;
+    std::vector<size_t> fields;
+};
+
 class field_selector : public selector {
     user_type _type;
     size_t _field;
     shared_ptr<selector> _selected;
+    // Set if the field belongs to a column of the result set, in which case it is read
+    // straight from the serialized column, without copying the whole value first.
+    std::optional<field_path> _path;
+    bytes_opt _current;
+    bool _first = true; ///< Whether the next row we receive is the first in its group.
 public:
     static shared_ptr<factory> new_factory(user_type type, size_t field, shared_ptr<selector::factory> factory) {
         struct field_selector_factory : selector::factory {
@@ -43,8 +56,23 @@ class field_selector : public selector {
                 return _type->field_type(_field);
             }
 
+            std::optional<field_path> path() const {
+                if (_factory->is_simple_selector_factory()) {
+                    return field_path{static_cast<const simple_selector_factory&>(*_factory).column_index(), {_field}};
+                }
+                auto selected = dynamic_cast<const field_selector_factory*>(_factory.get());
+                if (!selected) {
+                    return std::nullopt;
+                }
+                auto path = selected->path();
+                if (path) {
+                    path->fields.push_back(_field);
+                }
+                return path;
+            }
+
             shared_ptr<selector> new_instance() const override {
-                return make_shared<field_selector>(_type, _field, _factory->new_instance());
+                return make_shared<field_selector>(_type, _field, _factory->new_instance(), path());
             }
 
             bool is_aggregate_selector_factory() const override {
@@ -59,10 +87,33 @@ class field_selector : public selector {
     }
 
     virtual void add_input(result_set_builder& rs) override {
-        _selected->add_input(rs);
+        if (!_path) {
+            _selected->add_input(rs);
+            return;
+        }
+        // Keeps the first value of a group, like simple_selector does.
+        if (!_first) {
+            return;
+        }
+        _first = false;
+        auto& value = (*rs.current)[_path->column_idx];
+        if (!value) {
+            return;
+        }
+        std::optional<single_fragmented_view> v = single_fragmented_view(*value);
+        for (auto field : _path->fields) {
+            v = read_nth_tuple_element(*v, field);
+            if (!v) {
+                return;
+            }
+        }
+        _current = linearized(*v);
     }
 
     virtual bytes_opt get_output() override {
+        if (_path) {
+            return std::move(_current);
+        }
         auto&& value = _selected->get_output();
         if (!value) {
             return std::nullopt;
@@ -76,6 +127,8 @@ class field_selector : public selector {
 
     virtual void reset() override {
         _selected->reset();
+        _current = std::nullopt;
+        _first = true;
     }
 
     virtual sstring assignment_testable_source_context() const override {
@@ -84,8 +137,8 @@ class field_selector : public selector {
         return format("{}.{}", _selected, sname);
     }
 
-    field_selector(user_type type, size_t field, shared_ptr<selector> selected)
-            : _type(std::move(type)), _field(field), _selected(std::move(selected)) {
+    field_selector(user_type type, size_t field, shared_ptr<selector> selected, std::optional<field_path> path = std::nullopt)
+            : _type(std::move(type)), _field(field), _selected(std::move(selected)), _path(std::move(path)) {
     }
 };
 
@@ -48,6 +48,26 @@ class scalar_function_selector : public abstract_function_selector_for<functions
         return fun()->execute(_args);
     }
 
+    bool prefers_batch_execution() const {
+        return fun()->prefers_batch_execution();
+    }
+
+    std::vector<bytes_opt> execute_batch(std::span<const std::vector<bytes_opt>> rows) {
+        return fun()->execute_batch(rows);
+    }
+
+    // Like get_output(), but returns the arguments of the function instead
+    // of calling it, so that the caller can call execute_batch() on many of them.
+    std::vector<bytes_opt> get_output_arguments() {
+        std::vector<bytes_opt> args;
+        args.reserve(_arg_selectors.size());
+        for (auto&& s : _arg_selectors) {
+            args.push_back(s->get_output());
+            s->reset();
+        }
+        return args;
+    }
+
     virtual bool requires_thread() const override;
 
     scalar_function_selector(shared_ptr<functions::function> fun, std::vector<shared_ptr<selector>> arg_selectors)
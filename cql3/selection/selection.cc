@@ -17,9 +17,11 @@
 #include "cql3/selection/raw_selector.hh"
 #include "cql3/selection/selector_factories.hh"
 #include "cql3/selection/abstract_function_selector.hh"
+#include "cql3/selection/scalar_function_selector.hh"
 #include "cql3/result_set.hh"
 #include "cql3/query_options.hh"
 #include "cql3/restrictions/statement_restrictions.hh"
+#include "cql3/expr/compiled_restriction.hh"
 
 namespace cql3 {
 
@@ -203,6 +205,11 @@ class selection_with_processing : public selection {
         return _factories->get_reductions();
     }
 
+    virtual std::optional<query::forward_request::grouped_reductions_info>
+    get_grouped_reductions(const std::vector<const column_definition*>& group_by) const override {
+        return _factories->get_grouped_reductions(group_by);
+    }
+
     virtual std::vector<shared_ptr<functions::function>> used_functions() const override {
         return selectors_with_processing(_factories).used_functions();
     }
@@ -213,12 +220,30 @@ class selection_with_processing : public selection {
         ::shared_ptr<selector_factories> _factories;
         std::vector<::shared_ptr<selector>> _selectors;
         bool _requires_thread;
+        // Top-level function calls which are evaluated for all output rows at
+        // once in complete_output(), see scalar_function::prefers_batch_execution().
+        struct batched_call {
+            size_t column;
+            ::shared_ptr<scalar_function_selector> selector;
+            std::vector<std::vector<bytes_opt>> arguments;
+        };
+        std::vector<batched_call> _batched_calls;
     public:
         selectors_with_processing(::shared_ptr<selector_factories> factories)
             : _factories(std::move(factories))
             , _selectors(_factories->new_instances())
             , _requires_thread(boost::algorithm::any_of(_selectors, [] (auto& s) { return s->requires_thread(); }))
-        { }
+        {
+            if (_factories->does_aggregation()) {
+                return;
+            }
+            for (size_t i = 0; i < _selectors.size(); ++i) {
+                auto fun_selector = dynamic_pointer_cast<scalar_function_selector>(_selectors[i]);
+                if (fun_selector && fun_selector->prefers_batch_execution()) {
+                    _batched_calls.push_back(batched_call{i, std::move(fun_selector), {}});
+                }
+            }
+        }
 
         virtual bool requires_thread() const override {
             return _requires_thread;
@@ -237,8 +262,15 @@ class selection_with_processing : public selection {
         virtual std::vector<bytes_opt> get_output_row() override {
             std::vector<bytes_opt> output_row;
             output_row.reserve(_selectors.size());
-            for (auto&& s : _selectors) {
-                output_row.emplace_back(s->get_output());
+            auto batched = _batched_calls.begin();
+            for (size_t i = 0; i < _selectors.size(); ++i) {
+                if (batched != _batched_calls.end() && batched->column == i) {
+                    batched->arguments.push_back(batched->selector->get_output_arguments());
+                    output_row.emplace_back();
+                    ++batched;
+                } else {
+                    output_row.emplace_back(_selectors[i]->get_output());
+                }
             }
             return output_row;
         }
@@ -249,6 +281,14 @@ class selection_with_processing : public selection {
             }
         }
 
+        virtual void complete_output(result_set& rs) override {
+            for (auto& call : _batched_calls) {
+                auto results = call.selector->execute_batch(call.arguments);
+                call.arguments.clear();
+                rs.set_column_values(call.column, std::move(results));
+            }
+        }
+
         std::vector<shared_ptr<functions::function>> used_functions() const {
             std::vector<shared_ptr<functions::function>> functions;
             for (const auto& selector : _selectors) {
@@ -425,6 +465,7 @@ void result_set_builder::new_row() {
 
 std::unique_ptr<result_set> result_set_builder::build() {
     process_current_row(/*more_rows_coming=*/false);
+    _selectors->complete_output(*_result_set);
     if (_result_set->empty() && _selectors->is_aggregate()) {
         _result_set->add_row(_selectors->get_output_row());
     }
@@ -450,6 +491,12 @@ result_set_builder::restrictions_filter::restrictions_filter(::shared_ptr<const
     , _last_pkey(std::move(last_pkey))
 { }
 
+struct result_set_builder::restrictions_filter::compiled {
+    // In the order of the columns of the selection.
+    std::vector<std::pair<const column_definition*, expr::compiled_restriction>> restrictions;
+    bool has_non_pk_restrictions = false;
+};
+
 bool result_set_builder::restrictions_filter::do_filter(const selection& selection,
                                                          const std::vector<bytes>& partition_key,
                                                          const std::vector<bytes>& clustering_key,
@@ -461,108 +508,81 @@ bool result_set_builder::restrictions_filter::do_filter(const selection& selecti
         return false;
     }
 
+    if (!_compiled) {
+        auto c = std::make_shared<compiled>();
+        const expr::single_column_restrictions_map& non_pk_restrictions_map = _restrictions->get_non_pk_restriction();
+        const expr::single_column_restrictions_map& partition_key_restrictions_map = _restrictions->get_single_column_partition_key_restrictions();
+        const expr::single_column_restrictions_map& clustering_key_restrictions_map = _restrictions->get_single_column_clustering_key_restrictions();
+        for (auto&& cdef : selection.get_columns()) {
+            const expr::single_column_restrictions_map* map = nullptr;
+            switch (cdef->kind) {
+            case column_kind::static_column:
+            case column_kind::regular_column:
+                map = &non_pk_restrictions_map;
+                break;
+            case column_kind::partition_key:
+                map = _skip_pk_restrictions ? nullptr : &partition_key_restrictions_map;
+                break;
+            case column_kind::clustering_key:
+                map = _skip_ck_restrictions ? nullptr : &clustering_key_restrictions_map;
+                break;
+            default:
+                break;
+            }
+            auto restr_it = map ? map->find(cdef) : expr::single_column_restrictions_map::const_iterator();
+            if (!map || restr_it == map->end()) {
+                continue;
+            }
+            c->restrictions.emplace_back(cdef, expr::compiled_restriction(restr_it->second, selection, _options));
+            c->has_non_pk_restrictions |= !cdef->is_primary_key();
+        }
+        _compiled = std::move(c);
+    }
+
+    std::vector<managed_bytes_opt> static_and_regular_columns;
     const expr::expression& clustering_columns_restrictions = _restrictions->get_clustering_columns_restrictions();
-    if (expr::contains_multi_column_restriction(clustering_columns_restrictions)) {
-        clustering_key_prefix ckey = clustering_key_prefix::from_exploded(clustering_key);
-        // FIXME: push to upper layer so it happens once per row
-        auto static_and_regular_columns = expr::get_non_pk_values(selection, static_row, row);
-        bool multi_col_clustering_satisfied = expr::is_satisfied_by(
-                clustering_columns_restrictions,
-                expr::evaluation_inputs{
-                    .partition_key = &partition_key,
-                    .clustering_key = &clustering_key,
-                    .static_and_regular_columns = &static_and_regular_columns,
-                    .selection = &selection,
-                    .options = &_options,
-                });
+    bool multi_column_clustering_restrictions = expr::contains_multi_column_restriction(clustering_columns_restrictions);
+    if (multi_column_clustering_restrictions || _compiled->has_non_pk_restrictions) {
+        static_and_regular_columns = expr::get_non_pk_values(selection, static_row, row);
+    }
+    auto inputs = expr::evaluation_inputs{
+        .partition_key = &partition_key,
+        .clustering_key = &clustering_key,
+        .static_and_regular_columns = &static_and_regular_columns,
+        .selection = &selection,
+        .options = &_options,
+    };
+
+    if (multi_column_clustering_restrictions) {
+        bool multi_col_clustering_satisfied = expr::is_satisfied_by(clustering_columns_restrictions, inputs);
         if (!multi_col_clustering_satisfied) {
             return false;
         }
     }
 
-    auto static_row_iterator = static_row.iterator();
-    auto row_iterator = row ? std::optional<query::result_row_view::iterator_type>(row->iterator()) : std::nullopt;
-    const expr::single_column_restrictions_map& non_pk_restrictions_map = _restrictions->get_non_pk_restriction();
-    for (auto&& cdef : selection.get_columns()) {
+    for (auto&& [cdef, restriction] : _compiled->restrictions) {
         switch (cdef->kind) {
         case column_kind::static_column:
             // fallthrough
-        case column_kind::regular_column: {
-            if (cdef->kind == column_kind::regular_column && !row_iterator) {
-                continue;
-            }
-            auto restr_it = non_pk_restrictions_map.find(cdef);
-            if (restr_it == non_pk_restrictions_map.end()) {
+        case column_kind::regular_column:
+            if (cdef->kind == column_kind::regular_column && !row) {
                 continue;
             }
-            const expr::expression& single_col_restriction = restr_it->second;
-            // FIXME: push to upper layer so it happens once per row
-            auto static_and_regular_columns = expr::get_non_pk_values(selection, static_row, row);
-            bool regular_restriction_matches = expr::is_satisfied_by(
-                    single_col_restriction,
-                    expr::evaluation_inputs{
-                        .partition_key = &partition_key,
-                        .clustering_key = &clustering_key,
-                        .static_and_regular_columns = &static_and_regular_columns,
-                        .selection = &selection,
-                        .options = &_options,
-                    });
-            if (!regular_restriction_matches) {
+            if (!restriction.is_satisfied_by(inputs)) {
                 _current_static_row_does_not_match = (cdef->kind == column_kind::static_column);
                 return false;
             }
-            }
             break;
-        case column_kind::partition_key: {
-            if (_skip_pk_restrictions) {
-                continue;
-            }
-            auto partition_key_restrictions_map = _restrictions->get_single_column_partition_key_restrictions();
-            auto restr_it = partition_key_restrictions_map.find(cdef);
-            if (restr_it == partition_key_restrictions_map.end()) {
-                continue;
-            }
-            const expr::expression& single_col_restriction = restr_it->second;
-            if (!expr::is_satisfied_by(
-                        single_col_restriction,
-                        expr::evaluation_inputs{
-                            .partition_key = &partition_key,
-                            .clustering_key = &clustering_key,
-                            .static_and_regular_columns = nullptr, // partition key filtering only
-                            .selection = &selection,
-                            .options = &_options,
-                        })) {
+        case column_kind::partition_key:
+            if (!restriction.is_satisfied_by(inputs)) {
                 _current_partition_key_does_not_match = true;
                 return false;
             }
-            }
             break;
-        case column_kind::clustering_key: {
-            if (_skip_ck_restrictions) {
-                continue;
-            }
-            const expr::single_column_restrictions_map& clustering_key_restrictions_map =
-                _restrictions->get_single_column_clustering_key_restrictions();
-            auto restr_it = clustering_key_restrictions_map.find(cdef);
-            if (restr_it == clustering_key_restrictions_map.end()) {
-                continue;
-            }
-            if (clustering_key.empty()) {
-                return false;
-            }
-            const expr::expression& single_col_restriction = restr_it->second;
-            if (!expr::is_satisfied_by(
-                        single_col_restriction,
-                        expr::evaluation_inputs{
-                            .partition_key = &partition_key,
-                            .clustering_key = &clustering_key,
-                            .static_and_regular_columns = nullptr, // clustering key checks only
-                            .selection = &selection,
-                            .options = &_options,
-                        })) {
+        case column_kind::clustering_key:
+            if (clustering_key.empty() || !restriction.is_satisfied_by(inputs)) {
                 return false;
             }
-            }
             break;
         default:
             break;
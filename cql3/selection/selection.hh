@@ -55,6 +55,13 @@ class selectors {
     virtual std::vector<bytes_opt> get_output_row() = 0;
 
     virtual void reset() = 0;
+
+    /**
+     * Called once all the output rows were added to the result set.
+     * Fills in the values which get_output_row() left out, to compute them
+     * for all rows at once.
+     */
+    virtual void complete_output(result_set& rs) {}
 };
 
 class selection {
@@ -151,6 +158,12 @@ class selection {
 
     virtual query::forward_request::reductions_info get_reductions() const {return {{}, {}};}
 
+    // The reductions computing the selectors for each group of rows with the
+    // same values of the group_by columns, or std::nullopt if some selector
+    // is neither a reducible aggregate nor one of these columns.
+    virtual std::optional<query::forward_request::grouped_reductions_info>
+    get_grouped_reductions(const std::vector<const column_definition*>& group_by) const {return std::nullopt;}
+
     /**
      * Checks that selectors are either all aggregates or that none of them is.
      *
@@ -233,6 +246,10 @@ class result_set_builder {
         mutable uint64_t _rows_fetched_for_last_partition;
         mutable std::optional<partition_key> _last_pkey;
         mutable bool _is_first_partition_on_page = true;
+        // The restrictions to check, compiled on the first row, when the
+        // selection is known.
+        struct compiled;
+        mutable std::shared_ptr<const compiled> _compiled;
     public:
         explicit restrictions_filter(::shared_ptr<const restrictions::statement_restrictions> restrictions,
                 const query_options& options,
@@ -145,6 +145,34 @@ class selector_factories {
         return {types, infos};
     }
 
+    std::optional<query::forward_request::grouped_reductions_info>
+    get_grouped_reductions(const std::vector<const column_definition*>& group_by) const {
+        query::forward_request::grouped_reductions_info ret;
+        for (const auto& factory: _factories) {
+            if (factory->is_simple_selector_factory()) {
+                auto it = std::find_if(group_by.begin(), group_by.end(), [&] (const column_definition* cdef) {
+                    return cdef->name_as_text() == factory->column_name();
+                });
+                if (it == group_by.end()) {
+                    return std::nullopt;
+                }
+                ret.group_by_positions.push_back(it - group_by.begin());
+                continue;
+            }
+            if (!factory->is_reducible_selector_factory() || !factory->contains_only_simple_arguments()) {
+                return std::nullopt;
+            }
+            auto r = factory->get_reduction();
+            if (!r) {
+                return std::nullopt;
+            }
+            ret.reductions.types.push_back(r->first);
+            ret.reductions.infos.push_back(r->second);
+            ret.group_by_positions.push_back(std::nullopt);
+        }
+        return ret;
+    }
+
     /**
      * Checks if this <code>SelectorFactories</code> contains at least one factory for writetime selectors.
      *
@@ -41,6 +41,11 @@ class simple_selector_factory : public selector::factory {
         return _type;
     }
 
+    // The index of the selected column in the result set.
+    uint32_t column_index() const {
+        return _idx;
+    }
+
     virtual ::shared_ptr<selector> new_instance() const override;
 };
 
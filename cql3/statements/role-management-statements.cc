@@ -418,7 +418,8 @@ future<result_message_ptr>
 grant_role_statement::execute(query_processor&, service::query_state& state, const query_options&) const {
     auto& as = *state.get_client_state().get_auth_service();
 
-    return as.underlying_role_manager().grant(_grantee, _role).then([] {
+    return as.underlying_role_manager().grant(_grantee, _role).then([&as] {
+        as.request_permissions_cache_preload();
         return void_result_message();
     }).handle_exception_type([](const auth::roles_argument_exception& e) {
         return make_exception_future<result_message_ptr>(exceptions::invalid_request_exception(e.what()));
@@ -446,9 +447,10 @@ future<result_message_ptr> revoke_role_statement::execute(
         query_processor&,
         service::query_state& state,
         const query_options&) const {
-    auto& rm = state.get_client_state().get_auth_service()->underlying_role_manager();
+    auto& as = *state.get_client_state().get_auth_service();
 
-    return rm.revoke(_revokee, _role).then([] {
+    return as.underlying_role_manager().revoke(_revokee, _role).then([&as] {
+        as.request_permissions_cache_preload();
         return void_result_message();
     }).handle_exception_type([](const auth::roles_argument_exception& e) {
         return make_exception_future<result_message_ptr>(exceptions::invalid_request_exception(e.what()));
@@ -26,6 +26,7 @@
 #include "validation.hh"
 #include "exceptions/unrecognized_entity_exception.hh"
 #include <optional>
+#include <span>
 #include <seastar/core/shared_ptr.hh>
 #include "query-result-reader.hh"
 #include "query_ranges_to_vnodes.hh"
@@ -37,6 +38,7 @@
 #include "partition_slice_builder.hh"
 #include "cql3/untyped_result_set.hh"
 #include "db/timeout_clock.hh"
+#include "db/config.hh"
 #include "db/consistency_level_validations.hh"
 #include "data_dictionary/data_dictionary.hh"
 #include "test/lib/select_statement_utils.hh"
@@ -332,6 +334,44 @@ select_statement::execute_without_checking_exception_message(query_processor& qp
     return select_stage(this, seastar::ref(qp), seastar::ref(state), seastar::cref(options));
 }
 
+static std::optional<query::column_filter::op> to_column_filter_op(expr::oper_t op) {
+    switch (op) {
+    case expr::oper_t::EQ: return query::column_filter::op::eq;
+    case expr::oper_t::NEQ: return query::column_filter::op::neq;
+    case expr::oper_t::LT: return query::column_filter::op::lt;
+    case expr::oper_t::LTE: return query::column_filter::op::lte;
+    case expr::oper_t::GT: return query::column_filter::op::gt;
+    case expr::oper_t::GTE: return query::column_filter::op::gte;
+    default: return std::nullopt;
+    }
+}
+
+// Collects the comparisons of single regular columns to values among the
+// restrictions, which replicas can check on their own. The others are
+// left to the coordinator, which checks all of them anyway.
+static void add_column_filters(std::vector<query::column_filter>& filters, const column_definition& cdef, const expr::expression& e,
+        const query::partition_slice& slice, const query_options& options) {
+    if (auto conj = expr::as_if<expr::conjunction>(&e)) {
+        for (auto& child : conj->children) {
+            add_column_filters(filters, cdef, child, slice, options);
+        }
+        return;
+    }
+    auto binop = expr::as_if<expr::binary_operator>(&e);
+    auto col = binop ? expr::as_if<expr::column_value>(&binop->lhs) : nullptr;
+    auto op = binop ? to_column_filter_op(binop->op) : std::nullopt;
+    if (!col || col->col != &cdef || !op || binop->null_handling != expr::null_handling_style::sql
+            || !(expr::is<expr::constant>(binop->rhs) || expr::is<expr::bind_variable>(binop->rhs))
+            || std::find(slice.regular_columns.begin(), slice.regular_columns.end(), cdef.id) == slice.regular_columns.end()) {
+        return;
+    }
+    auto value = expr::evaluate(binop->rhs, options);
+    if (value.is_null()) {
+        return;
+    }
+    filters.push_back(query::column_filter{cdef.id, *op, std::move(value).to_bytes()});
+}
+
 future<shared_ptr<cql_transport::messages::result_message>>
 select_statement::do_execute(query_processor& qp,
                           service::query_state& state,
@@ -410,6 +450,16 @@ select_statement::do_execute(query_processor& qp,
     }
 
     command->slice.options.set<query::partition_slice::option::allow_short_read>();
+    // Rows filtered out on the replicas aren't sent to us, saving the replicas
+    // from serializing them and us from merging them. Per partition limits
+    // must count the rows which passed the filter, so they are checked here.
+    if (_restrictions_need_filtering && !_per_partition_limit && qp.proxy().features().replica_filtering) {
+        for (auto& [cdef, restr] : _restrictions->get_non_pk_restriction()) {
+            if (cdef->is_regular() && !cdef->is_multi_cell() && !cdef->is_counter()) {
+                add_column_filters(command->filters, *cdef, restr, command->slice, options);
+            }
+        }
+    }
     auto timeout_duration = get_timeout(state.get_client_state(), options);
     auto timeout = db::timeout_clock::now() + timeout_duration;
     auto p = service::pager::query_pagers::pager(qp.proxy(), _schema, _selection,
@@ -565,11 +615,12 @@ indexed_table_select_statement::do_execute_base_query(
     struct base_query_state {
         query::result_merger merger;
         query_ranges_to_vnodes_generator ranges_to_vnodes;
-        size_t concurrency = 1;
+        size_t concurrency;
         size_t previous_result_size = 0;
-        base_query_state(uint64_t row_limit, query_ranges_to_vnodes_generator&& ranges_to_vnodes_)
+        base_query_state(uint64_t row_limit, query_ranges_to_vnodes_generator&& ranges_to_vnodes_, size_t concurrency_)
                 : merger(row_limit, query::max_partitions)
                 , ranges_to_vnodes(std::move(ranges_to_vnodes_))
+                , concurrency(concurrency_)
                 {}
         base_query_state(base_query_state&&) = default;
         base_query_state(const base_query_state&) = delete;
@@ -581,7 +632,8 @@ indexed_table_select_statement::do_execute_base_query(
     }
 
     const bool is_paged = bool(paging_state);
-    base_query_state query_state{cmd->get_row_limit() * queried_ranges_count, std::move(ranges_to_vnodes)};
+    const size_t initial_concurrency = std::clamp<size_t>(qp.db().get_config().secondary_index_base_query_concurrency(), 1, max_base_table_query_concurrency);
+    base_query_state query_state{cmd->get_row_limit() * queried_ranges_count, std::move(ranges_to_vnodes), initial_concurrency};
     {
         auto& merger = query_state.merger;
         auto& ranges_to_vnodes = query_state.ranges_to_vnodes;
@@ -589,13 +641,14 @@ indexed_table_select_statement::do_execute_base_query(
         auto& previous_result_size = query_state.previous_result_size;
         query::short_read is_short_read = query::short_read::no;
         bool page_limit_reached = false;
+        bool first_iteration = true;
         while (!is_short_read && !ranges_to_vnodes.empty() && !page_limit_reached) {
-            // Starting with 1 range, we check if the result was a short read, and if not,
-            // we continue exponentially, asking for 2x more ranges than before
+            // Starting with the configured number of ranges, we check if the result was a short read,
+            // and if not, we continue exponentially, asking for 2x more ranges than before
             dht::partition_range_vector prange = ranges_to_vnodes(concurrency);
             auto command = ::make_lw_shared<query::read_command>(*cmd);
             auto old_paging_state = options.get_paging_state();
-            if (old_paging_state && concurrency == 1) {
+            if (old_paging_state && std::exchange(first_iteration, false)) {
                 auto base_pk = generate_base_key_from_index_pk<partition_key>(old_paging_state->get_partition_key(),
                         old_paging_state->get_clustering_key(), *_schema, *_view_schema);
                 auto row_ranges = command->slice.default_row_ranges();
@@ -670,36 +723,65 @@ indexed_table_select_statement::do_execute_base_query(
 
     query::result_merger merger(cmd->get_row_limit(), query::max_partitions);
     std::vector<primary_key> keys = std::move(primary_keys);
-    std::vector<primary_key>::iterator key_it(keys.begin());
+    // Rows of the same partition, which the index returns one after the
+    // other, are read by a single base query. Rows are only grouped while
+    // they are in the order of the slice, so that results are returned in
+    // the order of the index.
+    std::vector<std::span<const primary_key>> partitions;
+    {
+        const auto reversed = cmd->slice.is_reversed();
+        const auto ck_cmp = clustering_key_prefix::prefix_equal_tri_compare(*_schema);
+        auto begin = keys.cbegin();
+        for (auto it = keys.cbegin(); it != keys.cend(); ++it) {
+            if (it == begin) {
+                continue;
+            }
+            const auto& prev = *std::prev(it);
+            const bool grouped = prev.partition.equal(*_schema, it->partition)
+                    && (reversed ? ck_cmp(it->clustering, prev.clustering) < 0 : ck_cmp(prev.clustering, it->clustering) < 0);
+            if (!grouped) {
+                partitions.emplace_back(begin, it);
+                begin = it;
+            }
+        }
+        if (begin != keys.cend()) {
+            partitions.emplace_back(begin, keys.cend());
+        }
+    }
+    auto partition_it = partitions.begin();
     size_t previous_result_size = 0;
-    size_t next_iteration_size = 0;
+    // Grows by the number of partitions already read, i.e. doubles, while
+    // results are small.
+    size_t next_iteration_size = std::max<size_t>(qp.db().get_config().secondary_index_base_query_concurrency(), 1);
 
     const bool is_paged = bool(paging_state);
-    while (key_it != keys.end()) {
-        // Starting with 1 key, we check if the result was a short read, and if not,
-        // we continue exponentially, asking for 2x more key than before
-        auto already_done = std::distance(keys.begin(), key_it);
+    while (partition_it != partitions.end()) {
+        // Starting with the configured number of partitions, we check if the
+        // result was a short read, and if not, we continue exponentially,
+        // asking for 2x more partitions than before
+        auto already_done = std::distance(partitions.begin(), partition_it);
         // If the previous result already provided 1MB worth of data,
         // stop increasing the number of fetched partitions
-        if (previous_result_size < query::result_memory_limiter::maximum_result_size) {
-            next_iteration_size = already_done + 1;
+        if (already_done && previous_result_size < query::result_memory_limiter::maximum_result_size) {
+            next_iteration_size = std::max<size_t>(next_iteration_size, already_done + 1);
         }
-        next_iteration_size = std::min<size_t>({next_iteration_size, keys.size() - already_done, max_base_table_query_concurrency});
-        auto key_it_end = key_it + next_iteration_size;
-        auto command = ::make_lw_shared<query::read_command>(*cmd);
+        next_iteration_size = std::min<size_t>({next_iteration_size, partitions.size() - already_done, max_base_table_query_concurrency});
+        auto partition_it_end = partition_it + next_iteration_size;
 
         query::result_merger oneshot_merger(cmd->get_row_limit(), query::max_partitions);
-        coordinator_result<foreign_ptr<lw_shared_ptr<query::result>>> rresult = co_await utils::result_map_reduce(key_it, key_it_end, coroutine::lambda([&] (auto& key)
+        coordinator_result<foreign_ptr<lw_shared_ptr<query::result>>> rresult = co_await utils::result_map_reduce(partition_it, partition_it_end, coroutine::lambda([&] (std::span<const primary_key> rows)
                 -> future<coordinator_result<foreign_ptr<lw_shared_ptr<query::result>>>> {
             auto command = ::make_lw_shared<query::read_command>(*cmd);
-            // for each partition, read just one clustering row (TODO: can
-            // get all needed rows of one partition at once.)
+            // for each partition, read just the clustering rows returned
+            // by the index.
             command->slice._row_ranges.clear();
-            if (key.clustering) {
-                command->slice._row_ranges.push_back(query::clustering_range::make_singular(key.clustering));
+            for (const auto& key : rows) {
+                if (key.clustering) {
+                    command->slice._row_ranges.push_back(query::clustering_range::make_singular(key.clustering));
+                }
             }
             coordinator_result<service::storage_proxy::coordinator_query_result> rqr
-                    = co_await qp.proxy().query_result(_schema, command, {dht::partition_range::make_singular(key.partition)}, options.get_consistency(), {timeout, state.get_permit(), state.get_client_state(), state.get_trace_state()});
+                    = co_await qp.proxy().query_result(_schema, command, {dht::partition_range::make_singular(rows.front().partition)}, options.get_consistency(), {timeout, state.get_permit(), state.get_client_state(), state.get_trace_state()});
             if (!rqr.has_value()) {
                 co_return std::move(rqr).as_failure();
             }
@@ -714,7 +796,7 @@ indexed_table_select_statement::do_execute_base_query(
         const bool page_limit_reached = is_paged && result->buf().size() >= query::result_memory_limiter::maximum_result_size;
         previous_result_size = result->buf().size();
         merger(std::move(result));
-        key_it = key_it_end;
+        partition_it = partition_it_end;
         if (is_short_read || page_limit_reached) {
             break;
         }
@@ -841,11 +923,15 @@ select_statement::process_results_complex(foreign_ptr<lw_shared_ptr<query::resul
         auto rs = builder.build();
 
         if (needs_post_query_ordering()) {
-            rs->sort(_ordering_comparator);
+            // Only the first rows up to the limit are returned, select them
+            // rather than sorting all the rows read from the partitions.
             if (_is_reversed) {
-                rs->reverse();
+                rs->sort_top([this] (const result_row_type& r1, const result_row_type& r2) {
+                    return _ordering_comparator(r2, r1);
+                }, cmd->get_row_limit());
+            } else {
+                rs->sort_top(_ordering_comparator, cmd->get_row_limit());
             }
-            rs->trim(cmd->get_row_limit());
         }
         update_stats_rows_read(rs->size());
         _stats.filtered_rows_matched_total += _restrictions_need_filtering ? rs->size() : 0;
@@ -1410,7 +1496,33 @@ indexed_table_select_statement::find_index_clustering_rows(query_processor& qp,
     }));
 }
 
+// The columns grouping the rows of a query grouped by the columns at
+// group_by_cell_indices: the primary key columns up to the last of them,
+// including the ones GROUP BY may skip because they are restricted to a
+// single value. Thus rows are grouped by partition key and clustering prefix.
+static std::vector<const column_definition*> get_grouping_columns(const schema& s, const selection::selection& sel,
+        const std::vector<size_t>& group_by_cell_indices) {
+    size_t size = 0;
+    for (auto i : group_by_cell_indices) {
+        auto& cdef = *sel.get_columns()[i];
+        size = std::max<size_t>(size, cdef.is_partition_key() ? cdef.id + 1 : s.partition_key_size() + cdef.id + 1);
+    }
+    std::vector<const column_definition*> ret;
+    ret.reserve(size);
+    for (auto& cdef : s.all_columns_in_select_order()) {
+        if (ret.size() == size) {
+            break;
+        }
+        ret.push_back(&cdef);
+    }
+    return ret;
+}
+
 class parallelized_select_statement : public select_statement {
+    // For GROUP BY queries, the columns grouping the rows and how the
+    // selectors are computed from the groups.
+    std::vector<const column_definition*> _group_by;
+    std::optional<query::forward_request::grouped_reductions_info> _grouped_reductions;
 public:
     static ::shared_ptr<cql3::statements::select_statement> prepare(
         schema_ptr schema,
@@ -1507,6 +1619,10 @@ parallelized_select_statement::parallelized_select_statement(
     stats,
     std::move(attrs)
 ) {
+    if (has_group_by()) {
+        _group_by = get_grouping_columns(*_schema, *_selection, *_group_by_cell_indices);
+        _grouped_reductions = _selection->get_grouped_reductions(_group_by);
+    }
 }
 
 future<::shared_ptr<cql_transport::messages::result_message>>
@@ -1558,7 +1674,7 @@ parallelized_select_statement::do_execute(
     command->slice.options.set<query::partition_slice::option::allow_short_read>();
     auto timeout_duration = get_timeout(state.get_client_state(), options);
     auto timeout = lowres_system_clock::now() + timeout_duration;
-    auto reductions = _selection->get_reductions();
+    auto reductions = _grouped_reductions ? _grouped_reductions->reductions : _selection->get_reductions();
 
     query::forward_request req = {
         .reduction_types = reductions.types,
@@ -1567,17 +1683,41 @@ parallelized_select_statement::do_execute(
         .cl = options.get_consistency(),
         .timeout = timeout,
         .aggregation_infos = reductions.infos,
+        .group_by_columns = boost::copy_range<std::vector<sstring>>(_group_by | boost::adaptors::transformed(std::mem_fn(&column_definition::name_as_text))),
     };
 
-    // dispatch execution of this statement to other nodes
-    return qp.forwarder().dispatch(req, state.get_trace_state()).then([this] (query::forward_result res) {
-        auto meta = make_shared<metadata>(*_selection->get_result_metadata());
-        auto rs = std::make_unique<result_set>(std::move(meta));
-        rs->add_row(res.query_results);
+    auto make_result = [this] (std::unique_ptr<result_set> rs) {
         update_stats_rows_read(rs->size());
         return shared_ptr<cql_transport::messages::result_message>(
             make_shared<cql_transport::messages::result_message::rows>(result(std::move(rs)))
         );
+    };
+
+    // dispatch execution of this statement to other nodes
+    return qp.forwarder().dispatch(req, state.get_trace_state()).then([this, now, make_result] (query::forward_result res) {
+        if (_grouped_reductions && res.grouped_results.empty()) {
+            // Give the same result as the query would if it wasn't forwarded.
+            return do_with(cql3::selection::result_set_builder(*_selection, now, *_group_by_cell_indices), [] (auto& builder) {
+                return builder.with_thread_if_needed([&builder] {
+                    return builder.build();
+                });
+            }).then(make_result);
+        }
+        auto meta = make_shared<metadata>(*_selection->get_result_metadata());
+        auto rs = std::make_unique<result_set>(std::move(meta));
+        if (!_grouped_reductions) {
+            rs->add_row(res.query_results);
+        }
+        for (auto& group : res.grouped_results) {
+            std::vector<bytes_opt> row;
+            row.reserve(_grouped_reductions->group_by_positions.size());
+            auto reduction = group.begin() + _group_by.size();
+            for (auto& pos : _grouped_reductions->group_by_positions) {
+                row.push_back(pos ? std::move(group[*pos]) : std::move(*reduction++));
+            }
+            rs->add_row(std::move(row));
+        }
+        return make_ready_future<shared_ptr<cql_transport::messages::result_message>>(make_result(std::move(rs)));
     });
 }
 
@@ -1696,11 +1836,14 @@ std::unique_ptr<prepared_statement> select_statement::prepare(data_dictionary::d
         return selection->is_aggregate()        // Aggregation only
             && ( // SUPPORTED PARALLELIZATION
                  // All potential intermediate coordinators must support forwarding
-                (db.features().parallelized_aggregation && selection->is_count())
-                || (db.features().uda_native_parallelized_aggregation && selection->is_reducible())
+                (db.features().parallelized_aggregation && selection->is_count() && group_by_cell_indices->empty())
+                || (db.features().uda_native_parallelized_aggregation && selection->is_reducible() && group_by_cell_indices->empty())
+                || (db.features().grouped_parallelized_aggregation && !group_by_cell_indices->empty()
+                    // Groups are merged in ring order, LIMITs and orderings apply to them
+                    && !_limit && !_per_partition_limit && _parameters->orderings().empty()
+                    && selection->get_grouped_reductions(get_grouping_columns(*schema, *selection, *group_by_cell_indices)))
             )
             && !restrictions->need_filtering()  // No filtering
-            && group_by_cell_indices->empty()   // No GROUP BY
             && db.get_config().enable_parallelized_aggregation();
     };
 
@@ -36,40 +36,39 @@ namespace json_helpers {
  * should be treated as case-sensitive, while regular strings should be
  * case-insensitive.
  */
-static std::unordered_map<sstring, rjson::value> handle_case_sensitivity(rjson::value&& value_map) {
-    std::unordered_map<sstring, rjson::value> case_sensitive_map;
-    for (auto it = value_map.MemberBegin(); it != value_map.MemberEnd(); ++it) {
-        sstring name(rjson::to_string_view(it->name));
-        if (name.size() > 1 && *name.begin() == '"' && name.back() == '"') {
-            case_sensitive_map.emplace(name.substr(1, name.size() - 2), std::move(it->value));
-        } else {
-            std::transform(name.begin(), name.end(), name.begin(), ::tolower);
-            case_sensitive_map.emplace(std::move(name), std::move(it->value));
-        }
+static sstring case_sensitive_name(std::string_view name) {
+    if (name.size() > 1 && name.front() == '"' && name.back() == '"') {
+        return sstring(name.substr(1, name.size() - 2));
     }
-    return case_sensitive_map;
+    sstring lower(name);
+    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+    return lower;
 }
 
+// Converts the members of the parsed JSON object straight to the serialized
+// values of the columns they name, looked up in the schema, without going
+// through an intermediate map of JSON values.
 std::unordered_map<sstring, bytes_opt>
-parse(const sstring& json_string, const std::vector<column_definition>& expected_receivers) {
+parse(std::string_view json_string, const schema& s) {
     std::unordered_map<sstring, bytes_opt> json_map;
-    auto prepared_map = handle_case_sensitivity(rjson::parse(json_string));
-    for (const auto& def : expected_receivers) {
-        sstring cql_name = def.name_as_text();
-        auto value_it = prepared_map.find(cql_name);
-        if (value_it == prepared_map.end()) {
+    auto value_map = rjson::parse(json_string);
+    json_map.reserve(value_map.MemberCount());
+    for (auto it = value_map.MemberBegin(); it != value_map.MemberEnd(); ++it) {
+        auto cql_name = case_sensitive_name(rjson::to_string_view(it->name));
+        if (json_map.contains(cql_name)) {
+            // The first occurrence of a duplicated name wins.
             continue;
-        } else if (value_it->second.IsNull()) {
+        }
+        auto def = s.get_column_definition(to_bytes(cql_name));
+        if (!def) {
+            throw exceptions::invalid_request_exception(format("JSON values map contains unrecognized column: {}", cql_name));
+        }
+        if (it->value.IsNull()) {
             json_map.emplace(std::move(cql_name), bytes_opt{});
-            prepared_map.erase(value_it);
         } else {
-            json_map.emplace(std::move(cql_name), from_json_object(*def.type, std::move(value_it->second)));
-            prepared_map.erase(value_it);
+            json_map.emplace(std::move(cql_name), from_json_object(*def->type, it->value));
         }
     }
-    if (!prepared_map.empty()) {
-        throw exceptions::invalid_request_exception(format("JSON values map contains unrecognized column: {}", prepared_map.begin()->first));
-    }
     return json_map;
 }
 
@@ -157,8 +156,9 @@ void update_statement::add_update_for_key(mutation& m, const query::clustering_r
 
 modification_statement::json_cache_opt insert_prepared_json_statement::maybe_prepare_json_cache(const query_options& options) const {
     cql3::raw_value c = expr::evaluate(_value, options);
-    sstring json_string = utf8_type->to_string(to_bytes(c.view()));
-    return json_helpers::parse(std::move(json_string), s->all_columns());
+    return c.view().with_linearized([&] (bytes_view json_string) {
+        return json_helpers::parse(std::string_view(reinterpret_cast<const char*>(json_string.data()), json_string.size()), *s);
+    });
 }
 
 void
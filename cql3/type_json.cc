@@ -27,55 +27,6 @@ static inline bool is_control_char(char c) {
     return c >= 0 && c <= 0x1F;
 }
 
-static inline bool needs_escaping(const sstring& s) {
-    return std::any_of(s.begin(), s.end(), [](char c) {return is_control_char(c) || c == '"' || c == '\\';});
-}
-
-
-static sstring quote_json_string(const sstring& value) {
-    if (!needs_escaping(value)) {
-        return format("\"{}\"", value);
-    }
-    std::ostringstream oss;
-    oss << std::hex << std::uppercase << std::setfill('0');
-    oss.put('"');
-    for (char c : value) {
-        switch (c) {
-        case '"':
-            oss.put('\\').put('"');
-            break;
-        case '\\':
-            oss.put('\\').put('\\');
-            break;
-        case '\b':
-            oss.put('\\').put('b');
-            break;
-        case '\f':
-            oss.put('\\').put('f');
-            break;
-        case '\n':
-            oss.put('\\').put('n');
-            break;
-        case '\r':
-            oss.put('\\').put('r');
-            break;
-        case '\t':
-            oss.put('\\').put('t');
-            break;
-        default:
-            if (is_control_char(c)) {
-                oss.put('\\').put('u') << std::setw(4) << static_cast<int>(c);
-            } else {
-                oss.put(c);
-            }
-            break;
-        }
-    }
-    oss.put('"');
-    return oss.str();
-}
-
-
 template <typename T> static T to_int(const rjson::value& value) {
     int64_t result;
 
@@ -342,195 +293,249 @@ template <typename T> static T compose_value(const integer_type_impl<T>& t, byte
     return read_be<T>(reinterpret_cast<const char*>(bv.data()));
 }
 
-static sstring to_json_string_aux(const map_type_impl& t, bytes_view bv) {
-    std::ostringstream out;
+// The JSON representation of values is written straight to the output buffer,
+// element by element, rather than building a string for every value and for
+// every element of a collection.
+
+static void write_raw(bytes_ostream& out, std::string_view s) {
+    out.write(s.data(), s.size());
+}
+
+template <typename... Args>
+static void write_formatted(bytes_ostream& out, fmt::format_string<Args...> fmt, Args&&... args) {
+    fmt::memory_buffer buf;
+    fmt::format_to(std::back_inserter(buf), fmt, std::forward<Args>(args)...);
+    out.write(buf.data(), buf.size());
+}
+
+// Escapes control characters, quotes and backslashes, as rjson::quote_json_string() does.
+static void write_quoted_json_string(bytes_ostream& out, std::string_view value) {
+    write_raw(out, "\"");
+    auto unescaped_begin = value.begin();
+    for (auto it = value.begin(); it != value.end(); ++it) {
+        char c = *it;
+        if (!is_control_char(c) && c != '"' && c != '\\') {
+            continue;
+        }
+        write_raw(out, std::string_view(unescaped_begin, it));
+        unescaped_begin = it + 1;
+        switch (c) {
+        case '"': write_raw(out, "\\\""); break;
+        case '\\': write_raw(out, "\\\\"); break;
+        case '\b': write_raw(out, "\\b"); break;
+        case '\f': write_raw(out, "\\f"); break;
+        case '\n': write_raw(out, "\\n"); break;
+        case '\r': write_raw(out, "\\r"); break;
+        case '\t': write_raw(out, "\\t"); break;
+        default: write_formatted(out, "\\u{:04X}", static_cast<int>(c)); break;
+        }
+    }
+    write_raw(out, std::string_view(unescaped_begin, value.end()));
+    write_raw(out, "\"");
+}
 
-    out << '{';
+static void write_json_aux(bytes_ostream& out, const map_type_impl& t, bytes_view bv) {
+    // Valid keys in JSON map must be quoted strings. String keys already are,
+    // the representation of other types has to be quoted.
+    const bool string_keys = t.get_keys_type()->is_string();
+    write_raw(out, "{");
     auto size = read_collection_size(bv);
     for (int i = 0; i < size; ++i) {
         auto kb = read_collection_key(bv);
         auto vb = read_collection_value_nonnull(bv);
 
         if (i > 0) {
-            out << ", ";
+            write_raw(out, ", ");
         }
 
-        // Valid keys in JSON map must be quoted strings
-        sstring string_key = to_json_string(*t.get_keys_type(), kb);
-        bool is_unquoted = string_key.empty() || string_key[0] != '"';
-        if (is_unquoted) {
-            out << '"';
-        }
-        out << string_key;
-        if (is_unquoted) {
-            out << '"';
+        if (string_keys) {
+            write_json(out, *t.get_keys_type(), kb);
+        } else {
+            bytes_ostream key;
+            write_json(key, *t.get_keys_type(), kb);
+            auto key_view = key.linearize();
+            bool is_unquoted = key_view.empty() || key_view[0] != '"';
+            if (is_unquoted) {
+                write_raw(out, "\"");
+            }
+            out.write(key_view);
+            if (is_unquoted) {
+                write_raw(out, "\"");
+            }
         }
-        out << ": ";
-        out << to_json_string(*t.get_values_type(), vb);
+        write_raw(out, ": ");
+        write_json(out, *t.get_values_type(), vb);
     }
-    out << '}';
-    return out.str();
+    write_raw(out, "}");
 }
 
-static sstring to_json_string_aux(const set_type_impl& t, bytes_view bv) {
+static void write_json_aux(bytes_ostream& out, const listlike_collection_type_impl& t, bytes_view bv) {
     using llpdi = listlike_partial_deserializing_iterator;
-    std::ostringstream out;
     bool first = true;
-    out << '[';
+    write_raw(out, "[");
     managed_bytes_view mbv(bv);
     std::for_each(llpdi::begin(mbv), llpdi::end(mbv), [&first, &out, &t] (const managed_bytes_view_opt& e) {
         if (first) {
             first = false;
         } else {
-            out << ", ";
+            write_raw(out, ", ");
         }
         if (e) {
-            out << to_json_string(*t.get_elements_type(), *e);
+            write_json(out, *t.get_elements_type(), *e);
         } else {
             // Impossible in sets, but let's not insist here.
-            out << "null";
+            write_raw(out, "null");
         }
     });
-    out << ']';
-    return out.str();
+    write_raw(out, "]");
 }
 
-static sstring to_json_string_aux(const list_type_impl& t, bytes_view bv) {
-    using llpdi = listlike_partial_deserializing_iterator;
-    std::ostringstream out;
-    bool first = true;
-    out << '[';
-    managed_bytes_view mbv(bv);
-    std::for_each(llpdi::begin(mbv), llpdi::end(mbv), [&first, &out, &t] (const managed_bytes_view_opt& e) {
-        if (first) {
-            first = false;
-        } else {
-            out << ", ";
-        }
-        if (e) {
-            out << to_json_string(*t.get_elements_type(), *e);
-        } else {
-            out << "null";
-        }
-    });
-    out << ']';
-    return out.str();
-}
-
-static sstring to_json_string_aux(const tuple_type_impl& t, bytes_view bv) {
-    std::ostringstream out;
-    out << '[';
+static void write_json_aux(bytes_ostream& out, const tuple_type_impl& t, bytes_view bv) {
+    write_raw(out, "[");
 
     auto ti = t.all_types().begin();
     auto vi = tuple_deserializing_iterator::start(bv);
     while (ti != t.all_types().end() && vi != tuple_deserializing_iterator::finish(bv)) {
         if (ti != t.all_types().begin()) {
-            out << ", ";
+            write_raw(out, ", ");
         }
         if (*vi) {
-            // TODO(sarna): We can avoid copying if to_json_string accepted bytes_view
-            out << to_json_string(**ti, **vi);
+            write_json(out, **ti, **vi);
         } else {
-            out << "null";
+            write_raw(out, "null");
         }
         ++ti;
         ++vi;
     }
 
-    out << ']';
-    return out.str();
+    write_raw(out, "]");
 }
 
-static sstring to_json_string_aux(const user_type_impl& t, bytes_view bv) {
-    std::ostringstream out;
-    out << '{';
+static void write_json_aux(bytes_ostream& out, const user_type_impl& t, bytes_view bv) {
+    write_raw(out, "{");
 
     auto ti = t.all_types().begin();
     auto vi = tuple_deserializing_iterator::start(bv);
     int i = 0;
     while (ti != t.all_types().end() && vi != tuple_deserializing_iterator::finish(bv)) {
         if (ti != t.all_types().begin()) {
-            out << ", ";
+            write_raw(out, ", ");
         }
-        out << quote_json_string(t.field_name_as_string(i)) << ": ";
+        write_quoted_json_string(out, t.field_name_as_string(i));
+        write_raw(out, ": ");
         if (*vi) {
-            //TODO(sarna): We can avoid copying if to_json_string accepted bytes_view
-            out << to_json_string(**ti, **vi);
+            write_json(out, **ti, **vi);
         } else {
-            out << "null";
+            write_raw(out, "null");
         }
         ++ti;
         ++i;
         ++vi;
     }
 
-    out << '}';
-    return out.str();
+    write_raw(out, "}");
 }
 
 namespace {
-struct to_json_string_visitor {
+struct write_json_visitor {
+    bytes_ostream& out;
     bytes_view bv;
-    sstring operator()(const reversed_type_impl& t) { return to_json_string(*t.underlying_type(), bv); }
-    template <typename T> sstring operator()(const integer_type_impl<T>& t) { return to_sstring(compose_value(t, bv)); }
-    template <typename T> sstring operator()(const floating_type_impl<T>& t) {
+    void operator()(const reversed_type_impl& t) { write_json(out, *t.underlying_type(), bv); }
+    template <typename T> void operator()(const integer_type_impl<T>& t) { write_formatted(out, "{}", compose_value(t, bv)); }
+    template <typename T> void operator()(const floating_type_impl<T>& t) {
         if (bv.empty()) {
             throw exceptions::invalid_request_exception("Cannot create JSON string - deserialization error");
         }
         auto v = t.deserialize(bv);
         T d = value_cast<T>(v);
         if (std::isnan(d) || std::isinf(d)) {
-            return "null";
-        }
-        return to_sstring(d);
-    }
-    sstring operator()(const uuid_type_impl& t) { return quote_json_string(t.to_string(bv)); }
-    sstring operator()(const inet_addr_type_impl& t) { return quote_json_string(t.to_string(bv)); }
-    sstring operator()(const string_type_impl& t) { return quote_json_string(t.to_string(bv)); }
-    sstring operator()(const bytes_type_impl& t) { return quote_json_string("0x" + t.to_string(bv)); }
-    sstring operator()(const boolean_type_impl& t) { return t.to_string(bv); }
-    sstring operator()(const timestamp_date_base_class& t) { return quote_json_string(t.to_string(bv)); }
-    sstring operator()(const timeuuid_type_impl& t) { return quote_json_string(t.to_string(bv)); }
-    sstring operator()(const map_type_impl& t) { return to_json_string_aux(t, bv); }
-    sstring operator()(const set_type_impl& t) { return to_json_string_aux(t, bv); }
-    sstring operator()(const list_type_impl& t) { return to_json_string_aux(t, bv); }
-    sstring operator()(const tuple_type_impl& t) { return to_json_string_aux(t, bv); }
-    sstring operator()(const user_type_impl& t) { return to_json_string_aux(t, bv); }
-    sstring operator()(const simple_date_type_impl& t) { return quote_json_string(t.to_string(bv)); }
-    sstring operator()(const time_type_impl& t) { return t.to_string(bv); }
-    sstring operator()(const empty_type_impl& t) { return "null"; }
-    sstring operator()(const duration_type_impl& t) {
+            write_raw(out, "null");
+            return;
+        }
+        write_raw(out, to_sstring(d));
+    }
+    void operator()(const uuid_type_impl& t) { write_quoted_json_string(out, t.to_string(bv)); }
+    void operator()(const inet_addr_type_impl& t) { write_quoted_json_string(out, t.to_string(bv)); }
+    void operator()(const string_type_impl& t) {
+        write_quoted_json_string(out, std::string_view(reinterpret_cast<const char*>(bv.data()), bv.size()));
+    }
+    void operator()(const bytes_type_impl& t) {
+        write_raw(out, "\"0x");
+        write_raw(out, t.to_string(bv));
+        write_raw(out, "\"");
+    }
+    void operator()(const boolean_type_impl& t) { write_raw(out, t.to_string(bv)); }
+    void operator()(const timestamp_date_base_class& t) { write_quoted_json_string(out, t.to_string(bv)); }
+    void operator()(const timeuuid_type_impl& t) { write_quoted_json_string(out, t.to_string(bv)); }
+    void operator()(const map_type_impl& t) { write_json_aux(out, t, bv); }
+    void operator()(const set_type_impl& t) { write_json_aux(out, t, bv); }
+    void operator()(const list_type_impl& t) { write_json_aux(out, t, bv); }
+    void operator()(const tuple_type_impl& t) { write_json_aux(out, t, bv); }
+    void operator()(const user_type_impl& t) { write_json_aux(out, t, bv); }
+    void operator()(const simple_date_type_impl& t) { write_quoted_json_string(out, t.to_string(bv)); }
+    void operator()(const time_type_impl& t) { write_raw(out, t.to_string(bv)); }
+    void operator()(const empty_type_impl& t) { write_raw(out, "null"); }
+    void operator()(const duration_type_impl& t) {
         auto v = t.deserialize(bv);
         if (v.is_null()) {
             throw exceptions::invalid_request_exception("Cannot create JSON string - deserialization error");
         }
-        return quote_json_string(t.to_string(bv));
+        write_quoted_json_string(out, t.to_string(bv));
     }
-    sstring operator()(const counter_type_impl& t) {
+    void operator()(const counter_type_impl& t) {
         // It will be called only from cql3 layer while processing query results.
-        return to_json_string(*counter_cell_view::total_value_type(), bv);
+        write_json(out, *counter_cell_view::total_value_type(), bv);
     }
-    sstring operator()(const decimal_type_impl& t) {
+    void operator()(const decimal_type_impl& t) {
         if (bv.empty()) {
             throw exceptions::invalid_request_exception("Cannot create JSON string - deserialization error");
         }
         auto v = t.deserialize(bv);
-        return value_cast<big_decimal>(v).to_string();
+        write_raw(out, value_cast<big_decimal>(v).to_string());
     }
-    sstring operator()(const varint_type_impl& t) {
+    void operator()(const varint_type_impl& t) {
         if (bv.empty()) {
             throw exceptions::invalid_request_exception("Cannot create JSON string - deserialization error");
         }
         auto v = t.deserialize(bv);
-        return value_cast<utils::multiprecision_int>(v).str();
+        write_raw(out, value_cast<utils::multiprecision_int>(v).str());
     }
 };
 }
 
+void write_json(bytes_ostream& out, const abstract_type& t, bytes_view bv) {
+    visit(t, write_json_visitor{out, bv});
+}
+
+void write_json(bytes_ostream& out, const abstract_type& t, managed_bytes_view mbv) {
+    if (mbv.is_linearized()) {
+        write_json(out, t, mbv.current_fragment());
+    } else {
+        write_json(out, t, linearized(mbv));
+    }
+}
+
+void write_json(bytes_ostream& out, const abstract_type& t, const bytes_opt& b) {
+    if (b) {
+        write_json(out, t, bytes_view(*b));
+    } else {
+        write_raw(out, "null");
+    }
+}
+
+static sstring json_to_sstring(bytes_ostream& out) {
+    auto bv = out.linearize();
+    return sstring(reinterpret_cast<const char*>(bv.data()), bv.size());
+}
+
 sstring to_json_string(const abstract_type& t, bytes_view bv) {
-    return visit(t, to_json_string_visitor{bv});
+    bytes_ostream out;
+    write_json(out, t, bv);
+    return json_to_sstring(out);
 }
 
 sstring to_json_string(const abstract_type& t, const managed_bytes_view& mbv) {
-    return visit(t, to_json_string_visitor{linearized(mbv)});
+    bytes_ostream out;
+    write_json(out, t, mbv);
+    return json_to_sstring(out);
 }
@@ -10,8 +10,17 @@
 
 #include "types/types.hh"
 #include "utils/rjson.hh"
+#include "bytes_ostream.hh"
 
 bytes from_json_object(const abstract_type &t, const rjson::value& value);
+
+// Appends the JSON representation of a serialized value to `out`, writing the
+// elements of collections directly instead of going through intermediate strings.
+void write_json(bytes_ostream& out, const abstract_type& t, bytes_view bv);
+void write_json(bytes_ostream& out, const abstract_type& t, managed_bytes_view bv);
+// Writes "null" for a null value.
+void write_json(bytes_ostream& out, const abstract_type& t, const bytes_opt& b);
+
 sstring to_json_string(const abstract_type &t, bytes_view bv);
 sstring to_json_string(const abstract_type &t, const managed_bytes_view& bv);
 
@@ -10,14 +10,17 @@
 
 #include "utils/lru.hh"
 #include "utils/logalloc.hh"
+#include "utils/frequency_sketch.hh"
 #include "mutation/partition_version.hh"
 #include "mutation/mutation_cleaner.hh"
 
 #include <seastar/core/metrics_registration.hh>
 
 #include <stdint.h>
+#include <vector>
 
 class cache_entry;
+class row_cache;
 
 namespace cache {
 
@@ -68,6 +71,11 @@ class cache_tracker final {
         uint64_t pinned_dirty_memory_overload;
         uint64_t range_tombstone_reads;
         uint64_t row_tombstone_reads;
+        uint64_t rows_packed;
+        uint64_t admissions;
+        uint64_t admission_rejections;
+        uint64_t quota_row_evictions;
+        uint64_t absent_partition_hits;
 
         uint64_t active_reads() const {
             return reads - reads_done;
@@ -81,8 +89,24 @@ class cache_tracker final {
     mutation_cleaner _garbage;
     mutation_cleaner _memtable_cleaner;
     mutation_application_stats& _app_stats;
+    bool _pack_rows = false;
+    // See admit().
+    bool _admission_filter = false;
+    utils::frequency_sketch _admission_sketch;
+    uint64_t _row_evictions_at_sample_start = 0;
+    bool _evicted_in_last_sample = false;
+    size_t _absent_partitions_per_cache = 0;
+    // Caches using this tracker, indexed by row_cache::_id, so that evicted
+    // partitions can be accounted to their cache. Free slots are nullptr.
+    std::vector<row_cache*> _caches;
+    // Caches with a memory quota, see evict_over_quota().
+    // Has capacity for all of _caches, so that set_memory_quota() doesn't allocate.
+    std::vector<row_cache*> _capped_caches;
+    size_t _next_capped_cache = 0;
 private:
     void setup_metrics();
+    // Evicts a row of a cache which is over its memory quota, if there is one.
+    seastar::memory::reclaiming_result evict_over_quota() noexcept;
 public:
     using register_metrics = bool_class<class register_metrics_tag>;
     cache_tracker(mutation_application_stats&, register_metrics);
@@ -103,7 +127,7 @@ class cache_tracker final {
     void on_partition_merge() noexcept;
     void on_partition_hit() noexcept;
     void on_partition_miss() noexcept;
-    void on_partition_eviction() noexcept;
+    void on_partition_eviction(const cache_entry&) noexcept;
     void on_row_eviction() noexcept;
     void on_row_hit() noexcept;
     void on_dummy_row_hit() noexcept;
@@ -115,6 +139,7 @@ class cache_tracker final {
     void on_row_merged_from_memtable() noexcept { ++_stats.rows_merged_from_memtable; }
     void on_range_tombstone_read() noexcept { ++_stats.range_tombstone_reads; }
     void on_row_tombstone_read() noexcept { ++_stats.row_tombstone_reads; }
+    void on_row_packed() noexcept { ++_stats.rows_packed; }
     void pinned_dirty_memory_overload(uint64_t bytes) noexcept;
     allocation_strategy& allocator() noexcept;
     logalloc::region& region() noexcept;
@@ -125,6 +150,34 @@ class cache_tracker final {
     const stats& get_stats() const noexcept { return _stats; }
     stats& get_stats() noexcept { return _stats; }
     void set_compaction_scheduling_group(seastar::scheduling_group);
+    // Whether rows populated by reads are packed, see rows_entry::pack().
+    void set_pack_rows(bool pack) noexcept { _pack_rows = pack; }
+    bool pack_rows() const noexcept { return _pack_rows; }
+    // When enabled, partitions missing in cache are populated only if admit() agrees.
+    void set_admission_filter(bool enabled) noexcept { _admission_filter = enabled; }
+    // Records an access to the partition with the given hash, for admit().
+    void record_access(uint64_t hash) noexcept;
+    // Records an access to a partition missing in cache, and decides whether it should be
+    // populated. While the cache is evicting, a partition is admitted only if it was accessed
+    // already in the recent past, so that one-off reads, like those of scans, don't evict
+    // the partitions which are read repeatedly. Always true when the filter is disabled.
+    bool admit(uint64_t hash) noexcept;
+    // How many keys of partitions known to be absent in the underlying source
+    // each cache created afterwards remembers, see absent_partition_cache.
+    void set_absent_partitions_per_cache(size_t n) noexcept { _absent_partitions_per_cache = n; }
+    size_t absent_partitions_per_cache() const noexcept { return _absent_partitions_per_cache; }
+    // Returns the slot of the cache in the tracker.
+    uint32_t register_cache(row_cache&);
+    void unregister_cache(row_cache&) noexcept;
+    // Sets the soft limit of the memory used by the cache, 0 for none.
+    //
+    // Memory used by a cache is estimated as its share of cached partitions
+    // times the memory used by all of them. When the tracker needs to evict
+    // while some cache is over its quota, it evicts from such caches,
+    // partition by partition in ring order, instead of from the LRU.
+    void set_memory_quota(row_cache&, uint64_t quota) noexcept;
+    // The estimate of the memory used by the cache, see set_memory_quota().
+    uint64_t estimated_memory_usage(const row_cache&) const noexcept;
     lru& get_lru() { return _lru; }
     seastar::memory::reclaiming_result evict_from_lru_shallow() noexcept;
 };
@@ -31,6 +31,8 @@
 #include <seastar/core/fstream.hh>
 #include <seastar/core/memory.hh>
 #include <seastar/core/chunked_fifo.hh>
+#include <seastar/core/condition-variable.hh>
+#include <seastar/core/shared_future.hh>
 #include <seastar/core/queue.hh>
 #include <seastar/core/sleep.hh>
 #include <seastar/core/coroutine.hh>
@@ -105,6 +107,11 @@ db::commitlog::config db::commitlog::config::from_db_config(const db::config& cf
     c.commitlog_segment_size_in_mb = cfg.commitlog_segment_size_in_mb();
     c.commitlog_sync_period_in_ms = cfg.commitlog_sync_period_in_ms();
     c.mode = cfg.commitlog_sync() == "batch" ? sync_mode::BATCH : sync_mode::PERIODIC;
+    c.group_commit_window_in_us = cfg.commitlog_sync_group_window_in_us();
+    c.group_commit_threshold_in_bytes = uint64_t(cfg.commitlog_sync_group_threshold_in_kb()) * 1024;
+    c.min_reserve_segments = cfg.commitlog_reserve_segments();
+    c.compression = commitlog_entry_compression_from_string(cfg.commitlog_compression());
+    c.compression_threshold_in_bytes = uint64_t(cfg.commitlog_compression_threshold_in_kb()) * 1024;
     c.extensions = &cfg.extensions();
     c.use_o_dsync = cfg.commitlog_use_o_dsync();
     c.allow_going_over_size_limit = !cfg.commitlog_use_hard_size_limit();
@@ -377,6 +384,13 @@ class db::commitlog::segment_manager : public ::enable_shared_from_this<segment_
         uint64_t requests_blocked_memory = 0;
         uint64_t blocked_on_new_segment = 0;
         uint64_t active_allocations = 0;
+        uint64_t group_commits = 0;
+        uint64_t group_commit_followers = 0;
+        uint64_t segment_allocation_stalls = 0;
+        uint64_t segment_allocation_stall_time_us = 0;
+        uint64_t compressed_entries = 0;
+        uint64_t bytes_before_compression = 0;
+        uint64_t bytes_after_compression = 0;
     };
 
     class scope_increment_counter {
@@ -396,6 +410,24 @@ class db::commitlog::segment_manager : public ::enable_shared_from_this<segment_
     byte_flow<uint64_t> last_bytes;
     byte_flow<double> bytes_rate;
 
+    // Moving average of the time file flushes take, see group_commit_window().
+    std::chrono::microseconds flush_latency{0};
+
+    void on_flush_done(std::chrono::steady_clock::duration d) noexcept {
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(d);
+        flush_latency = flush_latency.count() ? (flush_latency * 7 + us) / 8 : us;
+    }
+
+    // How long the first write waiting for a sync waits for others to join it.
+    // Waiting for longer than a flush takes wouldn't let more writes share the
+    // sync than would queue up for the next one meanwhile.
+    std::chrono::microseconds group_commit_window() const noexcept {
+        if (cfg.mode != sync_mode::BATCH) {
+            return std::chrono::microseconds::zero();
+        }
+        return std::min(std::chrono::microseconds(cfg.group_commit_window_in_us), flush_latency);
+    }
+
     typename std::chrono::high_resolution_clock::time_point last_time;
 
     size_t pending_allocations() const {
@@ -690,6 +722,9 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
     std::unordered_map<cf_id_type, uint64_t> _cf_dirty;
     time_point _sync_time;
     utils::flush_queue<replay_position, std::less<replay_position>, clock_type> _pending_ops;
+    // Sync shared by the writes waiting for the current buffer to be synced, see group_sync().
+    lw_shared_ptr<shared_promise<>> _group_commit;
+    condition_variable _group_commit_cv;
 
     uint64_t _num_allocs = 0;
 
@@ -775,6 +810,14 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
     void add_schema_version(schema_ptr s) {
         _known_schema_versions.emplace(s->version());
     }
+    void account_compression(const commitlog_entry_writer& w) {
+        if (w.compressed()) {
+            auto& t = _segment_manager->totals;
+            ++t.compressed_entries;
+            t.bytes_before_compression += w.uncompressed_size();
+            t.bytes_after_compression += w.size();
+        }
+    }
     void forget_schema_versions() {
         _known_schema_versions.clear();
     }
@@ -906,7 +949,9 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
         }
 
         try {
+            auto start = std::chrono::steady_clock::now();
             co_await _file.flush();
+            _segment_manager->on_flush_done(std::chrono::steady_clock::now() - start);
             // TODO: retry/ignore/fail/stop - optional behaviour in origin.
             // we fast-fail the whole commit.
             _flush_pos = std::max(pos, _flush_pos);
@@ -1096,7 +1141,7 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
             } else {
                 // It is ok to leave the sync behind on timeout because there will be at most one
                 // such sync, all later allocations will block on _pending_ops until it is done.
-                co_await with_timeout(timeout, sync());
+                co_await group_sync(timeout);
             }
         } catch (...) {
             // If we get an IO exception (which we assume this is)
@@ -1109,6 +1154,54 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
         co_return me;
     }
 
+    /**
+     * Syncs the current buffer, writes included.
+     *
+     * With a group commit window, the first write to get here waits for up to
+     * the window for other writes to be added to the buffer, or until it holds
+     * group_commit_threshold_in_bytes. Writes which get here meanwhile
+     * wait for its sync instead of issuing their own.
+     */
+    future<> group_sync(timeout_clock::time_point timeout) {
+        auto window = _segment_manager->group_commit_window();
+        if (window == std::chrono::microseconds::zero()) {
+            co_await with_timeout(timeout, sync());
+            co_return;
+        }
+        auto over_threshold = [this] {
+            return buffer_position() >= _segment_manager->cfg.group_commit_threshold_in_bytes;
+        };
+        if (_group_commit) {
+            ++_segment_manager->totals.group_commit_followers;
+            if (over_threshold()) {
+                _group_commit_cv.signal();
+            }
+            co_await _group_commit->get_shared_future(timeout);
+            co_return;
+        }
+        auto group = make_lw_shared<shared_promise<>>();
+        _group_commit = group;
+        if (!over_threshold()) {
+            try {
+                co_await _group_commit_cv.wait(window);
+            } catch (const condition_variable_timed_out&) {
+                // Window passed.
+            }
+        }
+        _group_commit = nullptr;
+        ++_segment_manager->totals.group_commits;
+        // Followers are completed by the sync even if this write times out.
+        (void)sync().then_wrapped([group] (future<sseg_ptr> f) {
+            if (f.failed()) {
+                group->set_exception(f.get_exception());
+            } else {
+                f.ignore_ready_future();
+                group->set_value();
+            }
+        });
+        co_await group->get_shared_future(timeout);
+    }
+
     void background_cycle() {
         //FIXME: discarded future
         (void)cycle().discard_result().handle_exception([] (auto ex) {
@@ -1358,6 +1451,9 @@ db::commitlog::segment_manager::segment_manager(config c)
         }
         cfg.max_active_flushes = std::max(uint64_t(1), cfg.max_active_flushes / smp::count);
 
+        cfg.min_reserve_segments = std::max(uint64_t(1), cfg.min_reserve_segments);
+        cfg.max_reserve_segments = std::max(cfg.max_reserve_segments, cfg.min_reserve_segments);
+
         if (!cfg.base_segment_id) {
             cfg.base_segment_id = std::chrono::duration_cast<std::chrono::milliseconds>(runtime::get_boot_time().time_since_epoch()).count() + 1;
         }
@@ -1379,7 +1475,7 @@ db::commitlog::segment_manager::segment_manager(config c)
     // than default_size at the end of the allocation, that allows for every valid mutation to
     // always be admitted for processing.
     , _request_controller(max_request_controller_units(), request_controller_timeout_exception_factory{})
-    , _reserve_segments(1)
+    , _reserve_segments(cfg.min_reserve_segments)
     , _recycled_segments(std::numeric_limits<size_t>::max())
     , _reserve_replenisher(make_ready_future<>())
     , _background_sync(make_ready_future<>())
@@ -1530,6 +1626,22 @@ void db::commitlog::segment_manager::create_counters(const sstring& metrics_cate
         sm::make_counter("flush", totals.flush_count,
                        sm::description("Counts number of times the flush() method was called for a file.")),
 
+        sm::make_counter("group_commits", totals.group_commits,
+                       sm::description("Counts number of syncs in batch mode which waited for the group commit window.")),
+
+        sm::make_counter("group_commit_followers", totals.group_commit_followers,
+                       sm::description("Counts number of writes in batch mode which were synced by the group commit of another write.")),
+
+        sm::make_counter("compressed_entries", totals.compressed_entries,
+                       sm::description("Counts number of entries which were written compressed.")),
+
+        sm::make_counter("bytes_before_compression", totals.bytes_before_compression,
+                       sm::description("Counts number of bytes of the entries which were written compressed, before compression. "
+                                       "Divide bytes_after_compression by this value to get the achieved compression ratio.")),
+
+        sm::make_counter("bytes_after_compression", totals.bytes_after_compression,
+                       sm::description("Counts number of bytes of the entries which were written compressed, after compression.")),
+
         sm::make_counter("bytes_written", totals.bytes_written,
                        sm::description("Counts number of bytes written to the disk. "
                                        "Divide this value by \"alloc\" to get the average number of bytes per mutation written to the disk.")),
@@ -1578,6 +1690,16 @@ void db::commitlog::segment_manager::create_counters(const sstring& metrics_cate
         sm::make_gauge("blocked_on_new_segment", totals.blocked_on_new_segment,
                        sm::description("Number of allocations blocked on acquiring new segment.")),
 
+        sm::make_counter("segment_allocation_stalls", totals.segment_allocation_stalls,
+                       sm::description("Counts number of times switching to a new segment waited for one to be allocated, because the reserve was empty. "
+                                       "If this grows, consider increasing commitlog_reserve_segments.")),
+
+        sm::make_counter("segment_allocation_stall_time_us", totals.segment_allocation_stall_time_us,
+                       sm::description("Counts the time, in microseconds, switching to a new segment waited for one to be allocated.")),
+
+        sm::make_gauge("reserve_segments", [this] { return _reserve_segments.size(); },
+                       sm::description("Holds the number of pre-allocated segments ready to be switched to.")),
+
         sm::make_gauge("active_allocations", totals.active_allocations,
                        sm::description("Current number of active allocations.")),
     });
@@ -1836,7 +1958,15 @@ future<db::commitlog::segment_manager::sseg_ptr> db::commitlog::segment_manager:
         }
     }
 
-    auto s = co_await _reserve_segments.pop_eventually();
+    sseg_ptr s;
+    if (_reserve_segments.empty()) {
+        ++totals.segment_allocation_stalls;
+        auto start = std::chrono::steady_clock::now();
+        s = co_await _reserve_segments.pop_eventually();
+        totals.segment_allocation_stall_time_us += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    } else {
+        s = _reserve_segments.pop();
+    }
     _segments.push_back(s);
     _segments.back()->reset_sync_time();
     co_return s;
@@ -2359,9 +2489,11 @@ future<db::rp_handle> db::commitlog::add_entry(const cf_id_type& id, const commi
         commitlog_entry_writer _writer;
     public:
         rp_handle res;
-        cl_entry_writer(const commitlog_entry_writer& wr) 
-            : entry_writer(wr.sync()), _writer(wr) 
-        {}
+        cl_entry_writer(const commitlog_entry_writer& wr, const config& cfg)
+            : entry_writer(wr.sync()), _writer(wr)
+        {
+            _writer.set_compression(cfg.compression, cfg.compression_threshold_in_bytes);
+        }
         const cf_id_type& id(size_t) const override {
             return _writer.schema()->id();
         }
@@ -2379,6 +2511,7 @@ future<db::rp_handle> db::commitlog::add_entry(const cf_id_type& id, const commi
             if (_writer.with_schema()) {
                 seg.add_schema_version(_writer.schema());
             }
+            seg.account_compression(_writer);
             _writer.write(out);
         }
         void result(size_t, rp_handle h) override {
@@ -2391,7 +2524,7 @@ future<db::rp_handle> db::commitlog::add_entry(const cf_id_type& id, const commi
             return std::move(res);
         }
     };
-    return _segment_manager->allocate_when_possible(cl_entry_writer(cew), timeout);
+    return _segment_manager->allocate_when_possible(cl_entry_writer(cew, _segment_manager->cfg), timeout);
 }
 
 future<std::vector<db::rp_handle>> 
@@ -2402,10 +2535,13 @@ db::commitlog::add_entries(std::vector<commitlog_entry_writer> entry_writers, db
     public:
         std::vector<rp_handle> res;
 
-        cl_entries_writer(force_sync sync, std::vector<commitlog_entry_writer> entry_writers)
+        cl_entries_writer(force_sync sync, std::vector<commitlog_entry_writer> entry_writers, const config& cfg)
             : entry_writer(sync, entry_writers.size()), _writers(std::move(entry_writers))
         {
             res.reserve(_writers.size());
+            for (auto& w : _writers) {
+                w.set_compression(cfg.compression, cfg.compression_threshold_in_bytes);
+            }
         }
         const cf_id_type& id(size_t i) const override {
             return _writers.at(i).schema()->id();
@@ -2438,6 +2574,7 @@ db::commitlog::add_entries(std::vector<commitlog_entry_writer> entry_writers, db
             if (w.with_schema()) {
                 seg.add_schema_version(w.schema());
             }
+            seg.account_compression(w);
             w.write(out);
         }
         void result(size_t i, rp_handle h) override {
@@ -2453,7 +2590,7 @@ db::commitlog::add_entries(std::vector<commitlog_entry_writer> entry_writers, db
     };
 
     force_sync sync(std::any_of(entry_writers.begin(), entry_writers.end(), [](auto& w) { return bool(w.sync()); }));
-    return _segment_manager->allocate_when_possible(cl_entries_writer(sync, std::move(entry_writers)), timeout);
+    return _segment_manager->allocate_when_possible(cl_entries_writer(sync, std::move(entry_writers), _segment_manager->cfg), timeout);
 }
 
 db::commitlog::commitlog(config cfg)
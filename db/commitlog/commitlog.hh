@@ -95,6 +95,10 @@ class commitlog {
         std::optional<uint64_t> commitlog_flush_threshold_in_mb = {};
         uint64_t commitlog_segment_size_in_mb = 32;
         uint64_t commitlog_sync_period_in_ms = 10 * 1000; //TODO: verify default!
+        // Number of segments a background fiber keeps pre-allocated, so
+        // that switching segments doesn't wait for the filesystem. The
+        // reserve grows, up to max_reserve_segments, whenever it runs out.
+        uint64_t min_reserve_segments = 1;
         // Max number of segments to keep in pre-alloc reserve.
         // Not (yet) configurable from scylla.conf.
         uint64_t max_reserve_segments = 12;
@@ -103,6 +107,16 @@ class commitlog {
         uint64_t max_active_flushes = 0;
 
         sync_mode mode = sync_mode::PERIODIC;
+        // In BATCH mode, how long the first write waiting for a sync waits for
+        // other writes to share it, at most. The wait is also capped by
+        // the recent latency of flushes. Zero syncs right away.
+        uint64_t group_commit_window_in_us = 0;
+        // Writes stop waiting for the window to pass once the buffer holds this many bytes.
+        uint64_t group_commit_threshold_in_bytes = 128 * 1024;
+        // Entries of at least compression_threshold_in_bytes are written
+        // compressed with this algorithm, unless that doesn't make them smaller.
+        commitlog_entry_compression compression = commitlog_entry_compression::none;
+        uint64_t compression_threshold_in_bytes = 4 * 1024;
         std::string fname_prefix = descriptor::FILENAME_PREFIX;
 
         bool use_o_dsync = false;
@@ -8,11 +8,54 @@
 
 #include "counters.hh"
 #include "commitlog_entry.hh"
+#include "compress.hh"
 #include "idl/commitlog.dist.hh"
 #include "idl/commitlog.dist.impl.hh"
 
 #include <seastar/core/simple-stream.hh>
 
+// A compressed entry is:
+//
+//      magic       : uint32_t - compressed_entry_magic
+//      algorithm   : uint8_t  - commitlog_entry_compression
+//      size        : uint32_t - size of the serialized commitlog_entry
+//      chunk_size  : uint32_t
+//      chunks[]    : uint32_t compressed size, followed by the compressed data
+//
+// Each chunk holds chunk_size bytes of the serialized commitlog_entry,
+// except for the last one, which holds the rest of them.
+//
+// A serialized commitlog_entry starts with its own size, which includes
+// the size field itself, so it never starts with the magic.
+static constexpr uint32_t compressed_entry_magic = 0;
+static constexpr size_t compression_chunk_size = 64 * 1024;
+
+static const compressor& compressor_for(commitlog_entry_compression c) {
+    static thread_local const compressor_ptr zstd = compressor::create("ZstdCompressor", [] (const sstring&) {
+        return compressor::opt_string();
+    });
+    switch (c) {
+    case commitlog_entry_compression::lz4:
+        return *compressor::lz4;
+    case commitlog_entry_compression::zstd:
+        return *zstd;
+    case commitlog_entry_compression::none:
+        break;
+    }
+    throw std::runtime_error(format("Unknown commitlog entry compression {}", uint8_t(c)));
+}
+
+commitlog_entry_compression commitlog_entry_compression_from_string(std::string_view name) {
+    if (name == "none") {
+        return commitlog_entry_compression::none;
+    } else if (name == "lz4") {
+        return commitlog_entry_compression::lz4;
+    } else if (name == "zstd") {
+        return commitlog_entry_compression::zstd;
+    }
+    throw std::invalid_argument(format("Invalid commitlog compression: {}, expected none, lz4 or zstd", name));
+}
+
 template<typename Output>
 void commitlog_entry_writer::serialize(Output& out) const {
     [this, wr = ser::writer_of_commitlog_entry<Output>(out)] () mutable {
@@ -28,15 +71,107 @@ void commitlog_entry_writer::compute_size() {
     seastar::measuring_output_stream ms;
     serialize(ms);
     _size = ms.size();
+    _uncompressed_size = _size;
+    _compressed.clear();
+    if (_compression != commitlog_entry_compression::none && _size >= _min_compressed_size) {
+        compress();
+    }
+}
+
+void commitlog_entry_writer::compress() {
+    auto& c = compressor_for(_compression);
+    bytes_ostream raw;
+    serialize(raw);
+
+    bytes_ostream out;
+    ser::serialize(out, compressed_entry_magic);
+    ser::serialize(out, uint8_t(_compression));
+    ser::serialize(out, uint32_t(_uncompressed_size));
+    ser::serialize(out, uint32_t(compression_chunk_size));
+
+    auto chunk = std::make_unique<char[]>(compression_chunk_size);
+    auto compressed_chunk = std::make_unique<char[]>(c.compress_max_size(compression_chunk_size));
+    size_t chunk_len = 0;
+    auto flush_chunk = [&] {
+        auto len = c.compress(chunk.get(), chunk_len, compressed_chunk.get(), c.compress_max_size(compression_chunk_size));
+        ser::serialize(out, uint32_t(len));
+        out.write(compressed_chunk.get(), len);
+        chunk_len = 0;
+    };
+    for (bytes_view frag : raw.fragments()) {
+        while (!frag.empty()) {
+            auto n = std::min(frag.size(), compression_chunk_size - chunk_len);
+            std::copy_n(reinterpret_cast<const char*>(frag.data()), n, chunk.get() + chunk_len);
+            chunk_len += n;
+            frag.remove_prefix(n);
+            if (chunk_len == compression_chunk_size) {
+                flush_chunk();
+            }
+        }
+        // Give up as soon as the entry is known to not become smaller.
+        if (out.size() >= _uncompressed_size) {
+            return;
+        }
+    }
+    if (chunk_len) {
+        flush_chunk();
+    }
+    if (out.size() < _uncompressed_size) {
+        _compressed = std::move(out);
+        _size = _compressed.size();
+    }
 }
 
 void commitlog_entry_writer::write(typename seastar::memory_output_stream<std::vector<temporary_buffer<char>>::iterator>& out) const {
+    if (compressed()) {
+        for (bytes_view frag : _compressed.fragments()) {
+            out.write(reinterpret_cast<const char*>(frag.data()), frag.size());
+        }
+        return;
+    }
     serialize(out);
 }
 
+template<typename Input>
+static bytes_ostream uncompress_entry(Input& in) {
+    auto c = commitlog_entry_compression(ser::deserialize(in, boost::type<uint8_t>()));
+    auto& comp = compressor_for(c);
+    auto size = ser::deserialize(in, boost::type<uint32_t>());
+    auto chunk_size = ser::deserialize(in, boost::type<uint32_t>());
+    if (!chunk_size || chunk_size > bytes_ostream::max_chunk_size()) {
+        throw std::runtime_error(format("Invalid compressed commitlog entry: chunk size {}", chunk_size));
+    }
+
+    bytes_ostream out;
+    std::unique_ptr<char[]> compressed_chunk;
+    size_t compressed_chunk_capacity = 0;
+    while (out.size() < size) {
+        auto len = ser::deserialize(in, boost::type<uint32_t>());
+        if (len > compressed_chunk_capacity) {
+            compressed_chunk = std::make_unique<char[]>(len);
+            compressed_chunk_capacity = len;
+        }
+        in.read(compressed_chunk.get(), len);
+        auto expected = std::min<size_t>(chunk_size, size - out.size());
+        auto dst = reinterpret_cast<char*>(out.write_place_holder(expected));
+        if (comp.uncompress(compressed_chunk.get(), len, dst, expected) != expected) {
+            throw std::runtime_error("Invalid compressed commitlog entry: chunk size mismatch");
+        }
+    }
+    return out;
+}
+
 commitlog_entry_reader::commitlog_entry_reader(const fragmented_temporary_buffer& buffer)
     : _ce([&] {
     auto in = seastar::fragmented_memory_input_stream(fragmented_temporary_buffer::view(buffer).begin(), buffer.size_bytes());
+    if (buffer.size_bytes() >= sizeof(uint32_t)) {
+        auto peek = in;
+        if (ser::deserialize(peek, boost::type<uint32_t>()) == compressed_entry_magic) {
+            auto data = uncompress_entry(peek);
+            auto data_in = ser::as_input_stream(data);
+            return ser::deserialize(data_in, boost::type<commitlog_entry>());
+        }
+    }
     return ser::deserialize(in, boost::type<commitlog_entry>());
 }())
 {
@@ -10,10 +10,22 @@
 
 #include <optional>
 
+#include "bytes_ostream.hh"
 #include "commitlog_types.hh"
 #include "mutation/frozen_mutation.hh"
 #include "schema/schema_fwd.hh"
 
+// Algorithm compressing the commitlog entries which commitlog_entry_writer writes.
+// The value is stored in compressed entries, so don't renumber.
+enum class commitlog_entry_compression : uint8_t {
+    none = 0,
+    lz4 = 1,
+    zstd = 2,
+};
+
+// Parses "none", "lz4" or "zstd", throws std::invalid_argument otherwise.
+commitlog_entry_compression commitlog_entry_compression_from_string(std::string_view name);
+
 class commitlog_entry {
     std::optional<column_mapping> _mapping;
     frozen_mutation _mutation;
@@ -34,16 +46,32 @@ class commitlog_entry_writer {
     bool _with_schema = true;
     size_t _size = std::numeric_limits<size_t>::max();
     force_sync _sync;
+    commitlog_entry_compression _compression = commitlog_entry_compression::none;
+    size_t _min_compressed_size = 0;
+    // The compressed entry, if compression made it smaller.
+    bytes_ostream _compressed;
+    size_t _uncompressed_size = 0;
 private:
     template<typename Output>
     void serialize(Output&) const;
     void compute_size();
+    void compress();
 public:
     commitlog_entry_writer(schema_ptr s, const frozen_mutation& fm, force_sync sync)
         : _schema(std::move(s)), _mutation(fm), _sync(sync)
     {}
 
+    // Entries of at least min_size bytes are written compressed, unless
+    // that doesn't make them smaller. Must be called before set_with_schema().
+    void set_compression(commitlog_entry_compression c, size_t min_size) {
+        _compression = c;
+        _min_compressed_size = min_size;
+    }
+
     void set_with_schema(bool value) {
+        if (_size != std::numeric_limits<size_t>::max() && _with_schema == value) {
+            return;
+        }
         _with_schema = value;
         compute_size();
     }
@@ -59,6 +87,15 @@ class commitlog_entry_writer {
         return _size;
     }
 
+    // Whether the entry is written compressed, valid after set_with_schema().
+    bool compressed() const {
+        return !_compressed.empty();
+    }
+    // Size of the entry before compression, valid after set_with_schema().
+    size_t uncompressed_size() const {
+        return _uncompressed_size;
+    }
+
     size_t mutation_size() const {
         return _mutation.representation().size();
     }
@@ -68,6 +105,7 @@ class commitlog_entry_writer {
     void write(typename seastar::memory_output_stream<std::vector<temporary_buffer<char>>::iterator>& out) const;
 };
 
+// Reads entries written by commitlog_entry_writer, compressed or not.
 class commitlog_entry_reader {
     commitlog_entry _ce;
 public:
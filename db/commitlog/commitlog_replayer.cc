@@ -14,6 +14,9 @@
 #include <boost/range/adaptor/map.hpp>
 
 #include <seastar/core/future.hh>
+#include <seastar/core/gate.hh>
+#include <seastar/core/loop.hh>
+#include <seastar/core/semaphore.hh>
 #include <seastar/core/sharded.hh>
 
 #include "commitlog.hh"
@@ -81,8 +84,18 @@ class db::commitlog_replayer::impl {
         return _column_mappings.stop();
     }
 
-    future<> process(stats*, commitlog::buffer_and_replay_position buf_rp) const;
-    future<stats> recover(sstring file, const sstring& fname_prefix) const;
+    // Each shard replays this many of its segments concurrently. Mutations
+    // commute, and every segment carries the column mappings of its entries,
+    // so segments don't have to be replayed in order.
+    static constexpr size_t max_concurrent_segments = 4;
+    // Each shard keeps reading entries while this much memory of the entries
+    // it read is being applied.
+    static constexpr size_t max_memory_in_flight = 8 << 20;
+
+    // Applies the entry in the background, holding the pending gate and
+    // units of memory for its size until it's applied.
+    future<> process(stats*, commitlog::buffer_and_replay_position buf_rp, semaphore& memory, gate& pending) const;
+    future<stats> recover(sstring file, const sstring& fname_prefix, semaphore& memory) const;
 
     typedef std::unordered_map<table_id, replay_position> rp_map;
     typedef std::unordered_map<unsigned, rp_map> shard_rpm_map;
@@ -176,7 +189,7 @@ future<> db::commitlog_replayer::impl::init() {
 }
 
 future<db::commitlog_replayer::impl::stats>
-db::commitlog_replayer::impl::recover(sstring file, const sstring& fname_prefix) const {
+db::commitlog_replayer::impl::recover(sstring file, const sstring& fname_prefix, semaphore& memory) const {
     assert(_column_mappings.local_is_initialized());
 
     replay_position rp{commitlog::descriptor(file, fname_prefix)};
@@ -192,23 +205,26 @@ db::commitlog_replayer::impl::recover(sstring file, const sstring& fname_prefix)
     }
 
     auto s = make_lw_shared<stats>();
+    auto pending = make_lw_shared<gate>();
     auto& exts = _db.local().extensions();
 
     return db::commitlog::read_log_file(file, fname_prefix, service::get_local_commitlog_priority(),
-            std::bind(&impl::process, this, s.get(), std::placeholders::_1),
-            p, &exts).then_wrapped([s](future<> f) {
-        try {
-            f.get();
-        } catch (commitlog::segment_data_corruption_error& e) {
-            s->corrupt_bytes += e.bytes();
-        } catch (...) {
-            throw;
-        }
-        return make_ready_future<stats>(*s);
+            std::bind(&impl::process, this, s.get(), std::placeholders::_1, std::ref(memory), std::ref(*pending)),
+            p, &exts).then_wrapped([s, pending](future<> f) {
+        return pending->close().then([s, f = std::move(f)] () mutable {
+            try {
+                f.get();
+            } catch (commitlog::segment_data_corruption_error& e) {
+                s->corrupt_bytes += e.bytes();
+            } catch (...) {
+                throw;
+            }
+            return make_ready_future<stats>(*s);
+        });
     });
 }
 
-future<> db::commitlog_replayer::impl::process(stats* s, commitlog::buffer_and_replay_position buf_rp) const {
+future<> db::commitlog_replayer::impl::process(stats* s, commitlog::buffer_and_replay_position buf_rp, semaphore& memory, gate& pending) const {
     auto&& buf = buf_rp.buffer;
     auto&& rp = buf_rp.position;
     try {
@@ -245,7 +261,11 @@ future<> db::commitlog_replayer::impl::process(stats* s, commitlog::buffer_and_r
 
         const auto& schema = *_db.local().find_column_family(uuid).schema();
         auto shard = fm.shard_of(schema);
-        return _db.invoke_on(shard, [this, cer = std::move(cer), &src_cm, rp] (replica::database& db) mutable -> future<> {
+        auto size = std::min(buf.size_bytes(), max_memory_in_flight);
+        // Read the next entry while this one is applied.
+        return get_units(memory, size).then([this, s, cer = std::move(cer), &src_cm, rp, shard, &pending] (semaphore_units<> units) mutable {
+          (void)with_gate(pending, [this, s, cer = std::move(cer), &src_cm, rp, shard, units = std::move(units)] () mutable {
+           return _db.invoke_on(shard, [this, cer = std::move(cer), &src_cm, rp] (replica::database& db) mutable -> future<> {
             auto& fm = cer.mutation();
             // TODO: might need better verification that the deserialized mutation
             // is schema compatible. My guess is that just applying the mutation
@@ -280,7 +300,7 @@ future<> db::commitlog_replayer::impl::process(stats* s, commitlog::buffer_and_r
                     return db.apply_in_memory(m, cf.schema(), db::rp_handle(), db::no_timeout);
                 });
             }
-        }).then_wrapped([s] (future<> f) {
+           }).then_wrapped([s, units = std::move(units)] (future<> f) {
             try {
                 f.get();
                 s->applied_mutations++;
@@ -289,6 +309,8 @@ future<> db::commitlog_replayer::impl::process(stats* s, commitlog::buffer_and_r
                 // TODO: write mutation to file like origin.
                 rlogger.warn("error replaying: {}", std::current_exception());
             }
+           });
+          });
         });
     } catch (replica::no_such_column_family&) {
         // No such CF now? Origin just ignores this.
@@ -339,14 +361,13 @@ future<> db::commitlog_replayer::recover(std::vector<sstring> files, sstring fna
             return map_reduce(smp::all_cpus(), [this, map, &fname_prefix] (unsigned id) {
                 return smp::submit_to(id, [this, id, map, &fname_prefix] () {
                     auto total = ::make_lw_shared<impl::stats>();
-                    // TODO: or something. For now, we do this serialized per shard,
-                    // to reduce mutation congestion. We could probably (says avi)
-                    // do 2 segments in parallel or something, but lets use this first.
+                    auto memory = ::make_lw_shared<semaphore>(impl::max_memory_in_flight);
                     auto range = map->equal_range(id);
-                    return do_for_each(range.first, range.second, [this, total, &fname_prefix] (const std::pair<unsigned, sstring>& p) {
+                    return max_concurrent_for_each(boost::make_iterator_range(range.first, range.second), impl::max_concurrent_segments,
+                            [this, total, memory, &fname_prefix] (const std::pair<unsigned, sstring>& p) {
                         auto&f = p.second;
                         rlogger.debug("Replaying {}", f);
-                        return _impl->recover(f, fname_prefix).then([f, total](impl::stats stats) {
+                        return _impl->recover(f, fname_prefix, *memory).then([f, total](impl::stats stats) {
                             if (stats.corrupt_bytes != 0) {
                                 rlogger.warn("Corrupted file: {}. {} bytes skipped.", f, stats.corrupt_bytes);
                             }
@@ -358,7 +379,7 @@ future<> db::commitlog_replayer::recover(std::vector<sstring> files, sstring fna
                             );
                             *total += stats;
                         });
-                    }).then([total] {
+                    }).then([total, memory] {
                         return make_ready_future<impl::stats>(*total);
                     });
                 });
@@ -24,6 +24,7 @@
 #include "cdc/cdc_extension.hh"
 #include "tombstone_gc_extension.hh"
 #include "db/per_partition_rate_limit_extension.hh"
+#include "db/sstable_filter_type_extension.hh"
 #include "config.hh"
 #include "extensions.hh"
 #include "log.hh"
@@ -286,6 +287,16 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "If set to higher than 0, ignore the controller's output and set the compaction shares statically. Do not set this unless you know what you are doing and suspect a problem in the controller. This option will be retired when the controller reaches more maturity")
     , compaction_enforce_min_threshold(this, "compaction_enforce_min_threshold", liveness::LiveUpdate, value_status::Used, false,
         "If set to true, enforce the min_threshold option for compactions strictly. If false (default), Scylla may decide to compact even if below min_threshold")
+    , major_compaction_parallelism(this, "major_compaction_parallelism", liveness::LiveUpdate, value_status::Used, 1,
+        "Split a major compaction of a table into this many disjoint token sub-ranges, compacted concurrently in the scheduling group of the major compaction, each into its own sstable run. 1 (default) compacts the whole table at once.")
+    , compaction_backlog_forecast_horizon_in_ms(this, "compaction_backlog_forecast_horizon_in_ms", liveness::LiveUpdate, value_status::Used, 0,
+        "If set to higher than 0, the compaction controller adds to the backlog the bytes it expects memtables to flush within this many milliseconds, forecast from the recent flush rate, so that compaction shares are raised ahead of write bursts rather than after them. 0 (default) makes the controller react to the current backlog only.")
+    , max_concurrent_compactions_per_keyspace(this, "max_concurrent_compactions_per_keyspace", liveness::LiveUpdate, value_status::Used, 0,
+        "If set to higher than 0, a shard runs at most this many regular compactions of the tables of a keyspace at once, postponing the others, so the compactions caused by heavy writes to one keyspace leave room to those of the other keyspaces. 0 (default) sets no limit.")
+    , cold_storage_endpoint(this, "cold_storage_endpoint", value_status::Used, "",
+        "The S3 endpoint to which compaction moves the sstables of tables which enable it, such as TimeWindowCompactionStrategy tables with cold_storage_age_seconds set. Cold storage is disabled unless both this and cold_storage_bucket are set.")
+    , cold_storage_bucket(this, "cold_storage_bucket", value_status::Used, "",
+        "The bucket, on cold_storage_endpoint, which holds the sstables moved to cold storage.")
     /* Initialization properties */
     /* The minimal properties needed for configuring a cluster. */
     , cluster_name(this, "cluster_name", value_status::Used, "",
@@ -314,7 +325,7 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "The directory where hints files are stored if hinted handoff is enabled.")
     , view_hints_directory(this, "view_hints_directory", value_status::Used, "",
         "The directory where materialized-view updates are stored while a view replica is unreachable.")
-    , saved_caches_directory(this, "saved_caches_directory", value_status::Unused, "",
+    , saved_caches_directory(this, "saved_caches_directory", value_status::Used, "",
         "The directory location where table key and row caches are stored.")
     /* Commonly used properties */
     /* Properties most frequently used when configuring Scylla. */
@@ -429,6 +440,16 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     /* Note: does not exist on the listing page other than in above comment, wtf? */
     , commitlog_sync_batch_window_in_ms(this, "commitlog_sync_batch_window_in_ms", value_status::Used, 10000,
         "Controls how long the system waits for other writes before performing a sync in \"batch\" mode.")
+    , commitlog_sync_group_window_in_us(this, "commitlog_sync_group_window_in_us", value_status::Used, 0,
+        "In \"batch\" mode, how long a write waits, at most, for other writes to share its sync. The wait is also limited to the recent latency of commitlog flushes. 0 syncs every write right away.")
+    , commitlog_sync_group_threshold_in_kb(this, "commitlog_sync_group_threshold_in_kb", value_status::Used, 128,
+        "In \"batch\" mode, writes stop waiting for commitlog_sync_group_window_in_us once this much data waits to be synced.")
+    , commitlog_reserve_segments(this, "commitlog_reserve_segments", value_status::Used, 1,
+        "Number of commitlog segments, per shard, which are kept allocated ahead of time, so that writes rarely wait for a new segment to be created. The reserve grows, up to 12 segments, when writes do have to wait. Reserved segments count towards commitlog_total_space_in_mb.")
+    , commitlog_compression(this, "commitlog_compression", value_status::Used, "none",
+        "Compresses commitlog entries, to reduce the commitlog write bandwidth of large mutations. Can be none, lz4 or zstd. Entries which don't become smaller are written uncompressed. Commitlogs written with compression can be replayed regardless of this setting.")
+    , commitlog_compression_threshold_in_kb(this, "commitlog_compression_threshold_in_kb", value_status::Used, 4,
+        "Commitlog entries smaller than this are not compressed.")
     , commitlog_total_space_in_mb(this, "commitlog_total_space_in_mb", value_status::Used, -1,
         "Total space used for commitlogs. If the used space goes above this value, Scylla rounds up to the next nearest segment multiple and flushes memtables to disk for the oldest commitlog segments, removing those log segments. This reduces the amount of data to replay on startup, and prevents infrequently-updated tables from indefinitely keeping commitlog segments. A small total commitlog space tends to cause more flush activity on less-active tables.\n"
         "Related information: Configuring memtable throughput")
@@ -467,8 +488,10 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     , memtable_flush_queue_size(this, "memtable_flush_queue_size", value_status::Unused, 4,
         "The number of full memtables to allow pending flush (memtables waiting for a write thread). At a minimum, set to the maximum number of indexes created on a single table.\n"
         "Related information: Flushing data from the memtable")
-    , memtable_flush_writers(this, "memtable_flush_writers", value_status::Invalid, 1,
-        "Sets the number of memtable flush writer threads. These threads are blocked by disk I/O, and each one holds a memtable in memory while blocked. If you have a large Java heap size and many data directories, you can increase the value for better flush performance.")
+    , memtable_flush_writers(this, "memtable_flush_writers", liveness::LiveUpdate, value_status::Used, 1,
+        "Sets the maximum number of sstable writers which flush a single memtable concurrently, each writing a separate token range of it into its own sstables. Memtables are only split when each writer gets at least 32MB, so that small flushes don't produce many sstables.")
+    , memtable_flush_compaction(this, "memtable_flush_compaction", liveness::LiveUpdate, value_status::Used, true,
+        "Compact memtables holding expired or deleted data as they are flushed, as compaction would: expired cells are written as tombstones without their values, the tombstones which tombstone_gc allows to purge are dropped, and so are the partitions left empty.")
     , memtable_heap_space_in_mb(this, "memtable_heap_space_in_mb", value_status::Unused, 0,
         "Total permitted memory to use for memtables. Triggers a flush based on memtable_cleanup_threshold. Cassandra stops accepting writes when the limit is exceeded until a flush completes. If unset, sets to default.")
     , memtable_offheap_space_in_mb(this, "memtable_offheap_space_in_mb", value_status::Unused, 0,
@@ -493,6 +516,8 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "Throttles all streaming file transfer between the data centers. This setting allows throttles streaming throughput betweens data centers in addition to throttling all network stream traffic as configured with stream_throughput_outbound_megabits_per_sec.")
     , stream_io_throughput_mb_per_sec(this, "stream_io_throughput_mb_per_sec", liveness::LiveUpdate, value_status::Used, 0,
         "Throttles streaming I/O to the specified total throughput (in MiBs/s) across the entire system. Streaming I/O includes the one performed by repair and both RBNO and legacy topology operations such as adding or removing a node. Setting the value to 0 disables stream throttling")
+    , enable_sstable_file_streaming(this, "enable_sstable_file_streaming", liveness::LiveUpdate, value_status::Used, true,
+        "Set true to stream sstables whose data all falls in the streamed ranges by sending their files as is, instead of sending their rows to be written anew by the receiver. Applies to streaming based node operations, not to repair based ones.")
     , trickle_fsync(this, "trickle_fsync", value_status::Unused, false,
         "When doing sequential writing, enabling this option tells fsync to force the operating system to flush the dirty buffers at a set interval trickle_fsync_interval_in_kb. Enable this parameter to avoid sudden dirty buffer flushing from impacting read latencies. Recommended to use on SSDs, but not on HDDs.")
     , trickle_fsync_interval_in_kb(this, "trickle_fsync_interval_in_kb", value_status::Unused, 10240,
@@ -540,12 +565,12 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     , key_cache_size_in_mb(this, "key_cache_size_in_mb", value_status::Unused, 100,
         "A global cache setting for tables. It is the maximum size of the key cache in memory. To disable set to 0.\n"
         "Related information: nodetool setcachecapacity.")
-    , row_cache_keys_to_save(this, "row_cache_keys_to_save", value_status::Unused, 0,
-        "Number of keys from the row cache to save.")
+    , row_cache_keys_to_save(this, "row_cache_keys_to_save", value_status::Used, 0,
+        "Number of keys from the row cache to save, per table and shard. (0: all)")
     , row_cache_size_in_mb(this, "row_cache_size_in_mb", value_status::Unused, 0,
         "Maximum size of the row cache in memory. Row cache can save more time than key_cache_size_in_mb, but is space-intensive because it contains the entire row. Use the row cache only for hot rows or static rows. If you reduce the size, you may not get you hottest keys loaded on start up.")
-    , row_cache_save_period(this, "row_cache_save_period", value_status::Unused, 0,
-        "Duration in seconds that rows are saved in cache. Caches are saved to saved_caches_directory.")
+    , row_cache_save_period(this, "row_cache_save_period", value_status::Used, 0,
+        "Period in seconds of saving the keys of the partitions in the row cache to saved_caches_directory. On startup, the saved partitions are read back into cache in the background, so that the node doesn't serve reads from a cold cache. (0: disabled)")
     , memory_allocator(this, "memory_allocator", value_status::Invalid, "NativeAllocator",
         "The off-heap memory allocator. In addition to caches, this property affects storage engine meta data. Supported values:\n"
         "\tNativeAllocator\n"
@@ -570,6 +595,8 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "The maximum number of tombstones a query can scan before aborting.")
     , query_tombstone_page_limit(this, "query_tombstone_page_limit", liveness::LiveUpdate, value_status::Used, 10000,
         "The number of tombstones after which a query cuts a page, even if not full or even empty.")
+    , tombstone_compaction_read_threshold(this, "tombstone_compaction_read_threshold", liveness::LiveUpdate, value_status::Used, 0,
+        "When a page of a single partition query reads at least this many tombstones, compact the sstables holding the partition, so that the tombstones are merged with the data they shadow, and dropped once they can be. Applies to the size-tiered and incremental compaction strategies, and to sstables older than tombstone_compaction_interval. 0 disables it.")
     /* Network timeout settings */
     , range_request_timeout_in_ms(this, "range_request_timeout_in_ms", liveness::LiveUpdate, value_status::Used, 10000,
         "The time in milliseconds that the coordinator waits for sequential or index scans to complete.")
@@ -579,11 +606,29 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "The time that the coordinator waits for counter writes to complete.")
     , cas_contention_timeout_in_ms(this, "cas_contention_timeout_in_ms", liveness::LiveUpdate, value_status::Used, 1000,
         "The time that the coordinator continues to retry a CAS (compare and set) operation that contends with other proposals for the same row.")
+    , lwt_max_coalesced_requests(this, "lwt_max_coalesced_requests", liveness::LiveUpdate, value_status::Used, 1,
+        "The maximum number of concurrent CAS (compare and set) writes to the same partition that the coordinator applies in a single Paxos round. "
+        "The writes are applied in the order they arrived, each seeing the updates of the ones before it, and instead of contending with each other they share a ballot. "
+        "Only writes reading the same columns and rows of tables without non-frozen collections or user types are coalesced. 1 disables coalescing.")
+    , lwt_deferred_learn(this, "lwt_deferred_learn", liveness::LiveUpdate, value_status::Used, false,
+        "Acknowledge CAS (compare and set) writes once a quorum of replicas accepted them, and complete their learn stage in the background, "
+        "before the next CAS on the same partition through this coordinator prepares. This saves a round trip to replicas per write, "
+        "but reads at a non-serial consistency level may not see an acknowledged write until its learn stage completes.")
+    , coordinator_read_coalescing(this, "coordinator_read_coalescing", liveness::LiveUpdate, value_status::Used, false,
+        "Let identical single partition reads (same table, partition, slice, limits and consistency level) arriving at a coordinator shard while one of them is in flight "
+        "wait for it to complete and then share a single read, instead of each reading from replicas. Since the shared read starts after they all arrived, "
+        "they still see every write acknowledged before them. Reduces the load of replicas of hot partitions, at the cost of latency for the waiting reads.")
+    , range_scan_max_concurrency(this, "range_scan_max_concurrency", liveness::LiveUpdate, value_status::Used, 256,
+        "The maximum number of token ranges (vnodes) that each round of a range scan reads concurrently. Each round after the first reads as many ranges as the rows and partitions "
+        "per range returned so far indicate are needed to fill the rest of the page, up to this limit. Adjacent ranges with the same replicas are read with a single request.")
     , truncate_request_timeout_in_ms(this, "truncate_request_timeout_in_ms", liveness::LiveUpdate, value_status::Used, 60000,
         "The time that the coordinator waits for truncates (remove all data from a table) to complete. The long default value allows for a snapshot to be taken before removing the data. If auto_snapshot is disabled (not recommended), you can reduce this time.")
     , write_request_timeout_in_ms(this, "write_request_timeout_in_ms", liveness::LiveUpdate, value_status::Used, 2000,
         "The time in milliseconds that the coordinator waits for write operations to complete.\n"
         "Related information: About hinted handoff writes")
+    , remote_dc_write_batch_window_in_us(this, "remote_dc_write_batch_window_in_us", liveness::LiveUpdate, value_status::Used, 0,
+        "The time in microseconds that the coordinator holds writes sent to a replica in another datacenter, so that concurrent writes "
+        "to the same replica are sent to it in one message, which the replica forwards to the rest of its datacenter. 0 (the default) sends each write on its own.")
     , request_timeout_in_ms(this, "request_timeout_in_ms", liveness::LiveUpdate, value_status::Used, 10000,
         "The default timeout for other, miscellaneous operations.\n"
         "Related information: About hinted handoff writes")
@@ -608,6 +653,18 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "\tall: All traffic is compressed.\n"
         "\tdc : Traffic between data centers is compressed.\n"
         "\tnone : No compression.")
+    , internode_compression_algorithm(this, "internode_compression_algorithm", value_status::Used, "lz4",
+        "The algorithm preferred for compressing traffic to other nodes, when internode_compression enables it. The valid values are:\n"
+        "\n"
+        "\tlz4 : Each message is compressed on its own.\n"
+        "\tzstd : The messages of each connection are compressed as one stream, so that a message can refer back to the previous ones. Better for repetitive traffic like mutations, but costs more memory per connection.\n"
+        "\n"
+        "Connections fall back to lz4 with nodes which don't support zstd.")
+    , shard_aware_internode_connections(this, "shard_aware_internode_connections", value_status::Used, false,
+        "Open connections to each shard of other nodes, picking their source ports so that they land on that shard, and send requests for a partition to the shard owning it, saving the replica a hop between shards. Multiplies the number of connections between nodes by their shard count. Requests not bound to a partition go to shard 0, or are spread over the shards.")
+    , rpc_latency_sample_rate(this, "rpc_latency_sample_rate", liveness::LiveUpdate, value_status::Used, 0,
+        "The fraction, between 0 and 1, of internode messages whose serialization, round trip and handler latencies are sampled, by verb and peer. "
+        "Exported as metrics and through the REST API under /messaging_service/messages. While non zero, the messages in flight of each verb are counted too. 0 disables sampling.")
     , inter_dc_tcp_nodelay(this, "inter_dc_tcp_nodelay", value_status::Used, false,
         "Enable or disable tcp_nodelay for inter-data center communication. When disabled larger, but fewer, network packets are sent. This reduces overhead from the TCP protocol itself. However, if cross data-center responses are blocked, it will increase latency.")
     , streaming_socket_timeout_in_ms(this, "streaming_socket_timeout_in_ms", value_status::Unused, 0,
@@ -634,6 +691,9 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "Idle threads are stopped after 30 seconds.\n")
     , native_transport_max_frame_size_in_mb(this, "native_transport_max_frame_size_in_mb", value_status::Unused, 256,
         "The maximum size of allowed frame. Frame (requests) larger than this are rejected as invalid.")
+    , native_transport_compression_min_size(this, "native_transport_compression_min_size", liveness::LiveUpdate, value_status::Used, 0,
+        "Responses to clients which negotiated compression are sent uncompressed if their body is smaller than this many bytes, since compressing them costs more CPU than it saves bandwidth. "
+        "Responses which don't get smaller when compressed are sent uncompressed regardless.")
     /* RPC (remote procedure call) settings */
     /* Settings for configuring and tuning client connections. */
     , broadcast_rpc_address(this, "broadcast_rpc_address", value_status::Used, {/* unset */},
@@ -663,9 +723,13 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "This boolean controls whether the replicas for read query will be choosen based on cache hit ratio")
     /* Advanced fault detection settings */
     /* Settings to handle poorly performing or failing nodes. */
-    , dynamic_snitch_badness_threshold(this, "dynamic_snitch_badness_threshold", value_status::Unused, 0,
+    , dynamic_snitch(this, "dynamic_snitch", liveness::LiveUpdate, value_status::Used, false,
+        "Order the replicas of single partition reads by their recent read latencies, scaled by the number of their pending reads, rather than by proximity only. See dynamic_snitch_badness_threshold.")
+    , read_hedging_max_ratio(this, "read_hedging_max_ratio", liveness::LiveUpdate, value_status::Used, 0,
+        "When positive, reads of tables with a PERCENTILE speculative_retry speculate once the initially contacted replicas take longer than that percentile of their own recent read latencies, rather than of the table's. Speculative reads of all tables are then limited to this fraction of the reads, e.g. 0.05 for at most 5%.")
+    , dynamic_snitch_badness_threshold(this, "dynamic_snitch_badness_threshold", liveness::LiveUpdate, value_status::Used, 0,
         "Sets the performance threshold for dynamically routing requests away from a poorly performing node. A value of 0.2 means Cassandra continues to prefer the static snitch values until the node response time is 20% worse than the best performing node. Until the threshold is reached, incoming client requests are statically routed to the closest replica (as determined by the snitch). Having requests consistently routed to a given replica can help keep a working set of data hot when read repair is less than 1.")
-    , dynamic_snitch_reset_interval_in_ms(this, "dynamic_snitch_reset_interval_in_ms", value_status::Unused, 60000,
+    , dynamic_snitch_reset_interval_in_ms(this, "dynamic_snitch_reset_interval_in_ms", liveness::LiveUpdate, value_status::Used, 60000,
         "Time interval in milliseconds to reset all node scores, which allows a bad node to recover.")
     , dynamic_snitch_update_interval_in_ms(this, "dynamic_snitch_update_interval_in_ms", value_status::Unused, 100,
         "The time interval for how often the snitch calculates node scores. Because score calculation is CPU intensive, be careful when reducing this interval.")
@@ -674,8 +738,14 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "Related information: About hinted handoff writes")
     , max_hinted_handoff_concurrency(this, "max_hinted_handoff_concurrency", liveness::LiveUpdate, value_status::Used, 0,
         "Maximum concurrency allowed for sending hints. The concurrency is divided across shards and rounded up if not divisible by the number of shards. By default (or when set to 0), concurrency of 8*shard_count will be used.")
-    , hinted_handoff_throttle_in_kb(this, "hinted_handoff_throttle_in_kb", value_status::Unused, 1024,
-        "Maximum throttle per delivery thread in kilobytes per second. This rate reduces proportionally to the number of nodes in the cluster. For example, if there are two nodes in the cluster, each delivery thread will use the maximum rate. If there are three, each node will throttle to half of the maximum, since the two nodes are expected to deliver hints simultaneously.")
+    , hinted_handoff_throttle_in_kb(this, "hinted_handoff_throttle_in_kb", liveness::LiveUpdate, value_status::Used, 0,
+        "Maximum rate, in kilobytes per second, at which each shard replays hints. This rate reduces proportionally to the number of nodes in the cluster. For example, if there are two nodes in the cluster, each shard will use the maximum rate. If there are three, each shard will throttle to half of the maximum, since the two nodes are expected to replay hints simultaneously. 0 (the default) disables throttling.")
+    , hints_compression(this, "hints_compression", value_status::Used, "none",
+        "Compresses the hints written to hints files, to reduce their disk usage. Can be none, lz4 or zstd. Hints which don't become smaller are written uncompressed. Hints files written with compression can be replayed regardless of this setting.")
+    , hints_compression_threshold_in_kb(this, "hints_compression_threshold_in_kb", value_status::Used, 1,
+        "Hints smaller than this are not compressed.")
+    , hints_coalesce_on_replay(this, "hints_coalesce_on_replay", liveness::LiveUpdate, value_status::Used, true,
+        "Merges the hints for the same partition which are replayed together into a single mutation, so that a partition updated many times while a node was down is written to it once per batch of hints.")
     , max_hint_window_in_ms(this, "max_hint_window_in_ms", value_status::Used, 10800000,
         "Maximum amount of time that hints are generates hints for an unresponsive node. After this interval, new hints are no longer generated until the node is back up and responsive. If the node goes down again, a new interval begins. This setting can prevent a sudden demand for resources when a node is brought back online and the rest of the cluster attempts to replay a large volume of hinted writes.\n"
         "Related information: Failure detection and recovery")
@@ -738,6 +808,11 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "Refresh interval for permissions cache (if enabled). After this interval, cache entries become eligible for refresh. An async reload is scheduled every permissions_update_interval_in_ms time period and the old value is returned until it completes. If permissions_validity_in_ms has a non-zero value, then this property must also have a non-zero value. It's recommended to set this value to be at least 3 times smaller than the permissions_validity_in_ms.")
     , permissions_cache_max_entries(this, "permissions_cache_max_entries", liveness::LiveUpdate, value_status::Used, 1000,
         "Maximum cached permission entries. Must have a non-zero value if permissions caching is enabled (see a permissions_validity_in_ms description).")
+    , authentication_cache_validity_in_ms(this, "authentication_cache_validity_in_ms", liveness::LiveUpdate, value_status::Used, 10000,
+        "How long PasswordAuthenticator remembers that a password matched the role's salted hash, sparing the expensive hash of the password on the following logins of the role. "
+        "A remembered password only matches as long as the role's salted hash is unchanged, so changing or dropping the role takes effect immediately. Set to 0 to disable the cache.")
+    , authentication_cache_max_entries(this, "authentication_cache_max_entries", liveness::LiveUpdate, value_status::Used, 1000,
+        "Maximum number of roles whose password is remembered by each shard (see authentication_cache_validity_in_ms).")
     , server_encryption_options(this, "server_encryption_options", value_status::Used, {/*none*/},
         "Enable or disable inter-node encryption. You must also generate keys and provide the appropriate key and trust store locations and passwords. The available options are:\n"
         "\n"
@@ -800,6 +875,12 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     , override_decommission(this, "override_decommission", value_status::Used, false, "Set true to force a decommissioned node to join the cluster")
     , enable_repair_based_node_ops(this, "enable_repair_based_node_ops", liveness::LiveUpdate, value_status::Used, true, "Set true to use enable repair based node operations instead of streaming based")
     , allowed_repair_based_node_ops(this, "allowed_repair_based_node_ops", liveness::LiveUpdate, value_status::Used, "replace,removenode,rebuild,bootstrap,decommission", "A comma separated list of node operations which are allowed to enable repair based node operations. The operations can be bootstrap, replace, removenode, decommission and rebuild")
+    , repair_range_summaries_max_age_in_s(this, "repair_range_summaries_max_age_in_s", liveness::LiveUpdate, value_status::Used, 0,
+        "Make nodes remember, until they restart, the ranges which a repair found in sync and which weren't written since, so that repairing them again within this many seconds doesn't read and hash their rows. Expiring data and purged tombstones don't count as writes, so this shouldn't exceed gc_grace_seconds. 0 disables.")
+    , repair_range_summaries_subranges(this, "repair_range_summaries_subranges", liveness::LiveUpdate, value_status::Used, 16,
+        "Into how many parts of the same width repair splits each range when repair_range_summaries_max_age_in_s is set, so that a write to a part only makes the next repair read that part again. Higher values skip more unchanged data, at the cost of more repair rpcs per range.")
+    , repair_throughput_mb_per_sec(this, "repair_throughput_mb_per_sec", liveness::LiveUpdate, value_status::Used, 0,
+        "Throttles the rows repair reads and transfers to the specified total throughput (in MiBs/s) across the entire system, including repair based node operations. Repair lowers both its parallelism and this throughput while user reads queue for admission, and raises them back once they don't. Setting the value to 0 disables the throttling, leaving only the backing off of parallelism.")
     , ring_delay_ms(this, "ring_delay_ms", value_status::Used, 30 * 1000, "Time a node waits to hear from other nodes before joining the ring in milliseconds. Same as -Dcassandra.ring_delay_ms in cassandra.")
     , shadow_round_ms(this, "shadow_round_ms", value_status::Used, 300 * 1000, "The maximum gossip shadow round time. Can be used to reduce the gossip feature check time during node boot up.")
     , fd_max_interval_ms(this, "fd_max_interval_ms", value_status::Used, 2 * 1000, "The maximum failure_detector interval time in milliseconds. Interval larger than the maximum will be ignored. Larger cluster may need to increase the default.")
@@ -815,8 +896,18 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     , prometheus_address(this, "prometheus_address", value_status::Used, {/* listen_address */}, "Prometheus listening address, defaulting to listen_address if not explicitly set")
     , prometheus_prefix(this, "prometheus_prefix", value_status::Used, "scylla", "Set the prefix of the exported Prometheus metrics. Changing this will break Scylla's dashboard compatibility, do not change unless you know what you are doing.")
     , abort_on_lsa_bad_alloc(this, "abort_on_lsa_bad_alloc", value_status::Used, false, "Abort when allocation in LSA region fails")
+    , lsa_huge_pages(this, "lsa_huge_pages", value_status::Used, false, "Back the LSA memory, which holds the row cache and memtables, with transparent huge pages, populated at startup. "
+        "Reduces TLB misses on nodes with a lot of memory. To use 1GB pages, start with the --hugepages option instead.")
     , murmur3_partitioner_ignore_msb_bits(this, "murmur3_partitioner_ignore_msb_bits", value_status::Used, default_murmur3_partitioner_ignore_msb_bits, "Number of most siginificant token bits to ignore in murmur3 partitioner; increase for very large clusters")
+    , single_shard_tables(this, "single_shard_tables", value_status::Used, { },
+        "Tables, given as keyspace.table, whose data this node keeps on a single shard instead of spreading it over all shards. "
+        "Scans and aggregates of such tables then run on that shard only, instead of fanning out to every shard. "
+        "Meant for small tables which are scanned often, such as configuration and metadata tables. "
+        "Existing data is moved by resharding on the next restart.")
     , unspooled_dirty_soft_limit(this, "unspooled_dirty_soft_limit", value_status::Used, 0.6, "Soft limit of unspooled dirty memory expressed as a portion of the hard limit")
+    , unspooled_dirty_max_write_delay_in_ms(this, "unspooled_dirty_max_write_delay_in_ms", liveness::LiveUpdate, value_status::Used, 0,
+        "Maximum delay imposed on each write while unspooled dirty memory is between the soft and the hard limit and memtables are filled faster than they are flushed. "
+        "The delay grows with the excess of the write rate over the flush rate and as memory approaches the hard limit, so that clients slow down gradually instead of being blocked at the hard limit. Set to 0 to disable.")
     , sstable_summary_ratio(this, "sstable_summary_ratio", value_status::Used, 0.0005, "Enforces that 1 byte of summary is written for every N (2000 by default) "
         "bytes written to data file. Value must be between 0 and 1.")
     , large_memory_allocation_warning_threshold(this, "large_memory_allocation_warning_threshold", value_status::Used, size_t(1) << 20, "Warn about memory allocations above this size; set to zero to disable")
@@ -826,8 +917,32 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         " Performance is affected to some extent as a result. Useful to help debugging problems that may arise at another layers.")
     , enable_sstable_key_validation(this, "enable_sstable_key_validation", value_status::Used, ENABLE_SSTABLE_KEY_VALIDATION, "Enable validation of partition and clustering keys monotonicity"
         " Performance is affected to some extent as a result. Useful to help debugging problems that may arise at another layers.")
+    , enable_sstable_blocked_bloom_filter(this, "enable_sstable_blocked_bloom_filter", value_status::Used, false, "Write sstable bloom filters using a cache-line blocked layout,"
+        " where checking a key costs a single cache miss, at the cost of slightly larger filters for the same false-positive chance."
+        " SSTables written with this layout cannot be read by older versions, nor by Cassandra.")
+    , enable_evictable_sstable_filters(this, "enable_evictable_sstable_filters", value_status::Used, false, "Read sstable bloom filters through the cache, rather than holding them in memory,"
+        " so that they can be evicted under memory pressure. A lookup which needs a page that was evicted reports the key as present while the page is read back."
+        " Binary fuse filters, and the filters of sstables shared between shards, are always held in memory.")
+    , enable_sstable_partition_trie_index(this, "enable_sstable_partition_trie_index", value_status::Used, false, "Write a trie of partition key prefixes (Partitions.db) along with the index of new sstables,"
+        " so that single-partition reads find their index entry without parsing a whole summary page of Index.db."
+        " Older versions ignore the component.")
+    , enable_sstable_row_index(this, "enable_sstable_row_index", value_status::Used, false, "Write a tree over the promoted index blocks of large partitions (Rows.db) along with the index of new sstables,"
+        " so that reads within a large partition find their promoted index block with fewer page reads than a binary search."
+        " Older versions ignore the component.")
+    , enable_sstable_column_value_stats(this, "enable_sstable_column_value_stats", value_status::Used, false, "Record the minimum and maximum values and the number of nulls of the regular columns of new sstables in their Scylla component,"
+        " so that filtered reads which no sstable can satisfy return without reading them."
+        " Older versions ignore the statistics.")
+    , sstable_write_buffer_size_in_kb(this, "sstable_write_buffer_size_in_kb", value_status::Used, 0, "Size of the buffers the data and index files of new sstables are written with, rounded up to a multiple of 64 KiB."
+        " 0 writes them with the sstable buffer size (128 KiB).")
+    , sstable_write_behind(this, "sstable_write_behind", value_status::Used, 10, "Number of buffers of the data and index files of a new sstable written to the disk concurrently.")
+    , sstable_preallocation_size_in_mb(this, "sstable_preallocation_size_in_mb", value_status::Used, 0, "Preallocate the data and index files of new sstables with fallocate() in extents of this size, as they grow,"
+        " to reduce their fragmentation and the metadata updates of the writes. 0 disables preallocation.")
+    , sstable_write_sync_interval_in_mb(this, "sstable_write_sync_interval_in_mb", value_status::Used, 0, "fdatasync() the data and index files of new sstables every time that much was written to them,"
+        " to spread the writeback of flushes and compactions instead of syncing all of it when the sstable is sealed. 0 syncs only when sealing.")
     , cpu_scheduler(this, "cpu_scheduler", value_status::Used, true, "Enable cpu scheduling")
     , view_building(this, "view_building", value_status::Used, true, "Enable view building; should only be set to false when the node is experience issues due to view building")
+    , coalesce_view_updates(this, "coalesce_view_updates", liveness::LiveUpdate, value_status::Used, true,
+        "Sends the view updates generated for a base partition which go to the same view replicas together, so that each view replica receives them in a single message. A failure to send them is then accounted to all of them.")
     , enable_sstables_mc_format(this, "enable_sstables_mc_format", value_status::Unused, true, "Enable SSTables 'mc' format to be used as the default file format.  Deprecated, please use \"sstable_format\" instead.")
     , enable_sstables_md_format(this, "enable_sstables_md_format", value_status::Unused, true, "Enable SSTables 'md' format to be used as the default file format.  Deprecated, please use \"sstable_format\" instead.")
     , sstable_format(this, "sstable_format", value_status::Used, "me", "Default sstable file format", {"md", "me"})
@@ -852,10 +967,16 @@ db::config::config(std::shared_ptr<db::extensions> exts)
             "Start serializing reads after their collective memory consumption goes above $normal_limit * $multiplier.")
     , reader_concurrency_semaphore_kill_limit_multiplier(this, "reader_concurrency_semaphore_kill_limit_multiplier", liveness::LiveUpdate, value_status::Used, 4,
             "Start killing reads after their collective memory consumption goes above $normal_limit * $multiplier.")
+    , reader_concurrency_semaphore_scan_cost_limit(this, "reader_concurrency_semaphore_scan_cost_limit", liveness::LiveUpdate, value_status::Used, 500,
+            "Queue new scans (reads which are not point reads) while the admitted user scans are predicted to read more than this many sstables in total. "
+            "Point reads are not affected, and are admitted ahead of queued scans. Set to 0 to disable.")
     , twcs_max_window_count(this, "twcs_max_window_count", liveness::LiveUpdate, value_status::Used, 50,
             "The maximum number of compaction windows allowed when making use of TimeWindowCompactionStrategy. A setting of 0 effectively disables the restriction.")
     , initial_sstable_loading_concurrency(this, "initial_sstable_loading_concurrency", value_status::Used, 4u,
             "Maximum amount of sstables to load in parallel during initialization. A higher number can lead to more memory consumption. You should not need to touch this")
+    , defer_sstable_filter_loading(this, "defer_sstable_filter_loading", value_status::Used, false,
+            "Don't read the bloom filters of sstables during initialization, but in the background once their table is populated."
+            " Until its filter is read, an sstable is read by every single-partition read of its token range. Speeds up startup of nodes with many sstables.")
     , enable_3_1_0_compatibility_mode(this, "enable_3_1_0_compatibility_mode", value_status::Used, false,
         "Set to true if the cluster was initially installed from 3.1.0. If it was upgraded from an earlier version,"
         " or installed from a later version, leave this set to false. This adjusts the communication protocol to"
@@ -868,17 +989,36 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "Time period in seconds after which unused schema versions will be evicted from the local schema registry cache. Default is 1 second.")
     , max_concurrent_requests_per_shard(this, "max_concurrent_requests_per_shard", liveness::LiveUpdate, value_status::Used, std::numeric_limits<uint32_t>::max(),
         "Maximum number of concurrent requests a single shard can handle before it starts shedding extra load. By default, no requests will be shed.")
+    , max_concurrent_requests_per_connection(this, "max_concurrent_requests_per_connection", liveness::LiveUpdate, value_status::Used, std::numeric_limits<uint32_t>::max(),
+        "Maximum number of concurrent requests of a single CQL connection. Further requests pipelined on the connection aren't read until one completes. By default, there is no limit.")
+    , interactive_latency_target_ms(this, "interactive_latency_target_ms", liveness::LiveUpdate, value_status::Used, 0,
+        "Target for the p99 latency of the CQL requests of the service levels with the interactive workload type. While a shard misses it, the requests of the service levels with the batch workload type are shed with an OVERLOADED error, until the p99 is back below 80% of the target. 0 (default) disables shedding.")
+    , tracing_backend(this, "tracing_backend", value_status::Used, "system_traces",
+        "Where finished tracing sessions are stored. \"system_traces\" (default) writes them to the system_traces keyspace. \"ring_buffer\" keeps the last sessions of each shard in memory, which makes it cheap to keep the slow query logging enabled, and exposes them in the system.recent_traces virtual table.",
+        {"system_traces", "ring_buffer"})
+    , hot_partitions_capacity(this, "hot_partitions_capacity", value_status::Used, 256,
+        "Number of partitions each shard keeps read and write counts of, to find its hottest partitions, which are listed in the system.hot_partitions virtual table. Only single partition reads are counted. 0 disables the tracking.")
+    , hot_partitions_window_in_s(this, "hot_partitions_window_in_s", value_status::Used, 60,
+        "Length of the windows of time the hot partitions are counted in. The hottest partitions of the last complete window are reported.")
+    , cpu_profiler_frequency_hz(this, "cpu_profiler_frequency_hz", liveness::LiveUpdate, value_status::Used, 0,
+        "Number of times per second of CPU time each shard samples the stack it runs, along with the scheduling group and the table it works for. The profile is returned in the folded stacks format by the /system/cpu_profile REST API. At most 1000. 0 (default) disables the profiler.")
     , cdc_dont_rewrite_streams(this, "cdc_dont_rewrite_streams", value_status::Used, false,
             "Disable rewriting streams from cdc_streams_descriptions to cdc_streams_descriptions_v2. Should not be necessary, but the procedure is expensive and prone to failures; this config option is left as a backdoor in case some user requires manual intervention.")
+    , cdc_preimage_cache_size(this, "cdc_preimage_cache_size", liveness::LiveUpdate, value_status::Used, 0,
+            "Number of partitions of tables with CDC postimage enabled, per shard, whose rows written in the last second are remembered, so that writing them again takes their preimage from what they were written with instead of querying it. Rows written meanwhile through other nodes are then missed by the preimage. 0 disables it.")
     , strict_allow_filtering(this, "strict_allow_filtering", liveness::LiveUpdate, value_status::Used, strict_allow_filtering_default(), "Match Cassandra in requiring ALLOW FILTERING on slow queries. Can be true, false, or warn. When false, Scylla accepts some slow queries even without ALLOW FILTERING that Cassandra rejects. Warn is same as false, but with warning.")
     , reversed_reads_auto_bypass_cache(this, "reversed_reads_auto_bypass_cache", liveness::LiveUpdate, value_status::Used, false,
             "Bypass in-memory data cache (the row cache) when performing reversed queries.")
     , enable_optimized_reversed_reads(this, "enable_optimized_reversed_reads", liveness::LiveUpdate, value_status::Used, true,
             "Use a new optimized algorithm for performing reversed reads.")
+    , multi_partition_read_ahead(this, "multi_partition_read_ahead", liveness::LiveUpdate, value_status::Used, 0,
+            "When a query reads many single partitions, such as with IN (...) on the partition key, start reading this many of the partitions following the one being read in the background, so that their index and data reads are issued together instead of one after another. 0 reads the partitions one at a time.")
     , enable_cql_config_updates(this, "enable_cql_config_updates", liveness::LiveUpdate, value_status::Used, true,
             "Make the system.config table UPDATEable")
     , enable_parallelized_aggregation(this, "enable_parallelized_aggregation", liveness::LiveUpdate, value_status::Used, true,
             "Use on a new, parallel algorithm for performing aggregate queries.")
+    , secondary_index_base_query_concurrency(this, "secondary_index_base_query_concurrency", liveness::LiveUpdate, value_status::Used, 1,
+            "Number of base table partitions a query using a secondary index reads concurrently at first, for each page of index results. The number doubles with each batch of reads which didn't fill the page, up to 4096. Rows of the same partition are always read together.")
     , alternator_port(this, "alternator_port", value_status::Used, 0, "Alternator API port")
     , alternator_https_port(this, "alternator_https_port", value_status::Used, 0, "Alternator API HTTPS port")
     , alternator_address(this, "alternator_address", value_status::Used, "0.0.0.0", "Alternator API listening address")
@@ -890,6 +1030,10 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     , alternator_ttl_period_in_seconds(this, "alternator_ttl_period_in_seconds", value_status::Used,
         60*60*24,
         "The default period for Alternator's expiration scan. Alternator attempts to scan every table within that period.")
+    , alternator_ttl_scan_parallelism(this, "alternator_ttl_scan_parallelism", liveness::LiveUpdate, value_status::Used, 4,
+        "The maximum number of token ranges of a table which each shard scans for expired items at a time. The scan backs off from it while user reads queue up.")
+    , alternator_ttl_scan_rows_per_second(this, "alternator_ttl_scan_rows_per_second", liveness::LiveUpdate, value_status::Used, 0,
+        "The maximum number of rows per second which each shard reads while scanning for expired items, at full parallelism. 0 means unlimited.")
     , abort_on_ebadf(this, "abort_on_ebadf", value_status::Used, true, "Abort the server on incorrect file descriptor access. Throws exception when disabled.")
     , redis_port(this, "redis_port", value_status::Used, 0, "Port on which the REDIS transport listens for clients.")
     , redis_ssl_port(this, "redis_ssl_port", value_status::Used, 0, "Port on which the REDIS TLS native transport listens for clients.")
@@ -905,6 +1049,9 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "\t'datacenter_name':N [,...], (Default: 'dc1:1') IFF the class is NetworkTopologyStrategy, assign replication factors to each data center in a comma separated list.\n"
         "\n"
         "Related information: About replication strategy.")
+    , redis_in_memory_tables(this, "redis_in_memory_tables", value_status::Used, false,
+        "Keep the data of the redis keyspaces in memory only, as a replicated cache: writes skip the commitlog, memtables are moved into the row cache instead of being flushed to sstables, "
+        "and when memory runs short the least recently used data is evicted and lost. All the data is lost on restart.")
     , sanitizer_report_backtrace(this, "sanitizer_report_backtrace", value_status::Used, false,
             "In debug mode, report log-structured allocator sanitizer violations with a backtrace. Slow.")
     , flush_schema_tables_after_modification(this, "flush_schema_tables_after_modification", liveness::LiveUpdate, value_status::Used, true,
@@ -922,6 +1069,20 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     , nodeops_heartbeat_interval_seconds(this, "nodeops_heartbeat_interval_seconds", liveness::LiveUpdate, value_status::Used, 10, "Period of heartbeat ticks in node operations")
     , cache_index_pages(this, "cache_index_pages", liveness::LiveUpdate, value_status::Used, false,
         "Keep SSTable index pages in the global cache after a SSTable read. Expected to improve performance for workloads with big partitions, but may degrade performance for workloads with small partitions.")
+    , cache_pack_narrow_rows(this, "cache_pack_narrow_rows", value_status::Used, false,
+        "Store rows populated into the row cache in a compact encoding when all their cells are live, of fixed-width types, without TTL and written with the same timestamp. Reduces the memory taken by rows of narrow schemas, such as time series, at the cost of decoding them on reads.")
+    , cache_admission_filter(this, "cache_admission_filter", value_status::Used, false,
+        "While the row cache is evicting, populate it only with partitions which were read recently already, according to a frequency sketch of reads (TinyLFU). Keeps scans over data read only once from evicting frequently read partitions, without requiring BYPASS CACHE.")
+    , cache_absent_partitions_per_table(this, "cache_absent_partitions_per_table", value_status::Used, 0,
+        "How many keys of partitions which reads found not to exist each table remembers on each shard, so that reading them again doesn't need to consult SSTables after the row cache evicted them. Speeds up workloads dominated by reads of missing keys. 0 disables.")
+    , partition_digest_cache_entries_per_table(this, "partition_digest_cache_entries_per_table", value_status::Used, 0,
+        "How many results of digest reads of single partitions each table remembers on each shard, so that replicas answer the digest reads of quorum reads of unchanged partitions without reading and hashing them again. A remembered digest is dropped when its partition is written, when SSTables of the table change, and after one second. 0 disables.")
+    , counter_shard_cache_entries_per_table(this, "counter_shard_cache_entries_per_table", value_status::Used, 0,
+        "How many counter cells updated by this node each counter table remembers the shard of this node of on each shard, so that updating them again doesn't need to read them first. Remembered shards are forgotten when the table is truncated or altered. 0 disables.")
+    , querier_cache_prefetch(this, "querier_cache_prefetch", value_status::Used, false,
+        "Make replicas read the next page of paged queries while the current one is sent to the client, so that long paged reads, such as exports, aren't bound by the latency of each page. The read ahead data is accounted to the reader concurrency semaphore, which evicts it when memory is short.")
+    , query_result_cache_memory_fraction(this, "query_result_cache_memory_fraction", value_status::Used, 0.01,
+        "Maximum memory, as a fraction of the shard's memory, taken by the results remembered by all the tables with results_ttl_in_ms, see their caching options. When it is used up, a table drops its oldest results to remember new ones.")
     , x_log2_compaction_groups(this, "x_log2_compaction_groups", value_status::Used, 0, "Controls static number of compaction groups per table per shard. For X groups, set the option to log (base 2) of X. Example: Value of 3 implies 8 groups.")
      , consistent_cluster_management(this, "consistent_cluster_management", value_status::Used, false, "Use RAFT for cluster management and DDL")
     , wasm_cache_memory_fraction(this, "wasm_cache_memory_fraction", value_status::Used, 0.01, "Maximum total size of all WASM instances stored in the cache as fraction of total shard memory")
@@ -954,6 +1115,10 @@ void db::config::add_per_partition_rate_limit_extension() {
     _extensions->add_schema_extension<db::per_partition_rate_limit_extension>(db::per_partition_rate_limit_extension::NAME);
 }
 
+void db::config::add_sstable_filter_type_extension() {
+    _extensions->add_schema_extension<db::sstable_filter_type_extension>(db::sstable_filter_type_extension::NAME);
+}
+
 void db::config::setup_directories() {
     maybe_in_workdir(commitlog_directory, "commitlog");
     if (!schema_commitlog_directory.is_set()) {
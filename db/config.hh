@@ -110,6 +110,7 @@ class config : public utils::config_file {
     // For testing only
     void add_cdc_extension();
     void add_per_partition_rate_limit_extension();
+    void add_sstable_filter_type_extension();
 
     /// True iff the feature is enabled.
     bool check_experimental(experimental_features_t::feature f) const;
@@ -142,6 +143,11 @@ class config : public utils::config_file {
     named_value<float> memtable_flush_static_shares;
     named_value<float> compaction_static_shares;
     named_value<bool> compaction_enforce_min_threshold;
+    named_value<uint32_t> major_compaction_parallelism;
+    named_value<uint32_t> compaction_backlog_forecast_horizon_in_ms;
+    named_value<uint32_t> max_concurrent_compactions_per_keyspace;
+    named_value<sstring> cold_storage_endpoint;
+    named_value<sstring> cold_storage_bucket;
     named_value<sstring> cluster_name;
     named_value<sstring> listen_address;
     named_value<sstring> listen_interface;
@@ -178,6 +184,11 @@ class config : public utils::config_file {
     named_value<uint32_t> commitlog_segment_size_in_mb;
     named_value<uint32_t> commitlog_sync_period_in_ms;
     named_value<uint32_t> commitlog_sync_batch_window_in_ms;
+    named_value<uint32_t> commitlog_sync_group_window_in_us;
+    named_value<uint32_t> commitlog_sync_group_threshold_in_kb;
+    named_value<uint32_t> commitlog_reserve_segments;
+    named_value<sstring> commitlog_compression;
+    named_value<uint32_t> commitlog_compression_threshold_in_kb;
     named_value<int64_t> commitlog_total_space_in_mb;
     named_value<bool> commitlog_reuse_segments; // unused. retained for upgrade compat
     named_value<int64_t> commitlog_flush_threshold_in_mb;
@@ -194,6 +205,7 @@ class config : public utils::config_file {
     named_value<uint32_t> file_cache_size_in_mb;
     named_value<uint32_t> memtable_flush_queue_size;
     named_value<uint32_t> memtable_flush_writers;
+    named_value<bool> memtable_flush_compaction;
     named_value<uint32_t> memtable_heap_space_in_mb;
     named_value<uint32_t> memtable_offheap_space_in_mb;
     named_value<uint32_t> column_index_size_in_kb;
@@ -205,6 +217,7 @@ class config : public utils::config_file {
     named_value<uint32_t> stream_throughput_outbound_megabits_per_sec;
     named_value<uint32_t> inter_dc_stream_throughput_outbound_megabits_per_sec;
     named_value<uint32_t> stream_io_throughput_mb_per_sec;
+    named_value<bool> enable_sstable_file_streaming;
     named_value<bool> trickle_fsync;
     named_value<uint32_t> trickle_fsync_interval_in_kb;
     named_value<bool> auto_bootstrap;
@@ -230,17 +243,26 @@ class config : public utils::config_file {
     named_value<uint32_t> tombstone_warn_threshold;
     named_value<uint32_t> tombstone_failure_threshold;
     named_value<uint64_t> query_tombstone_page_limit;
+    named_value<uint32_t> tombstone_compaction_read_threshold;
     named_value<uint32_t> range_request_timeout_in_ms;
     named_value<uint32_t> read_request_timeout_in_ms;
     named_value<uint32_t> counter_write_request_timeout_in_ms;
     named_value<uint32_t> cas_contention_timeout_in_ms;
+    named_value<uint32_t> lwt_max_coalesced_requests;
+    named_value<bool> lwt_deferred_learn;
+    named_value<bool> coordinator_read_coalescing;
+    named_value<uint32_t> range_scan_max_concurrency;
     named_value<uint32_t> truncate_request_timeout_in_ms;
     named_value<uint32_t> write_request_timeout_in_ms;
+    named_value<uint32_t> remote_dc_write_batch_window_in_us;
     named_value<uint32_t> request_timeout_in_ms;
     named_value<bool> cross_node_timeout;
     named_value<uint32_t> internode_send_buff_size_in_bytes;
     named_value<uint32_t> internode_recv_buff_size_in_bytes;
     named_value<sstring> internode_compression;
+    named_value<sstring> internode_compression_algorithm;
+    named_value<bool> shard_aware_internode_connections;
+    named_value<double> rpc_latency_sample_rate;
     named_value<bool> inter_dc_tcp_nodelay;
     named_value<uint32_t> streaming_socket_timeout_in_ms;
     named_value<bool> start_native_transport;
@@ -250,6 +272,7 @@ class config : public utils::config_file {
     named_value<uint16_t> native_shard_aware_transport_port_ssl;
     named_value<uint32_t> native_transport_max_threads;
     named_value<uint32_t> native_transport_max_frame_size_in_mb;
+    named_value<uint32_t> native_transport_compression_min_size;
     named_value<sstring> broadcast_rpc_address;
     named_value<uint16_t> rpc_port;
     named_value<bool> start_rpc;
@@ -260,12 +283,17 @@ class config : public utils::config_file {
     named_value<uint32_t> rpc_send_buff_size_in_bytes;
     named_value<sstring> rpc_server_type;
     named_value<bool> cache_hit_rate_read_balancing;
+    named_value<bool> dynamic_snitch;
+    named_value<double> read_hedging_max_ratio;
     named_value<double> dynamic_snitch_badness_threshold;
     named_value<uint32_t> dynamic_snitch_reset_interval_in_ms;
     named_value<uint32_t> dynamic_snitch_update_interval_in_ms;
     named_value<hinted_handoff_enabled_type> hinted_handoff_enabled;
     named_value<uint32_t> max_hinted_handoff_concurrency;
     named_value<uint32_t> hinted_handoff_throttle_in_kb;
+    named_value<sstring> hints_compression;
+    named_value<uint32_t> hints_compression_threshold_in_kb;
+    named_value<bool> hints_coalesce_on_replay;
     named_value<uint32_t> max_hint_window_in_ms;
     named_value<uint32_t> max_hints_delivery_threads;
     named_value<uint32_t> batchlog_replay_throttle_in_kb;
@@ -281,6 +309,8 @@ class config : public utils::config_file {
     named_value<uint32_t> permissions_validity_in_ms;
     named_value<uint32_t> permissions_update_interval_in_ms;
     named_value<uint32_t> permissions_cache_max_entries;
+    named_value<uint32_t> authentication_cache_validity_in_ms;
+    named_value<uint32_t> authentication_cache_max_entries;
     named_value<string_map> server_encryption_options;
     named_value<string_map> client_encryption_options;
     named_value<string_map> alternator_encryption_options;
@@ -304,6 +334,9 @@ class config : public utils::config_file {
     named_value<bool> override_decommission;
     named_value<bool> enable_repair_based_node_ops;
     named_value<sstring> allowed_repair_based_node_ops;
+    named_value<uint32_t> repair_range_summaries_max_age_in_s;
+    named_value<uint32_t> repair_range_summaries_subranges;
+    named_value<uint32_t> repair_throughput_mb_per_sec;
     named_value<uint32_t> ring_delay_ms;
     named_value<uint32_t> shadow_round_ms;
     named_value<uint32_t> fd_max_interval_ms;
@@ -319,16 +352,29 @@ class config : public utils::config_file {
     named_value<sstring> prometheus_address;
     named_value<sstring> prometheus_prefix;
     named_value<bool> abort_on_lsa_bad_alloc;
+    named_value<bool> lsa_huge_pages;
     named_value<unsigned> murmur3_partitioner_ignore_msb_bits;
+    named_value<string_list> single_shard_tables;
     named_value<double> unspooled_dirty_soft_limit;
+    named_value<uint32_t> unspooled_dirty_max_write_delay_in_ms;
     named_value<double> sstable_summary_ratio;
     named_value<size_t> large_memory_allocation_warning_threshold;
     named_value<bool> enable_deprecated_partitioners;
     named_value<bool> enable_keyspace_column_family_metrics;
     named_value<bool> enable_sstable_data_integrity_check;
     named_value<bool> enable_sstable_key_validation;
+    named_value<bool> enable_sstable_blocked_bloom_filter;
+    named_value<bool> enable_evictable_sstable_filters;
+    named_value<bool> enable_sstable_partition_trie_index;
+    named_value<bool> enable_sstable_row_index;
+    named_value<bool> enable_sstable_column_value_stats;
+    named_value<uint32_t> sstable_write_buffer_size_in_kb;
+    named_value<uint32_t> sstable_write_behind;
+    named_value<uint32_t> sstable_preallocation_size_in_mb;
+    named_value<uint32_t> sstable_write_sync_interval_in_mb;
     named_value<bool> cpu_scheduler;
     named_value<bool> view_building;
+    named_value<bool> coalesce_view_updates;
     named_value<bool> enable_sstables_mc_format;
     named_value<bool> enable_sstables_md_format;
     named_value<sstring> sstable_format;
@@ -342,8 +388,10 @@ class config : public utils::config_file {
     named_value<uint64_t> max_memory_for_unlimited_query_hard_limit;
     named_value<uint32_t> reader_concurrency_semaphore_serialize_limit_multiplier;
     named_value<uint32_t> reader_concurrency_semaphore_kill_limit_multiplier;
+    named_value<uint32_t> reader_concurrency_semaphore_scan_cost_limit;
     named_value<uint32_t> twcs_max_window_count;
     named_value<unsigned> initial_sstable_loading_concurrency;
+    named_value<bool> defer_sstable_filter_loading;
     named_value<bool> enable_3_1_0_compatibility_mode;
     named_value<bool> enable_user_defined_functions;
     named_value<unsigned> user_defined_function_time_limit_ms;
@@ -351,12 +399,21 @@ class config : public utils::config_file {
     named_value<unsigned> user_defined_function_contiguous_allocation_limit_bytes;
     named_value<uint32_t> schema_registry_grace_period;
     named_value<uint32_t> max_concurrent_requests_per_shard;
+    named_value<uint32_t> max_concurrent_requests_per_connection;
+    named_value<uint32_t> interactive_latency_target_ms;
+    named_value<sstring> tracing_backend;
+    named_value<uint32_t> hot_partitions_capacity;
+    named_value<uint32_t> hot_partitions_window_in_s;
+    named_value<uint32_t> cpu_profiler_frequency_hz;
     named_value<bool> cdc_dont_rewrite_streams;
+    named_value<uint32_t> cdc_preimage_cache_size;
     named_value<tri_mode_restriction> strict_allow_filtering;
     named_value<bool> reversed_reads_auto_bypass_cache;
     named_value<bool> enable_optimized_reversed_reads;
+    named_value<uint32_t> multi_partition_read_ahead;
     named_value<bool> enable_cql_config_updates;
     named_value<bool> enable_parallelized_aggregation;
+    named_value<uint32_t> secondary_index_base_query_concurrency;
 
     named_value<uint16_t> alternator_port;
     named_value<uint16_t> alternator_https_port;
@@ -366,6 +423,8 @@ class config : public utils::config_file {
     named_value<uint32_t> alternator_streams_time_window_s;
     named_value<uint32_t> alternator_timeout_in_ms;
     named_value<double> alternator_ttl_period_in_seconds;
+    named_value<uint32_t> alternator_ttl_scan_parallelism;
+    named_value<uint32_t> alternator_ttl_scan_rows_per_second;
 
     named_value<bool> abort_on_ebadf;
 
@@ -375,6 +434,7 @@ class config : public utils::config_file {
     named_value<sstring> redis_write_consistency_level;
     named_value<uint16_t> redis_database_count;
     named_value<string_map> redis_keyspace_replication_strategy_options;
+    named_value<bool> redis_in_memory_tables;
 
     named_value<bool> sanitizer_report_backtrace;
     named_value<bool> flush_schema_tables_after_modification;
@@ -395,6 +455,13 @@ class config : public utils::config_file {
     named_value<uint32_t> nodeops_heartbeat_interval_seconds;
 
     named_value<bool> cache_index_pages;
+    named_value<bool> cache_pack_narrow_rows;
+    named_value<bool> cache_admission_filter;
+    named_value<uint32_t> cache_absent_partitions_per_table;
+    named_value<uint32_t> partition_digest_cache_entries_per_table;
+    named_value<uint32_t> counter_shard_cache_entries_per_table;
+    named_value<bool> querier_cache_prefetch;
+    named_value<double> query_result_cache_memory_fraction;
 
     named_value<unsigned> x_log2_compaction_groups;
 
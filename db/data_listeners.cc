@@ -11,6 +11,8 @@
 #include "readers/filtering.hh"
 #include "db_clock.hh"
 
+#include <seastar/core/metrics.hh>
+
 #include <tuple>
 
 extern logging::logger dblog;
@@ -92,6 +94,76 @@ void toppartitions_data_listener::on_write(const schema_ptr& s, const frozen_mut
     }
 }
 
+hot_partitions_data_listener::hot_partitions_data_listener(replica::database& db, size_t capacity, std::chrono::seconds window)
+        : _db(db)
+        , _capacity(capacity)
+        , _window(std::chrono::duration_cast<lowres_clock::duration>(window))
+        , _window_end(lowres_clock::now() + _window)
+        , _current_read(capacity)
+        , _current_write(capacity)
+        , _last_read(capacity)
+        , _last_write(capacity) {
+    namespace sm = seastar::metrics;
+    _metrics.add_group("database", {
+        sm::make_gauge("hot_partition_reads", [this] { maybe_rotate(); return hottest_count(_last_read); },
+                       sm::description("Holds the number of reads of the most read partition of the shard in the last complete hot partitions window.")),
+        sm::make_gauge("hot_partition_writes", [this] { maybe_rotate(); return hottest_count(_last_write); },
+                       sm::description("Holds the number of writes of the most written partition of the shard in the last complete hot partitions window.")),
+    });
+    _db.data_listeners().install(this);
+}
+
+hot_partitions_data_listener::~hot_partitions_data_listener() {
+    _db.data_listeners().uninstall(this);
+}
+
+void hot_partitions_data_listener::maybe_rotate() {
+    auto now = lowres_clock::now();
+    if (now < _window_end) {
+        return;
+    }
+    if (now < _window_end + _window) {
+        _last_read = std::exchange(_current_read, top_k(_capacity));
+        _last_write = std::exchange(_current_write, top_k(_capacity));
+    } else {
+        // Nothing was recorded in the last complete window.
+        _last_read = top_k(_capacity);
+        _last_write = top_k(_capacity);
+        _current_read = top_k(_capacity);
+        _current_write = top_k(_capacity);
+    }
+    _window_end = now + _window;
+}
+
+uint64_t hot_partitions_data_listener::hottest_count(const top_k& top) {
+    auto res = top.top(1);
+    return res.empty() ? 0 : res.front().count;
+}
+
+flat_mutation_reader_v2 hot_partitions_data_listener::on_read(const schema_ptr& s, const dht::partition_range& range,
+        const query::partition_slice& slice, flat_mutation_reader_v2&& rd) {
+    if (query::is_single_partition(range)) {
+        maybe_rotate();
+        _current_read.append(toppartitions_item_key{s, range.start()->value().as_decorated_key()});
+    }
+    return std::move(rd);
+}
+
+void hot_partitions_data_listener::on_write(const schema_ptr& s, const frozen_mutation& m) {
+    maybe_rotate();
+    _current_write.append(toppartitions_item_key{s, m.decorated_key(*s)});
+}
+
+hot_partitions_data_listener::top_k::results hot_partitions_data_listener::top_reads(unsigned k) {
+    maybe_rotate();
+    return _last_read.top(k);
+}
+
+hot_partitions_data_listener::top_k::results hot_partitions_data_listener::top_writes(unsigned k) {
+    maybe_rotate();
+    return _last_write.top(k);
+}
+
 toppartitions_data_listener::global_top_k::results
 toppartitions_data_listener::globalize(top_k::results&& r) {
     toppartitions_data_listener::global_top_k::results n;
@@ -12,6 +12,8 @@
 #include <seastar/core/future.hh>
 #include <seastar/core/distributed.hh>
 #include <seastar/core/weak_ptr.hh>
+#include <seastar/core/lowres_clock.hh>
+#include <seastar/core/metrics_registration.hh>
 
 #include "utils/hash.hh"
 #include "schema/schema_fwd.hh"
@@ -139,6 +141,44 @@ class toppartitions_data_listener : public data_listener, public weakly_referenc
     future<> stop();
 };
 
+// Continuously keeps track of the hottest partitions of the shard, for reads
+// and writes separately, unlike toppartitions_data_listener which is
+// installed on demand for the duration of a toppartitions query.
+//
+// Only single partition reads are counted, by their key, so the reads are
+// not wrapped in a filtering reader. The counts are kept per window of time
+// and the results are the ones of the last complete window, so that a recent
+// hot key is not hidden by the history of the node.
+class hot_partitions_data_listener : public data_listener {
+public:
+    using top_k = toppartitions_data_listener::top_k;
+private:
+    replica::database& _db;
+    size_t _capacity;
+    lowres_clock::duration _window;
+    lowres_clock::time_point _window_end;
+    top_k _current_read;
+    top_k _current_write;
+    top_k _last_read;
+    top_k _last_write;
+    seastar::metrics::metric_groups _metrics;
+
+    void maybe_rotate();
+    static uint64_t hottest_count(const top_k&);
+public:
+    hot_partitions_data_listener(replica::database& db, size_t capacity, std::chrono::seconds window);
+    ~hot_partitions_data_listener();
+
+    virtual flat_mutation_reader_v2 on_read(const schema_ptr& s, const dht::partition_range& range,
+            const query::partition_slice& slice, flat_mutation_reader_v2&& rd) override;
+
+    virtual void on_write(const schema_ptr& s, const frozen_mutation& m) override;
+
+    // The k hottest partitions of the last complete window.
+    top_k::results top_reads(unsigned k);
+    top_k::results top_writes(unsigned k);
+};
+
 class toppartitions_query {
     distributed<replica::database>& _xdb;
     std::unordered_set<std::tuple<sstring, sstring>, utils::tuple_hash> _table_filters;
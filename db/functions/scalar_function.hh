@@ -26,6 +26,29 @@ class scalar_function : public virtual function {
      * @throws InvalidRequestException if this function cannot not be applied to the parameter
      */
     virtual bytes_opt execute(std::span<const bytes_opt> parameters) = 0;
+
+    /**
+     * Checks whether applying the function to many rows at once, with execute_batch(),
+     * is cheaper than calling execute() for each row.
+     */
+    virtual bool prefers_batch_execution() const {
+        return false;
+    }
+
+    /**
+     * Applies this function to each row of parameters.
+     *
+     * @param rows the input parameters, one vector per call
+     * @return the results, in the order of rows
+     */
+    virtual std::vector<bytes_opt> execute_batch(std::span<const std::vector<bytes_opt>> rows) {
+        std::vector<bytes_opt> results;
+        results.reserve(rows.size());
+        for (auto& parameters : rows) {
+            results.push_back(execute(parameters));
+        }
+        return results;
+    }
 };
 
 
@@ -15,9 +15,11 @@
 #include <seastar/core/abort_source.hh>
 #include <seastar/core/coroutine.hh>
 #include <seastar/coroutine/parallel_for_each.hh>
+#include <seastar/coroutine/as_future.hh>
 #include <boost/range/adaptors.hpp>
 #include "utils/div_ceil.hh"
 #include "db/extensions.hh"
+#include "db/config.hh"
 #include "service/storage_proxy.hh"
 #include "gms/versioned_value.hh"
 #include "gms/gossiper.hh"
@@ -77,6 +79,12 @@ void manager::register_metrics(const sstring& group_name) {
         sm::make_counter("sent", _stats.sent,
                         sm::description("Number of sent hints.")),
 
+        sm::make_counter("sent_batches", _stats.sent_batches,
+                        sm::description("Number of batches of hints sent to their destination Node at once.")),
+
+        sm::make_counter("coalesced", _stats.coalesced,
+                        sm::description("Number of hints merged into another hint for the same partition before being sent.")),
+
         sm::make_counter("discarded", _stats.discarded,
                         sm::description("Number of hints that were discarded during sending (too old, schema changed, etc.).")),
 
@@ -391,6 +399,13 @@ future<db::commitlog> manager::end_point_hints_manager::add_store() noexcept {
             cfg.commitlog_total_space_in_mb = resource_manager::max_hints_per_ep_size_mb;
             cfg.fname_prefix = manager::FILENAME_PREFIX;
             cfg.extensions = &_shard_manager.local_db().extensions();
+            const auto& db_cfg = _shard_manager.local_db().get_config();
+            try {
+                cfg.compression = commitlog_entry_compression_from_string(db_cfg.hints_compression());
+            } catch (std::invalid_argument& e) {
+                manager_logger.warn("Writing hints uncompressed: {}", e.what());
+            }
+            cfg.compression_threshold_in_bytes = uint64_t(db_cfg.hints_compression_threshold_in_kb()) * 1024;
 
             // HH leaves segments on disk after commitlog shutdown, and later reads
             // them when commitlog is re-created. This is expected to happen regularly
@@ -847,76 +862,178 @@ void manager::end_point_hints_manager::sender::start() {
     });
 }
 
-future<> manager::end_point_hints_manager::sender::send_one_mutation(frozen_mutation_and_schema m) {
-    replica::keyspace& ks = _db.find_keyspace(m.s->ks_name());
-    auto token = dht::get_token(*m.s, m.fm.key());
-    inet_address_vector_replica_set natural_endpoints = ks.get_effective_replication_map()->get_natural_endpoints(std::move(token));
-
-    return do_send_one_mutation(std::move(m), natural_endpoints);
+void manager::end_point_hints_manager::sender::on_hint_sent(send_one_file_ctx& ctx, db::replay_position rp, bool succeeded) noexcept {
+    // Information about the error was already printed somewhere higher.
+    // We just need to account in the ctx that sending of this hint has failed.
+    if (!succeeded) {
+        ctx.on_hint_send_failure(rp);
+        return;
+    }
+    ctx.on_hint_send_success(rp);
+    auto new_bound = ctx.get_replayed_bound();
+    // Segments from other shards are replayed first and are considered to be "before" replay position 0.
+    // Update the sent upper bound only if it is a local segment.
+    if (new_bound.shard_id() == this_shard_id() && _sent_upper_bound_rp < new_bound) {
+        _sent_upper_bound_rp = new_bound;
+        notify_replay_waiters();
+    }
 }
 
-future<> manager::end_point_hints_manager::sender::send_one_hint(lw_shared_ptr<send_one_file_ctx> ctx_ptr, fragmented_temporary_buffer buf, db::replay_position rp, gc_clock::duration secs_since_file_mod, const sstring& fname) {
-    return _resource_manager.get_send_units_for(buf.size_bytes()).then([this, secs_since_file_mod, &fname, buf = std::move(buf), rp, ctx_ptr] (auto units) mutable {
-        ctx_ptr->mark_hint_as_in_progress(rp);
+std::vector<frozen_mutation_and_schema> coalesce_hints(std::vector<frozen_mutation_and_schema> hints, uint64_t& coalesced) {
+    using partition_index = std::unordered_map<partition_key, size_t, partition_key::hashing, partition_key::equality>;
+    std::unordered_map<table_schema_version, partition_index> index;
+    std::vector<frozen_mutation_and_schema> result;
+    // Set once a second hint for the partition of the hint in result is found.
+    std::vector<std::optional<mutation>> merged;
+    result.reserve(hints.size());
+    merged.reserve(hints.size());
+
+    for (auto& h : hints) {
+        const schema& s = *h.s;
+        auto& partitions = index.try_emplace(s.version(), 0, partition_key::hashing(s), partition_key::equality(s)).first->second;
+        auto [it, inserted] = partitions.try_emplace(h.fm.key(), result.size());
+        if (inserted) {
+            result.push_back(std::move(h));
+            merged.emplace_back();
+            continue;
+        }
+        auto& m = merged[it->second];
+        if (!m) {
+            m = result[it->second].fm.unfreeze(result[it->second].s);
+        }
+        m->apply(h.fm.unfreeze(h.s));
+        ++coalesced;
+    }
 
-        // Future is waited on indirectly in `send_one_file()` (via `ctx_ptr->file_send_gate`).
-        (void)with_gate(ctx_ptr->file_send_gate, [this, secs_since_file_mod, &fname, buf = std::move(buf), rp, ctx_ptr] () mutable {
-            try {
-                auto m = this->get_mutation(ctx_ptr, buf);
-                gc_clock::duration gc_grace_sec = m.s->gc_grace_seconds();
-
-                // The hint is too old - drop it.
-                //
-                // Files are aggregated for at most manager::hints_timer_period therefore the oldest hint there is
-                // (last_modification - manager::hints_timer_period) old.
-                if (gc_clock::now().time_since_epoch() - secs_since_file_mod > gc_grace_sec - manager::hints_flush_period) {
-                    return make_ready_future<>();
-                }
+    for (size_t i = 0; i < result.size(); ++i) {
+        if (merged[i]) {
+            result[i].fm = freeze(*merged[i]);
+        }
+    }
+    return result;
+}
 
-                return this->send_one_mutation(std::move(m)).then([this, ctx_ptr] {
-                    ++this->shard_stats().sent;
-                }).handle_exception([this, ctx_ptr] (auto eptr) {
-                    manager_logger.trace("send_one_hint(): failed to send to {}: {}", end_point_key(), eptr);
-                    return make_exception_future<>(std::move(eptr));
-                });
+future<> manager::end_point_hints_manager::sender::do_send_hint_batch(lw_shared_ptr<send_one_file_ctx> ctx_ptr,
+        std::vector<std::pair<fragmented_temporary_buffer, db::replay_position>> hints, gc_clock::duration secs_since_file_mod, const sstring& fname) noexcept {
+    // Hints still going to the destination Node, sent to it all at once.
+    std::vector<frozen_mutation_and_schema> direct;
+    std::vector<db::replay_position> direct_rps;
+    // Hints sent to all their current replicas, each on its own.
+    std::vector<future<>> others;
+    std::vector<db::replay_position> others_rps;
 
-            // ignore these errors and move on - probably this hint is too old and the KS/CF has been deleted...
-            } catch (replica::no_such_column_family& e) {
-                manager_logger.debug("send_hints(): no_such_column_family: {}", e.what());
-                ++this->shard_stats().discarded;
-            } catch (replica::no_such_keyspace& e) {
-                manager_logger.debug("send_hints(): no_such_keyspace: {}", e.what());
-                ++this->shard_stats().discarded;
-            } catch (no_column_mapping& e) {
-                manager_logger.debug("send_hints(): {} at {}: {}", fname, rp, e.what());
-                ++this->shard_stats().discarded;
-            } catch (...) {
-                auto eptr = std::current_exception();
-                manager_logger.debug("send_hints(): unexpected error in file {} at {}: {}", fname, rp, eptr);
-                return make_exception_future<>(std::move(eptr));
+    for (auto& [buf, rp] : hints) {
+        try {
+            auto m = this->get_mutation(ctx_ptr, buf);
+            gc_clock::duration gc_grace_sec = m.s->gc_grace_seconds();
+
+            // The hint is too old - drop it.
+            //
+            // Files are aggregated for at most manager::hints_timer_period therefore the oldest hint there is
+            // (last_modification - manager::hints_timer_period) old.
+            if (gc_clock::now().time_since_epoch() - secs_since_file_mod > gc_grace_sec - manager::hints_flush_period) {
+                on_hint_sent(*ctx_ptr, rp, true);
+                continue;
             }
-            return make_ready_future<>();
-        }).then_wrapped([this, units = std::move(units), rp, ctx_ptr] (future<>&& f) {
-            // Information about the error was already printed somewhere higher.
-            // We just need to account in the ctx that sending of this hint has failed.
-            if (!f.failed()) {
-                ctx_ptr->on_hint_send_success(rp);
-                auto new_bound = ctx_ptr->get_replayed_bound();
-                // Segments from other shards are replayed first and are considered to be "before" replay position 0.
-                // Update the sent upper bound only if it is a local segment.
-                if (new_bound.shard_id() == this_shard_id() && _sent_upper_bound_rp < new_bound) {
-                    _sent_upper_bound_rp = new_bound;
-                    notify_replay_waiters();
-                }
+
+            replica::keyspace& ks = _db.find_keyspace(m.s->ks_name());
+            auto token = dht::get_token(*m.s, m.fm.key());
+            inet_address_vector_replica_set natural_endpoints = ks.get_effective_replication_map()->get_natural_endpoints(std::move(token));
+            if (boost::range::find(natural_endpoints, end_point_key()) != natural_endpoints.end()) {
+                direct.push_back(std::move(m));
+                direct_rps.push_back(rp);
             } else {
-                ctx_ptr->on_hint_send_failure(rp);
+                others.push_back(do_send_one_mutation(std::move(m), natural_endpoints));
+                others_rps.push_back(rp);
             }
-            f.ignore_ready_future();
-        });
-    }).handle_exception([ctx_ptr, rp] (auto eptr) {
-        manager_logger.trace("send_one_file(): Hmmm. Something bad had happend: {}", eptr);
-        ctx_ptr->on_hint_send_failure(rp);
-    });
+            continue;
+
+        // ignore these errors and move on - probably this hint is too old and the KS/CF has been deleted...
+        } catch (replica::no_such_column_family& e) {
+            manager_logger.debug("send_hints(): no_such_column_family: {}", e.what());
+            ++this->shard_stats().discarded;
+        } catch (replica::no_such_keyspace& e) {
+            manager_logger.debug("send_hints(): no_such_keyspace: {}", e.what());
+            ++this->shard_stats().discarded;
+        } catch (no_column_mapping& e) {
+            manager_logger.debug("send_hints(): {} at {}: {}", fname, rp, e.what());
+            ++this->shard_stats().discarded;
+        } catch (...) {
+            manager_logger.debug("send_hints(): unexpected error in file {} at {}: {}", fname, rp, std::current_exception());
+            on_hint_sent(*ctx_ptr, rp, false);
+            continue;
+        }
+        on_hint_sent(*ctx_ptr, rp, true);
+    }
+
+    if (direct.size() > 1 && _db.get_config().hints_coalesce_on_replay()) {
+        try {
+            direct = coalesce_hints(std::move(direct), this->shard_stats().coalesced);
+        } catch (...) {
+            manager_logger.debug("send_hint_batch(): failed to coalesce hints to {}: {}", end_point_key(), std::current_exception());
+            for (auto rp : direct_rps) {
+                on_hint_sent(*ctx_ptr, rp, false);
+            }
+            direct.clear();
+            direct_rps.clear();
+        }
+    }
+    if (!direct.empty()) {
+        manager_logger.trace("Sending {} hints directly to {}", direct.size(), end_point_key());
+        // The fact that we send with CL::ALL ensures that new hints are not going
+        // to be generated as a result of hints sending.
+        auto f = co_await coroutine::as_future(_proxy.send_hints_to_endpoint(std::move(direct), end_point_key()));
+        const bool succeeded = !f.failed();
+        if (succeeded) {
+            this->shard_stats().sent += direct_rps.size();
+            ++this->shard_stats().sent_batches;
+        } else {
+            manager_logger.trace("send_hint_batch(): failed to send to {}: {}", end_point_key(), f.get_exception());
+        }
+        for (auto rp : direct_rps) {
+            on_hint_sent(*ctx_ptr, rp, succeeded);
+        }
+    }
+    for (size_t i = 0; i < others.size(); ++i) {
+        auto f = co_await coroutine::as_future(std::move(others[i]));
+        const bool succeeded = !f.failed();
+        if (succeeded) {
+            ++this->shard_stats().sent;
+        } else {
+            manager_logger.trace("send_hint_batch(): failed to send to {}: {}", end_point_key(), f.get_exception());
+        }
+        on_hint_sent(*ctx_ptr, others_rps[i], succeeded);
+    }
+}
+
+future<> manager::end_point_hints_manager::sender::send_hint_batch(lw_shared_ptr<send_one_file_ctx> ctx_ptr, gc_clock::duration secs_since_file_mod, const sstring& fname) {
+    auto hints = std::exchange(ctx_ptr->pending_hints, {});
+    auto bytes = std::exchange(ctx_ptr->pending_hints_bytes, 0);
+    if (hints.empty()) {
+        co_return;
+    }
+    for (auto& h : hints) {
+        ctx_ptr->mark_hint_as_in_progress(h.second);
+    }
+
+    try {
+        try {
+            co_await _resource_manager.throttle(bytes, std::max(_db.get_token_metadata().count_normal_token_owners(), size_t(2)) - 1, _stop_as);
+        } catch (seastar::sleep_aborted&) {
+            // Stopping - either the batch is sent right away, for draining, or the next one won't be sent.
+        }
+        auto units = co_await _resource_manager.get_send_units_for(bytes);
+
+        // Future is waited on indirectly in `send_one_file()` (via `ctx_ptr->file_send_gate`).
+        (void)with_gate(ctx_ptr->file_send_gate, [this, ctx_ptr, hints = std::move(hints), secs_since_file_mod, &fname] () mutable {
+            return do_send_hint_batch(ctx_ptr, std::move(hints), secs_since_file_mod, fname);
+        }).finally([units = std::move(units)] {});
+    } catch (...) {
+        manager_logger.trace("send_one_file(): Hmmm. Something bad had happend: {}", std::current_exception());
+        for (auto& h : hints) {
+            ctx_ptr->on_hint_send_failure(h.second);
+        }
+    }
 }
 
 void manager::end_point_hints_manager::sender::notify_replay_waiters() noexcept {
@@ -1063,7 +1180,11 @@ bool manager::end_point_hints_manager::sender::send_one_file(const sstring& fnam
                     co_await sleep(std::chrono::milliseconds(100));
                     continue;
                 } else {
-                    co_await send_one_hint(ctx_ptr, std::move(buf), rp, secs_since_file_mod, fname);
+                    ctx_ptr->pending_hints_bytes += buf.size_bytes();
+                    ctx_ptr->pending_hints.emplace_back(std::move(buf), rp);
+                    if (ctx_ptr->pending_hints_bytes >= max_hint_batch_bytes || ctx_ptr->pending_hints.size() >= max_hint_batch_size) {
+                        co_await send_hint_batch(ctx_ptr, secs_since_file_mod, fname);
+                    }
                     break;
                 }
             };
@@ -1077,6 +1198,15 @@ bool manager::end_point_hints_manager::sender::send_one_file(const sstring& fnam
         ctx_ptr->segment_replay_failed = true;
     }
 
+    // Send the hints read since the last full batch, unless we are not going to send the following ones either.
+    if ((draining() || !ctx_ptr->segment_replay_failed) && can_send()) {
+        send_hint_batch(ctx_ptr, secs_since_file_mod, fname).get();
+    } else {
+        for (auto& h : std::exchange(ctx_ptr->pending_hints, {})) {
+            ctx_ptr->on_hint_send_failure(h.second);
+        }
+    }
+
     // wait till all background hints sending is complete
     ctx_ptr->file_send_gate.close().get();
 
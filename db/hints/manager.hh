@@ -44,6 +44,15 @@ namespace hints {
 using node_to_hint_store_factory_type = utils::loading_shared_values<gms::inet_address, db::commitlog>;
 using hints_store_ptr = node_to_hint_store_factory_type::entry_ptr;
 using hint_entry_reader = commitlog_entry_reader;
+
+/// \brief Merges the hints for the same partition into a single mutation.
+///
+/// Hints are kept in the order of the first hint of their partition. Hints of
+/// different schema versions are not merged.
+///
+/// \param hints hints to merge
+/// \param coalesced incremented by the number of hints merged into another one
+std::vector<frozen_mutation_and_schema> coalesce_hints(std::vector<frozen_mutation_and_schema> hints, uint64_t& coalesced);
 using timer_clock_type = seastar::lowres_clock;
 
 /// A helper class which tracks hints directory creation
@@ -73,6 +82,8 @@ class manager {
         uint64_t errors = 0;
         uint64_t dropped = 0;
         uint64_t sent = 0;
+        uint64_t sent_batches = 0;
+        uint64_t coalesced = 0;
         uint64_t discarded = 0;
         uint64_t corrupted_files = 0;
     };
@@ -118,6 +129,9 @@ class manager {
                 std::optional<db::replay_position> last_succeeded_rp;
                 std::set<db::replay_position> in_progress_rps;
                 bool segment_replay_failed = false;
+                // Hints read from the file but not sent yet, see send_hint_batch().
+                std::vector<std::pair<fragmented_temporary_buffer, db::replay_position>> pending_hints;
+                size_t pending_hints_bytes = 0;
 
                 void mark_hint_as_in_progress(db::replay_position rp);
                 void on_hint_send_success(db::replay_position rp) noexcept;
@@ -128,6 +142,11 @@ class manager {
             };
 
         private:
+            // Hints read from a file are sent in batches of up to this many bytes or hints.
+            // Hints of a batch going to the same replica are sent in a single rpc.
+            static constexpr size_t max_hint_batch_bytes = 128 * 1024;
+            static constexpr size_t max_hint_batch_size = 128;
+
             std::list<sstring> _segments_to_replay;
             // Segments to replay which were not created on this shard but were moved during rebalancing
             std::list<sstring> _foreign_segments_to_replay;
@@ -230,19 +249,29 @@ class manager {
                 return _ep_manager.replay_allowed();
             }
 
-            /// \brief Try to send one hint read from the file.
-            ///  - Limit the maximum memory size of hints "in the air" and the maximum total number of hints "in the air".
+            /// \brief Send the hints read from the file since the previous batch, in ctx_ptr->pending_hints.
+            ///  - Limit the maximum memory size of hints "in the air" and the maximum total number of batches "in the air".
+            ///  - Limit the rate of sending hints to hinted_handoff_throttle_in_kb.
             ///  - Discard the hints that are older than the grace seconds value of the corresponding table.
             ///
-            /// If sending fails we are going to set the state::segment_replay_failed in the _state and _first_failed_rp will be updated to min(_first_failed_rp, \ref rp).
+            /// The hints are sent in the background, so that the next batch is read while this one is sent.
+            /// Hints still going to the destination Node are sent to it all at once, the others to all their
+            /// current replicas.
+            ///
+            /// If sending fails we are going to set the state::segment_replay_failed in the _state and _first_failed_rp will be updated to min(_first_failed_rp, replay position of the hint).
             ///
             /// \param ctx_ptr shared pointer to the file sending context
-            /// \param buf buffer representing the hint
-            /// \param rp replay position of this hint in the file (see commitlog for more details on "replay position")
             /// \param secs_since_file_mod last modification time stamp (in seconds since Epoch) of the current hints file
-            /// \param fname name of the hints file this hint was read from
-            /// \return future that resolves when next hint may be sent
-            future<> send_one_hint(lw_shared_ptr<send_one_file_ctx> ctx_ptr, fragmented_temporary_buffer buf, db::replay_position rp, gc_clock::duration secs_since_file_mod, const sstring& fname);
+            /// \param fname name of the hints file the hints were read from
+            /// \return future that resolves when next batch may be sent
+            future<> send_hint_batch(lw_shared_ptr<send_one_file_ctx> ctx_ptr, gc_clock::duration secs_since_file_mod, const sstring& fname);
+
+            /// \brief Sends the given hints, and accounts for the outcome of each one in ctx_ptr.
+            future<> do_send_hint_batch(lw_shared_ptr<send_one_file_ctx> ctx_ptr, std::vector<std::pair<fragmented_temporary_buffer, db::replay_position>> hints,
+                    gc_clock::duration secs_since_file_mod, const sstring& fname) noexcept;
+
+            /// \brief Accounts in ctx_ptr for the outcome of sending the hint at rp.
+            void on_hint_sent(send_one_file_ctx& ctx, db::replay_position rp, bool succeeded) noexcept;
 
             /// \brief Send all hint from a single file and delete it after it has been successfully sent.
             /// Send all hints from the given file. If we failed to send the current segment we will pick up in the next
@@ -279,12 +308,6 @@ class manager {
             /// \return future that resolves when the operation is complete
             future<> do_send_one_mutation(frozen_mutation_and_schema m, const inet_address_vector_replica_set& natural_endpoints) noexcept;
 
-            /// \brief Send one mutation out.
-            ///
-            /// \param m mutation to send
-            /// \return future that resolves when the mutation sending processing is complete.
-            future<> send_one_mutation(frozen_mutation_and_schema m);
-
             /// \brief Notifies replay waiters for which the target replay position was reached.
             void notify_replay_waiters() noexcept;
 
@@ -59,6 +59,30 @@ size_t resource_manager::sending_queue_length() const {
     return _send_limiter.waiters();
 }
 
+resource_manager::clock_type::duration resource_manager::consume_send_bandwidth(size_t buf_size, size_t nodes_sending, clock_type::time_point now) noexcept {
+    const uint32_t throttle_in_kb = _throttle_in_kb();
+    if (!throttle_in_kb) {
+        return clock_type::duration::zero();
+    }
+    const double rate = double(throttle_in_kb) * 1024 / std::max(nodes_sending, size_t(1));
+    const auto elapsed = std::chrono::duration<double>(now - _last_refill).count();
+    _last_refill = now;
+    _send_tokens = std::min(_send_tokens + elapsed * rate, rate) - buf_size;
+    if (_send_tokens >= 0) {
+        return clock_type::duration::zero();
+    }
+    return std::chrono::duration_cast<clock_type::duration>(std::chrono::duration<double>(-_send_tokens / rate));
+}
+
+future<> resource_manager::throttle(size_t buf_size, size_t nodes_sending, abort_source& as) {
+    auto delay = consume_send_bandwidth(buf_size, nodes_sending, clock_type::now());
+    if (delay <= clock_type::duration::zero()) {
+        return make_ready_future<>();
+    }
+    resource_manager_logger.trace("throttling hints sending for {} bytes: sleeping for {}", buf_size, std::chrono::duration_cast<std::chrono::milliseconds>(delay));
+    return sleep_abortable(delay, as);
+}
+
 const std::chrono::seconds space_watchdog::_watchdog_period = std::chrono::seconds(1);
 
 space_watchdog::space_watchdog(shard_managers_set& managers, per_device_limits_map& per_device_limits_map)
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <cstdint>
 #include <filesystem>
 #include <seastar/core/abort_source.hh>
@@ -116,9 +117,16 @@ class space_watchdog {
 };
 
 class resource_manager {
+    using clock_type = std::chrono::steady_clock;
+
     const size_t _max_send_in_flight_memory;
     utils::updateable_value<uint32_t> _max_hints_send_queue_length;
     seastar::named_semaphore _send_limiter;
+    // Bucket of the bytes of hints this shard may send, refilled at
+    // hinted_handoff_throttle_in_kb, see throttle().
+    utils::updateable_value<uint32_t> _throttle_in_kb;
+    double _send_tokens = 0;
+    clock_type::time_point _last_refill;
 
     seastar::named_semaphore _operation_lock;
     space_watchdog::shard_managers_set _shard_managers;
@@ -166,10 +174,12 @@ class resource_manager {
     static constexpr size_t default_per_shard_concurrency_limit = 8;
 
 public:
-    resource_manager(size_t max_send_in_flight_memory, utils::updateable_value<uint32_t> max_hint_sending_concurrency)
+    resource_manager(size_t max_send_in_flight_memory, utils::updateable_value<uint32_t> max_hint_sending_concurrency,
+            utils::updateable_value<uint32_t> throttle_in_kb = utils::updateable_value<uint32_t>(0))
         : _max_send_in_flight_memory(max_send_in_flight_memory)
         , _max_hints_send_queue_length(std::move(max_hint_sending_concurrency))
         , _send_limiter(_max_send_in_flight_memory, named_semaphore_exception_factory{"send limiter"})
+        , _throttle_in_kb(std::move(throttle_in_kb))
         , _operation_lock(1, named_semaphore_exception_factory{"operation lock"})
         , _space_watchdog(_shard_managers, _per_device_limits_map)
     {}
@@ -180,6 +190,15 @@ class resource_manager {
     future<semaphore_units<named_semaphore::exception_factory>> get_send_units_for(size_t buf_size);
     size_t sending_queue_length() const;
 
+    /// \brief Returns how long to wait before sending buf_size bytes of hints, for this shard to send
+    /// at most hinted_handoff_throttle_in_kb per second, shared with the other nodes_sending nodes
+    /// which are expected to replay hints at the same time. Up to a second worth of bytes is kept
+    /// while no hints are sent.
+    clock_type::duration consume_send_bandwidth(size_t buf_size, size_t nodes_sending, clock_type::time_point now) noexcept;
+
+    /// \brief Waits as consume_send_bandwidth() says, or until as is triggered.
+    future<> throttle(size_t buf_size, size_t nodes_sending, seastar::abort_source& as);
+
     future<> start(shared_ptr<service::storage_proxy> proxy_ptr, shared_ptr<gms::gossiper> gossiper_ptr);
     future<> stop() noexcept;
 
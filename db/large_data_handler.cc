@@ -8,6 +8,7 @@
 
 #include <seastar/core/print.hh>
 #include <seastar/core/coroutine.hh>
+#include <seastar/core/loop.hh>
 #include "db/system_keyspace.hh"
 #include "db/large_data_handler.hh"
 #include "sstables/sstables.hh"
@@ -132,8 +133,43 @@ cql_table_large_data_handler::cql_table_large_data_handler(gms::feature_service&
     , _cell_threshold_mb_updater(_cell_threshold_bytes, std::move(cell_threshold_mb), [] (uint32_t threshold_mb) { return uint64_t(threshold_mb) * MB; })
     , _rows_count_threshold_updater(_rows_count_threshold, std::move(rows_count_threshold))
     , _collection_elements_count_threshold_updater(_collection_elements_count_threshold, std::move(collection_elements_count_threshold))
+    , _write_pending_records([this] { return write_pending_records(); })
 {}
 
+future<> cql_table_large_data_handler::stop() {
+    co_await large_data_handler::stop();
+    co_await _write_pending_records.join();
+}
+
+future<> cql_table_large_data_handler::write_pending_records() {
+    auto records = std::exchange(_pending_records, {});
+    _pending_record_index.clear();
+    auto sys_ks = _sys_ks;
+    if (!sys_ks || records.empty()) {
+        co_return;
+    }
+    large_data_logger.debug("Writing {} large data records", records.size());
+    co_await max_concurrent_for_each(records, max_concurrent_writes, [&sys_ks] (pending_record& r) {
+        return futurize_invoke(r.write, *sys_ks).handle_exception([&r] (std::exception_ptr ep) {
+            large_data_logger.warn("Failed to add a record to system.large_{}s: sst = {} exception = {}",
+                    r.large_table, r.sstable_name, ep);
+        });
+    });
+}
+
+void cql_table_large_data_handler::drop_pending_records(const sstring& sstable_name) const {
+    auto n = std::erase_if(_pending_records, [&sstable_name] (const pending_record& r) {
+        return r.sstable_name == sstable_name;
+    });
+    if (n) {
+        large_data_logger.debug("Dropped {} pending large data records of {}", n, sstable_name);
+        _pending_record_index.clear();
+        for (size_t i = 0; i < _pending_records.size(); ++i) {
+            _pending_record_index.emplace(_pending_records[i].key, i);
+        }
+    }
+}
+
 template <typename... Args>
 future<> cql_table_large_data_handler::try_record(std::string_view large_table, const sstables::sstable& sst,  const sstables::key& partition_key, int64_t size,
         std::string_view desc, std::string_view extra_path, const std::vector<sstring> &extra_fields, Args&&... args) const {
@@ -156,13 +192,28 @@ future<> cql_table_large_data_handler::try_record(std::string_view large_table,
     std::string pk_str = key_to_str(partition_key.to_partition_key(s), s);
     auto timestamp = db_clock::now();
     large_data_logger.warn("Writing large {} {}/{}: {}{} ({} bytes) to {}", desc, ks_name, cf_name, pk_str, extra_path, size, sstable_name);
-    return _sys_ks->execute_cql(req, ks_name, cf_name, sstable_name, size, pk_str, timestamp, args...)
-            .discard_result()
-            .handle_exception([ks_name, cf_name, large_table, sstable_name] (std::exception_ptr ep) {
-                large_data_logger.warn("Failed to add a record to system.large_{}s: ks = {}, table = {}, sst = {} exception = {}",
-                        large_table, ks_name, cf_name, sstable_name, ep);
-            })
-            .finally([ p = _sys_ks ] {});
+    auto key = format("{}/{}/{}{}", large_table, sstable_name, pk_str, extra_path);
+    auto write = [req, ks_name, cf_name, sstable_name, size, pk_str, timestamp, ...args = std::forward<Args>(args)] (db::system_keyspace& sys_ks) {
+        return sys_ks.execute_cql(req, ks_name, cf_name, sstable_name, size, pk_str, timestamp, args...).discard_result();
+    };
+
+    auto [it, inserted] = _pending_record_index.try_emplace(key, _pending_records.size());
+    if (!inserted) {
+        auto& r = _pending_records[it->second];
+        if (r.size < size) {
+            r.size = size;
+            r.write = std::move(write);
+        }
+        return make_ready_future<>();
+    }
+    _pending_records.push_back(pending_record{std::move(key), sstable_name, large_table, size, std::move(write)});
+    auto f = _write_pending_records.trigger();
+    if (_pending_records.size() >= max_pending_records) {
+        return f;
+    }
+    // Written in the background, stop() waits for it.
+    (void)f;
+    return make_ready_future<>();
 }
 
 future<> cql_table_large_data_handler::record_large_partitions(const sstables::sstable& sst, const sstables::key& key, uint64_t partition_size, uint64_t rows) const {
@@ -218,17 +269,23 @@ future<> cql_table_large_data_handler::record_large_rows(const sstables::sstable
 
 future<> cql_table_large_data_handler::delete_large_data_entries(const schema& s, sstring sstable_name, std::string_view large_table_name) const {
     assert(_sys_ks);
+    auto sys_ks = _sys_ks;
+    auto schema = s.shared_from_this();
+    // The records of the sstable not written yet are stale, and the ones
+    // being written must not outlive the deletion.
+    drop_pending_records(sstable_name);
+    co_await _write_pending_records.join();
+
     const sstring req =
             format("DELETE FROM system.{} WHERE keyspace_name = ? AND table_name = ? AND sstable_name = ?",
                     large_table_name);
     large_data_logger.debug("Dropping entries from {}: ks = {}, table = {}, sst = {}",
-            large_table_name, s.ks_name(), s.cf_name(), sstable_name);
-    return _sys_ks->execute_cql(req, s.ks_name(), s.cf_name(), sstable_name)
-            .discard_result()
-            .handle_exception([&s, sstable_name, large_table_name] (std::exception_ptr ep) {
-                large_data_logger.warn("Failed to drop entries from {}: ks = {}, table = {}, sst = {} exception = {}",
-                        large_table_name, s.ks_name(), s.cf_name(), sstable_name, ep);
-            })
-            .finally([ p = _sys_ks ] {});
+            large_table_name, schema->ks_name(), schema->cf_name(), sstable_name);
+    try {
+        co_await sys_ks->execute_cql(req, schema->ks_name(), schema->cf_name(), sstable_name);
+    } catch (...) {
+        large_data_logger.warn("Failed to drop entries from {}: ks = {}, table = {}, sst = {} exception = {}",
+                large_table_name, schema->ks_name(), schema->cf_name(), sstable_name, std::current_exception());
+    }
 }
 }
@@ -9,10 +9,13 @@
 #pragma once
 
 #include <cstdint>
+#include <unordered_map>
+#include <seastar/util/noncopyable_function.hh>
 #include "schema/schema_fwd.hh"
 #include "system_keyspace.hh"
 #include "sstables/shared_sstable.hh"
 #include "utils/updateable_value.hh"
+#include "utils/serialized_action.hh"
 
 namespace sstables {
 class sstable;
@@ -74,7 +77,7 @@ class large_data_handler {
     // Once large_data_handler is stopped no further updates will be accepted.
     bool running() const { return _running; }
     void start();
-    future<> stop();
+    virtual future<> stop();
 
     future<bool> maybe_record_large_rows(const sstables::sstable& sst, const sstables::key& partition_key,
             const clustering_key_prefix* clustering_key, uint64_t row_size) {
@@ -155,6 +158,26 @@ class cql_table_large_data_handler : public large_data_handler {
     threshold_updater _cell_threshold_mb_updater;
     threshold_updater _rows_count_threshold_updater;
     threshold_updater _collection_elements_count_threshold_updater;
+
+    // Records are not written to the system tables as they are found, which
+    // would make the sstable writer wait for the writes when there are many.
+    // They are queued instead and written in the background: a write takes
+    // all the records queued since the previous one. The writer is slowed
+    // down only if max_pending_records are queued.
+    struct pending_record {
+        sstring key;
+        sstring sstable_name;
+        std::string_view large_table;
+        int64_t size;
+        noncopyable_function<future<> (db::system_keyspace&)> write;
+    };
+    static constexpr size_t max_pending_records = 1024;
+    static constexpr size_t max_concurrent_writes = 16;
+    mutable std::vector<pending_record> _pending_records;
+    // Queued records by the partition, row or cell they describe, so that
+    // each is recorded once per sstable, with the largest size seen.
+    mutable std::unordered_map<sstring, size_t> _pending_record_index;
+    mutable serialized_action _write_pending_records;
 public:
     explicit cql_table_large_data_handler(gms::feature_service& feat,
             utils::updateable_value<uint32_t> partition_threshold_mb,
@@ -163,6 +186,8 @@ class cql_table_large_data_handler : public large_data_handler {
             utils::updateable_value<uint32_t> rows_count_threshold,
             utils::updateable_value<uint32_t> collection_elements_count_threshold);
 
+    virtual future<> stop() override;
+
 protected:
     virtual future<> record_large_partitions(const sstables::sstable& sst, const sstables::key& partition_key, uint64_t partition_size, uint64_t rows) const override;
     virtual future<> delete_large_data_entries(const schema& s, sstring sstable_name, std::string_view large_table_name) const override;
@@ -177,6 +202,9 @@ class cql_table_large_data_handler : public large_data_handler {
             const clustering_key_prefix* clustering_key, const column_definition& cdef, uint64_t cell_size, uint64_t collection_elements) const;
 
 private:
+    future<> write_pending_records();
+    void drop_pending_records(const sstring& sstable_name) const;
+
     template <typename... Args>
     future<> try_record(std::string_view large_table, const sstables::sstable& sst,  const sstables::key& partition_key, int64_t size,
             std::string_view desc, std::string_view extra_path, const std::vector<sstring> &extra_fields, Args&&... args) const;
@@ -39,6 +39,13 @@
 // time window. This strategy is also known as "lossy counting".
 //
 // Both mechanisms 1) and 2) are implemented in a lazy manner.
+//
+// The hashmap has a fixed size, so with many active partitions an operation
+// may find no entry to use. Such operations are counted in a count-min sketch
+// instead, which is halved on every time window change like the hashmap.
+// The sketch never underestimates, so a hot partition is limited even if it
+// cannot get an entry; the price is that a cold one may be overestimated and
+// throttled if it shares all its counters with hot ones.
 
 namespace db {
 
@@ -60,6 +67,8 @@ void rate_limiter_base::on_timer() noexcept {
 
     _current_time_window = (_current_time_window + 1) % (1 << time_window_bits);
 
+    _overflow_sketch.decay();
+
     // Because time window ids are 12 bit numbers and we increase the current
     // time window number by 1 every second, it wraps around every 4096
     // seconds (more than an hour). Because of this, some very old entry
@@ -84,7 +93,54 @@ void rate_limiter_base::on_timer() noexcept {
     }
 }
 
-rate_limiter_base::entry* rate_limiter_base::get_entry(uint32_t label, uint64_t token) noexcept {
+frequency_sketch::frequency_sketch(uint32_t max_count)
+        : _counters(depth * width)
+        , _max_count(max_count) {
+}
+
+size_t frequency_sketch::counter_index(uint64_t hash, size_t row) const noexcept {
+    // Derive the index in each row from two halves of the hash (the
+    // double hashing scheme of Kirsch and Mitzenmacher). Skip the lowest
+    // bits, which the rate limiter already uses to index its hashmap.
+    const uint64_t h1 = hash >> 16;
+    const uint64_t h2 = (hash >> 40) | 1;
+    return row * width + ((h1 + row * h2) & (width - 1));
+}
+
+uint32_t frequency_sketch::increase_and_estimate(uint64_t hash) noexcept {
+    std::array<uint32_t*, depth> counters;
+    uint32_t count = _max_count;
+    for (size_t row = 0; row < depth; row++) {
+        counters[row] = &_counters[counter_index(hash, row)];
+        count = std::min(count, *counters[row]);
+    }
+    // Conservative update: only raise the counters which are below the
+    // new estimate. The others already account for other keys, and raising
+    // them would only increase the overestimation for those.
+    if (count < _max_count) {
+        ++count;
+    }
+    for (auto* c : counters) {
+        *c = std::max(*c, count);
+    }
+    return count;
+}
+
+uint32_t frequency_sketch::estimate(uint64_t hash) const noexcept {
+    uint32_t count = _max_count;
+    for (size_t row = 0; row < depth; row++) {
+        count = std::min(count, _counters[counter_index(hash, row)]);
+    }
+    return count;
+}
+
+void frequency_sketch::decay() noexcept {
+    for (auto& c : _counters) {
+        c /= 2;
+    }
+}
+
+rate_limiter_base::entry* rate_limiter_base::get_entry(uint32_t label, uint64_t token, size_t hash) noexcept {
     // We need to either find the existing entry for this (label, token) combination
     // or otherwise find an invalid entry which we can initialize and use.
     //
@@ -111,8 +167,6 @@ rate_limiter_base::entry* rate_limiter_base::get_entry(uint32_t label, uint64_t
     // probe chain, so this situation will happen a limited number of times (if
     // any at all) for a single "hot" entry.
 
-    size_t hash = compute_hash(label, token);
-
     static constexpr size_t max_probes = 32;
     for (size_t i = 0; i < max_probes; i++) {
         // Quadratic probing - every iteration jumps further than the previous one
@@ -211,6 +265,9 @@ void rate_limiter_base::register_metrics() {
         sm::make_counter("probe_count", _metrics.probe_count,
                 sm::description("Number of probes made during lookups.")),
 
+        sm::make_counter("sketch_estimates", _metrics.sketch_estimates,
+                sm::description("Number of times the operation count was estimated with the sketch, because no entry could be allocated.")),
+
         sm::make_gauge("load_factor", [&] {
                     uint32_t occupied_entry_count = _current_entries_in_time_window;
                     for (const auto& twe : _time_window_history) {
@@ -225,8 +282,9 @@ void rate_limiter_base::register_metrics() {
 rate_limiter_base::rate_limiter_base()
         : _salt(std::random_device{}())
         , _entries(entry_count)
-        , _time_window_history(op_count_bits - 1) {
-    
+        , _time_window_history(op_count_bits - 1)
+        , _overflow_sketch((1 << op_count_bits) - 1) {
+
     register_metrics();
 }
 
@@ -236,12 +294,13 @@ uint64_t rate_limiter_base::increase_and_get_counter(label& l, uint64_t token) n
         l._label = _next_label++;
     }
 
-    entry* b = get_entry(l._label, token);
+    const size_t hash = compute_hash(l._label, token);
+    entry* b = get_entry(l._label, token, hash);
     if (!b) {
-        // We failed to allocate a entry for this partition. This means that
-        // we won't track hit count for this partition during this time window.
-        // Assume that it's OK to admit the operation.
-        return 0;
+        // We failed to allocate a entry for this partition. Count it
+        // in the sketch, which may overestimate but has room for all.
+        ++_metrics.sketch_estimates;
+        return _overflow_sketch.increase_and_estimate(hash);
     }
 
     // Protect from wrap-around
@@ -32,6 +32,35 @@
 
 namespace db {
 
+// A count-min sketch with conservative update: a fixed-size table of
+// counters which estimates how many times each key (given by its hash)
+// was counted, no matter how many distinct keys there are. An estimate
+// is never below the real count. It is above it only if every counter
+// of the key is shared with other keys, which are more active.
+class frequency_sketch {
+public:
+    static constexpr size_t depth = 4;
+    static constexpr size_t width_bits = 14;
+    static constexpr size_t width = 1 << width_bits;
+
+private:
+    std::vector<uint32_t> _counters;
+    const uint32_t _max_count;
+
+    size_t counter_index(uint64_t hash, size_t row) const noexcept;
+
+public:
+    explicit frequency_sketch(uint32_t max_count);
+
+    // Increments the count of the key and returns its new estimate.
+    uint32_t increase_and_estimate(uint64_t hash) noexcept;
+
+    uint32_t estimate(uint64_t hash) const noexcept;
+
+    // Halves all the counts.
+    void decay() noexcept;
+};
+
 class rate_limiter_base {
 public:
     static constexpr size_t op_count_bits = 20;
@@ -43,6 +72,7 @@ class rate_limiter_base {
         uint64_t successful_lookups = 0;
         uint64_t failed_allocations = 0;
         uint64_t probe_count = 0;
+        uint64_t sketch_estimates = 0;
     };
 
     // Represents a piece of the hashmap storage.
@@ -106,11 +136,14 @@ class rate_limiter_base {
     utils::chunked_vector<entry> _entries;
     std::vector<time_window_entry> _time_window_history;
 
+    // Counts the operations for which no entry could be allocated.
+    frequency_sketch _overflow_sketch;
+
     metrics _metrics;
     seastar::metrics::metric_groups _metric_group;
 
 private:
-    entry* get_entry(uint32_t label, uint64_t token) noexcept;
+    entry* get_entry(uint32_t label, uint64_t token, size_t hash) noexcept;
     size_t compute_hash(uint32_t label, uint64_t token) noexcept;
 
     void entry_refresh(entry& b) noexcept;
@@ -104,9 +104,14 @@ schema_ctxt::schema_ctxt(const db::config& cfg, std::shared_ptr<data_dictionary:
     : _extensions(cfg.extensions())
     , _murmur3_partitioner_ignore_msb_bits(cfg.murmur3_partitioner_ignore_msb_bits())
     , _schema_registry_grace_period(cfg.schema_registry_grace_period())
+    , _single_shard_tables(cfg.single_shard_tables().begin(), cfg.single_shard_tables().end())
     , _user_types(std::move(uts))
 {}
 
+bool schema_ctxt::is_single_shard_table(std::string_view ks_name, std::string_view cf_name) const {
+    return !_single_shard_tables.empty() && _single_shard_tables.contains(format("{}.{}", ks_name, cf_name));
+}
+
 schema_ctxt::schema_ctxt(const replica::database& db)
     : schema_ctxt(db.get_config(), db.as_user_types_storage())
 {}
@@ -906,6 +911,47 @@ read_keyspace_mutation(distributed<service::storage_proxy>& proxy, const sstring
     co_return co_await query_partition_mutation(proxy.local(), std::move(s), std::move(cmd), std::move(key));
 }
 
+future<std::vector<canonical_mutation>> convert_schema_to_mutations(distributed<service::storage_proxy>& proxy, schema_features features,
+        const std::optional<sstring>& start_after, size_t max_keyspaces)
+{
+    // Every schema table is partitioned by keyspace name, so the names found in
+    // `keyspaces` (including the tombstoned partitions of dropped keyspaces) cover them all.
+    std::vector<sstring> keyspace_names;
+    {
+        auto rs = co_await db::system_keyspace::query_mutations(proxy, NAME, KEYSPACES);
+        auto s = keyspaces();
+        for (auto&& p : rs->partitions()) {
+            auto mut = p.mut().unfreeze(s);
+            auto name = value_cast<sstring>(utf8_type->deserialize(mut.key().get_component(*s, 0)));
+            if (is_system_keyspace(name) || (start_after && name <= *start_after)) {
+                continue;
+            }
+            keyspace_names.push_back(std::move(name));
+        }
+    }
+    std::sort(keyspace_names.begin(), keyspace_names.end());
+    if (keyspace_names.size() > max_keyspaces) {
+        keyspace_names.resize(max_keyspaces);
+    }
+
+    std::vector<canonical_mutation> results;
+    for (auto&& table : all_table_names(features)) {
+        auto s = proxy.local().get_db().local().find_schema(NAME, table);
+        for (auto&& keyspace_name : keyspace_names) {
+            auto key = partition_key::from_singular(*s, keyspace_name);
+            auto slice = s->full_slice();
+            auto cmd = make_lw_shared<query::read_command>(s->id(), s->version(), std::move(slice), proxy.local().get_max_result_size(slice), query::tombstone_limit::max);
+            auto mut = co_await query_partition_mutation(proxy.local(), s, std::move(cmd), std::move(key));
+            if (mut.partition().empty()) {
+                continue;
+            }
+            mut = redact_columns_for_missing_features(std::move(mut), features);
+            results.emplace_back(mut);
+        }
+    }
+    co_return results;
+}
+
 static thread_local semaphore the_merge_lock {1};
 
 future<> merge_lock() {
@@ -1389,30 +1435,49 @@ enum class schema_diff_side {
     right, // new, after
 };
 
-static schema_diff diff_table_or_view(distributed<service::storage_proxy>& proxy,
+// Yields between entries, since altering a type used by many tables, or merging
+// the schema of a node that was down for a while, can diff thousands of them.
+static future<schema_diff> diff_table_or_view(distributed<service::storage_proxy>& proxy,
     std::map<table_id, schema_mutations>&& before,
     std::map<table_id, schema_mutations>&& after,
     noncopyable_function<schema_ptr (schema_mutations sm, schema_diff_side)> create_schema)
 {
     schema_diff d;
-    auto diff = difference(before, after);
-    for (auto&& key : diff.entries_only_on_left) {
-        auto&& s = proxy.local().get_db().local().find_schema(key);
-        slogger.info("Dropping {}.{} id={} version={}", s->ks_name(), s->cf_name(), s->id(), s->version());
-        d.dropped.emplace_back(schema_diff::dropped_schema{s});
-    }
-    for (auto&& key : diff.entries_only_on_right) {
-        auto s = create_schema(std::move(after.at(key)), schema_diff_side::right);
-        slogger.info("Creating {}.{} id={} version={}", s->ks_name(), s->cf_name(), s->id(), s->version());
-        d.created.emplace_back(s);
-    }
-    for (auto&& key : diff.entries_differing) {
-        auto s_before = create_schema(std::move(before.at(key)), schema_diff_side::left);
+    std::vector<table_id> differing;
+    for (auto&& [key, sm_before] : before) {
+        auto it = after.find(key);
+        if (it == after.end()) {
+            auto&& s = proxy.local().get_db().local().find_schema(key);
+            slogger.info("Dropping {}.{} id={} version={}", s->ks_name(), s->cf_name(), s->id(), s->version());
+            d.dropped.emplace_back(schema_diff::dropped_schema{s});
+        } else if (!(sm_before == it->second)) {
+            differing.push_back(key);
+        }
+        co_await coroutine::maybe_yield();
+    }
+    for (auto&& [key, sm_after] : after) {
+        if (!before.contains(key)) {
+            auto s = create_schema(std::move(sm_after), schema_diff_side::right);
+            slogger.info("Creating {}.{} id={} version={}", s->ks_name(), s->cf_name(), s->id(), s->version());
+            d.created.emplace_back(s);
+        }
+        co_await coroutine::maybe_yield();
+    }
+    for (auto&& key : differing) {
+        // The schema we have is normally the one described by the old mutations,
+        // so reuse it instead of building the same schema again.
+        auto& db = proxy.local().get_db().local();
+        schema_ptr s_before = db.column_family_exists(key) ? db.find_schema(key) : nullptr;
+        auto& sm_before = before.at(key);
+        if (!s_before || s_before->version() != sm_before.digest()) {
+            s_before = create_schema(std::move(sm_before), schema_diff_side::left);
+        }
         auto s = create_schema(std::move(after.at(key)), schema_diff_side::right);
         slogger.info("Altering {}.{} id={} version={}", s->ks_name(), s->cf_name(), s->id(), s->version());
         d.altered.emplace_back(schema_diff::altered_schema{s_before, s});
+        co_await coroutine::maybe_yield();
     }
-    return d;
+    co_return d;
 }
 
 // see the comments for merge_keyspaces()
@@ -1426,10 +1491,21 @@ static future<> merge_tables_and_views(distributed<service::storage_proxy>& prox
     std::map<table_id, schema_mutations>&& views_before,
     std::map<table_id, schema_mutations>&& views_after)
 {
-    auto tables_diff = diff_table_or_view(proxy, std::move(tables_before), std::move(tables_after), [&] (schema_mutations sm, schema_diff_side) {
+    auto tables_diff = co_await diff_table_or_view(proxy, std::move(tables_before), std::move(tables_after), [&] (schema_mutations sm, schema_diff_side) {
         return create_table_from_mutations(proxy, std::move(sm));
     });
-    auto views_diff = diff_table_or_view(proxy, std::move(views_before), std::move(views_after), [&] (schema_mutations sm, schema_diff_side side) {
+    // Base tables changed by this merge, by (keyspace, table) name, so that views
+    // do not have to scan tables_diff, which can be large (e.g. on alter type).
+    std::map<std::pair<std::string_view, std::string_view>, std::pair<schema_ptr, schema_ptr>> changed_tables;
+    for (auto&& altered : tables_diff.altered) {
+        schema_ptr s = altered.new_schema;
+        changed_tables.emplace(std::pair(std::string_view(s->ks_name()), std::string_view(s->cf_name())), std::pair(altered.old_schema.get(), s));
+    }
+    for (auto&& gs : tables_diff.created) {
+        schema_ptr s = gs;
+        changed_tables.emplace(std::pair(std::string_view(s->ks_name()), std::string_view(s->cf_name())), std::pair(s, s));
+    }
+    auto views_diff = co_await diff_table_or_view(proxy, std::move(views_before), std::move(views_after), [&] (schema_mutations sm, schema_diff_side side) {
         // The view schema mutation should be created with reference to the base table schema because we definitely know it by now.
         // If we don't do it we are leaving a window where write commands to this schema are illegal.
         // There are 3 possibilities:
@@ -1439,21 +1515,10 @@ static future<> merge_tables_and_views(distributed<service::storage_proxy>& prox
         //    the database object.
         view_ptr vp = create_view_from_mutations(proxy, std::move(sm));
         schema_ptr base_schema;
-        for (auto&& altered : tables_diff.altered) {
+        auto it = changed_tables.find(std::pair(std::string_view(vp->ks_name()), std::string_view(vp->view_info()->base_name())));
+        if (it != changed_tables.end()) {
             // Chose the appropriate version of the base table schema: old -> old, new -> new.
-            schema_ptr s = side == schema_diff_side::left ? altered.old_schema : altered.new_schema;
-            if (s->ks_name() == vp->ks_name() && s->cf_name() == vp->view_info()->base_name() ) {
-                base_schema = s;
-                break;
-            }
-        }
-        if (!base_schema) {
-            for (auto&& s : tables_diff.created) {
-                if (s.get()->ks_name() == vp->ks_name() && s.get()->cf_name() == vp->view_info()->base_name() ) {
-                    base_schema = s;
-                    break;
-                }
-            }
+            base_schema = side == schema_diff_side::left ? it->second.first : it->second.second;
         }
 
         if (!base_schema) {
@@ -3097,6 +3162,10 @@ schema_ptr create_table_from_mutations(const schema_ctxt& ctxt, schema_mutations
         builder.with_partitioner(*partitioner);
         builder.with_sharder(smp::count, ctxt.murmur3_partitioner_ignore_msb_bits());
     }
+    // The sharder is local to this node, so unlike the partitioner it can be chosen by the node's configuration.
+    if (ctxt.is_single_shard_table(ks_name, cf_name)) {
+        builder.with_sharder(1, ctxt.murmur3_partitioner_ignore_msb_bits());
+    }
 
     return builder.build();
 }
@@ -22,6 +22,7 @@
 
 #include <vector>
 #include <map>
+#include <unordered_set>
 
 namespace data_dictionary {
 class keyspace_metadata;
@@ -83,6 +84,9 @@ class schema_ctxt {
         return _schema_registry_grace_period;
     }
 
+    // Whether the table's data is kept on a single shard, see the single_shard_tables option.
+    bool is_single_shard_table(std::string_view ks_name, std::string_view cf_name) const;
+
     const data_dictionary::user_types_storage& user_types() const noexcept {
         return *_user_types;
     }
@@ -91,6 +95,7 @@ class schema_ctxt {
     const db::extensions& _extensions;
     const unsigned _murmur3_partitioner_ignore_msb_bits;
     const uint32_t _schema_registry_grace_period;
+    const std::unordered_set<sstring> _single_shard_tables;
     const std::shared_ptr<data_dictionary::user_types_storage> _user_types;
 };
 
@@ -176,6 +181,10 @@ future<table_schema_version> calculate_schema_digest(distributed<service::storag
 future<table_schema_version> calculate_schema_digest(distributed<service::storage_proxy>& proxy, schema_features);
 
 future<std::vector<canonical_mutation>> convert_schema_to_mutations(distributed<service::storage_proxy>& proxy, schema_features);
+// Like the above, but only for the first `max_keyspaces` keyspaces (in name order)
+// whose names sort after `start_after`. Used to transfer the schema in chunks.
+future<std::vector<canonical_mutation>> convert_schema_to_mutations(distributed<service::storage_proxy>& proxy, schema_features,
+        const std::optional<sstring>& start_after, size_t max_keyspaces);
 std::vector<mutation> adjust_schema_for_schema_features(std::vector<mutation> schema, schema_features features);
 
 future<schema_result_value_type>
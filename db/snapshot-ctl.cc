@@ -15,10 +15,25 @@
 #include <seastar/coroutine/maybe_yield.hh>
 #include <seastar/coroutine/parallel_for_each.hh>
 #include "db/snapshot-ctl.hh"
+#include "db/snapshot/backup_task.hh"
 #include "replica/database.hh"
 
 namespace db {
 
+snapshot_ctl::snapshot_ctl(sharded<replica::database>& db, tasks::task_manager& tm)
+    : _db(db)
+    , _task_manager_module(make_shared<snapshot::task_manager_module>(tm))
+{
+    tm.register_module(_task_manager_module->get_name(), _task_manager_module);
+}
+
+future<> snapshot_ctl::stop() {
+    co_await _ops.close();
+    if (auto m = std::exchange(_task_manager_module, nullptr)) {
+        co_await m->stop();
+    }
+}
+
 future<> snapshot_ctl::check_snapshot_not_exist(sstring ks_name, sstring name, std::optional<std::vector<sstring>> filter) {
     auto& ks = _db.local().find_keyspace(ks_name);
     return parallel_for_each(ks.metadata()->cf_meta_data(), [this, ks_name = std::move(ks_name), name = std::move(name), filter = std::move(filter)] (auto& pair) {
@@ -130,4 +145,23 @@ future<int64_t> snapshot_ctl::true_snapshots_size() {
     }));
 }
 
+future<tasks::task_id> snapshot_ctl::start_backup(sstring endpoint, sstring bucket, sstring prefix, sstring ks_name, sstring cf_name, sstring tag) {
+    if (endpoint.empty() || bucket.empty()) {
+        throw std::runtime_error("You must supply the object storage endpoint and bucket");
+    }
+    if (tag.empty()) {
+        throw std::runtime_error("You must supply a snapshot name.");
+    }
+    // Throws if the table does not exist
+    _db.local().find_column_family(ks_name, cf_name);
+
+    return with_gate(_ops, [=, this] {
+        return container().invoke_on(0, [=] (snapshot_ctl& snap) {
+            return snap._task_manager_module->make_and_start_task<snapshot::backup_task_impl>({}, snap._db, endpoint, bucket, prefix, ks_name, cf_name, tag).then([] (tasks::task_manager::task_ptr task) {
+                return task->id();
+            });
+        });
+    });
+}
+
 }
@@ -17,6 +17,7 @@
 #include <seastar/core/sharded.hh>
 #include <seastar/core/future.hh>
 #include "replica/database_fwd.hh"
+#include "tasks/task_manager.hh"
 #include <seastar/core/gate.hh>
 #include <seastar/core/rwlock.hh>
 
@@ -24,6 +25,10 @@ using namespace seastar;
 
 namespace db {
 
+namespace snapshot {
+class task_manager_module;
+}
+
 class snapshot_ctl : public peering_sharded_service<snapshot_ctl> {
 public:
     using skip_flush = bool_class<class skip_flush_tag>;
@@ -37,10 +42,12 @@ class snapshot_ctl : public peering_sharded_service<snapshot_ctl> {
 
         bool operator==(const snapshot_details&) const = default;
     };
-    explicit snapshot_ctl(sharded<replica::database>& db) : _db(db) {}
+    snapshot_ctl(sharded<replica::database>& db, tasks::task_manager& tm);
 
-    future<> stop() {
-        return _ops.close();
+    future<> stop();
+
+    snapshot::task_manager_module& get_task_manager_module() noexcept {
+        return *_task_manager_module;
     }
 
     /**
@@ -88,8 +95,20 @@ class snapshot_ctl : public peering_sharded_service<snapshot_ctl> {
     future<std::unordered_map<sstring, std::vector<snapshot_details>>> get_snapshot_details();
 
     future<int64_t> true_snapshots_size();
+
+    /**
+     * Starts uploading the snapshot of a table to an S3 bucket.
+     * SSTables already uploaded under the prefix by a previous backup are skipped.
+     *
+     * @param endpoint the address of the object storage
+     * @param bucket the bucket to upload to
+     * @param prefix the prefix of the uploaded objects' names
+     * @return the id of the backup task
+     */
+    future<tasks::task_id> start_backup(sstring endpoint, sstring bucket, sstring prefix, sstring ks_name, sstring cf_name, sstring tag);
 private:
     sharded<replica::database>& _db;
+    shared_ptr<snapshot::task_manager_module> _task_manager_module;
     seastar::rwlock _lock;
     seastar::gate _ops;
 
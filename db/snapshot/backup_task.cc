@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/fstream.hh>
+#include <seastar/core/seastar.hh>
+#include <seastar/net/inet_address.hh>
+#include "db/snapshot/backup_task.hh"
+#include "replica/database.hh"
+#include "service/priority_manager.hh"
+#include "sstables/sstables.hh"
+#include "utils/lister.hh"
+#include "utils/s3/client.hh"
+
+namespace db::snapshot {
+
+static logging::logger bkplog("backup");
+
+backup_task_impl::backup_task_impl(tasks::task_manager::module_ptr module,
+        sharded<replica::database>& db,
+        sstring endpoint,
+        sstring bucket,
+        sstring prefix,
+        sstring keyspace,
+        sstring table,
+        sstring snapshot_name) noexcept
+    : tasks::task_manager::task::impl(module, tasks::task_id::create_random_id(), module->new_sequence_number(), std::move(keyspace), std::move(table), snapshot_name, tasks::task_id::create_null_id())
+    , _db(db)
+    , _endpoint(std::move(endpoint))
+    , _bucket(std::move(bucket))
+    , _prefix(std::move(prefix))
+    , _snapshot_name(std::move(snapshot_name))
+{
+    _status.progress_units = "bytes";
+}
+
+future<> backup_task_impl::run() {
+    co_await with_scheduling_group(_db.local().get_streaming_scheduling_group(), [this] {
+        return do_backup();
+    });
+}
+
+static bool is_snapshot_metadata(const sstring& name) {
+    return name == "manifest.json" || name == "schema.cql";
+}
+
+future<> backup_task_impl::do_backup() {
+    auto& t = _db.local().find_column_family(_status.keyspace, _status.table);
+    auto snapshot_dir = fs::path(t.dir()) / sstables::snapshots_dir / _snapshot_name;
+    if (!co_await file_exists(snapshot_dir.native())) {
+        throw std::runtime_error(format("Snapshot {} of {}.{} does not exist", _snapshot_name, _status.keyspace, _status.table));
+    }
+
+    std::vector<std::pair<sstring, uint64_t>> files;
+    auto lister = directory_lister(snapshot_dir, lister::dir_entry_types::of<directory_entry_type::regular>());
+    std::exception_ptr ex;
+    try {
+        while (auto de = co_await lister.get()) {
+            auto size = co_await file_size((snapshot_dir / de->name).native());
+            files.emplace_back(de->name, size);
+            _progress.total += size;
+        }
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await lister.close();
+    if (ex) {
+        std::rethrow_exception(std::move(ex));
+    }
+
+    bkplog.info("Backing up {} files ({} bytes) of snapshot {} of {}.{} to {}/{}/{}",
+            files.size(), _progress.total, _snapshot_name, _status.keyspace, _status.table, _endpoint, _bucket, _prefix);
+    auto client = s3::client::make(ipv4_addr(_endpoint));
+    size_t skipped = 0;
+    try {
+        for (const auto& [name, size] : files) {
+            if (_as.abort_requested()) {
+                throw abort_requested_exception();
+            }
+            auto object_name = format("/{}/{}/{}", _bucket, _prefix, name);
+            if (!is_snapshot_metadata(name) && co_await is_uploaded(*client, object_name, size)) {
+                bkplog.debug("Skipping {}, already uploaded", object_name);
+                _progress.completed += size;
+                skipped++;
+                continue;
+            }
+            co_await upload_file(*client, snapshot_dir / name, std::move(object_name));
+        }
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await client->close();
+    if (ex) {
+        std::rethrow_exception(std::move(ex));
+    }
+    bkplog.info("Backed up snapshot {} of {}.{}: uploaded {} files, skipped {} already uploaded",
+            _snapshot_name, _status.keyspace, _status.table, files.size() - skipped, skipped);
+}
+
+future<bool> backup_task_impl::is_uploaded(s3::client& client, const sstring& object_name, uint64_t size) {
+    try {
+        co_return co_await client.get_object_size(object_name) == size;
+    } catch (...) {
+        // Most likely the object does not exist. If the storage is not
+        // reachable, uploading it will tell.
+        bkplog.debug("Cannot stat {}: {}", object_name, std::current_exception());
+    }
+    co_return false;
+}
+
+future<> backup_task_impl::upload_file(s3::client& client, fs::path path, sstring object_name) {
+    bkplog.debug("Uploading {} to {}", path.native(), object_name);
+    auto f = co_await open_file_dma(path.native(), open_flags::ro);
+    file_input_stream_options options;
+    options.io_priority_class = service::get_local_streaming_priority();
+    auto in = make_file_input_stream(std::move(f), std::move(options));
+    auto out = output_stream<char>(client.make_upload_sink(std::move(object_name)));
+    std::exception_ptr ex;
+    try {
+        while (auto buf = co_await in.read()) {
+            auto size = buf.size();
+            co_await out.write(std::move(buf));
+            _progress.completed += size;
+        }
+        // Completes the upload, closing the sink before that aborts it.
+        co_await out.flush();
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await out.close();
+    co_await in.close();
+    if (ex) {
+        std::rethrow_exception(std::move(ex));
+    }
+}
+
+}
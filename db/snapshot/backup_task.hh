@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <filesystem>
+
+#include <seastar/core/sharded.hh>
+#include "replica/database_fwd.hh"
+#include "tasks/task_manager.hh"
+
+namespace s3 {
+class client;
+}
+
+namespace db::snapshot {
+
+class task_manager_module : public tasks::task_manager::module {
+public:
+    task_manager_module(tasks::task_manager& tm) noexcept : tasks::task_manager::module(tm, "snapshot") {}
+};
+
+// Uploads the files of a table snapshot to an S3 bucket, as objects named
+// /<bucket>/<prefix>/<file name>.
+//
+// The files are read with direct I/O of the streaming priority class, in the
+// streaming scheduling group, so the backup neither pollutes the page cache
+// nor competes with the user workload beyond what streaming is allowed to.
+//
+// SSTables are immutable, so backing up successive snapshots of a table to the
+// same prefix only uploads the sstables written since the previous backup: a
+// component is skipped if an object of the same name and size already exists.
+// The manifest and the schema of the snapshot are always uploaded.
+class backup_task_impl : public tasks::task_manager::task::impl {
+    sharded<replica::database>& _db;
+    sstring _endpoint;
+    sstring _bucket;
+    sstring _prefix;
+    sstring _snapshot_name;
+public:
+    backup_task_impl(tasks::task_manager::module_ptr module,
+            sharded<replica::database>& db,
+            sstring endpoint,
+            sstring bucket,
+            sstring prefix,
+            sstring keyspace,
+            sstring table,
+            sstring snapshot_name) noexcept;
+
+    virtual std::string type() const override {
+        return "backup";
+    }
+
+    virtual tasks::is_abortable is_abortable() const noexcept override {
+        return tasks::is_abortable::yes;
+    }
+protected:
+    virtual future<> run() override;
+private:
+    future<> do_backup();
+    future<bool> is_uploaded(s3::client& client, const sstring& object_name, uint64_t size);
+    future<> upload_file(s3::client& client, std::filesystem::path path, sstring object_name);
+};
+
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include "serializer.hh"
+#include "schema/schema.hh"
+#include "exceptions/exceptions.hh"
+
+namespace db {
+
+/**
+ * \brief Schema extension which represents the `sstable_filter_type` per-table option.
+ *
+ * The option selects the filter sstables of the table are written with:
+ * 'bloom' (the default) or 'binary_fuse', a static filter which takes less
+ * memory for the same `bloom_filter_fp_chance`. The option only affects
+ * newly written sstables.
+ */
+class sstable_filter_type_extension : public schema_extension {
+    sstable_filter_type _type = sstable_filter_type::bloom;
+public:
+    static constexpr auto NAME = "sstable_filter_type";
+
+    sstable_filter_type_extension() = default;
+
+    explicit sstable_filter_type_extension(sstable_filter_type type)
+        : _type(type)
+    {}
+
+    explicit sstable_filter_type_extension(const std::map<sstring, sstring>& map) {
+        throw exceptions::configuration_exception(format("Invalid value for {}: expected a string", NAME));
+    }
+
+    explicit sstable_filter_type_extension(const bytes& b) : _type(parse(deserialize(b)))
+    {}
+
+    explicit sstable_filter_type_extension(const sstring& s) : _type(parse(s))
+    {}
+
+    bytes serialize() const override {
+        return ser::serialize_to_buffer<bytes>(sstable_filter_type_to_sstring(_type));
+    }
+
+    static sstring deserialize(const bytes_view& buffer) {
+        return ser::deserialize_from_buffer(buffer, boost::type<sstring>());
+    }
+
+    static sstable_filter_type parse(const sstring& s) {
+        try {
+            return sstring_to_sstable_filter_type(s);
+        } catch (const std::invalid_argument&) {
+            throw exceptions::configuration_exception(format("Invalid value for {}: '{}', expected 'bloom' or 'binary_fuse'", NAME, s));
+        }
+    }
+
+    sstable_filter_type get_filter_type() const {
+        return _type;
+    }
+};
+
+} // namespace db
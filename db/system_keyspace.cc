@@ -19,6 +19,8 @@
 #include <seastar/json/json_elements.hh>
 #include "system_keyspace.hh"
 #include "types/types.hh"
+#include "types/list.hh"
+#include "types/tuple.hh"
 #include "service/storage_proxy.hh"
 #include "service/client_state.hh"
 #include "service/query_state.hh"
@@ -68,6 +70,9 @@
 #include "sstables/open_info.hh"
 #include "sstables/generation_type.hh"
 #include "cdc/generation.hh"
+#include "locator/tablets.hh"
+#include "tracing/ring_buffer_backend.hh"
+#include "db/data_listeners.hh"
 
 using days = std::chrono::duration<int, std::ratio<24 * 3600>>;
 
@@ -85,6 +90,7 @@ namespace {
             system_keyspace::BROADCAST_KV_STORE,
             system_keyspace::TOPOLOGY,
             system_keyspace::CDC_GENERATIONS_V3,
+            system_keyspace::TABLETS,
         };
         if (ks_name == system_keyspace::NAME && system_ks_null_shard_tables.contains(cf_name)) {
             props.use_null_sharder = true;
@@ -101,6 +107,7 @@ namespace {
             system_keyspace::BROADCAST_KV_STORE,
             system_keyspace::TOPOLOGY,
             system_keyspace::CDC_GENERATIONS_V3,
+            system_keyspace::TABLETS,
         };
         if (ks_name == system_keyspace::NAME && extra_durable_tables.contains(cf_name)) {
             props.wait_for_sync_to_commitlog = true;
@@ -302,6 +309,32 @@ schema_ptr system_keyspace::cdc_generations_v3() {
     return schema;
 }
 
+static thread_local data_type tablet_replica_type = tuple_type_impl::get_instance({uuid_type, int32_type});
+static thread_local data_type tablet_replica_set_type = list_type_impl::get_instance(tablet_replica_type, false);
+
+/* Placement of the tablets of tables which use tablets, see locator/tablets.hh.
+ * Written to by Raft Group 0. */
+schema_ptr system_keyspace::tablets() {
+    static thread_local auto schema = [] {
+        auto id = generate_legacy_id(NAME, TABLETS);
+        return schema_builder(NAME, TABLETS, std::optional(id))
+            .with_column("table_id", uuid_type, column_kind::partition_key)
+            .with_column("tablet_count", int32_type, column_kind::static_column)
+            .with_column("keyspace_name", utf8_type, column_kind::static_column)
+            .with_column("table_name", utf8_type, column_kind::static_column)
+            /* The last token owned by the tablet, which identifies it among the tablets of the table. */
+            .with_column("last_token", long_type, column_kind::clustering_key)
+            /* list<tuple<host_id, shard>> */
+            .with_column("replicas", tablet_replica_set_type)
+            /* The replicas the tablet migrates to, set only while the tablet is in transition. */
+            .with_column("new_replicas", tablet_replica_set_type)
+            .set_comment("Tablet placement")
+            .with_version(generate_schema_version(id))
+            .build();
+    }();
+    return schema;
+}
+
 schema_ptr system_keyspace::raft() {
     static thread_local auto schema = [] {
         auto id = generate_legacy_id(NAME, RAFT);
@@ -2452,6 +2485,177 @@ class runtime_info_table : public memtable_filling_virtual_table {
     }
 };
 
+// Lists the hottest partitions of the node in the last complete window of
+// hot_partitions_window_in_s, merged from the hot_partitions_data_listener
+// of all shards. A partition is owned by a single shard, so the lists of the
+// shards are disjoint.
+class hot_partitions_table : public memtable_filling_virtual_table {
+private:
+    distributed<replica::database>& _db;
+
+    struct hot_partition {
+        sstring ks_name;
+        sstring cf_name;
+        sstring key;
+        int64_t count;
+        int64_t error;
+        int32_t shard;
+    };
+public:
+    explicit hot_partitions_table(distributed<replica::database>& db)
+        : memtable_filling_virtual_table(build_schema())
+        , _db(db) {
+        _shard_aware = true;
+    }
+
+    static schema_ptr build_schema() {
+        auto id = generate_legacy_id(system_keyspace::NAME, "hot_partitions");
+        return schema_builder(system_keyspace::NAME, "hot_partitions", std::make_optional(id))
+            .with_column("operation", utf8_type, column_kind::partition_key)
+            .with_column("rank", int32_type, column_kind::clustering_key)
+            .with_column("keyspace_name", utf8_type)
+            .with_column("table_name", utf8_type)
+            .with_column("partition_key", utf8_type)
+            .with_column("count", long_type)
+            .with_column("error", long_type)
+            .with_column("shard", int32_type)
+            .set_comment("Hottest partitions of the node, for reads and writes, in the last complete window of hot_partitions_window_in_s.")
+            .with_version(system_keyspace::generate_schema_version(id))
+            .build();
+    }
+
+    future<> execute(std::function<void(mutation)> mutation_sink) override {
+        for (auto op : {"read", "write"}) {
+            auto dk = dht::decorate_key(*_s, partition_key::from_single_value(*schema(), data_value(op).serialize_nonnull()));
+            if (!this_shard_owns(dk)) {
+                continue;
+            }
+            const bool reads = op == std::string_view("read");
+            auto per_shard = co_await _db.map([reads] (replica::database& db) {
+                std::vector<hot_partition> ret;
+                auto* listener = db.hot_partitions();
+                if (!listener) {
+                    return ret;
+                }
+                auto top = reads ? listener->top_reads(listener_results) : listener->top_writes(listener_results);
+                ret.reserve(top.size());
+                for (auto& e : top) {
+                    ret.push_back(hot_partition{e.item.schema->ks_name(), e.item.schema->cf_name(), sstring(e.item),
+                            int64_t(e.count), int64_t(e.error), int32_t(this_shard_id())});
+                }
+                return ret;
+            });
+            std::vector<hot_partition> merged;
+            for (auto& partitions : per_shard) {
+                std::move(partitions.begin(), partitions.end(), std::back_inserter(merged));
+            }
+            std::stable_sort(merged.begin(), merged.end(), [] (const hot_partition& a, const hot_partition& b) {
+                return a.count > b.count;
+            });
+
+            mutation m(schema(), std::move(dk));
+            for (int32_t rank = 0; rank < int32_t(merged.size()); ++rank) {
+                auto& p = merged[rank];
+                auto ck = clustering_key::from_single_value(*schema(), data_value(rank).serialize_nonnull());
+                row& cr = m.partition().clustered_row(*schema(), ck).cells();
+                set_cell(cr, "keyspace_name", p.ks_name);
+                set_cell(cr, "table_name", p.cf_name);
+                set_cell(cr, "partition_key", p.key);
+                set_cell(cr, "count", p.count);
+                set_cell(cr, "error", p.error);
+                set_cell(cr, "shard", p.shard);
+            }
+            mutation_sink(std::move(m));
+        }
+    }
+
+private:
+    // Number of partitions reported by each shard.
+    static constexpr unsigned listener_results = 100;
+};
+
+// Lists the tracing sessions kept in memory by the ring_buffer_backend tracing
+// backend, see the tracing_backend config option. A session is stored by the shard
+// which ran it, so each read collects the sessions of all the shards.
+class recent_traces_table : public memtable_filling_virtual_table {
+public:
+    recent_traces_table()
+        : memtable_filling_virtual_table(build_schema()) {
+        _shard_aware = true;
+    }
+
+    static schema_ptr build_schema() {
+        auto id = generate_legacy_id(system_keyspace::NAME, "recent_traces");
+        return schema_builder(system_keyspace::NAME, "recent_traces", std::make_optional(id))
+            .with_column("session_id", uuid_type, column_kind::partition_key)
+            .with_column("event_id", int32_type, column_kind::clustering_key)
+            .with_column("shard", int32_type, column_kind::static_column)
+            .with_column("command", utf8_type, column_kind::static_column)
+            .with_column("started_at", timestamp_type, column_kind::static_column)
+            .with_column("duration", int32_type, column_kind::static_column)
+            .with_column("client", inet_addr_type, column_kind::static_column)
+            .with_column("username", utf8_type, column_kind::static_column)
+            .with_column("request", utf8_type, column_kind::static_column)
+            .with_column("parameters", map_type_impl::get_instance(utf8_type, utf8_type, false), column_kind::static_column)
+            .with_column("slow", boolean_type, column_kind::static_column)
+            .with_column("source_elapsed", int32_type)
+            .with_column("activity", utf8_type)
+            .set_comment("Tracing sessions kept in memory when tracing_backend is ring_buffer.")
+            .with_version(system_keyspace::generate_schema_version(id))
+            .build();
+    }
+
+    future<> execute(std::function<void(mutation)> mutation_sink) override {
+        using session = tracing::ring_buffer_backend::session;
+        auto& tr = tracing::tracing::tracing_instance();
+        if (!tr.local_is_initialized()) {
+            co_return;
+        }
+        auto sessions_per_shard = co_await tr.map([] (tracing::tracing& local_tracing) {
+            std::vector<session> sessions;
+            if (!local_tracing.started()) {
+                return sessions;
+            }
+            if (auto* backend = dynamic_cast<tracing::ring_buffer_backend*>(&local_tracing.backend_helper())) {
+                sessions.assign(backend->sessions().begin(), backend->sessions().end());
+            }
+            return sessions;
+        });
+
+        auto micros = [] (tracing::elapsed_clock::duration d) {
+            return int32_t(std::min<int64_t>(std::chrono::duration_cast<std::chrono::microseconds>(d).count(), std::numeric_limits<int32_t>::max()));
+        };
+        auto parameters_type = schema()->get_column_definition("parameters")->type;
+        for (unsigned shard = 0; shard < sessions_per_shard.size(); ++shard) {
+            for (auto& s : sessions_per_shard[shard]) {
+                auto dk = dht::decorate_key(*_s, partition_key::from_single_value(*schema(), data_value(s.session_id).serialize_nonnull()));
+                if (!this_shard_owns(dk)) {
+                    continue;
+                }
+                mutation m(schema(), std::move(dk));
+                row& sr = m.partition().static_row().maybe_create();
+                set_cell(sr, "shard", int32_t(shard));
+                set_cell(sr, "command", tracing::type_to_string(s.command));
+                set_cell(sr, "started_at", db_clock::time_point(std::chrono::duration_cast<db_clock::duration>(s.started_at.time_since_epoch())));
+                set_cell(sr, "duration", micros(s.elapsed));
+                set_cell(sr, "client", s.client);
+                set_cell(sr, "username", s.username);
+                set_cell(sr, "request", s.request);
+                std::vector<std::pair<data_value, data_value>> parameters(s.parameters.begin(), s.parameters.end());
+                set_cell(sr, "parameters", make_map_value(parameters_type, map_type_impl::native_type(std::move(parameters))));
+                set_cell(sr, "slow", s.slow);
+                for (unsigned i = 0; i < s.events.size(); ++i) {
+                    auto ck = clustering_key::from_single_value(*schema(), data_value(int32_t(i)).serialize_nonnull());
+                    row& cr = m.partition().clustered_row(*schema(), ck).cells();
+                    set_cell(cr, "source_elapsed", micros(s.events[i].elapsed));
+                    set_cell(cr, "activity", s.events[i].message);
+                }
+                mutation_sink(std::move(m));
+            }
+        }
+    }
+};
+
 class versions_table : public memtable_filling_virtual_table {
 public:
     explicit versions_table()
@@ -2862,6 +3066,8 @@ void register_virtual_tables(distributed<replica::database>& dist_db, distribute
     add_table(std::make_unique<db_config_table>(cfg));
     add_table(std::make_unique<clients_table>(ss));
     add_table(std::make_unique<raft_state_table>(dist_raft_gr));
+    add_table(std::make_unique<recent_traces_table>());
+    add_table(std::make_unique<hot_partitions_table>(dist_db));
 }
 
 std::vector<schema_ptr> system_keyspace::all_tables(const db::config& cfg) {
@@ -2883,7 +3089,7 @@ std::vector<schema_ptr> system_keyspace::all_tables(const db::config& cfg) {
         r.insert(r.end(), {raft(), raft_snapshots(), raft_snapshot_config(), group0_history(), discovery()});
 
         if (cfg.check_experimental(db::experimental_features_t::feature::RAFT)) {
-            r.insert(r.end(), {topology(), cdc_generations_v3()});
+            r.insert(r.end(), {topology(), cdc_generations_v3(), tablets()});
         }
 
         if (cfg.check_experimental(db::experimental_features_t::feature::BROADCAST_TABLES)) {
@@ -3685,6 +3891,103 @@ future<service::topology> system_keyspace::load_topology_state() {
     co_return ret;
 }
 
+static data_value tablet_replica_set_to_data_value(const locator::tablet_replica_set& replicas) {
+    std::vector<data_value> values;
+    values.reserve(replicas.size());
+    for (auto& r : replicas) {
+        values.push_back(make_tuple_value(tablet_replica_type, {data_value(r.host.uuid()), data_value(int32_t(r.shard))}));
+    }
+    return make_list_value(tablet_replica_set_type, std::move(values));
+}
+
+static locator::tablet_replica_set tablet_replica_set_from_cell(const cql3::untyped_result_set_row& row, std::string_view name) {
+    locator::tablet_replica_set replicas;
+    auto v = tablet_replica_set_type->deserialize_value(row.get_blob(name));
+    for (auto& replica : value_cast<list_type_impl::native_type>(v)) {
+        auto& tup = value_cast<tuple_type_impl::native_type>(replica);
+        replicas.push_back(locator::tablet_replica{
+            .host = locator::host_id(value_cast<utils::UUID>(tup[0])),
+            .shard = shard_id(value_cast<int32_t>(tup[1])),
+        });
+    }
+    return replicas;
+}
+
+mutation system_keyspace::make_tablet_map_mutation(table_id id, const sstring& keyspace_name, const sstring& table_name,
+        const locator::tablet_map& tablets, api::timestamp_type ts) {
+    auto s = system_keyspace::tablets();
+    mutation m(s, partition_key::from_single_value(*s, data_value(id.uuid()).serialize_nonnull()));
+    // Splits and merges change the boundaries of the tablets, so rows of the previous map are deleted.
+    m.partition().apply(tombstone(ts - 1, gc_clock::now()));
+    m.set_static_cell("tablet_count", data_value(int32_t(tablets.tablet_count())), ts);
+    m.set_static_cell("keyspace_name", data_value(keyspace_name), ts);
+    m.set_static_cell("table_name", data_value(table_name), ts);
+    for (auto tid : tablets.tablet_ids()) {
+        auto ck = clustering_key::from_single_value(*s, data_value(dht::token::to_int64(tablets.get_last_token(tid))).serialize_nonnull());
+        m.set_clustered_cell(ck, "replicas", tablet_replica_set_to_data_value(tablets.get_tablet_info(tid).replicas), ts);
+        if (auto trinfo = tablets.get_tablet_transition_info(tid)) {
+            m.set_clustered_cell(ck, "new_replicas", tablet_replica_set_to_data_value(trinfo->next), ts);
+        }
+    }
+    return m;
+}
+
+mutation system_keyspace::make_drop_tablet_map_mutation(table_id id, api::timestamp_type ts) {
+    auto s = system_keyspace::tablets();
+    mutation m(s, partition_key::from_single_value(*s, data_value(id.uuid()).serialize_nonnull()));
+    m.partition().apply(tombstone(ts, gc_clock::now()));
+    return m;
+}
+
+future<locator::tablet_metadata> system_keyspace::load_tablet_metadata() {
+    locator::tablet_metadata tm;
+    std::optional<locator::tablet_map> map;
+    table_id current;
+
+    auto flush = [&] {
+        if (map) {
+            tm.set_tablet_map(current, std::move(*map));
+            map.reset();
+        }
+    };
+
+    // Rows are ordered by partition, and by token within a partition, so the tablets
+    // of each table are read in tablet id order.
+    co_await qctx->qp().query_internal(format("SELECT * FROM system.{}", TABLETS),
+            [&] (const cql3::untyped_result_set_row& row) -> future<stop_iteration> {
+        auto id = table_id(row.get_as<utils::UUID>("table_id"));
+        if (!map || id != current) {
+            flush();
+            current = id;
+            map.emplace(size_t(row.get_as<int32_t>("tablet_count")));
+        }
+        auto last_token = dht::token::from_int64(row.get_as<int64_t>("last_token"));
+        auto tid = map->get_tablet_id(last_token);
+        if (map->get_last_token(tid) != last_token) {
+            on_internal_error(slogger, format("load_tablet_metadata: table {} has a tablet ending at {}, which is not a tablet boundary",
+                    current, last_token));
+        }
+        map->set_tablet(tid, locator::tablet_info{tablet_replica_set_from_cell(row, "replicas")});
+        if (row.has("new_replicas")) {
+            auto next = tablet_replica_set_from_cell(row, "new_replicas");
+            auto& replicas = map->get_tablet_info(tid).replicas;
+            auto pending = boost::find_if(next, [&] (const locator::tablet_replica& r) {
+                return boost::find(replicas, r) == replicas.end();
+            });
+            if (pending == next.end()) {
+                on_internal_error(slogger, format("load_tablet_metadata: tablet {} of table {} is in transition to its own replicas",
+                        tid, current));
+            }
+            auto pending_replica = *pending;
+            map->set_tablet_transition_info(tid, locator::tablet_transition_info{std::move(next), pending_replica});
+        }
+        co_return stop_iteration::no;
+    });
+    flush();
+
+    co_return tm;
+}
+
 future<cdc::topology_description>
 system_keyspace::read_cdc_generation(utils::UUID id) {
     std::vector<cdc::token_range_description> entries;
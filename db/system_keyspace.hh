@@ -62,6 +62,8 @@ namespace gms {
 namespace locator {
     class endpoint_dc_rack;
     class snitch_ptr;
+    class tablet_map;
+    class tablet_metadata;
 } // namespace locator
 
 namespace gms {
@@ -156,6 +158,7 @@ class system_keyspace : public seastar::peering_sharded_service<system_keyspace>
     static constexpr auto TOPOLOGY = "topology";
     static constexpr auto SSTABLES_REGISTRY = "sstables";
     static constexpr auto CDC_GENERATIONS_V3 = "cdc_generations_v3";
+    static constexpr auto TABLETS = "tablets";
 
     struct v3 {
         static constexpr auto BATCHES = "batches";
@@ -239,6 +242,7 @@ class system_keyspace : public seastar::peering_sharded_service<system_keyspace>
     static schema_ptr topology();
     static schema_ptr sstables_registry();
     static schema_ptr cdc_generations_v3();
+    static schema_ptr tablets();
 
     static table_schema_version generate_schema_version(table_id table_id, uint16_t offset = 0);
 
@@ -456,6 +460,16 @@ class system_keyspace : public seastar::peering_sharded_service<system_keyspace>
 
     static future<service::topology> load_topology_state();
 
+    // Returns a mutation of system.tablets which replaces the tablet map of the table with the given one.
+    static mutation make_tablet_map_mutation(table_id, const sstring& keyspace_name, const sstring& table_name,
+            const locator::tablet_map&, api::timestamp_type);
+
+    // Returns a mutation of system.tablets which removes the tablet map of the table.
+    static mutation make_drop_tablet_map_mutation(table_id, api::timestamp_type);
+
+    // Reads the tablet maps of all tables from system.tablets.
+    static future<locator::tablet_metadata> load_tablet_metadata();
+
     // Read CDC generation data with the given UUID as key.
     // Precondition: the data is known to be present in the table (because it was committed earlier through group 0).
     future<cdc::topology_description> read_cdc_generation(utils::UUID id);
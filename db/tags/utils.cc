@@ -42,7 +42,13 @@ std::optional<std::string> find_tag(const schema& s, const sstring& tag) {
 
 future<> modify_tags(service::migration_manager& mm, sstring ks, sstring cf,
                      std::function<void(std::map<sstring, sstring>&)> modify) {
-    co_await mm.container().invoke_on(0, [ks = std::move(ks), cf = std::move(cf), modify = std::move(modify)] (service::migration_manager& mm) -> future<> {
+    return modify_tags(mm, std::move(ks), std::move(cf), std::move(modify), {});
+}
+
+future<> modify_tags(service::migration_manager& mm, sstring ks, sstring cf,
+                     std::function<void(std::map<sstring, sstring>&)> modify,
+                     modify_schema_func_type modify_schema) {
+    co_await mm.container().invoke_on(0, [ks = std::move(ks), cf = std::move(cf), modify = std::move(modify), modify_schema = std::move(modify_schema)] (service::migration_manager& mm) -> future<> {
         // FIXME: the following needs to be in a loop. If mm.announce() below
         // fails, we need to retry the whole thing.
         auto group0_guard = co_await mm.start_group0_operation();
@@ -50,7 +56,8 @@ future<> modify_tags(service::migration_manager& mm, sstring ks, sstring cf,
         // table's *current* schema - it might have changed before we got
         // the lock, by some concurrent modification. If the table is gone,
         // this will throw no_such_column_family.
-        schema_ptr s = mm.get_storage_proxy().data_dictionary().find_schema(ks, cf);
+        auto t = mm.get_storage_proxy().data_dictionary().find_table(ks, cf);
+        schema_ptr s = t.schema();
         const std::map<sstring, sstring>* tags_ptr = get_tags_of_table(s);
         std::map<sstring, sstring> tags;
         if (tags_ptr) {
@@ -61,8 +68,12 @@ future<> modify_tags(service::migration_manager& mm, sstring ks, sstring cf,
         modify(tags);
         schema_builder builder(s);
         builder.add_extension(tags_extension::NAME, ::make_shared<tags_extension>(tags));
+        std::vector<view_ptr> view_updates;
+        if (modify_schema) {
+            view_updates = modify_schema(*s, t.views(), tags, builder);
+        }
 
-        auto m = co_await mm.prepare_column_family_update_announcement(builder.build(), false, std::vector<view_ptr>(), group0_guard.write_timestamp());
+        auto m = co_await mm.prepare_column_family_update_announcement(builder.build(), false, std::move(view_updates), group0_guard.write_timestamp());
 
         co_await mm.announce(std::move(m), std::move(group0_guard));
     });
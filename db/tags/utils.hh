@@ -19,6 +19,8 @@
 #include "service/client_state.hh"
 #include "service/migration_manager.hh"
 
+class schema_builder;
+
 namespace db {
 
 // get_tags_of_table() returns all tags associated with the given table, or
@@ -47,4 +49,14 @@ std::optional<std::string> find_tag(const schema& s, const sstring& tag);
 // is passed an empty map, and the tags it adds will be added to the table.
 future<> modify_tags(service::migration_manager& mm, sstring ks, sstring cf,
                      std::function<void(std::map<sstring, sstring>&)> modify_func);
+
+// Like modify_tags(), but also lets modify_schema_func() change the rest of
+// the schema of the table, s, along with its modified tags. It is passed the
+// current schemas of the table's views, and returns those it modified, which
+// are written along with the table's.
+using modify_schema_func_type = std::function<std::vector<view_ptr>(const schema& s, const std::vector<view_ptr>& views,
+        const std::map<sstring, sstring>& tags, schema_builder& builder)>;
+future<> modify_tags(service::migration_manager& mm, sstring ks, sstring cf,
+                     std::function<void(std::map<sstring, sstring>&)> modify_func,
+                     modify_schema_func_type modify_schema_func);
 }
@@ -26,6 +26,8 @@
 #include <seastar/core/future-util.hh>
 #include <seastar/core/coroutine.hh>
 #include <seastar/coroutine/maybe_yield.hh>
+#include <seastar/coroutine/as_future.hh>
+#include <seastar/coroutine/exception.hh>
 
 #include "replica/database.hh"
 #include "clustering_bounds_comparator.hh"
@@ -265,12 +267,16 @@ void stats::register_stats() {
                     {_cf_label, _ks_label}),
             ms::make_total_operations("view_updates_failed_remote", view_updates_failed_remote, ms::description("Number of updates (mutations) that failed to be pushed to remote view replicas"),
                     {_cf_label, _ks_label}),
+            ms::make_total_operations("view_update_batches_pushed_remote", view_update_batches_pushed_remote, ms::description("Number of times several updates (mutations) were pushed to the same remote view replicas at once"),
+                    {_cf_label, _ks_label}),
             ms::make_total_operations("view_updates_pushed_local", view_updates_pushed_local, ms::description("Number of updates (mutations) pushed to local view replicas"),
                     {_cf_label, _ks_label}),
             ms::make_total_operations("view_updates_failed_local", view_updates_failed_local, ms::description("Number of updates (mutations) that failed to be pushed to local view replicas"),
                     {_cf_label, _ks_label}),
             ms::make_gauge("view_updates_pending", ms::description("Number of updates pushed to view and are still to be completed"),
                     {_cf_label, _ks_label}, writes),
+            ms::make_current_bytes("view_update_backlog", ms::description("Memory taken by the pending updates of the views of the table, which base writes to it are throttled by"),
+                    {_cf_label, _ks_label}, [this] { return std::max(view_update_backlog_bytes, int64_t(0)); }),
     });
 }
 
@@ -1608,6 +1614,80 @@ static future<> apply_to_remote_endpoints(service::storage_proxy& proxy, gms::in
             allow_hints);
 }
 
+// Units of view_update_concurrency_semaphore held by pending view updates,
+// which are also accounted to the view update backlog of their base table
+// until they are returned.
+class view_update_units {
+    db::timeout_semaphore_units _units;
+    db::view::stats& _stats;
+public:
+    view_update_units(db::timeout_semaphore_units units, db::view::stats& stats) noexcept
+            : _units(std::move(units))
+            , _stats(stats) {
+        _stats.view_update_backlog_bytes += _units.count();
+    }
+    view_update_units(view_update_units&& o) noexcept = default;
+    ~view_update_units() {
+        return_all();
+    }
+    void adopt(view_update_units&& o) noexcept {
+        _units.adopt(std::move(o._units));
+    }
+    void return_all() noexcept {
+        _stats.view_update_backlog_bytes -= _units.count();
+        _units.return_all();
+    }
+};
+
+// View updates of a base partition going to the same view replicas.
+struct remote_view_updates {
+    gms::inet_address target;
+    inet_address_vector_topology_change pending_endpoints;
+    std::vector<frozen_mutation_and_schema> mutations;
+    view_update_units units;
+    // Whether the base write waits for the updates.
+    bool synchronous;
+};
+
+static future<> send_remote_view_updates(service::storage_proxy& proxy, remote_view_updates u, dht::token base_token,
+        db::view::stats& stats, replica::cf_stats& cf_stats, service::allow_hints allow_hints, tracing::trace_state_ptr tr_state) {
+    const size_t count = u.mutations.size();
+    const size_t updates_pushed_remote = count * (u.pending_endpoints.size() + 1);
+    const bool synchronous = u.synchronous;
+    if (count > 1) {
+        ++stats.view_update_batches_pushed_remote;
+    }
+    tracing::trace(tr_state, "Sending {} view updates to {}, with pending endpoints = {}; base token = {}",
+            count, u.target, u.pending_endpoints, base_token);
+    auto f = co_await coroutine::as_future(proxy.send_to_endpoint(
+            std::move(u.mutations),
+            u.target,
+            std::move(u.pending_endpoints),
+            db::write_type::VIEW,
+            tr_state,
+            allow_hints));
+    u.units.return_all();
+    if (f.failed()) {
+        stats.view_updates_failed_remote += updates_pushed_remote;
+        cf_stats.total_view_updates_failed_remote += updates_pushed_remote;
+        auto ep = f.get_exception();
+        tracing::trace(tr_state, "Failed to apply {} view updates for {} and {} remote endpoints",
+                count, u.target, updates_pushed_remote);
+
+        // Printing an error on every failed view mutation would cause log spam, so a rate limit is needed.
+        static thread_local logger::rate_limit view_update_error_rate_limit(std::chrono::seconds(4));
+        vlogger.log(log_level::error, view_update_error_rate_limit,
+                    "Error applying {} view updates to {} (base token: {}): {}",
+                    count, u.target, base_token, ep);
+        if (synchronous) {
+            co_await coroutine::return_exception_ptr(std::move(ep));
+        }
+        co_return;
+    }
+    tracing::trace(tr_state, "Successfully applied {} view updates for {} and {} remote endpoints",
+            count, u.target, updates_pushed_remote);
+}
+
 static bool should_update_synchronously(const schema& s) {
     auto tag_opt = db::find_tag(s, db::SYNCHRONOUS_VIEW_UPDATES_TAG_KEY);
     if (!tag_opt.has_value()) {
@@ -1632,8 +1712,13 @@ future<> view_update_generator::mutate_MV(
         wait_for_all_updates wait_for_all)
 {
     static constexpr size_t max_concurrent_updates = 128;
-    co_await max_concurrent_for_each(view_updates, max_concurrent_updates,
-            [this, base_token, &stats, &cf_stats, tr_state, &pending_view_updates, allow_hints, wait_for_all] (frozen_mutation_and_schema mut) mutable -> future<> {
+    // When coalescing, the remote updates going to the same view replicas are
+    // collected here and sent together, once all updates were routed, so that
+    // each view replica receives them in a single rpc.
+    std::vector<remote_view_updates> coalesced;
+    const bool coalesce = view_updates.size() > 1 && _db.get_config().coalesce_view_updates();
+    auto routed = co_await coroutine::as_future(max_concurrent_for_each(view_updates, max_concurrent_updates,
+            [this, base_token, &stats, &cf_stats, tr_state, &pending_view_updates, allow_hints, wait_for_all, coalesce, &coalesced] (frozen_mutation_and_schema mut) mutable -> future<> {
         auto view_token = dht::get_token(*mut.s, mut.fm.key());
         auto& keyspace_name = mut.s->ks_name();
         auto target_endpoint = get_view_natural_endpoint(_proxy.local().local_db(), keyspace_name, base_token, view_token);
@@ -1686,7 +1771,7 @@ future<> view_update_generator::mutate_MV(
                     mut.s->ks_name(), mut.s->cf_name(), base_token, view_token);
             local_view_update = _proxy.local().mutate_locally(mut.s, *mut_ptr, tr_state, db::commitlog::force_sync::no).then_wrapped(
                     [s = mut.s, &stats, &cf_stats, tr_state, base_token, view_token, my_address, mut_ptr = std::move(mut_ptr),
-                            units = sem_units.split(sem_units.count())] (future<>&& f) {
+                            units = view_update_units(sem_units.split(sem_units.count()), stats)] (future<>&& f) {
                 --stats.writes;
                 if (f.failed()) {
                     ++stats.view_updates_failed_local;
@@ -1720,10 +1805,22 @@ future<> view_update_generator::mutate_MV(
             size_t updates_pushed_remote = remote_endpoints.size() + 1;
             stats.view_updates_pushed_remote += updates_pushed_remote;
             cf_stats.total_view_updates_pushed_remote += updates_pushed_remote;
+            if (coalesce) {
+                auto it = std::find_if(coalesced.begin(), coalesced.end(), [&] (const remote_view_updates& u) {
+                    return u.target == *target_endpoint && u.pending_endpoints == remote_endpoints;
+                });
+                if (it == coalesced.end()) {
+                    it = coalesced.insert(coalesced.end(), remote_view_updates{*target_endpoint, std::move(remote_endpoints), {}, view_update_units(sem_units.split(0), stats), false});
+                }
+                it->mutations.push_back(std::move(mut));
+                it->units.adopt(view_update_units(sem_units.split(sem_units.count()), stats));
+                it->synchronous |= apply_update_synchronously;
+                return local_view_update;
+            }
             schema_ptr s = mut.s;
             future<> view_update = apply_to_remote_endpoints(_proxy.local(), *target_endpoint, std::move(remote_endpoints), std::move(mut), base_token, view_token, allow_hints, tr_state).then_wrapped(
                     [s = std::move(s), &stats, &cf_stats, tr_state, base_token, view_token, target_endpoint, updates_pushed_remote,
-                            units = sem_units.split(sem_units.count()), apply_update_synchronously] (future<>&& f) mutable {
+                            units = view_update_units(sem_units.split(sem_units.count()), stats), apply_update_synchronously] (future<>&& f) mutable {
                 if (f.failed()) {
                     stats.view_updates_failed_remote += updates_pushed_remote;
                     cf_stats.total_view_updates_failed_remote += updates_pushed_remote;
@@ -1751,7 +1848,28 @@ future<> view_update_generator::mutate_MV(
             }
         }
         return when_all_succeed(std::move(local_view_update), std::move(remote_view_update)).discard_result();
-    });
+    }));
+
+    // The coalesced updates are sent even if applying some of the others
+    // failed, as they would have been without coalescing.
+    std::vector<future<>> synchronous_updates;
+    for (auto& u : coalesced) {
+        const bool synchronous = u.synchronous;
+        auto f = send_remote_view_updates(_proxy.local(), std::move(u), base_token, stats, cf_stats, allow_hints, tr_state);
+        if (synchronous) {
+            synchronous_updates.push_back(std::move(f));
+        } else {
+            // The updates are sent to background in order to preserve availability,
+            // their parallelism is limited by view_update_concurrency_semaphore
+            (void)f;
+        }
+    }
+    auto sent = co_await coroutine::as_future(when_all_succeed(synchronous_updates.begin(), synchronous_updates.end()).discard_result());
+    if (routed.failed()) {
+        sent.ignore_ready_future();
+        co_await coroutine::return_exception_ptr(routed.get_exception());
+    }
+    co_await std::move(sent);
 }
 
 view_builder::view_builder(replica::database& db, db::system_keyspace& sys_ks, db::system_distributed_keyspace& sys_dist_ks, service::migration_notifier& mn, view_update_generator& vug)
@@ -1902,6 +2020,7 @@ future<> view_builder::initialize_reader_at_current_token(build_step& step) {
             nullptr,
             streamed_mutation::forwarding::no,
             mutation_reader::forwarding::no);
+    step.reader.set_max_buffer_size(reader_buffer_size);
   });
 }
 
@@ -2400,16 +2519,24 @@ class view_builder::consumer {
             _fragments.emplace_front(*_step.reader.schema(), _builder._permit, partition_start(_step.current_key, tombstone()));
             auto base_schema = _step.base->schema();
             auto views = with_base_info_snapshot(_views_to_build);
+            auto units = get_units(_builder._partitions_sem, 1).get0();
             auto reader = make_flat_mutation_reader_from_fragments(_step.reader.schema(), _builder._permit, std::move(_fragments));
             auto close_reader = defer([&reader] { reader.close().get(); });
             reader.upgrade_schema(base_schema);
-            _step.base->populate_views(
+            close_reader.cancel();
+            // Waited for by view_builder::wait_for_partitions().
+            (void)_step.base->populate_views(
                     _gen,
                     std::move(views),
                     _step.current_token(),
                     std::move(reader),
-                    _now).get();
-            close_reader.cancel();
+                    _now).then_wrapped([&builder = _builder, units = std::move(units)] (future<> f) {
+                if (f.failed() && !builder._partitions_error) {
+                    builder._partitions_error = f.get_exception();
+                } else {
+                    f.ignore_ready_future();
+                }
+            });
             _fragments.clear();
             _fragments_memory_usage = 0;
         }
@@ -2424,6 +2551,9 @@ class view_builder::consumer {
     // Must be called in a seastar thread.
     built_views consume_end_of_stream() {
         inject_failure("view_builder_consume_end_of_stream");
+        // The views must not be found built, nor the build restarted at the
+        // beginning of the ring, before the rows read so far are applied.
+        _builder.wait_for_partitions();
         if (vlogger.is_enabled(log_level::debug)) {
             auto view_names = boost::copy_range<std::vector<sstring>>(
                     _views_to_build | boost::adaptors::transformed([](auto v) {
@@ -2444,6 +2574,14 @@ class view_builder::consumer {
     }
 };
 
+// Called in the context of a seastar::thread.
+void view_builder::wait_for_partitions() {
+    get_units(_partitions_sem, max_concurrent_partitions).get();
+    if (auto ep = std::exchange(_partitions_error, nullptr)) {
+        std::rethrow_exception(std::move(ep));
+    }
+}
+
 // Called in the context of a seastar::thread.
 void view_builder::execute(build_step& step, exponential_backoff_retry r) {
     gc_clock::time_point now = gc_clock::now();
@@ -2453,8 +2591,28 @@ void view_builder::execute(build_step& step, exponential_backoff_retry r) {
             step.pslice,
             batch_size,
             query::max_partitions);
+    // The partitions whose view updates failed to be applied in the background
+    // may have been read by the step long before, so a failed step is retried
+    // from where it began.
+    auto start_key = step.current_key;
+    auto start_status = step.build_status;
     auto consumer = compact_for_query_v2<view_builder::consumer>(compaction_state, view_builder::consumer{*this, _vug.shared_from_this(), step, now});
-    auto built = step.reader.consume_in_thread(std::move(consumer));
+    auto built = [&] {
+        try {
+            auto built = step.reader.consume_in_thread(std::move(consumer));
+            wait_for_partitions();
+            return built;
+        } catch (...) {
+            auto ep = std::current_exception();
+            try {
+                wait_for_partitions();
+            } catch (...) {
+            }
+            step.current_key = std::move(start_key);
+            step.build_status = std::move(start_status);
+            std::rethrow_exception(std::move(ep));
+        }
+    }();
     if (auto ds = std::move(*compaction_state).detach_state()) {
         if (ds->current_tombstone) {
             step.reader.unpop_mutation_fragment(mutation_fragment_v2(*step.reader.schema(), step.reader.permit(), std::move(*ds->current_tombstone)));
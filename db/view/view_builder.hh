@@ -174,6 +174,11 @@ class view_builder final : public service::migration_listener::only_view_notific
     std::unordered_map<std::pair<sstring, sstring>, seastar::shared_promise<>, utils::tuple_hash> _build_notifiers;
     stats _stats;
     metrics::metric_groups _metrics;
+    // The view updates of the base partitions read by a build step are
+    // applied in the background, while the next partitions are read, up to
+    // max_concurrent_partitions at a time. See wait_for_partitions().
+    seastar::semaphore _partitions_sem{max_concurrent_partitions};
+    std::exception_ptr _partitions_error;
 
     struct view_builder_init_state {
         std::vector<future<>> bookkeeping_ops;
@@ -188,6 +193,10 @@ class view_builder final : public service::migration_listener::only_view_notific
     // collected batch_memory_max bytes, we can process the rows read so far.
     static constexpr size_t batch_size = 128;
     static constexpr size_t batch_memory_max = 1024*1024;
+    static constexpr size_t max_concurrent_partitions = 16;
+    // Readers of the base table read fragments ahead in buffers of this size,
+    // instead of the default one, as they read the whole table sequentially.
+    static constexpr size_t reader_buffer_size = 128*1024;
 
     replica::database& get_db() noexcept { return _db; }
 
@@ -231,6 +240,7 @@ class view_builder final : public service::migration_listener::only_view_notific
     future<> add_new_view(view_ptr, build_step&);
     future<> do_build_step();
     void execute(build_step&, exponential_backoff_retry);
+    void wait_for_partitions();
     future<> maybe_mark_view_as_built(view_ptr, dht::token);
     void setup_metrics();
 
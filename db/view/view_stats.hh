@@ -19,6 +19,10 @@ struct stats : public service::storage_proxy_stats::write_stats {
     int64_t view_updates_pushed_remote = 0;
     int64_t view_updates_failed_local = 0;
     int64_t view_updates_failed_remote = 0;
+    int64_t view_update_batches_pushed_remote = 0;
+    // Memory taken by the pending view updates generated by writes to the
+    // base table, see replica::table::get_view_update_backlog().
+    int64_t view_update_backlog_bytes = 0;
     using label_instance = seastar::metrics::label_instance;
     stats(const sstring& category, label_instance ks_label, label_instance cf_label);
     void register_stats();
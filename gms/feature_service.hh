@@ -111,6 +111,14 @@ class feature_service final {
     gms::feature collection_indexing { *this, "COLLECTION_INDEXING"sv };
     gms::feature large_collection_detection { *this, "LARGE_COLLECTION_DETECTION"sv };
     gms::feature secondary_indexes_on_static_columns { *this, "SECONDARY_INDEXES_ON_STATIC_COLUMNS"sv };
+    gms::feature mutation_batch_verb { *this, "MUTATION_BATCH_VERB"sv };
+    gms::feature sstable_file_streaming { *this, "SSTABLE_FILE_STREAMING"sv };
+    gms::feature hint_mutation_batch_verb { *this, "HINT_MUTATION_BATCH_VERB"sv };
+    gms::feature view_update_backlog_per_table { *this, "VIEW_UPDATE_BACKLOG_PER_TABLE"sv };
+    gms::feature replica_filtering { *this, "REPLICA_FILTERING"sv };
+    gms::feature grouped_parallelized_aggregation { *this, "GROUPED_PARALLELIZED_AGGREGATION"sv };
+    gms::feature alternator_leader_rmw { *this, "ALTERNATOR_LEADER_RMW"sv };
+    gms::feature group0_snapshot_chunks { *this, "GROUP0_SNAPSHOT_CHUNKS"sv };
 
 public:
 
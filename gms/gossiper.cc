@@ -693,6 +693,7 @@ future<> gossiper::remove_endpoint(inet_address endpoint) {
     _unreachable_endpoints.erase(endpoint);
     _syn_handlers.erase(endpoint);
     _ack_handlers.erase(endpoint);
+    _syn_peers.erase(endpoint);
     quarantine_endpoint(endpoint);
     logger.debug("removing endpoint {}", endpoint);
 }
@@ -1286,8 +1287,52 @@ future<version_type> gossiper::get_current_heart_beat_version(inet_address endpo
     });
 }
 
+static version_type get_max_application_state_version(const endpoint_state& state) noexcept {
+    version_type max_version;
+    for (auto& entry : state.get_application_state_map()) {
+        max_version = std::max(max_version, entry.second.version());
+    }
+    return max_version;
+}
+
+gossip_digest_syn gossiper::make_gossip_digest_syn_for(inet_address to, const gossip_digest_syn& message) {
+    auto to_state = get_endpoint_state_for_endpoint_ptr(to);
+    auto peer_generation = to_state ? to_state->get_heart_beat_state().get_generation() : generation_type();
+    auto& peer = _syn_peers[to];
+    // A restarted peer remembers nothing of what it was told before.
+    if (peer.peer_generation != peer_generation || peer.syns_since_full >= syns_between_full_digests) {
+        peer.peer_generation = peer_generation;
+        peer.advertised.clear();
+        peer.syns_since_full = 0;
+    } else {
+        peer.syns_since_full++;
+    }
+
+    auto local = get_broadcast_address();
+    utils::chunked_vector<gossip_digest> digests;
+    for (auto& g_digest : message.get_gossip_digests()) {
+        auto ep = g_digest.get_endpoint();
+        auto es = get_endpoint_state_for_endpoint_ptr(ep);
+        auto advertised = std::make_pair(g_digest.get_generation(), es ? get_max_application_state_version(*es) : version_type());
+        auto [it, inserted] = peer.advertised.try_emplace(ep, advertised);
+        if (inserted || it->second != advertised || ep == local) {
+            it->second = advertised;
+            digests.push_back(g_digest);
+        }
+    }
+    logger.trace("make_gossip_digest_syn_for(): to={}, digests {} of {}", to, digests.size(), message.get_gossip_digests().size());
+    return gossip_digest_syn(message.cluster_id(), message.partioner(), std::move(digests));
+}
+
 future<> gossiper::do_gossip_to_live_member(gossip_digest_syn message, gms::inet_address ep) {
-    return send_gossip(message, {ep});
+    auto id = get_msg_addr(ep);
+    logger.trace("Sending a GossipDigestSyn to {} ...", id);
+    return _messaging.send_gossip_digest_syn(id, make_gossip_digest_syn_for(ep, message)).handle_exception([this, id, g = shared_from_this()] (auto ep) {
+        // The peer may not have seen what the message advertised, so
+        // advertise everything to it next time.
+        _syn_peers.erase(id.addr);
+        logger.trace("Fail to send GossipDigestSyn to {}: {}", id, ep);
+    });
 }
 
 future<> gossiper::do_gossip_to_unreachable_member(gossip_digest_syn message) {
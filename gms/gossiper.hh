@@ -70,6 +70,16 @@ struct ack_msg_pending {
     std::optional<utils::chunked_vector<gossip_digest>> ack_msg_digest;
 };
 
+// What a node last advertised to a peer in its gossip_digest_syn messages.
+struct syn_peer_state {
+    // The peer's generation when it was last sent a full digest list.
+    generation_type peer_generation;
+    // The generation and the maximum application state version advertised
+    // for each endpoint.
+    std::unordered_map<inet_address, std::pair<generation_type, version_type>> advertised;
+    unsigned syns_since_full = 0;
+};
+
 struct gossip_config {
     seastar::scheduling_group gossip_scheduling_group = seastar::scheduling_group();
     sstring cluster_name;
@@ -123,6 +133,10 @@ class gossiper : public seastar::async_sharded_service<gossiper>, public seastar
     seastar::gate _background_msg;
     std::unordered_map<gms::inet_address, syn_msg_pending> _syn_handlers;
     std::unordered_map<gms::inet_address, ack_msg_pending> _ack_handlers;
+    std::unordered_map<gms::inet_address, syn_peer_state> _syn_peers;
+    // Every this many syn messages to a peer carry the full digest list,
+    // in case a previous one was lost.
+    static constexpr unsigned syns_between_full_digests = 10;
     bool _advertise_myself = true;
     // Map ip address and generation number
     generation_for_nodes _advertise_to_nodes;
@@ -326,6 +340,14 @@ class gossiper : public seastar::async_sharded_service<gossiper>, public seastar
      */
     void make_random_gossip_digest(utils::chunked_vector<gossip_digest>& g_digests);
 
+    /**
+     * Narrows the digests of a syn message to what changed since they were
+     * last advertised to the given peer: endpoints which are new to it, or
+     * whose generation or application states changed. Heartbeats alone
+     * don't count, each node advertises its own in every message.
+     */
+    gossip_digest_syn make_gossip_digest_syn_for(inet_address to, const gossip_digest_syn& message);
+
 public:
     /**
      * This method will begin removing an existing endpoint from the cluster by spoofing its state
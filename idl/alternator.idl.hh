@@ -0,0 +1,20 @@
+/*
+ * Copyright 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "idl/tracing.idl.hh"
+
+namespace alternator {
+
+// Runs a PutItem, UpdateItem or DeleteItem request, given by the name of
+// the operation and the request's JSON, on the leader of its item, for
+// tables using the "leader_rmw" write isolation policy. Returns the JSON of
+// the item's Attributes to return, and if the request failed, the type,
+// message and HTTP status code of its error.
+verb [[with_timeout]] alternator_leader_rmw (sstring operation, sstring request, std::optional<tracing::trace_info> trace_info) -> sstring, sstring, sstring, uint16_t;
+
+}
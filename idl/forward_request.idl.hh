@@ -39,10 +39,12 @@ struct forward_request {
     lowres_system_clock::time_point timeout;
 
     std::optional<std::vector<query::forward_request::aggregation_info>> aggregation_infos [[version 5.1]];
+    std::vector<sstring> group_by_columns [[version 5.4]];
 };
 
 struct forward_result {
     std::vector<bytes_opt> query_results;
+    std::vector<std::vector<bytes_opt>> grouped_results [[version 5.4]];
 };
 
 verb forward_request(query::forward_request, std::optional<tracing::trace_info>) -> query::forward_result;
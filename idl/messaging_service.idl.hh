@@ -11,6 +11,8 @@ namespace netw {
 struct schema_pull_options {
     bool remote_supports_canonical_mutation_retval;
     bool group0_snapshot_transfer [[version 4.7]] = false;
+    std::optional<sstring> group0_snapshot_start_after [[version 5.4]];
+    uint32_t group0_snapshot_max_keyspaces [[version 5.4]] = 0;
 };
 
 } // namespace netw
@@ -19,6 +19,11 @@ class repair_hash {
     uint64_t hash;
 };
 
+struct repair_range_summary {
+    uint64_t seed;
+    repair_hash hash;
+};
+
 struct partition_key_and_mutation_fragments {
     partition_key get_key();
     std::list<frozen_mutation_fragment> get_mutation_fragments();
@@ -70,6 +75,7 @@ enum class repair_row_level_start_status: uint8_t {
 
 struct repair_row_level_start_response {
     repair_row_level_start_status status;
+    std::optional<repair_range_summary> summary [[version 5.4]];
 };
 
 enum class node_ops_cmd : uint32_t {
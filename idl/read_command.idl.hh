@@ -46,6 +46,20 @@ struct max_result_size {
     uint64_t page_size [[version 4.7]] = 0;
 }
 
+struct column_filter {
+    enum class op : uint8_t {
+        eq,
+        neq,
+        lt,
+        lte,
+        gt,
+        gte,
+    };
+    uint32_t column;
+    query::column_filter::op oper;
+    bytes value;
+};
+
 class read_command {
     table_id cf_id;
     table_schema_version schema_version;
@@ -59,6 +73,7 @@ class read_command {
     std::optional<query::max_result_size> max_result_size [[version 4.3]] = std::nullopt;
     uint32_t row_limit_high_bits [[version 4.3]] = 0;
     uint64_t tombstone_limit [[version 5.2]] = query::max_tombstones;
+    std::vector<query::column_filter> filters [[version 5.4]];
 };
 
 }
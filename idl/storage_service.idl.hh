@@ -27,6 +27,7 @@ namespace service {
   struct raft_topology_snapshot {
       std::vector<canonical_mutation> topology_mutations;
       std::optional<canonical_mutation> cdc_generation_mutation;
+      std::vector<canonical_mutation> tablet_mutations [[version 5.4]];
   };
 
   struct raft_topology_pull_params {};
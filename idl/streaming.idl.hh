@@ -55,4 +55,11 @@ enum class stream_mutation_fragments_cmd : uint8_t {
     end_of_stream,
 };
 
+enum class stream_sstable_files_cmd : uint8_t {
+    error,
+    file_data,
+    end_of_file,
+    end_of_stream,
+};
+
 }
@@ -61,6 +61,7 @@ class lua_slice_state {
         : a_state(std::move(a_state))
         , _l(std::move(l)) {}
     operator lua_State*() { return _l.get(); }
+    const alloc_state& limits() const { return *a_state; }
 };
 }
 
@@ -435,6 +436,72 @@ static lua_slice_state load_script(const lua::runtime_config& cfg, lua::bitcode_
     return l;
 }
 
+namespace lua {
+// A state of a state_cache. Its stack holds the function loaded by
+// load_script_l and the metatable of the environments of its calls.
+struct cached_state {
+    lua_slice_state l;
+};
+}
+
+static int make_env_metatable_l(lua_State* l) {
+    // {__index = _G}
+    lua_createtable(l, 0, 1);
+    lua_pushglobaltable(l);
+    lua_setfield(l, -2, "__index");
+    return 1;
+}
+
+static std::unique_ptr<lua::cached_state> load_cached_state(const lua::runtime_config& cfg, lua::bitcode_view binary) {
+    lua_slice_state l = load_script(cfg, binary);
+    lua_pushcfunction(l, make_env_metatable_l);
+    if (lua_pcall(l, 0, 1, 0)) {
+        throw std::runtime_error(std::string("could not initiate: ") + lua_tostring(l, -1));
+    }
+    return std::make_unique<lua::cached_state>(std::move(l));
+}
+
+// Returns a new thread holding the function (argument 1), ready to be resumed.
+// Each call gets its own global environment, which falls back to the shared
+// one through the metatable (argument 2), so that the globals set by a call
+// are not seen by the next calls which reuse the state.
+static int prepare_call_l(lua_State* l) {
+    lua_State* thread = lua_newthread(l);
+    lua_pushvalue(l, 1);
+    lua_newtable(l);
+    lua_pushvalue(l, 2);
+    lua_setmetatable(l, -2);
+    // The first upvalue of a main chunk is its environment.
+    if (!lua_setupvalue(l, -2, 1)) {
+        luaL_error(l, "the function has no environment");
+    }
+    lua_xmove(l, thread, 1);
+    return 1;
+}
+
+lua::state_cache::state_cache() = default;
+lua::state_cache::state_cache(state_cache&&) noexcept = default;
+lua::state_cache::~state_cache() = default;
+
+std::unique_ptr<lua::cached_state> lua::state_cache::get(const runtime_config& cfg, bitcode_view bitcode) {
+    while (!_idle.empty()) {
+        auto state = std::move(_idle.back());
+        _idle.pop_back();
+        // Drop the states created before the limits were changed.
+        auto& limits = state->l.limits();
+        if (limits.max == cfg.max_bytes() && limits.max_contiguous == cfg.max_contiguous()) {
+            return state;
+        }
+    }
+    return load_cached_state(cfg, bitcode);
+}
+
+void lua::state_cache::put(std::unique_ptr<cached_state> state) {
+    if (_idle.size() < max_idle_states) {
+        _idle.push_back(std::move(state));
+    }
+}
+
 using millisecond = std::chrono::duration<double, std::milli>;
 static auto now() { return std::chrono::system_clock::now(); }
 
@@ -884,7 +951,7 @@ static data_value convert_from_lua(lua_State* l, const data_type& type) {
     return ::visit(*type, from_lua_visitor{l});
 }
 
-static bytes_opt convert_return(lua_slice_state &l, const data_type& return_type) {
+static bytes_opt convert_return(lua_State* l, const data_type& return_type) {
     int num_return_vals = lua_gettop(l);
     if (num_return_vals != 1) {
         throw exceptions::invalid_request_exception(
@@ -1049,6 +1116,48 @@ static void push_argument(lua_State* l, const data_value& arg) {
     ::visit(arg, to_lua_visitor{l});
 }
 
+// Like push_argument, but converts the common scalar types without deserializing
+// them to a data_value first.
+static void push_serialized_argument(lua_State* l, const data_type& type, const bytes_opt& arg) {
+    if (!arg) {
+        lua_pushnil(l);
+        return;
+    }
+    bytes_view v = *arg;
+    // Empty values, which have no fixed size, go through the data_value path.
+    if (v.size() == type->value_length_if_fixed()) {
+        switch (type->get_kind()) {
+        case abstract_type::kind::byte:
+            lua_pushinteger(l, read_simple_exactly<int8_t>(v));
+            return;
+        case abstract_type::kind::short_kind:
+            lua_pushinteger(l, read_simple_exactly<int16_t>(v));
+            return;
+        case abstract_type::kind::int32:
+            lua_pushinteger(l, read_simple_exactly<int32_t>(v));
+            return;
+        case abstract_type::kind::long_kind:
+            lua_pushinteger(l, read_simple_exactly<int64_t>(v));
+            return;
+        case abstract_type::kind::float_kind:
+            lua_pushnumber(l, std::bit_cast<float>(read_simple_exactly<int32_t>(v)));
+            return;
+        case abstract_type::kind::double_kind:
+            lua_pushnumber(l, std::bit_cast<double>(read_simple_exactly<int64_t>(v)));
+            return;
+        case abstract_type::kind::boolean:
+            lua_pushboolean(l, v[0] != 0);
+            return;
+        default:
+            break;
+        }
+    } else if (type->get_kind() == abstract_type::kind::ascii || type->get_kind() == abstract_type::kind::utf8) {
+        lua_pushlstring(l, reinterpret_cast<const char*>(v.data()), v.size());
+        return;
+    }
+    push_argument(l, type->deserialize(v));
+}
+
 lua::runtime_config lua::make_runtime_config(const db::config& config) {
     utils::updateable_value<unsigned> max_bytes(config.user_defined_function_allocation_limit_bytes);
     utils::updateable_value<unsigned> max_contiguous(config.user_defined_function_contiguous_allocation_limit_bytes());
@@ -1057,23 +1166,15 @@ lua::runtime_config lua::make_runtime_config(const db::config& config) {
     return lua::runtime_config{std::move(timeout_in_ms), std::move(max_bytes), std::move(max_contiguous)};
 }
 
-// run the script for at most max_instructions
-future<bytes_opt> lua::run_script(lua::bitcode_view bitcode, const std::vector<data_value>& values, data_type return_type, const lua::runtime_config& cfg) {
-    lua_slice_state l = load_script(cfg, bitcode);
-    unsigned nargs = values.size();
-    if (!lua_checkstack(l, nargs)) {
-        throw std::runtime_error("could push args to the stack");
-    }
-    for (const data_value& arg : values) {
-        push_argument(l, arg);
-    }
-
+// Resumes l, which holds the function and its nargs arguments, until the function returns.
+// l must be kept alive until the returned future is resolved.
+static future<bytes_opt> resume_script(lua_State* l, unsigned nargs, data_type return_type, const lua::runtime_config& cfg) {
     // We don't update the timeout once we start executing the function
     using millisecond = std::chrono::duration<double, std::milli>;
     using duration = std::chrono::system_clock::duration;
     duration elapsed{0};
     duration timeout = std::chrono::duration_cast<duration>(millisecond(cfg.timeout_in_ms));
-    return repeat_until_value([l = std::move(l), elapsed, return_type, nargs, timeout = std::move(timeout)] () mutable {
+    return repeat_until_value([l, elapsed, return_type, nargs, timeout = std::move(timeout)] () mutable {
         // Set the hook before resuming. We have to do it here since the hook can reset itself
         // if it detects we are spending too much time in C.
         // The hook will be called after 1000 instructions.
@@ -1099,6 +1200,49 @@ future<bytes_opt> lua::run_script(lua::bitcode_view bitcode, const std::vector<d
     });
 }
 
+// run the script for at most max_instructions
+future<bytes_opt> lua::run_script(lua::bitcode_view bitcode, const std::vector<data_value>& values, data_type return_type, const lua::runtime_config& cfg) {
+    lua_slice_state l = load_script(cfg, bitcode);
+    unsigned nargs = values.size();
+    if (!lua_checkstack(l, nargs)) {
+        throw std::runtime_error("could push args to the stack");
+    }
+    for (const data_value& arg : values) {
+        push_argument(l, arg);
+    }
+    return do_with(std::move(l), [nargs, return_type = std::move(return_type), &cfg] (lua_slice_state& l) {
+        return resume_script(l, nargs, std::move(return_type), cfg);
+    });
+}
+
+future<bytes_opt> lua::run_script(lua::bitcode_view bitcode, state_cache& states, std::span<const bytes_opt> params,
+        const std::vector<data_type>& arg_types, data_type return_type, const lua::runtime_config& cfg) {
+    auto state = states.get(cfg, bitcode);
+    lua_State* l = state->l;
+    lua_pushcfunction(l, prepare_call_l);
+    lua_pushvalue(l, 1);
+    lua_pushvalue(l, 2);
+    if (lua_pcall(l, 2, 1, 0)) {
+        throw std::runtime_error(std::string("could not prepare the call: ") + lua_tostring(l, -1));
+    }
+    // The thread stays referenced by the stack of the state until the call is done.
+    lua_State* thread = lua_tothread(l, -1);
+    unsigned nargs = params.size();
+    if (!lua_checkstack(thread, nargs)) {
+        throw std::runtime_error("could push args to the stack");
+    }
+    for (unsigned i = 0; i < nargs; ++i) {
+        push_serialized_argument(thread, arg_types[i], params[i]);
+    }
+    // A state whose call failed may be in any state, so it is only returned to
+    // the cache when the call succeeds.
+    return resume_script(thread, nargs, std::move(return_type), cfg).then([&states, state = std::move(state)] (bytes_opt ret) mutable {
+        lua_settop(state->l, 2);
+        states.put(std::move(state));
+        return ret;
+    });
+}
+
 namespace lua {
 
 void register_metatables(lua_State* l) {
@@ -12,6 +12,10 @@
 #include "utils/updateable_value.hh"
 #include <seastar/core/future.hh>
 
+#include <memory>
+#include <span>
+#include <vector>
+
 namespace db {
 class config;
 }
@@ -30,7 +34,36 @@ struct runtime_config {
 
 runtime_config make_runtime_config(const db::config& config);
 
+struct cached_state;
+
+// Lua states which have loaded the bitcode of a function, kept between its calls
+// so they don't have to create and initialize a new state each time.
+// Each call takes a state out of the cache, so concurrent calls use different states.
+// Only used by the shard which created it.
+class state_cache {
+    std::vector<std::unique_ptr<cached_state>> _idle;
+public:
+    // The number of idle states kept by a cache; the states of calls which find
+    // the cache full are destroyed.
+    static constexpr size_t max_idle_states = 4;
+
+    state_cache();
+    state_cache(state_cache&&) noexcept;
+    ~state_cache();
+
+    size_t idle_states() const noexcept {
+        return _idle.size();
+    }
+
+    std::unique_ptr<cached_state> get(const runtime_config& cfg, bitcode_view bitcode);
+    void put(std::unique_ptr<cached_state>);
+};
+
 sstring compile(const runtime_config& cfg, const std::vector<sstring>& arg_names, sstring script);
 seastar::future<bytes_opt> run_script(bitcode_view bitcode, const std::vector<data_value>& values,
                                       data_type return_type, const runtime_config& cfg);
+// Like above, but reuses a state of the cache and takes the arguments in their
+// serialized form, which is converted directly to Lua values for the common scalar types.
+seastar::future<bytes_opt> run_script(bitcode_view bitcode, state_cache& states, std::span<const bytes_opt> params,
+                                      const std::vector<data_type>& arg_types, data_type return_type, const runtime_config& cfg);
 }
@@ -13,6 +13,8 @@
 #include "utils/ascii.hh"
 #include "utils/date.h"
 #include "db/config.hh"
+#include <filesystem>
+#include <fstream>
 #include <seastar/core/byteorder.hh>
 #include <seastar/core/coroutine.hh>
 #include <seastar/util/defer.hh>
@@ -28,7 +30,9 @@ logging::logger wasm_logger("wasm");
 namespace wasm {
 
 startup_context::startup_context(db::config& cfg, replica::database_config& dbcfg)
-    : alien_runner(std::make_shared<wasm::alien_thread_runner>())
+    : alien_runner(std::make_shared<wasm::alien_thread_runner>(cfg.saved_caches_directory().empty()
+            ? std::filesystem::path()
+            : std::filesystem::path(cfg.saved_caches_directory()) / "wasm"))
     , engine(std::make_shared<rust::Box<wasmtime::Engine>>(wasmtime::create_engine(cfg.wasm_udf_memory_limit())))
     , cache_size(dbcfg.available_memory * cfg.wasm_cache_memory_fraction())
     , instance_size(cfg.wasm_cache_instance_size_limit())
@@ -227,13 +231,114 @@ struct from_val_visitor {
     }
 };
 
+// Compiled modules are saved in the alien thread's compiled_module_dir(), in files named
+// after the hash of their source, holding:
+//   compiled_module_magic, compile time in nanoseconds (u64), source size (u64), source, module.
+// The source is compared on load, so hash collisions only cost a recompilation. So does
+// a module compiled by another version of wasmtime, which fails to deserialize.
+static constexpr std::string_view compiled_module_magic = "SCYWASM1";
+
+static std::filesystem::path compiled_module_path(const std::filesystem::path& dir, std::string_view script) {
+    return dir / format("{:016x}.cwasm", std::hash<std::string_view>()(script));
+}
+
+// Runs in the alien thread.
+static std::optional<rust::Box<wasmtime::Module>> load_compiled_module(wasmtime::Engine& engine, const std::filesystem::path& file,
+        std::string_view script, std::chrono::nanoseconds& compile_time) {
+    std::ifstream in(file, std::ios::binary);
+    if (!in) {
+        return std::nullopt;
+    }
+    std::string contents((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::string_view v = contents;
+    auto read_u64 = [&v] {
+        uint64_t x;
+        std::memcpy(&x, v.data(), sizeof(x));
+        v.remove_prefix(sizeof(x));
+        return x;
+    };
+    if (v.size() < compiled_module_magic.size() + 2 * sizeof(uint64_t) || !v.starts_with(compiled_module_magic)) {
+        return std::nullopt;
+    }
+    v.remove_prefix(compiled_module_magic.size());
+    compile_time = std::chrono::nanoseconds(read_u64());
+    auto script_size = read_u64();
+    if (v.size() < script_size || v.substr(0, script_size) != script) {
+        return std::nullopt;
+    }
+    v.remove_prefix(script_size);
+    try {
+        return wasmtime::create_module_from_serialized(engine, rust::Slice<const uint8_t>(reinterpret_cast<const uint8_t*>(v.data()), v.size()));
+    } catch (const rust::Error& e) {
+        wasm_logger.info("Compiling again the module saved in {}: {}", file.native(), e.what());
+        return std::nullopt;
+    }
+}
+
+// Runs in the alien thread.
+static void save_compiled_module(const std::filesystem::path& file, std::string_view script, const wasmtime::Module& module,
+        std::chrono::nanoseconds compile_time) {
+    std::filesystem::create_directories(file.parent_path());
+    auto tmp_file = file;
+    tmp_file += ".tmp";
+    {
+        std::ofstream out(tmp_file, std::ios::binary | std::ios::trunc);
+        auto write_u64 = [&out] (uint64_t x) {
+            out.write(reinterpret_cast<const char*>(&x), sizeof(x));
+        };
+        auto serialized = module.serialized();
+        out.write(compiled_module_magic.data(), compiled_module_magic.size());
+        write_u64(compile_time.count());
+        write_u64(script.size());
+        out.write(script.data(), script.size());
+        out.write(reinterpret_cast<const char*>(serialized.data()), serialized.size());
+        out.flush();
+        if (!out) {
+            throw std::runtime_error(format("failed to write {}", tmp_file.native()));
+        }
+    }
+    std::filesystem::rename(tmp_file, file);
+}
+
 seastar::future<> precompile(alien_thread_runner& alien_runner, context& ctx, const std::vector<sstring>& arg_names, std::string script) {
     seastar::promise<rust::Box<wasmtime::Module>> done;
-    alien_runner.submit(done, [&engine_ptr = ctx.engine_ptr, script = std::move(script)] {
-        return wasmtime::create_module(engine_ptr, rust::Str(script.data(), script.size()));
+    // Written by the alien thread before it resolves done.
+    struct {
+        bool loaded = false;
+        std::chrono::nanoseconds compile_time{};
+    } result;
+    alien_runner.submit(done, [&engine_ptr = ctx.engine_ptr, script = std::move(script), dir = alien_runner.compiled_module_dir(), &result] {
+        std::filesystem::path file;
+        if (!dir.empty()) {
+            file = compiled_module_path(dir, script);
+            if (auto module = load_compiled_module(engine_ptr, file, script, result.compile_time)) {
+                result.loaded = true;
+                return std::move(*module);
+            }
+        }
+        auto start = std::chrono::steady_clock::now();
+        auto module = wasmtime::create_module(engine_ptr, rust::Str(script.data(), script.size()));
+        result.compile_time = std::chrono::steady_clock::now() - start;
+        if (!file.empty()) {
+            try {
+                save_compiled_module(file, script, *module, result.compile_time);
+            } catch (...) {
+                wasm_logger.warn("Failed to save the compiled module to {}: {}", file.native(), std::current_exception());
+            }
+        }
+        return module;
     });
 
     ctx.module = co_await done.get_future();
+    if (!alien_runner.compiled_module_dir().empty()) {
+        auto& stats = ctx.cache.shard_stats();
+        if (result.loaded) {
+            ++stats.compiled_module_hits;
+            stats.compile_time_saved += std::chrono::duration_cast<std::chrono::milliseconds>(result.compile_time);
+        } else {
+            ++stats.compiled_module_misses;
+        }
+    }
     std::exception_ptr ex;
     try {
         // After precompiling the module, we try creating a store, an instance and a function with it to make sure it's valid.
@@ -330,4 +435,36 @@ seastar::future<bytes_opt> run_script(const db::functions::function_name& name,
     }
     return make_ready_future<bytes_opt>(ret);
 }
+
+seastar::future<std::vector<bytes_opt>> run_script_batch(const db::functions::function_name& name, context& ctx, const std::vector<data_type>& arg_types, std::span<const std::vector<bytes_opt>> rows, data_type return_type, bool allow_null_input) {
+    wasm::instance_cache::value_type func_inst;
+    std::exception_ptr ex;
+    std::vector<bytes_opt> ret;
+    ret.reserve(rows.size());
+    try {
+        // Looking up and locking the instance is paid once for the whole batch,
+        // the instance stays locked for this scheduling group until it is recycled.
+        func_inst = ctx.cache.get(name, arg_types, ctx).get0();
+        for (auto& params : rows) {
+            if (ctx.cache.is_oversized(func_inst)) {
+                // Let the cache drop the grown instance, as it would between single calls.
+                ctx.cache.recycle(std::exchange(func_inst, wasm::instance_cache::value_type()));
+                func_inst = ctx.cache.get(name, arg_types, ctx).get0();
+            }
+            ret.push_back(wasm::run_script(ctx, *func_inst->instance->store, *func_inst->instance->instance, *func_inst->instance->func, arg_types, params, return_type, allow_null_input).get0());
+        }
+    } catch (const wasm::instance_corrupting_exception& e) {
+        func_inst->instance = std::nullopt;
+        ex = std::current_exception();
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    if (func_inst) {
+        ctx.cache.recycle(func_inst);
+    }
+    if (ex) {
+        std::rethrow_exception(std::move(ex));
+    }
+    return make_ready_future<std::vector<bytes_opt>>(std::move(ret));
+}
 }
@@ -59,4 +59,7 @@ seastar::future<> precompile(alien_thread_runner& alien_runner, context& ctx, co
 
 seastar::future<bytes_opt> run_script(const db::functions::function_name& name, context& ctx, const std::vector<data_type>& arg_types, std::span<const bytes_opt> params, data_type return_type, bool allow_null_input);
 
+// Calls the function once for each row of params, acquiring the cached instance only once.
+seastar::future<std::vector<bytes_opt>> run_script_batch(const db::functions::function_name& name, context& ctx, const std::vector<data_type>& arg_types, std::span<const std::vector<bytes_opt>> rows, data_type return_type, bool allow_null_input);
+
 }
@@ -36,8 +36,9 @@ void task_queue::push_back(std::optional<wasm_compile_task> work_item) {
     _cv.notify_one();
 }
 
-alien_thread_runner::alien_thread_runner()
-    : _thread([this] {
+alien_thread_runner::alien_thread_runner(std::filesystem::path compiled_module_dir)
+    : _compiled_module_dir(std::move(compiled_module_dir))
+    , _thread([this] {
         sigset_t mask;
         sigfillset(&mask);
         auto r = ::pthread_sigmask(SIG_BLOCK, &mask, nullptr);
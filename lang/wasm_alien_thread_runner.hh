@@ -12,6 +12,7 @@
 #include <mutex>
 #include <queue>
 #include <condition_variable>
+#include <filesystem>
 #include <thread>
 
 #include <seastar/core/future.hh>
@@ -39,13 +40,20 @@ struct task_queue {
 
 class alien_thread_runner {
     task_queue _pending_queue;
+    // Where compiled modules are saved, to be reused instead of being compiled again
+    // by other shards and after restarts. Empty if they are not saved.
+    std::filesystem::path _compiled_module_dir;
     std::thread _thread;
 public:
-    alien_thread_runner();
+    explicit alien_thread_runner(std::filesystem::path compiled_module_dir = {});
     ~alien_thread_runner();
     alien_thread_runner(const alien_thread_runner&) = delete;
     alien_thread_runner& operator=(const alien_thread_runner&) = delete;
     void submit(seastar::promise<rust::Box<wasmtime::Module>>& p, std::function<rust::Box<wasmtime::Module>()> f);
+
+    const std::filesystem::path& compiled_module_dir() const noexcept {
+        return _compiled_module_dir;
+    }
 };
 
 } // namespace wasm
@@ -63,6 +63,12 @@ void instance_cache::setup_metrics() {
                         sm::description("The number of user defined functions loaded")),
         sm::make_counter("cache_blocks", wasm::instance_cache::shard_stats().cache_blocks,
                         sm::description("The number of times a user defined function waited for an instance")),
+        sm::make_counter("compiled_module_hits", wasm::instance_cache::shard_stats().compiled_module_hits,
+                        sm::description("The number of user defined function modules loaded already compiled from disk")),
+        sm::make_counter("compiled_module_misses", wasm::instance_cache::shard_stats().compiled_module_misses,
+                        sm::description("The number of user defined function modules compiled because they were not found on disk")),
+        sm::make_counter("compile_time_saved_ms", [this] { return _stats.compile_time_saved.count(); },
+                        sm::description("The total compilation time of the user defined function modules loaded already compiled from disk, in milliseconds")),
         sm::make_gauge("cache_instace_count_any", [this] { return _cache.size(); },
                         sm::description("The total number of cached wasm instances, instances in use and empty instances")),
         sm::make_gauge("cache_total_size", [this] { return _total_size; },
@@ -204,6 +210,10 @@ void instance_cache::recycle(instance_cache::value_type val) noexcept {
     }
 }
 
+bool instance_cache::is_oversized(const value_type& val) const {
+    return val->instance && get_instance_size(val->instance.value()) > _max_instance_size;
+}
+
 void instance_cache::remove(const db::functions::function_name& name, const std::vector<data_type>& arg_types) noexcept {
     auto [it,end_it] = _cache.equal_range(name);
     while (it != end_it) {
@@ -61,6 +61,10 @@ class instance_cache {
         uint64_t cache_hits = 0;
         uint64_t cache_misses = 0;
         uint64_t cache_blocks = 0;
+        uint64_t compiled_module_hits = 0;
+        uint64_t compiled_module_misses = 0;
+        // Compile time of the modules which were loaded already compiled.
+        std::chrono::milliseconds compile_time_saved{0};
     };
 
 private:
@@ -128,6 +132,10 @@ class instance_cache {
 
     void recycle(value_type inst) noexcept;
 
+    // Returns true if the instance grew past the instance size limit,
+    // in which case recycle() drops it instead of caching it.
+    bool is_oversized(const value_type& inst) const;
+
     void remove(const db::functions::function_name& name, const std::vector<data_type>& arg_types) noexcept;
 
 private:
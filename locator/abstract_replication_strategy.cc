@@ -15,6 +15,7 @@
 #include <seastar/coroutine/parallel_for_each.hh>
 #include "replica/database.hh"
 #include "utils/stall_free.hh"
+#include "utils/array-search.hh"
 
 namespace locator {
 
@@ -63,15 +64,11 @@ sstring abstract_replication_strategy::to_qualified_class_name(std::string_view
 }
 
 inet_address_vector_replica_set abstract_replication_strategy::get_natural_endpoints(const token& search_token, const effective_replication_map& erm) const {
-    const token& key_token = erm.get_token_metadata_ptr()->first_token(search_token);
-    auto res = erm.get_replication_map().find(key_token);
-    return res->second;
+    return erm.ring_replicas(search_token);
 }
 
 stop_iteration abstract_replication_strategy::for_each_natural_endpoint_until(const token& search_token, const effective_replication_map& erm, const noncopyable_function<stop_iteration(const inet_address&)>& func) const {
-    const token& key_token = erm.get_token_metadata_ptr()->first_token(search_token);
-    auto res = erm.get_replication_map().find(key_token);
-    for (const auto& ep : res->second) {
+    for (const auto& ep : erm.ring_replicas(search_token)) {
         if (func(ep) == stop_iteration::yes) {
             return stop_iteration::yes;
         }
@@ -319,7 +316,9 @@ future<mutable_effective_replication_map_ptr> calculate_effective_replication_ma
     }
 
     auto rf = rs->get_replication_factor(*tmptr);
-    co_return make_effective_replication_map(std::move(rs), std::move(tmptr), std::move(replication_map), rf);
+    auto erm = make_effective_replication_map(std::move(rs), std::move(tmptr), std::move(replication_map), rf);
+    co_await erm->build_ring();
+    co_return erm;
 }
 
 future<replication_map> effective_replication_map::clone_endpoints_gently() const {
@@ -333,6 +332,50 @@ future<replication_map> effective_replication_map::clone_endpoints_gently() cons
     co_return cloned_endpoints;
 }
 
+future<> effective_replication_map::build_ring() {
+    const auto& sorted_tokens = _tmptr->sorted_tokens();
+    _ring_tokens.reserve(sorted_tokens.size() + ring_search_window);
+    _ring_replicas.reserve(sorted_tokens.size());
+    for (const auto& t : sorted_tokens) {
+        _ring_tokens.push_back(t.raw());
+        _ring_replicas.push_back(&_replication_map.at(t));
+        co_await coroutine::maybe_yield();
+    }
+    // Lets the search scan a full window past any token of the ring.
+    _ring_tokens.resize(_ring_tokens.size() + ring_search_window, std::numeric_limits<int64_t>::max());
+}
+
+size_t effective_replication_map::ring_index(const token& search_token) const {
+    auto ring_size = _ring_replicas.size();
+    auto key = search_token.raw();
+    // Tokens after all keys wrap around to the start of the ring, like those
+    // after the last token of the ring.
+    if (search_token.is_maximum() || key == std::numeric_limits<int64_t>::min()) {
+        return 0;
+    }
+    // Branch-free binary search, down to a window small enough to be scanned
+    // with SIMD. All tokens before base are less than key, and base[n], if
+    // within the ring, is not.
+    const int64_t* base = _ring_tokens.data();
+    size_t n = ring_size;
+    while (n > ring_search_window) {
+        auto half = n / 2;
+        base = base[half] < key ? base + half : base;
+        n -= half;
+    }
+    // The first token greater than key - 1 is the first one not less than key.
+    size_t i = (base - _ring_tokens.data()) + utils::array_search_gt(key - 1, base, ring_search_window, ring_search_window);
+    return i < ring_size ? i : 0;
+}
+
+const inet_address_vector_replica_set& effective_replication_map::ring_replicas(const token& search_token) const {
+    if (_ring_replicas.empty()) [[unlikely]] {
+        // Throws if there are no tokens.
+        return _replication_map.find(_tmptr->first_token(search_token))->second;
+    }
+    return *_ring_replicas[ring_index(search_token)];
+}
+
 inet_address_vector_replica_set effective_replication_map::get_natural_endpoints(const token& search_token) const {
     return _rs->get_natural_endpoints(search_token, *this);
 }
@@ -342,6 +385,8 @@ stop_iteration effective_replication_map::for_each_natural_endpoint_until(const
 }
 
 future<> effective_replication_map::clear_gently() noexcept {
+    _ring_tokens.clear();
+    _ring_replicas.clear();
     co_await utils::clear_gently(_replication_map);
     co_await utils::clear_gently(_tmptr);
 }
@@ -389,6 +434,7 @@ future<effective_replication_map_ptr> effective_replication_map_factory::create_
         auto rf = ref_erm->get_replication_factor();
         auto local_replication_map = co_await ref_erm->clone_endpoints_gently();
         new_erm = make_effective_replication_map(std::move(rs), std::move(tmptr), std::move(local_replication_map), rf);
+        co_await new_erm->build_ring();
     } else {
         new_erm = co_await calculate_effective_replication_map(std::move(rs), std::move(tmptr));
     }
@@ -159,9 +159,21 @@ class effective_replication_map : public enable_lw_shared_from_this<effective_re
     size_t _replication_factor;
     std::optional<factory_key> _factory_key = std::nullopt;
     effective_replication_map_factory* _factory = nullptr;
+    // The replication map flattened for finding the replicas of a token on
+    // the hot path: the raw values of the ring's sorted tokens, followed by
+    // ring_search_window of padding, and the replicas of each of them.
+    std::vector<int64_t> _ring_tokens;
+    std::vector<const inet_address_vector_replica_set*> _ring_replicas;
+    // Size of the tail of the search in _ring_tokens done with SIMD, see
+    // utils::array_search_gt(). Must be a multiple of 4.
+    static constexpr size_t ring_search_window = 16;
 
     friend class abstract_replication_strategy;
     friend class effective_replication_map_factory;
+
+    // Index in the ring of the first token not less than search_token, wrapping around.
+    size_t ring_index(const token& search_token) const;
+    const inet_address_vector_replica_set& ring_replicas(const token& search_token) const;
 public:
     explicit effective_replication_map(abstract_replication_strategy::ptr_type rs, token_metadata_ptr tmptr, replication_map replication_map, size_t replication_factor) noexcept
         : _rs(std::move(rs))
@@ -201,6 +213,10 @@ class effective_replication_map : public enable_lw_shared_from_this<effective_re
 
     future<replication_map> clone_endpoints_gently() const;
 
+    // Builds the flat ring used for finding the replicas of tokens, once the
+    // replication map is complete.
+    future<> build_ring();
+
     inet_address_vector_replica_set get_natural_endpoints(const token& search_token) const;
     stop_iteration for_each_natural_endpoint_until(const token& search_token, const noncopyable_function<stop_iteration(const inet_address&)>& func) const;
     inet_address_vector_replica_set get_natural_endpoints_without_node_being_replaced(const token& search_token) const;
@@ -0,0 +1,233 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/core/bitops.hh>
+#include <seastar/core/coroutine.hh>
+#include <seastar/coroutine/maybe_yield.hh>
+
+#include <boost/range/algorithm/find.hpp>
+#include <boost/range/algorithm/replace.hpp>
+
+#include "locator/tablets.hh"
+
+namespace locator {
+
+tablet_transition_info migration_to_transition_info(const tablet_info& ti, const tablet_replica& src, const tablet_replica& dst) {
+    if (boost::find(ti.replicas, src) == ti.replicas.end()) {
+        throw std::runtime_error(format("Tablet replica {} is not a replica of the tablet", src));
+    }
+    for (auto& r : ti.replicas) {
+        if (r.host == dst.host) {
+            throw std::runtime_error(format("Host {} is already a replica of the tablet", dst.host));
+        }
+    }
+    auto next = ti.replicas;
+    boost::replace(next, src, dst);
+    return tablet_transition_info{std::move(next), dst};
+}
+
+tablet_map::tablet_map(size_t tablet_count)
+        : _log2_tablets(log2ceil(tablet_count)) {
+    if (tablet_count == 0 || tablet_count != size_t(1) << _log2_tablets) {
+        throw std::invalid_argument(format("Tablet count must be a power of 2, got {}", tablet_count));
+    }
+    _tablets.resize(tablet_count);
+}
+
+void tablet_map::check_tablet_id(tablet_id id) const {
+    if (size_t(id) >= tablet_count()) {
+        throw std::logic_error(format("Invalid tablet id: {} >= {}", id, tablet_count()));
+    }
+}
+
+tablet_id tablet_map::get_tablet_id(dht::token t) const {
+    if (_log2_tablets == 0) {
+        return tablet_id(0);
+    }
+    switch (t._kind) {
+    case dht::token::kind::before_all_keys:
+        return tablet_id(0);
+    case dht::token::kind::after_all_keys:
+        return tablet_id(tablet_count() - 1);
+    case dht::token::kind::key:
+        return tablet_id(dht::unbias(t) >> (64 - _log2_tablets));
+    }
+    __builtin_unreachable();
+}
+
+dht::token tablet_map::get_first_token(tablet_id id) const {
+    check_tablet_id(id);
+    if (id == 0) {
+        // The lowest value of a token, INT64_MIN, is not a legal token.
+        return dht::bias(1);
+    }
+    return dht::bias(uint64_t(id) << (64 - _log2_tablets));
+}
+
+dht::token tablet_map::get_last_token(tablet_id id) const {
+    check_tablet_id(id);
+    if (size_t(id) == tablet_count() - 1) {
+        return dht::bias(std::numeric_limits<uint64_t>::max());
+    }
+    return dht::bias((uint64_t(id + 1) << (64 - _log2_tablets)) - 1);
+}
+
+dht::token_range tablet_map::get_token_range(tablet_id id) const {
+    if (id == 0) {
+        return dht::token_range::make_ending_with({get_last_token(id), true});
+    }
+    return dht::token_range::make({get_last_token(tablet_id(id - 1)), false}, {get_last_token(id), true});
+}
+
+const tablet_info& tablet_map::get_tablet_info(tablet_id id) const {
+    check_tablet_id(id);
+    return _tablets[size_t(id)];
+}
+
+void tablet_map::set_tablet(tablet_id id, tablet_info info) {
+    check_tablet_id(id);
+    _tablets[size_t(id)] = std::move(info);
+}
+
+const tablet_transition_info* tablet_map::get_tablet_transition_info(tablet_id id) const {
+    auto it = _transitions.find(id);
+    if (it == _transitions.end()) {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+void tablet_map::set_tablet_transition_info(tablet_id id, tablet_transition_info info) {
+    check_tablet_id(id);
+    _transitions.insert_or_assign(id, std::move(info));
+}
+
+void tablet_map::finish_tablet_transition(tablet_id id) {
+    auto it = _transitions.find(id);
+    if (it == _transitions.end()) {
+        throw std::runtime_error(format("Tablet {} is not in transition", id));
+    }
+    _tablets[size_t(id)].replicas = std::move(it->second.next);
+    _transitions.erase(it);
+}
+
+tablet_map tablet_map::split() const {
+    if (!_transitions.empty()) {
+        throw std::runtime_error(format("Cannot split tablets while {} of them are in transition", _transitions.size()));
+    }
+    tablet_map ret(tablet_count() * 2);
+    for (size_t i = 0; i < tablet_count(); ++i) {
+        ret._tablets[2 * i] = _tablets[i];
+        ret._tablets[2 * i + 1] = _tablets[i];
+    }
+    return ret;
+}
+
+bool tablet_map::can_merge() const noexcept {
+    if (tablet_count() == 1 || !_transitions.empty()) {
+        return false;
+    }
+    for (size_t i = 0; i < tablet_count(); i += 2) {
+        if (_tablets[i] != _tablets[i + 1]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+tablet_map tablet_map::merge() const {
+    if (!can_merge()) {
+        throw std::runtime_error(format("Cannot merge tablets: there are {} tablets, {} in transition, or siblings are not co-located",
+                tablet_count(), _transitions.size()));
+    }
+    tablet_map ret(tablet_count() / 2);
+    for (size_t i = 0; i < ret.tablet_count(); ++i) {
+        ret._tablets[i] = _tablets[2 * i];
+    }
+    return ret;
+}
+
+size_t tablet_map::tablet_count_on(host_id host) const {
+    size_t count = 0;
+    for (auto& info : _tablets) {
+        for (auto& r : info.replicas) {
+            if (r.host == host) {
+                ++count;
+                break;
+            }
+        }
+    }
+    return count;
+}
+
+const tablet_map& tablet_metadata::get_tablet_map(table_id id) const {
+    auto it = _tablets.find(id);
+    if (it == _tablets.end()) {
+        throw std::runtime_error(format("Tablet map not found for table {}", id));
+    }
+    return *it->second;
+}
+
+void tablet_metadata::set_tablet_map(table_id id, tablet_map map) {
+    _tablets.insert_or_assign(id, make_lw_shared<const tablet_map>(std::move(map)));
+}
+
+void tablet_metadata::drop_tablet_map(table_id id) {
+    _tablets.erase(id);
+}
+
+future<> tablet_metadata::clear_gently() {
+    for (auto it = _tablets.begin(); it != _tablets.end(); it = _tablets.erase(it)) {
+        co_await coroutine::maybe_yield();
+    }
+}
+
+bool tablet_metadata::operator==(const tablet_metadata& o) const {
+    if (_tablets.size() != o._tablets.size()) {
+        return false;
+    }
+    for (auto& [id, map] : _tablets) {
+        auto it = o._tablets.find(id);
+        if (it == o._tablets.end() || *it->second != *map) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::ostream& operator<<(std::ostream& out, const tablet_replica& r) {
+    return out << r.host << ":" << r.shard;
+}
+
+std::ostream& operator<<(std::ostream& out, const tablet_map& map) {
+    out << "{";
+    for (auto id : map.tablet_ids()) {
+        out << (id == 0 ? "" : ", ") << id << ": [";
+        auto& replicas = map.get_tablet_info(id).replicas;
+        for (size_t i = 0; i < replicas.size(); ++i) {
+            out << (i == 0 ? "" : ", ") << replicas[i];
+        }
+        out << "]";
+        if (auto trinfo = map.get_tablet_transition_info(id)) {
+            out << " -> " << trinfo->pending_replica;
+        }
+    }
+    return out << "}";
+}
+
+std::ostream& operator<<(std::ostream& out, const tablet_metadata& tm) {
+    out << "{";
+    bool first = true;
+    for (auto& [id, map] : tm._tablets) {
+        out << (first ? "" : ", ") << id << ": " << *map;
+        first = false;
+    }
+    return out << "}";
+}
+
+}
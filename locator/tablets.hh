@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include "dht/token.hh"
+#include "dht/i_partitioner.hh"
+#include "locator/host_id.hh"
+#include "schema/schema_fwd.hh"
+#include "utils/tagged_integer.hh"
+#include "seastarx.hh"
+
+#include <seastar/core/future.hh>
+#include <seastar/core/shared_ptr.hh>
+#include <seastar/core/smp.hh>
+
+#include <boost/range/irange.hpp>
+#include <boost/range/adaptor/transformed.hpp>
+
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace locator {
+
+// Tablets split the token ring of a table into tablet_count() contiguous ranges
+// of equal size, where tablet_count() is a power of two. Each tablet is replicated
+// on its own set of shards, independently of the other tablets, so the ownership
+// of the data of a table can be changed one tablet at a time:
+//
+//   - a tablet is migrated by replacing one of its replicas,
+//   - all the tablets of a table are split in two when the table grows,
+//   - sibling tablets are merged back when they are co-located and the table shrinks.
+//
+// The tablet maps of all tables are kept in token_metadata, and are changed
+// through group 0, see system.tablets.
+
+using tablet_id = utils::tagged_integer<struct tablet_id_tag, size_t>;
+
+/// Identifies a single replica of a tablet.
+struct tablet_replica {
+    host_id host;
+    shard_id shard;
+
+    bool operator==(const tablet_replica&) const = default;
+};
+
+using tablet_replica_set = std::vector<tablet_replica>;
+
+/// Placement of a tablet.
+struct tablet_info {
+    tablet_replica_set replicas;
+
+    bool operator==(const tablet_info&) const = default;
+};
+
+/// Describes an ongoing migration of a tablet.
+/// While the tablet is in transition, writes go to both the current replicas
+/// and pending_replica, and reads are served by the current replicas.
+struct tablet_transition_info {
+    // The replica set which will become the tablet's replica set once the migration is done.
+    tablet_replica_set next;
+    // The replica of next which is not a replica of the tablet yet.
+    tablet_replica pending_replica;
+
+    bool operator==(const tablet_transition_info&) const = default;
+};
+
+/// Computes the transition of a tablet which moves its replica src to dst.
+/// Throws std::runtime_error if src is not a replica of the tablet, or if dst already is.
+tablet_transition_info migration_to_transition_info(const tablet_info&, const tablet_replica& src, const tablet_replica& dst);
+
+/// Placement of the tablets of a single table.
+class tablet_map {
+    // The tablet_count() == 2^_log2_tablets tablets, ordered by token.
+    std::vector<tablet_info> _tablets;
+    std::unordered_map<tablet_id, tablet_transition_info> _transitions;
+    unsigned _log2_tablets;
+private:
+    void check_tablet_id(tablet_id) const;
+public:
+    /// Creates a map with tablet_count tablets, which have no replicas.
+    /// tablet_count must be a power of two.
+    explicit tablet_map(size_t tablet_count);
+
+    size_t tablet_count() const noexcept {
+        return _tablets.size();
+    }
+
+    auto tablet_ids() const {
+        return boost::irange<size_t>(0, tablet_count()) | boost::adaptors::transformed([] (size_t i) {
+            return tablet_id(i);
+        });
+    }
+
+    /// Returns the tablet which owns the token t.
+    tablet_id get_tablet_id(dht::token t) const;
+
+    dht::token get_first_token(tablet_id) const;
+    dht::token get_last_token(tablet_id) const;
+
+    /// Returns the range of tokens owned by the tablet, (last token of the previous tablet, last token].
+    dht::token_range get_token_range(tablet_id) const;
+
+    const tablet_info& get_tablet_info(tablet_id) const;
+    void set_tablet(tablet_id, tablet_info);
+
+    /// Returns nullptr if the tablet is not in transition.
+    const tablet_transition_info* get_tablet_transition_info(tablet_id) const;
+    const std::unordered_map<tablet_id, tablet_transition_info>& transitions() const noexcept {
+        return _transitions;
+    }
+    void set_tablet_transition_info(tablet_id, tablet_transition_info);
+    /// Makes transition.next the tablet's replica set and ends the transition.
+    void finish_tablet_transition(tablet_id);
+
+    /// Returns the tablet which covers the same tokens as the given tablet
+    /// and its sibling, once merged.
+    static tablet_id parent_of(tablet_id id) noexcept {
+        return tablet_id(id.value() / 2);
+    }
+
+    /// Returns a map with twice as many tablets, where each tablet is split in two halves
+    /// which keep its replicas. Throws std::runtime_error if a tablet is in transition.
+    tablet_map split() const;
+
+    /// Returns true iff merge() may be called, that is when there is more than
+    /// one tablet, none of them is in transition and each pair of siblings has
+    /// the same replicas.
+    bool can_merge() const noexcept;
+
+    /// Returns a map with half as many tablets, where each pair of sibling tablets
+    /// is merged. Throws std::runtime_error unless can_merge().
+    tablet_map merge() const;
+
+    /// Returns the number of tablets which have a replica on the host.
+    size_t tablet_count_on(host_id) const;
+
+    bool operator==(const tablet_map&) const = default;
+
+    friend std::ostream& operator<<(std::ostream&, const tablet_map&);
+};
+
+using tablet_map_ptr = lw_shared_ptr<const tablet_map>;
+
+/// Placement of the tablets of all tables which use tablets.
+///
+/// Tablet maps are immutable once set, so copying the metadata,
+/// as token_metadata::clone_async() does, is cheap.
+class tablet_metadata {
+    std::unordered_map<table_id, tablet_map_ptr> _tablets;
+public:
+    bool has_tablet_map(table_id id) const noexcept {
+        return _tablets.contains(id);
+    }
+    /// Throws std::runtime_error if the table does not use tablets.
+    const tablet_map& get_tablet_map(table_id) const;
+    const std::unordered_map<table_id, tablet_map_ptr>& all_tables() const noexcept {
+        return _tablets;
+    }
+    void set_tablet_map(table_id, tablet_map);
+    void drop_tablet_map(table_id);
+
+    future<> clear_gently();
+
+    bool operator==(const tablet_metadata&) const;
+
+    friend std::ostream& operator<<(std::ostream&, const tablet_metadata&);
+};
+
+std::ostream& operator<<(std::ostream&, const tablet_replica&);
+
+}
@@ -64,6 +64,8 @@ class token_metadata_impl final {
 
     topology _topology;
 
+    tablet_metadata _tablets;
+
     long _ring_version = 0;
     static thread_local long _static_ring_version;
 
@@ -71,6 +73,8 @@ class token_metadata_impl final {
     // clone_async() must be updated to copy that member.
 
     void sort_tokens();
+    // Like sort_tokens(), but yields, for rings with many tokens.
+    future<> sort_tokens_gently();
 
     struct shallow_copy {};
     token_metadata_impl(shallow_copy, const token_metadata_impl& o) noexcept
@@ -124,6 +128,14 @@ class token_metadata_impl final {
         return _topology;
     }
 
+    tablet_metadata& tablets() {
+        return _tablets;
+    }
+
+    const tablet_metadata& tablets() const {
+        return _tablets;
+    }
+
     void debug_show() const;
 
     /**
@@ -195,14 +207,12 @@ class token_metadata_impl final {
      * @return new token metadata
      */
     future<token_metadata_impl> clone_after_all_left() const noexcept {
-      return clone_only_token_map(false).then([this] (token_metadata_impl all_left_metadata) {
+        auto all_left_metadata = co_await clone_only_token_map(false);
         for (auto endpoint : _leaving_endpoints) {
             all_left_metadata.remove_endpoint(endpoint);
         }
-        all_left_metadata.sort_tokens();
-
-        return all_left_metadata;
-      });
+        co_await all_left_metadata.sort_tokens_gently();
+        co_return all_left_metadata;
     }
 
     /**
@@ -352,6 +362,7 @@ future<token_metadata_impl> token_metadata_impl::clone_async() const noexcept {
         ret._pending_ranges_interval_map.emplace(p);
         co_await coroutine::maybe_yield();
     }
+    ret._tablets = _tablets;
     ret._ring_version = _ring_version;
     co_return ret;
 }
@@ -381,6 +392,7 @@ future<> token_metadata_impl::clear_gently() noexcept {
     co_await utils::clear_gently(_pending_ranges_interval_map);
     co_await utils::clear_gently(_sorted_tokens);
     co_await _topology.clear_gently();
+    co_await _tablets.clear_gently();
     co_return;
 }
 
@@ -397,6 +409,20 @@ void token_metadata_impl::sort_tokens() {
     _sorted_tokens = std::move(sorted);
 }
 
+future<> token_metadata_impl::sort_tokens_gently() {
+    std::vector<token> sorted;
+    sorted.reserve(_token_to_endpoint_map.size());
+
+    for (auto&& i : _token_to_endpoint_map) {
+        sorted.push_back(i.first);
+        co_await coroutine::maybe_yield();
+    }
+
+    co_await utils::sort_gently(sorted);
+
+    _sorted_tokens = std::move(sorted);
+}
+
 const std::vector<token>& token_metadata_impl::sorted_tokens() const {
     return _sorted_tokens;
 }
@@ -464,7 +490,7 @@ future<> token_metadata_impl::update_normal_tokens(std::unordered_set<token> tok
     // New tokens were added to _token_to_endpoint_map
     // so re-sort all tokens.
     if (should_sort_tokens) {
-        sort_tokens();
+        co_await sort_tokens_gently();
     }
     co_return;
 }
@@ -851,7 +877,7 @@ void token_metadata_impl::calculate_pending_ranges_for_bootstrap(
         }
         all_left_metadata->_impl->remove_endpoint(endpoint);
     }
-    all_left_metadata->_impl->sort_tokens();
+    all_left_metadata->_impl->sort_tokens_gently().get();
 }
 
 future<> token_metadata_impl::update_pending_ranges(
@@ -1040,6 +1066,16 @@ token_metadata::get_topology() const {
     return _impl->get_topology();
 }
 
+tablet_metadata&
+token_metadata::tablets() {
+    return _impl->tablets();
+}
+
+const tablet_metadata&
+token_metadata::tablets() const {
+    return _impl->tablets();
+}
+
 void
 token_metadata::debug_show() const {
     _impl->debug_show();
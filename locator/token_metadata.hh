@@ -27,6 +27,7 @@
 
 #include "locator/types.hh"
 #include "locator/topology.hh"
+#include "locator/tablets.hh"
 
 // forward declaration since replica/database.hh includes this file
 namespace replica {
@@ -136,6 +137,10 @@ class token_metadata final {
 
     topology& get_topology();
     const topology& get_topology() const;
+
+    // Placement of the tablets of the tables which use tablets.
+    tablet_metadata& tablets();
+    const tablet_metadata& tablets() const;
     void debug_show() const;
 
     /**
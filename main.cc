@@ -39,6 +39,7 @@
 #include "utils/runtime.hh"
 #include "log.hh"
 #include "utils/directories.hh"
+#include "utils/cpu_profiler.hh"
 #include "debug.hh"
 #include "auth/common.hh"
 #include "init.hh"
@@ -81,6 +82,7 @@
 #include "tombstone_gc_extension.hh"
 #include "db/tags/extension.hh"
 #include "db/paxos_grace_seconds_extension.hh"
+#include "db/sstable_filter_type_extension.hh"
 #include "service/qos/standard_service_level_distributed_data_accessor.hh"
 #include "service/storage_proxy.hh"
 #include "service/forward_service.hh"
@@ -483,6 +485,7 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
     ext->add_schema_extension<db::paxos_grace_seconds_extension>(db::paxos_grace_seconds_extension::NAME);
     ext->add_schema_extension<tombstone_gc_extension>(tombstone_gc_extension::NAME);
     ext->add_schema_extension<db::per_partition_rate_limit_extension>(db::per_partition_rate_limit_extension::NAME);
+    ext->add_schema_extension<db::sstable_filter_type_extension>(db::sstable_filter_type_extension::NAME);
 
     auto cfg = make_lw_shared<db::config>(ext);
     auto init = app.get_options_description().add_options();
@@ -611,7 +614,8 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
                 sighup_handler.stop().get();
             });
 
-            logalloc::prime_segment_pool(memory::stats().total_memory(), memory::min_free_memory()).get();
+            logalloc::prime_segment_pool(memory::stats().total_memory(), memory::min_free_memory(),
+                    logalloc::use_huge_pages(cfg->lsa_huge_pages())).get();
             logging::apply_settings(cfg->logging_settings(app.options().log_opts));
 
             startlog.info(startup_msg, scylla_version(), get_build_id());
@@ -808,7 +812,7 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
             // });
 
             supervisor::notify("creating tracing");
-            tracing::tracing::create_tracing("trace_keyspace_helper").get();
+            tracing::tracing::create_tracing(cfg->tracing_backend() == "ring_buffer" ? "ring_buffer_backend" : "trace_keyspace_helper").get();
             auto destroy_tracing = defer_verbose_shutdown("tracing instance", [] {
                 tracing::tracing::tracing_instance().stop().get();
             });
@@ -827,6 +831,19 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
 
             api::set_server_config(ctx, *cfg).get();
 
+            static sharded<utils::cpu_profiler> cpu_profiler;
+            cpu_profiler.start(sharded_parameter([&] {
+                return utils::updateable_value<uint32_t>(cfg->cpu_profiler_frequency_hz);
+            })).get();
+            auto stop_cpu_profiler = defer_verbose_shutdown("CPU profiler", [] {
+                cpu_profiler.stop().get();
+            });
+            cpu_profiler.invoke_on_all(&utils::cpu_profiler::start).get();
+            api::set_server_cpu_profiler(ctx, cpu_profiler).get();
+            auto stop_cpu_profiler_api = defer_verbose_shutdown("CPU profiler API", [&ctx] {
+                api::unset_server_cpu_profiler(ctx).get();
+            });
+
             // Note: changed from using a move here, because we want the config object intact.
             replica::database_config dbcfg;
             dbcfg.compaction_scheduling_group = make_sched_group("compaction", 1000);
@@ -864,6 +881,13 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
             } else if (compress_what == "dc") {
                 mscfg.compress = netw::messaging_service::compress_what::dc;
             }
+            sstring compression_algorithm = cfg->internode_compression_algorithm();
+            if (compression_algorithm == "zstd") {
+                mscfg.compression = netw::messaging_service::compression_algorithm::zstd;
+            } else if (compression_algorithm != "lz4") {
+                startlog.error("Bad configuration: invalid internode_compression_algorithm {}, expected lz4 or zstd", compression_algorithm);
+                throw bad_configuration_error();
+            }
 
             if (encrypt == "all") {
                 mscfg.encrypt = netw::messaging_service::encrypt_what::all;
@@ -873,6 +897,8 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
                 mscfg.encrypt = netw::messaging_service::encrypt_what::rack;
             }
 
+            mscfg.shard_aware = cfg->shard_aware_internode_connections();
+
             if (!cfg->inter_dc_tcp_nodelay()) {
                 mscfg.tcp_nodelay = netw::messaging_service::tcp_nodelay_what::local;
             }
@@ -910,6 +936,16 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
             auto stop_ms = defer_verbose_shutdown("messaging service", [&messaging] {
                 messaging.invoke_on_all(&netw::messaging_service::stop).get();
             });
+            auto set_rpc_latency_sample_rate = [&messaging] (double rate) {
+                return messaging.invoke_on_all([rate] (netw::messaging_service& ms) {
+                    ms.set_verb_latency_sample_rate(rate);
+                });
+            };
+            set_rpc_latency_sample_rate(cfg->rpc_latency_sample_rate()).get();
+            auto rpc_latency_sample_rate_observer = cfg->rpc_latency_sample_rate.observe([set_rpc_latency_sample_rate] (double rate) {
+                // Setting a field of each shard can't fail.
+                (void)set_rpc_latency_sample_rate(rate);
+            });
 
             static sharded<db::system_distributed_keyspace> sys_dist_ks;
             static sharded<db::system_keyspace> sys_ks;
@@ -1041,6 +1077,9 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
                     .available_memory = dbcfg.available_memory,
                     .static_shares = cfg->compaction_static_shares,
                     .throughput_mb_per_sec = cfg->compaction_throughput_mb_per_sec,
+                    .major_compaction_parallelism = cfg->major_compaction_parallelism,
+                    .backlog_forecast_horizon_in_ms = cfg->compaction_backlog_forecast_horizon_in_ms,
+                    .max_concurrent_compactions_per_keyspace = cfg->max_concurrent_compactions_per_keyspace,
                 };
             });
             cm.start(std::move(get_cm_cfg), std::ref(stop_signal.as_sharded_abort_source()), std::ref(task_manager)).get();
@@ -1140,7 +1179,7 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
             });
 
             supervisor::notify("starting query processor");
-            cql3::query_processor::memory_config qp_mcfg = {memory::stats().total_memory() / 256, memory::stats().total_memory() / 2560};
+            cql3::query_processor::memory_config qp_mcfg = {memory::stats().total_memory() / 256, memory::stats().total_memory() / 2560, memory::stats().total_memory() / 2560};
             debug::the_query_processor = &qp;
             auto local_data_dict = seastar::sharded_parameter([] (const replica::database& db) { return db.as_data_dictionary(); }, std::ref(db));
 
@@ -1314,6 +1353,9 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
                     cf.trigger_compaction();
                 }
             }).get();
+
+            supervisor::notify("starting cache warmup");
+            db.invoke_on_all(&replica::database::start_cache_warmup).get();
             api::set_server_gossip(ctx, gossiper).get();
             api::set_server_snitch(ctx, snitch).get();
             auto stop_snitch_api = defer_verbose_shutdown("snitch API", [&ctx] {
@@ -1437,7 +1479,7 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
             api::set_server_task_manager_test(ctx).get();
 #endif
             supervisor::notify("starting sstables loader");
-            sst_loader.start(std::ref(db), std::ref(sys_dist_ks), std::ref(view_update_generator), std::ref(messaging)).get();
+            sst_loader.start(std::ref(db), std::ref(sys_dist_ks), std::ref(view_update_generator), std::ref(messaging), std::ref(task_manager)).get();
             auto stop_sst_loader = defer_verbose_shutdown("sstables loader", [&sst_loader] {
                 sst_loader.stop().get();
             });
@@ -1542,7 +1584,7 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
                 api::unset_server_authorization_cache(ctx).get();
             });
 
-            snapshot_ctl.start(std::ref(db)).get();
+            snapshot_ctl.start(std::ref(db), std::ref(task_manager)).get();
             auto stop_snapshot_ctl = defer_verbose_shutdown("snapshots", [&snapshot_ctl] {
                 snapshot_ctl.stop().get();
             });
@@ -1630,7 +1672,7 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
             notify_set.notify_all(configurable::system_state::started).get();
 
             scheduling_group_key_config cql_sg_stats_cfg = make_scheduling_group_key_config<cql_transport::cql_sg_stats>();
-            cql_transport::controller cql_server_ctl(auth_service, mm_notifier, gossiper, qp, service_memory_limiter, sl_controller, lifecycle_notifier, *cfg, scheduling_group_key_create(cql_sg_stats_cfg).get0());
+            cql_transport::controller cql_server_ctl(auth_service, mm_notifier, gossiper, qp, service_memory_limiter, sl_controller, lifecycle_notifier, cdc, *cfg, scheduling_group_key_create(cql_sg_stats_cfg).get0());
 
             ss.local().register_protocol_server(cql_server_ctl);
 
@@ -1673,7 +1715,7 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
                 api::unset_rpc_controller(ctx).get();
             });
 
-            alternator::controller alternator_ctl(gossiper, proxy, mm, sys_dist_ks, cdc_generation_service, service_memory_limiter, auth_service, sl_controller, *cfg);
+            alternator::controller alternator_ctl(gossiper, proxy, mm, sys_dist_ks, cdc_generation_service, service_memory_limiter, auth_service, sl_controller, messaging, *cfg);
             sharded<alternator::expiration_service> es;
             std::any stop_expiration_service;
 
@@ -1782,10 +1824,13 @@ int main(int ac, char** av) {
         {"server", scylla_main, "the scylladb server"},
         {"types", tools::scylla_types_main, "a command-line tool to examine values belonging to scylla types"},
         {"sstable", tools::scylla_sstable_main, "a multifunctional command-line tool to examine the content of sstables"},
+        {"perf-compaction", perf::scylla_compaction_main, "run performance tests by compacting generated sstables with each compaction strategy on this server"},
         {"perf-fast-forward", perf::scylla_fast_forward_main, "run performance tests by fast forwarding the reader on this server"},
         {"perf-row-cache-update", perf::scylla_row_cache_update_main, "run performance tests by updating row cache on this server"},
+        {"perf-schema-merge", perf::scylla_schema_merge_main, "run performance tests by applying schema changes to a keyspace with many tables on this server"},
         {"perf-simple-query", perf::scylla_simple_query_main, "run performance tests by sending simple queries to this server"},
         {"perf-sstable", perf::scylla_sstable_main, "run performance tests by exercising sstable related operations on this server"},
+        {"perf-workload", perf::scylla_workload_main, "run performance tests by sending a configurable mix of queries with realistic key distributions to this server"},
     };
 
     main_func_type main_func;
@@ -6,6 +6,8 @@
  * SPDX-License-Identifier: AGPL-3.0-or-later
  */
 
+#include <random>
+
 #include <seastar/core/coroutine.hh>
 #include <seastar/coroutine/as_future.hh>
 #include <seastar/coroutine/exception.hh>
@@ -20,11 +22,13 @@
 #include "query-request.hh"
 #include "query-result.hh"
 #include <seastar/rpc/rpc.hh>
+#include <seastar/core/metrics.hh>
 #include "mutation/canonical_mutation.hh"
 #include "schema_mutations.hh"
 #include "db/config.hh"
 #include "db/view/view_update_backlog.hh"
 #include "dht/i_partitioner.hh"
+#include "dht/token-sharding.hh"
 #include "range.hh"
 #include "frozen_schema.hh"
 #include "repair/repair.hh"
@@ -37,12 +41,14 @@
 #include "utils/digest_algorithm.hh"
 #include "streaming/stream_reason.hh"
 #include "streaming/stream_mutation_fragments_cmd.hh"
+#include "streaming/stream_sstable_files_cmd.hh"
 #include "cache_temperature.hh"
 #include "raft/raft.hh"
 #include "service/raft/group0_fwd.hh"
 #include "replica/exceptions.hh"
 #include "serializer.hh"
 #include "full_position.hh"
+#include "utils/histogram_metrics_helper.hh"
 #include "db/per_partition_rate_limit_info.hh"
 #include "service/topology_state_machine.hh"
 #include "idl/consistency_level.dist.hh"
@@ -105,15 +111,19 @@
 #include <seastar/rpc/lz4_compressor.hh>
 #include <seastar/rpc/lz4_fragmented_compressor.hh>
 #include <seastar/rpc/multi_algo_compressor_factory.hh>
+#include "message/zstd_rpc_compressor.hh"
 #include "partition_range_compat.hh"
 #include <boost/range/adaptor/filtered.hpp>
 #include <boost/range/adaptor/indirected.hpp>
 #include "mutation/frozen_mutation.hh"
 #include "streaming/stream_manager.hh"
 #include "streaming/stream_mutation_fragments_cmd.hh"
+#include "streaming/stream_sstable_files_cmd.hh"
 #include "idl/partition_checksum.dist.impl.hh"
 #include "idl/forward_request.dist.hh"
 #include "idl/forward_request.dist.impl.hh"
+#include "idl/alternator.dist.hh"
+#include "idl/alternator.dist.impl.hh"
 #include "idl/storage_service.dist.impl.hh"
 
 namespace netw {
@@ -133,10 +143,17 @@ using namespace std::chrono_literals;
 
 static rpc::lz4_fragmented_compressor::factory lz4_fragmented_compressor_factory;
 static rpc::lz4_compressor::factory lz4_compressor_factory;
+static netw::zstd_rpc_compressor_factory zstd_rpc_compressor_factory;
 static rpc::multi_algo_compressor_factory compressor_factory {
     &lz4_fragmented_compressor_factory,
     &lz4_compressor_factory,
 };
+// The algorithms are negotiated in the order of the client's preference.
+static rpc::multi_algo_compressor_factory zstd_preferring_compressor_factory {
+    &zstd_rpc_compressor_factory,
+    &lz4_fragmented_compressor_factory,
+    &lz4_compressor_factory,
+};
 
 struct messaging_service::rpc_protocol_server_wrapper : public rpc_protocol::server { using rpc_protocol::server::server; };
 
@@ -161,6 +178,83 @@ bool operator<(const msg_addr& x, const msg_addr& y) noexcept {
     }
 }
 
+std::string_view to_string(messaging_verb verb) {
+    switch (verb) {
+    case messaging_verb::CLIENT_ID: return "CLIENT_ID";
+    case messaging_verb::MUTATION: return "MUTATION";
+    case messaging_verb::MUTATION_DONE: return "MUTATION_DONE";
+    case messaging_verb::READ_DATA: return "READ_DATA";
+    case messaging_verb::READ_MUTATION_DATA: return "READ_MUTATION_DATA";
+    case messaging_verb::READ_DIGEST: return "READ_DIGEST";
+    case messaging_verb::GOSSIP_DIGEST_SYN: return "GOSSIP_DIGEST_SYN";
+    case messaging_verb::GOSSIP_DIGEST_ACK: return "GOSSIP_DIGEST_ACK";
+    case messaging_verb::GOSSIP_DIGEST_ACK2: return "GOSSIP_DIGEST_ACK2";
+    case messaging_verb::GOSSIP_ECHO: return "GOSSIP_ECHO";
+    case messaging_verb::GOSSIP_SHUTDOWN: return "GOSSIP_SHUTDOWN";
+    case messaging_verb::DEFINITIONS_UPDATE: return "DEFINITIONS_UPDATE";
+    case messaging_verb::TRUNCATE: return "TRUNCATE";
+    case messaging_verb::REPLICATION_FINISHED: return "REPLICATION_FINISHED";
+    case messaging_verb::MIGRATION_REQUEST: return "MIGRATION_REQUEST";
+    case messaging_verb::PREPARE_MESSAGE: return "PREPARE_MESSAGE";
+    case messaging_verb::PREPARE_DONE_MESSAGE: return "PREPARE_DONE_MESSAGE";
+    case messaging_verb::UNUSED__STREAM_MUTATION: return "UNUSED__STREAM_MUTATION";
+    case messaging_verb::STREAM_MUTATION_DONE: return "STREAM_MUTATION_DONE";
+    case messaging_verb::COMPLETE_MESSAGE: return "COMPLETE_MESSAGE";
+    case messaging_verb::UNUSED__REPAIR_CHECKSUM_RANGE: return "UNUSED__REPAIR_CHECKSUM_RANGE";
+    case messaging_verb::GET_SCHEMA_VERSION: return "GET_SCHEMA_VERSION";
+    case messaging_verb::SCHEMA_CHECK: return "SCHEMA_CHECK";
+    case messaging_verb::COUNTER_MUTATION: return "COUNTER_MUTATION";
+    case messaging_verb::MUTATION_FAILED: return "MUTATION_FAILED";
+    case messaging_verb::STREAM_MUTATION_FRAGMENTS: return "STREAM_MUTATION_FRAGMENTS";
+    case messaging_verb::REPAIR_ROW_LEVEL_START: return "REPAIR_ROW_LEVEL_START";
+    case messaging_verb::REPAIR_ROW_LEVEL_STOP: return "REPAIR_ROW_LEVEL_STOP";
+    case messaging_verb::REPAIR_GET_FULL_ROW_HASHES: return "REPAIR_GET_FULL_ROW_HASHES";
+    case messaging_verb::REPAIR_GET_COMBINED_ROW_HASH: return "REPAIR_GET_COMBINED_ROW_HASH";
+    case messaging_verb::REPAIR_GET_SYNC_BOUNDARY: return "REPAIR_GET_SYNC_BOUNDARY";
+    case messaging_verb::REPAIR_GET_ROW_DIFF: return "REPAIR_GET_ROW_DIFF";
+    case messaging_verb::REPAIR_PUT_ROW_DIFF: return "REPAIR_PUT_ROW_DIFF";
+    case messaging_verb::REPAIR_GET_ESTIMATED_PARTITIONS: return "REPAIR_GET_ESTIMATED_PARTITIONS";
+    case messaging_verb::REPAIR_SET_ESTIMATED_PARTITIONS: return "REPAIR_SET_ESTIMATED_PARTITIONS";
+    case messaging_verb::REPAIR_GET_DIFF_ALGORITHMS: return "REPAIR_GET_DIFF_ALGORITHMS";
+    case messaging_verb::REPAIR_GET_ROW_DIFF_WITH_RPC_STREAM: return "REPAIR_GET_ROW_DIFF_WITH_RPC_STREAM";
+    case messaging_verb::REPAIR_PUT_ROW_DIFF_WITH_RPC_STREAM: return "REPAIR_PUT_ROW_DIFF_WITH_RPC_STREAM";
+    case messaging_verb::REPAIR_GET_FULL_ROW_HASHES_WITH_RPC_STREAM: return "REPAIR_GET_FULL_ROW_HASHES_WITH_RPC_STREAM";
+    case messaging_verb::PAXOS_PREPARE: return "PAXOS_PREPARE";
+    case messaging_verb::PAXOS_ACCEPT: return "PAXOS_ACCEPT";
+    case messaging_verb::PAXOS_LEARN: return "PAXOS_LEARN";
+    case messaging_verb::HINT_MUTATION: return "HINT_MUTATION";
+    case messaging_verb::PAXOS_PRUNE: return "PAXOS_PRUNE";
+    case messaging_verb::GOSSIP_GET_ENDPOINT_STATES: return "GOSSIP_GET_ENDPOINT_STATES";
+    case messaging_verb::NODE_OPS_CMD: return "NODE_OPS_CMD";
+    case messaging_verb::RAFT_SEND_SNAPSHOT: return "RAFT_SEND_SNAPSHOT";
+    case messaging_verb::RAFT_APPEND_ENTRIES: return "RAFT_APPEND_ENTRIES";
+    case messaging_verb::RAFT_APPEND_ENTRIES_REPLY: return "RAFT_APPEND_ENTRIES_REPLY";
+    case messaging_verb::RAFT_VOTE_REQUEST: return "RAFT_VOTE_REQUEST";
+    case messaging_verb::RAFT_VOTE_REPLY: return "RAFT_VOTE_REPLY";
+    case messaging_verb::RAFT_TIMEOUT_NOW: return "RAFT_TIMEOUT_NOW";
+    case messaging_verb::RAFT_READ_QUORUM: return "RAFT_READ_QUORUM";
+    case messaging_verb::RAFT_READ_QUORUM_REPLY: return "RAFT_READ_QUORUM_REPLY";
+    case messaging_verb::RAFT_EXECUTE_READ_BARRIER_ON_LEADER: return "RAFT_EXECUTE_READ_BARRIER_ON_LEADER";
+    case messaging_verb::RAFT_ADD_ENTRY: return "RAFT_ADD_ENTRY";
+    case messaging_verb::RAFT_MODIFY_CONFIG: return "RAFT_MODIFY_CONFIG";
+    case messaging_verb::GROUP0_PEER_EXCHANGE: return "GROUP0_PEER_EXCHANGE";
+    case messaging_verb::GROUP0_MODIFY_CONFIG: return "GROUP0_MODIFY_CONFIG";
+    case messaging_verb::REPAIR_UPDATE_SYSTEM_TABLE: return "REPAIR_UPDATE_SYSTEM_TABLE";
+    case messaging_verb::REPAIR_FLUSH_HINTS_BATCHLOG: return "REPAIR_FLUSH_HINTS_BATCHLOG";
+    case messaging_verb::FORWARD_REQUEST: return "FORWARD_REQUEST";
+    case messaging_verb::GET_GROUP0_UPGRADE_STATE: return "GET_GROUP0_UPGRADE_STATE";
+    case messaging_verb::DIRECT_FD_PING: return "DIRECT_FD_PING";
+    case messaging_verb::RAFT_TOPOLOGY_CMD: return "RAFT_TOPOLOGY_CMD";
+    case messaging_verb::RAFT_PULL_TOPOLOGY_SNAPSHOT: return "RAFT_PULL_TOPOLOGY_SNAPSHOT";
+    case messaging_verb::MUTATION_BATCH: return "MUTATION_BATCH";
+    case messaging_verb::STREAM_SSTABLE_FILES: return "STREAM_SSTABLE_FILES";
+    case messaging_verb::HINT_MUTATION_BATCH: return "HINT_MUTATION_BATCH";
+    case messaging_verb::ALTERNATOR_LEADER_RMW: return "ALTERNATOR_LEADER_RMW";
+    case messaging_verb::LAST: break;
+    }
+    return "UNKNOWN";
+}
+
 std::ostream& operator<<(std::ostream& os, const msg_addr& x) {
     fmt::print(os, "{}:{}", x.addr, x.cpu_id);
     return os;
@@ -221,6 +315,107 @@ bool messaging_service::knows_version(const gms::inet_address& endpoint) const {
     return true;
 }
 
+void messaging_service::set_verb_latency_sample_rate(double sample_rate) {
+    _verb_latency_sample_rate = std::clamp(sample_rate, 0.0, 1.0);
+}
+
+bool messaging_service::sample_verb_latency() {
+    return _verb_latency_sample_rate >= 1 || std::uniform_real_distribution<double>(0, 1)(_verb_latency_sampler) < _verb_latency_sample_rate;
+}
+
+messaging_service::send_tracker messaging_service::track_send(messaging_verb verb, const msg_addr& id) {
+    if (!_verb_latency_sample_rate) {
+        return {};
+    }
+    return send_tracker(shared_from_this(), verb, id.addr, sample_verb_latency());
+}
+
+messaging_service::handler_tracker messaging_service::track_handler(messaging_verb verb) {
+    if (!_verb_latency_sample_rate) {
+        return {};
+    }
+    return handler_tracker(*this, verb, sample_verb_latency());
+}
+
+messaging_service::send_tracker::send_tracker(shared_ptr<messaging_service> ms, messaging_verb verb, gms::inet_address addr, bool sampled)
+        : _ms(std::move(ms)), _verb(verb), _addr(addr) {
+    ++_ms->_verb_stats[static_cast<int32_t>(_verb)].in_flight;
+    if (sampled) {
+        _start = std::chrono::steady_clock::now();
+    }
+}
+
+void messaging_service::send_tracker::serialized() noexcept {
+    if (_start) {
+        _serialization = std::chrono::steady_clock::now() - *_start;
+    }
+}
+
+messaging_service::send_tracker::~send_tracker() {
+    if (!_ms) {
+        return;
+    }
+    auto& st = _ms->_verb_stats[static_cast<int32_t>(_verb)];
+    --st.in_flight;
+    if (!_start) {
+        return;
+    }
+    auto to_us = [] (std::chrono::steady_clock::duration d) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+    };
+    auto round_trip = to_us(std::chrono::steady_clock::now() - *_start);
+    auto serialization = to_us(_serialization);
+    st.send.round_trip.add(round_trip);
+    st.send.serialization.add(serialization);
+    try {
+        auto& peer = _ms->_peer_verb_latencies[_addr][_verb];
+        peer.round_trip.add(round_trip);
+        peer.serialization.add(serialization);
+    } catch (...) {
+        // Losing a sample is fine.
+    }
+}
+
+messaging_service::handler_tracker::handler_tracker(messaging_service& ms, messaging_verb verb, bool sampled)
+        : _ms(&ms), _verb(verb) {
+    ++_ms->_verb_stats[static_cast<int32_t>(_verb)].handlers_in_flight;
+    if (sampled) {
+        _start = std::chrono::steady_clock::now();
+    }
+}
+
+messaging_service::handler_tracker::~handler_tracker() {
+    if (!_ms) {
+        return;
+    }
+    auto& st = _ms->_verb_stats[static_cast<int32_t>(_verb)];
+    --st.handlers_in_flight;
+    if (_start) {
+        st.handler.add(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - *_start).count());
+    }
+}
+
+void messaging_service::register_metrics() {
+    namespace sm = seastar::metrics;
+    auto verb_label = sm::label("verb");
+    std::vector<sm::metric_definition> defs;
+    for (int32_t i = 0; i < static_cast<int32_t>(messaging_verb::LAST); ++i) {
+        auto& st = _verb_stats[i];
+        auto verb = verb_label(sstring(to_string(messaging_verb(i))));
+        defs.push_back(sm::make_gauge("verb_messages_in_flight", [&st] { return st.in_flight; },
+                sm::description("Sent messages of the verb not yet answered, counted while rpc_latency_sample_rate is set"), {verb}).aggregate({sm::shard_label}));
+        defs.push_back(sm::make_gauge("verb_handlers_in_flight", [&st] { return st.handlers_in_flight; },
+                sm::description("Received messages of the verb not yet handled, counted while rpc_latency_sample_rate is set"), {verb}).aggregate({sm::shard_label}));
+        defs.push_back(sm::make_histogram("verb_serialization_latency", sm::description("Sampled time to serialize and queue messages of the verb, in microseconds"),
+                {verb}, [&st] { return to_metrics_histogram(st.send.serialization); }).aggregate({sm::shard_label}).set_skip_when_empty());
+        defs.push_back(sm::make_histogram("verb_round_trip_latency", sm::description("Sampled time from sending messages of the verb until their reply, in microseconds"),
+                {verb}, [&st] { return to_metrics_histogram(st.send.round_trip); }).aggregate({sm::shard_label}).set_skip_when_empty());
+        defs.push_back(sm::make_histogram("verb_handler_latency", sm::description("Sampled time to handle received messages of the verb, in microseconds"),
+                {verb}, [&st] { return to_metrics_histogram(st.handler); }).aggregate({sm::shard_label}).set_skip_when_empty());
+    }
+    _metrics.add_group("messaging_service", defs);
+}
+
 future<> messaging_service::unregister_handler(messaging_verb verb) {
     return _rpc->unregister_handler(verb);
 }
@@ -280,7 +475,7 @@ void messaging_service::do_start_listen() {
     bool listen_to_bc = _cfg.listen_on_broadcast_address && _cfg.ip != utils::fb_utilities::get_broadcast_address();
     rpc::server_options so;
     if (_cfg.compress != compress_what::none) {
-        so.compressor_factory = &compressor_factory;
+        so.compressor_factory = &zstd_preferring_compressor_factory;
     }
     so.load_balancing_algorithm = server_socket::load_balancing_algorithm::port;
 
@@ -375,6 +570,7 @@ messaging_service::messaging_service(config cfg, scheduling_config scfg, std::sh
     , _scheduling_info_for_connection_index(initial_scheduling_info())
 {
     _rpc->set_logger(&rpc_logger);
+    register_metrics();
 
     // this initialization should be done before any handler registration
     // this is because register_handler calls to: scheduling_group_for_verb
@@ -526,6 +722,7 @@ static constexpr unsigned do_get_rpc_client_idx(messaging_verb verb) {
     case messaging_verb::REPLICATION_FINISHED:
     case messaging_verb::UNUSED__REPAIR_CHECKSUM_RANGE:
     case messaging_verb::STREAM_MUTATION_FRAGMENTS:
+    case messaging_verb::STREAM_SSTABLE_FILES:
     case messaging_verb::REPAIR_ROW_LEVEL_START:
     case messaging_verb::REPAIR_ROW_LEVEL_STOP:
     case messaging_verb::REPAIR_GET_FULL_ROW_HASHES:
@@ -543,9 +740,11 @@ static constexpr unsigned do_get_rpc_client_idx(messaging_verb verb) {
     case messaging_verb::REPAIR_FLUSH_HINTS_BATCHLOG:
     case messaging_verb::NODE_OPS_CMD:
     case messaging_verb::HINT_MUTATION:
+    case messaging_verb::HINT_MUTATION_BATCH:
         return 1;
     case messaging_verb::CLIENT_ID:
     case messaging_verb::MUTATION:
+    case messaging_verb::MUTATION_BATCH:
     case messaging_verb::READ_DATA:
     case messaging_verb::READ_MUTATION_DATA:
     case messaging_verb::READ_DIGEST:
@@ -573,6 +772,7 @@ static constexpr unsigned do_get_rpc_client_idx(messaging_verb verb) {
     case messaging_verb::RAFT_MODIFY_CONFIG:
     case messaging_verb::DIRECT_FD_PING:
     case messaging_verb::RAFT_PULL_TOPOLOGY_SNAPSHOT:
+    case messaging_verb::ALTERNATOR_LEADER_RMW:
         return 2;
     case messaging_verb::MUTATION_DONE:
     case messaging_verb::MUTATION_FAILED:
@@ -717,6 +917,88 @@ gms::inet_address messaging_service::get_public_endpoint_for(const gms::inet_add
     return i != _preferred_to_endpoint.end() ? i->second : ip;
 }
 
+// Returns the addresses of all clients of the node of id, one for each of its
+// shards with shard aware connections.
+static std::vector<msg_addr> all_shards_of(const messaging_service::clients_map& clients, msg_addr id) {
+    std::vector<msg_addr> ret;
+    for (auto& [addr, _] : clients) {
+        if (addr.addr == id.addr) {
+            ret.push_back(addr);
+        }
+    }
+    return ret;
+}
+
+void messaging_service::set_peer_sharding(gms::inet_address ep, unsigned shard_count, unsigned ignore_msb) {
+    if (!shard_count) {
+        return;
+    }
+    auto [it, inserted] = _peer_sharding.try_emplace(ep, peer_sharding{shard_count, ignore_msb});
+    if (!inserted && it->second.shard_count == shard_count && it->second.ignore_msb == ignore_msb) {
+        return;
+    }
+    it->second = peer_sharding{shard_count, ignore_msb};
+    if (!_cfg.shard_aware) {
+        return;
+    }
+    // Connections opened before may have landed on other shards.
+    for (unsigned idx = 0; idx < _clients.size(); ++idx) {
+        // See comment above `TOPOLOGY_INDEPENDENT_IDX`.
+        if (idx == TOPOLOGY_INDEPENDENT_IDX) {
+            continue;
+        }
+        for (auto addr : all_shards_of(_clients[idx], msg_addr(ep))) {
+            find_and_remove_client(_clients[idx], addr, [] (const auto&) { return true; });
+        }
+    }
+}
+
+msg_addr messaging_service::addr_for(gms::inet_address ep, const dht::token& t) const {
+    if (!_cfg.shard_aware) {
+        return msg_addr(ep);
+    }
+    auto it = _peer_sharding.find(ep);
+    if (it == _peer_sharding.end()) {
+        return msg_addr(ep);
+    }
+    return msg_addr(ep, dht::shard_of(it->second.shard_count, it->second.ignore_msb, t));
+}
+
+msg_addr messaging_service::addr_for(gms::inet_address ep) const {
+    if (!_cfg.shard_aware) {
+        return msg_addr(ep);
+    }
+    auto it = _peer_sharding.find(ep);
+    if (it == _peer_sharding.end()) {
+        return msg_addr(ep);
+    }
+    return msg_addr(ep, this_shard_id() % it->second.shard_count);
+}
+
+std::optional<messaging_service::peer_sharding> messaging_service::get_peer_sharding(gms::inet_address ep) const {
+    if (!_cfg.shard_aware) {
+        return std::nullopt;
+    }
+    auto it = _peer_sharding.find(ep);
+    if (it == _peer_sharding.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+// The servers pick the shard of a connection from its source port (see
+// load_balancing_algorithm::port), so binding a port makes the connection
+// land on a chosen shard. The ports are picked from the range of dynamic
+// ports, at random to make collisions with other connections unlikely.
+static uint16_t pick_port_for_shard(unsigned shard, unsigned shard_count) {
+    static constexpr unsigned min_port = 49152;
+    static constexpr unsigned max_port = 65535;
+    static thread_local std::default_random_engine rnd{std::random_device{}()};
+    auto first = min_port + (shard_count - min_port % shard_count) % shard_count + shard;
+    auto choices = (max_port - first) / shard_count + 1;
+    return first + shard_count * std::uniform_int_distribution<unsigned>(0, choices - 1)(rnd);
+}
+
 shared_ptr<messaging_service::rpc_protocol_client_wrapper> messaging_service::get_rpc_client(messaging_verb verb, msg_addr id) {
     assert(!_shutting_down);
     auto idx = get_rpc_client_idx(verb);
@@ -735,7 +1017,14 @@ shared_ptr<messaging_service::rpc_protocol_client_wrapper> messaging_service::ge
 
     auto broadcast_address = utils::fb_utilities::get_broadcast_address();
     bool listen_to_bc = _cfg.listen_on_broadcast_address && _cfg.ip != broadcast_address;
-    auto laddr = socket_address(listen_to_bc ? broadcast_address : _cfg.ip, 0);
+    uint16_t lport = 0;
+    // See comment above `TOPOLOGY_INDEPENDENT_IDX`.
+    if (_cfg.shard_aware && idx != TOPOLOGY_INDEPENDENT_IDX) {
+        if (auto it = _peer_sharding.find(id.addr); it != _peer_sharding.end()) {
+            lport = pick_port_for_shard(id.cpu_id % it->second.shard_count, it->second.shard_count);
+        }
+    }
+    auto laddr = socket_address(listen_to_bc ? broadcast_address : _cfg.ip, lport);
 
     std::optional<bool> topology_status;
     auto has_topology = [&] {
@@ -809,7 +1098,7 @@ shared_ptr<messaging_service::rpc_protocol_client_wrapper> messaging_service::ge
     // send keepalive messages each minute if connection is idle, drop connection after 10 failures
     opts.keepalive = std::optional<net::tcp_keepalive_params>({60s, 60s, 10});
     if (must_compress) {
-        opts.compressor_factory = &compressor_factory;
+        opts.compressor_factory = _cfg.compression == compression_algorithm::zstd ? &zstd_preferring_compressor_factory : &compressor_factory;
     }
     opts.tcp_nodelay = must_tcp_nodelay;
     opts.reuseaddr = true;
@@ -873,13 +1162,17 @@ void messaging_service::remove_error_rpc_client(messaging_verb verb, msg_addr id
 
 void messaging_service::remove_rpc_client(msg_addr id) {
     for (auto& c : _clients) {
-        find_and_remove_client(c, id, [] (const auto&) { return true; });
+        for (auto addr : all_shards_of(c, id)) {
+            find_and_remove_client(c, addr, [] (const auto&) { return true; });
+        }
     }
 }
 
 void messaging_service::remove_rpc_client_with_ignored_topology(msg_addr id) {
     for (auto& c : _clients) {
-        find_and_remove_client(c, id, [] (const auto& s) { return s.topology_ignored; });
+        for (auto addr : all_shards_of(c, id)) {
+            find_and_remove_client(c, addr, [] (const auto& s) { return s.topology_ignored; });
+        }
     }
 }
 
@@ -916,6 +1209,38 @@ future<> messaging_service::unregister_stream_mutation_fragments() {
     return unregister_handler(messaging_verb::STREAM_MUTATION_FRAGMENTS);
 }
 
+rpc::sink<int32_t> messaging_service::make_sink_for_stream_sstable_files(rpc::source<bytes, streaming::stream_sstable_files_cmd>& source) {
+    return source.make_sink<netw::serializer, int32_t>();
+}
+
+future<std::tuple<rpc::sink<bytes, streaming::stream_sstable_files_cmd>, rpc::source<int32_t>>>
+messaging_service::make_sink_and_source_for_stream_sstable_files(table_schema_version schema_id, streaming::plan_id plan_id, table_id cf_id, streaming::stream_reason reason, sstring version, sstring format, std::vector<sstring> components, msg_addr id) {
+    using value_type = std::tuple<rpc::sink<bytes, streaming::stream_sstable_files_cmd>, rpc::source<int32_t>>;
+    if (is_shutting_down()) {
+        co_await coroutine::return_exception(rpc::closed_error());
+    }
+    auto rpc_client = get_rpc_client(messaging_verb::STREAM_SSTABLE_FILES, id);
+    auto sink = co_await rpc_client->make_stream_sink<netw::serializer, bytes, streaming::stream_sstable_files_cmd>();
+    auto rpc_handler = rpc()->make_client<rpc::source<int32_t> (streaming::plan_id, table_schema_version, table_id, streaming::stream_reason, sstring, sstring, std::vector<sstring>, rpc::sink<bytes, streaming::stream_sstable_files_cmd>)>(messaging_verb::STREAM_SSTABLE_FILES);
+    std::exception_ptr ex;
+    try {
+        auto source = co_await rpc_handler(*rpc_client, plan_id, schema_id, cf_id, reason, std::move(version), std::move(format), std::move(components), sink);
+        co_return value_type(std::move(sink), std::move(source));
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await sink.close();
+    std::rethrow_exception(std::move(ex));
+}
+
+void messaging_service::register_stream_sstable_files(std::function<future<rpc::sink<int32_t>> (const rpc::client_info& cinfo, streaming::plan_id plan_id, table_schema_version schema_id, table_id cf_id, streaming::stream_reason reason, sstring version, sstring format, std::vector<sstring> components, rpc::source<bytes, streaming::stream_sstable_files_cmd> source)>&& func) {
+    register_handler(this, messaging_verb::STREAM_SSTABLE_FILES, std::move(func));
+}
+
+future<> messaging_service::unregister_stream_sstable_files() {
+    return unregister_handler(messaging_verb::STREAM_SSTABLE_FILES);
+}
+
 template<class SinkType, class SourceType>
 future<std::tuple<rpc::sink<SinkType>, rpc::source<SourceType>>>
 do_make_sink_source(messaging_verb verb, uint32_t repair_meta_id, shared_ptr<messaging_service::rpc_protocol_client_wrapper> rpc_client, std::unique_ptr<messaging_service::rpc_protocol_wrapper>& rpc) {
@@ -1253,14 +1578,14 @@ future<rpc::optional<repair_row_level_start_response>> messaging_service::send_r
 }
 
 // Wrapper for REPAIR_ROW_LEVEL_STOP
-void messaging_service::register_repair_row_level_stop(std::function<future<> (const rpc::client_info& cinfo, uint32_t repair_meta_id, sstring keyspace_name, sstring cf_name, dht::token_range range)>&& func) {
+void messaging_service::register_repair_row_level_stop(std::function<future<> (const rpc::client_info& cinfo, uint32_t repair_meta_id, sstring keyspace_name, sstring cf_name, dht::token_range range, rpc::optional<bool> synced)>&& func) {
     register_handler(this, messaging_verb::REPAIR_ROW_LEVEL_STOP, std::move(func));
 }
 future<> messaging_service::unregister_repair_row_level_stop() {
     return unregister_handler(messaging_verb::REPAIR_ROW_LEVEL_STOP);
 }
-future<> messaging_service::send_repair_row_level_stop(msg_addr id, uint32_t repair_meta_id, sstring keyspace_name, sstring cf_name, dht::token_range range) {
-    return send_message<void>(this, messaging_verb::REPAIR_ROW_LEVEL_STOP, std::move(id), repair_meta_id, std::move(keyspace_name), std::move(cf_name), std::move(range));
+future<> messaging_service::send_repair_row_level_stop(msg_addr id, uint32_t repair_meta_id, sstring keyspace_name, sstring cf_name, dht::token_range range, bool synced) {
+    return send_message<void>(this, messaging_verb::REPAIR_ROW_LEVEL_STOP, std::move(id), repair_meta_id, std::move(keyspace_name), std::move(cf_name), std::move(range), synced);
 }
 
 // Wrapper for REPAIR_GET_ESTIMATED_PARTITIONS
@@ -15,16 +15,21 @@
 #include <seastar/core/sstring.hh>
 #include "gms/inet_address.hh"
 #include "inet_address_vectors.hh"
+#include <seastar/core/metrics_registration.hh>
 #include <seastar/rpc/rpc_types.hh>
 #include <unordered_map>
 #include "range.hh"
 #include "tracing/tracing.hh"
+#include "utils/estimated_histogram.hh"
 #include "schema/schema_fwd.hh"
 #include "streaming/stream_fwd.hh"
 
+#include <array>
+#include <chrono>
 #include <list>
 #include <vector>
 #include <optional>
+#include <random>
 #include <absl/container/btree_set.h>
 #include <seastar/net/tls.hh>
 
@@ -32,6 +37,7 @@
 namespace streaming {
     class prepare_message;
     enum class stream_mutation_fragments_cmd : uint8_t;
+    enum class stream_sstable_files_cmd : uint8_t;
 }
 
 namespace gms {
@@ -55,6 +61,10 @@ namespace locator {
 class shared_token_metadata;
 }
 
+namespace dht {
+class token;
+}
+
 class frozen_mutation;
 class frozen_schema;
 class canonical_mutation;
@@ -182,9 +192,16 @@ enum class messaging_verb : int32_t {
     DIRECT_FD_PING = 63,
     RAFT_TOPOLOGY_CMD = 64,
     RAFT_PULL_TOPOLOGY_SNAPSHOT = 65,
-    LAST = 66,
+    MUTATION_BATCH = 66,
+    STREAM_SSTABLE_FILES = 67,
+    HINT_MUTATION_BATCH = 68,
+    ALTERNATOR_LEADER_RMW = 69,
+    LAST = 70,
 };
 
+// The name of verb, e.g. "MUTATION".
+std::string_view to_string(messaging_verb verb);
+
 } // namespace netw
 
 namespace std {
@@ -208,6 +225,13 @@ struct schema_pull_options {
     // which contain additional data (besides schema tables mutations).
     // When used inside group 0 snapshot transfer, this is `true`.
     bool group0_snapshot_transfer = false;
+
+    // When non-zero, the group 0 snapshot is transferred in chunks: the reply carries
+    // the schema of at most this many keyspaces, those whose names sort after
+    // `group0_snapshot_start_after`. The group 0 history mutation is sent alone,
+    // in the reply which follows the last keyspace.
+    std::optional<sstring> group0_snapshot_start_after;
+    uint32_t group0_snapshot_max_keyspaces = 0;
 };
 
 class messaging_service : public seastar::async_sharded_service<messaging_service>, public peering_sharded_service<messaging_service> {
@@ -243,6 +267,80 @@ class messaging_service : public seastar::async_sharded_service<messaging_servic
 
     bool knows_version(const gms::inet_address& endpoint) const;
 
+    // Latencies of sampled messages, in microseconds.
+    using latency_histogram = utils::approx_exponential_histogram<16, 33554432, 4>;
+
+    struct verb_send_latencies {
+        // Serializing a message and queuing it on its connection.
+        latency_histogram serialization;
+        // From sending a message until its reply arrived, or for one-way
+        // messages until it was sent. Includes the time spent in the send
+        // queue, on the network and in the handler on the peer, which the
+        // peer tracks in its verb_stats::handler.
+        latency_histogram round_trip;
+    };
+
+    struct verb_stats {
+        // Sent messages not yet answered, and received messages not yet
+        // handled. Only counted while latencies are sampled.
+        uint64_t in_flight = 0;
+        uint64_t handlers_in_flight = 0;
+        verb_send_latencies send;
+        latency_histogram handler;
+    };
+    using peer_verb_latencies = std::unordered_map<gms::inet_address, std::unordered_map<messaging_verb, verb_send_latencies>>;
+
+    // Samples the latencies of about sample_rate of the messages of every
+    // verb, between 0, which disables sampling, and 1.
+    void set_verb_latency_sample_rate(double sample_rate);
+    const verb_stats& get_verb_stats(messaging_verb verb) const {
+        return _verb_stats[static_cast<int32_t>(verb)];
+    }
+    // Sampled latencies of messages sent to each peer.
+    const peer_verb_latencies& get_peer_verb_latencies() const {
+        return _peer_verb_latencies;
+    }
+
+    // Counts a sent message as in flight while alive, and records its
+    // latencies if it is sampled. Does nothing unless latencies are sampled.
+    class send_tracker {
+        shared_ptr<messaging_service> _ms;
+        messaging_verb _verb = messaging_verb::LAST;
+        gms::inet_address _addr;
+        std::optional<std::chrono::steady_clock::time_point> _start; // Engaged if sampled.
+        std::chrono::steady_clock::duration _serialization{};
+    public:
+        send_tracker() = default;
+        send_tracker(shared_ptr<messaging_service> ms, messaging_verb verb, gms::inet_address addr, bool sampled);
+        send_tracker(send_tracker&&) noexcept = default;
+        ~send_tracker();
+        explicit operator bool() const noexcept {
+            return bool(_ms);
+        }
+        // Called once the message was serialized and queued.
+        void serialized() noexcept;
+    };
+
+    // Like send_tracker, for the handler of a received message.
+    class handler_tracker {
+        messaging_service* _ms = nullptr;
+        messaging_verb _verb = messaging_verb::LAST;
+        std::optional<std::chrono::steady_clock::time_point> _start;
+    public:
+        handler_tracker() = default;
+        handler_tracker(messaging_service& ms, messaging_verb verb, bool sampled);
+        handler_tracker(handler_tracker&& o) noexcept
+            : _ms(std::exchange(o._ms, nullptr)), _verb(o._verb), _start(o._start) {
+        }
+        ~handler_tracker();
+        explicit operator bool() const noexcept {
+            return _ms;
+        }
+    };
+
+    send_tracker track_send(messaging_verb verb, const msg_addr& id);
+    handler_tracker track_handler(messaging_verb verb);
+
     enum class encrypt_what {
         none,
         rack,
@@ -256,6 +354,11 @@ class messaging_service : public seastar::async_sharded_service<messaging_servic
         all,
     };
 
+    enum class compression_algorithm {
+        lz4,
+        zstd,
+    };
+
     enum class tcp_nodelay_what {
         local,
         all,
@@ -267,9 +370,14 @@ class messaging_service : public seastar::async_sharded_service<messaging_servic
         uint16_t ssl_port = 0;
         encrypt_what encrypt = encrypt_what::none;
         compress_what compress = compress_what::none;
+        // Preferred for the connections this node opens, the peer may only
+        // support lz4. Connections from peers can use either.
+        compression_algorithm compression = compression_algorithm::lz4;
         tcp_nodelay_what tcp_nodelay = tcp_nodelay_what::all;
         bool listen_on_broadcast_address = false;
         size_t rpc_memory_limit = 1'000'000;
+        // Connections opened for a msg_addr land on its shard of the peer, see addr_for().
+        bool shard_aware = false;
     };
 
     struct scheduling_config {
@@ -297,11 +405,16 @@ class messaging_service : public seastar::async_sharded_service<messaging_servic
         scheduling_group sched_group;
         unsigned cliend_idx;
     };
+    struct peer_sharding {
+        unsigned shard_count;
+        unsigned ignore_msb;
+    };
 private:
     config _cfg;
     locator::shared_token_metadata* _token_metadata = nullptr;
     // map: Node broadcast address -> Node internal IP, and the reversed mapping, for communication within the same data center
     std::unordered_map<gms::inet_address, gms::inet_address> _preferred_ip_cache, _preferred_to_endpoint;
+    std::unordered_map<gms::inet_address, peer_sharding> _peer_sharding;
     std::unique_ptr<rpc_protocol_wrapper> _rpc;
     std::array<std::unique_ptr<rpc_protocol_server_wrapper>, 2> _server;
     ::shared_ptr<seastar::tls::server_credentials> _credentials;
@@ -309,12 +422,20 @@ class messaging_service : public seastar::async_sharded_service<messaging_servic
     std::array<std::unique_ptr<rpc_protocol_server_wrapper>, 2> _server_tls;
     std::vector<clients_map> _clients;
     uint64_t _dropped_messages[static_cast<int32_t>(messaging_verb::LAST)] = {};
+    double _verb_latency_sample_rate = 0;
+    std::minstd_rand _verb_latency_sampler{std::random_device{}()};
+    std::array<verb_stats, static_cast<int32_t>(messaging_verb::LAST)> _verb_stats;
+    peer_verb_latencies _peer_verb_latencies;
+    seastar::metrics::metric_groups _metrics;
     bool _shutting_down = false;
     connection_drop_signal_t _connection_dropped;
     scheduling_config _scheduling_config;
     std::vector<scheduling_info_for_connection_index> _scheduling_info_for_connection_index;
     std::vector<tenant_connection_index> _connection_index_for_tenant;
 
+    bool sample_verb_latency();
+    void register_metrics();
+
     future<> stop_tls_server();
     future<> stop_nontls_server();
     future<> stop_client();
@@ -338,6 +459,20 @@ class messaging_service : public seastar::async_sharded_service<messaging_servic
     void cache_preferred_ip(gms::inet_address ep, gms::inet_address ip);
     gms::inet_address get_public_endpoint_for(const gms::inet_address&) const;
 
+    // Remembers the sharding of ep, as gossiped by it.
+    void set_peer_sharding(gms::inet_address ep, unsigned shard_count, unsigned ignore_msb);
+    // Returns the address of the shard of ep owning t, if connections are
+    // shard aware and the sharding of ep is known, so that messages sent to
+    // it are handled there without a cross-shard hop.
+    msg_addr addr_for(gms::inet_address ep, const dht::token& t) const;
+    // Like above, for messages not bound to a token. Spreads the connections
+    // of this node's shards over the shards of ep.
+    msg_addr addr_for(gms::inet_address ep) const;
+    // Returns the sharding of ep, if connections are shard aware and it is
+    // known, so that messages sent to msg_addr(ep, shard) are handled by
+    // that shard of ep.
+    std::optional<peer_sharding> get_peer_sharding(gms::inet_address ep) const;
+
     future<> unregister_handler(messaging_verb verb);
 
     // Wrapper for PREPARE_MESSAGE verb
@@ -359,6 +494,13 @@ class messaging_service : public seastar::async_sharded_service<messaging_servic
     rpc::sink<int32_t> make_sink_for_stream_mutation_fragments(rpc::source<frozen_mutation_fragment, rpc::optional<streaming::stream_mutation_fragments_cmd>>& source);
     future<std::tuple<rpc::sink<frozen_mutation_fragment, streaming::stream_mutation_fragments_cmd>, rpc::source<int32_t>>> make_sink_and_source_for_stream_mutation_fragments(table_schema_version schema_id, streaming::plan_id plan_id, table_id cf_id, uint64_t estimated_partitions, streaming::stream_reason reason, msg_addr id);
 
+    // Wrapper for STREAM_SSTABLE_FILES
+    // Streams the components of an sstable, named by components, one after the other. The receiver sends a status code as with STREAM_MUTATION_FRAGMENTS.
+    void register_stream_sstable_files(std::function<future<rpc::sink<int32_t>> (const rpc::client_info& cinfo, streaming::plan_id plan_id, table_schema_version schema_id, table_id cf_id, streaming::stream_reason reason, sstring version, sstring format, std::vector<sstring> components, rpc::source<bytes, streaming::stream_sstable_files_cmd> source)>&& func);
+    future<> unregister_stream_sstable_files();
+    rpc::sink<int32_t> make_sink_for_stream_sstable_files(rpc::source<bytes, streaming::stream_sstable_files_cmd>& source);
+    future<std::tuple<rpc::sink<bytes, streaming::stream_sstable_files_cmd>, rpc::source<int32_t>>> make_sink_and_source_for_stream_sstable_files(table_schema_version schema_id, streaming::plan_id plan_id, table_id cf_id, streaming::stream_reason reason, sstring version, sstring format, std::vector<sstring> components, msg_addr id);
+
     // Wrapper for REPAIR_GET_ROW_DIFF_WITH_RPC_STREAM
     future<std::tuple<rpc::sink<repair_hash_with_cmd>, rpc::source<repair_row_on_wire_with_cmd>>> make_sink_and_source_for_repair_get_row_diff_with_rpc_stream(uint32_t repair_meta_id, msg_addr id);
     rpc::sink<repair_row_on_wire_with_cmd> make_sink_for_repair_get_row_diff_with_rpc_stream(rpc::source<repair_hash_with_cmd>& source);
@@ -416,9 +558,9 @@ class messaging_service : public seastar::async_sharded_service<messaging_servic
     future<rpc::optional<repair_row_level_start_response>> send_repair_row_level_start(msg_addr id, uint32_t repair_meta_id, sstring keyspace_name, sstring cf_name, dht::token_range range, row_level_diff_detect_algorithm algo, uint64_t max_row_buf_size, uint64_t seed, unsigned remote_shard, unsigned remote_shard_count, unsigned remote_ignore_msb, sstring remote_partitioner_name, table_schema_version schema_version, streaming::stream_reason reason);
 
     // Wrapper for REPAIR_ROW_LEVEL_STOP
-    void register_repair_row_level_stop(std::function<future<> (const rpc::client_info& cinfo, uint32_t repair_meta_id, sstring keyspace_name, sstring cf_name, dht::token_range range)>&& func);
+    void register_repair_row_level_stop(std::function<future<> (const rpc::client_info& cinfo, uint32_t repair_meta_id, sstring keyspace_name, sstring cf_name, dht::token_range range, rpc::optional<bool> synced)>&& func);
     future<> unregister_repair_row_level_stop();
-    future<> send_repair_row_level_stop(msg_addr id, uint32_t repair_meta_id, sstring keyspace_name, sstring cf_name, dht::token_range range);
+    future<> send_repair_row_level_stop(msg_addr id, uint32_t repair_meta_id, sstring keyspace_name, sstring cf_name, dht::token_range range, bool synced);
 
     // Wrapper for REPAIR_GET_ESTIMATED_PARTITIONS
     void register_repair_get_estimated_partitions(std::function<future<uint64_t> (const rpc::client_info& cinfo, uint32_t repair_meta_id)>&& func);
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <seastar/core/function_traits.hh>
 #include <seastar/rpc/rpc.hh>
 #include "messaging_service.hh"
 #include "serializer.hh"
@@ -115,10 +116,42 @@ class messaging_service::rpc_protocol_client_wrapper {
     }
 };
 
+// Wraps the handler of a verb, to track its latency. Keeps the signature of
+// the handler, from which rpc deduces how to deserialize the arguments.
+template <typename Signature>
+struct tracked_handler;
+
+template <typename Ret, typename... Args>
+struct tracked_handler<Ret (Args...)> {
+    template <typename Func>
+    static auto wrap(messaging_service* ms, messaging_verb verb, Func func) {
+        return [ms, verb, func = std::move(func)] (Args... args) mutable -> Ret {
+            auto tracker = ms->track_handler(verb);
+            if constexpr (is_future<Ret>::value) {
+                if (tracker) {
+                    return futurize_invoke(func, std::forward<Args>(args)...).finally([tracker = std::move(tracker)] {});
+                }
+            }
+            return func(std::forward<Args>(args)...);
+        };
+    }
+};
+
 // Register a handler (a callback lambda) for verb
 template<typename Func>
 void register_handler(messaging_service *ms, messaging_verb verb, Func &&func) {
-    ms->rpc()->register_handler(verb, ms->scheduling_group_for_verb(verb), std::move(func));
+    using signature = typename function_traits<std::remove_cvref_t<Func>>::signature;
+    ms->rpc()->register_handler(verb, ms->scheduling_group_for_verb(verb), tracked_handler<signature>::wrap(ms, verb, std::move(func)));
+}
+
+// Keeps tracker alive until the reply to its message arrives.
+template <typename Future>
+Future tracked_send(Future f, messaging_service::send_tracker tracker) {
+    if (!tracker) {
+        return f;
+    }
+    tracker.serialized();
+    return f.finally([tracker = std::move(tracker)] {});
 }
 
 // Send a message for verb
@@ -131,7 +164,8 @@ auto send_message(messaging_service* ms, messaging_verb verb, msg_addr id, MsgOu
     }
     auto rpc_client_ptr = ms->get_rpc_client(verb, id);
     auto& rpc_client = *rpc_client_ptr;
-    return rpc_handler(rpc_client, std::forward<MsgOut>(msg)...).handle_exception([ms = ms->shared_from_this(), id, verb, rpc_client_ptr = std::move(rpc_client_ptr)] (std::exception_ptr&& eptr) {
+    auto tracker = ms->track_send(verb, id);
+    return tracked_send(rpc_handler(rpc_client, std::forward<MsgOut>(msg)...).handle_exception([ms = ms->shared_from_this(), id, verb, rpc_client_ptr = std::move(rpc_client_ptr)] (std::exception_ptr&& eptr) {
         ms->increment_dropped_messages(verb);
         if (try_catch<rpc::closed_error>(eptr)) {
             // This is a transport error
@@ -141,7 +175,7 @@ auto send_message(messaging_service* ms, messaging_verb verb, msg_addr id, MsgOu
             // This is expected to be a rpc server error, e.g., the rpc handler throws a std::runtime_error.
             return futurator::make_exception_future(std::move(eptr));
         }
-    });
+    }), std::move(tracker));
 }
 
 // TODO: Remove duplicated code in send_message
@@ -154,7 +188,8 @@ auto send_message_timeout(messaging_service* ms, messaging_verb verb, msg_addr i
     }
     auto rpc_client_ptr = ms->get_rpc_client(verb, id);
     auto& rpc_client = *rpc_client_ptr;
-    return rpc_handler(rpc_client, timeout, std::forward<MsgOut>(msg)...).handle_exception([ms = ms->shared_from_this(), id, verb, rpc_client_ptr = std::move(rpc_client_ptr)] (std::exception_ptr&& eptr) {
+    auto tracker = ms->track_send(verb, id);
+    return tracked_send(rpc_handler(rpc_client, timeout, std::forward<MsgOut>(msg)...).handle_exception([ms = ms->shared_from_this(), id, verb, rpc_client_ptr = std::move(rpc_client_ptr)] (std::exception_ptr&& eptr) {
         ms->increment_dropped_messages(verb);
         if (try_catch<rpc::closed_error>(eptr)) {
             // This is a transport error
@@ -164,7 +199,7 @@ auto send_message_timeout(messaging_service* ms, messaging_verb verb, msg_addr i
             // This is expected to be a rpc server error, e.g., the rpc handler throws a std::runtime_error.
             return futurator::make_exception_future(std::move(eptr));
         }
-    });
+    }), std::move(tracker));
 }
 
 // Requesting abort on the provided abort_source drops the message from the outgoing queue (if it's still there)
@@ -189,7 +224,8 @@ auto send_message_cancellable(messaging_service* ms, messaging_verb verb, msg_ad
         return futurator::make_exception_future(abort_requested_exception{});
     }
 
-    return rpc_handler(rpc_client, c_ref, std::forward<MsgOut>(msg)...).handle_exception([ms = ms->shared_from_this(), id, verb, rpc_client_ptr = std::move(rpc_client_ptr), sub = std::move(sub)] (std::exception_ptr&& eptr) {
+    auto tracker = ms->track_send(verb, id);
+    return tracked_send(rpc_handler(rpc_client, c_ref, std::forward<MsgOut>(msg)...).handle_exception([ms = ms->shared_from_this(), id, verb, rpc_client_ptr = std::move(rpc_client_ptr), sub = std::move(sub)] (std::exception_ptr&& eptr) {
         ms->increment_dropped_messages(verb);
         if (try_catch<rpc::closed_error>(eptr)) {
             // This is a transport error
@@ -202,7 +238,7 @@ auto send_message_cancellable(messaging_service* ms, messaging_verb verb, msg_ad
             // This is expected to be a rpc server error, e.g., the rpc handler throws a std::runtime_error.
             return futurator::make_exception_future(std::move(eptr));
         }
-    });
+    }), std::move(tracker));
 }
 
 // Send one way message for verb
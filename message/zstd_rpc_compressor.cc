@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <memory>
+#include <variant>
+#include <vector>
+
+#include <seastar/core/byteorder.hh>
+#include <seastar/core/temporary_buffer.hh>
+
+#include <zstd.h>
+
+#include "message/zstd_rpc_compressor.hh"
+#include "utils/overloaded_functor.hh"
+#include "seastarx.hh"
+
+namespace netw {
+
+// Fast, the point is bandwidth savings without costing much cpu.
+static constexpr int compression_level = 1;
+// How far back messages can refer, bounds the memory of each connection,
+// which has a context for each direction.
+static constexpr int window_log = 17;
+
+struct cctx_deleter {
+    void operator()(ZSTD_CCtx* ctx) const noexcept { ZSTD_freeCCtx(ctx); }
+};
+
+struct dctx_deleter {
+    void operator()(ZSTD_DCtx* ctx) const noexcept { ZSTD_freeDCtx(ctx); }
+};
+
+static void check_zstd(size_t ret, const char* what) {
+    if (ZSTD_isError(ret)) {
+        throw std::runtime_error(format("zstd rpc {} failed: {}", what, ZSTD_getErrorName(ret)));
+    }
+}
+
+template <typename Func>
+static void for_each_fragment(const std::variant<std::vector<temporary_buffer<char>>, temporary_buffer<char>>& bufs, Func&& func) {
+    std::visit(overloaded_functor{
+        [&] (const temporary_buffer<char>& buf) { func(buf); },
+        [&] (const std::vector<temporary_buffer<char>>& bufs) {
+            for (auto& buf : bufs) {
+                func(buf);
+            }
+        },
+    }, bufs);
+}
+
+// Messages are prefixed with their uncompressed size, for decompress() to
+// allocate its output up front.
+class zstd_rpc_compressor final : public rpc::compressor {
+    std::unique_ptr<ZSTD_CCtx, cctx_deleter> _cctx;
+    std::unique_ptr<ZSTD_DCtx, dctx_deleter> _dctx;
+public:
+    zstd_rpc_compressor()
+        : _cctx(ZSTD_createCCtx())
+        , _dctx(ZSTD_createDCtx())
+    {
+        if (!_cctx || !_dctx) {
+            throw std::bad_alloc();
+        }
+        check_zstd(ZSTD_CCtx_setParameter(_cctx.get(), ZSTD_c_compressionLevel, compression_level), "setup");
+        check_zstd(ZSTD_CCtx_setParameter(_cctx.get(), ZSTD_c_windowLog, window_log), "setup");
+        // Don't let the peer make us allocate a larger window.
+        check_zstd(ZSTD_DCtx_setParameter(_dctx.get(), ZSTD_d_windowLogMax, window_log), "setup");
+    }
+
+    rpc::snd_buf compress(size_t head_space, rpc::snd_buf data) override {
+        head_space += sizeof(uint32_t);
+        std::vector<temporary_buffer<char>> chunks;
+        size_t size = 0;
+        ZSTD_outBuffer out{nullptr, 0, 0};
+        auto next_chunk = [&] {
+            if (out.dst) {
+                chunks.back().trim(out.pos);
+                size += out.pos;
+            }
+            auto& chunk = chunks.emplace_back(rpc::snd_buf::chunk_size);
+            out = ZSTD_outBuffer{chunk.get_write(), chunk.size(), 0};
+        };
+        next_chunk();
+        write_le<uint32_t>(chunks.front().get_write() + head_space - sizeof(uint32_t), data.size);
+        out.pos = head_space;
+
+        for_each_fragment(data.bufs, [&] (const temporary_buffer<char>& frag) {
+            ZSTD_inBuffer in{frag.get(), frag.size(), 0};
+            while (in.pos < in.size) {
+                if (out.pos == out.size) {
+                    next_chunk();
+                }
+                check_zstd(ZSTD_compressStream2(_cctx.get(), &out, &in, ZSTD_e_continue), "compression");
+            }
+        });
+        // Flushing ends a block, so that the peer can decompress the whole
+        // message without waiting for the next ones.
+        ZSTD_inBuffer in{nullptr, 0, 0};
+        size_t remaining;
+        do {
+            if (out.pos == out.size) {
+                next_chunk();
+            }
+            remaining = ZSTD_compressStream2(_cctx.get(), &out, &in, ZSTD_e_flush);
+            check_zstd(remaining, "compression");
+        } while (remaining);
+        chunks.back().trim(out.pos);
+        size += out.pos;
+
+        rpc::snd_buf ret(size);
+        if (chunks.size() == 1) {
+            ret.bufs = std::move(chunks.front());
+        } else {
+            ret.bufs = std::move(chunks);
+        }
+        return ret;
+    }
+
+    rpc::rcv_buf decompress(rpc::rcv_buf data) override {
+        char size_buf[sizeof(uint32_t)];
+        size_t prefix = 0;
+        std::vector<temporary_buffer<char>> chunks;
+        size_t next = 0;
+        ZSTD_outBuffer out{nullptr, 0, 0};
+        size_t size = 0;
+
+        auto step = [&] (ZSTD_inBuffer& in) {
+            if (out.pos == out.size && next < chunks.size()) {
+                out = ZSTD_outBuffer{chunks[next].get_write(), chunks[next].size(), 0};
+                ++next;
+            }
+            auto in_pos = in.pos;
+            auto out_pos = out.pos;
+            check_zstd(ZSTD_decompressStream(_dctx.get(), &out, &in), "decompression");
+            if (in.pos == in_pos && out.pos == out_pos) {
+                throw std::runtime_error(format("zstd rpc decompression failed: message is not of its declared size {}", size));
+            }
+        };
+
+        for_each_fragment(data.bufs, [&] (const temporary_buffer<char>& frag) {
+            auto skip = std::min(sizeof(size_buf) - prefix, frag.size());
+            std::copy_n(frag.get(), skip, size_buf + prefix);
+            if (prefix < sizeof(size_buf) && (prefix += skip) == sizeof(size_buf)) {
+                size = read_le<uint32_t>(size_buf);
+                for (size_t left = size; left; ) {
+                    auto len = std::min(left, rpc::snd_buf::chunk_size);
+                    chunks.emplace_back(len);
+                    left -= len;
+                }
+            }
+            ZSTD_inBuffer in{frag.get() + skip, frag.size() - skip, 0};
+            while (in.pos < in.size) {
+                step(in);
+            }
+        });
+        if (prefix < sizeof(size_buf)) {
+            throw std::runtime_error("zstd rpc decompression failed: truncated message");
+        }
+        // The decompressor may still hold the end of the message.
+        ZSTD_inBuffer in{nullptr, 0, 0};
+        while (next < chunks.size() || out.pos < out.size) {
+            step(in);
+        }
+
+        rpc::rcv_buf ret(size);
+        if (chunks.size() == 1) {
+            ret.bufs = std::move(chunks.front());
+        } else {
+            ret.bufs = std::move(chunks);
+        }
+        return ret;
+    }
+
+    sstring name() const override {
+        return "ZSTD_STREAM";
+    }
+};
+
+std::unique_ptr<rpc::compressor> zstd_rpc_compressor_factory::negotiate(sstring feature, bool is_server) const {
+    return feature == _name ? std::make_unique<zstd_rpc_compressor>() : nullptr;
+}
+
+}
@@ -0,0 +1,35 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <seastar/core/sstring.hh>
+#include <seastar/rpc/rpc_types.hh>
+
+namespace netw {
+
+// Compresses rpc messages with zstd, as one stream per connection and
+// direction: each message is flushed as a block which may refer back to
+// the previous messages of the connection, so repetitive payloads, like
+// mutations of the same tables, compress much better than with per message
+// compression. Verbs of different classes (mutations, reads, streaming...)
+// go through different connections, so each class builds its own history.
+//
+// Relies on seastar compressing the messages of a connection in the order
+// in which it sends them, and decompressing them in the order they are
+// received.
+class zstd_rpc_compressor_factory final : public seastar::rpc::compressor::factory {
+    seastar::sstring _name = "ZSTD_STREAM";
+public:
+    const seastar::sstring& supported() const override {
+        return _name;
+    }
+    std::unique_ptr<seastar::rpc::compressor> negotiate(seastar::sstring feature, bool is_server) const override;
+};
+
+}
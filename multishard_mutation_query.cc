@@ -559,8 +559,10 @@ future<> read_context::lookup_readers(db::timeout_clock::time_point timeout) noe
         return make_ready_future<>();
     }
     try {
-        return _db.invoke_on_all([this, cmd = &_cmd, ranges = &_ranges, gs = global_schema_ptr(_schema),
-                gts = tracing::global_trace_state_ptr(_trace_state), timeout] (replica::database& db) mutable {
+        // Shards beyond the table's shard count own no data, so they can't have saved readers.
+        return parallel_for_each(boost::irange(0u, _schema->get_sharder().shard_count()), [this, cmd = &_cmd, ranges = &_ranges, gs = global_schema_ptr(_schema),
+                gts = tracing::global_trace_state_ptr(_trace_state), timeout] (shard_id shard) mutable {
+          return _db.invoke_on(shard, [this, cmd, ranges, gs, gts, timeout] (replica::database& db) mutable {
             auto schema = gs.get();
             auto querier_opt = db.get_querier_cache().lookup_shard_mutation_querier(cmd->query_uuid, *schema, *ranges, cmd->slice, gts.get(), timeout);
             auto& table = db.find_column_family(schema);
@@ -588,6 +590,7 @@ future<> read_context::lookup_readers(db::timeout_clock::time_point timeout) noe
                     reader_state::successful_lookup,
                     reader_meta::remote_parts(q.permit(), std::move(q).reader_range(), std::move(q).reader_slice(), table.read_in_progress(),
                             std::move(handle)));
+          });
         });
     } catch (...) {
         return current_exception_as_future();
@@ -842,11 +845,13 @@ class data_query_result_builder {
     query_result_builder _builder;
 
 public:
-    data_query_result_builder(const schema& s, const query::partition_slice& slice, query::result_options opts,
-            query::result_memory_accounter&& accounter, const compact_for_query_state_v2& compaction_state, uint64_t tombstone_limit)
+    data_query_result_builder(const schema& s, const query::read_command& cmd, query::result_options opts,
+            query::result_memory_accounter&& accounter, const compact_for_query_state_v2& compaction_state)
         : _compaction_state(compaction_state)
-        , _res_builder(std::make_unique<query::result::builder>(slice, opts, std::move(accounter), tombstone_limit))
-        , _builder(s, *_res_builder) { }
+        , _res_builder(std::make_unique<query::result::builder>(cmd.slice, opts, std::move(accounter), cmd.tombstone_limit))
+        , _builder(s, *_res_builder) {
+        _res_builder->set_filters(cmd.filters);
+    }
 
     void consume_new_partition(const dht::decorated_key& dk) { _builder.consume_new_partition(dk); }
     void consume(tombstone t) { _builder.consume(t); }
@@ -856,6 +861,11 @@ class data_query_result_builder {
     stop_iteration consume_end_of_partition()  { return _builder.consume_end_of_partition(); }
     result_type consume_end_of_stream() {
         _builder.consume_end_of_stream();
+        // The page was cut short by the rows filtered out, which the
+        // coordinator must not mistake for the end of the data.
+        if (_compaction_state.are_limits_reached() && _res_builder->filtered_rows()) {
+            _res_builder->mark_as_short_read();
+        }
         if (_compaction_state.are_limits_reached() || _res_builder->is_short_read()) {
             return _res_builder->build(_compaction_state.current_full_position());
         }
@@ -892,6 +902,6 @@ future<std::tuple<foreign_ptr<lw_shared_ptr<query::result>>, cache_temperature>>
 
     return do_query_on_all_shards<data_query_result_builder>(db, query_schema, cmd, ranges, std::move(trace_state), timeout,
             [table_schema, &cmd, opts] (query::result_memory_accounter&& accounter, const compact_for_query_state_v2& compaction_state) {
-        return data_query_result_builder(*table_schema, cmd.slice, opts, std::move(accounter), compaction_state, cmd.tombstone_limit);
+        return data_query_result_builder(*table_schema, cmd, opts, std::move(accounter), compaction_state);
     });
 }
@@ -184,6 +184,9 @@ class compact_mutation_state {
         }
         _effective_tombstone = rtc.tombstone();
         const auto can_purge = rtc.tombstone() && can_purge_tombstone(rtc.tombstone());
+        if (!can_purge) {
+            note_retained_tombstone(rtc.tombstone());
+        }
         if (can_purge || _current_emitted_gc_tombstone) {
             partition_is_not_empty_for_gc_consumer(gc_consumer);
             auto tomb = can_purge ? rtc.tombstone() : tombstone{};
@@ -252,6 +255,16 @@ class compact_mutation_state {
         }
     }
 
+    // Accounts tombstones which are kept only because the range of the
+    // current partition has no repair time yet (tombstone_gc_mode::repair).
+    void note_retained_tombstone(tombstone t) {
+        if constexpr (sstable_compaction()) {
+            if (t && get_gc_before() == gc_clock::time_point::min() && can_gc(t)) {
+                _tombstone_gc_state.note_tombstone_retained_for_repair(_schema);
+            }
+        }
+    }
+
     bool can_gc(tombstone t) {
         if (!sstable_compaction()) {
             return true;
@@ -334,6 +347,7 @@ class compact_mutation_state {
         if (can_purge_tombstone(t)) {
             partition_is_not_empty_for_gc_consumer(gc_consumer);
         } else {
+            note_retained_tombstone(t);
             partition_is_not_empty(consumer);
         }
     }
@@ -401,6 +415,8 @@ class compact_mutation_state {
                     _collector->collect(rt);
                 }
                 cr.remove_tombstone();
+            } else {
+                note_retained_tombstone(rt.tomb());
             }
         }
         auto gc_before = get_gc_before();
@@ -133,6 +133,72 @@ void mutation_fragment::destroy_data() noexcept
     }
 }
 
+namespace {
+
+// Readers allocate the data of a fragment for each fragment they emit, and
+// their consumers free it shortly after, often millions of times per second
+// on a shard. The freed blocks, which all have the same size, are kept in a
+// bounded free list and reused for the next fragments, instead of going
+// through the allocator each time.
+//
+// Fragments hold the resources of their reader's permit, which belongs to
+// a single shard, so they are freed on the shard which allocated them.
+class fragment_data_pool {
+    struct free_block {
+        free_block* next;
+    };
+
+    static constexpr size_t max_free_blocks = 512;
+
+    free_block* _free = nullptr;
+    size_t _free_count = 0;
+public:
+    ~fragment_data_pool() {
+        while (_free) {
+            ::operator delete(std::exchange(_free, _free->next));
+        }
+    }
+
+    void* allocate(size_t size) {
+        if (!_free) {
+            return ::operator new(size);
+        }
+        --_free_count;
+        return std::exchange(_free, _free->next);
+    }
+
+    void free(void* ptr, size_t size) noexcept {
+        if (_free_count == max_free_blocks) {
+            ::operator delete(ptr, size);
+            return;
+        }
+        _free = new (ptr) free_block{_free};
+        ++_free_count;
+    }
+};
+
+thread_local fragment_data_pool local_fragment_data_pool;
+
+}
+
+// The standard allocator is used by debug builds, which should see
+// every allocation to detect misuses.
+void* mutation_fragment_v2::data::operator new(size_t size) {
+#ifndef SEASTAR_DEFAULT_ALLOCATOR
+    return local_fragment_data_pool.allocate(size);
+#else
+    return ::operator new(size);
+#endif
+}
+
+void mutation_fragment_v2::data::operator delete(void* ptr, size_t size) noexcept {
+#ifndef SEASTAR_DEFAULT_ALLOCATOR
+    local_fragment_data_pool.free(ptr, size);
+#else
+    ::operator delete(ptr, size);
+#endif
+}
+
 mutation_fragment_v2::mutation_fragment_v2(const schema& s, reader_permit permit, static_row&& r)
     : _kind(kind::static_row), _data(std::make_unique<data>(std::move(permit)))
 {
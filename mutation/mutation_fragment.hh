@@ -44,7 +44,7 @@ class clustering_row {
     clustering_row(const schema& s, const clustering_row& other)
         : _ck(other._ck), _row(s, other._row) { }
     clustering_row(const schema& s, const rows_entry& re)
-        : _ck(re.key()), _row(s, re.row()) { }
+        : _ck(re.key()), _row(re.unpacked_row(s)) { }
     clustering_row(rows_entry&& re)
         : _ck(std::move(re.key())), _row(std::move(re.row())) {}
 
@@ -85,7 +85,7 @@ class clustering_row {
         _row.apply(std::move(t));
     }
     void apply(const schema& s, const rows_entry& r) {
-        _row.apply(s, deletable_row(s, r.row()));
+        _row.apply(s, r.unpacked_row(s));
     }
     void apply(const schema& s, const deletable_row& r) {
         _row.apply(s, r);
@@ -148,6 +148,10 @@ class mutation_fragment_v2 {
         data(reader_permit permit) :  _memory(permit.consume_memory()) { }
         ~data() { }
 
+        // Recycled through a per-shard free list, see mutation_fragment.cc.
+        static void* operator new(size_t size);
+        static void operator delete(void* ptr, size_t size) noexcept;
+
         reader_permit::resource_units _memory;
         union {
             static_row _static_row;
@@ -1042,6 +1042,16 @@ operator<<(std::ostream& os, const deletable_row::printer& p) {
 std::ostream&
 operator<<(std::ostream& os, const rows_entry::printer& p) {
     auto& re = p._rows_entry;
+    if (re.is_packed()) {
+        // Can be printed from within the cache's allocating sections.
+        with_allocator(standard_allocator(), [&] {
+            auto row = re.unpacked_row(p._schema);
+            fmt::print(os, "{{rows_entry: cont={} dummy={} packed {} {}}}", re.continuous(), re.dummy(),
+                          position_in_partition_view::printer(p._schema, re.position()),
+                          deletable_row::printer(p._schema, row));
+        });
+        return os;
+    }
     fmt::print(os, "{{rows_entry: cont={} dummy={} {} {}}}", re.continuous(), re.dummy(),
                   position_in_partition_view::printer(p._schema, re.position()),
                   deletable_row::printer(p._schema, re._row));
@@ -1189,9 +1199,13 @@ rows_entry::equal(const schema& s, const rows_entry& other) const {
 bool
 rows_entry::equal(const schema& s, const rows_entry& other, const schema& other_schema) const {
     position_in_partition::equal_compare eq(s);
-    return eq(position(), other.position())
-           && _range_tombstone == other._range_tombstone
-           && row().equal(column_kind::regular_column, s, other.row(), other_schema);
+    if (!eq(position(), other.position()) || _range_tombstone != other._range_tombstone) {
+        return false;
+    }
+    if (is_packed() || other.is_packed()) {
+        return unpacked_row(s).equal(column_kind::regular_column, s, other.unpacked_row(other_schema), other_schema);
+    }
+    return row().equal(column_kind::regular_column, s, other.row(), other_schema);
 }
 
 bool mutation_partition::equal(const schema& s, const mutation_partition& p) const {
@@ -1325,6 +1339,7 @@ size_t rows_entry::memory_usage(const schema& s) const {
     }
     return size +
            row().cells().external_memory_usage(s, column_kind::regular_column) +
+           _packed_cells.external_memory_usage() +
            sizeof(rows_entry);
 }
 
@@ -1540,11 +1555,23 @@ mutation_partition::row_count() const {
     return _rows.calculate_size();
 }
 
+// Layout of rows_entry::_packed_cells: the timestamp of the cells, the bitmap of
+// present column ids and then the values of the present columns by column id.
+// Value lengths come from the column types, which are all fixed-width.
+static constexpr size_t packed_cells_header_size = sizeof(api::timestamp_type) + sizeof(uint64_t);
+static constexpr column_id max_packed_columns = 64;
+
+static api::timestamp_type packed_cells_timestamp(const managed_bytes& packed) {
+    auto in = managed_bytes_view(packed);
+    return read_simple<api::timestamp_type>(in);
+}
+
 rows_entry::rows_entry(rows_entry&& o) noexcept
     : evictable(std::move(o))
     , _link(std::move(o._link))
     , _key(std::move(o._key))
     , _row(std::move(o._row))
+    , _packed_cells(std::move(o._packed_cells))
     , _range_tombstone(std::move(o._range_tombstone))
     , _flags(std::move(o._flags))
 {
@@ -1557,6 +1584,10 @@ void rows_entry::compact(const schema& s, tombstone t) {
                              gc_clock::time_point::min(),  // no TTL expiration
                              never_gc,                     // no GC
                              gc_clock::time_point::min()); // no GC
+    // Packed cells share a timestamp, so they are either all covered or none is.
+    if (is_packed() && packed_cells_timestamp(_packed_cells) <= (t + _range_tombstone + _row.deleted_at().tomb()).timestamp) {
+        _packed_cells = managed_bytes();
+    }
     // FIXME: Purge redundant _range_tombstone
 }
 
@@ -1564,6 +1595,84 @@ void rows_entry::replace_with(rows_entry&& o) noexcept {
     swap(o);
     _range_tombstone = std::move(o._range_tombstone);
     _row = std::move(o._row);
+    _packed_cells = std::move(o._packed_cells);
+}
+
+bool rows_entry::pack(const schema& s) {
+    const row& cells = _row.cells();
+    if (is_packed() || cells.size() < 2) {
+        return false;
+    }
+    std::optional<api::timestamp_type> timestamp;
+    uint64_t present = 0;
+    size_t size = packed_cells_header_size;
+    bool packable = true;
+    cells.for_each_cell_until([&] (column_id id, const atomic_cell_or_collection& c) {
+        const column_definition& def = s.regular_column_at(id);
+        auto length = def.type->value_length_if_fixed();
+        if (id >= max_packed_columns || !def.is_atomic() || def.is_counter() || !length) {
+            packable = false;
+            return stop_iteration::yes;
+        }
+        auto cell = c.as_atomic_cell(def);
+        if (!cell.is_live() || cell.is_live_and_has_ttl() || cell.value_size() != *length
+                || (timestamp && *timestamp != cell.timestamp())) {
+            packable = false;
+            return stop_iteration::yes;
+        }
+        timestamp = cell.timestamp();
+        present |= uint64_t(1) << id;
+        size += *length;
+        return stop_iteration::no;
+    });
+    if (!packable) {
+        return false;
+    }
+    managed_bytes packed(managed_bytes::initialized_later(), size);
+    auto out = managed_bytes_mutable_view(packed);
+    write<api::timestamp_type>(out, *timestamp);
+    write<uint64_t>(out, present);
+    cells.for_each_cell([&] (column_id id, const atomic_cell_or_collection& c) {
+        write_fragmented(out, c.as_atomic_cell(s.regular_column_at(id)).value());
+    });
+    _packed_cells = std::move(packed);
+    _row.cells() = row();
+    return true;
+}
+
+row rows_entry::unpacked_cells(const schema& s) const {
+    if (!is_packed()) {
+        return row(s, column_kind::regular_column, _row.cells());
+    }
+    auto in = managed_bytes_view(_packed_cells);
+    auto timestamp = read_simple<api::timestamp_type>(in);
+    auto present = read_simple<uint64_t>(in);
+    row cells;
+    for (column_id id = 0; present; ++id, present >>= 1) {
+        if (present & 1) {
+            const column_definition& def = s.regular_column_at(id);
+            auto length = *def.type->value_length_if_fixed();
+            cells.append_cell(id, atomic_cell::make_live(*def.type, timestamp, in.prefix(length)));
+            in.remove_prefix(length);
+        }
+    }
+    return cells;
+}
+
+void rows_entry::unpack(const schema& s) {
+    if (!is_packed()) {
+        return;
+    }
+    _row.cells() = unpacked_cells(s);
+    _packed_cells = managed_bytes();
+}
+
+deletable_row rows_entry::unpacked_row(const schema& s) const {
+    deletable_row r(s, _row);
+    if (is_packed()) {
+        r.cells() = unpacked_cells(s);
+    }
+    return r;
 }
 
 row::row(const schema& s, column_kind kind, const row& o) : _size(o._size)
@@ -1994,7 +2103,37 @@ void mutation_querier::prepare_writers() {
     }
 }
 
+static bool passes_filters(const schema& s, const row& cells, const std::vector<query::column_filter>& filters) {
+    return std::ranges::all_of(filters, [&] (const query::column_filter& f) {
+        auto cell = cells.find_cell(f.column);
+        if (!cell) {
+            return false;
+        }
+        auto& def = s.regular_column_at(f.column);
+        auto c = cell->as_atomic_cell(def);
+        if (!c.is_live()) {
+            return false;
+        }
+        auto cmp = def.type->without_reversed().compare(c.value(), managed_bytes_view(bytes_view(f.value)));
+        switch (f.oper) {
+        case query::column_filter::op::eq: return cmp == 0;
+        case query::column_filter::op::neq: return cmp != 0;
+        case query::column_filter::op::lt: return cmp < 0;
+        case query::column_filter::op::lte: return cmp <= 0;
+        case query::column_filter::op::gt: return cmp > 0;
+        case query::column_filter::op::gte: return cmp >= 0;
+        }
+        return true;
+    });
+}
+
 stop_iteration mutation_querier::consume(clustering_row&& cr, row_tombstone current_tombstone) {
+    if (_pw.filters() && !passes_filters(_schema, cr.cells(), *_pw.filters())) {
+        ++_filtered_rows;
+        ++_pw.filtered_rows();
+        return stop_iteration::no;
+    }
+
     prepare_writers();
 
     const query::partition_slice& slice = _pw.slice();
@@ -2048,7 +2187,9 @@ uint64_t mutation_querier::consume_end_of_stream() {
     bool return_static_content_on_partition_with_no_rows =
         _pw.slice().options.contains(query::partition_slice::option::always_return_static_content) ||
         !has_ck_selector(_pw.ranges());
-    if (!_live_clustering_rows && (!return_static_content_on_partition_with_no_rows || !_live_data_in_static_row)) {
+    // Partitions whose rows were all filtered out are dropped by the
+    // coordinator too, even if they have static content.
+    if (!_live_clustering_rows && (_filtered_rows || !return_static_content_on_partition_with_no_rows || !_live_data_in_static_row)) {
         _pw.retract();
         return 0;
     } else {
@@ -910,6 +910,10 @@ class rows_entry final : public evictable {
     clustering_key _key;
     deletable_row _row;
 
+    // Regular cells of the row in the compact encoding of pack(), empty if
+    // the row isn't packed. The cells of a packed row are not in _row.
+    managed_bytes _packed_cells;
+
     // Given p is the preceding rows_entry&,
     // this tombstone applies to the range (p.position(), position()] if continuous()
     // and to [position(), position()] if !continuous().
@@ -960,6 +964,7 @@ class rows_entry final : public evictable {
     rows_entry(const schema& s, const rows_entry& e)
         : _key(e._key)
         , _row(s, e._row)
+        , _packed_cells(e._packed_cells)
         , _range_tombstone(e._range_tombstone)
         , _flags(e._flags)
     { }
@@ -991,15 +996,41 @@ class rows_entry final : public evictable {
     void set_dummy(bool value) { _flags._dummy = value; }
     void set_dummy(is_dummy value) { _flags._dummy = bool(value); }
     void replace_with(rows_entry&& other) noexcept;
+    // Replaces the row, but not the key nor the continuity, with the one of other.
+    void replace_row(rows_entry&& other) noexcept {
+        _row = std::move(other._row);
+        _packed_cells = std::move(other._packed_cells);
+    }
+
+    // Narrow rows, which cells are all live atomic cells of fixed-width types
+    // written with the same timestamp and without TTL, can be packed into a single
+    // buffer holding the timestamp, a bitmap of the present columns and the values.
+    // This takes a fraction of the memory of the cell tree, so the cache packs the
+    // rows it populates, when enabled. Only columns with id below 64 qualify.
+    //
+    // Cells of a packed row are not visible through row(), see unpacked_cells().
+    // Returns true iff the row was packed. Strong exception guarantees.
+    bool pack(const schema&);
+    // Moves packed cells back into row(). Strong exception guarantees.
+    void unpack(const schema&);
+    bool is_packed() const noexcept {
+        return !_packed_cells.empty();
+    }
+    // Returns the regular cells of the row, packed or not.
+    row unpacked_cells(const schema&) const;
+    // Returns a copy of the row, with the packed cells unpacked.
+    deletable_row unpacked_row(const schema&) const;
 
     void apply(row_tombstone t) {
         _row.apply(t);
     }
     void apply_monotonically(const schema& s, rows_entry&& e) {
+        unpack(s);
+        e.unpack(s);
         _row.apply(s, std::move(e._row));
     }
     bool empty() const {
-        return _row.empty();
+        return _row.empty() && !is_packed();
     }
     struct tri_compare {
         position_in_partition::tri_compare _c;
@@ -437,7 +437,7 @@ stop_iteration mutation_partition_v2::apply_monotonically(const schema& s, mutat
             }
             if (tracker) {
                 // Newer evictable versions store complete rows
-                i->row() = std::move(src_e.row());
+                i->replace_row(std::move(src_e));
                 // Need to preserve the LRU link of the later version in case it's
                 // the last dummy entry which holds the partition entry linked in LRU.
                 i->swap(src_e);
@@ -635,6 +635,8 @@ mutation_partition_v2::find_row(const schema& s, const clustering_key& key) cons
     if (i == _rows.end()) {
         return nullptr;
     }
+    // Packed rows exist only in the cache, which doesn't look rows up by key.
+    assert(!i->is_packed());
     return &i->row().cells();
 }
 
@@ -647,6 +649,7 @@ mutation_partition_v2::clustered_row(const schema& s, clustering_key&& key) {
             current_allocator().construct<rows_entry>(std::move(key)));
         i = _rows.insert_before_hint(i, std::move(e), rows_entry::tri_compare(s)).first;
     }
+    i->unpack(s);
     return i->row();
 }
 
@@ -659,6 +662,7 @@ mutation_partition_v2::clustered_row(const schema& s, const clustering_key& key)
             current_allocator().construct<rows_entry>(key));
         i = _rows.insert_before_hint(i, std::move(e), rows_entry::tri_compare(s)).first;
     }
+    i->unpack(s);
     return i->row();
 }
 
@@ -671,6 +675,7 @@ mutation_partition_v2::clustered_row(const schema& s, clustering_key_view key) {
             current_allocator().construct<rows_entry>(key));
         i = _rows.insert_before_hint(i, std::move(e), rows_entry::tri_compare(s)).first;
     }
+    i->unpack(s);
     return i->row();
 }
 
@@ -688,7 +693,9 @@ mutation_partition_v2::clustered_rows_entry(const schema& s, position_in_partiti
 
 deletable_row&
 mutation_partition_v2::clustered_row(const schema& s, position_in_partition_view pos, is_dummy dummy, is_continuous continuous) {
-    return clustered_rows_entry(s, pos, dummy, continuous).row();
+    rows_entry& e = clustered_rows_entry(s, pos, dummy, continuous);
+    e.unpack(s);
+    return e.row();
 }
 
 rows_entry&
@@ -848,11 +855,18 @@ operator<<(std::ostream& os, const mutation_partition_v2::printer& p) {
             os << indent << indent << indent << "},\n";
         }
 
-        row.cells().for_each_cell([&] (column_id& c_id, const atomic_cell_or_collection& cell) {
+        auto print_cell = [&] (column_id& c_id, const atomic_cell_or_collection& cell) {
             auto& column_def = p._schema.column_at(column_kind::regular_column, c_id);
             os << indent << indent << indent <<  "'" << column_def.name_as_text() 
                << "': " << atomic_cell_or_collection::printer(column_def, cell) << ",\n";
-        });
+        };
+        if (re.is_packed()) {
+            with_allocator(standard_allocator(), [&] {
+                re.unpacked_cells(p._schema).for_each_cell(print_cell);
+            });
+        } else {
+            row.cells().for_each_cell(print_cell);
+        }
 
         os << indent << indent << "},\n";
     }
@@ -950,14 +964,19 @@ void mutation_partition_v2::accept(const schema& s, mutation_partition_visitor&
             }
         }
         v.accept_row(e.position(), dr.deleted_at(), dr.marker(), e.dummy(), e.continuous());
-        dr.cells().for_each_cell([&] (column_id id, const atomic_cell_or_collection& cell) {
+        auto accept_cell = [&] (column_id id, const atomic_cell_or_collection& cell) {
             const column_definition& def = s.regular_column_at(id);
             if (def.is_atomic()) {
                 v.accept_row_cell(id, cell.as_atomic_cell(def));
             } else {
                 v.accept_row_cell(id, cell.as_collection_mutation());
             }
-        });
+        };
+        if (e.is_packed()) [[unlikely]] {
+            e.unpacked_cells(s).for_each_cell(accept_cell);
+        } else {
+            dr.cells().for_each_cell(accept_cell);
+        }
         prev_pos = e.position();
     }
 }
@@ -1136,7 +1155,7 @@ mutation_partition_v2::maybe_drop(const schema& s,
     rows_entry& e = *i;
     auto next_i = std::next(i);
 
-    if (!e.row().empty() || e.is_last_dummy()) {
+    if (!e.empty() || e.is_last_dummy()) {
         return next_i;
     }
 
@@ -356,6 +356,16 @@ void partition_entry::apply(logalloc::region& r,
     apply(r, c, s, mutation_partition_v2(mp_schema, std::move(mp_v1)), mp_schema, app_stats);
 }
 
+void partition_entry::apply(logalloc::region& r,
+           mutation_cleaner& c,
+           const schema& s,
+           mutation_partition&& mp,
+           const schema& mp_schema,
+           mutation_application_stats& app_stats) {
+    mp.make_fully_continuous();
+    apply(r, c, s, mutation_partition_v2(mp_schema, std::move(mp)), mp_schema, app_stats);
+}
+
 void partition_entry::apply(logalloc::region& r, mutation_cleaner& cleaner, const schema& s, mutation_partition_v2&& mp, const schema& mp_schema,
         mutation_application_stats& app_stats) {
     // A note about app_stats: it may happen that mp has rows that overwrite other rows
@@ -516,6 +526,7 @@ utils::coroutine partition_entry::apply_to_incomplete(const schema& s,
                         }
                         rows_entry& e = ropt->row;
                         if (!src_cur.dummy()) {
+                            e.unpack(s);
                             src_cur.consume_row([&](deletable_row&& row) {
                                 e.row().apply_monotonically(s, std::move(row));
                             });
@@ -526,6 +526,15 @@ class partition_entry {
                const schema& mp_schema,
                mutation_application_stats& app_stats);
 
+    // Like the above, but moves the contents of mp instead of copying them.
+    // mp is left in an unspecified state.
+    void apply(logalloc::region&,
+               mutation_cleaner&,
+               const schema& s,
+               mutation_partition&& mp,
+               const schema& mp_schema,
+               mutation_application_stats& app_stats);
+
     // Adds mutation_partition represented by "other" to the one represented
     // by this entry.
     // This entry must be evictable.
@@ -556,9 +556,9 @@ class partition_snapshot_row_cursor final {
     clustering_row row() const {
         // Note: if the precondition ("cursor is valid and pointing at a row") is fulfilled
         // then _current_row is not empty, so the below is valid.
-        clustering_row cr(key(), deletable_row(_schema, _current_row[0].it->row()));
+        clustering_row cr(_schema, *_current_row[0].it);
         for (size_t i = 1; i < _current_row.size(); ++i) {
-            cr.apply(_schema, _current_row[i].it->row());
+            cr.apply(_schema, *_current_row[i].it);
         }
         return cr;
     }
@@ -574,7 +574,9 @@ class partition_snapshot_row_cursor final {
     requires std::is_invocable_v<Consumer, deletable_row>
     void consume_row(Consumer&& consumer) {
         for (position_in_version& v : _current_row) {
-            if (v.unique_owner) {
+            if (v.it->is_packed()) [[unlikely]] {
+                consumer(v.it->unpacked_row(_schema));
+            } else if (v.unique_owner) {
                 consumer(std::move(v.it->row()));
             } else {
                 consumer(deletable_row(_schema, v.it->row()));
@@ -587,7 +589,11 @@ class partition_snapshot_row_cursor final {
     requires std::is_invocable_v<Consumer, const deletable_row&>
     void consume_row(Consumer&& consumer) const {
         for (const position_in_version& v : _current_row) {
-            consumer(v.it->row());
+            if (v.it->is_packed()) [[unlikely]] {
+                consumer(v.it->unpacked_row(_schema));
+            } else {
+                consumer(v.it->row());
+            }
         }
     }
 
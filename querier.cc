@@ -215,6 +215,22 @@ struct querier_utils {
     static void set_inactive_read_handle(querier_base& q, reader_concurrency_semaphore::inactive_read_handle h) noexcept {
         q._reader = std::move(h);
     }
+    static flat_mutation_reader_v2& reader(querier_base& q) noexcept {
+        return std::get<flat_mutation_reader_v2>(q._reader);
+    }
+    static bool is_prefetching(const querier_base& q) noexcept {
+        return q.is_prefetching();
+    }
+    static void set_prefetch(querier_base& q, shared_future<> prefetch, uint64_t id) noexcept {
+        q._prefetch = std::move(prefetch);
+        q._prefetch_id = id;
+    }
+    static void clear_prefetch(querier_base& q) noexcept {
+        q._prefetch.reset();
+    }
+    static uint64_t prefetch_id(const querier_base& q) noexcept {
+        return q._prefetch_id;
+    }
 };
 
 template <typename Querier>
@@ -240,6 +256,71 @@ void querier_cache::insert_querier(
 
     tracing::trace(trace_state, "Caching querier with key {}", key);
 
+    if constexpr (std::is_same_v<Querier, querier>) {
+        if (_prefetch && try_prefetch(key, index, q)) {
+            tracing::trace(trace_state, "Prefetching the next page");
+            return;
+        }
+    }
+
+    register_querier(key, index, stats, std::move(q), ttl);
+}
+
+bool querier_cache::try_prefetch(query_id key, querier_cache::index& index, querier& q) {
+    auto& reader = querier_utils::reader(q);
+    auto& sem = q.permit().semaphore();
+    if (!reader.is_buffer_empty() || reader.is_end_of_stream() || sem.get_stats().waiters || sem.available_resources().memory <= 0) {
+        return false;
+    }
+
+    const auto id = ++_last_prefetch_id;
+    // Readers aren't waited for while prefetching, let them give up
+    // when they would be evicted anyway.
+    reader.set_timeout(db::timeout_clock::now() + _entry_ttl);
+    auto prefetch = shared_future<>(reader.fill_buffer());
+    querier_utils::set_prefetch(q, prefetch, id);
+    auto qp = std::make_unique<querier>(std::move(q));
+    index.emplace(key, std::move(qp));
+    _prefetching.insert(id);
+    ++_stats.population;
+    ++_stats.prefetches;
+
+    // Safe, since _closing_gate is closed and waited on in
+    // querier_cache::stop()
+    (void)with_gate(_closing_gate, [this, key, &index, id, prefetch = std::move(prefetch)] () mutable {
+        return prefetch.get_future().then_wrapped([this, key, &index, id] (future<> f) {
+            const bool failed = f.failed();
+            f.ignore_ready_future();
+            if (!_prefetching.erase(id)) {
+                // Looked up meanwhile.
+                return make_ready_future<>();
+            }
+            const auto queriers = index.equal_range(key);
+            const auto it = std::find_if(queriers.first, queriers.second, [id] (const querier_cache::index::value_type& e) {
+                return querier_utils::prefetch_id(*e.second) == id;
+            });
+            auto q = std::move(static_cast<querier&>(*it->second));
+            index.erase(it);
+            --_stats.population;
+            querier_utils::clear_prefetch(q);
+            if (failed) {
+                // The next page will start from scratch.
+                return q.close().finally([q = std::move(q)] {});
+            }
+            register_querier(key, index, _stats, std::move(q), _entry_ttl);
+            return make_ready_future<>();
+        });
+    });
+    return true;
+}
+
+template <typename Querier>
+void querier_cache::register_querier(
+        query_id key,
+        querier_cache::index& index,
+        querier_cache::stats& stats,
+        Querier&& q,
+        std::chrono::seconds ttl) {
     auto& sem = q.permit().semaphore();
 
     auto irh = sem.register_inactive_read(querier_utils::get_reader(q));
@@ -322,12 +403,18 @@ std::optional<Querier> querier_cache::lookup_querier(
         throw std::runtime_error("lookup_querier(): found querier is not of the expected type");
     }
     auto& q = *q_ptr;
-    auto reader_opt = q.permit().semaphore().unregister_inactive_read(querier_utils::get_inactive_read_handle(q));
-    if (!reader_opt) {
-        throw std::runtime_error("lookup_querier(): found querier that is evicted");
+    if (querier_utils::is_prefetching(q)) {
+        // The page will wait for the prefetch to complete.
+        _prefetching.erase(querier_utils::prefetch_id(q));
+        querier_utils::reader(q).set_timeout(timeout);
+    } else {
+        auto reader_opt = q.permit().semaphore().unregister_inactive_read(querier_utils::get_inactive_read_handle(q));
+        if (!reader_opt) {
+            throw std::runtime_error("lookup_querier(): found querier that is evicted");
+        }
+        reader_opt->set_timeout(timeout);
+        querier_utils::set_reader(q, std::move(*reader_opt));
     }
-    reader_opt->set_timeout(timeout);
-    querier_utils::set_reader(q, std::move(*reader_opt));
     --stats.population;
 
     const auto can_be_used = can_be_used_for_page(q, s, ranges.front(), slice);
@@ -378,6 +465,12 @@ std::optional<shard_mutation_querier> querier_cache::lookup_shard_mutation_queri
 }
 
 future<> querier_base::close() noexcept {
+    if (is_prefetching()) {
+        return wait_for_prefetch().then_wrapped([reader = std::move(std::get<flat_mutation_reader_v2>(_reader))] (future<> f) mutable {
+            f.ignore_ready_future();
+            return reader.close();
+        });
+    }
     struct variant_closer {
         querier_base& q;
         future<> operator()(flat_mutation_reader_v2& reader) {
@@ -395,13 +488,23 @@ void querier_cache::set_entry_ttl(std::chrono::seconds entry_ttl) {
     _entry_ttl = entry_ttl;
 }
 
+void querier_cache::set_prefetch(bool prefetch) {
+    _prefetch = prefetch;
+}
+
 future<bool> querier_cache::evict_one() noexcept {
     for (auto ip : {&_data_querier_index, &_mutation_querier_index, &_shard_mutation_querier_index}) {
         auto& idx = *ip;
         if (idx.empty()) {
             continue;
         }
-        auto it = idx.begin();
+        // Prefetching queriers aren't registered with the semaphore yet.
+        auto it = std::find_if(idx.begin(), idx.end(), [] (const index::value_type& e) {
+            return !querier_utils::is_prefetching(*e.second);
+        });
+        if (it == idx.end()) {
+            continue;
+        }
         auto reader_opt = it->second->permit().semaphore().unregister_inactive_read(querier_utils::get_inactive_read_handle(*it->second));
         idx.erase(it);
         ++_stats.resource_based_evictions;
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <seastar/core/shared_future.hh>
 #include <seastar/util/closeable.hh>
 
 #include "mutation/mutation_compactor.hh"
@@ -17,6 +18,7 @@
 
 #include <boost/intrusive/set.hpp>
 
+#include <unordered_set>
 #include <variant>
 
 namespace query {
@@ -69,6 +71,18 @@ class querier_base {
     std::variant<flat_mutation_reader_v2, reader_concurrency_semaphore::inactive_read_handle> _reader;
     dht::partition_ranges_view _query_ranges;
     querier_config _qr_config;
+    // The reader filling its buffer with the next page, while the querier is
+    // cached, see querier_cache::set_prefetch().
+    std::optional<shared_future<>> _prefetch;
+    uint64_t _prefetch_id = 0;
+
+    bool is_prefetching() const {
+        return _prefetch && _prefetch->valid();
+    }
+
+    future<> wait_for_prefetch() {
+        return std::exchange(_prefetch, std::nullopt)->get_future();
+    }
 
 public:
     querier_base(reader_permit permit, lw_shared_ptr<const dht::partition_range> range,
@@ -93,6 +107,17 @@ class querier_base {
         , _qr_config(std::move(config))
     { }
 
+    querier_base(schema_ptr schema, reader_permit permit, dht::partition_range range,
+            query::partition_slice slice, flat_mutation_reader_v2 reader, querier_config config)
+        : _schema(std::move(schema))
+        , _permit(std::move(permit))
+        , _range(make_lw_shared<const dht::partition_range>(std::move(range)))
+        , _slice(std::make_unique<const query::partition_slice>(std::move(slice)))
+        , _reader(std::move(reader))
+        , _query_ranges(*_range)
+        , _qr_config(std::move(config))
+    { }
+
     querier_base(querier_base&&) = default;
     querier_base& operator=(querier_base&&) = default;
 
@@ -160,17 +185,38 @@ class querier : public querier_base {
         , _compaction_state(make_lw_shared<compact_for_query_state_v2>(*schema, gc_clock::time_point{}, *_slice, 0, 0)) {
     }
 
+    /// Serves the query from \p reader, which must read \p range with \p slice.
+    querier(flat_mutation_reader_v2 reader,
+            schema_ptr schema,
+            reader_permit permit,
+            dht::partition_range range,
+            query::partition_slice slice,
+            querier_config config = {})
+        : querier_base(schema, permit, std::move(range), std::move(slice), std::move(reader), std::move(config))
+        , _compaction_state(make_lw_shared<compact_for_query_state_v2>(*schema, gc_clock::time_point{}, *_slice, 0, 0)) {
+    }
+
     bool are_limits_reached() const {
         return  _compaction_state->are_limits_reached();
     }
 
+    /// Stats of the last page.
+    const compaction_stats& page_stats() const {
+        return _compaction_state->stats();
+    }
+
+    const dht::partition_range& range() const {
+        return *_range;
+    }
+
+private:
     template <typename Consumer>
     requires CompactedFragmentsConsumerV2<Consumer>
-    auto consume_page(Consumer&& consumer,
+    auto do_consume_page(Consumer&& consumer,
             uint64_t row_limit,
             uint32_t partition_limit,
             gc_clock::time_point query_time,
-            tracing::trace_state_ptr trace_ptr = {}) {
+            tracing::trace_state_ptr trace_ptr) {
         return ::query::consume_page(std::get<flat_mutation_reader_v2>(_reader), _compaction_state, *_slice, std::move(consumer), row_limit,
                 partition_limit, query_time).then_wrapped([this, trace_ptr = std::move(trace_ptr)] (auto&& fut) {
             const auto& cstats = _compaction_state->stats();
@@ -198,6 +244,23 @@ class querier : public querier_base {
         });
     }
 
+public:
+    template <typename Consumer>
+    requires CompactedFragmentsConsumerV2<Consumer>
+    auto consume_page(Consumer&& consumer,
+            uint64_t row_limit,
+            uint32_t partition_limit,
+            gc_clock::time_point query_time,
+            tracing::trace_state_ptr trace_ptr = {}) {
+        if (is_prefetching()) {
+            return wait_for_prefetch().then([this, consumer = std::forward<Consumer>(consumer), row_limit, partition_limit, query_time,
+                    trace_ptr = std::move(trace_ptr)] () mutable {
+                return do_consume_page(std::move(consumer), row_limit, partition_limit, query_time, std::move(trace_ptr));
+            });
+        }
+        return do_consume_page(std::forward<Consumer>(consumer), row_limit, partition_limit, query_time, std::move(trace_ptr));
+    }
+
     virtual std::optional<full_position_view> current_position() const override {
         const dht::decorated_key* dk = _compaction_state->current_partition();
         if (!dk) {
@@ -309,6 +372,8 @@ class querier_cache {
         uint64_t resource_based_evictions = 0;
         // The number of queriers currently in the cache.
         uint64_t population = 0;
+        // The number of inserted queriers which started reading the next page.
+        uint64_t prefetches = 0;
     };
 
     using index = std::unordered_multimap<query_id, std::unique_ptr<querier_base>>;
@@ -320,8 +385,22 @@ class querier_cache {
     std::chrono::seconds _entry_ttl;
     stats _stats;
     gate _closing_gate;
+    bool _prefetch = false;
+    uint64_t _last_prefetch_id = 0;
+    // Ids of the cached queriers still prefetching.
+    std::unordered_set<uint64_t> _prefetching;
 
 private:
+    template <typename Querier>
+    void register_querier(
+            query_id key,
+            querier_cache::index& index,
+            querier_cache::stats& stats,
+            Querier&& q,
+            std::chrono::seconds ttl);
+
+    bool try_prefetch(query_id key, querier_cache::index& index, querier& q);
+
     template <typename Querier>
     void insert_querier(
             query_id key,
@@ -402,6 +481,17 @@ class querier_cache {
     /// Applies only to entries inserted after the change.
     void set_entry_ttl(std::chrono::seconds entry_ttl);
 
+    /// Make inserted data and mutation queriers read ahead the next page.
+    ///
+    /// A querier is inserted when its page is done and about to be sent to
+    /// the coordinator. If its reader has nothing buffered, and the semaphore
+    /// has memory to spare and no reads queued, the reader fills its buffer
+    /// while the page travels to the client, and the next page is requested.
+    /// The querier is registered as an inactive read, which the semaphore may
+    /// evict, only once the buffer is filled. A lookup meanwhile gets the
+    /// querier right away, the next page waits for the buffer.
+    void set_prefetch(bool prefetch);
+
     /// Evict a querier.
     ///
     /// Return true if a querier was evicted and false otherwise (if the cache
@@ -171,6 +171,11 @@ class partition_slice {
         // directly, bypassing the intermediate reconcilable_result format used
         // in pre 4.5 range scans.
         range_scan_data_variant,
+        // Set by the replica on data queries which don't populate the cache:
+        // the sstable readers may return the cells of the columns which are not
+        // selected without their values, which they then needn't copy. The
+        // cells keep their liveness. Never sent to other nodes.
+        skip_unselected_values,
     };
     using option_set = enum_set<super_enum<option,
         option::send_clustering_key,
@@ -185,7 +190,8 @@ class partition_slice {
         option::with_digest,
         option::bypass_cache,
         option::always_return_static_content,
-        option::range_scan_data_variant>>;
+        option::range_scan_data_variant,
+        option::skip_unselected_values>>;
     clustering_row_ranges _row_ranges;
 public:
     column_id_vector static_columns; // TODO: consider using bitmap
@@ -275,6 +281,22 @@ enum class tombstone_limit : uint64_t { max = max_tombstones };
 
 using is_first_page = bool_class<class is_first_page_tag>;
 
+// A comparison of a regular column with a value, which replicas check on the
+// rows of data queries before adding them to the results, so that rows which
+// fail it aren't sent to the coordinator. Rows whose column is null fail it.
+//
+// Coordinators still filter the rows they get with all the restrictions of
+// the query, so only restrictions they check too can be passed down. Rows
+// are checked after they are merged from all the sources of the replica, so
+// only the result of the replica is affected, mutation queries used to
+// reconcile replicas are not filtered.
+struct column_filter {
+    enum class op : uint8_t { eq, neq, lt, lte, gt, gte };
+    column_id column;
+    op oper;
+    bytes value;
+};
+
 // Full specification of a query to the database.
 // Intended for passing across replicas.
 // Can be accessed across cores.
@@ -307,6 +329,10 @@ class read_command {
     uint32_t row_limit_high_bits;
     // Cut the page after processing this many tombstones (even if the page is empty).
     uint64_t tombstone_limit;
+    // Filters which the rows of the results must pass, see column_filter.
+    // Only for paged queries with no per partition or partition limit,
+    // which allow short reads.
+    std::vector<column_filter> filters;
     api::timestamp_type read_timestamp; // not serialized
     db::allow_per_partition_rate_limit allow_limit; // not serialized
 public:
@@ -322,7 +348,8 @@ class read_command {
                  query::is_first_page is_first_page,
                  std::optional<query::max_result_size> max_result_size,
                  uint32_t row_limit_high_bits,
-                 uint64_t tombstone_limit)
+                 uint64_t tombstone_limit,
+                 std::vector<column_filter> filters = {})
         : cf_id(std::move(cf_id))
         , schema_version(std::move(schema_version))
         , slice(std::move(slice))
@@ -335,6 +362,7 @@ class read_command {
         , max_result_size(max_result_size)
         , row_limit_high_bits(row_limit_high_bits)
         , tombstone_limit(tombstone_limit)
+        , filters(std::move(filters))
         , read_timestamp(api::new_timestamp())
         , allow_limit(db::allow_per_partition_rate_limit::no)
     { }
@@ -393,6 +421,12 @@ struct forward_request {
         std::vector<reduction_type> types;
         std::vector<aggregation_info> infos;
     };
+    struct grouped_reductions_info {
+        reductions_info reductions;
+        // For each selector, the position among the grouping columns of the
+        // column it selects, or std::nullopt if it is one of the reductions.
+        std::vector<std::optional<size_t>> group_by_positions;
+    };
 
     std::vector<reduction_type> reduction_types;
 
@@ -402,6 +436,10 @@ struct forward_request {
     db::consistency_level cl;
     lowres_system_clock::time_point timeout;
     std::optional<std::vector<aggregation_info>> aggregation_infos;
+    // If not empty, the reductions are computed for each group of rows
+    // with the same values of these columns, which are the partition key
+    // columns followed by a prefix of the clustering key columns.
+    std::vector<sstring> group_by_columns;
 };
 
 std::ostream& operator<<(std::ostream& out, const forward_request& r);
@@ -411,6 +449,9 @@ std::ostream& operator<<(std::ostream& out, const forward_request::aggregation_i
 struct forward_result {
     // vector storing query result for each selected column
     std::vector<bytes_opt> query_results;
+    // For requests with group_by_columns, the values of these columns
+    // followed by the query results, for each group.
+    std::vector<std::vector<bytes_opt>> grouped_results;
 
     struct printer {
         const std::vector<::shared_ptr<db::functions::aggregate_function>> functions;
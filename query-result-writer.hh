@@ -35,6 +35,8 @@ class result::partition_writer {
     uint64_t& _row_count;
     uint32_t& _partition_count;
     api::timestamp_type& _last_modified;
+    const std::vector<column_filter>* _filters;
+    uint64_t& _filtered_rows;
 public:
     partition_writer(
         result_request request,
@@ -46,7 +48,9 @@ class result::partition_writer {
         digester& digest,
         uint64_t& row_count,
         uint32_t& partition_count,
-        api::timestamp_type& last_modified)
+        api::timestamp_type& last_modified,
+        const std::vector<column_filter>* filters,
+        uint64_t& filtered_rows)
         : _request(request)
         , _w(std::move(w))
         , _slice(slice)
@@ -58,6 +62,8 @@ class result::partition_writer {
         , _row_count(row_count)
         , _partition_count(partition_count)
         , _last_modified(last_modified)
+        , _filters(filters)
+        , _filtered_rows(filtered_rows)
     { }
 
     bool requested_digest() const {
@@ -98,7 +104,13 @@ class result::partition_writer {
     api::timestamp_type& last_modified() {
         return _last_modified;
     }
-
+    // Null when rows aren't filtered.
+    const std::vector<column_filter>* filters() const {
+        return _filters;
+    }
+    uint64_t& filtered_rows() {
+        return _filtered_rows;
+    }
 };
 
 class result::builder {
@@ -114,6 +126,8 @@ class result::builder {
     result_memory_accounter _memory_accounter;
     const uint64_t _tombstone_limit = query::max_tombstones;
     uint64_t _tombstones = 0;
+    const std::vector<column_filter>* _filters = nullptr;
+    uint64_t _filtered_rows = 0;
 public:
     builder(const partition_slice& slice, result_options options, result_memory_accounter memory_accounter, uint64_t tombstone_limit)
         : _slice(slice)
@@ -145,6 +159,20 @@ class result::builder {
 
     const partition_slice& slice() const { return _slice; }
 
+    // Leaves the rows which fail filters out of the result, see column_filter.
+    // filters must outlive the builder.
+    void set_filters(const std::vector<column_filter>& filters) {
+        if (!filters.empty() && _slice.options.contains<partition_slice::option::allow_short_read>()) {
+            _filters = &filters;
+        }
+    }
+
+    // Rows left out of the result by the filters. They still count towards
+    // the row limit of the read, which bounds its work.
+    uint64_t filtered_rows() const {
+        return _filtered_rows;
+    }
+
     uint64_t row_count() const {
         return _row_count;
     }
@@ -170,7 +198,7 @@ class result::builder {
             _digest.feed_hash(key, s);
         }
         return partition_writer(_request, _slice, ranges, _w, std::move(pos), std::move(after_key), _digest, _row_count,
-                                _partition_count, _last_modified);
+                                _partition_count, _last_modified, _filters, _filtered_rows);
     }
 
     result build(std::optional<full_position> last_pos = {}) {
@@ -207,6 +235,7 @@ class mutation_querier {
     bool _live_data_in_static_row{};
     uint64_t _live_clustering_rows = 0;
     std::optional<ser::qr_partition__rows<bytes_ostream>> _rows_wr;
+    uint64_t _filtered_rows = 0;
 private:
     void query_static_row(const row& r, tombstone current_tombstone);
     void prepare_writers();
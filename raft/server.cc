@@ -973,6 +973,43 @@ future<> server_impl::io_fiber(index_t last_stable) {
                 _state_machine->drop_snapshot(snp_id);
             }
 
+            auto send_one = [this] (std::pair<server_id, rpc_message>& m) {
+                try {
+                    send_message(m.first, std::move(m.second));
+                } catch(...) {
+                    // Not being able to send a message is not a critical error
+                    logger.debug("[{}] io_fiber failed to send a message to {}: {}", _id, m.first, std::current_exception());
+                }
+            };
+
+            // Update RPC server address mappings. Add servers which are joining
+            // the cluster according to the new configuration (obtained from the
+            // last_conf_idx).
+            //
+            // It should be done prior to sending the messages since the RPC
+            // module needs to know who should it send the messages to (actual
+            // network addresses of the joining servers).
+            rpc_config_diff rpc_diff;
+            if (batch.configuration) {
+                rpc_diff = diff_address_sets(get_rpc_config(), *batch.configuration);
+                for (const auto& addr: rpc_diff.joining) {
+                    add_to_rpc_config(addr);
+                }
+                _rpc->on_configuration_change(rpc_diff.joining, {});
+            }
+
+            // The leader sends its entries to the followers while it persists
+            // them, as in section 10.2.1 of the Raft PhD thesis, so that the
+            // round trip to the followers overlaps the local write. The leader
+            // counts itself towards the quorum of the entries right away, but
+            // whatever gets committed is only acted upon with the next batch,
+            // after this one is persisted. Only a leader sends append_request.
+            for (auto&& m : batch.messages) {
+                if (std::holds_alternative<append_request>(m.second)) {
+                    send_one(m);
+                }
+            }
+
             if (batch.log_entries.size()) {
                 auto& entries = batch.log_entries;
 
@@ -992,30 +1029,12 @@ future<> server_impl::io_fiber(index_t last_stable) {
                 _stats.persisted_log_entries += entries.size();
             }
 
-            // Update RPC server address mappings. Add servers which are joining
-            // the cluster according to the new configuration (obtained from the
-            // last_conf_idx).
-            //
-            // It should be done prior to sending the messages since the RPC
-            // module needs to know who should it send the messages to (actual
-            // network addresses of the joining servers).
-            rpc_config_diff rpc_diff;
-            if (batch.configuration) {
-                rpc_diff = diff_address_sets(get_rpc_config(), *batch.configuration);
-                for (const auto& addr: rpc_diff.joining) {
-                    add_to_rpc_config(addr);
-                }
-                _rpc->on_configuration_change(rpc_diff.joining, {});
-            }
-
-             // After entries are persisted we can send messages.
+             // After entries are persisted we can send the other messages.
             for (auto&& m : batch.messages) {
-                try {
-                    send_message(m.first, std::move(m.second));
-                } catch(...) {
-                    // Not being able to send a message is not a critical error
-                    logger.debug("[{}] io_fiber failed to send a message to {}: {}", _id, m.first, std::current_exception());
+                if (std::holds_alternative<append_request>(m.second)) {
+                    continue;
                 }
+                send_one(m);
             }
 
             if (batch.configuration) {
@@ -137,6 +137,8 @@ class read_context final : public enable_lw_shared_from_this<read_context> {
     //
     autoupdating_underlying_reader _underlying;
     uint64_t _underlying_created = 0;
+    // What the permit read from sstables before this read, to attribute the rest to its misses.
+    sstable_read_stats _sstable_reads_before;
 
     mutation_source_opt _underlying_snapshot;
     dht::partition_range _sm_range;
@@ -167,6 +169,7 @@ class read_context final : public enable_lw_shared_from_this<read_context> {
             _native_slice = query::legacy_reverse_slice_to_native_reverse_slice(*_schema, _slice);
         }
         ++_cache._tracker._stats.reads;
+        _sstable_reads_before = _permit.get_sstable_read_stats();
         if (!_range_query) {
             _key = range.start()->value().as_decorated_key();
         }
@@ -176,6 +179,7 @@ class read_context final : public enable_lw_shared_from_this<read_context> {
         if (_underlying_created) {
             _cache._stats.reads_with_misses.mark();
             ++_cache._tracker._stats.reads_with_misses;
+            _cache.on_read_with_misses(_range_query, _sstable_reads_before, _permit.get_sstable_read_stats());
         } else {
             _cache._stats.reads_with_no_misses.mark();
         }
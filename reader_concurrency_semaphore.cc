@@ -19,6 +19,9 @@
 #include "utils/exceptions.hh"
 #include "schema/schema.hh"
 #include "utils/human_readable.hh"
+#include "utils/cpu_profiler.hh"
+#include "sstables/generation_type.hh"
+#include "sstables/resume_hint.hh"
 
 logger rcslog("reader_concurrency_semaphore");
 
@@ -27,6 +30,7 @@ struct reader_concurrency_semaphore::inactive_read {
     eviction_notify_handler notify_handler;
     timer<lowres_clock> ttl_timer;
     inactive_read_handle* handle = nullptr;
+    lowres_clock::time_point registered_at = lowres_clock::now();
 
     explicit inactive_read(flat_mutation_reader_v2 reader_) noexcept
         : reader(std::move(reader_))
@@ -36,6 +40,7 @@ struct reader_concurrency_semaphore::inactive_read {
         , notify_handler(std::move(o.notify_handler))
         , ttl_timer(std::move(o.ttl_timer))
         , handle(o.handle)
+        , registered_at(o.registered_at)
     {
         o.handle = nullptr;
     }
@@ -147,30 +152,53 @@ class reader_permit::impl
     timer<db::timeout_clock> _ttl_timer;
     query::max_result_size _max_result_size{query::result_memory_limiter::unlimited_result_size};
     uint64_t _sstables_read = 0;
+    sstable_read_stats _sstable_read_stats;
+    std::unordered_map<sstables::generation_type, lw_shared_ptr<const sstables::resume_hint>> _sstable_resume_hints;
     size_t _requested_memory = 0;
     uint64_t _oom_kills = 0;
     tracing::trace_state_ptr _trace_ptr;
+    read_cost _cost;
+    bool _scan_cost_consumed = false;
+    // Moving average of the time the permit spent inactive before being resumed,
+    // e.g. between pages of a paged query. Zero if it was never resumed.
+    lowres_clock::duration _mean_inactive_time{};
+    std::chrono::steady_clock::time_point _enqueued_at;
 
     // Not strictly related to the permit.
     // Used by the semaphore to to manage the permit.
     auxiliary_data _aux_data;
 
 private:
+    // Attribute the CPU used from now on to the permit's table, see utils::cpu_profiler.
+    void set_cpu_profiling_table() noexcept {
+        if (_schema) {
+            utils::current_cpu_profiling_table = _schema->id().uuid();
+        }
+    }
+    void clear_cpu_profiling_table() noexcept {
+        if (_schema && utils::current_cpu_profiling_table == _schema->id().uuid()) {
+            utils::current_cpu_profiling_table = utils::UUID();
+        }
+    }
     void on_permit_used() {
         _semaphore.on_permit_used();
         _marked_as_used = true;
+        set_cpu_profiling_table();
     }
     void on_permit_unused() {
         _semaphore.on_permit_unused();
         _marked_as_used = false;
+        clear_cpu_profiling_table();
     }
     void on_permit_blocked() {
         _semaphore.on_permit_blocked();
         _marked_as_blocked = true;
+        clear_cpu_profiling_table();
     }
     void on_permit_unblocked() {
         _semaphore.on_permit_unblocked();
         _marked_as_blocked = false;
+        set_cpu_profiling_table();
     }
     void on_permit_active() {
         if (_used_branches) {
@@ -195,6 +223,20 @@ class reader_permit::impl
         }
     }
 
+    void consume_scan_cost() noexcept {
+        if (_cost.lane == read_lane::scan && !_scan_cost_consumed) {
+            _semaphore._stats.scan_cost += _cost.sstables;
+            _scan_cost_consumed = true;
+        }
+    }
+
+    void release_scan_cost() noexcept {
+        if (_scan_cost_consumed) {
+            _semaphore._stats.scan_cost -= _cost.sstables;
+            _scan_cost_consumed = false;
+        }
+    }
+
     void on_timeout() {
         auto keepalive = std::exchange(_aux_data.permit_keepalive, std::nullopt);
 
@@ -238,6 +280,7 @@ class reader_permit::impl
         _semaphore.on_permit_created(*this);
     }
     ~impl() {
+        release_scan_cost();
         if (_base_resources_consumed) {
             signal(_base_resources);
         }
@@ -297,6 +340,7 @@ class reader_permit::impl
 
     void on_waiting_for_admission() {
         on_permit_inactive(reader_permit::state::waiting_for_admission);
+        _enqueued_at = std::chrono::steady_clock::now();
     }
 
     void on_waiting_for_memory() {
@@ -312,6 +356,7 @@ class reader_permit::impl
         on_permit_active();
         consume(_base_resources);
         _base_resources_consumed = true;
+        consume_scan_cost();
     }
 
     void on_granted_memory() {
@@ -338,6 +383,7 @@ class reader_permit::impl
     void on_evicted() {
         assert(_state == reader_permit::state::inactive);
         _state = reader_permit::state::evicted;
+        release_scan_cost();
         if (_base_resources_consumed) {
             signal(_base_resources);
             _base_resources_consumed = false;
@@ -369,7 +415,20 @@ class reader_permit::impl
         return _base_resources;
     }
 
+    read_cost cost() const noexcept {
+        return _cost;
+    }
+
+    void set_cost(read_cost cost) noexcept {
+        _cost = cost;
+    }
+
+    std::chrono::steady_clock::time_point enqueued_at() const noexcept {
+        return _enqueued_at;
+    }
+
     void release_base_resources() noexcept {
+        release_scan_cost();
         if (_base_resources_consumed) {
             _resources -= _base_resources;
             _base_resources_consumed = false;
@@ -479,6 +538,36 @@ class reader_permit::impl
         }
         ++_sstables_read;
         ++_semaphore._stats.sstables_read;
+        ++_sstable_read_stats.sstables_read;
+    }
+
+    sstable_read_stats& get_sstable_read_stats() noexcept {
+        return _sstable_read_stats;
+    }
+
+    void set_sstable_resume_hint(sstables::generation_type gen, lw_shared_ptr<const sstables::resume_hint> hint) {
+        if (hint) {
+            _sstable_resume_hints.insert_or_assign(gen, std::move(hint));
+        } else {
+            _sstable_resume_hints.erase(gen);
+        }
+    }
+
+    lw_shared_ptr<const sstables::resume_hint> get_sstable_resume_hint(sstables::generation_type gen) const {
+        auto it = _sstable_resume_hints.find(gen);
+        return it == _sstable_resume_hints.end() ? nullptr : it->second;
+    }
+
+    uint64_t sstables_read() const noexcept {
+        return _sstables_read;
+    }
+
+    lowres_clock::duration mean_inactive_time() const noexcept {
+        return _mean_inactive_time;
+    }
+
+    void on_resumed(lowres_clock::duration inactive_time) noexcept {
+        _mean_inactive_time = _mean_inactive_time.count() ? (3 * _mean_inactive_time + inactive_time) / 4 : inactive_time;
     }
 
     void on_finish_sstable_read() noexcept {
@@ -572,6 +661,10 @@ void reader_permit::release_base_resources() noexcept {
     return _impl->release_base_resources();
 }
 
+read_cost reader_permit::cost() const {
+    return _impl->cost();
+}
+
 sstring reader_permit::description() const {
     return _impl->description();
 }
@@ -628,6 +721,26 @@ void reader_permit::on_finish_sstable_read() noexcept {
     _impl->on_finish_sstable_read();
 }
 
+void reader_permit::on_sstable_bytes_read(uint64_t bytes) noexcept {
+    _impl->get_sstable_read_stats().bytes_read += bytes;
+}
+
+void reader_permit::on_index_page_read() noexcept {
+    ++_impl->get_sstable_read_stats().index_pages_read;
+}
+
+const sstable_read_stats& reader_permit::get_sstable_read_stats() const noexcept {
+    return _impl->get_sstable_read_stats();
+}
+
+void reader_permit::set_sstable_resume_hint(sstables::generation_type gen, lw_shared_ptr<const sstables::resume_hint> hint) {
+    _impl->set_sstable_resume_hint(gen, std::move(hint));
+}
+
+lw_shared_ptr<const sstables::resume_hint> reader_permit::get_sstable_resume_hint(sstables::generation_type gen) const {
+    return _impl->get_sstable_resume_hint(gen);
+}
+
 std::ostream& operator<<(std::ostream& os, reader_permit::state s) {
     switch (s) {
         case reader_permit::state::waiting_for_admission:
@@ -854,7 +967,22 @@ reader_concurrency_semaphore::inactive_read_handle::operator=(inactive_read_hand
 
 void reader_concurrency_semaphore::wait_queue::push_to_admission_queue(reader_permit::impl& p) {
     p.unlink();
-    _admission_queue.push_back(p);
+    if (p.cost().lane == read_lane::point) {
+        _point_admission_queue.push_back(p);
+    } else {
+        if (_admission_queue.empty()) {
+            _point_reads_ahead_of_scan = 0;
+        }
+        _admission_queue.push_back(p);
+    }
+}
+
+void reader_concurrency_semaphore::wait_queue::on_admitted(read_lane lane) noexcept {
+    if (lane == read_lane::scan) {
+        _point_reads_ahead_of_scan = 0;
+    } else if (!_admission_queue.empty()) {
+        ++_point_reads_ahead_of_scan;
+    }
 }
 
 void reader_concurrency_semaphore::wait_queue::push_to_memory_queue(reader_permit::impl& p) {
@@ -863,10 +991,12 @@ void reader_concurrency_semaphore::wait_queue::push_to_memory_queue(reader_permi
 }
 
 reader_permit::impl& reader_concurrency_semaphore::wait_queue::front() {
-    if (_memory_queue.empty()) {
-        return _admission_queue.front();
-    } else {
+    if (!_memory_queue.empty()) {
         return _memory_queue.front();
+    } else if (!_point_admission_queue.empty() && !scan_is_due()) {
+        return _point_admission_queue.front();
+    } else {
+        return _admission_queue.front();
     }
 }
 
@@ -1048,14 +1178,50 @@ flat_mutation_reader_v2_opt reader_concurrency_semaphore::unregister_inactive_re
 
     dequeue_permit(permit);
     permit.on_unregister_as_inactive();
+    const auto inactive_time = lowres_clock::now() - irp->registered_at;
+    permit.on_resumed(inactive_time);
+    _mean_inactive_time = _mean_inactive_time.count() ? (7 * _mean_inactive_time + inactive_time) / 8 : inactive_time;
     return std::move(irp->reader);
 }
 
+double reader_concurrency_semaphore::inactive_read_value(reader_permit::impl& permit, lowres_clock::time_point now) const noexcept {
+    // Recreating the reader costs at least the lookup of its position in the
+    // index of each sstable it reads.
+    const double recreation_cost = 1 + permit.sstables_read();
+    // The read is expected to be resumed after about as long as it was
+    // inactive in the past. The longer it stays inactive after that, the less
+    // likely it is that it will be resumed at all, e.g. the client gave up paging.
+    const auto expected_inactive_time = permit.mean_inactive_time().count() ? permit.mean_inactive_time() : _mean_inactive_time;
+    const auto inactive_time = now - permit.aux_data().ir->registered_at;
+    double resume_likelihood = 1;
+    if (expected_inactive_time.count() && inactive_time > expected_inactive_time) {
+        resume_likelihood = double(expected_inactive_time.count()) / inactive_time.count();
+    }
+    return recreation_cost * resume_likelihood;
+}
+
+reader_permit::impl& reader_concurrency_semaphore::select_inactive_read_to_evict() noexcept {
+    // Only consider the oldest inactive reads, to bound the cost of selection
+    // and to keep eviction roughly FIFO between reads of similar value.
+    static constexpr unsigned max_candidates = 16;
+    const auto now = lowres_clock::now();
+    auto* victim = &_inactive_reads.front();
+    double victim_value = std::numeric_limits<double>::max();
+    unsigned candidates = 0;
+    for (auto it = _inactive_reads.begin(); it != _inactive_reads.end() && candidates < max_candidates; ++it, ++candidates) {
+        if (const auto value = inactive_read_value(*it, now); value < victim_value) {
+            victim = &*it;
+            victim_value = value;
+        }
+    }
+    return *victim;
+}
+
 bool reader_concurrency_semaphore::try_evict_one_inactive_read(evict_reason reason) {
     if (_inactive_reads.empty()) {
         return false;
     }
-    evict(_inactive_reads.front(), reason);
+    evict(select_inactive_read_to_evict(), reason);
     return true;
 }
 
@@ -1128,6 +1294,8 @@ void reader_concurrency_semaphore::do_detach_inactive_reader(reader_permit::impl
     switch (reason) {
         case evict_reason::permit:
             ++_stats.permit_based_evictions;
+            _stats.permit_based_evictions_sstables += permit.sstables_read();
+            _stats.permit_based_evictions_memory += permit.resources().memory;
             break;
         case evict_reason::time:
             ++_stats.time_based_evictions;
@@ -1209,7 +1377,7 @@ void reader_concurrency_semaphore::evict_readers_in_background() {
                 _evicting = false;
                 return make_ready_future<stop_iteration>(stop_iteration::yes);
             }
-            return detach_inactive_reader(_inactive_reads.front(), evict_reason::permit).close().then([] {
+            return detach_inactive_reader(select_inactive_read_to_evict(), evict_reason::permit).close().then([] {
                 return stop_iteration::no;
             });
         });
@@ -1258,9 +1426,20 @@ reader_concurrency_semaphore::can_admit_read(const reader_permit::impl& permit)
         }
     }
 
+    if (permit.cost().lane == read_lane::scan && !has_available_scan_cost(permit.cost()) && !_wait_list.is_due(permit)) {
+        return {can_admit::no, reason::scan_cost};
+    }
+
     return {can_admit::yes, reason::all_ok};
 }
 
+bool reader_concurrency_semaphore::has_available_scan_cost(const read_cost& cost) const noexcept {
+    const auto limit = _scan_cost_limit();
+    // A scan is always admitted if there is no other scan, even if its cost
+    // is above the limit alone, so that it is not starved.
+    return !limit || !_stats.scan_cost || _stats.scan_cost + cost.sstables <= limit;
+}
+
 bool reader_concurrency_semaphore::should_evict_inactive_read() const noexcept {
     if (_resources.memory < 0 || _resources.count < 0) {
         return true;
@@ -1282,7 +1461,8 @@ future<> reader_concurrency_semaphore::do_wait_admission(reader_permit::impl& pe
         &stats::reads_queued_because_ready_list,
         &stats::reads_queued_because_used_permits,
         &stats::reads_queued_because_memory_resources,
-        &stats::reads_queued_because_count_resources
+        &stats::reads_queued_because_count_resources,
+        &stats::reads_queued_because_scan_cost
     };
 
     static const char* result_as_string[] = {
@@ -1290,15 +1470,17 @@ future<> reader_concurrency_semaphore::do_wait_admission(reader_permit::impl& pe
         "queued because of non-empty ready list",
         "queued because of used permits",
         "queued because of memory resources",
-        "queued because of count resources"
+        "queued because of count resources",
+        "queued because of the cost of admitted scans"
     };
 
     const auto [admit, why] = can_admit_read(permit);
     ++(_stats.*stats_table[static_cast<int>(why)]);
     tracing::trace(permit.trace_state(), "[reader concurrency semaphore] {}", result_as_string[static_cast<int>(why)]);
-    if (admit != can_admit::yes || !_wait_list.empty()) {
+    // Point reads only queue behind other point reads, not behind scans.
+    if (admit != can_admit::yes || _wait_list.has_waiters_ahead_of(permit.cost().lane)) {
         auto fut = enqueue_waiter(permit, wait_on::admission);
-        if (admit == can_admit::yes && !_wait_list.empty()) {
+        if (admit == can_admit::yes && can_admit_read(_wait_list.front()).decision == can_admit::yes) {
             // This is a contradiction: the semaphore could admit waiters yet it has waiters.
             // Normally, the semaphore should admit waiters as soon as it can.
             // So at any point in time, there should either be no waiters, or it
@@ -1315,6 +1497,11 @@ future<> reader_concurrency_semaphore::do_wait_admission(reader_permit::impl& pe
 
     permit.on_admission();
     ++_stats.reads_admitted;
+    _wait_list.on_admitted(permit.cost().lane);
+    if (_wait_list.scan_is_due()) {
+        // The oldest scan may have been held back by the scan cost limit only.
+        maybe_admit_waiters();
+    }
     if (permit.aux_data().func) {
         return with_ready_permit(permit);
     }
@@ -1333,6 +1520,17 @@ void reader_concurrency_semaphore::maybe_admit_waiters() noexcept {
             } else {
                 permit.on_admission();
                 ++_stats.reads_admitted;
+                _wait_list.on_admitted(permit.cost().lane);
+                const auto queue_duration = std::chrono::steady_clock::now() - permit.enqueued_at();
+                const uint64_t queue_time = std::chrono::duration_cast<std::chrono::microseconds>(queue_duration).count();
+                tracing::add_stage_time(permit.trace_state(), tracing::latency_stage::queue, queue_duration);
+                if (permit.cost().lane == read_lane::point) {
+                    ++_stats.point_reads_admitted_from_queue;
+                    _stats.point_reads_queue_time_us += queue_time;
+                } else {
+                    ++_stats.scan_reads_admitted_from_queue;
+                    _stats.scan_reads_queue_time_us += queue_time;
+                }
             }
             if (permit.aux_data().func) {
                 permit.unlink();
@@ -1461,9 +1659,10 @@ reader_permit reader_concurrency_semaphore::make_tracking_only_permit(const sche
     return reader_permit(*this, schema, std::move(op_name), {}, timeout, std::move(trace_ptr));
 }
 
-future<> reader_concurrency_semaphore::with_permit(const schema* const schema, const char* const op_name, size_t memory,
+future<> reader_concurrency_semaphore::with_permit(const schema* const schema, const char* const op_name, size_t memory, read_cost cost,
         db::timeout_clock::time_point timeout, tracing::trace_state_ptr trace_ptr, read_func func) {
     auto permit = reader_permit(*this, schema, std::string_view(op_name), {1, static_cast<ssize_t>(memory)}, timeout, std::move(trace_ptr));
+    permit->set_cost(cost);
     permit->aux_data().func = std::move(func);
     permit->aux_data().permit_keepalive = permit;
     return do_wait_admission(*permit);
@@ -1515,6 +1714,7 @@ std::string reader_concurrency_semaphore::dump_diagnostics(unsigned max_lines) c
 
 void reader_concurrency_semaphore::foreach_permit(noncopyable_function<void(const reader_permit::impl&)> func) const {
     boost::for_each(_permit_list, std::ref(func));
+    boost::for_each(_wait_list._point_admission_queue, std::ref(func));
     boost::for_each(_wait_list._admission_queue, std::ref(func));
     boost::for_each(_wait_list._memory_queue, std::ref(func));
     boost::for_each(_ready_list, std::ref(func));
@@ -1600,7 +1800,8 @@ class tracking_file_impl : public file_impl {
 
     virtual future<temporary_buffer<uint8_t>> dma_read_bulk(uint64_t offset, size_t range_size, const io_priority_class& pc) override {
         return _permit.request_memory(range_size).then([this, offset, range_size, &pc] (reader_permit::resource_units units) {
-            return get_file_impl(_tracked_file)->dma_read_bulk(offset, range_size, pc).then([units = std::move(units)] (temporary_buffer<uint8_t> buf) mutable {
+            return get_file_impl(_tracked_file)->dma_read_bulk(offset, range_size, pc).then([this, units = std::move(units)] (temporary_buffer<uint8_t> buf) mutable {
+                _permit.on_sstable_bytes_read(buf.size());
                 return make_ready_future<temporary_buffer<uint8_t>>(make_tracked_temporary_buffer(std::move(buf), std::move(units)));
             });
         });
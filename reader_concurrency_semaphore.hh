@@ -12,6 +12,7 @@
 #include <seastar/core/future.hh>
 #include <seastar/core/gate.hh>
 #include <seastar/core/condition-variable.hh>
+#include <seastar/core/lowres_clock.hh>
 #include "reader_permit.hh"
 #include "utils/updateable_value.hh"
 
@@ -58,6 +59,17 @@ using flat_mutation_reader_v2_opt = optimized_optional<flat_mutation_reader_v2>;
 /// This makes `_kill_limit_multiplier` times the memory limit the effective
 /// upper bound of the memory consumed by reads.
 ///
+/// Reads waiting for admission are queued in one of two lanes, according to
+/// their predicted cost (see \ref read_cost): point reads and scans. Point reads
+/// are admitted before scans, so they don't queue behind a backlog of scans.
+/// In addition, scans are only admitted while the number of sstables read by
+/// all admitted scans stays within the scan cost limit (see
+/// \ref set_scan_cost_limit()), so a few scans spanning many sstables cannot
+/// monopolize the disk. A scan is always admitted if there is no other scan.
+/// So that scans are not starved by a steady stream of point reads, the oldest
+/// waiting scan goes first once \ref max_point_reads_ahead_of_scan point reads
+/// were admitted while it waited, regardless of the scan cost limit.
+///
 /// The semaphore also acts as an execution stage for reads. This
 /// functionality is exposed via \ref with_permit() and \ref
 /// with_ready_permit().
@@ -65,6 +77,9 @@ class reader_concurrency_semaphore {
 public:
     using resources = reader_resources;
 
+    // How many point reads are admitted ahead of a waiting scan, at most, before it goes first.
+    static constexpr uint32_t max_point_reads_ahead_of_scan = 64;
+
     friend class reader_permit;
 
     enum class evict_reason {
@@ -78,6 +93,11 @@ class reader_concurrency_semaphore {
     struct stats {
         // The number of inactive reads evicted to free up permits.
         uint64_t permit_based_evictions = 0;
+        // The number of sstable readers, and the amount of memory, of the
+        // inactive reads evicted to free up permits. These have to be recreated
+        // if the read is resumed.
+        uint64_t permit_based_evictions_sstables = 0;
+        uint64_t permit_based_evictions_memory = 0;
         // The number of inactive reads evicted due to expiring.
         uint64_t time_based_evictions = 0;
         // The number of inactive reads currently registered.
@@ -122,6 +142,16 @@ class reader_concurrency_semaphore {
         uint64_t sstables_read = 0;
         // Permits waiting on something: admission, memory or execution
         uint64_t waiters = 0;
+        // Total number of reads enqueued because admitted scans reached the scan cost limit
+        uint64_t reads_queued_because_scan_cost = 0;
+        // Total number of reads admitted after waiting in the admission queue, per lane.
+        uint64_t point_reads_admitted_from_queue = 0;
+        uint64_t scan_reads_admitted_from_queue = 0;
+        // Total time spent waiting in the admission queue by the reads admitted from it, per lane.
+        uint64_t point_reads_queue_time_us = 0;
+        uint64_t scan_reads_queue_time_us = 0;
+        // The number of sstables read by the currently admitted scans, as predicted on admission.
+        uint64_t scan_cost = 0;
     };
 
     using permit_list_type = bi::list<
@@ -161,16 +191,35 @@ class reader_concurrency_semaphore {
     resources _resources;
 
     struct wait_queue {
-        // Stores entries for permits waiting to be admitted.
+        // Stores entries for scans waiting to be admitted.
         permit_list_type _admission_queue;
+        // Stores entries for point reads waiting to be admitted, these go before scans.
+        permit_list_type _point_admission_queue;
         // Stores entries for serialized permits waiting to obtain memory.
         permit_list_type _memory_queue;
+        // Point reads admitted since the oldest waiting scan was queued or since
+        // the last scan was admitted, whichever happened later.
+        uint32_t _point_reads_ahead_of_scan = 0;
     public:
         bool empty() const {
-            return _admission_queue.empty() && _memory_queue.empty();
+            return _admission_queue.empty() && _point_admission_queue.empty() && _memory_queue.empty();
+        }
+        // Whether the oldest waiting scan goes before point reads.
+        bool scan_is_due() const {
+            return !_admission_queue.empty() && _point_reads_ahead_of_scan >= max_point_reads_ahead_of_scan;
+        }
+        // Whether p is a scan which waited long enough to not be held back by the scan cost limit.
+        bool is_due(const reader_permit::impl& p) const {
+            return scan_is_due() && &p == &_admission_queue.front();
+        }
+        // Whether there are permits which would be admitted before a permit of the given lane.
+        bool has_waiters_ahead_of(read_lane lane) const {
+            return lane == read_lane::scan ? !empty() : !_point_admission_queue.empty() || !_memory_queue.empty() || scan_is_due();
         }
         void push_to_admission_queue(reader_permit::impl& p);
         void push_to_memory_queue(reader_permit::impl& p);
+        // Called for each read admitted, from the queue or not.
+        void on_admitted(read_lane lane) noexcept;
         reader_permit::impl& front();
         const reader_permit::impl& front() const;
     };
@@ -186,9 +235,12 @@ class reader_concurrency_semaphore {
     size_t _max_queue_length = std::numeric_limits<size_t>::max();
     utils::updateable_value<uint32_t> _serialize_limit_multiplier;
     utils::updateable_value<uint32_t> _kill_limit_multiplier;
+    utils::updateable_value<uint32_t> _scan_cost_limit{0};
     stats _stats;
     bool _stopped = false;
     bool _evicting = false;
+    // Moving average of the time inactive reads spend inactive before being resumed.
+    lowres_clock::duration _mean_inactive_time{};
     gate _close_readers_gate;
     gate _permit_gate;
     std::optional<future<>> _execution_loop_future;
@@ -199,6 +251,12 @@ class reader_concurrency_semaphore {
     [[nodiscard]] flat_mutation_reader_v2 detach_inactive_reader(reader_permit::impl&, evict_reason reason) noexcept;
     void evict(reader_permit::impl&, evict_reason reason) noexcept;
 
+    // The value of keeping the inactive read, which is the cost of recreating
+    // its reader, weighted by the likelihood of it being resumed.
+    double inactive_read_value(reader_permit::impl&, lowres_clock::time_point now) const noexcept;
+    // Select the inactive read which is the least valuable to keep.
+    reader_permit::impl& select_inactive_read_to_evict() noexcept;
+
     bool has_available_units(const resources& r) const;
 
     bool all_used_permits_are_stalled() const;
@@ -218,12 +276,14 @@ class reader_concurrency_semaphore {
     // A return value of can_admit::maybe means admission might be possible if
     // some of the inactive readers are evicted.
     enum class can_admit { no, maybe, yes };
-    enum class reason { all_ok = 0, ready_list, used_permits, memory_resources, count_resources };
+    enum class reason { all_ok = 0, ready_list, used_permits, memory_resources, count_resources, scan_cost };
     struct admit_result { can_admit decision; reason why; };
     admit_result can_admit_read(const reader_permit::impl& permit) const noexcept;
 
     bool should_evict_inactive_read() const noexcept;
 
+    bool has_available_scan_cost(const read_cost& cost) const noexcept;
+
     void maybe_admit_waiters() noexcept;
 
     // Request more memory for the permit.
@@ -344,6 +404,9 @@ class reader_concurrency_semaphore {
 
     /// Try to evict an inactive read.
     ///
+    /// Among the oldest inactive reads, the one which is the cheapest to
+    /// recreate, and the least likely to be resumed soon, is evicted.
+    ///
     /// Return true if an inactive read was evicted and false otherwise
     /// (if there was no reader to evict).
     bool try_evict_one_inactive_read(evict_reason = evict_reason::manual);
@@ -427,7 +490,10 @@ class reader_concurrency_semaphore {
     ///
     /// Some permits cannot be associated with any table, so passing nullptr as
     /// the schema parameter is allowed.
-    future<> with_permit(const schema* const schema, const char* const op_name, size_t memory, db::timeout_clock::time_point timeout, tracing::trace_state_ptr trace_ptr, read_func func);
+    ///
+    /// The predicted cost of the read determines its admission lane, see the
+    /// class comment.
+    future<> with_permit(const schema* const schema, const char* const op_name, size_t memory, read_cost cost, db::timeout_clock::time_point timeout, tracing::trace_state_ptr trace_ptr, read_func func);
 
     /// Run the function through the semaphore's execution stage with a pre-admitted permit
     ///
@@ -472,6 +538,12 @@ class reader_concurrency_semaphore {
         _max_queue_length = size;
     }
 
+    /// Limit the number of sstables read by admitted scans, as predicted on
+    /// their admission. 0 means no limit, which is the default.
+    void set_scan_cost_limit(utils::updateable_value<uint32_t> limit) {
+        _scan_cost_limit = std::move(limit);
+    }
+
     uint64_t active_reads() const noexcept {
         return _stats.current_permits - _stats.inactive_reads - _stats.waiters;
     }
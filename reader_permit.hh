@@ -20,6 +20,11 @@ namespace seastar {
     class file;
 } // namespace seastar
 
+namespace sstables {
+    class generation_type;
+    struct resume_hint;
+} // namespace sstables
+
 struct reader_resources {
     int count = 0;
     ssize_t memory = 0;
@@ -66,6 +71,29 @@ std::ostream& operator<<(std::ostream& os, const reader_resources& r);
 
 class reader_concurrency_semaphore;
 
+/// What a read read from sstables since its permit was created.
+struct sstable_read_stats {
+    /// Number of sstable readers created.
+    uint64_t sstables_read = 0;
+    /// Bytes read from sstable files, including those served from the page cache.
+    uint64_t bytes_read = 0;
+    /// Number of partition index pages loaded, either pages of the summary or single entries.
+    uint64_t index_pages_read = 0;
+};
+
+/// The admission lane of a read, see reader_concurrency_semaphore.
+enum class read_lane {
+    point, // Single partition reads of a bounded amount of rows.
+    scan,  // All other reads.
+};
+
+/// Predicted cost of a read, used by the semaphore to admit it.
+struct read_cost {
+    read_lane lane = read_lane::scan;
+    /// Number of sstables the read is predicted to touch, each costing at least one I/O.
+    uint32_t sstables = 0;
+};
+
 /// A permit for a specific read.
 ///
 /// Used to track the read's resource consumption. Use `consume_memory()` to
@@ -158,6 +186,8 @@ class reader_permit {
 
     void release_base_resources() noexcept;
 
+    read_cost cost() const;
+
     sstring description() const;
 
     db::timeout_clock::time_point timeout() const noexcept;
@@ -177,6 +207,16 @@ class reader_permit {
 
     void on_start_sstable_read() noexcept;
     void on_finish_sstable_read() noexcept;
+    void on_sstable_bytes_read(uint64_t bytes) noexcept;
+    void on_index_page_read() noexcept;
+    const sstable_read_stats& get_sstable_read_stats() const noexcept;
+
+    // Where the reader of the given sstable left off, when it was closed in
+    // the middle of a partition. Survives the reader being recreated for the
+    // same read, e.g. by the evictable reader after an eviction.
+    // Passing a null hint drops the existing one.
+    void set_sstable_resume_hint(sstables::generation_type gen, lw_shared_ptr<const sstables::resume_hint> hint);
+    lw_shared_ptr<const sstables::resume_hint> get_sstable_resume_hint(sstables::generation_type gen) const;
 
     uintptr_t id() { return reinterpret_cast<uintptr_t>(_impl.get()); }
 };
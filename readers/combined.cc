@@ -145,6 +145,152 @@ class mutation_fragment_merger {
     }
 };
 
+// A tournament (winner) tree holding the current fragment of each reader
+// taking part in the merge of a partition.
+//
+// Compared to a binary heap, removing the smallest fragment costs a single
+// comparison per level of the tree instead of two, and inserting one stops
+// as soon as it loses a match, which is the common case when the readers'
+// fragments interleave. Position comparisons are the dominant cost of
+// merging many sstables, as they compare clustering keys column by column.
+//
+// The position of each fragment is computed once, on insertion, and kept
+// alongside it. It stays valid while the fragment is moved around, as the
+// fragment's data is allocated separately.
+//
+// Slots are reused after the entry in them is removed, so the tree only
+// grows when more readers than ever before contribute to a single partition.
+template <typename Entry>
+class fragment_tournament_tree {
+    struct leaf {
+        Entry entry;
+        position_in_partition_view position;
+
+        explicit leaf(Entry e)
+            : entry(std::move(e))
+            , position(entry.fragment.position()) {
+        }
+    };
+
+    position_in_partition::less_compare _less;
+    // Always a power of two, so the tree is complete.
+    merger_vector<std::optional<leaf>> _leaves;
+    // _winners[n] is the slot of the smallest entry below node n,
+    // node 1 being the root and nodes n * 2 and n * 2 + 1 the children of n.
+    // Nodes _leaves.size() + i stand for the slots themselves.
+    merger_vector<uint32_t> _winners;
+    merger_vector<uint32_t> _free_slots;
+    size_t _size = 0;
+private:
+    size_t width() const noexcept {
+        return _leaves.size();
+    }
+
+    uint32_t winner(size_t node) const noexcept {
+        return node >= width() ? node - width() : _winners[node];
+    }
+
+    // Empty slots lose against everything.
+    bool beats(uint32_t a, uint32_t b) const {
+        return _leaves[a] && (!_leaves[b] || _less(_leaves[a]->position, _leaves[b]->position));
+    }
+
+    void play(size_t node) {
+        const auto left = winner(node * 2);
+        const auto right = winner(node * 2 + 1);
+        _winners[node] = beats(right, left) ? right : left;
+    }
+
+    void grow() {
+        const auto old_width = width();
+        const auto new_width = std::max<size_t>(1, old_width * 2);
+        _leaves.resize(new_width);
+        _winners.resize(new_width);
+        for (auto slot = new_width; slot > old_width; --slot) {
+            _free_slots.push_back(slot - 1);
+        }
+        for (auto node = new_width - 1; node > 0; --node) {
+            play(node);
+        }
+    }
+public:
+    explicit fragment_tournament_tree(const schema& s)
+        : _less(s) {
+    }
+
+    bool empty() const noexcept {
+        return !_size;
+    }
+
+    size_t size() const noexcept {
+        return _size;
+    }
+
+    // The entry with the smallest position. The tree must not be empty.
+    const Entry& top() const noexcept {
+        return _leaves[winner(1)]->entry;
+    }
+
+    const position_in_partition_view& top_position() const noexcept {
+        return _leaves[winner(1)]->position;
+    }
+
+    void push(Entry e) {
+        if (_free_slots.empty()) {
+            grow();
+        }
+        const auto slot = _free_slots.back();
+        _leaves[slot].emplace(std::move(e));
+        _free_slots.pop_back();
+        ++_size;
+        // The winners of nodes the new entry loses at are unaffected,
+        // and so are all their ancestors.
+        for (auto node = (width() + slot) / 2; node > 0; node /= 2) {
+            const auto current = _winners[node];
+            if (current != slot && !beats(slot, current)) {
+                break;
+            }
+            _winners[node] = slot;
+        }
+    }
+
+    // Removes and returns the entry with the smallest position.
+    // The tree must not be empty.
+    Entry pop() {
+        const auto slot = winner(1);
+        auto e = std::move(_leaves[slot]->entry);
+        _leaves[slot].reset();
+        _free_slots.push_back(slot);
+        --_size;
+        for (auto node = (width() + slot) / 2; node > 0; node /= 2) {
+            play(node);
+        }
+        return e;
+    }
+
+    // Removes all entries, keeping the slots for reuse.
+    void clear() noexcept {
+        if (!_size) {
+            return;
+        }
+        _free_slots.clear();
+        for (auto slot = width(); slot > 0; --slot) {
+            _leaves[slot - 1].reset();
+            _free_slots.push_back(slot - 1);
+        }
+        _size = 0;
+    }
+
+    template <typename Func>
+    void for_each(Func&& func) const {
+        for (auto& l : _leaves) {
+            if (l) {
+                func(l->entry);
+            }
+        }
+    }
+};
+
 // Merges the output of the sub-readers into a single non-decreasing
 // stream of mutation-fragments.
 class mutation_reader_merger {
@@ -178,7 +324,6 @@ class mutation_reader_merger {
     static constexpr int gallop_mode_entering_threshold = 3;
 private:
     struct reader_heap_compare;
-    struct fragment_heap_compare;
 
     struct needs_merge_tag { };
     using needs_merge = bool_class<needs_merge_tag>;
@@ -202,7 +347,7 @@ class mutation_reader_merger {
     merger_vector<reader_and_fragment> _reader_heap;
     // Readers and their current fragments, belonging to the current
     // partition.
-    merger_vector<reader_and_fragment> _fragment_heap;
+    fragment_tournament_tree<reader_and_fragment> _fragment_tree;
     merger_vector<reader_and_last_fragment_kind> _next;
     // Readers that reached EOS.
     merger_vector<reader_and_last_fragment_kind> _halted_readers;
@@ -234,7 +379,7 @@ class mutation_reader_merger {
     future<needs_merge> advance_galloping_reader();
     future<> prepare_next();
     // Collect all forwardable readers into _next, and remove them from
-    // their previous containers (_halted_readers and _fragment_heap).
+    // their previous containers (_halted_readers and _fragment_tree).
     void prepare_forwardable_readers();
 public:
     mutation_reader_merger(schema_ptr schema,
@@ -331,19 +476,6 @@ struct mutation_reader_merger::reader_heap_compare {
     }
 };
 
-struct mutation_reader_merger::fragment_heap_compare {
-    position_in_partition::less_compare cmp;
-
-    explicit fragment_heap_compare(const schema& s)
-        : cmp(s) {
-    }
-
-    bool operator()(const mutation_reader_merger::reader_and_fragment& a, const mutation_reader_merger::reader_and_fragment& b) {
-        // Invert comparison as this is a max-heap.
-        return cmp(b.fragment.position(), a.fragment.position());
-    }
-};
-
 bool mutation_reader_merger::in_gallop_mode() const {
     return _gallop_mode_hits >= gallop_mode_entering_threshold;
 }
@@ -352,7 +484,7 @@ void mutation_reader_merger::maybe_add_readers_at_partition_boundary() {
     // We are either crossing partition boundary or ran out of
     // readers. If there are halted readers then we are just
     // waiting for a fast-forward so there is nothing to do.
-    if (_fragment_heap.empty() && _halted_readers.empty()) {
+    if (_fragment_tree.empty() && _halted_readers.empty()) {
         if (_reader_heap.empty()) {
             maybe_add_readers(std::nullopt);
         } else {
@@ -386,9 +518,9 @@ future<mutation_reader_merger::needs_merge> mutation_reader_merger::prepare_one(
                 boost::push_heap(_reader_heap, reader_heap_compare(*_schema));
             } else {
                 if (reader_galloping) {
-                    // Optimization: assume that galloping reader will keep winning, and compare directly with the heap front.
-                    // If this assumption is correct, we do one key comparison instead of pushing to/popping from the heap.
-                    if (_fragment_heap.empty() || position_in_partition::less_compare(*_schema)(mfo->position(), _fragment_heap.front().fragment.position())) {
+                    // Optimization: assume that galloping reader will keep winning, and compare directly with the tree's top.
+                    // If this assumption is correct, we do one key comparison instead of pushing to/popping from the tree.
+                    if (_fragment_tree.empty() || position_in_partition::less_compare(*_schema)(mfo->position(), _fragment_tree.top_position())) {
                         _current.clear();
                         _current.emplace_back(std::move(*mfo), &*_galloping_reader.reader);
                         _galloping_reader.last_kind = _current.back().fragment.mutation_fragment_kind();
@@ -398,8 +530,7 @@ future<mutation_reader_merger::needs_merge> mutation_reader_merger::prepare_one(
                     _gallop_mode_hits = 0;
                 }
 
-                _fragment_heap.emplace_back(rk.reader, std::move(*mfo));
-                boost::range::push_heap(_fragment_heap, fragment_heap_compare(*_schema));
+                _fragment_tree.push(reader_and_fragment(rk.reader, std::move(*mfo)));
             }
         } else if (_fwd_sm == streamed_mutation::forwarding::yes && rk.last_kind != mutation_fragment_v2::kind::partition_end) {
             // When in streamed_mutation::forwarding mode we need
@@ -439,7 +570,7 @@ future<mutation_reader_merger::needs_merge> mutation_reader_merger::prepare_one(
 }
 
 void mutation_reader_merger::prepare_forwardable_readers() {
-    _next.reserve(_halted_readers.size() + _fragment_heap.size() + _next.size());
+    _next.reserve(_halted_readers.size() + _fragment_tree.size() + _next.size());
 
     std::move(_halted_readers.begin(), _halted_readers.end(), std::back_inserter(_next));
     if (_single_reader.reader != reader_iterator{}) {
@@ -449,12 +580,12 @@ void mutation_reader_merger::prepare_forwardable_readers() {
         _next.emplace_back(_galloping_reader);
         _gallop_mode_hits = 0;
     }
-    for (auto& df : _fragment_heap) {
+    _fragment_tree.for_each([this] (const reader_and_fragment& df) {
         _next.emplace_back(df.reader, df.fragment.mutation_fragment_kind());
-    }
+    });
 
     _halted_readers.clear();
-    _fragment_heap.clear();
+    _fragment_tree.clear();
 }
 
 mutation_reader_merger::mutation_reader_merger(schema_ptr schema,
@@ -462,6 +593,7 @@ mutation_reader_merger::mutation_reader_merger(schema_ptr schema,
         streamed_mutation::forwarding fwd_sm,
         mutation_reader::forwarding fwd_mr)
     : _selector(std::move(selector))
+    , _fragment_tree(*schema)
     , _schema(std::move(schema))
     , _fwd_sm(fwd_sm)
     , _fwd_mr(fwd_mr) {
@@ -507,27 +639,27 @@ future<mutation_fragment_batch> mutation_reader_merger::operator()() {
 
     // If we ran out of fragments for the current partition, select the
     // readers for the next one.
-    if (_fragment_heap.empty()) {
+    if (_fragment_tree.empty()) {
         if (!_halted_readers.empty() || _reader_heap.empty()) {
             return make_ready_future<mutation_fragment_batch>(_current);
         }
 
-        auto key = [] (const merger_vector<reader_and_fragment>& heap) -> const dht::decorated_key& {
-            return heap.front().fragment.as_partition_start().key();
+        auto key = [] (const reader_and_fragment& rf) -> const dht::decorated_key& {
+            return rf.fragment.as_partition_start().key();
         };
 
         do {
             boost::range::pop_heap(_reader_heap, reader_heap_compare(*_schema));
-            // All fragments here are partition_start so no need to
-            // heap-sort them.
-            _fragment_heap.emplace_back(std::move(_reader_heap.back()));
+            // All fragments here are partition_start so they all
+            // tie in the tree.
+            _fragment_tree.push(std::move(_reader_heap.back()));
             _reader_heap.pop_back();
         }
-        while (!_reader_heap.empty() && key(_fragment_heap).equal(*_schema, key(_reader_heap)));
-        if (_fragment_heap.size() == 1) {
-            _single_reader = { _fragment_heap.back().reader, mutation_fragment_v2::kind::partition_start };
-            _current.emplace_back(std::move(_fragment_heap.back().fragment), &*_single_reader.reader);
-            _fragment_heap.clear();
+        while (!_reader_heap.empty() && key(_fragment_tree.top()).equal(*_schema, key(_reader_heap.front())));
+        if (_fragment_tree.size() == 1) {
+            auto n = _fragment_tree.pop();
+            _single_reader = { n.reader, mutation_fragment_v2::kind::partition_start };
+            _current.emplace_back(std::move(n.fragment), &*_single_reader.reader);
             _gallop_mode_hits = 0;
             return make_ready_future<mutation_fragment_batch>(_current);
         }
@@ -535,14 +667,12 @@ future<mutation_fragment_batch> mutation_reader_merger::operator()() {
 
     const auto equal = position_in_partition::equal_compare(*_schema);
     do {
-        boost::range::pop_heap(_fragment_heap, fragment_heap_compare(*_schema));
-        auto& n = _fragment_heap.back();
+        auto n = _fragment_tree.pop();
         const auto kind = n.fragment.mutation_fragment_kind();
         _current.emplace_back(std::move(n.fragment), &*n.reader);
         _next.emplace_back(n.reader, kind);
-        _fragment_heap.pop_back();
     }
-    while (!_fragment_heap.empty() && equal(_current.back().fragment.position(), _fragment_heap.front().fragment.position()));
+    while (!_fragment_tree.empty() && equal(_current.back().fragment.position(), _fragment_tree.top_position()));
 
     if (_next.size() == 1 && _next.front().reader == _galloping_reader.reader) {
         ++_gallop_mode_hits;
@@ -565,7 +695,7 @@ future<> mutation_reader_merger::next_partition() {
     //
     // The readers in _next are those which returned the last batch of fragments, thus they are
     // currently positioned either inside P or at the end of P, hence we need to forward them.
-    // Readers in _fragment_heap (or the _galloping_reader, if we're currently galloping) are obviously still in P,
+    // Readers in _fragment_tree (or the _galloping_reader, if we're currently galloping) are obviously still in P,
     // so we also need to forward those. Finally, _halted_readers must have been halted after returning
     // a fragment from P, hence must be forwarded.
     //
@@ -583,7 +713,7 @@ future<> mutation_reader_merger::fast_forward_to(const dht::partition_range& pr)
     _gallop_mode_hits = 0;
     _next.clear();
     _halted_readers.clear();
-    _fragment_heap.clear();
+    _fragment_tree.clear();
     _reader_heap.clear();
 
     for (auto it = _all_readers.begin(); it != _all_readers.end(); ++it) {
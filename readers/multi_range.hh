@@ -56,3 +56,25 @@ make_flat_multi_range_reader(
         const io_priority_class& pc = default_priority_class(),
         tracing::trace_state_ptr trace_state = nullptr,
         mutation_reader::forwarding fwd_mr = mutation_reader::forwarding::yes);
+
+/// Make a reader for multiple ranges which reads ahead of the range it emits.
+///
+/// A reader is created for each range, and up to \p read_ahead of the readers
+/// following the current one fill their first buffer in the background, so the
+/// index lookups and data reads of consecutive ranges, for instance the
+/// partitions of an IN (...) query, are issued together instead of one after
+/// another. The fragments are still emitted in the order of the ranges.
+///
+/// Unlike the readers above, this reader owns a copy of \p ranges and \p slice.
+/// \param ranges Strictly monotonic partition ranges.
+/// The reader is not forwardable.
+flat_mutation_reader_v2
+make_prefetching_multi_range_reader(
+        schema_ptr s,
+        reader_permit permit,
+        mutation_source source,
+        dht::partition_range_vector ranges,
+        query::partition_slice slice,
+        size_t read_ahead,
+        const io_priority_class& pc = default_priority_class(),
+        tracing::trace_state_ptr trace_state = nullptr);
@@ -280,6 +280,10 @@ class evictable_reader_v2 : public flat_mutation_reader_v2::impl {
     reader_permit permit() {
         return _permit;
     }
+    // Sets the size of the buffers filled by the underlying reader.
+    void set_max_buffer_size(size_t size) {
+        max_buffer_size_in_bytes = size;
+    }
 };
 
 void evictable_reader_v2::do_pause(flat_mutation_reader_v2 reader) {
@@ -595,6 +599,7 @@ future<> evictable_reader_v2::fill_buffer() {
         }
         _reader_recreated = false;
     } else {
+        _reader->set_max_buffer_size(max_buffer_size_in_bytes);
         co_await _reader->fill_buffer();
     }
 
@@ -702,7 +707,17 @@ namespace {
 // Although it implements the flat_mutation_reader_v2:impl interface it cannot be
 // wrapped into a flat_mutation_reader_v2, as it needs to be managed by a shared
 // pointer.
+//
+// The size of the buffers filled on the remote shard adapts to how the
+// multishard reader consumes the shard's fragments: it grows when the
+// multishard reader has to wait for the shard's buffer to be refilled, and
+// shrinks when the multishard reader moves on to another shard, leaving
+// most of the buffer unconsumed. Dense shards are read in larger batches,
+// while shards with little data in the range hold less memory.
 class shard_reader_v2 : public flat_mutation_reader_v2::impl {
+public:
+    static constexpr size_t min_remote_buffer_size = default_max_buffer_size_in_bytes() / 2;
+    static constexpr size_t max_remote_buffer_size = default_max_buffer_size_in_bytes() * 8;
 private:
     shared_ptr<reader_lifecycle_policy_v2> _lifecycle_policy;
     const unsigned _shard;
@@ -713,6 +728,7 @@ class shard_reader_v2 : public flat_mutation_reader_v2::impl {
     const mutation_reader::forwarding _fwd_mr;
     std::optional<future<>> _read_ahead;
     foreign_ptr<std::unique_ptr<evictable_reader_v2>> _reader;
+    size_t _remote_buffer_size = default_max_buffer_size_in_bytes();
 
 private:
     future<> do_fill_buffer();
@@ -759,6 +775,23 @@ class shard_reader_v2 : public flat_mutation_reader_v2::impl {
     bool is_read_ahead_in_progress() const {
         return _read_ahead.has_value();
     }
+    bool is_read_ahead_ready() const {
+        return _read_ahead && _read_ahead->available();
+    }
+    // Whether the remote reader was created, that is, the shard was read from already.
+    bool is_started() const {
+        return bool(_reader);
+    }
+    // Called when the multishard reader has to wait for the buffer to be refilled.
+    void on_underfed() {
+        _remote_buffer_size = std::min(_remote_buffer_size * 2, max_remote_buffer_size);
+    }
+    // Called when the multishard reader moves on to another shard.
+    void on_left() {
+        if (buffer_size() > _remote_buffer_size / 2) {
+            _remote_buffer_size = std::max(_remote_buffer_size / 2, min_remote_buffer_size);
+        }
+    }
 };
 
 future<> shard_reader_v2::close() noexcept {
@@ -809,7 +842,7 @@ future<> shard_reader_v2::do_fill_buffer() {
 
     auto res = co_await std::invoke([&] () -> future<remote_fill_buffer_result_v2> {
         if (!_reader) {
-            reader_and_buffer_fill_result res = co_await smp::submit_to(_shard, coroutine::lambda([this, gs = global_schema_ptr(_schema)] () -> future<reader_and_buffer_fill_result> {
+            reader_and_buffer_fill_result res = co_await smp::submit_to(_shard, coroutine::lambda([this, gs = global_schema_ptr(_schema), buffer_size = _remote_buffer_size] () -> future<reader_and_buffer_fill_result> {
                 auto ms = mutation_source([lifecycle_policy = _lifecycle_policy.get()] (
                             schema_ptr s,
                             reader_permit permit,
@@ -854,6 +887,7 @@ future<> shard_reader_v2::do_fill_buffer() {
                 try {
                     tracing::trace(_trace_state, "Creating shard reader on shard: {}", this_shard_id());
                     reader_permit::used_guard ug{rreader->permit()};
+                    rreader->set_max_buffer_size(buffer_size);
                     co_await rreader->fill_buffer();
                     auto res = remote_fill_buffer_result_v2(rreader->detach_buffer(), rreader->is_end_of_stream());
                     co_return reader_and_buffer_fill_result{std::move(rreader), std::move(res)};
@@ -866,8 +900,9 @@ future<> shard_reader_v2::do_fill_buffer() {
             _reader = std::move(res.reader);
             co_return std::move(res.result);
         } else {
-            co_return co_await smp::submit_to(_shard, coroutine::lambda([this] () -> future<remote_fill_buffer_result_v2>  {
+            co_return co_await smp::submit_to(_shard, coroutine::lambda([this, buffer_size = _remote_buffer_size] () -> future<remote_fill_buffer_result_v2>  {
                 reader_permit::used_guard ug{_reader->permit()};
+                _reader->set_max_buffer_size(buffer_size);
                 co_await _reader->fill_buffer();
                 co_return remote_fill_buffer_result_v2(_reader->detach_buffer(), _reader->is_end_of_stream());
             }));
@@ -1036,6 +1071,7 @@ bool multishard_combining_reader_v2::maybe_move_to_next_shard(const dht::token*
     if (t) {
         _shard_selection_min_heap.push_back(shard_and_token{_current_shard, *t});
         boost::push_heap(_shard_selection_min_heap);
+        _shard_readers[_current_shard]->on_left();
     }
 
     _crossed_shards = true;
@@ -1054,8 +1090,14 @@ future<> multishard_combining_reader_v2::handle_empty_reader_buffer() {
         }
         return make_ready_future<>();
     } else if (reader.is_read_ahead_in_progress()) {
+        if (!reader.is_read_ahead_ready()) {
+            reader.on_underfed();
+        }
         return reader.fill_buffer();
     } else {
+        if (reader.is_started()) {
+            reader.on_underfed();
+        }
         // If we crossed shards and the next reader has an empty buffer we
         // double concurrency so the next time we cross shards we will have
         // more chances of hitting the reader's buffer.
@@ -30,6 +30,7 @@
 #include "readers/upgrading_consumer.hh"
 #include "tombstone_gc.hh"
 #include <seastar/core/coroutine.hh>
+#include <deque>
 #include <stack>
 
 extern logging::logger mrlog;
@@ -720,6 +721,125 @@ make_flat_multi_range_reader(
 }
 
 
+class prefetching_multi_range_mutation_reader : public flat_mutation_reader_v2::impl {
+    struct range_reader {
+        flat_mutation_reader_v2 reader;
+        // The fill_buffer() in progress, if any.
+        std::optional<future<>> fill;
+    };
+
+    mutation_source _source;
+    const dht::partition_range_vector _ranges;
+    const query::partition_slice _slice;
+    const io_priority_class& _pc;
+    tracing::trace_state_ptr _trace_state;
+    size_t _read_ahead;
+    dht::partition_range_vector::const_iterator _next_range;
+    // The reader of the current range, followed by those reading ahead.
+    std::deque<range_reader> _readers;
+
+private:
+    void start_reads() {
+        while (_readers.size() <= _read_ahead && _next_range != _ranges.end()) {
+            auto& r = _readers.emplace_back(range_reader{
+                    _source.make_reader_v2(_schema, _permit, *_next_range++, _slice, _pc, _trace_state,
+                            streamed_mutation::forwarding::no, mutation_reader::forwarding::no),
+                    std::nullopt});
+            r.fill = r.reader.fill_buffer();
+        }
+    }
+
+    future<> wait_for_fill(range_reader& r) {
+        if (!r.fill) {
+            return make_ready_future<>();
+        }
+        auto f = std::move(*r.fill);
+        r.fill.reset();
+        return f;
+    }
+
+public:
+    prefetching_multi_range_mutation_reader(
+            schema_ptr s,
+            reader_permit permit,
+            mutation_source source,
+            dht::partition_range_vector ranges,
+            query::partition_slice slice,
+            size_t read_ahead,
+            const io_priority_class& pc,
+            tracing::trace_state_ptr trace_state)
+        : impl(std::move(s), std::move(permit))
+        , _source(std::move(source))
+        , _ranges(std::move(ranges))
+        , _slice(std::move(slice))
+        , _pc(pc)
+        , _trace_state(std::move(trace_state))
+        , _read_ahead(read_ahead)
+        , _next_range(_ranges.begin())
+    {
+    }
+
+    virtual future<> fill_buffer() override {
+        while (!is_buffer_full() && !is_end_of_stream()) {
+            start_reads();
+            if (_readers.empty()) {
+                _end_of_stream = true;
+                break;
+            }
+            auto& current = _readers.front();
+            co_await wait_for_fill(current);
+            if (!current.reader.is_buffer_empty()) {
+                current.reader.move_buffer_content_to(*this);
+            } else if (current.reader.is_end_of_stream()) {
+                co_await current.reader.close();
+                _readers.pop_front();
+            } else {
+                current.fill = current.reader.fill_buffer();
+            }
+        }
+    }
+
+    virtual future<> fast_forward_to(const dht::partition_range& pr) override {
+        return make_exception_future<>(make_backtraced_exception_ptr<std::bad_function_call>());
+    }
+
+    virtual future<> fast_forward_to(position_range pr) override {
+        return make_exception_future<>(make_backtraced_exception_ptr<std::bad_function_call>());
+    }
+
+    virtual future<> next_partition() override {
+        clear_buffer_to_next_partition();
+        if (is_buffer_empty() && !_readers.empty()) {
+            auto& current = _readers.front();
+            co_await wait_for_fill(current);
+            co_await current.reader.next_partition();
+        }
+    }
+
+    virtual future<> close() noexcept override {
+        for (auto& r : _readers) {
+            // The reads ahead may fail after the reader stopped being read.
+            co_await wait_for_fill(r).handle_exception([] (std::exception_ptr) { });
+            co_await r.reader.close();
+        }
+    }
+};
+
+flat_mutation_reader_v2
+make_prefetching_multi_range_reader(
+        schema_ptr s,
+        reader_permit permit,
+        mutation_source source,
+        dht::partition_range_vector ranges,
+        query::partition_slice slice,
+        size_t read_ahead,
+        const io_priority_class& pc,
+        tracing::trace_state_ptr trace_state) {
+    return make_flat_mutation_reader_v2<prefetching_multi_range_mutation_reader>(std::move(s), std::move(permit), std::move(source),
+            std::move(ranges), std::move(slice), read_ahead, pc, std::move(trace_state));
+}
+
+
 /*
  * This reader takes a get_next_fragment generator that produces mutation_fragment_opt which is returned by
  * generating_reader.
@@ -35,6 +35,11 @@ future<redis_message> command_factory::create_execute(service::storage_proxy& pr
         { "hgetall", commands::hgetall },
         { "hdel", commands::hdel },
         { "hexists", commands::hexists },
+        { "zadd", commands::zadd },
+        { "zscore", commands::zscore },
+        { "zcard", commands::zcard },
+        { "zrem", commands::zrem },
+        { "zrangebyscore", commands::zrangebyscore },
     };
     auto&& command = _commands.find(req._command);
     if (command != _commands.end()) {
@@ -45,4 +50,48 @@ future<redis_message> command_factory::create_execute(service::storage_proxy& pr
     return commands::unknown(proxy, req, options, permit);
 }
 
+std::optional<std::vector<bytes>> command_factory::keys_of(const request& req)
+{
+    enum class keys { none, first, all };
+    static thread_local const std::unordered_map<bytes, keys> _keys =
+    {
+        { "ping", keys::none },
+        { "echo", keys::none },
+        { "lolwut", keys::none },
+        { "get", keys::first },
+        { "exists", keys::all },
+        { "ttl", keys::first },
+        { "strlen", keys::first },
+        { "set", keys::first },
+        { "setex", keys::first },
+        { "del", keys::all },
+        { "hget", keys::first },
+        { "hset", keys::first },
+        { "hgetall", keys::first },
+        { "hdel", keys::first },
+        { "hexists", keys::first },
+        { "zadd", keys::first },
+        { "zscore", keys::first },
+        { "zcard", keys::first },
+        { "zrem", keys::first },
+        { "zrangebyscore", keys::first },
+    };
+    auto it = _keys.find(req._command);
+    if (it == _keys.end()) {
+        return std::nullopt;
+    }
+    switch (it->second) {
+    case keys::none:
+        return std::vector<bytes>();
+    case keys::first:
+        if (req._args.empty()) {
+            return std::vector<bytes>();
+        }
+        return std::vector<bytes>{req._args[0]};
+    case keys::all:
+        return req._args;
+    }
+    return std::nullopt;
+}
+
 }
@@ -8,6 +8,9 @@
 
 #pragma once
 
+#include <optional>
+#include <vector>
+
 #include "redis/abstract_command.hh"
 #include "redis/options.hh"
 
@@ -22,5 +25,9 @@ class command_factory {
     command_factory() {}
     ~command_factory() {}
     static seastar::future<redis_message> create_execute(service::storage_proxy&, request&, redis::redis_options&, service_permit);
+    // The keys which the command reads or writes, or nullopt for commands
+    // which must not run along with any other, like those changing the
+    // options of the connection.
+    static std::optional<std::vector<bytes>> keys_of(const request&);
 };
 }
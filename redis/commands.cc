@@ -7,6 +7,12 @@
  */
 
 #include "redis/commands.hh"
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <set>
 #include <seastar/core/shared_ptr.hh>
 #include "redis/request.hh"
 #include "redis/reply.hh"
@@ -110,11 +116,28 @@ future<redis_message> hget(service::storage_proxy& proxy, request& req, redis::r
 }
 
 future<redis_message> hset(service::storage_proxy& proxy, request& req, redis::redis_options& options, service_permit permit) {
-    if (req.arguments_size() != 3) {
+    if (req.arguments_size() < 3 || req.arguments_size() % 2 != 1) {
         throw wrong_number_of_arguments_exception(req._command);
     }
-    return redis::write_hashes(proxy, options, std::move(req._args[0]), std::move(req._args[1]), std::move(req._args[2]), 0, permit).then([] {
-        return redis_message::one();
+    std::vector<bytes> names;
+    std::vector<std::pair<bytes, bytes>> fields;
+    for (size_t i = 1; i < req.arguments_size(); i += 2) {
+        names.push_back(req._args[i]);
+        fields.emplace_back(std::move(req._args[i]), std::move(req._args[i + 1]));
+    }
+    // HSET replies with the number of fields which didn't exist before, so
+    // the fields being set are read first.
+    return redis::read_hashes(proxy, options, req._args[0], names, permit).then(
+            [&proxy, &options, key = std::move(req._args[0]), names = std::move(names), fields = std::move(fields), permit] (auto existing) mutable {
+        std::set<bytes> added;
+        for (auto& name : names) {
+            if (!existing->contains(name)) {
+                added.insert(std::move(name));
+            }
+        }
+        return redis::write_hashes(proxy, options, std::move(key), std::move(fields), 0, std::move(permit)).then([added = added.size()] {
+            return redis_message::number(added);
+        });
     });
 }
 
@@ -139,6 +162,169 @@ future<redis_message> hexists(service::storage_proxy& proxy, request& req, redis
     });
 }
 
+static sstring bytes_to_sstring(const bytes& b) {
+    return sstring(reinterpret_cast<const char*>(b.data()), b.size());
+}
+
+static double parse_score(const bytes& b) {
+    auto s = bytes_to_sstring(b);
+    char* end = nullptr;
+    errno = 0;
+    double score = std::strtod(s.c_str(), &end);
+    if (s.empty() || end != s.c_str() + s.size() || errno == ERANGE || std::isnan(score)) {
+        throw redis_exception("value is not a valid float");
+    }
+    return score;
+}
+
+static int64_t parse_integer(const bytes& b) {
+    auto s = bytes_to_sstring(b);
+    int64_t n = 0;
+    auto [ptr, ec] = std::from_chars(s.data(), s.data() + s.size(), n);
+    if (s.empty() || ec != std::errc() || ptr != s.data() + s.size()) {
+        throw redis_exception("value is not an integer or out of range");
+    }
+    return n;
+}
+
+// Parses a bound of ZRANGEBYSCORE, exclusive if prefixed with '('.
+static score_bound parse_score_bound(const bytes& b) {
+    bool inclusive = b.empty() || b[0] != '(';
+    try {
+        return score_bound{parse_score(inclusive ? b : b.substr(1)), inclusive};
+    } catch (redis_exception&) {
+        throw redis_exception("min or max is not a float");
+    }
+}
+
+// Infinite bounds are left to the range read as unbounded, since they
+// cover all scores.
+static std::optional<score_bound> finite(const score_bound& b) {
+    if (std::isinf(b.score)) {
+        return std::nullopt;
+    }
+    return b;
+}
+
+static bytes format_score(double score) {
+    auto s = fmt::format("{}", score);
+    return bytes(reinterpret_cast<const int8_t*>(s.data()), s.size());
+}
+
+static bool iequals(const bytes& b, std::string_view s) {
+    return b.size() == s.size() && std::equal(b.begin(), b.end(), s.begin(), [] (int8_t x, char y) {
+        return ::tolower(x) == y;
+    });
+}
+
+future<redis_message> zadd(service::storage_proxy& proxy, request& req, redis::redis_options& options, service_permit permit) {
+    if (req.arguments_size() < 3 || req.arguments_size() % 2 != 1) {
+        throw wrong_number_of_arguments_exception(req._command);
+    }
+    // Later scores of a member given more than once win, as in redis.
+    std::map<bytes, double> scores;
+    for (size_t i = 1; i < req.arguments_size(); i += 2) {
+        scores.insert_or_assign(std::move(req._args[i + 1]), parse_score(req._args[i]));
+    }
+    std::vector<bytes> members;
+    for (const auto& [member, score] : scores) {
+        members.push_back(member);
+    }
+    return redis::read_zset_scores(proxy, options, req._args[0], members, permit).then([&proxy, &req, &options, permit, scores = std::move(scores)] (auto old_scores) mutable {
+        auto added = scores.size() - old_scores->size();
+        std::vector<std::pair<bytes, double>> members(scores.begin(), scores.end());
+        return redis::write_zset(proxy, options, std::move(req._args[0]), std::move(members), *old_scores, permit).then([added, old_scores] {
+            return redis_message::number(added);
+        });
+    });
+}
+
+future<redis_message> zscore(service::storage_proxy& proxy, request& req, redis::redis_options& options, service_permit permit) {
+    if (req.arguments_size() != 2) {
+        throw wrong_arguments_exception(2, req.arguments_size(), req._command);
+    }
+    auto member = req._args[1];
+    return redis::read_zset_scores(proxy, options, req._args[0], {member}, permit).then([member] (auto result) {
+        auto it = result->find(member);
+        if (it != result->end()) {
+            return redis_message::make_strings_result(format_score(it->second));
+        }
+        return redis_message::nil();
+    });
+}
+
+future<redis_message> zcard(service::storage_proxy& proxy, request& req, redis::redis_options& options, service_permit permit) {
+    if (req.arguments_size() != 1) {
+        throw wrong_arguments_exception(1, req.arguments_size(), req._command);
+    }
+    return redis::read_zset_scores(proxy, options, req._args[0], {}, permit).then([] (auto result) {
+        return redis_message::number(result->size());
+    });
+}
+
+future<redis_message> zrem(service::storage_proxy& proxy, request& req, redis::redis_options& options, service_permit permit) {
+    if (req.arguments_size() < 2) {
+        throw wrong_number_of_arguments_exception(req._command);
+    }
+    // The scores of the members are read to find their rows in the table
+    // ordered by score.
+    auto members = std::vector<bytes>(req._args.begin() + 1, req._args.end());
+    return redis::read_zset_scores(proxy, options, req._args[0], members, permit).then([&proxy, &req, &options, permit] (auto scores) {
+        if (scores->empty()) {
+            return redis_message::zero();
+        }
+        return redis::delete_zset_members(proxy, options, std::move(req._args[0]), *scores, permit).then([scores] {
+            return redis_message::number(scores->size());
+        });
+    });
+}
+
+future<redis_message> zrangebyscore(service::storage_proxy& proxy, request& req, redis::redis_options& options, service_permit permit) {
+    if (req.arguments_size() < 3) {
+        throw wrong_number_of_arguments_exception(req._command);
+    }
+    auto min = parse_score_bound(req._args[1]);
+    auto max = parse_score_bound(req._args[2]);
+    bool with_scores = false;
+    uint64_t offset = 0;
+    std::optional<uint64_t> count;
+    for (size_t i = 3; i < req.arguments_size(); ++i) {
+        if (iequals(req._args[i], "withscores")) {
+            with_scores = true;
+        } else if (iequals(req._args[i], "limit") && i + 2 < req.arguments_size()) {
+            auto o = parse_integer(req._args[i + 1]);
+            auto c = parse_integer(req._args[i + 2]);
+            if (o < 0 || c == 0) {
+                count = 0;
+            } else {
+                offset = o;
+                // A negative count returns all the members from offset.
+                count = c < 0 ? std::nullopt : std::optional<uint64_t>(c);
+            }
+            i += 2;
+        } else {
+            throw syntax_error_exception();
+        }
+    }
+    bool empty_range = min.score > max.score || (min.score == max.score && !(min.inclusive && max.inclusive))
+            || min.score == std::numeric_limits<double>::infinity() || max.score == -std::numeric_limits<double>::infinity();
+    if (empty_range || count == 0) {
+        std::vector<bytes> empty;
+        return redis_message::make_array_result(empty);
+    }
+    return redis::read_zset_range(proxy, options, req._args[0], finite(min), finite(max), offset, count, permit).then([with_scores] (auto result) {
+        std::vector<bytes> reply;
+        reply.reserve(result->size() * (with_scores ? 2 : 1));
+        for (auto& [member, score] : *result) {
+            reply.push_back(std::move(member));
+            if (with_scores) {
+                reply.push_back(format_score(score));
+            }
+        }
+        return redis_message::make_array_result(reply);
+    });
+}
+
 future<redis_message> set(service::storage_proxy& proxy, request& req, redis::redis_options& options, service_permit permit) {
     if (req.arguments_size() != 2 && req.arguments_size() != 4) {
         throw invalid_arguments_exception(req._command);
@@ -25,6 +25,11 @@ future<redis_message> hget(service::storage_proxy& proxy, request& req, redis::r
 future<redis_message> hset(service::storage_proxy& proxy, request& req, redis::redis_options& options, service_permit permit);
 future<redis_message> hdel(service::storage_proxy& proxy, request& req, redis::redis_options& options, service_permit permit);
 future<redis_message> hexists(service::storage_proxy& proxy, request& req, redis::redis_options& options, service_permit permit);
+future<redis_message> zadd(service::storage_proxy& proxy, request& req, redis::redis_options& options, service_permit permit);
+future<redis_message> zscore(service::storage_proxy& proxy, request& req, redis::redis_options& options, service_permit permit);
+future<redis_message> zcard(service::storage_proxy& proxy, request& req, redis::redis_options& options, service_permit permit);
+future<redis_message> zrem(service::storage_proxy& proxy, request& req, redis::redis_options& options, service_permit permit);
+future<redis_message> zrangebyscore(service::storage_proxy& proxy, request& req, redis::redis_options& options, service_permit permit);
 future<redis_message> set(service::storage_proxy& proxy, request& req, redis::redis_options& options, service_permit permit);
 future<redis_message> setex(service::storage_proxy& proxy, request& req, redis::redis_options& options, service_permit permit);
 future<redis_message> del(service::storage_proxy& proxy, request& req, redis::redis_options& options, service_permit permit);
@@ -44,6 +44,11 @@ class invalid_arguments_exception : public redis_exception {
     invalid_arguments_exception(const bytes& command) : redis_exception(fmt::format("invalid argument for '{}' command", sstring(reinterpret_cast<const char*>(command.data()), command.size()))) {}
 };
 
+class syntax_error_exception : public redis_exception {
+public:
+    syntax_error_exception() : redis_exception("syntax error") {}
+};
+
 class invalid_db_index_exception : public redis_exception {
 public:
     invalid_db_index_exception() : redis_exception("DB index is out of range") {}
@@ -140,6 +140,50 @@ schema_ptr zsets_schema(sstring ks_name) {
     return builder.build(schema_builder::compact_storage::yes);
 }
 
+schema_ptr zset_members_schema(sstring ks_name) {
+     schema_builder builder(generate_legacy_id(ks_name, redis::ZSET_MEMBERs), ks_name, redis::ZSET_MEMBERs,
+     // partition key
+     {{"pkey", utf8_type}},
+     // clustering key
+     {{"ckey", utf8_type}},
+     // regular columns
+     {{"data", double_type}},
+     // static columns
+     {},
+     // regular column name type
+     utf8_type,
+     // comment
+     "save the scores of the members of ZSETs for redis"
+    );
+    builder.set_gc_grace_seconds(0);
+    builder.with(schema_builder::compact_storage::yes);
+    builder.with_version(db::system_keyspace::generate_schema_version(builder.uuid()));
+    return builder.build(schema_builder::compact_storage::yes);
+}
+
+// The ZSETs table above can't tell apart members with the same score, so
+// the members ordered by score are kept here, under both.
+schema_ptr zset_scores_schema(sstring ks_name) {
+     schema_builder builder(generate_legacy_id(ks_name, redis::ZSET_SCOREs), ks_name, redis::ZSET_SCOREs,
+     // partition key
+     {{"pkey", utf8_type}},
+     // clustering key
+     {{"score", double_type}, {"ckey", utf8_type}},
+     // regular columns
+     {},
+     // static columns
+     {},
+     // regular column name type
+     utf8_type,
+     // comment
+     "save the members of ZSETs ordered by score for redis"
+    );
+    builder.set_gc_grace_seconds(0);
+    builder.with(schema_builder::compact_storage::yes);
+    builder.with_version(db::system_keyspace::generate_schema_version(builder.uuid()));
+    return builder.build(schema_builder::compact_storage::yes);
+}
+
 future<> create_keyspace_if_not_exists_impl(seastar::sharded<service::storage_proxy>& proxy, data_dictionary::database db, seastar::sharded<service::migration_manager>& mm, db::config& config, int default_replication_factor) {
     assert(this_shard_id() == 0);
     auto keyspace_replication_strategy_options = config.redis_keyspace_replication_strategy_options();
@@ -157,7 +201,9 @@ future<> create_keyspace_if_not_exists_impl(seastar::sharded<service::storage_pr
                              table{redis::LISTs, lists_schema},
                              table{redis::SETs, sets_schema},
                              table{redis::HASHes, hashes_schema},
-                             table{redis::ZSETs, zsets_schema}};
+                             table{redis::ZSETs, zsets_schema},
+                             table{redis::ZSET_MEMBERs, zset_members_schema},
+                             table{redis::ZSET_SCOREs, zset_scores_schema}};
 
     auto ks_names = boost::copy_range<std::vector<sstring>>(
             boost::irange<unsigned>(0, config.redis_database_count()) |
@@ -190,7 +236,7 @@ future<> create_keyspace_if_not_exists_impl(seastar::sharded<service::storage_pr
             }
 
             cql3::statements::ks_prop_defs attrs;
-            attrs.add_property(cql3::statements::ks_prop_defs::KW_DURABLE_WRITES, "true");
+            attrs.add_property(cql3::statements::ks_prop_defs::KW_DURABLE_WRITES, config.redis_in_memory_tables() ? "false" : "true");
             std::map<sstring, sstring> replication_properties;
             for (auto&& option : keyspace_replication_strategy_options) {
                 replication_properties.emplace(option.first, option.second);
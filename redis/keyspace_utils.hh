@@ -35,6 +35,10 @@ static constexpr auto LISTs           = "LISTs";
 static constexpr auto HASHes          = "HASHes";
 static constexpr auto SETs            = "SETs";
 static constexpr auto ZSETs           = "ZSETs";
+// Sorted sets are kept in two tables: the score of each member, and the
+// members ordered by score, for reading ranges of scores.
+static constexpr auto ZSET_MEMBERs    = "ZSET_MEMBERs";
+static constexpr auto ZSET_SCOREs     = "ZSET_SCOREs";
 
 seastar::future<> maybe_create_keyspace(seastar::sharded<service::storage_proxy>& proxy, data_dictionary::database db, seastar::sharded<service::migration_manager>& mm, db::config& cfg, seastar::sharded<gms::gossiper>& g);
 
@@ -13,6 +13,7 @@
 #include <seastar/core/print.hh>
 #include "redis/keyspace_utils.hh"
 #include "redis/options.hh"
+#include "redis/write_batch.hh"
 #include "mutation/mutation.hh"
 #include "service_permit.hh"
 
@@ -38,6 +39,15 @@ atomic_cell make_cell(const schema_ptr schema,
 }  
 
 
+// Writes the mutations of a command, along with those of the other commands
+// of its connection's write batch, if it has one.
+static future<> mutate(service::storage_proxy& proxy, redis::redis_options& options, std::vector<mutation> mutations, db::timeout_clock::time_point timeout, service_permit permit) {
+    if (auto batch = options.get_write_batch()) {
+        return batch->add(std::move(mutations), timeout, std::move(permit));
+    }
+    return proxy.mutate(std::move(mutations), options.get_write_consistency_level(), timeout, nullptr, std::move(permit), db::allow_per_partition_rate_limit::yes);
+}
+
 future<> write_hashes(service::storage_proxy& proxy, redis::redis_options& options, bytes&& key, bytes&& field, bytes&& data, long ttl, service_permit permit) {
     db::timeout_clock::time_point timeout = db::timeout_clock::now() + options.get_write_timeout();
 
@@ -49,8 +59,22 @@ future<> write_hashes(service::storage_proxy& proxy, redis::redis_options& optio
     auto cell = make_cell(schema, *(column.type.get()), data, ttl);
     m.set_clustered_cell(ckey, column, std::move(cell));
 
-    auto write_consistency_level = options.get_write_consistency_level();
-    return proxy.mutate(std::vector<mutation> {std::move(m)}, write_consistency_level, timeout, nullptr, permit, db::allow_per_partition_rate_limit::yes);
+    return mutate(proxy, options, std::vector<mutation> {std::move(m)}, timeout, permit);
+}
+
+future<> write_hashes(service::storage_proxy& proxy, redis::redis_options& options, bytes&& key, std::vector<std::pair<bytes, bytes>>&& fields, long ttl, service_permit permit) {
+    db::timeout_clock::time_point timeout = db::timeout_clock::now() + options.get_write_timeout();
+
+    auto schema = get_schema(proxy, options.get_keyspace_name(), redis::HASHes);
+    const column_definition& column = *schema->get_column_definition(redis::DATA_COLUMN_NAME);
+    auto pkey = partition_key::from_single_value(*schema, key);
+    auto m = mutation(schema, std::move(pkey));
+    for (auto& [field, data] : fields) {
+        auto ckey = clustering_key::from_single_value(*schema, field);
+        m.set_clustered_cell(ckey, column, make_cell(schema, *(column.type.get()), data, ttl));
+    }
+
+    return mutate(proxy, options, std::vector<mutation> {std::move(m)}, timeout, permit);
 }
 
 
@@ -67,8 +91,7 @@ mutation make_mutation(service::storage_proxy& proxy, const redis_options& optio
 future<> write_strings(service::storage_proxy& proxy, redis::redis_options& options, bytes&& key, bytes&& data, long ttl, service_permit permit) {
     db::timeout_clock::time_point timeout = db::timeout_clock::now() + options.get_write_timeout();
     auto m = make_mutation(proxy, options, std::move(key), std::move(data), ttl);
-    auto write_consistency_level = options.get_write_consistency_level();
-    return proxy.mutate(std::vector<mutation> {std::move(m)}, write_consistency_level, timeout, nullptr, permit, db::allow_per_partition_rate_limit::yes);
+    return mutate(proxy, options, std::vector<mutation> {std::move(m)}, timeout, permit);
 }
 
 
@@ -82,20 +105,21 @@ mutation make_tombstone(service::storage_proxy& proxy, const redis_options& opti
 
 future<> delete_objects(service::storage_proxy& proxy, redis::redis_options& options, std::vector<bytes>&& keys, service_permit permit) {
     db::timeout_clock::time_point timeout = db::timeout_clock::now() + options.get_write_timeout();
-    auto write_consistency_level = options.get_write_consistency_level();
-    std::vector<sstring> tables { redis::STRINGs, redis::LISTs, redis::HASHes, redis::SETs, redis::ZSETs }; 
-    auto remove = [&proxy, timeout, write_consistency_level, permit, &options, keys = std::move(keys)] (const sstring& cf_name) {
-        return parallel_for_each(keys.begin(), keys.end(), [&proxy, timeout, write_consistency_level, &options, permit, cf_name] (const bytes& key) {
-            auto m = make_tombstone(proxy, options, cf_name, key);
-            return proxy.mutate(std::vector<mutation> {std::move(m)}, write_consistency_level, timeout, nullptr, permit, db::allow_per_partition_rate_limit::yes);
-        });
-    };  
-    return parallel_for_each(tables.begin(), tables.end(), remove);
+    std::vector<sstring> tables { redis::STRINGs, redis::LISTs, redis::HASHes, redis::SETs, redis::ZSETs, redis::ZSET_MEMBERs, redis::ZSET_SCOREs };
+    // The tombstones of all keys in all tables are written by one mutate(),
+    // which writes them in parallel.
+    std::vector<mutation> mutations;
+    mutations.reserve(tables.size() * keys.size());
+    for (const auto& cf_name : tables) {
+        for (const auto& key : keys) {
+            mutations.push_back(make_tombstone(proxy, options, cf_name, key));
+        }
+    }
+    return mutate(proxy, options, std::move(mutations), timeout, permit);
 }
 
 future<> delete_fields(service::storage_proxy& proxy, redis::redis_options& options, bytes&& key, std::vector<bytes>&& fields, service_permit permit) {
     db::timeout_clock::time_point timeout = db::timeout_clock::now() + options.get_write_timeout();
-    auto write_consistency_level = options.get_write_consistency_level();
     auto schema = get_schema(proxy, options.get_keyspace_name(), redis::HASHes);
     auto pkey = partition_key::from_single_value(*schema, key);
     auto ts = api::new_timestamp();
@@ -107,7 +131,53 @@ future<> delete_fields(service::storage_proxy& proxy, redis::redis_options& opti
         m.partition().apply_delete(*schema, ckey, tombstone { ts, clk });
         mutations.push_back(m);
     }
-    return proxy.mutate(mutations, write_consistency_level, timeout, nullptr, permit, db::allow_per_partition_rate_limit::yes);
+    return mutate(proxy, options, std::move(mutations), timeout, permit);
+}
+
+static clustering_key make_score_key(const schema& schema, const bytes& member, double score) {
+    return clustering_key::from_exploded(schema, {double_type->decompose(score), member});
+}
+
+future<> write_zset(service::storage_proxy& proxy, redis::redis_options& options, bytes&& key, std::vector<std::pair<bytes, double>>&& members, const std::map<bytes, double>& old_scores, service_permit permit) {
+    db::timeout_clock::time_point timeout = db::timeout_clock::now() + options.get_write_timeout();
+    auto members_schema = get_schema(proxy, options.get_keyspace_name(), redis::ZSET_MEMBERs);
+    auto scores_schema = get_schema(proxy, options.get_keyspace_name(), redis::ZSET_SCOREs);
+    const column_definition& score_column = *members_schema->get_column_definition(redis::DATA_COLUMN_NAME);
+    // Rows of the scores table only have the empty value column of dense
+    // tables, which makes them live.
+    const column_definition& value_column = *scores_schema->regular_columns().begin();
+    auto members_m = mutation(members_schema, partition_key::from_single_value(*members_schema, key));
+    auto scores_m = mutation(scores_schema, partition_key::from_single_value(*scores_schema, key));
+    // The tombstone of an old score row would also delete a new row with
+    // the same score, so it is only written for scores which changed.
+    auto ts = api::new_timestamp();
+    auto clk = gc_clock::now();
+    for (const auto& [member, score] : members) {
+        auto it = old_scores.find(member);
+        if (it != old_scores.end() && it->second != score) {
+            scores_m.partition().apply_delete(*scores_schema, make_score_key(*scores_schema, member, it->second), tombstone { ts, clk });
+        }
+    }
+    for (const auto& [member, score] : members) {
+        members_m.set_clustered_cell(clustering_key::from_single_value(*members_schema, member), score_column, make_cell(members_schema, *score_column.type, double_type->decompose(score)));
+        scores_m.set_clustered_cell(make_score_key(*scores_schema, member, score), value_column, make_cell(scores_schema, *value_column.type, bytes_view()));
+    }
+    return mutate(proxy, options, std::vector<mutation> {std::move(members_m), std::move(scores_m)}, timeout, permit);
+}
+
+future<> delete_zset_members(service::storage_proxy& proxy, redis::redis_options& options, bytes&& key, const std::map<bytes, double>& members, service_permit permit) {
+    db::timeout_clock::time_point timeout = db::timeout_clock::now() + options.get_write_timeout();
+    auto members_schema = get_schema(proxy, options.get_keyspace_name(), redis::ZSET_MEMBERs);
+    auto scores_schema = get_schema(proxy, options.get_keyspace_name(), redis::ZSET_SCOREs);
+    auto members_m = mutation(members_schema, partition_key::from_single_value(*members_schema, key));
+    auto scores_m = mutation(scores_schema, partition_key::from_single_value(*scores_schema, key));
+    auto ts = api::new_timestamp();
+    auto clk = gc_clock::now();
+    for (const auto& [member, score] : members) {
+        members_m.partition().apply_delete(*members_schema, clustering_key::from_single_value(*members_schema, member), tombstone { ts, clk });
+        scores_m.partition().apply_delete(*scores_schema, make_score_key(*scores_schema, member, score), tombstone { ts, clk });
+    }
+    return mutate(proxy, options, std::vector<mutation> {std::move(members_m), std::move(scores_m)}, timeout, permit);
 }
 
 }
@@ -7,6 +7,7 @@
  */
 
 #pragma once
+#include <map>
 #include "types/types.hh"
 
 class service_permit;
@@ -21,8 +22,13 @@ namespace redis {
 class redis_options;
 
 future<> write_hashes(service::storage_proxy& proxy, redis::redis_options& options, bytes&& key, bytes&& field, bytes&& data, long ttl, service_permit permit);
+future<> write_hashes(service::storage_proxy& proxy, redis::redis_options& options, bytes&& key, std::vector<std::pair<bytes, bytes>>&& fields, long ttl, service_permit permit);
 future<> write_strings(service::storage_proxy& proxy, redis::redis_options& options, bytes&& key, bytes&& data, long ttl, service_permit permit);
 future<> delete_objects(service::storage_proxy& proxy, redis::redis_options& options, std::vector<bytes>&& keys, service_permit permit);
 future<> delete_fields(service::storage_proxy& proxy, redis::redis_options& options, bytes&& key, std::vector<bytes>&& fields, service_permit permit);
+// Sets the scores of members of the sorted set, which had old_scores before.
+future<> write_zset(service::storage_proxy& proxy, redis::redis_options& options, bytes&& key, std::vector<std::pair<bytes, double>>&& members, const std::map<bytes, double>& old_scores, service_permit permit);
+// Removes the members of the sorted set, along with their scores.
+future<> delete_zset_members(service::storage_proxy& proxy, redis::redis_options& options, bytes&& key, const std::map<bytes, double>& members, service_permit permit);
 
 }
@@ -23,6 +23,8 @@ class storage_proxy;
 
 namespace redis {
 
+class write_batch;
+
 class redis_options {
     sstring _ks_name;
     const db::consistency_level _read_consistency;
@@ -30,6 +32,7 @@ class redis_options {
     const updateable_timeout_config& _timeout_config;
     service::client_state _client_state;
     size_t _total_redis_db_count;
+    write_batch* _write_batch = nullptr;
 public:
     explicit redis_options(const db::consistency_level rcl,
         const db::consistency_level wcl,
@@ -71,6 +74,9 @@ class redis_options {
 
     void set_keyspace_name(const sstring ks_name) { _ks_name = ks_name; }
     size_t get_total_redis_db_count() const { return _total_redis_db_count; }
+    // The batch of the connection which the writes of commands join, if any.
+    write_batch* get_write_batch() const { return _write_batch; }
+    void set_write_batch(write_batch* batch) { _write_batch = batch; }
 };
 
 schema_ptr get_schema(service::storage_proxy& proxy, const sstring& ks_name, const sstring& cf_name);
@@ -8,6 +8,7 @@
 
 
 #include "redis/query_utils.hh"
+#include <algorithm>
 #include "db/per_partition_rate_limit_info.hh"
 #include "redis/options.hh"
 #include "timeout_config.hh"
@@ -19,6 +20,7 @@
 #include "gc_clock.hh"
 #include "service_permit.hh"
 #include "redis/keyspace_utils.hh"
+#include "types/types.hh"
 
 namespace redis {
 
@@ -144,6 +146,27 @@ future<lw_shared_ptr<std::map<bytes, bytes>>> read_hashes(service::storage_proxy
         .build();
     return query_hashes(proxy, options, key, permit, schema, ps);
 }
+future<lw_shared_ptr<std::map<bytes, bytes>>> read_hashes(service::storage_proxy& proxy, const redis_options& options, const bytes& key, const std::vector<bytes>& fields, service_permit permit) {
+    auto schema = get_schema(proxy, options.get_keyspace_name(), redis::HASHes);
+    std::vector<clustering_key> ckeys;
+    ckeys.reserve(fields.size());
+    for (auto& field : fields) {
+        ckeys.push_back(clustering_key::from_single_value(*schema, field));
+    }
+    // The ranges of a slice must be sorted and must not overlap.
+    std::sort(ckeys.begin(), ckeys.end(), clustering_key::less_compare(*schema));
+    ckeys.erase(std::unique(ckeys.begin(), ckeys.end(), clustering_key::equality(*schema)), ckeys.end());
+    std::vector<query::clustering_range> ranges;
+    ranges.reserve(ckeys.size());
+    for (auto& ckey : ckeys) {
+        ranges.push_back(query::clustering_range::make_singular(std::move(ckey)));
+    }
+
+    auto ps = partition_slice_builder(*schema)
+        .with_ranges(std::move(ranges))
+        .build();
+    return query_hashes(proxy, options, key, permit, schema, ps);
+}
 
 future<lw_shared_ptr<std::map<bytes, bytes>>> query_hashes(service::storage_proxy& proxy, const redis_options& options, const bytes& key, service_permit permit, schema_ptr schema, query::partition_slice ps) {
     const auto max_result_size = proxy.get_max_result_size(ps);
@@ -164,4 +187,122 @@ future<lw_shared_ptr<std::map<bytes, bytes>>> query_hashes(service::storage_prox
     });
 }
 
+class zset_scores_result_builder {
+    lw_shared_ptr<std::map<bytes, double>> _data;
+    const query::partition_slice& _partition_slice;
+    const schema_ptr _schema;
+public:
+    zset_scores_result_builder(lw_shared_ptr<std::map<bytes, double>> data, const schema_ptr schema, const query::partition_slice& ps)
+        : _data(data)
+        , _partition_slice(ps)
+        , _schema(schema)
+    {
+    }
+    void accept_new_partition(const partition_key& key, uint32_t row_count) {}
+    void accept_new_partition(uint32_t row_count) {}
+    void accept_new_row(const clustering_key& key, const query::result_row_view& static_row, const query::result_row_view& row)
+    {
+        auto row_iterator = row.iterator();
+        auto cell = row_iterator.next_atomic_cell();
+        if (cell) {
+            cell->value().with_linearized([this, &key] (bytes_view cell_view) {
+                _data->emplace(key.explode().front(), value_cast<double>(double_type->deserialize_value(cell_view)));
+            });
+        }
+    }
+    void accept_new_row(const query::result_row_view& static_row, const query::result_row_view& row) {}
+    void accept_partition_end(const query::result_row_view& static_row) {}
+};
+
+class zset_range_result_builder {
+    lw_shared_ptr<zset_members> _data;
+    uint64_t _skip;
+public:
+    zset_range_result_builder(lw_shared_ptr<zset_members> data, uint64_t skip)
+        : _data(data)
+        , _skip(skip)
+    {
+    }
+    void accept_new_partition(const partition_key& key, uint32_t row_count) {}
+    void accept_new_partition(uint32_t row_count) {}
+    void accept_new_row(const clustering_key& key, const query::result_row_view& static_row, const query::result_row_view& row)
+    {
+        if (_skip) {
+            --_skip;
+            return;
+        }
+        auto components = key.explode();
+        _data->emplace_back(std::move(components[1]), value_cast<double>(double_type->deserialize_value(components[0])));
+    }
+    void accept_new_row(const query::result_row_view& static_row, const query::result_row_view& row) {}
+    void accept_partition_end(const query::result_row_view& static_row) {}
+};
+
+static dht::partition_range_vector single_partition(const schema& schema, const bytes& key) {
+    auto pkey = partition_key::from_single_value(schema, key);
+    dht::partition_range_vector partition_ranges;
+    partition_ranges.emplace_back(dht::partition_range::make_singular(dht::decorate_key(schema, std::move(pkey))));
+    return partition_ranges;
+}
+
+future<lw_shared_ptr<std::map<bytes, double>>> read_zset_scores(service::storage_proxy& proxy, const redis_options& options, const bytes& key, const std::vector<bytes>& members, service_permit permit) {
+    auto schema = get_schema(proxy, options.get_keyspace_name(), redis::ZSET_MEMBERs);
+    std::vector<query::clustering_range> ranges;
+    for (const auto& member : members) {
+        ranges.push_back(query::clustering_range::make_singular(clustering_key::from_single_value(*schema, member)));
+    }
+    if (ranges.empty()) {
+        ranges.push_back(query::clustering_range::make_open_ended_both_sides());
+    } else {
+        std::sort(ranges.begin(), ranges.end(), [cmp = clustering_key::less_compare(*schema)] (const auto& a, const auto& b) {
+            return cmp(a.start()->value(), b.start()->value());
+        });
+        ranges.erase(std::unique(ranges.begin(), ranges.end(), [eq = clustering_key::equality(*schema)] (const auto& a, const auto& b) {
+            return eq(a.start()->value(), b.start()->value());
+        }), ranges.end());
+    }
+    auto ps = partition_slice_builder(*schema)
+        .with_ranges(std::move(ranges))
+        .build();
+    const auto max_result_size = proxy.get_max_result_size(ps);
+    const auto max_tombstones = proxy.get_tombstone_limit();
+    query::read_command cmd(schema->id(), schema->version(), ps, max_result_size, max_tombstones, query::row_limit::max, query::partition_limit(1), gc_clock::now(), std::nullopt, query_id::create_null_id(), query::is_first_page::no);
+    auto read_consistency_level = options.get_read_consistency_level();
+    db::timeout_clock::time_point timeout = db::timeout_clock::now() + options.get_read_timeout();
+    return proxy.query(schema, make_lw_shared<query::read_command>(std::move(cmd)), single_partition(*schema, key), read_consistency_level, {timeout, permit, service::client_state::for_internal_calls()}).then([ps, schema] (auto qr) {
+        return query::result_view::do_with(*qr.query_result, [&] (query::result_view v) {
+            auto pd = make_lw_shared<std::map<bytes, double>>();
+            v.consume(ps, zset_scores_result_builder(pd, schema, ps));
+            return pd;
+        });
+    });
+}
+
+future<lw_shared_ptr<zset_members>> read_zset_range(service::storage_proxy& proxy, const redis_options& options, const bytes& key,
+        std::optional<score_bound> min, std::optional<score_bound> max, uint64_t offset, std::optional<uint64_t> count, service_permit permit) {
+    auto schema = get_schema(proxy, options.get_keyspace_name(), redis::ZSET_SCOREs);
+    auto make_bound = [&schema] (const std::optional<score_bound>& b) -> std::optional<query::clustering_range::bound> {
+        if (!b) {
+            return std::nullopt;
+        }
+        return query::clustering_range::bound(clustering_key_prefix::from_single_value(*schema, double_type->decompose(b->score)), b->inclusive);
+    };
+    auto ps = partition_slice_builder(*schema)
+        .with_range(query::clustering_range(make_bound(min), make_bound(max)))
+        .build();
+    const auto max_result_size = proxy.get_max_result_size(ps);
+    const auto max_tombstones = proxy.get_tombstone_limit();
+    auto row_limit = count ? query::row_limit(offset + *count) : query::row_limit::max;
+    query::read_command cmd(schema->id(), schema->version(), ps, max_result_size, max_tombstones, row_limit, query::partition_limit(1), gc_clock::now(), std::nullopt, query_id::create_null_id(), query::is_first_page::no);
+    auto read_consistency_level = options.get_read_consistency_level();
+    db::timeout_clock::time_point timeout = db::timeout_clock::now() + options.get_read_timeout();
+    return proxy.query(schema, make_lw_shared<query::read_command>(std::move(cmd)), single_partition(*schema, key), read_consistency_level, {timeout, permit, service::client_state::for_internal_calls()}).then([ps, offset] (auto qr) {
+        return query::result_view::do_with(*qr.query_result, [&] (query::result_view v) {
+            auto pd = make_lw_shared<zset_members>();
+            v.consume(ps, zset_range_result_builder(pd, offset));
+            return pd;
+        });
+    });
+}
+
 }
@@ -13,6 +13,9 @@
 #include "bytes.hh"
 #include "gc_clock.hh"
 #include "query-request.hh"
+#include <optional>
+#include <utility>
+#include <vector>
 
 namespace service {
 class storage_proxy;
@@ -40,6 +43,25 @@ seastar::future<seastar::lw_shared_ptr<strings_result>> query_strings(service::s
 
 seastar::future<seastar::lw_shared_ptr<std::map<bytes, bytes>>> read_hashes(service::storage_proxy&, const redis_options&, const bytes&, service_permit);
 seastar::future<seastar::lw_shared_ptr<std::map<bytes, bytes>>> read_hashes(service::storage_proxy&, const redis_options&, const bytes&, const bytes&, service_permit);
+seastar::future<seastar::lw_shared_ptr<std::map<bytes, bytes>>> read_hashes(service::storage_proxy&, const redis_options&, const bytes&, const std::vector<bytes>&, service_permit);
 seastar::future<seastar::lw_shared_ptr<std::map<bytes, bytes>>> query_hashes(service::storage_proxy&, const redis_options&, const bytes&, service_permit, schema_ptr, query::partition_slice);
 
+// A bound of a range of scores of a sorted set.
+struct score_bound {
+    double score;
+    bool inclusive;
+};
+
+// Members of a sorted set and their scores, in the order of their scores.
+using zset_members = std::vector<std::pair<bytes, double>>;
+
+// Reads the scores of the given members of the sorted set, or of all its
+// members if none are given.
+seastar::future<seastar::lw_shared_ptr<std::map<bytes, double>>> read_zset_scores(service::storage_proxy&, const redis_options&, const bytes& key, const std::vector<bytes>& members, service_permit);
+// Reads the members of the sorted set whose score is within the bounds,
+// skipping the first offset of them and returning up to count. The range is
+// read by the replicas, which only return the rows it holds.
+seastar::future<seastar::lw_shared_ptr<zset_members>> read_zset_range(service::storage_proxy&, const redis_options&, const bytes& key,
+        std::optional<score_bound> min, std::optional<score_bound> max, uint64_t offset, std::optional<uint64_t> count, service_permit);
+
 }
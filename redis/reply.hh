@@ -68,6 +68,14 @@ class redis_message final {
         }
         return make_ready_future<redis_message>(m);
     }
+    static seastar::future<redis_message> make_array_result(std::vector<bytes>& array_result) {
+        auto m = make_lw_shared<scattered_message<char>> ();
+        m->append(fmt::format("*{}\r\n", array_result.size()));
+        for (auto& r : array_result) {
+            write_bytes(m, r);
+        }
+        return make_ready_future<redis_message>(m);
+    }
     static seastar::future<redis_message> make_strings_result(bytes result) {
         auto m = make_lw_shared<scattered_message<char>> ();
         write_bytes(m, result);
@@ -8,6 +8,7 @@
 
 #include "redis/server.hh"
 
+#include "redis/command_factory.hh"
 #include "redis/request.hh"
 #include "redis/reply.hh"
 
@@ -70,7 +71,9 @@ redis_server::connection::connection(redis_server& server, socket_address server
     , _server(server)
     , _server_addr(server_addr)
     , _options(server._config._read_consistency_level, server._config._write_consistency_level, server._config._timeout_config, server._auth_service, addr, server._total_redis_db_count)
+    , _write_batch(server._query_processor.local().proxy(), server._config._write_consistency_level, server._stats, _pending_requests_gate)
 {
+    _options.set_write_batch(&_write_batch);
 }
 
 redis_server::connection::~connection() {
@@ -78,59 +81,129 @@ redis_server::connection::~connection() {
 
 thread_local redis_server::connection::execution_stage_type redis_server::connection::_process_request_stage {"redis_transport", &connection::process_request_one};
 
-future<redis_server::result> redis_server::connection::process_request_internal() {
-    return _process_request_stage(this, _parser.get_request(), seastar::ref(_options), empty_service_permit());
+static sstring error_message(std::exception_ptr ep) {
+    try {
+        std::rethrow_exception(ep);
+    } catch (redis_exception& e) {
+        return e.what_message();
+    } catch (std::exception& e) {
+        return e.what();
+    } catch (...) {
+        return "Unknown exception";
+    }
+}
+
+// Runs the command once the commands received before it which touch the
+// same keys completed, or all of them for commands which don't run along
+// with others.
+future<redis_server::result> redis_server::connection::process_pipelined(redis::request&& request) {
+    auto keys = redis::command_factory::keys_of(request);
+    auto id = ++_last_command_id;
+    promise<> done;
+    shared_future<> done_future(done.get_future());
+    std::vector<future<>> predecessors;
+    if (_last_exclusive_command) {
+        predecessors.push_back(_last_exclusive_command->done.get_future());
+    }
+    if (!keys) {
+        for (auto& [key, command] : _last_command_of_key) {
+            predecessors.push_back(command.done.get_future());
+        }
+        _last_exclusive_command = running_command{id, done_future};
+    } else {
+        for (const auto& key : *keys) {
+            auto [it, inserted] = _last_command_of_key.try_emplace(key, running_command{id, done_future});
+            if (!inserted && it->second.id != id) {
+                predecessors.push_back(it->second.done.get_future());
+                it->second = running_command{id, done_future};
+            }
+        }
+    }
+    auto ready = predecessors.empty() ? make_ready_future<>() : when_all(predecessors.begin(), predecessors.end()).discard_result();
+    return ready.then([this, request = std::move(request)] () mutable {
+        return _process_request_stage(this, std::move(request), seastar::ref(_options), empty_service_permit());
+    }).then_wrapped([this, id, keys = std::move(keys), done = std::move(done)] (future<result> f) mutable {
+        if (!keys) {
+            if (_last_exclusive_command && _last_exclusive_command->id == id) {
+                _last_exclusive_command = std::nullopt;
+            }
+        } else {
+            for (const auto& key : *keys) {
+                auto it = _last_command_of_key.find(key);
+                if (it != _last_command_of_key.end() && it->second.id == id) {
+                    _last_command_of_key.erase(it);
+                }
+            }
+        }
+        done.set_value();
+        return f;
+    });
+}
+
+future<> redis_server::connection::write_message(lw_shared_ptr<scattered_message<char>> m) {
+    return _write_buf.write(std::move(*m)).then([this] {
+        // Replies of pipelined commands are flushed together.
+        if (--_replies_pending) {
+            return make_ready_future<>();
+        }
+        return _write_buf.flush();
+    });
 }
 
 void redis_server::connection::write_reply(const redis_exception& e)
 {
+    ++_replies_pending;
     _ready_to_respond = _ready_to_respond.then([this, exception_message = e.what_message()] () mutable {
         return redis_message::exception(exception_message).then([this] (auto&& result) {
-            auto m = result.message();
-            return _write_buf.write(std::move(*m)).then([this] {
-                return _write_buf.flush();
-            });
+            return write_message(result.message());
         });
     });
 }
 
-void redis_server::connection::write_reply(redis_server::result result)
+// Writes the reply of a command once it completes, after the replies of
+// the commands received before it.
+void redis_server::connection::write_reply(future<redis_server::result> result)
 {
+    ++_replies_pending;
     _ready_to_respond = _ready_to_respond.then([this, result = std::move(result)] () mutable {
-        auto m = result.make_message();
-        return _write_buf.write(std::move(*m)).then([this] {
-            return _write_buf.flush();
+        return result.then_wrapped([this] (future<redis_server::result> f) {
+            if (f.failed()) {
+                return redis_message::exception(error_message(f.get_exception())).then([this] (auto&& result) {
+                    return write_message(result.message());
+                });
+            }
+            return write_message(f.get0().make_message());
         });
     });
 }
 
 future<> redis_server::connection::process_request() {
-    _parser.init();
-    return _read_buf.consume(_parser).then([this] {
-        if (_parser.eof()) {
-            return make_ready_future<>();
-        }
-        ++_server._stats._requests_serving;
-        _pending_requests_gate.enter();
-        utils::latency_counter lc;
-        lc.start();
-        auto leave = defer([this] () noexcept { _pending_requests_gate.leave(); });
-        return process_request_internal().then([this, leave = std::move(leave), lc = std::move(lc)] (auto&& result) mutable {
-            --_server._stats._requests_serving;
-            try {
-                if (_parser.failed()) {
-                    logging.error("request parse failed");
-                    const auto e = redis_exception("unknown command ''");
-                    write_reply(std::move(e));
-                }else{
-                    write_reply(std::move(result));
-                }
+    return get_units(_pipeline_slots, 1).then([this] (semaphore_units<> slot) {
+        _parser.init();
+        return _read_buf.consume(_parser).then([this, slot = std::move(slot)] () mutable {
+            if (_parser.eof()) {
+                return;
+            }
+            ++_server._stats._requests_serving;
+            _pending_requests_gate.enter();
+            utils::latency_counter lc;
+            lc.start();
+            auto leave = defer([this] () noexcept { _pending_requests_gate.leave(); });
+            if (_parser.failed()) {
+                logging.error("request parse failed");
+            }
+            auto f = _parser.failed()
+                    ? make_exception_future<result>(redis_exception("unknown command ''"))
+                    : process_pipelined(std::move(_parser.get_request()));
+            // The next command is read without waiting for this one to
+            // complete.
+            write_reply(f.then_wrapped([this, leave = std::move(leave), lc = std::move(lc), slot = std::move(slot)] (future<result> f) mutable {
+                --_server._stats._requests_serving;
                 ++_server._stats._requests_served;
                 _server._stats._requests.mark(lc.stop().latency());
                 _server._stats._estimated_requests_latency.add(lc.latency(), _server._stats._requests.hist.count);
-            } catch (...) {
-                logging.error("request processing failed: {}", std::current_exception());
-            }
+                return f;
+            }));
         });
     });
 }
@@ -14,6 +14,7 @@
 #include "redis/reply.hh"
 #include "redis/request.hh"
 #include "redis/stats.hh"
+#include "redis/write_batch.hh"
 
 #include "auth/authenticator.hh"
 #include "auth/service.hh"
@@ -27,11 +28,14 @@
 
 #include <seastar/core/seastar.hh>
 #include <seastar/core/semaphore.hh>
+#include <seastar/core/shared_future.hh>
 #include <seastar/core/sharded.hh>
 #include <seastar/core/execution_stage.hh>
 #include <seastar/net/tls.hh>
 
 #include <memory>
+#include <optional>
+#include <unordered_map>
 
 db::consistency_level make_consistency_level(const sstring&);
 
@@ -63,6 +67,10 @@ class redis_server : public generic_server::server {
     size_t _total_redis_db_count;
 
 public:
+    // The commands a client can pipeline before the server stops reading
+    // more of them, waiting for some to complete.
+    static constexpr size_t max_pipelined_commands = 128;
+
     redis_server(seastar::sharded<redis::query_processor>& qp, auth::service& auth_service, redis_server_config config);
 
     struct result {
@@ -80,6 +88,21 @@ class redis_server : public generic_server::server {
         socket_address _server_addr;
         redis_protocol_parser _parser;
         redis::redis_options _options;
+        // Commands pipelined by the client run concurrently, except those
+        // touching the same keys, which run in the order they were received,
+        // see process_pipelined(). Their replies are written in that order.
+        semaphore _pipeline_slots{max_pipelined_commands};
+        redis::write_batch _write_batch;
+        struct running_command {
+            uint64_t id;
+            shared_future<> done;
+        };
+        uint64_t _last_command_id = 0;
+        // The last command received touching each key.
+        std::unordered_map<bytes, running_command> _last_command_of_key;
+        // The last command received which doesn't run along with others.
+        std::optional<running_command> _last_exclusive_command;
+        size_t _replies_pending = 0;
 
         using execution_stage_type = inheriting_concrete_execution_stage<
                 future<redis_server::result>,
@@ -95,10 +118,11 @@ class redis_server : public generic_server::server {
         future<> process_request() override;
         void handle_error(future<>&& f) override;
         void write_reply(const redis_exception&);
-        void write_reply(redis_server::result result);
+        void write_reply(future<redis_server::result> result);
     private:
         future<result> process_request_one(redis::request&& request, redis::redis_options&, service_permit permit);
-        future<result> process_request_internal();
+        future<result> process_pipelined(redis::request&& request);
+        future<> write_message(lw_shared_ptr<scattered_message<char>> m);
     };
 
     virtual shared_ptr<generic_server::connection> make_connection(socket_address server_addr, connected_socket&& fd, socket_address addr) override;
@@ -37,6 +37,10 @@ stats::stats() : api_operations{} {
             seastar::metrics::description("Counts a number of served requests.")),
         seastar::metrics::make_gauge("requests_serving", _requests_serving,
             seastar::metrics::description("Holds a number of requests that are being processed right now.")),
+        seastar::metrics::make_counter("write_batches", _write_batches,
+            seastar::metrics::description("Counts a number of writes of the mutations of pipelined requests.")),
+        seastar::metrics::make_counter("batched_mutations", _batched_mutations,
+            seastar::metrics::description("Counts a number of mutations written along with those of other pipelined requests.")),
         seastar::metrics::make_histogram("requests_latency", seastar::metrics::description("The general requests latency histogram"), [this]{ return _estimated_requests_latency.get_histogram(16, 20);}),
     });
 }
@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "redis/write_batch.hh"
+#include "redis/stats.hh"
+#include "service/storage_proxy.hh"
+
+#include <seastar/core/future-util.hh>
+
+namespace redis {
+
+write_batch::write_batch(service::storage_proxy& proxy, db::consistency_level cl, stats& stats, seastar::gate& gate)
+    : _proxy(proxy)
+    , _cl(cl)
+    , _stats(stats)
+    , _gate(gate)
+{
+}
+
+future<> write_batch::add(std::vector<mutation> mutations, db::timeout_clock::time_point timeout, service_permit permit) {
+    if (_mutations.empty()) {
+        _timeout = timeout;
+        _permit = std::move(permit);
+        // The commands ready to run now run before the flush, and so join
+        // the batch.
+        (void)with_gate(_gate, [this] {
+            return yield().then([this] {
+                flush();
+            });
+        });
+    } else {
+        _timeout = std::min(_timeout, timeout);
+    }
+    std::move(mutations.begin(), mutations.end(), std::back_inserter(_mutations));
+    auto f = _done->get_shared_future();
+    if (_mutations.size() >= max_size) {
+        flush();
+    }
+    return f;
+}
+
+void write_batch::flush() {
+    if (_mutations.empty()) {
+        return;
+    }
+    ++_stats._write_batches;
+    _stats._batched_mutations += _mutations.size();
+    auto done = std::exchange(_done, make_lw_shared<shared_promise<>>());
+    (void)_proxy.mutate(std::exchange(_mutations, {}), _cl, _timeout, nullptr, std::exchange(_permit, empty_service_permit()),
+            db::allow_per_partition_rate_limit::yes).then_wrapped([done = std::move(done)] (future<> f) {
+        if (f.failed()) {
+            done->set_exception(f.get_exception());
+        } else {
+            done->set_value();
+        }
+    });
+}
+
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <vector>
+
+#include <seastar/core/future.hh>
+#include <seastar/core/gate.hh>
+#include <seastar/core/shared_future.hh>
+#include <seastar/core/shared_ptr.hh>
+
+#include "db/consistency_level_type.hh"
+#include "db/timeout_clock.hh"
+#include "mutation/mutation.hh"
+#include "service_permit.hh"
+#include "seastarx.hh"
+
+namespace service {
+class storage_proxy;
+}
+
+namespace redis {
+
+class stats;
+
+// Coalesces the writes of the commands a client pipelines into a single
+// storage_proxy::mutate() call, which writes the mutations of all of them
+// in parallel.
+//
+// Mutations added are written once the commands which can run at the same
+// time, like those of a pipeline read at once, had the chance to add theirs,
+// or once the batch holds max_size of them. All the commands of a batch fail
+// if any of its mutations does.
+class write_batch {
+public:
+    static constexpr size_t max_size = 128;
+private:
+    service::storage_proxy& _proxy;
+    db::consistency_level _cl;
+    stats& _stats;
+    // Held by the flushes scheduled by add().
+    seastar::gate& _gate;
+    std::vector<mutation> _mutations;
+    db::timeout_clock::time_point _timeout;
+    service_permit _permit = empty_service_permit();
+    lw_shared_ptr<shared_promise<>> _done = make_lw_shared<shared_promise<>>();
+public:
+    write_batch(service::storage_proxy& proxy, db::consistency_level cl, stats& stats, seastar::gate& gate);
+
+    // Adds the mutations of a command, resolving once they are written.
+    future<> add(std::vector<mutation> mutations, db::timeout_clock::time_point timeout, service_permit permit);
+
+    // Writes the mutations added so far.
+    void flush();
+};
+
+}
@@ -36,6 +36,15 @@ class repair_hash {
 
 using repair_hash_set = absl::btree_set<repair_hash>;
 
+// Identifies the rows a node read from a range in a row level repair which
+// found the range in sync on all the nodes taking part in it: the seed of
+// the repair, which all of them share, and the combined hash of the rows.
+struct repair_range_summary {
+    uint64_t seed;
+    repair_hash hash;
+    bool operator==(const repair_range_summary&) const = default;
+};
+
 class repair_hasher {
     uint64_t _seed;
     schema_ptr _schema;
@@ -40,6 +40,7 @@
 #include <seastar/core/coroutine.hh>
 #include <seastar/coroutine/parallel_for_each.hh>
 #include <seastar/core/sleep.hh>
+#include <seastar/core/loop.hh>
 
 #include <cfloat>
 #include <algorithm>
@@ -352,12 +353,25 @@ float node_ops_metrics::repair_finished_percentage() {
 repair::task_manager_module::task_manager_module(tasks::task_manager& tm, repair_service& rs, size_t max_repair_memory) noexcept
     : tasks::task_manager::module(tm, "repair")
     , _rs(rs)
-    , _range_parallelism_semaphore(std::max(size_t(1), size_t(max_repair_memory / max_repair_memory_per_range / 4)),
-            named_semaphore_exception_factory{"repair range parallelism"})
+    , _scheduler(max_repair_memory / max_repair_memory_per_range / 4)
 {
-    auto nr = _range_parallelism_semaphore.available_units();
+    auto nr = _scheduler.max_parallelism();
     rlogger.info("Setting max_repair_memory={}, max_repair_memory_per_range={}, max_repair_ranges_in_parallel={}",
         max_repair_memory, max_repair_memory_per_range, nr);
+
+    namespace sm = seastar::metrics;
+    _metrics.add_group("repair", {
+        sm::make_gauge("scheduler_parallelism", [this] { return _scheduler.parallelism(); },
+                sm::description("Number of ranges the repairs on this shard may repair in parallel, lowered while the foreground workload is busy")),
+        sm::make_gauge("scheduler_running_ranges", [this] { return _scheduler.running(); },
+                sm::description("Number of ranges currently repaired on this shard")),
+        sm::make_gauge("scheduler_queued_ranges", [this] { return _scheduler.waiters(); },
+                sm::description("Number of ranges waiting to be repaired on this shard")),
+        sm::make_counter("scheduler_backoffs", [this] { return _scheduler.get_stats().backoffs; },
+                sm::description("Number of times repair lowered its parallelism for the foreground workload")),
+        sm::make_counter("scheduler_throttled_bytes", [this] { return _scheduler.get_stats().throttled_bytes; },
+                sm::description("Total number of row bytes repair had to wait for, to keep to repair_throughput_mb_per_sec")),
+    });
 }
 
 void repair::task_manager_module::start(repair_uniq_id id) {
@@ -490,10 +504,6 @@ float repair::task_manager_module::report_progress(streaming::stream_reason reas
     return nr_ranges_total == 0 ? 1 : float(nr_ranges_finished) / float(nr_ranges_total);
 }
 
-named_semaphore& repair::task_manager_module::range_parallelism_semaphore() {
-    return _range_parallelism_semaphore;
-}
-
 future<> repair::task_manager_module::run(repair_uniq_id id, std::function<void ()> func) {
     return seastar::with_gate(async_gate(), [this, id, func = std::move(func)] () mutable {
         start(id);
@@ -585,6 +595,7 @@ repair::shard_repair_task_impl::shard_repair_task_impl(tasks::task_manager::modu
     , total_rf(erm->get_replication_factor())
     , nr_ranges_total(ranges.size())
     , _hints_batchlog_flushed(std::move(hints_batchlog_flushed))
+    , buf_size_controller(task_manager_module::max_repair_memory_per_range)
 { }
 
 void repair::shard_repair_task_impl::check_failed_ranges() {
@@ -612,10 +623,17 @@ repair_neighbors repair::shard_repair_task_impl::get_repair_neighbors(const dht:
         neighbors[range];
 }
 
-size_t repair::shard_repair_task_impl::ranges_size() {
+size_t repair::shard_repair_task_impl::ranges_size() const noexcept {
     return ranges.size() * table_ids.size();
 }
 
+future<tasks::task_manager::task::progress> repair::shard_repair_task_impl::get_progress() const {
+    co_return tasks::task_manager::task::progress{
+        .completed = double(nr_ranges_finished),
+        .total = double(ranges_size()),
+    };
+}
+
 // Repair a single local range, multiple column families.
 // Comparable to RepairSession in Origin
 future<> repair::shard_repair_task_impl::repair_range(const dht::token_range& range, ::table_id table_id) {
@@ -683,6 +701,7 @@ void repair_stats::add(const repair_stats& o) {
     round_nr_fast_path_already_synced += o.round_nr_fast_path_already_synced;
     round_nr_fast_path_same_combined_hashes += o.round_nr_fast_path_same_combined_hashes;
     round_nr_slow_path += o.round_nr_slow_path;
+    unchanged_range_nr += o.unchanged_range_nr;
     rpc_call_nr += o.rpc_call_nr;
     tx_hashes_nr += o.tx_hashes_nr;
     rx_hashes_nr += o.rx_hashes_nr;
@@ -719,11 +738,12 @@ sstring repair_stats::get_stats() {
             row_from_disk_rows_per_sec[x.first] = 0;
         }
     }
-    return format("round_nr={}, round_nr_fast_path_already_synced={}, round_nr_fast_path_same_combined_hashes={}, round_nr_slow_path={}, rpc_call_nr={}, tx_hashes_nr={}, rx_hashes_nr={}, duration={} seconds, tx_row_nr={}, rx_row_nr={}, tx_row_bytes={}, rx_row_bytes={}, row_from_disk_bytes={}, row_from_disk_nr={}, row_from_disk_bytes_per_sec={} MiB/s, row_from_disk_rows_per_sec={} Rows/s, tx_row_nr_peer={}, rx_row_nr_peer={}",
+    return format("round_nr={}, round_nr_fast_path_already_synced={}, round_nr_fast_path_same_combined_hashes={}, round_nr_slow_path={}, unchanged_range_nr={}, rpc_call_nr={}, tx_hashes_nr={}, rx_hashes_nr={}, duration={} seconds, tx_row_nr={}, rx_row_nr={}, tx_row_bytes={}, rx_row_bytes={}, row_from_disk_bytes={}, row_from_disk_nr={}, row_from_disk_bytes_per_sec={} MiB/s, row_from_disk_rows_per_sec={} Rows/s, tx_row_nr_peer={}, rx_row_nr_peer={}",
             round_nr,
             round_nr_fast_path_already_synced,
             round_nr_fast_path_same_combined_hashes,
             round_nr_slow_path,
+            unchanged_range_nr,
             rpc_call_nr,
             tx_hashes_nr,
             rx_hashes_nr,
@@ -920,44 +940,50 @@ struct repair_options {
 };
 
 future<> repair::shard_repair_task_impl::do_repair_ranges() {
-    // Repair tables in the keyspace one after another
+    // Repair the ranges of all tables in the keyspace in parallel, as the
+    // repair scheduler admits them. The ranges are queued table after table,
+    // so the repair of a table only overlaps with the tables next to it.
     assert(table_names().size() == table_ids.size());
-    for (size_t idx = 0; idx < table_ids.size(); idx++) {
+    auto& scheduler = rs.get_repair_module().scheduler();
+    auto pc = _reason == streaming::stream_reason::repair ? repair_scheduler::priority_class::repair : repair_scheduler::priority_class::node_ops;
+    std::vector<size_t> ranges_left(table_ids.size(), ranges.size());
+    auto work = boost::irange(size_t(0), table_ids.size() * ranges.size());
+    co_await max_concurrent_for_each(work, scheduler.max_parallelism(), [&] (size_t i) -> future<> {
+        auto idx = i / ranges.size();
+        auto& range = ranges[i % ranges.size()];
         auto table_id = table_ids[idx];
-        auto table_name = table_names()[idx];
-        // repair all the ranges in limited parallelism
-        rlogger.info("repair[{}]: Started to repair {} out of {} tables in keyspace={}, table={}, table_id={}, repair_reason={}",
-                global_repair_id.uuid(), idx + 1, table_ids.size(), _status.keyspace, table_name, table_id, _reason);
-        co_await coroutine::parallel_for_each(ranges, [this, table_id] (auto&& range) {
-            return with_semaphore(rs.get_repair_module().range_parallelism_semaphore(), 1, [this, &range, table_id] {
-                return repair_range(range, table_id).then([this] {
-                    if (_reason == streaming::stream_reason::bootstrap) {
-                        rs.get_metrics().bootstrap_finished_ranges++;
-                    } else if (_reason == streaming::stream_reason::replace) {
-                        rs.get_metrics().replace_finished_ranges++;
-                    } else if (_reason == streaming::stream_reason::rebuild) {
-                        rs.get_metrics().rebuild_finished_ranges++;
-                    } else if (_reason == streaming::stream_reason::decommission) {
-                        rs.get_metrics().decommission_finished_ranges++;
-                    } else if (_reason == streaming::stream_reason::removenode) {
-                        rs.get_metrics().removenode_finished_ranges++;
-                    } else if (_reason == streaming::stream_reason::repair) {
-                        rs.get_metrics().repair_finished_ranges_sum++;
-                        nr_ranges_finished++;
-                    }
-                    rlogger.debug("repair[{}]: node ops progress bootstrap={}, replace={}, rebuild={}, decommission={}, removenode={}, repair={}",
-                        global_repair_id.uuid(),
-                        rs.get_metrics().bootstrap_finished_percentage(),
-                        rs.get_metrics().replace_finished_percentage(),
-                        rs.get_metrics().rebuild_finished_percentage(),
-                        rs.get_metrics().decommission_finished_percentage(),
-                        rs.get_metrics().removenode_finished_percentage(),
-                        rs.get_metrics().repair_finished_percentage());
-                });
-            });
-        });
-
-        if (_reason != streaming::stream_reason::repair) {
+        if (i % ranges.size() == 0) {
+            rlogger.info("repair[{}]: Started to repair {} out of {} tables in keyspace={}, table={}, table_id={}, repair_reason={}",
+                    global_repair_id.uuid(), idx + 1, table_ids.size(), _status.keyspace, table_names()[idx], table_id, _reason);
+        }
+        {
+            auto permit = co_await scheduler.acquire(pc);
+            co_await repair_range(range, table_id);
+        }
+        if (_reason == streaming::stream_reason::bootstrap) {
+            rs.get_metrics().bootstrap_finished_ranges++;
+        } else if (_reason == streaming::stream_reason::replace) {
+            rs.get_metrics().replace_finished_ranges++;
+        } else if (_reason == streaming::stream_reason::rebuild) {
+            rs.get_metrics().rebuild_finished_ranges++;
+        } else if (_reason == streaming::stream_reason::decommission) {
+            rs.get_metrics().decommission_finished_ranges++;
+        } else if (_reason == streaming::stream_reason::removenode) {
+            rs.get_metrics().removenode_finished_ranges++;
+        } else if (_reason == streaming::stream_reason::repair) {
+            rs.get_metrics().repair_finished_ranges_sum++;
+        }
+        nr_ranges_finished++;
+        rlogger.debug("repair[{}]: node ops progress bootstrap={}, replace={}, rebuild={}, decommission={}, removenode={}, repair={}",
+            global_repair_id.uuid(),
+            rs.get_metrics().bootstrap_finished_percentage(),
+            rs.get_metrics().replace_finished_percentage(),
+            rs.get_metrics().rebuild_finished_percentage(),
+            rs.get_metrics().decommission_finished_percentage(),
+            rs.get_metrics().removenode_finished_percentage(),
+            rs.get_metrics().repair_finished_percentage());
+
+        if (--ranges_left[idx] == 0 && _reason != streaming::stream_reason::repair) {
             try {
                 auto& table = db.local().find_column_family(table_id);
                 rlogger.debug("repair[{}]: Trigger off-strategy compaction for keyspace={}, table={}",
@@ -967,8 +993,7 @@ future<> repair::shard_repair_task_impl::do_repair_ranges() {
                 // Ignore dropped table
             }
         }
-    }
-    co_return;
+    });
 }
 
 // Repairs a list of token ranges, each assumed to be a token
@@ -124,6 +124,8 @@ class repair_stats {
     uint64_t round_nr_fast_path_already_synced = 0;
     uint64_t round_nr_fast_path_same_combined_hashes= 0;
     uint64_t round_nr_slow_path = 0;
+    // Ranges skipped because they were unchanged since the last repair found them in sync
+    uint64_t unchanged_range_nr = 0;
 
     uint64_t rpc_call_nr = 0;
 
@@ -174,6 +176,9 @@ enum class repair_row_level_start_status: uint8_t {
 
 struct repair_row_level_start_response {
     repair_row_level_start_status status;
+    // The summary of the range the follower kept from the last repair which
+    // found it in sync, see replica::repair_range_summaries.
+    std::optional<repair_range_summary> summary;
 };
 
 // Return value of the REPAIR_GET_SYNC_BOUNDARY RPC verb
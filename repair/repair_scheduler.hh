@@ -0,0 +1,194 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include <seastar/core/chunked_fifo.hh>
+#include <seastar/core/future.hh>
+#include <seastar/core/sleep.hh>
+
+// Schedules the ranges repaired by a shard, for all repair jobs and the node
+// operations using repair, so that they share the capacity which the
+// foreground workload leaves to them.
+//
+// Up to parallelism() ranges are repaired at a time, admitted from the queue
+// of the highest priority class holding any, in the order they were queued.
+// The parallelism is halved whenever the foreground workload is found busy,
+// and grows back by one range at a time while it isn't, see adjust(). Ranges
+// already admitted are not interrupted when it shrinks.
+//
+// Repairs also charge the rows they read and transfer to a token bucket,
+// refilled at the configured rate scaled by the parallelism, so that repair
+// backs off its disk and network bandwidth along with its concurrency.
+class repair_scheduler {
+public:
+    using clock_type = std::chrono::steady_clock;
+    enum class priority_class {
+        // Node operations, which the topology change waits for.
+        node_ops,
+        repair,
+    };
+    static constexpr size_t priority_class_count = 2;
+    struct stats {
+        uint64_t admitted = 0;
+        uint64_t queued = 0;
+        uint64_t backoffs = 0;
+        uint64_t throttled_bytes = 0;
+    };
+    // Frees a slot of the scheduler when destroyed.
+    class permit {
+        repair_scheduler* _scheduler;
+    public:
+        explicit permit(repair_scheduler& scheduler) noexcept : _scheduler(&scheduler) {}
+        permit(permit&& o) noexcept : _scheduler(std::exchange(o._scheduler, nullptr)) {}
+        permit& operator=(permit&& o) noexcept {
+            if (this != &o) {
+                release();
+                _scheduler = std::exchange(o._scheduler, nullptr);
+            }
+            return *this;
+        }
+        ~permit() {
+            release();
+        }
+        void release() noexcept {
+            if (_scheduler) {
+                std::exchange(_scheduler, nullptr)->signal();
+            }
+        }
+    };
+private:
+    size_t _max_parallelism;
+    size_t _parallelism;
+    size_t _running = 0;
+    // Not empty only while _running >= _parallelism.
+    std::array<seastar::chunked_fifo<seastar::promise<permit>>, priority_class_count> _waiters;
+    // Bytes per second refilled at full parallelism, 0 for unlimited.
+    uint64_t _rate = 0;
+    double _tokens = 0;
+    clock_type::time_point _last_refill;
+    stats _stats;
+private:
+    void signal() noexcept {
+        --_running;
+        maybe_admit();
+    }
+
+    void maybe_admit() noexcept {
+        for (auto& waiters : _waiters) {
+            while (!waiters.empty() && _running < _parallelism) {
+                ++_running;
+                ++_stats.admitted;
+                waiters.front().set_value(permit(*this));
+                waiters.pop_front();
+            }
+        }
+    }
+public:
+    explicit repair_scheduler(size_t max_parallelism) noexcept
+        : _max_parallelism(std::max(max_parallelism, size_t(1)))
+        , _parallelism(_max_parallelism)
+    { }
+
+    repair_scheduler(const repair_scheduler&) = delete;
+    repair_scheduler& operator=(const repair_scheduler&) = delete;
+
+    // Resolves once a range of the given class can be repaired, for as long
+    // as the permit is held.
+    seastar::future<permit> acquire(priority_class pc) {
+        if (_running < _parallelism) {
+            ++_running;
+            ++_stats.admitted;
+            return seastar::make_ready_future<permit>(permit(*this));
+        }
+        auto& waiters = _waiters[size_t(pc)];
+        waiters.emplace_back();
+        ++_stats.queued;
+        return waiters.back().get_future();
+    }
+
+    // Called periodically with whether the foreground workload is busy.
+    void adjust(bool foreground_busy) noexcept {
+        if (foreground_busy) {
+            if (_parallelism > 1) {
+                _parallelism /= 2;
+                ++_stats.backoffs;
+            }
+        } else if (_parallelism < _max_parallelism) {
+            ++_parallelism;
+            maybe_admit();
+        }
+    }
+
+    // Sets the rate, in bytes per second, at which rows can be read and
+    // transferred at full parallelism, 0 for unlimited.
+    void set_rate(uint64_t bytes_per_second) noexcept {
+        _rate = bytes_per_second;
+    }
+
+    double effective_rate() const noexcept {
+        return double(_rate) * _parallelism / _max_parallelism;
+    }
+
+    // Takes bytes from the bucket, returning how long the caller has to
+    // wait for them to be refilled. Up to a second worth of bytes is kept
+    // while repair is idle.
+    clock_type::duration consume(uint64_t bytes, clock_type::time_point now) noexcept {
+        if (!_rate) {
+            return clock_type::duration::zero();
+        }
+        auto rate = effective_rate();
+        auto elapsed = std::chrono::duration<double>(now - _last_refill).count();
+        _last_refill = now;
+        _tokens = std::min(_tokens + elapsed * rate, rate) - bytes;
+        if (_tokens >= 0) {
+            return clock_type::duration::zero();
+        }
+        _stats.throttled_bytes += bytes;
+        return std::chrono::duration_cast<clock_type::duration>(std::chrono::duration<double>(-_tokens / rate));
+    }
+
+    seastar::future<> throttle(uint64_t bytes) {
+        auto delay = consume(bytes, clock_type::now());
+        if (delay <= clock_type::duration::zero()) {
+            return seastar::make_ready_future<>();
+        }
+        return seastar::sleep(delay);
+    }
+
+    size_t max_parallelism() const noexcept {
+        return _max_parallelism;
+    }
+
+    size_t parallelism() const noexcept {
+        return _parallelism;
+    }
+
+    size_t running() const noexcept {
+        return _running;
+    }
+
+    size_t waiters() const noexcept {
+        size_t n = 0;
+        for (auto& waiters : _waiters) {
+            n += waiters.size();
+        }
+        return n;
+    }
+
+    const stats& get_stats() const noexcept {
+        return _stats;
+    }
+};
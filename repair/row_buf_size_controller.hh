@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Picks the size of the row buffers of the ranges a shard repairs, from what
+// the ranges it repaired before observed.
+//
+// Every round of row level repair costs a few round trips to the peers,
+// whatever the size of the rows it syncs, so on links with a high bandwidth
+// delay product rounds have to carry many rows to keep the link busy.
+// Buffers are sized so that rounds take rtts_per_round round trips at the
+// rate rows were synced so far, which grows them while round trips dominate
+// the rounds and stops once reading or sending the rows does.
+//
+// Rows held in the buffers take memory beyond their size, for their
+// hashes, keys and bookkeeping, which dominates for small rows, so buffers
+// are also shrunk for the memory their rows take to fit the memory budget
+// of the range.
+class row_buf_size_controller {
+public:
+    using clock_type = std::chrono::steady_clock;
+    static constexpr size_t min_size = 256 * 1024;
+    static constexpr size_t max_size = 128 * 1024 * 1024;
+    // Estimated memory taken by a row held in the buffers, beyond its size.
+    static constexpr size_t row_overhead = 256;
+    static constexpr unsigned rtts_per_round = 16;
+private:
+    size_t _default_size;
+    // Exponential moving averages of what ranges observed, 0 until they did.
+    double _rtt_s = 0;
+    double _bytes_per_s = 0;
+    double _bytes_per_row = 0;
+private:
+    static void update(double& avg, double sample) {
+        avg = avg ? 0.75 * avg + 0.25 * sample : sample;
+    }
+public:
+    explicit row_buf_size_controller(size_t default_size) noexcept
+        : _default_size(default_size)
+    { }
+
+    // The size of the buffers to read rows into, for memory_budget bytes of
+    // memory per node.
+    size_t size(size_t memory_budget) const noexcept {
+        double size = _default_size;
+        if (_rtt_s && _bytes_per_s) {
+            size = std::clamp(_bytes_per_s * _rtt_s * rtts_per_round, double(min_size), double(max_size));
+        }
+        if (_bytes_per_row) {
+            size = std::min(size, memory_budget * _bytes_per_row / (_bytes_per_row + row_overhead));
+        } else {
+            size = std::min(size, double(memory_budget));
+        }
+        return std::max(size_t(size), min_size);
+    }
+
+    // The memory needed per node by buffers of the given size.
+    size_t memory_for(size_t size) const noexcept {
+        if (!_bytes_per_row) {
+            return size;
+        }
+        return size + size / _bytes_per_row * row_overhead;
+    }
+
+    // Records how long a round trip to the farthest peer took.
+    void observe_rtt(clock_type::duration rtt) noexcept {
+        update(_rtt_s, std::chrono::duration<double>(rtt).count());
+    }
+
+    // Records that repairing a range read rows rows, of bytes in total, on
+    // each node, in rounds rounds which took elapsed. Ranges which fit in one
+    // round say nothing of the rate of syncing rows, only of their size.
+    void observe_range(uint64_t bytes, uint64_t rows, unsigned rounds, clock_type::duration elapsed) noexcept {
+        if (rows) {
+            update(_bytes_per_row, double(bytes) / rows);
+        }
+        auto elapsed_s = std::chrono::duration<double>(elapsed).count();
+        if (rounds > 1 && elapsed_s > 0) {
+            update(_bytes_per_s, bytes / elapsed_s);
+        }
+    }
+
+    double rtt_seconds() const noexcept {
+        return _rtt_s;
+    }
+
+    double bytes_per_second() const noexcept {
+        return _bytes_per_s;
+    }
+};
@@ -45,6 +45,7 @@
 #include "db/system_keyspace.hh"
 #include "service/storage_proxy.hh"
 #include "db/batchlog_manager.hh"
+#include "db/config.hh"
 #include "idl/position_in_partition.dist.hh"
 #include "idl/partition_checksum.dist.hh"
 #include "readers/empty_v2.hh"
@@ -177,6 +178,8 @@ struct row_level_repair_metrics {
     uint64_t row_from_disk_bytes{0};
     uint64_t tx_hashes_nr{0};
     uint64_t rx_hashes_nr{0};
+    uint64_t row_buf_size{0};
+    uint64_t peer_rtt_us{0};
     row_level_repair_metrics() {
         namespace sm = seastar::metrics;
         _metrics.add_group("repair", {
@@ -196,6 +199,10 @@ struct row_level_repair_metrics {
                             sm::description("Total number of rows read from disk on this shard.")),
             sm::make_counter("row_from_disk_bytes", row_from_disk_bytes,
                             sm::description("Total bytes of rows read from disk on this shard.")),
+            sm::make_gauge("row_buf_size", row_buf_size,
+                            sm::description("Size of the row buffers of the last range this shard started to repair as master.")),
+            sm::make_gauge("peer_rtt_us", peer_rtt_us,
+                            sm::description("Average round trip time to the farthest peer of the ranges this shard repaired as master, in microseconds.")),
         });
     }
 };
@@ -743,6 +750,8 @@ class repair_meta {
     is_dirty_on_master _dirty_on_master = is_dirty_on_master::no;
     std::optional<shared_future<>> _stopped;
     repair_hasher _repair_hasher;
+    // Combines the repair_hash of all rows read from disk
+    repair_hash _read_rows_hash;
 public:
     std::vector<repair_node_state>& all_nodes() {
         return _all_node_states;
@@ -886,6 +895,58 @@ class repair_meta {
         return _stopped->get_future();
     }
 
+private:
+    replica::repair_range_summaries::key range_summary_key() const {
+        return {_range, _master_node_shard_config.shard, _master_node_shard_config.shard_count, _master_node_shard_config.ignore_msb};
+    }
+
+    // Node operations repair ranges to new replicas, only regular repairs
+    // use summaries.
+    std::chrono::seconds range_summaries_max_age() const {
+        if (_reason != streaming::stream_reason::repair) {
+            return std::chrono::seconds(0);
+        }
+        return std::chrono::seconds(_db.local().get_config().repair_range_summaries_max_age_in_s());
+    }
+
+public:
+    // Returns the summary of the range which all shards kept from the last
+    // repair which found it in sync, if any, and starts summarizing the
+    // range for this repair.
+    future<std::optional<repair_range_summary>> find_and_begin_range_summary() {
+        auto max_age = range_summaries_max_age();
+        if (max_age == std::chrono::seconds(0)) {
+            co_return std::nullopt;
+        }
+        std::vector<std::optional<repair_range_summary>> summaries(smp::count);
+        co_await _db.invoke_on_all([&summaries, id = _schema->id(), k = range_summary_key(), seed = _seed,
+                min_committed_at = gc_clock::now() - max_age] (replica::database& db) {
+            auto& range_summaries = db.find_column_family(id).get_repair_range_summaries();
+            summaries[this_shard_id()] = range_summaries.find(k, min_committed_at);
+            range_summaries.begin(k, seed);
+        });
+        if (std::adjacent_find(summaries.begin(), summaries.end(), std::not_equal_to<>()) != summaries.end()) {
+            co_return std::nullopt;
+        }
+        co_return summaries.front();
+    }
+
+    // Records that this repair found the range in sync on all nodes, after
+    // reading all its rows. Best effort.
+    future<> commit_range_summary() noexcept {
+        if (range_summaries_max_age() == std::chrono::seconds(0)) {
+            co_return;
+        }
+        try {
+            co_await _db.invoke_on_all([id = _schema->id(), k = range_summary_key(), seed = _seed, hash = _read_rows_hash,
+                    now = gc_clock::now()] (replica::database& db) {
+                db.find_column_family(id).get_repair_range_summaries().commit(k, seed, hash, now);
+            });
+        } catch (...) {
+            rlogger.debug("Failed to commit the summary of range={}: {}", _range, std::current_exception());
+        }
+    }
+
     void reset_peer_row_hash_sets() {
         if (_peer_row_hash_sets.size() != _nr_peer_nodes) {
             _peer_row_hash_sets.resize(_nr_peer_nodes);
@@ -1038,6 +1099,7 @@ class repair_meta {
             return stop_iteration::no;
         }
         auto hash = _repair_hasher.do_hash_for_mf(*_repair_reader.get_current_dk(), mf);
+        _read_rows_hash.add(hash);
         repair_row r(freeze(*_schema, mf), position_in_partition(mf.position()), _repair_reader.get_current_dk(), hash, is_dirty_on_master::no);
         rlogger.trace("Reading: r.boundary={}, r.hash={}", r.boundary(), r.hash());
         _metrics.row_from_disk_nr++;
@@ -1453,10 +1515,11 @@ class repair_meta {
     }
 
     // RPC API
-    future<>
+    // Returns the summary of the range the node kept, see find_and_begin_range_summary().
+    future<std::optional<repair_range_summary>>
     repair_row_level_start(gms::inet_address remote_node, sstring ks_name, sstring cf_name, dht::token_range range, table_schema_version schema_version, streaming::stream_reason reason) {
         if (remote_node == _myip) {
-            return make_ready_future<>();
+            return find_and_begin_range_summary();
         }
         stats().rpc_call_nr++;
         // Even though remote partitioner name is ignored in the current version of
@@ -1470,9 +1533,9 @@ class repair_meta {
                 _master_node_shard_config.shard, _master_node_shard_config.shard_count, _master_node_shard_config.ignore_msb,
                 remote_partitioner_name, std::move(schema_version), reason).then([ks_name, cf_name] (rpc::optional<repair_row_level_start_response> resp) {
             if (resp && resp->status == repair_row_level_start_status::no_such_column_family) {
-                return make_exception_future<>(replica::no_such_column_family(ks_name, cf_name));
+                return make_exception_future<std::optional<repair_range_summary>>(replica::no_such_column_family(ks_name, cf_name));
             } else {
-                return make_ready_future<>();
+                return make_ready_future<std::optional<repair_range_summary>>(resp ? resp->summary : std::nullopt);
             }
         });
     }
@@ -1484,31 +1547,39 @@ class repair_meta {
             uint64_t seed, shard_config master_node_shard_config, table_schema_version schema_version, streaming::stream_reason reason) {
         rlogger.debug(">>> Started Row Level Repair (Follower): local={}, peers={}, repair_meta_id={}, keyspace={}, cf={}, schema_version={}, range={}, seed={}, max_row_buf_siz={}",
             utils::fb_utilities::get_broadcast_address(), from, repair_meta_id, ks_name, cf_name, schema_version, range, seed, max_row_buf_size);
-        return repair.insert_repair_meta(from, src_cpu_id, repair_meta_id, std::move(range), algo, max_row_buf_size, seed, std::move(master_node_shard_config), std::move(schema_version), reason).then([] {
-            return repair_row_level_start_response{repair_row_level_start_status::ok};
+        return repair.insert_repair_meta(from, src_cpu_id, repair_meta_id, std::move(range), algo, max_row_buf_size, seed, std::move(master_node_shard_config), std::move(schema_version), reason).then([&repair, from, repair_meta_id] {
+            auto rm = repair.get_repair_meta(from, repair_meta_id);
+            return rm->find_and_begin_range_summary().finally([rm] {});
+        }).then([] (std::optional<repair_range_summary> summary) {
+            return repair_row_level_start_response{repair_row_level_start_status::ok, summary};
         }).handle_exception_type([] (replica::no_such_column_family&) {
             return repair_row_level_start_response{repair_row_level_start_status::no_such_column_family};
         });
     }
 
     // RPC API
-    future<> repair_row_level_stop(gms::inet_address remote_node, sstring ks_name, sstring cf_name, dht::token_range range) {
+    // synced tells the node that the repair found the range in sync.
+    future<> repair_row_level_stop(gms::inet_address remote_node, sstring ks_name, sstring cf_name, dht::token_range range, bool synced) {
         if (remote_node == _myip) {
-            return stop();
+            return stop().then([this, synced] {
+                return synced ? commit_range_summary() : make_ready_future<>();
+            });
         }
         stats().rpc_call_nr++;
         return _messaging.send_repair_row_level_stop(msg_addr(remote_node),
-                _repair_meta_id, std::move(ks_name), std::move(cf_name), std::move(range));
+                _repair_meta_id, std::move(ks_name), std::move(cf_name), std::move(range), synced);
     }
 
     // RPC handler
     static future<>
-    repair_row_level_stop_handler(repair_service& rs, gms::inet_address from, uint32_t repair_meta_id, sstring ks_name, sstring cf_name, dht::token_range range) {
-        rlogger.debug("<<< Finished Row Level Repair (Follower): local={}, peers={}, repair_meta_id={}, keyspace={}, cf={}, range={}",
-            utils::fb_utilities::get_broadcast_address(), from, repair_meta_id, ks_name, cf_name, range);
+    repair_row_level_stop_handler(repair_service& rs, gms::inet_address from, uint32_t repair_meta_id, sstring ks_name, sstring cf_name, dht::token_range range, bool synced) {
+        rlogger.debug("<<< Finished Row Level Repair (Follower): local={}, peers={}, repair_meta_id={}, keyspace={}, cf={}, range={}, synced={}",
+            utils::fb_utilities::get_broadcast_address(), from, repair_meta_id, ks_name, cf_name, range, synced);
         auto rm = rs.get_repair_meta(from, repair_meta_id);
         rm->set_repair_state_for_local_node(repair_state::row_level_stop_started);
-        return rs.remove_repair_meta(from, repair_meta_id, std::move(ks_name), std::move(cf_name), std::move(range)).then([rm] {
+        return rs.remove_repair_meta(from, repair_meta_id, std::move(ks_name), std::move(cf_name), std::move(range)).then([rm, synced] {
+            return synced ? rm->commit_range_summary() : make_ready_future<>();
+        }).then([rm] {
             rm->set_repair_state_for_local_node(repair_state::row_level_stop_finished);
         });
     }
@@ -2290,12 +2361,13 @@ future<> repair_service::init_ms_handlers() {
         });
     });
     ms.register_repair_row_level_stop([this] (const rpc::client_info& cinfo, uint32_t repair_meta_id,
-            sstring ks_name, sstring cf_name, dht::token_range range) {
+            sstring ks_name, sstring cf_name, dht::token_range range, rpc::optional<bool> synced_opt) {
         auto src_cpu_id = cinfo.retrieve_auxiliary<uint32_t>("src_cpu_id");
         auto from = cinfo.retrieve_auxiliary<gms::inet_address>("baddr");
-        return container().invoke_on(src_cpu_id % smp::count, [from, repair_meta_id, ks_name, cf_name, range] (repair_service& local_repair) mutable {
+        bool synced = synced_opt.value_or(false);
+        return container().invoke_on(src_cpu_id % smp::count, [from, repair_meta_id, ks_name, cf_name, range, synced] (repair_service& local_repair) mutable {
             return repair_meta::repair_row_level_stop_handler(local_repair, from, repair_meta_id,
-                    std::move(ks_name), std::move(cf_name), std::move(range));
+                    std::move(ks_name), std::move(cf_name), std::move(range), synced);
         });
     });
     ms.register_repair_get_estimated_partitions([this] (const rpc::client_info& cinfo, uint32_t repair_meta_id) {
@@ -2411,6 +2483,9 @@ class row_level_repair {
     // Sum of estimated_partitions on all peers
     uint64_t _estimated_partitions = 0;
 
+    // The bytes of rows already charged to the repair scheduler
+    uint64_t _throttled_bytes = 0;
+
     // A flag indicates any error during the repair
     bool _failed = false;
 
@@ -2451,9 +2526,18 @@ class row_level_repair {
         return sorted_nodes;
     }
 
-    size_t get_max_row_buf_size(row_level_diff_detect_algorithm algo) {
+    // Charges the rows read and transferred since the last call to the
+    // repair scheduler, waiting for their turn.
+    void throttle(repair_meta& master) {
+        auto& stats = master.stats();
+        auto bytes = stats.row_from_disk_bytes[master.myip()] + stats.tx_row_bytes + stats.rx_row_bytes;
+        _shard_task.rs.get_repair_module().scheduler().throttle(bytes - _throttled_bytes).get();
+        _throttled_bytes = bytes;
+    }
+
+    size_t get_max_row_buf_size(row_level_diff_detect_algorithm algo, size_t memory_budget) {
         // Max buffer size per repair round
-        return is_rpc_stream_supported(algo) ?  repair::task_manager_module::max_repair_memory_per_range : 256 * 1024;
+        return is_rpc_stream_supported(algo) ? _shard_task.buf_size_controller.size(memory_budget) : 256 * 1024;
     }
 
     // Step A: Negotiate sync boundary to use
@@ -2721,7 +2805,6 @@ class row_level_repair {
             _shard_task.check_in_abort_or_shutdown();
             auto repair_meta_id = _shard_task.rs.get_next_repair_meta_id().get0();
             auto algorithm = get_common_diff_detect_algorithm(_shard_task.messaging.local(), _all_live_peer_nodes);
-            auto max_row_buf_size = get_max_row_buf_size(algorithm);
             auto master_node_shard_config = shard_config {
                     this_shard_id(),
                     _shard_task.sharder.shard_count(),
@@ -2733,7 +2816,10 @@ class row_level_repair {
 
             auto& mem_sem = _shard_task.rs.memory_sem();
             auto max = _shard_task.rs.max_repair_memory();
-            auto wanted = (_all_live_peer_nodes.size() + 1) * repair::task_manager_module::max_repair_memory_per_range;
+            auto nr_nodes = _all_live_peer_nodes.size() + 1;
+            auto max_row_buf_size = get_max_row_buf_size(algorithm, max / nr_nodes);
+            _metrics.row_buf_size = max_row_buf_size;
+            auto wanted = nr_nodes * _shard_task.buf_size_controller.memory_for(max_row_buf_size);
             wanted = std::min(max, wanted);
             rlogger.trace("repair[{}]: Started to get memory budget, wanted={}, available={}, max_repair_memory={}",
                     _shard_task.global_repair_id.uuid(), wanted, mem_sem.current(), max);
@@ -2770,11 +2856,14 @@ class row_level_repair {
 
             std::vector<gms::inet_address> nodes_to_stop;
             nodes_to_stop.reserve(master.all_nodes().size());
+            std::vector<std::optional<repair_range_summary>> range_summaries(master.all_nodes().size());
+            bool unchanged = false;
             try {
                 parallel_for_each(master.all_nodes(), [&, this] (repair_node_state& ns) {
                     const auto& node = ns.node;
                     ns.state = repair_state::row_level_start_started;
-                    return master.repair_row_level_start(node, _shard_task.get_keyspace(), _cf_name, _range, schema_version, _shard_task.reason()).then([&] () {
+                    return master.repair_row_level_start(node, _shard_task.get_keyspace(), _cf_name, _range, schema_version, _shard_task.reason()).then([&] (std::optional<repair_range_summary> summary) {
+                        range_summaries[&ns - master.all_nodes().data()] = summary;
                         ns.state = repair_state::row_level_start_finished;
                         nodes_to_stop.push_back(node);
                         ns.state = repair_state::get_estimated_partitions_started;
@@ -2786,27 +2875,59 @@ class row_level_repair {
                     });
                 }).get();
 
-                parallel_for_each(master.all_nodes(), [&, this] (repair_node_state& ns) {
-                    const auto& node = ns.node;
-                    rlogger.trace("Get repair_set_estimated_partitions for node={}, estimated_partitions={}", node, _estimated_partitions);
-                    ns.state = repair_state::set_estimated_partitions_started;
-                    return master.repair_set_estimated_partitions(node, _estimated_partitions).then([&ns] {
-                        ns.state = repair_state::set_estimated_partitions_finished;
-                    });
-                }).get();
+                // All nodes kept the same summary of the range, so they
+                // found it in sync together, and none of them wrote to it
+                // since.
+                if (range_summaries.front() && std::adjacent_find(range_summaries.begin(), range_summaries.end(), std::not_equal_to<>()) == range_summaries.end()) {
+                    rlogger.debug("repair[{}]: Skipped range={} of keyspace={}, cf={}, unchanged since the repair with seed={} found it in sync",
+                            _shard_task.global_repair_id.uuid(), _range, _shard_task.get_keyspace(), _cf_name, range_summaries.front()->seed);
+                    master.stats().unchanged_range_nr++;
+                    unchanged = true;
+                }
 
-                while (true) {
-                    auto status = negotiate_sync_boundary(master);
-                    if (status == op_status::next_round) {
-                        continue;
-                    } else if (status == op_status::all_done) {
-                        break;
+                if (!unchanged) {
+                    // Followers do nothing but store the estimate, so this
+                    // takes a round trip to the farthest of them.
+                    auto rtt_start = row_buf_size_controller::clock_type::now();
+                    parallel_for_each(master.all_nodes(), [&, this] (repair_node_state& ns) {
+                        const auto& node = ns.node;
+                        rlogger.trace("Get repair_set_estimated_partitions for node={}, estimated_partitions={}", node, _estimated_partitions);
+                        ns.state = repair_state::set_estimated_partitions_started;
+                        return master.repair_set_estimated_partitions(node, _estimated_partitions).then([&ns] {
+                            ns.state = repair_state::set_estimated_partitions_finished;
+                        });
+                    }).get();
+                    auto& buf_size_controller = _shard_task.buf_size_controller;
+                    buf_size_controller.observe_rtt(row_buf_size_controller::clock_type::now() - rtt_start);
+                    _metrics.peer_rtt_us = buf_size_controller.rtt_seconds() * 1000000;
+
+                    auto sync_start = row_buf_size_controller::clock_type::now();
+
+                    while (true) {
+                        throttle(master);
+                        auto status = negotiate_sync_boundary(master);
+                        if (status == op_status::next_round) {
+                            continue;
+                        } else if (status == op_status::all_done) {
+                            break;
+                        }
+                        status = get_missing_rows_from_follower_nodes(master);
+                        if (status == op_status::next_round) {
+                            continue;
+                        }
+                        send_missing_rows_to_follower_nodes(master);
                     }
-                    status = get_missing_rows_from_follower_nodes(master);
-                    if (status == op_status::next_round) {
-                        continue;
+                    uint64_t bytes = 0;
+                    uint64_t rows = 0;
+                    for (auto& ns : master.all_nodes()) {
+                        bytes += master.stats().row_from_disk_bytes[ns.node];
+                        rows += master.stats().row_from_disk_nr[ns.node];
                     }
-                    send_missing_rows_to_follower_nodes(master);
+                    buf_size_controller.observe_range(bytes / nr_nodes, rows / nr_nodes, master.stats().round_nr,
+                            row_buf_size_controller::clock_type::now() - sync_start);
+                    rlogger.debug("repair[{}]: Synced range={} with row_buf_size={}, rounds={}, peer_rtt={}s, sync_rate={} bytes/s",
+                            _shard_task.global_repair_id.uuid(), _range, max_row_buf_size, master.stats().round_nr,
+                            buf_size_controller.rtt_seconds(), buf_size_controller.bytes_per_second());
                 }
             } catch (replica::no_such_column_family& e) {
                 table_dropped = true;
@@ -2820,9 +2941,12 @@ class row_level_repair {
                 _failed = true;
             }
 
+            // The range is in sync if no rows had to be sent, in which case
+            // the nodes keep a summary of what they read of it.
+            bool synced = !_failed && !unchanged && master.stats().round_nr_slow_path == 0;
             parallel_for_each(nodes_to_stop, [&] (const gms::inet_address& node) {
                 master.set_repair_state(repair_state::row_level_stop_started, node);
-                return master.repair_row_level_stop(node, _shard_task.get_keyspace(), _cf_name, _range).then([node, &master] {
+                return master.repair_row_level_stop(node, _shard_task.get_keyspace(), _cf_name, _range, synced).then([node, &master] {
                     master.set_repair_state(repair_state::row_level_stop_finished, node);
                 });
             }).get();
@@ -2843,15 +2967,44 @@ class row_level_repair {
     }
 };
 
+// Splits range into about parts ranges of the same width.
+static dht::token_range_vector split_range_evenly(const dht::token_range& range, unsigned parts) {
+    auto value = [] (const std::optional<dht::token_range::bound>& b, int64_t unbounded) {
+        return b && !b->value().is_minimum() && !b->value().is_maximum() ? b->value()._data : unbounded;
+    };
+    auto start = uint64_t(value(range.start(), std::numeric_limits<int64_t>::min()));
+    auto end = uint64_t(value(range.end(), std::numeric_limits<int64_t>::max()));
+    auto step = (end - start) / std::max(parts, 1U);
+    if (step == 0) {
+        return {range};
+    }
+    dht::token_range_vector ret;
+    ret.reserve(parts);
+    auto left = range.start();
+    for (unsigned i = 1; i < parts; ++i) {
+        auto t = dht::token(dht::token::kind::key, int64_t(start + step * i));
+        ret.push_back(dht::token_range(left, dht::token_range::bound(t, true)));
+        left = dht::token_range::bound(t, false);
+    }
+    ret.push_back(dht::token_range(left, range.end()));
+    return ret;
+}
+
 future<> repair_cf_range_row_level(repair::shard_repair_task_impl& shard_task,
         sstring cf_name, table_id table_id, dht::token_range range,
         const std::vector<gms::inet_address>& all_peer_nodes) {
-    return seastar::futurize_invoke([&shard_task, cf_name = std::move(cf_name), table_id = std::move(table_id), range = std::move(range), &all_peer_nodes] () mutable {
-        auto repair = row_level_repair(shard_task, std::move(cf_name), std::move(table_id), std::move(range), all_peer_nodes);
-        return do_with(std::move(repair), [] (row_level_repair& repair) {
-            return repair.run();
-        });
-    });
+    // When nodes keep summaries of the ranges repair found in sync, repair
+    // the range in parts, so that a write to one of them doesn't make the
+    // next repair read all the others again.
+    const auto& cfg = shard_task.db.local().get_config();
+    unsigned parts = 1;
+    if (shard_task.reason() == streaming::stream_reason::repair && cfg.repair_range_summaries_max_age_in_s()) {
+        parts = cfg.repair_range_summaries_subranges();
+    }
+    for (auto& r : split_range_evenly(range, parts)) {
+        auto repair = row_level_repair(shard_task, cf_name, table_id, std::move(r), all_peer_nodes);
+        co_await repair.run();
+    }
 }
 
 class row_level_repair_gossip_helper : public gms::i_endpoint_state_change_subscriber {
@@ -2934,6 +3087,7 @@ repair_service::repair_service(distributed<gms::gossiper>& gossiper,
     , _node_ops_metrics(_repair_module)
     , _max_repair_memory(max_repair_memory)
     , _memory_sem(max_repair_memory)
+    , _scheduler_timer([this] { adjust_scheduler(); })
 {
     tm.register_module("repair", _repair_module);
     if (this_shard_id() == 0) {
@@ -2945,9 +3099,12 @@ repair_service::repair_service(distributed<gms::gossiper>& gossiper,
 future<> repair_service::start() {
     co_await load_history();
     co_await init_ms_handlers();
+    adjust_scheduler();
+    _scheduler_timer.arm_periodic(std::chrono::seconds(1));
 }
 
 future<> repair_service::stop() {
+    _scheduler_timer.cancel();
     co_await _repair_module->stop();
     co_await uninit_ms_handlers();
     if (this_shard_id() == 0) {
@@ -2960,6 +3117,15 @@ repair_service::~repair_service() {
     assert(_stopped);
 }
 
+// Repair backs off while user reads queue for admission, as that is when
+// the reads it does itself slow them down the most.
+void repair_service::adjust_scheduler() noexcept {
+    auto& db = _db.local();
+    auto& scheduler = _repair_module->scheduler();
+    scheduler.set_rate(uint64_t(db.get_config().repair_throughput_mb_per_sec()) * 1024 * 1024 / smp::count);
+    scheduler.adjust(db.user_read_concurrency_semaphore().get_stats().waiters > 0);
+}
+
 static shard_id repair_id_to_shard(tasks::task_id& repair_id) {
     return shard_id(repair_id.uuid().get_most_significant_bits()) % smp::count;
 }
@@ -15,6 +15,7 @@
 #include "tasks/task_manager.hh"
 #include "locator/abstract_replication_strategy.hh"
 #include <seastar/core/distributed.hh>
+#include <seastar/core/timer.hh>
 #include <seastar/util/bool_class.hh>
 
 using namespace seastar;
@@ -105,6 +106,12 @@ class repair_service : public seastar::peering_sharded_service<repair_service> {
     size_t _max_repair_memory;
     seastar::semaphore _memory_sem;
 
+    // Feeds the repair scheduler with the foreground load and the
+    // configured throughput.
+    seastar::timer<lowres_clock> _scheduler_timer;
+
+    void adjust_scheduler() noexcept;
+
     future<> init_ms_handlers();
     future<> uninit_ms_handlers();
 
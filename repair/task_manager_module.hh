@@ -9,8 +9,12 @@
 #pragma once
 
 #include "repair/repair.hh"
+#include "repair/repair_scheduler.hh"
+#include "repair/row_buf_size_controller.hh"
 #include "tasks/task_manager.hh"
 
+#include <seastar/core/metrics_registration.hh>
+
 namespace repair {
 
 class repair_task_impl : public tasks::task_manager::task::impl {
@@ -120,6 +124,8 @@ class shard_repair_task_impl : public repair_task_impl {
     repair_stats _stats;
     std::unordered_set<sstring> dropped_tables;
     bool _hints_batchlog_flushed = false;
+    // Shared by the ranges this shard repairs as the master.
+    row_buf_size_controller buf_size_controller;
 public:
     shard_repair_task_impl(tasks::task_manager::module_ptr module,
             tasks::task_id id,
@@ -137,6 +143,7 @@ class shard_repair_task_impl : public repair_task_impl {
     virtual tasks::is_internal is_internal() const noexcept override {
         return tasks::is_internal::yes;
     }
+    virtual future<tasks::task_manager::task::progress> get_progress() const override;
     void check_failed_ranges();
     void check_in_abort_or_shutdown();
     repair_neighbors get_repair_neighbors(const dht::token_range& range);
@@ -159,7 +166,7 @@ class shard_repair_task_impl : public repair_task_impl {
 
     future<> repair_range(const dht::token_range& range, table_id);
 
-    size_t ranges_size();
+    size_t ranges_size() const noexcept;
 protected:
     future<> do_repair_ranges();
     future<> run() override;
@@ -181,9 +188,10 @@ class task_manager_module : public tasks::task_manager::module {
     std::unordered_map<int, tasks::task_id> _repairs;
     std::unordered_set<tasks::task_id> _pending_repairs;
     std::unordered_set<tasks::task_id> _aborted_pending_repairs;
-    // The semaphore used to control the maximum
-    // ranges that can be repaired in parallel.
-    named_semaphore _range_parallelism_semaphore;
+    // Controls the ranges which can be repaired in parallel, by all repairs
+    // of this shard.
+    repair_scheduler _scheduler;
+    seastar::metrics::metric_groups _metrics;
     seastar::condition_variable _done_cond;
     void start(repair_uniq_id id);
     void done(repair_uniq_id id, bool succeeded);
@@ -211,7 +219,9 @@ class task_manager_module : public tasks::task_manager::module {
     std::vector<int> get_active() const;
     size_t nr_running_repair_jobs();
     void abort_all_repairs();
-    named_semaphore& range_parallelism_semaphore();
+    repair_scheduler& scheduler() noexcept {
+        return _scheduler;
+    }
     future<> run(repair_uniq_id id, std::function<void ()> func);
     future<repair_status> repair_await_completion(int id, std::chrono::steady_clock::time_point timeout);
     float report_progress(streaming::stream_reason reason);
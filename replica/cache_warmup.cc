@@ -0,0 +1,248 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/core/byteorder.hh>
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/fstream.hh>
+#include <seastar/core/seastar.hh>
+#include <seastar/core/sleep.hh>
+#include <seastar/coroutine/exception.hh>
+#include <seastar/coroutine/maybe_yield.hh>
+#include <seastar/util/closeable.hh>
+#include <seastar/util/file.hh>
+
+#include <unordered_set>
+
+#include "replica/cache_warmup.hh"
+#include "replica/database.hh"
+#include "utils/disk-error-handler.hh"
+#include "utils/fragment_range.hh"
+#include "utils/lister.hh"
+#include "checked-file-impl.hh"
+#include "log.hh"
+
+namespace replica {
+
+static logging::logger cwlog("cache_warmup");
+
+// Keys are copied out of the cache in batches, to not stall the reactor.
+static constexpr size_t key_batch_size = 128;
+
+cache_warmup::cache_warmup(database& db, std::filesystem::path dir, std::chrono::seconds save_period, size_t keys_to_save)
+    : _db(db)
+    , _dir(std::move(dir))
+    , _save_period(save_period)
+    , _keys_to_save(keys_to_save ? keys_to_save : std::numeric_limits<size_t>::max())
+{
+}
+
+sstring cache_warmup::file_prefix(const schema& s) const {
+    return format("{}-{}-{}-RowCache-", s.ks_name(), s.cf_name(), s.id());
+}
+
+void cache_warmup::start() {
+    _done = with_scheduling_group(_db.get_streaming_scheduling_group(), [this] {
+        return run();
+    });
+}
+
+future<> cache_warmup::stop() {
+    _as.request_abort();
+    co_await std::exchange(_done, make_ready_future<>());
+}
+
+future<> cache_warmup::run() {
+    co_await load_all();
+    while (!_as.abort_requested()) {
+        try {
+            co_await sleep_abortable(_save_period, _as);
+        } catch (const sleep_aborted&) {
+            break;
+        }
+        co_await save_all();
+    }
+}
+
+future<> cache_warmup::load_all() {
+    std::vector<std::filesystem::path> files;
+    try {
+        co_await lister::scan_dir(_dir, lister::dir_entry_types::of<directory_entry_type::regular>(), [&files] (fs::path dir, directory_entry de) {
+            files.push_back(dir / de.name);
+            return make_ready_future<>();
+        });
+    } catch (...) {
+        // Nothing was saved yet.
+        cwlog.debug("Not loading saved cache keys from {}: {}", _dir, std::current_exception());
+        co_return;
+    }
+    for (auto& t : _db.get_non_system_column_families()) {
+        if (_as.abort_requested()) {
+            break;
+        }
+        if (t->cache_enabled()) {
+            co_await load(*t, files);
+        }
+    }
+}
+
+future<> cache_warmup::load(table& t, const std::vector<std::filesystem::path>& files) {
+    // Keeps the table from being stopped, if it's dropped, while it's read.
+    gate::holder holder;
+    try {
+        holder = t.async_gate().hold();
+    } catch (const gate_closed_exception&) {
+        co_return;
+    }
+    auto prefix = file_prefix(*t.schema());
+    for (auto& file : files) {
+        if (!file.filename().native().starts_with(prefix)) {
+            continue;
+        }
+        try {
+            co_await load_file(t, file);
+        } catch (...) {
+            cwlog.warn("Failed to load saved cache keys from {}: {}", file, std::current_exception());
+        }
+    }
+}
+
+future<> cache_warmup::load_file(table& t, std::filesystem::path file) {
+    auto s = t.schema();
+    auto buf = co_await seastar::util::read_entire_file_contiguous(file);
+    size_t pos = 0;
+    size_t loaded = 0;
+    while (pos < buf.size() && !_as.abort_requested()) {
+        if (buf.size() - pos < sizeof(uint32_t)) {
+            throw std::runtime_error(format("truncated key length at {}", pos));
+        }
+        auto len = read_be<uint32_t>(buf.data() + pos);
+        pos += sizeof(uint32_t);
+        if (buf.size() - pos < len) {
+            throw std::runtime_error(format("truncated key of {} bytes at {}", len, pos));
+        }
+        auto key = partition_key::from_bytes(bytes_view(reinterpret_cast<const int8_t*>(buf.data() + pos), len));
+        pos += len;
+        auto dk = dht::decorate_key(*s, std::move(key));
+        if (dht::shard_of(*s, dk.token()) != this_shard_id()) {
+            continue;
+        }
+        // Reading the partition through the table populates the cache with it.
+        auto permit = co_await _db.obtain_reader_permit(t, "cache_warmup", db::no_timeout, {});
+        auto range = dht::partition_range::make_singular(dk);
+        co_await with_closeable(t.make_reader_v2(s, std::move(permit), range), [] (flat_mutation_reader_v2& reader) {
+            return reader.consume_pausable([] (mutation_fragment_v2) {
+                return stop_iteration::no;
+            });
+        });
+        ++loaded;
+    }
+    cwlog.info("Loaded {} partitions of {}.{} into cache from {}", loaded, s->ks_name(), s->cf_name(), file);
+}
+
+future<> cache_warmup::save_all() {
+    try {
+        co_await io_check([this] { return recursive_touch_directory(_dir.native()); });
+    } catch (...) {
+        cwlog.warn("Failed to create {}, not saving cache keys: {}", _dir, std::current_exception());
+        co_return;
+    }
+    auto tables = _db.get_non_system_column_families();
+    for (auto& t : tables) {
+        if (_as.abort_requested()) {
+            break;
+        }
+        if (!t->cache_enabled()) {
+            continue;
+        }
+        try {
+            co_await save(*t);
+        } catch (...) {
+            cwlog.warn("Failed to save cache keys of {}.{}: {}", t->schema()->ks_name(), t->schema()->cf_name(), std::current_exception());
+        }
+    }
+    // All shards have the same tables, so one of them is enough to find the
+    // files of the dropped ones.
+    if (this_shard_id() == 0 && !_as.abort_requested()) {
+        co_await remove_orphaned_files(tables);
+    }
+}
+
+future<> cache_warmup::remove_orphaned_files(const std::vector<lw_shared_ptr<table>>& tables) {
+    std::unordered_set<sstring> prefixes;
+    for (auto& t : tables) {
+        prefixes.insert(file_prefix(*t->schema()));
+    }
+    static constexpr std::string_view suffix = "-RowCache-";
+    std::vector<std::filesystem::path> orphans;
+    try {
+        co_await lister::scan_dir(_dir, lister::dir_entry_types::of<directory_entry_type::regular>(), [&] (fs::path dir, directory_entry de) {
+            auto pos = de.name.find(suffix);
+            if (pos != sstring::npos && !prefixes.contains(de.name.substr(0, pos + suffix.size()))) {
+                orphans.push_back(dir / de.name);
+            }
+            return make_ready_future<>();
+        });
+        for (auto& file : orphans) {
+            co_await remove_file(file.native());
+            cwlog.info("Removed saved cache keys of a dropped table: {}", file);
+        }
+    } catch (...) {
+        cwlog.warn("Failed to remove saved cache keys of dropped tables from {}: {}", _dir, std::current_exception());
+    }
+}
+
+future<> cache_warmup::save(table& t) {
+    // Keeps the table from being stopped, if it's dropped, while it's saved.
+    gate::holder holder;
+    try {
+        holder = t.async_gate().hold();
+    } catch (const gate_closed_exception&) {
+        co_return;
+    }
+    auto s = t.schema();
+    auto file = _dir / format("{}{}.keys", file_prefix(*s), this_shard_id());
+    auto tmp_file = file;
+    tmp_file += ".tmp";
+
+    auto f = co_await open_checked_file_dma(general_disk_error_handler, tmp_file.native(), open_flags::wo | open_flags::create | open_flags::truncate);
+    auto out = co_await make_file_output_stream(std::move(f));
+    std::exception_ptr ex;
+    size_t saved = 0;
+    try {
+        std::optional<dht::decorated_key> last;
+        while (saved < _keys_to_save) {
+            auto keys = t.get_row_cache().get_keys(last, std::min(key_batch_size, _keys_to_save - saved));
+            if (keys.empty()) {
+                break;
+            }
+            for (auto& dk : keys) {
+                auto key = dk.key().representation();
+                char len[sizeof(uint32_t)];
+                write_be<uint32_t>(len, key.size());
+                co_await out.write(len, sizeof(len));
+                for (bytes_view frag : fragment_range(key)) {
+                    co_await out.write(reinterpret_cast<const char*>(frag.data()), frag.size());
+                }
+            }
+            saved += keys.size();
+            last = std::move(keys.back());
+            co_await coroutine::maybe_yield();
+        }
+        co_await out.flush();
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await out.close();
+    if (ex) {
+        co_await coroutine::return_exception_ptr(std::move(ex));
+    }
+    co_await rename_file(tmp_file.native(), file.native());
+    cwlog.debug("Saved {} partition keys of {}.{} to {}", saved, s->ks_name(), s->cf_name(), file);
+}
+
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+
+#include <seastar/core/abort_source.hh>
+#include <seastar/core/future.hh>
+#include <seastar/core/shared_ptr.hh>
+#include <seastar/core/sstring.hh>
+
+#include "schema/schema_fwd.hh"
+
+namespace replica {
+
+class database;
+class table;
+
+// Saves the keys of the partitions present in the row cache of each user table
+// every save_period, in saved_caches_directory, and reads them back into cache
+// on startup, so that restarted nodes don't serve reads from a cold cache.
+//
+// Each shard saves its own keys, to <ks>-<cf>-<table id>-RowCache-<shard>.keys,
+// and loads the keys it owns from the files of all shards, so that the keys
+// survive changes of the shard count. Both run in the streaming scheduling group.
+// The files of tables which no longer exist are removed when saving.
+class cache_warmup {
+    database& _db;
+    std::filesystem::path _dir;
+    std::chrono::seconds _save_period;
+    size_t _keys_to_save;
+    seastar::abort_source _as;
+    seastar::future<> _done = seastar::make_ready_future<>();
+private:
+    sstring file_prefix(const schema& s) const;
+    seastar::future<> run();
+    seastar::future<> load(table& t, const std::vector<std::filesystem::path>& files);
+    seastar::future<> load_file(table& t, std::filesystem::path file);
+    seastar::future<> save(table& t);
+    seastar::future<> remove_orphaned_files(const std::vector<seastar::lw_shared_ptr<table>>& tables);
+public:
+    // keys_to_save of 0 means all of them.
+    cache_warmup(database& db, std::filesystem::path dir, std::chrono::seconds save_period, size_t keys_to_save);
+
+    // Starts loading the saved keys in the background, then saving them periodically.
+    void start();
+    seastar::future<> stop();
+
+    seastar::future<> load_all();
+    seastar::future<> save_all();
+};
+
+}
@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <optional>
+
+#include "counters.hh"
+#include "dht/i_partitioner.hh"
+#include "keys.hh"
+#include "mutation/mutation.hh"
+#include "schema/schema.hh"
+#include "utils/hash.hh"
+#include "utils/two_choice_cache.hh"
+
+namespace replica {
+
+// Remembers the shard of this node of the counter cells it updated recently,
+// so that updating them again as the leader doesn't need to read their
+// current state first.
+//
+// A node's shard of a counter cell is only ever updated by the node itself,
+// as the leader of a counter update, and the updates of a cell are
+// serialized by the table's cell locker, so a remembered shard stays the
+// current one until its cell is updated again, which also updates it here.
+// The cache is cleared when the table is truncated and when its schema
+// changes, since column ids may change with it. Counters which were deleted
+// must not be updated again (see docs/cql/types.rst), so deletions don't
+// need to invalidate it.
+//
+// Holds up to a fixed number of cells, each of which can be in one of two
+// slots picked from the hash of the cell, see utils::two_choice_cache.
+// Inserting a cell when both slots are taken replaces the one used less
+// recently.
+class counter_shard_cache {
+public:
+    struct stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+    };
+private:
+    struct cell_key {
+        dht::decorated_key dk;
+        clustering_key_prefix ck; // Empty for static cells.
+        column_kind kind;
+        column_id id;
+    };
+    utils::two_choice_cache<cell_key, counter_shard, utils::two_choice_replacement::least_recently_used> _shards;
+    stats _stats;
+private:
+    static uint64_t hash_of(const schema& s, const dht::decorated_key& dk, const clustering_key_prefix& ck, column_kind kind, column_id id) {
+        size_t h = utils::hash_combine(clustering_key_prefix::hashing(s)(ck), uint64_t(dk.token().raw()));
+        return utils::hash_combine(uint64_t(id) << 1 | (kind == column_kind::static_column), h);
+    }
+
+    static auto key_equal(const schema& s, const dht::decorated_key& dk, const clustering_key_prefix& ck, column_kind kind, column_id id) {
+        return [&s, &dk, &ck, kind, id] (const cell_key& k) {
+            return k.id == id && k.kind == kind && k.dk.equal(s, dk) && clustering_key_prefix::equality(s)(k.ck, ck);
+        };
+    }
+
+    counter_shard* find(const schema& s, const dht::decorated_key& dk, const clustering_key_prefix& ck, column_kind kind, column_id id) {
+        auto e = _shards.find(hash_of(s, dk, ck, kind, id), key_equal(s, dk, ck, kind, id));
+        return e ? &e->value : nullptr;
+    }
+
+    void insert(const schema& s, const dht::decorated_key& dk, const clustering_key_prefix& ck, column_kind kind, column_id id, counter_shard shard) {
+        _shards.insert(hash_of(s, dk, ck, kind, id), key_equal(s, dk, ck, kind, id), cell_key{dk, ck, kind, id}, std::move(shard));
+    }
+
+    void erase(const schema& s, const dht::decorated_key& dk, const clustering_key_prefix& ck, column_kind kind, column_id id) noexcept {
+        if (!_shards.size()) {
+            return;
+        }
+        _shards.erase(hash_of(s, dk, ck, kind, id), key_equal(s, dk, ck, kind, id));
+    }
+
+    template <typename Func>
+    static void for_each_update_cell(const mutation& m, Func&& func) {
+        const auto& s = *m.schema();
+        const auto static_ck = clustering_key_prefix::make_empty();
+        m.partition().static_row().for_each_cell([&] (column_id id, const atomic_cell_or_collection& c) {
+            func(static_ck, column_kind::static_column, s.static_column_at(id), id, c);
+        });
+        for (const auto& cr : m.partition().clustered_rows()) {
+            cr.row().cells().for_each_cell([&] (column_id id, const atomic_cell_or_collection& c) {
+                func(cr.key(), column_kind::regular_column, s.regular_column_at(id), id, c);
+            });
+        }
+    }
+public:
+    // capacity is rounded up to a power of two, 0 disables the cache.
+    explicit counter_shard_cache(size_t capacity) noexcept
+        : _shards(capacity)
+    { }
+
+    bool enabled() const noexcept {
+        return _shards.enabled();
+    }
+
+    // Returns the current state of the cells updated by the counter update m,
+    // as transform_counter_updates_to_shards() expects it, if the shard of
+    // this node of all of them is known. Cells whose shard is known hold
+    // only that shard.
+    std::optional<mutation> get_current_state(const mutation& m) {
+        if (!_shards.size() || m.partition().partition_tombstone() || !m.partition().row_tombstones().empty()) {
+            ++_stats.misses;
+            return std::nullopt;
+        }
+        const auto& s = *m.schema();
+        mutation state(m.schema(), m.decorated_key());
+        bool found = true;
+        for_each_update_cell(m, [&] (const clustering_key_prefix& ck, column_kind kind, const column_definition& cdef, column_id id, const atomic_cell_or_collection& c) {
+            if (!found) {
+                return;
+            }
+            auto shard = find(s, m.decorated_key(), ck, kind, id);
+            if (!shard || !c.as_atomic_cell(cdef).is_live()) {
+                found = false;
+                return;
+            }
+            auto cell = counter_cell_builder::from_single_shard(api::min_timestamp, *shard);
+            if (kind == column_kind::static_column) {
+                state.set_static_cell(cdef, std::move(cell));
+            } else {
+                state.set_clustered_cell(ck, cdef, std::move(cell));
+            }
+        });
+        if (!found) {
+            ++_stats.misses;
+            return std::nullopt;
+        }
+        ++_stats.hits;
+        return state;
+    }
+
+    // Remembers the shards of this node of the cells of m, a counter update
+    // transformed to shards and applied.
+    // Best effort, the shards are forgotten if memory can't be allocated.
+    void update(const mutation& m, counter_id local_id) noexcept {
+        if (!enabled()) {
+            return;
+        }
+        const auto& s = *m.schema();
+        for_each_update_cell(m, [&] (const clustering_key_prefix& ck, column_kind kind, const column_definition& cdef, column_id id, const atomic_cell_or_collection& c) {
+            try {
+                auto acv = c.as_atomic_cell(cdef);
+                std::optional<counter_shard_view> shard;
+                if (acv.is_live()) {
+                    shard = counter_cell_view(acv).get_shard(local_id);
+                }
+                if (shard) {
+                    insert(s, m.decorated_key(), ck, kind, id, counter_shard(*shard));
+                } else {
+                    erase(s, m.decorated_key(), ck, kind, id);
+                }
+            } catch (...) {
+                erase(s, m.decorated_key(), ck, kind, id);
+            }
+        });
+    }
+
+    // Forgets the cells of m, a counter update which may or may not have
+    // been applied.
+    void invalidate(const mutation& m) noexcept {
+        const auto& s = *m.schema();
+        for_each_update_cell(m, [&] (const clustering_key_prefix& ck, column_kind kind, const column_definition&, column_id id, const atomic_cell_or_collection&) {
+            erase(s, m.decorated_key(), ck, kind, id);
+        });
+    }
+
+    void clear() noexcept {
+        _shards.clear();
+    }
+
+    size_t size() const noexcept {
+        return _shards.size();
+    }
+
+    const stats& get_stats() const noexcept {
+        return _stats;
+    }
+};
+
+}
@@ -317,7 +317,8 @@ database::database(const db::config& cfg, database_config dbcfg, service::migrat
     , _cfg(cfg)
     // Allow system tables a pool of 10 MB memory to write, but never block on other regions.
     , _system_dirty_memory_manager(*this, 10 << 20, cfg.unspooled_dirty_soft_limit(), default_scheduling_group())
-    , _dirty_memory_manager(*this, dbcfg.available_memory * 0.50, cfg.unspooled_dirty_soft_limit(), dbcfg.statement_scheduling_group)
+    , _dirty_memory_manager(*this, dbcfg.available_memory * 0.50, cfg.unspooled_dirty_soft_limit(), dbcfg.statement_scheduling_group,
+            cfg.unspooled_dirty_max_write_delay_in_ms)
     , _dbcfg(dbcfg)
     , _flush_sg(backlog_controller::scheduling_group{dbcfg.memtable_scheduling_group, service::get_local_memtable_flush_priority()})
     , _memtable_controller(make_flush_controller(_cfg, _flush_sg, [this, limit = float(_dirty_memory_manager.throttle_threshold())] {
@@ -353,6 +354,7 @@ database::database(const db::config& cfg, database_config dbcfg, service::migrat
             utils::updateable_value(std::numeric_limits<uint32_t>::max()),
             utils::updateable_value(std::numeric_limits<uint32_t>::max()))
     , _row_cache_tracker(cache_tracker::register_metrics::yes)
+    , _result_cache_budget(dbcfg.available_memory * cfg.query_result_cache_memory_fraction())
     , _apply_stage("db_apply", &database::do_apply)
     , _version(empty_version)
     , _compaction_manager(cm)
@@ -382,6 +384,15 @@ database::database(const db::config& cfg, database_config dbcfg, service::migrat
     setup_metrics();
 
     _row_cache_tracker.set_compaction_scheduling_group(dbcfg.memory_compaction_scheduling_group);
+    _row_cache_tracker.set_pack_rows(_cfg.cache_pack_narrow_rows());
+    _row_cache_tracker.set_admission_filter(_cfg.cache_admission_filter());
+    _row_cache_tracker.set_absent_partitions_per_cache(_cfg.cache_absent_partitions_per_table());
+    _querier_cache.set_prefetch(_cfg.querier_cache_prefetch());
+    _read_concurrency_sem.set_scan_cost_limit(_cfg.reader_concurrency_semaphore_scan_cost_limit);
+    if (_cfg.hot_partitions_capacity()) {
+        _hot_partitions = std::make_unique<db::hot_partitions_data_listener>(*this, _cfg.hot_partitions_capacity(),
+                std::chrono::seconds(std::max(_cfg.hot_partitions_window_in_s(), 1u)));
+    }
 
     setup_scylla_memory_diagnostics_producer();
     if (_dbcfg.sstables_format) {
@@ -410,6 +421,7 @@ void backlog_controller::adjust() {
     }
 
     auto backlog = _current_backlog();
+    _last_backlog = backlog;
 
     if (backlog >= _control_points.back().input) {
         update_controller(_control_points.back().output);
@@ -449,6 +461,7 @@ float backlog_controller::backlog_of_shares(float shares) const {
 }
 
 void backlog_controller::update_controller(float shares) {
+    _last_shares = shares;
     _scheduling_group.cpu.set_shares(shares);
     if (!_inflight_update.available()) {
         return; // next timer will fix it
@@ -460,6 +473,7 @@ void backlog_controller::update_controller(float shares) {
 namespace replica {
 
 static const metrics::label class_label("class");
+static const metrics::label lane_label("lane");
 
 void
 database::setup_metrics() {
@@ -581,6 +595,12 @@ database::setup_metrics() {
         sm::make_gauge("querier_cache_population", _querier_cache.get_stats().population,
                        sm::description("The number of entries currently in the querier cache.")),
 
+        sm::make_counter("querier_cache_prefetches", _querier_cache.get_stats().prefetches,
+                       sm::description("Counts cached queriers which started reading the next page ahead of its request.")),
+
+        sm::make_gauge("query_result_cache_bytes", [this] { return _result_cache_budget.used(); },
+                       sm::description("Memory used by the results which tables with results_ttl_in_ms remember.")),
+
         sm::make_counter("sstable_read_queue_overloads", _read_concurrency_sem.get_stats().total_reads_shed_due_to_overload,
                        sm::description("Counts the number of times the sstable read queue was overloaded. "
                                        "A non-zero value indicates that we have to drop read requests because they arrive faster than we can serve them.")),
@@ -610,6 +630,15 @@ database::setup_metrics() {
                                        " to be able to admit new ones, if there is a shortage of permits."),
                        {user_label_instance}),
 
+        sm::make_counter("paused_reads_permit_based_evictions_sstables", _read_concurrency_sem.get_stats().permit_based_evictions_sstables,
+                       sm::description("The number of sstable readers discarded by evicting paused reads to free up permits."
+                                       " These have to be recreated, looking up their position in the index, when the read is resumed."),
+                       {user_label_instance}),
+
+        sm::make_counter("paused_reads_permit_based_evictions_memory", _read_concurrency_sem.get_stats().permit_based_evictions_memory,
+                       sm::description("The amount of memory, mostly buffered data, discarded by evicting paused reads to free up permits."),
+                       {user_label_instance}),
+
         sm::make_counter("reads_shed_due_to_overload", _read_concurrency_sem.get_stats().total_reads_shed_due_to_overload,
                        sm::description("The number of reads shed because the admission queue reached its max capacity."
                                        " When the queue is full, excessive reads are shed to avoid overload."),
@@ -623,6 +652,33 @@ database::setup_metrics() {
                        sm::description("Holds the number of currently read sstables. "),
                        {user_label_instance}),
 
+        sm::make_gauge("scan_cost", [this] { return _read_concurrency_sem.get_stats().scan_cost; },
+                       sm::description("Holds the number of sstables predicted to be read by the currently admitted scans. "
+                                       "Scans are queued when this reaches reader_concurrency_semaphore_scan_cost_limit."),
+                       {user_label_instance}),
+
+        sm::make_counter("reads_queued_because_scan_cost", _read_concurrency_sem.get_stats().reads_queued_because_scan_cost,
+                       sm::description("The number of scans queued because the admitted scans reached the scan cost limit."),
+                       {user_label_instance}),
+
+        sm::make_counter("reads_admitted_from_queue", _read_concurrency_sem.get_stats().point_reads_admitted_from_queue,
+                       sm::description("The number of reads admitted after waiting in the admission queue, per admission lane."),
+                       {user_label_instance, lane_label("point")}),
+
+        sm::make_counter("reads_admitted_from_queue", _read_concurrency_sem.get_stats().scan_reads_admitted_from_queue,
+                       sm::description("The number of reads admitted after waiting in the admission queue, per admission lane."),
+                       {user_label_instance, lane_label("scan")}),
+
+        sm::make_counter("reads_queue_time_us", _read_concurrency_sem.get_stats().point_reads_queue_time_us,
+                       sm::description("The total time, in microseconds, spent in the admission queue by the reads admitted from it, per admission lane. "
+                                       "Divide by reads_admitted_from_queue to get the mean queue latency."),
+                       {user_label_instance, lane_label("point")}),
+
+        sm::make_counter("reads_queue_time_us", _read_concurrency_sem.get_stats().scan_reads_queue_time_us,
+                       sm::description("The total time, in microseconds, spent in the admission queue by the reads admitted from it, per admission lane. "
+                                       "Divide by reads_admitted_from_queue to get the mean queue latency."),
+                       {user_label_instance, lane_label("scan")}),
+
         sm::make_gauge("active_reads", [this] { return _streaming_concurrency_sem.active_reads(); },
                        sm::description("Holds the number of currently active read operations issued on behalf of streaming "),
                        {streaming_label_instance}),
@@ -1240,6 +1296,7 @@ keyspace::make_column_family_config(const schema& s, const database& db) const {
     cfg.enable_disk_writes = _config.enable_disk_writes;
     cfg.enable_commitlog = _config.enable_commitlog;
     cfg.enable_cache = _config.enable_cache;
+    cfg.cache_only = _config.cache_only;
     cfg.enable_dangerous_direct_import_of_cassandra_counters = _config.enable_dangerous_direct_import_of_cassandra_counters;
     cfg.compaction_enforce_min_threshold = _config.compaction_enforce_min_threshold;
     cfg.dirty_memory_manager = _config.dirty_memory_manager;
@@ -1256,11 +1313,26 @@ keyspace::make_column_family_config(const schema& s, const database& db) const {
     cfg.enable_metrics_reporting = db_config.enable_keyspace_column_family_metrics();
     cfg.reversed_reads_auto_bypass_cache = db_config.reversed_reads_auto_bypass_cache;
     cfg.enable_optimized_reversed_reads = db_config.enable_optimized_reversed_reads;
+    cfg.multi_partition_read_ahead = db_config.multi_partition_read_ahead;
+    cfg.tombstone_compaction_read_threshold = db_config.tombstone_compaction_read_threshold;
     cfg.tombstone_warn_threshold = db_config.tombstone_warn_threshold();
+    cfg.partition_digest_cache_entries = db_config.partition_digest_cache_entries_per_table();
+    cfg.counter_shard_cache_entries = db_config.counter_shard_cache_entries_per_table();
+    cfg.result_cache_budget = &_result_cache_budget;
+    cfg.memtable_flush_writers = db_config.memtable_flush_writers;
+    cfg.memtable_flush_compaction = db_config.memtable_flush_compaction;
     cfg.view_update_concurrency_semaphore = _config.view_update_concurrency_semaphore;
     cfg.view_update_concurrency_semaphore_limit = _config.view_update_concurrency_semaphore_limit;
     cfg.data_listeners = &db.data_listeners();
     cfg.x_log2_compaction_groups = db_config.x_log2_compaction_groups();
+    if (_metadata->get_storage_options().is_local_type() && !db_config.cold_storage_endpoint().empty() && !db_config.cold_storage_bucket().empty()) {
+        data_dictionary::storage_options cold;
+        cold.value = data_dictionary::storage_options::s3{
+            .bucket = db_config.cold_storage_bucket(),
+            .endpoint = db_config.cold_storage_endpoint(),
+        };
+        cfg.cold_storage_opts = make_lw_shared<const data_dictionary::storage_options>(std::move(cold));
+    }
 
     return cfg;
 }
@@ -1523,7 +1595,8 @@ database::query(schema_ptr s, const query::read_command& cmd, query::result_opti
             querier_opt->permit().set_trace_state(trace_state);
             f = co_await coroutine::as_future(semaphore.with_ready_permit(querier_opt->permit(), read_func));
         } else {
-            f = co_await coroutine::as_future(semaphore.with_permit(s.get(), "data-query", cf.estimate_read_memory_cost(), timeout, trace_state, read_func));
+            f = co_await coroutine::as_future(semaphore.with_permit(s.get(), "data-query", cf.estimate_read_memory_cost(), cf.estimate_read_cost(cmd, ranges),
+                    timeout, trace_state, read_func));
         }
 
         if (!f.failed()) {
@@ -1590,7 +1663,8 @@ database::query_mutations(schema_ptr s, const query::read_command& cmd, const dh
             querier_opt->permit().set_trace_state(trace_state);
             f = co_await coroutine::as_future(semaphore.with_ready_permit(querier_opt->permit(), read_func));
         } else {
-            f = co_await coroutine::as_future(semaphore.with_permit(s.get(), "mutation-query", cf.estimate_read_memory_cost(), timeout, trace_state, read_func));
+            f = co_await coroutine::as_future(semaphore.with_permit(s.get(), "mutation-query", cf.estimate_read_memory_cost(),
+                    cf.estimate_read_cost(cmd, std::span(&range, 1)), timeout, trace_state, read_func));
         }
 
         if (!f.failed()) {
@@ -1703,18 +1777,37 @@ future<mutation> database::do_apply_counter_update(column_family& cf, const froz
             // deltas to counter shards. To do that, we need to read the current
             // counter state for each modified cell...
 
-            tracing::trace(trace_state, "Reading counter values from the CF");
-            auto permit = get_reader_concurrency_semaphore().make_tracking_only_permit(m_schema.get(), "counter-read-before-write", timeout, trace_state);
-            return counter_write_query(m_schema, cf.as_mutation_source(), std::move(permit), m.decorated_key(), slice, trace_state)
-                    .then([this, &cf, &m, m_schema, timeout, trace_state] (auto mopt) {
+            // ...unless this node updated all of them recently, and so knows
+            // its own shard of each of them, which is the only one needed.
+            auto& shard_cache = cf.get_counter_shard_cache();
+            auto read_state = [&] () -> future<mutation_opt> {
+                if (shard_cache.enabled()) {
+                    if (auto state = shard_cache.get_current_state(m)) {
+                        tracing::trace(trace_state, "Counter values found in the counter shard cache");
+                        return make_ready_future<mutation_opt>(std::move(state));
+                    }
+                }
+                tracing::trace(trace_state, "Reading counter values from the CF");
+                auto permit = get_reader_concurrency_semaphore().make_tracking_only_permit(m_schema.get(), "counter-read-before-write", timeout, trace_state);
+                return counter_write_query(m_schema, cf.as_mutation_source(), std::move(permit), m.decorated_key(), slice, trace_state);
+            };
+            return read_state().then([this, &cf, &m, m_schema, timeout, trace_state] (auto mopt) {
                 // ...now, that we got existing state of all affected counter
                 // cells we can look for our shard in each of them, increment
                 // its clock and apply the delta.
                 transform_counter_updates_to_shards(m, mopt ? &*mopt : nullptr, cf.failed_counter_applies_to_memtable(), _cfg.host_id);
                 tracing::trace(trace_state, "Applying counter update");
                 return this->apply_with_commitlog(cf, m, timeout);
-            }).then([&m] {
-                return std::move(m);
+            }).then_wrapped([this, &cf, &m] (future<> f) {
+                // Still holding the cell locks.
+                auto& shard_cache = cf.get_counter_shard_cache();
+                if (f.failed()) {
+                    // The update may or may not have been applied.
+                    shard_cache.invalidate(m);
+                    return make_exception_future<mutation>(f.get_exception());
+                }
+                shard_cache.update(m, counter_id(_cfg.host_id.uuid()));
+                return make_ready_future<mutation>(std::move(m));
             });
         });
     });
@@ -1863,6 +1956,7 @@ future<> database::do_apply_many(const std::vector<frozen_mutation>& muts, db::t
     std::vector<commitlog_entry_writer> writers;
     db::commitlog* cl = nullptr;
     std::optional<shard_id> shard;
+    bool durable = false;
 
     if (muts.empty()) {
         co_return;
@@ -1895,13 +1989,21 @@ future<> database::do_apply_many(const std::vector<frozen_mutation>& muts, db::t
 
         dblog.trace("apply [{}/{}]: {}", i, muts.size() - 1, muts[i].pretty_printer(s));
         writers.emplace_back(s, muts[i], commitlog_entry_writer::force_sync::yes);
+        durable |= cf.durable_writes();
     }
 
     if (!cl) {
         on_internal_error(dblog, "Cannot apply atomically without commitlog");
     }
 
-    std::vector<rp_handle> handles = co_await cl->add_entries(std::move(writers), timeout);
+    // Like do_apply(), don't wait for the commitlog when none of the tables
+    // need their writes to survive a crash.
+    std::vector<rp_handle> handles;
+    if (durable) {
+        handles = co_await cl->add_entries(std::move(writers), timeout);
+    } else {
+        handles.resize(muts.size());
+    }
 
     // FIXME: Memtable application is not atomic so reads may observe mutations partially applied until restart.
     for (size_t i = 0; i < muts.size(); ++i) {
@@ -2067,6 +2169,14 @@ database::make_keyspace_config(const keyspace_metadata& ksm) {
         cfg.enable_commitlog = false;
         cfg.enable_cache = false;
     }
+    // The keyspaces of the Redis frontend, REDIS_0, REDIS_1, ..., may be kept
+    // as a replicated cache, with no commitlog and no sstables.
+    if (_cfg.redis_in_memory_tables() && ksm.name().starts_with("REDIS_")) {
+        cfg.enable_disk_writes = false;
+        cfg.enable_commitlog = false;
+        cfg.enable_cache = true;
+        cfg.cache_only = true;
+    }
     cfg.enable_dangerous_direct_import_of_cassandra_counters = _cfg.enable_dangerous_direct_import_of_cassandra_counters();
     cfg.compaction_enforce_min_threshold = _cfg.compaction_enforce_min_threshold;
     cfg.dirty_memory_manager = &_dirty_memory_manager;
@@ -2174,7 +2284,7 @@ future<> database::close_tables(table_kind kind_to_close) {
         auto& s = val_pair.second->schema();
         table_kind k = is_system_table(*s) || _cfg.extensions().is_extension_internal_keyspace(s->ks_name()) ? table_kind::system : table_kind::user;
         if (k == kind_to_close) {
-            co_await val_pair.second->stop();
+            co_await val_pair.second->stop(table::save_sstable_owners::yes);
         }
     });
     co_await _stop_barrier.arrive_and_wait();
@@ -2190,15 +2300,31 @@ future<> database::start() {
     _large_data_handler->start();
     // We need the compaction manager ready early so we can reshard.
     _compaction_manager.enable();
+    _compaction_manager.plug_flushed_bytes_source([this] {
+        return _dirty_memory_manager.flushed_bytes() + _system_dirty_memory_manager.flushed_bytes();
+    });
     co_await init_commitlog();
 }
 
+void database::start_cache_warmup() {
+    if (!_cfg.row_cache_save_period() || _cfg.saved_caches_directory().empty()) {
+        return;
+    }
+    _cache_warmup.emplace(*this, std::filesystem::path(_cfg.saved_caches_directory()),
+            std::chrono::seconds(_cfg.row_cache_save_period()), _cfg.row_cache_keys_to_save());
+    _cache_warmup->start();
+}
+
 future<> database::shutdown() {
     _shutdown = true;
     auto b = defer([this] { _stop_barrier.abort(); });
     co_await _stop_barrier.arrive_and_wait();
     b.cancel();
 
+    if (_cache_warmup) {
+        co_await _cache_warmup->stop();
+    }
+
     // Closing a table can cause us to find a large partition. Since we want to record that, we have to close
     // system.large_partitions after the regular tables.
     co_await close_tables(database::table_kind::user);
@@ -2240,6 +2366,7 @@ future<> database::stop() {
     dblog.info("Shutting down system dirty memory manager");
     co_await _system_dirty_memory_manager.shutdown();
     dblog.info("Shutting down dirty memory manager");
+    _compaction_manager.unplug_flushed_bytes_source();
     co_await _dirty_memory_manager.shutdown();
     dblog.info("Shutting down memtable controller");
     co_await _memtable_controller.shutdown();
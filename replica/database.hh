@@ -23,6 +23,7 @@
 #include <unordered_map>
 #include <map>
 #include <set>
+#include <span>
 #include <boost/functional/hash.hpp>
 #include <boost/range/algorithm/find.hpp>
 #include <optional>
@@ -58,6 +59,11 @@
 #include "data_dictionary/keyspace_metadata.hh"
 #include "data_dictionary/data_dictionary.hh"
 #include "absl-flat_hash_map.hh"
+#include "replica/cache_warmup.hh"
+#include "replica/partition_digest_cache.hh"
+#include "replica/counter_shard_cache.hh"
+#include "replica/repair_range_summaries.hh"
+#include "replica/query_result_cache.hh"
 #include "utils/cross-shard-barrier.hh"
 #include "sstables/generation_type.hh"
 #include "db/rate_limiter.hh"
@@ -113,6 +119,7 @@ class config;
 class extensions;
 class rp_handle;
 class data_listeners;
+class hot_partitions_data_listener;
 class large_data_handler;
 class system_keyspace;
 class table_selector;
@@ -331,6 +338,11 @@ struct table_stats {
     int64_t live_sstable_count = 0;
     /** Estimated number of compactions pending for this column family */
     int64_t pending_compactions = 0;
+    /** Bytes of the sstables written by memtable flushes. */
+    int64_t memtable_flushed_bytes = 0;
+    /** Bytes of the sstables replaced by compactions, and of the ones they wrote. */
+    int64_t compaction_bytes_read = 0;
+    int64_t compaction_bytes_written = 0;
     int64_t memtable_partition_insertions = 0;
     int64_t memtable_partition_hits = 0;
     int64_t memtable_range_tombstone_reads = 0;
@@ -344,7 +356,10 @@ struct table_stats {
     utils::estimated_histogram estimated_sstable_per_read{35};
     utils::timed_rate_moving_average_and_histogram tombstone_scanned;
     utils::timed_rate_moving_average_and_histogram live_scanned;
-    utils::estimated_histogram estimated_coordinator_read;
+    utils::latency_histogram estimated_coordinator_read;
+    int64_t digest_cache_hits = 0;
+    int64_t result_cache_hits = 0;
+    int64_t filtered_reads_skipped = 0;
 };
 
 using storage_options = data_dictionary::storage_options;
@@ -358,9 +373,16 @@ class table : public enable_lw_shared_from_this<table> {
         bool enable_disk_reads = true;
         bool enable_cache = true;
         bool enable_commitlog = true;
+        // Keep the data in memory only: sealed memtables are moved into the
+        // cache instead of being written to sstables, and whatever the cache
+        // evicts is gone. Used with enable_disk_writes == false.
+        bool cache_only = false;
         bool enable_incremental_backups = false;
         utils::updateable_value<bool> compaction_enforce_min_threshold{false};
         bool enable_dangerous_direct_import_of_cassandra_counters = false;
+        // Where compaction moves the sstables which the compaction strategy finds cold.
+        // Null when cold storage isn't configured.
+        lw_shared_ptr<const storage_options> cold_storage_opts;
         replica::dirty_memory_manager* dirty_memory_manager = &default_dirty_memory_manager;
         reader_concurrency_semaphore* streaming_read_concurrency_semaphore;
         reader_concurrency_semaphore* compaction_concurrency_semaphore;
@@ -379,8 +401,18 @@ class table : public enable_lw_shared_from_this<table> {
         // for easy access from `table` member functions:
         utils::updateable_value<bool> reversed_reads_auto_bypass_cache{false};
         utils::updateable_value<bool> enable_optimized_reversed_reads{true};
+        utils::updateable_value<uint32_t> multi_partition_read_ahead{0};
+        utils::updateable_value<uint32_t> tombstone_compaction_read_threshold{0};
         uint32_t tombstone_warn_threshold{0};
         unsigned x_log2_compaction_groups{0};
+        utils::updateable_value<uint32_t> memtable_flush_writers{1};
+        utils::updateable_value<bool> memtable_flush_compaction{false};
+        // Capacity of the table's partition_digest_cache, 0 disables it.
+        size_t partition_digest_cache_entries = 0;
+        // Capacity of the table's counter_shard_cache, 0 disables it.
+        size_t counter_shard_cache_entries = 0;
+        // Memory shared by the query_result_caches of the shard, which are disabled without it.
+        query_result_cache_budget* result_cache_budget = nullptr;
     };
     struct no_commitlog {};
 
@@ -443,6 +475,11 @@ class table : public enable_lw_shared_from_this<table> {
     std::vector<view_ptr> _views;
 
     std::unique_ptr<cell_locker> _counter_cell_locks; // Memory-intensive; allocate only when needed.
+    // Shards of this node of the counter cells recently updated through
+    // this table, see do_apply_counter_update().
+    counter_shard_cache _counter_shard_cache;
+    // Ranges which the last repair found in sync and weren't written since.
+    repair_range_summaries _repair_range_summaries;
 
     // Labels used to identify writes and reads for this table in the rate_limiter structure.
     db::rate_limiter::label _rate_limiter_label_for_writes;
@@ -470,7 +507,7 @@ class table : public enable_lw_shared_from_this<table> {
 
     double _cached_percentile = -1;
     lowres_clock::time_point _percentile_cache_timestamp;
-    std::chrono::milliseconds _percentile_cache_value;
+    std::chrono::microseconds _percentile_cache_value;
 
     // Phaser used to synchronize with in-progress writes. This is useful for code that,
     // after some modification, needs to ensure that news writes will see it before
@@ -498,6 +535,11 @@ class table : public enable_lw_shared_from_this<table> {
     future<> add_sstables_and_update_cache(const std::vector<sstables::shared_sstable>& ssts);
     future<> move_sstables_from_staging(std::vector<sstables::shared_sstable>);
     sstables::shared_sstable make_sstable();
+    // Makes an sstable on cold storage, which must be configured.
+    sstables::shared_sstable make_cold_sstable();
+    bool has_cold_storage() const noexcept {
+        return bool(_config.cold_storage_opts);
+    }
     void cache_truncation_record(db_clock::time_point truncated_at) {
         _truncated_at = truncated_at;
     }
@@ -548,6 +590,7 @@ class table : public enable_lw_shared_from_this<table> {
         return _config.enable_cache && _schema->caching_options().enabled();
     }
     void update_stats_for_new_sstable(const sstables::shared_sstable& sst) noexcept;
+    void update_stats_for_compaction(const sstables::compaction_completion_desc& desc) noexcept;
     future<> do_add_sstable_and_update_cache(sstables::shared_sstable sst, sstables::offstrategy offstrategy);
     // Helpers which add sstable on behalf of a compaction group and refreshes compound set.
     void add_sstable(compaction_group& cg, sstables::shared_sstable sstable);
@@ -556,6 +599,10 @@ class table : public enable_lw_shared_from_this<table> {
     static void remove_sstable_from_backlog_tracker(compaction_backlog_tracker& tracker, sstables::shared_sstable sstable);
     lw_shared_ptr<memtable> new_memtable();
     future<> try_flush_memtable_to_sstable(compaction_group& cg, lw_shared_ptr<memtable> memt, sstable_write_permit&& permit);
+    // Flush of a cache_only table: the memtable is merged into the cache, and no sstable is written.
+    future<> move_memtable_to_cache(compaction_group& cg, lw_shared_ptr<memtable> memt);
+    // Number of writers flushing the memtable concurrently, each to a separate token range.
+    size_t memtable_flush_writers(const memtable& mt) const;
     // Caller must keep m alive.
     future<> update_cache(compaction_group& cg, lw_shared_ptr<memtable> m, std::vector<sstables::shared_sstable> ssts);
     struct merge_comparator;
@@ -616,6 +663,7 @@ class table : public enable_lw_shared_from_this<table> {
 
     const storage_options& get_storage_options() const noexcept { return *_storage_opts; }
     lw_shared_ptr<const storage_options> get_storage_options_ptr() const noexcept { return _storage_opts; }
+    lw_shared_ptr<const storage_options> get_cold_storage_options_ptr() const noexcept { return _config.cold_storage_opts; }
 
     seastar::gate& async_gate() { return _async_gate; }
 
@@ -623,6 +671,14 @@ class table : public enable_lw_shared_from_this<table> {
         return _failed_counter_applies_to_memtable;
     }
 
+    counter_shard_cache& get_counter_shard_cache() noexcept {
+        return _counter_shard_cache;
+    }
+
+    repair_range_summaries& get_repair_range_summaries() noexcept {
+        return _repair_range_summaries;
+    }
+
     // This function should be called when this column family is ready for writes, IOW,
     // to produce SSTables. Extensive details about why this is important can be found
     // in Scylla's Github Issue #1014
@@ -685,6 +741,10 @@ class table : public enable_lw_shared_from_this<table> {
     flat_mutation_reader_v2 make_streaming_reader(schema_ptr schema, reader_permit permit,
             const dht::partition_range_vector& ranges) const;
 
+    // Excluding the given sstables, streamed on their own.
+    flat_mutation_reader_v2 make_streaming_reader(schema_ptr schema, reader_permit permit,
+            const dht::partition_range_vector& ranges, std::vector<sstables::shared_sstable> excluded) const;
+
     // Single range overload.
     flat_mutation_reader_v2 make_streaming_reader(schema_ptr schema, reader_permit permit, const dht::partition_range& range,
             const query::partition_slice& slice,
@@ -700,6 +760,9 @@ class table : public enable_lw_shared_from_this<table> {
 
     sstables::shared_sstable make_streaming_sstable_for_write(std::optional<sstring> subdir = {});
     sstables::shared_sstable make_streaming_staging_sstable();
+    // Makes an sstable to write the components of a streamed sstable to, of
+    // the same version and format.
+    sstables::shared_sstable make_streamed_sstable(sstables::sstable_version_types v, sstables::sstable_format_types f, std::optional<sstring> subdir = {});
 
     mutation_source as_mutation_source() const;
     mutation_source as_mutation_source_excluding(std::vector<sstables::shared_sstable>& sst) const;
@@ -821,7 +884,10 @@ class table : public enable_lw_shared_from_this<table> {
             std::optional<query::querier>* saved_querier = { });
 
     void start();
-    future<> stop();
+    // With save_sstable_owners, the owners of the sstables are saved for the next
+    // startup, see sstables::sstable_directory::write_owners_manifests().
+    using save_sstable_owners = bool_class<struct save_sstable_owners_tag>;
+    future<> stop(save_sstable_owners = save_sstable_owners::no);
     future<> flush(std::optional<db::replay_position> = {});
     future<> clear(); // discards memtable(s) without flushing them to disk.
     future<db::replay_position> discard_sstables(db_clock::time_point);
@@ -887,12 +953,24 @@ class table : public enable_lw_shared_from_this<table> {
     lw_shared_ptr<const sstable_list> get_sstables() const;
     lw_shared_ptr<const sstable_list> get_sstables_including_compacted_undeleted() const;
     std::vector<sstables::shared_sstable> select_sstables(const dht::partition_range& range) const;
+    // Reads in the background the bloom filters left unread when the table was
+    // populated, see db::config::defer_sstable_filter_loading.
+    void load_deferred_sstable_filters();
+private:
+    future<> do_load_deferred_sstable_filters();
+public:
     size_t sstables_count() const;
     std::vector<uint64_t> sstable_count_per_level() const;
     int64_t get_unleveled_sstables() const;
 
     void start_compaction();
     void trigger_compaction();
+    // Accounts the tombstones read by a query page from the sstables holding the partition
+    // it read, and triggers compaction if they are many, see tombstone_compaction_read_threshold.
+    void note_tombstones_read(const dht::partition_range& range, const compaction_stats& page_stats);
+    // Whether the filters of the read can't match any row, according to the
+    // column value statistics of the sstables, see query().
+    bool filters_exclude_all_rows(const schema& s, const query::read_command& cmd, const dht::partition_range_vector& ranges) const;
     void try_trigger_compaction(compaction_group& cg) noexcept;
     // Triggers offstrategy compaction, if needed, in the background.
     void trigger_offstrategy_compaction();
@@ -928,6 +1006,17 @@ class table : public enable_lw_shared_from_this<table> {
         return _view_stats;
     }
 
+    // The memory taken by the pending updates of the views of this table, out
+    // of what pending view updates can take on this shard. Unlike the backlog
+    // of the node, it is only made of the updates that writes to this table
+    // generated, so that a slow view only throttles writes to its base table.
+    db::view::update_backlog get_view_update_backlog() const {
+        if (!_config.view_update_concurrency_semaphore_limit) {
+            return db::view::update_backlog::no_backlog();
+        }
+        return {size_t(std::max(_view_stats.view_update_backlog_bytes, int64_t(0))), _config.view_update_concurrency_semaphore_limit};
+    }
+
     replica::cf_stats* cf_stats() {
         return _config.cf_stats;
     }
@@ -1018,8 +1107,8 @@ class table : public enable_lw_shared_from_this<table> {
     stream_view_replica_updates(shared_ptr<db::view::view_update_generator> gen, const schema_ptr& s, mutation&& m, db::timeout_clock::time_point timeout,
             std::vector<sstables::shared_sstable>& excluded_sstables) const;
 
-    void add_coordinator_read_latency(utils::estimated_histogram::duration latency);
-    std::chrono::milliseconds get_coordinator_read_latency_percentile(double percentile);
+    void add_coordinator_read_latency(utils::latency_histogram::duration latency);
+    std::chrono::microseconds get_coordinator_read_latency_percentile(double percentile);
 
     secondary_index::secondary_index_manager& get_index_manager() {
         return _index_manager;
@@ -1042,7 +1131,7 @@ class table : public enable_lw_shared_from_this<table> {
             shared_ptr<db::view::view_update_generator> gen,
             std::vector<db::view::view_and_base>,
             dht::token base_token,
-            flat_mutation_reader_v2&&,
+            flat_mutation_reader_v2,
             gc_clock::time_point);
 
     reader_concurrency_semaphore& streaming_read_concurrency_semaphore() {
@@ -1055,6 +1144,11 @@ class table : public enable_lw_shared_from_this<table> {
 
     size_t estimate_read_memory_cost() const;
 
+    // Predicts the cost of a read, for its admission by the reader concurrency semaphore.
+    // Reads of single partitions which return a bounded amount of rows are point reads,
+    // all other reads are scans.
+    read_cost estimate_read_cost(const query::read_command& cmd, std::span<const dht::partition_range> ranges) const;
+
 private:
     future<row_locker::lock_holder> do_push_view_replica_updates(shared_ptr<db::view::view_update_generator> gen, schema_ptr s, mutation m, db::timeout_clock::time_point timeout, mutation_source source,
             tracing::trace_state_ptr tr_state, reader_concurrency_semaphore& sem, const io_priority_class& io_priority, query::partition_slice::option_set custom_opts) const;
@@ -1104,6 +1198,14 @@ class table : public enable_lw_shared_from_this<table> {
 
 private:
     timer<> _off_strategy_trigger;
+
+    // Results of recent digest reads of single partitions, invalidated by
+    // writes to the partitions and by changes of the sstable set.
+    partition_digest_cache _digest_cache;
+    // Results of recent data reads, for tables whose caching options set
+    // results_ttl_in_ms, invalidated like _digest_cache.
+    query_result_cache _result_cache;
+
     void do_update_off_strategy_trigger();
 
 public:
@@ -1140,6 +1242,7 @@ class keyspace {
         bool enable_disk_reads = true;
         bool enable_disk_writes = true;
         bool enable_cache = true;
+        bool cache_only = false;
         bool enable_incremental_backups = false;
         utils::updateable_value<bool> compaction_enforce_min_threshold{false};
         bool enable_dangerous_direct_import_of_cassandra_counters = false;
@@ -1325,6 +1428,7 @@ class database : public peering_sharded_service<database> {
     db::timeout_semaphore _view_update_concurrency_sem{max_memory_pending_view_updates()};
 
     cache_tracker _row_cache_tracker;
+    query_result_cache_budget _result_cache_budget;
     seastar::shared_ptr<db::view::view_update_generator> _view_update_generator;
 
     inheriting_concrete_execution_stage<
@@ -1365,6 +1469,9 @@ class database : public peering_sharded_service<database> {
 
     friend db::data_listeners;
     std::unique_ptr<db::data_listeners> _data_listeners;
+    // Null if hot partitions tracking is disabled. Uninstalls itself from
+    // _data_listeners, so must be destroyed first.
+    std::unique_ptr<db::hot_partitions_data_listener> _hot_partitions;
 
     service::migration_notifier& _mnotifier;
     gms::feature_service& _feat;
@@ -1377,6 +1484,8 @@ class database : public peering_sharded_service<database> {
 
     db::rate_limiter _rate_limiter;
 
+    std::optional<cache_warmup> _cache_warmup;
+
     serialized_action _update_memtable_flush_static_shares_action;
     utils::observer<float> _memtable_flush_static_shares_observer;
 
@@ -1538,6 +1647,9 @@ class database : public peering_sharded_service<database> {
     /// reads, to speed up startup. After startup this should be reverted to
     /// the normal concurrency.
     void revert_initial_system_read_concurrency_boost();
+    // Starts loading the row cache with the partitions saved before the restart,
+    // and saving them periodically, if row_cache_save_period is set.
+    void start_cache_warmup();
     future<> start();
     future<> shutdown();
     future<> stop();
@@ -1706,6 +1818,11 @@ class database : public peering_sharded_service<database> {
         return *_data_listeners;
     }
 
+    // Null if hot partitions tracking is disabled, see the hot_partitions_capacity option.
+    db::hot_partitions_data_listener* hot_partitions() const {
+        return _hot_partitions.get();
+    }
+
     // Get the maximum result size for an unlimited query, appropriate for the
     // query class, which is deduced from the current scheduling group.
     query::max_result_size get_unlimited_query_max_result_size() const;
@@ -1714,6 +1831,11 @@ class database : public peering_sharded_service<database> {
     // which is deduced from the current scheduling group.
     reader_concurrency_semaphore& get_reader_concurrency_semaphore();
 
+    // The semaphore admitting user reads, whatever the current scheduling group.
+    reader_concurrency_semaphore& user_read_concurrency_semaphore() noexcept {
+        return _read_concurrency_sem;
+    }
+
     // Convenience method to obtain an admitted permit. See reader_concurrency_semaphore::obtain_permit().
     future<reader_permit> obtain_reader_permit(table& tbl, const char* const op_name, db::timeout_clock::time_point timeout, tracing::trace_state_ptr trace_ptr);
     future<reader_permit> obtain_reader_permit(schema_ptr schema, const char* const op_name, db::timeout_clock::time_point timeout, tracing::trace_state_ptr trace_ptr);
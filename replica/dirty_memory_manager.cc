@@ -192,9 +192,10 @@ void region_group::update_unspooled(ssize_t delta) {
 
 future<>
 region_group::shutdown() noexcept {
+    co_await _delayed_requests.close();
     _shutdown_requested = true;
     _relief.signal();
-    return std::move(_releaser);
+    co_await std::move(_releaser);
 }
 
 void region_group::on_request_expiry::operator()(std::unique_ptr<allocating_function>& func) noexcept {
@@ -207,7 +208,8 @@ future<flush_permit> flush_permit::reacquire_sstable_write_permit() && {
     return _manager->get_flush_permit(std::move(_background_permit));
 }
 
-dirty_memory_manager::dirty_memory_manager(replica::database& db, size_t threshold, double soft_limit, scheduling_group deferred_work_sg)
+dirty_memory_manager::dirty_memory_manager(replica::database& db, size_t threshold, double soft_limit, scheduling_group deferred_work_sg,
+        utils::updateable_value<uint32_t> max_write_delay_in_ms)
     : _db(&db)
     , _region_group("memtable (unspooled)", dirty_memory_manager_logalloc::reclaim_config{
             .unspooled_hard_limit = threshold / 2,
@@ -216,7 +218,38 @@ dirty_memory_manager::dirty_memory_manager(replica::database& db, size_t thresho
             .start_reclaiming = std::bind_front(&dirty_memory_manager::start_reclaiming, this)
       }, deferred_work_sg)
     , _flush_serializer(1)
-    , _waiting_flush(flush_when_needed()) {}
+    , _waiting_flush(flush_when_needed())
+    , _max_write_delay_in_ms(std::move(max_write_delay_in_ms))
+    , _write_throttle_timer([this] { update_write_delay(); })
+{
+    _write_throttle_timer.arm_periodic(write_throttle_period);
+}
+
+std::chrono::microseconds dirty_memory_manager::write_delay(size_t unspooled, size_t soft_limit, size_t hard_limit,
+        double ingest_rate, double flush_rate, std::chrono::microseconds max_delay) noexcept {
+    if (unspooled <= soft_limit || hard_limit <= soft_limit || ingest_rate <= flush_rate) {
+        return std::chrono::microseconds(0);
+    }
+    auto pressure = std::min(1.0, double(unspooled - soft_limit) / (hard_limit - soft_limit));
+    auto gap = (ingest_rate - flush_rate) / ingest_rate;
+    return std::chrono::duration_cast<std::chrono::microseconds>(max_delay * (pressure * gap));
+}
+
+void dirty_memory_manager::update_write_delay() noexcept {
+    // Weight of the latest sample in the rate estimates.
+    constexpr double alpha = 0.2;
+    constexpr double period = std::chrono::duration<double>(write_throttle_period).count();
+
+    auto ingested = _region_group.unspooled_bytes_added();
+    _ingest_rate += alpha * ((ingested - _last_ingested_bytes) / period - _ingest_rate);
+    _last_ingested_bytes = ingested;
+    _flush_rate += alpha * ((_flushed_bytes - _last_flushed_bytes) / period - _flush_rate);
+    _last_flushed_bytes = _flushed_bytes;
+
+    _region_group.set_write_delay(write_delay(unspooled_dirty_memory(), _region_group.unspooled_soft_limit_threshold(),
+            _region_group.unspooled_throttle_threshold(), _ingest_rate, _flush_rate,
+            std::chrono::milliseconds(_max_write_delay_in_ms())));
+}
 
 void
 dirty_memory_manager::setup_collectd(sstring namestr) {
@@ -230,11 +263,24 @@ dirty_memory_manager::setup_collectd(sstring namestr) {
 
         sm::make_gauge(namestr +"_unspooled_dirty_bytes", [this] { return unspooled_dirty_memory(); },
                        sm::description("Holds the size of used memory in bytes. Compare it to \"dirty_bytes\" to see how many memory is wasted (neither used nor available).")),
+
+        sm::make_counter(namestr + "_flushed_bytes", [this] { return flushed_bytes(); },
+                       sm::description("Holds the number of memtable bytes written to sstables.")),
+
+        sm::make_gauge(namestr + "_write_delay_us", [this] { return _region_group.write_delay().count(); },
+                       sm::description("Holds the delay currently imposed on writes because memtables are filled faster than they are flushed.")),
+
+        sm::make_counter(namestr + "_delayed_writes", [this] { return _region_group.delayed_requests_counter(); },
+                       sm::description("Holds the number of writes which were delayed because memtables were filled faster than they were flushed.")),
+
+        sm::make_counter(namestr + "_write_delay_total_us", [this] { return _region_group.total_write_delay().count(); },
+                       sm::description("Holds the total delay imposed on writes because memtables were filled faster than they were flushed.")),
     });
 }
 
 future<> dirty_memory_manager::shutdown() {
     _db_shutdown_requested = true;
+    _write_throttle_timer.cancel();
     _should_flush.signal();
     return std::move(_waiting_flush).then([this] {
         return _region_group.shutdown();
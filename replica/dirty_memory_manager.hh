@@ -12,10 +12,14 @@
 #include <boost/heap/binomial_heap.hpp>
 #include <seastar/core/condition-variable.hh>
 #include <seastar/core/future.hh>
+#include <seastar/core/gate.hh>
 #include <seastar/core/metrics_registration.hh>
 #include <seastar/core/semaphore.hh>
+#include <seastar/core/sleep.hh>
+#include <seastar/core/timer.hh>
 #include "replica/database_fwd.hh"
 #include "utils/logalloc.hh"
+#include "utils/updateable_value.hh"
 
 class test_region_group;
 
@@ -168,7 +172,17 @@ class region_group : public logalloc::region_listener {
 
     uint64_t _blocked_requests_counter = 0;
 
+    // Requests admitted while over the soft limit are delayed by _write_delay before they
+    // run, so that writers slow down gradually instead of all blocking at the hard limit.
+    // Set by the owner, see dirty_memory_manager::update_write_delay().
+    std::chrono::microseconds _write_delay{0};
+    uint64_t _delayed_requests_counter = 0;
+    std::chrono::microseconds _total_write_delay{0};
+    gate _delayed_requests;
+
     size_t _unspooled_total_memory = 0;
+    // Bytes ever added to regions of this group, to estimate the ingestion rate.
+    uint64_t _unspooled_bytes_added = 0;
 
     region_heap _regions;
 
@@ -227,10 +241,11 @@ class region_group : public logalloc::region_listener {
     size_t unspooled_throttle_threshold() const noexcept {
         return _cfg.unspooled_hard_limit;
     }
-private:
+
     size_t unspooled_soft_limit_threshold() const noexcept {
         return _cfg.unspooled_soft_limit;
     }
+private:
 
     bool reclaimer_can_block() const;
     future<> start_releaser(scheduling_group deferered_work_sg);
@@ -279,6 +294,7 @@ class region_group : public logalloc::region_listener {
     //    the full update cycle even then.
     virtual void increase_usage(logalloc::region* r, ssize_t delta) override { // From region_listener
         _regions.increase(*static_cast<size_tracked_region*>(r)->_heap_handle);
+        _unspooled_bytes_added += delta;
         update_unspooled(delta);
     }
 
@@ -307,12 +323,35 @@ class region_group : public logalloc::region_listener {
     // region_groups.
     //
     // When timeout is reached first, the returned future is resolved with timed_out_error exception.
+    //
+    // When over the soft limit and a write delay is set, the function is run (or queued) only
+    // after the write delay passes, if that leaves time before the timeout.
     template <typename Func>
     // We disallow future-returning functions here, because otherwise memory may be available
     // when we start executing it, but no longer available in the middle of the execution.
     requires (!is_future<std::invoke_result_t<Func>>::value)
     futurize_t<std::result_of_t<Func()>> run_when_memory_available(Func&& func, db::timeout_clock::time_point timeout);
 
+    void set_write_delay(std::chrono::microseconds delay) noexcept {
+        _write_delay = delay;
+    }
+
+    std::chrono::microseconds write_delay() const noexcept {
+        return _write_delay;
+    }
+
+    uint64_t delayed_requests_counter() const noexcept {
+        return _delayed_requests_counter;
+    }
+
+    std::chrono::microseconds total_write_delay() const noexcept {
+        return _total_write_delay;
+    }
+
+    uint64_t unspooled_bytes_added() const noexcept {
+        return _unspooled_bytes_added;
+    }
+
     // returns a pointer to the largest region (in terms of memory usage) that sits below this
     // region group. This includes the regions owned by this region group as well as all of its
     // children.
@@ -326,6 +365,9 @@ class region_group : public logalloc::region_listener {
 
     uint64_t blocked_requests_counter() const noexcept;
 private:
+    template <typename Func>
+    futurize_t<std::result_of_t<Func()>> run_or_queue(Func&& func, db::timeout_clock::time_point timeout);
+
     // Returns true if and only if constraints of this group are not violated.
     // That's taking into account any constraints imposed by enclosing (parent) groups.
     bool execution_permitted() noexcept;
@@ -412,12 +454,27 @@ class dirty_memory_manager {
     semaphore _background_work_flush_serializer = { _max_background_work };
     condition_variable _should_flush;
     int64_t _dirty_bytes_released_pre_accounted = 0;
+    // Memtable bytes written to sstables so far. Bytes whose flush failed are counted again when retried.
+    uint64_t _flushed_bytes = 0;
 
     future<> flush_when_needed();
 
     future<> _waiting_flush;
     void start_reclaiming() noexcept;
 
+    // Smooth write throttling. The ingestion and flush rates are sampled every
+    // write_throttle_period and the region group's write delay is updated from them.
+    static constexpr std::chrono::milliseconds write_throttle_period{100};
+    utils::updateable_value<uint32_t> _max_write_delay_in_ms;
+    timer<lowres_clock> _write_throttle_timer;
+    uint64_t _last_ingested_bytes = 0;
+    uint64_t _last_flushed_bytes = 0;
+    // In bytes per second, exponentially weighted.
+    double _ingest_rate = 0;
+    double _flush_rate = 0;
+
+    void update_write_delay() noexcept;
+
     bool has_pressure() const noexcept {
         return _region_group.over_unspooled_soft_limit();
     }
@@ -462,7 +519,15 @@ class dirty_memory_manager {
     //
     // We then set the soft limit to 80 % of the unspooled dirty hard limit, which is equal to 40 % of
     // the user-supplied threshold.
-    dirty_memory_manager(replica::database& db, size_t threshold, double soft_limit, scheduling_group deferred_work_sg);
+    //
+    // Write Delay
+    // -----------
+    // Between the soft and the hard limit, writes can be delayed in proportion to how far memory is
+    // past the soft limit and how much faster data comes in than it is flushed, up to
+    // max_write_delay_in_ms (0 disables this). Writers then slow down gradually as memory fills up,
+    // rather than all blocking at once when the hard limit is hit.
+    dirty_memory_manager(replica::database& db, size_t threshold, double soft_limit, scheduling_group deferred_work_sg,
+            utils::updateable_value<uint32_t> max_write_delay_in_ms = utils::updateable_value<uint32_t>(0));
     dirty_memory_manager()
         : _db(nullptr)
         , _region_group("memtable (unspooled)",
@@ -494,6 +559,7 @@ class dirty_memory_manager {
         _region_group.update_real(delta);
         _region_group.update_unspooled(-delta);
         _dirty_bytes_released_pre_accounted += delta;
+        _flushed_bytes += delta;
     }
 
     void pin_real_dirty_memory(int64_t delta) {
@@ -512,10 +578,18 @@ class dirty_memory_manager {
         return _region_group.unspooled_memory_used();
     }
 
+    uint64_t flushed_bytes() const noexcept {
+        return _flushed_bytes;
+    }
+
     void notify_soft_pressure() {
         _region_group.notify_unspooled_soft_pressure();
     }
 
+    // The delay to impose on each write, see "Write Delay" above.
+    static std::chrono::microseconds write_delay(size_t unspooled, size_t soft_limit, size_t hard_limit,
+            double ingest_rate, double flush_rate, std::chrono::microseconds max_delay) noexcept;
+
     size_t throttle_threshold() const {
         return _region_group.unspooled_throttle_threshold();
     }
@@ -563,6 +637,23 @@ template <typename Func>
 requires (!is_future<std::invoke_result_t<Func>>::value)
 futurize_t<std::result_of_t<Func()>>
 region_group::run_when_memory_available(Func&& func, db::timeout_clock::time_point timeout) {
+    auto delay = _write_delay;
+    if (delay.count() && over_unspooled_soft_limit() && !_delayed_requests.is_closed()
+            && timeout - db::timeout_clock::now() > delay) {
+        ++_delayed_requests_counter;
+        _total_write_delay += delay;
+        return with_gate(_delayed_requests, [this, delay, func = std::forward<Func>(func), timeout] () mutable {
+            return sleep(delay).then([this, func = std::move(func), timeout] () mutable {
+                return run_or_queue(std::move(func), timeout);
+            });
+        });
+    }
+    return run_or_queue(std::forward<Func>(func), timeout);
+}
+
+template <typename Func>
+futurize_t<std::result_of_t<Func()>>
+region_group::run_or_queue(Func&& func, db::timeout_clock::time_point timeout) {
     bool blocked = 
         !_blocked_requests.empty()
         || under_unspooled_pressure()
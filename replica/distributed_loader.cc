@@ -612,6 +612,9 @@ class table_populator {
         for (auto subdir : { "", sstables::staging_dir, sstables::quarantine_dir }) {
             co_await start_subdir(subdir);
         }
+        if (_global_table->has_cold_storage()) {
+            co_await start_directory(cold_storage_key, _base_path.native(), _global_table->get_cold_storage_options_ptr());
+        }
 
         co_await smp::invoke_on_all([this] {
             _global_table->update_sstables_known_generation(_highest_generation);
@@ -621,6 +624,11 @@ class table_populator {
         co_await populate_subdir(sstables::staging_dir, allow_offstrategy_compaction::no);
         co_await populate_subdir(sstables::quarantine_dir, allow_offstrategy_compaction::no, must_exist::no);
         co_await populate_subdir("", allow_offstrategy_compaction::yes);
+        co_await populate_cold_storage();
+
+        co_await smp::invoke_on_all([this] {
+            _global_table->load_deferred_sstable_filters();
+        });
     }
 
     future<> stop() {
@@ -639,6 +647,13 @@ class table_populator {
     future<> populate_subdir(sstring subdir, allow_offstrategy_compaction, must_exist = must_exist::yes);
 
     future<> start_subdir(sstring subdir);
+
+    // The sstables which compaction moved to the table's cold storage are kept
+    // in the same directory as its local sstables, but listed from the registry.
+    static constexpr auto cold_storage_key = "<cold storage>";
+    future<> populate_cold_storage();
+
+    future<> start_directory(sstring key, sstring sstdir, lw_shared_ptr<const data_dictionary::storage_options> storage_opts);
 };
 
 future<> table_populator::start_subdir(sstring subdir) {
@@ -655,6 +670,10 @@ future<> table_populator::start_subdir(sstring subdir) {
         co_await distributed_loader::handle_sstables_pending_delete(pending_delete_dir);
     }
 
+    co_await start_directory(subdir, sstdir, _global_table->get_storage_options_ptr());
+}
+
+future<> table_populator::start_directory(sstring key, sstring sstdir, lw_shared_ptr<const data_dictionary::storage_options> storage_opts) {
     auto dptr = make_lw_shared<sharded<sstables::sstable_directory>>();
     auto& directory = *dptr;
     auto& global_table = _global_table;
@@ -662,13 +681,13 @@ future<> table_populator::start_subdir(sstring subdir) {
     co_await directory.start(
         sharded_parameter([&global_table] { return std::ref(global_table->get_sstables_manager()); }),
         sharded_parameter([&global_table] { return global_table->schema(); }),
-        sharded_parameter([&global_table] { return global_table->get_storage_options_ptr(); }),
+        sharded_parameter([storage_opts] { return storage_opts; }),
         fs::path(sstdir), default_priority_class(),
         default_io_error_handler_gen()
     );
 
     // directory must be stopped using table_populator::stop below
-    _sstable_directories[subdir] = dptr;
+    _sstable_directories[key] = dptr;
 
     co_await distributed_loader::lock_table(directory, _db, _ks, _cf);
 
@@ -676,6 +695,9 @@ future<> table_populator::start_subdir(sstring subdir) {
         .throw_on_missing_toc = true,
         .enable_dangerous_direct_import_of_cassandra_counters = db.local().get_config().enable_dangerous_direct_import_of_cassandra_counters(),
         .allow_loading_materialized_view = true,
+        .sstable_open_config = {
+            .defer_bloom_filter = db.local().get_config().defer_sstable_filter_loading(),
+        },
     };
     co_await distributed_loader::process_sstable_dir(directory, flags);
 
@@ -749,6 +771,32 @@ future<> table_populator::populate_subdir(sstring subdir, allow_offstrategy_comp
     });
 }
 
+future<> table_populator::populate_cold_storage() {
+    if (!_sstable_directories.contains(cold_storage_key)) {
+        co_return;
+    }
+    dblog.debug("Populating {}/{} from cold storage", _ks, _cf);
+
+    auto& directory = *_sstable_directories.at(cold_storage_key);
+
+    // Sstables shared by several shards are resharded into local ones, which
+    // compaction will move back to cold storage in time. Cold sstables are
+    // not reshaped, as they were written by the compaction strategy already.
+    co_await distributed_loader::reshard(directory, _db, _ks, _cf, [this] (shard_id shard) mutable {
+        auto gen = smp::submit_to(shard, [this] () {
+            return _global_table->calculate_generation_for_new_table();
+        }).get0();
+
+        return make_sstable(*_global_table, _base_path, gen, _highest_version);
+    }, default_priority_class());
+
+    co_await directory.invoke_on_all([this] (sstables::sstable_directory& dir) -> future<> {
+        co_await dir.do_for_each_sstable([this] (sstables::shared_sstable sst) {
+            return _global_table->add_sstable_and_update_cache(sst);
+        });
+    });
+}
+
 future<> distributed_loader::populate_keyspace(distributed<replica::database>& db, sstring datadir, sstring ks_name) {
     auto ksdir = datadir + "/" + ks_name;
     auto& keyspaces = db.local().get_keyspaces();
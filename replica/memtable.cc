@@ -219,6 +219,12 @@ partition_entry&
 memtable::find_or_create_partition(const dht::decorated_key& key) {
     assert(!reclaiming_enabled());
 
+    if (auto e = _partition_index.find(*_schema, key.token(), key.key())) {
+        ++_table_stats.memtable_partition_hits;
+        upgrade_entry(*e);
+        return e->partition();
+    }
+
     // call lower_bound so we have a hint for the insert, just in case.
     partitions_type::bound_hint hint;
     auto i = partitions.lower_bound(key, dht::ring_position_comparator(*_schema), hint);
@@ -226,6 +232,7 @@ memtable::find_or_create_partition(const dht::decorated_key& key) {
         partitions_type::iterator entry = partitions.emplace_before(i,
                 key.token().raw(), hint,
                 _schema, dht::decorated_key(key), mutation_partition(_schema));
+        _partition_index.insert(*entry);
         ++nr_partitions;
         ++_table_stats.memtable_partition_insertions;
         if (!hint.emplace_keeps_iterators()) {
@@ -620,9 +627,9 @@ class flush_reader final : public flat_mutation_reader_v2::impl, private iterato
     flat_mutation_reader_v2_opt _partition_reader;
     flush_memory_accounter _flushed_memory;
 public:
-    flush_reader(schema_ptr s, reader_permit permit, lw_shared_ptr<memtable> m)
+    flush_reader(schema_ptr s, reader_permit permit, lw_shared_ptr<memtable> m, const dht::partition_range& range)
         : impl(s, std::move(permit))
-        , iterator_reader(std::move(s), m, query::full_partition_range)
+        , iterator_reader(std::move(s), m, range)
         , _flushed_memory(*m)
     {}
     flush_reader(const flush_reader&) = delete;
@@ -712,10 +719,9 @@ memtable::make_flat_reader_opt(schema_ptr s,
     if (query::is_single_partition(range) && !fwd_mr) {
         const query::ring_position& pos = range.start()->value();
         auto snp = _read_section(*this, [&] () -> partition_snapshot_ptr {
-            auto i = partitions.find(pos, dht::ring_position_comparator(*_schema));
-            if (i != partitions.end()) {
-                upgrade_entry(*i);
-                return i->snapshot(*this);
+            if (auto e = _partition_index.find(*_schema, pos.token(), *pos.key())) {
+                upgrade_entry(*e);
+                return e->snapshot(*this);
             } else {
                 return { };
             }
@@ -744,14 +750,40 @@ memtable::make_flat_reader_opt(schema_ptr s,
 }
 
 flat_mutation_reader_v2
-memtable::make_flush_reader(schema_ptr s, reader_permit permit, const io_priority_class& pc) {
+memtable::make_flush_reader(schema_ptr s, reader_permit permit, const io_priority_class& pc, const dht::partition_range& range) {
     if (!_merged_into_cache) {
-        return make_flat_mutation_reader_v2<flush_reader>(std::move(s), std::move(permit), shared_from_this());
+        return make_flat_mutation_reader_v2<flush_reader>(std::move(s), std::move(permit), shared_from_this(), range);
     } else {
         auto& full_slice = s->full_slice();
         return make_flat_mutation_reader_v2<scanning_reader>(std::move(s), shared_from_this(), std::move(permit),
-                      query::full_partition_range, full_slice, pc, mutation_reader::forwarding::no);
+                      range, full_slice, pc, mutation_reader::forwarding::no);
+    }
+}
+
+dht::partition_range_vector memtable::split_for_flush(size_t n) const {
+    if (n <= 1 || partitions.empty()) {
+        return {query::full_partition_range};
+    }
+    // Splitting the tokens between the first and the last partition, rather
+    // than the whole ring, keeps the ranges even for tables with few distinct
+    // tokens, and makes sure the first and last ranges aren't empty.
+    auto first = partitions.begin()->key().token().raw();
+    auto last = std::prev(partitions.end())->key().token().raw();
+    auto width = uint64_t(last) - uint64_t(first);
+    if (width < n) {
+        return {query::full_partition_range};
+    }
+    dht::partition_range_vector ranges;
+    ranges.reserve(n);
+    std::optional<dht::partition_range::bound> start;
+    for (size_t i = 1; i < n; ++i) {
+        auto t = dht::token::from_int64(int64_t(uint64_t(first) + width / n * i));
+        auto end = dht::partition_range::bound(dht::ring_position::starting_at(t), false);
+        ranges.emplace_back(std::move(start), end);
+        start = dht::partition_range::bound(dht::ring_position::starting_at(t), true);
     }
+    ranges.emplace_back(std::move(start), std::nullopt);
+    return ranges;
 }
 
 void
@@ -793,6 +825,8 @@ memtable::apply(const frozen_mutation& m, const schema_ptr& m_schema, db::rp_han
     with_allocator(allocator(), [this, &m, &m_schema] {
         _allocating_section(*this, [&, this] {
             auto& p = find_or_create_partition_slow(m.key());
+            // Cells are copied from the frozen mutation straight into the
+            // region, and the rows built from them are moved into the entry.
             mutation_partition mp(m_schema);
             partition_builder pb(*m_schema, mp);
             m.partition().accept(*m_schema, pb);
@@ -824,9 +858,97 @@ memtable_entry::memtable_entry(memtable_entry&& o) noexcept
     : _schema(std::move(o._schema))
     , _key(std::move(o._key))
     , _pe(std::move(o._pe))
+    , _index_next(std::exchange(o._index_next, nullptr))
+    , _index_pprev(std::exchange(o._index_pprev, nullptr))
     , _flags(o._flags)
+{
+    if (_index_pprev) {
+        *_index_pprev = this;
+    }
+    if (_index_next) {
+        _index_next->_index_pprev = &_index_next;
+    }
+}
+
+memtable_entry::~memtable_entry() {
+    if (_index_pprev) {
+        *_index_pprev = _index_next;
+        if (_index_next) {
+            _index_next->_index_pprev = _index_pprev;
+        }
+    }
+}
+
+memtable_partition_index::memtable_partition_index()
+    : _buckets(initial_buckets)
+    , _shift(64 - std::countr_zero(initial_buckets))
 { }
 
+memtable_partition_index::~memtable_partition_index() {
+    clear();
+}
+
+memtable_entry* memtable_partition_index::find(const schema& s, const dht::token& t, const partition_key& key) const noexcept {
+    for (auto e = _buckets[bucket_of(t)]; e; e = e->_index_next) {
+        if (e->_key.token() == t && e->_key.key().equal(s, key)) {
+            return e;
+        }
+    }
+    return nullptr;
+}
+
+void memtable_partition_index::insert(memtable_entry& e) noexcept {
+    if (++_inserted > _buckets.size()) {
+        maybe_grow();
+    }
+    auto& head = _buckets[bucket_of(e._key.token())];
+    e._index_next = head;
+    e._index_pprev = &head;
+    if (head) {
+        head->_index_pprev = &e._index_next;
+    }
+    head = &e;
+}
+
+void memtable_partition_index::maybe_grow() noexcept {
+    std::vector<memtable_entry*> old;
+    try {
+        // May be called under the memtable's allocator.
+        with_allocator(standard_allocator(), [&] {
+            old = std::exchange(_buckets, std::vector<memtable_entry*>(_buckets.size() * 2));
+        });
+    } catch (const std::bad_alloc&) {
+        return;
+    }
+    --_shift;
+    for (auto& head : old) {
+        while (auto e = head) {
+            head = e->_index_next;
+            auto& new_head = _buckets[bucket_of(e->_key.token())];
+            e->_index_next = new_head;
+            e->_index_pprev = &new_head;
+            if (new_head) {
+                new_head->_index_pprev = &e->_index_next;
+            }
+            new_head = e;
+        }
+    }
+    with_allocator(standard_allocator(), [&] {
+        old = {};
+    });
+}
+
+void memtable_partition_index::clear() noexcept {
+    for (auto& head : _buckets) {
+        while (auto e = head) {
+            head = e->_index_next;
+            e->_index_next = nullptr;
+            e->_index_pprev = nullptr;
+        }
+    }
+    _inserted = 0;
+}
+
 stop_iteration memtable_entry::clear_gently() noexcept {
     return _pe.clear_gently(no_cache_tracker);
 }
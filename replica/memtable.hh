@@ -8,9 +8,11 @@
 
 #pragma once
 
+#include <bit>
 #include <map>
 #include <memory>
 #include <iosfwd>
+#include <vector>
 #include "replica/database_fwd.hh"
 #include "dht/i_partitioner.hh"
 #include "schema/schema_fwd.hh"
@@ -22,6 +24,7 @@
 #include "mutation/mutation_cleaner.hh"
 #include "sstables/types.hh"
 #include "utils/double-decker.hh"
+#include "utils/hash.hh"
 #include "readers/empty_v2.hh"
 #include "readers/mutation_source.hh"
 
@@ -36,6 +39,11 @@ class memtable_entry {
     schema_ptr _schema;
     dht::decorated_key _key;
     partition_entry _pe;
+    // Links in the bucket chain of memtable_partition_index.
+    // _index_pprev points at the bucket or at the _index_next of the previous entry,
+    // so that the entry can relink itself when moved by LSA, and unlink itself when destroyed.
+    memtable_entry* _index_next = nullptr;
+    memtable_entry** _index_pprev = nullptr;
     struct {
         bool _head : 1;
         bool _tail : 1;
@@ -58,6 +66,7 @@ class memtable_entry {
     { }
 
     memtable_entry(memtable_entry&& o) noexcept;
+    ~memtable_entry();
     // Frees elements of the entry in batches.
     // Returns stop_iteration::yes iff there are no more elements to free.
     stop_iteration clear_gently() noexcept;
@@ -93,6 +102,39 @@ class memtable_entry {
 
     friend dht::ring_position_view ring_position_view_to_compare(const memtable_entry& mt) { return mt._key; }
     friend std::ostream& operator<<(std::ostream&, const memtable_entry&);
+    friend class memtable_partition_index;
+};
+
+// Hash index of memtable entries by token, complementing the partitions tree
+// of the memtable for lookups of single partitions, which then don't pay
+// for the tree walk.
+//
+// Entries are linked into the bucket chains intrusively, so the index needs
+// no memory per entry and stays valid when LSA moves the entries. The bucket
+// array lives in the standard allocator. Growing it is best effort, when that
+// fails the chains just get longer, so the index always has all the entries.
+class memtable_partition_index {
+    static constexpr size_t initial_buckets = 64;
+
+    std::vector<memtable_entry*> _buckets;
+    unsigned _shift;
+    // Entries inserted since the last clear(). Not decremented when entries are
+    // destroyed, that only happens when the memtable is being flushed or cleared.
+    size_t _inserted = 0;
+private:
+    size_t bucket_of(const dht::token& t) const noexcept {
+        return utils::fibonacci_hash(t.raw()) >> _shift;
+    }
+    void maybe_grow() noexcept;
+public:
+    memtable_partition_index();
+    ~memtable_partition_index();
+    memtable_partition_index(const memtable_partition_index&) = delete;
+
+    memtable_entry* find(const schema& s, const dht::token& t, const partition_key& key) const noexcept;
+    void insert(memtable_entry& e) noexcept;
+    // Unlinks all the entries.
+    void clear() noexcept;
 };
 
 }
@@ -116,6 +158,8 @@ class memtable final : public enable_lw_shared_from_this<memtable>, private dirt
     schema_ptr _schema;
     logalloc::allocating_section _read_section;
     logalloc::allocating_section _allocating_section;
+    // Must outlive the entries of partitions.
+    memtable_partition_index _partition_index;
     partitions_type partitions;
     size_t nr_partitions = 0;
     db::replay_position _replay_position;
@@ -266,7 +310,16 @@ class memtable final : public enable_lw_shared_from_this<memtable>, private dirt
         return make_flat_reader(s, std::move(permit), range, full_slice);
     }
 
-    flat_mutation_reader_v2 make_flush_reader(schema_ptr, reader_permit permit, const io_priority_class& pc);
+    // The range must be alive as long as the reader is. Flush readers of
+    // disjoint ranges may be used concurrently.
+    flat_mutation_reader_v2 make_flush_reader(schema_ptr, reader_permit permit, const io_priority_class& pc,
+                                              const dht::partition_range& range = query::full_partition_range);
+
+    // Splits the ring into at most n contiguous ranges, so that each of them
+    // holds roughly the same number of partitions of this memtable, assuming
+    // their tokens are evenly distributed, and so that flushing them with
+    // separate flush readers writes all of them.
+    dht::partition_range_vector split_for_flush(size_t n) const;
 
     mutation_source as_data_source();
 
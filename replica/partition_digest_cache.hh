@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <chrono>
+#include <optional>
+
+#include <seastar/core/lowres_clock.hh>
+
+#include "dht/i_partitioner.hh"
+#include "query-result.hh"
+#include "schema/schema.hh"
+#include "utils/two_choice_cache.hh"
+
+namespace replica {
+
+// Remembers the results of recent digest-only reads of single partitions, so
+// that replicas answering the digest reads of quorum reads of a partition
+// which didn't change don't read and hash it again.
+//
+// A result is identified by the partition key, the schema version, the digest
+// algorithm and the serialized slice and limits of the read command. It is
+// served for up to max_age, which bounds how long data expiring in the
+// meantime can be ignored, unless the partition is written or the
+// table's sstables change before that.
+//
+// Holds up to a fixed number of results, each of which can be in one of two
+// slots picked from the token of its partition, see utils::two_choice_cache.
+// Inserting a result when both slots are taken replaces the older one.
+//
+// Reads which run concurrently with an invalidation may have missed it, so
+// results are only inserted if no invalidation happened since the read
+// started, see generation().
+class partition_digest_cache {
+public:
+    using clock_type = seastar::lowres_clock;
+    static constexpr std::chrono::seconds max_age{1};
+
+    struct key {
+        dht::decorated_key dk;
+        table_schema_version version;
+        query::digest_algorithm algo;
+        bytes command;
+    };
+private:
+    struct result {
+        bytes_ostream buf; // Doesn't hold rows, for digest-only results.
+        query::result_digest digest;
+        api::timestamp_type last_modified;
+        std::optional<uint32_t> row_count_low_bits;
+        std::optional<uint32_t> row_count_high_bits;
+        std::optional<uint32_t> partition_count;
+        std::optional<full_position> last_position;
+        clock_type::time_point inserted_at;
+    };
+    utils::two_choice_cache<key, result> _results;
+    uint64_t _generation = 0;
+private:
+    static uint64_t hash_of(const dht::decorated_key& dk) noexcept {
+        return dk.token().raw();
+    }
+
+    static auto key_equal(const schema& s, const key& k) noexcept {
+        return [&s, &k] (const key& other) {
+            return k.version == other.version && k.algo == other.algo && k.dk.equal(s, other.dk) && k.command == other.command;
+        };
+    }
+public:
+    // capacity is rounded up to a power of two, 0 disables the cache.
+    explicit partition_digest_cache(size_t capacity) noexcept
+        : _results(capacity)
+    { }
+
+    bool enabled() const noexcept {
+        return _results.enabled();
+    }
+
+    // Incremented by every invalidation.
+    uint64_t generation() const noexcept {
+        return _generation;
+    }
+
+    std::optional<query::result> find(const schema& s, const key& k) {
+        auto e = _results.find(hash_of(k.dk), key_equal(s, k));
+        if (!e) {
+            return std::nullopt;
+        }
+        auto& r = e->value;
+        if (clock_type::now() - r.inserted_at >= max_age) {
+            _results.erase(hash_of(k.dk), key_equal(s, k));
+            return std::nullopt;
+        }
+        return query::result(bytes_ostream(r.buf), r.digest, r.last_modified, query::short_read::no,
+                r.row_count_low_bits, r.partition_count, r.row_count_high_bits, r.last_position);
+    }
+
+    // Remembers the result r of a read which started when generation() was
+    // generation. Best effort, r is not remembered if memory can't be
+    // allocated for it.
+    void insert(const schema& s, key k, const query::result& r, uint64_t generation) noexcept {
+        if (!enabled() || generation != _generation || !r.digest() || r.is_short_read()) {
+            return;
+        }
+        try {
+            _results.insert(hash_of(k.dk), key_equal(s, k), std::move(k), result{r.buf(), *r.digest(), r.last_modified(), r.row_count_low_bits(),
+                    r.row_count_high_bits(), r.partition_count(), r.last_position(), clock_type::now()});
+        } catch (...) {
+            // Not remembering the result is fine.
+        }
+    }
+
+    void invalidate(const schema& s, const dht::decorated_key& dk) noexcept {
+        ++_generation;
+        _results.erase(hash_of(dk), [&] (const key& k) { return k.dk.equal(s, dk); });
+    }
+
+    void clear() noexcept {
+        ++_generation;
+        _results.clear();
+    }
+
+    size_t size() const noexcept {
+        return _results.size();
+    }
+};
+
+}
@@ -0,0 +1,227 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <optional>
+#include <vector>
+
+#include <seastar/core/lowres_clock.hh>
+
+#include "dht/i_partitioner.hh"
+#include "query-result.hh"
+#include "schema/schema.hh"
+
+namespace replica {
+
+// The memory which the query_result_caches of all the tables of a shard may
+// use together, accounted in bytes of results and keys.
+class query_result_cache_budget {
+    size_t _limit;
+    size_t _used = 0;
+public:
+    explicit query_result_cache_budget(size_t limit) noexcept : _limit(limit) {}
+
+    bool try_consume(size_t memory) noexcept {
+        if (memory > _limit - _used) {
+            return false;
+        }
+        _used += memory;
+        return true;
+    }
+
+    void release(size_t memory) noexcept {
+        _used -= memory;
+    }
+
+    size_t used() const noexcept {
+        return _used;
+    }
+};
+
+// Remembers the results of recent reads of a table, so that replicas
+// answering the same pages of the same queries over and over, like those of
+// dashboards refreshed every few seconds, don't read them again.
+//
+// A result is identified by the schema version, the kind of result, the
+// serialized slice and limits of the read command and the partition ranges,
+// which together stand for the statement, its bound values and the paging
+// state of the page. It is served for up to the ttl set by the caching
+// options of the table, which bounds how long data expiring in the meantime
+// can be ignored, unless a partition in its ranges is written or the
+// table's sstables change before that.
+//
+// Holds up to max_entries results of up to max_result_size bytes each,
+// inserting a result when full replaces the oldest one. The memory of the
+// entries is charged to a budget shared with the other tables of the shard;
+// when it runs out, the table's oldest results are dropped to make room, and
+// if that's not enough the result isn't remembered. Without a budget, nothing
+// is remembered.
+//
+// Reads which run concurrently with an invalidation may have missed it, so
+// results are only inserted if no invalidation happened since the read
+// started, see generation().
+class query_result_cache {
+public:
+    using clock_type = seastar::lowres_clock;
+    static constexpr size_t max_entries = 32;
+    static constexpr size_t max_result_size = 128 * 1024;
+
+    struct key {
+        table_schema_version version;
+        query::result_request request;
+        query::digest_algorithm algo;
+        bytes command;
+        dht::partition_range_vector ranges;
+    };
+private:
+    struct entry {
+        key k;
+        bytes_ostream buf;
+        std::optional<query::result_digest> digest;
+        api::timestamp_type last_modified;
+        std::optional<uint32_t> row_count_low_bits;
+        std::optional<uint32_t> row_count_high_bits;
+        std::optional<uint32_t> partition_count;
+        std::optional<full_position> last_position;
+        clock_type::time_point inserted_at;
+        size_t memory;
+    };
+    query_result_cache_budget* _budget;
+    std::vector<entry> _entries; // Oldest first.
+    size_t _memory = 0; // Charged to _budget.
+    uint64_t _generation = 0;
+private:
+    static size_t memory_of(const key& k, const query::result& r) noexcept {
+        return sizeof(entry) + k.command.size() + k.ranges.size() * sizeof(dht::partition_range) + r.buf().size();
+    }
+
+    void release(size_t memory) noexcept {
+        _memory -= memory;
+        _budget->release(memory);
+    }
+
+    template <typename Pred>
+    void erase_if(Pred pred) {
+        std::erase_if(_entries, [&] (const entry& e) {
+            if (!pred(e)) {
+                return false;
+            }
+            release(e.memory);
+            return true;
+        });
+    }
+
+    void erase_oldest() noexcept {
+        release(_entries.front().memory);
+        _entries.erase(_entries.begin());
+    }
+
+    static bool matches(const schema& s, const key& a, const key& b) noexcept {
+        if (a.version != b.version || a.request != b.request || a.algo != b.algo || a.command != b.command
+                || a.ranges.size() != b.ranges.size()) {
+            return false;
+        }
+        dht::ring_position_comparator cmp(s);
+        for (size_t i = 0; i < a.ranges.size(); ++i) {
+            if (!a.ranges[i].equal(b.ranges[i], cmp)) {
+                return false;
+            }
+        }
+        return true;
+    }
+public:
+    explicit query_result_cache(query_result_cache_budget* budget) noexcept : _budget(budget) {}
+    query_result_cache(const query_result_cache&) = delete;
+    ~query_result_cache() {
+        clear();
+    }
+
+    // Incremented by every invalidation.
+    uint64_t generation() const noexcept {
+        return _generation;
+    }
+
+    std::optional<query::result> find(const schema& s, const key& k, clock_type::duration ttl) {
+        for (auto it = _entries.begin(); it != _entries.end(); ++it) {
+            if (!matches(s, it->k, k)) {
+                continue;
+            }
+            if (clock_type::now() - it->inserted_at >= ttl) {
+                release(it->memory);
+                _entries.erase(it);
+                return std::nullopt;
+            }
+            return query::result(bytes_ostream(it->buf), it->digest, it->last_modified, query::short_read::no,
+                    it->row_count_low_bits, it->partition_count, it->row_count_high_bits, it->last_position);
+        }
+        return std::nullopt;
+    }
+
+    // Remembers the result r of a read which started when generation() was
+    // generation. Best effort, r is not remembered if the budget or the
+    // allocator can't provide memory for it.
+    void insert(const schema& s, key k, const query::result& r, uint64_t generation) noexcept {
+        if (!_budget || generation != _generation || r.is_short_read() || r.buf().size() > max_result_size) {
+            return;
+        }
+        erase_if([&] (const entry& e) { return matches(s, e.k, k); });
+        if (_entries.size() >= max_entries) {
+            erase_oldest();
+        }
+        auto memory = memory_of(k, r);
+        while (!_budget->try_consume(memory)) {
+            if (_entries.empty()) {
+                return;
+            }
+            erase_oldest();
+        }
+        _memory += memory;
+        try {
+            _entries.push_back(entry{std::move(k), r.buf(), r.digest(), r.last_modified(), r.row_count_low_bits(), r.row_count_high_bits(),
+                    r.partition_count(), r.last_position(), clock_type::now(), memory});
+        } catch (...) {
+            // Not remembering the result is fine.
+            release(memory);
+        }
+    }
+
+    void invalidate(const schema& s, const dht::decorated_key& dk) noexcept {
+        ++_generation;
+        if (_entries.empty()) {
+            return;
+        }
+        try {
+            dht::ring_position pos(dk);
+            dht::ring_position_comparator cmp(s);
+            erase_if([&] (const entry& e) {
+                return std::any_of(e.k.ranges.begin(), e.k.ranges.end(), [&] (const dht::partition_range& r) {
+                    return r.contains(pos, cmp);
+                });
+            });
+        } catch (...) {
+            clear();
+        }
+    }
+
+    void clear() noexcept {
+        ++_generation;
+        _entries.clear();
+        if (_memory) {
+            release(_memory);
+        }
+    }
+
+    size_t size() const noexcept {
+        return _entries.size();
+    }
+};
+
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <map>
+#include <optional>
+#include <vector>
+
+#include "dht/i_partitioner.hh"
+#include "gc_clock.hh"
+#include "repair/hash.hh"
+
+namespace replica {
+
+// Remembers the token ranges of a table which the last row level repair
+// found in sync, and which weren't written since, so that repairing them
+// again can stop as soon as all nodes agree they are still unchanged,
+// instead of reading and hashing all their rows.
+//
+// A range is identified by its bounds and the sharding configuration of the
+// repair master, which reads only the tokens of one of its shards. A repair
+// begins a summary of the ranges it repairs before reading them, and commits
+// it once the repair master found them in sync on all nodes, see
+// repair_range_summary. Writing to a range, or adding sstables holding some
+// of its tokens, drops its summary, committed or not, and so do truncation
+// and schema changes. Expiring data and purged tombstones don't, so callers
+// ignore summaries older than they can tolerate, see find().
+//
+// Every shard keeps its own summaries and drops them on its own writes, so
+// a node has a summary of a range only if all its shards have it.
+//
+// Summaries of overlapping ranges which aren't the same range are not kept
+// together, inserting one drops the others, so that a token falls in the
+// ranges of at most one set of entries.
+class repair_range_summaries {
+public:
+    struct key {
+        dht::token_range range;
+        unsigned shard;
+        unsigned shard_count;
+        unsigned ignore_msb;
+    };
+private:
+    struct entry {
+        unsigned shard;
+        unsigned shard_count;
+        unsigned ignore_msb;
+        std::optional<uint64_t> pending_seed;
+        std::optional<repair_range_summary> summary;
+        gc_clock::time_point committed_at;
+    };
+    struct range_entries {
+        dht::token_range range;
+        std::vector<entry> entries;
+    };
+    // Keyed by the end token of the range.
+    std::map<dht::token, range_entries> _ranges;
+private:
+    static dht::token end_token(const dht::token_range& r) {
+        return r.end() ? r.end()->value() : dht::maximum_token();
+    }
+
+    static bool matches(const entry& e, const key& k) {
+        return e.shard == k.shard && e.shard_count == k.shard_count && e.ignore_msb == k.ignore_msb;
+    }
+
+    entry* find_entry(const key& k) {
+        auto it = _ranges.find(end_token(k.range));
+        if (it == _ranges.end() || !it->second.range.equal(k.range, dht::token_comparator())) {
+            return nullptr;
+        }
+        for (auto& e : it->second.entries) {
+            if (matches(e, k)) {
+                return &e;
+            }
+        }
+        return nullptr;
+    }
+public:
+    bool empty() const noexcept {
+        return _ranges.empty();
+    }
+
+    // Starts summarizing the range of k for the repair using seed.
+    void begin(const key& k, uint64_t seed) {
+        if (auto e = find_entry(k)) {
+            e->pending_seed = seed;
+            return;
+        }
+        invalidate(k.range);
+        auto& re = _ranges.try_emplace(end_token(k.range), range_entries{k.range, {}}).first->second;
+        re.entries.push_back(entry{k.shard, k.shard_count, k.ignore_msb, seed, std::nullopt, {}});
+    }
+
+    // Records that the repair using seed found the range of k in sync, after
+    // reading rows hashing to hash from it. Ignored if the range was written
+    // since begin(), or if another repair of the range began since.
+    void commit(const key& k, uint64_t seed, repair_hash hash, gc_clock::time_point now) noexcept {
+        auto e = find_entry(k);
+        if (!e || e->pending_seed != seed) {
+            return;
+        }
+        e->pending_seed = std::nullopt;
+        e->summary = repair_range_summary{seed, hash};
+        e->committed_at = now;
+    }
+
+    // Returns the summary of the range of k, if it was committed after
+    // min_committed_at and not dropped since.
+    std::optional<repair_range_summary> find(const key& k, gc_clock::time_point min_committed_at) {
+        auto e = find_entry(k);
+        if (!e || !e->summary || e->committed_at < min_committed_at) {
+            return std::nullopt;
+        }
+        return e->summary;
+    }
+
+    // Drops the summaries of the range holding t.
+    void invalidate(dht::token t) noexcept {
+        // The range ending at t may exclude it, and the next one start at it.
+        for (auto it = _ranges.lower_bound(t); it != _ranges.end(); ++it) {
+            if (it->second.range.contains(t, dht::token_comparator())) {
+                _ranges.erase(it);
+                return;
+            }
+            if (it->first != t) {
+                return;
+            }
+        }
+    }
+
+    // Drops the summaries of the ranges overlapping r.
+    void invalidate(const dht::token_range& r) noexcept {
+        std::erase_if(_ranges, [&r] (const auto& x) {
+            return x.second.range.overlaps(r, dht::token_comparator());
+        });
+    }
+
+    void clear() noexcept {
+        _ranges.clear();
+    }
+};
+
+}
@@ -37,6 +37,7 @@
 #include "db/view/view_update_generator.hh"
 #include <boost/range/adaptor/transformed.hpp>
 #include <boost/range/adaptor/map.hpp>
+#include <boost/range/join.hpp>
 #include "utils/error_injection.hh"
 #include "utils/histogram_metrics_helper.hh"
 #include "utils/fb_utilities.hh"
@@ -57,6 +58,14 @@
 #include "readers/multi_range.hh"
 #include "readers/combined.hh"
 #include "readers/compacting.hh"
+#include "idl/keys.dist.hh"
+#include "idl/range.dist.hh"
+#include "idl/uuid.dist.hh"
+#include "idl/read_command.dist.hh"
+#include "idl/keys.dist.impl.hh"
+#include "idl/range.dist.impl.hh"
+#include "idl/uuid.dist.impl.hh"
+#include "idl/read_command.dist.impl.hh"
 
 namespace replica {
 
@@ -139,6 +148,8 @@ lw_shared_ptr<sstables::sstable_set> table::make_maintenance_sstable_set() const
 
 void table::refresh_compound_sstable_set() {
     _sstables = make_compound_sstable_set();
+    _digest_cache.clear();
+    _result_cache.clear();
 }
 
 // Exposed for testing, not performance critical.
@@ -296,6 +307,16 @@ sstables::shared_sstable table::make_streaming_staging_sstable() {
     return make_streaming_sstable_for_write(sstables::staging_dir);
 }
 
+sstables::shared_sstable table::make_streamed_sstable(sstables::sstable_version_types v, sstables::sstable_format_types f, std::optional<sstring> subdir) {
+    sstring dir = _config.datadir;
+    if (subdir) {
+        dir += "/" + *subdir;
+    }
+    auto newtab = get_sstables_manager().make_sstable(_schema, *_storage_opts, dir, calculate_generation_for_new_table(), v, f);
+    tlogger.debug("Created sstable for streamed sstable: ks={}, cf={}, dir={}, version={}", schema()->ks_name(), schema()->cf_name(), dir, v);
+    return newtab;
+}
+
 flat_mutation_reader_v2
 table::make_streaming_reader(schema_ptr s, reader_permit permit,
                            const dht::partition_range_vector& ranges) const {
@@ -315,6 +336,20 @@ table::make_streaming_reader(schema_ptr s, reader_permit permit,
     return make_flat_multi_range_reader(s, std::move(permit), std::move(source), ranges, slice, pc, nullptr, mutation_reader::forwarding::no);
 }
 
+flat_mutation_reader_v2
+table::make_streaming_reader(schema_ptr s, reader_permit permit,
+                           const dht::partition_range_vector& ranges, std::vector<sstables::shared_sstable> excluded) const {
+    auto& slice = s->full_slice();
+    auto& pc = service::get_local_streaming_priority();
+
+    auto source = mutation_source([this, excluded = make_lw_shared(std::move(excluded))] (schema_ptr s, reader_permit permit, const dht::partition_range& range, const query::partition_slice& slice,
+                                      const io_priority_class& pc, tracing::trace_state_ptr trace_state, streamed_mutation::forwarding fwd, mutation_reader::forwarding fwd_mr) {
+        return make_reader_v2_excluding_sstables(std::move(s), std::move(permit), *excluded, range, slice, pc, std::move(trace_state), fwd, fwd_mr);
+    });
+
+    return make_flat_multi_range_reader(s, std::move(permit), std::move(source), ranges, slice, pc, nullptr, mutation_reader::forwarding::no);
+}
+
 flat_mutation_reader_v2 table::make_streaming_reader(schema_ptr schema, reader_permit permit, const dht::partition_range& range,
         const query::partition_slice& slice, mutation_reader::forwarding fwd_mr) const {
     const auto& pc = service::get_local_streaming_priority();
@@ -419,6 +454,14 @@ sstables::shared_sstable table::make_sstable() {
     return make_sstable(_config.datadir);
 }
 
+sstables::shared_sstable table::make_cold_sstable() {
+    if (!has_cold_storage()) {
+        on_internal_error(tlogger, format("make_cold_sstable: table {}.{} has no cold storage", _schema->ks_name(), _schema->cf_name()));
+    }
+    auto& sstm = get_sstables_manager();
+    return sstm.make_sstable(_schema, *_config.cold_storage_opts, _config.datadir, calculate_generation_for_new_table(), sstm.get_highest_supported_format(), sstables::sstable::format_types::big);
+}
+
 void table::notify_bootstrap_or_replace_start() {
     _is_bootstrap_or_replace = true;
 }
@@ -574,20 +617,60 @@ void table::update_stats_for_new_sstable(const sstables::shared_sstable& sst) no
     _stats.live_sstable_count++;
 }
 
+void table::update_stats_for_compaction(const sstables::compaction_completion_desc& desc) noexcept {
+    for (auto& sst : desc.old_sstables) {
+        _stats.compaction_bytes_read += sst->bytes_on_disk();
+    }
+    for (auto& sst : desc.new_sstables) {
+        _stats.compaction_bytes_written += sst->bytes_on_disk();
+    }
+}
+
 future<>
 table::do_add_sstable_and_update_cache(sstables::shared_sstable sst, sstables::offstrategy offstrategy) {
-    auto permit = co_await seastar::get_units(_sstable_set_mutation_sem, 1);
-    co_return co_await get_row_cache().invalidate(row_cache::external_updater([this, sst, offstrategy] () noexcept {
-        // FIXME: this is not really noexcept, but we need to provide strong exception guarantees.
-        // atomically load all opened sstables into column family.
-        compaction_group& cg = compaction_group_for_sstable(sst);
-        if (!offstrategy) {
-            add_sstable(cg, sst);
-        } else {
-            add_maintenance_sstable(cg, sst);
+    // The set with the new sstable is built in prepare(), which yields, rather
+    // than copied in execute(), which is atomic and would stall for tables with
+    // many sstables, e.g. when all of them are loaded one by one.
+    class sstable_adder : public row_cache::external_updater_impl {
+        table& _t;
+        compaction_group& _cg;
+        table::sstable_list_builder _builder;
+        std::vector<sstables::shared_sstable> _new;
+        sstables::offstrategy _offstrategy;
+        lw_shared_ptr<sstables::sstable_set> _new_sstables;
+    public:
+        sstable_adder(table& t, table::sstable_list_builder::permit_t permit, sstables::shared_sstable sst, sstables::offstrategy offstrategy)
+            : _t(t), _cg(t.compaction_group_for_sstable(sst)), _builder(std::move(permit)), _new{std::move(sst)}, _offstrategy(offstrategy) {}
+        virtual future<> prepare() override {
+            if (belongs_to_other_shard(_new.front()->get_shards_for_this_sstable())) {
+                on_internal_error(tlogger, format("Attempted to load the shared SSTable {} at table", _new.front()->get_filename()));
+            }
+            std::vector<sstables::shared_sstable> empty;
+            if (!_offstrategy) {
+                _new_sstables = co_await _builder.build_new_list(*_cg.main_sstables(), _t._compaction_strategy.make_sstable_set(_t._schema), _new, empty);
+            } else {
+                _new_sstables = co_await _builder.build_new_list(*_cg.maintenance_sstables(), std::move(*_t.make_maintenance_sstable_set()), _new, empty);
+            }
+        }
+        virtual void execute() override {
+            auto& sst = _new.front();
+            if (!_offstrategy) {
+                _cg.set_main_sstables(std::move(_new_sstables));
+                table::add_sstable_to_backlog_tracker(_cg.get_backlog_tracker(), sst);
+            } else {
+                _cg.set_maintenance_sstables(std::move(_new_sstables));
+            }
+            _t.refresh_compound_sstable_set();
+            _t.update_stats_for_new_sstable(sst);
+            _t._repair_range_summaries.invalidate(dht::token_range::make({sst->get_first_decorated_key().token(), true}, {sst->get_last_decorated_key().token(), true}));
         }
-        update_stats_for_new_sstable(sst);
-    }), dht::partition_range::make({sst->get_first_decorated_key(), true}, {sst->get_last_decorated_key(), true}));
+        static std::unique_ptr<row_cache::external_updater_impl> make(table& t, table::sstable_list_builder::permit_t permit, sstables::shared_sstable sst, sstables::offstrategy offstrategy) {
+            return std::make_unique<sstable_adder>(t, std::move(permit), std::move(sst), offstrategy);
+        }
+    };
+    auto permit = co_await seastar::get_units(_sstable_set_mutation_sem, 1);
+    auto range = dht::partition_range::make({sst->get_first_decorated_key(), true}, {sst->get_last_decorated_key(), true});
+    co_return co_await get_row_cache().invalidate(row_cache::external_updater(sstable_adder::make(*this, std::move(permit), std::move(sst), offstrategy)), range);
 }
 
 future<>
@@ -627,6 +710,7 @@ table::update_cache(compaction_group& cg, lw_shared_ptr<memtable> m, std::vector
         for (auto& sst : ssts) {
             add_sstable(cg, sst);
             update_stats_for_new_sstable(sst);
+            _stats.memtable_flushed_bytes += sst->bytes_on_disk();
         }
         m->mark_flushed(std::move(new_ssts_ms));
         try_trigger_compaction(cg);
@@ -819,6 +903,9 @@ table::seal_active_memtable(compaction_group& cg, flush_permit&& flush_permit) n
     }));
 
     co_await with_retry([&] () -> future<> {
+        if (_config.cache_only) {
+            co_return co_await move_memtable_to_cache(cg, old);
+        }
         // Reacquiring the write permit might be needed if retrying flush
         if (!permit.has_sstable_write_permit()) {
             tlogger.debug("seal_active_memtable: reacquiring write permit");
@@ -847,6 +934,50 @@ table::seal_active_memtable(compaction_group& cg, flush_permit&& flush_permit) n
     // FIXME: provide back-pressure to upper layers
 }
 
+// Splitting a memtable is not worth the extra sstables below this size per writer.
+static constexpr size_t min_memtable_flush_bytes_per_writer = 32 << 20;
+
+size_t table::memtable_flush_writers(const memtable& mt) const {
+    size_t max_writers = std::max(_config.memtable_flush_writers(), 1u);
+    return std::clamp<size_t>(mt.occupancy().used_space() / min_memtable_flush_bytes_per_writer, 1, max_writers);
+}
+
+// Returns the max purgeable timestamp of the partitions of a memtable being
+// flushed, to compact them like compaction would: the data of the partition in
+// the other memtables and in the sstables of the compaction group holds back
+// the purging of tombstones which aren't older than it. The keys must be
+// passed in ring order.
+static std::function<api::timestamp_type(const dht::decorated_key&)>
+make_flush_max_purgeable(compaction_group& cg, const memtable& flushed) {
+    auto memtables_min_timestamp = api::max_timestamp;
+    for (const auto& mt : *cg.memtables()) {
+        if (mt.get() != &flushed) {
+            memtables_min_timestamp = std::min(memtables_min_timestamp, mt->get_min_timestamp());
+        }
+    }
+    auto set = cg.make_compound_sstable_set();
+    auto selector = make_lw_shared<sstables::sstable_set::incremental_selector>(set->make_incremental_selector());
+    auto compacted_undeleted = cg.compacted_undeleted_sstables();
+    return [set = std::move(set), selector = std::move(selector), compacted_undeleted = std::move(compacted_undeleted), memtables_min_timestamp, s = flushed.schema()]
+            (const dht::decorated_key& dk) {
+        auto timestamp = memtables_min_timestamp;
+        std::optional<utils::hashed_key> hk;
+        for (auto&& sst : boost::range::join(selector->select(dk).sstables, compacted_undeleted)) {
+            auto min_timestamp = sst->get_stats_metadata().min_timestamp;
+            if (min_timestamp >= timestamp) {
+                continue;
+            }
+            if (!hk) {
+                hk = sstables::sstable::make_hashed_key(*s, dk.key());
+            }
+            if (sst->filter_has_key(*hk)) {
+                timestamp = min_timestamp;
+            }
+        }
+        return timestamp;
+    };
+}
+
 future<>
 table::try_flush_memtable_to_sstable(compaction_group& cg, lw_shared_ptr<memtable> old, sstable_write_permit&& permit) {
     auto try_flush = [this, old = std::move(old), permit = make_lw_shared(std::move(permit)), &cg] () mutable -> future<> {
@@ -872,7 +1003,10 @@ table::try_flush_memtable_to_sstable(compaction_group& cg, lw_shared_ptr<memtabl
             co_await _compaction_manager.maybe_wait_for_sstable_count_reduction(cg.as_table_state());
         }
 
-        auto consumer = _compaction_strategy.make_interposer_consumer(metadata, [this, old, permit, &newtabs, estimated_partitions, &cg] (flat_mutation_reader_v2 reader) mutable -> future<> {
+        auto ranges = old->split_for_flush(memtable_flush_writers(*old));
+        estimated_partitions /= ranges.size();
+
+        auto flush_to_sstables = [this, old, permit, &newtabs, estimated_partitions, &cg] (flat_mutation_reader_v2 reader) mutable -> future<> {
           std::exception_ptr ex;
           try {
             auto&& priority = service::get_local_memtable_flush_priority();
@@ -892,12 +1026,40 @@ table::try_flush_memtable_to_sstable(compaction_group& cg, lw_shared_ptr<memtabl
           }
           co_await reader.close();
           co_await coroutine::return_exception_ptr(std::move(ex));
-        });
+        };
+
+        // Ranges of a split memtable are flushed concurrently, each into its own sstables.
+        // Only memtables with expired cells or tombstones have anything to compact.
+        const auto flush_compaction_time = gc_clock::now();
+        const bool compact = _config.memtable_flush_compaction() && old->get_encoding_stats().min_local_deletion_time <= flush_compaction_time;
+
+        auto flush_range = [this, old, &cg, &metadata, &flush_to_sstables, compact, flush_compaction_time, split = ranges.size() > 1] (const dht::partition_range& range) -> future<> {
+            auto reader = old->make_flush_reader(
+                old->schema(),
+                compaction_concurrency_semaphore().make_tracking_only_permit(old->schema().get(), "try_flush_memtable_to_sstable()", db::no_timeout, {}),
+                service::get_local_memtable_flush_priority(),
+                range);
+            if (compact) {
+                reader = make_compacting_reader(std::move(reader), flush_compaction_time, make_flush_max_purgeable(cg, *old),
+                        _compaction_manager.get_tombstone_gc_state());
+            }
+            if (split || compact) {
+                // Don't write empty sstables for ranges without partitions, or
+                // whose partitions were all compacted away.
+                auto empty = co_await coroutine::as_future(reader.peek());
+                if (empty.failed() || !empty.get0()) {
+                    co_await reader.close();
+                    if (empty.failed()) {
+                        co_await coroutine::return_exception_ptr(empty.get_exception());
+                    }
+                    co_return;
+                }
+            }
+            auto consumer = _compaction_strategy.make_interposer_consumer(metadata, flush_to_sstables);
+            co_await consumer(std::move(reader));
+        };
 
-        auto f = consumer(old->make_flush_reader(
-            old->schema(),
-            compaction_concurrency_semaphore().make_tracking_only_permit(old->schema().get(), "try_flush_memtable_to_sstable()", db::no_timeout, {}),
-            service::get_local_memtable_flush_priority()));
+        auto f = parallel_for_each(ranges, std::ref(flush_range));
 
         // Switch back to default scheduling group for post-flush actions, to avoid them being staved by the memtable flush
         // controller. Cache update does not affect the input of the memtable cpu controller, so it can be subject to
@@ -933,13 +1095,36 @@ table::try_flush_memtable_to_sstable(compaction_group& cg, lw_shared_ptr<memtabl
     co_return co_await with_scheduling_group(_config.memtable_scheduling_group, std::ref(try_flush));
 }
 
+future<>
+table::move_memtable_to_cache(compaction_group& cg, lw_shared_ptr<memtable> old) {
+    // The cache is the only place the data lives in, so readers of the memtable
+    // which outlive the move continue from the cache.
+    auto cache_source = mutation_source([this] (schema_ptr s,
+                                                reader_permit permit,
+                                                const dht::partition_range& range,
+                                                const query::partition_slice& slice,
+                                                const io_priority_class& pc,
+                                                tracing::trace_state_ptr trace_state,
+                                                streamed_mutation::forwarding fwd,
+                                                mutation_reader::forwarding fwd_mr) {
+        return _cache.make_reader(std::move(s), std::move(permit), range, slice, pc, std::move(trace_state), fwd, fwd_mr);
+    });
+    co_await with_scheduling_group(_config.memtable_to_cache_scheduling_group, [this, old, cache_source = std::move(cache_source)] () mutable {
+        return _cache.update(row_cache::external_updater([old, cache_source = std::move(cache_source)] () mutable {
+            old->mark_flushed(std::move(cache_source));
+        }), *old);
+    });
+    cg.memtables()->erase(old);
+    tlogger.debug("Memtable for {}.{} moved to cache", old->schema()->ks_name(), old->schema()->cf_name());
+}
+
 void
 table::start() {
     start_compaction();
 }
 
 future<>
-table::stop() {
+table::stop(save_sstable_owners save_owners) {
     if (_async_gate.is_closed()) {
         co_return;
     }
@@ -947,6 +1132,11 @@ table::stop() {
     co_await await_pending_ops();
     co_await parallel_foreach_compaction_group(std::mem_fn(&compaction_group::stop));
     co_await _sstable_deletion_gate.close();
+    if (save_owners) {
+        // Nothing changes the sstables of the table from now on.
+        auto sstables = get_sstables();
+        co_await sstables::sstable_directory::write_owners_manifests(std::vector<sstables::shared_sstable>(sstables->begin(), sstables->end()));
+    }
     co_await get_row_cache().invalidate(row_cache::external_updater([this] {
         for (const compaction_group_ptr& cg : compaction_groups()) {
             cg->clear_sstables();
@@ -971,6 +1161,13 @@ void table::set_metrics() {
                 ms::make_counter("memtable_rows_compacted_with_tombstones", _stats.memtable_app_stats.rows_compacted_with_tombstones, ms::description("Number of rows scanned during write of a tombstone for the purpose of compaction in memtables"))(cf)(ks).set_skip_when_empty(),
                 ms::make_counter("memtable_range_tombstone_reads", _stats.memtable_range_tombstone_reads, ms::description("Number of range tombstones read from memtables"))(cf)(ks).set_skip_when_empty(),
                 ms::make_counter("memtable_row_tombstone_reads", _stats.memtable_row_tombstone_reads, ms::description("Number of row tombstones read from memtables"))(cf)(ks),
+                ms::make_counter("digest_cache_hits", _stats.digest_cache_hits, ms::description("Number of digest reads answered from the partition digest cache"))(cf)(ks).set_skip_when_empty(),
+                ms::make_counter("result_cache_hits", _stats.result_cache_hits, ms::description("Number of data reads answered from the query result cache"))(cf)(ks).set_skip_when_empty(),
+                ms::make_counter("filtered_reads_skipped", _stats.filtered_reads_skipped, ms::description("Number of filtered reads answered without reading, as the column value statistics of the sstables showed no row could pass the filters"))(cf)(ks).set_skip_when_empty(),
+                ms::make_counter("counter_shard_cache_hits", [this] { return _counter_shard_cache.get_stats().hits; }, ms::description("Number of counter updates which didn't read the counter cells they update, thanks to the counter shard cache"))(cf)(ks).set_skip_when_empty(),
+                ms::make_counter("memtable_flushed_bytes", _stats.memtable_flushed_bytes, ms::description("Number of bytes of the sstables written by memtable flushes"))(cf)(ks).set_skip_when_empty(),
+                ms::make_counter("compaction_bytes_read", _stats.compaction_bytes_read, ms::description("Number of bytes of the sstables replaced by compactions"))(cf)(ks).set_skip_when_empty(),
+                ms::make_counter("compaction_bytes_written", _stats.compaction_bytes_written, ms::description("Number of bytes of the sstables written by compactions. Together with memtable_flushed_bytes, it gives the write amplification of the table"))(cf)(ks).set_skip_when_empty(),
                 ms::make_gauge("pending_tasks", ms::description("Estimated number of tasks pending for this column family"), _stats.pending_flushes)(cf)(ks),
                 ms::make_gauge("live_disk_space", ms::description("Live disk space used"), _stats.live_disk_space_used)(cf)(ks),
                 ms::make_gauge("total_disk_space", ms::description("Total disk space used"), _stats.total_disk_space_used)(cf)(ks),
@@ -1013,7 +1210,23 @@ void table::set_metrics() {
                     ms::make_histogram("cas_prepare_latency", ms::description("CAS prepare round latency histogram"), [this] {return to_metrics_histogram(_stats.cas_prepare.histogram());})(cf)(ks).aggregate({seastar::metrics::shard_label}).set_skip_when_empty(),
                     ms::make_histogram("cas_propose_latency", ms::description("CAS accept round latency histogram"), [this] {return to_metrics_histogram(_stats.cas_accept.histogram());})(cf)(ks).aggregate({seastar::metrics::shard_label}).set_skip_when_empty(),
                     ms::make_histogram("cas_commit_latency", ms::description("CAS learn round latency histogram"), [this] {return to_metrics_histogram(_stats.cas_learn.histogram());})(cf)(ks).aggregate({seastar::metrics::shard_label}).set_skip_when_empty(),
-                    ms::make_gauge("cache_hit_rate", ms::description("Cache hit rate"), [this] {return float(_global_cache_hit_rate);})(cf)(ks)
+                    ms::make_histogram("sstables_per_read", ms::description("Histogram of the number of sstables read by single-partition reads"), [this] {return _stats.estimated_sstable_per_read.get_histogram(1, 8);})(cf)(ks).aggregate({seastar::metrics::shard_label}).set_skip_when_empty(),
+                    ms::make_gauge("cache_hit_rate", ms::description("Cache hit rate"), [this] {return float(_global_cache_hit_rate);})(cf)(ks),
+                    ms::make_gauge("cache_partitions", ms::description("Number of partitions of the table in the row cache"), [this] {return _cache.partition_count();})(cf)(ks),
+                    ms::make_gauge("cache_bytes_estimate", ms::description("Estimated row cache memory used by the table, its share of cached partitions of the memory used by all of them"),
+                            [this] {return _cache.estimated_memory_usage();})(cf)(ks),
+                    ms::make_gauge("cache_memory_quota", ms::description("Soft limit of the row cache memory of the table, set by the memory_quota_in_mb caching option, 0 if unlimited"),
+                            [this] {return _cache.memory_quota();})(cf)(ks),
+                    ms::make_counter("cache_single_partition_reads_with_misses", ms::description("Number of single-partition reads which had to read from sstables because of row cache misses"),
+                            [this] {return _cache.stats().single_partition_reads_with_misses;})(cf)(ks),
+                    ms::make_counter("cache_range_reads_with_misses", ms::description("Number of range reads which had to read from sstables because of row cache misses"),
+                            [this] {return _cache.stats().range_reads_with_misses;})(cf)(ks),
+                    ms::make_counter("cache_miss_sstables_read", ms::description("Number of sstable readers created by reads which missed in row cache"),
+                            [this] {return _cache.stats().miss_sstables_read;})(cf)(ks),
+                    ms::make_counter("cache_miss_bytes_read", ms::description("Bytes read from sstable files by reads which missed in row cache"),
+                            [this] {return _cache.stats().miss_bytes_read;})(cf)(ks),
+                    ms::make_counter("cache_miss_index_pages_read", ms::description("Number of partition index pages loaded by reads which missed in row cache"),
+                            [this] {return _cache.stats().miss_index_pages_read;})(cf)(ks)
             });
         }
     }
@@ -1462,6 +1675,40 @@ lw_shared_ptr<const sstable_list> table::get_sstables_including_compacted_undele
     return ret;
 }
 
+void table::load_deferred_sstable_filters() {
+    (void)with_gate(_async_gate, [this] {
+        return with_scheduling_group(_config.streaming_scheduling_group, [this] {
+            return do_load_deferred_sstable_filters();
+        });
+    }).handle_exception([this] (std::exception_ptr ep) {
+        tlogger.warn("{}.{}: failed to load deferred sstable filters: {}", schema()->ks_name(), schema()->cf_name(), ep);
+    });
+}
+
+future<> table::do_load_deferred_sstable_filters() {
+    auto sstables = get_sstables();
+    unsigned loaded = 0;
+    for (auto& sst : *sstables) {
+        if (_async_gate.is_closed()) {
+            co_return;
+        }
+        if (!sst->filter_deferred()) {
+            continue;
+        }
+        try {
+            co_await sst->load_deferred_filter();
+            ++loaded;
+        } catch (...) {
+            // The sstable may have been compacted away meanwhile. Either way, it keeps
+            // using the always-present filter, which is correct, just slower.
+            tlogger.debug("{}.{}: failed to load filter of {}: {}", schema()->ks_name(), schema()->cf_name(), sst->get_filename(), std::current_exception());
+        }
+    }
+    if (loaded) {
+        tlogger.debug("{}.{}: loaded {} deferred sstable filters", schema()->ks_name(), schema()->cf_name(), loaded);
+    }
+}
+
 const std::vector<sstables::shared_sstable>& compaction_group::compacted_undeleted_sstables() const noexcept {
     return _sstables_compacted_but_not_deleted;
 }
@@ -1486,7 +1733,7 @@ compaction_group::compaction_group(table& t, dht::token_range token_range)
     , _table_state(std::make_unique<table_state>(t, *this))
     , _token_range(std::move(token_range))
     , _compaction_strategy_state(compaction::compaction_strategy_state::make(_t._compaction_strategy))
-    , _memtables(_t._config.enable_disk_writes ? _t.make_memtable_list(*this) : _t.make_memory_only_memtable_list())
+    , _memtables(_t._config.enable_disk_writes || _t._config.cache_only ? _t.make_memtable_list(*this) : _t.make_memory_only_memtable_list())
     , _main_sstables(make_lw_shared<sstables::sstable_set>(t._compaction_strategy.make_sstable_set(t.schema())))
     , _maintenance_sstables(t.make_maintenance_sstable_set())
 {
@@ -1539,8 +1786,11 @@ table::table(schema_ptr schema, config config, lw_shared_ptr<const storage_optio
     , _sstables_manager(sst_manager)
     , _index_manager(this->as_data_dictionary())
     , _counter_cell_locks(_schema->is_counter() ? std::make_unique<cell_locker>(_schema, cl_stats) : nullptr)
+    , _counter_shard_cache(_schema->is_counter() ? _config.counter_shard_cache_entries : 0)
     , _row_locker(_schema)
     , _off_strategy_trigger([this] { trigger_offstrategy_compaction(); })
+    , _digest_cache(_config.partition_digest_cache_entries)
+    , _result_cache(_config.result_cache_budget)
 {
     if (!_config.enable_disk_writes) {
         tlogger.warn("Writes disabled, column family no durable.");
@@ -1844,6 +2094,10 @@ future<> table::clear() {
     auto permits = co_await _config.dirty_memory_manager->get_all_flush_permits();
 
     co_await parallel_foreach_compaction_group(std::mem_fn(&compaction_group::clear_memtables));
+    _digest_cache.clear();
+    _result_cache.clear();
+    _counter_shard_cache.clear();
+    _repair_range_summaries.clear();
 
     co_await _cache.invalidate(row_cache::external_updater([] { /* There is no underlying mutation source */ }));
 }
@@ -1899,6 +2153,8 @@ future<db::replay_position> table::discard_sstables(db_clock::time_point truncat
             p->prune(*cg, truncated_at);
         }
         refresh_compound_sstable_set();
+        _counter_shard_cache.clear();
+        _repair_range_summaries.clear();
         tlogger.debug("cleaning out row cache");
     }));
     rebuild_statistics();
@@ -1927,6 +2183,10 @@ void table::set_schema(schema_ptr s) {
     if (_counter_cell_locks) {
         _counter_cell_locks->set_schema(s);
     }
+    // Column ids may change with the schema.
+    _counter_shard_cache.clear();
+    // So may the rows repair reads and hashes.
+    _repair_range_summaries.clear();
     _schema = std::move(s);
 
     for (auto&& v : _views) {
@@ -2017,6 +2277,9 @@ future<> table::generate_and_propagate_view_updates(shared_ptr<db::view::view_up
             now);
 
     std::exception_ptr err = nullptr;
+    // The next updates are built, reading the existing rows they need, while
+    // the previous ones are propagated.
+    future<> propagated = make_ready_future<>();
     while (true) {
         std::optional<utils::chunked_vector<frozen_mutation_and_schema>> updates;
         try {
@@ -2030,16 +2293,15 @@ future<> table::generate_and_propagate_view_updates(shared_ptr<db::view::view_up
         }
         tracing::trace(tr_state, "Generated {} view update mutations", updates->size());
         auto units = seastar::consume_units(*_config.view_update_concurrency_semaphore, memory_usage_of(*updates));
-        try {
-            co_await gen->mutate_MV(base_token, std::move(*updates), _view_stats, *_config.cf_stats, tr_state,
-                std::move(units), service::allow_hints::yes, db::view::wait_for_all_updates::no);
-        } catch (...) {
-            // Ignore exceptions: any individual failure to propagate a view update will be reported
-            // by a separate mechanism in mutate_MV() function. Moreover, we should continue trying
-            // to generate updates even if some of them fail, in order to minimize the potential
-            // inconsistencies caused by not being able to propagate an update
-        }
-    }
+        co_await std::move(propagated);
+        // Ignore exceptions: any individual failure to propagate a view update will be reported
+        // by a separate mechanism in mutate_MV() function. Moreover, we should continue trying
+        // to generate updates even if some of them fail, in order to minimize the potential
+        // inconsistencies caused by not being able to propagate an update
+        propagated = gen->mutate_MV(base_token, std::move(*updates), _view_stats, *_config.cf_stats, tr_state,
+                std::move(units), service::allow_hints::yes, db::view::wait_for_all_updates::no).handle_exception([] (std::exception_ptr) { });
+    }
+    co_await std::move(propagated);
     co_await builder.close();
     if (err) {
         std::rethrow_exception(err);
@@ -2142,7 +2404,7 @@ future<> table::populate_views(
         shared_ptr<db::view::view_update_generator> gen,
         std::vector<db::view::view_and_base> views,
         dht::token base_token,
-        flat_mutation_reader_v2&& reader,
+        flat_mutation_reader_v2 reader,
         gc_clock::time_point now) {
     auto schema = reader.schema();
     db::view::view_update_builder builder = db::view::make_view_update_builder(
@@ -2185,6 +2447,27 @@ size_t table::estimate_read_memory_cost() const {
     return new_reader_base_cost;
 }
 
+// Reads returning up to this many rows from each partition are considered point reads.
+static constexpr uint64_t max_point_read_rows = 100;
+
+read_cost table::estimate_read_cost(const query::read_command& cmd, std::span<const dht::partition_range> ranges) const {
+    read_cost cost{read_lane::point, 0};
+    const auto row_limit = std::min(cmd.get_row_limit(), cmd.slice.partition_row_limit());
+    const bool bounded_rows = row_limit <= max_point_read_rows || std::ranges::all_of(cmd.slice.default_row_ranges(),
+            [] (const query::clustering_range& r) { return r.is_singular(); });
+    if (!bounded_rows) {
+        cost.lane = read_lane::scan;
+    }
+    for (auto& range : ranges) {
+        if (!range.is_singular()) {
+            cost.lane = read_lane::scan;
+        }
+        auto sstables = _sstables->count(range);
+        cost.sstables = std::min<size_t>(cost.sstables + sstables, std::numeric_limits<uint32_t>::max());
+    }
+    return cost;
+}
+
 void table::set_hit_rate(gms::inet_address addr, cache_temperature rate) {
     auto& e = _cluster_cache_hit_rates[addr];
     e.rate = rate;
@@ -2258,6 +2541,13 @@ void table::do_apply(compaction_group& cg, db::rp_handle&& h, Args&&... args) {
 
 future<> table::apply(const mutation& m, db::rp_handle&& h, db::timeout_clock::time_point timeout) {
     return dirty_memory_region_group().run_when_memory_available([this, &m, h = std::move(h)] () mutable {
+        if (_digest_cache.enabled()) {
+            _digest_cache.invalidate(*_schema, m.decorated_key());
+        }
+        _result_cache.invalidate(*_schema, m.decorated_key());
+        if (!_repair_range_summaries.empty()) {
+            _repair_range_summaries.invalidate(m.token());
+        }
         do_apply(compaction_group_for_token(m.token()), std::move(h), m);
     }, timeout);
 }
@@ -2270,6 +2560,18 @@ future<> table::apply(const frozen_mutation& m, schema_ptr m_schema, db::rp_hand
     }
 
     return dirty_memory_region_group().run_when_memory_available([this, &m, m_schema = std::move(m_schema), h = std::move(h)]() mutable {
+        if (_digest_cache.enabled()) {
+            _digest_cache.invalidate(*_schema, m.decorated_key(*m_schema));
+        }
+        if (_result_cache.size()) {
+            _result_cache.invalidate(*_schema, m.decorated_key(*m_schema));
+        } else {
+            // Nothing to drop, but reads in progress must not insert their results.
+            _result_cache.clear();
+        }
+        if (!_repair_range_summaries.empty()) {
+            _repair_range_summaries.invalidate(dht::get_token(*m_schema, m.key()));
+        }
         do_apply(compaction_group_for_key(m.key(), m_schema), std::move(h), m, m_schema);
     }, timeout);
 }
@@ -2325,6 +2627,7 @@ struct query_state {
             , partition_limit(cmd.partition_limit)
             , current_partition_range(ranges.begin())
             , range_end(ranges.end()){
+        builder.set_filters(cmd.filters);
     }
     schema_ptr schema;
     const query::read_command& cmd;
@@ -2335,7 +2638,7 @@ struct query_state {
     dht::partition_range_vector::const_iterator current_partition_range;
     dht::partition_range_vector::const_iterator range_end;
     uint64_t remaining_rows() const {
-        return limit - builder.row_count();
+        return limit - builder.row_count() - builder.filtered_rows();
     }
     uint32_t remaining_partitions() const {
         return partition_limit - builder.partition_count();
@@ -2345,6 +2648,96 @@ struct query_state {
     }
 };
 
+void table::note_tombstones_read(const dht::partition_range& range, const compaction_stats& page_stats) {
+    auto threshold = _config.tombstone_compaction_read_threshold();
+    auto tombstones = page_stats.static_rows.dead + page_stats.clustering_rows.dead + page_stats.range_tombstones;
+    if (!threshold || tombstones < threshold || !range.is_singular()) {
+        return;
+    }
+    bool newly_marked = false;
+    for (auto& sst : select_sstables(range)) {
+        newly_marked |= !sst->tombstones_read();
+        sst->add_tombstones_read(tombstones);
+    }
+    if (newly_marked) {
+        tlogger.debug("Read {} tombstones from {}.{} partition {}, triggering compaction", tombstones, _schema->ks_name(), _schema->cf_name(), range);
+        trigger_compaction();
+    }
+}
+
+// Whether some live value of the column in the sstable may pass the filter.
+static bool may_pass_filter(const sstables::sstable& sst, const column_definition& cdef, const query::column_filter& f) {
+    auto* stats = sst.get_column_value_stats(cdef.name());
+    if (!stats) {
+        return true;
+    }
+    if (!stats->values) {
+        return false;
+    }
+    if (!stats->bounded) {
+        return true;
+    }
+    auto& type = cdef.type->without_reversed();
+    auto value = managed_bytes_view(bytes_view(f.value));
+    auto cmp_min = type.compare(managed_bytes_view(bytes_view(stats->min_value.value)), value);
+    auto cmp_max = type.compare(managed_bytes_view(bytes_view(stats->max_value.value)), value);
+    switch (f.oper) {
+    case query::column_filter::op::eq: return cmp_min <= 0 && cmp_max >= 0;
+    case query::column_filter::op::neq: return cmp_min != 0 || cmp_max != 0;
+    case query::column_filter::op::lt: return cmp_min < 0;
+    case query::column_filter::op::lte: return cmp_min <= 0;
+    case query::column_filter::op::gt: return cmp_max > 0;
+    case query::column_filter::op::gte: return cmp_max >= 0;
+    }
+    return true;
+}
+
+// A row passes a filter only with a live value of the column, which it takes
+// from one of the sources of the read. So when the memtables are empty, and
+// one of the filters can't pass any value of the sstables holding the ranges,
+// no row can pass all the filters.
+bool table::filters_exclude_all_rows(const schema& s, const query::read_command& cmd, const dht::partition_range_vector& ranges) const {
+    if (cmd.filters.empty() || !cmd.slice.options.contains<query::partition_slice::option::allow_short_read>() || _virtual_reader) {
+        return false;
+    }
+    for (const compaction_group_ptr& cg : compaction_groups()) {
+        for (auto& mt : *cg->memtables()) {
+            if (!mt->empty()) {
+                return false;
+            }
+        }
+    }
+    std::vector<sstables::shared_sstable> sstables;
+    for (auto& range : ranges) {
+        auto ssts = select_sstables(range);
+        sstables.insert(sstables.end(), ssts.begin(), ssts.end());
+    }
+    return std::ranges::any_of(cmd.filters, [&] (const query::column_filter& f) {
+        auto& cdef = s.regular_column_at(f.column);
+        return std::ranges::none_of(sstables, [&] (const sstables::shared_sstable& sst) {
+            return may_pass_filter(*sst, cdef, f);
+        });
+    });
+}
+
+// Whether the ranges are single partitions in increasing order, which can be
+// read ahead of each other by a single reader.
+static bool are_ordered_partitions(const schema& s, dht::partition_range_vector::const_iterator begin, dht::partition_range_vector::const_iterator end) {
+    if (std::distance(begin, end) < 2) {
+        return false;
+    }
+    dht::ring_position_comparator cmp(s);
+    for (auto it = begin; it != end; ++it) {
+        if (!it->is_singular()) {
+            return false;
+        }
+        if (it != begin && cmp(std::prev(it)->start()->value(), it->start()->value()) >= 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
 future<lw_shared_ptr<query::result>>
 table::query(schema_ptr s,
         reader_permit permit,
@@ -2359,6 +2752,44 @@ table::query(schema_ptr s,
         co_return make_lw_shared<query::result>();
     }
 
+    std::optional<partition_digest_cache::key> digest_cache_key;
+    auto digest_cache_generation = _digest_cache.generation();
+    if (_digest_cache.enabled() && opts.request == query::result_request::only_digest && !_virtual_reader
+            && partition_ranges.size() == 1 && partition_ranges.front().is_singular() && partition_ranges.front().start()->value().has_key()
+            && !(saved_querier && *saved_querier)) {
+        bytes_ostream command;
+        ser::serialize(command, cmd.slice);
+        ser::serialize(command, cmd.get_row_limit());
+        ser::serialize(command, cmd.partition_limit);
+        ser::serialize(command, cmd.filters);
+        digest_cache_key = partition_digest_cache::key{partition_ranges.front().start()->value().as_decorated_key(), s->version(), opts.digest_algo,
+                to_bytes(command.linearize())};
+        if (auto r = _digest_cache.find(*s, *digest_cache_key)) {
+            ++_stats.digest_cache_hits;
+            tracing::trace(trace_state, "Digest found in the partition digest cache");
+            co_return make_lw_shared<query::result>(std::move(*r));
+        }
+    }
+
+    std::optional<query_result_cache::key> result_cache_key;
+    auto result_cache_generation = _result_cache.generation();
+    auto results_ttl = s->caching_options().results_ttl();
+    if (results_ttl.count() && opts.request != query::result_request::only_digest && !_virtual_reader
+            && !(saved_querier && *saved_querier)
+            && !cmd.slice.options.contains<query::partition_slice::option::bypass_cache>()) {
+        bytes_ostream command;
+        ser::serialize(command, cmd.slice);
+        ser::serialize(command, cmd.get_row_limit());
+        ser::serialize(command, cmd.partition_limit);
+        ser::serialize(command, cmd.filters);
+        result_cache_key = query_result_cache::key{s->version(), opts.request, opts.digest_algo, to_bytes(command.linearize()), partition_ranges};
+        if (auto r = _result_cache.find(*s, *result_cache_key, results_ttl)) {
+            ++_stats.result_cache_hits;
+            tracing::trace(trace_state, "Result found in the query result cache");
+            co_return make_lw_shared<query::result>(std::move(*r));
+        }
+    }
+
     _async_gate.enter();
     utils::latency_counter lc;
     _stats.reads.set_latency(lc);
@@ -2375,24 +2806,55 @@ table::query(schema_ptr s,
 
     query_state qs(s, cmd, opts, partition_ranges, std::move(accounter));
 
+    // The result only holds the values of the selected columns, and of the
+    // filtered ones, so unless the sstables are read to populate the cache
+    // the values of the other columns needn't be parsed.
+    std::optional<query::partition_slice> projected_slice;
+    if (cmd.slice.options.contains<query::partition_slice::option::bypass_cache>() && std::ranges::all_of(cmd.filters, [&] (const query::column_filter& f) {
+                return std::ranges::find(cmd.slice.regular_columns, f.column) != cmd.slice.regular_columns.end();
+            })) {
+        projected_slice = cmd.slice;
+        projected_slice->options.set<query::partition_slice::option::skip_unselected_values>();
+    }
+    const auto& reader_slice = projected_slice ? *projected_slice : qs.cmd.slice;
+
     std::optional<query::querier> querier_opt;
     if (saved_querier) {
         querier_opt = std::move(*saved_querier);
     }
 
-    while (!qs.done()) {
-        auto&& range = *qs.current_partition_range++;
+    const bool filtered_out = filters_exclude_all_rows(*s, cmd, partition_ranges);
+    if (filtered_out) {
+        ++_stats.filtered_reads_skipped;
+        tracing::trace(trace_state, "No sstable holds values passing the filters");
+    }
 
+    while (!filtered_out && !qs.done()) {
         if (!querier_opt) {
             query::querier_base::querier_config conf(_config.tombstone_warn_threshold);
-            querier_opt = query::querier(as_mutation_source(), s, permit, range, qs.cmd.slice,
-                    service::get_local_sstable_query_read_priority(), trace_state, conf);
+            auto read_ahead = _config.multi_partition_read_ahead();
+            if (read_ahead && are_ordered_partitions(*s, qs.current_partition_range, qs.range_end)) {
+                // Read all the remaining partitions with one querier, which
+                // starts reading the following partitions while it reads one.
+                auto range = dht::partition_range::make(qs.current_partition_range->start().value(), std::prev(qs.range_end)->end().value());
+                auto reader = make_prefetching_multi_range_reader(s, permit, as_mutation_source(),
+                        dht::partition_range_vector(qs.current_partition_range, qs.range_end), reader_slice, read_ahead,
+                        service::get_local_sstable_query_read_priority(), trace_state);
+                querier_opt = query::querier(std::move(reader), s, permit, std::move(range), reader_slice, conf);
+                qs.current_partition_range = qs.range_end;
+            } else {
+                querier_opt = query::querier(as_mutation_source(), s, permit, *qs.current_partition_range++, reader_slice,
+                        service::get_local_sstable_query_read_priority(), trace_state, conf);
+            }
+        } else {
+            ++qs.current_partition_range;
         }
         auto& q = *querier_opt;
 
         std::exception_ptr ex;
       try {
         co_await q.consume_page(query_result_builder(*s, qs.builder), qs.remaining_rows(), qs.remaining_partitions(), qs.cmd.timestamp, trace_state);
+        note_tombstones_read(q.range(), q.page_stats());
       } catch (...) {
         ex = std::current_exception();
       }
@@ -2410,7 +2872,7 @@ table::query(schema_ptr s,
         last_pos.emplace(*querier_opt->current_position());
     }
 
-    if (!saved_querier || (querier_opt && !querier_opt->are_limits_reached() && !qs.builder.is_short_read())) {
+    if (querier_opt && (!saved_querier || (!querier_opt->are_limits_reached() && !qs.builder.is_short_read()))) {
         co_await querier_opt->close();
         querier_opt = {};
     }
@@ -2418,7 +2880,19 @@ table::query(schema_ptr s,
         *saved_querier = std::move(querier_opt);
     }
 
-    co_return make_lw_shared<query::result>(qs.builder.build(std::move(last_pos)));
+    // The page was cut short by the rows filtered out, which the coordinator
+    // must not mistake for the end of the data.
+    if (qs.builder.filtered_rows() && !qs.remaining_rows()) {
+        qs.builder.mark_as_short_read();
+    }
+    auto result = make_lw_shared<query::result>(qs.builder.build(std::move(last_pos)));
+    if (digest_cache_key) {
+        _digest_cache.insert(*s, std::move(*digest_cache_key), *result, digest_cache_generation);
+    }
+    if (result_cache_key) {
+        _result_cache.insert(*s, std::move(*result_cache_key), *result, result_cache_generation);
+    }
+    co_return result;
 }
 
 future<reconcilable_result>
@@ -2483,15 +2957,15 @@ table::as_mutation_source() const {
     });
 }
 
-void table::add_coordinator_read_latency(utils::estimated_histogram::duration latency) {
-    _stats.estimated_coordinator_read.add(std::chrono::duration_cast<std::chrono::microseconds>(latency).count());
+void table::add_coordinator_read_latency(utils::latency_histogram::duration latency) {
+    _stats.estimated_coordinator_read.add(latency);
 }
 
-std::chrono::milliseconds table::get_coordinator_read_latency_percentile(double percentile) {
+std::chrono::microseconds table::get_coordinator_read_latency_percentile(double percentile) {
     if (_cached_percentile != percentile || lowres_clock::now() - _percentile_cache_timestamp > 1s) {
         _percentile_cache_timestamp = lowres_clock::now();
         _cached_percentile = percentile;
-        _percentile_cache_value = std::max(_stats.estimated_coordinator_read.percentile(percentile) / 1000, int64_t(1)) * 1ms;
+        _percentile_cache_value = std::chrono::microseconds(std::max(_stats.estimated_coordinator_read.quantile(percentile), uint64_t(1)));
         _stats.estimated_coordinator_read *= 0.9; // decay values a little to give new data points more weight
     }
     return _percentile_cache_value;
@@ -2769,6 +3243,12 @@ class compaction_group::table_state : public compaction::table_state {
     sstables::shared_sstable make_sstable() const override {
         return _t.make_sstable();
     }
+    bool has_cold_storage() const noexcept override {
+        return _t.has_cold_storage();
+    }
+    sstables::shared_sstable make_cold_sstable() const override {
+        return _t.make_cold_sstable();
+    }
     sstables::sstable_writer_config configure_writer(sstring origin) const override {
         return _t.get_sstables_manager().configure_writer(std::move(origin));
     }
@@ -2776,6 +3256,7 @@ class compaction_group::table_state : public compaction::table_state {
         return _cg.min_memtable_timestamp();
     }
     future<> on_compaction_completion(sstables::compaction_completion_desc desc, sstables::offstrategy offstrategy) override {
+        _t.update_stats_for_compaction(desc);
         if (offstrategy) {
             co_await _cg.update_sstable_lists_on_off_strategy_completion(std::move(desc));
             _cg.trigger_compaction();
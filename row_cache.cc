@@ -57,10 +57,14 @@ cache_tracker::cache_tracker(register_metrics with_metrics)
 
 static thread_local cache_tracker* current_tracker;
 
+// 16k counters per row, halved every 160k recorded accesses.
+static constexpr size_t admission_sketch_width = 16 * 1024;
+
 cache_tracker::cache_tracker(mutation_application_stats& app_stats, register_metrics with_metrics)
     : _garbage(_region, this, app_stats)
     , _memtable_cleaner(_region, nullptr, app_stats)
     , _app_stats(app_stats)
+    , _admission_sketch(admission_sketch_width)
 {
     if (with_metrics) {
         setup_metrics();
@@ -77,6 +81,9 @@ cache_tracker::cache_tracker(mutation_application_stats& app_stats, register_met
                 return memory::reclaiming_result::reclaimed_something;
             }
             current_tracker = this;
+            if (!_capped_caches.empty() && evict_over_quota() == memory::reclaiming_result::reclaimed_something) {
+                return memory::reclaiming_result::reclaimed_something;
+            }
             return _lru.evict();
         });
     });
@@ -93,6 +100,76 @@ memory::reclaiming_result cache_tracker::evict_from_lru_shallow() noexcept {
     });
 }
 
+void cache_tracker::record_access(uint64_t hash) noexcept {
+    if (!_admission_filter) {
+        return;
+    }
+    if (_admission_sketch.record(hash)) {
+        _evicted_in_last_sample = _stats.row_evictions != _row_evictions_at_sample_start;
+        _row_evictions_at_sample_start = _stats.row_evictions;
+    }
+}
+
+bool cache_tracker::admit(uint64_t hash) noexcept {
+    if (!_admission_filter) {
+        return true;
+    }
+    bool seen = _admission_sketch.estimate(hash) > 0;
+    record_access(hash);
+    bool evicting = _evicted_in_last_sample || _stats.row_evictions != _row_evictions_at_sample_start;
+    if (seen || !evicting) {
+        ++_stats.admissions;
+        return true;
+    }
+    ++_stats.admission_rejections;
+    return false;
+}
+
+uint32_t cache_tracker::register_cache(row_cache& c) {
+    auto i = std::find(_caches.begin(), _caches.end(), nullptr);
+    if (i == _caches.end()) {
+        _caches.push_back(nullptr);
+        i = std::prev(_caches.end());
+    }
+    _capped_caches.reserve(_caches.size());
+    *i = &c;
+    return i - _caches.begin();
+}
+
+void cache_tracker::unregister_cache(row_cache& c) noexcept {
+    set_memory_quota(c, 0);
+    _caches[c._id] = nullptr;
+}
+
+void cache_tracker::set_memory_quota(row_cache& c, uint64_t quota) noexcept {
+    auto i = std::find(_capped_caches.begin(), _capped_caches.end(), &c);
+    if (quota && i == _capped_caches.end()) {
+        _capped_caches.push_back(&c);
+    } else if (!quota && i != _capped_caches.end()) {
+        _capped_caches.erase(i);
+    }
+    c._memory_quota = quota;
+}
+
+uint64_t cache_tracker::estimated_memory_usage(const row_cache& c) const noexcept {
+    if (!_stats.partitions) {
+        return 0;
+    }
+    return double(_region.occupancy().used_space()) * c._partition_count / _stats.partitions;
+}
+
+memory::reclaiming_result cache_tracker::evict_over_quota() noexcept {
+    // Go round-robin, so that all caches over their quotas give up memory.
+    for (size_t n = 0; n < _capped_caches.size(); ++n) {
+        auto& c = *_capped_caches[_next_capped_cache++ % _capped_caches.size()];
+        if (estimated_memory_usage(c) > c._memory_quota && c.evict_for_quota() == memory::reclaiming_result::reclaimed_something) {
+            ++_stats.quota_row_evictions;
+            return memory::reclaiming_result::reclaimed_something;
+        }
+    }
+    return memory::reclaiming_result::reclaimed_nothing;
+}
+
 void cache_tracker::set_compaction_scheduling_group(seastar::scheduling_group sg) {
     _memtable_cleaner.set_scheduling_group(sg);
     _garbage.set_scheduling_group(sg);
@@ -140,6 +217,16 @@ cache_tracker::setup_metrics() {
             sm::description("total amount of range tombstones processed during read")),
         sm::make_counter("row_tombstone_reads", _stats.row_tombstone_reads,
             sm::description("total amount of row tombstones processed during read")),
+        sm::make_counter("rows_packed", _stats.rows_packed,
+            sm::description("total number of rows stored in the packed encoding on population")),
+        sm::make_counter("admissions", _stats.admissions,
+            sm::description("total number of partitions missing in cache which the admission filter let reads populate")),
+        sm::make_counter("admission_rejections", _stats.admission_rejections,
+            sm::description("total number of partitions missing in cache which the admission filter kept reads from populating")),
+        sm::make_counter("absent_partition_hits", _stats.absent_partition_hits,
+            sm::description("total number of single-partition reads of partitions known to be absent in sstables, which were not in cache")),
+        sm::make_counter("quota_row_evictions", _stats.quota_row_evictions,
+            sm::description("total number of rows evicted from tables which were over their cache memory quota")),
     });
 }
 
@@ -196,7 +283,8 @@ void cache_tracker::on_partition_miss() noexcept {
     ++_stats.partition_misses;
 }
 
-void cache_tracker::on_partition_eviction() noexcept {
+void cache_tracker::on_partition_eviction(const cache_entry& e) noexcept {
+    --_caches[e._cache_id]->_partition_count;
     --_stats.partitions;
     ++_stats.partition_evictions;
 }
@@ -378,10 +466,13 @@ class single_partition_populating_reader final : public flat_mutation_reader_v2:
                     _cache._read_section(_cache._tracker.region(), [this] {
                         _cache.find_or_create_missing(_read_context->key());
                     });
+                    _cache._absent_partitions.insert(*_cache._schema, _read_context->key());
                 } else {
                     _cache._tracker.on_mispopulate();
                 }
                 _end_of_stream = true;
+            } else if (!_cache.admit(_read_context->key())) {
+                _reader = read_directly_from_underlying(*_read_context, std::move(*mfopt));
             } else if (phase == _cache.phase_of(_read_context->range().start()->value())) {
                 _reader = _cache._read_section(_cache._tracker.region(), [&] {
                     cache_entry& e = _cache.find_or_create_incomplete(mfopt->as_partition_start(), phase);
@@ -453,6 +544,27 @@ void row_cache::on_partition_miss() {
     _tracker.on_partition_miss();
 }
 
+uint64_t row_cache::access_hash(const dht::decorated_key& dk) const noexcept {
+    return std::hash<table_id>()(_schema->id()) ^ uint64_t(dk.token().raw());
+}
+
+void row_cache::on_read_with_misses(bool range_query, const sstable_read_stats& before, const sstable_read_stats& after) noexcept {
+    ++(range_query ? _stats.range_reads_with_misses : _stats.single_partition_reads_with_misses);
+    auto sstables_read = after.sstables_read - before.sstables_read;
+    auto bytes_read = after.bytes_read - before.bytes_read;
+    auto index_pages_read = after.index_pages_read - before.index_pages_read;
+    _stats.miss_sstables_read += sstables_read;
+    _stats.miss_bytes_read += bytes_read;
+    _stats.miss_index_pages_read += index_pages_read;
+    _stats.miss_sstables_read_histogram.add(sstables_read);
+    _stats.miss_bytes_read_histogram.add(bytes_read);
+    _stats.miss_index_pages_read_histogram.add(index_pages_read);
+}
+
+bool row_cache::admit(const dht::decorated_key& dk) noexcept {
+    return _tracker.admit(access_hash(dk));
+}
+
 void row_cache::on_row_hit() {
     _stats.hits.mark();
     _tracker.on_row_hit();
@@ -526,6 +638,10 @@ class range_populating_reader {
                 _cache.on_partition_miss();
                 const partition_start& ps = mfopt->as_partition_start();
                 const dht::decorated_key& key = ps.key();
+                if (!_cache.admit(key)) {
+                    _last_key = {};
+                    return make_ready_future<flat_mutation_reader_v2_opt>(read_directly_from_underlying(_read_context, std::move(*mfopt)));
+                }
                 if (_reader.creation_phase() == _cache.phase_of(key)) {
                     return _cache._read_section(_cache._tracker.region(), [&] {
                         cache_entry& e = _cache.find_or_create_incomplete(ps, _reader.creation_phase(),
@@ -737,6 +853,7 @@ row_cache::make_reader_opt(schema_ptr s,
     if (query::is_single_partition(range) && !fwd_mr) {
         tracing::trace(trace_state, "Querying cache for range {} and slice {}",
                 range, seastar::value_of([&slice] { return slice.get_all_ranges(); }));
+        tracing::stage_timer cache_timer(trace_state, tracing::latency_stage::cache);
         auto mr = _read_section(_tracker.region(), [&] () -> flat_mutation_reader_v2_opt {
             dht::ring_position_comparator cmp(*_schema);
             auto&& pos = range.start()->value();
@@ -746,9 +863,13 @@ row_cache::make_reader_opt(schema_ptr s,
                 cache_entry& e = *i;
                 upgrade_entry(e);
                 on_partition_hit();
+                _tracker.record_access(access_hash(e.key()));
                 return e.read(*this, make_context());
             } else if (i->continuous()) {
                 return {};
+            } else if (_absent_partitions.contains(*_schema, pos.as_decorated_key())) {
+                ++_tracker._stats.absent_partition_hits;
+                return {};
             } else {
                 tracing::trace(trace_state, "Range {} not found in cache", range);
                 on_partition_miss();
@@ -777,21 +898,23 @@ row_cache::~row_cache() {
     with_allocator(_tracker.allocator(), [this] {
         _partitions.clear_and_dispose([this] (cache_entry* p) mutable noexcept {
             if (!p->is_dummy_entry()) {
-                _tracker.on_partition_erase();
+                on_partition_erase();
             }
             p->evict(_tracker);
         });
     });
+    _tracker.unregister_cache(*this);
 }
 
 void row_cache::clear_now() noexcept {
     with_allocator(_tracker.allocator(), [this] {
         auto it = _partitions.erase_and_dispose(_partitions.begin(), partitions_end(), [this] (cache_entry* p) noexcept {
-            _tracker.on_partition_erase();
+            on_partition_erase();
             p->evict(_tracker);
         });
         _tracker.clear_continuity(*it);
     });
+    _absent_partitions.clear();
 }
 
 template<typename CreateEntry, typename VisitEntry>
@@ -834,7 +957,7 @@ cache_entry& row_cache::find_or_create_incomplete(const partition_start& ps, row
         mutation_partition mp = mutation_partition::make_incomplete(*_schema, ps.partition_tombstone());
         partitions_type::iterator entry = _partitions.emplace_before(i, ps.key().token().raw(), hint,
                 _schema, ps.key(), std::move(mp));
-        _tracker.insert(*entry);
+        on_partition_insert(*entry);
         return entry;
     }, [&] (auto i) { // visit
         _tracker.on_miss_already_populated();
@@ -850,7 +973,7 @@ cache_entry& row_cache::find_or_create_missing(const dht::decorated_key& key) {
         bool cont = i->continuous();
         partitions_type::iterator entry = _partitions.emplace_before(i, key.token().raw(), hint,
                 _schema, key, std::move(mp));
-        _tracker.insert(*entry);
+        on_partition_insert(*entry);
         entry->set_continuous(cont);
         return entry;
     }, [&] (auto i) {
@@ -863,7 +986,7 @@ void row_cache::populate(const mutation& m, const previous_entry_pointer* previo
     do_find_or_create_entry(m.decorated_key(), previous, [&] (auto i, const partitions_type::bound_hint& hint) {
         partitions_type::iterator entry = _partitions.emplace_before(i, m.decorated_key().token().raw(), hint,
                 m.schema(), m.decorated_key(), m.partition());
-        _tracker.insert(*entry);
+        on_partition_insert(*entry);
         entry->set_continuous(i->continuous());
         upgrade_entry(*entry);
         return entry;
@@ -905,6 +1028,7 @@ row_cache::snapshot_and_phase row_cache::snapshot_of(dht::ring_position_view pos
 void row_cache::invalidate_sync(replica::memtable& m) noexcept {
     with_allocator(_tracker.allocator(), [&m, this] () {
         logalloc::reclaim_lock _(_tracker.region());
+        _absent_partitions.clear();
         bool blow_cache = false;
         m.partitions.clear_and_dispose([this, &m, &blow_cache] (replica::memtable_entry* entry) noexcept {
             try {
@@ -986,6 +1110,9 @@ future<> row_cache::do_update(external_updater eu, replica::memtable& m, Updater
                             real_dirty_acc.unpin_memory(size_entry);
                             _update_section(_tracker.region(), [&] {
                                 auto i = m.partitions.begin();
+                                // Done before _prev_snapshot_pos moves past the key, so that reads
+                                // of the old snapshot can't insert it again.
+                                _absent_partitions.erase(*_schema, i->key());
                                 i.erase_and_dispose(dht::raw_token_less_comparator{}, [&] (replica::memtable_entry* e) noexcept {
                                     m.evict_entry(*e, _tracker.memtable_cleaner());
                                 });
@@ -1037,7 +1164,7 @@ future<> row_cache::update(external_updater eu, replica::memtable& m) {
                 cache_entry::evictable_tag(), _schema, dht::decorated_key(mem_e.key()),
                 partition_entry::make_evictable(*_schema, mutation_partition(_schema)));
             entry->set_continuous(cache_i->continuous());
-            _tracker.insert(*entry);
+            on_partition_insert(*entry);
             mem_e.upgrade_schema(_schema, _tracker.memtable_cleaner());
             return entry->partition().apply_to_incomplete(*_schema, std::move(mem_e.partition()), _tracker.memtable_cleaner(),
                 alloc, _tracker.region(), _tracker, _underlying_phase, acc);
@@ -1106,7 +1233,7 @@ void row_cache::invalidate_locked(const dht::decorated_key& dk) {
     } else {
         auto it = pos.erase_and_dispose(dht::raw_token_less_comparator{},
             [this](cache_entry* p) mutable noexcept {
-                _tracker.on_partition_erase();
+                on_partition_erase();
                 p->evict(_tracker);
             });
         _tracker.clear_continuity(*it);
@@ -1143,7 +1270,7 @@ future<> row_cache::invalidate(external_updater eu, dht::partition_range_vector&
                             while (it != end) {
                                 it = it.erase_and_dispose(dht::raw_token_less_comparator{},
                                     [&] (cache_entry* p) mutable noexcept {
-                                        _tracker.on_partition_erase();
+                                        on_partition_erase();
                                         p->evict(_tracker);
                                     });
                                 // it != end is necessary for correctness. We cannot set _prev_snapshot_pos to end->position()
@@ -1169,6 +1296,10 @@ future<> row_cache::invalidate(external_updater eu, dht::partition_range_vector&
                 }
             }
 
+            // Reads which start after the update can't insert keys from the old snapshot.
+            for (auto&& range : ranges) {
+                _absent_partitions.erase(*_schema, range);
+            }
             on_failure.cancel();
         });
     });
@@ -1178,10 +1309,29 @@ void row_cache::evict() {
     while (_tracker.region().evict_some() == memory::reclaiming_result::reclaimed_something) {}
 }
 
+std::vector<dht::decorated_key> row_cache::get_keys(const std::optional<dht::decorated_key>& after, size_t limit) {
+    return _read_section(_tracker.region(), [&] {
+        std::vector<dht::decorated_key> keys;
+        auto i = _partitions.begin();
+        if (after) {
+            partitions_type::bound_hint hint;
+            i = _partitions.lower_bound(*after, dht::ring_position_comparator(*_schema), hint);
+            if (hint.match) {
+                ++i;
+            }
+        }
+        for (; i != partitions_end() && keys.size() < limit; ++i) {
+            keys.push_back(i->key());
+        }
+        return keys;
+    });
+}
+
 row_cache::row_cache(schema_ptr s, snapshot_source src, cache_tracker& tracker, is_continuous cont)
     : _tracker(tracker)
     , _schema(std::move(s))
     , _partitions(dht::raw_token_less_comparator{})
+    , _absent_partitions(tracker.absent_partitions_per_cache())
     , _underlying(src())
     , _snapshot_source(std::move(src))
 {
@@ -1191,6 +1341,8 @@ row_cache::row_cache(schema_ptr s, snapshot_source src, cache_tracker& tracker,
         auto raw_token = entry.position().token().raw();
         _partitions.insert(raw_token, std::move(entry), dht::ring_position_comparator{*_schema});
     });
+    _id = _tracker.register_cache(*this);
+    _tracker.set_memory_quota(*this, memory_quota_of(*_schema));
 }
 
 cache_entry::cache_entry(cache_entry&& o) noexcept
@@ -1198,6 +1350,7 @@ cache_entry::cache_entry(cache_entry&& o) noexcept
     , _key(std::move(o._key))
     , _pe(std::move(o._pe))
     , _flags(o._flags)
+    , _cache_id(o._cache_id)
 {
 }
 
@@ -1208,15 +1361,65 @@ void cache_entry::evict(cache_tracker& tracker) noexcept {
     _pe.evict(tracker.cleaner());
 }
 
+// The quota is per node, each shard gets its part.
+static uint64_t memory_quota_of(const schema& s) noexcept {
+    return s.caching_options().memory_quota() / smp::count;
+}
+
 void row_cache::set_schema(schema_ptr new_schema) noexcept {
     _schema = std::move(new_schema);
+    _tracker.set_memory_quota(*this, memory_quota_of(*_schema));
+}
+
+void row_cache::on_partition_insert(cache_entry& e) {
+    e._cache_id = _id;
+    ++_partition_count;
+    _tracker.insert(e);
+}
+
+void row_cache::on_partition_erase() noexcept {
+    --_partition_count;
+    _tracker.on_partition_erase();
+}
+
+memory::reclaiming_result row_cache::evict_for_quota() noexcept {
+    // Partitions with more than one version are skipped, evicting from them
+    // out of LRU order could break the invariant that older versions are
+    // evicted first. Going through too many of them would stall the reclaimer.
+    static constexpr int max_skipped = 16;
+    dht::ring_position_comparator cmp(*_schema);
+    auto it = _partitions.lower_bound(dht::ring_position_view::starting_at(dht::token::from_int64(_quota_eviction_pos)), cmp);
+    for (int skipped = 0; skipped < max_skipped; ++skipped) {
+        if (it == partitions_end()) {
+            it = _partitions.begin();
+            if (it == partitions_end()) {
+                return memory::reclaiming_result::reclaimed_nothing;
+            }
+        }
+        cache_entry& ce = *it;
+        partition_entry& pe = ce.partition();
+        _quota_eviction_pos = ce.key().token().raw();
+        if (pe.is_locked() || pe.version()->next()) {
+            ++it;
+            continue;
+        }
+        // Like lru::evict(), but of the first row of the partition. Evicting the last
+        // dummy, when nothing else is left, evicts the whole entry.
+        rows_entry& e = *pe.version()->partition().mutable_clustered_rows().begin();
+        if (e.is_linked()) {
+            _tracker.get_lru().remove(e);
+        }
+        e.on_evicted(_tracker);
+        return memory::reclaiming_result::reclaimed_something;
+    }
+    return memory::reclaiming_result::reclaimed_nothing;
 }
 
 void cache_entry::on_evicted(cache_tracker& tracker) noexcept {
     row_cache::partitions_type::iterator it(this);
     std::next(it)->set_continuous(false);
     evict(tracker);
-    tracker.on_partition_eviction();
+    tracker.on_partition_eviction(*this);
     it.erase(dht::raw_token_less_comparator{});
 }
 
@@ -18,12 +18,14 @@
 #include "mutation/mutation_partition.hh"
 #include "utils/phased_barrier.hh"
 #include "utils/histogram.hh"
+#include "utils/estimated_histogram.hh"
 #include "mutation/partition_version.hh"
 #include "tracing/trace_state.hh"
 #include <seastar/core/metrics_registration.hh>
 #include "mutation/mutation_cleaner.hh"
 #include "utils/double-decker.hh"
 #include "db/cache_tracker.hh"
+#include "absent_partition_cache.hh"
 #include "readers/empty_v2.hh"
 #include "readers/mutation_source.hh"
 
@@ -61,6 +63,8 @@ class cache_entry {
         bool _tail : 1;
         bool _train : 1;
     } _flags{};
+    // row_cache::_id of the owning cache.
+    uint32_t _cache_id = 0;
     friend class size_calculator;
 
     flat_mutation_reader_v2 do_read(row_cache&, cache::read_context& ctx);
@@ -209,12 +213,32 @@ class row_cache final {
         utils::timed_rate_moving_average misses;
         utils::timed_rate_moving_average reads_with_misses;
         utils::timed_rate_moving_average reads_with_no_misses;
+        // Reads which missed, by type, and what they read from sstables.
+        uint64_t single_partition_reads_with_misses = 0;
+        uint64_t range_reads_with_misses = 0;
+        uint64_t miss_sstables_read = 0;
+        uint64_t miss_bytes_read = 0;
+        uint64_t miss_index_pages_read = 0;
+        // Distribution of the above per read which missed.
+        utils::estimated_histogram miss_sstables_read_histogram{35};
+        utils::estimated_histogram miss_bytes_read_histogram;
+        utils::estimated_histogram miss_index_pages_read_histogram{35};
     };
 private:
     cache_tracker& _tracker;
     stats _stats{};
     schema_ptr _schema;
     partitions_type _partitions; // Cached partitions are complete.
+    // Slot of this cache in the tracker, see cache_tracker::register_cache().
+    uint32_t _id;
+    // Not counting the dummy entry.
+    uint64_t _partition_count = 0;
+    uint64_t _memory_quota = 0;
+    // Token of the partition evict_for_quota() evicts from next.
+    int64_t _quota_eviction_pos = std::numeric_limits<int64_t>::min();
+    // Partitions which reads found to be absent in the underlying source.
+    // Consulted by single-partition reads of partitions which are not in cache.
+    absent_partition_cache _absent_partitions;
 
     // The snapshots used by cache are versioned. The version number of a snapshot is
     // called the "population phase", or simply "phase". Between updates, cache
@@ -261,6 +285,18 @@ class row_cache final {
     flat_mutation_reader_v2 make_scanning_reader(const dht::partition_range&, std::unique_ptr<cache::read_context>);
     void on_partition_hit();
     void on_partition_miss();
+    // Must be called for every entry inserted into _partitions, except for the dummy one.
+    void on_partition_insert(cache_entry&);
+    void on_partition_erase() noexcept;
+    // Evicts a row of the next partition in ring order, see cache_tracker::set_memory_quota().
+    seastar::memory::reclaiming_result evict_for_quota() noexcept;
+    // The tracker's admission filter is shared by all tables, so tell their partitions apart.
+    uint64_t access_hash(const dht::decorated_key&) const noexcept;
+    // Whether a read which missed the partition should populate it, see cache_tracker::admit().
+    bool admit(const dht::decorated_key&) noexcept;
+    // Accounts what a read which missed read from sstables, given the totals of its permit
+    // before and after the read.
+    void on_read_with_misses(bool range_query, const sstable_read_stats& before, const sstable_read_stats& after) noexcept;
     void on_row_hit();
     void on_row_miss();
     void on_static_row_insert();
@@ -354,7 +390,7 @@ class row_cache final {
 public:
     ~row_cache();
     row_cache(schema_ptr, snapshot_source, cache_tracker&, is_continuous = is_continuous::no);
-    row_cache(row_cache&&) = default;
+    row_cache(row_cache&&) = delete; // registered in the tracker
     row_cache(const row_cache&) = delete;
 public:
     // Implements mutation_source for this cache, see mutation_reader.hh
@@ -448,6 +484,22 @@ class row_cache final {
     // If it did, use invalidate() instead.
     void evict();
 
+    // Returns the keys of up to limit partitions present in cache, in ring order,
+    // starting after the given key, or from the first one if it's disengaged.
+    std::vector<dht::decorated_key> get_keys(const std::optional<dht::decorated_key>& after, size_t limit);
+
+    uint64_t partition_count() const noexcept {
+        return _partition_count;
+    }
+
+    // See cache_tracker::set_memory_quota().
+    uint64_t memory_quota() const noexcept {
+        return _memory_quota;
+    }
+    uint64_t estimated_memory_usage() const noexcept {
+        return _tracker.estimated_memory_usage(*this);
+    }
+
     const cache_tracker& get_cache_tracker() const {
         return _tracker;
     }
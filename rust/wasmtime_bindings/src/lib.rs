@@ -39,6 +39,8 @@ mod ffi {
 
         type Module;
         fn create_module(engine: &mut Engine, script: &str) -> Result<Box<Module>>;
+        fn create_module_from_serialized(engine: &mut Engine, serialized: &[u8]) -> Result<Box<Module>>;
+        fn serialized(self: &Module) -> &[u8];
         fn raw_size(self: &Module) -> usize;
         fn is_compiled(self: &Module) -> bool;
         fn compile(self: &mut Module, engine: &mut Engine) -> Result<()>;
@@ -152,7 +154,25 @@ fn create_module(engine: &mut Engine, script: &str) -> Result<Box<Module>> {
     Ok(module)
 }
 
+// Recreates a module from the output of `serialized()`, e.g. saved on disk by a previous run.
+// Fails if it was compiled by another version of wasmtime or with another engine configuration.
+fn create_module_from_serialized(engine: &mut Engine, serialized: &[u8]) -> Result<Box<Module>> {
+    // `deserialize` trusts its input: it must be the result of `precompile_module`, written
+    // to a location only writable by the database itself.
+    unsafe { wasmtime::Module::deserialize(&engine.wasmtime_engine, serialized) }
+        .map_err(|e| anyhow!("Deserialization failed: {:?}", e))?;
+    let module = Box::new(Module {
+        serialized_module: serialized.to_vec(),
+        wasmtime_module: None,
+        references: 0,
+    });
+    Ok(module)
+}
+
 impl Module {
+    fn serialized(&self) -> &[u8] {
+        &self.serialized_module
+    }
     fn raw_size(&self) -> usize {
         self.serialized_module.len()
     }
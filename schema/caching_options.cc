@@ -12,8 +12,8 @@
 #include "exceptions/exceptions.hh"
 #include "utils/rjson.hh"
 
-caching_options::caching_options(sstring k, sstring r, bool enabled)
-        : _key_cache(k), _row_cache(r), _enabled(enabled) {
+caching_options::caching_options(sstring k, sstring r, bool enabled, uint64_t memory_quota_in_mb, uint64_t results_ttl_in_ms)
+        : _key_cache(k), _row_cache(r), _enabled(enabled), _memory_quota_in_mb(memory_quota_in_mb), _results_ttl_in_ms(results_ttl_in_ms) {
     if ((k != "ALL") && (k != "NONE")) {
         throw exceptions::configuration_exception("Invalid key value: " + k); 
     }
@@ -40,6 +40,12 @@ caching_options::to_map() const {
     if (!_enabled) {
         res.insert({"enabled", "false"});
     }
+    if (_memory_quota_in_mb) {
+        res.insert({"memory_quota_in_mb", format("{}", _memory_quota_in_mb)});
+    }
+    if (_results_ttl_in_ms) {
+        res.insert({"results_ttl_in_ms", format("{}", _results_ttl_in_ms)});
+    }
     return res;
 }
 
@@ -58,6 +64,8 @@ caching_options::from_map(const std::map<sstring, sstring>& map) {
     sstring k = default_key;
     sstring r = default_row;
     bool e = true;
+    uint64_t quota = 0;
+    uint64_t results_ttl = 0;
 
     for (auto& p : map) {
         if (p.first == "keys") {
@@ -66,11 +74,23 @@ caching_options::from_map(const std::map<sstring, sstring>& map) {
             r = p.second;
         } else if (p.first == "enabled") {
             e = p.second == "true";
+        } else if (p.first == "memory_quota_in_mb") {
+            try {
+                quota = boost::lexical_cast<uint64_t>(p.second);
+            } catch (const boost::bad_lexical_cast&) {
+                throw exceptions::configuration_exception("Invalid memory_quota_in_mb value: " + p.second);
+            }
+        } else if (p.first == "results_ttl_in_ms") {
+            try {
+                results_ttl = boost::lexical_cast<uint64_t>(p.second);
+            } catch (const boost::bad_lexical_cast&) {
+                throw exceptions::configuration_exception("Invalid results_ttl_in_ms value: " + p.second);
+            }
         } else {
             throw exceptions::configuration_exception(format("Invalid caching option: {}", p.first));
         }
     }
-    return caching_options(k, r, e);
+    return caching_options(k, r, e, quota, results_ttl);
 }
 
 caching_options
@@ -81,7 +101,8 @@ caching_options::from_sstring(const sstring& str) {
 bool
 caching_options::operator==(const caching_options& other) const {
     return _key_cache == other._key_cache && _row_cache == other._row_cache
-        && _enabled == other._enabled;
+        && _enabled == other._enabled && _memory_quota_in_mb == other._memory_quota_in_mb
+        && _results_ttl_in_ms == other._results_ttl_in_ms;
 }
 
 bool
@@ -8,6 +8,7 @@
 
 #pragma once
 #include <seastar/core/sstring.hh>
+#include <chrono>
 #include <map>
 #include "seastarx.hh"
 
@@ -25,7 +26,11 @@ class caching_options {
     sstring _key_cache;
     sstring _row_cache;
     bool _enabled = true;
-    caching_options(sstring k, sstring r, bool enabled);
+    // Soft limit of row cache memory of the table, 0 when unlimited.
+    uint64_t _memory_quota_in_mb = 0;
+    // How long replicas serve the results of repeated reads, 0 when they don't.
+    uint64_t _results_ttl_in_ms = 0;
+    caching_options(sstring k, sstring r, bool enabled, uint64_t memory_quota_in_mb = 0, uint64_t results_ttl_in_ms = 0);
 
     friend class schema;
     caching_options();
@@ -34,6 +39,18 @@ class caching_options {
         return _enabled;
     }
 
+    // Soft limit, in bytes, of the row cache memory which the table can take
+    // while other tables need it, 0 means unlimited. See cache_tracker::evict_over_quota().
+    uint64_t memory_quota() const {
+        return _memory_quota_in_mb << 20;
+    }
+
+    // How long the results of reads of the table can be served again to
+    // identical reads, 0 means never. See replica::query_result_cache.
+    std::chrono::milliseconds results_ttl() const {
+        return std::chrono::milliseconds(_results_ttl_in_ms);
+    }
+
     std::map<sstring, sstring> to_map() const;
 
     sstring to_sstring() const;
@@ -32,6 +32,7 @@
 #include "cdc/cdc_extension.hh"
 #include "tombstone_gc_extension.hh"
 #include "db/paxos_grace_seconds_extension.hh"
+#include "db/sstable_filter_type_extension.hh"
 #include "utils/rjson.hh"
 #include "tombstone_gc_options.hh"
 #include "db/per_partition_rate_limit_extension.hh"
@@ -507,6 +508,7 @@ bool operator==(const schema& x, const schema& y)
         && x._raw._default_time_to_live == y._raw._default_time_to_live
         && x._raw._regular_column_name_type == y._raw._regular_column_name_type
         && x._raw._bloom_filter_fp_chance == y._raw._bloom_filter_fp_chance
+        && x._raw._sstable_filter_type == y._raw._sstable_filter_type
         && x._raw._compressor_params == y._raw._compressor_params
         && x._raw._is_dense == y._raw._is_dense
         && x._raw._is_compound == y._raw._is_compound
@@ -1320,6 +1322,12 @@ schema_ptr schema_builder::build() {
             dynamic_pointer_cast<db::paxos_grace_seconds_extension>(it->second)->get_paxos_grace_seconds();
     }
 
+    // cache `sstable_filter_type` value for fast access through the schema object
+    if (auto it = new_raw._extensions.find(db::sstable_filter_type_extension::NAME); it != new_raw._extensions.end()) {
+        new_raw._sstable_filter_type =
+            dynamic_pointer_cast<db::sstable_filter_type_extension>(it->second)->get_filter_type();
+    }
+
     // cache the `per_partition_rate_limit` parameters for fast access through the schema object.
     if (auto it = new_raw._extensions.find(db::per_partition_rate_limit_extension::NAME); it != new_raw._extensions.end()) {
         new_raw._per_partition_rate_limit_options =
@@ -1383,6 +1391,11 @@ schema_builder& schema_builder::set_paxos_grace_seconds(int32_t seconds) {
     return *this;
 }
 
+schema_builder& schema_builder::set_sstable_filter_type(sstable_filter_type type) {
+    add_extension(db::sstable_filter_type_extension::NAME, ::make_shared<db::sstable_filter_type_extension>(type));
+    return *this;
+}
+
 gc_clock::duration schema::paxos_grace_seconds() const {
     return std::chrono::duration_cast<gc_clock::duration>(
         std::chrono::seconds(
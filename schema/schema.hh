@@ -154,6 +154,30 @@ inline cf_type sstring_to_cf_type(sstring name) {
     throw std::invalid_argument(format("unknown type: {}\n", name));
 }
 
+// The kind of filter sstables of a table are written with.
+enum class sstable_filter_type : uint8_t {
+    bloom,
+    // A static filter, see utils::filter::binary_fuse_filter.
+    binary_fuse,
+};
+
+inline sstring sstable_filter_type_to_sstring(sstable_filter_type t) {
+    switch (t) {
+    case sstable_filter_type::bloom: return "bloom";
+    case sstable_filter_type::binary_fuse: return "binary_fuse";
+    }
+    throw std::invalid_argument(format("unknown sstable filter type: {:d}\n", uint8_t(t)));
+}
+
+inline sstable_filter_type sstring_to_sstable_filter_type(const sstring& name) {
+    if (name == "bloom") {
+        return sstable_filter_type::bloom;
+    } else if (name == "binary_fuse") {
+        return sstable_filter_type::binary_fuse;
+    }
+    throw std::invalid_argument(format("unknown sstable filter type: {}\n", name));
+}
+
 struct speculative_retry {
     enum class type {
         NONE, CUSTOM, PERCENTILE, ALWAYS
@@ -613,6 +637,7 @@ class schema final : public enable_lw_shared_from_this<schema>, public data_dict
         data_type _regular_column_name_type;
         data_type _default_validation_class = bytes_type;
         double _bloom_filter_fp_chance = 0.01;
+        sstable_filter_type _sstable_filter_type = sstable_filter_type::bloom;
         compression_parameters _compressor_params;
         extensions_map _extensions;
         bool _is_dense = false;
@@ -711,6 +736,10 @@ class schema final : public enable_lw_shared_from_this<schema>, public data_dict
     double bloom_filter_fp_chance() const {
         return _raw._bloom_filter_fp_chance;
     }
+
+    sstable_filter_type filter_type() const {
+        return _raw._sstable_filter_type;
+    }
     sstring thrift_key_validator() const;
     const compression_parameters& get_compressor_params() const {
         return _raw._compressor_params;
@@ -194,6 +194,8 @@ struct schema_builder {
     double get_bloom_filter_fp_chance() const {
         return _raw._bloom_filter_fp_chance;
     }
+
+    schema_builder& set_sstable_filter_type(sstable_filter_type type);
     schema_builder& set_compressor_params(const compression_parameters& cp) {
         _raw._compressor_params = cp;
         return *this;
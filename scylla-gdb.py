@@ -1779,6 +1779,8 @@ class lsa_region():
         size = int(self.region['_closed_occupancy']['_total_space'])
         if int(self.region['_active_offset']) > 0:
             size += self.segment_size
+        if int(self.region['_large_active']) != 0 and int(self.region['_large_active_offset']) > 0:
+            size += self.segment_size
         return size
 
     def free(self):
@@ -2692,7 +2694,7 @@ class scylla_lsa_check(gdb.Command):
             desc = segment_descriptor(desc)
             if desc.is_lsa() and desc.region() == cache_region.impl():
                 if not int(desc.address) in in_buckets:
-                    if cache_region.impl()['_active'] != base and cache_region.impl()['_buf_active'] != base:
+                    if base not in (cache_region.impl()['_active'], cache_region.impl()['_large_active'], cache_region.impl()['_buf_active']):
                         # stray = not in _closed_segments
                         gdb.write('ERROR: Stray segment: (logalloc::segment*)0x%x, (logalloc::segment_descriptor*)0x%x, free_space=%d\n'
                               % (base, int(desc.address), desc.free_space()))
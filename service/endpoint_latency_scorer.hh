@@ -0,0 +1,168 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include <seastar/core/lowres_clock.hh>
+
+#include "gms/inet_address.hh"
+#include "inet_address_vectors.hh"
+#include "utils/estimated_histogram.hh"
+
+namespace service {
+
+// Scores replicas by how fast they answered recent reads, like Cassandra's
+// dynamic snitch does, so that reads can be steered away from a slow replica.
+//
+// The score of a replica is the moving average of its read latencies, scaled
+// by the number of its reads which are still pending, so that a replica which
+// stopped answering is avoided before its latency samples come back. Lower is
+// better, replicas without samples score 0.
+//
+// Also keeps a histogram of the read latencies of each replica, decayed every
+// second, to estimate their quantiles.
+class endpoint_latency_scorer {
+public:
+    using clock_type = seastar::lowres_clock;
+private:
+    // Weight of the newest sample in the moving average.
+    static constexpr double alpha = 0.25;
+    static constexpr std::chrono::seconds histogram_decay_period{1};
+
+    struct endpoint_state {
+        double latency_us = 0;
+        unsigned pending = 0;
+        utils::latency_histogram latencies;
+        clock_type::time_point last_decay = clock_type::now();
+    };
+    std::unordered_map<gms::inet_address, endpoint_state> _endpoints;
+    clock_type::time_point _last_reset = clock_type::now();
+private:
+    static void request_done(endpoint_state& st) noexcept {
+        if (st.pending) {
+            --st.pending;
+        }
+    }
+public:
+    void request_started(gms::inet_address ep) {
+        ++_endpoints[ep].pending;
+    }
+
+    void request_completed(gms::inet_address ep, std::chrono::microseconds latency) {
+        auto& st = _endpoints[ep];
+        request_done(st);
+        auto sample = double(latency.count());
+        st.latency_us = st.latency_us ? alpha * sample + (1 - alpha) * st.latency_us : sample;
+        st.latencies.add_micro(latency.count());
+    }
+
+    // A failure doesn't give a latency sample, the replica may have failed fast.
+    void request_failed(gms::inet_address ep) {
+        request_done(_endpoints[ep]);
+    }
+
+    double score(gms::inet_address ep) const noexcept {
+        auto it = _endpoints.find(ep);
+        if (it == _endpoints.end()) {
+            return 0;
+        }
+        return it->second.latency_us * (1 + it->second.pending);
+    }
+
+    // Returns the estimated quantile q of the read latencies of ep, or
+    // std::nullopt if there are no samples of them.
+    std::optional<std::chrono::microseconds> latency_quantile(gms::inet_address ep, float q) {
+        auto it = _endpoints.find(ep);
+        if (it == _endpoints.end()) {
+            return std::nullopt;
+        }
+        auto& st = it->second;
+        if (clock_type::now() - st.last_decay >= histogram_decay_period) {
+            // Give new samples more weight.
+            st.latencies *= 0.9;
+            st.last_decay = clock_type::now();
+        }
+        if (!st.latencies.count()) {
+            return std::nullopt;
+        }
+        return std::chrono::microseconds(st.latencies.quantile(q));
+    }
+
+    // Forgets the latency samples, but not the pending reads, so that a
+    // replica which was slow gets a chance to show that it recovered.
+    void reset() noexcept {
+        for (auto& [ep, st] : _endpoints) {
+            st.latency_us = 0;
+        }
+        _last_reset = clock_type::now();
+    }
+
+    // Reorders eps by score. The given order, presumably by proximity, is
+    // kept unless some replica in it scores worse than (1 + badness_threshold)
+    // times the replica in the same position when ordered by score.
+    //
+    // The latency samples are reset every reset_interval, if it isn't zero.
+    void sort_by_score(inet_address_vector_replica_set& eps, double badness_threshold, clock_type::duration reset_interval) {
+        if (reset_interval.count() && clock_type::now() - _last_reset >= reset_interval) {
+            reset();
+        }
+        if (eps.size() < 2) {
+            return;
+        }
+        std::vector<double> scores;
+        scores.reserve(eps.size());
+        for (auto ep : eps) {
+            scores.push_back(score(ep));
+        }
+        auto sorted_scores = scores;
+        std::sort(sorted_scores.begin(), sorted_scores.end());
+        bool bad = false;
+        for (size_t i = 0; i < scores.size(); ++i) {
+            if (scores[i] > sorted_scores[i] * (1 + badness_threshold)) {
+                bad = true;
+                break;
+            }
+        }
+        if (!bad) {
+            return;
+        }
+        std::stable_sort(eps.begin(), eps.end(), [this] (gms::inet_address a, gms::inet_address b) {
+            return score(a) < score(b);
+        });
+    }
+};
+
+// Limits extra reads, like hedged ones, to a fraction of all reads.
+//
+// Each read earns max_ratio of a credit and each extra read spends a whole
+// one. Up to max_credits are saved, for bursts.
+class read_budget {
+    static constexpr double max_credits = 100;
+    double _credits = 0;
+public:
+    void read_started(double max_ratio) noexcept {
+        _credits = std::min(_credits + max_ratio, max_credits);
+    }
+
+    // Returns true iff an extra read may be sent, consuming a credit.
+    bool try_spend() noexcept {
+        if (_credits < 1) {
+            return false;
+        }
+        _credits -= 1;
+        return true;
+    }
+};
+
+}
@@ -8,6 +8,7 @@
 
 #include "service/forward_service.hh"
 
+#include <boost/range/adaptor/sliced.hpp>
 #include <boost/range/algorithm/remove_if.hpp>
 #include <seastar/core/coroutine.hh>
 #include <seastar/core/future-util.hh>
@@ -61,6 +62,13 @@ class forward_aggregates {
 private:
     std::vector<::shared_ptr<db::functions::aggregate_function>> _funcs;
     std::vector<db::functions::stateless_aggregate_function> _aggrs;
+    schema_ptr _schema;
+    // The columns grouping the rows, empty if they aren't grouped.
+    std::vector<const column_definition*> _group_by;
+private:
+    std::strong_ordering compare_groups(const dht::decorated_key& a_key, const std::vector<bytes_opt>& a,
+            const dht::decorated_key& b_key, const std::vector<bytes_opt>& b) const;
+    void finalize_groups(query::forward_result& result);
 public:
     forward_aggregates(const query::forward_request& request);
     void merge(query::forward_result& result, query::forward_result&& other);
@@ -90,9 +98,19 @@ forward_aggregates::forward_aggregates(const query::forward_request& request) {
         aggrs.push_back(func->get_aggregate());
     }
     _aggrs = std::move(aggrs);
+
+    _schema = local_schema_registry().get(request.cmd.schema_version);
+    for (auto& name : request.group_by_columns) {
+        _group_by.push_back(_schema->get_column_definition(to_bytes(name)));
+    }
 }
 
 void forward_aggregates::merge(query::forward_result &result, query::forward_result&& other) {
+    if (!_group_by.empty()) {
+        // Groups are sorted and merged by finalize().
+        std::move(other.grouped_results.begin(), other.grouped_results.end(), std::back_inserter(result.grouped_results));
+        return;
+    }
     if (result.query_results.empty()) {
         result.query_results = std::move(other.query_results);
         return;
@@ -116,7 +134,81 @@ void forward_aggregates::merge(query::forward_result &result, query::forward_res
     }
 }
 
+// Orders groups like the rows they were computed from, i.e. by token, then
+// partition key and clustering prefix, rows of static content first.
+std::strong_ordering forward_aggregates::compare_groups(const dht::decorated_key& a_key, const std::vector<bytes_opt>& a,
+        const dht::decorated_key& b_key, const std::vector<bytes_opt>& b) const {
+    if (auto cmp = a_key.tri_compare(*_schema, b_key); cmp != 0) {
+        return cmp;
+    }
+    for (size_t i = _schema->partition_key_size(); i < _group_by.size(); i++) {
+        if (!a[i] || !b[i]) {
+            if (bool(a[i]) != bool(b[i])) {
+                return bool(a[i]) <=> bool(b[i]);
+            }
+            continue;
+        }
+        if (auto cmp = _group_by[i]->type->compare(bytes_view(*a[i]), bytes_view(*b[i])); cmp != 0) {
+            return cmp;
+        }
+    }
+    return std::strong_ordering::equal;
+}
+
+void forward_aggregates::finalize_groups(query::forward_result& result) {
+    const auto key_size = _group_by.size();
+    for (auto& group : result.grouped_results) {
+        if (group.size() != key_size + _aggrs.size()) {
+            on_internal_error(
+                flogger,
+                format("forward_aggregates::finalize(): operation cannot be completed due to invalid argument sizes. "
+                        "this.aggrs.size(): {} "
+                        "this.group_by.size(): {} "
+                        "group.size(): {} ",
+                        _aggrs.size(), key_size, group.size())
+            );
+        }
+    }
+
+    std::vector<std::pair<dht::decorated_key, std::vector<bytes_opt>>> groups;
+    groups.reserve(result.grouped_results.size());
+    for (auto& group : result.grouped_results) {
+        auto pk_values = boost::copy_range<std::vector<bytes>>(group
+                | boost::adaptors::sliced(0, _schema->partition_key_size())
+                | boost::adaptors::transformed([] (const bytes_opt& v) { return *v; }));
+        auto key = dht::decorate_key(*_schema, partition_key::from_exploded(*_schema, pk_values));
+        groups.emplace_back(std::move(key), std::move(group));
+    }
+    std::sort(groups.begin(), groups.end(), [this] (const auto& a, const auto& b) {
+        return compare_groups(a.first, a.second, b.first, b.second) < 0;
+    });
+
+    // A group is normally computed by a single shard, but a retried
+    // request may have computed parts of it on several.
+    result.grouped_results.clear();
+    for (size_t i = 0; i < groups.size(); i++) {
+        auto& group = groups[i].second;
+        while (i + 1 < groups.size() && compare_groups(groups[i].first, group, groups[i + 1].first, groups[i + 1].second) == 0) {
+            auto& next = groups[++i].second;
+            for (size_t j = 0; j < _aggrs.size(); j++) {
+                group[key_size + j] = _aggrs[j].state_reduction_function->execute(std::vector({std::move(group[key_size + j]), std::move(next[key_size + j])}));
+            }
+        }
+        for (size_t j = 0; j < _aggrs.size(); j++) {
+            if (_aggrs[j].state_to_result_function) {
+                group[key_size + j] = _aggrs[j].state_to_result_function->execute(std::vector({std::move(group[key_size + j])}));
+            }
+        }
+        result.grouped_results.push_back(std::move(group));
+    }
+}
+
 void forward_aggregates::finalize(query::forward_result &result) {
+    if (!_group_by.empty()) {
+        // Grouping no rows gives no groups.
+        finalize_groups(result);
+        return;
+    }
     if (result.query_results.empty()) {
         // An empty result means that we didn't send the aggregation request
         // to any node. I.e., it was a query that matched no partition, such
@@ -335,6 +427,12 @@ static shared_ptr<cql3::selection::selection> mock_selection(
         return make_shared<cql3::selection::raw_selector>(fc_expr, column_identifier);
     };
 
+    // The values of the grouping columns come first in the results of groups.
+    for (auto& name : request.group_by_columns) {
+        raw_selectors.emplace_back(make_shared<cql3::selection::raw_selector>(cql3::expr::unresolved_identifier{
+            make_shared<cql3::column_identifier_raw>(name, true)
+        }, nullptr));
+    }
     for (size_t i = 0; i < request.reduction_types.size(); i++) {
         auto info = (request.aggregation_infos) ? std::optional(request.aggregation_infos->at(i)) : std::nullopt;
         raw_selectors.emplace_back(mock_singular_selection(functions[i], request.reduction_types[i], info));
@@ -351,7 +449,9 @@ future<query::forward_result> forward_service::dispatch_to_shards(
     std::optional<query::forward_result> result;
     std::vector<future<query::forward_result>> futures;
 
-    for (const auto& s : smp::all_cpus()) {
+    // Shards beyond the table's shard count own no data of it.
+    schema_ptr schema = local_schema_registry().get(req.cmd.schema_version);
+    for (shard_id s = 0; s < schema->get_sharder().shard_count(); ++s) {
         futures.push_back(container().invoke_on(s, [req, tr_info] (auto& fs) {
             return fs.execute_on_this_shard(req, tr_info);
         }));
@@ -423,10 +523,14 @@ future<query::forward_result> forward_service::execute_on_this_shard(
         cql3::query_options::specific_options::DEFAULT
     );
 
+    std::vector<size_t> group_by_cell_indices;
+    for (auto& name : req.group_by_columns) {
+        group_by_cell_indices.push_back(selection->index_of(*schema->get_column_definition(to_bytes(name))));
+    }
     auto rs_builder = cql3::selection::result_set_builder(
         *selection,
         now,
-        std::vector<size_t>() // Represents empty GROUP BY indices.
+        std::move(group_by_cell_indices)
     );
 
     // We serve up to 256 ranges at a time to avoid allocating a huge vector for ranges
@@ -470,6 +574,23 @@ future<query::forward_result> forward_service::execute_on_this_shard(
     co_return co_await rs_builder.with_thread_if_needed([&req, &rs_builder, reductions = req.reduction_types, tr_state = std::move(tr_state)] {
         auto rs = rs_builder.build();
         auto& rows = rs->rows();
+        if (!req.group_by_columns.empty()) {
+            query::forward_result res;
+            for (auto& row : rows) {
+                if (row.size() != req.group_by_columns.size() + reductions.size()) {
+                    flogger.error("aggregation result column count does not match requested column count");
+                    throw std::runtime_error("aggregation result column count does not match requested column count");
+                }
+                // Aggregating no rows gives a row with no partition key,
+                // which isn't a group.
+                if (row[0]) {
+                    res.grouped_results.push_back(row);
+                }
+            }
+            tracing::trace(tr_state, "On shard execution result is {} groups", res.grouped_results.size());
+            flogger.debug("on shard execution result is {} groups", res.grouped_results.size());
+            return res;
+        }
         if (rows.size() != 1) {
             flogger.error("aggregation result row count != 1");
             throw std::runtime_error("aggregation result row count != 1");
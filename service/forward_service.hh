@@ -41,6 +41,11 @@ class storage_proxy;
 //   5. `dispatch` merges results from all coordinators and returns merged
 //      result.
 //
+// Requests with `group_by_columns` compute a result for each group of rows.
+// Since groups include the whole partition key, each lies in a single vnode
+// and is computed by a single shard; merging the results puts the groups in
+// ring order.
+//
 // Splitting query into sub-queries in is implemented as:
 //   a. Partition ranges of the original query are split into a sequence of
 //      vnodes.
@@ -123,6 +123,15 @@ void migration_manager::init_messaging_service()
 
         auto features = self._feat.cluster_schema_features();
         auto& proxy = self._storage_proxy.container();
+        if (options && options->group0_snapshot_max_keyspaces) {
+            // Chunked group 0 snapshot transfer, see `schema_pull_options`.
+            auto cm = co_await db::schema_tables::convert_schema_to_mutations(proxy, features,
+                    options->group0_snapshot_start_after, options->group0_snapshot_max_keyspaces);
+            if (cm.empty()) {
+                cm.emplace_back(co_await db::system_keyspace::get_group0_history(proxy));
+            }
+            co_return rpc::tuple(std::vector<frozen_mutation>{}, std::move(cm));
+        }
         auto cm = co_await db::schema_tables::convert_schema_to_mutations(proxy, features);
         if (options->group0_snapshot_transfer) {
             // if `group0_snapshot_transfer` is `true`, the sender must also understand canonical mutations
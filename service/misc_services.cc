@@ -302,6 +302,9 @@ future<> view_update_backlog_broker::on_change(gms::inet_address endpoint, gms::
 
 future<> view_update_backlog_broker::on_remove(gms::inet_address endpoint) {
     _sp.local()._view_update_backlogs.erase(endpoint);
+    for (auto& [table, backlogs] : _sp.local()._table_view_update_backlogs) {
+        backlogs.erase(endpoint);
+    }
     return make_ready_future();
 }
 
@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "latency_slo_guard.hh"
+
+namespace qos {
+
+latency_slo_guard::latency_slo_guard(utils::updateable_value<uint32_t> interactive_p99_target_ms)
+    : _interactive_p99_target_ms(std::move(interactive_p99_target_ms))
+    , _window_end(clock::now() + window_duration) {
+}
+
+void latency_slo_guard::maybe_close_window(clock::time_point now) {
+    if (now < _window_end) {
+        return;
+    }
+    uint64_t target_us = uint64_t(_interactive_p99_target_ms()) * 1000;
+    if (!target_us || _window.count() < min_window_requests) {
+        // Not enough interactive traffic to hurt.
+        _shedding = false;
+    } else {
+        _stats.interactive_p99_us = _window.quantile(0.99);
+        if (_stats.interactive_p99_us > target_us) {
+            ++_stats.windows_over_target;
+            _shedding = true;
+        } else if (_stats.interactive_p99_us < target_us * release_ratio) {
+            _shedding = false;
+        }
+    }
+    _window.clear();
+    _window_end = now + window_duration;
+}
+
+void latency_slo_guard::record_interactive_request(std::chrono::steady_clock::duration latency, clock::time_point now) {
+    maybe_close_window(now);
+    _window.add(latency);
+}
+
+bool latency_slo_guard::shed_batch_request(clock::time_point now) {
+    if (!enabled()) {
+        return false;
+    }
+    maybe_close_window(now);
+    if (_shedding) {
+        ++_stats.batch_requests_shed;
+    }
+    return _shedding;
+}
+
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <seastar/core/lowres_clock.hh>
+#include "utils/estimated_histogram.hh"
+#include "utils/updateable_value.hh"
+
+namespace qos {
+
+/**
+ * Sheds the requests of the batch workloads while the p99 latency of the
+ * interactive workloads misses its target, so that batch surges don't make
+ * the latency of interactive traffic unpredictable.
+ *
+ * The latency of the interactive requests is measured over windows of
+ * window_duration, and the decision to shed is revised at the end of each.
+ * Once shedding, it goes on until the p99 drops below release_ratio of the
+ * target, so that it doesn't flip with every window.
+ *
+ * Shard-local.
+ */
+class latency_slo_guard {
+public:
+    using clock = seastar::lowres_clock;
+    static constexpr std::chrono::seconds window_duration{1};
+    // The p99 of windows with fewer interactive requests says too little.
+    static constexpr uint64_t min_window_requests = 100;
+    static constexpr double release_ratio = 0.8;
+
+    struct stats {
+        uint64_t batch_requests_shed = 0;
+        uint64_t windows_over_target = 0;
+        // p99 latency of the interactive requests in the last complete window.
+        uint64_t interactive_p99_us = 0;
+    };
+private:
+    // 0 disables shedding.
+    utils::updateable_value<uint32_t> _interactive_p99_target_ms;
+    utils::time_estimated_histogram _window;
+    clock::time_point _window_end;
+    bool _shedding = false;
+    stats _stats;
+private:
+    void maybe_close_window(clock::time_point now);
+public:
+    explicit latency_slo_guard(utils::updateable_value<uint32_t> interactive_p99_target_ms);
+
+    bool enabled() const {
+        return _interactive_p99_target_ms() != 0;
+    }
+
+    void record_interactive_request(std::chrono::steady_clock::duration latency, clock::time_point now = clock::now());
+
+    // Returns true, and counts the request as shed, if a batch request arriving now must be shed.
+    bool shed_batch_request(clock::time_point now = clock::now());
+
+    const stats& get_stats() const noexcept {
+        return _stats;
+    }
+};
+
+}
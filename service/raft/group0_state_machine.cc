@@ -30,6 +30,7 @@
 #include "idl/group0_state_machine.dist.impl.hh"
 #include "service/migration_manager.hh"
 #include "db/system_keyspace.hh"
+#include "db/schema_tables.hh"
 #include "service/storage_proxy.hh"
 #include "service/raft/raft_group0_client.hh"
 #include "partition_slice_builder.hh"
@@ -138,6 +139,9 @@ future<> group0_state_machine::transfer_snapshot(gms::inet_address from, raft::s
 
     slogger.trace("transfer snapshot from {} index {} snp id {}", from, snp.idx, snp.id);
     netw::messaging_service::msg_addr addr{from, 0};
+    if (_mm._feat.group0_snapshot_chunks) {
+        co_return co_await transfer_snapshot_in_chunks(addr);
+    }
     // (Ab)use MIGRATION_REQUEST to also transfer group0 history table mutation besides schema tables mutations.
     auto [_, cm] = co_await _mm._messaging.send_migration_request(addr, netw::schema_pull_options { .group0_snapshot_transfer = true });
     if (!cm) {
@@ -163,6 +167,57 @@ future<> group0_state_machine::transfer_snapshot(gms::inet_address from, raft::s
     co_await _sp.mutate_locally({std::move(history_mut)}, nullptr);
 }
 
+future<> group0_state_machine::transfer_snapshot_in_chunks(netw::msg_addr addr) {
+    // Pull and apply the schema a few keyspaces at a time, so that neither side has to
+    // build, serialize or hold the schema of all keyspaces at once. Each chunk carries
+    // whole keyspaces, so the schema of a keyspace is always merged in one go.
+    // The history mutation comes last, once the schema of every keyspace was applied.
+    auto topology_snp = co_await ser::storage_service_rpc_verbs::send_raft_pull_topology_snapshot(&_mm._messaging, addr, service::raft_topology_pull_params{});
+
+    auto read_apply_mutex_holder = co_await _client.hold_read_apply_mutex();
+
+    auto keyspaces_schema = db::schema_tables::keyspaces();
+    auto history_table_id = _sp.data_dictionary().find_schema(db::system_keyspace::NAME, db::system_keyspace::GROUP0_HISTORY)->id();
+    std::optional<sstring> start_after;
+    std::optional<mutation> history_mut;
+    while (!history_mut) {
+        auto [_, cm] = co_await _mm._messaging.send_migration_request(addr, netw::schema_pull_options {
+            .group0_snapshot_transfer = true,
+            .group0_snapshot_start_after = start_after,
+            .group0_snapshot_max_keyspaces = group0_snapshot_transfer_chunk_keyspaces,
+        });
+        if (!cm) {
+            on_internal_error(slogger, "Expected MIGRATION_REQUEST to return canonical mutations");
+        }
+        if (cm->size() == 1 && cm->front().column_family_id() == history_table_id) {
+            history_mut = extract_history_mutation(*cm, _sp.data_dictionary());
+            continue;
+        }
+
+        auto prev_start_after = start_after;
+        for (auto& m : *cm) {
+            if (m.column_family_id() == keyspaces_schema->id()) {
+                auto mut = m.to_mutation(keyspaces_schema);
+                auto name = value_cast<sstring>(utf8_type->deserialize(mut.key().get_component(*keyspaces_schema, 0)));
+                if (!start_after || *start_after < name) {
+                    start_after = std::move(name);
+                }
+            }
+        }
+        if (start_after == prev_start_after) {
+            on_internal_error(slogger, "group0 snapshot chunk did not advance past any keyspace");
+        }
+        slogger.trace("transfer snapshot: applying {} schema mutations, up to keyspace {}", cm->size(), *start_after);
+        co_await _mm.merge_schema_from(addr, std::move(*cm));
+    }
+
+    if (!topology_snp.topology_mutations.empty()) {
+        co_await _ss.merge_topology_snapshot(std::move(topology_snp));
+    }
+
+    co_await _sp.mutate_locally({std::move(*history_mut)}, nullptr);
+}
+
 future<> group0_state_machine::abort() {
     return make_ready_future<>();
 }
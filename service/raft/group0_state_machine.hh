@@ -12,6 +12,7 @@
 #include "utils/UUID_gen.hh"
 #include "mutation/canonical_mutation.hh"
 #include "service/raft/raft_state_machine.hh"
+#include "message/messaging_service_fwd.hh"
 
 namespace cdc {
 class generation_service;
@@ -78,6 +79,11 @@ class group0_state_machine : public raft_state_machine {
     storage_proxy& _sp;
     storage_service& _ss;
     cdc::generation_service& _cdc_gen_svc;
+
+    // How many keyspaces are pulled per MIGRATION_REQUEST when transferring a snapshot in chunks.
+    static constexpr uint32_t group0_snapshot_transfer_chunk_keyspaces = 16;
+
+    future<> transfer_snapshot_in_chunks(netw::msg_addr addr);
 public:
     group0_state_machine(raft_group0_client& client, migration_manager& mm, storage_proxy& sp, storage_service& ss, cdc::generation_service& cdc_gen_svc) : _client(client), _mm(mm), _sp(sp), _ss(ss), _cdc_gen_svc(cdc_gen_svc) {}
     future<> apply(std::vector<raft::command_cref> command) override;
@@ -8,6 +8,7 @@
  * SPDX-License-Identifier: (AGPL-3.0-or-later and Apache-2.0)
  */
 
+#include <cmath>
 #include <random>
 #include <seastar/core/sleep.hh>
 #include <seastar/util/defer.hh>
@@ -75,6 +76,7 @@
 #include <seastar/coroutine/parallel_for_each.hh>
 #include <seastar/coroutine/as_future.hh>
 #include <seastar/coroutine/all.hh>
+#include <seastar/core/with_scheduling_group.hh>
 #include "locator/abstract_replication_strategy.hh"
 #include "service/paxos/cas_request.hh"
 #include "mutation/mutation_partition_view.hh"
@@ -86,6 +88,14 @@
 #include "idl/frozen_schema.dist.hh"
 #include "idl/frozen_schema.dist.impl.hh"
 #include "idl/storage_proxy.dist.hh"
+#include "idl/keys.dist.hh"
+#include "idl/range.dist.hh"
+#include "idl/uuid.dist.hh"
+#include "idl/read_command.dist.hh"
+#include "idl/keys.dist.impl.hh"
+#include "idl/range.dist.impl.hh"
+#include "idl/uuid.dist.impl.hh"
+#include "idl/read_command.dist.impl.hh"
 #include "utils/result.hh"
 #include "utils/result_combinators.hh"
 #include "utils/result_loop.hh"
@@ -96,6 +106,8 @@
 #include "replica/exceptions.hh"
 #include "db/operation_type.hh"
 #include "locator/util.hh"
+#include "mutation_query.hh"
+#include "query-result-reader.hh"
 
 namespace bi = boost::intrusive;
 
@@ -158,11 +170,37 @@ class storage_proxy::remote {
     netw::connection_drop_slot_t _connection_dropped;
     netw::connection_drop_registration_t _condrop_registration;
 
+    // Mutations and hints sent between begin_mutation_batch() and flush_mutation_batches(),
+    // grouped by replica, so that each replica receives them in a single rpc.
+    struct mutation_batch {
+        storage_proxy::clock_type::time_point timeout = storage_proxy::clock_type::time_point::min();
+        std::vector<frozen_mutation> fms;
+        std::vector<inet_address_vector_replica_set> forward;
+        std::vector<uint64_t> response_ids;
+        std::vector<std::optional<tracing::trace_info>> trace_info;
+        std::vector<db::per_partition_rate_limit::info> rate_limit_info;
+        std::vector<promise<>> sent;
+        size_t bytes = 0;
+    };
+    // A batch is sent right away once it grows past this size.
+    static constexpr size_t max_mutation_batch_bytes = 128 * 1024;
+    using mutation_batches = std::unordered_map<netw::msg_addr, mutation_batch, netw::msg_addr::hash>;
+    mutation_batches _mutation_batches;
+    mutation_batches _hint_mutation_batches;
+    bool _batching_mutations = false;
+    // Mutations sent to replicas in other datacenters, which forward them to the rest
+    // of their datacenter, held for remote_dc_write_batch_window_in_us so that
+    // concurrent writes to the same replica share a message. Grouped by the
+    // scheduling group of the writes, which their batch is sent under.
+    std::unordered_map<scheduling_group, mutation_batches> _remote_dc_mutation_batches;
+    timer<> _remote_dc_flush_timer;
+
 public:
     remote(storage_proxy& sp, netw::messaging_service& ms, gms::gossiper& g)
         : _sp(sp), _ms(ms), _gossiper(g)
         , _connection_dropped(std::bind_front(&remote::connection_dropped, this))
         , _condrop_registration(_ms.when_connection_drops(_connection_dropped))
+        , _remote_dc_flush_timer([this] { flush_remote_dc_mutation_batches(); })
     {}
 
     void init_messaging_service(migration_manager* mm, storage_proxy* sp) {
@@ -170,7 +208,9 @@ class storage_proxy::remote {
 
         ser::storage_proxy_rpc_verbs::register_counter_mutation(&_ms, std::bind_front(&remote::handle_counter_mutation, this));
         ser::storage_proxy_rpc_verbs::register_mutation(&_ms, std::bind_front(&remote::receive_mutation_handler, this, sp->_write_smp_service_group));
+        ser::storage_proxy_rpc_verbs::register_mutation_batch(&_ms, std::bind_front(&remote::receive_mutation_batch_handler, this, sp->_write_smp_service_group));
         ser::storage_proxy_rpc_verbs::register_hint_mutation(&_ms, [this, sp] <typename... Args>(Args&&... args) { return receive_mutation_handler(sp->_hints_write_smp_service_group, std::forward<Args>(args)..., std::monostate()); });
+        ser::storage_proxy_rpc_verbs::register_hint_mutation_batch(&_ms, std::bind_front(&remote::receive_hint_mutation_batch_handler, this, sp->_hints_write_smp_service_group));
         ser::storage_proxy_rpc_verbs::register_paxos_learn(&_ms, std::bind_front(&remote::handle_paxos_learn, this));
         ser::storage_proxy_rpc_verbs::register_mutation_done(&_ms, std::bind_front(&remote::handle_mutation_done, this));
         ser::storage_proxy_rpc_verbs::register_mutation_failed(&_ms, std::bind_front(&remote::handle_mutation_failed, this));
@@ -185,6 +225,8 @@ class storage_proxy::remote {
     }
 
     future<> uninit_messaging_service() {
+        _remote_dc_flush_timer.cancel();
+        flush_remote_dc_mutation_batches();
         co_await ser::storage_proxy_rpc_verbs::unregister(&_ms);
         _mm = nullptr;
     }
@@ -197,20 +239,198 @@ class storage_proxy::remote {
         return _gossiper.is_alive(ep);
     }
 
+    netw::msg_addr addr_for(gms::inet_address ep, const dht::token& t) const {
+        return _ms.addr_for(ep, t);
+    }
+
+    netw::msg_addr addr_for(gms::inet_address ep) const {
+        return _ms.addr_for(ep);
+    }
+
     future<> send_mutation(
             netw::msg_addr addr, storage_proxy::clock_type::time_point timeout, std::optional<tracing::trace_info> trace_info,
             frozen_mutation m, inet_address_vector_replica_set&& forward, gms::inet_address reply_to, unsigned shard,
             storage_proxy::response_id_type response_id, db::per_partition_rate_limit::info rate_limit_info) {
+        if (can_batch(addr, reply_to, shard) && _sp.features().mutation_batch_verb) {
+            return queue_mutation(_mutation_batches, false, addr, timeout, std::move(trace_info), std::move(m), std::move(forward), response_id, rate_limit_info);
+        }
+        if (auto window = remote_dc_batch_window(addr, reply_to, shard); window.count()) {
+            // The replica applies the mutations of the batch on the right shards
+            // itself, so they are grouped by node rather than by shard.
+            auto& batches = _remote_dc_mutation_batches[current_scheduling_group()];
+            auto f = queue_mutation(batches, false, netw::msg_addr(addr.addr), timeout, std::move(trace_info),
+                    std::move(m), std::move(forward), response_id, rate_limit_info);
+            if (!_remote_dc_flush_timer.armed() && !batches.empty()) {
+                _remote_dc_flush_timer.arm(window);
+            }
+            return f;
+        }
         return ser::storage_proxy_rpc_verbs::send_mutation(
                 &_ms, std::move(addr), timeout,
                 std::move(m), std::move(forward), std::move(reply_to), shard,
                 response_id, std::move(trace_info), rate_limit_info);
     }
 
+    bool can_batch(const netw::msg_addr& addr, gms::inet_address reply_to, unsigned shard) const noexcept {
+        return _batching_mutations && addr.cpu_id == 0 && reply_to == utils::fb_utilities::get_broadcast_address() && shard == this_shard_id();
+    }
+
+    bool is_in_remote_dc(gms::inet_address ep) const {
+        const auto& topology = _sp.get_token_metadata_ptr()->get_topology();
+        auto* node = topology.find_node(ep);
+        return node && node->dc_rack().dc != topology.get_datacenter();
+    }
+
+    // How long a mutation sent to addr may wait for others to share its message,
+    // or zero if it must be sent right away.
+    std::chrono::microseconds remote_dc_batch_window(const netw::msg_addr& addr, gms::inet_address reply_to, unsigned shard) const {
+        auto window = std::chrono::microseconds(_sp._db.local().get_config().remote_dc_write_batch_window_in_us());
+        if (!window.count() || !_sp.features().mutation_batch_verb
+                || reply_to != utils::fb_utilities::get_broadcast_address() || shard != this_shard_id() || !is_in_remote_dc(addr.addr)) {
+            return std::chrono::microseconds(0);
+        }
+        return window;
+    }
+
+    // Moves to the back of a remote datacenter's replicas, where send_to_live_endpoints()
+    // takes the coordinator of the datacenter from, one that already has a batch waiting,
+    // so that concurrent writes to the datacenter share a message even when they were
+    // given different replicas.
+    void prefer_batched_remote_dc_coordinator(inet_address_vector_replica_set& replicas) const {
+        auto it = _remote_dc_mutation_batches.find(current_scheduling_group());
+        if (it == _remote_dc_mutation_batches.end()) {
+            return;
+        }
+        auto replica = std::find_if(replicas.begin(), replicas.end(), [&batches = it->second] (gms::inet_address ep) {
+            return batches.contains(netw::msg_addr(ep));
+        });
+        if (replica != replicas.end()) {
+            std::iter_swap(replica, replicas.end() - 1);
+        }
+    }
+
+    future<> queue_mutation(mutation_batches& batches, bool hints,
+            netw::msg_addr addr, storage_proxy::clock_type::time_point timeout, std::optional<tracing::trace_info> trace_info,
+            frozen_mutation m, inet_address_vector_replica_set&& forward,
+            storage_proxy::response_id_type response_id, db::per_partition_rate_limit::info rate_limit_info) {
+        auto& b = batches[addr];
+        b.timeout = std::max(b.timeout, timeout);
+        b.bytes += m.representation().size();
+        b.fms.push_back(std::move(m));
+        b.forward.push_back(std::move(forward));
+        b.response_ids.push_back(response_id);
+        b.trace_info.push_back(std::move(trace_info));
+        b.rate_limit_info.push_back(rate_limit_info);
+        b.sent.emplace_back();
+        auto f = b.sent.back().get_future();
+        if (b.bytes >= max_mutation_batch_bytes) {
+            auto node = batches.extract(addr);
+            send_mutation_batch(node.key(), std::move(node.mapped()), hints);
+        }
+        return f;
+    }
+
+    // Until flush_mutation_batches() is called, send_mutation() and send_hint_mutation()
+    // queue the mutations they are given rather than sending them, if all nodes
+    // support MUTATION_BATCH and HINT_MUTATION_BATCH respectively.
+    void begin_mutation_batch() noexcept {
+        _batching_mutations = true;
+    }
+
+    // Sends the mutations queued since begin_mutation_batch(), one rpc per replica,
+    // and stops queueing. Replicas acknowledge each mutation separately.
+    void flush_mutation_batches() {
+        _batching_mutations = false;
+        auto batches = std::exchange(_mutation_batches, {});
+        for (auto& [addr, b] : batches) {
+            send_mutation_batch(addr, std::move(b), false);
+        }
+        auto hint_batches = std::exchange(_hint_mutation_batches, {});
+        for (auto& [addr, b] : hint_batches) {
+            send_mutation_batch(addr, std::move(b), true);
+        }
+    }
+
+    // Called from the flush timer, which runs in the default scheduling group, so
+    // each batch is sent under the scheduling group of the writes it holds.
+    void flush_remote_dc_mutation_batches() {
+        auto batches_by_group = std::exchange(_remote_dc_mutation_batches, {});
+        for (auto& [sg, batches] : batches_by_group) {
+            // Waited on by the senders of the mutations, through the batches' sent promises.
+            (void)with_scheduling_group(sg, [this, batches = std::move(batches)] () mutable {
+                for (auto& [addr, b] : batches) {
+                    send_mutation_batch(addr, std::move(b), false);
+                }
+            });
+        }
+    }
+
+    void send_mutation_batch(netw::msg_addr addr, mutation_batch b, bool hints) {
+        if (hints) {
+            send_hint_mutation_batch(addr, std::move(b));
+            return;
+        }
+        if (b.fms.size() == 1) {
+            ser::storage_proxy_rpc_verbs::send_mutation(
+                    &_ms, addr, b.timeout,
+                    std::move(b.fms.front()), std::move(b.forward.front()), utils::fb_utilities::get_broadcast_address(), this_shard_id(),
+                    b.response_ids.front(), std::move(b.trace_info.front()), b.rate_limit_info.front()).forward_to(std::move(b.sent.front()));
+            return;
+        }
+        ++_sp.get_stats().sent_mutation_batches;
+        // Waited on by the senders of the mutations, through b.sent.
+        (void)ser::storage_proxy_rpc_verbs::send_mutation_batch(
+                &_ms, addr, b.timeout,
+                std::move(b.fms), std::move(b.forward), utils::fb_utilities::get_broadcast_address(), this_shard_id(),
+                std::move(b.response_ids), std::move(b.trace_info), std::move(b.rate_limit_info)).then_wrapped([sent = std::move(b.sent)] (future<> f) mutable {
+            if (f.failed()) {
+                auto ex = f.get_exception();
+                for (auto& p : sent) {
+                    p.set_exception(ex);
+                }
+            } else {
+                for (auto& p : sent) {
+                    p.set_value();
+                }
+            }
+        });
+    }
+
+    void send_hint_mutation_batch(netw::msg_addr addr, mutation_batch b) {
+        if (b.fms.size() == 1) {
+            ser::storage_proxy_rpc_verbs::send_hint_mutation(
+                    &_ms, addr, b.timeout,
+                    std::move(b.fms.front()), std::move(b.forward.front()), utils::fb_utilities::get_broadcast_address(), this_shard_id(),
+                    b.response_ids.front(), std::move(b.trace_info.front())).forward_to(std::move(b.sent.front()));
+            return;
+        }
+        ++_sp.get_stats().sent_mutation_batches;
+        // Waited on by the senders of the hints, through b.sent.
+        (void)ser::storage_proxy_rpc_verbs::send_hint_mutation_batch(
+                &_ms, addr, b.timeout,
+                std::move(b.fms), std::move(b.forward), utils::fb_utilities::get_broadcast_address(), this_shard_id(),
+                std::move(b.response_ids), std::move(b.trace_info)).then_wrapped([sent = std::move(b.sent)] (future<> f) mutable {
+            if (f.failed()) {
+                auto ex = f.get_exception();
+                for (auto& p : sent) {
+                    p.set_exception(ex);
+                }
+            } else {
+                for (auto& p : sent) {
+                    p.set_value();
+                }
+            }
+        });
+    }
+
     future<> send_hint_mutation(
             netw::msg_addr addr, storage_proxy::clock_type::time_point timeout, tracing::trace_state_ptr tr_state,
             frozen_mutation m, inet_address_vector_replica_set&& forward, gms::inet_address reply_to, unsigned shard,
             storage_proxy::response_id_type response_id, db::per_partition_rate_limit::info rate_limit_info) {
+        if (can_batch(addr, reply_to, shard) && _sp.features().hint_mutation_batch_verb) {
+            tracing::trace(tr_state, "Queueing a hint to /{}", addr.addr);
+            return queue_mutation(_hint_mutation_batches, true, addr, timeout, tracing::make_trace_info(tr_state), std::move(m), std::move(forward), response_id, rate_limit_info);
+        }
         tracing::trace(tr_state, "Sending a hint to /{}", addr.addr);
         return ser::storage_proxy_rpc_verbs::send_hint_mutation(
                 &_ms, std::move(addr), timeout,
@@ -250,6 +470,7 @@ class storage_proxy::remote {
             netw::msg_addr addr, storage_proxy::clock_type::time_point timeout, tracing::trace_state_ptr tr_state,
             const query::read_command& cmd, const dht::partition_range& pr) {
         tracing::trace(tr_state, "read_mutation_data: sending a message to /{}", addr.addr);
+        tracing::stage_timer rpc_timer(tr_state, tracing::latency_stage::replica_rpc);
         auto&& [result, hit_rate, opt_exception] = co_await ser::storage_proxy_rpc_verbs::send_read_mutation_data(&_ms, addr, timeout, cmd, pr);
         if (opt_exception.has_value() && *opt_exception) {
             co_await coroutine::return_exception_ptr((*opt_exception).into_exception_ptr());
@@ -265,6 +486,7 @@ class storage_proxy::remote {
             const query::read_command& cmd, const dht::partition_range& pr,
             query::digest_algorithm digest_algo, db::per_partition_rate_limit::info rate_limit_info) {
         tracing::trace(tr_state, "read_data: sending a message to /{}", addr.addr);
+        tracing::stage_timer rpc_timer(tr_state, tracing::latency_stage::replica_rpc);
         auto&& [result, hit_rate, opt_exception] =
             co_await ser::storage_proxy_rpc_verbs::send_read_data(&_ms, addr, timeout, cmd, pr, digest_algo, rate_limit_info);
         if (opt_exception.has_value() && *opt_exception) {
@@ -281,6 +503,7 @@ class storage_proxy::remote {
             const query::read_command& cmd, const dht::partition_range& pr,
             query::digest_algorithm digest_algo, db::per_partition_rate_limit::info rate_limit_info) {
         tracing::trace(tr_state, "read_digest: sending a message to /{}", addr.addr);
+        tracing::stage_timer rpc_timer(tr_state, tracing::latency_stage::replica_rpc);
         auto&& [d, t, hit_rate, opt_exception, opt_last_pos] =
             co_await ser::storage_proxy_rpc_verbs::send_read_digest(&_ms, addr, timeout, cmd, pr, digest_algo, rate_limit_info);
         if (opt_exception.has_value() && *opt_exception) {
@@ -430,22 +653,23 @@ class storage_proxy::remote {
         const auto& m = in;
         shared_ptr<storage_proxy> p = _sp.shared_from_this();
         errors_info errors;
+        schema_ptr s;
         ++p->get_stats().received_mutations;
         p->get_stats().forwarded_mutations += forward.size();
         co_await coroutine::all(
             [&] () -> future<> {
                 try {
                     // FIXME: get_schema_for_write() doesn't timeout
-                    schema_ptr s = co_await get_schema_for_write(schema_version, netw::messaging_service::msg_addr{reply_to, shard});
+                    s = co_await get_schema_for_write(schema_version, netw::messaging_service::msg_addr{reply_to, shard});
                     // Note: blocks due to execution_stage in replica::database::apply()
-                    co_await apply_fn(p, trace_state_ptr, std::move(s), m, timeout);
+                    co_await apply_fn(p, trace_state_ptr, s, m, timeout);
                     // We wait for send_mutation_done to complete, otherwise, if reply_to is busy, we will accumulate
                     // lots of unsent responses, which can OOM our shard.
                     //
                     // Usually we will return immediately, since this work only involves appending data to the connection
                     // send buffer.
                     auto f = co_await coroutine::as_future(send_mutation_done(netw::messaging_service::msg_addr{reply_to, shard}, trace_state_ptr,
-                            shard, response_id, p->get_view_update_backlog()));
+                            shard, response_id, p->get_view_update_backlog(*s)));
                     f.ignore_ready_future();
                 } catch (...) {
                     std::exception_ptr eptr = std::current_exception();
@@ -465,7 +689,9 @@ class storage_proxy::remote {
                 return parallel_for_each(forward.begin(), forward.end(), [&] (gms::inet_address forward) {
                     // Note: not a coroutine, since forward_fn() typically returns a ready future
                     tracing::trace(trace_state_ptr, "Forwarding a mutation to /{}", forward);
-                    return forward_fn(p, netw::messaging_service::msg_addr{forward, 0}, timeout, m, reply_to, shard, response_id,
+                    // Shard aware senders sent the mutation to the shard owning it, which
+                    // is the same shard on replicas with the same sharding.
+                    return forward_fn(p, addr_for(forward), timeout, m, reply_to, shard, response_id,
                                         tracing::make_trace_info(trace_state_ptr))
                             .then_wrapped([&] (future<> f) {
                         if (f.failed()) {
@@ -485,7 +711,7 @@ class storage_proxy::remote {
                     shard,
                     response_id,
                     errors.count,
-                    p->get_view_update_backlog(),
+                    s ? p->get_view_update_backlog(*s) : p->get_view_update_backlog(),
                     std::move(errors.local)));
             f.ignore_ready_future();
         }
@@ -515,6 +741,43 @@ class storage_proxy::remote {
                 });
     }
 
+    future<rpc::no_wait_type> receive_mutation_batch_handler(
+            smp_service_group smp_grp, const rpc::client_info& cinfo, rpc::opt_time_point t,
+            std::vector<frozen_mutation> fms, std::vector<inet_address_vector_replica_set> forward, gms::inet_address reply_to,
+            unsigned shard, std::vector<uint64_t> response_ids,
+            std::vector<std::optional<tracing::trace_info>> trace_info, std::vector<db::per_partition_rate_limit::info> rate_limit_info) {
+        auto n = fms.size();
+        if (forward.size() != n || response_ids.size() != n || trace_info.size() != n || rate_limit_info.size() != n) {
+            on_internal_error(slogger, format("Malformed mutation batch from {}: {} mutations, {} forward lists, {} response ids, {} trace infos, {} rate limit infos",
+                    reply_to, n, forward.size(), response_ids.size(), trace_info.size(), rate_limit_info.size()));
+        }
+        ++_sp.get_stats().received_mutation_batches;
+        // Each mutation is acknowledged separately, with MUTATION_DONE or MUTATION_FAILED.
+        co_await coroutine::parallel_for_each(boost::irange(size_t(0), n), [&] (size_t i) {
+            return receive_mutation_handler(smp_grp, cinfo, t, std::move(fms[i]), std::move(forward[i]), reply_to, shard, response_ids[i],
+                    std::move(trace_info[i]), rate_limit_info[i]).discard_result();
+        });
+        co_return netw::messaging_service::no_wait();
+    }
+
+    future<rpc::no_wait_type> receive_hint_mutation_batch_handler(
+            smp_service_group smp_grp, const rpc::client_info& cinfo, rpc::opt_time_point t,
+            std::vector<frozen_mutation> fms, std::vector<inet_address_vector_replica_set> forward, gms::inet_address reply_to,
+            unsigned shard, std::vector<uint64_t> response_ids, std::vector<std::optional<tracing::trace_info>> trace_info) {
+        auto n = fms.size();
+        if (forward.size() != n || response_ids.size() != n || trace_info.size() != n) {
+            on_internal_error(slogger, format("Malformed hint mutation batch from {}: {} mutations, {} forward lists, {} response ids, {} trace infos",
+                    reply_to, n, forward.size(), response_ids.size(), trace_info.size()));
+        }
+        ++_sp.get_stats().received_mutation_batches;
+        // Each hint is acknowledged separately, with MUTATION_DONE or MUTATION_FAILED.
+        co_await coroutine::parallel_for_each(boost::irange(size_t(0), n), [&] (size_t i) {
+            return receive_mutation_handler(smp_grp, cinfo, t, std::move(fms[i]), std::move(forward[i]), reply_to, shard, response_ids[i],
+                    std::move(trace_info[i]), std::monostate()).discard_result();
+        });
+        co_return netw::messaging_service::no_wait();
+    }
+
     future<rpc::no_wait_type> handle_paxos_learn(
             const rpc::client_info& cinfo, rpc::opt_time_point t,
             paxos::proposal decision, inet_address_vector_replica_set forward, gms::inet_address reply_to, unsigned shard,
@@ -877,6 +1140,67 @@ static inline db::per_partition_rate_limit::info adjust_rate_limit_for_local_ope
     return info;
 }
 
+// Every write allocates a write response handler and a mutation holder, and
+// frees them once the replicas answered. So each shard keeps the memory of
+// some of the freed ones for the next writes to reuse. They are of a few
+// types, each of a fixed size, so blocks are kept by size.
+class write_handler_pool {
+    static constexpr size_t max_free_blocks = 1024;
+    struct bin {
+        size_t size;
+        std::vector<void*> free;
+    };
+    utils::small_vector<bin, 8> _bins;
+private:
+    bin* find_bin(size_t size) noexcept {
+        for (auto& b : _bins) {
+            if (b.size == size) {
+                return &b;
+            }
+        }
+        return nullptr;
+    }
+public:
+    write_handler_pool() = default;
+    write_handler_pool(const write_handler_pool&) = delete;
+    ~write_handler_pool() {
+        for (auto& b : _bins) {
+            for (auto* p : b.free) {
+                ::operator delete(p, b.size);
+            }
+        }
+    }
+
+    void* allocate(size_t size) {
+        auto* b = find_bin(size);
+        if (!b) {
+            b = &_bins.emplace_back(bin{size, {}});
+            // So that deallocate() doesn't have to allocate.
+            b->free.reserve(max_free_blocks);
+        }
+        if (b->free.empty()) {
+            return ::operator new(size);
+        }
+        auto* p = b->free.back();
+        b->free.pop_back();
+        return p;
+    }
+
+    void deallocate(void* p, size_t size) noexcept {
+        auto* b = find_bin(size);
+        if (b && b->free.size() < max_free_blocks) {
+            b->free.push_back(p);
+        } else {
+            ::operator delete(p, size);
+        }
+    }
+
+    static write_handler_pool& local() noexcept {
+        static thread_local write_handler_pool pool;
+        return pool;
+    }
+};
+
 class mutation_holder {
 protected:
     size_t _size = 0;
@@ -901,12 +1225,25 @@ class mutation_holder {
     // called when reply is received
     // alllows mutation holder to have its own accounting
     virtual void reply(gms::inet_address ep) {};
+
+    static void* operator new(size_t size) {
+        return write_handler_pool::local().allocate(size);
+    }
+    static void operator delete(void* ptr, size_t size) noexcept {
+        write_handler_pool::local().deallocate(ptr, size);
+    }
 };
 
 // different mutation for each destination (for read repairs)
 class per_destination_mutation : public mutation_holder {
-    std::unordered_map<gms::inet_address, lw_shared_ptr<const frozen_mutation>> _mutations;
+    // There are as many destinations as replicas, few enough to search linearly.
+    utils::small_vector<std::pair<gms::inet_address, lw_shared_ptr<const frozen_mutation>>, 3> _mutations;
     dht::token _token;
+private:
+    lw_shared_ptr<const frozen_mutation> mutation_for(gms::inet_address ep) const {
+        auto it = std::find_if(_mutations.begin(), _mutations.end(), [ep] (const auto& m) { return m.first == ep; });
+        return it != _mutations.end() ? it->second : nullptr;
+    }
 public:
     per_destination_mutation(const std::unordered_map<gms::inet_address, std::optional<mutation>>& mutations) {
         for (auto&& m : mutations) {
@@ -917,11 +1254,11 @@ class per_destination_mutation : public mutation_holder {
                 fm = make_lw_shared<const frozen_mutation>(freeze(m.second.value()));
                 _size += fm->representation().size();
             }
-            _mutations.emplace(m.first, std::move(fm));
+            _mutations.emplace_back(m.first, std::move(fm));
         }
     }
     virtual bool store_hint(db::hints::manager& hm, gms::inet_address ep, tracing::trace_state_ptr tr_state) override {
-        auto m = _mutations[ep];
+        auto m = mutation_for(ep);
         if (m) {
             return hm.store_hint(ep, _schema, std::move(m), tr_state);
         } else {
@@ -930,7 +1267,7 @@ class per_destination_mutation : public mutation_holder {
     }
     virtual future<> apply_locally(storage_proxy& sp, storage_proxy::clock_type::time_point timeout,
             tracing::trace_state_ptr tr_state, db::per_partition_rate_limit::info rate_limit_info) override {
-        auto m = _mutations[utils::fb_utilities::get_broadcast_address()];
+        auto m = mutation_for(utils::fb_utilities::get_broadcast_address());
         if (m) {
             tracing::trace(tr_state, "Executing a mutation locally");
             return sp.mutate_locally(_schema, *m, std::move(tr_state), db::commitlog::force_sync::no, timeout, rate_limit_info);
@@ -940,10 +1277,10 @@ class per_destination_mutation : public mutation_holder {
     virtual future<> apply_remotely(storage_proxy& sp, gms::inet_address ep, inet_address_vector_replica_set&& forward,
             storage_proxy::response_id_type response_id, storage_proxy::clock_type::time_point timeout,
             tracing::trace_state_ptr tr_state, db::per_partition_rate_limit::info rate_limit_info) override {
-        auto m = _mutations[ep];
+        auto m = mutation_for(ep);
         if (m) {
             tracing::trace(tr_state, "Sending a mutation to /{}", ep);
-            return sp.remote().send_mutation(netw::messaging_service::msg_addr{ep, 0}, timeout, tracing::make_trace_info(tr_state),
+            return sp.remote().send_mutation(sp.remote().addr_for(ep, _token), timeout, tracing::make_trace_info(tr_state),
                     *m, std::move(forward), utils::fb_utilities::get_broadcast_address(), this_shard_id(),
                     response_id, rate_limit_info);
         }
@@ -989,7 +1326,7 @@ class shared_mutation : public mutation_holder {
             storage_proxy::response_id_type response_id, storage_proxy::clock_type::time_point timeout,
             tracing::trace_state_ptr tr_state, db::per_partition_rate_limit::info rate_limit_info) override {
         tracing::trace(tr_state, "Sending a mutation to /{}", ep);
-        return sp.remote().send_mutation(netw::messaging_service::msg_addr{ep, 0}, timeout, tracing::make_trace_info(tr_state),
+        return sp.remote().send_mutation(sp.remote().addr_for(ep, dht::get_token(*_schema, _mutation->key())), timeout, tracing::make_trace_info(tr_state),
                 *_mutation, std::move(forward), utils::fb_utilities::get_broadcast_address(), this_shard_id(),
                 response_id, rate_limit_info);
     }
@@ -1018,7 +1355,7 @@ class hint_mutation : public shared_mutation {
             storage_proxy::response_id_type response_id, storage_proxy::clock_type::time_point timeout,
             tracing::trace_state_ptr tr_state, db::per_partition_rate_limit::info rate_limit_info) override {
         return sp.remote().send_hint_mutation(
-                netw::messaging_service::msg_addr{ep, 0}, timeout, tr_state,
+                sp.remote().addr_for(ep, dht::get_token(*_schema, _mutation->key())), timeout, tr_state,
                 *_mutation, std::move(forward), utils::fb_utilities::get_broadcast_address(), this_shard_id(), response_id, rate_limit_info);
     }
 };
@@ -1086,6 +1423,8 @@ class paxos_response_handler : public enable_shared_from_this<paxos_response_han
         utils::UUID ballot;
         // Current value of the requested key or none.
         foreign_ptr<lw_shared_ptr<query::result>> data;
+        // The lowest timestamp newer than the ones written by the most recent commit.
+        api::timestamp_type min_timestamp;
     };
 
     // Steps of the Paxos protocol
@@ -1140,7 +1479,7 @@ class cas_mutation : public mutation_holder {
         tracing::trace(tr_state, "Sending a learn to /{}", ep);
         // TODO: Enforce per partition rate limiting in paxos
         return sp.remote().send_paxos_learn(
-                netw::messaging_service::msg_addr{ep, 0}, timeout, tracing::make_trace_info(tr_state),
+                sp.remote().addr_for(ep, dht::get_token(*_schema, _proposal->update.key())), timeout, tracing::make_trace_info(tr_state),
                 *_proposal, std::move(forward), utils::fb_utilities::get_broadcast_address(), this_shard_id(), response_id);
     }
     virtual bool is_shared() override {
@@ -1248,6 +1587,13 @@ class abstract_write_response_handler : public seastar::enable_shared_from_this<
             }
         }
     }
+    static void* operator new(size_t size) {
+        return write_handler_pool::local().allocate(size);
+    }
+    static void operator delete(void* ptr, size_t size) noexcept {
+        write_handler_pool::local().deallocate(ptr, size);
+    }
+
     bool is_counter() const {
         return _type == db::write_type::COUNTER;
     }
@@ -1371,7 +1717,7 @@ class abstract_write_response_handler : public seastar::enable_shared_from_this<
     db::view::update_backlog max_backlog() {
         return boost::accumulate(
                 get_targets() | boost::adaptors::transformed([this] (gms::inet_address ep) {
-                    return _proxy->get_backlog_of(ep);
+                    return _proxy->get_backlog_of(ep, get_schema()->id());
                 }),
                 db::view::update_backlog::no_backlog(),
                 [] (const db::view::update_backlog& lhs, const db::view::update_backlog& rhs) {
@@ -1559,19 +1905,24 @@ view_update_write_response_handler::~view_update_write_response_handler() {
 
 class datacenter_sync_write_response_handler : public abstract_write_response_handler {
     struct dc_info {
+        sstring dc;
         size_t acks;
         size_t total_block_for;
         size_t total_endpoints;
         size_t failures;
     };
-    std::unordered_map<sstring, dc_info> _dc_responses;
+    // Few enough datacenters to search linearly.
+    utils::small_vector<dc_info, 3> _dc_responses;
+    dc_info* find_dc(const sstring& dc) noexcept {
+        auto it = std::find_if(_dc_responses.begin(), _dc_responses.end(), [&dc] (const dc_info& i) { return i.dc == dc; });
+        return it != _dc_responses.end() ? &*it : nullptr;
+    }
     bool waited_for(gms::inet_address from) override {
         auto& topology = _effective_replication_map_ptr->get_topology();
-        sstring data_center = topology.get_datacenter(from);
-        auto dc_resp = _dc_responses.find(data_center);
+        auto* dc_resp = find_dc(topology.get_datacenter(from));
 
-        if (dc_resp->second.acks < dc_resp->second.total_block_for) {
-            ++dc_resp->second.acks;
+        if (dc_resp->acks < dc_resp->total_block_for) {
+            ++dc_resp->acks;
             return true;
         }
         return false;
@@ -1588,26 +1939,25 @@ class datacenter_sync_write_response_handler : public abstract_write_response_ha
         for (auto& target : targets) {
             auto dc = topology.get_datacenter(target);
 
-            if (!_dc_responses.contains(dc)) {
+            if (!find_dc(dc)) {
                 auto pending_for_dc = boost::range::count_if(pending_endpoints, [&topology, &dc] (const gms::inet_address& ep){
                     return topology.get_datacenter(ep) == dc;
                 });
                 size_t total_endpoints_for_dc = boost::range::count_if(targets, [&topology, &dc] (const gms::inet_address& ep){
                     return topology.get_datacenter(ep) == dc;
                 });
-                _dc_responses.emplace(dc, dc_info{0, db::local_quorum_for(*erm, dc) + pending_for_dc, total_endpoints_for_dc, 0});
+                _dc_responses.push_back(dc_info{dc, 0, db::local_quorum_for(*erm, dc) + pending_for_dc, total_endpoints_for_dc, 0});
                 _total_block_for += pending_for_dc;
             }
         }
     }
     bool failure(gms::inet_address from, size_t count, error err) override {
         auto& topology = _effective_replication_map_ptr->get_topology();
-        const sstring& dc = topology.get_datacenter(from);
-        auto dc_resp = _dc_responses.find(dc);
+        auto* dc_resp = find_dc(topology.get_datacenter(from));
 
-        dc_resp->second.failures += count;
+        dc_resp->failures += count;
         _failed += count;
-        if (dc_resp->second.total_block_for + dc_resp->second.failures > dc_resp->second.total_endpoints) {
+        if (dc_resp->total_block_for + dc_resp->failures > dc_resp->total_endpoints) {
             _error = err;
             return true;
         }
@@ -1747,6 +2097,8 @@ paxos_response_handler::begin_and_repair_paxos(client_state& cs, unsigned& conte
         // just be a timing issue, but may also mean we lost messages), we pro-actively "repair"
         // those nodes, and retry.
         auto now_in_sec = utils::UUID_gen::unix_timestamp_in_sec(ballot);
+        api::timestamp_type min_timestamp = summary.most_recent_commit
+                ? utils::UUID_gen::micros_timestamp(summary.most_recent_commit->ballot) + 1 : 0;
 
         inet_address_vector_replica_set missing_mrc = summary.replicas_missing_most_recent_commit(_schema, now_in_sec);
         if (missing_mrc.size() > 0) {
@@ -1770,7 +2122,7 @@ paxos_response_handler::begin_and_repair_paxos(client_state& cs, unsigned& conte
                 continue;
             }
         }
-        co_return ballot_and_data{ballot, std::move(summary.data)};
+        co_return ballot_and_data{ballot, std::move(summary.data), min_timestamp};
     }
 }
 
@@ -1815,7 +2167,7 @@ future<paxos::prepare_summary> paxos_response_handler::prepare_ballot(utils::UUI
                     tracing::trace(tr_state, "prepare_ballot: prepare {} locally", ballot);
                     response = co_await paxos::paxos_state::prepare(*_proxy, tr_state, _schema, *_cmd, _key.key(), ballot, only_digest, da, _timeout);
                 } else {
-                    response = co_await _proxy->remote().send_paxos_prepare(netw::msg_addr(peer), _timeout, tr_state, *_cmd, _key.key(), ballot, only_digest, da);
+                    response = co_await _proxy->remote().send_paxos_prepare(_proxy->remote().addr_for(peer, _key.token()), _timeout, tr_state, *_cmd, _key.key(), ballot, only_digest, da);
                 }
             } catch (...) {
                 if (request_tracker.p) {
@@ -1974,7 +2326,7 @@ future<bool> paxos_response_handler::accept_proposal(lw_shared_ptr<paxos::propos
                     tracing::trace(tr_state, "accept_proposal: accept {} locally", *proposal);
                     accepted = co_await paxos::paxos_state::accept(*_proxy, tr_state, _schema, proposal->update.decorated_key(*_schema).token(), *proposal, _timeout);
                 } else {
-                    accepted = co_await _proxy->remote().send_paxos_accept(netw::msg_addr(peer), _timeout, tr_state, *proposal);
+                    accepted = co_await _proxy->remote().send_paxos_accept(_proxy->remote().addr_for(peer, _key.token()), _timeout, tr_state, *proposal);
                 }
             } catch(...) {
                 if (request_tracker.p) {
@@ -2131,7 +2483,7 @@ void paxos_response_handler::prune(utils::UUID ballot) {
             return paxos::paxos_state::prune(_schema, _key.key(), ballot, _timeout, tr_state);
         } else {
             tracing::trace(tr_state, "prune: send prune of {} to {}", ballot, peer);
-            return _proxy->remote().send_paxos_prune(netw::msg_addr(peer), _timeout, tr_state, _schema->version(), _key.key(), ballot);
+            return _proxy->remote().send_paxos_prune(_proxy->remote().addr_for(peer, _key.token()), _timeout, tr_state, _schema->version(), _key.key(), ballot);
         }
     }).then_wrapped([this, h = shared_from_this()] (future<> f) {
         h->_proxy->get_stats().cas_now_pruning--;
@@ -2246,7 +2598,9 @@ void storage_proxy::remove_response_handler_entry(response_handlers_map::iterato
 
 void storage_proxy::got_response(storage_proxy::response_id_type id, gms::inet_address from, std::optional<db::view::update_backlog> backlog) {
     auto it = _response_handlers.find(id);
+    std::optional<table_id> table;
     if (it != _response_handlers.end()) {
+        table = it->second->get_schema()->id();
         tracing::trace(it->second->get_trace_state(), "Got a response from /{}", from);
         if (it->second->response(from)) {
             remove_response_handler_entry(std::move(it)); // last one, remove entry. Will cancel expiration timer too.
@@ -2254,12 +2608,14 @@ void storage_proxy::got_response(storage_proxy::response_id_type id, gms::inet_a
             it->second->check_for_early_completion();
         }
     }
-    maybe_update_view_backlog_of(std::move(from), std::move(backlog));
+    maybe_update_view_backlog_of(std::move(from), std::move(backlog), table);
 }
 
 void storage_proxy::got_failure_response(storage_proxy::response_id_type id, gms::inet_address from, size_t count, std::optional<db::view::update_backlog> backlog, error err, std::optional<sstring> msg) {
     auto it = _response_handlers.find(id);
+    std::optional<table_id> table;
     if (it != _response_handlers.end()) {
+        table = it->second->get_schema()->id();
         tracing::trace(it->second->get_trace_state(), "Got {} failures from /{}", count, from);
         if (it->second->failure_response(from, count, err, std::move(msg))) {
             remove_response_handler_entry(std::move(it));
@@ -2267,20 +2623,40 @@ void storage_proxy::got_failure_response(storage_proxy::response_id_type id, gms
             it->second->check_for_early_completion();
         }
     }
-    maybe_update_view_backlog_of(std::move(from), std::move(backlog));
+    maybe_update_view_backlog_of(std::move(from), std::move(backlog), table);
 }
 
-void storage_proxy::maybe_update_view_backlog_of(gms::inet_address replica, std::optional<db::view::update_backlog> backlog) {
-    if (backlog) {
-        auto now = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
-        _view_update_backlogs[replica] = {std::move(*backlog), now};
+void storage_proxy::maybe_update_view_backlog_of(gms::inet_address replica, std::optional<db::view::update_backlog> backlog, std::optional<table_id> table) {
+    if (!backlog) {
+        return;
+    }
+    if (_features.view_update_backlog_per_table) {
+        // Replicas report the backlog of the table written to, which is
+        // unknown if the write already completed.
+        if (table) {
+            _table_view_update_backlogs[*table][replica] = *backlog;
+        }
+        return;
     }
+    auto now = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    _view_update_backlogs[replica] = {std::move(*backlog), now};
 }
 
 db::view::update_backlog storage_proxy::get_view_update_backlog() const {
     return _max_view_update_backlog.add_fetch(this_shard_id(), get_db().local().get_view_update_backlog());
 }
 
+db::view::update_backlog storage_proxy::get_view_update_backlog(const schema& s) const {
+    if (!_features.view_update_backlog_per_table) {
+        return get_view_update_backlog();
+    }
+    auto& db = get_db().local();
+    if (!db.column_family_exists(s.id())) {
+        return db::view::update_backlog::no_backlog();
+    }
+    return db.find_column_family(s.id()).get_view_update_backlog();
+}
+
 db::view::update_backlog storage_proxy::get_backlog_of(gms::inet_address ep) const {
     auto it = _view_update_backlogs.find(ep);
     if (it == _view_update_backlogs.end()) {
@@ -2289,6 +2665,21 @@ db::view::update_backlog storage_proxy::get_backlog_of(gms::inet_address ep) con
     return it->second.backlog;
 }
 
+db::view::update_backlog storage_proxy::get_backlog_of(gms::inet_address ep, table_id table) const {
+    if (!_features.view_update_backlog_per_table) {
+        return get_backlog_of(ep);
+    }
+    auto it = _table_view_update_backlogs.find(table);
+    if (it == _table_view_update_backlogs.end()) {
+        return db::view::update_backlog::no_backlog();
+    }
+    auto bit = it->second.find(ep);
+    if (bit == it->second.end()) {
+        return db::view::update_backlog::no_backlog();
+    }
+    return bit->second;
+}
+
 future<result<>> storage_proxy::response_wait(storage_proxy::response_id_type id, clock_type::time_point timeout) {
     auto& handler = _response_handlers.find(id)->second;
     handler->expire_at(timeout);
@@ -2408,6 +2799,10 @@ void storage_proxy_stats::write_stats::register_stats() {
                     sm::description("number of CQL write requests which failed because the hinted handoff mechanism is overloaded "
                     "and cannot store any more in-flight hints"),
                     {storage_proxy_stats::current_scheduling_group_label()}).set_skip_when_empty(),
+
+            sm::make_total_operations("sent_mutation_batches", sent_mutation_batches,
+                    sm::description("number of messages which carried several mutations, of the same request or of replayed hints, to a single replica"),
+                    {storage_proxy_stats::current_scheduling_group_label()}).set_skip_when_empty(),
         });
     _metrics = std::exchange(new_metrics, {});
 }
@@ -2503,6 +2898,14 @@ void storage_proxy_stats::stats::register_stats() {
                        sm::description("number of speculative data read requests that were sent"),
                        {storage_proxy_stats::current_scheduling_group_label()}).set_skip_when_empty(),
 
+        sm::make_total_operations("speculative_reads_over_budget", speculative_reads_over_budget,
+                       sm::description("number of speculative read requests that were not sent because of read_hedging_max_ratio"),
+                       {storage_proxy_stats::current_scheduling_group_label()}).set_skip_when_empty(),
+
+        sm::make_total_operations("coalesced_reads", coalesced_reads,
+                       sm::description("number of single partition reads which shared the result of an identical concurrent read"),
+                       {storage_proxy_stats::current_scheduling_group_label()}).set_skip_when_empty(),
+
         sm::make_summary("cas_read_latency_summary", sm::description("CAS read latency summary"), [this] {return to_metrics_summary(cas_read.summary());})(storage_proxy_stats::current_scheduling_group_label()).set_skip_when_empty(),
         sm::make_summary("cas_write_latency_summary", sm::description("CAS write latency summary"), [this] {return to_metrics_summary(cas_write.summary());})(storage_proxy_stats::current_scheduling_group_label()).set_skip_when_empty(),
 
@@ -2543,6 +2946,14 @@ void storage_proxy_stats::stats::register_stats() {
                        sm::description("number of transaction preconditions that did not match current values"),
                        {storage_proxy_stats::current_scheduling_group_label()}).set_skip_when_empty(),
 
+        sm::make_total_operations("cas_write_coalesced", cas_write_coalesced,
+                       sm::description("number of transactions applied in the Paxos round of another transaction on the same partition"),
+                       {storage_proxy_stats::current_scheduling_group_label()}).set_skip_when_empty(),
+
+        sm::make_total_operations("cas_write_deferred_learn", cas_write_deferred_learn,
+                       sm::description("number of transactions acknowledged before their learn stage completed"),
+                       {storage_proxy_stats::current_scheduling_group_label()}).set_skip_when_empty(),
+
         sm::make_total_operations("cas_write_timeout_due_to_uncertainty", cas_write_timeout_due_to_uncertainty,
                        sm::description("how many times write timeout was reported because of uncertainty in the result"),
                        {storage_proxy_stats::current_scheduling_group_label()}).set_skip_when_empty(),
@@ -2589,6 +3000,10 @@ void storage_proxy_stats::stats::register_stats() {
                        sm::description("number of mutations received by a replica Node"),
                        {storage_proxy_stats::current_scheduling_group_label()}).set_skip_when_empty(),
 
+        sm::make_total_operations("received_mutation_batches", received_mutation_batches,
+                       sm::description("number of batches of mutations received by a replica Node in a single message"),
+                       {storage_proxy_stats::current_scheduling_group_label()}).set_skip_when_empty(),
+
         sm::make_total_operations("forwarded_mutations", forwarded_mutations,
                        sm::description("number of mutations forwarded to other replica Nodes"),
                        {storage_proxy_stats::current_scheduling_group_label()}).set_skip_when_empty(),
@@ -2712,7 +3127,7 @@ storage_proxy::storage_proxy(distributed<replica::database>& db, gms::gossiper&
     , _hints_write_smp_service_group(cfg.hints_write_smp_service_group)
     , _write_ack_smp_service_group(cfg.write_ack_smp_service_group)
     , _next_response_id(std::chrono::system_clock::now().time_since_epoch()/1ms)
-    , _hints_resource_manager(cfg.available_memory / 10, _db.local().get_config().max_hinted_handoff_concurrency)
+    , _hints_resource_manager(cfg.available_memory / 10, _db.local().get_config().max_hinted_handoff_concurrency, _db.local().get_config().hinted_handoff_throttle_in_kb)
     , _hints_manager(_db.local().get_config().hints_directory(), cfg.hinted_handoff_enabled, _db.local().get_config().max_hint_window_in_ms(), _hints_resource_manager, _db)
     , _hints_directory_initializer(std::move(cfg.hints_directory_initializer))
     , _hints_for_views_manager(_db.local().get_config().view_hints_directory(), {}, _db.local().get_config().max_hint_window_in_ms(), _hints_resource_manager, _db)
@@ -3018,7 +3433,13 @@ future<result<storage_proxy::unique_response_handler_vector>> storage_proxy::mut
 
 future<result<>> storage_proxy::mutate_begin(unique_response_handler_vector ids, db::consistency_level cl,
                                      tracing::trace_state_ptr trace_state, std::optional<clock_type::time_point> timeout_opt) {
-    return utils::result_parallel_for_each<result<>>(ids, [this, cl, timeout_opt] (unique_response_handler& protected_response) {
+    // The mutations are all sent before result_parallel_for_each() returns, so the
+    // ones going to the same replica can share a single rpc.
+    bool batch = _remote && ids.size() > 1;
+    if (batch) {
+        _remote->begin_mutation_batch();
+    }
+    auto res = utils::result_parallel_for_each<result<>>(ids, [this, cl, timeout_opt] (unique_response_handler& protected_response) {
         auto response_id = protected_response.id;
         // This function, mutate_begin(), is called after a preemption point
         // so it's possible that other code besides our caller just ran. In
@@ -3049,6 +3470,10 @@ future<result<>> storage_proxy::mutate_begin(unique_response_handler_vector ids,
         send_to_live_endpoints(protected_response.release(), timeout); // response is now running and it will either complete or timeout
         return f;
     });
+    if (batch) {
+        _remote->flush_mutation_batches();
+    }
+    return res;
 }
 
 // this function should be called with a future that holds result of mutation attempt (usually
@@ -3172,7 +3597,7 @@ future<> storage_proxy::mutate_counters(Range&& mutations, db::consistency_level
             get_stats().writes_coordinator_outside_replica_set += fms.size();
 
             co_await remote().send_counter_mutation(
-                    netw::messaging_service::msg_addr{ endpoint_and_mutations.first, 0 }, timeout, tr_state,
+                    remote().addr_for(endpoint_and_mutations.first), timeout, tr_state,
                     std::move(fms), cl);
         }
       } catch (...) {
@@ -3276,14 +3701,16 @@ future<> storage_proxy::mutate(std::vector<mutation> mutations, db::consistency_
 }
 
 future<result<>> storage_proxy::mutate_result(std::vector<mutation> mutations, db::consistency_level cl, clock_type::time_point timeout, tracing::trace_state_ptr tr_state, service_permit permit, db::allow_per_partition_rate_limit allow_limit, bool raw_counters) {
+    tracing::stage_timer coordinator_timer(tr_state, tracing::latency_stage::coordinator);
     if (_cdc && _cdc->needs_cdc_augmentation(mutations)) {
         return _cdc->augment_mutation_call(timeout, std::move(mutations), tr_state, cl).then([this, cl, timeout, tr_state, permit = std::move(permit), raw_counters, cdc = _cdc->shared_from_this(), allow_limit](std::tuple<std::vector<mutation>, lw_shared_ptr<cdc::operation_result_tracker>>&& t) mutable {
             auto mutations = std::move(std::get<0>(t));
             auto tracker = std::move(std::get<1>(t));
             return _mutate_stage(this, std::move(mutations), cl, timeout, std::move(tr_state), std::move(permit), raw_counters, allow_limit, std::move(tracker));
-        });
+        }).finally([coordinator_timer = std::move(coordinator_timer)] {});
     }
-    return _mutate_stage(this, std::move(mutations), cl, timeout, std::move(tr_state), std::move(permit), raw_counters, allow_limit, nullptr);
+    return _mutate_stage(this, std::move(mutations), cl, timeout, std::move(tr_state), std::move(permit), raw_counters, allow_limit, nullptr)
+            .finally([coordinator_timer = std::move(coordinator_timer)] {});
 }
 
 future<result<>> storage_proxy::do_mutate(std::vector<mutation> mutations, db::consistency_level cl, clock_type::time_point timeout, tracing::trace_state_ptr tr_state, service_permit permit, bool raw_counters, db::allow_per_partition_rate_limit allow_limit, lw_shared_ptr<cdc::operation_result_tracker> cdc_tracker) {
@@ -3598,6 +4025,18 @@ future<> storage_proxy::send_to_endpoint(
         tracing::trace_state_ptr tr_state,
         write_stats& stats,
         allow_hints allow_hints) {
+    return send_mutations_to_endpoint(std::array{std::move(m)}, target, std::move(pending_endpoints), type, std::move(tr_state), stats, allow_hints);
+}
+
+template<typename Range>
+future<> storage_proxy::send_mutations_to_endpoint(
+        Range&& mutations,
+        gms::inet_address target,
+        inet_address_vector_topology_change pending_endpoints,
+        db::write_type type,
+        tracing::trace_state_ptr tr_state,
+        write_stats& stats,
+        allow_hints allow_hints) {
     utils::latency_counter lc;
     lc.start();
 
@@ -3608,7 +4047,7 @@ future<> storage_proxy::send_to_endpoint(
         // and to apply backpressure.
         timeout = clock_type::now() + 5min;
     }
-    return mutate_prepare(std::array{std::move(m)}, cl, type, /* does view building should hold a real permit */ empty_service_permit(),
+    return mutate_prepare(std::forward<Range>(mutations), cl, type, /* does view building should hold a real permit */ empty_service_permit(),
             [this, tr_state, target = std::array{target}, pending_endpoints = std::move(pending_endpoints), &stats] (
                 std::unique_ptr<mutation_holder>& m,
                 db::consistency_level cl,
@@ -3679,6 +4118,28 @@ future<> storage_proxy::send_to_endpoint(
             allow_hints);
 }
 
+future<> storage_proxy::send_to_endpoint(
+        std::vector<frozen_mutation_and_schema> fms,
+        gms::inet_address target,
+        inet_address_vector_topology_change pending_endpoints,
+        db::write_type type,
+        tracing::trace_state_ptr tr_state,
+        allow_hints allow_hints) {
+    std::vector<std::unique_ptr<mutation_holder>> ms;
+    ms.reserve(fms.size());
+    for (auto& fm_a_s : fms) {
+        ms.push_back(std::make_unique<shared_mutation>(std::move(fm_a_s)));
+    }
+    return send_mutations_to_endpoint(
+            std::move(ms),
+            std::move(target),
+            std::move(pending_endpoints),
+            type,
+            std::move(tr_state),
+            get_stats(),
+            allow_hints);
+}
+
 future<> storage_proxy::send_hint_to_endpoint(frozen_mutation_and_schema fm_a_s, gms::inet_address target) {
     if (!_features.hinted_handoff_separate_connection) {
         return send_to_endpoint(
@@ -3701,6 +4162,31 @@ future<> storage_proxy::send_hint_to_endpoint(frozen_mutation_and_schema fm_a_s,
             allow_hints::no);
 }
 
+future<> storage_proxy::send_hints_to_endpoint(std::vector<frozen_mutation_and_schema> fms, gms::inet_address target) {
+    if (!_features.hinted_handoff_separate_connection) {
+        co_await coroutine::parallel_for_each(fms, [this, target] (frozen_mutation_and_schema& fm_a_s) {
+            return send_hint_to_endpoint(std::move(fm_a_s), target);
+        });
+        co_return;
+    }
+
+    // All the hints are sent by a single mutate_begin(), which sends the ones
+    // going to the same replica in a single rpc.
+    std::vector<std::unique_ptr<mutation_holder>> ms;
+    ms.reserve(fms.size());
+    for (auto& fm_a_s : fms) {
+        ms.push_back(std::make_unique<hint_mutation>(std::move(fm_a_s)));
+    }
+    co_await send_mutations_to_endpoint(
+            std::move(ms),
+            std::move(target),
+            { },
+            db::write_type::SIMPLE,
+            tracing::trace_state_ptr(),
+            get_stats(),
+            allow_hints::no);
+}
+
 future<> storage_proxy::send_hint_to_all_replicas(frozen_mutation_and_schema fm_a_s) {
     if (!_features.hinted_handoff_separate_connection) {
         std::array<mutation, 1> ms{fm_a_s.fm.unfreeze(fm_a_s.s)};
@@ -3753,6 +4239,11 @@ void storage_proxy::send_to_live_endpoints(storage_proxy::response_id_type respo
                 dc_groups[dc].push_back(dest);
             }
         }
+        if (_remote) {
+            for (auto& [dc, replicas] : dc_groups) {
+                _remote->prefer_batched_remote_dc_coordinator(replicas);
+            }
+        }
     } else {
         // There is only one target replica and it is me
         local.emplace_back("", handler.get_targets());
@@ -3767,7 +4258,7 @@ void storage_proxy::send_to_live_endpoints(storage_proxy::response_id_type respo
                 .then([response_id, this, my_address, h = std::move(handler_ptr), p = shared_from_this()] {
             // make mutation alive until it is processed locally, otherwise it
             // may disappear if write timeouts before this future is ready
-            got_response(response_id, my_address, get_view_update_backlog());
+            got_response(response_id, my_address, get_view_update_backlog(*h->get_schema()));
         });
     };
 
@@ -4640,13 +5131,20 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
     }
 
 protected:
+    // Reads of a single partition go to the shard of ep owning it.
+    netw::msg_addr replica_addr(gms::inet_address ep) const {
+        if (_partition_range.is_singular()) {
+            return _proxy->remote().addr_for(ep, _partition_range.start()->value().token());
+        }
+        return _proxy->remote().addr_for(ep);
+    }
     future<rpc::tuple<foreign_ptr<lw_shared_ptr<reconcilable_result>>, cache_temperature>> make_mutation_data_request(lw_shared_ptr<query::read_command> cmd, gms::inet_address ep, clock_type::time_point timeout) {
         ++_proxy->get_stats().mutation_data_read_attempts.get_ep_stat(get_topology(), ep);
         if (fbu::is_me(ep)) {
             tracing::trace(_trace_state, "read_mutation_data: querying locally");
             return _proxy->query_mutations_locally(_schema, cmd, _partition_range, timeout, _trace_state);
         } else {
-            return _proxy->remote().send_read_mutation_data(netw::messaging_service::msg_addr{ep, 0}, timeout, _trace_state, *cmd, _partition_range);
+            return _proxy->remote().send_read_mutation_data(replica_addr(ep), timeout, _trace_state, *cmd, _partition_range);
         }
     }
     future<rpc::tuple<foreign_ptr<lw_shared_ptr<query::result>>, cache_temperature>> make_data_request(gms::inet_address ep, clock_type::time_point timeout, bool want_digest) {
@@ -4658,7 +5156,7 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
             tracing::trace(_trace_state, "read_data: querying locally");
             return _proxy->query_result_local(_schema, _cmd, _partition_range, opts, _trace_state, timeout, adjust_rate_limit_for_local_operation(_rate_limit_info));
         } else {
-            return _proxy->remote().send_read_data(netw::messaging_service::msg_addr{ep, 0}, timeout, _trace_state, *_cmd, _partition_range, opts.digest_algo, _rate_limit_info);
+            return _proxy->remote().send_read_data(replica_addr(ep), timeout, _trace_state, *_cmd, _partition_range, opts.digest_algo, _rate_limit_info);
         }
     }
     future<rpc::tuple<query::result_digest, api::timestamp_type, cache_temperature, std::optional<full_position>>> make_digest_request(gms::inet_address ep, clock_type::time_point timeout) {
@@ -4669,12 +5167,13 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
                         timeout, digest_algorithm(*_proxy), adjust_rate_limit_for_local_operation(_rate_limit_info));
         } else {
             tracing::trace(_trace_state, "read_digest: sending a message to /{}", ep);
-            return _proxy->remote().send_read_digest(netw::messaging_service::msg_addr{ep, 0}, timeout, _trace_state, *_cmd, _partition_range, digest_algorithm(*_proxy), _rate_limit_info);
+            return _proxy->remote().send_read_digest(replica_addr(ep), timeout, _trace_state, *_cmd, _partition_range, digest_algorithm(*_proxy), _rate_limit_info);
         }
     }
     void make_mutation_data_requests(lw_shared_ptr<query::read_command> cmd, data_resolver_ptr resolver, targets_iterator begin, targets_iterator end, clock_type::time_point timeout) {
         auto start = latency_clock::now();
         for (const gms::inet_address& ep : boost::make_iterator_range(begin, end)) {
+            _proxy->_endpoint_latency_scorer.request_started(ep);
             // Waited on indirectly, shared_from_this keeps `this` alive
             (void)make_mutation_data_request(cmd, ep, timeout).then_wrapped([this, resolver, ep, start, exec = shared_from_this()] (future<rpc::tuple<foreign_ptr<lw_shared_ptr<reconcilable_result>>, cache_temperature>> f) {
                 std::exception_ptr ex;
@@ -4684,7 +5183,9 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
                     _cf->set_hit_rate(ep, std::get<1>(v));
                     resolver->add_mutate_data(ep, std::get<0>(std::move(v)));
                     ++_proxy->get_stats().mutation_data_read_completed.get_ep_stat(get_topology(), ep);
-                    register_request_latency(latency_clock::now() - start);
+                    auto latency = latency_clock::now() - start;
+                    _proxy->_endpoint_latency_scorer.request_completed(ep, std::chrono::duration_cast<std::chrono::microseconds>(latency));
+                    register_request_latency(latency);
                     return;
                   } else {
                     ex = f.get_exception();
@@ -4693,6 +5194,7 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
                   ex = std::current_exception();
                 }
 
+                _proxy->_endpoint_latency_scorer.request_failed(ep);
                 ++_proxy->get_stats().mutation_data_read_errors.get_ep_stat(get_topology(), ep);
                 resolver->error(ep, std::move(ex));
             });
@@ -4701,6 +5203,7 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
     void make_data_requests(digest_resolver_ptr resolver, targets_iterator begin, targets_iterator end, clock_type::time_point timeout, bool want_digest) {
         auto start = latency_clock::now();
         for (const gms::inet_address& ep : boost::make_iterator_range(begin, end)) {
+            _proxy->_endpoint_latency_scorer.request_started(ep);
             // Waited on indirectly, shared_from_this keeps `this` alive
             (void)make_data_request(ep, timeout, want_digest).then_wrapped([this, resolver, ep, start, exec = shared_from_this()] (future<rpc::tuple<foreign_ptr<lw_shared_ptr<query::result>>, cache_temperature>> f) {
                 std::exception_ptr ex;
@@ -4711,7 +5214,9 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
                     resolver->add_data(ep, std::get<0>(std::move(v)));
                     ++_proxy->get_stats().data_read_completed.get_ep_stat(get_topology(), ep);
                     _used_targets.push_back(ep);
-                    register_request_latency(latency_clock::now() - start);
+                    auto latency = latency_clock::now() - start;
+                    _proxy->_endpoint_latency_scorer.request_completed(ep, std::chrono::duration_cast<std::chrono::microseconds>(latency));
+                    register_request_latency(latency);
                     return;
                   } else {
                     ex = f.get_exception();
@@ -4720,6 +5225,7 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
                   ex = std::current_exception();
                 }
 
+                _proxy->_endpoint_latency_scorer.request_failed(ep);
                 ++_proxy->get_stats().data_read_errors.get_ep_stat(get_topology(), ep);
                 resolver->error(ep, std::move(ex));
             });
@@ -4728,6 +5234,7 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
     void make_digest_requests(digest_resolver_ptr resolver, targets_iterator begin, targets_iterator end, clock_type::time_point timeout) {
         auto start = latency_clock::now();
         for (const gms::inet_address& ep : boost::make_iterator_range(begin, end)) {
+            _proxy->_endpoint_latency_scorer.request_started(ep);
             // Waited on indirectly, shared_from_this keeps `this` alive
             (void)make_digest_request(ep, timeout).then_wrapped([this, resolver, ep, start, exec = shared_from_this()] (future<rpc::tuple<query::result_digest, api::timestamp_type, cache_temperature, std::optional<full_position>>> f) {
                 std::exception_ptr ex;
@@ -4738,7 +5245,9 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
                     resolver->add_digest(ep, std::get<0>(v), std::get<1>(v), std::get<3>(std::move(v)));
                     ++_proxy->get_stats().digest_read_completed.get_ep_stat(get_topology(), ep);
                     _used_targets.push_back(ep);
-                    register_request_latency(latency_clock::now() - start);
+                    auto latency = latency_clock::now() - start;
+                    _proxy->_endpoint_latency_scorer.request_completed(ep, std::chrono::duration_cast<std::chrono::microseconds>(latency));
+                    register_request_latency(latency);
                     return;
                   } else {
                     ex = f.get_exception();
@@ -4747,6 +5256,7 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
                   ex = std::current_exception();
                 }
 
+                _proxy->_endpoint_latency_scorer.request_failed(ep);
                 ++_proxy->get_stats().digest_read_errors.get_ep_stat(get_topology(), ep);
                 resolver->error(ep, std::move(ex));
             });
@@ -5010,11 +5520,32 @@ class always_speculating_read_executor : public abstract_read_executor {
 // this executor sends request to an additional replica after some time below timeout
 class speculating_read_executor : public abstract_read_executor {
     timer<storage_proxy::clock_type> _speculate_timer;
+    // See read_hedging_max_ratio.
+    bool _hedging = false;
+private:
+    // Returns the largest percentile of the read latencies of the replicas
+    // which are sent the initial requests, since all of them must answer.
+    std::optional<std::chrono::microseconds> replica_latency_percentile(double percentile) {
+        std::optional<std::chrono::microseconds> ret;
+        for (auto ep : boost::make_iterator_range(_targets.begin(), _targets.end() - 1)) {
+            auto latency = _proxy->_endpoint_latency_scorer.latency_quantile(ep, percentile);
+            if (!latency) {
+                // Not enough is known of this replica, fall back to the table latencies.
+                return std::nullopt;
+            }
+            ret = std::max(ret.value_or(*latency), *latency);
+        }
+        return ret;
+    }
 public:
     using abstract_read_executor::abstract_read_executor;
     virtual void make_requests(digest_resolver_ptr resolver, storage_proxy::clock_type::time_point timeout) override {
         _speculate_timer.set_callback([this, resolver, timeout] {
             if (!resolver->is_completed()) { // at the time the callback runs request may be completed already
+                if (_hedging && !_proxy->_read_hedging_budget.try_spend()) {
+                    _proxy->get_stats().speculative_reads_over_budget++;
+                    return;
+                }
                 resolver->add_wait_targets(1); // we send one more request so wait for it too
                 // FIXME: consider disabling for CL=*ONE
                 auto send_request = [&] (bool has_data) {
@@ -5030,9 +5561,23 @@ class speculating_read_executor : public abstract_read_executor {
             }
         });
         auto& sr = _schema->speculative_retry();
-        auto t = (sr.get_type() == speculative_retry::type::PERCENTILE) ?
-            std::min(_cf->get_coordinator_read_latency_percentile(sr.get_value()), std::chrono::milliseconds(_proxy->get_db().local().get_config().read_request_timeout_in_ms()/2)) :
-            std::chrono::milliseconds(unsigned(sr.get_value()));
+        const auto& cfg = _proxy->get_db().local().get_config();
+        auto max_hedged_ratio = cfg.read_hedging_max_ratio();
+        _hedging = max_hedged_ratio > 0;
+        if (_hedging) {
+            _proxy->_read_hedging_budget.read_started(max_hedged_ratio);
+        }
+        storage_proxy::clock_type::duration t;
+        if (sr.get_type() == speculative_retry::type::PERCENTILE) {
+            auto latency = _cf->get_coordinator_read_latency_percentile(sr.get_value());
+            if (_hedging) {
+                latency = replica_latency_percentile(sr.get_value()).value_or(latency);
+            }
+            t = std::chrono::ceil<storage_proxy::clock_type::duration>(latency);
+            t = std::min(t, storage_proxy::clock_type::duration(std::chrono::milliseconds(cfg.read_request_timeout_in_ms()/2)));
+        } else {
+            t = std::chrono::milliseconds(unsigned(sr.get_value()));
+        }
         _speculate_timer.arm(t);
 
         // if CL + RR result in covering all replicas, getReadExecutor forces AlwaysSpeculating.  So we know
@@ -5097,12 +5642,18 @@ result<::shared_ptr<abstract_read_executor>> storage_proxy::get_read_executor(lw
     // orders the list by proximity to the local endpoint.
     is_read_non_local |= !all_replicas.empty() && all_replicas.front() != utils::fb_utilities::get_broadcast_address();
 
+    const auto& cfg = _db.local().get_config();
+    if (cfg.dynamic_snitch()) {
+        _endpoint_latency_scorer.sort_by_score(all_replicas, cfg.dynamic_snitch_badness_threshold(),
+                std::chrono::milliseconds(cfg.dynamic_snitch_reset_interval_in_ms()));
+    }
+
     auto cf = _db.local().find_column_family(schema).shared_from_this();
     auto& gossiper = _remote->gossiper();
     inet_address_vector_replica_set target_replicas = db::filter_for_query(cl, *erm, all_replicas, preferred_endpoints, repair_decision,
             gossiper,
             retry_type == speculative_retry::type::NONE ? nullptr : &extra_replica,
-            _db.local().get_config().cache_hit_rate_read_balancing() ? &*cf : nullptr);
+            cfg.cache_hit_rate_read_balancing() ? &*cf : nullptr);
 
     slogger.trace("creating read executor for token {} with all: {} targets: {} rp decision: {}", token, all_replicas, target_replicas, repair_decision);
     tracing::trace(trace_state, "Creating read executor for token {} with all: {} targets: {} repair decision: {}", token, all_replicas, target_replicas, repair_decision);
@@ -5361,6 +5912,33 @@ bool storage_proxy::is_worth_merging_for_range_query(
         : true;
 }
 
+// Returns how many token ranges the next round of a range scan should query,
+// given that the ranges_queried ranges queried so far, the last
+// concurrency_factor of them concurrently, returned rows_fetched rows of
+// partitions_fetched partitions.
+//
+// Doubling the concurrency every round takes many rounds to ramp up for
+// scans of tables with sparse data, and overshoots the page for scans
+// which are nearly done with it. So the next round queries as many ranges as
+// needed to fill the rest of the page, going by the average of the ranges
+// queried so far, with some margin. If nothing was found yet, there is
+// nothing to estimate from, so the concurrency is ramped up fast.
+static int next_range_scan_concurrency(int concurrency_factor, size_t ranges_queried, uint64_t rows_fetched, uint64_t partitions_fetched,
+        uint64_t remaining_row_count, uint32_t remaining_partition_count, uint32_t max_concurrency) {
+    auto max = double(std::max(max_concurrency, 1u));
+    if (!rows_fetched && !partitions_fetched) {
+        return int(std::min(double(concurrency_factor) * 4, max));
+    }
+    auto needed = max;
+    if (rows_fetched) {
+        needed = std::min(needed, remaining_row_count / (double(rows_fetched) / ranges_queried));
+    }
+    if (partitions_fetched) {
+        needed = std::min(needed, remaining_partition_count / (double(partitions_fetched) / ranges_queried));
+    }
+    return int(std::clamp(std::ceil(needed * 1.2), 1.0, max));
+}
+
 future<result<query_partition_key_range_concurrent_result>>
 storage_proxy::query_partition_key_range_concurrent(storage_proxy::clock_type::time_point timeout,
         locator::effective_replication_map_ptr erm,
@@ -5369,6 +5947,7 @@ storage_proxy::query_partition_key_range_concurrent(storage_proxy::clock_type::t
         db::consistency_level cl,
         query_ranges_to_vnodes_generator&& ranges_to_vnodes,
         int concurrency_factor,
+        size_t ranges_queried,
         tracing::trace_state_ptr trace_state,
         uint64_t remaining_row_count,
         uint32_t remaining_partition_count,
@@ -5400,6 +5979,7 @@ storage_proxy::query_partition_key_range_concurrent(storage_proxy::clock_type::t
     // eventualy zero out resulting in an infinite recursion. This line makes sure that concurrency factor is never
     // get stuck on 0 and never increased too much if the number of results remains small.
     concurrency_factor = std::max(size_t(1), ranges.size());
+    ranges_queried += ranges.size();
 
     auto& gossiper = _remote->gossiper();
     while (i != ranges.end()) {
@@ -5528,6 +6108,7 @@ storage_proxy::query_partition_key_range_concurrent(storage_proxy::clock_type::t
             cl,
             cmd,
             concurrency_factor,
+            ranges_queried,
             timeout,
             remaining_row_count,
             remaining_partition_count,
@@ -5556,8 +6137,18 @@ storage_proxy::query_partition_key_range_concurrent(storage_proxy::clock_type::t
         } else {
             cmd->set_row_limit(remaining_row_count);
             cmd->partition_limit = remaining_partition_count;
+            uint64_t rows_fetched = 0;
+            uint64_t partitions_fetched = 0;
+            for (auto& r : results) {
+                rows_fetched += r->row_count().value();
+                partitions_fetched += r->partition_count().value();
+            }
+            auto next_concurrency_factor = next_range_scan_concurrency(concurrency_factor, ranges_queried, rows_fetched, partitions_fetched,
+                    remaining_row_count, remaining_partition_count, p->_db.local().get_config().range_scan_max_concurrency());
+            tracing::trace(trace_state, "Read {} rows of {} partitions from {} ranges, querying {} ranges next", rows_fetched, partitions_fetched,
+                    ranges_queried, next_concurrency_factor);
             return p->query_partition_key_range_concurrent(timeout, std::move(erm), std::move(results), cmd, cl, std::move(ranges_to_vnodes),
-                    concurrency_factor * 2, std::move(trace_state), remaining_row_count, remaining_partition_count, std::move(preferred_replicas), std::move(permit));
+                    next_concurrency_factor, ranges_queried, std::move(trace_state), remaining_row_count, remaining_partition_count, std::move(preferred_replicas), std::move(permit));
         }
       }));
     },  utils::result_catch_dots([p] (auto&& handle) {
@@ -5609,6 +6200,7 @@ storage_proxy::query_partition_key_range(lw_shared_ptr<query::read_command> cmd,
             cl,
             std::move(ranges_to_vnodes),
             concurrency_factor,
+            0,
             std::move(query_options.trace_state),
             cmd->get_row_limit(),
             cmd->partition_limit,
@@ -5648,6 +6240,7 @@ storage_proxy::query_result(schema_ptr s,
     db::consistency_level cl,
     storage_proxy::coordinator_query_options query_options)
 {
+    tracing::stage_timer coordinator_timer(query_options.trace_state, tracing::latency_stage::coordinator);
     if (slogger.is_enabled(logging::log_level::trace) || qlogger.is_enabled(logging::log_level::trace)) {
         static thread_local int next_id = 0;
         auto query_id = next_id++;
@@ -5673,10 +6266,137 @@ storage_proxy::query_result(schema_ptr s,
             }
             qlogger.trace("id={}, {}", query_id, res->pretty_printer(s, cmd->slice));
             return qr;
-        });
+        }).finally([coordinator_timer = std::move(coordinator_timer)] {});
+    }
+
+    return do_query(s, cmd, std::move(partition_ranges), cl, std::move(query_options)).finally([coordinator_timer = std::move(coordinator_timer)] {});
+}
+
+struct storage_proxy::coalesced_read {
+    dht::decorated_key key;
+    db::consistency_level cl;
+    // The read command, without the fields which differ between identical reads.
+    bytes command;
+    // Of the read, readers timing out before it don't join.
+    clock_type::time_point timeout;
+    // Set once the read is sent, readers arriving after that don't join it.
+    bool started = false;
+    unsigned readers = 1;
+    shared_promise<> done;
+    // Set before done is resolved, if readers joined.
+    lw_shared_ptr<query::result> result;
+    replicas_per_token_range last_replicas;
+    db::read_repair_decision read_repair_decision = db::read_repair_decision::NONE;
+    std::optional<exceptions::coordinator_exception_container> error;
+
+    bool matches(const schema& s, const dht::decorated_key& k, db::consistency_level c, const bytes& cmd) const {
+        return cl == c && key.equal(s, k) && command == cmd;
+    }
+};
+
+static bytes coalesced_read_command(const query::read_command& cmd) {
+    auto c = cmd;
+    c.timestamp = {};
+    c.query_uuid = {};
+    c.is_first_page = query::is_first_page::no;
+    bytes_ostream out;
+    ser::serialize(out, c);
+    // Not serialized with the command.
+    ser::serialize(out, bool(c.allow_limit));
+    return to_bytes(out.linearize());
+}
+
+// Copies r, which may belong to another shard, to this one.
+static lw_shared_ptr<query::result> local_query_result(const foreign_ptr<lw_shared_ptr<query::result>>& r) {
+    if (r.get_owner_shard() == this_shard_id()) {
+        return r.get();
     }
+    return make_lw_shared<query::result>(bytes_ostream(r->buf()), r->digest(), r->last_modified(), r->is_short_read(),
+            r->row_count_low_bits(), r->partition_count(), r->row_count_high_bits(), r->last_position());
+}
 
-    return do_query(s, cmd, std::move(partition_ranges), cl, std::move(query_options));
+future<result<storage_proxy::coordinator_query_result>>
+storage_proxy::query_singular_coalesced(lw_shared_ptr<query::read_command> cmd,
+        dht::partition_range_vector&& partition_ranges,
+        db::consistency_level cl,
+        storage_proxy::coordinator_query_options query_options) {
+    schema_ptr s;
+    try {
+        s = _db.local().find_schema(cmd->cf_id);
+    } catch (const replica::no_such_column_family&) {
+        co_return coordinator_query_result(make_foreign(make_lw_shared<query::result>()));
+    }
+    auto key = partition_ranges[0].start()->value().as_decorated_key();
+    auto command = coalesced_read_command(*cmd);
+    auto timeout = query_options.timeout(*this);
+    auto trace_state = query_options.trace_state;
+    auto token = key.token();
+
+    auto& reads = _coalesced_reads[token];
+    lw_shared_ptr<coalesced_read> in_flight;
+    lw_shared_ptr<coalesced_read> next;
+    for (auto& r : reads) {
+        if (r->matches(*s, key, cl, command)) {
+            (r->started ? in_flight : next) = r;
+        }
+    }
+    if (next && next->timeout <= timeout) {
+        ++next->readers;
+        ++get_stats().coalesced_reads;
+        tracing::trace(trace_state, "Waiting to share an identical read after the one in flight");
+        co_await next->done.get_shared_future();
+        if (next->error) {
+            co_return bo::failure(next->error->clone());
+        }
+        co_return coordinator_query_result(make_foreign(next->result), next->last_replicas, next->read_repair_decision);
+    }
+    if (next) {
+        // Can't wait for it, read on our own.
+        co_return co_await query_singular(std::move(cmd), std::move(partition_ranges), cl, std::move(query_options));
+    }
+
+    auto read = make_lw_shared<coalesced_read>(coalesced_read{std::move(key), cl, std::move(command), timeout});
+    reads.push_back(read);
+    auto remove = defer([this, token, read] () noexcept {
+        auto it = _coalesced_reads.find(token);
+        std::erase(it->second, read);
+        if (it->second.empty()) {
+            _coalesced_reads.erase(it);
+        }
+    });
+    if (in_flight) {
+        // Readers arriving now could read together with the read in flight, but
+        // they could miss writes completed after it was sent and before they
+        // arrived. So they wait for it and read anew.
+        tracing::trace(trace_state, "Waiting for an identical read in flight");
+        auto f = co_await coroutine::as_future(in_flight->done.get_shared_future());
+        f.ignore_ready_future();
+    }
+    read->started = true;
+
+    auto f = co_await coroutine::as_future(futurize_invoke([&] {
+        return query_singular(std::move(cmd), std::move(partition_ranges), cl, std::move(query_options));
+    }));
+    if (f.failed()) {
+        auto ex = f.get_exception();
+        read->done.set_exception(ex);
+        co_return coroutine::exception(std::move(ex));
+    }
+    auto res = f.get();
+    if (read->readers == 1) {
+        read->done.set_value();
+        co_return std::move(res);
+    }
+    if (!res) {
+        read->error = res.assume_error().clone();
+    } else {
+        // Shared by the readers, each through its own foreign_ptr.
+        read->result = local_query_result(res.value().query_result);
+        read->last_replicas = res.value().last_replicas;
+        read->read_repair_decision = res.value().read_repair_decision;
+    }
+    read->done.set_value();
+    co_return std::move(res);
 }
 
 future<result<storage_proxy::coordinator_query_result>>
@@ -5705,11 +6425,16 @@ storage_proxy::do_query(schema_ptr s,
         auto p = shared_from_this();
 
         if (query::is_single_partition(partition_ranges[0])) { // do not support mixed partitions (yet?)
+            // Paged reads carrying replicas or a read repair decision from
+            // earlier pages read on their own.
+            bool coalesce = _db.local().get_config().coordinator_read_coalescing() && partition_ranges.size() == 1
+                    && query_options.preferred_replicas.empty() && !query_options.read_repair_decision;
             try {
-                return query_singular(cmd,
+                return (coalesce ? query_singular_coalesced(cmd, std::move(partition_ranges), cl, std::move(query_options))
+                        : query_singular(cmd,
                         std::move(partition_ranges),
                         cl,
-                        std::move(query_options)).finally([lc, p] () mutable {
+                        std::move(query_options))).finally([lc, p] () mutable {
                     p->get_stats().read.mark(lc.stop().latency());
                 });
             } catch (const replica::no_such_column_family&) {
@@ -5825,6 +6550,227 @@ static mutation_write_failure_exception read_failure_to_write(schema_ptr s, read
  *
  * WARNING: the function should be called on a shard that owns the key cas() operates on
  */
+struct storage_proxy::pending_cas {
+    shared_ptr<cas_request> request;
+    lw_shared_ptr<query::read_command> cmd;
+    // Partitions with the same token share the coordinator lock, and the queue.
+    dht::decorated_key key;
+    db::consistency_level cl_for_paxos;
+    db::consistency_level cl_for_learn;
+    clock_type::time_point write_timeout;
+    // Set once the holder of the coordinator lock takes the request into its round.
+    bool coalesced = false;
+    bool condition_met = false;
+    promise<bool> result;
+};
+
+// Coalesced requests are evaluated against a value rebuilt from the read of the
+// round, which is only done for atomic columns, see cas_value_builder.
+static bool can_coalesce_cas(const schema& s, const query::partition_slice& slice) {
+    return !slice.get_specific_ranges()
+        && std::ranges::none_of(slice.static_columns, [&] (column_id id) { return s.static_column_at(id).type->is_multi_cell(); })
+        && std::ranges::none_of(slice.regular_columns, [&] (column_id id) { return s.regular_column_at(id).type->is_multi_cell(); });
+}
+
+// Whether a and b read the same columns and rows, of a partition to be compared separately.
+static bool same_cas_read(const schema& s, const query::read_command& a, const query::read_command& b) {
+    auto cmp = clustering_key_prefix::prefix_equal_tri_compare(s);
+    return a.schema_version == b.schema_version
+        && a.get_row_limit() == b.get_row_limit()
+        && a.slice.options.mask() == b.slice.options.mask()
+        && std::ranges::equal(a.slice.static_columns, b.slice.static_columns)
+        && std::ranges::equal(a.slice.regular_columns, b.slice.regular_columns)
+        && std::ranges::equal(a.slice.default_row_ranges(), b.slice.default_row_ranges(), [&] (const query::clustering_range& x, const query::clustering_range& y) {
+            return x.equal(y, cmp);
+        });
+}
+
+// Rebuilds the value read by a CAS round as a mutation with all cells written at
+// the given timestamp and a row marker on every row, so that querying it with the
+// same slice gives back the same result. TTLs are not kept, the value is only
+// read within the round. Whether a row had a marker is not known, see
+// deletes_regular_cells().
+// Implements ResultVisitor concept from query.hh
+class cas_value_builder {
+    const schema& _s;
+    const query::partition_slice& _slice;
+    mutation& _m;
+    api::timestamp_type _ts;
+private:
+    void apply_static_row(const query::result_row_view& static_row) {
+        auto it = static_row.iterator();
+        for (auto id : _slice.static_columns) {
+            const column_definition& def = _s.static_column_at(id);
+            if (auto cell = it.next_atomic_cell()) {
+                _m.set_static_cell(def, atomic_cell::make_live(*def.type, _ts, cell->value()));
+            }
+        }
+    }
+public:
+    cas_value_builder(const schema& s, const query::partition_slice& slice, mutation& m, api::timestamp_type ts)
+        : _s(s), _slice(slice), _m(m), _ts(ts)
+    { }
+
+    void accept_new_partition(const partition_key& key, uint64_t row_count) { }
+
+    void accept_new_partition(uint64_t row_count) {
+        assert(0);
+    }
+
+    void accept_new_row(const clustering_key& key, const query::result_row_view& static_row, const query::result_row_view& row) {
+        apply_static_row(static_row);
+        deletable_row& r = _m.partition().clustered_row(_s, key);
+        r.apply(row_marker(_ts));
+        auto it = row.iterator();
+        for (auto id : _slice.regular_columns) {
+            const column_definition& def = _s.regular_column_at(id);
+            if (auto cell = it.next_atomic_cell()) {
+                r.cells().apply(def, atomic_cell::make_live(*def.type, _ts, cell->value()));
+            }
+        }
+    }
+
+    void accept_new_row(const query::result_row_view& static_row, const query::result_row_view& row) {
+        assert(0);
+    }
+
+    void accept_partition_end(const query::result_row_view& static_row) {
+        apply_static_row(static_row);
+    }
+};
+
+// Whether m deletes a regular cell, which may be the last live cell of its row.
+// Rows rebuilt by cas_value_builder have a row marker, as the read doesn't tell
+// whether they had one, so such a row would wrongly still exist in the value
+// seen by the following requests.
+static bool deletes_regular_cells(const schema& s, const mutation& m) {
+    for (const rows_entry& e : m.partition().clustered_rows()) {
+        bool found = false;
+        e.row().cells().for_each_cell_until([&] (column_id id, const atomic_cell_or_collection& c) {
+            const column_definition& def = s.regular_column_at(id);
+            found = !def.is_atomic() || !c.as_atomic_cell(def).is_live();
+            return stop_iteration(found);
+        });
+        if (found) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void storage_proxy::remove_pending_cas(const dht::token& token, const pending_cas& p) noexcept {
+    auto it = _pending_cas.find(token);
+    if (it == _pending_cas.end()) {
+        return;
+    }
+    auto& queue = it->second;
+    auto i = std::ranges::find_if(queue, [&p] (const lw_shared_ptr<pending_cas>& q) { return q.get() == &p; });
+    if (i != queue.end()) {
+        queue.erase(i);
+    }
+    if (queue.empty()) {
+        _pending_cas.erase(it);
+    }
+}
+
+lw_shared_ptr<storage_proxy::deferred_learn> storage_proxy::find_deferred_learn(const schema& s, const dht::decorated_key& key) const {
+    auto it = _deferred_learns.find(key.token());
+    if (it == _deferred_learns.end()) {
+        return nullptr;
+    }
+    auto i = std::ranges::find_if(it->second, [&] (const lw_shared_ptr<deferred_learn>& l) { return l->table == s.id() && l->key.equal(s, key); });
+    return i != it->second.end() ? *i : nullptr;
+}
+
+void storage_proxy::remove_deferred_learn(const deferred_learn& learn) noexcept {
+    auto it = _deferred_learns.find(learn.key.token());
+    if (it == _deferred_learns.end()) {
+        return;
+    }
+    auto& learns = it->second;
+    auto i = std::ranges::find_if(learns, [&learn] (const lw_shared_ptr<deferred_learn>& l) { return l.get() == &learn; });
+    if (i != learns.end()) {
+        learns.erase(i);
+    }
+    if (learns.empty()) {
+        _deferred_learns.erase(it);
+    }
+}
+
+std::vector<lw_shared_ptr<storage_proxy::pending_cas>>
+storage_proxy::coalesce_pending_cas(const dht::token& token, const schema& s, const pending_cas& leader, unsigned max) {
+    std::vector<lw_shared_ptr<pending_cas>> ret;
+    auto it = _pending_cas.find(token);
+    if (it == _pending_cas.end()) {
+        return ret;
+    }
+    auto& queue = it->second;
+    for (auto i = queue.begin(); i != queue.end() && ret.size() < max;) {
+        auto& p = **i;
+        // The round runs with the consistency levels and timeouts of the leader.
+        if (&p != &leader && p.cl_for_paxos == leader.cl_for_paxos && p.cl_for_learn == leader.cl_for_learn
+                && p.write_timeout >= leader.write_timeout && same_cas_read(s, *p.cmd, *leader.cmd) && p.key.equal(s, leader.key)) {
+            p.coalesced = true;
+            ret.push_back(std::move(*i));
+            i = queue.erase(i);
+        } else {
+            ++i;
+        }
+    }
+    if (queue.empty()) {
+        _pending_cas.erase(it);
+    }
+    return ret;
+}
+
+std::optional<mutation> storage_proxy::apply_coalesced_cas(schema_ptr s, const partition_key& key, const query::read_command& cmd,
+        foreign_ptr<lw_shared_ptr<query::result>> qr, api::timestamp_type ts, api::timestamp_type min_ts,
+        std::deque<lw_shared_ptr<pending_cas>>& pending, std::vector<lw_shared_ptr<pending_cas>>& evaluated) {
+    // Each request writes with a distinct timestamp, so that the updates of the later ones
+    // override the updates of the earlier ones, and all of them newer than the most recent
+    // commit. Requests which don't fit are left for the next round.
+    auto n = std::min<size_t>(pending.size(), std::max<api::timestamp_type>(ts - min_ts + 1, 1));
+    auto first_ts = ts - api::timestamp_type(n - 1);
+
+    // The value each request reads is the one read by the round with the updates
+    // of the requests before it applied.
+    mutation current(s, key);
+    query::result_view::consume(*qr, cmd.slice, cas_value_builder(*s, cmd.slice, current, api::min_timestamp));
+    auto now = gc_clock::now();
+
+    std::optional<mutation> updates;
+    bool last = false;
+    for (size_t i = 0; i < n; ++i) {
+        auto p = std::move(pending.front());
+        pending.pop_front();
+        try {
+            auto value = i == 0 ? std::move(qr)
+                    : make_foreign(make_lw_shared<query::result>(query_mutation(mutation(current), cmd.slice, cmd.get_row_limit(), now)));
+            auto m = p->request->apply(std::move(value), cmd.slice, first_ts + i);
+            p->condition_met = bool(m);
+            // The requests after it are left for the next round, which reads the real value.
+            last = m && deletes_regular_cells(*s, *m);
+            if (m) {
+                current.apply(*m);
+                if (updates) {
+                    updates->apply(std::move(*m));
+                } else {
+                    updates = std::move(m);
+                }
+            } else {
+                ++get_stats().cas_write_condition_not_met;
+            }
+            evaluated.push_back(std::move(p));
+        } catch (...) {
+            p->result.set_exception(std::current_exception());
+        }
+        if (last) {
+            break;
+        }
+    }
+    return updates;
+}
+
 future<bool> storage_proxy::cas(schema_ptr schema, shared_ptr<cas_request> request, lw_shared_ptr<query::read_command> cmd,
         dht::partition_range_vector partition_ranges, storage_proxy::coordinator_query_options query_options,
         db::consistency_level cl_for_paxos, db::consistency_level cl_for_learn,
@@ -5864,13 +6810,33 @@ future<bool> storage_proxy::cas(schema_ptr schema, shared_ptr<cas_request> reque
 
     unsigned contentions;
 
-    dht::token token = partition_ranges[0].start()->value().as_decorated_key().token();
+    const dht::decorated_key& dkey = partition_ranges[0].start()->value().as_decorated_key();
+    dht::token token = dkey.token();
     utils::latency_counter lc;
     lc.start();
 
+    // Concurrent writes to the partition queue up on the coordinator lock below. Register
+    // ours, so that the holder of the lock can apply it in its round, and apply
+    // the writes registered by others in our round once we hold the lock.
+    unsigned max_coalesced = _db.local().get_config().lwt_max_coalesced_requests();
+    lw_shared_ptr<pending_cas> self;
+    if (write && max_coalesced > 1 && can_coalesce_cas(*schema, cmd->slice)) {
+        self = make_lw_shared<pending_cas>(pending_cas{request, cmd, dkey, cl_for_paxos, cl_for_learn, write_timeout});
+        _pending_cas[token].push_back(self);
+    }
+    auto unregister = defer([&] () noexcept {
+        if (self && !self->coalesced) {
+            remove_pending_cas(token, *self);
+        }
+    });
+    // The requests left to apply, ours first, and the ones evaluated in the current round.
+    std::deque<lw_shared_ptr<pending_cas>> pending;
+    std::vector<lw_shared_ptr<pending_cas>> evaluated;
+
     bool condition_met;
 
     try {
+      try {
         auto update_stats = seastar::defer ([&] {
             get_stats().cas_foreground--;
             write ? get_stats().cas_write.mark(lc.stop().latency()) : get_stats().cas_read.mark(lc.stop().latency());
@@ -5881,11 +6847,30 @@ future<bool> storage_proxy::cas(schema_ptr schema, shared_ptr<cas_request> reque
 
         paxos::paxos_state::guard l = co_await paxos::paxos_state::get_cas_lock(token, write_timeout);
 
+        if (self) {
+            if (self->coalesced) {
+                paxos::paxos_state::logger.debug("CAS[{}] applied in the round of another request", handler->id());
+                tracing::trace(handler->tr_state, "CAS applied in the Paxos round of another request");
+                co_return co_await self->result.get_future();
+            }
+            remove_pending_cas(token, *self);
+            pending.push_back(self);
+            for (auto& p : coalesce_pending_cas(token, *schema, *self, max_coalesced - 1)) {
+                pending.push_back(std::move(p));
+            }
+            get_stats().cas_write_coalesced += pending.size() - 1;
+        }
+
         while (true) {
+            if (auto learn = find_deferred_learn(*schema, dkey)) {
+                // Let the learn of the previous round on the key complete first, so that our
+                // prepare doesn't find the previous round in progress and repeat it.
+                co_await learn->done.get_shared_future();
+            }
             // Finish the previous PAXOS round, if any, and, as a side effect, compute
             // a ballot (round identifier) which is a) unique b) has good chances of being
             // recent enough.
-            auto [ballot, qr] = co_await handler->begin_and_repair_paxos(query_options.cstate, contentions, write);
+            auto [ballot, qr, min_timestamp] = co_await handler->begin_and_repair_paxos(query_options.cstate, contentions, write);
             // Read the current values and check they validate the conditions.
             if (qr) {
                 paxos::paxos_state::logger.debug("CAS[{}]: Using prefetched values for CAS precondition",
@@ -5902,26 +6887,42 @@ future<bool> storage_proxy::cas(schema_ptr schema, shared_ptr<cas_request> reque
                 qr = std::move(cqr.query_result);
             }
 
-            auto mutation = request->apply(std::move(qr), cmd->slice, utils::UUID_gen::micros_timestamp(ballot));
-            condition_met = true;
-            if (!mutation) {
-                if (write) {
-                    paxos::paxos_state::logger.debug("CAS[{}] precondition does not match current values", handler->id());
-                    tracing::trace(handler->tr_state, "CAS precondition does not match current values");
-                    ++get_stats().cas_write_condition_not_met;
-                    condition_met = false;
+            std::optional<mutation> mutation;
+            if (self) {
+                auto ts = utils::UUID_gen::micros_timestamp(ballot);
+                mutation = apply_coalesced_cas(schema, handler->key(), *cmd, std::move(qr), ts, min_timestamp, pending, evaluated);
+                paxos::paxos_state::logger.debug("CAS[{}] proposing updates of {} requests, {} of which met their precondition, for {}",
+                        handler->id(), evaluated.size(), std::ranges::count_if(evaluated, [] (auto& p) { return p->condition_met; }), ballot);
+                tracing::trace(handler->tr_state, "Proposing updates of {} requests for {}", evaluated.size(), ballot);
+                if (mutation) {
+                    handler->set_cl_for_learn(cl_for_learn);
+                } else {
+                    // As below, complete the round with an empty mutation.
+                    mutation.emplace(handler->schema(), handler->key());
+                    handler->set_cl_for_learn(db::consistency_level::ANY);
                 }
-                // If a condition is not met we still need to complete paxos round to achieve
-                // linearizability otherwise next write attempt may read differnt value as described
-                // in https://github.com/scylladb/scylla/issues/6299
-                // Let's use empty mutation as a value and proceed
-                mutation.emplace(handler->schema(), handler->key());
-                // since the value we are writing is dummy we may use minimal consistency level for learn
-                handler->set_cl_for_learn(db::consistency_level::ANY);
             } else {
-                paxos::paxos_state::logger.debug("CAS[{}] precondition is met; proposing client-requested updates for {}",
-                        handler->id(), ballot);
-                tracing::trace(handler->tr_state, "CAS precondition is met; proposing client-requested updates for {}", ballot);
+                mutation = request->apply(std::move(qr), cmd->slice, utils::UUID_gen::micros_timestamp(ballot));
+                condition_met = true;
+                if (!mutation) {
+                    if (write) {
+                        paxos::paxos_state::logger.debug("CAS[{}] precondition does not match current values", handler->id());
+                        tracing::trace(handler->tr_state, "CAS precondition does not match current values");
+                        ++get_stats().cas_write_condition_not_met;
+                        condition_met = false;
+                    }
+                    // If a condition is not met we still need to complete paxos round to achieve
+                    // linearizability otherwise next write attempt may read differnt value as described
+                    // in https://github.com/scylladb/scylla/issues/6299
+                    // Let's use empty mutation as a value and proceed
+                    mutation.emplace(handler->schema(), handler->key());
+                    // since the value we are writing is dummy we may use minimal consistency level for learn
+                    handler->set_cl_for_learn(db::consistency_level::ANY);
+                } else {
+                    paxos::paxos_state::logger.debug("CAS[{}] precondition is met; proposing client-requested updates for {}",
+                            handler->id(), ballot);
+                    tracing::trace(handler->tr_state, "CAS precondition is met; proposing client-requested updates for {}", ballot);
+                }
             }
 
             auto proposal = make_lw_shared<paxos::proposal>(ballot, freeze(*mutation));
@@ -5931,30 +6932,63 @@ future<bool> storage_proxy::cas(schema_ptr schema, shared_ptr<cas_request> reque
                 // The majority (aka a QUORUM) has promised the coordinator to
                 // accept the action associated with the computed ballot.
                 // Apply the mutation.
-                try {
-                  co_await handler->learn_decision(std::move(proposal));
-                } catch (unavailable_exception& e) {
-                    // if learning stage encountered unavailablity error lets re-map it to a write error
-                    // since unavailable error means that operation has never ever started which is not
-                    // the case here
-                    schema_ptr schema = handler->schema();
-                    throw mutation_write_timeout_exception(schema->ks_name(), schema->cf_name(),
-                                          e.consistency, e.alive, e.required, db::write_type::CAS);
+                if (write && _db.local().get_config().lwt_deferred_learn() && !_deferred_learns_gate.is_closed()) {
+                    // The decision is final once accepted by a quorum, any later round
+                    // completes it if our learn doesn't.
+                    auto learn = make_lw_shared<deferred_learn>(handler->id(), schema->id(), dkey);
+                    if (auto previous = find_deferred_learn(*schema, dkey)) {
+                        remove_deferred_learn(*previous);
+                    }
+                    _deferred_learns[token].push_back(learn);
+                    ++get_stats().cas_write_deferred_learn;
+                    (void)with_gate(_deferred_learns_gate, [this, learn, handler, proposal = std::move(proposal)] () mutable {
+                        return handler->learn_decision(std::move(proposal)).then_wrapped([this, learn, handler] (future<> f) {
+                            if (f.failed()) {
+                                paxos::paxos_state::logger.debug("CAS[{}] background learn failed: {}", handler->id(), f.get_exception());
+                            }
+                            learn->done.set_value();
+                            remove_deferred_learn(*learn);
+                        });
+                    });
+                } else {
+                    try {
+                      co_await handler->learn_decision(std::move(proposal));
+                    } catch (unavailable_exception& e) {
+                        // if learning stage encountered unavailablity error lets re-map it to a write error
+                        // since unavailable error means that operation has never ever started which is not
+                        // the case here
+                        schema_ptr schema = handler->schema();
+                        throw mutation_write_timeout_exception(schema->ks_name(), schema->cf_name(),
+                                              e.consistency, e.alive, e.required, db::write_type::CAS);
+                    }
                 }
                 paxos::paxos_state::logger.debug("CAS[{}] successful", handler->id());
                 tracing::trace(handler->tr_state, "CAS successful");
+                for (auto& p : std::exchange(evaluated, {})) {
+                    p->result.set_value(p->condition_met);
+                }
+                if (!pending.empty()) {
+                    // The ballot didn't leave room for the timestamps of all requests.
+                    continue;
+                }
                 break;
             } else {
                 paxos::paxos_state::logger.debug("CAS[{}] PAXOS proposal not accepted (pre-empted by a higher ballot)",
                         handler->id());
                 tracing::trace(handler->tr_state, "PAXOS proposal not accepted (pre-empted by a higher ballot)");
+                // Evaluate the requests again in the next round.
+                pending.insert(pending.begin(), std::make_move_iterator(evaluated.begin()), std::make_move_iterator(evaluated.end()));
+                evaluated.clear();
                 ++contentions;
                 co_await sleep_approx_50ms();
             }
         }
-    } catch (read_failure_exception& ex) {
+        if (self) {
+            condition_met = co_await self->result.get_future();
+        }
+      } catch (read_failure_exception& ex) {
         write ? throw read_failure_to_write(schema, ex) : throw;
-    } catch (read_timeout_exception& ex) {
+      } catch (read_timeout_exception& ex) {
         if (write) {
             get_stats().cas_write_timeouts.mark();
             throw read_timeout_to_write(schema, ex);
@@ -5962,9 +6996,9 @@ future<bool> storage_proxy::cas(schema_ptr schema, shared_ptr<cas_request> reque
             get_stats().cas_read_timeouts.mark();
             throw;
         }
-    } catch (mutation_write_failure_exception& ex) {
+      } catch (mutation_write_failure_exception& ex) {
         write ? throw : throw write_failure_to_read(schema, ex);
-    } catch (mutation_write_timeout_exception& ex) {
+      } catch (mutation_write_timeout_exception& ex) {
         if (write) {
             get_stats().cas_write_timeouts.mark();
             throw;
@@ -5972,10 +7006,10 @@ future<bool> storage_proxy::cas(schema_ptr schema, shared_ptr<cas_request> reque
             get_stats().cas_read_timeouts.mark();
             throw write_timeout_to_read(schema, ex);
         }
-    } catch (exceptions::unavailable_exception& ex) {
+      } catch (exceptions::unavailable_exception& ex) {
         write ? get_stats().cas_write_unavailables.mark() :  get_stats().cas_read_unavailables.mark();
         throw;
-    } catch (seastar::semaphore_timed_out& ex) {
+      } catch (seastar::semaphore_timed_out& ex) {
         paxos::paxos_state::logger.trace("CAS[{}]: timeout while waiting for row lock {}", handler->id());
         if (write) {
             get_stats().cas_write_timeouts.mark();
@@ -5984,6 +7018,18 @@ future<bool> storage_proxy::cas(schema_ptr schema, shared_ptr<cas_request> reque
             get_stats().cas_read_timeouts.mark();
             throw read_timeout_exception(schema->ks_name(), schema->cf_name(), cl_for_paxos, 0,  handler->block_for(), 0);
         }
+      }
+    } catch (...) {
+        // Fail the coalesced requests with the same error as ours.
+        auto ex = std::current_exception();
+        auto fail = [&] (lw_shared_ptr<pending_cas>& p) {
+            if (p != self) {
+                p->result.set_exception(ex);
+            }
+        };
+        std::ranges::for_each(evaluated, fail);
+        std::ranges::for_each(pending, fail);
+        throw;
     }
 
     co_return condition_met;
@@ -6266,7 +7312,7 @@ future<> storage_proxy::drain_on_shutdown() {
 
 future<>
 storage_proxy::stop() {
-    return make_ready_future<>();
+    return _deferred_learns_gate.close();
 }
 
 locator::token_metadata_ptr storage_proxy::get_token_metadata_ptr() const noexcept {
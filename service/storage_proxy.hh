@@ -10,12 +10,15 @@
 
 #pragma once
 
+#include <deque>
 #include <variant>
 #include "replica/database_fwd.hh"
 #include "message/messaging_service_fwd.hh"
 #include <seastar/core/distributed.hh>
 #include <seastar/core/execution_stage.hh>
 #include <seastar/core/scheduling_specific.hh>
+#include <seastar/core/shared_future.hh>
+#include <seastar/core/gate.hh>
 #include "db/read_repair_decision.hh"
 #include "db/write_type.hh"
 #include "db/hints/manager.hh"
@@ -30,6 +33,7 @@
 #include "db/hints/host_filter.hh"
 #include "utils/small_vector.hh"
 #include "service/endpoint_lifecycle_subscriber.hh"
+#include "service/endpoint_latency_scorer.hh"
 #include <seastar/core/circular_buffer.hh>
 #include "exceptions/exceptions.hh"
 #include "exceptions/coordinator_result.hh"
@@ -271,6 +275,9 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
             lw_shared_ptr<cdc::operation_result_tracker>> _mutate_stage;
     db::view::node_update_backlog& _max_view_update_backlog;
     std::unordered_map<gms::inet_address, view_update_backlog_timestamped> _view_update_backlogs;
+    // The backlogs of the views of each table reported by replicas, used
+    // instead of the backlogs of the replicas once they all report them.
+    std::unordered_map<table_id, std::unordered_map<gms::inet_address, db::view::update_backlog>> _table_view_update_backlogs;
 
     //NOTICE(sarna): This opaque pointer is here just to avoid moving write handler class definitions from .cc to .hh. It's slow path.
     class view_update_handlers_list;
@@ -293,11 +300,54 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
     cdc::cdc_service* _cdc = nullptr;
 
     cdc_stats _cdc_stats;
+
+    // CAS writes waiting for the coordinator lock of their partition, in arrival
+    // order. The holder of the lock can apply them in its own Paxos round, see cas().
+    struct pending_cas;
+    std::unordered_map<dht::token, std::deque<lw_shared_ptr<pending_cas>>> _pending_cas;
+
+    // Learns of CAS decisions running in the background, see lwt_deferred_learn,
+    // by the token of their partition. stop() waits for them through the gate.
+    struct deferred_learn {
+        uint64_t id;
+        table_id table;
+        dht::decorated_key key;
+        shared_promise<> done;
+        deferred_learn(uint64_t id, table_id table, dht::decorated_key key) : id(id), table(table), key(std::move(key)) {}
+    };
+    std::unordered_map<dht::token, std::vector<lw_shared_ptr<deferred_learn>>> _deferred_learns;
+    seastar::gate _deferred_learns_gate;
+
+    // Single partition reads in flight, and the identical reads waiting for
+    // them to complete to read together, see query_singular_coalesced().
+    struct coalesced_read;
+    std::unordered_map<dht::token, std::vector<lw_shared_ptr<coalesced_read>>> _coalesced_reads;
+
+    // Latencies of the reads sent to each replica, used to order replicas
+    // for reads when dynamic_snitch is enabled.
+    endpoint_latency_scorer _endpoint_latency_scorer;
+    read_budget _read_hedging_budget;
 private:
+    void remove_pending_cas(const dht::token& token, const pending_cas& p) noexcept;
+    lw_shared_ptr<deferred_learn> find_deferred_learn(const schema& s, const dht::decorated_key& key) const;
+    void remove_deferred_learn(const deferred_learn& learn) noexcept;
+    // Takes up to max pending requests which can be applied in the round of leader.
+    std::vector<lw_shared_ptr<pending_cas>> coalesce_pending_cas(const dht::token& token, const schema& s, const pending_cas& leader, unsigned max);
+    // Evaluates pending requests in order against the value qr read by a round with ballot timestamp ts,
+    // moving those evaluated to evaluated, and returns the updates to propose, if any.
+    std::optional<mutation> apply_coalesced_cas(schema_ptr s, const partition_key& key, const query::read_command& cmd,
+            foreign_ptr<lw_shared_ptr<query::result>> qr, api::timestamp_type ts, api::timestamp_type min_ts,
+            std::deque<lw_shared_ptr<pending_cas>>& pending, std::vector<lw_shared_ptr<pending_cas>>& evaluated);
     future<result<coordinator_query_result>> query_singular(lw_shared_ptr<query::read_command> cmd,
             dht::partition_range_vector&& partition_ranges,
             db::consistency_level cl,
             coordinator_query_options optional_params);
+    // Like query_singular(), but reads arriving while an identical read is in
+    // flight wait for it to complete, and then share a single read.
+    future<result<coordinator_query_result>> query_singular_coalesced(lw_shared_ptr<query::read_command> cmd,
+            dht::partition_range_vector&& partition_ranges,
+            db::consistency_level cl,
+            coordinator_query_options optional_params);
     response_id_type register_response_handler(shared_ptr<abstract_write_response_handler>&& h);
     void remove_response_handler(response_id_type id);
     void remove_response_handler_entry(response_handlers_map::iterator entry);
@@ -365,6 +415,7 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
             db::consistency_level cl,
             query_ranges_to_vnodes_generator&& ranges_to_vnodes,
             int concurrency_factor,
+            size_t ranges_queried,
             tracing::trace_state_ptr trace_state,
             uint64_t remaining_row_count,
             uint32_t remaining_partition_count,
@@ -417,12 +468,25 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
             tracing::trace_state_ptr tr_state,
             write_stats& stats,
             allow_hints allow_hints = allow_hints::yes);
+    template<typename Range>
+    future<> send_mutations_to_endpoint(
+            Range&& mutations,
+            gms::inet_address target,
+            inet_address_vector_topology_change pending_endpoints,
+            db::write_type type,
+            tracing::trace_state_ptr tr_state,
+            write_stats& stats,
+            allow_hints allow_hints);
 
     db::view::update_backlog get_view_update_backlog() const;
+    // The backlog to report to the coordinator of a write to a table.
+    db::view::update_backlog get_view_update_backlog(const schema&) const;
 
-    void maybe_update_view_backlog_of(gms::inet_address, std::optional<db::view::update_backlog>);
+    void maybe_update_view_backlog_of(gms::inet_address, std::optional<db::view::update_backlog>, std::optional<table_id> = std::nullopt);
 
     db::view::update_backlog get_backlog_of(gms::inet_address) const;
+    // The backlog of the views of a table on a replica, which writes to the table are delayed by.
+    db::view::update_backlog get_backlog_of(gms::inet_address, table_id) const;
 
     template<typename Range>
     future<> mutate_counters(Range&& mutations, db::consistency_level cl, tracing::trace_state_ptr tr_state, service_permit permit, clock_type::time_point timeout);
@@ -571,12 +635,21 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
             tracing::trace_state_ptr tr_state, write_stats& stats, allow_hints allow_hints = allow_hints::yes);
     future<> send_to_endpoint(frozen_mutation_and_schema fm_a_s, gms::inet_address target, inet_address_vector_topology_change pending_endpoints, db::write_type type,
             tracing::trace_state_ptr tr_state, allow_hints allow_hints = allow_hints::yes);
+    // Send several mutations to one specific remote target. Mutations going to the same
+    // replica are sent in a single rpc if all nodes support it. Fails if any of them fails.
+    future<> send_to_endpoint(std::vector<frozen_mutation_and_schema> fms, gms::inet_address target, inet_address_vector_topology_change pending_endpoints, db::write_type type,
+            tracing::trace_state_ptr tr_state, allow_hints allow_hints = allow_hints::yes);
 
     // Send a mutation to a specific remote target as a hint.
     // Unlike regular mutations during write operations, hints are sent on the streaming connection
     // and use different RPC verb.
     future<> send_hint_to_endpoint(frozen_mutation_and_schema fm_a_s, gms::inet_address target);
 
+    // Send several hints to a specific remote target, as send_hint_to_endpoint() does.
+    // Hints going to the same replica are sent in a single rpc if all nodes support it.
+    // Fails if any of the hints failed to be sent.
+    future<> send_hints_to_endpoint(std::vector<frozen_mutation_and_schema> fms, gms::inet_address target);
+
     /**
      * Performs the truncate operatoin, which effectively deletes all data from
      * the column family cfname
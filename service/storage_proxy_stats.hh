@@ -101,9 +101,12 @@ struct write_stats {
     uint64_t throttled_base_writes = 0; // current number of base writes delayed due to view update backlog
     uint64_t background_writes_failed = 0;
     uint64_t writes_failed_due_to_too_many_in_flight_hints = 0;
+    uint64_t sent_mutation_batches = 0; // number of MUTATION_BATCH and HINT_MUTATION_BATCH messages sent to replicas
 
     uint64_t cas_write_unfinished_commit = 0;
     uint64_t cas_write_condition_not_met = 0;
+    uint64_t cas_write_coalesced = 0;
+    uint64_t cas_write_deferred_learn = 0;
     uint64_t cas_write_timeout_due_to_uncertainty = 0;
     uint64_t cas_failed_read_round_optimization = 0;
     uint16_t cas_now_pruning = 0;
@@ -144,6 +147,8 @@ struct stats : public write_stats {
 
     // number of mutations received as a coordinator
     uint64_t received_mutations = 0;
+    // number of MUTATION_BATCH and HINT_MUTATION_BATCH messages received as a replica
+    uint64_t received_mutation_batches = 0;
 
     // number of counter updates received as a leader
     uint64_t received_counter_updates = 0;
@@ -168,6 +173,8 @@ struct stats : public write_stats {
     uint64_t read_retries = 0; // read is retried with new limit
     uint64_t speculative_digest_reads = 0;
     uint64_t speculative_data_reads = 0;
+    uint64_t speculative_reads_over_budget = 0;
+    uint64_t coalesced_reads = 0; // reads which shared the result of an identical read
 
     uint64_t cas_read_unfinished_commit = 0;
     uint64_t cas_foreground = 0;
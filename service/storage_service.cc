@@ -323,8 +323,11 @@ future<> storage_service::topology_state_load(cdc::generation_service& cdc_gen_s
         }
     }
 
-    co_await mutate_token_metadata(seastar::coroutine::lambda([this, &id2ip, &am] (mutable_token_metadata_ptr tmptr) -> future<> {
+    auto tablets = co_await db::system_keyspace::load_tablet_metadata();
+
+    co_await mutate_token_metadata(seastar::coroutine::lambda([this, &id2ip, &am, &tablets] (mutable_token_metadata_ptr tmptr) -> future<> {
         co_await tmptr->clear_gently(); // drop previous state
+        tmptr->tablets() = std::move(tablets);
 
         auto add_normal_node = [&] (raft::server_id id, const replica_state& rs) -> future<> {
             assert (rs.ring.value().state == ring_slice::ring_slice::replication_state::owner);
@@ -443,13 +446,19 @@ future<> storage_service::topology_transition(storage_proxy& proxy, cdc::generat
 
 future<> storage_service::merge_topology_snapshot(raft_topology_snapshot snp) {
    std::vector<mutation> muts;
-   muts.reserve(snp.topology_mutations.size() + (snp.cdc_generation_mutation ? 1 : 0));
+   muts.reserve(snp.topology_mutations.size() + snp.tablet_mutations.size() + (snp.cdc_generation_mutation ? 1 : 0));
    {
        auto s = _db.local().find_schema(db::system_keyspace::NAME, db::system_keyspace::TOPOLOGY);
        boost::transform(snp.topology_mutations, std::back_inserter(muts), [s] (const canonical_mutation& m) {
            return m.to_mutation(s);
        });
    }
+   if (!snp.tablet_mutations.empty()) {
+       auto s = _db.local().find_schema(db::system_keyspace::NAME, db::system_keyspace::TABLETS);
+       boost::transform(snp.tablet_mutations, std::back_inserter(muts), [s] (const canonical_mutation& m) {
+           return m.to_mutation(s);
+       });
+   }
    if (snp.cdc_generation_mutation) {
        auto s = _db.local().find_schema(db::system_keyspace::NAME, db::system_keyspace::CDC_GENERATIONS_V3);
        muts.push_back(snp.cdc_generation_mutation->to_mutation(s));
@@ -2275,6 +2284,9 @@ future<> storage_service::on_change(inet_address endpoint, application_state sta
             slogger.debug("Ignoring state change for dead or unknown endpoint: {}", endpoint);
             co_return;
         }
+        if (state == application_state::SHARD_COUNT || state == application_state::IGNORE_MSB_BITS) {
+            co_await update_peer_sharding(endpoint, *ep_state);
+        }
         if (get_token_metadata().is_normal_token_owner(endpoint)) {
             slogger.debug("endpoint={} on_change:     updating system.peers table", endpoint);
             co_await do_update_system_peers_table(endpoint, state, value);
@@ -2302,6 +2314,25 @@ future<> storage_service::maybe_reconnect_to_preferred_ip(inet_address ep, inet_
     }
 }
 
+future<> storage_service::update_peer_sharding(inet_address ep, const gms::endpoint_state& ep_state) {
+    auto* shard_count = ep_state.get_application_state_ptr(application_state::SHARD_COUNT);
+    auto* ignore_msb = ep_state.get_application_state_ptr(application_state::IGNORE_MSB_BITS);
+    if (!shard_count || !ignore_msb) {
+        return make_ready_future<>();
+    }
+    unsigned count, msb;
+    try {
+        count = std::stoul(shard_count->value());
+        msb = std::stoul(ignore_msb->value());
+    } catch (...) {
+        slogger.warn("Failed to parse the sharding of {}: shard_count={}, ignore_msb_bits={}: {}",
+                ep, shard_count->value(), ignore_msb->value(), std::current_exception());
+        return make_ready_future<>();
+    }
+    return _messaging.invoke_on_all([ep, count, msb] (auto& local_ms) {
+        local_ms.set_peer_sharding(ep, count, msb);
+    });
+}
 
 future<> storage_service::on_remove(gms::inet_address endpoint) {
     slogger.debug("endpoint={} on_remove", endpoint);
@@ -4819,6 +4850,7 @@ void storage_service::init_messaging_service(sharded<service::storage_proxy>& pr
             }
 
             std::vector<canonical_mutation> topology_mutations;
+            std::vector<canonical_mutation> tablet_mutations;
             std::optional<cdc::generation_id_v2> curr_cdc_gen_id;
             {
                 // FIXME: make it an rwlock, here we only need to lock for reads,
@@ -4833,6 +4865,15 @@ void storage_service::init_messaging_service(sharded<service::storage_proxy>& pr
                     return canonical_mutation{p.mut().unfreeze(s)};
                 });
 
+                auto tablets_rs = co_await db::system_keyspace::query_mutations(
+                    proxy, db::system_keyspace::NAME, db::system_keyspace::TABLETS);
+                auto tablets_s = ss._db.local().find_schema(db::system_keyspace::NAME, db::system_keyspace::TABLETS);
+                tablet_mutations.reserve(tablets_rs->partitions().size());
+                boost::range::transform(
+                        tablets_rs->partitions(), std::back_inserter(tablet_mutations), [tablets_s] (const partition& p) {
+                    return canonical_mutation{p.mut().unfreeze(tablets_s)};
+                });
+
                 curr_cdc_gen_id = ss._topology_state_machine._topology.current_cdc_generation_id;
             }
 
@@ -4867,6 +4908,7 @@ void storage_service::init_messaging_service(sharded<service::storage_proxy>& pr
             co_return raft_topology_snapshot{
                 .topology_mutations = std::move(topology_mutations),
                 .cdc_generation_mutation = std::move(cdc_generation_mutation),
+                .tablet_mutations = std::move(tablet_mutations),
             };
         });
     });
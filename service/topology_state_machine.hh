@@ -106,6 +106,9 @@ struct raft_topology_snapshot {
 
     // Mutation for system.cdc_generations_v3, contains the current CDC generation data.
     std::optional<canonical_mutation> cdc_generation_mutation;
+
+    // Mutations for the system.tablets table.
+    std::vector<canonical_mutation> tablet_mutations;
 };
 
 struct raft_topology_pull_params {
@@ -26,6 +26,9 @@ enum class component_type {
     TemporaryTOC,
     TemporaryStatistics,
     Scylla,
+    CompressionDictionary,
+    Partitions,
+    Rows,
     Unknown,
 };
 
@@ -63,6 +66,12 @@ struct fmt::formatter<sstables::component_type> : fmt::formatter<std::string_vie
             return formatter<std::string_view>::format("TemporaryStatistics", ctx);
         case Scylla:
             return formatter<std::string_view>::format("Scylla", ctx);
+        case CompressionDictionary:
+            return formatter<std::string_view>::format("CompressionDictionary", ctx);
+        case Partitions:
+            return formatter<std::string_view>::format("Partitions", ctx);
+        case Rows:
+            return formatter<std::string_view>::format("Rows", ctx);
         case Unknown:
             return formatter<std::string_view>::format("Unknown", ctx);
         }
@@ -8,6 +8,7 @@
 
 #include <stdexcept>
 #include <cstdlib>
+#include <deque>
 
 #include <boost/range/algorithm/find_if.hpp>
 #include <seastar/core/align.hh>
@@ -22,6 +23,7 @@
 #include "segmented_compress_params.hh"
 #include "utils/class_registrator.hh"
 #include "reader_permit.hh"
+#include "reader_concurrency_semaphore.hh"
 
 namespace sstables {
 
@@ -254,7 +256,7 @@ local_compression::local_compression(compressor_ptr p)
 local_compression::local_compression(const compression& c)
     : _compressor([&c] {
         sstring n(c.name.value.begin(), c.name.value.end());
-        return compressor::create(n, [&c, &n](const sstring& key) -> compressor::opt_string {
+        auto cp = compressor::create(n, [&c, &n](const sstring& key) -> compressor::opt_string {
             if (key == compression_parameters::CHUNK_LENGTH_KB || key == compression_parameters::CHUNK_LENGTH_KB_ERR) {
                 return to_sstring(c.chunk_len / 1024);
             }
@@ -268,6 +270,10 @@ local_compression::local_compression(const compression& c)
             }
             return std::nullopt;
         });
+        if (cp && cp->uses_dictionary()) {
+            cp = cp->with_dictionary(bytes_view(c.dictionary));
+        }
+        return cp;
     }())
 {}
 
@@ -335,6 +341,19 @@ compression::locate(uint64_t position, const compression::segmented_offsets::acc
 template <typename ChecksumType>
 requires ChecksumUtils<ChecksumType>
 class compressed_file_data_source_impl : public data_source_impl {
+    // Compressed chunk read ahead of the consumer, not yet uncompressed.
+    struct prefetched_chunk {
+        sstables::compression::chunk_and_offset addr;
+        future<temporary_buffer<char>> buf;
+        // Charges the buffer to the read, until it is uncompressed or discarded.
+        reader_permit::resource_units units;
+    };
+
+    // Upper bound of the read-ahead window, in chunks.
+    static constexpr size_t max_prefetched_chunks = 8;
+    // The window takes up to this fraction of the memory left in the reader's semaphore.
+    static constexpr size_t prefetch_memory_divisor = 256;
+
     std::optional<input_stream<char>> _input_stream;
     sstables::compression* _compression_metadata;
     sstables::compression::segmented_offsets::accessor _offsets;
@@ -344,6 +363,58 @@ class compressed_file_data_source_impl : public data_source_impl {
     uint64_t _pos;
     uint64_t _beg_pos;
     uint64_t _end_pos;
+    // Readers which asked for no read-ahead don't prefetch either.
+    size_t _max_prefetched;
+    // Chunks read from _input_stream, in order, starting with the one holding _pos.
+    std::deque<prefetched_chunk> _prefetched;
+    // Position in the uncompressed data, and in the file, of the chunk following the prefetched ones.
+    uint64_t _prefetch_pos;
+    uint64_t _underlying_prefetch_pos;
+    // Reads from _input_stream must be serialized, so each one is chained to the previous one.
+    // Never fails, failed reads resolve the future of their chunk instead.
+    future<> _reads = make_ready_future<>();
+private:
+    // The number of chunks to keep read ahead. Reads compete for the memory of
+    // the semaphore, so the window shrinks down to a single chunk, the one being
+    // consumed, as the semaphore runs out of memory.
+    size_t prefetch_window() {
+        auto& sem = _permit.semaphore();
+        if (_max_prefetched == 1 || sem.is_unlimited()) {
+            return _max_prefetched;
+        }
+        auto available = sem.available_resources().memory;
+        if (available <= 0) {
+            return 1;
+        }
+        auto chunks = size_t(available) / (prefetch_memory_divisor * _compression_metadata->uncompressed_chunk_length());
+        return std::clamp(chunks, size_t(1), _max_prefetched);
+    }
+
+    void prefetch() {
+        auto window = prefetch_window();
+        while (_prefetched.size() < window && _prefetch_pos < _end_pos) {
+            auto addr = _compression_metadata->locate(_prefetch_pos, _offsets);
+            if (!addr.chunk_len) {
+                throw sstables::malformed_sstable_exception(format("compressed chunk_len must be greater than zero, chunk_start={}", addr.chunk_start));
+            }
+            promise<temporary_buffer<char>> pr;
+            auto buf = pr.get_future();
+            _reads = _reads.then([this, len = addr.chunk_len, pr = std::move(pr)] () mutable {
+                return _input_stream->read_exactly(len).then_wrapped([pr = std::move(pr)] (future<temporary_buffer<char>> f) mutable {
+                    f.forward_to(std::move(pr));
+                });
+            });
+            _prefetched.push_back(prefetched_chunk{addr, std::move(buf), _permit.consume_memory(addr.chunk_len)});
+            _prefetch_pos += _compression_metadata->uncompressed_chunk_length() - addr.offset;
+            _underlying_prefetch_pos = addr.chunk_start + addr.chunk_len;
+        }
+    }
+
+    static void discard(prefetched_chunk&& chunk) {
+        (void)std::move(chunk.buf).then_wrapped([units = std::move(chunk.units)] (future<temporary_buffer<char>> f) {
+            f.ignore_ready_future();
+        });
+    }
 public:
     compressed_file_data_source_impl(file f, sstables::compression* cm,
                 uint64_t pos, size_t len, file_input_stream_options options, reader_permit permit)
@@ -351,6 +422,7 @@ class compressed_file_data_source_impl : public data_source_impl {
             , _offsets(_compression_metadata->offsets.get_accessor())
             , _compression(*cm)
             , _permit(std::move(permit))
+            , _max_prefetched(options.read_ahead ? max_prefetched_chunks : 1)
     {
         _beg_pos = pos;
         if (pos > _compression_metadata->uncompressed_file_length()) {
@@ -358,7 +430,7 @@ class compressed_file_data_source_impl : public data_source_impl {
         }
         if (len == 0 || pos == _compression_metadata->uncompressed_file_length()) {
             // Nothing to read
-            _end_pos = _pos = _beg_pos;
+            _end_pos = _pos = _prefetch_pos = _beg_pos;
             return;
         }
         if (len <= _compression_metadata->uncompressed_file_length() - pos) {
@@ -375,28 +447,31 @@ class compressed_file_data_source_impl : public data_source_impl {
                 start.chunk_start,
                 end.chunk_start + end.chunk_len - start.chunk_start,
                 std::move(options));
-        _underlying_pos = start.chunk_start;
-        _pos = _beg_pos;
+        _underlying_pos = _underlying_prefetch_pos = start.chunk_start;
+        _pos = _prefetch_pos = _beg_pos;
     }
     virtual future<temporary_buffer<char>> get() override {
         if (_pos >= _end_pos) {
             return make_ready_future<temporary_buffer<char>>();
         }
-        auto addr = _compression_metadata->locate(_pos, _offsets);
+        // Keep the following chunks read while this one is uncompressed and consumed.
+        prefetch();
+        auto chunk = std::move(_prefetched.front());
+        _prefetched.pop_front();
+        auto addr = chunk.addr;
         // Uncompress the next chunk. We need to skip part of the first
         // chunk, but then continue to read from beginning of chunks.
         if (_pos != _beg_pos && addr.offset != 0) {
+            discard(std::move(chunk));
             throw std::runtime_error("compressed reader out of sync");
         }
-        if (!addr.chunk_len) {
-            throw sstables::malformed_sstable_exception(format("compressed chunk_len must be greater than zero, chunk_start={}", addr.chunk_start));
-        }
-        return _input_stream->read_exactly(addr.chunk_len).then([this, addr](temporary_buffer<char> buf) {
+        _underlying_pos = addr.chunk_start;
+        return std::move(chunk.buf).then([this, addr, units = std::move(chunk.units)] (temporary_buffer<char> buf) mutable {
             if (buf.size() != addr.chunk_len) {
                 throw sstables::malformed_sstable_exception(format("compressed reader hit premature end-of-file at file offset {}, expected chunk_len={}, actual={}", _underlying_pos, addr.chunk_len, buf.size()));
             }
             return _permit.request_memory(_compression_metadata->uncompressed_chunk_length()).then(
-                    [this, addr, buf = std::move(buf)] (reader_permit::resource_units res_units) mutable {
+                    [this, addr, buf = std::move(buf), units = std::move(units)] (reader_permit::resource_units res_units) mutable {
                 // The last 4 bytes of the chunk are the adler32/crc32 checksum
                 // of the rest of the (compressed) chunk.
                 auto compressed_len = addr.chunk_len - 4;
@@ -431,7 +506,14 @@ class compressed_file_data_source_impl : public data_source_impl {
         if (!_input_stream) {
             return make_ready_future<>();
         }
-        return _input_stream->close();
+        return std::exchange(_reads, make_ready_future<>()).then([this] {
+            // All the reads completed, so the chunks and their memory can go right away.
+            while (!_prefetched.empty()) {
+                _prefetched.front().buf.ignore_ready_future();
+                _prefetched.pop_front();
+            }
+            return _input_stream->close();
+        });
     }
 
     virtual future<temporary_buffer<char>> skip(uint64_t n) override {
@@ -441,10 +523,23 @@ class compressed_file_data_source_impl : public data_source_impl {
             return make_ready_future<temporary_buffer<char>>();
         }
         auto addr = _compression_metadata->locate(_pos, _offsets);
-        auto underlying_n = addr.chunk_start - _underlying_pos;
-        _underlying_pos = addr.chunk_start;
         _beg_pos = _pos;
-        return _input_stream->skip(underlying_n).then([] {
+        // Chunks are prefetched contiguously, so if any is left after dropping
+        // the ones which were skipped, it holds _pos.
+        while (!_prefetched.empty() && _prefetched.front().addr.chunk_start < addr.chunk_start) {
+            discard(std::move(_prefetched.front()));
+            _prefetched.pop_front();
+        }
+        if (!_prefetched.empty()) {
+            _prefetched.front().addr = addr;
+            return make_ready_future<temporary_buffer<char>>();
+        }
+        auto underlying_n = addr.chunk_start - _underlying_prefetch_pos;
+        _underlying_pos = _underlying_prefetch_pos = addr.chunk_start;
+        _prefetch_pos = _pos;
+        return std::exchange(_reads, make_ready_future<>()).then([this, underlying_n] {
+            return _input_stream->skip(underlying_n);
+        }).then([] {
             return make_ready_future<temporary_buffer<char>>();
         });
     }
@@ -491,6 +586,12 @@ class compressed_file_data_sink_impl : public data_sink_impl {
     sstables::local_compression _compression;
     size_t _pos = 0;
     uint32_t _full_checksum;
+    // For dictionary-aware compressors, the first chunks are held back until
+    // enough of them were collected to train the dictionary they (and all
+    // the following chunks) are compressed with.
+    bool _training = false;
+    size_t _training_size = 0;
+    std::vector<temporary_buffer<char>> _samples;
 public:
     compressed_file_data_sink_impl(output_stream<char> out, sstables::compression* cm, sstables::local_compression lc)
             : _out(std::move(out))
@@ -498,10 +599,47 @@ class compressed_file_data_sink_impl : public data_sink_impl {
             , _offsets(_compression_metadata->offsets.get_writer())
             , _compression(lc)
             , _full_checksum(ChecksumType::init_checksum())
-    {}
+    {
+        if (_compression && _compression.compressor()->uses_dictionary()) {
+            _training = true;
+        }
+    }
 
     virtual future<> put(net::packet data) override { abort(); }
     virtual future<> put(temporary_buffer<char> buf) override {
+        if (_training) {
+            _training_size += buf.size();
+            _samples.push_back(std::move(buf));
+            if (_training_size < _compression.compressor()->dictionary_training_size()) {
+                return make_ready_future<>();
+            }
+            return finish_training();
+        }
+        return compress_and_write(std::move(buf));
+    }
+private:
+    future<> finish_training() {
+        _training = false;
+        std::vector<bytes_view> samples;
+        samples.reserve(_samples.size());
+        for (auto& b : _samples) {
+            samples.emplace_back(reinterpret_cast<const bytes_view::value_type*>(b.get()), b.size());
+        }
+        auto base = _compression.compressor();
+        return do_with(std::move(samples), [base] (std::vector<bytes_view>& samples) {
+            return base->train_dictionary(samples);
+        }).then([this, base] (bytes dictionary) {
+            _compression_metadata->dictionary.value = std::move(dictionary);
+            _compression = sstables::local_compression(base->with_dictionary(bytes_view(_compression_metadata->dictionary)));
+            return do_with(std::exchange(_samples, {}), [this] (std::vector<temporary_buffer<char>>& samples) {
+                return do_for_each(samples, [this] (temporary_buffer<char>& buf) {
+                    return compress_and_write(std::move(buf));
+                });
+            });
+        });
+    }
+
+    future<> compress_and_write(temporary_buffer<char> buf) {
         auto output_len = _compression.compress_max_size(buf.size());
 
         // account space for checksum that goes after compressed data.
@@ -541,7 +679,13 @@ class compressed_file_data_sink_impl : public data_sink_impl {
         auto f = _out.write(compressed.get(), compressed.size());
         return f.then([compressed = std::move(compressed)] {});
     }
+public:
     virtual future<> close() override {
+        if (_training) {
+            return finish_training().then([this] {
+                return _out.close();
+            });
+        }
         return _out.close();
     }
 
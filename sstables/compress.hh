@@ -299,6 +299,12 @@ struct compression {
     uint64_t data_len = 0;
     segmented_offsets offsets;
 
+    // Dictionary used by dictionary-aware compressors, see
+    // compressor::uses_dictionary(). It is not part of the "Compression Info"
+    // file, but is stored in its own CompressionDictionary component.
+    // Empty if the data was compressed without a dictionary.
+    disk_string<uint32_t> dictionary;
+
 private:
     // Variables *not* found in the "Compression Info" file (added by update()):
     uint64_t _compressed_file_length = 0;
@@ -253,6 +253,17 @@ class primitive_consumer {
                 prestate::READING_UNSIGNED_VINT,
                 prestate::READING_UNSIGNED_VINT_WITH_LEN>(data, _u64);
     }
+    // Reads the unsigned vints of a run of known length at once, when the
+    // buffer holds all of them. Otherwise returns false without consuming
+    // anything, and they have to be read one by one with read_unsigned_vint().
+    inline bool try_read_unsigned_vints(temporary_buffer<char>& data, std::span<uint64_t> out) noexcept {
+        auto size = unsigned_vint::deserialize_batch(bytes_view(reinterpret_cast<const bytes::value_type*>(data.get()), data.size()), out);
+        if (!size) {
+            return false;
+        }
+        data.trim_front(size);
+        return true;
+    }
     inline read_status read_signed_vint(temporary_buffer<char>& data) {
         return read_vint<
                 signed_vint,
@@ -478,6 +489,7 @@ class continuous_data_consumer : protected primitive_consumer {
     // remaining length of input to read (if <0, continue until end of file).
     uint64_t _remain;
     std::optional<reader_permit::blocked_guard> _blocked_guard;
+    std::optional<tracing::stage_timer> _io_timer;
     bool _first_invoke = true;
 public:
     using read_status = data_consumer::read_status;
@@ -508,10 +520,12 @@ class continuous_data_consumer : protected primitive_consumer {
 
     void mark_blocked() {
         _blocked_guard.emplace(_permit);
+        _io_timer.emplace(_permit.trace_state(), tracing::latency_stage::sstable_io);
     }
 
     void mark_unblocked() {
         _blocked_guard.reset();
+        _io_timer.reset();
     }
 
     data_consumer::processing_result skip(temporary_buffer<char>& data, uint32_t len) {
@@ -617,6 +631,7 @@ class continuous_data_consumer : protected primitive_consumer {
 
         primitive_consumer::reset();
         reader_permit::blocked_guard _{_permit};
+        tracing::stage_timer io_timer(_permit.trace_state(), tracing::latency_stage::sstable_io);
         co_await _input.skip(n);
     }
 
@@ -288,6 +288,9 @@ class index_entry {
 class partition_index_page {
 public:
     lsa::chunked_managed_vector<managed_ref<index_entry>> _entries;
+    // Raw tokens of _entries, packed so that lower_bound() can search them
+    // without dereferencing the entries.
+    lsa::chunked_managed_vector<int64_t> _tokens;
 public:
     partition_index_page() = default;
     partition_index_page(partition_index_page&&) noexcept = default;
@@ -296,8 +299,51 @@ class partition_index_page {
     bool empty() const { return _entries.empty(); }
     size_t size() const { return _entries.size(); }
 
+    // Must be called with the LSA allocator as the current allocator.
+    void push_back(const schema& s, managed_ref<index_entry> e) {
+        _tokens.push_back(e->get_decorated_key(s).token().raw());
+        try {
+            _entries.push_back(std::move(e));
+        } catch (...) {
+            _tokens.pop_back();
+            throw;
+        }
+    }
+
+    void reserve(size_t size) {
+        _entries.reserve(size);
+        _tokens.reserve(size);
+    }
+
+    void clear_and_release() noexcept {
+        _entries.clear_and_release();
+        _tokens.clear_and_release();
+    }
+
+    // Returns the index of the first entry at or after from which is not smaller than pos.
+    //
+    // Entries are only compared with pos when their token is equal to the token of pos.
+    // May allocate so must be called under allocating_section.
+    size_t lower_bound(const schema& s, size_t from, dht::ring_position_view pos) const {
+        const auto& t = pos.token();
+        if (t.is_minimum()) {
+            return from;
+        }
+        if (t.is_maximum()) {
+            return size();
+        }
+        auto lo = std::lower_bound(_tokens.begin() + from, _tokens.end(), t.raw());
+        auto hi = std::upper_bound(lo, _tokens.end(), t.raw());
+        dht::ring_position_comparator_for_sstables cmp(s);
+        auto i = std::lower_bound(_entries.begin() + (lo - _tokens.begin()), _entries.begin() + (hi - _tokens.begin()), pos,
+                [&] (const managed_ref<index_entry>& e, dht::ring_position_view rp) {
+            return cmp(e->get_decorated_key(s), rp) < 0;
+        });
+        return i - _entries.begin();
+    }
+
     size_t external_memory_usage() const {
-        size_t size = _entries.external_memory_usage();
+        size_t size = _entries.external_memory_usage() + _tokens.external_memory_usage();
         for (auto&& e : _entries) {
             size += sizeof(index_entry) + e->external_memory_usage();
         }
@@ -11,6 +11,7 @@
 #include "consumer.hh"
 #include "downsampling.hh"
 #include "sstables/partition_index_cache.hh"
+#include "sstables/partition_trie.hh"
 #include <seastar/util/bool_class.hh>
 #include "utils/buffer_input_stream.hh"
 #include "sstables/prepended_input_stream.hh"
@@ -63,7 +64,7 @@ class index_consumer {
 
     ~index_consumer() {
         with_allocator(_region.allocator(), [&] {
-            indexes._entries.clear_and_release();
+            indexes.clear_and_release();
         });
     }
 
@@ -79,7 +80,7 @@ class index_consumer {
                             e.promoted_index->num_blocks);
                 }
                 auto key = managed_bytes(reinterpret_cast<const blob_storage::char_type*>(e.key.get()), e.key.size());
-                indexes._entries.emplace_back(make_managed<index_entry>(std::move(key), e.data_file_offset, std::move(pi)));
+                indexes.push_back(*_s, make_managed<index_entry>(std::move(key), e.data_file_offset, std::move(pi)));
             });
         });
     }
@@ -88,7 +89,7 @@ class index_consumer {
         _alloc_section = logalloc::allocating_section();
         _alloc_section(_region, [&] {
             with_allocator(_region.allocator(), [&] {
-                indexes._entries.reserve(size);
+                indexes.reserve(size);
             });
         });
     }
@@ -332,10 +333,17 @@ std::unique_ptr<clustered_index_cursor> promoted_index::make_cursor(shared_sstab
                                                     sst->manager().get_cache_tracker().get_lru(),
                                                     sst->manager().get_cache_tracker().region(),
                                                     sst->_index_file_size);
+        std::unique_ptr<mc::row_index_cursor> row_index;
+        if (caching && sst->_row_index) {
+            if (auto root = sst->_row_index->find_root(_promoted_index_start)) {
+                row_index = std::make_unique<mc::row_index_cursor>(*sst->get_schema(), sst->_row_index->get_cached_file(), *root,
+                    options.io_priority_class, permit, *ck_values_fixed_lengths, trace_state);
+            }
+        }
         return std::make_unique<mc::bsearch_clustered_cursor>(*sst->get_schema(),
             _promoted_index_start, _promoted_index_size,
             promoted_index_cache_metrics, permit,
-            *ck_values_fixed_lengths, cached_file_ptr, options.io_priority_class, _num_blocks, trace_state);
+            *ck_values_fixed_lengths, cached_file_ptr, options.io_priority_class, _num_blocks, trace_state, std::move(row_index));
     }
 
     auto file = make_tracked_index_file(*sst, permit, std::move(trace_state), caching);
@@ -393,6 +401,9 @@ struct index_bound {
     uint64_t data_file_position = 0;
     indexable_element element = indexable_element::partition;
     std::optional<open_rt_marker> end_open_marker;
+    // Whether current_list holds only the entry found through the partition trie,
+    // rather than the whole summary page current_summary_idx.
+    bool single_entry = false;
 
     // Holds the cursor for the current partition. Lazily initialized.
     std::unique_ptr<clustered_index_cursor> clustered_cursor;
@@ -409,6 +420,7 @@ struct index_bound {
             , data_file_position(other.data_file_position)
             , element(other.element)
             , end_open_marker(other.end_open_marker)
+            , single_entry(other.single_entry)
     { }
 
     index_bound(index_bound&&) noexcept = default;
@@ -440,6 +452,10 @@ class index_reader {
         auto index_file = make_tracked_index_file(*_sstable, _permit, _trace_state, _use_caching);
         auto input = make_file_input_stream(index_file, begin, (_single_page_read ? end : _sstable->index_size()) - begin,
                         get_file_input_stream_options(_pc));
+        return make_context(std::move(input), begin, end, consumer);
+    }
+
+    std::unique_ptr<index_consume_entry_context<index_consumer>> make_context(input_stream<char> input, uint64_t begin, uint64_t end, index_consumer& consumer) {
         auto trust_pi = trust_promoted_index(_sstable->has_correct_promoted_index_entries());
         auto ck_values_fixed_lengths = _sstable->get_version() >= sstable_version_types::mc
                             ? std::make_optional(get_clustering_values_fixed_lengths(_sstable->get_serialization_header()))
@@ -483,6 +499,7 @@ class index_reader {
         bound.data_file_position = data_file_end();
         bound.element = indexable_element::partition;
         bound.current_list = {};
+        bound.single_entry = false;
         bound.end_open_marker.reset();
         return reset_clustered_cursor(bound);
     }
@@ -491,7 +508,7 @@ class index_reader {
     future<> advance_to_page(index_bound& bound, uint64_t summary_idx) {
         sstlog.trace("index {}: advance_to_page({}), bound {}", fmt::ptr(this), summary_idx, fmt::ptr(&bound));
         assert(!bound.current_list || bound.current_summary_idx <= summary_idx);
-        if (bound.current_list && bound.current_summary_idx == summary_idx) {
+        if (bound.current_list && !bound.single_entry && bound.current_summary_idx == summary_idx) {
             sstlog.trace("index {}: same page", fmt::ptr(this));
             return make_ready_future<>();
         }
@@ -502,6 +519,7 @@ class index_reader {
             return advance_to_end(bound);
         }
         auto loader = [this, &bound] (uint64_t summary_idx) -> future<index_list> {
+            _permit.on_index_page_read();
             auto& summary = _sstable->get_summary();
             uint64_t position = summary.entries[summary_idx].position;
             uint64_t quantity = downsampling::get_effective_index_interval_after_index(summary_idx, summary.header.sampling_level,
@@ -537,6 +555,7 @@ class index_reader {
 
         return _index_cache.get_or_load(summary_idx, loader).then([this, &bound, summary_idx] (partition_index_cache::entry_ptr ref) {
             bound.current_list = std::move(ref);
+            bound.single_entry = false;
             bound.current_summary_idx = summary_idx;
             bound.current_index_idx = 0;
             bound.current_pi_idx = 0;
@@ -607,6 +626,9 @@ class index_reader {
                 return advance_to_next_partition(bound);
             });
         }
+        if (bound.single_entry) {
+            return advance_past_single_entry(bound);
+        }
         if (bound.current_index_idx + 1 < bound.current_list->size()) {
             ++bound.current_index_idx;
             bound.current_pi_idx = 0;
@@ -622,6 +644,110 @@ class index_reader {
         return advance_to_end(bound);
     }
 
+    // Replaces the entry found through the partition trie with the summary page
+    // holding it, and moves to the partition following that entry.
+    future<> advance_past_single_entry(index_bound& bound) {
+        auto position = current_partition_entry(bound).position();
+        auto summary_idx = bound.current_summary_idx;
+        co_await advance_to_page(bound, summary_idx);
+        auto& entries = bound.current_list->_entries;
+        auto i = std::upper_bound(std::begin(entries), std::end(entries), position, [] (uint64_t pos, const managed_ref<index_entry>& e) {
+            return pos < e->position();
+        });
+        if (i == std::end(entries)) {
+            co_await advance_to_page(bound, summary_idx + 1);
+            co_return;
+        }
+        bound.current_index_idx = std::distance(std::begin(entries), i);
+        bound.data_file_position = (*i)->position();
+        sstlog.trace("index {} bound {}: advanced past single entry, new page index = {}, pos={}",
+            fmt::ptr(this), fmt::ptr(&bound), bound.current_index_idx, bound.data_file_position);
+    }
+
+    // Reads the index entry at [offset, offset + size) alone.
+    future<index_list> read_single_entry(uint64_t offset, uint64_t size) {
+        auto index_file = make_tracked_index_file(*_sstable, _permit, _trace_state, _use_caching);
+        auto options = get_file_input_stream_options(_pc);
+        // The entry most often fits in a page, so read it without read-ahead.
+        // A promoted index which follows it is skipped.
+        options.buffer_size = cached_file::page_size;
+        options.read_ahead = 0;
+        options.dynamic_adjustments = {};
+        auto input = make_file_input_stream(index_file, offset, size, std::move(options));
+        index_consumer consumer(_region, _sstable->get_schema());
+        consumer.prepare(1);
+        auto context = make_context(std::move(input), offset, offset + size, consumer);
+        std::exception_ptr ex;
+        try {
+            co_await context->consume_input();
+        } catch (...) {
+            ex = std::current_exception();
+        }
+        co_await context->close();
+        if (ex) {
+            sstlog.error("failed reading index entry at {} of {}: {}", offset, _sstable->get_filename(), ex);
+            std::rethrow_exception(std::move(ex));
+        }
+        if (consumer.indexes.size() != 1) {
+            throw malformed_sstable_exception(format("expected a single index entry at {} of {} bytes, found {}", offset, size, consumer.indexes.size()),
+                _sstable->index_filename());
+        }
+        co_return std::move(consumer.indexes);
+    }
+
+    bool can_use_partition_trie(dht::ring_position_view key) const {
+        return _use_caching && _sstable->_partition_trie && key.key() && !key.is_after_key()
+            && !partition_data_ready(_lower_bound) && _lower_bound.previous_summary_idx == 0 && !_upper_bound;
+    }
+
+    // Positions the lower bound on the partition of the given key, which it finds through
+    // the partition trie, reading only its index entry.
+    // Returns false, without moving the lower bound, if the sstable doesn't contain the key.
+    future<bool> advance_lower_with_partition_trie(dht::ring_position_view key) {
+        const schema& s = *_sstable->_schema;
+        auto sstable_key = sstables::key::from_partition_key(s, *key.key());
+        auto entry = co_await _sstable->_partition_trie->lookup(key.token(), bytes_view(sstable_key), _pc, _trace_state);
+        if (!entry) {
+            sstlog.trace("index {}: not in partition trie", fmt::ptr(this));
+            co_return false;
+        }
+        // The summary page holding the entry is the last one starting at or before it.
+        auto& summary = _sstable->get_summary();
+        auto page = std::upper_bound(summary.entries.begin(), summary.entries.end(), entry->index_offset, [] (uint64_t offset, const summary_entry& e) {
+            return offset < e.position;
+        });
+        if (page == summary.entries.begin()) {
+            throw malformed_sstable_exception(format("partition trie points to index entry at {}, before the first summary page", entry->index_offset),
+                _sstable->filename(component_type::Partitions));
+        }
+        auto list = co_await _sstable->_index_entry_cache->get_or_load(entry->index_offset, [this, size = entry->index_entry_size] (uint64_t offset) {
+            _permit.on_index_page_read();
+            return read_single_entry(offset, size);
+        });
+        bool found = _alloc_section(_region, [&] {
+            dht::ring_position_comparator_for_sstables tri_cmp(s);
+            return tri_cmp(list->_entries[0]->get_decorated_key(s), key) == 0;
+        });
+        if (!found) {
+            sstlog.trace("index {}: partition trie points to another key", fmt::ptr(this));
+            co_return false;
+        }
+        auto summary_idx = std::distance(summary.entries.begin(), page) - 1;
+        auto& bound = _lower_bound;
+        bound.current_list = std::move(list);
+        bound.single_entry = true;
+        bound.previous_summary_idx = summary_idx;
+        bound.current_summary_idx = summary_idx;
+        bound.current_index_idx = 0;
+        bound.current_pi_idx = 0;
+        bound.data_file_position = bound.current_list->_entries[0]->position();
+        bound.element = indexable_element::partition;
+        bound.end_open_marker.reset();
+        sstlog.trace("index {}: found in partition trie, summary_idx={}, pos={}", fmt::ptr(this), summary_idx, bound.data_file_position);
+        co_await reset_clustered_cursor(bound);
+        co_return true;
+    }
+
     future<> advance_to(index_bound& bound, dht::ring_position_view pos) {
         sstlog.trace("index {} bound {}: advance_to({}), _previous_summary_idx={}, _current_summary_idx={}",
             fmt::ptr(this), fmt::ptr(&bound), pos, bound.previous_summary_idx, bound.current_summary_idx);
@@ -672,20 +798,17 @@ class index_reader {
 
         return advance_to_page(bound, summary_idx).then([this, &bound, pos, summary_idx] {
             sstlog.trace("index {}: old page index = {}", fmt::ptr(this), bound.current_index_idx);
-            auto i = _alloc_section(_region, [&] {
-                auto& entries = bound.current_list->_entries;
-                return std::lower_bound(std::begin(entries) + bound.current_index_idx, std::end(entries), pos,
-                    index_comparator(*_sstable->_schema));
+            auto idx = _alloc_section(_region, [&] {
+                return bound.current_list->lower_bound(*_sstable->_schema, bound.current_index_idx, pos);
             });
-            // i is valid until next allocation point
             auto& entries = bound.current_list->_entries;
-            if (i == std::end(entries)) {
+            if (idx == entries.size()) {
                 sstlog.trace("index {}: not found", fmt::ptr(this));
                 return advance_to_page(bound, summary_idx + 1);
             }
-            bound.current_index_idx = std::distance(std::begin(entries), i);
+            bound.current_index_idx = idx;
             bound.current_pi_idx = 0;
-            bound.data_file_position = (*i)->position();
+            bound.data_file_position = entries[idx]->position();
             bound.element = indexable_element::partition;
             bound.end_open_marker.reset();
             sstlog.trace("index {}: new page index = {}, pos={}", fmt::ptr(this), bound.current_index_idx, bound.data_file_position);
@@ -921,8 +1044,22 @@ class index_reader {
 
     // Like advance_to(dht::ring_position_view), but returns information whether the key was found
     // If upper_bound is provided, the upper bound within position is looked up
+    //
+    // When the sstable has a partition trie, the first lookup of a reader goes through it,
+    // and reads only the index entry of the key. The lower bound is then left where it is
+    // when the key isn't found.
     future<bool> advance_lower_and_check_if_present(
             dht::ring_position_view key, std::optional<position_in_partition_view> pos = {}) {
+        if (can_use_partition_trie(key)) {
+            return advance_lower_with_partition_trie(key).then([this, pos] (bool found) {
+                if (!found || !pos) {
+                    return make_ready_future<bool>(found);
+                }
+                return advance_upper_past(*pos).then([] {
+                    return make_ready_future<bool>(true);
+                });
+            });
+        }
         return advance_to(_lower_bound, key).then([this, key, pos] {
             if (eof()) {
                 return make_ready_future<bool>(false);
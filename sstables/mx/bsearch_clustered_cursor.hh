@@ -11,7 +11,9 @@
 #include "sstables/index_entry.hh"
 #include "sstables/column_translation.hh"
 #include "sstables/promoted_index_blocks_reader.hh"
+#include "sstables/exceptions.hh"
 #include "parsers.hh"
+#include "row_index.hh"
 #include "schema/schema.hh"
 #include "utils/cached_file.hh"
 
@@ -359,6 +361,9 @@ class cached_promoted_index {
 ///
 /// N = number of index entries
 ///
+/// When the partition has a tree in the row index, the binary search starts from
+/// the block the tree points to, and the I/O cost drops to the height of the tree.
+///
 class bsearch_clustered_cursor : public clustered_index_cursor {
     using pi_offset_type = cached_promoted_index::pi_offset_type;
     using pi_index_type = cached_promoted_index::pi_index_type;
@@ -379,14 +384,42 @@ class bsearch_clustered_cursor : public clustered_index_cursor {
     std::optional<position_in_partition> _current_pos;
 
     tracing::trace_state_ptr _trace_state;
+
+    // Set when the partition has a tree in the row index.
+    std::unique_ptr<row_index_cursor> _row_index;
 private:
     // Advances the cursor to the nearest block whose start position is > pos.
     //
-    // upper_idx should be the index of the block which is known to have start position > pos.
-    // upper_idx can be set to _blocks_count if no such entry is known.
-    //
     // Async calls must be serialized.
     future<> advance_to_upper_bound(position_in_partition_view pos) {
+        _upper_idx = _blocks_count;
+        if (!_row_index) {
+            return bisect(pos);
+        }
+        return _row_index->upper_bound(pos).then([this, pos] (row_index_cursor::upper_bound_info info) {
+            if (info.index > _blocks_count) {
+                throw malformed_sstable_exception(format("Row index points to promoted index block {} out of {}", info.index, _blocks_count));
+            }
+            sstlog.trace("mc_bsearch_clustered_cursor {}: row index upper bound [{}] .start={}", fmt::ptr(this), info.index, info.start);
+            if (info.index >= _current_idx) {
+                _current_idx = info.index;
+                if (info.start) {
+                    _current_pos = std::move(*info.start);
+                    _upper_idx = _current_idx;
+                } else {
+                    // The start of the upper bound is on another leaf of the tree, read it from the promoted index.
+                    _upper_idx = std::min(_current_idx + 1, _blocks_count);
+                }
+            }
+            return bisect(pos);
+        });
+    }
+
+    // Binary search over blocks in [_current_idx, _upper_idx).
+    //
+    // _upper_idx should be the index of the block which is known to have start position > pos.
+    // _upper_idx can be set to _blocks_count if no such entry is known.
+    future<> bisect(position_in_partition_view pos) {
         // Binary search over blocks.
         //
         // Post conditions:
@@ -405,7 +438,6 @@ class bsearch_clustered_cursor : public clustered_index_cursor {
         //
         // Eventually _current_idx will reach _upper_idx.
 
-        _upper_idx = _blocks_count;
         return repeat([this, pos] {
             if (_current_idx >= _upper_idx) {
                 if (_current_idx == _blocks_count) {
@@ -444,7 +476,8 @@ class bsearch_clustered_cursor : public clustered_index_cursor {
             seastar::shared_ptr<cached_file> f,
             io_priority_class pc,
             pi_index_type blocks_count,
-            tracing::trace_state_ptr trace_state)
+            tracing::trace_state_ptr trace_state,
+            std::unique_ptr<row_index_cursor> row_index = {})
         : _s(s)
         , _blocks_count(blocks_count)
         , _cached_file(std::move(f))
@@ -458,6 +491,7 @@ class bsearch_clustered_cursor : public clustered_index_cursor {
             pc,
             blocks_count)
         , _trace_state(std::move(trace_state))
+        , _row_index(std::move(row_index))
     { }
 
     future<std::optional<skip_info>> advance_to(position_in_partition_view pos) override {
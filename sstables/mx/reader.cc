@@ -12,6 +12,7 @@
 #include "sstables/mutation_fragment_filter.hh"
 #include "sstables/sstable_mutation_reader.hh"
 #include "sstables/processing_result_generator.hh"
+#include "sstables/resume_hint.hh"
 
 namespace sstables {
 namespace mx {
@@ -58,6 +59,11 @@ class mp_row_consumer_m {
     std::optional<mutation_fragment_filter> _mf_filter;
 
     bool _is_mutation_end = true;
+    tombstone _partition_tombstone;
+    // Rows under a tombstone at least as new as everything in the sstable are
+    // shadowed by it, so they are skipped instead of parsed. Disabled when the
+    // sstable content is to be returned as it is.
+    std::optional<api::timestamp_type> _skip_rows_shadowed_from;
     streamed_mutation::forwarding _fwd;
     // For static-compact tables C* stores the only row in the static row but in our representation they're regular rows.
     const bool _treat_static_row_as_regular;
@@ -234,6 +240,17 @@ class mp_row_consumer_m {
 
     ~mp_row_consumer_m() {}
 
+    // Skip the rows which a range or partition tombstone shadows for sure:
+    // those with a timestamp not newer than the sstable's maximum.
+    void skip_shadowed_rows() {
+        _skip_rows_shadowed_from = _sst->get_stats_metadata().max_timestamp;
+    }
+
+    bool is_shadowed(tombstone rt) const {
+        auto t = std::max(rt, _partition_tombstone);
+        return _skip_rows_shadowed_from && t && t.timestamp >= *_skip_rows_shadowed_from;
+    }
+
     // See the RowConsumer concept
     void push_ready_fragments() {
         if (auto rto = std::move(_stored_tombstone)) {
@@ -315,6 +332,7 @@ class mp_row_consumer_m {
         auto pk = partition_key::from_exploded(key.explode(*_schema));
         setup_for_partition(pk);
         auto dk = dht::decorate_key(*_schema, pk);
+        _partition_tombstone = tombstone(deltime);
         _reader->on_next_partition(std::move(dk), tombstone(deltime));
         return proceed(!_reader->is_buffer_full() && !need_preempt());
     }
@@ -337,6 +355,12 @@ class mp_row_consumer_m {
 
         switch (res.action) {
         case mutation_fragment_filter::result::emit:
+            if (is_shadowed(_mf_filter->current_tombstone())) {
+                sstlog.trace("mp_row_consumer_m {}: skip shadowed", fmt::ptr(this));
+                _sst->get_stats().on_shadowed_row_skipped();
+                _in_progress_row.reset();
+                return mp_row_consumer_m::row_processing_result::skip_row;
+            }
             sstlog.trace("mp_row_consumer_m {}: emit", fmt::ptr(this));
             return mp_row_consumer_m::row_processing_result::do_proceed;
         case mutation_fragment_filter::result::ignore:
@@ -388,6 +412,37 @@ class mp_row_consumer_m {
         return mp_row_consumer_m::row_processing_result::do_proceed;
     }
 
+    // Returns the type of the value of the cell at cell_path of a multi-cell
+    // column of the given type.
+    static const abstract_type& multi_cell_value_type(const abstract_type& type, bytes_view cell_path) {
+        // Cells of lists, sets and maps all have the value type of the
+        // collection, so only user types need visiting for every cell.
+        const auto kind = type.get_kind();
+        if (kind == abstract_type::kind::list || kind == abstract_type::kind::set || kind == abstract_type::kind::map) {
+            return *static_cast<const collection_type_impl&>(type).value_comparator();
+        }
+        return visit(type, make_visitor(
+            [] (const collection_type_impl& ctype) -> const abstract_type& { return *ctype.value_comparator(); },
+            [&] (const user_type_impl& utype) -> const abstract_type& {
+                if (cell_path.size() != sizeof(int16_t)) {
+                    throw malformed_sstable_exception(format("wrong size of field index while reading UDT column: expected {}, got {}",
+                                sizeof(int16_t), cell_path.size()));
+                }
+
+                auto field_idx = deserialize_field_index(cell_path);
+                if (field_idx >= utype.size()) {
+                    throw malformed_sstable_exception(format("field index too big while reading UDT column: type has {} fields, got {}",
+                                utype.size(), field_idx));
+                }
+
+                return *utype.type(field_idx);
+            },
+            [] (const abstract_type& o) -> const abstract_type& {
+                throw malformed_sstable_exception(format("attempted to read multi-cell column, but expected type was {}", o.name()));
+            }
+        ));
+    }
+
     proceed consume_column(const column_translation::column_info& column_info,
                                    bytes_view cell_path,
                                    fragmented_temporary_buffer::view value,
@@ -408,26 +463,7 @@ class mp_row_consumer_m {
         }
         check_schema_mismatch(column_info, column_def);
         if (column_def.is_multi_cell()) {
-            auto& value_type = visit(*column_def.type, make_visitor(
-                [] (const collection_type_impl& ctype) -> const abstract_type& { return *ctype.value_comparator(); },
-                [&] (const user_type_impl& utype) -> const abstract_type& {
-                    if (cell_path.size() != sizeof(int16_t)) {
-                        throw malformed_sstable_exception(format("wrong size of field index while reading UDT column: expected {}, got {}",
-                                    sizeof(int16_t), cell_path.size()));
-                    }
-
-                    auto field_idx = deserialize_field_index(cell_path);
-                    if (field_idx >= utype.size()) {
-                        throw malformed_sstable_exception(format("field index too big while reading UDT column: type has {} fields, got {}",
-                                    utype.size(), field_idx));
-                    }
-
-                    return *utype.type(field_idx);
-                },
-                [] (const abstract_type& o) -> const abstract_type& {
-                    throw malformed_sstable_exception(format("attempted to read multi-cell column, but expected type was {}", o.name()));
-                }
-            ));
+            auto& value_type = multi_cell_value_type(*column_def.type, cell_path);
             auto ac = is_deleted ? atomic_cell::make_dead(timestamp, local_deletion_time)
                                  : make_atomic_cell(value_type,
                                                     timestamp,
@@ -664,6 +700,10 @@ class mp_row_consumer_m {
     tracing::trace_state_ptr trace_state() const {
         return _trace_state;
     }
+
+    const query::partition_slice& slice() const {
+        return _slice;
+    }
 };
 
 // data_consume_rows_context_m remembers the context that an ongoing
@@ -677,6 +717,9 @@ class data_consume_rows_context_m : public data_consumer::continuous_data_consum
         OTHER,
     } _state = state::PARTITION_START;
 
+    // Data file position of the last partition whose header was parsed.
+    uint64_t _partition_start_position = 0;
+
     // becomes false when we yield in the main coroutine, although we don't need to consume
     // more data buffers to continue, switch back to true afterwards
     bool _consuming = true;
@@ -707,6 +750,10 @@ class data_consume_rows_context_m : public data_consumer::continuous_data_consum
 
         // Represents the subset of _all_columns present in current row
         boost::dynamic_bitset<uint64_t> _columns_selector; // size() == _columns.size()
+
+        // The subset of _all_columns whose values are skipped, see
+        // query::partition_slice::option::skip_unselected_values.
+        boost::dynamic_bitset<uint64_t> _skipped_values; // size() == _columns.size()
     };
 
     row_schema _regular_row;
@@ -754,6 +801,19 @@ class data_consume_rows_context_m : public data_consumer::continuous_data_consum
     void setup_columns(row_schema& rs, const std::vector<column_translation::column_info>& columns) {
         rs._all_columns = boost::make_iterator_range(columns);
         rs._columns_selector = boost::dynamic_bitset<uint64_t>(columns.size());
+        rs._skipped_values = boost::dynamic_bitset<uint64_t>(columns.size());
+    }
+    // Only the values of simple columns are skipped, the cells of collections
+    // and counters are always parsed.
+    void setup_skipped_values(row_schema& rs, const query::column_id_vector& selected) {
+        size_t pos = 0;
+        for (const auto& column : rs._all_columns) {
+            if (column.id && !column.is_collection && !column.is_counter
+                    && std::find(selected.begin(), selected.end(), *column.id) == selected.end()) {
+                rs._skipped_values.set(pos);
+            }
+            ++pos;
+        }
     }
     void skip_absent_columns() {
         size_t pos = _row->_columns_selector.find_first();
@@ -772,6 +832,9 @@ class data_consume_rows_context_m : public data_consumer::continuous_data_consum
     }
     bool is_column_simple() const { return !_row->_columns.front().is_collection; }
     bool is_column_counter() const { return _row->_columns.front().is_counter; }
+    bool is_column_value_skipped() const {
+        return _row->_skipped_values.test(_row->_skipped_values.size() - _row->_columns.size());
+    }
     const column_translation::column_info& get_column_info() const {
         return _row->_columns.front();
     }
@@ -816,6 +879,10 @@ class data_consume_rows_context_m : public data_consumer::continuous_data_consum
         return !_consuming;
     }
 
+    uint64_t partition_start_position() const {
+        return _partition_start_position;
+    }
+
     data_consumer::processing_result process_state(temporary_buffer<char>& data) {
         _processing_data = &data;
         return _gen.generate();
@@ -826,6 +893,7 @@ class data_consume_rows_context_m : public data_consumer::continuous_data_consum
             goto flags_label;
         }
         partition_start_label: {
+            _partition_start_position = position() - _processing_data->size();
             _is_first_unfiltered = true;
             _state = state::DELETION_TIME;
             co_yield read_short_length_bytes(*_processing_data, _pk);
@@ -1007,6 +1075,15 @@ class data_consume_rows_context_m : public data_consumer::continuous_data_consum
                     _row->_columns_selector.set();
                 }
                 while (_missing_columns_to_read > 0) {
+                    std::array<uint64_t, 16> column_indexes;
+                    auto batch = std::span(column_indexes).first(std::min(_missing_columns_to_read, uint64_t(column_indexes.size())));
+                    if (try_read_unsigned_vints(*_processing_data, batch)) {
+                        for (auto idx : batch) {
+                            _row->_columns_selector.flip(idx);
+                        }
+                        _missing_columns_to_read -= batch.size();
+                        continue;
+                    }
                     --_missing_columns_to_read;
                     co_yield read_unsigned_vint(*_processing_data);
                     _row->_columns_selector.flip(_u64);
@@ -1084,6 +1161,17 @@ class data_consume_rows_context_m : public data_consumer::continuous_data_consum
             }
             if (!_column_flags.has_value()) {
                 _column_value = fragmented_temporary_buffer();
+            } else if (is_column_value_skipped()) {
+                if (auto len = get_column_value_length()) {
+                    _u64 = *len;
+                } else {
+                    co_yield read_unsigned_vint(*_processing_data);
+                }
+                _column_value = fragmented_temporary_buffer();
+                auto maybe_skip_bytes = skip(*_processing_data, _u64);
+                if (std::holds_alternative<skip_bytes>(maybe_skip_bytes)) {
+                    co_yield maybe_skip_bytes;
+                }
             } else {
                 read_status status = read_status::waiting;
                 if (auto len = get_column_value_length()) {
@@ -1184,6 +1272,12 @@ class data_consume_rows_context_m : public data_consumer::continuous_data_consum
     {
         setup_columns(_regular_row, _column_translation.regular_columns());
         setup_columns(_static_row, _column_translation.static_columns());
+        // The static row of static compact tables holds regular columns.
+        const auto& slice = consumer.slice();
+        if (slice.options.contains<query::partition_slice::option::skip_unselected_values>() && !s.is_static_compact_table()) {
+            setup_skipped_values(_regular_row, slice.regular_columns);
+            setup_skipped_values(_static_row, slice.static_columns);
+        }
     }
 
     void verify_end_state() {
@@ -1272,6 +1366,12 @@ class mx_sstable_mutation_reader : public mp_row_consumer_reader_mx {
     // of the reversing data source used underneath (see `partition_reversing_data_source`).
     // Engaged after `_context` is engaged, i.e. after `initialize()`.
     const uint64_t* _reversed_read_sstable_position;
+
+    // Data file position of the current partition when it was read from the index
+    // rather than parsed from the data file, see resume_hint.
+    std::optional<uint64_t> _partition_start_from_index;
+    // Data file position of the end of the range, see resume_hint.
+    uint64_t _range_end_position = 0;
 public:
     mx_sstable_mutation_reader(shared_sstable sst,
                             schema_ptr schema,
@@ -1295,6 +1395,7 @@ class mx_sstable_mutation_reader : public mp_row_consumer_reader_mx {
             , _fwd(fwd)
             , _fwd_mr(fwd_mr)
             , _monitor(mon) {
+        _consumer.skip_shadowed_rows();
         if (reversed()) {
             if (!_single_partition_read) {
                 on_internal_error(sstlog, format(
@@ -1344,7 +1445,8 @@ class mx_sstable_mutation_reader : public mp_row_consumer_reader_mx {
                 : get_index_reader().advance_to(dht::ring_position_view::for_after_key(*_current_partition_key))).then([this] {
             _index_in_current_partition = true;
             auto [start, end] = _index_reader->data_file_positions();
-            if (end && start > *end) {
+            // The index has no upper bound if the reader was initialized from a resume_hint.
+            if (start > end.value_or(_range_end_position)) {
                 _read_enabled = false;
                 return make_ready_future<>();
             }
@@ -1365,6 +1467,7 @@ class mx_sstable_mutation_reader : public mp_row_consumer_reader_mx {
         auto key = dht::decorate_key(*_schema, std::move(pk));
         _consumer.setup_for_partition(key.key());
         on_next_partition(std::move(key), tombstone(*tomb));
+        _partition_start_from_index = _index_reader->data_file_positions().start;
         return make_ready_future<>();
     }
     future<> read_from_datafile() {
@@ -1392,6 +1495,7 @@ class mx_sstable_mutation_reader : public mp_row_consumer_reader_mx {
         // It is also better to pay the cost of reading the index if we know that we will
         // need to use the index anyway soon.
         //
+        _partition_start_from_index.reset();
         if (_index_in_current_partition) {
             if (_context->eof()) {
                 sstlog.trace("reader {}: eof", fmt::ptr(this));
@@ -1507,11 +1611,24 @@ class mx_sstable_mutation_reader : public mp_row_consumer_reader_mx {
             }
         } else {
             _sst->get_stats().on_range_partition_read();
+            if (auto hint = get_resume_hint()) {
+                sstlog.trace("reader {}: resuming from data file position {}", fmt::ptr(this), hint->partition_start);
+                sstable::disk_read_range drr{hint->partition_start, hint->range_end};
+                _range_end_position = drr.end;
+                _read_enabled = bool(drr);
+                _context = data_consume_rows<DataConsumeRowsContext>(*_schema, _sst, _consumer, std::move(drr), _range_end_position);
+                _monitor.on_read_started(_context->reader_position());
+                // The index is only looked up if the read needs it, e.g. to skip within the partition.
+                _index_in_current_partition = false;
+                _will_likely_slice = will_likely_slice(_slice);
+                co_return;
+            }
             co_await get_index_reader().advance_to(_pr);
         }
 
         auto [begin, end] = _index_reader->data_file_positions();
         assert(end);
+        _range_end_position = *end;
 
         if (_single_partition_read) {
             _read_enabled = (begin != *end);
@@ -1534,6 +1651,44 @@ class mx_sstable_mutation_reader : public mp_row_consumer_reader_mx {
         _index_in_current_partition = true;
         _will_likely_slice = will_likely_slice(_slice);
     }
+    bool can_use_resume_hint() const {
+        return !_single_partition_read && !reversed() && !_fwd && !_fwd_mr;
+    }
+    // Returns the hint left by the previous reader of this sstable in the same
+    // read, if _pr starts at the hinted partition and has the same end.
+    lw_shared_ptr<const resume_hint> get_resume_hint() const {
+        if (!can_use_resume_hint() || !_pr.start() || !_pr.start()->is_inclusive()) {
+            return nullptr;
+        }
+        auto hint = _permit.get_sstable_resume_hint(_sst->generation());
+        if (!hint || dht::ring_position_tri_compare(*_schema, _pr.start()->value(), hint->partition) != 0) {
+            return nullptr;
+        }
+        const auto& end = _pr.end();
+        const auto& hint_end = hint->range_end_bound;
+        if (bool(end) != bool(hint_end)) {
+            return nullptr;
+        }
+        if (end && (end->is_inclusive() != hint_end->is_inclusive()
+                || dht::ring_position_tri_compare(*_schema, end->value(), hint_end->value()) != 0)) {
+            return nullptr;
+        }
+        return hint;
+    }
+    // Called on close(). Readers which were never initialized leave the hint
+    // of the sstable as it is, it still applies to the next reader.
+    void save_resume_hint() {
+        if (!_context) {
+            return;
+        }
+        if (!can_use_resume_hint() || !_current_partition_key || _partition_finished) {
+            _permit.set_sstable_resume_hint(_sst->generation(), nullptr);
+            return;
+        }
+        auto partition_start = _partition_start_from_index.value_or(_context->partition_start_position());
+        _permit.set_sstable_resume_hint(_sst->generation(), make_lw_shared<resume_hint>(resume_hint{
+                *_current_partition_key, partition_start, _pr.end(), _range_end_position}));
+    }
     future<> ensure_initialized() {
         if (is_initialized()) {
             return make_ready_future<>();
@@ -1662,6 +1817,12 @@ class mx_sstable_mutation_reader : public mp_row_consumer_reader_mx {
         }
     }
     virtual future<> close() noexcept override {
+        try {
+            save_resume_hint();
+        } catch (...) {
+            sstlog.debug("Failed to save the resume hint of {}: {}. Ignored.", _sst->get_filename(), std::current_exception());
+        }
+
         auto close_context = make_ready_future<>();
         if (_context) {
             _monitor.on_read_completed();
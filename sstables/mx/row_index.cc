@@ -0,0 +1,301 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "sstables/mx/row_index.hh"
+#include "sstables/writer.hh"
+#include "sstables/exceptions.hh"
+#include "log.hh"
+
+#include <seastar/core/byteorder.hh>
+#include <seastar/core/coroutine.hh>
+
+#include <algorithm>
+
+namespace sstables {
+
+extern logging::logger sstlog;
+
+}
+
+namespace sstables::mc {
+
+thread_local row_index::stats row_index::_shard_stats;
+
+namespace {
+
+constexpr size_t header_size = 1 + 2 + 4;
+constexpr size_t leaf_entry_size = 4 + 4;
+constexpr size_t inner_entry_size = 4 + 8;
+constexpr size_t footer_size = sizeof(uint64_t);
+constexpr size_t root_entry_size = 2 * sizeof(uint64_t);
+
+constexpr uint8_t leaf_flag = 1;
+
+}
+
+row_index_writer::row_index_writer(std::unique_ptr<file_writer> out)
+    : _out(std::move(out))
+{
+}
+
+row_index_writer::~row_index_writer() = default;
+
+void row_index_writer::pad_for(size_t node_size) {
+    auto in_page = _out->offset() % cached_file::page_size;
+    if (in_page && node_size <= cached_file::page_size && in_page + node_size > cached_file::page_size) {
+        bytes padding(cached_file::page_size - in_page, 0);
+        _out->write(padding);
+    }
+}
+
+uint64_t row_index_writer::write_node(bool leaf, std::span<const entry> entries) {
+    auto entry_size = leaf ? leaf_entry_size : inner_entry_size;
+    size_t size = header_size + entries.size() * entry_size;
+    for (auto& e : entries) {
+        size += e.key.size();
+    }
+    pad_for(size);
+    auto pos = _out->offset();
+
+    bytes buf(bytes::initialized_later(), size);
+    auto p = reinterpret_cast<char*>(buf.data());
+    *p++ = char(leaf ? leaf_flag : 0);
+    write_be(p, uint16_t(entries.size()));
+    p += 2;
+    write_be(p, uint32_t(size));
+    p += 4;
+    uint32_t key_offset = header_size + entries.size() * entry_size;
+    for (auto& e : entries) {
+        write_be(p, key_offset);
+        p += 4;
+        if (leaf) {
+            write_be(p, uint32_t(e.value));
+            p += 4;
+        } else {
+            write_be(p, e.value);
+            p += 8;
+        }
+        key_offset += e.key.size();
+    }
+    for (auto& e : entries) {
+        p = std::copy(e.key.begin(), e.key.end(), p);
+    }
+    _out->write(buf);
+    return pos;
+}
+
+void row_index_writer::end_partition(uint64_t promoted_index_start) {
+    if (_keys.size() < min_blocks) {
+        _keys.clear();
+        return;
+    }
+    std::vector<entry> level;
+    level.reserve(_keys.size());
+    for (size_t i = 0; i < _keys.size(); ++i) {
+        level.push_back(entry{_keys[i], i});
+    }
+    bool leaf = true;
+    for (;;) {
+        auto entry_size = leaf ? leaf_entry_size : inner_entry_size;
+        std::vector<entry> parents;
+        size_t begin = 0;
+        while (begin < level.size()) {
+            // Fill the node up to a page, but with at least one entry.
+            size_t size = header_size + entry_size + level[begin].key.size();
+            size_t end = begin + 1;
+            while (end < level.size() && size + entry_size + level[end].key.size() <= cached_file::page_size) {
+                size += entry_size + level[end].key.size();
+                ++end;
+            }
+            auto pos = write_node(leaf, std::span<const entry>(level).subspan(begin, end - begin));
+            parents.push_back(entry{level[begin].key, pos});
+            begin = end;
+        }
+        if (parents.size() == 1) {
+            _roots.emplace_back(promoted_index_start, parents.front().value);
+            break;
+        }
+        level = std::move(parents);
+        leaf = false;
+    }
+    _keys.clear();
+}
+
+void row_index_writer::finish() {
+    bytes buf(bytes::initialized_later(), _roots.size() * root_entry_size + footer_size);
+    auto p = reinterpret_cast<char*>(buf.data());
+    for (auto& [pi_start, root] : _roots) {
+        write_be(p, pi_start);
+        write_be(p + sizeof(uint64_t), root);
+        p += root_entry_size;
+    }
+    write_be(p, uint64_t(_roots.size()));
+    _out->write(buf);
+    _out->close();
+}
+
+row_index::row_index(file f, uint64_t size, std::vector<std::pair<uint64_t, uint64_t>> roots, cached_file::metrics& metrics, cache_tracker& tracker)
+    : _file(std::move(f))
+    , _cached_file(seastar::make_shared<cached_file>(_file, metrics, tracker.get_lru(), tracker.region(), size))
+    , _roots(std::move(roots))
+{
+}
+
+future<std::unique_ptr<row_index>> row_index::open(file f, cached_file::metrics& metrics, cache_tracker& tracker, const io_priority_class& pc) {
+    auto size = co_await f.size();
+    if (size < footer_size) {
+        throw malformed_sstable_exception(format("Rows.db is too short: {} bytes", size));
+    }
+    auto footer = co_await f.dma_read_exactly<char>(size - footer_size, footer_size, pc);
+    auto count = read_be<uint64_t>(footer.get());
+    if (count > (size - footer_size) / root_entry_size) {
+        throw malformed_sstable_exception(format("Rows.db of {} bytes can't hold {} trees", size, count));
+    }
+    std::vector<std::pair<uint64_t, uint64_t>> roots;
+    roots.reserve(count);
+    auto table_start = size - footer_size - count * root_entry_size;
+    if (count) {
+        auto table = co_await f.dma_read_exactly<char>(table_start, count * root_entry_size, pc);
+        for (size_t i = 0; i < count; ++i) {
+            auto p = table.get() + i * root_entry_size;
+            auto root = read_be<uint64_t>(p + sizeof(uint64_t));
+            if (root >= table_start) {
+                throw malformed_sstable_exception(format("Rows.db tree root at {} is past the end of the trees at {}", root, table_start));
+            }
+            roots.emplace_back(read_be<uint64_t>(p), root);
+        }
+    }
+    if (!std::is_sorted(roots.begin(), roots.end())) {
+        throw malformed_sstable_exception("Rows.db trees are not sorted by promoted index start");
+    }
+    co_return std::make_unique<row_index>(std::move(f), size, std::move(roots), metrics, tracker);
+}
+
+std::optional<uint64_t> row_index::find_root(uint64_t promoted_index_start) const {
+    auto i = std::lower_bound(_roots.begin(), _roots.end(), promoted_index_start, [] (const auto& e, uint64_t start) {
+        return e.first < start;
+    });
+    if (i == _roots.end() || i->first != promoted_index_start) {
+        return std::nullopt;
+    }
+    return i->second;
+}
+
+future<> row_index::close() noexcept {
+    try {
+        co_await _file.close();
+    } catch (...) {
+        sstlog.warn("Failed to close row index file: {}", std::current_exception());
+    }
+}
+
+row_index_cursor::row_index_cursor(const schema& s,
+        seastar::shared_ptr<cached_file> f,
+        uint64_t root,
+        io_priority_class pc,
+        reader_permit permit,
+        column_values_fixed_lengths cvfl,
+        tracing::trace_state_ptr trace_state)
+    : _s(s)
+    , _cached_file(std::move(f))
+    , _root(root)
+    , _pc(pc)
+    , _permit(permit)
+    , _clustering_parser(s, std::move(permit), std::move(cvfl), true)
+    , _trace_state(std::move(trace_state))
+{
+}
+
+future<temporary_buffer<char>> row_index_cursor::read(uint64_t pos, size_t size) {
+    auto s = _cached_file->read(pos, _pc, _permit, _trace_state, size);
+    auto buf = co_await s.next();
+    if (buf.size() >= size) {
+        buf.trim(size);
+        co_return buf;
+    }
+    // The node doesn't fit in a page.
+    temporary_buffer<char> result(size);
+    size_t copied = 0;
+    while (copied < size) {
+        if (buf.empty()) {
+            throw malformed_sstable_exception(format("Rows.db node at {} of {} bytes is past the end of the file", pos, size));
+        }
+        auto n = std::min(buf.size(), size - copied);
+        std::copy_n(buf.get(), n, result.get_write() + copied);
+        copied += n;
+        if (copied < size) {
+            buf = co_await s.next();
+        }
+    }
+    co_return result;
+}
+
+position_in_partition row_index_cursor::parse_key(temporary_buffer<char>& node, size_t offset) {
+    if (offset >= node.size()) {
+        throw malformed_sstable_exception(format("Rows.db key at {} is past the end of its {} bytes node", offset, node.size()));
+    }
+    auto buf = node.share(offset, node.size() - offset);
+    _clustering_parser.reset();
+    if (_clustering_parser.consume(buf) != data_consumer::read_status::ready) {
+        throw malformed_sstable_exception(format("Rows.db key at {} runs past the end of its {} bytes node", offset, node.size()));
+    }
+    return _clustering_parser.get_and_reset();
+}
+
+future<row_index_cursor::upper_bound_info> row_index_cursor::upper_bound(position_in_partition_view pos) {
+    ++row_index::_shard_stats.lookups;
+    position_in_partition::less_compare less(_s);
+    auto node_pos = _root;
+    for (;;) {
+        auto header = co_await read(node_pos, header_size);
+        bool leaf = uint8_t(header[0]) & leaf_flag;
+        size_t count = read_be<uint16_t>(header.get() + 1);
+        size_t size = read_be<uint32_t>(header.get() + 3);
+        auto entry_size = leaf ? leaf_entry_size : inner_entry_size;
+        if (count == 0 || size < header_size + count * entry_size) {
+            throw malformed_sstable_exception(format("Rows.db node at {} of {} bytes can't hold {} entries", node_pos, size, count));
+        }
+        auto node = co_await read(node_pos, size);
+        auto entry_at = [&] (size_t i) {
+            return node.get() + header_size + i * entry_size;
+        };
+
+        // Find the first entry whose key is greater than pos.
+        size_t lo = 0;
+        size_t hi = count;
+        std::optional<position_in_partition> hi_key;
+        while (lo < hi) {
+            auto mid = lo + (hi - lo) / 2;
+            auto key = parse_key(node, read_be<uint32_t>(entry_at(mid)));
+            if (less(pos, key)) {
+                hi = mid;
+                hi_key = std::move(key);
+            } else {
+                lo = mid + 1;
+            }
+        }
+        sstlog.trace("row_index_cursor {}: node at {}, leaf={}, {} entries, upper bound {}", fmt::ptr(this), node_pos, leaf, count, hi);
+
+        if (leaf) {
+            if (hi < count) {
+                co_return upper_bound_info{read_be<uint32_t>(entry_at(hi) + 4), std::move(hi_key)};
+            }
+            // The upper bound is the first key of the next leaf.
+            co_return upper_bound_info{read_be<uint32_t>(entry_at(count - 1) + 4) + 1, std::nullopt};
+        }
+        // Descend into the last child whose first key isn't greater than pos,
+        // or into the first one if there is none.
+        auto child = read_be<uint64_t>(entry_at(hi ? hi - 1 : 0) + 4);
+        if (child >= node_pos) {
+            throw malformed_sstable_exception(format("Rows.db node at {} points to a child at {}", node_pos, child));
+        }
+        node_pos = child;
+    }
+}
+
+}
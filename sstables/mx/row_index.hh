@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include "sstables/column_translation.hh"
+#include "parsers.hh"
+#include "utils/cached_file.hh"
+#include "db/cache_tracker.hh"
+#include "tracing/trace_state.hh"
+#include "reader_permit.hh"
+
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace sstables {
+
+class file_writer;
+
+}
+
+namespace sstables::mc {
+
+// The row index (Rows.db) holds, for each partition with a large promoted
+// index, a tree over the start positions of its promoted index blocks. The
+// tree finds the block holding a clustering position by reading one node per
+// level, where a binary search over the promoted index reads a block start,
+// often on a page of its own, at each of its log2(N) steps.
+//
+// Nodes are written children first, each level after the one below it, so the
+// root of each tree is its last node. A node is at most a page long unless a
+// single key doesn't fit, and doesn't straddle pages when it fits in one.
+// Each node is made of:
+//
+//   flags (1 byte): bit 0 is set for leaves
+//   number of entries (2 bytes)
+//   size of the node in bytes (4 bytes)
+//   for each entry: the offset of its key in the node (4 bytes), followed by
+//     the index of the promoted index block in leaves (4 bytes), or the
+//     position of the child node in the file otherwise (8 bytes)
+//   the keys, serialized like the block starts of the promoted index
+//
+// In leaves, key i is the start of the promoted index block it points to. In
+// the other nodes, it is the first key of the child. All integers are
+// big-endian.
+//
+// After the trees comes a table of (promoted index start, root position)
+// pairs, sorted by the start of the promoted index in Index.db, and the number
+// of pairs, each as 8 bytes.
+//
+// The promoted index remains authoritative: the tree only tells which block to
+// read from it.
+class row_index_writer {
+    std::unique_ptr<file_writer> _out;
+    // Block starts of the current partition.
+    std::vector<bytes> _keys;
+    std::vector<std::pair<uint64_t, uint64_t>> _roots;
+private:
+    struct entry {
+        bytes_view key;
+        uint64_t value;
+    };
+    void pad_for(size_t node_size);
+    uint64_t write_node(bool leaf, std::span<const entry> entries);
+public:
+    // Partitions with fewer promoted index blocks are left out of the row index,
+    // as a binary search over their promoted index reads few pages.
+    static constexpr size_t min_blocks = 64;
+
+    explicit row_index_writer(std::unique_ptr<file_writer> out);
+    ~row_index_writer();
+
+    // Adds the start of the next promoted index block of the current partition,
+    // serialized as in the promoted index.
+    void add_block(bytes_view start) {
+        _keys.emplace_back(start.begin(), start.end());
+    }
+
+    // Writes the tree of the current partition, whose promoted index starts at
+    // promoted_index_start in Index.db, if it has enough blocks.
+    void end_partition(uint64_t promoted_index_start);
+
+    // Forgets the blocks of the current partition, without writing its tree.
+    void discard_partition() {
+        _keys.clear();
+    }
+
+    // Writes the table of roots and closes the file.
+    void finish();
+};
+
+// The row index of an sstable, read through a cached_file.
+class row_index {
+public:
+    struct stats {
+        // Searches of promoted index blocks which went through the row index.
+        uint64_t lookups = 0;
+    };
+private:
+    file _file;
+    seastar::shared_ptr<cached_file> _cached_file;
+    // Sorted by promoted index start.
+    std::vector<std::pair<uint64_t, uint64_t>> _roots;
+
+    static thread_local stats _shard_stats;
+
+    friend class row_index_cursor;
+public:
+    row_index(file f, uint64_t size, std::vector<std::pair<uint64_t, uint64_t>> roots, cached_file::metrics& metrics, cache_tracker& tracker);
+
+    // Opens the row index in Rows.db, which must be open as f.
+    static future<std::unique_ptr<row_index>> open(file f, cached_file::metrics& metrics, cache_tracker& tracker, const io_priority_class& pc);
+
+    // Returns the position of the root of the tree of the partition whose
+    // promoted index starts at promoted_index_start in Index.db, if it has one.
+    std::optional<uint64_t> find_root(uint64_t promoted_index_start) const;
+
+    seastar::shared_ptr<cached_file> get_cached_file() const {
+        return _cached_file;
+    }
+
+    future<> close() noexcept;
+
+    future<> evict_gently() {
+        return _cached_file->evict_gently();
+    }
+
+    static const stats& get_shard_stats() noexcept {
+        return _shard_stats;
+    }
+};
+
+// Searches the row index tree of a single partition.
+//
+// Designed for a single user. Methods must not be invoked concurrently.
+class row_index_cursor {
+public:
+    using pi_index_type = uint32_t;
+
+    struct upper_bound_info {
+        // Index of the first promoted index block whose start is greater than
+        // the position, or the number of blocks if there is none.
+        pi_index_type index;
+        // Start of that block, if the tree holds it next to the blocks before
+        // it. It is otherwise the first key of another leaf.
+        std::optional<position_in_partition> start;
+    };
+private:
+    const schema& _s;
+    seastar::shared_ptr<cached_file> _cached_file;
+    uint64_t _root;
+    const io_priority_class _pc;
+    reader_permit _permit;
+    clustering_parser _clustering_parser;
+    tracing::trace_state_ptr _trace_state;
+private:
+    future<temporary_buffer<char>> read(uint64_t pos, size_t size);
+    position_in_partition parse_key(temporary_buffer<char>& node, size_t offset);
+public:
+    row_index_cursor(const schema& s,
+            seastar::shared_ptr<cached_file> f,
+            uint64_t root,
+            io_priority_class pc,
+            reader_permit permit,
+            column_values_fixed_lengths cvfl,
+            tracing::trace_state_ptr trace_state);
+
+    // Finds the first promoted index block whose start is greater than pos.
+    future<upper_bound_info> upper_bound(position_in_partition_view pos);
+};
+
+}
@@ -18,6 +18,9 @@
 #include "mutation/atomic_cell.hh"
 #include "utils/exceptions.hh"
 #include "db/large_data_handler.hh"
+#include "utils/binary_fuse_filter.hh"
+#include "sstables/partition_trie.hh"
+#include "sstables/mx/row_index.hh"
 
 #include <functional>
 #include <boost/iterator/iterator_facade.hpp>
@@ -533,6 +536,10 @@ class writer : public sstable_writer::writer_impl {
     bool _compression_enabled = false;
     std::unique_ptr<file_writer> _data_writer;
     std::unique_ptr<file_writer> _index_writer;
+    std::unique_ptr<partition_trie_writer> _partition_trie_writer;
+    std::unique_ptr<row_index_writer> _row_index_writer;
+    // Used for serializing block starts for the row index
+    bytes_ostream _row_index_key;
     bool _tombstone_written = false;
     bool _static_row_written = false;
     // The length of partition header (partition key, partition deletion and static row, if present)
@@ -600,6 +607,22 @@ class writer : public sstable_writer::writer_impl {
     large_data_stats_entry _cell_size_entry;
     large_data_stats_entry _elements_in_collection_entry;
 
+    // Values of each regular column, for column_value_stats. Empty unless
+    // sstable_writer_config::column_value_stats is set.
+    struct column_value_tracker {
+        uint64_t values = 0;
+        bool bounded = true;
+        std::optional<bytes> min;
+        std::optional<bytes> max;
+    };
+    std::vector<column_value_tracker> _column_values;
+    uint64_t _column_value_rows = 0;
+    // Values larger than this leave their column unbounded.
+    static constexpr size_t max_tracked_column_value_size = 256;
+
+    void update_column_value_stats(const column_definition& cdef, atomic_cell_view cell);
+    scylla_metadata::column_value_stats make_column_value_stats();
+
     void init_file_writers();
 
     // Returns the closed writer
@@ -788,6 +811,15 @@ class writer : public sstable_writer::writer_impl {
         // exactly what callers used to do anyway.
         estimated_partitions = std::max(uint64_t(1), estimated_partitions);
 
+        if (_cfg.partition_trie_index) {
+            _sst._recognized_components.insert(component_type::Partitions);
+        }
+        if (_cfg.row_index) {
+            _sst._recognized_components.insert(component_type::Rows);
+        }
+        if (_cfg.column_value_stats) {
+            _column_values.resize(_schema.regular_columns_count());
+        }
         _sst.open_sstable(_pc);
         _sst.create_data().get();
         _compression_enabled = !_sst.has_component(component_type::CRC);
@@ -795,7 +827,12 @@ class writer : public sstable_writer::writer_impl {
         _sst._shards = { shard };
 
         _cfg.monitor->on_write_started(_data_writer->offset_tracker());
-        _sst._components->filter = utils::i_filter::get_filter(estimated_partitions, _schema.bloom_filter_fp_chance(), utils::filter_format::m_format);
+        auto layout = _cfg.blocked_bloom_filter ? utils::filter_layout::blocked : utils::filter_layout::classic;
+        if (_schema.filter_type() == sstable_filter_type::binary_fuse) {
+            _sst._components->filter = utils::i_filter::get_static_filter(estimated_partitions, _schema.bloom_filter_fp_chance(), layout);
+        } else {
+            _sst._components->filter = utils::i_filter::get_filter(estimated_partitions, _schema.bloom_filter_fp_chance(), utils::filter_format::m_format, layout);
+        }
         _pi_write_m.promoted_index_block_size = cfg.promoted_index_block_size;
         _pi_write_m.promoted_index_auto_scale_threshold = cfg.promoted_index_auto_scale_threshold;
         _index_sampling_state.summary_byte_cost = _cfg.summary_byte_cost;
@@ -874,7 +911,7 @@ void writer::maybe_add_pi_block() {
 }
 
 void writer::init_file_writers() {
-    auto out = _sst._storage->make_data_or_index_sink(_sst, component_type::Data, _pc).get0();
+    auto out = _sst._storage->make_data_or_index_sink(_sst, component_type::Data, _pc, _cfg).get0();
 
     if (!_compression_enabled) {
         _data_writer = std::make_unique<crc32_checksummed_file_writer>(std::move(out), _sst.sstable_buffer_size, _sst.filename(component_type::Data));
@@ -886,8 +923,22 @@ void writer::init_file_writers() {
                 _schema.get_compressor_params()), _sst.filename(component_type::Data));
     }
 
-    out = _sst._storage->make_data_or_index_sink(_sst, component_type::Index, _pc).get0();
+    out = _sst._storage->make_data_or_index_sink(_sst, component_type::Index, _pc, _cfg).get0();
     _index_writer = std::make_unique<file_writer>(output_stream<char>(std::move(out)), _sst.filename(component_type::Index));
+
+    if (_sst.has_component(component_type::Partitions)) {
+        file_output_stream_options options;
+        options.buffer_size = _sst.sstable_buffer_size;
+        auto w = _sst.make_component_file_writer(component_type::Partitions, std::move(options)).get0();
+        _partition_trie_writer = std::make_unique<partition_trie_writer>(std::make_unique<file_writer>(std::move(w)));
+    }
+
+    if (_sst.has_component(component_type::Rows)) {
+        file_output_stream_options options;
+        options.buffer_size = _sst.sstable_buffer_size;
+        auto w = _sst.make_component_file_writer(component_type::Rows, std::move(options)).get0();
+        _row_index_writer = std::make_unique<row_index_writer>(std::make_unique<file_writer>(std::move(w)));
+    }
 }
 
 std::unique_ptr<file_writer> writer::close_writer(std::unique_ptr<file_writer>& w) {
@@ -913,6 +964,9 @@ void writer::consume_new_partition(const dht::decorated_key& dk) {
 
     _partition_key = key::from_partition_key(_schema, dk.key());
     maybe_add_summary_entry(dk.token(), bytes_view(*_partition_key));
+    if (_partition_trie_writer) {
+        _partition_trie_writer->add(dk.token(), bytes_view(*_partition_key), _index_writer->offset());
+    }
 
     _sst._components->filter->add(bytes_view(*_partition_key));
     _collector.add_key(bytes_view(*_partition_key));
@@ -1147,7 +1201,9 @@ void writer::write_cells(bytes_ostream& writer, const clustering_key_prefix* clu
     // is compared with the set of all columns filled in the memtable. So our encoding may be less optimal in some cases
     // but still valid.
     write_missing_columns(writer, kind == column_kind::static_column ? _sst_schema.static_columns : _sst_schema.regular_columns, row_body);
-    row_body.for_each_cell([this, &writer, kind, &properties, clustering_key] (column_id id, const atomic_cell_or_collection& c) {
+    const bool track_values = kind == column_kind::regular_column && !_column_values.empty();
+    _column_value_rows += track_values;
+    row_body.for_each_cell([this, &writer, kind, &properties, clustering_key, track_values] (column_id id, const atomic_cell_or_collection& c) {
         auto&& column_definition = _schema.column_at(kind, id);
         if (!column_definition.is_atomic()) {
             _collections.push_back({&column_definition, c});
@@ -1157,6 +1213,9 @@ void writer::write_cells(bytes_ostream& writer, const clustering_key_prefix* clu
         ++_c_stats.cells_count;
         ++_c_stats.column_count;
         write_cell(writer, clustering_key, cell, column_definition, properties);
+        if (track_values) {
+            update_column_value_stats(column_definition, cell);
+        }
     });
 
     for (const auto& col: _collections) {
@@ -1165,6 +1224,50 @@ void writer::write_cells(bytes_ostream& writer, const clustering_key_prefix* clu
     _collections.clear();
 }
 
+void writer::update_column_value_stats(const column_definition& cdef, atomic_cell_view cell) {
+    if (cdef.is_counter() || !cell.is_live()) {
+        return;
+    }
+    auto& t = _column_values[cdef.id];
+    ++t.values;
+    if (!t.bounded) {
+        return;
+    }
+    auto value = cell.value();
+    if (value.size_bytes() > max_tracked_column_value_size) {
+        t.bounded = false;
+        t.min.reset();
+        t.max.reset();
+        return;
+    }
+    auto& type = cdef.type->without_reversed();
+    if (!t.min || type.compare(value, managed_bytes_view(bytes_view(*t.min))) < 0) {
+        t.min = to_bytes(value);
+    }
+    if (!t.max || type.compare(value, managed_bytes_view(bytes_view(*t.max))) > 0) {
+        t.max = to_bytes(value);
+    }
+}
+
+scylla_metadata::column_value_stats writer::make_column_value_stats() {
+    scylla_metadata::column_value_stats stats;
+    for (const auto& cdef : _schema.regular_columns()) {
+        if (!cdef.is_atomic() || cdef.is_counter()) {
+            continue;
+        }
+        auto& t = _column_values[cdef.id];
+        const bool bounded = t.bounded && t.values;
+        stats.map.emplace(disk_string<uint32_t>{cdef.name()}, column_value_stats{
+            .rows = _column_value_rows,
+            .values = t.values,
+            .bounded = bounded,
+            .min_value = {bounded ? std::move(*t.min) : bytes()},
+            .max_value = {bounded ? std::move(*t.max) : bytes()},
+        });
+    }
+    return stats;
+}
+
 void writer::write_row_body(bytes_ostream& writer, const clustering_row& row, bool has_complex_deletion) {
     write_liveness_info(writer, row.marker());
     auto write_tombstone_and_update_stats = [this, &writer] (const tombstone& t) {
@@ -1344,6 +1447,9 @@ void writer::write_promoted_index() {
     uint64_t pi_size = _tmp_bufs.size() + _pi_write_m.blocks.size() + _pi_write_m.offsets.size();
     write_vint(*_index_writer, pi_size);
     flush_tmp_bufs(*_index_writer);
+    if (_row_index_writer) {
+        _row_index_writer->end_partition(_index_writer->offset());
+    }
     write(_sst.get_version(), *_index_writer, _pi_write_m.blocks);
     write(_sst.get_version(), *_index_writer, _pi_write_m.offsets);
 }
@@ -1355,6 +1461,11 @@ void writer::write_pi_block(const pi_block& block) {
     write(_sst.get_version(), _pi_write_m.offsets, offset);
     write_clustering_prefix(_sst.get_version(), blocks, block.first.kind, _schema, block.first.clustering);
     write_clustering_prefix(_sst.get_version(), blocks, block.last.kind, _schema, block.last.clustering);
+    if (_row_index_writer) {
+        _row_index_key.clear();
+        write_clustering_prefix(_sst.get_version(), _row_index_key, block.first.kind, _schema, block.first.clustering);
+        _row_index_writer->add_block(_row_index_key.linearize());
+    }
     write_vint(blocks, block.offset);
     write_signed_vint(blocks, block.width - width_base);
     write(_sst.get_version(), blocks, static_cast<std::byte>(block.open_marker ? 1 : 0));
@@ -1448,6 +1559,14 @@ void writer::consume_end_of_stream() {
         _collector.add_compression_ratio(_sst._components->compression.compressed_file_length(), _sst._components->compression.uncompressed_file_length());
     }
 
+    if (_partition_trie_writer) {
+        _partition_trie_writer->finish(_index_writer->offset());
+        _partition_trie_writer.reset();
+    }
+    if (_row_index_writer) {
+        _row_index_writer->finish();
+        _row_index_writer.reset();
+    }
     close_writer(_index_writer);
     _sst.set_first_and_last_keys();
 
@@ -1457,10 +1576,19 @@ void writer::consume_end_of_stream() {
         _sst._schema, _sst.get_first_decorated_key(), _sst.get_last_decorated_key(), _enc_stats);
     close_data_writer();
     _sst.write_summary(_pc);
+    if (auto builder = dynamic_cast<utils::filter::static_filter_builder*>(_sst._components->filter.get())) {
+        _sst._components->filter = builder->seal();
+    }
     _sst.write_filter(_pc);
     _sst.write_statistics(_pc);
     _sst.write_compression(_pc);
     auto features = sstable_enabled_features::all();
+    if (!_cfg.blocked_bloom_filter) {
+        features.disable(sstable_feature::BlockedBloomFilter);
+    }
+    if (!dynamic_cast<const utils::filter::binary_fuse_filter*>(_sst._components->filter.get())) {
+        features.disable(sstable_feature::BinaryFuseFilter);
+    }
     run_identifier identifier{_run_identifier};
     std::optional<scylla_metadata::large_data_stats> ld_stats(scylla_metadata::large_data_stats{
         .map = {
@@ -1471,7 +1599,11 @@ void writer::consume_end_of_stream() {
             { large_data_type::elements_in_collection, std::move(_elements_in_collection_entry) },
         }
     });
-    _sst.write_scylla_metadata(_pc, _shard, std::move(features), std::move(identifier), std::move(ld_stats), _cfg.origin);
+    std::optional<scylla_metadata::column_value_stats> cv_stats;
+    if (!_column_values.empty()) {
+        cv_stats = make_column_value_stats();
+    }
+    _sst.write_scylla_metadata(_pc, _shard, std::move(features), std::move(identifier), std::move(ld_stats), _cfg.origin, std::move(cv_stats));
     _sst.seal_sstable(_cfg.backup).get();
 }
 
@@ -68,6 +68,10 @@ struct sstable_open_config {
     // filter, meaning that the SSTable will be opened on every single-partition
     // read.
     bool load_bloom_filter = true;
+    // If set, the bloom filter is not read when the SSTable is loaded and an
+    // always-present filter is used until sstable::load_deferred_filter() is
+    // called. Filters of SSTables shared between shards are never deferred.
+    bool defer_bloom_filter = false;
 };
 
 }
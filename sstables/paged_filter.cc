@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "sstables/paged_filter.hh"
+#include "sstables/exceptions.hh"
+#include "utils/bloom_filter.hh"
+#include "log.hh"
+
+#include <seastar/core/byteorder.hh>
+
+namespace sstables {
+
+extern logging::logger sstlog;
+
+thread_local paged_bloom_filter::stats paged_bloom_filter::_shard_stats;
+
+paged_bloom_filter::paged_bloom_filter(file f, uint64_t file_size, int hash_count, uint64_t nr_words, utils::filter_format fformat, utils::filter_layout layout,
+        cached_file::metrics& metrics, cache_tracker& tracker, const io_priority_class& pc)
+    : _file(std::move(f))
+    , _cached_file(seastar::make_shared<cached_file>(_file, metrics, tracker.get_lru(), tracker.region(), file_size))
+    , _hash_count(hash_count)
+    , _nr_bits(nr_words * 64)
+    , _format(fformat)
+    , _layout(layout)
+    , _pc(pc)
+{
+}
+
+future<std::unique_ptr<paged_bloom_filter>> paged_bloom_filter::open(file f, utils::filter_format fformat, utils::filter_layout layout,
+        cached_file::metrics& metrics, cache_tracker& tracker, const io_priority_class& pc) {
+    auto size = co_await f.size();
+    auto header = co_await f.dma_read_exactly<char>(0, header_size, pc);
+    auto hash_count = read_be<uint32_t>(header.get());
+    auto nr_words = read_be<uint32_t>(header.get() + 4);
+    if (size != header_size + nr_words * sizeof(uint64_t)) {
+        throw malformed_sstable_exception(format("Filter.db has {} bytes, expected {} for {} words", size, header_size + nr_words * sizeof(uint64_t), nr_words));
+    }
+    if (layout == utils::filter_layout::blocked && nr_words % utils::filter::blocked_bloom_filter::words_per_block) {
+        throw malformed_sstable_exception(format("Blocked bloom filter of {} words is not made of whole blocks", nr_words));
+    }
+    co_return std::make_unique<paged_bloom_filter>(std::move(f), size, hash_count, nr_words, fformat, layout, metrics, tracker, pc);
+}
+
+void paged_bloom_filter::load_page(cached_file::page_idx_type idx) noexcept {
+    if (_loads.is_closed() || _loading.contains(idx)) {
+        return;
+    }
+    try {
+        _loading.insert(idx);
+        // Missing bits are treated as set, so failing to load a page only
+        // makes the filter less selective.
+        (void)with_gate(_loads, [this, idx] {
+            return _cached_file->populate(idx, _pc).handle_exception([this, idx] (std::exception_ptr ep) {
+                sstlog.debug("Failed to read page {} of a bloom filter: {}", idx, ep);
+            }).finally([this, idx] {
+                _loading.erase(idx);
+            });
+        });
+    } catch (...) {
+        _loading.erase(idx);
+    }
+}
+
+std::optional<uint64_t> paged_bloom_filter::get_word(uint64_t idx) noexcept {
+    auto offset = header_size + idx * sizeof(uint64_t);
+    auto page = offset / cached_file::page_size;
+    // Words never straddle pages, as both the header and the page size are
+    // multiples of the word size.
+    if (auto p = _cached_file->get_page_if_cached(page)) {
+        return read_be<uint64_t>(p + offset % cached_file::page_size);
+    }
+    load_page(page);
+    return std::nullopt;
+}
+
+bool paged_bloom_filter::is_present(utils::hashed_key key) {
+    bool complete = true;
+    bool present = true;
+    if (_layout == utils::filter_layout::blocked) {
+        using utils::filter::blocked_bloom_filter;
+        auto [block, masks] = blocked_bloom_filter::locate_in_block(key, _hash_count, _nr_bits / blocked_bloom_filter::bits_per_block);
+        for (size_t i = 0; i < blocked_bloom_filter::words_per_block && present; ++i) {
+            if (!masks[i]) {
+                continue;
+            }
+            auto word = get_word(block * blocked_bloom_filter::words_per_block + i);
+            if (!word) {
+                complete = false;
+                continue;
+            }
+            present = !(masks[i] & ~*word);
+        }
+    } else {
+        utils::filter::for_each_index(key, _hash_count, _nr_bits, _format, [&] (auto i) {
+            auto word = get_word(i / 64);
+            if (!word) {
+                complete = false;
+                return stop_iteration::no;
+            }
+            present = (*word >> (i % 64)) & 1;
+            return stop_iteration(!present);
+        });
+    }
+    ++(present && !complete ? _shard_stats.incomplete_lookups : _shard_stats.complete_lookups);
+    return present;
+}
+
+bool paged_bloom_filter::is_present(const bytes_view& key) {
+    return is_present(utils::make_hashed_key(key));
+}
+
+void paged_bloom_filter::add(const bytes_view& key) {
+    throw std::logic_error("Keys cannot be added to a bloom filter read from disk");
+}
+
+void paged_bloom_filter::clear() {
+    throw std::logic_error("A bloom filter read from disk cannot be cleared");
+}
+
+future<> paged_bloom_filter::close_gently() noexcept {
+    co_await _loads.close();
+    try {
+        co_await _file.close();
+    } catch (...) {
+        sstlog.warn("Failed to close bloom filter file: {}", std::current_exception());
+    }
+    co_await _cached_file->evict_gently();
+}
+
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include "utils/i_filter.hh"
+#include "utils/cached_file.hh"
+#include "db/cache_tracker.hh"
+
+#include <seastar/core/gate.hh>
+#include <unordered_set>
+
+namespace sstables {
+
+extern thread_local cached_file::metrics filter_page_cache_metrics;
+
+// A bloom filter read from Filter.db through a cached_file, instead of being
+// held in memory in full. Its pages live in the cache_tracker's region and
+// LRU, so they are evicted under memory pressure, in competition with the row
+// cache.
+//
+// Lookups are synchronous, so they can't wait for pages to be read. A lookup
+// only tests the bits it finds in cached pages, and treats the other ones as
+// set, which can't cause a false negative. The missing pages are read in the
+// background, for the lookups that follow.
+//
+// Both the classic and the blocked layouts are supported.
+//
+// The filter is shard-local: it must not be used by sstables shared between
+// shards.
+class paged_bloom_filter : public utils::i_filter {
+public:
+    // The hash count and the word count preceding the bits in Filter.db.
+    static constexpr size_t header_size = 8;
+
+    struct stats {
+        // Lookups answered from cached pages.
+        uint64_t complete_lookups = 0;
+        // Lookups which found the key present only because they skipped
+        // bits of pages which weren't cached.
+        uint64_t incomplete_lookups = 0;
+    };
+private:
+    file _file;
+    seastar::shared_ptr<cached_file> _cached_file;
+    int _hash_count;
+    uint64_t _nr_bits;
+    utils::filter_format _format;
+    utils::filter_layout _layout;
+    const io_priority_class& _pc;
+    // Pages being read in the background.
+    std::unordered_set<cached_file::page_idx_type> _loading;
+    seastar::gate _loads;
+
+    static thread_local stats _shard_stats;
+private:
+    // Returns the word with the given index, or std::nullopt after starting
+    // to load it when its page isn't cached.
+    std::optional<uint64_t> get_word(uint64_t idx) noexcept;
+    void load_page(cached_file::page_idx_type idx) noexcept;
+public:
+    paged_bloom_filter(file f, uint64_t file_size, int hash_count, uint64_t nr_words, utils::filter_format fformat, utils::filter_layout layout,
+            cached_file::metrics& metrics, cache_tracker& tracker, const io_priority_class& pc);
+
+    // Opens the filter in Filter.db, which must be open as f.
+    static future<std::unique_ptr<paged_bloom_filter>> open(file f, utils::filter_format fformat, utils::filter_layout layout,
+            cached_file::metrics& metrics, cache_tracker& tracker, const io_priority_class& pc);
+
+    virtual void add(const bytes_view& key) override;
+
+    virtual bool is_present(const bytes_view& key) override;
+
+    virtual bool is_present(utils::hashed_key key) override;
+
+    virtual void clear() override;
+
+    virtual void close() override { }
+
+    // Only the pages which are cached, and accounted by the cache_tracker, use memory.
+    virtual size_t memory_size() override {
+        return sizeof(*this);
+    }
+
+    size_t cached_bytes() const noexcept {
+        return _cached_file->cached_bytes();
+    }
+
+    // Waits for background reads, closes the file and evicts the cached pages.
+    future<> close_gently() noexcept;
+
+    static const stats& get_shard_stats() noexcept {
+        return _shard_stats;
+    }
+};
+
+}
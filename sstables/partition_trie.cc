@@ -0,0 +1,285 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "sstables/partition_trie.hh"
+#include "sstables/writer.hh"
+#include "sstables/exceptions.hh"
+#include "log.hh"
+
+#include <seastar/core/byteorder.hh>
+#include <seastar/core/coroutine.hh>
+
+#include <algorithm>
+
+namespace sstables {
+
+extern logging::logger sstlog;
+
+thread_local partition_trie::stats partition_trie::_shard_stats;
+
+namespace {
+
+constexpr size_t footer_size = sizeof(uint64_t);
+
+// Returns log2 of the number of bytes needed to store v.
+unsigned width_code(uint64_t v) {
+    return v <= 0xff ? 0 : v <= 0xffff ? 1 : v <= 0xffffffff ? 2 : 3;
+}
+
+char* put_be(char* p, uint64_t v, size_t width) {
+    for (size_t i = width; i > 0; --i) {
+        p[i - 1] = char(v & 0xff);
+        v >>= 8;
+    }
+    return p + width;
+}
+
+uint64_t get_be(const char* p, size_t width) {
+    uint64_t v = 0;
+    for (size_t i = 0; i < width; ++i) {
+        v = (v << 8) | uint8_t(p[i]);
+    }
+    return v;
+}
+
+size_t common_prefix(bytes_view a, bytes_view b) {
+    return std::mismatch(a.begin(), a.begin() + std::min(a.size(), b.size()), b.begin()).first - a.begin();
+}
+
+}
+
+partition_trie_writer::partition_trie_writer(std::unique_ptr<file_writer> out)
+    : _out(std::move(out))
+{
+    _path.emplace_back();
+}
+
+partition_trie_writer::~partition_trie_writer() = default;
+
+uint64_t partition_trie_writer::write_node(const node& n) {
+    auto pos = _out->offset();
+    uint8_t flags = 0;
+    size_t size = 1;
+    unsigned offset_code = 0;
+    unsigned size_code = 0;
+    if (n.payload) {
+        offset_code = width_code(n.payload->index_offset);
+        size_code = width_code(n.payload->index_entry_size);
+        flags |= 1 | (offset_code << 4) | (size_code << 6);
+        size += (1 << offset_code) + (1 << size_code);
+    }
+    unsigned ptr_code = 0;
+    if (!n.children.empty()) {
+        // Children were written before their parent, in increasing order.
+        ptr_code = width_code(pos - n.children.front().second);
+        flags |= 2 | (ptr_code << 2);
+        size += 1 + n.children.size() * (1 + (1 << ptr_code));
+    }
+    bytes buf(bytes::initialized_later(), size);
+    auto p = reinterpret_cast<char*>(buf.data());
+    *p++ = char(flags);
+    if (!n.children.empty()) {
+        *p++ = char(n.children.size() - 1);
+    }
+    if (n.payload) {
+        p = put_be(p, n.payload->index_offset, 1 << offset_code);
+        p = put_be(p, n.payload->index_entry_size, 1 << size_code);
+    }
+    for (auto& [label, child] : n.children) {
+        *p++ = char(label);
+    }
+    for (auto& [label, child] : n.children) {
+        p = put_be(p, pos - child, 1 << ptr_code);
+    }
+    _out->write(buf);
+    return pos;
+}
+
+void partition_trie_writer::pop() {
+    auto n = std::move(_path.back());
+    _path.pop_back();
+    auto pos = write_node(n);
+    _path.back().children.emplace_back(n.label, pos);
+}
+
+void partition_trie_writer::insert(bytes_view prefix, partition_trie_payload payload) {
+    // Prefixes come in increasing order, and none is a prefix of the previous one,
+    // so the nodes past the common part of the path are complete.
+    auto common = common_prefix(prefix, _last_prefix);
+    while (_path.size() > common + 1) {
+        pop();
+    }
+    for (size_t i = common; i < prefix.size(); ++i) {
+        _path.push_back(node{uint8_t(prefix[i])});
+    }
+    _path.back().payload = payload;
+    _last_prefix = bytes(prefix.data(), prefix.size());
+}
+
+void partition_trie_writer::add_sorted(bytes key, partition_trie_payload payload) {
+    if (_has_pending) {
+        auto common = common_prefix(_pending_key, key);
+        auto unique = std::min(_pending_key.size(), std::max(_pending_common_prefix, common) + 1);
+        insert(bytes_view(_pending_key).substr(0, unique), _pending_payload);
+        _pending_common_prefix = common;
+    }
+    _pending_key = std::move(key);
+    _pending_payload = payload;
+    _has_pending = true;
+}
+
+void partition_trie_writer::flush_token_group(uint64_t next_entry_start) {
+    if (_token_group.empty()) {
+        return;
+    }
+    std::vector<std::pair<bytes, partition_trie_payload>> entries;
+    entries.reserve(_token_group.size());
+    for (size_t i = 0; i < _token_group.size(); ++i) {
+        auto end = i + 1 < _token_group.size() ? _token_group[i + 1].second : next_entry_start;
+        auto offset = _token_group[i].second;
+        entries.emplace_back(std::move(_token_group[i].first), partition_trie_payload{offset, end - offset});
+    }
+    _token_group.clear();
+    if (entries.size() > 1) {
+        std::sort(entries.begin(), entries.end(), [] (const auto& a, const auto& b) {
+            return compare_unsigned(a.first, b.first) < 0;
+        });
+    }
+    for (auto& [key, payload] : entries) {
+        add_sorted(std::move(key), payload);
+    }
+}
+
+void partition_trie_writer::add(const dht::token& token, bytes_view key, uint64_t index_offset) {
+    if (!_token_group.empty() && token != _group_token) {
+        flush_token_group(index_offset);
+    }
+    _group_token = token;
+    _token_group.emplace_back(partition_trie::make_key(token, key), index_offset);
+}
+
+void partition_trie_writer::finish(uint64_t index_size) {
+    flush_token_group(index_size);
+    if (_has_pending) {
+        auto unique = std::min(_pending_key.size(), _pending_common_prefix + 1);
+        insert(bytes_view(_pending_key).substr(0, unique), _pending_payload);
+        _has_pending = false;
+    }
+    while (_path.size() > 1) {
+        pop();
+    }
+    auto root = write_node(_path.back());
+    _path.clear();
+    char footer[footer_size];
+    put_be(footer, root, footer_size);
+    _out->write(footer, footer_size);
+    _out->close();
+}
+
+bytes partition_trie::make_key(const dht::token& token, bytes_view key) {
+    bytes result(bytes::initialized_later(), sizeof(uint64_t) + key.size());
+    write_be(reinterpret_cast<char*>(result.data()), dht::unbias(token));
+    std::copy(key.begin(), key.end(), result.begin() + sizeof(uint64_t));
+    return result;
+}
+
+partition_trie::partition_trie(file f, uint64_t size, uint64_t root, cached_file::metrics& metrics, cache_tracker& tracker)
+    : _file(std::move(f))
+    , _cached_file(seastar::make_shared<cached_file>(_file, metrics, tracker.get_lru(), tracker.region(), size))
+    , _root(root)
+{
+}
+
+future<std::unique_ptr<partition_trie>> partition_trie::open(file f, cached_file::metrics& metrics, cache_tracker& tracker, const io_priority_class& pc) {
+    auto size = co_await f.size();
+    if (size <= footer_size) {
+        throw malformed_sstable_exception(format("Partitions.db is too short: {} bytes", size));
+    }
+    auto footer = co_await f.dma_read_exactly<char>(size - footer_size, footer_size, pc);
+    auto root = read_be<uint64_t>(footer.get());
+    if (root >= size - footer_size) {
+        throw malformed_sstable_exception(format("Partitions.db root at {} is past the end of its {} bytes", root, size));
+    }
+    co_return std::make_unique<partition_trie>(std::move(f), size, root, metrics, tracker);
+}
+
+future<temporary_buffer<char>> partition_trie::read(uint64_t pos, size_t size, const io_priority_class& pc, tracing::trace_state_ptr trace_state) {
+    auto s = _cached_file->read(pos, pc, std::nullopt, std::move(trace_state), size);
+    auto buf = co_await s.next();
+    if (buf.size() >= size) {
+        buf.trim(size);
+        co_return buf;
+    }
+    // The node straddles pages.
+    temporary_buffer<char> result(size);
+    size_t copied = 0;
+    while (copied < size) {
+        if (buf.empty()) {
+            throw malformed_sstable_exception(format("Partitions.db node at {} of {} bytes is past the end of the file", pos, size));
+        }
+        auto n = std::min(buf.size(), size - copied);
+        std::copy_n(buf.get(), n, result.get_write() + copied);
+        copied += n;
+        if (copied < size) {
+            buf = co_await s.next();
+        }
+    }
+    co_return result;
+}
+
+future<std::optional<partition_trie_payload>> partition_trie::lookup(const dht::token& token, bytes_view key,
+        const io_priority_class& pc, tracing::trace_state_ptr trace_state) {
+    auto k = make_key(token, key);
+    auto pos = _root;
+    for (size_t depth = 0;; ++depth) {
+        // Every node is followed by at least the footer, so its first two bytes can be read.
+        auto header = co_await read(pos, 2, pc, trace_state);
+        auto flags = uint8_t(header[0]);
+        bool has_payload = flags & 1;
+        bool has_children = flags & 2;
+        size_t ptr_width = size_t(1) << ((flags >> 2) & 3);
+        size_t offset_width = size_t(1) << ((flags >> 4) & 3);
+        size_t size_width = size_t(1) << ((flags >> 6) & 3);
+        size_t nr_children = has_children ? uint8_t(header[1]) + 1 : 0;
+        size_t node_size = 1 + has_children + (has_payload ? offset_width + size_width : 0) + nr_children * (1 + ptr_width);
+        auto node = node_size <= header.size() ? std::move(header) : co_await read(pos, node_size, pc, trace_state);
+
+        const char* p = node.get() + 1 + has_children;
+        std::optional<partition_trie_payload> payload;
+        if (has_payload) {
+            payload = partition_trie_payload{get_be(p, offset_width), get_be(p + offset_width, size_width)};
+            p += offset_width + size_width;
+        }
+        // Past the end of the unique prefix of a key, the rest of the key isn't stored.
+        if (!has_children || depth == k.size()) {
+            ++(payload ? _shard_stats.hits : _shard_stats.misses);
+            co_return payload;
+        }
+        auto labels = reinterpret_cast<const uint8_t*>(p);
+        auto label = std::lower_bound(labels, labels + nr_children, uint8_t(k[depth]));
+        if (label == labels + nr_children || *label != uint8_t(k[depth])) {
+            ++_shard_stats.misses;
+            co_return std::nullopt;
+        }
+        auto distance = get_be(p + nr_children + (label - labels) * ptr_width, ptr_width);
+        if (distance == 0 || distance > pos) {
+            throw malformed_sstable_exception(format("Partitions.db node at {} points to a child {} bytes before it", pos, distance));
+        }
+        pos -= distance;
+    }
+}
+
+future<> partition_trie::close() noexcept {
+    try {
+        co_await _file.close();
+    } catch (...) {
+        sstlog.warn("Failed to close partition trie file: {}", std::current_exception());
+    }
+}
+
+}
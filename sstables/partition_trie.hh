@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include "dht/token.hh"
+#include "bytes.hh"
+#include "utils/cached_file.hh"
+#include "db/cache_tracker.hh"
+#include "tracing/trace_state.hh"
+
+#include <optional>
+#include <vector>
+
+namespace sstables {
+
+class file_writer;
+
+// The partition trie (Partitions.db) maps partition keys to their entries in
+// Index.db, so that a point lookup finds its index entry by walking a few
+// small nodes instead of parsing a whole summary page of Index.db.
+//
+// The trie is keyed by the byte-comparable form of the partition's position:
+// the big-endian, unbiased token followed by the key as serialized in Index.db.
+// Only the shortest prefix which tells a key apart from its neighbours is
+// stored, so a key found in the trie may still be absent from the sstable, and
+// its index entry must be checked. A key which isn't found is absent.
+//
+// Nodes are written children first, followed by the root, and by the offset
+// of the root in the last 8 bytes of the file. Each node is made of:
+//
+//   flags (1 byte):
+//     bit 0: the node holds an index entry
+//     bit 1: the node has children
+//     bits 2-3: log2 of the width of child pointers
+//     bits 4-5: log2 of the width of the index entry offset
+//     bits 6-7: log2 of the width of the index entry size
+//   number of children minus one (1 byte), if the node has children
+//   offset and size of the index entry (big-endian), if the node holds one
+//   the byte labelling each child's transition, in increasing order
+//   the distance back from the node to each child (big-endian)
+struct partition_trie_payload {
+    uint64_t index_offset;
+    uint64_t index_entry_size;
+};
+
+// Builds the partition trie of an sstable as its partitions are written.
+// Must be used in a seastar thread.
+class partition_trie_writer {
+    struct node {
+        uint8_t label;
+        std::optional<partition_trie_payload> payload;
+        std::vector<std::pair<uint8_t, uint64_t>> children;
+    };
+
+    std::unique_ptr<file_writer> _out;
+    // The nodes on the path to the last inserted prefix, from the root.
+    std::vector<node> _path;
+    bytes _last_prefix;
+    // The last key added, which is inserted once the key following it is
+    // known, as its unique prefix depends on both of its neighbours.
+    bytes _pending_key;
+    partition_trie_payload _pending_payload;
+    size_t _pending_common_prefix = 0;
+    bool _has_pending = false;
+    // Keys of the same token may not come in byte order, so they are sorted
+    // before being added.
+    std::vector<std::pair<bytes, uint64_t>> _token_group;
+    dht::token _group_token;
+private:
+    void flush_token_group(uint64_t next_entry_start);
+    void add_sorted(bytes key, partition_trie_payload payload);
+    void insert(bytes_view prefix, partition_trie_payload payload);
+    void pop();
+    uint64_t write_node(const node& n);
+public:
+    explicit partition_trie_writer(std::unique_ptr<file_writer> out);
+    ~partition_trie_writer();
+
+    // Adds the partition whose index entry starts at index_offset.
+    // Must be called in the order of partitions in the sstable, with the
+    // index entries laid out contiguously.
+    void add(const dht::token& token, bytes_view key, uint64_t index_offset);
+
+    // Completes the trie, given the size of Index.db, and closes the file.
+    void finish(uint64_t index_size);
+};
+
+// Lookups in the partition trie of an sstable, read through a cached_file.
+class partition_trie {
+public:
+    struct stats {
+        // Lookups which found an index entry the key may be in.
+        uint64_t hits = 0;
+        // Lookups which found the key absent without reading Index.db.
+        uint64_t misses = 0;
+    };
+private:
+    file _file;
+    seastar::shared_ptr<cached_file> _cached_file;
+    uint64_t _root;
+
+    static thread_local stats _shard_stats;
+private:
+    future<temporary_buffer<char>> read(uint64_t pos, size_t size, const io_priority_class& pc, tracing::trace_state_ptr trace_state);
+public:
+    partition_trie(file f, uint64_t size, uint64_t root, cached_file::metrics& metrics, cache_tracker& tracker);
+
+    // Opens the trie in Partitions.db, which must be open as f.
+    static future<std::unique_ptr<partition_trie>> open(file f, cached_file::metrics& metrics, cache_tracker& tracker, const io_priority_class& pc);
+
+    static bytes make_key(const dht::token& token, bytes_view key);
+
+    // Returns the index entry which holds the given key if the sstable
+    // contains it, or std::nullopt if the sstable doesn't.
+    future<std::optional<partition_trie_payload>> lookup(const dht::token& token, bytes_view key,
+            const io_priority_class& pc, tracing::trace_state_ptr trace_state = {});
+
+    future<> close() noexcept;
+
+    future<> evict_gently() {
+        return _cached_file->evict_gently();
+    }
+
+    static const stats& get_shard_stats() noexcept {
+        return _shard_stats;
+    }
+};
+
+}
@@ -0,0 +1,31 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include "dht/i_partitioner.hh"
+
+namespace sstables {
+
+// Where an sstable reader left off, saved in its permit when the reader is
+// closed in the middle of a partition of a range scan.
+//
+// When the read recreates the reader of the same sstable, starting from that
+// partition and with the same range end, as the evictable reader does after
+// the read was evicted, the new reader seeks straight to the saved data file
+// positions instead of looking both bounds up in the index.
+struct resume_hint {
+    dht::decorated_key partition;
+    // Data file position of the start of the partition.
+    uint64_t partition_start;
+    // End bound of the range that was read and the matching data file position.
+    std::optional<dht::partition_range::bound> range_end_bound;
+    uint64_t range_end;
+};
+
+} // namespace sstables
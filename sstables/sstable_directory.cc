@@ -8,6 +8,9 @@
 
 #include <type_traits>
 #include <seastar/core/coroutine.hh>
+#include <seastar/core/fstream.hh>
+#include <seastar/core/seastar.hh>
+#include <seastar/coroutine/maybe_yield.hh>
 #include <seastar/coroutine/parallel_for_each.hh>
 #include <seastar/util/file.hh>
 #include <boost/range/adaptor/map.hpp>
@@ -163,6 +166,17 @@ future<foreign_sstable_open_info> sstable_directory::get_open_info_for_this_ssta
 
 future<>
 sstable_directory::sort_sstable(sstables::entry_descriptor desc, process_flags flags) {
+    if (auto it = _owned_by_manifest.find(desc.generation); it != _owned_by_manifest.end()
+            && it->second.version == desc.version && it->second.format == desc.format) {
+        auto sst = co_await load_sstable(desc, flags);
+        if (sst->get_shards_for_this_sstable() == std::vector<shard_id>{this_shard_id()}) {
+            dirlog.trace("{} identified as a local unshared SSTable by the owners manifest", sstable_filename(desc));
+            _unshared_local_sstables.push_back(std::move(sst));
+            co_return;
+        }
+        dirlog.warn("{} is not owned by this shard alone, unlike the owners manifest says", sstable_filename(desc));
+    }
+
     auto shards = co_await get_shards_for_this_sstable(desc, flags);
     if (shards.size() == 1) {
         if (shards[0] == this_shard_id()) {
@@ -178,6 +192,71 @@ sstable_directory::sort_sstable(sstables::entry_descriptor desc, process_flags f
     }
 }
 
+future<> sstable_directory::read_owners_manifest(fs::path filename) {
+    try {
+        auto buf = co_await seastar::util::read_entire_file_contiguous(filename);
+        std::vector<sstring> lines;
+        boost::split(lines, buf, boost::is_any_of("\n"), boost::token_compress_on);
+        // The first line holds the shard count and ignore-msb bits the owners were computed with.
+        auto& sharder = _schema->get_sharder();
+        if (lines.empty() || lines[0] != format("{} {}", sharder.shard_count(), sharder.sharding_ignore_msb())) {
+            dirlog.info("Ignoring owners manifest {}, written with a different sharding", filename);
+            co_return;
+        }
+        for (size_t i = 1; i < lines.size(); ++i) {
+            std::vector<sstring> fields;
+            boost::split(fields, lines[i], boost::is_any_of(" "));
+            if (fields.size() != 2 || fields[1] != format("{}", this_shard_id())) {
+                continue;
+            }
+            auto desc = sstables::entry_descriptor::make_descriptor(_sstable_dir.native(), fields[0]);
+            _owned_by_manifest.insert_or_assign(desc.generation, manifest_entry{desc.version, desc.format});
+            co_await coroutine::maybe_yield();
+        }
+    } catch (...) {
+        dirlog.warn("Ignoring owners manifest {}: {}", filename, std::current_exception());
+    }
+}
+
+future<> sstable_directory::write_owners_manifests(const std::vector<shared_sstable>& sstables) {
+    std::map<sstring, sstring> manifests;
+    for (auto& sst : sstables) {
+        if (sst->_storage->is_remote() || sst->get_shards_for_this_sstable() != std::vector<shard_id>{this_shard_id()}) {
+            continue;
+        }
+        auto& manifest = manifests[sst->_storage->prefix()];
+        if (manifest.empty()) {
+            auto& sharder = sst->get_schema()->get_sharder();
+            manifest = format("{} {}\n", sharder.shard_count(), sharder.sharding_ignore_msb());
+        }
+        manifest += format("{} {}\n", sst->component_basename(component_type::TOC), this_shard_id());
+        co_await coroutine::maybe_yield();
+    }
+    for (auto& [dir, manifest] : manifests) {
+        auto file = fs::path(dir) / format("{}{}", owners_manifest_prefix, this_shard_id());
+        auto tmp_file = fs::path(file.native() + ".tmp");
+        try {
+            auto f = co_await open_file_dma(tmp_file.native(), open_flags::wo | open_flags::create | open_flags::truncate);
+            auto out = co_await make_file_output_stream(std::move(f));
+            std::exception_ptr ex;
+            try {
+                co_await out.write(manifest.data(), manifest.size());
+                co_await out.flush();
+            } catch (...) {
+                ex = std::current_exception();
+            }
+            co_await out.close();
+            if (ex) {
+                std::rethrow_exception(std::move(ex));
+            }
+            co_await rename_file(tmp_file.native(), file.native());
+            co_await sync_directory(dir);
+        } catch (...) {
+            dirlog.warn("Failed to write owners manifest {}: {}", file, std::current_exception());
+        }
+    }
+}
+
 sstring sstable_directory::sstable_filename(const sstables::entry_descriptor& desc) const {
     return sstable::filename(_sstable_dir.native(), _schema->ks_name(), _schema->cf_name(), desc.version, desc.generation, desc.format, component_type::Data);
 }
@@ -217,6 +296,11 @@ future<> sstable_directory::filesystem_components_lister::process(sstable_direct
             if (name == "") {
                 break;
             }
+            if (std::string_view(name).starts_with(owners_manifest_prefix)) {
+                // Left-overs of an interrupted write are removed too.
+                _state->owners_manifests.push_back(location / name);
+                continue;
+            }
             auto comps = sstables::entry_descriptor::make_descriptor(location.native(), name);
             handle(std::move(comps), location / name);
         }
@@ -245,6 +329,16 @@ future<> sstable_directory::filesystem_components_lister::process(sstable_direct
         _state->descriptors.erase(desc.generation);
     }
 
+    for (auto& path : _state->owners_manifests) {
+        if (path.extension() != ".tmp") {
+            co_await directory.read_owners_manifest(path);
+        }
+        // Every shard lists the same manifests.
+        if (this_shard_id() == 0) {
+            _state->files_for_removal.insert(path.native());
+        }
+    }
+
     auto msg = format("After {} scanned, {} descriptors found, {} different files found",
             location, _state->descriptors.size(), _state->generations_found.size());
 
@@ -84,6 +84,8 @@ class sstable_directory {
             scan_multimap generations_found;
             scan_descriptors temp_toc_found;
             scan_descriptors_map descriptors;
+            // Owners manifests found in the directory, see sstable_directory::write_owners_manifests().
+            std::vector<fs::path> owners_manifests;
 
             // SSTable files to be deleted: things with a Temporary TOC, missing TOC files,
             // TemporaryStatistics, etc. Not part of the scan state, because we want to do a 2-phase
@@ -153,7 +155,16 @@ class sstable_directory {
     sstable_open_info_vector _shared_sstable_info;
 
     std::vector<sstables::shared_sstable> _unsorted_sstables;
+
+    // Shard which owned an sstable at the last shutdown, by generation, as read from
+    // the owners manifests of the directory. Only sstables owned by this shard are kept.
+    struct manifest_entry {
+        sstables::sstable_version_types version;
+        sstables::sstable_format_types format;
+    };
+    std::unordered_map<generation_type, manifest_entry> _owned_by_manifest;
 private:
+    future<> read_owners_manifest(fs::path filename);
     future<> process_descriptor(sstables::entry_descriptor desc, process_flags flags);
     void validate(sstables::shared_sstable sst, process_flags flags) const;
     future<sstables::shared_sstable> load_sstable(sstables::entry_descriptor desc, sstables::sstable_open_config cfg = {}) const;
@@ -191,6 +202,14 @@ class sstable_directory {
     // moves unshared SSTables that don't belong to this shard to the right shards.
     future<> move_foreign_sstables(sharded<sstable_directory>& source_directory);
 
+    // At shutdown, each shard saves the list of the sstables it owns alone to a file
+    // in their directory, the owners manifest. process_sstable_dir() can then load them
+    // on this shard without reading their metadata first to compute their owners.
+    // The manifests are removed by commit_directory_changes(), before the directory
+    // changes. An sstable whose owners turn out to differ is sorted as usual.
+    static constexpr std::string_view owners_manifest_prefix = "sstable-owners-";
+    static future<> write_owners_manifests(const std::vector<shared_sstable>& sstables);
+
     // returns what is the highest generation seen in this directory.
     std::optional<generation_type> highest_generation_seen() const;
 
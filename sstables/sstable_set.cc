@@ -19,6 +19,7 @@
 #include "compaction/compaction_strategy_impl.hh"
 #include "compaction/leveled_compaction_strategy.hh"
 #include "compaction/time_window_compaction_strategy.hh"
+#include "compaction/incremental_compaction_strategy.hh"
 
 #include "sstable_set_impl.hh"
 
@@ -142,6 +143,16 @@ sstable_set::select(const dht::partition_range& range) const {
     return _impl->select(range);
 }
 
+size_t
+sstable_set::count(const dht::partition_range& range) const {
+    return _impl->count(range);
+}
+
+size_t
+sstable_set_impl::count(const dht::partition_range& range) const {
+    return select(range).size();
+}
+
 std::vector<sstable_run>
 sstable_set::select_sstable_runs(const std::vector<shared_sstable>& sstables) const {
     return _impl->select_sstable_runs(sstables);
@@ -318,6 +329,19 @@ std::vector<shared_sstable> partitioned_sstable_set::select(const dht::partition
     return r;
 }
 
+size_t partitioned_sstable_set::count(const dht::partition_range& range) const {
+    auto [b, e] = query(range);
+    if (b == e) {
+        return _unleveled_sstables.size();
+    }
+    // An sstable may span several intervals, so they have to be deduplicated,
+    // unless there is a single one, which is the common case for single partition ranges.
+    if (std::next(b) != e) {
+        return select(range).size();
+    }
+    return _unleveled_sstables.size() + b->second.size();
+}
+
 lw_shared_ptr<const sstable_list> partitioned_sstable_set::all() const {
     return _all;
 }
@@ -454,6 +478,10 @@ std::vector<shared_sstable> time_series_sstable_set::select(const dht::partition
     return boost::copy_range<std::vector<shared_sstable>>(*_sstables | boost::adaptors::map_values);
 }
 
+size_t time_series_sstable_set::count(const dht::partition_range& range) const {
+    return _sstables->size();
+}
+
 lw_shared_ptr<const sstable_list> time_series_sstable_set::all() const {
     return make_lw_shared<const sstable_list>(boost::copy_range<const sstable_list>(*_sstables | boost::adaptors::map_values));
 }
@@ -519,8 +547,8 @@ std::unique_ptr<incremental_selector_impl> time_series_sstable_set::make_increme
     return std::make_unique<selector>(*this);
 }
 
-// Queue of readers of sstables in a time_series_sstable_set,
-// returning readers in order of the sstables' clustering key lower bounds.
+// Queue of readers of a set of sstables, ordered by their clustering key lower bounds
+// (like the containers of a time_series_sstable_set), returning readers in that order.
 //
 // For sstable `s` we take `s.min_position()` as the lower bound for non-reversed reads,
 // and `s.max_position().reversed()` for reversed reads (in reversed reads comparisons
@@ -538,7 +566,9 @@ std::unique_ptr<incremental_selector_impl> time_series_sstable_set::make_increme
 // returned as the first on the first `pop(b)` call for any `b`. Its upper bound
 // is `before_all_clustered_rows`.
 class sstable_position_reader_queue : public position_reader_queue {
-    using container_t = time_series_sstable_set::container_t;
+public:
+    using container_t = std::multimap<position_in_partition, shared_sstable, position_in_partition::less_compare>;
+private:
     using value_t = container_t::value_type;
 
     schema_ptr _query_schema;
@@ -572,8 +602,9 @@ class sstable_position_reader_queue : public position_reader_queue {
 public:
     // Assumes that `create_reader` returns readers that emit only fragments from partition `pk`.
     //
+    // `sstables` must be keyed by `lower_bound(s)`, ordered using `query_schema`.
     // For reversed reads `query_schema` must be reversed (see docs/dev/reverse-reads.md).
-    sstable_position_reader_queue(const time_series_sstable_set& set,
+    sstable_position_reader_queue(lw_shared_ptr<const container_t> sstables,
             schema_ptr query_schema,
             std::function<flat_mutation_reader_v2(sstable&)> create_reader,
             std::function<bool(const sstable&)> filter,
@@ -582,7 +613,7 @@ class sstable_position_reader_queue : public position_reader_queue {
             streamed_mutation::forwarding fwd_sm,
             bool reversed)
         : _query_schema(std::move(query_schema))
-        , _sstables(reversed ? set._sstables_reversed : set._sstables)
+        , _sstables(std::move(sstables))
         , _it(_sstables->begin())
         , _end(_sstables->end())
         , _cmp(*_query_schema)
@@ -667,7 +698,7 @@ std::unique_ptr<position_reader_queue> time_series_sstable_set::make_position_re
         std::function<bool(const sstable&)> filter,
         partition_key pk, schema_ptr query_schema, reader_permit permit,
         streamed_mutation::forwarding fwd_sm, bool reversed) const {
-    return std::make_unique<sstable_position_reader_queue>(*this,
+    return std::make_unique<sstable_position_reader_queue>(reversed ? _sstables_reversed : _sstables,
             std::move(query_schema), std::move(create_reader), std::move(filter),
             std::move(pk), std::move(permit), fwd_sm, reversed);
 }
@@ -685,6 +716,11 @@ std::unique_ptr<sstable_set_impl> leveled_compaction_strategy::make_sstable_set(
     return std::make_unique<partitioned_sstable_set>(std::move(schema));
 }
 
+std::unique_ptr<sstable_set_impl> incremental_compaction_strategy::make_sstable_set(schema_ptr schema) const {
+    // Fragments of a run don't overlap, so all of them go to the interval map, like LCS levels.
+    return std::make_unique<partitioned_sstable_set>(std::move(schema));
+}
+
 std::unique_ptr<sstable_set_impl> time_window_compaction_strategy::make_sstable_set(schema_ptr schema) const {
     return std::make_unique<time_series_sstable_set>(std::move(schema), _options.enable_optimized_twcs_queries);
 }
@@ -794,18 +830,32 @@ class incremental_reader_selector : public reader_selector {
 // Assumes the given `pos` and `schema` are alive during the function's lifetime.
 static std::predicate<const sstable&> auto
 make_pk_filter(const dht::ring_position& pos, const schema& schema) {
-    return [&pos, key = key::from_partition_key(schema, *pos.key()), cmp = dht::ring_position_comparator(schema)] (const sstable& sst) {
+    // The key is hashed once, rather than once for every sstable checked.
+    return [&pos, hk = sstable::make_hashed_key(schema, *pos.key()), cmp = dht::ring_position_comparator(schema)] (const sstable& sst) {
         return cmp(pos, sst.get_first_decorated_key()) >= 0 &&
                cmp(pos, sst.get_last_decorated_key()) <= 0 &&
-               sst.filter_has_key(key);
+               sst.filter_has_key(hk);
     };
 }
 
 // Filter out sstables for reader using bloom filter
+//
+// The key is hashed once for all sstables, and the filters are checked in two
+// passes: the first one drops the sstables whose key range doesn't include the
+// key and prefetches the filter memory of the remaining ones, so that their
+// cache misses overlap, and the second one probes the filters.
 static std::vector<shared_sstable>
 filter_sstable_for_reader_by_pk(std::vector<shared_sstable>&& sstables, const schema& schema, const dht::ring_position& pos) {
-    auto filter = [_filter = make_pk_filter(pos, schema)] (const shared_sstable& sst) { return !_filter(*sst); };
-    sstables.erase(boost::remove_if(sstables, filter), sstables.end());
+    auto hk = sstable::make_hashed_key(schema, *pos.key());
+    auto cmp = dht::ring_position_comparator(schema);
+    auto out_of_range = [&] (const shared_sstable& sst) {
+        return cmp(pos, sst->get_first_decorated_key()) < 0 || cmp(pos, sst->get_last_decorated_key()) > 0;
+    };
+    sstables.erase(boost::remove_if(sstables, out_of_range), sstables.end());
+    for (const auto& sst : sstables) {
+        sst->prefetch_filter(hk);
+    }
+    sstables.erase(boost::remove_if(sstables, [&] (const shared_sstable& sst) { return !sst->filter_has_key(hk); }), sstables.end());
     return std::move(sstables);
 }
 
@@ -843,6 +893,41 @@ filter_sstable_for_reader_by_ck(std::vector<shared_sstable>&& sstables, replica:
     return std::move(sstables);
 }
 
+// Whether the sstables can be merged in clustering order, with the readers of the sstables
+// opened only once the read reaches their lower bounds (see sstable_position_reader_queue).
+// The sstables must be sufficiently modern to contain the min/max column metadata,
+// and since readers are opened in the middle of the partition, the sstables can have
+// neither static rows nor partition tombstones.
+static bool can_read_in_clustering_order(const schema& schema, const std::vector<shared_sstable>& sstables) {
+    return !schema.has_static_columns() && std::ranges::none_of(sstables, [] (const shared_sstable& sst) {
+        return sst->get_version() < sstable_version_types::md || sst->may_have_partition_tombstones();
+    });
+}
+
+static flat_mutation_reader_v2
+make_clustering_ordered_sstable_reader(schema_ptr schema, reader_permit permit, const std::vector<shared_sstable>& sstables,
+        const dht::ring_position& pos, const dht::partition_range& pr, const query::partition_slice& slice,
+        const io_priority_class& pc, tracing::trace_state_ptr trace_state, streamed_mutation::forwarding fwd) {
+    const auto reversed = slice.is_reversed();
+    auto ordered = make_lw_shared<sstable_position_reader_queue::container_t>(position_in_partition::less_compare(*schema));
+    for (const auto& sst : sstables) {
+        ordered->emplace(reversed ? sst->max_position().reversed() : sst->min_position(), sst);
+    }
+
+    auto create_reader = [schema, permit, &pos, &pr, &slice, &pc, trace_state, fwd] (sstable& sst) {
+        tracing::trace(trace_state, "Reading key {} from sstable {}", pos, seastar::value_of([&sst] { return sst.get_filename(); }));
+        return sst.make_reader(schema, permit, pr, slice, pc, trace_state, fwd);
+    };
+    // The sstables were already filtered.
+    auto filter = [] (const sstable&) { return true; };
+
+    // Note that `sstable_position_reader_queue` always includes a reader which emits a `partition_start` fragment,
+    // so the partition is emitted even if none of the sstables have rows in the slice, see #3552.
+    auto queue = std::make_unique<sstable_position_reader_queue>(std::move(ordered), schema, std::move(create_reader),
+            std::move(filter), *pos.key(), permit, fwd, reversed);
+    return make_clustering_combined_reader(std::move(schema), std::move(permit), fwd, std::move(queue));
+}
+
 std::vector<sstable_run>
 sstable_set_impl::select_sstable_runs(const std::vector<shared_sstable>& sstables) const {
     throw_with_backtrace<std::bad_function_call>();
@@ -867,8 +952,19 @@ sstable_set_impl::create_single_key_sstable_reader(
     if (!num_sstables) {
         return make_empty_flat_reader_v2(schema, permit);
     }
-    auto readers = boost::copy_range<std::vector<flat_mutation_reader_v2>>(
-        filter_sstable_for_reader_by_ck(std::move(selected_sstables), *cf, schema, slice)
+    selected_sstables = filter_sstable_for_reader_by_ck(std::move(selected_sstables), *cf, schema, slice);
+    auto num_readers = selected_sstables.size();
+
+    // Open the readers lazily, as the read reaches the first clustering position
+    // of each sstable, when the sstables allow it. Reads of the latest rows of
+    // a partition spread over many sstables then often open only a few of them.
+    if (num_readers > 1 && can_read_in_clustering_order(*schema, selected_sstables)) {
+        sstable_histogram.add(num_readers);
+        return make_clustering_ordered_sstable_reader(std::move(schema), std::move(permit), selected_sstables,
+                pos, pr, slice, pc, std::move(trace_state), fwd);
+    }
+
+    auto readers = boost::copy_range<std::vector<flat_mutation_reader_v2>>(selected_sstables
         | boost::adaptors::transformed([&] (const shared_sstable& sstable) {
             tracing::trace(trace_state, "Reading key {} from sstable {}", pos, seastar::value_of([&sstable] { return sstable->get_filename(); }));
             return sstable->make_reader(schema, permit, pr, slice, pc, trace_state, fwd);
@@ -883,7 +979,6 @@ sstable_set_impl::create_single_key_sstable_reader(
     // the partition_start/end pair and append it to the list of readers passed
     // to make_combined_reader to ensure partition_start/end are emitted even if
     // all sstables actually containing the partition were filtered.
-    auto num_readers = readers.size();
     if (num_readers != num_sstables) {
         readers.push_back(make_flat_mutation_reader_from_mutations_v2(schema, permit, {mutation(schema, *pos.key())}, slice, fwd));
     }
@@ -1000,6 +1095,14 @@ std::vector<shared_sstable> compound_sstable_set::select(const dht::partition_ra
     return ret;
 }
 
+size_t compound_sstable_set::count(const dht::partition_range& range) const {
+    size_t ret = 0;
+    for (auto& set : _sets) {
+        ret += set->count(range);
+    }
+    return ret;
+}
+
 std::vector<sstable_run> compound_sstable_set::select_sstable_runs(const std::vector<shared_sstable>& sstables) const {
     std::vector<sstable_run> ret;
     for (auto& set : _sets) {
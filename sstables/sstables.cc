@@ -60,6 +60,10 @@
 #include "counters.hh"
 #include "binary_search.hh"
 #include "utils/bloom_filter.hh"
+#include "utils/binary_fuse_filter.hh"
+#include "sstables/paged_filter.hh"
+#include "sstables/partition_trie.hh"
+#include "sstables/mx/row_index.hh"
 #include "utils/memory_data_sink.hh"
 #include "utils/cached_file.hh"
 #include "utils/stall_free.hh"
@@ -108,6 +112,9 @@ thread_local utils::updateable_value<bool> global_cache_index_pages(false);
 
 logging::logger sstlog("sstable");
 
+// Metrics of the cache of pages read from the Data file of sstables on object storage.
+static thread_local cached_file::metrics data_page_cache_metrics;
+
 // Because this is a noop and won't hold any state, it is better to use a global than a
 // thread_local. It will be faster, specially on non-x86.
 struct noop_write_monitor final : public write_monitor {
@@ -163,6 +170,10 @@ class sstable::filesystem_storage final : public sstable::storage {
 public:
     explicit filesystem_storage(sstring dir_) : dir(std::move(dir_)) {}
 
+    future<> link_to(const sstable& sst, const sstring& dst_dir, generation_type generation) const {
+        return create_links_common(sst, dst_dir, generation, mark_for_removal::no);
+    }
+
     virtual future<> seal(const sstable& sst) override;
     virtual future<> snapshot(const sstable& sst, sstring dir, absolute_path abs) const override;
     virtual future<> change_state(const sstable& sst, sstring to, generation_type generation, delayed_commit_changes* delay) override;
@@ -170,21 +181,93 @@ class sstable::filesystem_storage final : public sstable::storage {
     virtual void open(sstable& sst, const io_priority_class& pc) override;
     virtual future<> wipe(const sstable& sst) noexcept override;
     virtual future<file> open_component(const sstable& sst, component_type type, open_flags flags, file_open_options options, bool check_integrity) override;
-    virtual future<data_sink> make_data_or_index_sink(sstable& sst, component_type type, io_priority_class pc) override;
+    virtual future<data_sink> make_data_or_index_sink(sstable& sst, component_type type, io_priority_class pc, const sstable_writer_config& cfg) override;
     virtual future<data_sink> make_component_sink(sstable& sst, component_type type, open_flags oflags, file_output_stream_options options) override;
     virtual future<storage::stat> get_stats(const sstable& sst) override;
 
     virtual sstring prefix() const override { return dir; }
+    virtual bool is_remote() const noexcept override { return false; }
 };
 
-future<data_sink> sstable::filesystem_storage::make_data_or_index_sink(sstable& sst, component_type type, io_priority_class pc) {
+// Passes the writes through to the sink of a component file and fdatasync()s
+// the file in the background every sync_interval bytes, so that the dirty data
+// of a large sstable reaches the disk as it is written instead of all at once
+// when the sstable is sealed. At most one sync is in flight; a writer faster
+// than the disk waits for it.
+class periodically_synced_data_sink_impl final : public data_sink_impl {
+    data_sink _out;
+    file _file;
+    uint64_t _sync_interval;
+    uint64_t _unsynced = 0;
+    future<> _sync = make_ready_future<>();
+private:
+    future<> maybe_sync(size_t written) {
+        _unsynced += written;
+        if (_unsynced < _sync_interval) {
+            return make_ready_future<>();
+        }
+        _unsynced = 0;
+        return std::exchange(_sync, make_ready_future<>()).then([this] {
+            _sync = _file.flush();
+        });
+    }
+public:
+    periodically_synced_data_sink_impl(data_sink out, file f, uint64_t sync_interval)
+            : _out(std::move(out))
+            , _file(std::move(f))
+            , _sync_interval(sync_interval)
+    {}
+
+    virtual temporary_buffer<char> allocate_buffer(size_t size) override {
+        return _out.allocate_buffer(size);
+    }
+    virtual future<> put(net::packet data) override {
+        auto size = data.len();
+        return _out.put(std::move(data)).then([this, size] {
+            return maybe_sync(size);
+        });
+    }
+    virtual future<> put(temporary_buffer<char> buf) override {
+        auto size = buf.size();
+        return _out.put(std::move(buf)).then([this, size] {
+            return maybe_sync(size);
+        });
+    }
+    virtual future<> flush() override {
+        return _out.flush();
+    }
+    virtual future<> close() override {
+        std::exception_ptr ex;
+        try {
+            co_await std::exchange(_sync, make_ready_future<>());
+        } catch (...) {
+            ex = std::current_exception();
+        }
+        co_await _out.close();
+        if (ex) {
+            std::rethrow_exception(std::move(ex));
+        }
+    }
+    virtual size_t buffer_size() const noexcept override {
+        return _out.buffer_size();
+    }
+};
+
+future<data_sink> sstable::filesystem_storage::make_data_or_index_sink(sstable& sst, component_type type, io_priority_class pc, const sstable_writer_config& cfg) {
     file_output_stream_options options;
     options.io_priority_class = pc;
-    options.buffer_size = sst.sstable_buffer_size;
-    options.write_behind = 10;
+    options.buffer_size = cfg.data_write_buffer_size ? cfg.data_write_buffer_size : sst.sstable_buffer_size;
+    options.write_behind = cfg.data_write_behind;
+    options.preallocation_size = cfg.data_preallocation_size;
 
     assert(type == component_type::Data || type == component_type::Index);
-    return make_file_data_sink(type == component_type::Data ? std::move(sst._data_file) : std::move(sst._index_file), options);
+    file f = type == component_type::Data ? std::move(sst._data_file) : std::move(sst._index_file);
+    if (!cfg.data_sync_interval) {
+        return make_file_data_sink(std::move(f), options);
+    }
+    return make_file_data_sink(f, options).then([f, sync_interval = cfg.data_sync_interval] (data_sink out) mutable {
+        return data_sink(std::make_unique<periodically_synced_data_sink_impl>(std::move(out), std::move(f), sync_interval));
+    });
 }
 
 future<data_sink> sstable::filesystem_storage::make_component_sink(sstable& sst, component_type type, open_flags oflags, file_output_stream_options options) {
@@ -937,10 +1020,14 @@ void sstable::generate_toc() {
     if (_schema->bloom_filter_fp_chance() != 1.0) {
         _recognized_components.insert(component_type::Filter);
     }
-    if (_schema->get_compressor_params().get_compressor() == nullptr) {
+    auto compressor = _schema->get_compressor_params().get_compressor();
+    if (compressor == nullptr) {
         _recognized_components.insert(component_type::CRC);
     } else {
         _recognized_components.insert(component_type::CompressionInfo);
+        if (compressor->uses_dictionary()) {
+            _recognized_components.insert(component_type::CompressionDictionary);
+        }
     }
     _recognized_components.insert(component_type::Scylla);
 }
@@ -1150,10 +1237,13 @@ template void sstable::write_simple<component_type::Summary>(const sstables::sum
 future<> sstable::read_compression(const io_priority_class& pc) {
      // FIXME: If there is no compression, we should expect a CRC file to be present.
     if (!has_component(component_type::CompressionInfo)) {
-        return make_ready_future<>();
+        co_return;
     }
 
-    return read_simple<component_type::CompressionInfo>(_components->compression, pc);
+    co_await read_simple<component_type::CompressionInfo>(_components->compression, pc);
+    if (has_component(component_type::CompressionDictionary)) {
+        co_await read_simple<component_type::CompressionDictionary>(_components->compression.dictionary, pc);
+    }
 }
 
 void sstable::write_compression(const io_priority_class& pc) {
@@ -1162,6 +1252,9 @@ void sstable::write_compression(const io_priority_class& pc) {
     }
 
     write_simple<component_type::CompressionInfo>(_components->compression, pc);
+    if (has_component(component_type::CompressionDictionary)) {
+        write_simple<component_type::CompressionDictionary>(_components->compression.dictionary, pc);
+    }
 }
 
 void sstable::validate_partitioner() {
@@ -1442,6 +1535,18 @@ future<> sstable::open_data(sstable_open_config cfg) noexcept {
     if (origin) {
         _origin = sstring(to_sstring_view(bytes_view(origin->value)));
     }
+    if (_filter_deferred && _shards.size() > 1) {
+        // Other shards get a copy of the components, so the filter can't be read later.
+        co_await load_deferred_filter();
+    } else if (auto f = dynamic_cast<paged_bloom_filter*>(_components->filter.get()); f && _shards.size() > 1) {
+        // The filter of an sstable shared between shards is used by all of
+        // them, so it can't be read through the shard-local cache.
+        co_await f->close_gently();
+        co_await read_filter(default_priority_class());
+    } else if (_shards.size() == 1 && can_page_filter() && dynamic_cast<const utils::filter::bloom_filter*>(_components->filter.get())) {
+        // A freshly written sstable still holds the filter it was written with.
+        co_await open_paged_filter(default_priority_class());
+    }
     _open_mode.emplace(open_flags::ro);
     _stats.on_open_for_reading();
 }
@@ -1464,6 +1569,22 @@ future<> sstable::update_info_for_opened_data(sstable_open_config cfg) {
                                                             _manager.get_cache_tracker().region(),
                                                             _index_file_size);
     _index_file = make_cached_seastar_file(*_cached_index_file);
+    if (_storage->is_remote() && !_cached_data_file) {
+        // Every read of a remote Data file is a round-trip to the object store,
+        // so keep the pages read from it in the shard's cache, like index pages.
+        _cached_data_file = seastar::make_shared<cached_file>(_data_file,
+                                                               data_page_cache_metrics,
+                                                               _manager.get_cache_tracker().get_lru(),
+                                                               _manager.get_cache_tracker().region(),
+                                                               _data_file_size);
+        _data_file = make_cached_seastar_file(*_cached_data_file);
+    }
+    if (has_component(component_type::Partitions) && !_partition_trie) {
+        co_await open_partition_trie();
+    }
+    if (has_component(component_type::Rows) && !_row_index) {
+        co_await open_row_index();
+    }
 
     this->set_min_max_position_range();
     this->set_first_and_last_keys();
@@ -1521,9 +1642,18 @@ future<> sstable::create_data() noexcept {
 }
 
 future<> sstable::drop_caches() {
-    return _cached_index_file->evict_gently().then([this] {
-        return _index_cache->evict_gently();
-    });
+    co_await _cached_index_file->evict_gently();
+    if (_cached_data_file) {
+        co_await _cached_data_file->evict_gently();
+    }
+    co_await _index_cache->evict_gently();
+    co_await _index_entry_cache->evict_gently();
+    if (_partition_trie) {
+        co_await _partition_trie->evict_gently();
+    }
+    if (_row_index) {
+        co_await _row_index->evict_gently();
+    }
 }
 
 future<> sstable::read_filter(const io_priority_class& pc, sstable_open_config cfg) {
@@ -1532,11 +1662,34 @@ future<> sstable::read_filter(const io_priority_class& pc, sstable_open_config c
         return make_ready_future<>();
     }
 
+    if (cfg.defer_bloom_filter) {
+        _components->filter = std::make_unique<utils::filter::always_present_filter>();
+        _filter_deferred = true;
+        return make_ready_future<>();
+    }
+
+    // The owners aren't known yet when loading, see open_data().
+    if (_shards.size() <= 1 && can_page_filter()) {
+        return open_paged_filter(pc);
+    }
+
     return seastar::async([this, &pc] () mutable {
         sstables::filter filter;
         read_simple<component_type::Filter>(filter, pc).get();
+        if (_components->scylla_metadata && _components->scylla_metadata->has_feature(sstable_feature::BinaryFuseFilter)) {
+            try {
+                _components->filter = std::make_unique<utils::filter::binary_fuse_filter>(std::move(filter.buckets.elements));
+            } catch (const std::invalid_argument& e) {
+                throw malformed_sstable_exception(e.what(), filename(component_type::Filter));
+            }
+            return;
+        }
         auto nr_bits = filter.buckets.elements.size() * std::numeric_limits<typename decltype(filter.buckets.elements)::value_type>::digits;
         large_bitset bs(nr_bits, std::move(filter.buckets.elements));
+        if (_components->scylla_metadata && _components->scylla_metadata->has_feature(sstable_feature::BlockedBloomFilter)) {
+            _components->filter = utils::filter::create_blocked_filter(filter.hashes, std::move(bs));
+            return;
+        }
         utils::filter_format format = (_version >= sstable_version_types::mc)
                                       ? utils::filter_format::m_format
                                       : utils::filter_format::k_l_format;
@@ -1544,12 +1697,81 @@ future<> sstable::read_filter(const io_priority_class& pc, sstable_open_config c
     });
 }
 
+future<> sstable::load_deferred_filter() {
+    if (!_filter_deferred) {
+        co_return;
+    }
+    co_await read_filter(default_priority_class());
+    _filter_deferred = false;
+}
+
+bool sstable::can_page_filter() const {
+    return _manager.config().enable_evictable_sstable_filters()
+        && has_component(component_type::Filter)
+        && !(_components->scylla_metadata && _components->scylla_metadata->has_feature(sstable_feature::BinaryFuseFilter));
+}
+
+future<> sstable::open_paged_filter(const io_priority_class& pc) {
+    auto layout = _components->scylla_metadata && _components->scylla_metadata->has_feature(sstable_feature::BlockedBloomFilter)
+            ? utils::filter_layout::blocked
+            : utils::filter_layout::classic;
+    auto format = (_version >= sstable_version_types::mc)
+            ? utils::filter_format::m_format
+            : utils::filter_format::k_l_format;
+    auto f = co_await open_file(component_type::Filter, open_flags::ro);
+    std::exception_ptr ex;
+    try {
+        _components->filter = co_await paged_bloom_filter::open(f, format, layout, filter_page_cache_metrics, _manager.get_cache_tracker(), pc);
+        co_return;
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await f.close();
+    std::rethrow_exception(ex);
+}
+
+future<> sstable::open_partition_trie() {
+    auto f = co_await open_file(component_type::Partitions, open_flags::ro);
+    std::exception_ptr ex;
+    try {
+        _partition_trie = co_await partition_trie::open(f, index_page_cache_metrics, _manager.get_cache_tracker(), default_priority_class());
+        co_return;
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await f.close();
+    // Index.db holds all that the trie does, so the sstable can still be read with it alone.
+    sstlog.warn("Couldn't read partition trie {}: {}. Using Index.db only.", filename(component_type::Partitions), ex);
+}
+
+future<> sstable::open_row_index() {
+    auto f = co_await open_file(component_type::Rows, open_flags::ro);
+    std::exception_ptr ex;
+    try {
+        _row_index = co_await mc::row_index::open(f, index_page_cache_metrics, _manager.get_cache_tracker(), default_priority_class());
+        co_return;
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await f.close();
+    // The promoted index is still there to be searched.
+    sstlog.warn("Couldn't read row index {}: {}. Using the promoted index only.", filename(component_type::Rows), ex);
+}
+
 void sstable::write_filter(const io_priority_class& pc) {
     if (!has_component(component_type::Filter)) {
         return;
     }
 
-    auto f = static_cast<utils::filter::murmur3_bloom_filter *>(_components->filter.get());
+    if (auto f = dynamic_cast<const utils::filter::binary_fuse_filter*>(_components->filter.get())) {
+        // No hash functions, so it reads as an always present bloom filter
+        // where BinaryFuseFilter is unknown.
+        write_simple<component_type::Filter>(sstables::filter_ref(0, f->words()), pc);
+        return;
+    }
+
+    // Both classic and blocked bloom filters are stored the same way.
+    auto f = static_cast<utils::filter::bloom_filter *>(_components->filter.get());
 
     auto&& bs = f->bits();
     auto filter_ref = sstables::filter_ref(f->num_hashes(), bs.get_storage());
@@ -1779,7 +2001,8 @@ sstable::read_scylla_metadata(const io_priority_class& pc) noexcept {
 
 void
 sstable::write_scylla_metadata(const io_priority_class& pc, shard_id shard, sstable_enabled_features features, struct run_identifier identifier,
-        std::optional<scylla_metadata::large_data_stats> ld_stats, sstring origin) {
+        std::optional<scylla_metadata::large_data_stats> ld_stats, sstring origin,
+        std::optional<scylla_metadata::column_value_stats> cv_stats) {
     auto&& first_key = get_first_decorated_key();
     auto&& last_key = get_last_decorated_key();
     auto sm = create_sharding_metadata(_schema, first_key, last_key, shard);
@@ -1800,6 +2023,9 @@ sstable::write_scylla_metadata(const io_priority_class& pc, shard_id shard, ssta
     if (ld_stats) {
         _components->scylla_metadata->data.set<scylla_metadata_type::LargeDataStats>(std::move(*ld_stats));
     }
+    if (cv_stats) {
+        _components->scylla_metadata->data.set<scylla_metadata_type::ColumnValueStats>(std::move(*cv_stats));
+    }
     if (!origin.empty()) {
         scylla_metadata::sstable_origin o;
         o.value = bytes(to_bytes_view(sstring_view(origin)));
@@ -2296,6 +2522,76 @@ future<> sstable::snapshot(const sstring& dir) const {
     return _storage->snapshot(*this, dir, filesystem_storage::absolute_path::yes);
 }
 
+bool sstable::can_link_into(const sstable& dst) const noexcept {
+    return _version == dst._version && _format == dst._format
+            && dynamic_cast<const filesystem_storage*>(_storage.get())
+            && dynamic_cast<const filesystem_storage*>(dst._storage.get());
+}
+
+future<> sstable::link_into(sstable& dst, const io_priority_class& pc) const {
+    assert(can_link_into(dst));
+    auto& storage = static_cast<const filesystem_storage&>(*_storage);
+    co_await storage.link_to(*this, dst._storage->prefix(), dst._generation);
+    co_await dst.load(pc);
+}
+
+bool sstable::can_stream_components() const noexcept {
+    return _version >= version_types::mc
+            && dynamic_cast<const filesystem_storage*>(_storage.get())
+            && _manager.config().extensions().sstable_file_io_extensions().empty();
+}
+
+std::vector<sstring> sstable::streamed_components() const {
+    std::vector<sstring> components;
+    for (auto c : _recognized_components) {
+        if (c != component_type::TOC) {
+            components.push_back(sstable_version_constants::get_component_map(_version).at(c));
+        }
+    }
+    return components;
+}
+
+future<input_stream<char>> sstable::make_streamed_component_input_stream(const sstring& component, const io_priority_class& pc) {
+    auto type = reverse_map(component, sstable_version_constants::get_component_map(_version));
+    auto f = co_await open_file(type, open_flags::ro);
+    file_input_stream_options options;
+    options.buffer_size = 128 * 1024;
+    options.read_ahead = 4;
+    options.io_priority_class = pc;
+    co_return make_file_input_stream(std::move(f), 0, std::move(options));
+}
+
+future<> sstable::open_for_streamed_components(const std::vector<sstring>& components, const io_priority_class& pc) {
+    _recognized_components.clear();
+    _recognized_components.insert(component_type::TOC);
+    for (auto& c : components) {
+        try {
+            _recognized_components.insert(reverse_map(c, sstable_version_constants::get_component_map(_version)));
+        } catch (std::out_of_range&) {
+            throw malformed_sstable_exception(format("Unrecognized streamed component {}", c), get_filename());
+        }
+    }
+    // Delete the components written so far if this sstable is destroyed
+    // before it is sealed, as with sstables written by get_writer().
+    _marked_for_deletion = mark_for_deletion::implicit;
+    co_await seastar::async([this, &pc] {
+        _storage->open(*this, pc);
+    });
+}
+
+future<output_stream<char>> sstable::make_streamed_component_output_stream(const sstring& component, const io_priority_class& pc) {
+    auto type = reverse_map(component, sstable_version_constants::get_component_map(_version));
+    if (!_recognized_components.contains(type) || type == component_type::TOC) {
+        throw malformed_sstable_exception(format("Unexpected streamed component {}", component), get_filename());
+    }
+    file_output_stream_options options;
+    options.buffer_size = 128 * 1024;
+    options.write_behind = 4;
+    options.io_priority_class = pc;
+    auto sink = co_await _storage->make_component_sink(*this, type, open_flags::wo | open_flags::create | open_flags::exclusive, std::move(options));
+    co_return output_stream<char>(std::move(sink));
+}
+
 future<> sstable::filesystem_storage::move(const sstable& sst, sstring new_dir, generation_type new_generation, delayed_commit_changes* delay_commit) {
     co_await touch_directory(new_dir);
     sstring old_dir = dir;
@@ -2836,6 +3132,18 @@ int sstable::compare_by_max_timestamp(const sstable& other) const {
 }
 
 future<> sstable::close_files() {
+    auto filter_closed = make_ready_future<>();
+    if (auto f = dynamic_cast<paged_bloom_filter*>(_components->filter.get())) {
+        filter_closed = f->close_gently();
+    }
+    auto partition_trie_closed = make_ready_future<>();
+    if (_partition_trie) {
+        partition_trie_closed = _partition_trie->close();
+    }
+    auto row_index_closed = make_ready_future<>();
+    if (_row_index) {
+        row_index_closed = _row_index->close();
+    }
     auto index_closed = make_ready_future<>();
     if (_index_file) {
         index_closed = _index_file.close().handle_exception([me = shared_from_this()] (auto ep) {
@@ -2874,7 +3182,7 @@ future<> sstable::close_files() {
 
     _on_closed(*this);
 
-    return when_all_succeed(std::move(index_closed), std::move(data_closed), std::move(unlinked)).discard_result().then([this, me = shared_from_this()] {
+    return when_all_succeed(std::move(filter_closed), std::move(partition_trie_closed), std::move(row_index_closed), std::move(index_closed), std::move(data_closed), std::move(unlinked)).discard_result().then([this, me = shared_from_this()] {
         if (_open_mode) {
             if (_open_mode.value() == open_flags::ro) {
                 _stats.on_close_for_reading();
@@ -3158,6 +3466,7 @@ sstable::unlink() noexcept {
 thread_local sstables_stats::stats sstables_stats::_shard_stats;
 thread_local partition_index_cache::stats partition_index_cache::_shard_stats;
 thread_local cached_file::metrics index_page_cache_metrics;
+thread_local cached_file::metrics filter_page_cache_metrics;
 thread_local mc::cached_promoted_index::metrics promoted_index_cache_metrics;
 static thread_local seastar::metrics::metric_groups metrics;
 
@@ -3178,6 +3487,13 @@ future<> init_metrics() {
         sm::make_gauge("index_page_used_bytes", [] { return partition_index_cache::shard_stats().used_bytes; },
             sm::description("Amount of bytes used by index pages in memory")),
 
+        sm::make_counter("partition_trie_hits", [] { return partition_trie::get_shard_stats().hits; },
+            sm::description("Partition trie lookups which found the index entry of the partition")),
+        sm::make_counter("partition_trie_misses", [] { return partition_trie::get_shard_stats().misses; },
+            sm::description("Partition trie lookups which found the partition absent without reading the index")),
+        sm::make_counter("row_index_lookups", [] { return mc::row_index::get_shard_stats().lookups; },
+            sm::description("Searches of promoted index blocks which went through the row index")),
+
         sm::make_counter("index_page_cache_hits", [] { return index_page_cache_metrics.page_hits; },
             sm::description("Index page cache requests which were served from cache")),
         sm::make_counter("index_page_cache_misses", [] { return index_page_cache_metrics.page_misses; },
@@ -3186,11 +3502,34 @@ future<> init_metrics() {
             sm::description("Total number of index page cache pages which have been evicted")),
         sm::make_counter("index_page_cache_populations", [] { return index_page_cache_metrics.page_populations; },
             sm::description("Total number of index page cache pages which were inserted into the cache")),
+        sm::make_counter("index_page_cache_readaheads", [] { return index_page_cache_metrics.page_readaheads; },
+            sm::description("Total number of index page cache pages which were read ahead of being requested")),
         sm::make_gauge("index_page_cache_bytes", [] { return index_page_cache_metrics.cached_bytes; },
             sm::description("Total number of bytes cached in the index page cache")),
         sm::make_gauge("index_page_cache_bytes_in_std", [] { return index_page_cache_metrics.bytes_in_std; },
             sm::description("Total number of bytes in temporary buffers which live in the std allocator")),
 
+        sm::make_counter("filter_page_cache_hits", [] { return filter_page_cache_metrics.page_hits; },
+            sm::description("Evictable bloom filter page lookups which were served from cache")),
+        sm::make_counter("filter_page_cache_misses", [] { return filter_page_cache_metrics.page_misses; },
+            sm::description("Evictable bloom filter page lookups which had to perform I/O")),
+        sm::make_counter("filter_page_cache_evictions", [] { return filter_page_cache_metrics.page_evictions; },
+            sm::description("Total number of evictable bloom filter pages which have been evicted")),
+        sm::make_counter("filter_page_cache_populations", [] { return filter_page_cache_metrics.page_populations; },
+            sm::description("Total number of evictable bloom filter pages which were inserted into the cache")),
+        sm::make_gauge("filter_page_cache_bytes", [] { return filter_page_cache_metrics.cached_bytes; },
+            sm::description("Total number of bytes cached for evictable bloom filters")),
+        sm::make_counter("data_page_cache_hits", [] { return data_page_cache_metrics.page_hits; },
+            sm::description("Data page cache requests for sstables on object storage which were served from cache")),
+        sm::make_counter("data_page_cache_misses", [] { return data_page_cache_metrics.page_misses; },
+            sm::description("Data page cache requests for sstables on object storage which had to read from it")),
+        sm::make_counter("data_page_cache_evictions", [] { return data_page_cache_metrics.page_evictions; },
+            sm::description("Total number of data page cache pages which have been evicted")),
+        sm::make_gauge("data_page_cache_bytes", [] { return data_page_cache_metrics.cached_bytes; },
+            sm::description("Total number of bytes cached in the data page cache")),
+        sm::make_counter("filter_incomplete_lookups", [] { return paged_bloom_filter::get_shard_stats().incomplete_lookups; },
+            sm::description("Evictable bloom filter lookups which reported a key as present because some of their pages were not cached")),
+
         sm::make_counter("pi_cache_hits_l0", [] { return promoted_index_cache_metrics.hits_l0; },
             sm::description("Number of requests for promoted index block in state l0 which didn't have to go to the page cache")),
         sm::make_counter("pi_cache_hits_l1", [] { return promoted_index_cache_metrics.hits_l1; },
@@ -3243,6 +3582,8 @@ future<> init_metrics() {
             sm::description("Number of partitions seeked")),
         sm::make_counter("row_reads", [] { return sstables_stats::get_shard_stats().row_reads; },
             sm::description("Number of rows read")),
+        sm::make_counter("shadowed_rows_skipped", [] { return sstables_stats::get_shard_stats().shadowed_rows_skipped; },
+            sm::description("Number of rows read which were skipped without being parsed, because a tombstone newer than the whole sstable shadows them")),
 
         sm::make_counter("capped_local_deletion_time", [] { return sstables_stats::get_shard_stats().capped_local_deletion_time; },
             sm::description("Was local deletion time capped at maximum allowed value in Statistics")),
@@ -3268,6 +3609,9 @@ future<> init_metrics() {
 
         sm::make_gauge("bloom_filter_memory_size", [] { return utils::filter::bloom_filter::get_shard_stats().memory_size; },
             sm::description("Bloom filter memory usage in bytes.")),
+
+        sm::make_gauge("binary_fuse_filter_memory_size", [] { return utils::filter::binary_fuse_filter::get_shard_stats().memory_size; },
+            sm::description("Binary fuse filter memory usage in bytes.")),
     });
   });
 }
@@ -3316,11 +3660,12 @@ class sstable::s3_storage final : public sstable::storage {
     virtual void open(sstable& sst, const io_priority_class& pc) override;
     virtual future<> wipe(const sstable& sst) noexcept override;
     virtual future<file> open_component(const sstable& sst, component_type type, open_flags flags, file_open_options options, bool check_integrity) override;
-    virtual future<data_sink> make_data_or_index_sink(sstable& sst, component_type type, io_priority_class pc) override;
+    virtual future<data_sink> make_data_or_index_sink(sstable& sst, component_type type, io_priority_class pc, const sstable_writer_config& cfg) override;
     virtual future<data_sink> make_component_sink(sstable& sst, component_type type, open_flags oflags, file_output_stream_options options) override;
     virtual future<storage::stat> get_stats(const sstable& sst) override;
 
     virtual sstring prefix() const override { return _location; }
+    virtual bool is_remote() const noexcept override { return true; }
 };
 
 future<> sstable::s3_storage::ensure_remote_prefix(const sstable& sst) {
@@ -3354,7 +3699,7 @@ future<file> sstable::s3_storage::open_component(const sstable& sst, component_t
     co_return _client->make_readable_file(make_s3_object_name(sst, type));
 }
 
-future<data_sink> sstable::s3_storage::make_data_or_index_sink(sstable& sst, component_type type, io_priority_class pc) {
+future<data_sink> sstable::s3_storage::make_data_or_index_sink(sstable& sst, component_type type, io_priority_class pc, const sstable_writer_config&) {
     assert(type == component_type::Data || type == component_type::Index);
     co_await ensure_remote_prefix(sst);
     co_return _client->make_upload_sink(make_s3_object_name(sst, type));
@@ -3437,6 +3782,8 @@ sstable::sstable(schema_ptr schema,
     , _format(f)
     , _index_cache(std::make_unique<partition_index_cache>(
             manager.get_cache_tracker().get_lru(), manager.get_cache_tracker().region()))
+    , _index_entry_cache(std::make_unique<partition_index_cache>(
+            manager.get_cache_tracker().get_lru(), manager.get_cache_tracker().region()))
     , _now(now)
     , _read_error_handler(error_handler_gen(sstable_read_error))
     , _write_error_handler(error_handler_gen(sstable_write_error))
@@ -3462,11 +3809,29 @@ void sstable::unused() {
 future<> sstable::destroy() {
     return close_files().finally([this] {
         return _index_cache->evict_gently().then([this] {
+            return _index_entry_cache->evict_gently();
+        }).then([this] {
+            if (_partition_trie) {
+                return _partition_trie->evict_gently();
+            }
+            return make_ready_future<>();
+        }).then([this] {
+            if (_row_index) {
+                return _row_index->evict_gently();
+            }
+            return make_ready_future<>();
+        }).then([this] {
             if (_cached_index_file) {
                 return _cached_index_file->evict_gently();
             } else {
                 return make_ready_future<>();
             }
+        }).then([this] {
+            if (_cached_data_file) {
+                return _cached_data_file->evict_gently();
+            } else {
+                return make_ready_future<>();
+            }
         });
     });
 }
@@ -3483,6 +3848,18 @@ std::ostream& operator<<(std::ostream& out, const deletion_time& dt) {
     return out << "{timestamp=" << dt.marked_for_delete_at << ", deletion_time=" << dt.marked_for_delete_at << "}";
 }
 
+const column_value_stats* sstable::get_column_value_stats(const bytes& column_name) const {
+    if (!_components->scylla_metadata) {
+        return nullptr;
+    }
+    auto* stats = _components->scylla_metadata->data.get<scylla_metadata_type::ColumnValueStats, scylla_metadata::column_value_stats>();
+    if (!stats) {
+        return nullptr;
+    }
+    auto it = stats->map.find(disk_string<uint32_t>{column_name});
+    return it != stats->map.end() ? &it->second : nullptr;
+}
+
 std::optional<large_data_stats_entry> sstable::get_large_data_stat(large_data_type t) const noexcept {
     if (_large_data_stats) {
         auto it = _large_data_stats->map.find(t);
@@ -59,6 +59,7 @@ extern thread_local utils::updateable_value<bool> global_cache_index_pages;
 
 namespace mc {
 class writer;
+class row_index;
 }
 
 namespace fs = std::filesystem;
@@ -91,6 +92,7 @@ class data_consume_context;
 
 class index_reader;
 class partition_index_cache;
+class partition_trie;
 class sstables_manager;
 
 extern size_t summary_byte_cost(double summary_ratio);
@@ -107,6 +109,21 @@ struct sstable_writer_config {
     run_id run_identifier = run_id::create_random_id();
     size_t summary_byte_cost;
     sstring origin;
+    bool blocked_bloom_filter = false;
+    bool partition_trie_index = false;
+    bool row_index = false;
+    // Collect column_value_stats of the regular columns into the Scylla component.
+    bool column_value_stats = false;
+    // How the Data and Index components are written to local storage.
+    // Buffers of the size of the sstable's buffer if zero, else a multiple of
+    // the checksum chunk size.
+    size_t data_write_buffer_size = 0;
+    unsigned data_write_behind = 10;
+    // Grow the files by fallocate()d extents of this size, if not zero.
+    uint32_t data_preallocation_size = 0;
+    // fdatasync() the files every time that many bytes were written to them,
+    // rather than only when the sstable is sealed, if not zero.
+    uint64_t data_sync_interval = 0;
 
 private:
     explicit sstable_writer_config() {}
@@ -325,14 +342,36 @@ class sstable : public enable_lw_shared_from_this<sstable> {
         return _data_file_write_time;
     }
 
+    // Accounts tombstones read by a query page which read at least
+    // tombstone_compaction_read_threshold of them from partitions that this
+    // sstable holds, making it a candidate for tombstone compaction.
+    void add_tombstones_read(uint64_t tombstones) noexcept {
+        _tombstones_read += tombstones;
+    }
+
+    uint64_t tombstones_read() const noexcept {
+        return _tombstones_read;
+    }
+
     uint64_t filter_memory_size() const {
         return _components->filter->memory_size();
     }
 
+    // Whether the bloom filter was left unread when loading, see sstable_open_config::defer_bloom_filter.
+    bool filter_deferred() const noexcept {
+        return _filter_deferred;
+    }
+    // Reads the bloom filter whose loading was deferred. No-op otherwise.
+    future<> load_deferred_filter();
+
     version_types get_version() const {
         return _version;
     }
 
+    format_types get_format() const {
+        return _format;
+    }
+
     // Returns the total bytes of all components.
     uint64_t bytes_on_disk() const;
 
@@ -393,6 +432,32 @@ class sstable : public enable_lw_shared_from_this<sstable> {
 
     future<> snapshot(const sstring& dir) const;
 
+    // Returns true if link_into() can make dst, a new sstable, out of this one:
+    // both have to be of the same version and format, on local storage.
+    bool can_link_into(const sstable& dst) const noexcept;
+
+    // Makes dst, a new sstable which wasn't written, out of hard links to the
+    // components of this sstable, and loads it.
+    future<> link_into(sstable& dst, const io_priority_class& pc) const;
+
+    // Whole-sstable streaming sends the raw content of the components of a
+    // sealed sstable to a peer, which writes it to a new sstable of the same
+    // version and format. Both have to be on local storage, with no
+    // extension transforming their files, and of a version which describes
+    // the columns it was written with, so peers can read it with their own
+    // version of the schema.
+    bool can_stream_components() const noexcept;
+    // The components to stream, all but the TOC, which receivers write from
+    // the list of components.
+    std::vector<sstring> streamed_components() const;
+    future<input_stream<char>> make_streamed_component_input_stream(const sstring& component, const io_priority_class& pc);
+    // Writes the temporary TOC of this sstable, not written yet, listing the
+    // streamed components. They are written with
+    // make_streamed_component_output_stream(), then the sstable is sealed
+    // with seal_sstable() and loaded.
+    future<> open_for_streamed_components(const std::vector<sstring>& components, const io_priority_class& pc);
+    future<output_stream<char>> make_streamed_component_output_stream(const sstring& component, const io_priority_class& pc);
+
     // Delete the sstable by unlinking all sstable files
     // Ignores all errors.
     future<> unlink() noexcept;
@@ -492,7 +557,7 @@ class sstable : public enable_lw_shared_from_this<sstable> {
         virtual void open(sstable& sst, const io_priority_class& pc) = 0;
         virtual future<> wipe(const sstable& sst) noexcept = 0;
         virtual future<file> open_component(const sstable& sst, component_type type, open_flags flags, file_open_options options, bool check_integrity) = 0;
-        virtual future<data_sink> make_data_or_index_sink(sstable& sst, component_type type, io_priority_class pc) = 0;
+        virtual future<data_sink> make_data_or_index_sink(sstable& sst, component_type type, io_priority_class pc, const sstable_writer_config& cfg) = 0;
         virtual future<data_sink> make_component_sink(sstable& sst, component_type type, open_flags oflags, file_output_stream_options options) = 0;
         struct stat {
             uint64_t bytes_on_disk = 0;
@@ -501,6 +566,8 @@ class sstable : public enable_lw_shared_from_this<sstable> {
         virtual future<stat> get_stats(const sstable& sst) = 0;
 
         virtual sstring prefix() const  = 0;
+        // True when the components live on object storage rather than on the local disk.
+        virtual bool is_remote() const noexcept = 0;
     };
 
     const storage& get_storage() const {
@@ -534,12 +601,20 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     std::set<generation_type> _compaction_ancestors;
     file _index_file;
     seastar::shared_ptr<cached_file> _cached_index_file;
+    // Set when the sstable has a Partitions component.
+    std::unique_ptr<partition_trie> _partition_trie;
+    // Set when the sstable has a Rows component.
+    std::unique_ptr<mc::row_index> _row_index;
     file _data_file;
+    // Set when the sstable is on object storage, to cache the pages read from its Data file.
+    seastar::shared_ptr<cached_file> _cached_data_file;
     uint64_t _data_file_size;
     uint64_t _index_file_size;
     uint64_t _filter_file_size = 0;
+    bool _filter_deferred = false;
     uint64_t _bytes_on_disk = 0;
     db_clock::time_point _data_file_write_time;
+    uint64_t _tombstones_read = 0;
     position_range _min_max_position_range = position_range::all_clustered_rows();
     position_in_partition _first_partition_first_position = position_in_partition::before_all_clustered_rows();
     position_in_partition _last_partition_last_position = position_in_partition::after_all_clustered_rows();
@@ -563,6 +638,8 @@ class sstable : public enable_lw_shared_from_this<sstable> {
 
     filter_tracker _filter_tracker;
     std::unique_ptr<partition_index_cache> _index_cache;
+    // Single index entries found through the partition trie, keyed by their offset in Index.db.
+    std::unique_ptr<partition_index_cache> _index_entry_cache;
 
     enum class mark_for_deletion {
         implicit = -1,
@@ -622,10 +699,18 @@ class sstable : public enable_lw_shared_from_this<sstable> {
 
     future<> read_scylla_metadata(const io_priority_class& pc) noexcept;
     void write_scylla_metadata(const io_priority_class& pc, shard_id shard, sstable_enabled_features features, run_identifier identifier,
-            std::optional<scylla_metadata::large_data_stats> ld_stats, sstring origin);
+            std::optional<scylla_metadata::large_data_stats> ld_stats, sstring origin,
+            std::optional<scylla_metadata::column_value_stats> cv_stats = {});
 
     future<> read_filter(const io_priority_class& pc, sstable_open_config cfg = {});
 
+    // Whether the bloom filter may be read through the cache, rather than
+    // held in memory, see paged_bloom_filter.
+    bool can_page_filter() const;
+    future<> open_paged_filter(const io_priority_class& pc);
+    future<> open_partition_trie();
+    future<> open_row_index();
+
     void write_filter(const io_priority_class& pc);
 
     future<> read_summary(const io_priority_class& pc) noexcept;
@@ -761,6 +846,10 @@ class sstable : public enable_lw_shared_from_this<sstable> {
         return _components->scylla_metadata ? &*_components->scylla_metadata : nullptr;
     }
 
+    // Statistics of the values of the regular column, or nullptr if the
+    // sstable was written without them, see sstable_writer_config::column_value_stats.
+    const column_value_stats* get_column_value_stats(const bytes& column_name) const;
+
     run_id run_identifier() const {
         return _run_identifier;
     }
@@ -785,6 +874,10 @@ class sstable : public enable_lw_shared_from_this<sstable> {
         return _components->filter->is_present(key);
     }
 
+    void prefetch_filter(utils::hashed_key key) const {
+        _components->filter->prefetch(key);
+    }
+
     bool filter_has_key(const schema& s, partition_key_view key) const {
         return filter_has_key(key::from_partition_key(s, key));
     }
@@ -6,6 +6,8 @@
  * SPDX-License-Identifier: AGPL-3.0-or-later
  */
 
+#include <seastar/core/align.hh>
+
 #include "log.hh"
 #include "sstables/sstables_manager.hh"
 #include "sstables/partition_index_cache.hh"
@@ -67,6 +69,15 @@ sstable_writer_config sstables_manager::configure_writer(sstring origin) const {
             ? mutation_fragment_stream_validation_level::clustering_key
             : mutation_fragment_stream_validation_level::token;
     cfg.summary_byte_cost = summary_byte_cost(_db_config.sstable_summary_ratio());
+    cfg.blocked_bloom_filter = _db_config.enable_sstable_blocked_bloom_filter();
+    cfg.partition_trie_index = _db_config.enable_sstable_partition_trie_index();
+    cfg.row_index = _db_config.enable_sstable_row_index();
+    cfg.column_value_stats = _db_config.enable_sstable_column_value_stats();
+    // The checksummed data writer cuts the checksum chunks at buffer boundaries.
+    cfg.data_write_buffer_size = align_up(size_t(_db_config.sstable_write_buffer_size_in_kb()) * 1024, size_t(DEFAULT_CHUNK_SIZE));
+    cfg.data_write_behind = std::max(_db_config.sstable_write_behind(), 1u);
+    cfg.data_preallocation_size = std::min(_db_config.sstable_preallocation_size_in_mb(), 1024u) << 20;
+    cfg.data_sync_interval = uint64_t(_db_config.sstable_write_sync_interval_in_mb()) << 20;
 
     cfg.origin = std::move(origin);
 
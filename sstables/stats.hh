@@ -28,6 +28,7 @@ class sstables_stats {
         uint64_t partition_reads = 0;
         uint64_t partition_seeks = 0;
         uint64_t row_reads = 0;
+        uint64_t shadowed_rows_skipped = 0;
         uint64_t capped_local_deletion_time = 0;
         uint64_t capped_tombstone_deletion_time = 0;
         uint64_t open_for_reading = 0;
@@ -101,6 +102,10 @@ class sstables_stats {
         ++_stats.row_reads;
     }
 
+    inline void on_shadowed_row_skipped() noexcept {
+        ++_stats.shadowed_rows_skipped;
+    }
+
     inline void on_capped_local_deletion_time() noexcept {
         ++_stats.capped_local_deletion_time;
     }
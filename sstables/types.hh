@@ -496,7 +496,9 @@ enum sstable_feature : uint8_t {
     CorrectStaticCompact = 3, // See #4139
     CorrectEmptyCounters = 4, // See #4363
     CorrectUDTsInCollections = 5, // See #6130
-    End = 6,
+    BlockedBloomFilter = 6, // Filter.db uses the blocked bloom filter layout
+    BinaryFuseFilter = 7, // Filter.db holds a binary fuse filter
+    End = 8,
 };
 
 // Scylla-specific features enabled for a particular sstable.
@@ -539,6 +541,7 @@ enum class scylla_metadata_type : uint32_t {
     SSTableOrigin = 6,
     ScyllaBuildId = 7,
     ScyllaVersion = 8,
+    ColumnValueStats = 9,
 };
 
 // UUID is used for uniqueness across nodes, such that an imported sstable
@@ -573,12 +576,30 @@ struct large_data_stats_entry {
     auto describe_type(sstable_version_types v, Describer f) { return f(max_value, threshold, above_threshold); }
 };
 
+// Statistics of the values of a regular column in the rows of an sstable.
+struct column_value_stats {
+    // Rows, and rows with a live cell of the column. The others have no value
+    // (null) as far as this sstable is concerned.
+    uint64_t rows;
+    uint64_t values;
+    // Whether min_value and max_value bound the live values. They don't when
+    // there are none, or when some were too large to be tracked.
+    uint8_t bounded;
+    disk_string<uint32_t> min_value;
+    disk_string<uint32_t> max_value;
+
+    template <typename Describer>
+    auto describe_type(sstable_version_types v, Describer f) { return f(rows, values, bounded, min_value, max_value); }
+};
+
 struct scylla_metadata {
     using extension_attributes = disk_hash<uint32_t, disk_string<uint32_t>, disk_string<uint32_t>>;
     using large_data_stats = disk_hash<uint32_t, large_data_type, large_data_stats_entry>;
     using sstable_origin = disk_string<uint32_t>;
     using scylla_build_id = disk_string<uint32_t>;
     using scylla_version = disk_string<uint32_t>;
+    // Keyed by column name.
+    using column_value_stats = disk_hash<uint32_t, disk_string<uint32_t>, sstables::column_value_stats>;
 
     disk_set_of_tagged_union<scylla_metadata_type,
             disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::Sharding, sharding_metadata>,
@@ -588,7 +609,8 @@ struct scylla_metadata {
             disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::LargeDataStats, large_data_stats>,
             disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::SSTableOrigin, sstable_origin>,
             disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::ScyllaBuildId, scylla_build_id>,
-            disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::ScyllaVersion, scylla_version>
+            disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::ScyllaVersion, scylla_version>,
+            disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::ColumnValueStats, column_value_stats>
             > data;
 
     sstable_enabled_features get_features() const {
@@ -7,6 +7,7 @@
  */
 
 #include <seastar/core/coroutine.hh>
+#include <seastar/core/loop.hh>
 #include <seastar/coroutine/parallel_for_each.hh>
 #include <seastar/rpc/rpc.hh>
 #include "sstables_loader.hh"
@@ -27,6 +28,13 @@ static logging::logger llog("sstables_loader");
 
 namespace {
 
+// A fragment read from the sstables, shared by the destinations it is sent to.
+// The memory it accounts for is released once all of them have sent it.
+struct pending_fragment {
+    frozen_mutation_fragment fmf;
+    semaphore_units<> units;
+};
+
 class send_meta_data {
     gms::inet_address _node;
     seastar::rpc::sink<frozen_mutation_fragment, streaming::stream_mutation_fragments_cmd> _sink;
@@ -35,6 +43,9 @@ class send_meta_data {
     size_t _num_partitions_sent = 0;
     size_t _num_bytes_sent = 0;
     future<> _receive_done;
+    // The sends queued to the node, which are waited for in order so that a
+    // slow node does not hold back the others.
+    future<> _send_done;
 private:
     future<> do_receive() {
         int32_t status = 0;
@@ -58,25 +69,41 @@ class send_meta_data {
         : _node(std::move(node))
         , _sink(std::move(sink))
         , _source(std::move(source))
-        , _receive_done(make_ready_future<>()) {
+        , _receive_done(make_ready_future<>())
+        , _send_done(make_ready_future<>()) {
     }
     void receive() {
         _receive_done = do_receive();
     }
-    future<> send(const frozen_mutation_fragment& fmf, bool is_partition_start) {
+    // Queues the fragment behind the ones already sent to the node.
+    // Fails if a previous send did.
+    future<> send(lw_shared_ptr<pending_fragment> pf, bool is_partition_start) {
         if (_error_from_peer) {
-            throw std::runtime_error(format("send_meta_data: got error from peer node={}", _node));
+            return make_exception_future<>(std::runtime_error(format("send_meta_data: got error from peer node={}", _node)));
+        }
+        if (_send_done.failed()) {
+            return std::exchange(_send_done, make_ready_future<>());
         }
-        auto size = fmf.representation().size();
+        auto size = pf->fmf.representation().size();
         if (is_partition_start) {
             ++_num_partitions_sent;
         }
         _num_bytes_sent += size;
         llog.trace("send_meta_data: send mf to node={}, size={}", _node, size);
-        co_return co_await _sink(fmf, streaming::stream_mutation_fragments_cmd::mutation_fragment_data);
+        _send_done = _send_done.then([this, pf = std::move(pf)] {
+            return _sink(pf->fmf, streaming::stream_mutation_fragments_cmd::mutation_fragment_data);
+        });
+        return make_ready_future<>();
     }
     future<> finish(bool failed) {
         std::exception_ptr eptr;
+        try {
+            co_await std::exchange(_send_done, make_ready_future<>());
+        } catch (...) {
+            failed = true;
+            eptr = std::current_exception();
+            llog.warn("send_meta_data: failed to send mf to node={}, err={}", _node, eptr);
+        }
         try {
             if (failed) {
                 co_await _sink(frozen_mutation_fragment(bytes_ostream()), streaming::stream_mutation_fragments_cmd::error);
@@ -115,135 +142,260 @@ class send_meta_data {
 
 } // anonymous namespace
 
-future<> sstables_loader::load_and_stream(sstring ks_name, sstring cf_name,
-        ::table_id table_id, std::vector<sstables::shared_sstable> sstables, bool primary_replica_only) {
-    const auto full_partition_range = dht::partition_range::make_open_ended_both_sides();
-    const auto full_token_range = dht::token_range::make_open_ended_both_sides();
-    auto& table = _db.local().find_column_family(table_id);
-    auto s = table.schema();
-    const auto cf_id = s->id();
-    const auto reason = streaming::stream_reason::repair;
-    auto erm = _db.local().find_keyspace(ks_name).get_effective_replication_map();
+// Loads and streams the sstables of a table's upload directory, through a
+// shard_load_and_stream_task_impl on every shard. Its progress is the sum of
+// theirs, in bytes of sstables streamed, which together with the start time
+// gives the throughput of the restore.
+class load_and_stream_task_impl : public tasks::task_manager::task::impl {
+    sharded<sstables_loader>& _loader;
+    bool _primary_replica_only;
+public:
+    load_and_stream_task_impl(tasks::task_manager::module_ptr module,
+            sharded<sstables_loader>& loader,
+            sstring ks_name,
+            sstring cf_name,
+            bool primary_replica_only) noexcept
+        : tasks::task_manager::task::impl(module, tasks::task_id::create_random_id(), module->new_sequence_number(), std::move(ks_name), std::move(cf_name), "", tasks::task_id::create_null_id())
+        , _loader(loader)
+        , _primary_replica_only(primary_replica_only)
+    {
+        _status.progress_units = "bytes";
+    }
 
+    virtual std::string type() const override {
+        return "load and stream";
+    }
+
+    virtual future<tasks::task_manager::task::progress> get_progress() const override {
+        tasks::task_manager::task::progress progress;
+        for (auto& child : _children) {
+            auto p = co_await smp::submit_to(child.get_owner_shard(), [&child] {
+                return child->get_progress();
+            });
+            progress.completed += p.completed;
+            progress.total += p.total;
+        }
+        co_return progress;
+    }
+protected:
+    virtual future<> run() override;
+};
+
+class shard_load_and_stream_task_impl : public tasks::task_manager::task::impl {
+    sstables_loader& _loader;
+    ::table_id _table_id;
+    std::vector<sstables::shared_sstable> _sstables;
+    bool _primary_replica_only;
+public:
+    shard_load_and_stream_task_impl(tasks::task_manager::module_ptr module,
+            std::string ks_name,
+            std::string cf_name,
+            tasks::task_id parent_id,
+            sstables_loader& loader,
+            ::table_id table_id,
+            std::vector<sstables::shared_sstable> sstables,
+            bool primary_replica_only) noexcept
+        : tasks::task_manager::task::impl(module, tasks::task_id::create_random_id(), module->new_sequence_number(), std::move(ks_name), std::move(cf_name), "", parent_id)
+        , _loader(loader)
+        , _table_id(table_id)
+        , _sstables(std::move(sstables))
+        , _primary_replica_only(primary_replica_only)
+    {
+        _status.progress_units = "bytes";
+    }
+
+    virtual std::string type() const override {
+        return "load and stream";
+    }
+
+    virtual tasks::is_internal is_internal() const noexcept override {
+        return tasks::is_internal::yes;
+    }
+protected:
+    virtual future<> run() override {
+        return _loader.load_and_stream(_status.keyspace, _status.table, _table_id, std::move(_sstables), _primary_replica_only, _progress);
+    }
+};
+
+future<> load_and_stream_task_impl::run() {
+    // Load-and-stream reads the entire content from SSTables, therefore it can afford to discard the bloom filter
+    // that might otherwise consume a significant amount of memory.
+    sstables::sstable_open_config cfg {
+        .load_bloom_filter = false,
+    };
+    ::table_id table_id;
+    std::vector<std::vector<sstables::shared_sstable>> sstables_on_shards;
+    std::tie(table_id, sstables_on_shards) = co_await replica::distributed_loader::get_sstables_from_upload_dir(_loader.local()._db, _status.keyspace, _status.table, cfg);
+    co_await _loader.invoke_on_all([&] (sstables_loader& loader) -> future<> {
+        auto task = co_await loader._task_manager_module->make_and_start_task<shard_load_and_stream_task_impl>({_status.id, _status.shard},
+                _status.keyspace, _status.table, _status.id, loader, table_id, std::move(sstables_on_shards[this_shard_id()]), _primary_replica_only);
+        co_await task->done();
+    });
+}
+
+sstables_loader::sstables_loader(sharded<replica::database>& db,
+        sharded<db::system_distributed_keyspace>& sys_dist_ks,
+        sharded<db::view::view_update_generator>& view_update_generator,
+        netw::messaging_service& messaging,
+        tasks::task_manager& tm)
+    : _db(db)
+    , _sys_dist_ks(sys_dist_ks)
+    , _view_update_generator(view_update_generator)
+    , _messaging(messaging)
+    , _task_manager_module(make_shared<task_manager_module>(tm))
+{
+    tm.register_module(_task_manager_module->get_name(), _task_manager_module);
+}
+
+future<> sstables_loader::stop() {
+    if (auto m = std::exchange(_task_manager_module, nullptr)) {
+        co_await m->stop();
+    }
+}
+
+future<> sstables_loader::load_and_stream(sstring ks_name, sstring cf_name,
+        ::table_id table_id, std::vector<sstables::shared_sstable> sstables, bool primary_replica_only,
+        tasks::task_manager::task::progress& progress) {
     // By sorting SSTables by their primary key, we allow SSTable runs to be
     // incrementally streamed.
     // Overlapping run fragments can have their content deduplicated, reducing
     // the amount of data we need to put on the wire.
-    // Elements are popped off from the back of the vector, therefore we're sorting
-    // it in descending order, to start from the smaller tokens.
     std::ranges::sort(sstables, [] (const sstables::shared_sstable& x, const sstables::shared_sstable& y) {
-        return x->compare_by_first_key(*y) > 0;
+        return x->compare_by_first_key(*y) < 0;
     });
 
-    size_t nr_sst_total = sstables.size();
-    size_t nr_sst_current = 0;
-    while (!sstables.empty()) {
-        auto ops_uuid = streaming::plan_id{utils::make_random_uuid()};
-        auto sst_set = make_lw_shared<sstables::sstable_set>(sstables::make_partitioned_sstable_set(s, false));
-        size_t batch_sst_nr = 16;
-        std::vector<sstring> sst_names;
-        std::vector<sstables::shared_sstable> sst_processed;
-        size_t estimated_partitions = 0;
-        while (batch_sst_nr-- && !sstables.empty()) {
-            auto sst = sstables.back();
-            estimated_partitions += sst->estimated_keys_for_range(full_token_range);
-            sst_names.push_back(sst->get_filename());
-            sst_set->insert(sst);
-            sst_processed.push_back(sst);
-            sstables.pop_back();
+    const size_t batch_sst_nr = 16;
+    std::vector<std::vector<sstables::shared_sstable>> batches;
+    for (auto& sst : sstables) {
+        if (batches.empty() || batches.back().size() == batch_sst_nr) {
+            batches.emplace_back();
         }
+        progress.total += sst->bytes_on_disk();
+        batches.back().push_back(std::move(sst));
+    }
 
-        llog.info("load_and_stream: started ops_uuid={}, process [{}-{}] out of {} sstables={}",
-                ops_uuid, nr_sst_current, nr_sst_current + sst_processed.size(), nr_sst_total, sst_names);
+    llog.info("load_and_stream: ks={}, table={}, streaming {} sstables in {} batches, up to {} at a time",
+            ks_name, cf_name, sstables.size(), batches.size(), max_parallel_batches);
+    co_await max_concurrent_for_each(batches, max_parallel_batches, [&] (std::vector<sstables::shared_sstable>& batch) -> future<> {
+        uint64_t batch_bytes = 0;
+        for (auto& sst : batch) {
+            batch_bytes += sst->bytes_on_disk();
+        }
+        co_await stream_batch(ks_name, cf_name, table_id, std::move(batch), primary_replica_only);
+        progress.completed += batch_bytes;
+    });
+}
 
-        auto start_time = std::chrono::steady_clock::now();
-        inet_address_vector_replica_set current_targets;
-        std::unordered_map<gms::inet_address, send_meta_data> metas;
-        size_t num_partitions_processed = 0;
-        size_t num_bytes_read = 0;
-        nr_sst_current += sst_processed.size();
-        auto permit = co_await _db.local().obtain_reader_permit(table, "sstables_loader::load_and_stream()", db::no_timeout, {});
-        auto reader = mutation_fragment_v1_stream(table.make_streaming_reader(s, std::move(permit), full_partition_range, sst_set));
-        std::exception_ptr eptr;
-        bool failed = false;
-        try {
-            netw::messaging_service& ms = _messaging;
-            while (auto mf = co_await reader()) {
-                bool is_partition_start = mf->is_partition_start();
-                if (is_partition_start) {
-                    ++num_partitions_processed;
-                    auto& start = mf->as_partition_start();
-                    const auto& current_dk = start.key();
+future<> sstables_loader::stream_batch(sstring ks_name, sstring cf_name,
+        ::table_id table_id, std::vector<sstables::shared_sstable> sst_processed, bool primary_replica_only) {
+    const auto full_partition_range = dht::partition_range::make_open_ended_both_sides();
+    const auto full_token_range = dht::token_range::make_open_ended_both_sides();
+    auto& table = _db.local().find_column_family(table_id);
+    auto s = table.schema();
+    const auto cf_id = s->id();
+    const auto reason = streaming::stream_reason::repair;
+    auto erm = _db.local().find_keyspace(ks_name).get_effective_replication_map();
 
-                    current_targets = erm->get_natural_endpoints(current_dk.token());
-                    if (primary_replica_only && current_targets.size() > 1) {
-                        current_targets.resize(1);
-                    }
-                    llog.trace("load_and_stream: ops_uuid={}, current_dk={}, current_targets={}", ops_uuid,
-                            current_dk.token(), current_targets);
-                    for (auto& node : current_targets) {
-                        if (!metas.contains(node)) {
-                            auto [sink, source] = co_await ms.make_sink_and_source_for_stream_mutation_fragments(reader.schema()->version(),
-                                    ops_uuid, cf_id, estimated_partitions, reason, netw::messaging_service::msg_addr(node));
-                            llog.debug("load_and_stream: ops_uuid={}, make sink and source for node={}", ops_uuid, node);
-                            metas.emplace(node, send_meta_data(node, std::move(sink), std::move(source)));
-                            metas.at(node).receive();
-                        }
+    auto ops_uuid = streaming::plan_id{utils::make_random_uuid()};
+    auto sst_set = make_lw_shared<sstables::sstable_set>(sstables::make_partitioned_sstable_set(s, false));
+    std::vector<sstring> sst_names;
+    size_t estimated_partitions = 0;
+    for (auto& sst : sst_processed) {
+        estimated_partitions += sst->estimated_keys_for_range(full_token_range);
+        sst_names.push_back(sst->get_filename());
+        sst_set->insert(sst);
+    }
+
+    llog.info("load_and_stream: started ops_uuid={}, process {} sstables={}",
+            ops_uuid, sst_processed.size(), sst_names);
+    auto start_time = std::chrono::steady_clock::now();
+    inet_address_vector_replica_set current_targets;
+    std::unordered_map<gms::inet_address, send_meta_data> metas;
+    size_t num_partitions_processed = 0;
+    size_t num_bytes_read = 0;
+    auto permit = co_await _db.local().obtain_reader_permit(table, "sstables_loader::load_and_stream()", db::no_timeout, {});
+    auto reader = mutation_fragment_v1_stream(table.make_streaming_reader(s, std::move(permit), full_partition_range, sst_set));
+    std::exception_ptr eptr;
+    bool failed = false;
+    try {
+        netw::messaging_service& ms = _messaging;
+        while (auto mf = co_await reader()) {
+            bool is_partition_start = mf->is_partition_start();
+            if (is_partition_start) {
+                ++num_partitions_processed;
+                auto& start = mf->as_partition_start();
+                const auto& current_dk = start.key();
+
+                current_targets = erm->get_natural_endpoints(current_dk.token());
+                if (primary_replica_only && current_targets.size() > 1) {
+                    current_targets.resize(1);
+                }
+                llog.trace("load_and_stream: ops_uuid={}, current_dk={}, current_targets={}", ops_uuid,
+                        current_dk.token(), current_targets);
+                for (auto& node : current_targets) {
+                    if (!metas.contains(node)) {
+                        auto [sink, source] = co_await ms.make_sink_and_source_for_stream_mutation_fragments(reader.schema()->version(),
+                                ops_uuid, cf_id, estimated_partitions, reason, netw::messaging_service::msg_addr(node));
+                        llog.debug("load_and_stream: ops_uuid={}, make sink and source for node={}", ops_uuid, node);
+                        metas.emplace(node, send_meta_data(node, std::move(sink), std::move(source)));
+                        metas.at(node).receive();
                     }
                 }
-                frozen_mutation_fragment fmf = freeze(*s, *mf);
-                num_bytes_read += fmf.representation().size();
-                co_await coroutine::parallel_for_each(current_targets, [&metas, &fmf, is_partition_start] (const gms::inet_address& node) {
-                    return metas.at(node).send(fmf, is_partition_start);
-                });
             }
-        } catch (...) {
-            failed = true;
-            eptr = std::current_exception();
-            llog.warn("load_and_stream: ops_uuid={}, ks={}, table={}, send_phase, err={}",
-                    ops_uuid, ks_name, cf_name, eptr);
+            frozen_mutation_fragment fmf = freeze(*s, *mf);
+            auto size = fmf.representation().size();
+            num_bytes_read += size;
+            auto units = co_await get_units(_memory_sem, std::min(size, max_in_flight_bytes));
+            auto pf = make_lw_shared<pending_fragment>(std::move(fmf), std::move(units));
+            for (auto& node : current_targets) {
+                co_await metas.at(node).send(pf, is_partition_start);
+            }
         }
-        co_await reader.close();
+    } catch (...) {
+        failed = true;
+        eptr = std::current_exception();
+        llog.warn("load_and_stream: ops_uuid={}, ks={}, table={}, send_phase, err={}",
+                ops_uuid, ks_name, cf_name, eptr);
+    }
+    co_await reader.close();
+    try {
+        co_await coroutine::parallel_for_each(metas.begin(), metas.end(), [failed] (std::pair<const gms::inet_address, send_meta_data>& pair) {
+            auto& meta = pair.second;
+            return meta.finish(failed);
+        });
+    } catch (...) {
+        failed = true;
+        eptr = std::current_exception();
+        llog.warn("load_and_stream: ops_uuid={}, ks={}, table={}, finish_phase, err={}",
+                ops_uuid, ks_name, cf_name, eptr);
+    }
+    if (!failed) {
         try {
-            co_await coroutine::parallel_for_each(metas.begin(), metas.end(), [failed] (std::pair<const gms::inet_address, send_meta_data>& pair) {
-                auto& meta = pair.second;
-                return meta.finish(failed);
+            co_await coroutine::parallel_for_each(sst_processed, [&] (sstables::shared_sstable& sst) {
+                llog.debug("load_and_stream: ops_uuid={}, ks={}, table={}, remove sst={}",
+                        ops_uuid, ks_name, cf_name, sst->component_filenames());
+                return sst->unlink();
             });
         } catch (...) {
             failed = true;
             eptr = std::current_exception();
-            llog.warn("load_and_stream: ops_uuid={}, ks={}, table={}, finish_phase, err={}",
+            llog.warn("load_and_stream: ops_uuid={}, ks={}, table={}, del_sst_phase, err={}",
                     ops_uuid, ks_name, cf_name, eptr);
         }
-        if (!failed) {
-            try {
-                co_await coroutine::parallel_for_each(sst_processed, [&] (sstables::shared_sstable& sst) {
-                    llog.debug("load_and_stream: ops_uuid={}, ks={}, table={}, remove sst={}",
-                            ops_uuid, ks_name, cf_name, sst->component_filenames());
-                    return sst->unlink();
-                });
-            } catch (...) {
-                failed = true;
-                eptr = std::current_exception();
-                llog.warn("load_and_stream: ops_uuid={}, ks={}, table={}, del_sst_phase, err={}",
-                        ops_uuid, ks_name, cf_name, eptr);
-            }
-        }
-        auto duration = std::chrono::duration_cast<std::chrono::duration<float>>(std::chrono::steady_clock::now() - start_time).count();
-        for (auto& [node, meta] : metas) {
-            llog.info("load_and_stream: ops_uuid={}, ks={}, table={}, target_node={}, num_partitions_sent={}, num_bytes_sent={}",
-                    ops_uuid, ks_name, cf_name, node, meta.num_partitions_sent(), meta.num_bytes_sent());
-        }
-        auto partition_rate = std::fabs(duration) > FLT_EPSILON ? num_partitions_processed / duration : 0;
-        auto bytes_rate = std::fabs(duration) > FLT_EPSILON ? num_bytes_read / duration / 1024 / 1024 : 0;
-        auto status = failed ? "failed" : "succeeded";
-        llog.info("load_and_stream: finished ops_uuid={}, ks={}, table={}, partitions_processed={} partitions, bytes_processed={} bytes, partitions_per_second={} partitions/s, bytes_per_second={} MiB/s, duration={} s, status={}",
-                ops_uuid, ks_name, cf_name, num_partitions_processed, num_bytes_read, partition_rate, bytes_rate, duration, status);
-        if (failed) {
-            std::rethrow_exception(eptr);
-        }
     }
-    co_return;
+    auto duration = std::chrono::duration_cast<std::chrono::duration<float>>(std::chrono::steady_clock::now() - start_time).count();
+    for (auto& [node, meta] : metas) {
+        llog.info("load_and_stream: ops_uuid={}, ks={}, table={}, target_node={}, num_partitions_sent={}, num_bytes_sent={}",
+                ops_uuid, ks_name, cf_name, node, meta.num_partitions_sent(), meta.num_bytes_sent());
+    }
+    auto partition_rate = std::fabs(duration) > FLT_EPSILON ? num_partitions_processed / duration : 0;
+    auto bytes_rate = std::fabs(duration) > FLT_EPSILON ? num_bytes_read / duration / 1024 / 1024 : 0;
+    auto status = failed ? "failed" : "succeeded";
+    llog.info("load_and_stream: finished ops_uuid={}, ks={}, table={}, partitions_processed={} partitions, bytes_processed={} bytes, partitions_per_second={} partitions/s, bytes_per_second={} MiB/s, duration={} s, status={}",
+            ops_uuid, ks_name, cf_name, num_partitions_processed, num_bytes_read, partition_rate, bytes_rate, duration, status);
+    if (failed) {
+        std::rethrow_exception(eptr);
+    }
 }
 
 // For more details, see the commends on column_family::load_new_sstables
@@ -260,17 +412,8 @@ future<> sstables_loader::load_new_sstables(sstring ks_name, sstring cf_name,
             ks_name, cf_name, load_and_stream, primary_replica_only);
     try {
         if (load_and_stream) {
-            ::table_id table_id;
-            std::vector<std::vector<sstables::shared_sstable>> sstables_on_shards;
-            // Load-and-stream reads the entire content from SSTables, therefore it can afford to discard the bloom filter
-            // that might otherwise consume a significant amount of memory.
-            sstables::sstable_open_config cfg {
-                .load_bloom_filter = false,
-            };
-            std::tie(table_id, sstables_on_shards) = co_await replica::distributed_loader::get_sstables_from_upload_dir(_db, ks_name, cf_name, cfg);
-            co_await container().invoke_on_all([&sstables_on_shards, ks_name, cf_name, table_id, primary_replica_only] (sstables_loader& loader) mutable -> future<> {
-                co_await loader.load_and_stream(ks_name, cf_name, table_id, std::move(sstables_on_shards[this_shard_id()]), primary_replica_only);
-            });
+            auto task = co_await _task_manager_module->make_and_start_task<load_and_stream_task_impl>({}, container(), ks_name, cf_name, primary_replica_only);
+            co_await task->done();
         } else {
             co_await replica::distributed_loader::process_upload_dir(_db, _sys_dist_ks, _view_update_generator, ks_name, cf_name);
         }
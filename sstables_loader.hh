@@ -8,9 +8,11 @@
 
 #pragma once
 
+#include <seastar/core/semaphore.hh>
 #include <seastar/core/sharded.hh>
 #include "schema/schema_fwd.hh"
 #include "sstables/shared_sstable.hh"
+#include "tasks/task_manager.hh"
 
 using namespace seastar;
 
@@ -31,10 +33,24 @@ class view_update_generator;
 // Gets sstables from the upload directory and makes them available in the
 // system. Built on top of the distributed_loader functionality.
 class sstables_loader : public seastar::peering_sharded_service<sstables_loader> {
+public:
+    class task_manager_module : public tasks::task_manager::module {
+    public:
+        task_manager_module(tasks::task_manager& tm) noexcept : tasks::task_manager::module(tm, "sstables_loader") {}
+    };
+
+    // Batches of sstables streamed concurrently by each shard.
+    static constexpr size_t max_parallel_batches = 4;
+    // Bytes of frozen fragments each shard may have in flight to all the
+    // destinations, before reading waits for the slowest of them.
+    static constexpr size_t max_in_flight_bytes = 16 << 20;
+private:
     sharded<replica::database>& _db;
     sharded<db::system_distributed_keyspace>& _sys_dist_ks;
     sharded<db::view::view_update_generator>& _view_update_generator;
     netw::messaging_service& _messaging;
+    shared_ptr<task_manager_module> _task_manager_module;
+    semaphore _memory_sem{max_in_flight_bytes};
 
     // Note that this is obviously only valid for the current shard. Users of
     // this facility should elect a shard to be the coordinator based on any
@@ -45,20 +61,23 @@ class sstables_loader : public seastar::peering_sharded_service<sstables_loader>
     bool _loading_new_sstables = false;
 
     future<> load_and_stream(sstring ks_name, sstring cf_name,
+            table_id, std::vector<sstables::shared_sstable> sstables,
+            bool primary_replica_only, tasks::task_manager::task::progress& progress);
+    future<> stream_batch(sstring ks_name, sstring cf_name,
             table_id, std::vector<sstables::shared_sstable> sstables,
             bool primary_replica_only);
 
+    friend class load_and_stream_task_impl;
+    friend class shard_load_and_stream_task_impl;
+
 public:
     sstables_loader(sharded<replica::database>& db,
             sharded<db::system_distributed_keyspace>& sys_dist_ks,
             sharded<db::view::view_update_generator>& view_update_generator,
-            netw::messaging_service& messaging)
-        : _db(db)
-        , _sys_dist_ks(sys_dist_ks)
-        , _view_update_generator(view_update_generator)
-        , _messaging(messaging)
-    {
-    }
+            netw::messaging_service& messaging,
+            tasks::task_manager& tm);
+
+    future<> stop();
 
     /**
      * Load new SSTables not currently tracked by the system
@@ -60,6 +60,19 @@ stream_manager::stream_manager(db::config& cfg,
         sm::make_counter("total_outgoing_bytes", [this] { return _total_outgoing_bytes; },
                         sm::description("Total number of bytes sent on this shard.")),
 
+        sm::make_counter("sstables_sent_as_files", [this] { return _sstable_file_stats.sent; },
+                        sm::description("Number of sstables sent by this shard as their files, instead of their rows.")),
+
+        sm::make_counter("sstables_sent_as_files_failures", [this] { return _sstable_file_stats.send_failures; },
+                        sm::description("Number of sstables which this shard failed to send as files, and sent their rows instead.")),
+
+        sm::make_counter("sstables_received_as_files", [this] { return _sstable_file_stats.received; },
+                        sm::description("Number of sstables received by this shard as their files.")),
+
+        sm::make_counter("sstables_received_as_files_rewritten", [this] { return _sstable_file_stats.rewritten; },
+                        sm::description("Number of sstables received by this shard as their files, whose rows had to be written to sstables "
+                                        "of their shards, since they weren't of this shard alone.")),
+
         sm::make_gauge("finished_percentage", [this] { return _finished_percentage[streaming::stream_reason::bootstrap]; },
                 sm::description("Finished percentage of node operation on this shard"), {ops_label_type("bootstrap")}),
 
@@ -73,6 +73,18 @@ struct stream_bytes {
  * All stream operation should be created through this class to track streaming status and progress.
  */
 class stream_manager : public gms::i_endpoint_state_change_subscriber, public enable_shared_from_this<stream_manager>, public peering_sharded_service<stream_manager> {
+public:
+    // Of the sstables streamed as files, see STREAM_SSTABLE_FILES.
+    struct sstable_file_stats {
+        uint64_t sent = 0;
+        // Sent as mutation fragments instead.
+        uint64_t send_failures = 0;
+        uint64_t received = 0;
+        // Received sstables which weren't of the receiving shard alone, so
+        // their rows were written to new sstables of their shards.
+        uint64_t rewritten = 0;
+    };
+private:
     using inet_address = gms::inet_address;
     using endpoint_state = gms::endpoint_state;
     using application_state = gms::application_state;
@@ -96,6 +108,7 @@ class stream_manager : public gms::i_endpoint_state_change_subscriber, public en
     uint64_t _total_incoming_bytes{0};
     uint64_t _total_outgoing_bytes{0};
     semaphore _mutation_send_limiter{256};
+    sstable_file_stats _sstable_file_stats;
     seastar::metrics::metric_groups _metrics;
     std::unordered_map<streaming::stream_reason, float> _finished_percentage;
 
@@ -116,6 +129,8 @@ class stream_manager : public gms::i_endpoint_state_change_subscriber, public en
 
     semaphore& mutation_send_limiter() { return _mutation_send_limiter; }
 
+    sstable_file_stats& get_sstable_file_stats() noexcept { return _sstable_file_stats; }
+
     void register_sending(shared_ptr<stream_result_future> result);
 
     void register_receiving(shared_ptr<stream_result_future> result);
@@ -17,6 +17,7 @@
 #include "streaming/stream_manager.hh"
 #include "dht/i_partitioner.hh"
 #include "utils/fb_utilities.hh"
+#include "utils/error_injection.hh"
 #include "streaming/stream_plan.hh"
 #include <seastar/core/sleep.hh>
 #include <seastar/core/thread.hh>
@@ -35,8 +36,12 @@
 #include "replica/database.hh"
 #include "mutation/mutation_source_metadata.hh"
 #include "streaming/stream_mutation_fragments_cmd.hh"
+#include "streaming/stream_sstable_files_cmd.hh"
 #include "consumer.hh"
 #include "readers/generating_v2.hh"
+#include "sstables/sstables.hh"
+#include "sstables/sstables_manager.hh"
+#include "db/view/view_update_generator.hh"
 
 namespace streaming {
 
@@ -87,6 +92,94 @@ class offstrategy_trigger {
     }
 };
 
+// Writes the components of an sstable streamed by STREAM_SSTABLE_FILES to a
+// new sstable, and adds it to the table. If the sstable isn't of this shard
+// alone, since sharding differs on the sender, its rows are written anew to
+// sstables of their shards, as if they were streamed.
+static future<> receive_sstable_files(stream_manager& sm, sharded<replica::database>& db, sharded<db::system_distributed_keyspace>& sys_dist_ks,
+        sharded<db::view::view_update_generator>& vug, streaming::plan_id plan_id, netw::messaging_service::msg_addr from, schema_ptr s,
+        stream_reason reason, sstables::sstable_version_types version, sstables::sstable_format_types format, std::vector<sstring> components,
+        rpc::source<bytes, stream_sstable_files_cmd> source) {
+    auto& pc = service::get_local_streaming_priority();
+    auto cf = db.local().find_column_family(s->id()).shared_from_this();
+    auto op = cf->stream_in_progress();
+    auto offstrategy = is_offstrategy_supported(reason);
+    offstrategy_trigger offstrategy_update(db, s->id(), plan_id);
+    auto use_view_update_path = co_await db::view::check_needs_view_update_path(sys_dist_ks.local(), db.local().get_token_metadata(), *cf, reason);
+    auto sst = use_view_update_path
+            ? cf->make_streamed_sstable(version, format, sstring(sstables::staging_dir))
+            : cf->make_streamed_sstable(version, format);
+    co_await sst->open_for_streamed_components(components, pc);
+    for (auto& c : components) {
+        auto out = co_await sst->make_streamed_component_output_stream(c, pc);
+        std::exception_ptr ex;
+        try {
+            for (;;) {
+                auto opt = co_await source();
+                if (!opt) {
+                    throw std::runtime_error("Sender did not send end_of_file");
+                }
+                auto& [data, cmd] = *opt;
+                if (cmd == stream_sstable_files_cmd::end_of_file) {
+                    break;
+                } else if (cmd == stream_sstable_files_cmd::error) {
+                    throw std::runtime_error("Sender failed");
+                } else if (cmd != stream_sstable_files_cmd::file_data) {
+                    throw std::runtime_error("Sender sent wrong cmd");
+                }
+                co_await out.write(reinterpret_cast<const char*>(data.data()), data.size());
+                sm.update_progress(plan_id, from.addr, progress_info::direction::IN, data.size());
+                offstrategy_update.update();
+            }
+            co_await out.flush();
+        } catch (...) {
+            ex = std::current_exception();
+        }
+        co_await out.close();
+        if (ex) {
+            std::rethrow_exception(std::move(ex));
+        }
+    }
+    auto opt = co_await source();
+    if (!opt || std::get<1>(*opt) != stream_sstable_files_cmd::end_of_stream) {
+        throw std::runtime_error("Sender did not send end_of_stream");
+    }
+    co_await sst->seal_sstable(cf->incremental_backups_enabled());
+    try {
+        co_await sst->load(pc);
+    } catch (...) {
+        sst->mark_for_deletion();
+        throw;
+    }
+    ++sm.get_sstable_file_stats().received;
+    if (sst->get_shards_for_this_sstable() == std::vector<unsigned>{this_shard_id()}) {
+        sslog.debug("[Stream #{}] Received sstable {} for ks={}, cf={} as files from {}", plan_id, sst->get_filename(), s->ks_name(), s->cf_name(), from.addr);
+        co_await cf->add_sstable_and_update_cache(sst, offstrategy);
+        if (use_view_update_path) {
+            co_await vug.local().register_staging_sstable(sst, std::move(cf));
+        }
+        co_return;
+    }
+    ++sm.get_sstable_file_stats().rewritten;
+    sslog.debug("[Stream #{}] Received sstable {} for ks={}, cf={} as files from {}, not of this shard alone, rewriting it", plan_id, sst->get_filename(),
+            s->ks_name(), s->cf_name(), from.addr);
+    auto permit = co_await db.local().obtain_reader_permit(s, "stream-session", db::no_timeout, {});
+    auto reader = sst->make_reader(s, std::move(permit), query::full_partition_range, s->full_slice(), pc, {},
+            streamed_mutation::forwarding::no, mutation_reader::forwarding::no);
+    std::exception_ptr ex;
+    try {
+        co_await mutation_writer::distribute_reader_and_consume_on_shards(s, std::move(reader),
+                make_streaming_consumer("streaming", db, sys_dist_ks, vug, sst->get_estimated_key_count(), reason, offstrategy),
+                std::move(op));
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    sst->mark_for_deletion();
+    if (ex) {
+        std::rethrow_exception(std::move(ex));
+    }
+}
+
 void stream_manager::init_messaging_service_handler() {
     auto& ms = _ms.local();
 
@@ -147,6 +240,8 @@ void stream_manager::init_messaging_service_handler() {
                                 return make_exception_future<mutation_fragment_opt>(std::runtime_error("Sender sent wrong cmd"));
                             }
                         }
+                        utils::get_local_injector().inject("stream_mutation_fragments_rx_error",
+                            [] { throw std::runtime_error("stream_mutation_fragments_rx_error"); });
                         frozen_mutation_fragment& fmf = std::get<0>(*opt);
                         auto sz = fmf.representation().size();
                         auto mf = fmf.unfreeze(*s, permit);
@@ -203,6 +298,39 @@ void stream_manager::init_messaging_service_handler() {
         });
       });
     });
+    ms.register_stream_sstable_files([this] (const rpc::client_info& cinfo, streaming::plan_id plan_id, table_schema_version schema_id, table_id cf_id, stream_reason reason,
+            sstring version, sstring format, std::vector<sstring> components, rpc::source<bytes, stream_sstable_files_cmd> source) -> future<rpc::sink<int32_t>> {
+        auto from = netw::messaging_service::get_source(cinfo);
+        sslog.trace("Got stream_sstable_files from {} reason {}", from, int(reason));
+        if (!_sys_dist_ks.local_is_initialized() || !_view_update_generator.local_is_initialized()) {
+            throw std::runtime_error(format("Node {} is not fully initialized for streaming, try again later",
+                    utils::fb_utilities::get_broadcast_address()));
+        }
+        auto v = sstables::version_from_string(version);
+        auto f = sstables::format_from_string(format);
+        auto s = co_await _mm.local().get_schema_for_write(schema_id, from, _ms.local());
+        if (v > _db.local().find_column_family(cf_id).get_sstables_manager().get_highest_supported_format()) {
+            throw std::runtime_error(format("Node {} does not support sstables of version {} yet", utils::fb_utilities::get_broadcast_address(), version));
+        }
+        auto sink = _ms.local().make_sink_for_stream_sstable_files(source);
+        //FIXME: discarded future.
+        (void)receive_sstable_files(*this, _db, _sys_dist_ks, _view_update_generator, plan_id, from, s, reason, v, f, std::move(components), std::move(source))
+                .then_wrapped([s, plan_id, from, sink] (future<> f) mutable {
+            int32_t status = 0;
+            if (f.failed()) {
+                sslog.error("[Stream #{}] Failed to handle STREAM_SSTABLE_FILES (receive phase) for ks={}, cf={}, peer={}: {}",
+                        plan_id, s->ks_name(), s->cf_name(), from.addr, f.get_exception());
+                status = -1;
+            }
+            return sink(status).finally([sink] () mutable {
+                return sink.close();
+            });
+        }).handle_exception([s, plan_id, from] (std::exception_ptr ep) {
+            sslog.error("[Stream #{}] Failed to handle STREAM_SSTABLE_FILES (respond phase) for ks={}, cf={}, peer={}: {}",
+                    plan_id, s->ks_name(), s->cf_name(), from.addr, ep);
+        });
+        co_return sink;
+    });
     ms.register_stream_mutation_done([this] (const rpc::client_info& cinfo, streaming::plan_id plan_id, dht::token_range_vector ranges, table_id cf_id, unsigned dst_cpu_id) {
         const auto& from = cinfo.retrieve_auxiliary<gms::inet_address>("baddr");
         return container().invoke_on(dst_cpu_id, [ranges = std::move(ranges), plan_id, cf_id, from] (auto& sm) mutable {
@@ -233,6 +361,7 @@ future<> stream_manager::uninit_messaging_service_handler() {
         ms.unregister_prepare_message(),
         ms.unregister_prepare_done_message(),
         ms.unregister_stream_mutation_fragments(),
+        ms.unregister_stream_sstable_files(),
         ms.unregister_stream_mutation_done(),
         ms.unregister_complete_message()).discard_result();
 }
@@ -0,0 +1,26 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace streaming {
+
+// Sent along the content of the component files of an sstable streamed with
+// STREAM_SSTABLE_FILES, in the order of the components of the request.
+enum class stream_sstable_files_cmd : uint8_t {
+    error,
+    // A chunk of the current component.
+    file_data,
+    // The current component is complete, the next chunks are of the next one.
+    end_of_file,
+    end_of_stream,
+};
+
+}
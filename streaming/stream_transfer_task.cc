@@ -16,6 +16,7 @@
 #include "streaming/stream_manager.hh"
 #include "streaming/stream_reason.hh"
 #include "streaming/stream_mutation_fragments_cmd.hh"
+#include "streaming/stream_sstable_files_cmd.hh"
 #include "readers/mutation_fragment_v1_stream.hh"
 #include "mutation/mutation_fragment_stream_validator.hh"
 #include "mutation/frozen_mutation.hh"
@@ -26,11 +27,15 @@
 #include "dht/sharder.hh"
 #include "service/priority_manager.hh"
 #include <boost/range/irange.hpp>
+#include <boost/algorithm/cxx11/any_of.hpp>
 #include <boost/icl/interval.hpp>
 #include <boost/icl/interval_set.hpp>
 #include "sstables/sstables.hh"
 #include "replica/database.hh"
 #include "gms/feature_service.hh"
+#include "db/config.hh"
+#include <seastar/core/coroutine.hh>
+#include <seastar/coroutine/maybe_yield.hh>
 
 namespace streaming {
 
@@ -59,9 +64,12 @@ struct send_info {
     dht::partition_range_vector prs;
     mutation_fragment_v1_stream reader;
     noncopyable_function<void(size_t)> update;
+    // Overrides the estimate of estimate_partitions().
+    std::optional<size_t> estimated_partitions;
     send_info(netw::messaging_service& ms_, streaming::plan_id plan_id_, replica::table& tbl_, reader_permit permit_,
               dht::token_range_vector ranges_, netw::messaging_service::msg_addr id_,
-              uint32_t dst_cpu_id_, stream_reason reason_, noncopyable_function<void(size_t)> update_fn)
+              uint32_t dst_cpu_id_, stream_reason reason_, noncopyable_function<void(size_t)> update_fn,
+              std::vector<sstables::shared_sstable> excluded = {})
         : ms(ms_)
         , plan_id(plan_id_)
         , cf_id(tbl_.schema()->id())
@@ -71,7 +79,28 @@ struct send_info {
         , cf(tbl_)
         , ranges(std::move(ranges_))
         , prs(dht::to_partition_ranges(ranges))
-        , reader(cf.make_streaming_reader(cf.schema(), std::move(permit_), prs))
+        , reader(excluded.empty()
+                ? cf.make_streaming_reader(cf.schema(), std::move(permit_), prs)
+                : cf.make_streaming_reader(cf.schema(), std::move(permit_), prs, std::move(excluded)))
+        , update(std::move(update_fn))
+    {
+    }
+    // Sends the rows of sst alone.
+    send_info(netw::messaging_service& ms_, streaming::plan_id plan_id_, replica::table& tbl_, reader_permit permit_,
+              dht::token_range_vector ranges_, netw::messaging_service::msg_addr id_,
+              uint32_t dst_cpu_id_, stream_reason reason_, noncopyable_function<void(size_t)> update_fn,
+              sstables::shared_sstable sst)
+        : ms(ms_)
+        , plan_id(plan_id_)
+        , cf_id(tbl_.schema()->id())
+        , id(id_)
+        , dst_cpu_id(dst_cpu_id_)
+        , reason(reason_)
+        , cf(tbl_)
+        , ranges(std::move(ranges_))
+        , prs(dht::to_partition_ranges(ranges))
+        , reader(sst->make_reader(cf.schema(), std::move(permit_), query::full_partition_range, cf.schema()->full_slice(),
+                service::get_local_streaming_priority(), {}, streamed_mutation::forwarding::no, mutation_reader::forwarding::no))
         , update(std::move(update_fn))
     {
     }
@@ -94,6 +123,9 @@ struct send_info {
         });
     }
     future<size_t> estimate_partitions() {
+        if (estimated_partitions) {
+            return make_ready_future<size_t>(*estimated_partitions);
+        }
         return do_with(cf.get_sstables(), size_t(0), [this] (auto& sstables, size_t& partition_count) {
             return do_for_each(*sstables, [this, &partition_count] (auto& sst) {
                 return do_for_each(ranges, [&sst, &partition_count] (auto& range) {
@@ -186,6 +218,179 @@ future<> send_mutation_fragments(lw_shared_ptr<send_info> si) {
  });
 }
 
+// Picks the sstables which can be streamed as files: those of this shard
+// alone, whose tokens all fall in one of the ranges, so that the receiver
+// can use them as is.
+static std::vector<sstables::shared_sstable> sstables_to_stream_as_files(stream_manager& sm, replica::table& tbl, const dht::token_range_vector& ranges) {
+    std::vector<sstables::shared_sstable> ret;
+    if (!sm.db().features().sstable_file_streaming || !sm.db().get_config().enable_sstable_file_streaming()) {
+        return ret;
+    }
+    auto sstables = tbl.get_sstables();
+    for (auto& sst : *sstables) {
+        if (!sst->can_stream_components() || sst->get_shards_for_this_sstable() != std::vector<unsigned>{this_shard_id()}) {
+            continue;
+        }
+        auto first = sst->get_first_decorated_key().token();
+        auto last = sst->get_last_decorated_key().token();
+        if (boost::algorithm::any_of(ranges, [&] (const dht::token_range& r) {
+            return r.contains(first, dht::token_comparator()) && r.contains(last, dht::token_comparator());
+        })) {
+            ret.push_back(sst);
+        }
+    }
+    return ret;
+}
+
+static future<> send_sstable_files(send_info& si, netw::messaging_service::msg_addr id, sstables::shared_sstable sst) {
+    auto& pc = service::get_local_streaming_priority();
+    auto components = sst->streamed_components();
+    // Open all the components before sending any, so that if sst was
+    // compacted and deleted meanwhile, it is noticed before the peer writes
+    // anything, and they can all be read if it is deleted later.
+    std::vector<input_stream<char>> inputs;
+    inputs.reserve(components.size());
+    std::exception_ptr ex;
+    try {
+        for (auto& c : components) {
+            inputs.push_back(co_await sst->make_streamed_component_input_stream(c, pc));
+        }
+        sslog.debug("[Stream #{}] Start sending sstable {} of ks={}, cf={} as files, size={}", si.plan_id, sst->get_filename(),
+                si.cf.schema()->ks_name(), si.cf.schema()->cf_name(), sst->bytes_on_disk());
+        auto [sink, source] = co_await si.ms.make_sink_and_source_for_stream_sstable_files(si.cf.schema()->version(), si.plan_id, si.cf_id, si.reason,
+                fmt::to_string(sst->get_version()), fmt::to_string(sst->get_format()), components, id);
+        bool got_error_from_peer = false;
+        auto source_op = [&] () -> future<> {
+            // Keep reading until EOS, as with STREAM_MUTATION_FRAGMENTS.
+            while (auto status_opt = co_await source()) {
+                got_error_from_peer = std::get<0>(*status_opt) == -1;
+            }
+        };
+        auto sink_op = [&] () -> future<> {
+            std::exception_ptr ex;
+            try {
+                for (auto& in : inputs) {
+                    for (;;) {
+                        auto buf = co_await in.read();
+                        if (got_error_from_peer) {
+                            throw std::runtime_error("Got status error code from peer");
+                        }
+                        if (buf.empty()) {
+                            break;
+                        }
+                        si.update(buf.size());
+                        co_await sink(bytes(reinterpret_cast<const bytes::value_type*>(buf.get()), buf.size()), stream_sstable_files_cmd::file_data);
+                    }
+                    co_await sink(bytes(), stream_sstable_files_cmd::end_of_file);
+                }
+                co_await sink(bytes(), stream_sstable_files_cmd::end_of_stream);
+            } catch (...) {
+                ex = std::current_exception();
+            }
+            if (ex) {
+                // Notify the receiver the sender has failed
+                co_await sink(bytes(), stream_sstable_files_cmd::error).handle_exception([] (std::exception_ptr) {});
+            }
+            co_await sink.close();
+            if (ex) {
+                std::rethrow_exception(std::move(ex));
+            }
+        };
+        co_await when_all_succeed(source_op(), sink_op()).discard_result();
+        if (got_error_from_peer) {
+            throw std::runtime_error(format("Peer failed to process sstable files peer={}, plan_id={}, cf_id={}", id.addr, si.plan_id, si.cf_id));
+        }
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    for (auto& in : inputs) {
+        co_await in.close();
+    }
+    if (ex) {
+        std::rethrow_exception(std::move(ex));
+    }
+}
+
+// Sends the sstables as files, or their rows if that fails, to the shard of
+// the receiver owning them, if known.
+static future<> send_sstables_as_files(stream_manager& sm, lw_shared_ptr<send_info> si, reader_permit permit, std::vector<sstables::shared_sstable> sstables,
+        std::function<void(size_t)> update) {
+    auto& stats = sm.get_sstable_file_stats();
+    std::vector<sstables::shared_sstable> failed;
+    for (auto& sst : sstables) {
+        try {
+            co_await send_sstable_files(*si, si->ms.addr_for(si->id.addr, sst->get_first_decorated_key().token()), sst);
+            ++stats.sent;
+        } catch (...) {
+            ++stats.send_failures;
+            sslog.warn("[Stream #{}] Failed to send sstable {} of ks={}, cf={} as files to {}, sending its mutation fragments instead: {}",
+                    si->plan_id, sst->get_filename(), si->cf.schema()->ks_name(), si->cf.schema()->cf_name(), si->id.addr, std::current_exception());
+            failed.push_back(sst);
+        }
+    }
+    for (auto& sst : failed) {
+        auto fsi = make_lw_shared<send_info>(si->ms, si->plan_id, si->cf, permit, si->ranges,
+                si->ms.addr_for(si->id.addr, sst->get_first_decorated_key().token()), si->dst_cpu_id, si->reason, update, sst);
+        std::exception_ptr ex;
+        try {
+            co_await send_mutation_fragments(fsi);
+        } catch (...) {
+            ex = std::current_exception();
+        }
+        co_await fsi->reader.close();
+        if (ex) {
+            std::rethrow_exception(std::move(ex));
+        }
+    }
+}
+
+// Sends the rows of the ranges held by this shard. If the sharding of the
+// receiver is known, and connections land on the shard they are made to,
+// the ranges are split by the shards of the receiver and the rows of each
+// shard are sent to it, so that the receiver writes them to sstables of
+// the shard receiving them, instead of forwarding them to their shards.
+static future<> send_ranges(lw_shared_ptr<send_info> si, reader_permit permit, std::vector<sstables::shared_sstable> excluded,
+        std::function<void(size_t)> update) {
+    auto sharding = si->ms.get_peer_sharding(si->id.addr);
+    if (!sharding || sharding->shard_count <= 1) {
+        co_await send_mutation_fragments(std::move(si));
+        co_return;
+    }
+    dht::sharder sharder(sharding->shard_count, sharding->ignore_msb);
+    // Estimating the partitions of each shard would be as costly as of all
+    // of them, for each shard, as they hold interleaved ranges.
+    auto estimated_partitions = co_await si->estimate_partitions() / sharder.shard_count();
+    for (unsigned i = 0; i < sharder.shard_count(); ++i) {
+        // Start from a different receiving shard on each shard, so that
+        // they don't all send to the same ones at the same time.
+        auto shard = (this_shard_id() + i) % sharder.shard_count();
+        dht::token_range_vector ranges;
+        for (const auto& range : si->ranges) {
+            auto range_sharder = dht::selective_token_range_sharder(sharder, range, shard);
+            while (auto shard_range = range_sharder.next()) {
+                ranges.push_back(std::move(*shard_range));
+            }
+            co_await coroutine::maybe_yield();
+        }
+        if (ranges.empty()) {
+            continue;
+        }
+        auto ssi = make_lw_shared<send_info>(si->ms, si->plan_id, si->cf, permit, std::move(ranges),
+                netw::messaging_service::msg_addr{si->id.addr, shard}, si->dst_cpu_id, si->reason, update, excluded);
+        ssi->estimated_partitions = estimated_partitions;
+        std::exception_ptr ex;
+        try {
+            co_await send_mutation_fragments(ssi);
+        } catch (...) {
+            ex = std::current_exception();
+        }
+        co_await ssi->reader.close();
+        if (ex) {
+            std::rethrow_exception(std::move(ex));
+        }
+    }
+}
+
 future<> stream_transfer_task::execute() {
     auto plan_id = session->plan_id();
     auto cf_id = this->cf_id;
@@ -198,16 +403,20 @@ future<> stream_transfer_task::execute() {
     return sm.container().invoke_on_all([plan_id, cf_id, id, dst_cpu_id, ranges=this->_ranges, reason] (stream_manager& sm) mutable {
         auto& tbl = sm.db().find_column_family(cf_id);
       return sm.db().obtain_reader_permit(tbl, "stream-transfer-task", db::no_timeout, {}).then([&sm, &tbl, plan_id, cf_id, id, dst_cpu_id, ranges=std::move(ranges), reason] (reader_permit permit) mutable {
-        auto si = make_lw_shared<send_info>(sm.ms(), plan_id, tbl, std::move(permit), std::move(ranges), id, dst_cpu_id, reason, [&sm, plan_id, addr = id.addr] (size_t sz) {
+        std::function<void(size_t)> update = [&sm, plan_id, addr = id.addr] (size_t sz) {
             sm.update_progress(plan_id, addr, streaming::progress_info::direction::OUT, sz);
-        });
-        return si->has_relevant_range_on_this_shard().then([si, plan_id, cf_id] (bool has_relevant_range_on_this_shard) {
+        };
+        auto streamed_sstables = sstables_to_stream_as_files(sm, tbl, ranges);
+        auto si = make_lw_shared<send_info>(sm.ms(), plan_id, tbl, permit, std::move(ranges), id, dst_cpu_id, reason, update, streamed_sstables);
+        return si->has_relevant_range_on_this_shard().then([&sm, si, plan_id, cf_id, permit = std::move(permit), streamed_sstables = std::move(streamed_sstables), update = std::move(update)] (bool has_relevant_range_on_this_shard) mutable {
             if (!has_relevant_range_on_this_shard) {
                 sslog.debug("[Stream #{}] stream_transfer_task: cf_id={}: ignore ranges on shard={}",
                         plan_id, cf_id, this_shard_id());
                 return make_ready_future<>();
             }
-            return send_mutation_fragments(std::move(si));
+            return send_sstables_as_files(sm, si, permit, streamed_sstables, update).then([si, permit, streamed_sstables, update] () mutable {
+                return send_ranges(si, std::move(permit), std::move(streamed_sstables), std::move(update));
+            });
         }).finally([si] {
             return si->reader.close();
         });
@@ -83,6 +83,16 @@ def test_batch_write_and_delete(test_table_s):
     assert not 'Item' in test_table_s.get_item(Key={'p': p1}, ConsistentRead=True)
     assert 'Item' in test_table_s.get_item(Key={'p': p2}, ConsistentRead=True)
 
+# Test a batch writing and deleting many items of the same partition, which
+# are written together.
+def test_batch_write_same_partition(test_table):
+    p = random_string()
+    test_table.put_item(Item={'p': p, 'c': 'deleted'})
+    items = [{'p': p, 'c': random_string(), 'val': random_string()} for i in range(20)]
+    test_table.meta.client.batch_write_item(RequestItems = {test_table.name: [
+        {'DeleteRequest': {'Key': {'p': p, 'c': 'deleted'}}}] + [{'PutRequest': {'Item': item}} for item in items]})
+    assert multiset(full_query(test_table, KeyConditionExpression='p=:p', ExpressionAttributeValues={':p': p})) == multiset(items)
+
 # It is forbidden to update the same key twice in the same batch.
 # DynamoDB says "Provided list of item keys contains duplicates".
 def test_batch_write_duplicate_write(test_table_s, test_table):
@@ -267,6 +277,19 @@ def test_batch_get_item_hash(test_table_s):
     got_items = reply['Responses'][test_table_s.name]
     assert multiset(got_items) == multiset(items)
 
+# Same, with the largest number of keys DynamoDB allows in one batch, many
+# of which are owned by the same replicas and read together, and some of
+# which are missing.
+def test_batch_get_item_hash_many(test_table_s):
+    items = [{'p': random_string(), 'val': random_string()} for i in range(80)]
+    with test_table_s.batch_writer() as batch:
+        for item in items:
+            batch.put_item(item)
+    keys = [{'p': x['p']} for x in items] + [{'p': random_string()} for i in range(20)]
+    reply = test_table_s.meta.client.batch_get_item(RequestItems = {test_table_s.name: {'Keys': keys, 'ConsistentRead': True}})
+    got_items = reply['Responses'][test_table_s.name]
+    assert multiset(got_items) == multiset(items)
+
 # Test what do we get if we try to read two *missing* values in addition to
 # an existing one. It turns out the missing items are simply not returned,
 # with no sign they are missing.
@@ -13,7 +13,7 @@ from botocore.exceptions import ClientError
 import re
 import time
 import threading
-from util import multiset, create_test_table, unique_table_name, random_string
+from util import multiset, create_test_table, new_test_table, unique_table_name, random_string, full_query
 from packaging.version import Version
 
 def delete_tags(table, arn):
@@ -139,7 +139,7 @@ def test_tag_resource_incorrect(test_table):
 def test_tag_resource_write_isolation_values(scylla_only, test_table):
     got = test_table.meta.client.describe_table(TableName=test_table.name)['Table']
     arn =  got['TableArn']
-    for i in ['f', 'forbid', 'forbid_rmw', 'a', 'always', 'always_use_lwt', 'o', 'only_rmw_uses_lwt', 'u', 'unsafe', 'unsafe_rmw']:
+    for i in ['f', 'forbid', 'forbid_rmw', 'a', 'always', 'always_use_lwt', 'o', 'only_rmw_uses_lwt', 'u', 'unsafe', 'unsafe_rmw', 'l', 'leader', 'leader_rmw']:
         test_table.meta.client.tag_resource(ResourceArn=arn, Tags=[{'Key':'system:write_isolation', 'Value':i}])
     with pytest.raises(ClientError, match='ValidationException'):
         test_table.meta.client.tag_resource(ResourceArn=arn, Tags=[{'Key':'system:write_isolation', 'Value':'bah'}])
@@ -342,3 +342,64 @@ def test_concurrent_tag(dynamodb, test_table):
     t2.start()
     t1.join()
     t2.join()
+
+# Test that promoting attributes with the system:promoted_attributes tag
+# keeps the items written before and after it intact, through reads,
+# updates, deletes of the promoted attributes and GSIs. This is a
+# scylla_only test because the tag is a Scylla extension.
+def test_tag_promoted_attributes(scylla_only, dynamodb):
+    with new_test_table(dynamodb,
+            KeySchema=[ { 'AttributeName': 'p', 'KeyType': 'HASH' },
+                        { 'AttributeName': 'c', 'KeyType': 'RANGE' } ],
+            AttributeDefinitions=[
+                        { 'AttributeName': 'p', 'AttributeType': 'S' },
+                        { 'AttributeName': 'c', 'AttributeType': 'S' },
+                        { 'AttributeName': 'x', 'AttributeType': 'S' } ],
+            GlobalSecondaryIndexes=[
+                {   'IndexName': 'gsi',
+                    'KeySchema': [ { 'AttributeName': 'x', 'KeyType': 'HASH' } ],
+                    'Projection': { 'ProjectionType': 'ALL' }
+                } ]) as table:
+        client = table.meta.client
+        arn = client.describe_table(TableName=table.name)['Table']['TableArn']
+        p = random_string()
+        x = random_string()
+        old = {'p': p, 'c': 'old', 'x': x, 'a': 1, 'b': {'d': 'hello'}, 'e': 'e'}
+        table.put_item(Item=old)
+        client.tag_resource(ResourceArn=arn, Tags=[{'Key': 'system:promoted_attributes', 'Value': 'a b'}])
+        new = {'p': p, 'c': 'new', 'x': x, 'a': 2, 'b': {'d': 'world'}}
+        table.put_item(Item=new)
+        assert table.get_item(Key={'p': p, 'c': 'old'}, ConsistentRead=True)['Item'] == old
+        assert table.get_item(Key={'p': p, 'c': 'new'}, ConsistentRead=True)['Item'] == new
+        # Updates of the promoted attributes of items written before they were
+        # promoted replace the value they had.
+        table.update_item(Key={'p': p, 'c': 'old'}, UpdateExpression='SET a = a + :one, b.d = :d',
+            ExpressionAttributeValues={':one': 1, ':d': 'there'})
+        old.update({'a': 2, 'b': {'d': 'there'}})
+        assert table.get_item(Key={'p': p, 'c': 'old'}, ConsistentRead=True)['Item'] == old
+        table.update_item(Key={'p': p, 'c': 'old'}, UpdateExpression='REMOVE b')
+        del old['b']
+        assert table.get_item(Key={'p': p, 'c': 'old'}, ConsistentRead=True)['Item'] == old
+        assert table.get_item(Key={'p': p, 'c': 'new'}, ConsistentRead=True, ProjectionExpression='b.d')['Item'] == {'b': {'d': 'world'}}
+        assert multiset(full_query(table, KeyConditionExpression='p=:p', ExpressionAttributeValues={':p': p})) == multiset([old, new])
+        assert multiset(full_query(table, KeyConditionExpression='p=:p', FilterExpression='a = :two',
+            ExpressionAttributeValues={':p': p, ':two': 2})) == multiset([old, new])
+        # The promoted attributes are also in the GSI, which has all the
+        # attributes of the items, eventually.
+        for i in range(60):
+            got = full_query(table, IndexName='gsi', ConsistentRead=False, KeyConditionExpression='x=:x', ExpressionAttributeValues={':x': x})
+            if multiset(got) == multiset([old, new]):
+                break
+            time.sleep(0.5)
+        assert multiset(got) == multiset([old, new])
+        # Promoted attributes can't be removed from the tag, and keys can't
+        # be promoted.
+        with pytest.raises(ClientError, match='ValidationException.*removed'):
+            client.tag_resource(ResourceArn=arn, Tags=[{'Key': 'system:promoted_attributes', 'Value': 'a'}])
+        with pytest.raises(ClientError, match='ValidationException.*removed'):
+            client.untag_resource(ResourceArn=arn, TagKeys=['system:promoted_attributes'])
+        for key in ['p', 'x']:
+            with pytest.raises(ClientError, match='ValidationException.*key attribute'):
+                client.tag_resource(ResourceArn=arn, Tags=[{'Key': 'system:promoted_attributes', 'Value': 'a b ' + key}])
+        client.tag_resource(ResourceArn=arn, Tags=[{'Key': 'system:promoted_attributes', 'Value': 'a b e'}])
+        assert table.get_item(Key={'p': p, 'c': 'old'}, ConsistentRead=True)['Item'] == old
@@ -9,6 +9,7 @@
 #define BOOST_TEST_MODULE core
 
 #include <boost/test/unit_test.hpp>
+#include <thread>
 #include <utility>
 #include "utils/UUID_gen.hh"
 #include "utils/lexicographical_compare.hh"
@@ -276,3 +277,31 @@ BOOST_AUTO_TEST_CASE(test_null_uuid) {
     BOOST_CHECK(!uuid.is_null());
     BOOST_CHECK(uuid);
 }
+
+BOOST_AUTO_TEST_CASE(test_time_uuid_is_monotonic) {
+    auto prev = utils::UUID_gen::get_time_UUID();
+    for (int i = 0; i < 100000; i++) {
+        auto next = utils::UUID_gen::get_time_UUID();
+        BOOST_REQUIRE_GT(next.timestamp(), prev.timestamp());
+        prev = next;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_time_uuid_clock_sequence_is_per_thread) {
+    auto clock_seq = [] (UUID uuid) {
+        return (uuid.get_least_significant_bits() >> 48) & 0x3fff;
+    };
+    std::vector<int64_t> seqs(4);
+    std::vector<std::thread> threads;
+    for (auto& seq : seqs) {
+        threads.emplace_back([&seq, &clock_seq] {
+            seq = clock_seq(utils::UUID_gen::get_time_UUID());
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    seqs.push_back(clock_seq(utils::UUID_gen::get_time_UUID()));
+    std::sort(seqs.begin(), seqs.end());
+    BOOST_REQUIRE(std::adjacent_find(seqs.begin(), seqs.end()) == seqs.end());
+}
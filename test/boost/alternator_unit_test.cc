@@ -13,6 +13,7 @@
 #include <seastar/core/memory.hh>
 #include "utils/base64.hh"
 #include "utils/rjson.hh"
+#include "alternator/ttl_scan_controller.hh"
 
 static bytes_view to_bytes_view(const std::string& s) {
     return bytes_view(reinterpret_cast<const signed char*>(s.c_str()), s.size());
@@ -38,6 +39,17 @@ BOOST_AUTO_TEST_CASE(test_base64_encode_decode) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(test_base64_all_bytes) {
+    std::string str;
+    for (int i = 0; i < 3 * 256 + 2; i++) {
+        str += char(i * 7);
+        auto decoded = base64_decode(base64_encode(to_bytes_view(str)));
+        BOOST_REQUIRE_EQUAL(to_bytes_view(str), bytes_view(decoded));
+    }
+    BOOST_REQUIRE_THROW(base64_decode("YW!j"), std::invalid_argument);
+    BOOST_REQUIRE_THROW(base64_decode("YWJ"), std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_CASE(test_base64_decoded_len) {
     for (auto& [str, encoded] : strings) {
         BOOST_REQUIRE_EQUAL(str.size(), base64_decoded_len(encoded));
@@ -69,6 +81,61 @@ BOOST_AUTO_TEST_CASE(test_base64_begins_with) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(test_streaming_writer) {
+    auto value = rjson::parse(R"({"Items":[{"a":{"S":"x\"y"},"b":{"L":[{"N":"1"},{"BOOL":true}]}}],"Count":1})");
+    rjson::streaming_writer writer;
+    writer.start_object();
+    writer.key("Items");
+    writer.start_array();
+    writer.start_object();
+    writer.key("a");
+    writer.value(value["Items"][0]["a"]);
+    writer.key("b");
+    writer.raw(R"({"L":[{"N":"1"},{"BOOL":true}]})");
+    writer.end_object();
+    writer.end_array();
+    writer.key("Count");
+    writer.number(1);
+    writer.end_object();
+
+    auto size = writer.size();
+    std::string text;
+    for (auto& buf : std::move(writer).finish()) {
+        BOOST_REQUIRE(!buf.empty());
+        text.append(buf.get(), buf.size());
+    }
+    BOOST_REQUIRE_EQUAL(text.size(), size);
+    BOOST_REQUIRE_EQUAL(text, rjson::print(value));
+}
+
+BOOST_AUTO_TEST_CASE(test_parse_chunked_content) {
+    auto check = [] (const std::string& text) {
+        auto expected = rjson::print(rjson::parse(text));
+        // Split the text into chunks of all sizes.
+        for (size_t chunk_size = 1; chunk_size <= text.size(); chunk_size = chunk_size * 2 + 1) {
+            rjson::chunked_content content;
+            for (size_t pos = 0; pos < text.size(); pos += chunk_size) {
+                auto len = std::min(chunk_size, text.size() - pos);
+                content.emplace_back(text.data() + pos, len);
+            }
+            BOOST_REQUIRE_EQUAL(rjson::print(rjson::parse(std::move(content))), expected);
+        }
+    };
+    check(R"( { "TableName" : "t", "Item" : { "p" : { "S" : "a long string value, \"escaped\"" }, "n" : { "N" : "12" } } } )");
+    // Larger than what is copied to be parsed as null-terminated text.
+    std::string large = R"({"L":[)";
+    for (int i = 0; i < 20000; i++) {
+        large += i ? R"(,{"S":"value"})" : R"({"S":"value"})";
+    }
+    large += "]}";
+    check(large);
+
+    BOOST_REQUIRE_THROW(rjson::parse(std::string_view(R"({"a":)")), rjson::error);
+    rjson::chunked_content truncated;
+    truncated.emplace_back("{\"a\":", 5);
+    BOOST_REQUIRE_THROW(rjson::parse(std::move(truncated)), rjson::error);
+}
+
 BOOST_AUTO_TEST_CASE(test_allocator_fail_gracefully) {
     // Allocation size is set to a ridiculously high value to ensure
     // that it will immediately fail - trying to lazily allocate just
@@ -86,3 +153,69 @@ BOOST_AUTO_TEST_CASE(test_allocator_fail_gracefully) {
     rapidjson::internal::Stack stack(&allocator, 0);
     BOOST_REQUIRE_THROW(stack.Push<char>(too_large_alloc_size), rjson::error);
 }
+
+BOOST_AUTO_TEST_CASE(test_ttl_scan_controller) {
+    alternator::ttl_scan_controller c(4);
+    std::vector<alternator::ttl_scan_controller::permit> permits;
+    for (int i = 0; i < 4; i++) {
+        auto f = c.acquire();
+        BOOST_REQUIRE(f.available());
+        permits.push_back(f.get0());
+    }
+    auto queued = c.acquire();
+    BOOST_REQUIRE(!queued.available());
+
+    // Backing off keeps pages waiting, down to one range at a time.
+    c.adjust(true);
+    c.adjust(true);
+    c.adjust(true);
+    BOOST_REQUIRE_EQUAL(c.parallelism(), 1U);
+    BOOST_REQUIRE_EQUAL(c.get_stats().backoffs, 2U);
+    permits.clear();
+    BOOST_REQUIRE(queued.available());
+    queued.get0().release();
+
+    // The parallelism grows back one range at a time.
+    c.adjust(false);
+    BOOST_REQUIRE_EQUAL(c.parallelism(), 2U);
+    c.adjust(false);
+    c.adjust(false);
+    c.adjust(false);
+    BOOST_REQUIRE_EQUAL(c.parallelism(), 4U);
+
+    // Tables dense with expired items back off to half the parallelism only.
+    for (int i = 0; i < 10; i++) {
+        c.observe_page(100, 100);
+    }
+    BOOST_REQUIRE_GE(c.density(), alternator::ttl_scan_controller::dense);
+    c.adjust(true);
+    c.adjust(true);
+    BOOST_REQUIRE_EQUAL(c.parallelism(), 2U);
+    c.begin_table();
+    c.adjust(true);
+    BOOST_REQUIRE_EQUAL(c.parallelism(), 1U);
+}
+
+BOOST_AUTO_TEST_CASE(test_ttl_scan_controller_throttle) {
+    using clock_type = alternator::ttl_scan_controller::clock_type;
+    alternator::ttl_scan_controller c(2);
+    auto now = clock_type::now();
+    BOOST_REQUIRE(c.consume(1000000, now) == clock_type::duration::zero());
+
+    // Once the bucket is empty, items are refilled at the configured rate.
+    c.set_rate(1000);
+    c.consume(0, now);
+    c.consume(0, now + std::chrono::seconds(10));
+    now += std::chrono::seconds(10);
+    BOOST_REQUIRE(c.consume(1000, now) == clock_type::duration::zero());
+    BOOST_REQUIRE(c.consume(500, now) == std::chrono::milliseconds(500));
+
+    // Backing off slows the refill down along with the parallelism.
+    c.adjust(true);
+    BOOST_REQUIRE_EQUAL(c.effective_rate(), 500);
+
+    // Dense tables are refilled faster.
+    c.observe_page(100, 100);
+    BOOST_REQUIRE_EQUAL(c.effective_rate(), 625);
+    BOOST_REQUIRE_EQUAL(c.get_stats().throttled_items, 500U);
+}
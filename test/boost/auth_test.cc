@@ -28,6 +28,7 @@
 #include "auth/service.hh"
 #include "auth/authenticated_user.hh"
 #include "auth/resource.hh"
+#include "auth/role_or_anonymous.hh"
 
 #include "db/config.hh"
 #include "cql3/query_processor.hh"
@@ -157,6 +158,39 @@ SEASTAR_TEST_CASE(test_password_authenticator_operations) {
     }, cfg);
 }
 
+SEASTAR_TEST_CASE(test_password_authenticator_cache) {
+    auto cfg = make_shared<db::config>();
+    cfg->authenticator(sstring(auth::password_authenticator_name));
+
+    return do_with_cql_env_thread([](cql_test_env& env) {
+        auto& a = dynamic_cast<const auth::password_authenticator&>(env.local_auth_service().underlying_authenticator());
+        auth::role_config config;
+        config.can_login = true;
+        auth::authentication_options options;
+        options.password = "pass1";
+        auth::create_role(env.local_auth_service(), "user1", config, options).get();
+
+        authenticate(env, "user1", "pass1").get();
+        auto stats = a.get_cache_stats();
+        authenticate(env, "user1", "pass1").get();
+        BOOST_REQUIRE_EQUAL(a.get_cache_stats().hits, stats.hits + 1);
+        BOOST_REQUIRE_EQUAL(a.get_cache_stats().misses, stats.misses);
+
+        // A remembered password does not let another one in.
+        require_throws<exceptions::authentication_exception>(authenticate(env, "user1", "pass2")).get();
+
+        // Nor does it survive a password change.
+        auth::role_config_update config_update;
+        options.password = "pass2";
+        auth::alter_role(env.local_auth_service(), "user1", config_update, options).get();
+        require_throws<exceptions::authentication_exception>(authenticate(env, "user1", "pass1")).get();
+        authenticate(env, "user1", "pass2").get();
+
+        auth::drop_role(env.local_auth_service(), "user1").get();
+        require_throws<exceptions::authentication_exception>(authenticate(env, "user1", "pass2")).get();
+    }, cfg);
+}
+
 namespace {
 
 /// Asserts that table is protected from alterations that can brick a node.
@@ -198,6 +232,28 @@ SEASTAR_TEST_CASE(role_permissions_table_is_protected) {
     }, auth_on());
 }
 
+SEASTAR_TEST_CASE(test_permissions_cache_preload) {
+    return do_with_cql_env_thread([] (cql_test_env& env) {
+        env.execute_cql("CREATE TABLE ks.t (p int PRIMARY KEY)").get();
+        env.execute_cql("CREATE ROLE r1").get();
+        env.execute_cql("CREATE ROLE r2").get();
+        env.execute_cql("GRANT SELECT ON ks.t TO r1").get();
+        env.execute_cql("GRANT MODIFY ON KEYSPACE ks TO r2").get();
+        env.execute_cql("GRANT r1 TO r2").get();
+
+        auto& as = env.local_auth_service();
+        as.preload_permissions_cache().get();
+        for (auto role : {"r1", "r2"}) {
+            for (auto& r : {auth::make_data_resource("ks", "t"), auth::make_data_resource("ks")}) {
+                auto perms = as.get_permissions(auth::role_or_anonymous(role), r).get0();
+                auto uncached_perms = as.get_uncached_permissions(auth::role_or_anonymous(role), r).get0();
+                BOOST_REQUIRE_EQUAL(perms.mask(), uncached_perms.mask());
+            }
+        }
+        BOOST_REQUIRE(as.get_permissions(auth::role_or_anonymous("r2"), auth::make_data_resource("ks", "t")).get0().contains(auth::permission::SELECT));
+    }, auth_on());
+}
+
 SEASTAR_TEST_CASE(alter_opts_on_system_auth_tables) {
     return do_with_cql_env_thread([] (cql_test_env& env) {
         cquery_nofail(env, "ALTER TABLE system_auth.roles WITH speculative_retry = 'NONE'");
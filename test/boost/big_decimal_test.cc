@@ -203,3 +203,27 @@ BOOST_AUTO_TEST_CASE(test_big_decimal_sub) {
     test_sub("9999999999999999999999999999999999999", "-1.000e0", "10000000000000000000000000000000000000.000");
     test_sub("+10.", "1.e+1", "0");
 }
+
+// Additions of values whose unscaled value fits in 64 bits take a 128-bit
+// fast path, the others fall back to cpp_int. Check both sides of the edge.
+BOOST_AUTO_TEST_CASE(test_big_decimal_add_sub_int64_edges) {
+    test_add("9223372036854775807", "0.000000000000000001", "9223372036854775807.000000000000000001");
+    test_add("9223372036854775807", "9223372036854775807.0", "18446744073709551614.0");
+    test_add("-9223372036854775808", "-9223372036854775808.0", "-18446744073709551616.0");
+    test_add("9223372036854775808", "0.1", "9223372036854775808.1");
+    test_add("1", "0.0000000000000000001", "1.0000000000000000001");
+    test_add("1.5e3", "0.25", "1500.25");
+    test_sub("-9223372036854775808", "0.1", "-9223372036854775808.1");
+    test_sub("0.000000000000000001", "9223372036854775807", "-9223372036854775806.999999999999999999");
+    test_sub("1", "0.0000000000000000001", "0.9999999999999999999");
+}
+
+BOOST_AUTO_TEST_CASE(test_big_decimal_compare) {
+    BOOST_REQUIRE(big_decimal{"1.5"} < big_decimal{"1.50001"});
+    BOOST_REQUIRE((big_decimal{"1.5"} <=> big_decimal{"1.500"}) == 0);
+    BOOST_REQUIRE(big_decimal{"-1.5"} < big_decimal{"-1.49"});
+    BOOST_REQUIRE(big_decimal{"9223372036854775807"} < big_decimal{"9223372036854775807.000000000000000001"});
+    BOOST_REQUIRE(big_decimal{"9223372036854775808"} > big_decimal{"9223372036854775807.9"});
+    BOOST_REQUIRE(big_decimal{"1"} > big_decimal{"0.9999999999999999999"});
+    BOOST_REQUIRE((big_decimal{"1e3"} <=> big_decimal{"1000"}) == 0);
+}
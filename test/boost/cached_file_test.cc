@@ -262,6 +262,54 @@ SEASTAR_THREAD_TEST_CASE(test_eviction_via_lru) {
     }
 }
 
+SEASTAR_THREAD_TEST_CASE(test_sequential_readahead) {
+    auto page = cached_file::page_size;
+    test_file tf = make_test_file(page * 16);
+
+    {
+        cached_file::metrics metrics;
+        logalloc::region region;
+        cached_file cf(tf.f, metrics, cf_lru, region, tf.contents.size());
+
+        BOOST_REQUIRE_EQUAL(tf.contents, read_to_string(cf, 0));
+
+        // Pages [0, 4) are read one by one, then 4 pages are read at page 4 and 8 at page 8.
+        BOOST_REQUIRE_EQUAL(6, metrics.page_misses);
+        BOOST_REQUIRE_EQUAL(10, metrics.page_hits);
+        BOOST_REQUIRE_EQUAL(10, metrics.page_readaheads);
+        BOOST_REQUIRE_EQUAL(16, metrics.page_populations);
+        BOOST_REQUIRE_EQUAL(page * 16, cf.cached_bytes());
+        BOOST_REQUIRE_EQUAL(0, metrics.bytes_in_std);
+    }
+
+    {
+        cached_file::metrics metrics;
+        logalloc::region region;
+        cached_file cf(tf.f, metrics, cf_lru, region, tf.contents.size());
+
+        // Reads pages [0, 8), of which [5, 8) are not requested.
+        BOOST_REQUIRE_EQUAL(tf.contents.substr(0, page * 5), read_to_string(cf, 0, page * 5));
+        BOOST_REQUIRE_EQUAL(3, metrics.page_readaheads);
+        BOOST_REQUIRE_EQUAL(page * 8, cf.cached_bytes());
+
+        // A page read ahead is touched when it is requested.
+        auto hits = metrics.page_hits;
+        BOOST_REQUIRE_EQUAL(tf.contents.substr(page * 5, 1), read_to_string(cf, page * 5, 1));
+        BOOST_REQUIRE_EQUAL(hits + 1, metrics.page_hits);
+
+        // Pages which were read ahead and not requested are evicted first,
+        // even though they were populated after the requested ones.
+        cf_lru.evict();
+        cf_lru.evict();
+        BOOST_REQUIRE_EQUAL(2, metrics.page_evictions);
+        BOOST_REQUIRE_EQUAL(page * 6, cf.cached_bytes());
+
+        hits = metrics.page_hits;
+        BOOST_REQUIRE_EQUAL(tf.contents.substr(0, page * 6), read_to_string(cf, 0, page * 6));
+        BOOST_REQUIRE_EQUAL(hits + 6, metrics.page_hits);
+    }
+}
+
 // A file which serves garbage but is very fast.
 class garbage_file_impl : public file_impl {
 private:
@@ -19,6 +19,7 @@
 #include "test/lib/cql_test_env.hh"
 #include "test/lib/exception_utils.hh"
 #include "test/lib/log.hh"
+#include "service/storage_proxy.hh"
 #include "transport/messages/result_message.hh"
 
 #include "types/types.hh"
@@ -609,6 +610,87 @@ SEASTAR_THREAD_TEST_CASE(test_pre_post_image_logging) {
     }).get();
 }
 
+SEASTAR_THREAD_TEST_CASE(test_preimage_cache) {
+    cql_test_config cfg;
+    cfg.db_config->cdc_preimage_cache_size(100);
+    do_with_cql_env_thread([](cql_test_env& e) {
+        cquery_nofail(e, "CREATE TABLE ks.tbl (pk int, ck int, val int, val2 int, PRIMARY KEY(pk, ck)) "
+                "WITH cdc = {'enabled':'true', 'preimage':'full', 'postimage':'true'}");
+        auto& cdc_stats = e.get_storage_proxy().local().get_cdc_stats();
+        const auto selects = cdc_stats.counters_total.preimage_selects;
+
+        cquery_nofail(e, "UPDATE ks.tbl SET val = 1, val2 = 2 WHERE pk = 0 AND ck = 0");
+        // The preimages of the rows written since are taken from the cache.
+        cquery_nofail(e, "UPDATE ks.tbl SET val = 3 WHERE pk = 0 AND ck = 0");
+        cquery_nofail(e, "DELETE FROM ks.tbl WHERE pk = 0 AND ck = 0");
+        cquery_nofail(e, "UPDATE ks.tbl SET val = 4 WHERE pk = 0 AND ck = 0");
+        // Deleting a range of rows makes the partition forgotten.
+        cquery_nofail(e, "DELETE FROM ks.tbl WHERE pk = 0 AND ck > 0");
+        cquery_nofail(e, "UPDATE ks.tbl SET val = 5 WHERE pk = 0 AND ck = 0");
+
+        auto rows = select_log(e, "tbl");
+        auto pre_image = to_bytes_filtered(*rows, cdc::operation::pre_image);
+        sort_by_time(*rows, pre_image);
+        auto val_index = column_index(*rows, cdc::log_data_column_name("val"));
+        auto val2_index = column_index(*rows, cdc::log_data_column_name("val2"));
+
+        // The rows didn't exist before the first write, nor after the deletion.
+        BOOST_REQUIRE_EQUAL(pre_image.size(), 3);
+        BOOST_REQUIRE_EQUAL(pre_image[0][val_index], int32_type->decompose(1));
+        BOOST_REQUIRE_EQUAL(pre_image[0][val2_index], int32_type->decompose(2));
+        BOOST_REQUIRE_EQUAL(pre_image[1][val_index], int32_type->decompose(3));
+        BOOST_REQUIRE_EQUAL(pre_image[1][val2_index], int32_type->decompose(2));
+        BOOST_REQUIRE_EQUAL(pre_image[2][val_index], int32_type->decompose(4));
+        BOOST_REQUIRE(!pre_image[2][val2_index]);
+
+        // Unless writing them took over a second.
+        BOOST_REQUIRE_GE(cdc_stats.preimage_cache_hits, 1);
+        BOOST_REQUIRE_GE(cdc_stats.counters_total.preimage_selects - selects, 3);
+    }, cfg).get();
+}
+
+SEASTAR_THREAD_TEST_CASE(test_change_subscriber) {
+    struct subscriber : public cdc::change_subscriber {
+        std::vector<std::pair<sstring, std::vector<bytes>>> changes;
+        virtual void on_cdc_change(const schema& log_schema, const std::vector<bytes>& stream_ids) override {
+            changes.emplace_back(log_schema.cf_name(), stream_ids);
+        }
+    };
+    do_with_cql_env_thread([](cql_test_env& e) {
+        cquery_nofail(e, "CREATE TABLE ks.tbl (pk int, ck int, val int, PRIMARY KEY(pk, ck)) WITH cdc = {'enabled':'true'}");
+        cquery_nofail(e, "CREATE TABLE ks.other (pk int PRIMARY KEY, val int)");
+        subscriber sub;
+        auto& cdc = *e.get_storage_proxy().local().get_cdc_service();
+        cdc.register_change_subscriber(&sub);
+        auto unregister = defer([&] { cdc.unregister_change_subscriber(&sub); });
+
+        cquery_nofail(e, "BEGIN UNLOGGED BATCH "
+                "UPDATE ks.tbl SET val = 1 WHERE pk = 0 AND ck = 0; "
+                "UPDATE ks.tbl SET val = 2 WHERE pk = 0 AND ck = 1; "
+                "APPLY BATCH");
+        // Writes to tables without CDC aren't notified.
+        cquery_nofail(e, "UPDATE ks.other SET val = 1 WHERE pk = 0");
+        BOOST_REQUIRE_EQUAL(sub.changes.size(), 1);
+
+        cquery_nofail(e, "UPDATE ks.tbl SET val = 3 WHERE pk = 1 AND ck = 0");
+        BOOST_REQUIRE_EQUAL(sub.changes.size(), 2);
+
+        auto rows = select_log(e, "tbl");
+        auto stream_id_index = column_index(*rows, cdc::log_meta_column_name("stream_id"));
+        std::set<bytes> logged, notified;
+        for (auto& row : rows->rows()) {
+            logged.insert(*row[stream_id_index]);
+        }
+        for (auto& [table, stream_ids] : sub.changes) {
+            BOOST_REQUIRE_EQUAL(table, cdc::log_name("tbl"));
+            // The changes of both rows of the partition are in the same stream.
+            BOOST_REQUIRE_EQUAL(stream_ids.size(), 1);
+            notified.insert(stream_ids.begin(), stream_ids.end());
+        }
+        BOOST_REQUIRE(logged == notified);
+    }).get();
+}
+
 SEASTAR_THREAD_TEST_CASE(test_pre_post_image_logging_static_row) {
     do_with_cql_env_thread([](cql_test_env& e) {
         auto test = [&e] (bool enabled, bool with_ttl) {
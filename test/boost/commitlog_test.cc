@@ -43,6 +43,7 @@
 #include "test/lib/sstable_utils.hh"
 #include "test/lib/mutation_source_test.hh"
 #include "test/lib/key_utils.hh"
+#include "test/lib/simple_schema.hh"
 
 using namespace db;
 
@@ -104,6 +105,33 @@ SEASTAR_TEST_CASE(test_commitlog_written_to_disk_batch){
         });
 }
 
+// check that writes sharing a group commit are all flushed
+SEASTAR_TEST_CASE(test_commitlog_written_to_disk_batch_group_commit){
+    commitlog::config cfg;
+    cfg.mode = commitlog::sync_mode::BATCH;
+    cfg.group_commit_window_in_us = 1000000;
+    return cl_test(cfg, [](commitlog& log) -> future<> {
+        sstring tmp = "hej bubba cow";
+        auto add = [&] {
+            return log.add_mutation(make_table_id(), tmp.size(), db::commitlog::force_sync::no, [tmp](db::commitlog::output& dst) {
+                dst.write(tmp.data(), tmp.size());
+            });
+        };
+        // Measures the flush latency, which caps the window.
+        co_await add();
+        auto n = log.get_flush_count();
+        std::vector<future<replay_position>> writes;
+        for (int i = 0; i < 100; ++i) {
+            writes.push_back(add());
+        }
+        auto rps = co_await when_all_succeed(writes.begin(), writes.end());
+        for (auto& rp : rps) {
+            BOOST_CHECK_NE(rp, db::replay_position());
+        }
+        BOOST_REQUIRE_GT(log.get_flush_count(), n);
+    });
+}
+
 // check that an entry marked as sync is immediately flushed to a storage
 SEASTAR_TEST_CASE(test_commitlog_written_to_disk_sync){
     commitlog::config cfg;
@@ -724,6 +752,57 @@ SEASTAR_TEST_CASE(test_commitlog_add_entries) {
     });
 }
 
+SEASTAR_THREAD_TEST_CASE(test_commitlog_entry_compression) {
+    for (auto c : { commitlog_entry_compression::lz4, commitlog_entry_compression::zstd }) {
+        commitlog::config cfg;
+        cfg.compression = c;
+        cfg.compression_threshold_in_bytes = 1024;
+
+        cl_test(cfg, [c] (commitlog& log) -> future<> {
+            simple_schema ss;
+            auto s = ss.schema();
+            // A compressible value, spanning several compression chunks, and a small one.
+            auto big = mutation(s, ss.make_pkey(0));
+            ss.add_row(big, ss.make_ckey(0), sstring(300 * 1024, 'a'));
+            auto small = mutation(s, ss.make_pkey(1));
+            ss.add_row(small, ss.make_ckey(0), "v");
+            std::vector<frozen_mutation> mutations{freeze(big), freeze(small)};
+
+            commitlog_entry_writer w(s, mutations[0], commitlog_entry_writer::force_sync::no);
+            w.set_compression(c, cfg.compression_threshold_in_bytes);
+            w.set_with_schema(true);
+            BOOST_REQUIRE(w.compressed());
+            BOOST_REQUIRE_LT(w.size(), w.uncompressed_size() / 10);
+
+            commitlog_entry_writer small_w(s, mutations[1], commitlog_entry_writer::force_sync::no);
+            small_w.set_compression(c, cfg.compression_threshold_in_bytes);
+            small_w.set_with_schema(true);
+            BOOST_REQUIRE(!small_w.compressed());
+
+            std::vector<replay_position> rps;
+            for (auto& fm : mutations) {
+                auto h = co_await log.add_entry(s->id(), commitlog_entry_writer(s, fm, commitlog_entry_writer::force_sync::no), db::timeout_clock::now() + 60s);
+                rps.push_back(h.release());
+            }
+            co_await log.sync_all_segments();
+
+            size_t found = 0;
+            for (auto& seg : log.get_active_segment_names()) {
+                co_await db::commitlog::read_log_file(seg, db::commitlog::descriptor::FILENAME_PREFIX, service::get_local_commitlog_priority(), [&] (db::commitlog::buffer_and_replay_position buf_rp) {
+                    auto i = std::find(rps.begin(), rps.end(), buf_rp.position);
+                    if (i != rps.end()) {
+                        commitlog_entry_reader r(buf_rp.buffer);
+                        BOOST_CHECK_EQUAL(r.mutation().unfreeze(s), mutations.at(std::distance(rps.begin(), i)).unfreeze(s));
+                        ++found;
+                    }
+                    return make_ready_future<>();
+                });
+            }
+            BOOST_REQUIRE_EQUAL(found, mutations.size());
+        }).get();
+    }
+}
+
 SEASTAR_TEST_CASE(test_commitlog_new_segment_odsync){
     commitlog::config cfg;
     cfg.commitlog_segment_size_in_mb = 1;
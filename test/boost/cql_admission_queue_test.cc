@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "test/lib/scylla_test_case.hh"
+#include <seastar/testing/thread_test_case.hh>
+#include <seastar/core/when_all.hh>
+
+#include "transport/admission_queue.hh"
+
+using namespace seastar;
+using namespace std::chrono_literals;
+
+SEASTAR_THREAD_TEST_CASE(test_admission_queue_admits_available_memory_right_away) {
+    semaphore memory(100);
+    cql_transport::admission_queue queue(memory, 10);
+
+    auto fut = queue.admit("a", 60);
+    BOOST_REQUIRE(fut.available());
+    auto units = fut.get0();
+    BOOST_REQUIRE_EQUAL(memory.available_units(), 40);
+    BOOST_REQUIRE_EQUAL(queue.waiters(), 0U);
+    BOOST_REQUIRE_EQUAL(queue.get_stats().queued, 0U);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_admission_queue_alternates_flows) {
+    semaphore memory(0);
+    cql_transport::admission_queue queue(memory, 10);
+    std::vector<sstring> order;
+    std::vector<future<>> admitted;
+    auto admit = [&] (sstring flow) {
+        // The units are released right away, so that the next request is admitted.
+        admitted.push_back(queue.admit(flow, 10).then([&order, flow] (semaphore_units<>) {
+            order.push_back(flow);
+        }));
+    };
+
+    // The first request is picked before the others are queued.
+    admit("first");
+    for (int i = 0; i < 4; ++i) {
+        admit("many");
+    }
+    admit("few");
+    BOOST_REQUIRE_EQUAL(queue.waiters(), 6U);
+
+    memory.signal(10);
+    when_all_succeed(admitted.begin(), admitted.end()).get();
+
+    const std::vector<sstring> expected = {"first", "many", "few", "many", "many", "many"};
+    BOOST_REQUIRE(order == expected);
+    BOOST_REQUIRE_EQUAL(queue.waiters(), 0U);
+    BOOST_REQUIRE_EQUAL(queue.get_stats().queued, 6U);
+    BOOST_REQUIRE_EQUAL(memory.available_units(), 10);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_admission_queue_large_requests_wait_for_their_share) {
+    semaphore memory(0);
+    cql_transport::admission_queue queue(memory, 10);
+    std::vector<sstring> order;
+    std::vector<future<>> admitted;
+    auto admit = [&] (sstring flow, size_t size) {
+        admitted.push_back(queue.admit(flow, size).then([&order, flow] (semaphore_units<>) {
+            order.push_back(flow);
+        }));
+    };
+
+    admit("first", 10);
+    // Worth three rounds of the small flow.
+    admit("large", 30);
+    admit("small", 10);
+    admit("small", 10);
+    admit("small", 10);
+
+    memory.signal(30);
+    when_all_succeed(admitted.begin(), admitted.end()).get();
+
+    const std::vector<sstring> expected = {"first", "small", "small", "large", "small"};
+    BOOST_REQUIRE(order == expected);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_admission_queue_timeout) {
+    semaphore memory(0);
+    cql_transport::admission_queue queue(memory, 10);
+
+    auto fut = queue.admit("a", 10, semaphore::clock::now() + 10ms);
+    BOOST_REQUIRE_EQUAL(queue.waiters(), 1U);
+    BOOST_REQUIRE_THROW(fut.get(), semaphore_timed_out);
+    BOOST_REQUIRE_EQUAL(queue.waiters(), 0U);
+
+    // The queue keeps admitting requests after the timeout.
+    memory.signal(10);
+    auto units = queue.admit("a", 10).get0();
+    BOOST_REQUIRE_EQUAL(memory.available_units(), 0);
+    BOOST_REQUIRE_EQUAL(queue.get_stats().queued, 1U);
+}
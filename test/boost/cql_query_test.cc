@@ -2225,6 +2225,25 @@ SEASTAR_TEST_CASE(test_order_by) {
             });
         }
 
+        {
+            auto msg = e.execute_cql("select c1, c2, r1 from torder where p1 in (0, 1) order by c1 desc, c2 desc limit 4;").get0();
+            assert_that(msg).is_rows().with_rows({
+                {int32_type->decompose(2), int32_type->decompose(3), int32_type->decompose(7)},
+                {int32_type->decompose(2), int32_type->decompose(2), int32_type->decompose(5)},
+                {int32_type->decompose(2), int32_type->decompose(1), int32_type->decompose(0)},
+                {int32_type->decompose(1), int32_type->decompose(2), int32_type->decompose(3)},
+            });
+        }
+
+        {
+            auto msg = e.execute_cql("select c1, c2, r1 from torder where p1 in (0, 1) order by c1 asc, c2 asc limit 3;").get0();
+            assert_that(msg).is_rows().with_rows({
+                {int32_type->decompose(1), int32_type->decompose(0), int32_type->decompose(6)},
+                {int32_type->decompose(1), int32_type->decompose(1), int32_type->decompose(4)},
+                {int32_type->decompose(1), int32_type->decompose(2), int32_type->decompose(3)},
+            });
+        }
+
         {
             auto msg = e.execute_cql("select c1, c2, r1 from torder where p1 = 0 and c1 > 1 order by c1 desc, c2 desc;").get0();
             assert_that(msg).is_rows().with_rows({
@@ -3327,6 +3346,52 @@ SEASTAR_TEST_CASE(test_in_restriction_on_not_last_partition_key) {
     });
 }
 
+SEASTAR_TEST_CASE(test_prepared_statements_on_composite_partition_key) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE t (a int, b text, c int, d int, PRIMARY KEY ((a, b), c));").get();
+        auto insert = e.prepare("INSERT INTO t (b, c, a, d) VALUES (?, ?, ?, ?)").get0();
+        for (int a = 0; a < 3; a++) {
+            e.execute_prepared(insert, {
+                cql3::raw_value::make_value(utf8_type->decompose(format("b{}", a))),
+                cql3::raw_value::make_value(int32_type->decompose(1)),
+                cql3::raw_value::make_value(int32_type->decompose(a)),
+                cql3::raw_value::make_value(int32_type->decompose(a * 10)),
+            }).get();
+        }
+
+        // The restrictions of the partition key columns are in neither the
+        // order of the columns nor of the bind markers.
+        auto select = e.prepare("SELECT d FROM t WHERE c = ? AND b = ? AND a = ?").get0();
+        for (int a = 0; a < 3; a++) {
+            auto msg = e.execute_prepared(select, {
+                cql3::raw_value::make_value(int32_type->decompose(1)),
+                cql3::raw_value::make_value(utf8_type->decompose(format("b{}", a))),
+                cql3::raw_value::make_value(int32_type->decompose(a)),
+            }).get0();
+            assert_that(msg).is_rows().with_rows({{int32_type->decompose(a * 10)}});
+        }
+        auto msg = e.execute_prepared(select, {
+            cql3::raw_value::make_value(int32_type->decompose(1)),
+            cql3::raw_value::make_value(utf8_type->decompose(sstring("b1"))),
+            cql3::raw_value::make_value(int32_type->decompose(2)),
+        }).get0();
+        assert_that(msg).is_rows().is_empty();
+
+        auto select_with_constant = e.prepare("SELECT d FROM t WHERE b = 'b2' AND a = ?").get0();
+        msg = e.execute_prepared(select_with_constant, {cql3::raw_value::make_value(int32_type->decompose(2))}).get0();
+        assert_that(msg).is_rows().with_rows({{int32_type->decompose(20)}});
+
+        auto update = e.prepare("UPDATE t SET d = ? WHERE a = ? AND b = ? AND c = 1").get0();
+        e.execute_prepared(update, {
+            cql3::raw_value::make_value(int32_type->decompose(5)),
+            cql3::raw_value::make_value(int32_type->decompose(0)),
+            cql3::raw_value::make_value(utf8_type->decompose(sstring("b0"))),
+        }).get();
+        msg = e.execute_cql("SELECT d FROM t WHERE a = 0 AND b = 'b0'").get0();
+        assert_that(msg).is_rows().with_rows({{int32_type->decompose(5)}});
+    });
+}
+
 SEASTAR_TEST_CASE(test_static_multi_cell_static_lists_with_ckey) {
     return do_with_cql_env_thread([] (cql_test_env& e) {
         e.execute_cql("CREATE TABLE t (p int, c int, slist list<int> static, v int, PRIMARY KEY (p, c));").get();
@@ -4710,6 +4775,64 @@ SEASTAR_TEST_CASE(test_list_parameter_marker) {
     });
 }
 
+SEASTAR_TEST_CASE(test_coalesced_cas) {
+    auto db_config = make_shared<db::config>();
+    db_config->lwt_max_coalesced_requests(8);
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        cquery_nofail(e, "CREATE TABLE t (p int, c int, v int, PRIMARY KEY (p, c))");
+        const sstring insert("INSERT INTO t (p, c, v) VALUES (0, 0, 0) IF NOT EXISTS");
+        auto msg = e.execute_cql(insert).get0();
+        auto shard = msg->move_to_shard().value_or(this_shard_id());
+        if (msg->move_to_shard()) {
+            smp::submit_to(shard, [&] { return e.execute_cql(insert).discard_result(); }).get();
+        }
+
+        // Runs the queries concurrently on the shard owning the partition and returns how many applied.
+        auto execute_concurrently = [&] (std::function<sstring (int)> query, int n) {
+            return smp::submit_to(shard, [&] {
+                return map_reduce(boost::irange(0, n), [&] (int i) {
+                    return e.execute_cql(query(i)).then([] (shared_ptr<cql_transport::messages::result_message> msg) {
+                        auto row = dynamic_cast<cql_transport::messages::result_message::rows&>(*msg).rs().result_set().rows().front();
+                        return value_cast<bool>(boolean_type->deserialize(row[0].value()));
+                    });
+                }, 0, [] (int applied, bool a) { return applied + a; });
+            }).get0();
+        };
+
+        // Each request sees the updates of the ones applied before it, also in the same round.
+        auto applied = execute_concurrently([] (int i) { return format("UPDATE t SET v = {} WHERE p = 0 AND c = 0 IF v = {}", i + 1, i); }, 32);
+        BOOST_REQUIRE_GE(applied, 1);
+        require_rows(e, "SELECT v FROM t WHERE p = 0 AND c = 0", {{I(applied)}});
+
+        applied = execute_concurrently([] (int i) { return format("INSERT INTO t (p, c, v) VALUES (0, 1, {}) IF NOT EXISTS", i); }, 32);
+        BOOST_REQUIRE_EQUAL(applied, 1);
+        applied = execute_concurrently([] (int) { return sstring("DELETE FROM t WHERE p = 0 AND c = 1 IF EXISTS"); }, 32);
+        BOOST_REQUIRE_EQUAL(applied, 1);
+        require_rows(e, "SELECT v FROM t WHERE p = 0 AND c = 1", {});
+
+        // A row created by UPDATE exists only through its cells, so it is gone once
+        // the first request nulls its only cell, and the others must see that.
+        cquery_nofail(e, "UPDATE t SET v = 1 WHERE p = 0 AND c = 2");
+        applied = execute_concurrently([] (int) { return sstring("UPDATE t SET v = null WHERE p = 0 AND c = 2 IF EXISTS"); }, 32);
+        BOOST_REQUIRE_EQUAL(applied, 1);
+        require_rows(e, "SELECT v FROM t WHERE p = 0 AND c = 2", {});
+    }, cql_test_config(db_config));
+}
+
+SEASTAR_TEST_CASE(test_cas_with_deferred_learn) {
+    auto db_config = make_shared<db::config>();
+    db_config->lwt_deferred_learn(true);
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        cquery_nofail(e, "CREATE TABLE t (p int PRIMARY KEY, v int)");
+        cquery_nofail(e, "INSERT INTO t (p, v) VALUES (0, 0)");
+        // Each write sees the previous one, although it was acknowledged before its learn completed.
+        for (int i = 0; i < 10; ++i) {
+            prepared_on_shard(e, "UPDATE t SET v = ? WHERE p = 0 IF v = ?", {I(i + 1), I(i)}, {{B(true), I(i)}});
+        }
+        prepared_on_shard(e, "UPDATE t SET v = ? WHERE p = 0 IF v = ?", {I(0), I(9)}, {{B(false), I(10)}});
+    }, cql_test_config(db_config));
+}
+
 SEASTAR_TEST_CASE(test_select_serial_consistency) {
     return do_with_cql_env_thread([] (cql_test_env& e) {
         cquery_nofail(e, "CREATE TABLE t (a int, b int, primary key (a,b))");
@@ -5333,7 +5456,49 @@ SEASTAR_TEST_CASE(test_parallelized_select_sum_group_by) {
             {int32_type->decompose(int32_t(0)), int32_type->decompose(int32_t((value_count - 1) * value_count / 2))}
         });
 
-        BOOST_CHECK_EQUAL(stat_parallelized, qp.get_cql_stats().select_parallelized);
+        BOOST_CHECK_EQUAL(stat_parallelized + 1, qp.get_cql_stats().select_parallelized);
+    });
+}
+
+SEASTAR_TEST_CASE(test_parallelized_select_group_by_clustering_prefix) {
+    return with_parallelized_aggregation_enabled_thread([](cql_test_env& e) {
+        auto& qp = e.local_qp();
+        auto stat_parallelized = qp.get_cql_stats().select_parallelized;
+
+        e.execute_cql("CREATE TABLE tbl (k int, c1 int, c2 int, v int, PRIMARY KEY (k, c1, c2));").get();
+
+        auto msg = e.execute_cql("SELECT k, COUNT(*) FROM tbl GROUP BY k;").get();
+        assert_that(msg).is_rows().with_rows({
+            {std::nullopt, long_type->decompose(int64_t(0))}
+        });
+
+        for (int k = 0; k < 2; k++) {
+            for (int c1 = 0; c1 < 2; c1++) {
+                for (int c2 = 0; c2 < 3; c2++) {
+                    e.execute_cql(format("INSERT INTO tbl (k, c1, c2, v) VALUES ({:d}, {:d}, {:d}, {:d});", k, c1, c2, c1 * 10 + c2)).get();
+                }
+            }
+        }
+        // Groups come in the order of the rows, k = 1 has the lower token.
+        msg = e.execute_cql("SELECT c1, k, MAX(v), COUNT(*), MIN(v) FROM tbl GROUP BY k, c1;").get();
+        assert_that(msg).is_rows().with_rows({
+            {int32_type->decompose(0), int32_type->decompose(1), int32_type->decompose(2), long_type->decompose(int64_t(3)), int32_type->decompose(0)},
+            {int32_type->decompose(1), int32_type->decompose(1), int32_type->decompose(12), long_type->decompose(int64_t(3)), int32_type->decompose(10)},
+            {int32_type->decompose(0), int32_type->decompose(0), int32_type->decompose(2), long_type->decompose(int64_t(3)), int32_type->decompose(0)},
+            {int32_type->decompose(1), int32_type->decompose(0), int32_type->decompose(12), long_type->decompose(int64_t(3)), int32_type->decompose(10)},
+        });
+
+        // Grouping columns needn't be selected.
+        msg = e.execute_cql("SELECT SUM(v) FROM tbl WHERE k IN (0, 1) GROUP BY k, c1, c2;").get();
+        assert_that(msg).is_rows().with_size(12);
+
+        // LIMIT applies to groups, these aren't forwarded.
+        msg = e.execute_cql("SELECT k, COUNT(*) FROM tbl GROUP BY k LIMIT 1;").get();
+        assert_that(msg).is_rows().with_rows({
+            {int32_type->decompose(1), long_type->decompose(int64_t(6))}
+        });
+
+        BOOST_CHECK_EQUAL(stat_parallelized + 3, qp.get_cql_stats().select_parallelized);
     });
 }
 
@@ -5713,3 +5878,56 @@ SEASTAR_TEST_CASE(test_setting_synchronous_updates_property) {
         );
     });
 }
+
+SEASTAR_TEST_CASE(test_prepare_from_other_shards) {
+    return do_with_cql_env_thread([](cql_test_env& e) {
+        e.execute_cql("create table t (p int primary key, v int);").get();
+        e.execute_cql("insert into t (p, v) values (1, 2);").get();
+
+        auto prepared_on_shard = [&e] (unsigned shard, cql3::prepared_cache_key_type id) {
+            return e.qp().invoke_on(shard, [id = std::move(id)] (cql3::query_processor& qp) {
+                return qp.prepare_from_other_shards(id, service::client_state::for_internal_calls()).then([&qp, &id] (auto prepared) {
+                    return bool(prepared) && bool(qp.get_prepared(id));
+                });
+            }).get0();
+        };
+
+        const sstring query = "select v from ks.t where p = ?";
+        const auto id = e.local_qp().compute_id(query, "");
+        const auto other_shard = (this_shard_id() + 1) % smp::count;
+        // Prepare the statement on this shard only.
+        e.local_qp().prepare(query, service::client_state::for_internal_calls(), false).get();
+
+        BOOST_REQUIRE(prepared_on_shard(other_shard, id));
+        // Not prepared on any shard.
+        BOOST_REQUIRE(!prepared_on_shard(other_shard, e.local_qp().compute_id("select p from ks.t where p = ?", "")));
+
+        auto msg = e.execute_prepared(id, {cql3::raw_value::make_value(int32_type->decompose(1))}).get0();
+        assert_that(msg).is_rows().with_rows({{int32_type->decompose(2)}});
+    });
+}
+
+// Statements executed without being prepared are cached by their text,
+// check they see schema changes.
+SEASTAR_TEST_CASE(test_direct_statements_cache_invalidation) {
+    return do_with_cql_env_thread([](cql_test_env& e) {
+        e.execute_cql("create table t (p int primary key, v int);").get();
+        e.execute_cql("insert into t (p, v) values (1, 2);").get();
+        assert_that(e.execute_cql("select * from t;").get0()).is_rows().with_rows({
+            {int32_type->decompose(1), int32_type->decompose(2)},
+        });
+
+        e.execute_cql("alter table t add w text;").get();
+        e.execute_cql("update t set w = 'x' where p = 1;").get();
+        assert_that(e.execute_cql("select * from t;").get0()).is_rows().with_rows({
+            {int32_type->decompose(1), int32_type->decompose(2), utf8_type->decompose("x")},
+        });
+
+        e.execute_cql("drop table t;").get();
+        e.execute_cql("create table t (p int primary key, v text);").get();
+        e.execute_cql("insert into t (p, v) values (1, 'y');").get();
+        assert_that(e.execute_cql("select * from t;").get0()).is_rows().with_rows({
+            {int32_type->decompose(1), utf8_type->decompose("y")},
+        });
+    });
+}
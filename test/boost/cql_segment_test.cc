@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <boost/test/unit_test.hpp>
+#include "test/lib/scylla_test_case.hh"
+#include <seastar/testing/thread_test_case.hh>
+
+#include "transport/segment.hh"
+#include "test/lib/random_utils.hh"
+
+using namespace cql_transport;
+
+static bytes linearize(bytes_ostream out) {
+    return bytes(out.linearize());
+}
+
+// Reads back all segments of buf, joining the frames split over several
+// segments.
+static std::vector<bytes> read_payloads(bytes_view buf, bool compressed) {
+    std::vector<bytes> ret;
+    bytes partial;
+    while (!buf.empty()) {
+        auto seg = read_segment(buf, compressed);
+        BOOST_REQUIRE(seg);
+        if (seg->self_contained) {
+            BOOST_REQUIRE(partial.empty());
+            ret.push_back(std::move(seg->payload));
+        } else {
+            partial += seg->payload;
+            if (seg->payload.size() < segment_writer::max_payload_size) {
+                ret.push_back(std::exchange(partial, bytes()));
+            }
+        }
+    }
+    BOOST_REQUIRE(partial.empty());
+    return ret;
+}
+
+SEASTAR_THREAD_TEST_CASE(test_cql_segment_round_trip) {
+    for (bool compressed : {false, true}) {
+        segment_writer w(compressed);
+        auto small = tests::random::get_bytes(100);
+        auto large = tests::random::get_bytes(segment_writer::max_payload_size * 2 + 10);
+        w.add_frame(small);
+        w.add_frame(small);
+        w.add_frame(large);
+        w.add_frame(small);
+        auto out = linearize(w.flush());
+        BOOST_REQUIRE(linearize(w.flush()).empty());
+
+        auto payloads = read_payloads(out, compressed);
+        // The small frames around the large one are coalesced.
+        BOOST_REQUIRE_EQUAL(payloads.size(), 3);
+        BOOST_REQUIRE(payloads[0] == small + small);
+        BOOST_REQUIRE(payloads[1] == large);
+        BOOST_REQUIRE(payloads[2] == small);
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(test_cql_segment_compression) {
+    segment_writer w(true);
+    bytes frame(bytes::initialized_later(), 10000);
+    std::fill(frame.begin(), frame.end(), 'a');
+    w.add_frame(frame);
+    auto out = linearize(w.flush());
+    BOOST_REQUIRE_LT(out.size(), frame.size() / 10);
+    bytes_view v(out);
+    auto seg = read_segment(v, true);
+    BOOST_REQUIRE(seg && seg->self_contained);
+    BOOST_REQUIRE(seg->payload == frame);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_cql_segment_incomplete_and_corrupt) {
+    for (bool compressed : {false, true}) {
+        segment_writer w(compressed);
+        w.add_frame(tests::random::get_bytes(1000));
+        auto out = linearize(w.flush());
+
+        for (size_t len : {size_t(0), segment_header_size(compressed) - 1, segment_header_size(compressed), out.size() - 1}) {
+            bytes_view v(out.data(), len);
+            BOOST_REQUIRE(!read_segment(v, compressed));
+            BOOST_REQUIRE_EQUAL(v.size(), len);
+        }
+
+        auto corrupt_header = out;
+        corrupt_header[1] ^= 1;
+        bytes_view v(corrupt_header);
+        BOOST_REQUIRE_THROW(read_segment(v, compressed), std::runtime_error);
+
+        auto corrupt_payload = out;
+        corrupt_payload[segment_header_size(compressed) + 10] ^= 1;
+        v = bytes_view(corrupt_payload);
+        BOOST_REQUIRE_THROW(read_segment(v, compressed), std::runtime_error);
+    }
+}
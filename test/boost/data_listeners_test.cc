@@ -12,6 +12,7 @@
 #include "test/lib/cql_test_env.hh"
 #include "test/lib/cql_assertions.hh"
 #include "test/lib/log.hh"
+#include "test/lib/eventually.hh"
 #include "cql3/query_processor.hh"
 #include "readers/filtering.hh"
 
@@ -113,3 +114,29 @@ SEASTAR_TEST_CASE(test_dlistener_t2) {
         BOOST_REQUIRE_EQUAL(0, res.write);
     });
 }
+
+SEASTAR_THREAD_TEST_CASE(test_hot_partitions) {
+    cql_test_config cfg;
+    cfg.db_config->hot_partitions_window_in_s(1);
+    do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE t1 (k int, c int, PRIMARY KEY (k, c));").get();
+
+        // The reported partitions are the ones of the last complete window,
+        // so keep the load going until one is complete.
+        eventually([&] {
+            for (int i = 0; i < 10; ++i) {
+                e.execute_cql(format("INSERT INTO t1 (k, c) VALUES (1, {});", i)).get();
+                e.execute_cql("SELECT * FROM t1 WHERE k = 1;").get();
+            }
+            e.execute_cql("INSERT INTO t1 (k, c) VALUES (2, 0);").get();
+            e.execute_cql("SELECT * FROM t1 WHERE k = 2;").get();
+
+            for (auto op : {"read", "write"}) {
+                auto msg = e.execute_cql(format("SELECT table_name, partition_key FROM system.hot_partitions WHERE operation = '{}' LIMIT 1;", op)).get0();
+                assert_that(msg).is_rows().with_rows({
+                    {utf8_type->decompose("t1"), utf8_type->decompose("1")},
+                });
+            }
+        });
+    }, std::move(cfg)).get();
+}
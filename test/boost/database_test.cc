@@ -18,6 +18,7 @@
 
 #include "test/lib/cql_test_env.hh"
 #include "test/lib/result_set_assertions.hh"
+#include "test/lib/cql_assertions.hh"
 #include "test/lib/log.hh"
 #include "test/lib/random_utils.hh"
 #include "test/lib/key_utils.hh"
@@ -252,6 +253,261 @@ SEASTAR_TEST_CASE(test_querying_with_limits) {
     });
 }
 
+SEASTAR_TEST_CASE(test_partition_digest_cache) {
+    cql_test_config cfg;
+    cfg.db_config->partition_digest_cache_entries_per_table(16);
+    return do_with_cql_env_thread([](cql_test_env& e) {
+        e.execute_cql("create table ks.cf (k text, v int, primary key (k));").get();
+        auto s = e.local_db().find_schema("ks", "cf");
+        auto uuid = s->id();
+        auto pkey = partition_key::from_single_value(*s, to_bytes("key1"));
+        auto dk = dht::decorate_key(*s, pkey);
+        auto shard = dht::shard_of(*s, dk.token());
+
+        auto write = [&] (int32_t v) {
+            mutation m(s, pkey);
+            m.set_clustered_cell(clustering_key_prefix::make_empty(), "v", v, api::new_timestamp());
+            apply_mutation(e.db(), uuid, m).get();
+        };
+        // Returns the digest and the number of hits of the digest cache.
+        auto query_digest = [&] {
+            return e.db().invoke_on(shard, [&] (replica::database& db) -> future<std::pair<query::result_digest, int64_t>> {
+                auto s = db.find_schema(uuid);
+                auto slice = partition_slice_builder(*s).with_option<query::partition_slice::option::with_digest>().build();
+                auto cmd = query::read_command(s->id(), s->version(), std::move(slice), query::max_result_size(std::numeric_limits<size_t>::max()),
+                        query::tombstone_limit::max, query::row_limit(query::max_rows));
+                auto result = std::get<0>(co_await db.query(s, cmd, query::result_options::only_digest(query::digest_algorithm::xxHash),
+                        {dht::partition_range::make_singular(dk)}, nullptr, db::no_timeout));
+                co_return std::pair(*result->digest(), db.find_column_family(uuid).get_stats().digest_cache_hits);
+            }).get();
+        };
+
+        write(1);
+        auto [d1, hits1] = query_digest();
+        BOOST_REQUIRE_EQUAL(hits1, 0);
+        auto [d2, hits2] = query_digest();
+        BOOST_REQUIRE(d2 == d1);
+        BOOST_REQUIRE_EQUAL(hits2, 1);
+
+        // Writes to the partition invalidate its digest.
+        write(2);
+        auto [d3, hits3] = query_digest();
+        BOOST_REQUIRE(d3 != d1);
+        BOOST_REQUIRE_EQUAL(hits3, 1);
+        auto [d4, hits4] = query_digest();
+        BOOST_REQUIRE(d4 == d3);
+        BOOST_REQUIRE_EQUAL(hits4, 2);
+
+        // So do changes of the sstable set.
+        e.db().invoke_on(shard, [&] (replica::database& db) {
+            return db.find_column_family(uuid).flush();
+        }).get();
+        auto [d5, hits5] = query_digest();
+        BOOST_REQUIRE(d5 == d3);
+        BOOST_REQUIRE_EQUAL(hits5, 2);
+    }, std::move(cfg));
+}
+
+SEASTAR_TEST_CASE(test_memtable_flush_compaction) {
+    return do_with_cql_env_thread([](cql_test_env& e) {
+        e.execute_cql("create table ks.cf (k text, v int, primary key (k)) with gc_grace_seconds = 0;").get();
+        auto s = e.local_db().find_schema("ks", "cf");
+        auto uuid = s->id();
+        auto& v_def = *s->get_column_definition(to_bytes("v"));
+
+        auto write = [&] (sstring key, bool expired) {
+            mutation m(s, partition_key::from_single_value(*s, to_bytes(key)));
+            auto value = int32_type->decompose(int32_t(1));
+            auto cell = expired
+                    ? atomic_cell::make_live(*int32_type, api::new_timestamp(), value, gc_clock::now() - std::chrono::hours(1), std::chrono::seconds(1))
+                    : atomic_cell::make_live(*int32_type, api::new_timestamp(), value);
+            m.set_clustered_cell(clustering_key_prefix::make_empty(), v_def, std::move(cell));
+            apply_mutation(e.db(), uuid, m).get();
+        };
+        auto flush_and_count_sstables = [&] {
+            e.db().invoke_on_all([&] (replica::database& db) {
+                return db.find_column_family(uuid).flush();
+            }).get();
+            return e.db().map_reduce0([&] (replica::database& db) {
+                return db.find_column_family(uuid).get_sstables()->size();
+            }, size_t(0), std::plus<size_t>()).get();
+        };
+
+        // The expired cells are purgeable, so nothing is left to write.
+        write("expired1", true);
+        write("expired2", true);
+        BOOST_REQUIRE_EQUAL(flush_and_count_sstables(), 0);
+
+        write("expired3", true);
+        write("live", false);
+        BOOST_REQUIRE_EQUAL(flush_and_count_sstables(), 1);
+        assert_that(e.execute_cql("select k from ks.cf;").get0())
+            .is_rows().with_rows({{utf8_type->decompose("live")}});
+    });
+}
+
+SEASTAR_TEST_CASE(test_flushed_and_compacted_bytes) {
+    return do_with_cql_env_thread([](cql_test_env& e) {
+        e.execute_cql("create table ks.cf (k text, v int, primary key (k));").get();
+        auto uuid = e.local_db().find_schema("ks", "cf")->id();
+
+        auto flush = [&] {
+            e.db().invoke_on_all([&] (replica::database& db) {
+                return db.find_column_family(uuid).flush();
+            }).get();
+        };
+        auto get_stat = [&] (int64_t replica::column_family_stats::*stat) {
+            return e.db().map_reduce0([&] (replica::database& db) {
+                return db.find_column_family(uuid).get_stats().*stat;
+            }, int64_t(0), std::plus<int64_t>()).get();
+        };
+        auto get_disk_space = [&] {
+            return get_stat(&replica::column_family_stats::live_disk_space_used);
+        };
+
+        e.execute_cql("insert into ks.cf (k, v) values ('a', 1);").get();
+        flush();
+        e.execute_cql("insert into ks.cf (k, v) values ('a', 2);").get();
+        flush();
+        auto flushed_space = get_disk_space();
+        BOOST_REQUIRE_GT(flushed_space, 0);
+        BOOST_REQUIRE_EQUAL(get_stat(&replica::column_family_stats::memtable_flushed_bytes), flushed_space);
+        BOOST_REQUIRE_EQUAL(get_stat(&replica::column_family_stats::compaction_bytes_read), 0);
+
+        e.db().invoke_on_all([&] (replica::database& db) {
+            return db.find_column_family(uuid).compact_all_sstables();
+        }).get();
+        BOOST_REQUIRE_EQUAL(get_stat(&replica::column_family_stats::memtable_flushed_bytes), flushed_space);
+        BOOST_REQUIRE_EQUAL(get_stat(&replica::column_family_stats::compaction_bytes_read), flushed_space);
+        BOOST_REQUIRE_EQUAL(get_stat(&replica::column_family_stats::compaction_bytes_written), get_disk_space());
+    });
+}
+
+SEASTAR_TEST_CASE(test_query_result_cache) {
+    return do_with_cql_env_thread([](cql_test_env& e) {
+        e.execute_cql("create table ks.cf (k text, v int, primary key (k)) with caching = {'keys': 'ALL', 'rows_per_partition': 'ALL', 'results_ttl_in_ms': '600000'};").get();
+        auto s = e.local_db().find_schema("ks", "cf");
+        auto uuid = s->id();
+        // Both on shard 0, so that the scan of the shard reads both.
+        auto keys = tests::generate_partition_keys(2, s, 0);
+
+        auto write = [&] (const dht::decorated_key& dk, int32_t v) {
+            mutation m(s, dk);
+            m.set_clustered_cell(clustering_key_prefix::make_empty(), "v", v, api::new_timestamp());
+            apply_mutation(e.db(), uuid, m).get();
+        };
+        // Returns the number of rows read and the number of hits of the result cache.
+        auto query = [&] (dht::partition_range range, bool bypass_cache = false) {
+            return e.db().invoke_on(0, [&] (replica::database& db) -> future<std::pair<uint64_t, int64_t>> {
+                auto s = db.find_schema(uuid);
+                auto slice = s->full_slice();
+                if (bypass_cache) {
+                    slice.options.set<query::partition_slice::option::bypass_cache>();
+                }
+                auto cmd = query::read_command(s->id(), s->version(), std::move(slice), query::max_result_size(std::numeric_limits<size_t>::max()),
+                        query::tombstone_limit::max, query::row_limit(query::max_rows));
+                auto result = std::get<0>(co_await db.query(s, cmd, query::result_options::only_result(), {range}, nullptr, db::no_timeout));
+                co_return std::pair(result->row_count().value_or(0), db.find_column_family(uuid).get_stats().result_cache_hits);
+            }).get();
+        };
+        auto first = dht::partition_range::make_singular(keys[0]);
+        auto all = query::full_partition_range;
+
+        write(keys[0], 1);
+        write(keys[1], 1);
+        BOOST_REQUIRE(query(all) == std::pair<uint64_t, int64_t>(2, 0));
+        BOOST_REQUIRE(query(first) == std::pair<uint64_t, int64_t>(1, 0));
+        BOOST_REQUIRE(query(all) == std::pair<uint64_t, int64_t>(2, 1));
+        BOOST_REQUIRE(query(first) == std::pair<uint64_t, int64_t>(1, 2));
+
+        // Writes only invalidate the results of the ranges they fall in.
+        write(keys[1], 2);
+        BOOST_REQUIRE(query(first) == std::pair<uint64_t, int64_t>(1, 3));
+        BOOST_REQUIRE(query(all) == std::pair<uint64_t, int64_t>(2, 3));
+        BOOST_REQUIRE(query(all) == std::pair<uint64_t, int64_t>(2, 4));
+
+        // Deleted partitions aren't returned from the cache.
+        mutation m(s, keys[0]);
+        m.partition().apply(tombstone(api::new_timestamp(), gc_clock::now()));
+        apply_mutation(e.db(), uuid, m).get();
+        BOOST_REQUIRE(query(all) == std::pair<uint64_t, int64_t>(1, 4));
+        BOOST_REQUIRE(query(first) == std::pair<uint64_t, int64_t>(0, 4));
+
+        // Reads bypassing the cache neither use nor remember results.
+        auto second = dht::partition_range::make_singular(keys[1]);
+        BOOST_REQUIRE(query(first, true) == std::pair<uint64_t, int64_t>(0, 4));
+        BOOST_REQUIRE(query(second, true) == std::pair<uint64_t, int64_t>(1, 4));
+        BOOST_REQUIRE(query(second) == std::pair<uint64_t, int64_t>(1, 4));
+        BOOST_REQUIRE(query(second) == std::pair<uint64_t, int64_t>(1, 5));
+
+        // Tables which don't opt in don't cache results.
+        e.execute_cql("alter table ks.cf with caching = {'keys': 'ALL', 'rows_per_partition': 'ALL'};").get();
+        BOOST_REQUIRE(query(all) == std::pair<uint64_t, int64_t>(1, 5));
+        BOOST_REQUIRE(query(all) == std::pair<uint64_t, int64_t>(1, 5));
+    });
+}
+
+SEASTAR_TEST_CASE(test_query_result_cache_memory_budget) {
+    cql_test_config cfg;
+    // No memory for any result.
+    cfg.db_config->query_result_cache_memory_fraction(0);
+    return do_with_cql_env_thread([](cql_test_env& e) {
+        e.execute_cql("create table ks.cf (k text, v int, primary key (k)) with caching = {'keys': 'ALL', 'rows_per_partition': 'ALL', 'results_ttl_in_ms': '600000'};").get();
+        e.execute_cql("insert into ks.cf (k, v) values ('a', 1);").get();
+        for (int i = 0; i < 3; ++i) {
+            e.execute_cql("select * from ks.cf;").get();
+        }
+        auto uuid = e.local_db().find_schema("ks", "cf")->id();
+        auto hits = e.db().map_reduce0([uuid] (replica::database& db) {
+            return db.find_column_family(uuid).get_stats().result_cache_hits;
+        }, int64_t(0), std::plus<int64_t>()).get();
+        BOOST_REQUIRE_EQUAL(hits, 0);
+    }, std::move(cfg));
+}
+
+SEASTAR_TEST_CASE(test_counter_shard_cache) {
+    cql_test_config cfg;
+    cfg.db_config->counter_shard_cache_entries_per_table(16);
+    return do_with_cql_env_thread([](cql_test_env& e) {
+        e.execute_cql("create table ks.cf (k int, c int, s counter static, v counter, primary key (k, c));").get();
+        auto uuid = e.local_db().find_schema("ks", "cf")->id();
+        auto hits = [&] {
+            return e.db().map_reduce0([uuid] (replica::database& db) {
+                return db.find_column_family(uuid).get_counter_shard_cache().get_stats().hits;
+            }, uint64_t(0), std::plus<uint64_t>()).get();
+        };
+        auto require_values = [&] (int64_t sv, int64_t v) {
+            assert_that(e.execute_cql("select s, v from ks.cf where k = 0 and c = 0;").get())
+                .is_rows().with_rows({{long_type->decompose(sv), long_type->decompose(v)}});
+        };
+
+        e.execute_cql("update ks.cf set v = v + 1 where k = 0 and c = 0;").get();
+        BOOST_REQUIRE_EQUAL(hits(), 0);
+        e.execute_cql("update ks.cf set v = v + 2 where k = 0 and c = 0;").get();
+        BOOST_REQUIRE_EQUAL(hits(), 1);
+        require_values(0, 3);
+
+        // Updates of cells which weren't updated yet read them.
+        e.execute_cql("update ks.cf set s = s + 5, v = v - 1 where k = 0 and c = 0;").get();
+        BOOST_REQUIRE_EQUAL(hits(), 1);
+        e.execute_cql("update ks.cf set s = s + 5, v = v - 1 where k = 0 and c = 0;").get();
+        BOOST_REQUIRE_EQUAL(hits(), 2);
+        require_values(10, 1);
+
+        // The values survive flushes, the cache holds shards, not deltas.
+        e.db().invoke_on_all([] (replica::database& db) { return db.flush_all_memtables(); }).get();
+        e.execute_cql("update ks.cf set v = v + 1 where k = 0 and c = 0;").get();
+        BOOST_REQUIRE_EQUAL(hits(), 3);
+        require_values(10, 2);
+
+        // Truncation forgets the cells.
+        e.execute_cql("truncate ks.cf;").get();
+        e.execute_cql("update ks.cf set s = s + 1, v = v + 1 where k = 0 and c = 0;").get();
+        BOOST_REQUIRE_EQUAL(hits(), 3);
+        require_values(1, 1);
+    });
+}
+
 static void test_database(void (*run_tests)(populate_fn_ex, bool)) {
     do_with_cql_env_and_compaction_groups([run_tests] (cql_test_env& e) {
         run_tests([&] (schema_ptr s, const std::vector<mutation>& partitions, gc_clock::time_point) -> mutation_source {
@@ -758,8 +1014,11 @@ SEASTAR_TEST_CASE(clear_nonexistent_snapshot) {
 
 SEASTAR_TEST_CASE(test_snapshot_ctl_details) {
     return do_with_some_data({"cf"}, [] (cql_test_env& e) {
+        sharded<tasks::task_manager> tm;
+        tm.start().get();
+        auto stop_tm = deferred_stop(tm);
         sharded<db::snapshot_ctl> sc;
-        sc.start(std::ref(e.db())).get();
+        sc.start(std::ref(e.db()), std::ref(tm)).get();
         auto stop_sc = deferred_stop(sc);
 
         auto& cf = e.local_db().find_column_family("ks", "cf");
@@ -808,8 +1067,11 @@ SEASTAR_TEST_CASE(test_snapshot_ctl_details) {
 
 SEASTAR_TEST_CASE(test_snapshot_ctl_true_snapshots_size) {
     return do_with_some_data({"cf"}, [] (cql_test_env& e) {
+        sharded<tasks::task_manager> tm;
+        tm.start().get();
+        auto stop_tm = deferred_stop(tm);
         sharded<db::snapshot_ctl> sc;
-        sc.start(std::ref(e.db())).get();
+        sc.start(std::ref(e.db()), std::ref(tm)).get();
         auto stop_sc = deferred_stop(sc);
 
         auto& cf = e.local_db().find_column_family("ks", "cf");
@@ -263,6 +263,64 @@ SEASTAR_TEST_CASE(test_region_groups_basic_throttling) {
     });
 }
 
+SEASTAR_TEST_CASE(test_region_groups_write_delay) {
+    return seastar::async([] {
+        raii_region_group rg({ .unspooled_hard_limit = 16 * logalloc::segment_size, .unspooled_soft_limit = logalloc::segment_size });
+        auto region = std::make_unique<test_region>();
+        region->listen(&rg);
+        rg.set_write_delay(10ms);
+
+        // Below the soft limit, requests are not delayed.
+        auto fut = rg.run_when_memory_available([] {}, db::no_timeout);
+        BOOST_REQUIRE(fut.available());
+        BOOST_REQUIRE_EQUAL(rg.delayed_requests_counter(), 0);
+
+        region->alloc();
+        region->alloc();
+        BOOST_REQUIRE(rg.over_unspooled_soft_limit());
+        BOOST_REQUIRE(!rg.under_unspooled_pressure());
+
+        auto start = std::chrono::steady_clock::now();
+        bool ran = false;
+        fut = rg.run_when_memory_available([&ran] { ran = true; }, db::no_timeout);
+        BOOST_REQUIRE(!fut.available());
+        BOOST_REQUIRE(!ran);
+        quiesce(std::move(fut));
+        BOOST_REQUIRE(ran);
+        BOOST_REQUIRE(std::chrono::steady_clock::now() - start >= 10ms);
+        BOOST_REQUIRE_EQUAL(rg.delayed_requests_counter(), 1);
+        BOOST_REQUIRE(rg.total_write_delay() == 10ms);
+
+        // Requests which would time out while delayed are not delayed.
+        fut = rg.run_when_memory_available([] {}, db::timeout_clock::now() + 5ms);
+        BOOST_REQUIRE(fut.available());
+        BOOST_REQUIRE_EQUAL(rg.delayed_requests_counter(), 1);
+
+        rg.set_write_delay(0ms);
+        fut = rg.run_when_memory_available([] {}, db::no_timeout);
+        BOOST_REQUIRE(fut.available());
+    });
+}
+
+SEASTAR_THREAD_TEST_CASE(test_dirty_memory_manager_write_delay) {
+    constexpr size_t soft = 100;
+    constexpr size_t hard = 200;
+    constexpr std::chrono::microseconds max_delay = 1000us;
+
+    // No delay below the soft limit, or when flushes keep up.
+    BOOST_REQUIRE(dirty_memory_manager::write_delay(soft, soft, hard, 2000, 1000, max_delay).count() == 0);
+    BOOST_REQUIRE(dirty_memory_manager::write_delay(hard, soft, hard, 1000, 1000, max_delay).count() == 0);
+    BOOST_REQUIRE(dirty_memory_manager::write_delay(hard, soft, hard, 1000, 2000, max_delay).count() == 0);
+
+    // The delay grows with the distance from the soft limit and with the ingestion excess.
+    BOOST_REQUIRE(dirty_memory_manager::write_delay(150, soft, hard, 1000, 0, max_delay) == 500us);
+    BOOST_REQUIRE(dirty_memory_manager::write_delay(hard, soft, hard, 1000, 0, max_delay) == max_delay);
+    BOOST_REQUIRE(dirty_memory_manager::write_delay(hard, soft, hard, 1000, 500, max_delay) == 500us);
+    BOOST_REQUIRE(dirty_memory_manager::write_delay(150, soft, hard, 1000, 500, max_delay) == 250us);
+    BOOST_REQUIRE(dirty_memory_manager::write_delay(2 * hard, soft, hard, 1000, 0, max_delay) == max_delay);
+    BOOST_REQUIRE(dirty_memory_manager::write_delay(hard, soft, hard, 1000, 0, 0us).count() == 0);
+}
+
 SEASTAR_TEST_CASE(test_region_groups_fifo_order) {
     // tests that requests that are queued for later execution execute in FIFO order
     return seastar::async([] {
@@ -109,3 +109,41 @@ BOOST_AUTO_TEST_CASE(test_estimated_statistics) {
     hist *= 0.5;
     BOOST_CHECK_EQUAL(hist.get(1), 1);
 }
+
+BOOST_AUTO_TEST_CASE(test_latency_histogram_quantiles) {
+    utils::latency_histogram hist;
+    BOOST_CHECK_EQUAL(hist.count(), 0);
+    BOOST_CHECK_EQUAL(hist.quantile(0.5), 0);
+
+    for (int i = 0; i < 50; i++) {
+        hist.add(std::chrono::microseconds(100));
+        hist.add_micro(1000);
+    }
+    BOOST_CHECK_EQUAL(hist.count(), 100);
+    // 100us is in [96, 104), 1000us in [960, 1024).
+    BOOST_CHECK_EQUAL(hist.quantile(0), 104);
+    BOOST_CHECK_EQUAL(hist.quantile(0.5), 104);
+    BOOST_CHECK_EQUAL(hist.quantile(0.51), 1024);
+    BOOST_CHECK_EQUAL(hist.quantile(1), 1024);
+
+    std::array<double, 3> qs{0.25, 0.5, 0.99};
+    std::array<uint64_t, 3> out;
+    hist.quantiles(qs, out);
+    BOOST_CHECK_EQUAL(out[0], 104);
+    BOOST_CHECK_EQUAL(out[1], 104);
+    BOOST_CHECK_EQUAL(out[2], 1024);
+
+    hist *= 0.5;
+    BOOST_CHECK_EQUAL(hist.count(), 50);
+
+    utils::latency_histogram other;
+    other.add_micro(1000000000);
+    hist.merge(other);
+    BOOST_CHECK_EQUAL(hist.count(), 51);
+    BOOST_CHECK_EQUAL(hist.quantile(1), 33554432);
+
+    hist.clear();
+    BOOST_CHECK_EQUAL(hist.count(), 0);
+    hist.quantiles(qs, out);
+    BOOST_CHECK_EQUAL(out[2], 0);
+}
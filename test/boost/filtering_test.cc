@@ -344,6 +344,52 @@ SEASTAR_TEST_CASE(test_allow_filtering_clustering_column) {
     });
 }
 
+SEASTAR_TEST_CASE(test_allow_filtering_typed_comparisons) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE t (k int, c bigint, s smallint, t text, b blob, v int, PRIMARY KEY (k, c)) WITH CLUSTERING ORDER BY (c DESC);").get();
+        e.require_table_exists("ks", "t").get();
+
+        e.execute_cql("INSERT INTO t (k, c, s, t, b, v) VALUES (-1, -300, -2, 'a', 0x00, -5)").get();
+        e.execute_cql("INSERT INTO t (k, c, s, t, b, v) VALUES (1, 300, 2, 'b', 0xff, 5)").get();
+        e.execute_cql("INSERT INTO t (k, c, s, t, b) VALUES (2, 0, 0, 'ab', 0x)").get();
+
+        auto keys = [] (std::vector<int32_t> ks) {
+            std::vector<std::vector<bytes_opt>> rows;
+            for (auto k : ks) {
+                rows.push_back({int32_type->decompose(k)});
+            }
+            return rows;
+        };
+        auto check = [&] (sstring where, std::vector<int32_t> expected) {
+            auto msg = e.execute_cql(format("SELECT k FROM t WHERE {} ALLOW FILTERING", where)).get0();
+            assert_that(msg).is_rows().with_rows_ignore_order(keys(std::move(expected)));
+        };
+
+        // Signed integers, including reversed clustering columns.
+        check("k < 1", {-1});
+        check("c > -300", {1, 2});
+        check("c <= 0", {-1, 2});
+        check("s >= 0", {1, 2});
+        check("v != -5", {1});
+        check("v < 10", {-1, 1});
+        // Strings and blobs compare bytewise, empty values first.
+        check("t > 'a'", {1, 2});
+        check("t < 'b'", {-1, 2});
+        check("b > 0x00", {1});
+        check("b < 0x01", {-1, 2});
+        // Several comparisons of a column.
+        check("c > -300 AND c < 300", {2});
+        check("v > -10 AND v < 0 AND t = 'a'", {-1});
+
+        cql3::prepared_cache_key_type prepared_id = e.prepare("SELECT k FROM t WHERE v > ? ALLOW FILTERING").get0();
+        std::vector<cql3::raw_value> raw_values {
+                cql3::raw_value::make_value(int32_type->decompose(-6)),
+        };
+        auto msg = e.execute_prepared(prepared_id, raw_values).get0();
+        assert_that(msg).is_rows().with_rows_ignore_order(keys({-1, 1}));
+    });
+}
+
 SEASTAR_TEST_CASE(test_allow_filtering_two_clustering_columns) {
     return do_with_cql_env_thread([] (cql_test_env& e) {
         e.execute_cql("CREATE TABLE t (p int, c1 int, c2 int, data int, PRIMARY KEY (p, c1, c2))").get();
@@ -1153,3 +1199,36 @@ SEASTAR_TEST_CASE(test_filtering) {
 
     });
 }
+
+SEASTAR_TEST_CASE(test_allow_filtering_paging_skips_filtered_rows) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE t (p int, c int, v int, s text, PRIMARY KEY (p, c));").get();
+        for (int p = 0; p < 4; ++p) {
+            for (int c = 0; c < 50; ++c) {
+                e.execute_cql(format("INSERT INTO t (p, c, v, s) VALUES ({}, {}, {}, '{}')", p, c, c % 10, c % 3 ? "x" : "y")).get();
+            }
+        }
+        // Rows the replicas filter out must neither end the paging early
+        // nor reach the results.
+        auto fetch_all = [&] (sstring query) {
+            std::vector<std::vector<bytes_opt>> rows;
+            lw_shared_ptr<service::pager::paging_state> paging_state;
+            do {
+                auto qo = std::make_unique<cql3::query_options>(db::consistency_level::LOCAL_ONE, std::vector<cql3::raw_value>{},
+                        cql3::query_options::specific_options{3, paging_state, {}, api::new_timestamp()});
+                auto msg = e.execute_cql(query, std::move(qo)).get0();
+                auto rs = dynamic_pointer_cast<cql_transport::messages::result_message::rows>(msg);
+                for (auto& row : rs->rs().result_set().rows()) {
+                    rows.push_back(row);
+                }
+                paging_state = extract_paging_state(msg);
+            } while (paging_state);
+            return rows;
+        };
+        BOOST_REQUIRE_EQUAL(fetch_all("SELECT p, c FROM t WHERE v = 7 ALLOW FILTERING").size(), 20U);
+        BOOST_REQUIRE_EQUAL(fetch_all("SELECT p, c FROM t WHERE v > 2 AND v <= 4 ALLOW FILTERING").size(), 40U);
+        BOOST_REQUIRE_EQUAL(fetch_all("SELECT p, c FROM t WHERE v = 0 AND s = 'y' ALLOW FILTERING").size(), 8U);
+        BOOST_REQUIRE_EQUAL(fetch_all("SELECT p, c FROM t WHERE v != 1 AND s = 'x' ALLOW FILTERING").size(), 4U * 29);
+        BOOST_REQUIRE_EQUAL(fetch_all("SELECT p, c FROM t WHERE v = 10 ALLOW FILTERING").size(), 0U);
+    });
+}
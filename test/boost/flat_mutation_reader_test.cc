@@ -471,6 +471,72 @@ SEASTAR_THREAD_TEST_CASE(test_multi_range_reader) {
             [&] { return multiple_generator; });
 }
 
+SEASTAR_THREAD_TEST_CASE(test_prefetching_multi_range_reader) {
+    simple_schema s;
+    tests::reader_concurrency_semaphore_wrapper semaphore;
+    auto permit = semaphore.make_permit();
+
+    auto keys = s.make_pkeys(10);
+    auto ring = s.to_ring_positions(keys);
+
+    auto crs = boost::copy_range<std::vector<mutation_fragment>>(boost::irange(0, 3) | boost::adaptors::transformed([&] (auto n) {
+        return s.make_row(permit, s.make_ckey(n), "value");
+    }));
+
+    auto ms = boost::copy_range<std::vector<mutation>>(keys | boost::adaptors::transformed([&] (auto& key) {
+        auto m = mutation(s.schema(), key);
+        for (auto& mf : crs) {
+            m.apply(mf);
+        }
+        return m;
+    }));
+
+    size_t readers_created = 0;
+    auto source = mutation_source([&] (schema_ptr, reader_permit permit, const dht::partition_range& range) {
+        ++readers_created;
+        return make_flat_mutation_reader_from_mutations_v2(s.schema(), std::move(permit), ms, range);
+    });
+
+    auto make_ranges = [&] {
+        return dht::partition_range_vector{
+                dht::partition_range::make_singular(ring[0]),
+                dht::partition_range::make_singular(ring[2]),
+                dht::partition_range::make(ring[3], ring[5]),
+                dht::partition_range::make_singular(ring[7]),
+                dht::partition_range::make_singular(ring[9]),
+        };
+    };
+
+    for (size_t read_ahead : {0, 1, 3, 10}) {
+        testlog.info("read ahead {}: read full partitions", read_ahead);
+        readers_created = 0;
+        assert_that(make_prefetching_multi_range_reader(s.schema(), semaphore.make_permit(), source, make_ranges(), s.schema()->full_slice(), read_ahead))
+                .produces(ms[0])
+                .produces(ms[2])
+                .produces(ms[3])
+                .produces(ms[4])
+                .produces(ms[5])
+                .produces(ms[7])
+                .produces(ms[9])
+                .produces_end_of_stream();
+        BOOST_REQUIRE_EQUAL(readers_created, 5);
+
+        testlog.info("read ahead {}: skip partitions", read_ahead);
+        // The reader is closed with the last range possibly being read ahead.
+        assert_that(make_prefetching_multi_range_reader(s.schema(), semaphore.make_permit(), source, make_ranges(), s.schema()->full_slice(), read_ahead))
+                .produces_partition_start(keys[0])
+                .next_partition()
+                .produces_partition_start(keys[2])
+                .produces_row_with_key(crs[0].as_clustering_row().key())
+                .next_partition()
+                .produces(ms[3])
+                .produces_partition_start(keys[4])
+                .next_partition()
+                .produces(ms[5])
+                .produces_partition_start(keys[7]);
+    }
+}
+
 using reversed_partitions = seastar::bool_class<class reversed_partitions_tag>;
 using skip_after_first_fragment = seastar::bool_class<class skip_after_first_fragment_tag>;
 using skip_after_first_partition = seastar::bool_class<class skip_after_first_partition_tag>;
@@ -9,8 +9,12 @@
 #include <boost/test/unit_test.hpp>
 #include "test/lib/scylla_test_case.hh"
 #include <seastar/core/smp.hh>
+#include <seastar/testing/thread_test_case.hh>
 
 #include "db/hints/sync_point.hh"
+#include "db/hints/resource_manager.hh"
+#include "db/hints/manager.hh"
+#include "test/lib/simple_schema.hh"
 
 SEASTAR_TEST_CASE(test_hint_sync_point_faithful_reserialization) {
     const unsigned encoded_shard_count = 2;
@@ -65,3 +69,52 @@ SEASTAR_TEST_CASE(test_hint_sync_point_faithful_reserialization) {
 
     return make_ready_future<>();
 }
+
+SEASTAR_TEST_CASE(test_hint_send_throttling) {
+    using clock_type = std::chrono::steady_clock;
+    using namespace std::chrono_literals;
+    const auto t0 = clock_type::now();
+
+    db::hints::resource_manager unthrottled(1 << 20, utils::updateable_value<uint32_t>(0));
+    BOOST_REQUIRE(unthrottled.consume_send_bandwidth(1 << 30, 1, t0) == clock_type::duration::zero());
+
+    // 100KiB per second, with a full bucket to begin with.
+    db::hints::resource_manager rm(1 << 20, utils::updateable_value<uint32_t>(0), utils::updateable_value<uint32_t>(100));
+    BOOST_REQUIRE(rm.consume_send_bandwidth(100 * 1024, 1, t0) == clock_type::duration::zero());
+    BOOST_REQUIRE(rm.consume_send_bandwidth(50 * 1024, 1, t0) == std::chrono::duration_cast<clock_type::duration>(500ms));
+    BOOST_REQUIRE(rm.consume_send_bandwidth(50 * 1024, 1, t0 + 1s) == clock_type::duration::zero());
+
+    // The rate is shared with the other nodes sending hints.
+    BOOST_REQUIRE(rm.consume_send_bandwidth(100 * 1024, 2, t0 + 2s) == std::chrono::duration_cast<clock_type::duration>(1s));
+
+    return make_ready_future<>();
+}
+
+SEASTAR_THREAD_TEST_CASE(test_coalesce_hints) {
+    simple_schema ss;
+    auto s = ss.schema();
+    auto pk1 = ss.make_pkey(1);
+    auto pk2 = ss.make_pkey(2);
+
+    mutation m1(s, pk1);
+    ss.add_row(m1, ss.make_ckey(1), "v1");
+    mutation m2(s, pk2);
+    ss.add_row(m2, ss.make_ckey(1), "v2");
+    mutation m3(s, pk1);
+    ss.add_row(m3, ss.make_ckey(1), "v3");
+    ss.add_row(m3, ss.make_ckey(2), "v4");
+
+    std::vector<frozen_mutation_and_schema> hints;
+    for (auto* m : {&m1, &m2, &m3}) {
+        hints.push_back(frozen_mutation_and_schema{freeze(*m), s});
+    }
+    uint64_t coalesced = 0;
+    auto result = db::hints::coalesce_hints(std::move(hints), coalesced);
+
+    BOOST_REQUIRE_EQUAL(coalesced, 1);
+    BOOST_REQUIRE_EQUAL(result.size(), 2);
+    auto expected = m1;
+    expected.apply(m3);
+    BOOST_REQUIRE(result[0].fm.unfreeze(s) == expected);
+    BOOST_REQUIRE(result[1].fm.unfreeze(s) == m2);
+}
@@ -688,6 +688,35 @@ SEASTAR_TEST_CASE(test_json_insert_null) {
     });
 }
 
+SEASTAR_TEST_CASE(test_json_escaping_and_column_names) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE t (pk text PRIMARY KEY, \"CaseSensitive\" int, m map<text, text>, s set<frozen<map<int, text>>>);").get();
+
+        e.execute_cql("INSERT INTO t JSON '{\"pk\": \"a\\\"b\\\\c\\n\\u0001\", \"\\\"CaseSensitive\\\"\": 7, "
+                "\"m\": {\"k\\\"\": \"v\\t\"}, \"s\": [{\"1\": \"x\"}]}'").get();
+
+        auto msg = e.execute_cql("SELECT JSON * FROM t").get0();
+        assert_that(msg).is_rows().with_rows({
+            {
+                utf8_type->decompose(
+                    "{\"pk\": \"a\\\"b\\\\c\\n\\u0001\", "
+                    "\"\\\"CaseSensitive\\\"\": 7, "
+                    "\"m\": {\"k\\\"\": \"v\\t\"}, "
+                    "\"s\": [{\"1\": \"x\"}]}"
+                )
+            }
+        });
+
+        BOOST_REQUIRE_THROW(e.execute_cql("INSERT INTO t JSON '{\"pk\": \"b\", \"casesensitive\": 1}'").get(), exceptions::invalid_request_exception);
+        BOOST_REQUIRE_THROW(e.execute_cql("INSERT INTO t JSON '{\"pk\": \"b\", \"nonexistent\": 1}'").get(), exceptions::invalid_request_exception);
+
+        // Unquoted names are case-insensitive.
+        e.execute_cql("INSERT INTO t JSON '{\"PK\": \"c\", \"\\\"CaseSensitive\\\"\": 8}'").get();
+        msg = e.execute_cql("SELECT \"CaseSensitive\" FROM t WHERE pk = 'c'").get0();
+        assert_that(msg).is_rows().with_rows({{int32_type->decompose(8)}});
+    });
+}
+
 SEASTAR_TEST_CASE(test_json_tuple) {
     return do_with_cql_env_thread([] (cql_test_env& e) {
         e.execute_cql("CREATE TABLE t(id int PRIMARY KEY, v tuple<int, text, float>);").get();
@@ -343,6 +343,176 @@ SEASTAR_TEST_CASE(test_merging) {
     });
 }
 
+SEASTAR_THREAD_TEST_CASE(test_large_objects_are_segregated) {
+    region reg;
+    with_allocator(reg.allocator(), [&] {
+        auto& alloc = reg.allocator();
+        // Objects up to 1024 bytes are small, larger ones which LSA still manages are large.
+        auto* small1 = alloc.construct<std::array<char, 16>>();
+        auto* small2 = alloc.construct<std::array<char, 1024>>();
+        auto* large1 = alloc.construct<std::array<char, 1025>>();
+        auto* large2 = alloc.construct<std::array<char, 8 * 1024>>();
+        auto* small3 = alloc.construct<std::array<char, 100>>();
+
+        BOOST_REQUIRE(!reg.is_in_large_object_segment(small1));
+        BOOST_REQUIRE(!reg.is_in_large_object_segment(small2));
+        BOOST_REQUIRE(reg.is_in_large_object_segment(large1));
+        BOOST_REQUIRE(reg.is_in_large_object_segment(large2));
+        BOOST_REQUIRE(!reg.is_in_large_object_segment(small3));
+
+        alloc.destroy(small1);
+        alloc.destroy(small2);
+        alloc.destroy(large1);
+        alloc.destroy(large2);
+        alloc.destroy(small3);
+    });
+    BOOST_REQUIRE_EQUAL(reg.occupancy().used_space(), 0);
+}
+
+using small_lsa_object = std::array<uint32_t, 16>;
+using large_lsa_object = std::array<uint32_t, 1024>;
+
+template <typename T>
+static managed_ref<T> make_filled(uint32_t v) {
+    T value;
+    std::ranges::fill(value, v);
+    return make_managed<T>(std::move(value));
+}
+
+// Checks that each object holds its index and is in the segments of its size class.
+template <typename T>
+static void check_lsa_objects(region& reg, const std::vector<managed_ref<T>>& objs, bool large) {
+    for (size_t i = 0; i < objs.size(); ++i) {
+        if (!objs[i]) {
+            continue;
+        }
+        BOOST_REQUIRE(std::ranges::all_of(*objs[i], [v = objs[i]->front()] (uint32_t x) { return x == v; }));
+        BOOST_REQUIRE_EQUAL(reg.is_in_large_object_segment(objs[i].get()), large);
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(test_compaction_and_eviction_of_mixed_size_objects) {
+    region reg;
+    std::vector<managed_ref<small_lsa_object>> smalls;
+    std::vector<managed_ref<large_lsa_object>> larges;
+
+    with_allocator(reg.allocator(), [&] {
+        for (uint32_t i = 0; i < 64 * 1024; ++i) {
+            smalls.push_back(make_filled<small_lsa_object>(i));
+            if (i % 16 == 0) {
+                larges.push_back(make_filled<large_lsa_object>(i));
+            }
+        }
+
+        // Leave holes in the segments of both kinds.
+        auto& random = seastar::testing::local_random_engine;
+        for (auto& o : smalls) {
+            if (tests::random::get_bool(random)) {
+                o = {};
+            }
+        }
+        for (auto& o : larges) {
+            if (tests::random::get_bool(random)) {
+                o = {};
+            }
+        }
+
+        auto reclaim_counter = reg.reclaim_counter();
+        reg.full_compaction();
+        BOOST_REQUIRE_NE(reg.reclaim_counter(), reclaim_counter);
+        check_lsa_objects(reg, smalls, false);
+        check_lsa_objects(reg, larges, true);
+
+        // Objects allocated after compaction go to segments of their class too.
+        smalls.push_back(make_filled<small_lsa_object>(1));
+        larges.push_back(make_filled<large_lsa_object>(1));
+        check_lsa_objects(reg, smalls, false);
+        check_lsa_objects(reg, larges, true);
+    });
+
+    size_t next_small = 0;
+    size_t next_large = 0;
+    reg.make_evictable([&] {
+        with_allocator(reg.allocator(), [&] {
+            while (next_small < smalls.size() && !smalls[next_small]) {
+                ++next_small;
+            }
+            while (next_large < larges.size() && !larges[next_large]) {
+                ++next_large;
+            }
+        });
+        if (next_small == smalls.size() && next_large == larges.size()) {
+            return memory::reclaiming_result::reclaimed_nothing;
+        }
+        with_allocator(reg.allocator(), [&] {
+            // Evict both kinds, mostly small ones.
+            if (next_large < larges.size() && (next_small == smalls.size() || next_small % 8 == 0)) {
+                larges[next_large++] = {};
+            } else {
+                smalls[next_small++] = {};
+            }
+        });
+        return memory::reclaiming_result::reclaimed_something;
+    });
+
+    // Evict half, then check that what's left is intact after reclaiming.
+    for (size_t i = 0; i < smalls.size() / 4; ++i) {
+        reg.evict_some();
+    }
+    with_allocator(reg.allocator(), [&] {
+        reg.full_compaction();
+        check_lsa_objects(reg, smalls, false);
+        check_lsa_objects(reg, larges, true);
+    });
+    while (reg.evict_some() == memory::reclaiming_result::reclaimed_something) {
+    }
+    BOOST_REQUIRE_EQUAL(reg.occupancy().used_space(), 0);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_merging_regions_with_large_objects) {
+    auto fill = [] (region& reg, std::vector<managed_ref<small_lsa_object>>& smalls, std::vector<managed_ref<large_lsa_object>>& larges, size_t n) {
+        with_allocator(reg.allocator(), [&] {
+            for (size_t i = 0; i < n; ++i) {
+                smalls.push_back(make_filled<small_lsa_object>(i));
+                larges.push_back(make_filled<large_lsa_object>(i));
+            }
+        });
+    };
+
+    // Both regions have an active segment for large objects, and one of them also
+    // closed ones.
+    for (auto [n1, n2] : {std::pair<size_t, size_t>(10, 10), {0, 10}, {10, 0}, {1000, 10}, {10, 1000}}) {
+        region reg1;
+        region reg2;
+        std::vector<managed_ref<small_lsa_object>> smalls;
+        std::vector<managed_ref<large_lsa_object>> larges;
+        fill(reg1, smalls, larges, n1);
+        fill(reg2, smalls, larges, n2);
+
+        reg1.merge(reg2);
+        BOOST_REQUIRE_EQUAL(reg2.occupancy().used_space(), 0);
+
+        with_allocator(reg1.allocator(), [&] {
+            check_lsa_objects(reg1, smalls, false);
+            check_lsa_objects(reg1, larges, true);
+        });
+        // The merged region keeps allocating into, and compacting, both kinds.
+        fill(reg1, smalls, larges, 100);
+        with_allocator(reg1.allocator(), [&] {
+            for (size_t i = 0; i < smalls.size(); i += 2) {
+                smalls[i] = {};
+                larges[i] = {};
+            }
+            reg1.full_compaction();
+            check_lsa_objects(reg1, smalls, false);
+            check_lsa_objects(reg1, larges, true);
+            smalls.clear();
+            larges.clear();
+        });
+        BOOST_REQUIRE_EQUAL(reg1.occupancy().used_space(), 0);
+    }
+}
+
 SEASTAR_THREAD_TEST_CASE(test_region_move) {
     logalloc::region r0;
     logalloc::region r1(std::move(r0)); // simple move
@@ -84,6 +84,22 @@ SEASTAR_TEST_CASE(test_memtable_conforms_to_mutation_source) {
     });
 }
 
+SEASTAR_TEST_CASE(test_memtable_applied_frozen_mutations_conforms_to_mutation_source) {
+    return seastar::async([] {
+        run_mutation_source_tests([](schema_ptr s, const std::vector<mutation>& partitions) {
+            auto mt = make_lw_shared<replica::memtable>(s);
+
+            for (auto&& m : partitions) {
+                mt->apply(freeze(m), m.schema());
+            }
+
+            logalloc::shard_tracker().full_compaction();
+
+            return mt->as_data_source();
+        });
+    });
+}
+
 SEASTAR_TEST_CASE(test_memtable_with_many_versions_conforms_to_mutation_source) {
     return seastar::async([] {
         tests::reader_concurrency_semaphore_wrapper semaphore;
@@ -199,6 +215,52 @@ SEASTAR_TEST_CASE(test_memtable_flush_reader) {
     });
 }
 
+SEASTAR_THREAD_TEST_CASE(test_memtable_flush_readers_of_split_ranges) {
+    simple_schema ss;
+    auto s = ss.schema();
+    tests::reader_concurrency_semaphore_wrapper semaphore;
+    replica::table_stats tbl_stats;
+    replica::dirty_memory_manager mgr;
+    auto mt = make_lw_shared<replica::memtable>(s, mgr, tbl_stats);
+
+    std::vector<mutation> muts;
+    for (auto& dk : ss.make_pkeys(100)) {
+        mutation m(s, dk);
+        ss.add_row(m, ss.make_ckey(0), "v");
+        mt->apply(m);
+        muts.push_back(std::move(m));
+    }
+
+    BOOST_REQUIRE_EQUAL(mt->split_for_flush(1).size(), 1);
+
+    auto ranges = mt->split_for_flush(4);
+    BOOST_REQUIRE_EQUAL(ranges.size(), 4);
+
+    // Flush readers of all ranges, existing at the same time, produce every partition exactly once.
+    std::vector<flat_mutation_reader_v2> readers;
+    for (auto& range : ranges) {
+        readers.push_back(mt->make_flush_reader(s, semaphore.make_permit(), default_priority_class(), range));
+    }
+    size_t produced = 0;
+    for (size_t r = 0; r < ranges.size(); ++r) {
+        auto a = assert_that(std::move(readers[r]));
+        size_t in_range = 0;
+        for (auto& m : muts) {
+            if (ranges[r].contains(m.decorated_key(), dht::ring_position_comparator(*s))) {
+                a.produces(m);
+                ++in_range;
+            }
+        }
+        a.produces_end_of_stream();
+        // The ranges start and end at the first and last partition.
+        if (r == 0 || r == ranges.size() - 1) {
+            BOOST_REQUIRE_GT(in_range, 0);
+        }
+        produced += in_range;
+    }
+    BOOST_REQUIRE_EQUAL(produced, muts.size());
+}
+
 SEASTAR_TEST_CASE(test_adding_a_column_during_reading_doesnt_affect_read_result) {
     return seastar::async([] {
         auto common_builder = schema_builder("ks", "cf")
@@ -383,6 +445,49 @@ SEASTAR_TEST_CASE(test_partition_version_consistency_after_lsa_compaction_happen
     });
 }
 
+SEASTAR_THREAD_TEST_CASE(test_single_partition_lookups_after_lsa_compaction) {
+    simple_schema ss;
+    auto s = ss.schema();
+    tests::reader_concurrency_semaphore_wrapper semaphore;
+    auto mt = make_lw_shared<replica::memtable>(s);
+
+    // Enough partitions to grow the partition hash index a few times.
+    auto keys = ss.make_pkeys(1000);
+    std::vector<mutation> expected;
+    for (auto& dk : keys) {
+        mutation m(s, dk);
+        ss.add_row(m, ss.make_ckey(1), "v1");
+        mt->apply(m);
+        expected.push_back(m);
+    }
+
+    logalloc::shard_tracker().full_compaction();
+
+    // Writes to existing partitions find them after their entries were moved.
+    for (size_t i = 0; i < keys.size(); ++i) {
+        mutation m(s, keys[i]);
+        ss.add_row(m, ss.make_ckey(2), "v2");
+        mt->apply(m);
+        expected[i].apply(m);
+    }
+    BOOST_REQUIRE_EQUAL(mt->partition_count(), keys.size());
+
+    logalloc::shard_tracker().full_compaction();
+
+    for (auto& m : expected) {
+        auto pr = dht::partition_range::make_singular(m.decorated_key());
+        assert_that(mt->make_flat_reader(s, semaphore.make_permit(), pr, s->full_slice(), default_priority_class(),
+                nullptr, streamed_mutation::forwarding::no, mutation_reader::forwarding::no))
+            .produces(m)
+            .produces_end_of_stream();
+    }
+
+    auto absent = dht::partition_range::make_singular(ss.make_pkey());
+    assert_that(mt->make_flat_reader(s, semaphore.make_permit(), absent, s->full_slice(), default_priority_class(),
+            nullptr, streamed_mutation::forwarding::no, mutation_reader::forwarding::no))
+        .produces_end_of_stream();
+}
+
 // Reproducer for #1746
 SEASTAR_TEST_CASE(test_segment_migration_during_flush) {
     return seastar::async([] {
@@ -559,6 +559,47 @@ SEASTAR_THREAD_TEST_CASE(test_read_all) {
     }).get();
 }
 
+// Best run with SMP>=2
+SEASTAR_THREAD_TEST_CASE(test_single_shard_table) {
+    auto db_cfg = make_shared<db::config>();
+    db_cfg->single_shard_tables.set({"ks.single_shard"}, utils::config_file::config_source::CommandLine);
+
+    do_with_cql_env_thread([] (cql_test_env& env) -> future<> {
+        const int num_partitions = 64;
+
+        env.execute_cql("CREATE TABLE ks.single_shard (pk int PRIMARY KEY, v int)").get();
+        env.execute_cql("CREATE TABLE ks.all_shards (pk int PRIMARY KEY, v int)").get();
+        for (int pk = 0; pk < num_partitions; ++pk) {
+            env.execute_cql(format("INSERT INTO ks.single_shard (pk, v) VALUES ({}, {})", pk, pk)).get();
+            env.execute_cql(format("INSERT INTO ks.all_shards (pk, v) VALUES ({}, {})", pk, pk)).get();
+        }
+
+        tests::require_equal(env.local_db().find_schema("ks", "single_shard")->get_sharder().shard_count(), 1u);
+        tests::require_equal(env.local_db().find_schema("ks", "all_shards")->get_sharder().shard_count(), smp::count);
+
+        const auto partitions_per_shard = env.db().map([] (replica::database& db) {
+            size_t partitions = 0;
+            for (auto* mt : db.find_column_family("ks", "single_shard").active_memtables()) {
+                partitions += mt->partition_count();
+            }
+            return partitions;
+        }).get();
+        tests::require_equal(partitions_per_shard[0], size_t(num_partitions));
+        for (unsigned shard = 1; shard < smp::count; ++shard) {
+            tests::require_equal(partitions_per_shard[shard], size_t(0));
+        }
+
+        for (const auto table : {"single_shard", "all_shards"}) {
+            auto msg = env.execute_cql(format("SELECT * FROM ks.{}", table)).get();
+            assert_that(msg).is_rows().with_size(num_partitions);
+            msg = env.execute_cql(format("SELECT count(*) FROM ks.{}", table)).get();
+            assert_that(msg).is_rows().with_rows({{long_type->decompose(int64_t(num_partitions))}});
+        }
+
+        return make_ready_future<>();
+    }, db_cfg).get();
+}
+
 // Best run with SMP>=2
 SEASTAR_THREAD_TEST_CASE(test_read_all_multi_range) {
     do_with_cql_env_thread([] (cql_test_env& env) -> future<> {
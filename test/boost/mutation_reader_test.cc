@@ -232,6 +232,44 @@ SEASTAR_THREAD_TEST_CASE(combined_reader_galloping_changing_multiple_partitions_
         .produces_end_of_stream();
 }
 
+// Exercises the fragment tree of the combined reader with many readers
+// interleaving their rows, with a different number of readers taking
+// part in each partition, and rows shared by several readers.
+SEASTAR_THREAD_TEST_CASE(combined_reader_many_interleaving_readers_test) {
+    simple_schema s;
+    tests::reader_concurrency_semaphore_wrapper semaphore;
+    auto permit = semaphore.make_permit();
+
+    const auto k = s.make_pkeys(3);
+    const std::array<int, 3> readers_per_partition = {5, 11, 3};
+    const int rows = 64;
+
+    std::vector<std::vector<mutation>> reader_mutations(11);
+    for (size_t p = 0; p < k.size(); ++p) {
+        const int n = readers_per_partition[p];
+        for (int r = 0; r < n; ++r) {
+            std::vector<int> ckeys;
+            for (int i = 0; i < rows; ++i) {
+                // Every third row is shared by two readers.
+                if (i % n == r || (i % 3 == 0 && (i + 1) % n == r)) {
+                    ckeys.push_back(i);
+                }
+            }
+            reader_mutations[r].push_back(make_partition_with_clustering_rows(s, k[p], ckeys));
+        }
+    }
+
+    std::vector<flat_mutation_reader_v2> v;
+    for (auto& muts : reader_mutations) {
+        v.push_back(make_flat_mutation_reader_from_mutations_v2(s.schema(), permit, std::move(muts)));
+    }
+    auto assertions = assert_that(make_combined_reader(s.schema(), permit, std::move(v), streamed_mutation::forwarding::no, mutation_reader::forwarding::no));
+    for (auto& pk : k) {
+        assertions.produces(make_partition_with_clustering_rows(s, pk, boost::irange(0, rows)));
+    }
+    assertions.produces_end_of_stream();
+}
+
 SEASTAR_THREAD_TEST_CASE(test_combined_reader_range_tombstone_change_merging) {
     simple_schema s;
     const auto schema = s.schema();
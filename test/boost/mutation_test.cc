@@ -394,6 +394,58 @@ SEASTAR_THREAD_TEST_CASE(test_udt_mutations) {
     });
 }
 
+SEASTAR_THREAD_TEST_CASE(test_collection_mutation_view_index) {
+    auto my_map_type = map_type_impl::get_instance(int32_type, int32_type, true);
+
+    collection_mutation_description desc;
+    desc.tomb = tombstone(1, gc_clock::now());
+    for (int k = 0; k < 1000; k += 2) {
+        desc.cells.emplace_back(int32_type->decompose(k), make_collection_member(int32_type, k * 10));
+    }
+    auto cm = desc.serialize(*my_map_type);
+
+    collection_mutation_view_index index(*my_map_type, cm);
+    BOOST_REQUIRE_EQUAL(index.size(), 500);
+    BOOST_REQUIRE(index.tomb() == desc.tomb);
+
+    for (int k = -1; k <= 1000; ++k) {
+        auto key = managed_bytes(int32_type->decompose(k));
+        auto cell = index.find(key);
+        if (k >= 0 && k < 1000 && k % 2 == 0) {
+            BOOST_REQUIRE(cell);
+            BOOST_REQUIRE_EQUAL(value_cast<int32_t>(int32_type->deserialize(cell->value().linearize())), k * 10);
+        } else {
+            BOOST_REQUIRE(!cell);
+        }
+        BOOST_REQUIRE_EQUAL(index.lower_bound(key), size_t(std::clamp((k + 1) / 2, 0, 500)));
+    }
+
+    // The index agrees with the full deserialization.
+    collection_mutation_view(cm).with_deserialized(*my_map_type, [&] (collection_mutation_view_description m) {
+        BOOST_REQUIRE_EQUAL(m.cells.size(), index.size());
+        for (size_t i = 0; i < index.size(); ++i) {
+            auto [key, cell] = index[i];
+            BOOST_REQUIRE(managed_bytes_view(m.cells[i].first) == key);
+            BOOST_REQUIRE_EQUAL(cell.timestamp(), m.cells[i].second.timestamp());
+        }
+    });
+
+    // Field indexes of user types are indexed too.
+    auto ut = user_type_impl::get_instance("ks", to_bytes("ut"),
+            {to_bytes("a"), to_bytes("b"), to_bytes("c")},
+            {int32_type, utf8_type, long_type},
+            true);
+    auto udt_mut = make_collection_mutation({}, serialize_field_index(0), make_collection_member(int32_type, 0),
+            serialize_field_index(2), make_collection_member(long_type, int64_t(2))).serialize(*ut);
+    collection_mutation_view_index udt_index(*ut, udt_mut);
+    BOOST_REQUIRE_EQUAL(udt_index.size(), 2);
+    BOOST_REQUIRE(udt_index.find(managed_bytes(serialize_field_index(0))));
+    BOOST_REQUIRE(!udt_index.find(managed_bytes(serialize_field_index(1))));
+    auto c = udt_index.find(managed_bytes(serialize_field_index(2)));
+    BOOST_REQUIRE(c);
+    BOOST_REQUIRE_EQUAL(value_cast<int64_t>(long_type->deserialize(c->value().linearize())), 2);
+}
+
 // Verify that serializing and unserializing a large collection doesn't
 // trigger any large allocations.
 // We create a 8MB collection, composed of key/value pairs of varying
@@ -3492,3 +3544,54 @@ SEASTAR_TEST_CASE(test_tracing_format) {
     BOOST_CHECK_EQUAL(formatted, "{key: pk{0103}, token: 42}");
     return make_ready_future();
  }
+
+SEASTAR_THREAD_TEST_CASE(test_tombstone_gc_watermarks) {
+    tests::reader_concurrency_semaphore_wrapper semaphore;
+
+    auto s = schema_builder("ks", "cf")
+            .with_column("pk", int32_type, column_kind::partition_key)
+            .with_column("v", int32_type)
+            .with_tombstone_gc_options(tombstone_gc_options({{"mode", "repair"}, {"propagation_delay_in_seconds", "0"}}))
+            .build();
+
+    std::vector<mutation> mutations;
+    const auto now = gc_clock::now();
+    for (int32_t pk = 0; pk < 4; ++pk) {
+        auto dk = dht::decorate_key(*s, partition_key::from_single_value(*s, int32_type->decompose(pk)));
+        mutations.emplace_back(s, std::move(dk));
+        mutations.back().partition().apply(tombstone(1, now - std::chrono::hours(1)));
+    }
+    std::sort(mutations.begin(), mutations.end(), [&] (const mutation& a, const mutation& b) {
+        return a.decorated_key().less_compare(*s, b.decorated_key());
+    });
+
+    // Repair the first and the last partition only.
+    per_table_history_maps maps;
+    auto gc_state = tombstone_gc_state(&maps);
+    gc_state.update_repair_time(s->id(), dht::token_range::make_singular(mutations.front().token()), now);
+    gc_state.update_repair_time(s->id(), dht::token_range::make_singular(mutations.back().token()), now);
+
+    auto snapshot = gc_state.with_watermarks(*s);
+    for (const auto& m : mutations) {
+        BOOST_REQUIRE(snapshot.get_gc_before_for_key(s, m.decorated_key(), now) == gc_state.get_gc_before_for_key(s, m.decorated_key(), now));
+    }
+    BOOST_REQUIRE(snapshot.get_gc_before_for_key(s, mutations.front().decorated_key(), now) == now);
+    BOOST_REQUIRE(snapshot.get_gc_before_for_key(s, mutations[1].decorated_key(), now) == gc_clock::time_point::min());
+
+    // Repairs done after the snapshot was taken are not seen by it.
+    gc_state.update_repair_time(s->id(), dht::token_range::make_singular(mutations[1].token()), now);
+    BOOST_REQUIRE(gc_state.get_gc_before_for_key(s, mutations[1].decorated_key(), now) == now);
+    BOOST_REQUIRE(snapshot.get_gc_before_for_key(s, mutations[1].decorated_key(), now) == gc_clock::time_point::min());
+
+    auto reader = make_flat_mutation_reader_from_mutations_v2(s, semaphore.make_permit(), mutations);
+    auto close_reader = deferred_close(reader);
+    auto get_max_purgeable = [] (const dht::decorated_key&) {
+        return api::max_timestamp;
+    };
+    reader.consume_in_thread(compact_for_compaction_v2<noop_compacted_fragments_consumer, noop_compacted_fragments_consumer>(
+            *s, now, get_max_purgeable, snapshot, noop_compacted_fragments_consumer(), noop_compacted_fragments_consumer()));
+
+    // The tombstones of the two partitions which weren't repaired when the snapshot was taken.
+    BOOST_REQUIRE_EQUAL(snapshot.tombstones_retained_for_repair(), 2u);
+    BOOST_REQUIRE_EQUAL(gc_state.tombstones_retained_for_repair(), 0u);
+}
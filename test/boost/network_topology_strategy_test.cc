@@ -611,6 +611,63 @@ SEASTAR_THREAD_TEST_CASE(testCalculateEndpoints) {
     }
 }
 
+// Checks the replicas found through the flat ring of the effective
+// replication map against those of the first token of the ring not less
+// than the searched one.
+SEASTAR_THREAD_TEST_CASE(test_natural_endpoints_ring_lookup) {
+    utils::fb_utilities::set_broadcast_address(gms::inet_address("localhost"));
+    utils::fb_utilities::set_broadcast_rpc_address(gms::inet_address("localhost"));
+
+    std::unordered_map<sstring, size_t> datacenters = {
+                    { "rf1", 1 },
+                    { "rf3", 3 },
+    };
+    auto ars_ptr = abstract_replication_strategy::create_replication_strategy("NetworkTopologyStrategy", {{"rf1", "1"}, {"rf3", "3"}});
+
+    // Rings smaller than, about as large as, and much larger than the window
+    // searched with SIMD.
+    for (size_t vnodes : {1, 4, 64}) {
+        std::vector<inet_address> nodes;
+        std::generate_n(std::back_inserter(nodes), 5, [i = 0u]() mutable {
+            return inet_address((127u << 24) | ++i);
+        });
+
+        semaphore sem(1);
+        shared_token_metadata stm([&sem] () noexcept { return get_units(sem, 1); }, locator::token_metadata::config{});
+        stm.mutate_token_metadata([&] (token_metadata& tm) -> future<> {
+            generate_topology(tm.get_topology(), datacenters, nodes);
+            for (auto& node : nodes) {
+                std::unordered_set<token> tokens;
+                while (tokens.size() < vnodes) {
+                    tokens.insert(dht::token::get_random_token());
+                }
+                co_await tm.update_normal_tokens(std::move(tokens), node);
+            }
+        }).get();
+
+        auto tmptr = stm.get();
+        auto erm = calculate_effective_replication_map(ars_ptr, tmptr).get0();
+        auto check = [&] (const token& t) {
+            auto expected = erm->get_replication_map().at(tmptr->first_token(t));
+            BOOST_REQUIRE(erm->get_natural_endpoints(t) == expected);
+        };
+        auto shift = [] (const token& t, int64_t by) {
+            return dht::token::from_int64(int64_t(uint64_t(dht::token::to_int64(t)) + by));
+        };
+
+        check(dht::minimum_token());
+        check(dht::maximum_token());
+        for (auto& t : tmptr->sorted_tokens()) {
+            check(t);
+            check(shift(t, -1));
+            check(shift(t, 1));
+        }
+        for (size_t i = 0; i < 1000; ++i) {
+            check(dht::token::get_random_token());
+        }
+    }
+}
+
 SEASTAR_TEST_CASE(test_invalid_dcs) {
     return do_with_cql_env_thread([] (auto& e) {
         for (auto& incorrect : std::vector<std::string>{"3\"", "", "!!!", "abcb", "!3", "-5", "0x123", "999999999999999999999999999999"}) {
@@ -328,6 +328,16 @@ class test_querier_cache {
         return *this;
     }
 
+    test_querier_cache& enable_prefetch() {
+        _cache.set_prefetch(true);
+        return *this;
+    }
+
+    test_querier_cache& prefetches() {
+        BOOST_REQUIRE_EQUAL(_cache.get_stats().prefetches, ++_expected_stats.prefetches);
+        return *this;
+    }
+
     test_querier_cache& no_misses() {
         BOOST_REQUIRE_EQUAL(_cache.get_stats().misses, _expected_stats.misses);
         return *this;
@@ -720,6 +730,35 @@ SEASTAR_THREAD_TEST_CASE(test_resources_based_cache_eviction) {
     }, std::move(db_cfg_ptr)).get();
 }
 
+SEASTAR_THREAD_TEST_CASE(test_prefetch_next_page) {
+    // Rows larger than the buffer of the reader, so that the first page ends
+    // with nothing buffered.
+    test_querier_cache t([] (size_t) {
+        return make_string_blob(2 * test_querier_cache::max_reader_buffer_size);
+    });
+    t.enable_prefetch();
+
+    auto entry = t.produce_first_page_and_save_data_querier(1, t.make_default_partition_range());
+    t.prefetches();
+    t.assert_cache_lookup_data_querier(entry.key, *t.get_schema(), entry.expected_range, entry.expected_slice)
+        .no_misses()
+        .no_drops()
+        .no_evictions();
+
+    // Prefetched queriers are still evicted when resources are needed.
+    entry = t.produce_first_page_and_save_data_querier(2, t.make_default_partition_range());
+    t.prefetches();
+    // It's registered as an inactive read once the buffer is filled.
+    while (!t.get_semaphore().get_stats().inactive_reads) {
+        seastar::thread::yield();
+    }
+    BOOST_REQUIRE(t.get_semaphore().try_evict_one_inactive_read(reader_concurrency_semaphore::evict_reason::permit));
+    t.assert_cache_lookup_data_querier(entry.key, *t.get_schema(), entry.expected_range, entry.expected_slice)
+        .misses()
+        .no_drops()
+        .resource_based_evictions();
+}
+
 SEASTAR_THREAD_TEST_CASE(test_immediate_evict_on_insert) {
     test_querier_cache t;
 
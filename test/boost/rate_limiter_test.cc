@@ -127,3 +127,55 @@ SEASTAR_TEST_CASE(test_rate_limiter_account_operation) {
     }
     BOOST_REQUIRE(encountered_rejection);
 }
+
+static uint64_t sketch_hash(uint64_t key) {
+    // Any well mixed 64-bit hash will do, take the murmur finalizer.
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    key *= 0xc4ceb3fe1a85ec53ULL;
+    key ^= key >> 33;
+    return key;
+}
+
+SEASTAR_TEST_CASE(test_frequency_sketch_never_underestimates) {
+    db::frequency_sketch sketch(UINT32_MAX);
+    const uint64_t hot_key = 0;
+    uint32_t hot_count = 0;
+    for (uint64_t key = 1; key < 1000 * 1000; key++) {
+        sketch.increase_and_estimate(sketch_hash(key));
+        if (key % 100 == 0) {
+            BOOST_REQUIRE_GE(sketch.increase_and_estimate(sketch_hash(hot_key)), ++hot_count);
+        }
+        co_await maybe_yield();
+    }
+    BOOST_REQUIRE_GE(sketch.estimate(sketch_hash(hot_key)), hot_count);
+
+    sketch.decay();
+    BOOST_REQUIRE_GE(sketch.estimate(sketch_hash(hot_key)), hot_count / 2);
+}
+
+// Measures how often a partition which had a single operation would be
+// considered over the limit, when a second's worth of operations on
+// distinct partitions were counted in the sketch.
+SEASTAR_TEST_CASE(test_frequency_sketch_false_positive_rate) {
+    const uint64_t limit = 100;
+    const uint64_t ops_per_second = 200 * 1000;
+    const uint64_t probes = 100 * 1000;
+    db::frequency_sketch sketch((1 << test_rate_limiter::op_count_bits) - 1);
+
+    for (uint64_t key = 0; key < ops_per_second; key++) {
+        sketch.increase_and_estimate(sketch_hash(key));
+        co_await maybe_yield();
+    }
+    uint64_t over_limit = 0;
+    for (uint64_t key = ops_per_second; key < ops_per_second + probes; key++) {
+        // The rate limiter starts rejecting above twice the limit.
+        if (sketch.estimate(sketch_hash(key)) + 1 > 2 * limit) {
+            ++over_limit;
+        }
+    }
+    BOOST_TEST_MESSAGE(fmt::format("{} of {} cold partitions over the limit of {} ops/s with {} ops/s in the sketch",
+            over_limit, probes, limit, ops_per_second));
+    BOOST_REQUIRE_LE(over_limit, probes / 1000);
+}
@@ -1896,3 +1896,168 @@ SEASTAR_THREAD_TEST_CASE(test_reader_concurrency_semaphore_necessary_evicting) {
         semaphore.set_resources(initial_resources);
     }
 }
+
+// Point reads are admitted ahead of queued scans, and scans are queued while
+// admitted scans reach the scan cost limit.
+SEASTAR_THREAD_TEST_CASE(test_reader_concurrency_semaphore_admission_lanes) {
+    simple_schema s;
+    const auto schema_ptr = s.schema().get();
+    const auto initial_resources = reader_concurrency_semaphore::resources{1, 10 * 1024};
+    reader_concurrency_semaphore semaphore(reader_concurrency_semaphore::for_tests{}, get_name(), initial_resources.count, initial_resources.memory);
+    auto stop_sem = deferred_stop(semaphore);
+
+    std::vector<sstring> admitted;
+    auto run = [&] (sstring name, read_cost cost) {
+        return semaphore.with_permit(schema_ptr, get_name(), 1024, cost, db::no_timeout, {}, [&admitted, name] (reader_permit) {
+            admitted.push_back(name);
+            return make_ready_future<>();
+        });
+    };
+
+    // Point reads don't queue behind scans.
+    {
+        reader_permit_opt permit = semaphore.obtain_permit(schema_ptr, get_name(), 1024, db::no_timeout, {}).get();
+
+        auto scan_fut = run("scan", read_cost{read_lane::scan, 1});
+        auto point_fut = run("point", read_cost{read_lane::point, 1});
+        BOOST_REQUIRE_EQUAL(semaphore.get_stats().waiters, 2);
+
+        permit = {};
+        when_all_succeed(std::move(scan_fut), std::move(point_fut)).get();
+        BOOST_REQUIRE(admitted == (std::vector<sstring>{"point", "scan"}));
+        BOOST_REQUIRE_EQUAL(semaphore.get_stats().point_reads_admitted_from_queue, 1);
+        BOOST_REQUIRE_EQUAL(semaphore.get_stats().scan_reads_admitted_from_queue, 1);
+        BOOST_REQUIRE_EQUAL(semaphore.get_stats().scan_cost, 0);
+    }
+
+    // Scans are limited by their cost, point reads are not.
+    {
+        semaphore.set_resources({10, initial_resources.memory});
+        semaphore.set_scan_cost_limit(utils::updateable_value<uint32_t>(10));
+        admitted.clear();
+
+        promise<> release;
+        auto expensive_scan_fut = semaphore.with_permit(schema_ptr, get_name(), 1024, read_cost{read_lane::scan, 20}, db::no_timeout, {},
+                [&release] (reader_permit permit) {
+            return release.get_future().finally([permit] { });
+        });
+        thread::yield();
+        // A scan is admitted when it is the only one, even if above the limit.
+        BOOST_REQUIRE_EQUAL(semaphore.get_stats().scan_cost, 20);
+
+        auto scan_fut = run("scan", read_cost{read_lane::scan, 1});
+        BOOST_REQUIRE_EQUAL(semaphore.get_stats().waiters, 1);
+        BOOST_REQUIRE_EQUAL(semaphore.get_stats().reads_queued_because_scan_cost, 1);
+
+        run("point", read_cost{read_lane::point, 5}).get();
+        BOOST_REQUIRE(admitted == (std::vector<sstring>{"point"}));
+
+        release.set_value();
+        expensive_scan_fut.get();
+        scan_fut.get();
+        BOOST_REQUIRE(admitted == (std::vector<sstring>{"point", "scan"}));
+        BOOST_REQUIRE_EQUAL(semaphore.get_stats().scan_cost, 0);
+    }
+}
+
+// Among inactive reads, the one which is the cheapest to recreate is evicted first,
+// not the oldest one.
+SEASTAR_THREAD_TEST_CASE(test_reader_concurrency_semaphore_evicts_cheapest_inactive_read) {
+    simple_schema s;
+    reader_concurrency_semaphore semaphore(reader_concurrency_semaphore::no_limits{}, get_name());
+    auto stop_sem = deferred_stop(semaphore);
+
+    auto expensive_permit = semaphore.make_tracking_only_permit(s.schema().get(), get_name(), db::no_timeout, {});
+    expensive_permit.on_start_sstable_read();
+    expensive_permit.on_start_sstable_read();
+    auto cheap_permit = semaphore.make_tracking_only_permit(s.schema().get(), get_name(), db::no_timeout, {});
+
+    auto expensive_handle = semaphore.register_inactive_read(make_empty_flat_reader_v2(s.schema(), expensive_permit));
+    auto cheap_handle = semaphore.register_inactive_read(make_empty_flat_reader_v2(s.schema(), cheap_permit));
+    BOOST_REQUIRE(expensive_handle);
+    BOOST_REQUIRE(cheap_handle);
+
+    BOOST_REQUIRE(semaphore.try_evict_one_inactive_read(reader_concurrency_semaphore::evict_reason::permit));
+    BOOST_REQUIRE(expensive_handle);
+    BOOST_REQUIRE(!cheap_handle);
+    BOOST_REQUIRE_EQUAL(semaphore.get_stats().permit_based_evictions, 1);
+    BOOST_REQUIRE_EQUAL(semaphore.get_stats().permit_based_evictions_sstables, 0);
+
+    BOOST_REQUIRE(semaphore.try_evict_one_inactive_read(reader_concurrency_semaphore::evict_reason::permit));
+    BOOST_REQUIRE(!expensive_handle);
+    BOOST_REQUIRE_EQUAL(semaphore.get_stats().permit_based_evictions, 2);
+    BOOST_REQUIRE_EQUAL(semaphore.get_stats().permit_based_evictions_sstables, 2);
+
+    expensive_permit.on_finish_sstable_read();
+    expensive_permit.on_finish_sstable_read();
+}
+
+// Scans are not starved by point reads: the oldest waiting scan goes first
+// after max_point_reads_ahead_of_scan point reads were admitted ahead of it,
+// even if it is held back by the scan cost limit.
+SEASTAR_THREAD_TEST_CASE(test_reader_concurrency_semaphore_scan_aging) {
+    simple_schema s;
+    const auto schema_ptr = s.schema().get();
+    const auto initial_resources = reader_concurrency_semaphore::resources{1, 10 * 1024};
+    reader_concurrency_semaphore semaphore(reader_concurrency_semaphore::for_tests{}, get_name(), initial_resources.count, initial_resources.memory);
+    auto stop_sem = deferred_stop(semaphore);
+    const auto max_points = reader_concurrency_semaphore::max_point_reads_ahead_of_scan;
+
+    std::vector<sstring> admitted;
+    auto run = [&] (sstring name, read_cost cost) {
+        return semaphore.with_permit(schema_ptr, get_name(), 1024, cost, db::no_timeout, {}, [&admitted, name] (reader_permit) {
+            admitted.push_back(name);
+            return make_ready_future<>();
+        });
+    };
+
+    // Queued point reads don't starve a queued scan.
+    {
+        reader_permit_opt permit = semaphore.obtain_permit(schema_ptr, get_name(), 1024, db::no_timeout, {}).get();
+
+        std::vector<future<>> futs;
+        futs.push_back(run("scan", read_cost{read_lane::scan, 1}));
+        for (uint32_t i = 0; i < max_points + 2; ++i) {
+            futs.push_back(run("point", read_cost{read_lane::point, 1}));
+        }
+
+        permit = {};
+        when_all_succeed(futs.begin(), futs.end()).get();
+        std::vector<sstring> expected(max_points, "point");
+        expected.push_back("scan");
+        expected.push_back("point");
+        expected.push_back("point");
+        BOOST_REQUIRE(admitted == expected);
+    }
+
+    // Point reads admitted right away don't starve a scan held back by the scan cost limit.
+    {
+        semaphore.set_resources({10, initial_resources.memory});
+        semaphore.set_scan_cost_limit(utils::updateable_value<uint32_t>(10));
+        admitted.clear();
+
+        promise<> release;
+        auto expensive_scan_fut = semaphore.with_permit(schema_ptr, get_name(), 1024, read_cost{read_lane::scan, 20}, db::no_timeout, {},
+                [&release] (reader_permit permit) {
+            return release.get_future().finally([permit] { });
+        });
+        thread::yield();
+        BOOST_REQUIRE_EQUAL(semaphore.get_stats().scan_cost, 20);
+
+        auto scan_fut = run("scan", read_cost{read_lane::scan, 1});
+        BOOST_REQUIRE_EQUAL(semaphore.get_stats().waiters, 1);
+
+        for (uint32_t i = 0; i < max_points - 1; ++i) {
+            run("point", read_cost{read_lane::point, 1}).get();
+        }
+        BOOST_REQUIRE(!scan_fut.available());
+        run("point", read_cost{read_lane::point, 1}).get();
+        scan_fut.get();
+        BOOST_REQUIRE_EQUAL(admitted.size(), max_points + 1);
+        BOOST_REQUIRE_EQUAL(std::ranges::count(admitted, "scan"), 1);
+
+        release.set_value();
+        expensive_scan_fut.get();
+        BOOST_REQUIRE_EQUAL(semaphore.get_stats().scan_cost, 0);
+    }
+}
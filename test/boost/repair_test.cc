@@ -13,10 +13,14 @@
 #include "repair/row.hh"
 #include "repair/writer.hh"
 #include "repair/row_level.hh"
+#include "replica/repair_range_summaries.hh"
+#include "repair/row_buf_size_controller.hh"
+#include "repair/repair_scheduler.hh"
 #include "test/lib/mutation_source_test.hh"
 #include "test/lib/random_utils.hh"
 #include "test/lib/reader_concurrency_semaphore.hh"
 #include "test/lib/scylla_test_case.hh"
+#include <seastar/testing/thread_test_case.hh>
 #include "readers/mutation_fragment_v1_stream.hh"
 
 // Helper mutation_fragment_queue that stores the received stream of
@@ -133,3 +137,159 @@ SEASTAR_TEST_CASE(flush_repair_rows_on_wire_to_sstable) {
     });
 }
 
+SEASTAR_THREAD_TEST_CASE(test_repair_range_summaries) {
+    auto token = [] (int64_t v) {
+        return dht::token(dht::token::kind::key, v);
+    };
+    auto range = [&] (int64_t start, int64_t end) {
+        return dht::token_range::make({token(start), false}, {token(end), true});
+    };
+    auto summary = [] (uint64_t seed, uint64_t hash) {
+        return std::optional<repair_range_summary>(repair_range_summary{seed, repair_hash(hash)});
+    };
+    auto now = gc_clock::now();
+    replica::repair_range_summaries summaries;
+    const auto k1 = replica::repair_range_summaries::key{range(0, 10), 0, 2, 12};
+    const auto k1_other_shard = replica::repair_range_summaries::key{range(0, 10), 1, 2, 12};
+    const auto k2 = replica::repair_range_summaries::key{range(10, 20), 0, 2, 12};
+
+    // Summaries are only found once committed by the repair which began them.
+    summaries.begin(k1, 1);
+    summaries.begin(k1_other_shard, 1);
+    summaries.begin(k2, 1);
+    BOOST_REQUIRE(!summaries.find(k1, now));
+    summaries.commit(k1, 2, repair_hash(7), now);
+    BOOST_REQUIRE(!summaries.find(k1, now));
+    summaries.commit(k1, 1, repair_hash(7), now);
+    summaries.commit(k1_other_shard, 1, repair_hash(8), now);
+    summaries.commit(k2, 1, repair_hash(9), now);
+    BOOST_REQUIRE(summaries.find(k1, now) == summary(1, 7));
+    BOOST_REQUIRE(summaries.find(k1_other_shard, now) == summary(1, 8));
+    BOOST_REQUIRE(!summaries.find(k1, now + std::chrono::seconds(1)));
+
+    // A new repair keeps the summary of the last one until it commits.
+    summaries.begin(k1, 3);
+    BOOST_REQUIRE(summaries.find(k1, now) == summary(1, 7));
+    summaries.commit(k1, 3, repair_hash(10), now);
+    BOOST_REQUIRE(summaries.find(k1, now) == summary(3, 10));
+
+    // Writes drop the summaries of the range holding them, and only those.
+    summaries.invalidate(token(10));
+    BOOST_REQUIRE(!summaries.find(k1, now));
+    BOOST_REQUIRE(!summaries.find(k1_other_shard, now));
+    BOOST_REQUIRE(summaries.find(k2, now));
+    summaries.invalidate(token(30));
+    BOOST_REQUIRE(summaries.find(k2, now));
+
+    // Writes between begin() and commit() keep the range from being summarized.
+    summaries.begin(k1, 4);
+    summaries.invalidate(token(5));
+    summaries.commit(k1, 4, repair_hash(11), now);
+    BOOST_REQUIRE(!summaries.find(k1, now));
+
+    // So do sstables added with some of the tokens of the range.
+    summaries.invalidate(range(15, 25));
+    BOOST_REQUIRE(!summaries.find(k2, now));
+    BOOST_REQUIRE(summaries.empty());
+
+    // Ranges overlapping a new one are dropped.
+    summaries.begin(k2, 5);
+    summaries.commit(k2, 5, repair_hash(12), now);
+    summaries.begin(replica::repair_range_summaries::key{range(5, 15), 0, 2, 12}, 6);
+    BOOST_REQUIRE(!summaries.find(k2, now));
+}
+
+SEASTAR_THREAD_TEST_CASE(test_row_buf_size_controller) {
+    using namespace std::chrono_literals;
+    constexpr size_t MiB = 1024 * 1024;
+    row_buf_size_controller c(32 * MiB);
+
+    // Until ranges observe anything, buffers have the default size, within the budget.
+    BOOST_REQUIRE_EQUAL(c.size(1024 * MiB), 32 * MiB);
+    BOOST_REQUIRE_EQUAL(c.size(8 * MiB), 8 * MiB);
+    BOOST_REQUIRE_EQUAL(c.memory_for(8 * MiB), 8 * MiB);
+
+    // Buffers are sized for rounds to last rtts_per_round round trips.
+    c.observe_rtt(100ms);
+    c.observe_range(64 * MiB, 64 * 1024, 2, 1s);
+    BOOST_REQUIRE_EQUAL(c.size(1024 * MiB), size_t(64 * MiB * 0.1 * row_buf_size_controller::rtts_per_round));
+    // Ranges which fit in a round don't change the rate.
+    c.observe_range(1 * MiB, 1024, 1, 1s);
+    BOOST_REQUIRE_EQUAL(c.bytes_per_second(), 64 * MiB);
+
+    // Small rows shrink buffers to fit their overhead in the budget.
+    row_buf_size_controller small_rows(32 * MiB);
+    small_rows.observe_range(16 * MiB, 16 * MiB / 64, 1, 1s);
+    auto size = small_rows.size(32 * MiB);
+    BOOST_REQUIRE_EQUAL(size, 32 * MiB * 64 / (64 + row_buf_size_controller::row_overhead));
+    BOOST_REQUIRE_LE(small_rows.memory_for(size), 32 * MiB);
+
+    // Buffers never shrink below min_size.
+    row_buf_size_controller fast_link(32 * MiB);
+    fast_link.observe_rtt(1us);
+    fast_link.observe_range(1 * MiB, 1024, 2, 1s);
+    BOOST_REQUIRE_EQUAL(fast_link.size(1024 * MiB), row_buf_size_controller::min_size);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_repair_scheduler) {
+    using pc = repair_scheduler::priority_class;
+    repair_scheduler s(2);
+
+    auto p1 = s.acquire(pc::repair).get0();
+    auto p2 = s.acquire(pc::repair).get0();
+    auto queued_repair = s.acquire(pc::repair);
+    auto queued_node_ops = s.acquire(pc::node_ops);
+    BOOST_REQUIRE_EQUAL(s.running(), 2U);
+    BOOST_REQUIRE_EQUAL(s.waiters(), 2U);
+
+    // Node operations are admitted first, even when queued later.
+    p1.release();
+    BOOST_REQUIRE(queued_node_ops.available());
+    BOOST_REQUIRE(!queued_repair.available());
+    auto p3 = queued_node_ops.get0();
+
+    // Backing off keeps new ranges waiting, but doesn't stop those running.
+    s.adjust(true);
+    BOOST_REQUIRE_EQUAL(s.parallelism(), 1U);
+    p2.release();
+    BOOST_REQUIRE(!queued_repair.available());
+    BOOST_REQUIRE_EQUAL(s.running(), 1U);
+
+    // The parallelism grows back once the foreground workload isn't busy.
+    s.adjust(false);
+    BOOST_REQUIRE(queued_repair.available());
+    auto p4 = queued_repair.get0();
+    BOOST_REQUIRE_EQUAL(s.running(), 2U);
+    s.adjust(false);
+    BOOST_REQUIRE_EQUAL(s.parallelism(), 2U);
+
+    // It never drops below one range.
+    s.adjust(true);
+    s.adjust(true);
+    BOOST_REQUIRE_EQUAL(s.parallelism(), 1U);
+    BOOST_REQUIRE_EQUAL(s.get_stats().backoffs, 2U);
+    BOOST_REQUIRE_EQUAL(s.get_stats().admitted, 4U);
+    BOOST_REQUIRE_EQUAL(s.get_stats().queued, 2U);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_repair_scheduler_throttle) {
+    using namespace std::chrono_literals;
+    constexpr uint64_t MiB = 1024 * 1024;
+    repair_scheduler s(4);
+    auto now = repair_scheduler::clock_type::now();
+
+    // Unlimited until a rate is set.
+    BOOST_REQUIRE(s.consume(1024 * MiB, now) == 0s);
+
+    // A second worth of bytes is available after idling, the rest waits.
+    s.set_rate(MiB);
+    BOOST_REQUIRE(s.consume(MiB, now) == 0s);
+    BOOST_REQUIRE(s.consume(MiB / 2, now) == 500ms);
+    BOOST_REQUIRE(s.consume(0, now + 500ms) == 0s);
+
+    // Backing off lowers the rate along with the parallelism.
+    s.adjust(true);
+    BOOST_REQUIRE_EQUAL(s.effective_rate(), MiB / 2);
+    BOOST_REQUIRE(s.consume(MiB / 4, now + 500ms) == 500ms);
+    BOOST_REQUIRE_EQUAL(s.get_stats().throttled_bytes, MiB / 2 + MiB / 4);
+}
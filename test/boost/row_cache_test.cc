@@ -839,6 +839,86 @@ SEASTAR_TEST_CASE(test_random_partition_population) {
     });
 }
 
+SEASTAR_TEST_CASE(test_get_keys) {
+    return seastar::async([] {
+        auto s = make_schema();
+        auto mt = make_lw_shared<replica::memtable>(s);
+        cache_tracker tracker;
+        row_cache cache(s, snapshot_source_from_snapshot(mt->as_data_source()), tracker);
+
+        std::vector<dht::decorated_key> keys;
+        for (int i = 0; i < 100; i++) {
+            auto m = make_new_mutation(s);
+            keys.emplace_back(m.decorated_key());
+            cache.populate(m);
+        }
+        std::sort(keys.begin(), keys.end(), dht::decorated_key::less_comparator(s));
+
+        std::vector<dht::decorated_key> cached;
+        std::optional<dht::decorated_key> last;
+        for (;;) {
+            auto batch = cache.get_keys(last, 7);
+            BOOST_REQUIRE_LE(batch.size(), 7);
+            if (batch.empty()) {
+                break;
+            }
+            last = batch.back();
+            std::move(batch.begin(), batch.end(), std::back_inserter(cached));
+        }
+        BOOST_REQUIRE_EQUAL(cached.size(), keys.size());
+        for (size_t i = 0; i < keys.size(); ++i) {
+            BOOST_REQUIRE(cached[i].equal(*s, keys[i]));
+        }
+    });
+}
+
+SEASTAR_TEST_CASE(test_memory_quota) {
+    return seastar::async([] {
+        auto s = make_schema();
+        auto s_capped = schema_builder("ks", "capped")
+            .with_column("pk", bytes_type, column_kind::partition_key)
+            .with_column("v", bytes_type, column_kind::regular_column)
+            .set_caching_options(caching_options::from_map({{"memory_quota_in_mb", "1"}}))
+            .build();
+        auto mt = make_lw_shared<replica::memtable>(s);
+        auto mt_capped = make_lw_shared<replica::memtable>(s_capped);
+        cache_tracker tracker;
+        row_cache cache(s, snapshot_source_from_snapshot(mt->as_data_source()), tracker);
+        row_cache capped(s_capped, snapshot_source_from_snapshot(mt_capped->as_data_source()), tracker);
+        BOOST_REQUIRE_EQUAL(cache.memory_quota(), 0);
+        BOOST_REQUIRE_EQUAL(capped.memory_quota(), (1 << 20) / smp::count);
+
+        auto populate = [] (row_cache& c, schema_ptr s) {
+            for (int i = 0; i < 200; i++) {
+                mutation m(s, new_key(s));
+                m.set_clustered_cell(clustering_key::make_empty(), "v", data_value(bytes(bytes::initialized_later(), 16 * 1024)), next_timestamp++);
+                c.populate(m);
+            }
+        };
+        populate(cache, s);
+        populate(capped, s_capped);
+        BOOST_REQUIRE_EQUAL(cache.partition_count(), 200);
+        BOOST_REQUIRE_EQUAL(capped.partition_count(), 200);
+        BOOST_REQUIRE_GT(capped.estimated_memory_usage(), capped.memory_quota());
+
+        // The capped table is evicted from, even though its rows are the most recently used.
+        while (capped.partition_count() > 100) {
+            BOOST_REQUIRE(tracker.region().evict_some() == memory::reclaiming_result::reclaimed_something);
+        }
+        BOOST_REQUIRE_EQUAL(cache.partition_count(), 200);
+        BOOST_REQUIRE_GT(tracker.get_stats().quota_row_evictions, 0);
+
+        // Within its quota, it is evicted from in LRU order again.
+        tracker.set_memory_quota(capped, std::numeric_limits<uint64_t>::max());
+        auto quota_row_evictions = tracker.get_stats().quota_row_evictions;
+        while (cache.partition_count() > 199) {
+            BOOST_REQUIRE(tracker.region().evict_some() == memory::reclaiming_result::reclaimed_something);
+        }
+        BOOST_REQUIRE_EQUAL(capped.partition_count(), 100);
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().quota_row_evictions, quota_row_evictions);
+    });
+}
+
 SEASTAR_TEST_CASE(test_eviction) {
     return seastar::async([] {
         auto s = make_schema();
@@ -1041,6 +1121,165 @@ SEASTAR_TEST_CASE(test_single_partition_update) {
     });
 }
 
+SEASTAR_TEST_CASE(test_packed_rows) {
+    return seastar::async([] {
+        auto s = schema_builder("ks", "cf")
+            .with_column("pk", int32_type, column_kind::partition_key)
+            .with_column("ck", int32_type, column_kind::clustering_key)
+            .with_column("v1", int32_type)
+            .with_column("v2", long_type)
+            .with_column("v3", utf8_type)
+            .build();
+        tests::reader_concurrency_semaphore_wrapper semaphore;
+        auto pk = partition_key::from_exploded(*s, { int32_type->decompose(0) });
+        auto range = dht::partition_range::make_singular(dht::decorate_key(*s, pk));
+        auto make_ck = [&s] (int v) {
+            return clustering_key_prefix::from_single_value(*s, int32_type->decompose(v));
+        };
+
+        mutation m(s, pk);
+        // Packable.
+        m.set_clustered_cell(make_ck(1), "v1", data_value(1), 1);
+        m.set_clustered_cell(make_ck(1), "v2", data_value(int64_t(1)), 1);
+        // Different timestamps.
+        m.set_clustered_cell(make_ck(2), "v1", data_value(2), 1);
+        m.set_clustered_cell(make_ck(2), "v2", data_value(int64_t(2)), 2);
+        // Variable-width column.
+        m.set_clustered_cell(make_ck(3), "v1", data_value(3), 1);
+        m.set_clustered_cell(make_ck(3), "v3", data_value("3"), 1);
+        // Packable, with a row marker.
+        m.partition().clustered_row(*s, make_ck(4)).apply(row_marker(1));
+        m.set_clustered_cell(make_ck(4), "v1", data_value(4), 1);
+        m.set_clustered_cell(make_ck(4), "v2", data_value(int64_t(4)), 1);
+
+        memtable_snapshot_source underlying(s);
+        underlying.apply(m);
+        cache_tracker tracker;
+        tracker.set_pack_rows(true);
+        row_cache cache(s, snapshot_source([&] { return underlying(); }), tracker);
+
+        assert_that(cache.make_reader(s, semaphore.make_permit(), range))
+            .produces(m)
+            .produces_end_of_stream();
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().rows_packed, 2);
+
+        // Reads from cache decode the packed rows.
+        assert_that(cache.make_reader(s, semaphore.make_permit(), range))
+            .produces(m)
+            .produces_end_of_stream();
+
+        // Writes merge into packed rows.
+        mutation m2(s, pk);
+        m2.set_clustered_cell(make_ck(1), "v1", data_value(10), 2);
+        m2.partition().apply_delete(*s, make_ck(4), tombstone(1, gc_clock::now()));
+        auto mt = make_lw_shared<replica::memtable>(s);
+        mt->apply(m2);
+        cache.update(row_cache::external_updater([&] {
+            underlying.apply(m2);
+        }), *mt).get();
+        m.apply(m2);
+
+        assert_that(cache.make_reader(s, semaphore.make_permit(), range))
+            .produces(m)
+            .produces_end_of_stream();
+    });
+}
+
+SEASTAR_TEST_CASE(test_admission_filter) {
+    return seastar::async([] {
+        auto s = make_schema();
+        auto m1 = make_new_mutation(s);
+        auto m2 = make_new_mutation(s);
+        memtable_snapshot_source underlying(s);
+        underlying.apply(m1);
+        underlying.apply(m2);
+        cache_tracker tracker;
+        tracker.set_admission_filter(true);
+        row_cache cache(s, snapshot_source([&] { return underlying(); }), tracker);
+
+        // Everything is admitted while the cache isn't evicting.
+        verify_has(cache, m1);
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().admissions, 1);
+        cache.evict();
+        BOOST_REQUIRE_GT(tracker.get_stats().row_evictions, 0);
+
+        // Now, partitions have to be read twice to be admitted.
+        verify_has(cache, m2);
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().admission_rejections, 1);
+        verify_has(cache, m2);
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().admissions, 2);
+        auto misses = tracker.get_stats().partition_misses;
+        verify_has(cache, m2);
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().partition_misses, misses);
+
+        // m1 was read already.
+        verify_has(cache, m1);
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().admissions, 3);
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().admission_rejections, 1);
+    });
+}
+
+SEASTAR_TEST_CASE(test_absent_partitions_are_remembered_after_eviction) {
+    return seastar::async([] {
+        auto s = make_schema();
+        auto m1 = make_new_mutation(s);
+        auto m2 = make_new_mutation(s);
+        memtable_snapshot_source underlying(s);
+        cache_tracker tracker;
+        tracker.set_absent_partitions_per_cache(16);
+        row_cache cache(s, snapshot_source([&] { return underlying(); }), tracker);
+
+        verify_does_not_have(cache, m1.decorated_key());
+        verify_does_not_have(cache, m2.decorated_key());
+        auto misses = tracker.get_stats().partition_misses;
+        cache.evict();
+        verify_does_not_have(cache, m1.decorated_key());
+        verify_does_not_have(cache, m2.decorated_key());
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().partition_misses, misses);
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().absent_partition_hits, 2);
+
+        // Writes make the keys unknown again.
+        auto mt = make_lw_shared<replica::memtable>(s);
+        mt->apply(m1);
+        cache.update(row_cache::external_updater([&] { underlying.apply(m1); }), *mt).get();
+        cache.evict();
+        verify_has(cache, m1);
+
+        cache.invalidate(row_cache::external_updater([&] { underlying.apply(m2); }), m2.decorated_key()).get();
+        verify_has(cache, m2);
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().absent_partition_hits, 2);
+    });
+}
+
+SEASTAR_TEST_CASE(test_miss_cost_is_attributed_to_the_table) {
+    return seastar::async([] {
+        auto s = make_schema();
+        auto m = make_new_mutation(s);
+        tests::reader_concurrency_semaphore_wrapper semaphore;
+        cache_tracker tracker;
+        // Pretends to read 100 bytes from one sstable.
+        auto src = mutation_source([m] (schema_ptr s, reader_permit permit, const dht::partition_range&, const query::partition_slice&, const io_priority_class&, tracing::trace_state_ptr, streamed_mutation::forwarding fwd) {
+            permit.on_start_sstable_read();
+            permit.on_sstable_bytes_read(100);
+            permit.on_finish_sstable_read();
+            return make_flat_mutation_reader_from_mutations_v2(s, std::move(permit), {m}, std::move(fwd));
+        });
+        row_cache cache(s, snapshot_source_from_snapshot(src), tracker);
+
+        verify_has(cache, m);
+        verify_has(cache, m);
+        assert_that(cache.make_reader(s, semaphore.make_permit())).produces(m).produces_end_of_stream();
+
+        auto& stats = cache.stats();
+        BOOST_REQUIRE_EQUAL(stats.single_partition_reads_with_misses, 1);
+        BOOST_REQUIRE_EQUAL(stats.range_reads_with_misses, 1);
+        BOOST_REQUIRE_EQUAL(stats.miss_sstables_read, 2);
+        BOOST_REQUIRE_EQUAL(stats.miss_bytes_read, 200);
+        BOOST_REQUIRE_EQUAL(stats.miss_index_pages_read, 0);
+        BOOST_REQUIRE_EQUAL(stats.miss_bytes_read_histogram.count(), 2);
+    });
+}
+
 SEASTAR_TEST_CASE(test_update) {
     return seastar::async([] {
         auto s = make_schema();
@@ -4327,6 +4566,98 @@ SEASTAR_TEST_CASE(test_eviction_of_upper_bound_of_population_range) {
     });
 }
 
+// When rows are inserted into or evicted from the cache while a reader fills a
+// gap from underlying, the reader closes the range it read with a dummy entry
+// and marks it continuous, see read_from_underlying(). Checks that the reader,
+// and later reads relying on that continuity, return what underlying has.
+SEASTAR_TEST_CASE(test_concurrent_cache_changes_while_populating_gap) {
+    return seastar::async([] {
+        simple_schema s;
+        tests::reader_concurrency_semaphore_wrapper semaphore;
+        memtable_snapshot_source underlying(s.schema());
+
+        auto pkey = s.make_pkey("pk");
+        auto pr = dht::partition_range::make_singular(pkey);
+
+        mutation m1(s.schema(), pkey);
+        for (int i = 0; i < 6; ++i) {
+            s.add_row(m1, s.make_ckey(i), "v1");
+        }
+        underlying.apply(m1);
+
+        cache_tracker tracker;
+        throttle thr(true);
+        auto cache_source = make_decorated_snapshot_source(snapshot_source([&] { return underlying(); }),
+                                                           [&] (mutation_source src) {
+            return throttled_mutation_source(thr, std::move(src));
+        });
+        row_cache cache(s.schema(), cache_source, tracker);
+
+        auto check_read = [&] (mutation_source expected, int start, int end) {
+            auto slice = partition_slice_builder(*s.schema())
+                    .with_range(query::clustering_range::make(s.make_ckey(start), s.make_ckey(end)))
+                    .build();
+            auto rd = cache.make_reader(s.schema(), semaphore.make_permit(), pr, slice);
+            auto close_rd = deferred_close(rd);
+            auto m_cache = read_mutation_from_flat_mutation_reader(rd).get0();
+            close_rd.close_now();
+            auto expected_rd = expected.make_reader_v2(s.schema(), semaphore.make_permit(), pr, slice);
+            auto close_expected_rd = deferred_close(expected_rd);
+            auto m_expected = read_mutation_from_flat_mutation_reader(expected_rd).get0();
+            BOOST_REQUIRE(m_expected);
+            assert_that(m_cache).has_mutation().is_equal_to(*m_expected);
+        };
+
+        // Rows inserted into the gap, and a memtable flush, while it is read.
+        {
+            populate_range(cache, pr, s.make_ckey_range(4, 4));
+            auto before = underlying();
+
+            auto arrived = thr.block();
+            auto f = seastar::async([&] {
+                check_read(before, 0, 5);
+            });
+            arrived.get();
+
+            populate_range(cache, pr, s.make_ckey_range(1, 2));
+            mutation m2(s.schema(), pkey);
+            s.add_row(m2, s.make_ckey(2), "v2");
+            s.add_row(m2, s.make_ckey(3), "v2");
+            s.add_row(m2, s.make_ckey(6), "v2");
+            apply(cache, underlying, m2);
+
+            thr.unblock();
+            f.get();
+
+            check_read(underlying(), 0, 6);
+            check_read(underlying(), 1, 4);
+        }
+
+        // Rows, including the one bounding the gap, evicted while it is read.
+        {
+            cache.evict();
+            populate_range(cache, pr, s.make_ckey_range(4, 4));
+            auto before = underlying();
+
+            auto arrived = thr.block();
+            auto f = seastar::async([&] {
+                check_read(before, 0, 6);
+            });
+            arrived.get();
+
+            populate_range(cache, pr, s.make_ckey_range(5, 6));
+            evict_one_row(tracker);
+            evict_one_row(tracker);
+
+            thr.unblock();
+            f.get();
+
+            check_read(underlying(), 0, 6);
+            check_read(underlying(), 2, 5);
+        }
+    });
+}
+
 // Checks that merging rows from different partition versions preserves the LRU link of the entry
 // from the newer version. We need this in case we're merging two last dummy entries where the older
 // dummy is already unlinked from the LRU. We need to preserve the fact that the last dummy in the
@@ -109,6 +109,49 @@ SEASTAR_THREAD_TEST_CASE(test_client_multipart_upload) {
     cln->close().get();
 }
 
+SEASTAR_THREAD_TEST_CASE(test_client_download_source) {
+    const ipv4_addr s3_server(tests::getenv_safe("S3_SERVER_ADDRESS_FOR_TEST"), 9000);
+    const sstring name(fmt::format("/{}/testdownloadobject-{}", tests::getenv_safe("S3_PUBLIC_BUCKET_FOR_TEST"), ::getpid()));
+
+    testlog.info("Make client\n");
+    auto cln = s3::client::make(s3_server);
+
+    testlog.info("Upload object\n");
+    auto out = output_stream<char>(cln->make_upload_sink(name, s3::upload_options{ .part_size = 6 << 20, .concurrency = 8 }));
+    auto close = seastar::deferred_close(out);
+
+    static constexpr unsigned chunk_size = 1000;
+    auto rnd = tests::random::get_bytes(chunk_size);
+    uint64_t object_size = 0;
+    for (unsigned ch = 0; ch < 20 * 1024; ch++) {
+        out.write(reinterpret_cast<char*>(rnd.begin()), rnd.size()).get();
+        object_size += rnd.size();
+    }
+    out.flush().get();
+    close.close_now();
+
+    testlog.info("Download object\n");
+    // The parts don't align with the chunks, so that each chunk is checked across part boundaries.
+    auto in = input_stream<char>(cln->make_download_source(name, s3::download_options{ .part_size = 100 * 1024 + 7, .readahead = 5 }));
+    auto close_in = seastar::deferred_close(in);
+    uint64_t read_size = 0;
+    while (true) {
+        auto buf = in.read_exactly(chunk_size).get0();
+        if (buf.empty()) {
+            break;
+        }
+        BOOST_REQUIRE_EQUAL(buf.size(), chunk_size);
+        BOOST_REQUIRE_EQUAL(memcmp(rnd.begin(), buf.get(), chunk_size), 0);
+        read_size += buf.size();
+    }
+    BOOST_REQUIRE_EQUAL(read_size, object_size);
+
+    testlog.info("Delete object\n");
+    cln->delete_object(name).get();
+
+    cln->close().get();
+}
+
 SEASTAR_THREAD_TEST_CASE(test_client_readable_file) {
     const ipv4_addr s3_server(tests::getenv_safe("S3_SERVER_ADDRESS_FOR_TEST"), 9000);
     const sstring name(fmt::format("/{}/testroobject-{}", tests::getenv_safe("S3_PUBLIC_BUCKET_FOR_TEST"), ::getpid()));
@@ -9,6 +9,7 @@
 #include "test/lib/scylla_test_case.hh"
 #include "test/lib/cql_test_env.hh"
 #include "test/lib/cql_assertions.hh"
+#include "db/config.hh"
 #include "transport/messages/result_message.hh"
 #include "service/pager/paging_state.hh"
 #include "types/map.hh"
@@ -396,6 +397,41 @@ SEASTAR_TEST_CASE(test_index_with_partition_key) {
     });
 }
 
+// Rows of the same base partition returned by the index are read by a single
+// base query, and several base partitions are read at once.
+SEASTAR_TEST_CASE(test_index_with_many_rows_per_base_partition) {
+    auto cfg = make_shared<db::config>();
+    cfg->secondary_index_base_query_concurrency(8);
+    return do_with_cql_env_thread([] (auto& e) {
+        e.execute_cql("CREATE TABLE tab (pk int, ck int, v int, PRIMARY KEY (pk, ck))").get();
+        e.execute_cql("CREATE INDEX ON tab (v)").get();
+        for (int pk = 0; pk < 20; ++pk) {
+            for (int ck = 0; ck < 10; ++ck) {
+                e.execute_cql(format("INSERT INTO tab (pk, ck, v) VALUES ({}, {}, {})", pk, ck, ck % 2)).get();
+            }
+        }
+
+        eventually([&] {
+            auto res = e.execute_cql("SELECT * FROM tab WHERE v = 1").get0();
+            assert_that(res).is_rows().with_size(100);
+        });
+
+        eventually([&] {
+            auto res = e.execute_cql("SELECT ck FROM tab WHERE pk = 3 AND v = 0").get0();
+            assert_that(res).is_rows().with_rows({
+                {int32_type->decompose(0)}, {int32_type->decompose(2)}, {int32_type->decompose(4)}, {int32_type->decompose(6)}, {int32_type->decompose(8)},
+            });
+        });
+
+        eventually([&] {
+            auto qo = std::make_unique<cql3::query_options>(db::consistency_level::LOCAL_ONE, std::vector<cql3::raw_value>{},
+                    cql3::query_options::specific_options{7, nullptr, {}, api::new_timestamp()});
+            auto res = e.execute_cql("SELECT * FROM tab WHERE v = 1", std::move(qo)).get0();
+            assert_that(res).is_rows().with_size(7);
+        });
+    }, cfg);
+}
+
 SEASTAR_TEST_CASE(test_index_on_pk_ck_with_paging) {
     return do_with_cql_env_thread([] (auto& e) {
         e.execute_cql("CREATE TABLE tab (pk int, pk2 int, ck text, ck2 text, v int, v2 int, v3 text, PRIMARY KEY ((pk, pk2), ck, ck2))").get();
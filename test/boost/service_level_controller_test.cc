@@ -18,6 +18,7 @@
 #include <algorithm>
 #include "service/qos/service_level_controller.hh"
 #include "service/qos/qos_configuration_change_subscriber.hh"
+#include "service/qos/latency_slo_guard.hh"
 #include "auth/service.hh"
 #include "utils/overloaded_functor.hh"
 
@@ -111,3 +112,38 @@ SEASTAR_THREAD_TEST_CASE(subscriber_simple) {
     BOOST_REQUIRE_EQUAL(ccss.ops, expected_result);
     sl_controller.stop().get();
 }
+
+SEASTAR_THREAD_TEST_CASE(latency_slo_guard_sheds_batch_requests) {
+    using namespace std::chrono_literals;
+    utils::updateable_value_source<uint32_t> target_ms(0);
+    latency_slo_guard guard{utils::updateable_value<uint32_t>(target_ms)};
+    auto now = latency_slo_guard::clock::now();
+    auto run_window = [&] (std::chrono::milliseconds latency) {
+        for (uint64_t i = 0; i < latency_slo_guard::min_window_requests; ++i) {
+            guard.record_interactive_request(latency, now);
+        }
+        now += latency_slo_guard::window_duration;
+    };
+
+    // Disabled.
+    run_window(100ms);
+    BOOST_REQUIRE(!guard.shed_batch_request(now));
+
+    target_ms.set(10);
+    run_window(100ms);
+    BOOST_REQUIRE(guard.shed_batch_request(now));
+    BOOST_REQUIRE_EQUAL(guard.get_stats().batch_requests_shed, 1);
+
+    // Still shedding until the p99 drops well below the target.
+    run_window(9ms);
+    BOOST_REQUIRE(guard.shed_batch_request(now));
+    run_window(2ms);
+    BOOST_REQUIRE(!guard.shed_batch_request(now));
+
+    // A window with too few interactive requests stops shedding.
+    run_window(100ms);
+    BOOST_REQUIRE(guard.shed_batch_request(now));
+    now += latency_slo_guard::window_duration;
+    BOOST_REQUIRE(!guard.shed_batch_request(now));
+    BOOST_REQUIRE_EQUAL(guard.get_stats().batch_requests_shed, 3);
+}
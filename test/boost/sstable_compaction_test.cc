@@ -40,6 +40,7 @@
 #include "compaction/date_tiered_compaction_strategy.hh"
 #include "compaction/time_window_compaction_strategy.hh"
 #include "compaction/leveled_compaction_strategy.hh"
+#include "compaction/incremental_compaction_strategy.hh"
 #include "test/lib/mutation_assertions.hh"
 #include "counters.hh"
 #include "cell_locking.hh"
@@ -66,6 +67,7 @@
 #include <boost/icl/interval_map.hpp>
 #include "test/lib/test_services.hh"
 #include "test/lib/cql_test_env.hh"
+#include "test/lib/cql_assertions.hh"
 #include "test/lib/reader_concurrency_semaphore.hh"
 #include "test/lib/sstable_utils.hh"
 #include "test/lib/random_utils.hh"
@@ -188,6 +190,11 @@ SEASTAR_TEST_CASE(compaction_manager_basic_test) {
     }
     BOOST_REQUIRE(cm.get_stats().completed_tasks == 1);
     BOOST_REQUIRE(cm.get_stats().errors == 0);
+    auto ks_stats = cm.get_keyspace_stats(some_keyspace);
+    BOOST_REQUIRE(ks_stats);
+    BOOST_REQUIRE_EQUAL(ks_stats->active_tasks, 0);
+    BOOST_REQUIRE_EQUAL(ks_stats->completed_tasks, 1);
+    BOOST_REQUIRE_GT(ks_stats->compacted_bytes, 0);
 
     // expect sstables of cf to be compacted.
     BOOST_REQUIRE(cf->sstables_count() == 1);
@@ -1491,6 +1498,67 @@ SEASTAR_TEST_CASE(time_window_strategy_ts_resolution_check) {
   });
 }
 
+SEASTAR_TEST_CASE(time_window_strategy_cold_storage_age_option) {
+    using opts_t = std::map<sstring, sstring>;
+    constexpr auto key = time_window_compaction_strategy_options::COLD_STORAGE_AGE_SECONDS_KEY;
+
+    BOOST_REQUIRE(!time_window_compaction_strategy_options(opts_t{}).get_cold_storage_age());
+    BOOST_REQUIRE(time_window_compaction_strategy_options(opts_t{{key, "86400"}}).get_cold_storage_age() == std::chrono::seconds(86400));
+    BOOST_REQUIRE(time_window_compaction_strategy_options(opts_t{{key, "0"}}).get_cold_storage_age() == std::chrono::seconds(0));
+    BOOST_REQUIRE_THROW(time_window_compaction_strategy_options(opts_t{{key, "-1"}}), exceptions::configuration_exception);
+    BOOST_REQUIRE_THROW(time_window_compaction_strategy_options(opts_t{{key, "a day"}}), exceptions::syntax_exception);
+
+    return make_ready_future<>();
+}
+
+SEASTAR_TEST_CASE(time_window_strategy_moves_cold_windows_to_cold_storage) {
+  return test_env::do_with_async([] (test_env& env) {
+    using namespace std::chrono;
+
+    auto builder = schema_builder("tests", "time_window_cold_storage")
+            .with_column("id", utf8_type, column_kind::partition_key)
+            .with_column("value", int32_type);
+    builder.set_compaction_strategy(sstables::compaction_strategy_type::time_window);
+    builder.set_compaction_strategy_options({
+        { time_window_compaction_strategy_options::COMPACTION_WINDOW_UNIT_KEY, "HOURS" },
+        { time_window_compaction_strategy_options::COMPACTION_WINDOW_SIZE_KEY, "1" },
+        { time_window_compaction_strategy_options::COLD_STORAGE_AGE_SECONDS_KEY, "86400" },
+    });
+    auto s = builder.build();
+    auto cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::time_window, s->compaction_strategy_options());
+    auto strategy_c = make_strategy_control_for_test(false);
+    const auto key = tests::generate_partition_key(s);
+
+    auto make_sstable = [&] (table_for_tests& cf, hours age) {
+        auto ts = api::new_timestamp() - duration_cast<microseconds>(age).count();
+        auto sst = cf.make_sstable();
+        sstables::test(sst).set_values(key.key(), key.key(), build_stats(ts, ts, std::numeric_limits<int32_t>::max()));
+        return sst;
+    };
+
+    auto cf = table_for_tests(env.manager(), s, env.tempdir().path().native(), make_lw_shared<const replica::storage_options>());
+    auto stop_cf = deferred_stop(cf);
+    BOOST_REQUIRE(cf.as_table_state().has_cold_storage());
+
+    // A window which ended more than cold_storage_age ago is moved to cold storage...
+    auto desc = cs.get_sstables_for_compaction(cf.as_table_state(), *strategy_c, { make_sstable(cf, hours(48)) });
+    BOOST_REQUIRE_EQUAL(desc.sstables.size(), 1);
+    BOOST_REQUIRE(desc.to_cold_storage == sstables::to_cold_storage::yes);
+
+    // ...newer ones aren't.
+    desc = cs.get_sstables_for_compaction(cf.as_table_state(), *strategy_c, { make_sstable(cf, hours(2)) });
+    BOOST_REQUIRE(desc.sstables.empty());
+    BOOST_REQUIRE(desc.to_cold_storage == sstables::to_cold_storage::no);
+
+    // Nor is any window of a table without cold storage.
+    auto local_cf = env.make_table_for_tests(s);
+    auto stop_local_cf = deferred_stop(local_cf);
+    BOOST_REQUIRE(!local_cf.as_table_state().has_cold_storage());
+    desc = cs.get_sstables_for_compaction(local_cf.as_table_state(), *strategy_c, { make_sstable(local_cf, hours(48)) });
+    BOOST_REQUIRE(desc.to_cold_storage == sstables::to_cold_storage::no);
+  });
+}
+
 SEASTAR_TEST_CASE(time_window_strategy_correctness_test) {
     using namespace std::chrono;
 
@@ -1750,6 +1818,112 @@ SEASTAR_TEST_CASE(size_tiered_beyond_max_threshold_test) {
   });
 }
 
+SEASTAR_TEST_CASE(incremental_compaction_strategy_picks_whole_runs_test) {
+  return test_env::do_with_async([] (test_env& env) {
+    auto cf = env.make_table_for_tests();
+    auto stop_cf = deferred_stop(cf);
+    auto s = cf.schema();
+    auto cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::incremental, s->compaction_strategy_options());
+    const auto keys = tests::generate_partition_keys(4, s);
+    size_t min_threshold = s->min_compaction_threshold();
+
+    std::vector<sstables::shared_sstable> candidates;
+    auto add_run = [&] (size_t fragments, uint64_t fragment_size) {
+        auto run_id = sstables::run_id::create_random_id();
+        for (size_t i = 0; i < fragments; i++) {
+            auto sst = cf.make_sstable();
+            sstables::test(sst).set_values(keys[2 * i].key(), keys[2 * i + 1].key(), stats_metadata{}, fragment_size);
+            sstables::test(sst).set_run_identifier(run_id);
+            candidates.push_back(std::move(sst));
+        }
+    };
+    // min_threshold runs of two fragments in the same tier, and a much bigger run of a single fragment.
+    for (size_t i = 0; i < min_threshold; i++) {
+        add_run(2, 1000);
+    }
+    add_run(1, 1000000);
+
+    BOOST_REQUIRE_EQUAL(sstables::incremental_compaction_strategy::get_runs(candidates).size(), min_threshold + 1);
+
+    auto strategy_c = make_strategy_control_for_test(false);
+    auto desc = cs.get_sstables_for_compaction(cf.as_table_state(), *strategy_c, candidates);
+    BOOST_REQUIRE_EQUAL(desc.sstables.size(), min_threshold * 2);
+    BOOST_REQUIRE(std::ranges::none_of(desc.sstables, [] (const sstables::shared_sstable& sst) { return sst->data_size() == 1000000; }));
+    // The output is written as a run of fragments, so the input fragments can be released as compaction goes.
+    BOOST_REQUIRE_EQUAL(desc.max_sstable_bytes, uint64_t(1000) * 1024 * 1024);
+  });
+}
+
+SEASTAR_THREAD_TEST_CASE(major_compaction_parallelism_test) {
+    cql_test_config test_cfg;
+    const uint32_t parallelism = 4;
+    test_cfg.db_config->major_compaction_parallelism(parallelism);
+
+    do_with_cql_env_thread([parallelism] (cql_test_env& e) {
+        e.execute_cql("create table ks.tbl (pk int primary key, v int)").get();
+        const int partitions = 200;
+        // Each flush overwrites all partitions, so the sstables overlap.
+        for (int v = 0; v < 3; v++) {
+            for (int pk = 0; pk < partitions; pk++) {
+                e.execute_cql(format("insert into ks.tbl (pk, v) values ({}, {})", pk, v)).get();
+            }
+            e.db().invoke_on_all(&replica::database::flush_all_memtables).get();
+        }
+
+        e.db().invoke_on_all([] (replica::database& db) {
+            return db.find_column_family("ks", "tbl").compact_all_sstables();
+        }).get();
+
+        // Each sub-range is compacted into sstables of its own, which don't overlap with the other ones.
+        auto& t = e.local_db().find_column_family("ks", "tbl");
+        const auto& s = *t.schema();
+        auto sstables = boost::copy_range<std::vector<sstables::shared_sstable>>(*t.get_sstables());
+        BOOST_REQUIRE_LE(sstables.size(), parallelism);
+        std::sort(sstables.begin(), sstables.end(), [&s] (const sstables::shared_sstable& a, const sstables::shared_sstable& b) {
+            return a->get_first_decorated_key().less_compare(s, b->get_first_decorated_key());
+        });
+        for (size_t i = 1; i < sstables.size(); i++) {
+            BOOST_REQUIRE(sstables[i - 1]->get_last_decorated_key().less_compare(s, sstables[i]->get_first_decorated_key()));
+        }
+
+        auto msg = e.execute_cql("select pk, v from ks.tbl").get0();
+        std::vector<std::vector<bytes_opt>> expected;
+        for (int pk = 0; pk < partitions; pk++) {
+            expected.push_back({int32_type->decompose(pk), int32_type->decompose(2)});
+        }
+        assert_that(msg).is_rows().with_rows_ignore_order(std::move(expected));
+    }, test_cfg).get();
+}
+
+// Late writes to past windows share memtables with the current ones. They must be
+// flushed to sstables of their own window, or TWCS would have to compact across windows.
+SEASTAR_THREAD_TEST_CASE(twcs_memtable_flush_segregates_windows_test) {
+    do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("create table ks.tbl (pk int, ck int, v int, primary key (pk, ck)) with compaction = "
+                "{'class': 'TimeWindowCompactionStrategy', 'compaction_window_unit': 'HOURS', 'compaction_window_size': 1}").get();
+        const int64_t window = 3600 * 1000000L;
+        const int64_t now = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        const int windows = 3;
+        for (int w = 0; w < windows; w++) {
+            e.execute_cql(format("insert into ks.tbl (pk, ck, v) values (0, {}, 0) using timestamp {}", w, now - w * window)).get();
+        }
+        e.db().invoke_on_all(&replica::database::flush_all_memtables).get();
+
+        auto count_sstables = [&] (std::function<bool(const sstables::stats_metadata&)> pred) {
+            return e.db().map_reduce0([pred] (replica::database& db) {
+                auto all = db.find_column_family("ks", "tbl").get_sstables();
+                return size_t(std::ranges::count_if(*all, [&] (const sstables::shared_sstable& sst) {
+                    return pred(sst->get_stats_metadata());
+                }));
+            }, size_t(0), std::plus<size_t>()).get0();
+        };
+        BOOST_REQUIRE_EQUAL(count_sstables([] (const sstables::stats_metadata&) { return true; }), windows);
+        BOOST_REQUIRE_EQUAL(count_sstables([window] (const sstables::stats_metadata& stats) {
+            return stats.min_timestamp / window != stats.max_timestamp / window;
+        }), 0);
+    }).get();
+}
+
 SEASTAR_TEST_CASE(sstable_expired_data_ratio) {
     return test_env::do_with_async([] (test_env& env) {
         auto make_schema = [&] (sstables::compaction_strategy_type cst) {
@@ -1862,6 +2036,136 @@ SEASTAR_TEST_CASE(sstable_expired_data_ratio) {
     });
 }
 
+SEASTAR_TEST_CASE(tombstone_read_compaction_test) {
+  return test_env::do_with_async([] (test_env& env) {
+    auto cf = env.make_table_for_tests();
+    auto stop_cf = deferred_stop(cf);
+    auto s = cf.schema();
+    auto cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::size_tiered, s->compaction_strategy_options());
+    auto strategy_c = make_strategy_control_for_test(false);
+    const auto keys = tests::generate_partition_keys(1, s);
+
+    // Sizes far apart and above min_sstable_size, so that no sstables are in the same tier.
+    std::vector<sstables::shared_sstable> candidates;
+    for (uint64_t size : {uint64_t(100) << 20, uint64_t(10) << 30, uint64_t(1) << 40, uint64_t(100) << 40}) {
+        auto sst = cf.make_sstable();
+        sstables::test(sst).set_values(keys[0].key(), keys[0].key(), stats_metadata{}, size);
+        sstables::test(sst).set_data_file_write_time(db_clock::time_point::min());
+        candidates.push_back(std::move(sst));
+    }
+    BOOST_REQUIRE(cs.get_sstables_for_compaction(cf.as_table_state(), *strategy_c, candidates).sstables.empty());
+
+    // A single sstable without droppable tombstones isn't worth compacting.
+    candidates[1]->add_tombstones_read(1000);
+    BOOST_REQUIRE(cs.get_sstables_for_compaction(cf.as_table_state(), *strategy_c, candidates).sstables.empty());
+
+    // Sstables holding the same partition are compacted together, so that the tombstones are merged with the data they shadow.
+    candidates[3]->add_tombstones_read(2000);
+    auto desc = cs.get_sstables_for_compaction(cf.as_table_state(), *strategy_c, candidates);
+    BOOST_REQUIRE_EQUAL(desc.sstables.size(), 2);
+    BOOST_REQUIRE(desc.sstables[0] == candidates[3]);
+    BOOST_REQUIRE(desc.sstables[1] == candidates[1]);
+
+    // Recently written sstables are left alone, as their tombstones may not be droppable yet.
+    sstables::test(candidates[3]).set_data_file_write_time(db_clock::now());
+    BOOST_REQUIRE(cs.get_sstables_for_compaction(cf.as_table_state(), *strategy_c, candidates).sstables.empty());
+  });
+}
+
+SEASTAR_TEST_CASE(compaction_copies_through_untouched_sstables_test) {
+    return test_env::do_with_async([] (test_env& env) {
+        auto builder = schema_builder("tests", "copy_through")
+                .with_column("id", utf8_type, column_kind::partition_key)
+                .with_column("value", int32_type);
+        builder.set_compaction_strategy(sstables::compaction_strategy_type::leveled);
+        auto s = builder.build();
+        auto sst_gen = env.make_sst_factory(s);
+        auto cf = env.make_table_for_tests(s);
+        auto close_cf = deferred_stop(cf);
+
+        auto make_insert = [&] (const dht::decorated_key& key, api::timestamp_type ts) {
+            mutation m(s, key);
+            m.set_clustered_cell(clustering_key::make_empty(), bytes("value"), data_value(int32_t(ts)), ts);
+            return m;
+        };
+        const auto keys = tests::generate_partition_keys(3, s);
+        auto mut1 = make_insert(keys[0], 1);
+        auto mut2 = make_insert(keys[1], 1);
+        auto mut2_update = make_insert(keys[1], 2);
+        auto mut3 = make_insert(keys[2], 1);
+
+        auto overlapping1 = make_sstable_containing(sst_gen, {mut1, mut2});
+        auto overlapping2 = make_sstable_containing(sst_gen, {mut2_update});
+        auto untouched = make_sstable_containing(sst_gen, {mut3});
+
+        auto desc = sstables::compaction_descriptor({overlapping1, overlapping2, untouched}, default_priority_class(), 1, 1024 * 1024 * 1024);
+        auto result = compact_sstables(std::move(desc), cf, sst_gen).get0().new_sstables;
+        BOOST_REQUIRE_EQUAL(result.size(), 2);
+
+        // The sstable which overlaps no other one is linked to the output, at the new level.
+        auto copy = boost::find_if(result, [&] (const shared_sstable& sst) {
+            return same_file(sst->get_filename(), untouched->get_filename()).get0();
+        });
+        BOOST_REQUIRE(copy != result.end());
+        BOOST_REQUIRE_EQUAL((*copy)->get_sstable_level(), 1);
+        BOOST_REQUIRE((*copy)->generation() != untouched->generation());
+        assert_that(sstable_reader(*copy, s, env.make_reader_permit()))
+                .produces(mut3)
+                .produces_end_of_stream();
+
+        // The others are merged.
+        auto merged = *copy == result[0] ? result[1] : result[0];
+        BOOST_REQUIRE_EQUAL(merged->get_sstable_level(), 1);
+        assert_that(sstable_reader(merged, s, env.make_reader_permit()))
+                .produces(mut1)
+                .produces(mut2_update)
+                .produces_end_of_stream();
+    });
+}
+
+SEASTAR_TEST_CASE(reshape_concatenates_disjoint_sstables_test) {
+    return test_env::do_with_async([] (test_env& env) {
+        auto builder = schema_builder("tests", "reshape_concat")
+                .with_column("id", utf8_type, column_kind::partition_key)
+                .with_column("value", int32_type);
+        auto s = builder.build();
+        auto sst_gen = env.make_sst_factory(s);
+        auto cf = env.make_table_for_tests(s);
+        auto close_cf = deferred_stop(cf);
+
+        auto make_insert = [&] (const dht::decorated_key& key, api::timestamp_type ts) {
+            mutation m(s, key);
+            m.set_clustered_cell(clustering_key::make_empty(), bytes("value"), data_value(int32_t(ts)), ts);
+            return m;
+        };
+        const auto keys = tests::generate_partition_keys(6, s);
+        std::vector<mutation> muts;
+        std::vector<shared_sstable> ssts;
+        // Like streamed sstables, each of the first ones covers a range of its own,
+        // and the last one overlaps with two of them.
+        for (size_t i = 0; i < keys.size(); i += 2) {
+            muts.push_back(make_insert(keys[i], 1));
+            muts.push_back(make_insert(keys[i + 1], 1));
+            ssts.push_back(make_sstable_containing(sst_gen, {muts[i], muts[i + 1]}));
+        }
+        auto update1 = make_insert(keys[1], 2);
+        auto update2 = make_insert(keys[2], 2);
+        ssts.push_back(make_sstable_containing(sst_gen, {update1, update2}));
+        muts[1] = update1;
+        muts[2] = update2;
+
+        auto desc = sstables::compaction_descriptor(std::move(ssts), default_priority_class(), 0, sstables::compaction_descriptor::default_max_sstable_bytes,
+                sstables::run_id::create_random_id(), sstables::compaction_type_options::make_reshape());
+        auto result = compact_sstables(std::move(desc), cf, sst_gen).get0().new_sstables;
+        BOOST_REQUIRE_EQUAL(result.size(), 1);
+        auto assertion = assert_that(sstable_reader(result.front(), s, env.make_reader_permit()));
+        for (auto& m : muts) {
+            assertion.produces(m);
+        }
+        assertion.produces_end_of_stream();
+    });
+}
+
 SEASTAR_TEST_CASE(compaction_correctness_with_partitioned_sstable_set) {
     return test_env::do_with_async([] (test_env& env) {
         auto builder = schema_builder("tests", "tombstone_purge")
@@ -4145,6 +4449,59 @@ SEASTAR_TEST_CASE(test_twcs_single_key_reader_filtering) {
     });
 }
 
+SEASTAR_TEST_CASE(test_single_key_reader_opens_sstables_lazily) {
+    return test_env::do_with_async([] (test_env& env) {
+        auto s = schema_builder("tests", "single_key_reader_opens_sstables_lazily")
+                .with_column("pk", int32_type, column_kind::partition_key)
+                .with_column("ck", int32_type, column_kind::clustering_key)
+                .with_column("v", int32_type)
+                .build();
+
+        auto sst_gen = env.make_sst_factory(s);
+        auto pk = partition_key::from_single_value(*s, int32_type->decompose(0));
+
+        // Each sstable holds the next 10 rows of the partition.
+        const int nr_sstables = 4;
+        auto cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::size_tiered, {});
+        auto set = cs.make_sstable_set(s);
+        for (int i = 0; i < nr_sstables; ++i) {
+            mutation m(s, pk);
+            for (int ck = i * 10; ck < i * 10 + 10; ++ck) {
+                m.set_clustered_cell(clustering_key::from_single_value(*s, int32_type->decompose(ck)), to_bytes("v"), int32_t(ck), api::new_timestamp());
+            }
+            set.insert(make_sstable_containing(sst_gen, {std::move(m)}));
+        }
+
+        auto cf = env.make_table_for_tests(s);
+        auto close_cf = deferred_stop(cf);
+        cf->start();
+
+        reader_permit permit = env.make_reader_permit();
+        utils::estimated_histogram eh;
+        auto pr = dht::partition_range::make_singular(dht::decorate_key(*s, pk));
+
+        auto reader = set.create_single_key_sstable_reader(
+                &*cf, s, permit, eh, pr, s->full_slice(), default_priority_class(),
+                tracing::trace_state_ptr(), ::streamed_mutation::forwarding::no,
+                ::mutation_reader::forwarding::no);
+        auto close_reader = deferred_close(reader);
+        reader.set_max_buffer_size(1);
+
+        auto& stats = env.semaphore().get_stats();
+
+        // Reading the first row needs only the first sstable.
+        BOOST_REQUIRE(reader().get()->is_partition_start());
+        BOOST_REQUIRE(reader().get()->is_clustering_row());
+        BOOST_REQUIRE_EQUAL(stats.sstables_read, 1);
+
+        int rows = 1;
+        while (auto mf = reader().get()) {
+            rows += mf->is_clustering_row();
+        }
+        BOOST_REQUIRE_EQUAL(rows, nr_sstables * 10);
+    });
+}
+
 SEASTAR_TEST_CASE(max_ongoing_compaction_test) {
     return test_env::do_with_async([] (test_env& env) {
         BOOST_REQUIRE(smp::count == 1);
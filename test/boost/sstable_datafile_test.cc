@@ -13,6 +13,9 @@
 #include <seastar/util/closeable.hh>
 
 #include "sstables/sstables.hh"
+#include "sstables/paged_filter.hh"
+#include "sstables/partition_trie.hh"
+#include "sstables/mx/row_index.hh"
 #include "sstables/key.hh"
 #include "sstables/compress.hh"
 #include "test/lib/scylla_test_case.hh"
@@ -306,6 +309,242 @@ static flat_mutation_reader_v2 sstable_reader_v2(shared_sstable sst, schema_ptr
     return sst->as_mutation_source().make_reader_v2(s, std::move(permit), pr, s->full_slice());
 }
 
+SEASTAR_TEST_CASE(test_zstd_dictionary_compression) {
+    return test_env::do_with_async([] (test_env& env) {
+        auto s = schema_builder("ks", "test_zstd_dictionary_compression")
+                .with_column("pk", int32_type, column_kind::partition_key)
+                .with_column("v", utf8_type)
+                .set_compressor_params(compression_parameters({
+                    {"sstable_compression", "org.apache.cassandra.io.compress.ZstdWithDictionaryCompressor"},
+                    {"dictionary_size_in_kb", "1"},
+                    {"chunk_length_in_kb", "1"}}))
+                .build();
+
+        std::vector<mutation> muts;
+        for (int i = 0; i < 2000; ++i) {
+            mutation m(s, partition_key::from_single_value(*s, int32_type->decompose(i)));
+            m.set_clustered_cell(clustering_key::make_empty(), "v", data_value(format("a small row sharing most of its contents with its siblings #{}", i)), api::new_timestamp());
+            muts.push_back(std::move(m));
+        }
+
+        // make_sstable_containing() validates the written sstable's contents.
+        auto sst = make_sstable_containing(env.make_sstable(s), muts);
+        BOOST_REQUIRE(sst->has_component(component_type::CompressionDictionary));
+        BOOST_REQUIRE(!sst->get_compression().dictionary.value.empty());
+
+        auto reopened = env.reusable_sst(s, sst).get0();
+        BOOST_REQUIRE(reopened->get_compression().dictionary == sst->get_compression().dictionary);
+        std::sort(muts.begin(), muts.end(), mutation_decorated_key_less_comparator());
+        auto rd = assert_that(sstable_reader_v2(reopened, s, env.make_reader_permit()));
+        for (auto& m : muts) {
+            rd.produces(m);
+        }
+        rd.produces_end_of_stream();
+    });
+}
+
+SEASTAR_TEST_CASE(test_evictable_bloom_filter) {
+    return test_env::do_with_async([] (test_env& env) {
+        env.db_config().enable_evictable_sstable_filters.set(true);
+        auto s = schema_builder("ks", "test_evictable_bloom_filter")
+                .with_column("pk", int32_type, column_kind::partition_key)
+                .with_column("v", int32_type)
+                .build();
+
+        // Enough keys for the filter to span several pages.
+        constexpr int nr_keys = 20000;
+        std::vector<mutation> muts;
+        for (int i = 0; i < nr_keys; ++i) {
+            mutation m(s, partition_key::from_single_value(*s, int32_type->decompose(i)));
+            m.set_clustered_cell(clustering_key::make_empty(), "v", data_value(i), api::new_timestamp());
+            muts.push_back(std::move(m));
+        }
+        auto key = [&] (int i) {
+            return sstables::sstable::make_hashed_key(*s, partition_key::from_single_value(*s, int32_type->decompose(i)));
+        };
+
+        auto check = [&] (shared_sstable sst) {
+            BOOST_REQUIRE(dynamic_cast<sstables::paged_bloom_filter*>(sstables::test(sst).get_filter()));
+            // There are no false negatives, whether pages are cached or not.
+            for (int i = 0; i < nr_keys; ++i) {
+                BOOST_REQUIRE(sst->filter_has_key(key(i)));
+            }
+            // Lookups of absent keys are rejected once the pages they need are read.
+            int false_positives;
+            for (;;) {
+                auto incomplete = sstables::paged_bloom_filter::get_shard_stats().incomplete_lookups;
+                false_positives = 0;
+                for (int i = nr_keys; i < 2 * nr_keys; ++i) {
+                    false_positives += sst->filter_has_key(key(i));
+                }
+                if (sstables::paged_bloom_filter::get_shard_stats().incomplete_lookups == incomplete) {
+                    break;
+                }
+                seastar::sleep(std::chrono::milliseconds(1)).get();
+            }
+            BOOST_REQUIRE_LT(false_positives, nr_keys * 2 * s->bloom_filter_fp_chance());
+
+            env.manager().get_cache_tracker().get_lru().evict_all();
+            for (int i = 0; i < nr_keys; ++i) {
+                BOOST_REQUIRE(sst->filter_has_key(key(i)));
+            }
+        };
+
+        // Written sstables switch to the on-disk filter once sealed.
+        auto sst = make_sstable_containing(env.make_sstable(s), muts);
+        check(sst);
+
+        auto misses = sstables::filter_page_cache_metrics.page_misses;
+        check(env.reusable_sst(s, sst).get0());
+        BOOST_REQUIRE_GT(sstables::filter_page_cache_metrics.page_misses, misses);
+    });
+}
+
+SEASTAR_TEST_CASE(test_deferred_bloom_filter) {
+    return test_env::do_with_async([] (test_env& env) {
+        auto s = schema_builder("ks", "test_deferred_bloom_filter")
+                .with_column("pk", int32_type, column_kind::partition_key)
+                .with_column("v", int32_type)
+                .build();
+
+        constexpr int nr_keys = 1000;
+        std::vector<mutation> muts;
+        for (int i = 0; i < nr_keys; ++i) {
+            mutation m(s, partition_key::from_single_value(*s, int32_type->decompose(i)));
+            m.set_clustered_cell(clustering_key::make_empty(), "v", data_value(i), api::new_timestamp());
+            muts.push_back(std::move(m));
+        }
+        auto key = [&] (int i) {
+            return sstables::sstable::make_hashed_key(*s, partition_key::from_single_value(*s, int32_type->decompose(i)));
+        };
+        auto sst = make_sstable_containing(env.make_sstable(s), muts);
+
+        auto reopened = env.make_sstable(s, sst->generation(), sst->get_version());
+        reopened->load(default_priority_class(), sstable_open_config{.defer_bloom_filter = true}).get();
+        BOOST_REQUIRE(reopened->filter_deferred());
+        // Until the filter is read, every key may be present.
+        for (int i = nr_keys; i < 2 * nr_keys; ++i) {
+            BOOST_REQUIRE(reopened->filter_has_key(key(i)));
+        }
+
+        reopened->load_deferred_filter().get();
+        BOOST_REQUIRE(!reopened->filter_deferred());
+        for (int i = 0; i < nr_keys; ++i) {
+            BOOST_REQUIRE(reopened->filter_has_key(key(i)));
+        }
+        int false_positives = 0;
+        for (int i = nr_keys; i < 2 * nr_keys; ++i) {
+            false_positives += reopened->filter_has_key(key(i));
+        }
+        BOOST_REQUIRE_LT(false_positives, nr_keys * 2 * s->bloom_filter_fp_chance());
+    });
+}
+
+SEASTAR_TEST_CASE(test_partition_trie_index) {
+    return test_env::do_with_async([] (test_env& env) {
+        env.db_config().enable_sstable_partition_trie_index.set(true);
+        // Small promoted index blocks, so that wide partitions have several.
+        env.db_config().column_index_size_in_kb.set(1);
+        auto s = schema_builder("ks", "test_partition_trie_index")
+                .with_column("pk", int32_type, column_kind::partition_key)
+                .with_column("ck", int32_type, column_kind::clustering_key)
+                .with_column("v", utf8_type)
+                .build();
+
+        constexpr int nr_keys = 2000;
+        std::vector<mutation> muts;
+        for (int i = 0; i < nr_keys; ++i) {
+            mutation m(s, partition_key::from_single_value(*s, int32_type->decompose(i)));
+            // Every tenth partition is wide enough to have a promoted index.
+            auto nr_rows = i % 10 ? 1 : 100;
+            for (int j = 0; j < nr_rows; ++j) {
+                m.set_clustered_cell(clustering_key::from_single_value(*s, int32_type->decompose(j)), "v", data_value(format("value #{}", j)), api::new_timestamp());
+            }
+            muts.push_back(std::move(m));
+        }
+
+        auto check = [&] (shared_sstable sst) {
+            BOOST_REQUIRE(sst->has_component(component_type::Partitions));
+            auto hits = sstables::partition_trie::get_shard_stats().hits;
+            for (auto& m : muts) {
+                auto pr = dht::partition_range::make_singular(m.decorated_key());
+                assert_that(sstable_reader_v2(sst, s, env.make_reader_permit(), pr))
+                    .produces(m)
+                    .produces_end_of_stream();
+            }
+            BOOST_REQUIRE_GE(sstables::partition_trie::get_shard_stats().hits, hits + nr_keys);
+            for (int i = nr_keys; i < 2 * nr_keys; ++i) {
+                auto pr = dht::partition_range::make_singular(dht::decorate_key(*s, partition_key::from_single_value(*s, int32_type->decompose(i))));
+                assert_that(sstable_reader_v2(sst, s, env.make_reader_permit(), pr))
+                    .produces_end_of_stream();
+            }
+        };
+
+        // make_sstable_containing() also checks that scans, which don't use the trie, see all partitions.
+        auto sst = make_sstable_containing(env.make_sstable(s), muts);
+        check(sst);
+        env.manager().get_cache_tracker().get_lru().evict_all();
+        check(env.reusable_sst(s, sst).get0());
+    });
+}
+
+SEASTAR_TEST_CASE(test_row_index) {
+    return test_env::do_with_async([] (test_env& env) {
+        env.db_config().enable_sstable_row_index.set(true);
+        // Small promoted index blocks, so that the wide partition has a tree of several levels.
+        env.db_config().column_index_size_in_kb.set(1);
+        auto s = schema_builder("ks", "test_row_index")
+                .with_column("pk", int32_type, column_kind::partition_key)
+                .with_column("ck", int32_type, column_kind::clustering_key)
+                .with_column("v", utf8_type)
+                .build();
+
+        auto make_ck = [&] (int ck) {
+            return clustering_key::from_single_value(*s, int32_type->decompose(ck));
+        };
+        constexpr int nr_rows = 20000;
+        std::vector<mutation> muts;
+        for (int i = 0; i < 2; ++i) {
+            mutation m(s, partition_key::from_single_value(*s, int32_type->decompose(i)));
+            // Only the first partition is wide enough for the row index.
+            for (int j = 0; j < (i ? 10 : nr_rows); j += 2) {
+                m.set_clustered_cell(make_ck(j), "v", data_value(format("value #{}", j)), api::new_timestamp());
+            }
+            m.partition().apply_delete(*s, range_tombstone(
+                    bound_view(make_ck(nr_rows / 3), bound_kind::incl_start),
+                    bound_view(make_ck(nr_rows / 2), bound_kind::excl_end),
+                    tombstone(api::new_timestamp(), gc_clock::now())));
+            muts.push_back(std::move(m));
+        }
+        std::sort(muts.begin(), muts.end(), mutation_decorated_key_less_comparator());
+
+        auto check = [&] (shared_sstable sst) {
+            BOOST_REQUIRE(sst->has_component(component_type::Rows));
+            auto lookups = sstables::mc::row_index::get_shard_stats().lookups;
+            for (auto& m : muts) {
+                auto pr = dht::partition_range::make_singular(m.decorated_key());
+                // Row keys are even, so odd bounds fall between rows, and some ranges are empty.
+                for (int start : {-1, 0, 1, 999, 1000, nr_rows / 3 - 1, nr_rows / 3 + 1, nr_rows / 2 - 1, nr_rows - 2, nr_rows - 1, nr_rows + 1}) {
+                    for (int len : {1, 2, 50, nr_rows}) {
+                        auto ranges = query::clustering_row_ranges{query::clustering_range::make(
+                            {make_ck(start), true}, {make_ck(start + len), false})};
+                        auto slice = partition_slice_builder(*s).with_ranges(ranges).build();
+                        assert_that(sst->as_mutation_source().make_reader_v2(s, env.make_reader_permit(), pr, slice))
+                            .produces(m.sliced(ranges))
+                            .produces_end_of_stream();
+                    }
+                }
+            }
+            BOOST_REQUIRE_GT(sstables::mc::row_index::get_shard_stats().lookups, lookups);
+        };
+
+        auto sst = make_sstable_containing(env.make_sstable(s), muts);
+        check(sst);
+        env.manager().get_cache_tracker().get_lru().evict_all();
+        check(env.reusable_sst(s, sst).get0());
+    });
+}
+
 SEASTAR_TEST_CASE(datafile_generation_37) {
     return test_env::do_with_async([] (test_env& env) {
         auto s = compact_simple_dense_schema();
@@ -2941,6 +3180,54 @@ SEASTAR_TEST_CASE(test_validate_checksums) {
     });
 }
 
+SEASTAR_TEST_CASE(test_write_io_options) {
+    return test_env::do_with_async([&] (test_env& env) {
+        auto random_spec = tests::make_random_schema_specification(
+                get_name(),
+                std::uniform_int_distribution<size_t>(1, 4),
+                std::uniform_int_distribution<size_t>(2, 4),
+                std::uniform_int_distribution<size_t>(2, 8),
+                std::uniform_int_distribution<size_t>(2, 8));
+        auto random_schema = tests::random_schema{tests::random::get_int<uint32_t>(), *random_spec};
+        auto schema = random_schema.schema();
+        auto permit = env.make_reader_permit();
+
+        const auto muts = tests::generate_random_mutations(random_schema).get();
+
+        const std::map<sstring, sstring> no_compression_params = {};
+        const std::map<sstring, sstring> lz4_compression_params = {{compression_parameters::SSTABLE_COMPRESSION, "LZ4Compressor"}};
+
+        for (const auto& compression_params : {no_compression_params, lz4_compression_params}) {
+            testlog.info("compression={}", compression_params);
+            auto sst_schema = schema_builder(schema).set_compressor_params(compression_params).build();
+
+            auto mr = make_flat_mutation_reader_from_mutations_v2(schema, permit, muts);
+            auto close_mr = deferred_close(mr);
+
+            auto sst = env.make_sstable(sst_schema);
+            sstable_writer_config cfg = env.manager().configure_writer();
+            cfg.data_write_buffer_size = 3 * DEFAULT_CHUNK_SIZE;
+            cfg.data_write_behind = 2;
+            cfg.data_preallocation_size = 1 << 20;
+            cfg.data_sync_interval = 64 * 1024;
+
+            auto wr = sst->get_writer(*sst_schema, 1, cfg, encoding_stats{}, default_priority_class());
+            mr.consume_in_thread(std::move(wr));
+
+            sst->load().get();
+
+            // The preallocated space past the end of the data is released.
+            BOOST_REQUIRE(sstables::validate_checksums(sst, permit, default_priority_class()).get());
+
+            auto assertions = assert_that(sst->make_reader(schema, permit, query::full_partition_range, schema->full_slice()));
+            for (const auto& m : muts) {
+                assertions.produces(m);
+            }
+            assertions.produces_end_of_stream();
+        }
+    });
+}
+
 SEASTAR_TEST_CASE(partial_sstable_deletion_test) {
     return test_env::do_with_async([] (test_env& env) {
         simple_schema ss;
@@ -3144,3 +3431,101 @@ SEASTAR_TEST_CASE(find_first_position_in_partition_from_sstable_test) {
         }
     });
 }
+
+SEASTAR_TEST_CASE(test_sstable_streamed_components) {
+    return test_env::do_with_async([] (test_env& env) {
+        simple_schema ss;
+        auto s = ss.schema();
+        auto& pc = default_priority_class();
+
+        auto m = ss.new_mutation("pk");
+        ss.add_row(m, ss.make_ckey(1), "v1");
+        ss.add_row(m, ss.make_ckey(2), "v2");
+        auto sst = make_sstable_containing(env.make_sstable(s), {m});
+        BOOST_REQUIRE(sst->can_stream_components());
+
+        auto components = sst->streamed_components();
+        BOOST_REQUIRE(boost::find(components, "TOC.txt") == components.end());
+        BOOST_REQUIRE(boost::find(components, "Data.db") != components.end());
+
+        // Copy the components as a receiver of STREAM_SSTABLE_FILES would.
+        auto dst = env.make_sstable(s, sst->get_version());
+        dst->open_for_streamed_components(components, pc).get();
+        for (auto& c : components) {
+            auto in = sst->make_streamed_component_input_stream(c, pc).get0();
+            auto close_in = deferred_close(in);
+            auto out = dst->make_streamed_component_output_stream(c, pc).get0();
+            auto close_out = deferred_close(out);
+            for (auto buf = in.read().get0(); !buf.empty(); buf = in.read().get0()) {
+                out.write(buf.get(), buf.size()).get();
+            }
+            out.flush().get();
+        }
+        dst->seal_sstable(false).get();
+        dst->load().get();
+
+        BOOST_REQUIRE_EQUAL(dst->bytes_on_disk(), sst->bytes_on_disk());
+        assert_that(dst->as_mutation_source().make_reader_v2(s, env.make_reader_permit(), query::full_partition_range))
+            .produces(m)
+            .produces_end_of_stream();
+    });
+}
+
+SEASTAR_TEST_CASE(test_reader_resumes_from_permit_hint) {
+    return test_env::do_with_async([] (test_env& env) {
+        simple_schema table;
+        auto s = table.schema();
+
+        auto pkeys = table.make_pkeys(4);
+        std::vector<mutation> muts;
+        for (auto& pk : pkeys) {
+            mutation m(s, pk);
+            for (uint32_t ck = 0; ck < 10; ++ck) {
+                table.add_row(m, table.make_ckey(ck), "v");
+            }
+            muts.push_back(std::move(m));
+        }
+        auto sst = make_sstable_containing(env.make_sstable(s), muts);
+
+        // Without the index cache, each reader loads the index pages it needs.
+        auto slice = partition_slice_builder(*s).with_option<query::partition_slice::option::bypass_cache>().build();
+        auto permit = env.make_reader_permit();
+        auto& stats = permit.get_sstable_read_stats();
+
+        // Stop in the middle of the second partition, like an evicted read.
+        {
+            auto rd = sst->make_reader(s, permit, query::full_partition_range, slice, default_priority_class(),
+                    tracing::trace_state_ptr(), streamed_mutation::forwarding::no, mutation_reader::forwarding::no);
+            auto close_rd = deferred_close(rd);
+            rd.set_max_buffer_size(1);
+            while (true) {
+                auto mf = rd().get();
+                BOOST_REQUIRE(mf);
+                if (mf->is_partition_start() && mf->as_partition_start().key().equal(*s, pkeys[1])) {
+                    break;
+                }
+            }
+            BOOST_REQUIRE(rd().get()->is_clustering_row());
+        }
+
+        // The recreated reader seeks to the partition directly.
+        const auto index_pages_read = stats.index_pages_read;
+        auto pr = dht::partition_range::make_starting_with({dht::ring_position(pkeys[1]), true});
+        assert_that(sst->make_reader(s, permit, pr, slice, default_priority_class(),
+                    tracing::trace_state_ptr(), streamed_mutation::forwarding::no, mutation_reader::forwarding::no))
+            .produces(muts[1])
+            .produces(muts[2])
+            .produces(muts[3])
+            .produces_end_of_stream();
+        BOOST_REQUIRE_EQUAL(stats.index_pages_read, index_pages_read);
+
+        // The hint is dropped once a reader of the sstable reaches the end of its range.
+        auto other_pr = dht::partition_range::make({dht::ring_position(pkeys[1]), true}, {dht::ring_position(pkeys[2]), true});
+        assert_that(sst->make_reader(s, permit, other_pr, slice, default_priority_class(),
+                    tracing::trace_state_ptr(), streamed_mutation::forwarding::no, mutation_reader::forwarding::no))
+            .produces(muts[1])
+            .produces(muts[2])
+            .produces_end_of_stream();
+        BOOST_REQUIRE_GT(stats.index_pages_read, index_pages_read);
+    });
+}
@@ -10,6 +10,7 @@
 #include "sstables/generation_type.hh"
 #include "test/lib/scylla_test_case.hh"
 #include <seastar/core/sstring.hh>
+#include <seastar/core/fstream.hh>
 #include "sstables/shared_sstable.hh"
 #include "sstables/sstable_directory.hh"
 #include "replica/distributed_loader.hh"
@@ -385,6 +386,99 @@ SEASTAR_THREAD_TEST_CASE(sstable_directory_unshared_sstables_sanity_unmatched_ge
     }).get();
 }
 
+// Called from a seastar thread
+static void write_file(fs::path path, sstring contents) {
+    auto f = open_file_dma(path.native(), open_flags::wo | open_flags::create | open_flags::truncate).get0();
+    auto out = make_file_output_stream(std::move(f)).get0();
+    out.write(contents.data(), contents.size()).get();
+    out.close().get();
+}
+
+// Called from a seastar thread
+static bool has_owners_manifests(fs::path dir) {
+    bool found = false;
+    lister::scan_dir(dir, lister::dir_entry_types::of<directory_entry_type::regular>(), [&found] (fs::path, directory_entry de) {
+        found |= std::string_view(de.name).starts_with(sstable_directory::owners_manifest_prefix);
+        return make_ready_future<>();
+    }).get();
+    return found;
+}
+
+// Test that the owners manifests saved at shutdown don't change where the SSTables are
+// loaded, whether they are up to date, stale or missing, and that they are removed.
+SEASTAR_THREAD_TEST_CASE(sstable_directory_owners_manifest) {
+    sstables::test_env::do_with_sharded_async([] (sharded<test_env>& env) {
+        // Writes an SSTable owned by each shard, with generation shard + gen_offset, and returns
+        // the names of their TOCs. With save_owners, each shard saves its owners manifest.
+        auto make_sstables = [&env] (fs::path dir, unsigned gen_offset, bool save_owners) {
+            std::vector<sstring> tocs;
+            for (shard_id i = 0; i < smp::count; ++i) {
+                tocs.push_back(env.invoke_on(i, [dir, i, gen_offset, save_owners] (sstables::test_env& env) {
+                    return seastar::async([&] {
+                        auto sst = make_sstable_for_this_shard(std::bind(new_sstable, std::ref(env), dir, sstables::generation_type(i + gen_offset)));
+                        if (save_owners) {
+                            sstable_directory::write_owners_manifests({sst}).get();
+                        }
+                        return sstring(test::filename(*sst, component_type::TOC).filename().native());
+                    });
+                }).get0());
+            }
+            return tocs;
+        };
+        auto load_and_verify = [&env] (fs::path dir) {
+            with_sstable_directory(dir, env, [] (sharded<sstables::sstable_directory>& sstdir) {
+                distributed_loader_for_tests::process_sstable_dir(sstdir, { .throw_on_missing_toc = true }).get();
+                verify_that_all_sstables_are_local(sstdir, smp::count).get();
+            });
+            BOOST_REQUIRE(!has_owners_manifests(dir));
+        };
+        // A manifest saying that shard owner(i) owns the SSTable of shard i.
+        auto make_manifest = [] (const std::vector<sstring>& tocs, unsigned shard_count, std::function<shard_id (shard_id)> owner) {
+            auto manifest = format("{} {}\n", shard_count, test_table_schema()->get_sharder().sharding_ignore_msb());
+            for (shard_id i = 0; i < tocs.size(); ++i) {
+                manifest += format("{} {}\n", tocs[i], owner(i));
+            }
+            return manifest;
+        };
+        auto manifest_path = [] (fs::path dir) {
+            return dir / format("{}{}", sstable_directory::owners_manifest_prefix, 0);
+        };
+
+        testlog.info("Up to date manifests");
+        {
+            tmpdir dir;
+            make_sstables(dir.path(), smp::count, true);
+            BOOST_REQUIRE(has_owners_manifests(dir.path()));
+            load_and_verify(dir.path());
+        }
+
+        testlog.info("Missing manifests, and the left-over of an interrupted write");
+        {
+            tmpdir dir;
+            auto tocs = make_sstables(dir.path(), smp::count, false);
+            write_file(fs::path(manifest_path(dir.path()).native() + ".tmp"), make_manifest(tocs, smp::count, [] (shard_id i) { return i; }));
+            load_and_verify(dir.path());
+        }
+
+        testlog.info("Manifest written with a different sharding");
+        {
+            tmpdir dir;
+            auto tocs = make_sstables(dir.path(), smp::count, false);
+            write_file(manifest_path(dir.path()), make_manifest(tocs, smp::count + 1, [] (shard_id i) { return i; }));
+            load_and_verify(dir.path());
+        }
+
+        testlog.info("Manifest with stale owners");
+        {
+            tmpdir dir;
+            // Each SSTable is processed by the next shard, which the manifest says owns it.
+            auto tocs = make_sstables(dir.path(), 1, false);
+            write_file(manifest_path(dir.path()), make_manifest(tocs, smp::count, [] (shard_id i) { return (i + 1) % smp::count; }));
+            load_and_verify(dir.path());
+        }
+    }).get();
+}
+
 // Test that the sstable_dir object can keep the table alive against a drop
 SEASTAR_TEST_CASE(sstable_directory_test_table_lock_works) {
     return do_with_cql_env_thread([] (cql_test_env& e) {
@@ -1659,3 +1659,164 @@ SEASTAR_TEST_CASE(writer_handles_subsequent_range_tombstone_changes_without_tomb
     });
 }
 
+
+SEASTAR_TEST_CASE(test_skip_unselected_values) {
+    return test_env::do_with_async([] (test_env& env) {
+        for (const auto version : writable_sstable_versions) {
+            auto s = schema_builder("ks", "test")
+                .with_column("pk", int32_type, column_kind::partition_key)
+                .with_column("ck", int32_type, column_kind::clustering_key)
+                .with_column("s1", utf8_type, column_kind::static_column)
+                .with_column("v1", utf8_type)
+                .with_column("v2", int32_type)
+                .with_column("v3", int64_type)
+                .build();
+
+            auto dk = dht::decorate_key(*s, partition_key::from_exploded(*s, {int32_type->decompose(1)}));
+            mutation m(s, dk);
+            // The unselected cells are expected without their values, but with
+            // their liveness, so that rows without a row marker stay alive.
+            mutation expected(s, dk);
+            auto set_cell = [&] (int32_t ck, const char* column, data_value value, api::timestamp_type ts, bool selected) {
+                auto& cdef = *s->get_column_definition(to_bytes(column));
+                auto expiry = gc_clock::now() + std::chrono::hours(1);
+                auto ttl = ts % 2 ? gc_clock::duration(std::chrono::hours(1)) : gc_clock::duration::zero();
+                auto cell = [&] (bytes_view v) {
+                    return ttl.count() ? atomic_cell::make_live(*cdef.type, ts, v, expiry, ttl) : atomic_cell::make_live(*cdef.type, ts, v);
+                };
+                auto v = value.serialize_nonnull();
+                if (cdef.is_static()) {
+                    m.set_static_cell(cdef, cell(v));
+                    expected.set_static_cell(cdef, cell(selected ? bytes_view(v) : bytes_view()));
+                } else {
+                    auto key = clustering_key::from_exploded(*s, {int32_type->decompose(ck)});
+                    m.set_clustered_cell(key, cdef, cell(v));
+                    expected.set_clustered_cell(key, cdef, cell(selected ? bytes_view(v) : bytes_view()));
+                }
+            };
+            set_cell(0, "s1", sstring(1000, 's'), 1, false);
+            set_cell(1, "v1", sstring(100, 'a'), 2, false);
+            set_cell(1, "v2", int32_t(1), 3, true);
+            set_cell(1, "v3", int64_t(10), 4, false);
+            set_cell(2, "v1", sstring(100000, 'b'), 5, false);
+            set_cell(3, "v2", int32_t(3), 6, true);
+            set_cell(3, "v3", int64_t(30), 7, false);
+
+            sstable_writer_config cfg = env.manager().configure_writer();
+            auto ms = make_sstable_mutation_source(env, s, {m}, cfg, version);
+
+            auto slice = partition_slice_builder(*s)
+                .with_regular_column(to_bytes("v2"))
+                .with_no_static_columns()
+                .with_option<query::partition_slice::option::skip_unselected_values>()
+                .build();
+            assert_that(ms.make_reader_v2(s, env.make_reader_permit(), query::full_partition_range, slice))
+                .produces(expected)
+                .produces_end_of_stream();
+
+            // Without the option, all the values are read.
+            auto full_values_slice = partition_slice_builder(*s)
+                .with_regular_column(to_bytes("v2"))
+                .with_no_static_columns()
+                .build();
+            assert_that(ms.make_reader_v2(s, env.make_reader_permit(), query::full_partition_range, full_values_slice))
+                .produces(m)
+                .produces_end_of_stream();
+        }
+    });
+}
+
+SEASTAR_TEST_CASE(test_column_value_stats) {
+    return test_env::do_with_async([] (test_env& env) {
+        for (const auto version : writable_sstable_versions) {
+            auto s = schema_builder("ks", "test")
+                .with_column("pk", int32_type, column_kind::partition_key)
+                .with_column("ck", int32_type, column_kind::clustering_key)
+                .with_column("v1", int32_type)
+                .with_column("v2", utf8_type)
+                .with_column("v3", int32_type)
+                .build();
+
+            auto mt = make_lw_shared<replica::memtable>(s);
+            auto dk = dht::decorate_key(*s, partition_key::from_exploded(*s, {int32_type->decompose(1)}));
+            mutation m(s, dk);
+            auto set_cell = [&] (int32_t ck, const char* column, data_value value) {
+                auto key = clustering_key::from_exploded(*s, {int32_type->decompose(ck)});
+                m.set_clustered_cell(key, *s->get_column_definition(to_bytes(column)), atomic_cell::make_live(*value.type(), 1, value.serialize_nonnull()));
+            };
+            set_cell(0, "v1", int32_t(-5));
+            set_cell(1, "v1", int32_t(7));
+            set_cell(2, "v1", int32_t(3));
+            set_cell(0, "v2", sstring("abc"));
+            set_cell(1, "v2", sstring(1000, 'x'));
+            mt->apply(m);
+
+            sstable_writer_config cfg = env.manager().configure_writer();
+            cfg.column_value_stats = true;
+            auto sst = make_sstable_easy(env, mt, cfg, version);
+
+            auto* v1 = sst->get_column_value_stats(to_bytes("v1"));
+            BOOST_REQUIRE(v1);
+            BOOST_REQUIRE_EQUAL(v1->rows, 3);
+            BOOST_REQUIRE_EQUAL(v1->values, 3);
+            BOOST_REQUIRE(v1->bounded);
+            BOOST_REQUIRE_EQUAL(v1->min_value.value, int32_type->decompose(int32_t(-5)));
+            BOOST_REQUIRE_EQUAL(v1->max_value.value, int32_type->decompose(int32_t(7)));
+
+            // A value too large to be tracked leaves the column unbounded.
+            auto* v2 = sst->get_column_value_stats(to_bytes("v2"));
+            BOOST_REQUIRE(v2);
+            BOOST_REQUIRE_EQUAL(v2->values, 2);
+            BOOST_REQUIRE(!v2->bounded);
+
+            auto* v3 = sst->get_column_value_stats(to_bytes("v3"));
+            BOOST_REQUIRE(v3);
+            BOOST_REQUIRE_EQUAL(v3->rows, 3);
+            BOOST_REQUIRE_EQUAL(v3->values, 0);
+            BOOST_REQUIRE(!v3->bounded);
+
+            // Not collected by default.
+            auto plain = make_sstable_easy(env, mt, env.manager().configure_writer(), version);
+            BOOST_REQUIRE(!plain->get_column_value_stats(to_bytes("v1")));
+        }
+    });
+}
+
+SEASTAR_TEST_CASE(test_skip_shadowed_rows) {
+    return test_env::do_with_async([] (test_env& env) {
+        for (const auto version : writable_sstable_versions) {
+            simple_schema ss;
+            auto s = ss.schema();
+            auto pk = ss.make_pkey(0);
+
+            mutation m(s, pk);
+            for (int ck = 0; ck < 4; ++ck) {
+                ss.add_row(m, ss.make_ckey(ck), "v");
+            }
+            ss.delete_range(m, query::clustering_range::make(ss.make_ckey(1), ss.make_ckey(2)));
+
+            auto read = [&] (shared_sstable sst) {
+                auto skipped_before = sstables::sstables_stats::get_shard_stats().shadowed_rows_skipped;
+                assert_that(sst->make_reader(s, env.make_reader_permit(), query::full_partition_range, s->full_slice()))
+                    .produces(m)
+                    .produces_end_of_stream();
+                return sstables::sstables_stats::get_shard_stats().shadowed_rows_skipped - skipped_before;
+            };
+
+            // The range tombstone is the newest write of the sstable, the rows it covers are not parsed.
+            BOOST_REQUIRE_EQUAL(read(make_sstable_containing(env.make_sstable(s, version), {m})), 2);
+
+            // A newer write elsewhere in the sstable leaves the rows to the rest of the read.
+            mutation newer(s, ss.make_pkey(1));
+            ss.add_row(newer, ss.make_ckey(0), "v");
+            std::vector<mutation> muts{m, newer};
+            boost::sort(muts, mutation_decorated_key_less_comparator());
+            auto sst = make_sstable_containing(env.make_sstable(s, version), muts);
+            auto skipped_before = sstables::sstables_stats::get_shard_stats().shadowed_rows_skipped;
+            assert_that(sst->make_reader(s, env.make_reader_permit(), query::full_partition_range, s->full_slice()))
+                .produces(muts)
+                .produces_end_of_stream();
+            BOOST_REQUIRE_EQUAL(sstables::sstables_stats::get_shard_stats().shadowed_rows_skipped, skipped_before);
+        }
+    });
+}
@@ -26,7 +26,7 @@ static void add_entry(logalloc::region& r,
     as(r, [&] {
         with_allocator(r.allocator(), [&] {
             sstables::key sst_key = sstables::key::from_partition_key(s, key);
-            page._entries.push_back(make_managed<index_entry>(
+            page.push_back(s, make_managed<index_entry>(
                     managed_bytes(sst_key.get_bytes()),
                     position,
                     managed_ref<promoted_index>()));
@@ -149,6 +149,35 @@ static future<> ignore_result(future<T>&& f) {
     });
 }
 
+SEASTAR_THREAD_TEST_CASE(test_page_lower_bound) {
+    simple_schema s;
+    logalloc::region r;
+    auto keys = s.make_pkeys(4);
+    partition_index_page page;
+    auto destroy_page = defer([&] {
+        with_allocator(r.allocator(), [&] {
+           auto p = std::move(page);
+        });
+    });
+    for (size_t i = 0; i < keys.size(); ++i) {
+        add_entry(r, *s.schema(), page, keys[i].key(), i);
+    }
+
+    auto lower_bound = [&] (size_t from, dht::ring_position_view pos) {
+        return with_allocator(r.allocator(), [&] {
+            return page.lower_bound(*s.schema(), from, pos);
+        });
+    };
+    for (size_t i = 0; i < keys.size(); ++i) {
+        BOOST_REQUIRE_EQUAL(lower_bound(0, keys[i]), i);
+        BOOST_REQUIRE_EQUAL(lower_bound(0, dht::ring_position_view::starting_at(keys[i].token())), i);
+        BOOST_REQUIRE_EQUAL(lower_bound(0, dht::ring_position_view::ending_at(keys[i].token())), i + 1);
+        BOOST_REQUIRE_EQUAL(lower_bound(2, keys[i]), std::max<size_t>(i, 2));
+    }
+    BOOST_REQUIRE_EQUAL(lower_bound(1, dht::ring_position_view::min()), 1);
+    BOOST_REQUIRE_EQUAL(lower_bound(0, dht::ring_position_view::max()), keys.size());
+}
+
 SEASTAR_THREAD_TEST_CASE(test_exception_while_loading) {
     ::lru lru;
     simple_schema s;
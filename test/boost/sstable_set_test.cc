@@ -81,3 +81,44 @@ SEASTAR_TEST_CASE(test_time_series_sstable_set_read_modify_write) {
         BOOST_REQUIRE_EQUAL(ss1->all()->size(), 1);
     });
 }
+
+SEASTAR_TEST_CASE(test_sstable_set_count) {
+    return test_env::do_with_async([] (test_env& env) {
+        simple_schema ss;
+        auto s = ss.schema();
+        sstable_writer_config cfg = env.manager().configure_writer("");
+
+        auto pks = tests::generate_partition_keys(5, s);
+        auto make_sstable = [&] (std::vector<dht::decorated_key> keys) {
+            std::vector<mutation> muts;
+            for (auto& pk : keys) {
+                muts.emplace_back(s, pk);
+                ss.add_row(muts.back(), ss.make_ckey(0), "val");
+            }
+            return make_sstable_easy(env, make_flat_mutation_reader_from_mutations_v2(s, env.make_reader_permit(), std::move(muts)), cfg);
+        };
+        // Overlapping sstables, so that some of them span several intervals of the set.
+        auto ssts = make_lw_shared<sstable_list>({
+            make_sstable({pks[0], pks[2]}),
+            make_sstable({pks[1], pks[3]}),
+            make_sstable({pks[3]}),
+            make_sstable({pks[0], pks[4]}),
+        });
+
+        auto check = [&] (const sstables::sstable_set& set) {
+            for (auto& pk : pks) {
+                auto range = dht::partition_range::make_singular(pk);
+                BOOST_REQUIRE_EQUAL(set.count(range), set.select(range).size());
+            }
+            auto range = dht::partition_range::make({pks[1]}, {pks[3]});
+            BOOST_REQUIRE_EQUAL(set.count(range), set.select(range).size());
+            BOOST_REQUIRE_EQUAL(set.count(query::full_partition_range), set.select(query::full_partition_range).size());
+        };
+
+        auto leveled = make_lw_shared<sstables::sstable_set>(make_sstable_set(s, ssts, false));
+        check(*leveled);
+        auto unleveled = make_lw_shared<sstables::sstable_set>(make_sstable_set(s, ssts, true));
+        check(*unleveled);
+        check(make_compound_sstable_set(s, {leveled, unleveled}));
+    });
+}
@@ -31,6 +31,8 @@
 #include "partition_slice_builder.hh"
 #include "test/lib/test_services.hh"
 #include "cell_locking.hh"
+#include "utils/bloom_filter.hh"
+#include "utils/binary_fuse_filter.hh"
 #include "sstables/sstable_mutation_reader.hh"
 
 #include <boost/range/combine.hpp>
@@ -284,6 +286,82 @@ SEASTAR_TEST_CASE(check_filter_func) {
     return check_component_integrity(component_type::Filter);
 }
 
+SEASTAR_TEST_CASE(test_blocked_bloom_filter) {
+    return seastar::async([] {
+        constexpr int64_t nr_keys = 100000;
+        constexpr double fp_chance = 0.01;
+        auto f = utils::i_filter::get_filter(nr_keys, fp_chance, utils::filter_format::m_format, utils::filter_layout::blocked);
+        auto key = [] (int64_t i) {
+            return to_bytes(format("key{}", i));
+        };
+        for (int64_t i = 0; i < nr_keys; ++i) {
+            f->add(key(i));
+        }
+        for (int64_t i = 0; i < nr_keys; ++i) {
+            BOOST_REQUIRE(f->is_present(key(i)));
+        }
+        int64_t false_positives = 0;
+        for (int64_t i = nr_keys; i < 2 * nr_keys; ++i) {
+            false_positives += f->is_present(key(i));
+        }
+        // Leave room for variance in the measured rate.
+        BOOST_REQUIRE_LT(double(false_positives) / nr_keys, 1.5 * fp_chance);
+
+        // The filter survives a round trip through its on-disk representation.
+        auto& bf = static_cast<utils::filter::bloom_filter&>(*f);
+        auto words = bf.bits().get_storage();
+        large_bitset bs(bf.bits().size(), std::move(words));
+        auto loaded = utils::filter::create_blocked_filter(bf.num_hashes(), std::move(bs));
+        for (int64_t i = 0; i < nr_keys; ++i) {
+            BOOST_REQUIRE(loaded->is_present(key(i)));
+        }
+    });
+}
+
+SEASTAR_TEST_CASE(test_binary_fuse_filter) {
+    return seastar::async([] {
+        constexpr int64_t nr_keys = 100000;
+        constexpr double fp_chance = 0.01;
+        auto f = utils::i_filter::get_static_filter(nr_keys, fp_chance);
+        auto builder = dynamic_cast<utils::filter::static_filter_builder*>(f.get());
+        BOOST_REQUIRE(builder);
+        auto key = [] (int64_t i) {
+            return to_bytes(format("key{}", i));
+        };
+        for (int64_t i = 0; i < nr_keys; ++i) {
+            builder->add(key(i));
+        }
+        f = builder->seal();
+        auto fuse = dynamic_cast<utils::filter::binary_fuse_filter*>(f.get());
+        BOOST_REQUIRE(fuse);
+        // The narrowest fingerprint good for the requested rate.
+        BOOST_REQUIRE_EQUAL(fuse->fingerprint_bits(), 8);
+        // Less than the 10 bits per key of the equivalent bloom filter.
+        BOOST_REQUIRE_LT(double(fuse->memory_size() * 8) / nr_keys, 10);
+        for (int64_t i = 0; i < nr_keys; ++i) {
+            BOOST_REQUIRE(f->is_present(key(i)));
+        }
+        int64_t false_positives = 0;
+        for (int64_t i = nr_keys; i < 2 * nr_keys; ++i) {
+            false_positives += f->is_present(key(i));
+        }
+        BOOST_REQUIRE_LT(double(false_positives) / nr_keys, 1.5 / 256);
+
+        // The filter survives a round trip through its on-disk representation.
+        auto words = fuse->words();
+        utils::filter::binary_fuse_filter loaded(std::move(words));
+        for (int64_t i = 0; i < nr_keys; ++i) {
+            BOOST_REQUIRE(loaded.is_present(key(i)));
+        }
+        auto bad = fuse->words();
+        bad.pop_back();
+        BOOST_REQUIRE_THROW(utils::filter::binary_fuse_filter(std::move(bad)), std::invalid_argument);
+
+        // A bloom filter beats the smallest fingerprints for high rates.
+        BOOST_REQUIRE(dynamic_cast<utils::filter::bloom_filter*>(utils::i_filter::get_static_filter(nr_keys, 0.05).get()));
+    });
+}
+
 SEASTAR_TEST_CASE(check_statistics_func) {
     auto s = make_schema_for_compressed_sstable();
     return write_and_validate_sst(std::move(s), "test/resource/sstables/compressed", [] (shared_sstable sst1, shared_sstable sst2) {
@@ -830,6 +908,96 @@ SEASTAR_TEST_CASE(test_skipping_in_compressed_stream) {
     });
 }
 
+SEASTAR_TEST_CASE(test_prefetching_compressed_stream) {
+    return seastar::async([] {
+        tests::reader_concurrency_semaphore_wrapper semaphore;
+
+        tmpdir tmp;
+        auto file_path = (tmp.path() / "test").string();
+        file f = open_file_dma(file_path, open_flags::create | open_flags::wo).get0();
+
+        file_input_stream_options opts;
+        opts.read_ahead = 4;
+
+        compression_parameters cp({
+            { compression_parameters::SSTABLE_COMPRESSION, "LZ4Compressor" },
+            { compression_parameters::CHUNK_LENGTH_KB, "4" },
+        });
+
+        sstables::compression c;
+        auto os = make_file_output_stream(f, file_output_stream_options()).get0();
+        auto out = make_compressed_file_m_format_output_stream(std::move(os), &c, cp);
+
+        // More chunks than the read-ahead window holds.
+        constexpr size_t nr_chunks = 32;
+        std::vector<temporary_buffer<char>> chunks;
+        for (size_t i = 0; i < nr_chunks; ++i) {
+            temporary_buffer<char> buf(c.uncompressed_chunk_length());
+            std::fill_n(buf.get_write(), buf.size(), char('a' + i % 26));
+            out.write(buf.get(), buf.size()).get();
+            chunks.push_back(std::move(buf));
+        }
+        out.close().get();
+
+        c.update(seastar::file_size(file_path).get0());
+        const auto chunk_len = c.uncompressed_chunk_length();
+
+        auto make_is = [&] (uint64_t pos = 0) {
+            f = open_file_dma(file_path, open_flags::ro).get0();
+            return make_compressed_file_m_format_input_stream(f, &c, pos, nr_chunks * chunk_len - pos, opts, semaphore.make_permit());
+        };
+
+        auto expect = [&] (input_stream<char>& in, size_t chunk, size_t offset = 0) {
+            auto b = in.read_exactly(chunk_len - offset).get0();
+            BOOST_REQUIRE(std::equal(b.begin(), b.end(), chunks[chunk].begin() + offset, chunks[chunk].end()));
+        };
+
+        auto expect_eof = [] (input_stream<char>& in) {
+            auto b = in.read().get0();
+            BOOST_REQUIRE(b.empty());
+        };
+
+        auto in = make_is();
+        for (size_t i = 0; i < nr_chunks; ++i) {
+            expect(in, i);
+        }
+        expect_eof(in);
+        in.close().get();
+
+        // Skips within the prefetched chunks, and past them.
+        in = make_is();
+        expect(in, 0);
+        in.skip(chunk_len + 10).get();
+        expect(in, 2, 10);
+        in.skip(chunk_len * 20).get();
+        expect(in, 23);
+        in.skip(chunk_len * (nr_chunks - 25)).get();
+        expect(in, nr_chunks - 1);
+        expect_eof(in);
+        in.close().get();
+
+        // Starting and skipping mid-chunk.
+        in = make_is(chunk_len * 3 + 100);
+        expect(in, 3, 100);
+        in.skip(5).get();
+        expect(in, 4, 5);
+        in.close().get();
+
+        // Closing with reads in flight.
+        in = make_is();
+        expect(in, 0);
+        in.close().get();
+
+        // The prefetched chunks are charged to the read, until they are discarded.
+        BOOST_REQUIRE_EQUAL(semaphore.semaphore().consumed_resources().memory, 0);
+        in = make_is();
+        expect(in, 0);
+        BOOST_REQUIRE_GT(semaphore.semaphore().consumed_resources().memory, 0);
+        in.close().get();
+        BOOST_REQUIRE_EQUAL(semaphore.semaphore().consumed_resources().memory, 0);
+    });
+}
+
 // Test that sstables::key_view::tri_compare(const schema& s, partition_key_view other)
 // should correctly compare empty keys. The fact we did this incorrectly was
 // noticed while fixing #9375, and a separate issue on it is #10178.
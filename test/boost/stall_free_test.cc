@@ -10,6 +10,7 @@
 #include "utils/stall_free.hh"
 #include "utils/small_vector.hh"
 #include "utils/chunked_vector.hh"
+#include "test/lib/random_utils.hh"
 
 SEASTAR_THREAD_TEST_CASE(test_merge1) {
     std::list<int> l1{1, 2, 5, 8};
@@ -43,6 +44,30 @@ SEASTAR_THREAD_TEST_CASE(test_merge4) {
     BOOST_CHECK(l1 == expected);
 }
 
+SEASTAR_THREAD_TEST_CASE(test_sort_gently) {
+    for (size_t size : {size_t(0), size_t(1), size_t(7), utils::sort_gently_run_size, utils::sort_gently_run_size + 1,
+            3 * utils::sort_gently_run_size + 17, size_t(100000)}) {
+        std::vector<int> v;
+        v.reserve(size);
+        for (size_t i = 0; i < size; ++i) {
+            v.push_back(tests::random::get_int<int>(0, size / 2));
+        }
+        auto expected = v;
+        std::sort(expected.begin(), expected.end());
+        utils::sort_gently(v).get();
+        BOOST_REQUIRE(v == expected);
+
+        std::sort(expected.begin(), expected.end(), std::greater<int>());
+        utils::sort_gently(v, std::greater<int>()).get();
+        BOOST_REQUIRE(v == expected);
+
+        utils::chunked_vector<int> cv(v.begin(), v.end());
+        utils::sort_gently(cv).get();
+        std::sort(expected.begin(), expected.end());
+        BOOST_REQUIRE(std::equal(cv.begin(), cv.end(), expected.begin(), expected.end()));
+    }
+}
+
 SEASTAR_THREAD_TEST_CASE(test_clear_gently_string) {
     sstring s0 = "hello";
     utils::clear_gently(s0).get();
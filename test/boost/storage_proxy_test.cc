@@ -14,6 +14,9 @@
 #include "test/lib/cql_test_env.hh"
 #include "test/lib/mutation_source_test.hh"
 #include "test/lib/result_set_assertions.hh"
+#include "test/lib/cql_assertions.hh"
+#include "transport/messages/result_message.hh"
+#include "db/config.hh"
 #include "service/storage_proxy.hh"
 #include "query_ranges_to_vnodes.hh"
 #include "partition_slice_builder.hh"
@@ -123,3 +126,105 @@ SEASTAR_TEST_CASE(test_get_restricted_ranges) {
         });
     });
 }
+
+SEASTAR_THREAD_TEST_CASE(test_endpoint_latency_scorer) {
+    using namespace std::chrono_literals;
+    service::endpoint_latency_scorer scorer;
+    auto a = gms::inet_address("127.0.0.1");
+    auto b = gms::inet_address("127.0.0.2");
+    auto c = gms::inet_address("127.0.0.3");
+
+    auto sorted = [&] (inet_address_vector_replica_set eps, double badness_threshold) {
+        scorer.sort_by_score(eps, badness_threshold, 0ms);
+        return eps;
+    };
+
+    // No samples, the given order is kept.
+    BOOST_REQUIRE(sorted({a, b, c}, 0) == inet_address_vector_replica_set({a, b, c}));
+
+    for (auto ep : {a, b, c}) {
+        scorer.request_started(ep);
+    }
+    scorer.request_completed(a, 10ms);
+    scorer.request_completed(b, 1ms);
+    scorer.request_completed(c, 2ms);
+    BOOST_REQUIRE(sorted({a, b, c}, 0) == inet_address_vector_replica_set({b, c, a}));
+    // a is 10 times slower than b, which is within a badness threshold of 10.
+    BOOST_REQUIRE(sorted({a, b, c}, 10) == inet_address_vector_replica_set({a, b, c}));
+
+    // Reads pending on b make it worse than c.
+    scorer.request_started(b);
+    scorer.request_started(b);
+    BOOST_REQUIRE(sorted({a, b, c}, 0) == inet_address_vector_replica_set({c, b, a}));
+    scorer.request_failed(b);
+    scorer.request_failed(b);
+    BOOST_REQUIRE(sorted({a, b, c}, 0) == inet_address_vector_replica_set({b, c, a}));
+
+    scorer.reset();
+    BOOST_REQUIRE(sorted({a, b, c}, 0) == inet_address_vector_replica_set({a, b, c}));
+}
+
+SEASTAR_THREAD_TEST_CASE(test_endpoint_latency_quantile) {
+    using namespace std::chrono_literals;
+    service::endpoint_latency_scorer scorer;
+    auto a = gms::inet_address("127.0.0.1");
+
+    BOOST_REQUIRE(!scorer.latency_quantile(a, 0.99));
+    for (int i = 0; i < 100; ++i) {
+        scorer.request_started(a);
+        scorer.request_completed(a, i < 90 ? 1ms : 100ms);
+    }
+    auto p50 = scorer.latency_quantile(a, 0.5);
+    auto p95 = scorer.latency_quantile(a, 0.95);
+    BOOST_REQUIRE(p50 && p95);
+    BOOST_REQUIRE_LE(p50->count(), 1000);
+    BOOST_REQUIRE_GT(p95->count(), 50000);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_read_budget) {
+    service::read_budget budget;
+    unsigned spent = 0;
+    for (int i = 0; i < 1000; ++i) {
+        budget.read_started(0.25);
+        spent += budget.try_spend();
+    }
+    BOOST_REQUIRE_EQUAL(spent, 250);
+
+    // Unused credits are saved for bursts, up to a limit.
+    for (int i = 0; i < 100000; ++i) {
+        budget.read_started(0.05);
+    }
+    spent = 0;
+    while (budget.try_spend()) {
+        ++spent;
+    }
+    BOOST_REQUIRE_EQUAL(spent, 100);
+}
+
+SEASTAR_TEST_CASE(test_coordinator_read_coalescing) {
+    cql_test_config cfg;
+    cfg.db_config->coordinator_read_coalescing(true);
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("create table ks.t (k int primary key, v int)").get();
+        e.execute_cql("insert into ks.t (k, v) values (1, 1)").get();
+
+        auto read_all = [&] {
+            std::vector<future<shared_ptr<cql_transport::messages::result_message>>> reads;
+            for (int i = 0; i < 20; ++i) {
+                reads.push_back(e.execute_cql("select v from ks.t where k = 1"));
+            }
+            return when_all_succeed(reads.begin(), reads.end()).get();
+        };
+        for (auto& msg : read_all()) {
+            assert_that(msg).is_rows().with_rows({{int32_type->decompose(1)}});
+        }
+        BOOST_REQUIRE_GT(e.get_storage_proxy().local().get_stats().coalesced_reads, 0);
+
+        // Reads arriving after a write see it even though an earlier read is in flight.
+        auto before = e.execute_cql("select v from ks.t where k = 1");
+        e.execute_cql("update ks.t set v = 2 where k = 1").get();
+        auto after = e.execute_cql("select v from ks.t where k = 1");
+        before.get();
+        assert_that(after.get()).is_rows().with_rows({{int32_type->decompose(2)}});
+    }, std::move(cfg));
+}
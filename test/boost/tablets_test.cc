@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include "test/lib/scylla_test_case.hh"
+
+#include "locator/tablets.hh"
+#include "utils/UUID_gen.hh"
+#include "log.hh"
+
+extern logging::logger testlog;
+
+using namespace locator;
+
+SEASTAR_THREAD_TEST_CASE(test_tablet_token_ranges) {
+    BOOST_REQUIRE_THROW(tablet_map(0), std::invalid_argument);
+    BOOST_REQUIRE_THROW(tablet_map(3), std::invalid_argument);
+
+    {
+        tablet_map tmap(1);
+        BOOST_REQUIRE_EQUAL(tmap.get_tablet_id(dht::minimum_token()).value(), 0);
+        BOOST_REQUIRE_EQUAL(tmap.get_tablet_id(dht::maximum_token()).value(), 0);
+        BOOST_REQUIRE_EQUAL(tmap.get_tablet_id(dht::token::from_int64(0)).value(), 0);
+        BOOST_REQUIRE_EQUAL(tmap.get_last_token(tablet_id(0)), dht::token::from_int64(std::numeric_limits<int64_t>::max()));
+    }
+
+    tablet_map tmap(4);
+    BOOST_REQUIRE_EQUAL(tmap.tablet_count(), 4);
+    BOOST_REQUIRE_EQUAL(tmap.get_tablet_id(dht::minimum_token()).value(), 0);
+    BOOST_REQUIRE_EQUAL(tmap.get_tablet_id(dht::maximum_token()).value(), 3);
+    BOOST_REQUIRE_EQUAL(tmap.get_tablet_id(dht::token::from_int64(std::numeric_limits<int64_t>::min() + 1)).value(), 0);
+    BOOST_REQUIRE_EQUAL(tmap.get_tablet_id(dht::token::from_int64(-1)).value(), 1);
+    BOOST_REQUIRE_EQUAL(tmap.get_tablet_id(dht::token::from_int64(0)).value(), 2);
+    BOOST_REQUIRE_EQUAL(tmap.get_tablet_id(dht::token::from_int64(std::numeric_limits<int64_t>::max())).value(), 3);
+
+    BOOST_REQUIRE_EQUAL(tmap.get_last_token(tablet_id(1)), dht::token::from_int64(-1));
+    BOOST_REQUIRE_EQUAL(tmap.get_first_token(tablet_id(2)), dht::token::from_int64(0));
+
+    for (auto id : tmap.tablet_ids()) {
+        BOOST_REQUIRE(tmap.get_tablet_id(tmap.get_first_token(id)) == id);
+        BOOST_REQUIRE(tmap.get_tablet_id(tmap.get_last_token(id)) == id);
+        auto range = tmap.get_token_range(id);
+        BOOST_REQUIRE(range.contains(tmap.get_first_token(id), dht::token_comparator()));
+        BOOST_REQUIRE(range.contains(tmap.get_last_token(id), dht::token_comparator()));
+        if (id != 0) {
+            BOOST_REQUIRE(!range.contains(tmap.get_last_token(tablet_id(id - 1)), dht::token_comparator()));
+        }
+    }
+
+    BOOST_REQUIRE_THROW(tmap.get_tablet_info(tablet_id(4)), std::logic_error);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_tablet_split_and_merge) {
+    auto h1 = host_id::create_random_id();
+    auto h2 = host_id::create_random_id();
+    auto h3 = host_id::create_random_id();
+
+    tablet_map tmap(2);
+    tmap.set_tablet(tablet_id(0), tablet_info{{tablet_replica{h1, 0}, tablet_replica{h2, 1}}});
+    tmap.set_tablet(tablet_id(1), tablet_info{{tablet_replica{h2, 0}, tablet_replica{h3, 3}}});
+
+    auto split = tmap.split();
+    BOOST_REQUIRE_EQUAL(split.tablet_count(), 4);
+    for (auto id : split.tablet_ids()) {
+        BOOST_REQUIRE(split.get_tablet_info(id) == tmap.get_tablet_info(tablet_map::parent_of(id)));
+    }
+    BOOST_REQUIRE_EQUAL(split.get_last_token(tablet_id(1)), tmap.get_last_token(tablet_id(0)));
+    BOOST_REQUIRE_EQUAL(split.get_last_token(tablet_id(3)), tmap.get_last_token(tablet_id(1)));
+
+    BOOST_REQUIRE(split.can_merge());
+    BOOST_REQUIRE_EQUAL(split.merge(), tmap);
+
+    // Siblings must be co-located to be merged.
+    BOOST_REQUIRE(!tmap.can_merge());
+    BOOST_REQUIRE_THROW(tmap.merge(), std::runtime_error);
+    BOOST_REQUIRE(!tablet_map(1).can_merge());
+
+    split.set_tablet_transition_info(tablet_id(2),
+            migration_to_transition_info(split.get_tablet_info(tablet_id(2)), tablet_replica{h3, 3}, tablet_replica{h1, 2}));
+    BOOST_REQUIRE(!split.can_merge());
+    BOOST_REQUIRE_THROW(split.split(), std::runtime_error);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_tablet_migration) {
+    auto h1 = host_id::create_random_id();
+    auto h2 = host_id::create_random_id();
+    auto h3 = host_id::create_random_id();
+
+    tablet_map tmap(4);
+    for (auto id : tmap.tablet_ids()) {
+        tmap.set_tablet(id, tablet_info{{tablet_replica{h1, 0}, tablet_replica{h2, 0}}});
+    }
+    BOOST_REQUIRE_EQUAL(tmap.tablet_count_on(h1), 4);
+    BOOST_REQUIRE_EQUAL(tmap.tablet_count_on(h3), 0);
+
+    auto& info = tmap.get_tablet_info(tablet_id(1));
+    BOOST_REQUIRE_THROW(migration_to_transition_info(info, tablet_replica{h3, 0}, tablet_replica{h3, 1}), std::runtime_error);
+    BOOST_REQUIRE_THROW(migration_to_transition_info(info, tablet_replica{h1, 0}, tablet_replica{h2, 1}), std::runtime_error);
+
+    auto trinfo = migration_to_transition_info(info, tablet_replica{h1, 0}, tablet_replica{h3, 1});
+    BOOST_REQUIRE_EQUAL(trinfo.pending_replica, (tablet_replica{h3, 1}));
+    tmap.set_tablet_transition_info(tablet_id(1), trinfo);
+    BOOST_REQUIRE(tmap.get_tablet_transition_info(tablet_id(1)));
+    BOOST_REQUIRE(!tmap.get_tablet_transition_info(tablet_id(0)));
+    testlog.debug("tablets: {}", tmap);
+
+    tmap.finish_tablet_transition(tablet_id(1));
+    BOOST_REQUIRE(!tmap.get_tablet_transition_info(tablet_id(1)));
+    BOOST_REQUIRE(tmap.get_tablet_info(tablet_id(1)) == (tablet_info{{tablet_replica{h3, 1}, tablet_replica{h2, 0}}}));
+    BOOST_REQUIRE_EQUAL(tmap.tablet_count_on(h1), 3);
+    BOOST_REQUIRE_EQUAL(tmap.tablet_count_on(h3), 1);
+    BOOST_REQUIRE_THROW(tmap.finish_tablet_transition(tablet_id(1)), std::runtime_error);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_tablet_metadata) {
+    auto h1 = host_id::create_random_id();
+    auto table1 = table_id(utils::UUID_gen::get_time_UUID());
+    auto table2 = table_id(utils::UUID_gen::get_time_UUID());
+
+    tablet_metadata tm;
+    BOOST_REQUIRE(!tm.has_tablet_map(table1));
+    BOOST_REQUIRE_THROW(tm.get_tablet_map(table1), std::runtime_error);
+
+    tablet_map tmap(2);
+    tmap.set_tablet(tablet_id(0), tablet_info{{tablet_replica{h1, 0}}});
+    tm.set_tablet_map(table1, tmap);
+    tm.set_tablet_map(table2, tablet_map(8));
+
+    auto copy = tm;
+    BOOST_REQUIRE_EQUAL(copy, tm);
+    BOOST_REQUIRE_EQUAL(copy.get_tablet_map(table1), tmap);
+
+    copy.set_tablet_map(table1, tmap.split());
+    BOOST_REQUIRE_EQUAL(tm.get_tablet_map(table1), tmap);
+    BOOST_REQUIRE(copy != tm);
+
+    copy.drop_tablet_map(table2);
+    BOOST_REQUIRE(!copy.has_tablet_map(table2));
+    BOOST_REQUIRE(tm.has_tablet_map(table2));
+
+    tm.clear_gently().get();
+    BOOST_REQUIRE(tm.all_tables().empty());
+}
@@ -10,13 +10,15 @@
 
 #include "tracing/tracing.hh"
 #include "tracing/trace_state.hh"
+#include "tracing/ring_buffer_backend.hh"
 #include "utils/class_registrator.hh"
 
 #include "test/lib/cql_test_env.hh"
+#include "test/lib/cql_assertions.hh"
 
-future<> do_with_tracing_env(std::function<future<>(cql_test_env&)> func, cql_test_config cfg_in = {}) {
-    return do_with_cql_env_thread([func](auto &env) {
-        tracing::tracing::create_tracing("trace_keyspace_helper").get();
+future<> do_with_tracing_env(std::function<future<>(cql_test_env&)> func, cql_test_config cfg_in = {}, sstring backend = "trace_keyspace_helper") {
+    return do_with_cql_env_thread([func, backend](auto &env) {
+        tracing::tracing::create_tracing(backend).get();
 
         tracing::tracing::start_tracing(env.qp()).get();
 
@@ -87,3 +89,66 @@ SEASTAR_TEST_CASE(tracing_slow_query_fast_mode) {
         return make_ready_future<>();
     });
 }
+
+SEASTAR_TEST_CASE(tracing_ring_buffer_backend) {
+    return do_with_tracing_env([](cql_test_env& e) {
+        tracing::tracing &t = tracing::tracing::get_local_tracing_instance();
+        auto& backend = dynamic_cast<tracing::ring_buffer_backend&>(t.backend_helper());
+
+        tracing::trace_state_props_set trace_props;
+        trace_props.set(tracing::trace_state_props::full_tracing);
+
+        tracing::trace_state_ptr trace_state = t.create_session(tracing::trace_type::QUERY, trace_props);
+        auto session_id = trace_state->session_id();
+        tracing::begin(trace_state, "begin", gms::inet_address());
+        tracing::trace(trace_state, "trace 1");
+        tracing::trace(trace_state, "trace 2");
+        trace_state = nullptr;
+
+        t.write_pending_records();
+        BOOST_REQUIRE_EQUAL(backend.sessions().size(), 1);
+        auto& s = backend.sessions().front();
+        BOOST_REQUIRE_EQUAL(s.session_id, session_id);
+        BOOST_REQUIRE_EQUAL(s.request, "begin");
+        BOOST_REQUIRE_EQUAL(s.events.size(), 2);
+        BOOST_REQUIRE_EQUAL(s.events[1].message, "trace 2");
+
+        auto msg = e.execute_cql(format("SELECT activity FROM system.recent_traces WHERE session_id = {}", session_id)).get0();
+        assert_that(msg).is_rows().with_rows({
+            {utf8_type->decompose("trace 1")},
+            {utf8_type->decompose("trace 2")},
+        });
+
+        return make_ready_future<>();
+    }, {}, "ring_buffer_backend");
+}
+
+SEASTAR_TEST_CASE(tracing_stage_times) {
+    return do_with_tracing_env([](cql_test_env& e) {
+        tracing::tracing &t = tracing::tracing::get_local_tracing_instance();
+        auto& backend = dynamic_cast<tracing::ring_buffer_backend&>(t.backend_helper());
+
+        tracing::trace_state_props_set trace_props;
+        trace_props.set(tracing::trace_state_props::full_tracing);
+
+        tracing::trace_state_ptr trace_state = t.create_session(tracing::trace_type::QUERY, trace_props);
+        tracing::begin(trace_state, "begin", gms::inet_address());
+        tracing::add_stage_time(trace_state, tracing::latency_stage::queue, std::chrono::milliseconds(3));
+        tracing::add_stage_time(trace_state, tracing::latency_stage::sstable_io, std::chrono::microseconds(10));
+        tracing::add_stage_time(trace_state, tracing::latency_stage::sstable_io, std::chrono::microseconds(20));
+        {
+            tracing::stage_timer timer(trace_state, tracing::latency_stage::cache);
+        }
+        BOOST_REQUIRE(trace_state->stage_time(tracing::latency_stage::cache) >= tracing::elapsed_clock::duration::zero());
+        BOOST_REQUIRE(trace_state->stage_time(tracing::latency_stage::coordinator) == tracing::elapsed_clock::duration::zero());
+        trace_state = nullptr;
+
+        t.write_pending_records();
+        BOOST_REQUIRE_EQUAL(backend.sessions().size(), 1);
+        auto& params = backend.sessions().front().parameters;
+        BOOST_REQUIRE(params.contains("stages"));
+        BOOST_REQUIRE(params.at("stages").starts_with("queue=3000us, sstable_io=30us"));
+
+        return make_ready_future<>();
+    }, {}, "ring_buffer_backend");
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#define BOOST_TEST_MODULE core
+
+#include <boost/test/unit_test.hpp>
+#include "utils/two_choice_cache.hh"
+#include <string>
+
+using namespace utils;
+
+template <typename Cache>
+static const std::string* find(const Cache& c, uint64_t hash, int key) {
+    auto e = c.find(hash, [key] (int k) { return k == key; });
+    return e ? &e->value : nullptr;
+}
+
+template <typename Cache>
+static void insert(Cache& c, uint64_t hash, int key, std::string value) {
+    c.insert(hash, [key] (int k) { return k == key; }, key, std::move(value));
+}
+
+BOOST_AUTO_TEST_CASE(test_insert_find_erase) {
+    two_choice_cache<int, std::string> c(5);
+    BOOST_REQUIRE(c.enabled());
+    BOOST_REQUIRE(!find(c, 1, 1));
+
+    insert(c, 1, 1, "a");
+    insert(c, 2, 2, "b");
+    BOOST_REQUIRE_EQUAL(c.size(), 2);
+    BOOST_REQUIRE_EQUAL(*find(c, 1, 1), "a");
+    BOOST_REQUIRE_EQUAL(*find(c, 2, 2), "b");
+    // The hash selects the slots, the predicate the entry.
+    BOOST_REQUIRE(!find(c, 1, 2));
+
+    insert(c, 1, 1, "c");
+    BOOST_REQUIRE_EQUAL(c.size(), 2);
+    BOOST_REQUIRE_EQUAL(*find(c, 1, 1), "c");
+
+    c.erase(1, [] (int) { return true; });
+    BOOST_REQUIRE_EQUAL(c.size(), 1);
+    BOOST_REQUIRE(!find(c, 1, 1));
+    BOOST_REQUIRE_EQUAL(*find(c, 2, 2), "b");
+
+    c.erase_if([] (const auto& e) { return e.key == 2; });
+    BOOST_REQUIRE_EQUAL(c.size(), 0);
+
+    insert(c, 3, 3, "d");
+    c.clear();
+    BOOST_REQUIRE_EQUAL(c.size(), 0);
+    BOOST_REQUIRE(!find(c, 3, 3));
+}
+
+BOOST_AUTO_TEST_CASE(test_disabled) {
+    two_choice_cache<int, std::string> c(0);
+    BOOST_REQUIRE(!c.enabled());
+    insert(c, 1, 1, "a");
+    BOOST_REQUIRE_EQUAL(c.size(), 0);
+    BOOST_REQUIRE(!find(c, 1, 1));
+}
+
+BOOST_AUTO_TEST_CASE(test_replaces_oldest_insert) {
+    two_choice_cache<int, std::string> c(1024);
+    // Keys with the same hash compete for the same two slots.
+    insert(c, 7, 1, "a");
+    insert(c, 7, 2, "b");
+    BOOST_REQUIRE_EQUAL(c.size(), 2);
+    // Finding an entry doesn't protect it.
+    BOOST_REQUIRE(c.find(7, [] (int k) { return k == 1; }));
+    insert(c, 7, 3, "c");
+    BOOST_REQUIRE_EQUAL(c.size(), 2);
+    BOOST_REQUIRE(!find(c, 7, 1));
+    BOOST_REQUIRE_EQUAL(*find(c, 7, 2), "b");
+    BOOST_REQUIRE_EQUAL(*find(c, 7, 3), "c");
+}
+
+BOOST_AUTO_TEST_CASE(test_replaces_least_recently_used) {
+    two_choice_cache<int, std::string, two_choice_replacement::least_recently_used> c(1024);
+    insert(c, 7, 1, "a");
+    insert(c, 7, 2, "b");
+    BOOST_REQUIRE(c.find(7, [] (int k) { return k == 1; }));
+    insert(c, 7, 3, "c");
+    BOOST_REQUIRE_EQUAL(c.size(), 2);
+    BOOST_REQUIRE_EQUAL(*find(c, 7, 1), "a");
+    BOOST_REQUIRE(!find(c, 7, 2));
+    BOOST_REQUIRE_EQUAL(*find(c, 7, 3), "c");
+}
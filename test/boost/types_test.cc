@@ -393,6 +393,34 @@ BOOST_AUTO_TEST_CASE(test_float_types_to_string) {
     test_float_type_to_string<double>(double_type);
 }
 
+BOOST_AUTO_TEST_CASE(test_clustering_types_compare) {
+    auto require_ordered = [] (data_type t, std::vector<data_value> values) {
+        for (size_t i = 0; i < values.size(); ++i) {
+            for (size_t j = 0; j < values.size(); ++j) {
+                auto v1 = values[i].serialize_nonnull();
+                auto v2 = values[j].serialize_nonnull();
+                BOOST_REQUIRE(t->compare(v1, v2) == (i <=> j));
+                BOOST_REQUIRE(t->compare(managed_bytes(v1), managed_bytes(v2)) == (i <=> j));
+            }
+        }
+        // Empty values sort first.
+        auto v = values.front().serialize_nonnull();
+        BOOST_REQUIRE(t->compare(bytes(), v) < 0);
+        BOOST_REQUIRE(t->compare(v, bytes()) > 0);
+        BOOST_REQUIRE(t->compare(bytes(), bytes()) == 0);
+    };
+    require_ordered(int32_type, {int32_t(-1000), int32_t(-1), int32_t(0), int32_t(1), int32_t(1000)});
+    require_ordered(long_type, {int64_t(-1000), int64_t(-1), int64_t(0), int64_t(1), int64_t(1) << 40});
+    require_ordered(timestamp_type, {db_clock::time_point(db_clock::duration(-1)), db_clock::time_point(db_clock::duration(0)), db_clock::time_point(db_clock::duration(1000))});
+    require_ordered(utf8_type, {sstring("a"), sstring("aa"), sstring("b")});
+    require_ordered(bytes_type, {to_bytes("a"), to_bytes("aa"), to_bytes("\xff")});
+    require_ordered(reversed_type_impl::get_instance(int32_type), {int32_t(1), int32_t(0), int32_t(-1)});
+    require_ordered(timeuuid_type, {
+        timeuuid_native_type{utils::UUID_gen::get_time_UUID(std::chrono::milliseconds(1000))},
+        timeuuid_native_type{utils::UUID_gen::get_time_UUID(std::chrono::milliseconds(2000))},
+    });
+}
+
 BOOST_AUTO_TEST_CASE(test_duration_type_compare) {
     duration_type->equal(duration_type->from_string("3d5m"), duration_type->from_string("3d5m"));
 }
@@ -440,6 +468,21 @@ BOOST_AUTO_TEST_CASE(test_varint) {
 
     BOOST_REQUIRE_EQUAL(from_hex("80000000"), varint_type->decompose(utils::multiprecision_int(-2147483648)));
 
+    // Values fitting in 64 bits are (de)serialized natively, the others through cpp_int.
+    for (auto [hex, value] : std::initializer_list<std::pair<const char*, const char*>>{
+            {"7fffffffffffffff", "9223372036854775807"},
+            {"8000000000000000", "-9223372036854775808"},
+            {"008000000000000000", "9223372036854775808"},
+            {"ff7fffffffffffffff", "-9223372036854775809"},
+            {"0080", "128"},
+            {"ff7f", "-129"},
+            {"80", "-128"},
+            {"7f", "127"},
+    }) {
+        BOOST_REQUIRE_EQUAL(from_hex(hex), varint_type->decompose(utils::multiprecision_int(value)));
+        BOOST_CHECK_EQUAL(value_cast<utils::multiprecision_int>(varint_type->deserialize(from_hex(hex))), utils::multiprecision_int(value));
+    }
+
     test_parsing_fails(varint_type, "1A");
 }
 
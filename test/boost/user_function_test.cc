@@ -894,6 +894,26 @@ SEASTAR_TEST_CASE(test_user_function_lua_error) {
     });
 }
 
+SEASTAR_TEST_CASE(test_user_function_reused_state) {
+    return with_udf_enabled([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE my_table (key int PRIMARY KEY, i int, b bigint, d double, t text);").get();
+        for (int i = 0; i < 10; ++i) {
+            e.execute_cql(format("INSERT INTO my_table (key, i, b, d, t) VALUES ({}, {}, {}, {}, 'x{}');", i, -i, int64_t(1) << (40 + i), i + 0.5, i)).get();
+        }
+        // The states are reused between calls, but not the globals set by the calls.
+        e.execute_cql("CREATE FUNCTION my_func(i int, b bigint, d double, t text) RETURNS NULL ON NULL INPUT RETURNS text LANGUAGE Lua AS "
+                "'calls = (calls or 0) + 1 return string.format(\"%d %d %d %.1f %s\", calls, i, b, d, t)';").get();
+        auto res = e.execute_cql("SELECT my_func(i, b, d, t) FROM my_table WHERE key = 3;").get0();
+        assert_that(res).is_rows().with_rows({{serialized(format("1 -3 {} 3.5 x3", int64_t(1) << 43))}});
+        res = e.execute_cql("SELECT my_func(i, b, d, t) FROM my_table;").get0();
+        std::vector<std::vector<bytes_opt>> expected;
+        for (int i = 0; i < 10; ++i) {
+            expected.push_back({serialized(format("1 {} {} {}.5 x{}", -i, int64_t(1) << (40 + i), i, i))});
+        }
+        assert_that(res).is_rows().with_rows_ignore_order(expected);
+    });
+}
+
 SEASTAR_TEST_CASE(test_user_function_timeout) {
     return with_udf_enabled([] (cql_test_env& e) {
         e.execute_cql("CREATE TABLE my_table (key text PRIMARY KEY, val int);").get();
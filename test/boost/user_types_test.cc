@@ -625,3 +625,31 @@ SEASTAR_TEST_CASE(test_user_type_quoted) {
         // Pass if the above CREATE TABLE completes without an exception.
     });
 }
+
+SEASTAR_TEST_CASE(test_user_type_field_selection) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("create type inner_t (x int, y text);").get();
+        e.execute_cql("create type outer_t (a int, b frozen<inner_t>, c text);").get();
+        e.execute_cql("create table cf (pk int, ck int, v frozen<outer_t>, primary key (pk, ck));").get();
+        e.execute_cql("insert into cf (pk, ck, v) values (1, 1, {a: 1, b: {x: 10, y: 'ten'}, c: 'one'});").get();
+        e.execute_cql("insert into cf (pk, ck, v) values (1, 2, {a: 2, c: 'two'});").get();
+        e.execute_cql("insert into cf (pk, ck) values (1, 3);").get();
+
+        before_and_after_flush(e, [&] {
+            assert_that(e.execute_cql("select v.a, v.c, v.b.x, v.b.y from cf where pk = 1;").get0())
+                .is_rows()
+                .with_rows({
+                    {int32_type->decompose(1), utf8_type->decompose("one"), int32_type->decompose(10), utf8_type->decompose("ten")},
+                    {int32_type->decompose(2), utf8_type->decompose("two"), std::nullopt, std::nullopt},
+                    {std::nullopt, std::nullopt, std::nullopt, std::nullopt},
+                });
+
+            // Only the first row of each group is selected.
+            assert_that(e.execute_cql("select v.a, v.b.y from cf where pk = 1 group by pk;").get0())
+                .is_rows()
+                .with_rows({
+                    {int32_type->decompose(1), utf8_type->decompose("ten")},
+                });
+        });
+    });
+}
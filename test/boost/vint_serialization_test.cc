@@ -137,3 +137,33 @@ BOOST_AUTO_TEST_CASE(sanity_signed_examples) {
 BOOST_AUTO_TEST_CASE(sanity_signed_sweep) {
     check_roundtrip_sweep<signed_vint>(100'000, random_engine());
 }
+
+BOOST_AUTO_TEST_CASE(unsigned_batch_sweep) {
+    auto& rng = random_engine();
+    std::uniform_int_distribution<unsigned> bits(0, 64);
+    std::uniform_int_distribution<uint64_t> values;
+
+    for (int iteration = 0; iteration < 1000; ++iteration) {
+        std::vector<uint64_t> expected(17);
+        for (auto& v : expected) {
+            auto nr_bits = bits(rng);
+            v = nr_bits ? values(rng) >> (64 - nr_bits) : 0;
+        }
+        bytes serialized(bytes::initialized_later{}, expected.size() * max_vint_length);
+        size_t size = 0;
+        for (auto v : expected) {
+            size += unsigned_vint::serialize(v, serialized.begin() + size);
+        }
+
+        std::vector<uint64_t> decoded(expected.size());
+        BOOST_REQUIRE_EQUAL(unsigned_vint::deserialize_batch(bytes_view(serialized.data(), size), decoded), size);
+        BOOST_REQUIRE(decoded == expected);
+
+        // Trailing bytes are left alone.
+        BOOST_REQUIRE_EQUAL(unsigned_vint::deserialize_batch(bytes_view(serialized), decoded), size);
+        BOOST_REQUIRE(decoded == expected);
+
+        // A truncated run isn't decoded.
+        BOOST_REQUIRE_EQUAL(unsigned_vint::deserialize_batch(bytes_view(serialized.data(), size - 1), decoded), 0);
+    }
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <boost/test/unit_test.hpp>
+#include "test/lib/scylla_test_case.hh"
+#include <seastar/testing/thread_test_case.hh>
+
+#include "message/zstd_rpc_compressor.hh"
+#include "test/lib/random_utils.hh"
+
+using namespace seastar;
+
+static std::vector<temporary_buffer<char>> fragments_of(std::variant<std::vector<temporary_buffer<char>>, temporary_buffer<char>> bufs) {
+    if (auto* buf = std::get_if<temporary_buffer<char>>(&bufs)) {
+        std::vector<temporary_buffer<char>> ret;
+        ret.push_back(std::move(*buf));
+        return ret;
+    }
+    return std::move(std::get<std::vector<temporary_buffer<char>>>(bufs));
+}
+
+static sstring linearize(std::variant<std::vector<temporary_buffer<char>>, temporary_buffer<char>> bufs) {
+    sstring ret;
+    for (auto& frag : fragments_of(std::move(bufs))) {
+        ret += sstring(frag.get(), frag.size());
+    }
+    return ret;
+}
+
+// Splits msg into fragments of up to fragment_size bytes.
+static rpc::snd_buf make_snd_buf(const sstring& msg, size_t fragment_size) {
+    rpc::snd_buf ret(msg.size());
+    std::vector<temporary_buffer<char>> frags;
+    for (size_t pos = 0; pos < msg.size(); pos += fragment_size) {
+        frags.emplace_back(msg.data() + pos, std::min(fragment_size, msg.size() - pos));
+    }
+    ret.bufs = std::move(frags);
+    return ret;
+}
+
+SEASTAR_THREAD_TEST_CASE(test_zstd_rpc_compressor_round_trip) {
+    netw::zstd_rpc_compressor_factory factory;
+    BOOST_REQUIRE(!factory.negotiate("LZ4", false));
+    auto client = factory.negotiate(factory.supported(), false);
+    auto server = factory.negotiate(factory.supported(), true);
+    BOOST_REQUIRE(client && server);
+
+    const size_t head_space = 11;
+    auto payload = tests::random::get_sstring(1000);
+    std::vector<sstring> msgs = {
+        payload,
+        "",
+        payload,
+        tests::random::get_sstring(3 * rpc::snd_buf::chunk_size),
+        payload + payload,
+        payload,
+    };
+    std::vector<size_t> compressed_sizes;
+    for (auto& msg : msgs) {
+        auto compressed = client->compress(head_space, make_snd_buf(msg, 4096));
+        compressed_sizes.push_back(compressed.size);
+        // Seastar fills the head space and strips it before decompressing.
+        auto frags = fragments_of(std::move(compressed.bufs));
+        BOOST_REQUIRE_GE(frags.front().size(), head_space);
+        frags.front().trim_front(head_space);
+        // Fragmented differently on the way in.
+        auto data = linearize(std::move(frags));
+        rpc::rcv_buf received(data.size());
+        std::vector<temporary_buffer<char>> received_frags;
+        for (size_t pos = 0; pos < data.size(); pos += 7) {
+            received_frags.emplace_back(data.data() + pos, std::min<size_t>(7, data.size() - pos));
+        }
+        received.bufs = std::move(received_frags);
+
+        auto decompressed = server->decompress(std::move(received));
+        BOOST_REQUIRE_EQUAL(decompressed.size, msg.size());
+        BOOST_REQUIRE(linearize(std::move(decompressed.bufs)) == msg);
+    }
+    // Repeated messages refer back to the first one.
+    BOOST_REQUIRE_LT(compressed_sizes[2], compressed_sizes[0] / 4);
+    BOOST_REQUIRE_LT(compressed_sizes[5], compressed_sizes[0] / 4);
+}
@@ -264,6 +264,39 @@ def test_scylla_sstable_write(cql, test_keyspace, scylla_path, scylla_data_dir,
             assert actual_json == original_json
 
 
+def test_scylla_sstable_query_token_range(cql, test_keyspace, scylla_path, scylla_data_dir):
+    with scylla_sstable(simple_no_clustering_table, cql, test_keyspace, scylla_data_dir) as (schema_file, sstables):
+        common_args = ["--schema-file", schema_file, "--output-format", "json", "--merge"]
+
+        full_out = subprocess.check_output([scylla_path, "sstable", "dump-data"] + common_args + sstables)
+        partitions = json.loads(full_out)["sstables"]["anonymous"]
+        tokens = [int(p["key"]["token"]) for p in partitions]
+        start_token, end_token = tokens[2], tokens[-3]
+
+        query_out = subprocess.check_output([scylla_path, "sstable", "query", f"--start-token={start_token}", f"--end-token={end_token}"] + common_args + sstables)
+
+    expected = [p for p, t in zip(partitions, tokens) if start_token <= t <= end_token]
+    assert json.loads(query_out)["sstables"]["anonymous"] == expected
+
+
+def test_scylla_sstable_dump_data_parallel(cql, test_keyspace, scylla_path, scylla_data_dir):
+    with scylla_sstable(simple_clustering_table, cql, test_keyspace, scylla_data_dir) as (schema_file, sstables):
+        common_args = ["--schema-file", schema_file, "--output-format", "json", "--merge"]
+
+        full_out = subprocess.check_output([scylla_path, "sstable", "dump-data"] + common_args + sstables)
+
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            subprocess.check_call([scylla_path, "sstable", "dump-data", "--smp", "2", "--parallel", "--output-dir", tmp_dir] + common_args + sstables)
+
+            partitions = []
+            for shard in range(0, 2):
+                with open(os.path.join(tmp_dir, f"shard-{shard}.json"), "r") as f:
+                    partitions += json.load(f)["sstables"]["anonymous"]
+
+    # The shards read consecutive parts of the token range.
+    assert partitions == json.loads(full_out)["sstables"]["anonymous"]
+
+
 def script_consume_test_table_factory(cql, keyspace):
     table = util.unique_name()
     schema = f"CREATE TABLE {keyspace}.{table} (pk int, ck int, v int, s int STATIC, PRIMARY KEY (pk, ck)) WITH compaction = {{'class': 'NullCompactionStrategy'}}"
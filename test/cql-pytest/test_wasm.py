@@ -152,6 +152,43 @@ def test_fib_called_on_null(cql, test_keyspace, table1, scylla_with_wasm_only):
         with pytest.raises(InvalidRequest, match="wasm"):
           cql.execute(f"SELECT {test_keyspace}.{fib_name}(p) AS result FROM {table} WHERE p = 997")
 
+# Test that a function evaluated over many rows of a page, which happens in
+# batches, returns each row's own result, next to the other selected columns,
+# and null for the rows with null input.
+def test_fib_many_rows(cql, test_keyspace, scylla_with_wasm_only):
+    fib_name = unique_name()
+    fib_source = f"""
+(module
+  (func ${fib_name} (param $n i64) (result i64)
+    (if
+      (i64.lt_s (local.get $n) (i64.const 2))
+      (return (local.get $n))
+    )
+    (i64.add
+      (call ${fib_name} (i64.sub (local.get $n) (i64.const 1)))
+      (call ${fib_name} (i64.sub (local.get $n) (i64.const 2)))
+    )
+  )
+  (memory (;0;) 17)
+  (export "memory" (memory 0))
+  (export "{fib_name}" (func ${fib_name}))
+)
+"""
+    src = f"(input bigint) RETURNS NULL ON NULL INPUT RETURNS bigint LANGUAGE wasm AS '{fib_source}'"
+    fib = [0, 1]
+    while len(fib) < 20:
+        fib.append(fib[-1] + fib[-2])
+    with new_test_table(cql, test_keyspace, "p int, c int, v bigint, PRIMARY KEY (p, c)") as table, \
+            new_function(cql, test_keyspace, src, fib_name):
+        for c in range(20):
+            if c % 3 == 0:
+                cql.execute(f"INSERT INTO {table} (p, c) VALUES (0, {c})")
+            else:
+                cql.execute(f"INSERT INTO {table} (p, c, v) VALUES (0, {c}, {c})")
+        res = list(cql.execute(f"SELECT c, {test_keyspace}.{fib_name}(v) AS result, v FROM {table} WHERE p = 0"))
+        assert [(r.c, r.result, r.v) for r in res] == \
+            [(c, None, None) if c % 3 == 0 else (c, fib[c], c) for c in range(20)]
+
 # Test that an infinite loop gets broken out of eventually
 def test_infinite_loop(cql, test_keyspace, table1, scylla_with_wasm_only):
     table = table1
@@ -12,6 +12,7 @@
 #include <seastar/core/coroutine.hh>
 
 #include "service/storage_proxy.hh"
+#include "message/messaging_service.hh"
 
 future<> alternator_test_env::start(std::string_view isolation_level) {
     smp_service_group_config c;
@@ -29,7 +30,9 @@ future<> alternator_test_env::start(std::string_view isolation_level) {
             std::ref(_sdks),
             std::ref(_cdc_metadata),
             // end-of-streams-parameters
-            ssg);
+            ssg,
+            std::ref(_ms));
+    co_await _executor.invoke_on_all(&alternator::executor::start);
     try {
         alternator::rmw_operation::set_default_write_isolation(isolation_level);
     } catch (const std::runtime_error& e) {
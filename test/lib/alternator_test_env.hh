@@ -28,6 +28,10 @@ namespace gms {
 class gossiper;
 }
 
+namespace netw {
+class messaging_service;
+}
+
 // Test environment for alternator frontend.
 // The interface is minimal and does not cover alternator streams,
 // because this environment has limited use as well - microbenchmarks.
@@ -43,6 +47,7 @@ class alternator_test_env {
     sharded<service::storage_proxy>& _proxy;
     sharded<service::migration_manager>& _mm;
     sharded<cql3::query_processor>& _qp;
+    sharded<netw::messaging_service>& _ms;
 
     // Dummy service, only needed for alternator streams
     sharded<db::system_distributed_keyspace> _sdks;
@@ -55,11 +60,13 @@ class alternator_test_env {
             sharded<gms::gossiper>& gossiper,
             sharded<service::storage_proxy>& proxy,
             sharded<service::migration_manager>& mm,
-            sharded<cql3::query_processor>& qp)
+            sharded<cql3::query_processor>& qp,
+            sharded<netw::messaging_service>& ms)
         : _gossiper(gossiper)
         , _proxy(proxy)
         , _mm(mm)
         , _qp(qp)
+        , _ms(ms)
     {}
 
     future<> start(std::string_view isolation_level);
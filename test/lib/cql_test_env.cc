@@ -107,6 +107,7 @@ cql_test_config::cql_test_config(shared_ptr<db::config> cfg)
 
     db_config->add_cdc_extension();
     db_config->add_per_partition_rate_limit_extension();
+    db_config->add_sstable_filter_type_extension();
 
     db_config->flush_schema_tables_after_modification.set(false);
     db_config->commitlog_use_o_dsync(false);
@@ -143,6 +144,7 @@ class single_node_cql_env : public cql_test_env {
     service::raft_group0_client& _group0_client;
     sharded<service::raft_group_registry>& _group0_registry;
     sharded<db::system_keyspace>& _sys_ks;
+    sharded<netw::messaging_service>& _ms;
 
 private:
     struct core_local_state {
@@ -197,7 +199,8 @@ class single_node_cql_env : public cql_test_env {
             sharded<gms::gossiper>& gossiper,
             service::raft_group0_client& client,
             sharded<service::raft_group_registry>& group0_registry,
-            sharded<db::system_keyspace>& sys_ks)
+            sharded<db::system_keyspace>& sys_ks,
+            sharded<netw::messaging_service>& ms)
             : _db(db)
             , _proxy(proxy)
             , _qp(qp)
@@ -212,6 +215,7 @@ class single_node_cql_env : public cql_test_env {
             , _group0_client(client)
             , _group0_registry(group0_registry)
             , _sys_ks(sys_ks)
+            , _ms(ms)
     {
         adjust_rlimit();
     }
@@ -443,6 +447,10 @@ class single_node_cql_env : public cql_test_env {
         return _proxy;
     }
 
+    virtual sharded<netw::messaging_service>& get_messaging_service() override {
+        return _ms;
+    }
+
     virtual future<> refresh_client_state() override {
         return _core_local.invoke_on_all([] (core_local_state& state) {
             return state.client_state.maybe_update_per_service_level_params();
@@ -728,6 +736,9 @@ class single_node_cql_env : public cql_test_env {
                     .available_memory = dbcfg.available_memory,
                     .static_shares = cfg->compaction_static_shares,
                     .throughput_mb_per_sec = cfg->compaction_throughput_mb_per_sec,
+                    .major_compaction_parallelism = cfg->major_compaction_parallelism,
+                    .backlog_forecast_horizon_in_ms = cfg->compaction_backlog_forecast_horizon_in_ms,
+                    .max_concurrent_compactions_per_keyspace = cfg->max_concurrent_compactions_per_keyspace,
                 };
             });
             cm.start(std::move(get_cm_cfg), std::ref(abort_sources), std::ref(task_manager)).get();
@@ -771,7 +782,7 @@ class single_node_cql_env : public cql_test_env {
             if (cfg_in.qp_mcfg) {
                 qp_mcfg = *cfg_in.qp_mcfg;
             } else {
-                qp_mcfg = {memory::stats().total_memory() / 256, memory::stats().total_memory() / 2560};
+                qp_mcfg = {memory::stats().total_memory() / 256, memory::stats().total_memory() / 2560, memory::stats().total_memory() / 2560};
             }
             auto local_data_dict = seastar::sharded_parameter([] (const replica::database& db) { return db.as_data_dictionary(); }, std::ref(db));
 
@@ -958,7 +969,7 @@ class single_node_cql_env : public cql_test_env {
 
             notify_set.notify_all(configurable::system_state::started).get();
 
-            single_node_cql_env env(db, proxy, qp, auth_service, view_builder, view_update_generator, mm_notif, mm, std::ref(sl_controller), bm, gossiper, group0_client, raft_gr, sys_ks);
+            single_node_cql_env env(db, proxy, qp, auth_service, view_builder, view_update_generator, mm_notif, mm, std::ref(sl_controller), bm, gossiper, group0_client, raft_gr, sys_ks, ms);
             env.start().get();
             auto stop_env = defer([&env] { env.stop().get(); });
 
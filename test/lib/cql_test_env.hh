@@ -34,6 +34,10 @@ namespace db {
 class batchlog_manager;
 }
 
+namespace netw {
+class messaging_service;
+}
+
 namespace db::view {
 class view_builder;
 class view_update_generator;
@@ -178,6 +182,8 @@ class cql_test_env {
 
     virtual sharded<service::storage_proxy>& get_storage_proxy() = 0;
 
+    virtual sharded<netw::messaging_service>& get_messaging_service() = 0;
+
     data_dictionary::database data_dictionary();
 };
 
@@ -97,6 +97,12 @@ class table_for_tests::table_state : public compaction::table_state {
     sstables::shared_sstable make_sstable() const override {
         return table().make_sstable();
     }
+    bool has_cold_storage() const noexcept override {
+        return table().has_cold_storage();
+    }
+    sstables::shared_sstable make_cold_sstable() const override {
+        return table().make_cold_sstable();
+    }
     sstables::sstable_writer_config configure_writer(sstring origin) const override {
         return _sstables_manager.configure_writer(std::move(origin));
     }
@@ -118,7 +124,8 @@ class table_for_tests::table_state : public compaction::table_state {
     }
 };
 
-table_for_tests::table_for_tests(sstables::sstables_manager& sstables_manager, schema_ptr s, std::optional<sstring> datadir)
+table_for_tests::table_for_tests(sstables::sstables_manager& sstables_manager, schema_ptr s, std::optional<sstring> datadir,
+        lw_shared_ptr<const replica::storage_options> cold_storage_opts)
     : _data(make_lw_shared<data>())
 {
     _data->s = s ? s : make_default_schema();
@@ -127,6 +134,7 @@ table_for_tests::table_for_tests(sstables::sstables_manager& sstables_manager, s
     _data->cfg.datadir = datadir.value_or(sstring());
     _data->cfg.cf_stats = &_data->cf_stats;
     _data->cfg.enable_commitlog = false;
+    _data->cfg.cold_storage_opts = std::move(cold_storage_opts);
     _data->cm.enable();
     _data->cf = make_lw_shared<replica::column_family>(_data->s, _data->cfg, make_lw_shared<replica::storage_options>(), replica::column_family::no_commitlog(), _data->cm, sstables_manager, _data->cl_stats, _data->tracker);
     _data->cf->mark_ready_for_writes();
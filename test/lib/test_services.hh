@@ -56,7 +56,8 @@ struct table_for_tests {
 
     explicit table_for_tests(sstables::sstables_manager& sstables_manager);
 
-    explicit table_for_tests(sstables::sstables_manager& sstables_manager, schema_ptr s, std::optional<sstring> datadir = {});
+    explicit table_for_tests(sstables::sstables_manager& sstables_manager, schema_ptr s, std::optional<sstring> datadir = {},
+            lw_shared_ptr<const replica::storage_options> cold_storage_opts = {});
 
     schema_ptr schema() { return _data->s; }
 
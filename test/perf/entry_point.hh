@@ -8,9 +8,12 @@
 
 namespace perf {
 
+int scylla_compaction_main(int argc, char** argv);
 int scylla_fast_forward_main(int argc, char** argv);
 int scylla_row_cache_update_main(int argc, char**argv);
+int scylla_schema_merge_main(int argc, char** argv);
 int scylla_simple_query_main(int argc, char** argv);
 int scylla_sstable_main(int argc, char** argv);
+int scylla_workload_main(int argc, char** argv);
 
 } // namespace tools
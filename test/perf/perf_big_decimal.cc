@@ -36,3 +36,39 @@ PERF_TEST_F(big_decimal_test, from_string) {
     perf_tests::do_not_optimize(big_decimal{neg_data_fraction_neg_exponent});
 }
 
+
+struct big_decimal_sum_test {
+    // Typical amounts, with mixed scales so that the sum needs rescaling.
+    std::vector<big_decimal> values = [] {
+        std::vector<big_decimal> ret;
+        for (int i = 0; i < 100; ++i) {
+            ret.emplace_back(sstring(make_random_numeric_string(7) + "." + make_random_numeric_string(1 + i % 4)));
+        }
+        return ret;
+    }();
+    std::vector<big_decimal> large_values = [] {
+        std::vector<big_decimal> ret;
+        for (int i = 0; i < 100; ++i) {
+            ret.emplace_back(sstring(make_random_numeric_string(30) + "." + make_random_numeric_string(1 + i % 4)));
+        }
+        return ret;
+    }();
+};
+
+PERF_TEST_F(big_decimal_sum_test, sum) {
+    big_decimal sum;
+    for (auto& v : values) {
+        sum += v;
+    }
+    perf_tests::do_not_optimize(sum);
+    return values.size();
+}
+
+PERF_TEST_F(big_decimal_sum_test, sum_large) {
+    big_decimal sum;
+    for (auto& v : large_values) {
+        sum += v;
+    }
+    perf_tests::do_not_optimize(sum);
+    return large_values.size();
+}
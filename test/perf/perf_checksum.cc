@@ -53,3 +53,44 @@ PERF_TEST_F(crc_test, perf_zlib_crc32_checksum) {
     perf_tests::do_not_optimize(
         zlib_crc32_checksummer::checksum(data.data(), data.size()));
 }
+
+// The checksums of the sstable data paths: the per-chunk checksum of a
+// compressed chunk, verified by every read, and the full file digest built
+// from the chunk checksums, verified by validate-checksums.
+struct chunk_crc_test {
+    static constexpr size_t chunk_size = 4 * 1024;
+    static constexpr size_t chunks = 256;
+    const sstring data = make_random_string(chunk_size * chunks);
+    std::vector<uint32_t> chunk_checksums;
+
+    chunk_crc_test() {
+        for (size_t i = 0; i < chunks; ++i) {
+            chunk_checksums.push_back(crc32_utils::checksum(data.data() + i * chunk_size, chunk_size));
+        }
+    }
+};
+
+PERF_TEST_F(chunk_crc_test, perf_crc32_chunk_checksum) {
+    for (size_t i = 0; i < chunks; ++i) {
+        perf_tests::do_not_optimize(crc32_utils::checksum(data.data() + i * chunk_size, chunk_size));
+    }
+    return chunks;
+}
+
+PERF_TEST_F(chunk_crc_test, perf_crc32_digest_by_combining) {
+    uint32_t digest = crc32_utils::init_checksum();
+    for (size_t i = 0; i < chunks; ++i) {
+        digest = crc32_utils::checksum_combine(digest, chunk_checksums[i], chunk_size);
+    }
+    perf_tests::do_not_optimize(digest);
+    return chunks;
+}
+
+PERF_TEST_F(chunk_crc_test, perf_crc32_digest_by_feeding) {
+    uint32_t digest = crc32_utils::init_checksum();
+    for (size_t i = 0; i < chunks; ++i) {
+        digest = crc32_utils::checksum(digest, data.data() + i * chunk_size, chunk_size);
+    }
+    perf_tests::do_not_optimize(digest);
+    return chunks;
+}
@@ -0,0 +1,318 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/core/app-template.hh>
+#include <seastar/core/reactor.hh>
+#include <seastar/core/sstring.hh>
+#include <seastar/core/thread.hh>
+#include <seastar/util/closeable.hh>
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/classification.hpp>
+#include <random>
+
+#include "compaction/compaction_strategy.hh"
+#include "compaction/strategy_control.hh"
+#include "compaction/table_state.hh"
+#include "counters.hh"
+#include "types/map.hh"
+#include "test/lib/key_utils.hh"
+#include "test/lib/random_utils.hh"
+#include "test/lib/sstable_utils.hh"
+#include "test/lib/test_services.hh"
+#include "test/perf/perf.hh"
+
+using namespace sstables;
+
+namespace {
+
+enum class value_kind {
+    regular,
+    counter,
+    collection,
+};
+
+enum class size_distribution {
+    fixed,
+    uniform,
+    exponential,
+};
+
+struct conf {
+    unsigned sstables;
+    unsigned partitions;
+    // Fraction of the partitions of each sstable which are found in all the others.
+    double overlap;
+    // Fraction of the rows written as row tombstones.
+    double tombstones;
+    // Mean number of rows per partition, picked according to rows_distribution.
+    unsigned rows;
+    size_distribution rows_distribution;
+    value_kind kind;
+    unsigned value_size;
+    // Number of cells of each collection.
+    unsigned cells;
+    int32_t gc_grace_seconds;
+    bool major;
+};
+
+class no_ongoing_compaction : public compaction::strategy_control {
+public:
+    bool has_ongoing_compaction(compaction::table_state& table_s) const noexcept override {
+        return false;
+    }
+};
+
+schema_ptr make_schema(const conf& cfg, compaction_strategy_type type) {
+    data_type value_type = bytes_type;
+    switch (cfg.kind) {
+    case value_kind::regular:
+        break;
+    case value_kind::counter:
+        value_type = counter_type;
+        break;
+    case value_kind::collection:
+        value_type = map_type_impl::get_instance(int32_type, bytes_type, true);
+        break;
+    }
+    return schema_builder("ks", "perf_compaction")
+            .with_column("pk", bytes_type, column_kind::partition_key)
+            .with_column("ck", int32_type, column_kind::clustering_key)
+            .with_column("v", value_type)
+            .set_compaction_strategy(type)
+            .set_gc_grace_seconds(cfg.gc_grace_seconds)
+            .build();
+}
+
+class sstable_set_generator {
+    const conf& _cfg;
+    schema_ptr _s;
+    std::vector<dht::decorated_key> _keys;
+    std::mt19937 _gen{std::random_device{}()};
+    bytes _value;
+    api::timestamp_type _ts = api::new_timestamp();
+private:
+    unsigned rows() {
+        switch (_cfg.rows_distribution) {
+        case size_distribution::fixed:
+            return _cfg.rows;
+        case size_distribution::uniform:
+            return std::uniform_int_distribution<unsigned>(1, std::max(1u, 2 * _cfg.rows - 1))(_gen);
+        case size_distribution::exponential:
+            return 1 + unsigned(std::exponential_distribution<double>(1.0 / std::max(1u, _cfg.rows))(_gen));
+        }
+        abort();
+    }
+
+    atomic_cell_or_collection make_value() {
+        switch (_cfg.kind) {
+        case value_kind::regular:
+            return atomic_cell::make_live(*bytes_type, _ts, _value);
+        case value_kind::counter: {
+            counter_cell_builder b;
+            b.add_shard(counter_shard(counter_id::create_random_id(), 1, 1));
+            return b.build(_ts);
+        }
+        case value_kind::collection: {
+            collection_mutation_description cmd;
+            for (unsigned i = 0; i < _cfg.cells; ++i) {
+                cmd.cells.emplace_back(int32_type->decompose(int32_t(i)), atomic_cell::make_live(*bytes_type, _ts, _value, atomic_cell::collection_member::yes));
+            }
+            return cmd.serialize(*_s->regular_column_at(0).type);
+        }
+        }
+        abort();
+    }
+
+    mutation make_partition(const dht::decorated_key& dk) {
+        mutation m(_s, dk);
+        auto& cdef = _s->regular_column_at(0);
+        std::bernoulli_distribution is_tombstone(_cfg.tombstones);
+        for (unsigned i = 0, n = rows(); i < n; ++i) {
+            auto ck = clustering_key::from_single_value(*_s, int32_type->decompose(int32_t(i)));
+            if (is_tombstone(_gen)) {
+                m.partition().apply_delete(*_s, ck, tombstone(_ts, gc_clock::now()));
+            } else {
+                m.set_clustered_cell(ck, cdef, make_value());
+            }
+        }
+        return m;
+    }
+public:
+    sstable_set_generator(const conf& cfg, schema_ptr s)
+        : _cfg(cfg)
+        , _s(std::move(s))
+        , _value(tests::random::get_bytes(cfg.value_size))
+    {
+        // The first shared partitions are written to all sstables, the rest to a single one.
+        auto shared = size_t(cfg.partitions * cfg.overlap);
+        _keys = tests::generate_partition_keys(shared + (cfg.partitions - shared) * cfg.sstables, _s, local_shard_only::yes);
+    }
+
+    // Returns the memtable of the idx-th sstable, written after the previous ones.
+    lw_shared_ptr<replica::memtable> make_memtable(unsigned idx) {
+        auto mt = make_lw_shared<replica::memtable>(_s);
+        auto shared = size_t(_cfg.partitions * _cfg.overlap);
+        auto unique = _cfg.partitions - shared;
+        for (size_t i = 0; i < shared; ++i) {
+            mt->apply(make_partition(_keys[i]));
+        }
+        for (size_t i = 0; i < unique; ++i) {
+            mt->apply(make_partition(_keys[shared + idx * unique + i]));
+        }
+        ++_ts;
+        return mt;
+    }
+};
+
+struct strategy_result {
+    unsigned compactions = 0;
+    uint64_t flushed_bytes = 0;
+    compaction_stats stats;
+    std::chrono::duration<double> wall_time{};
+    std::chrono::duration<double> cpu_time{};
+    uint64_t allocations = 0;
+};
+
+// Flushes the sstables one after the other and runs the compactions picked by
+// the strategy after each, or a major compaction after the last one, then
+// measures the compactions only. Must be called in a seastar thread.
+strategy_result run_strategy(test_env& env, const conf& cfg, compaction_strategy_type type) {
+    auto s = make_schema(cfg, type);
+    auto cf = env.make_table_for_tests(s);
+    auto stop_cf = deferred_stop(cf);
+    auto& table_s = cf.as_table_state();
+    auto& cs = table_s.get_compaction_strategy();
+    no_ongoing_compaction control;
+    sstable_set_generator generator(cfg, s);
+    strategy_result result;
+
+    auto candidates = [&] {
+        auto all = table_s.main_sstable_set().all();
+        return std::vector<shared_sstable>(all->begin(), all->end());
+    };
+    auto compact = [&] (compaction_descriptor desc) {
+        auto replacer = [&] (compaction_completion_desc desc) {
+            table_s.on_compaction_completion(std::move(desc), offstrategy::no).get();
+        };
+        auto wall_start = std::chrono::steady_clock::now();
+        auto busy_start = engine().total_busy_time();
+        auto mallocs_start = perf_mallocs();
+        auto ret = compact_sstables(cf.get_compaction_manager(), std::move(desc), table_s, cf.make_sst_factory(), replacer).get0();
+        result.allocations += perf_mallocs() - mallocs_start;
+        result.cpu_time += engine().total_busy_time() - busy_start;
+        result.wall_time += std::chrono::steady_clock::now() - wall_start;
+        result.stats += ret.stats;
+        ++result.compactions;
+    };
+
+    for (unsigned i = 0; i < cfg.sstables; ++i) {
+        auto sst = cf.make_sstable();
+        write_memtable_to_sstable_for_test(*generator.make_memtable(i), sst).get();
+        sst->open_data().get();
+        result.flushed_bytes += sst->bytes_on_disk();
+        table_s.on_compaction_completion(compaction_completion_desc{.new_sstables = {sst}}, offstrategy::no).get();
+        if (cfg.major) {
+            continue;
+        }
+        // Bounded, in case a strategy keeps picking the same job.
+        for (unsigned n = 0; n < 1000; ++n) {
+            auto desc = cs.get_sstables_for_compaction(table_s, control, candidates());
+            if (desc.sstables.empty()) {
+                break;
+            }
+            compact(std::move(desc));
+        }
+    }
+    if (cfg.major) {
+        compact(cs.get_major_compaction_job(table_s, candidates()));
+    }
+    return result;
+}
+
+template <typename T>
+T parse_option(const std::unordered_map<sstring, T>& values, const sstring& name, const sstring& value) {
+    auto it = values.find(value);
+    if (it == values.end()) {
+        throw std::invalid_argument(format("Invalid {}: {}", name, value));
+    }
+    return it->second;
+}
+
+}
+
+namespace perf {
+
+int scylla_compaction_main(int argc, char** argv) {
+    namespace bpo = boost::program_options;
+    app_template app;
+    app.add_options()
+        ("sstables", bpo::value<unsigned>()->default_value(16), "number of sstables to flush and compact")
+        ("partitions", bpo::value<unsigned>()->default_value(10000), "number of partitions per sstable")
+        ("overlap", bpo::value<double>()->default_value(0.5), "fraction of the partitions of each sstable which are also in all the others")
+        ("tombstones", bpo::value<double>()->default_value(0.1), "fraction of the rows written as row tombstones")
+        ("rows", bpo::value<unsigned>()->default_value(4), "mean number of rows per partition")
+        ("rows-distribution", bpo::value<sstring>()->default_value("fixed"), "distribution of the number of rows per partition, one of: fixed, uniform, exponential")
+        ("values", bpo::value<sstring>()->default_value("regular"), "kind of the values of the rows, one of: regular, counter, collection")
+        ("value-size", bpo::value<unsigned>()->default_value(64), "size in bytes of each value, or of each collection cell")
+        ("cells", bpo::value<unsigned>()->default_value(8), "number of cells of each collection")
+        ("gc-grace-seconds", bpo::value<int32_t>()->default_value(864000), "gc_grace_seconds of the table, 0 lets compaction purge the tombstones it writes")
+        ("strategies", bpo::value<sstring>()->default_value("SizeTieredCompactionStrategy,LeveledCompactionStrategy,TimeWindowCompactionStrategy,IncrementalCompactionStrategy"),
+             "comma-separated list of the compaction strategies to run")
+        ("major", "run a major compaction after flushing all the sstables, instead of the compactions picked by the strategy");
+
+    return app.run(argc, argv, [&app] {
+        return seastar::async([&app] {
+            auto& config = app.configuration();
+            conf cfg;
+            cfg.sstables = config["sstables"].as<unsigned>();
+            cfg.partitions = config["partitions"].as<unsigned>();
+            cfg.overlap = std::clamp(config["overlap"].as<double>(), 0.0, 1.0);
+            cfg.tombstones = std::clamp(config["tombstones"].as<double>(), 0.0, 1.0);
+            cfg.rows = config["rows"].as<unsigned>();
+            cfg.rows_distribution = parse_option<size_distribution>({
+                {"fixed", size_distribution::fixed},
+                {"uniform", size_distribution::uniform},
+                {"exponential", size_distribution::exponential},
+            }, "rows-distribution", config["rows-distribution"].as<sstring>());
+            cfg.kind = parse_option<value_kind>({
+                {"regular", value_kind::regular},
+                {"counter", value_kind::counter},
+                {"collection", value_kind::collection},
+            }, "values", config["values"].as<sstring>());
+            cfg.value_size = config["value-size"].as<unsigned>();
+            cfg.cells = config["cells"].as<unsigned>();
+            cfg.gc_grace_seconds = config["gc-grace-seconds"].as<int32_t>();
+            cfg.major = config.contains("major");
+
+            std::vector<sstring> strategies;
+            boost::split(strategies, config["strategies"].as<sstring>(), boost::is_any_of(","));
+
+            // Write amplification counts the flush, so it is 1 when nothing was compacted.
+            std::cout << format("{:<32} {:>11} {:>11} {:>11} {:>8} {:>10} {:>12} {:>9}\n",
+                    "strategy", "compactions", "input(MB)", "output(MB)", "MB/s", "cpu(ns/B)", "allocs/MB", "write-amp");
+            test_env::do_with_async([&] (test_env& env) {
+                for (auto& name : strategies) {
+                    auto r = run_strategy(env, cfg, compaction_strategy::type(name));
+                    auto input_mb = r.stats.start_size / double(1 << 20);
+                    auto output_mb = r.stats.end_size / double(1 << 20);
+                    auto per_input = [&] (double v) {
+                        return r.stats.start_size ? v : 0.0;
+                    };
+                    std::cout << format("{:<32} {:>11} {:>11.2f} {:>11.2f} {:>8.2f} {:>10.2f} {:>12.0f} {:>9.2f}\n",
+                            name, r.compactions, input_mb, output_mb,
+                            per_input(input_mb / r.wall_time.count()),
+                            per_input(std::chrono::duration<double, std::nano>(r.cpu_time).count() / r.stats.start_size),
+                            per_input(r.allocations / input_mb),
+                            double(r.flushed_bytes + r.stats.end_size) / r.flushed_bytes);
+                }
+            }).get();
+        });
+    });
+}
+
+} // namespace perf
@@ -33,6 +33,7 @@
 #include "transport/messages/result_message.hh"
 #include "sstables/partition_index_cache.hh"
 #include <fstream>
+#include <linux/perf_event.h>
 
 using namespace std::chrono_literals;
 using namespace seastar;
@@ -63,6 +64,28 @@ class instructions_counter {
 
 static thread_local instructions_counter the_instructions_counter;
 
+// Counts the user space references to memory which missed all the CPU caches
+// (usually the last level cache).
+class cache_misses_counter {
+    linux_perf_event _event = make_event();
+
+    static linux_perf_event make_event() {
+        ::perf_event_attr attr = {};
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        return linux_perf_event(attr, 0, -1, -1, 0);
+    }
+public:
+    cache_misses_counter() { _event.enable(); }
+    uint64_t read() { return _event.read(); }
+};
+
+static thread_local cache_misses_counter the_cache_misses_counter;
+
 struct metrics_snapshot {
     std::chrono::high_resolution_clock::time_point hr_clock;
     steady_clock_type::duration busy_time;
@@ -73,6 +96,7 @@ struct metrics_snapshot {
     sstables::partition_index_cache::stats index;
     cache_tracker::stats cache;
     uint64_t instructions;
+    uint64_t cache_misses;
 
     metrics_snapshot()
             : mem(memory::stats()) {
@@ -85,6 +109,7 @@ struct metrics_snapshot {
         index = sstables::partition_index_cache::shard_stats();
         cache = cql_env->local_db().row_cache_tracker().get_stats();
         instructions = the_instructions_counter.read();
+        cache_misses = the_cache_misses_counter.read();
     }
 };
 
@@ -214,6 +239,7 @@ using stats_values = std::tuple<
     uint64_t, // allocations
     uint64_t, // tasks
     uint64_t, // instructions
+    double, // cache misses
     float // cpu
 >;
 
@@ -258,6 +284,7 @@ std::array<sstring, std::tuple_size<stats_values>::value> stats_formats =
     "{}",
     "{}",
     "{}",
+    "{:.2f}",
     "{:.1f}%",
 };
 
@@ -649,6 +676,7 @@ struct test_result {
     uint64_t allocations() const { return after.mem.mallocs() - before.mem.mallocs(); }
     uint64_t tasks() const { return after.sched.tasks_processed - before.sched.tasks_processed; }
     uint64_t instructions() const { return after.instructions - before.instructions; }
+    uint64_t cache_misses() const { return after.cache_misses - before.cache_misses; }
 
     float cpu_utilization() const {
         auto busy_delta = after.busy_time.count() - before.busy_time.count();
@@ -679,6 +707,7 @@ struct test_result {
             {"allocs",   "{:>9}"},
             {"tasks",    "{:>7}"},
             {"insns/f",  "{:>7}"},
+            {"cmiss/f",  "{:>7}"},
             {"cpu",      "{:>6}"}
         };
     }
@@ -712,6 +741,7 @@ struct test_result {
             allocations(),
             tasks(),
             fragments_read ? instructions() / fragments_read : 0,
+            fragments_read ? double(cache_misses()) / fragments_read : 0.0,
             cpu_utilization() * 100
         };
     }
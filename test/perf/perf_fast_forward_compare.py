@@ -0,0 +1,183 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+#
+# Copyright (C) 2023-present ScyllaDB
+#
+#
+# SPDX-License-Identifier: AGPL-3.0-or-later
+#
+
+# Compares the results of two perf_fast_forward runs, a stored baseline and
+# a new one, both written with `--output-format json --dump-all-results`.
+#
+# For every test present in both, and every compared statistic, the ratio of
+# the medians (new / baseline) is computed together with a bootstrap
+# confidence interval over the iterations of the two runs. A test is reported
+# as regressed (or improved) only if the whole interval lies beyond the
+# threshold, so noisy tests do not raise false alarms. When only the summary
+# results are available, their median absolute deviation is used to estimate
+# the noise instead.
+#
+# Exits with status 1 if any regression was found, so it can gate a pipeline.
+
+import argparse
+import json
+import os
+import random
+import statistics
+import sys
+
+# Statistic name in the results -> True if higher is better.
+DEFAULT_STATS = {
+    'frag/s': True,
+    'insns/f': False,
+    'cmiss/f': False,
+    'allocs': False,
+}
+
+cmdline_parser = argparse.ArgumentParser(formatter_class=argparse.ArgumentDefaultsHelpFormatter)
+cmdline_parser.add_argument('baseline', help='output directory of the baseline perf_fast_forward run')
+cmdline_parser.add_argument('current', help='output directory of the perf_fast_forward run to check')
+cmdline_parser.add_argument('--stats', default=','.join(DEFAULT_STATS.keys()),
+                            help='comma-separated list of statistics to compare')
+cmdline_parser.add_argument('--threshold', type=float, default=0.05,
+                            help='relative change below which differences are ignored')
+cmdline_parser.add_argument('--confidence', type=float, default=0.95, help='confidence level of the intervals')
+cmdline_parser.add_argument('--resamples', type=int, default=2000, help='number of bootstrap resamples')
+cmdline_parser.add_argument('--seed', type=int, default=0, help='seed of the bootstrap, for repeatable reports')
+cmdline_parser.add_argument('--json-output', help='write the comparison to this file as JSON')
+cmdline_parser.add_argument('--verbose', action='store_true', help='also print the unchanged results')
+
+
+def load_results(directory):
+    """Returns {test id: {'samples': {stat: [values]}, 'summary': {stat: value}}}"""
+    results = {}
+    for dirpath, _, filenames in os.walk(directory):
+        for filename in filenames:
+            if not filename.endswith('.json'):
+                continue
+            path = os.path.join(dirpath, filename)
+            all_results = filename.endswith('.all.json')
+            test_id = os.path.relpath(path, directory)[:-len('.all.json' if all_results else '.json')]
+            with open(path) as f:
+                stats = json.load(f)['results']['stats']
+            entry = results.setdefault(test_id, {'samples': None, 'summary': None})
+            if all_results:
+                entry['samples'] = {name: [s[name] for s in stats] for name in stats[0]} if stats else {}
+            else:
+                entry['summary'] = stats
+    return results
+
+
+def percentile(sorted_values, p):
+    return sorted_values[min(len(sorted_values) - 1, int(p * len(sorted_values)))]
+
+
+def bootstrap_ratio(baseline, current, confidence, resamples, rng):
+    ratios = []
+    for _ in range(resamples):
+        b = statistics.median(rng.choices(baseline, k=len(baseline)))
+        c = statistics.median(rng.choices(current, k=len(current)))
+        if b != 0:
+            ratios.append(c / b)
+    if not ratios:
+        return None
+    ratios.sort()
+    alpha = (1 - confidence) / 2
+    return percentile(ratios, alpha), percentile(ratios, 1 - alpha)
+
+
+def summary_ratio(baseline, current, stat, confidence):
+    # Without the samples, approximate the standard error of each median from
+    # the median absolute deviation of the frag/s (the only statistic with
+    # one), scaled to a normal standard deviation, and propagate it to the
+    # ratio. Other statistics are assumed to be noise-free.
+    z = statistics.NormalDist().inv_cdf(0.5 + confidence / 2)
+    b, c = baseline[stat], current[stat]
+    if b == 0:
+        return None
+    rel_err = 0
+    if stat == 'frag/s':
+        for s in (baseline, current):
+            n = max(1, s.get('iterations', 1))
+            if s[stat]:
+                rel_err += (1.4826 * s.get('mad f/s', 0) / s[stat]) ** 2 * (1.57 / n)
+    spread = z * rel_err ** 0.5
+    ratio = c / b
+    return ratio * (1 - spread), ratio * (1 + spread)
+
+
+def compare(args):
+    stats = args.stats.split(',')
+    baseline = load_results(args.baseline)
+    current = load_results(args.current)
+    rng = random.Random(args.seed)
+    report = []
+    for test_id in sorted(set(baseline) & set(current)):
+        b, c = baseline[test_id], current[test_id]
+        for stat in stats:
+            higher_is_better = DEFAULT_STATS.get(stat, True)
+            if b['samples'] and c['samples'] and stat in b['samples'] and stat in c['samples']:
+                b_median = statistics.median(b['samples'][stat])
+                c_median = statistics.median(c['samples'][stat])
+                interval = bootstrap_ratio(b['samples'][stat], c['samples'][stat], args.confidence, args.resamples, rng)
+            elif b['summary'] and c['summary'] and stat in b['summary'] and stat in c['summary']:
+                b_median = b['summary'][stat]
+                c_median = c['summary'][stat]
+                interval = summary_ratio(b['summary'], c['summary'], stat, args.confidence)
+            else:
+                continue
+            if interval is None:
+                continue
+            low, high = interval
+            worse = high < 1 - args.threshold if higher_is_better else low > 1 + args.threshold
+            better = low > 1 + args.threshold if higher_is_better else high < 1 - args.threshold
+            report.append({
+                'test': test_id,
+                'stat': stat,
+                'baseline': b_median,
+                'current': c_median,
+                'ratio': c_median / b_median if b_median else None,
+                'ci_low': low,
+                'ci_high': high,
+                'verdict': 'regression' if worse else 'improvement' if better else 'unchanged',
+            })
+    missing = sorted(set(baseline) - set(current))
+    return report, missing
+
+
+def main():
+    args = cmdline_parser.parse_args()
+    report, missing = compare(args)
+
+    for r in report:
+        if r['verdict'] == 'unchanged' and not args.verbose:
+            continue
+        print('{verdict:>11}: {test} {stat}: {baseline:.6g} -> {current:.6g} (x{ratio:.3f}, {confidence:.0%} CI [{ci_low:.3f}, {ci_high:.3f}])'.format(
+            confidence=args.confidence, **r))
+    for test_id in missing:
+        print('    missing: {}'.format(test_id))
+
+    regressions = sum(1 for r in report if r['verdict'] == 'regression')
+    improvements = sum(1 for r in report if r['verdict'] == 'improvement')
+    print('{} comparisons: {} regressions, {} improvements, {} tests missing'.format(
+        len(report), regressions, improvements, len(missing)))
+
+    if args.json_output:
+        with open(args.json_output, 'w') as f:
+            json.dump({
+                'parameters': {
+                    'baseline': args.baseline,
+                    'current': args.current,
+                    'threshold': args.threshold,
+                    'confidence': args.confidence,
+                },
+                'comparisons': report,
+                'missing': missing,
+            }, f, indent=2)
+
+    return 1 if regressions else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -12,6 +12,7 @@
 #include "test/perf/perf.hh"
 
 #include "mutation/mutation_fragment.hh"
+#include "mutation/mutation_fragment_v2.hh"
 
 namespace tests {
 
@@ -68,6 +69,10 @@ class clustering_row {
     mutation_fragment make_clustering_row_1M() const {
         return _schema.make_row_from_serialized_value(_permit, _key, _value_1M);
     }
+
+    mutation_fragment_v2 make_clustering_row_v2_4() const {
+        return mutation_fragment_v2(*schema(), _permit, make_clustering_row_4().as_clustering_row());
+    }
 };
 
 PERF_TEST_F(clustering_row, make_4)
@@ -133,4 +138,23 @@ PERF_TEST_F(clustering_row, hash_1M)
     });
 }
 
+// Fills a reader buffer with fragments and consumes it, like a reader
+// and its consumer do, to measure the allocation and freeing of fragments.
+PERF_TEST_F(clustering_row, fill_and_consume_buffer_v2)
+{
+    const size_t fragments = 128;
+    circular_buffer<mutation_fragment_v2> buffer;
+    buffer.reserve(fragments);
+    auto row = make_clustering_row_v2_4();
+    for (size_t i = 0; i < fragments; ++i) {
+        buffer.emplace_back(*schema(), permit(), row);
+    }
+    while (!buffer.empty()) {
+        auto mf = std::move(buffer.front());
+        buffer.pop_front();
+        perf_tests::do_not_optimize(mf);
+    }
+    return fragments;
+}
+
 }
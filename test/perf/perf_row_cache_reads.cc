@@ -46,6 +46,10 @@
 /// The second row which starts with "read:" has high max latency (106 ms),
 /// which is an indication of the following bug: https://github.com/scylladb/scylla/issues/8153
 ///
+/// test_random_point_reads measures the cost of single-partition lookups spread over
+/// a large cache, which is dominated by cache and TLB misses. Compare runs with and
+/// without --lsa-huge-pages to see the effect of backing LSA memory with huge pages.
+///
 
 static const int cell_size = 128;
 static bool cancelled = false;
@@ -220,17 +224,96 @@ void test_scan_with_range_delete_over_rows() {
     tracker.cleaner().drain().get();
 }
 
+void test_random_point_reads(size_t lookups) {
+    std::cout << __FUNCTION__<< std::endl;
+
+    simple_schema ss;
+    auto s = ss.schema();
+    tests::reader_concurrency_semaphore_wrapper semaphore;
+
+    cache_tracker tracker;
+    memtable_snapshot_source mss(s);
+
+    auto val = sstring(sstring::initialized_later(), cell_size);
+
+    std::cout << "Populating with partitions" << std::endl;
+
+    const size_t cache_size = seastar::memory::stats().total_memory() / 4;
+    std::vector<dht::decorated_key> keys;
+    while (mss.used_space() < cache_size) {
+        mutation m(s, ss.make_pkey(keys.size()));
+        ss.add_row(m, ss.make_ckey(0), val);
+        mss.apply(m);
+        keys.push_back(m.decorated_key());
+
+        if (cancelled) {
+            return;
+        }
+    }
+
+    row_cache cache(s, snapshot_source([&] { return mss(); }), tracker, is_continuous::no);
+
+    // Populate the cache with all partitions.
+    {
+        auto rd = cache.make_reader(s, semaphore.make_permit(), query::full_partition_range);
+        auto close_reader = deferred_close(rd);
+        rd.consume_pausable([](mutation_fragment_v2) {
+            return stop_iteration(cancelled);
+        }).get();
+    }
+
+    std::cout << "Partitions: " << keys.size() << std::endl;
+    std::cout << "Reading..." << std::endl;
+
+    auto test_read = [&] {
+        auto d = duration_in_seconds([&] {
+            for (size_t i = 0; i < lookups && !cancelled; ++i) {
+                auto pr = dht::partition_range::make_singular(keys[tests::random::get_int<size_t>(0, keys.size() - 1)]);
+                auto rd = cache.make_reader(s, semaphore.make_permit(), pr);
+                auto close_reader = deferred_close(rd);
+                rd.consume_pausable([](mutation_fragment_v2) {
+                    return stop_iteration::no;
+                }).get();
+                seastar::thread::maybe_yield();
+            }
+        });
+
+        fmt::print(std::cout, "read: {:.6f} [ms], {:.3f} [us/lookup], hits: {:d}, misses: {:d}, cache: {:d}/{:d} [MB]\n",
+                   d.count() * 1000,
+                   d.count() * 1e6 / lookups,
+                   tracker.get_stats().partition_hits,
+                   tracker.get_stats().partition_misses,
+                   tracker.region().occupancy().used_space() / MB,
+                   tracker.region().occupancy().total_space() / MB);
+    };
+
+    test_read();
+    test_read();
+
+    // Clean gently to avoid reactor stalls in destructors
+    cache.invalidate(row_cache::external_updater([]{})).get();
+    tracker.cleaner().drain().get();
+}
+
 int main(int argc, char** argv) {
+    namespace bpo = boost::program_options;
     app_template app;
-    return app.run(argc, argv, [] {
+    app.add_options()
+        ("lsa-huge-pages", "Back LSA memory with transparent huge pages, see the lsa_huge_pages option")
+        ("lookups", bpo::value<size_t>()->default_value(1000000), "Number of lookups in each round of test_random_point_reads")
+        ;
+
+    return app.run(argc, argv, [&app] {
         return seastar::async([&] {
             engine().at_exit([] {
                 cancelled = true;
                 return make_ready_future();
             });
-            logalloc::prime_segment_pool(memory::stats().total_memory(), memory::min_free_memory()).get();
+            auto huge_pages = logalloc::use_huge_pages(app.configuration().contains("lsa-huge-pages"));
+            logalloc::prime_segment_pool(memory::stats().total_memory(), memory::min_free_memory(), huge_pages).get();
             test_scans_with_dummy_entries();
             test_scan_with_range_delete_over_rows();
+            test_random_point_reads(app.configuration()["lookups"].as<size_t>());
         });
     });
 }
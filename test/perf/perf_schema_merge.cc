@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/core/app-template.hh>
+#include <seastar/core/reactor.hh>
+#include <seastar/core/sstring.hh>
+#include <seastar/core/thread.hh>
+
+#include "test/lib/cql_test_env.hh"
+#include "test/perf/perf.hh"
+
+namespace {
+
+struct conf {
+    unsigned tables;
+    unsigned columns;
+    unsigned views;
+    unsigned iterations;
+};
+
+struct statement_result {
+    std::chrono::duration<double> wall_time{};
+    std::chrono::duration<double> max_wall_time{};
+    std::chrono::duration<double> cpu_time{};
+    uint64_t allocations = 0;
+};
+
+// Creates a keyspace holding cfg.tables tables which all use the same user type,
+// and cfg.views views of the first table. Must be called in a seastar thread.
+void populate_schema(cql_test_env& env, const conf& cfg) {
+    env.execute_cql("CREATE KEYSPACE ks WITH replication = {'class': 'SimpleStrategy', 'replication_factor': 1}").get();
+    env.execute_cql("CREATE TYPE ks.ut (a int)").get();
+    for (unsigned i = 0; i < cfg.tables; ++i) {
+        sstring columns;
+        for (unsigned c = 0; c < cfg.columns; ++c) {
+            columns += format("c{} int, ", c);
+        }
+        env.execute_cql(format("CREATE TABLE ks.t{} (pk int, ck int, {}u frozen<ut>, PRIMARY KEY (pk, ck))", i, columns)).get();
+    }
+    for (unsigned i = 0; i < cfg.views; ++i) {
+        env.execute_cql(format("CREATE MATERIALIZED VIEW ks.v{} AS SELECT * FROM ks.t0"
+                " WHERE pk IS NOT NULL AND ck IS NOT NULL PRIMARY KEY (ck, pk)", i)).get();
+    }
+}
+
+// Runs the statements returned by make_statement(0), ..., make_statement(cfg.iterations - 1)
+// one after the other and measures each. Must be called in a seastar thread.
+statement_result run_statements(cql_test_env& env, const conf& cfg, std::function<sstring (unsigned)> make_statement) {
+    statement_result result;
+    for (unsigned i = 0; i < cfg.iterations; ++i) {
+        auto statement = make_statement(i);
+        auto wall_start = std::chrono::steady_clock::now();
+        auto busy_start = engine().total_busy_time();
+        auto mallocs_start = perf_mallocs();
+        env.execute_cql(statement).get();
+        result.allocations += perf_mallocs() - mallocs_start;
+        result.cpu_time += engine().total_busy_time() - busy_start;
+        std::chrono::duration<double> wall_time = std::chrono::steady_clock::now() - wall_start;
+        result.wall_time += wall_time;
+        result.max_wall_time = std::max(result.max_wall_time, wall_time);
+    }
+    return result;
+}
+
+} // anonymous namespace
+
+namespace perf {
+
+int scylla_schema_merge_main(int argc, char** argv) {
+    namespace bpo = boost::program_options;
+    app_template app;
+    app.add_options()
+        ("tables", bpo::value<unsigned>()->default_value(1000), "number of tables in the keyspace, all using the same user type")
+        ("columns", bpo::value<unsigned>()->default_value(8), "number of regular columns of each table")
+        ("views", bpo::value<unsigned>()->default_value(4), "number of materialized views of the first table")
+        ("iterations", bpo::value<unsigned>()->default_value(10), "number of times each statement is run");
+
+    return app.run(argc, argv, [&app] {
+        auto& config = app.configuration();
+        conf cfg;
+        cfg.tables = config["tables"].as<unsigned>();
+        cfg.columns = config["columns"].as<unsigned>();
+        cfg.views = config["views"].as<unsigned>();
+        cfg.iterations = config["iterations"].as<unsigned>();
+
+        return do_with_cql_env_thread([cfg] (cql_test_env& env) {
+            std::cout << format("Creating {} tables with {} views...\n", cfg.tables, cfg.views);
+            populate_schema(env, cfg);
+
+            std::vector<std::pair<sstring, std::function<sstring (unsigned)>>> statements = {
+                {"create table", [] (unsigned i) { return format("CREATE TABLE ks.new{} (pk int PRIMARY KEY, v int)", i); }},
+                {"alter table", [] (unsigned i) { return format("ALTER TABLE ks.t0 ADD added{} int", i); }},
+                {"drop table", [] (unsigned i) { return format("DROP TABLE ks.new{}", i); }},
+                // Changes every table of the keyspace.
+                {"alter type", [] (unsigned i) { return format("ALTER TYPE ks.ut ADD added{} int", i); }},
+            };
+
+            std::cout << format("{:<16} {:>12} {:>12} {:>12} {:>14}\n", "statement", "mean(ms)", "max(ms)", "cpu(ms)", "allocs");
+            for (auto& [name, make_statement] : statements) {
+                auto r = run_statements(env, cfg, make_statement);
+                auto per_statement = [&] (double v) {
+                    return v / cfg.iterations;
+                };
+                std::cout << format("{:<16} {:>12.2f} {:>12.2f} {:>12.2f} {:>14.0f}\n", name,
+                        per_statement(r.wall_time.count() * 1000),
+                        r.max_wall_time.count() * 1000,
+                        per_statement(r.cpu_time.count() * 1000),
+                        per_statement(r.allocations));
+            }
+        });
+    });
+}
+
+} // namespace perf
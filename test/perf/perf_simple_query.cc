@@ -74,6 +74,7 @@ struct test_config {
     bool stop_on_error;
     sstring timeout;
     bool bypass_cache;
+    bool durable_writes = true;
 };
 
 std::ostream& operator<<(std::ostream& os, const test_config::run_mode& m) {
@@ -100,6 +101,7 @@ std::ostream& operator<<(std::ostream& os, const test_config& cfg) {
            << ", frontend=" << cfg.frontend
            << ", query_single_key=" << (cfg.query_single_key ? "yes" : "no")
            << ", counters=" << (cfg.counters ? "yes" : "no")
+           << ", durable_writes=" << (cfg.durable_writes ? "yes" : "no")
            << "}";
 }
 
@@ -375,11 +377,12 @@ static std::vector<perf_result> do_alternator_test(std::string isolation_level,
         sharded<cql3::query_processor>& qp,
         sharded<service::migration_manager>& mm,
         sharded<gms::gossiper>& gossiper,
+        sharded<netw::messaging_service>& ms,
         test_config& cfg) {
     assert(cfg.frontend == test_config::frontend_type::alternator);
     std::cout << "Running test with config: " << cfg << std::endl;
 
-    alternator_test_env env(gossiper, qp.local().proxy().container(), mm, qp);
+    alternator_test_env env(gossiper, qp.local().proxy().container(), mm, qp, ms);
     env.start(isolation_level).get();
     auto stop_env = defer([&] {
         env.stop().get();
@@ -425,6 +428,10 @@ static std::vector<perf_result> do_cql_test(cql_test_env& env, test_config& cfg)
                 .with_column("C4", bytes_type)
                 .build();
     }).get();
+    if (!cfg.durable_writes) {
+        env.execute_cql("ALTER KEYSPACE ks WITH replication = { 'class' : 'org.apache.cassandra.locator.SimpleStrategy', 'replication_factor' : 1 }"
+                " AND durable_writes = false").get();
+    }
 
     switch (cfg.mode) {
     case test_config::run_mode::read:
@@ -471,6 +478,9 @@ void write_json_result(std::string result_file, const test_config& cfg, perf_res
     if (cfg.counters) {
         test_type += "_counters";
     }
+    if (!cfg.durable_writes) {
+        test_type += "_non_durable";
+    }
     results["test_properties"]["type"] = test_type;
 
     // <version>-<release>
@@ -521,6 +531,7 @@ int scylla_simple_query_main(int argc, char** argv) {
         ("stop-on-error", bpo::value<bool>()->default_value(true), "stop after encountering the first error")
         ("timeout", bpo::value<std::string>()->default_value(""), "use timeout")
         ("bypass-cache", "use bypass cache when querying")
+        ("durable-writes", bpo::value<bool>()->default_value(true), "write to the commitlog, false compares with writes which skip it")
         ;
 
     set_abort_on_internal_error(true);
@@ -567,10 +578,11 @@ int scylla_simple_query_main(int argc, char** argv) {
             cfg.stop_on_error = app.configuration()["stop-on-error"].as<bool>();
             cfg.timeout = app.configuration()["timeout"].as<std::string>();
             cfg.bypass_cache = app.configuration().contains("bypass-cache");
+            cfg.durable_writes = app.configuration()["durable-writes"].as<bool>();
             auto results = cfg.frontend == test_config::frontend_type::cql
                     ? do_cql_test(env, cfg)
                     : do_alternator_test(app.configuration()["alternator"].as<std::string>(),
-                            env.local_client_state(), env.qp(), env.migration_manager(), env.gossiper(), cfg);
+                            env.local_client_state(), env.qp(), env.migration_manager(), env.gossiper(), env.get_messaging_service(), cfg);
 
             auto compare_throughput = [] (perf_result a, perf_result b) { return a.throughput < b.throughput; };
             std::sort(results.begin(), results.end(), compare_throughput);
@@ -11,6 +11,8 @@
 #include <seastar/core/sstring.hh>
 #include <seastar/core/reactor.hh>
 #include <random>
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/classification.hpp>
 
 // hack: perf_sstable falsely depends on Boost.Test, but we can't include it with
 // with statically linked boost
@@ -18,6 +20,7 @@
 #define BOOST_CHECK_NO_THROW(x) (void)(x)
 
 #include "test/perf/perf_sstable.hh"
+#include "utils/class_registrator.hh"
 
 using namespace sstables;
 
@@ -52,12 +55,49 @@ future<> test_sequential_read(distributed<perf_sstable_test_env>& dt) {
     return time_runs(iterations, parallelism, dt, &perf_sstable_test_env::read_sequential_partitions);
 }
 
+static std::vector<sstring> split_list(const sstring& list) {
+    std::vector<sstring> items;
+    if (!list.empty()) {
+        boost::split(items, list, boost::is_any_of(","));
+    }
+    return items;
+}
+
+// Compares the given compressors, all the registered ones if there are none,
+// with each of the chunk lengths, on the first shard.
+future<> test_compression(distributed<perf_sstable_test_env>& dt, std::vector<sstring> compressors, std::vector<sstring> chunk_lengths_kb, unsigned reads) {
+    return dt.invoke_on(0, [compressors = std::move(compressors), chunk_lengths_kb = std::move(chunk_lengths_kb), reads] (perf_sstable_test_env& t) mutable {
+        if (compressors.empty()) {
+            for (auto& c : { compressor::lz4, compressor::snappy, compressor::deflate }) {
+                compressors.push_back(c->name());
+            }
+            for (auto& [name, creator] : compressor_registry::classes()) {
+                compressors.push_back(name);
+            }
+        }
+        std::vector<compression_parameters> options;
+        for (auto& c : compressors) {
+            for (auto& kb : chunk_lengths_kb) {
+                options.emplace_back(std::map<sstring, sstring>{
+                    {compression_parameters::SSTABLE_COMPRESSION, c},
+                    {compression_parameters::CHUNK_LENGTH_KB, kb},
+                });
+                options.back().validate();
+            }
+        }
+        return t.fill_memtable().then([&t, options = std::move(options), reads] () mutable {
+            return t.compression_benchmark(std::move(options), reads);
+        });
+    });
+}
+
 enum class test_modes {
     sequential_read,
     index_read,
     write,
     index_write,
     compaction,
+    compression,
 };
 
 static std::unordered_map<sstring, test_modes> test_mode = {
@@ -66,6 +106,7 @@ static std::unordered_map<sstring, test_modes> test_mode = {
     {"write", test_modes::write },
     {"index_write", test_modes::index_write },
     {"compaction", test_modes::compaction },
+    {"compression", test_modes::compression },
 };
 
 namespace perf {
@@ -82,7 +123,10 @@ int scylla_sstable_main(int argc, char** argv) {
         ("num_columns", bpo::value<unsigned>()->default_value(5), "number of columns per row")
         ("column_size", bpo::value<unsigned>()->default_value(64), "size in bytes for each column")
         ("sstables", bpo::value<unsigned>()->default_value(1), "number of sstables (valid only for compaction mode)")
-        ("mode", bpo::value<sstring>()->default_value("index_write"), "one of: sequential_read, index_read, write, compaction, index_write (default)")
+        ("mode", bpo::value<sstring>()->default_value("index_write"), "one of: sequential_read, index_read, write, compaction, compression, index_write (default)")
+        ("compressors", bpo::value<sstring>()->default_value(""), "comma-separated list of compressors to compare in compression mode, all the registered ones by default")
+        ("chunk-lengths", bpo::value<sstring>()->default_value("4,16,64"), "comma-separated list of chunk_length_in_kb values to compare in compression mode")
+        ("reads", bpo::value<unsigned>()->default_value(1000), "number of single partition reads of each option in compression mode")
         ("testdir", bpo::value<sstring>()->default_value("/var/lib/scylla/perf-tests"), "directory in which to store the sstables")
         ("compaction-strategy", bpo::value<sstring>()->default_value("SizeTieredCompactionStrategy"), "compaction strategy to use, one of "
              "(SizeTieredCompactionStrategy, LeveledCompactionStrategy, DateTieredCompactionStrategy, TimeWindowCompactionStrategy)")
@@ -124,12 +168,12 @@ int scylla_sstable_main(int argc, char** argv) {
                         throw;
                     }
                 });
-            } else if ((mode == test_modes::index_write) || (mode == test_modes::write) || (mode == test_modes::compaction)) {
+            } else if ((mode == test_modes::index_write) || (mode == test_modes::write) || (mode == test_modes::compaction) || (mode == test_modes::compression)) {
                 return test_setup::create_empty_test_dir(dir);
             } else {
                 throw std::invalid_argument("Invalid mode");
             }
-        }).then([test, mode] {
+        }).then([&app, test, mode] {
             if (mode == test_modes::index_read) {
                 return test_index_read(*test).then([test] {});
             } else if (mode == test_modes::sequential_read) {
@@ -138,6 +182,10 @@ int scylla_sstable_main(int argc, char** argv) {
                 return test_write(*test).then([test] {});
             } else if (mode == test_modes::compaction) {
                 return test_compaction(*test).then([test] {});
+            } else if (mode == test_modes::compression) {
+                auto& config = app.configuration();
+                return test_compression(*test, split_list(config["compressors"].as<sstring>()), split_list(config["chunk-lengths"].as<sstring>()),
+                        config["reads"].as<unsigned>()).then([test] {});
             } else {
                 throw std::invalid_argument("Invalid mode");
             }
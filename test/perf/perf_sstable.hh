@@ -8,9 +8,11 @@
 
 #pragma once
 
+#include <seastar/core/fstream.hh>
 #include <seastar/util/closeable.hh>
 
 #include "sstables/sstables.hh"
+#include "compress.hh"
 #include "compaction/compaction_manager.hh"
 #include "compaction/time_window_compaction_strategy.hh"
 #include "cell_locking.hh"
@@ -125,6 +127,7 @@ class perf_sstable_test_env {
     std::default_random_engine _generator;
     std::uniform_int_distribution<char> _distribution;
     lw_shared_ptr<replica::memtable> _mt;
+    std::vector<dht::decorated_key> _keys;
     std::vector<shared_sstable> _sst;
 
     schema_ptr create_schema(sstables::compaction_strategy_type type) {
@@ -166,9 +169,9 @@ class perf_sstable_test_env {
 
     future<> fill_memtable() {
         auto idx = boost::irange(0, int(_cfg.partitions / _cfg.sstables));
-        auto local_keys = tests::generate_partition_keys(int(_cfg.partitions / _cfg.sstables), s, local_shard_only::yes, tests::key_size{_cfg.key_size, _cfg.key_size});
-        return do_for_each(idx.begin(), idx.end(), [this, local_keys = std::move(local_keys)] (auto iteration) {
-            auto mut = mutation(this->s, local_keys.at(iteration));
+        _keys = tests::generate_partition_keys(int(_cfg.partitions / _cfg.sstables), s, local_shard_only::yes, tests::key_size{_cfg.key_size, _cfg.key_size});
+        return do_for_each(idx.begin(), idx.end(), [this] (auto iteration) {
+            auto mut = mutation(this->s, _keys.at(iteration));
             for (auto& cdef: this->s->regular_columns()) {
                 const auto ts = _cfg.timestamp_range ? tests::random::get_int<api::timestamp_type>(-_cfg.timestamp_range, _cfg.timestamp_range) : 0;
                 mut.set_clustered_cell(clustering_key::make_empty(), cdef, atomic_cell::make_live(*utf8_type, ts, utf8_type->decompose(this->random_column())));
@@ -188,6 +191,122 @@ class perf_sstable_test_env {
         return clk::now();
     }
 
+private:
+    // Must be called in a seastar thread, like the helpers below.
+    std::pair<shared_sstable, double> write_compressed(const compression_parameters& cp, int idx) {
+        _mt->set_schema(schema_builder(s).set_compressor_params(cp).build());
+        auto sst = _env.make_sstable(_mt->schema(), dir(), sstables::generation_type(idx), sstables::get_highest_sstable_version(), sstable::format_types::big, _cfg.buffer_size);
+
+        auto start = perf_sstable_test_env::now();
+        write_memtable_to_sstable_for_test(*_mt, sst).get();
+        auto end = perf_sstable_test_env::now();
+
+        _mt->revert_flushed_memory();
+        sst->open_data().get();
+        return {sst, std::chrono::duration<double>(end - start).count()};
+    }
+
+    // Compresses and uncompresses the data file of the uncompressed sstable
+    // raw, chunk by chunk, and returns the throughput of each, in MB/s of
+    // uncompressed data.
+    std::pair<double, double> time_compressor(shared_sstable raw, compressor_ptr c, size_t chunk_len) {
+        auto f = open_file_dma(raw->get_filename(), open_flags::ro).get0();
+        auto close_f = deferred_close(f);
+        auto for_each_chunk = [&] (std::function<stop_iteration(temporary_buffer<char>)> func) {
+            auto in = make_file_input_stream(f);
+            auto close_in = deferred_close(in);
+            for (;;) {
+                auto buf = in.read_exactly(chunk_len).get0();
+                if (buf.empty() || func(std::move(buf)) == stop_iteration::yes) {
+                    break;
+                }
+            }
+        };
+
+        if (c->uses_dictionary()) {
+            // Train the dictionary on the first chunks, like the sstable writer does.
+            std::vector<temporary_buffer<char>> samples;
+            size_t sampled = 0;
+            for_each_chunk([&] (temporary_buffer<char> buf) {
+                sampled += buf.size();
+                samples.push_back(std::move(buf));
+                return stop_iteration(sampled >= c->dictionary_training_size());
+            });
+            std::vector<bytes_view> views;
+            for (auto& b : samples) {
+                views.emplace_back(reinterpret_cast<const bytes_view::value_type*>(b.get()), b.size());
+            }
+            c = c->with_dictionary(c->train_dictionary(views).get0());
+        }
+
+        clk::duration compress_time{};
+        clk::duration uncompress_time{};
+        uint64_t total = 0;
+        std::vector<char> compressed(c->compress_max_size(chunk_len));
+        std::vector<char> uncompressed(chunk_len);
+        for_each_chunk([&] (temporary_buffer<char> buf) {
+            auto start = perf_sstable_test_env::now();
+            auto len = c->compress(buf.get(), buf.size(), compressed.data(), compressed.size());
+            auto compressed_at = perf_sstable_test_env::now();
+            c->uncompress(compressed.data(), len, uncompressed.data(), uncompressed.size());
+            auto end = perf_sstable_test_env::now();
+            compress_time += compressed_at - start;
+            uncompress_time += end - compressed_at;
+            total += buf.size();
+            return stop_iteration::no;
+        });
+        auto mb = total / double(1 << 20);
+        return {mb / std::chrono::duration<double>(compress_time).count(), mb / std::chrono::duration<double>(uncompress_time).count()};
+    }
+
+    // Returns the mean latency, in microseconds, of reading random partitions
+    // one at a time.
+    double time_point_reads(shared_sstable sst, unsigned reads) {
+        auto schema = sst->get_schema();
+        std::uniform_int_distribution<size_t> key_distribution(0, _keys.size() - 1);
+        clk::duration total{};
+        for (unsigned i = 0; i < reads; ++i) {
+            auto pr = dht::partition_range::make_singular(_keys[key_distribution(_generator)]);
+            auto start = perf_sstable_test_env::now();
+            auto rd = sst->make_reader(schema, _env.make_reader_permit(), pr, schema->full_slice());
+            auto close_rd = deferred_close(rd);
+            auto m = read_mutation_from_flat_mutation_reader(rd).get0();
+            total += perf_sstable_test_env::now() - start;
+            if (!m) {
+                throw std::runtime_error(format("Partition {} not found after writing it", pr));
+            }
+        }
+        return std::chrono::duration<double, std::micro>(total).count() / reads;
+    }
+
+public:
+    // Writes the memtable with each of the compression options and prints the
+    // compression ratio, the throughput of the compressor, the write throughput
+    // and the latency of single partition reads of each.
+    future<> compression_benchmark(std::vector<compression_parameters> options, unsigned reads) {
+        return seastar::async([this, options = std::move(options), reads] {
+            test_setup::create_empty_test_dir(dir()).get();
+            int idx = 0;
+            auto raw = write_compressed(compression_parameters::no_compression(), ++idx).first;
+
+            std::cout << format("{:<40} {:>9} {:>8} {:>14} {:>16} {:>11} {:>14}\n",
+                    "compressor", "chunk(KB)", "ratio", "compress(MB/s)", "decompress(MB/s)", "write(MB/s)", "read(us/part)");
+            for (auto& cp : options) {
+                auto [sst, write_time] = write_compressed(cp, ++idx);
+                auto [compress_mbps, decompress_mbps] = time_compressor(raw, cp.get_compressor(), cp.chunk_length());
+                auto read_latency = time_point_reads(sst, reads);
+                auto name = cp.get_compressor()->name();
+                if (name.find(compressor::namespace_prefix) == 0) {
+                    name = name.substr(compressor::namespace_prefix.size());
+                }
+                std::cout << format("{:<40} {:>9} {:>8.2f} {:>14.2f} {:>16.2f} {:>11.2f} {:>14.2f}\n",
+                        name, cp.chunk_length() >> 10, double(sst->data_size()) / sst->ondisk_data_size(), compress_mbps, decompress_mbps,
+                        sst->data_size() / double(1 << 20) / write_time, read_latency);
+            }
+            _mt->set_schema(s);
+        });
+    }
+
 
     // Mappers below
     future<double> flush_memtable(int idx) {
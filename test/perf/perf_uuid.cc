@@ -0,0 +1,37 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/testing/perf_tests.hh>
+
+#include "utils/UUID_gen.hh"
+
+struct uuid_gen {
+    static constexpr size_t count = 1000;
+};
+
+PERF_TEST_F(uuid_gen, time_uuid) {
+    for (size_t i = 0; i < count; i++) {
+        perf_tests::do_not_optimize(utils::UUID_gen::get_time_UUID());
+    }
+    return count;
+}
+
+PERF_TEST_F(uuid_gen, time_uuid_bytes) {
+    for (size_t i = 0; i < count; i++) {
+        perf_tests::do_not_optimize(utils::UUID_gen::get_time_UUID_bytes());
+    }
+    return count;
+}
+
+PERF_TEST_F(uuid_gen, random_time_uuid) {
+    auto now = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch());
+    for (size_t i = 0; i < count; i++) {
+        perf_tests::do_not_optimize(utils::UUID_gen::get_random_time_UUID_from_micros(now));
+    }
+    return count;
+}
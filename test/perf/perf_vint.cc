@@ -58,3 +58,14 @@ PERF_TEST_F(vint, deserialize) {
     }
     return count;
 }
+
+PERF_TEST_F(vint, deserialize_batch) {
+    auto src = serialized();
+    std::array<uint64_t, 16> batch;
+    for (auto i = 0u; i < count; i += batch.size()) {
+        auto out = std::span(batch).first(std::min(batch.size(), size_t(count - i)));
+        src.remove_prefix(unsigned_vint::deserialize_batch(src, out));
+        perf_tests::do_not_optimize(batch);
+    }
+    return count;
+}
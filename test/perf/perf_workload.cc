@@ -0,0 +1,427 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+// Runs a configurable workload against an in-process node with all its shards,
+// going through the CQL coordinator and replica paths. Unlike perf-simple-query,
+// which reads or writes a single narrow row with uniformly distributed keys,
+// this covers the shapes of real workloads: wide partitions, collections,
+// counters and TTLs, skewed (zipfian) key popularity, a mix of reads and writes
+// and the consistency level of the requests.
+//
+// Reports throughput, allocations, tasks and instructions per operation for
+// every iteration, like perf-simple-query, and latency percentiles over the
+// whole run.
+
+#include <boost/range/adaptor/transformed.hpp>
+#include <boost/range/irange.hpp>
+#include <json/json.h>
+
+#include <seastar/core/app-template.hh>
+#include <seastar/core/loop.hh>
+#include <seastar/core/smp.hh>
+#include <seastar/testing/test_runner.hh>
+
+#include "test/lib/cql_test_env.hh"
+#include "test/perf/perf.hh"
+#include "cql3/query_processor.hh"
+#include "db/config.hh"
+#include "types/types.hh"
+#include "utils/estimated_histogram.hh"
+
+#include <cmath>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+namespace {
+
+enum class schema_kind { simple, wide, collections, counters };
+
+std::ostream& operator<<(std::ostream& os, schema_kind k) {
+    switch (k) {
+        case schema_kind::simple: return os << "simple";
+        case schema_kind::wide: return os << "wide";
+        case schema_kind::collections: return os << "collections";
+        case schema_kind::counters: return os << "counters";
+    }
+    abort();
+}
+
+schema_kind parse_schema_kind(const std::string& name) {
+    for (auto k : {schema_kind::simple, schema_kind::wide, schema_kind::collections, schema_kind::counters}) {
+        std::ostringstream os;
+        os << k;
+        if (os.str() == name) {
+            return k;
+        }
+    }
+    throw std::invalid_argument(format("Unknown schema: {}, expected one of: simple, wide, collections, counters", name));
+}
+
+db::consistency_level parse_consistency_level(const std::string& name) {
+    for (auto i = int(db::consistency_level::MIN_VALUE); i <= int(db::consistency_level::MAX_VALUE); ++i) {
+        auto cl = db::consistency_level(i);
+        std::ostringstream os;
+        os << cl;
+        if (os.str() == name) {
+            return cl;
+        }
+    }
+    throw std::invalid_argument(format("Unknown consistency level: {}", name));
+}
+
+struct workload_config {
+    schema_kind schema;
+    unsigned partitions;
+    unsigned rows_per_partition;
+    unsigned collection_size;
+    unsigned value_size;
+    unsigned ttl;
+    std::optional<double> zipf_exponent;
+    double read_ratio;
+    db::consistency_level cl;
+    unsigned concurrency;
+    unsigned duration_in_seconds;
+    unsigned operations_per_shard = 0;
+    bool flush_memtables;
+    bool stop_on_error;
+};
+
+std::ostream& operator<<(std::ostream& os, const workload_config& cfg) {
+    os << "{schema=" << cfg.schema
+       << ", partitions=" << cfg.partitions;
+    if (cfg.schema == schema_kind::wide) {
+        os << ", rows_per_partition=" << cfg.rows_per_partition;
+    }
+    if (cfg.schema == schema_kind::collections) {
+        os << ", collection_size=" << cfg.collection_size;
+    }
+    os << ", value_size=" << cfg.value_size
+       << ", ttl=" << cfg.ttl
+       << ", distribution=";
+    if (cfg.zipf_exponent) {
+        os << "zipfian(" << *cfg.zipf_exponent << ")";
+    } else {
+        os << "uniform";
+    }
+    return os << ", read_ratio=" << cfg.read_ratio
+              << ", consistency_level=" << cfg.cl
+              << ", concurrency=" << cfg.concurrency
+              << "}";
+}
+
+// Draws ranks in [0, n) such that the probability of rank i is proportional
+// to 1 / (i + 1)^theta, with the method of Gray et al., "Quickly Generating
+// Billion-Record Synthetic Databases" (as used by YCSB). It requires
+// 0 < theta < 1, and computing zeta(n) once, in O(n).
+class zipfian_distribution {
+    uint64_t _n;
+    double _theta;
+    double _alpha;
+    double _zetan;
+    double _eta;
+
+    static double zeta(uint64_t n, double theta) {
+        double sum = 0;
+        for (uint64_t i = 1; i <= n; ++i) {
+            sum += 1 / std::pow(double(i), theta);
+        }
+        return sum;
+    }
+public:
+    zipfian_distribution(uint64_t n, double theta)
+            : _n(n)
+            , _theta(theta)
+            , _alpha(1 / (1 - theta))
+            , _zetan(zeta(n, theta))
+            , _eta((1 - std::pow(2.0 / n, 1 - theta)) / (1 - zeta(2, theta) / _zetan)) {
+        if (theta <= 0 || theta >= 1) {
+            throw std::invalid_argument(format("The zipfian exponent must be in (0, 1), got {}", theta));
+        }
+    }
+
+    template <typename Engine>
+    uint64_t operator()(Engine& e) const {
+        auto u = std::uniform_real_distribution<double>(0, 1)(e);
+        auto uz = u * _zetan;
+        if (uz < 1) {
+            return 0;
+        }
+        if (uz < 1 + std::pow(0.5, _theta)) {
+            return 1;
+        }
+        return std::min<uint64_t>(_n - 1, _n * std::pow(_eta * u - _eta + 1, _alpha));
+    }
+};
+
+// Latencies of the operations executed on this shard, in microseconds.
+thread_local utils::estimated_histogram latencies(90);
+
+class workload {
+    using clk = std::chrono::steady_clock;
+
+    cql_test_env& _env;
+    const workload_config& _cfg;
+    std::optional<zipfian_distribution> _zipf;
+    bytes _value;
+    cql3::prepared_cache_key_type _read_id;
+    cql3::prepared_cache_key_type _write_id;
+public:
+    workload(cql_test_env& env, const workload_config& cfg)
+            : _env(env)
+            , _cfg(cfg)
+            , _value(bytes::initialized_later(), cfg.value_size) {
+        if (cfg.zipf_exponent) {
+            _zipf.emplace(cfg.partitions, *cfg.zipf_exponent);
+        }
+        std::fill(_value.begin(), _value.end(), int8_t(0x5a));
+    }
+
+    void create_table() {
+        switch (_cfg.schema) {
+        case schema_kind::simple:
+            _env.execute_cql("CREATE TABLE ks.cf (pk bigint PRIMARY KEY, c0 blob, c1 blob, c2 blob, c3 blob, c4 blob)").get();
+            break;
+        case schema_kind::wide:
+            _env.execute_cql("CREATE TABLE ks.cf (pk bigint, ck bigint, v blob, PRIMARY KEY (pk, ck))").get();
+            break;
+        case schema_kind::collections:
+            _env.execute_cql("CREATE TABLE ks.cf (pk bigint PRIMARY KEY, m map<int, blob>)").get();
+            break;
+        case schema_kind::counters:
+            if (_cfg.ttl) {
+                throw std::invalid_argument("Counters cannot have a TTL");
+            }
+            _env.execute_cql("CREATE TABLE ks.cf (pk bigint PRIMARY KEY, c counter)").get();
+            break;
+        }
+    }
+
+    void prepare() {
+        auto using_ttl = _cfg.ttl ? format(" USING TTL {}", _cfg.ttl) : sstring();
+        sstring read_query;
+        sstring write_query;
+        switch (_cfg.schema) {
+        case schema_kind::simple:
+            read_query = "SELECT c0, c1, c2, c3, c4 FROM ks.cf WHERE pk = ?";
+            write_query = format("UPDATE ks.cf{} SET c0 = ?, c1 = ?, c2 = ?, c3 = ?, c4 = ? WHERE pk = ?", using_ttl);
+            break;
+        case schema_kind::wide:
+            read_query = "SELECT v FROM ks.cf WHERE pk = ? AND ck = ?";
+            write_query = format("UPDATE ks.cf{} SET v = ? WHERE pk = ? AND ck = ?", using_ttl);
+            break;
+        case schema_kind::collections:
+            read_query = "SELECT m FROM ks.cf WHERE pk = ?";
+            write_query = format("UPDATE ks.cf{} SET m[?] = ? WHERE pk = ?", using_ttl);
+            break;
+        case schema_kind::counters:
+            read_query = "SELECT c FROM ks.cf WHERE pk = ?";
+            write_query = "UPDATE ks.cf SET c = c + 1 WHERE pk = ?";
+            break;
+        }
+        _read_id = _env.prepare(std::move(read_query)).get0();
+        _write_id = _env.prepare(std::move(write_query)).get0();
+    }
+
+    // Writes every row (or collection element) of every partition once.
+    void populate() {
+        auto items = _cfg.schema == schema_kind::wide ? _cfg.rows_per_partition
+                : _cfg.schema == schema_kind::collections ? _cfg.collection_size
+                : 1;
+        std::cout << "Populating " << _cfg.partitions << " partitions with " << items << " items each..." << std::endl;
+        max_concurrent_for_each(boost::irange<uint64_t>(0, uint64_t(_cfg.partitions) * items), 100, [this, items] (uint64_t i) {
+            return write(i / items, i % items);
+        }).get();
+
+        if (_cfg.flush_memtables) {
+            std::cout << "Flushing partitions..." << std::endl;
+            _env.db().invoke_on_all(&replica::database::flush_all_memtables).get();
+        }
+    }
+
+    future<> run_operation() const {
+        auto& e = seastar::testing::local_random_engine;
+        auto pk = _zipf ? (*_zipf)(e) : std::uniform_int_distribution<uint64_t>(0, _cfg.partitions - 1)(e);
+        auto is_read = std::uniform_real_distribution<double>(0, 1)(e) < _cfg.read_ratio;
+        auto items = _cfg.schema == schema_kind::wide ? _cfg.rows_per_partition
+                : _cfg.schema == schema_kind::collections ? _cfg.collection_size
+                : 1;
+        auto item = std::uniform_int_distribution<uint64_t>(0, items - 1)(e);
+        auto start = clk::now();
+        return (is_read ? read(pk, item) : write(pk, item)).then([start] {
+            latencies.add(std::chrono::duration_cast<std::chrono::microseconds>(clk::now() - start).count());
+        });
+    }
+
+private:
+    static cql3::raw_value bigint(uint64_t v) {
+        return cql3::raw_value::make_value(long_type->decompose(int64_t(v)));
+    }
+
+    future<> read(uint64_t pk, uint64_t item) const {
+        cql3::raw_value_vector_with_unset values({bigint(pk)});
+        if (_cfg.schema == schema_kind::wide) {
+            values = cql3::raw_value_vector_with_unset({bigint(pk), bigint(item)});
+        }
+        return _env.execute_prepared(_read_id, std::move(values), _cfg.cl).discard_result();
+    }
+
+    future<> write(uint64_t pk, uint64_t item) const {
+        auto value = [this] { return cql3::raw_value::make_value(_value); };
+        std::vector<cql3::raw_value> values;
+        switch (_cfg.schema) {
+        case schema_kind::simple:
+            values = {value(), value(), value(), value(), value(), bigint(pk)};
+            break;
+        case schema_kind::wide:
+            values = {value(), bigint(pk), bigint(item)};
+            break;
+        case schema_kind::collections:
+            values = {cql3::raw_value::make_value(int32_type->decompose(int32_t(item))), value(), bigint(pk)};
+            break;
+        case schema_kind::counters:
+            values = {bigint(pk)};
+            break;
+        }
+        return _env.execute_prepared(_write_id, cql3::raw_value_vector_with_unset(std::move(values)), _cfg.cl).discard_result();
+    }
+};
+
+utils::estimated_histogram gather_latencies() {
+    return map_reduce(boost::irange(0u, smp::count), [] (unsigned shard) {
+        return smp::submit_to(shard, [] { return latencies; });
+    }, utils::estimated_histogram(90), utils::estimated_histogram_merge).get0();
+}
+
+void write_json_result(std::string result_file, const workload_config& cfg, perf_result median, double mad,
+        const utils::estimated_histogram& lat) {
+    Json::Value results;
+
+    Json::Value params;
+    std::ostringstream os;
+    os << cfg;
+    params["workload"] = os.str();
+    params["cpus"] = smp::count;
+    params["duration"] = cfg.duration_in_seconds;
+    results["parameters"] = std::move(params);
+
+    Json::Value stats;
+    stats["median tps"] = median.throughput;
+    stats["allocs_per_op"] = median.mallocs_per_op;
+    stats["tasks_per_op"] = median.tasks_per_op;
+    stats["instructions_per_op"] = median.instructions_per_op;
+    stats["mad tps"] = mad;
+    stats["p50 latency us"] = Json::Int64(lat.percentile(0.5));
+    stats["p95 latency us"] = Json::Int64(lat.percentile(0.95));
+    stats["p99 latency us"] = Json::Int64(lat.percentile(0.99));
+    stats["p999 latency us"] = Json::Int64(lat.percentile(0.999));
+    stats["max latency us"] = Json::Int64(lat.max());
+    results["stats"] = std::move(stats);
+
+    auto out = std::ofstream(result_file);
+    out << results;
+}
+
+} // anonymous namespace
+
+namespace perf {
+
+int scylla_workload_main(int argc, char** argv) {
+    namespace bpo = boost::program_options;
+    app_template app;
+    app.add_options()
+        ("random-seed", bpo::value<unsigned>(), "Random number generator seed")
+        ("schema", bpo::value<std::string>()->default_value("simple"), "table shape: simple (5 blob columns), wide (rows of a blob), collections (a map<int, blob>) or counters")
+        ("partitions", bpo::value<unsigned>()->default_value(10000), "number of partitions")
+        ("rows-per-partition", bpo::value<unsigned>()->default_value(100), "number of rows in each partition, for the wide schema")
+        ("collection-size", bpo::value<unsigned>()->default_value(10), "number of elements in each collection, for the collections schema")
+        ("value-size", bpo::value<unsigned>()->default_value(64), "size of the written blobs")
+        ("ttl", bpo::value<unsigned>()->default_value(0), "TTL of the written data in seconds, 0 for none")
+        ("zipfian", bpo::value<double>(), "pick the partitions with a zipfian distribution of given exponent, in (0, 1), instead of uniformly")
+        ("read-ratio", bpo::value<double>()->default_value(0.5), "fraction of the operations which are reads, the rest are writes")
+        ("consistency-level", bpo::value<std::string>()->default_value("ONE"), "consistency level of the operations")
+        ("duration", bpo::value<unsigned>()->default_value(5), "test duration in seconds")
+        ("concurrency", bpo::value<unsigned>()->default_value(100), "workers per core")
+        ("operations-per-shard", bpo::value<unsigned>(), "run this many operations per shard (overrides duration)")
+        ("flush", "flush memtables before test")
+        ("enable-cache", bpo::value<bool>()->default_value(true), "enable row cache")
+        ("stop-on-error", bpo::value<bool>()->default_value(true), "stop after encountering the first error")
+        ("json-result", bpo::value<std::string>(), "name of the json result file")
+        ;
+
+    set_abort_on_internal_error(true);
+
+    return app.run(argc, argv, [&app] {
+        auto conf_seed = app.configuration()["random-seed"];
+        auto seed = conf_seed.empty() ? std::random_device()() : conf_seed.as<unsigned>();
+        std::cout << "random-seed=" << seed << '\n';
+        return smp::invoke_on_all([seed] {
+            seastar::testing::local_random_engine.seed(seed + this_shard_id());
+        }).then([&app] () -> future<> {
+            auto db_cfg = ::make_shared<db::config>();
+            db_cfg->enable_cache(app.configuration()["enable-cache"].as<bool>());
+            cql_test_config cfg(db_cfg);
+          return do_with_cql_env_thread([&app] (cql_test_env& env) {
+            auto& opts = app.configuration();
+            auto cfg = workload_config();
+            cfg.schema = parse_schema_kind(opts["schema"].as<std::string>());
+            cfg.partitions = opts["partitions"].as<unsigned>();
+            cfg.rows_per_partition = opts["rows-per-partition"].as<unsigned>();
+            cfg.collection_size = opts["collection-size"].as<unsigned>();
+            cfg.value_size = opts["value-size"].as<unsigned>();
+            cfg.ttl = opts["ttl"].as<unsigned>();
+            if (opts.contains("zipfian")) {
+                cfg.zipf_exponent = opts["zipfian"].as<double>();
+            }
+            cfg.read_ratio = opts["read-ratio"].as<double>();
+            cfg.cl = parse_consistency_level(opts["consistency-level"].as<std::string>());
+            cfg.duration_in_seconds = opts["duration"].as<unsigned>();
+            cfg.concurrency = opts["concurrency"].as<unsigned>();
+            if (opts.contains("operations-per-shard")) {
+                cfg.operations_per_shard = opts["operations-per-shard"].as<unsigned>();
+            }
+            cfg.flush_memtables = opts.contains("flush");
+            cfg.stop_on_error = opts["stop-on-error"].as<bool>();
+
+            std::cout << "Running test with config: " << cfg << std::endl;
+            workload w(env, cfg);
+            w.create_table();
+            w.prepare();
+            w.populate();
+            smp::invoke_on_all([] {
+                latencies.clear();
+            }).get();
+
+            auto results = time_parallel([&w] {
+                return w.run_operation();
+            }, cfg.concurrency, cfg.duration_in_seconds, cfg.operations_per_shard, cfg.stop_on_error);
+
+            auto compare_throughput = [] (perf_result a, perf_result b) { return a.throughput < b.throughput; };
+            std::sort(results.begin(), results.end(), compare_throughput);
+            auto median_result = results[results.size() / 2];
+            auto median = median_result.throughput;
+            auto absolute_deviations = boost::copy_range<std::vector<double>>(
+                    results
+                    | boost::adaptors::transformed(std::mem_fn(&perf_result::throughput))
+                    | boost::adaptors::transformed([&] (double r) { return abs(r - median); }));
+            std::sort(absolute_deviations.begin(), absolute_deviations.end());
+            auto mad = absolute_deviations[results.size() / 2];
+            auto lat = gather_latencies();
+            std::cout << format("\nmedian {}\nmedian absolute deviation: {:.2f}\n", median_result, mad);
+            std::cout << format("latency [us]: p50: {}, p95: {}, p99: {}, p999: {}, max: {}\n",
+                    lat.percentile(0.5), lat.percentile(0.95), lat.percentile(0.99), lat.percentile(0.999), lat.max());
+
+            if (opts.contains("json-result")) {
+                write_json_result(opts["json-result"].as<std::string>(), cfg, median_result, mad, lat);
+            }
+          }, std::move(cfg));
+        });
+    });
+}
+
+} // namespace perf
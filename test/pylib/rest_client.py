@@ -213,6 +213,21 @@ class ScyllaRESTAPIClient():
         assert(type(e) == str for e in data)
         return data
 
+    async def keyspace_flush(self, node_ip: str, keyspace: str, table: Optional[str] = None) -> None:
+        """Flush the memtables of the keyspace, or of one of its tables"""
+        params = {"cf": table} if table else None
+        await self.client.post(f"/storage_service/keyspace_flush/{keyspace}", host=node_ip, params=params)
+
+    async def take_snapshot(self, node_ip: str, keyspace: str, tag: str) -> None:
+        """Take a snapshot of the keyspace, named `tag`"""
+        await self.client.post("/storage_service/snapshots", host=node_ip, params={"kn": keyspace, "tag": tag})
+
+    async def load_new_sstables(self, node_ip: str, keyspace: str, table: str,
+                                load_and_stream: bool = False) -> None:
+        """Load the sstables of the table's upload directory, like `nodetool refresh`"""
+        await self.client.post(f"/storage_service/sstables/{keyspace}", host=node_ip,
+                               params={"cf": table, "load_and_stream": str(load_and_stream).lower()})
+
     async def get_logger_level(self, node_ip: str, logger: str) -> str:
         """Get logger level"""
         return await self.client.get_text(f"/system/logger/{logger}", host=node_ip)
@@ -203,7 +203,8 @@ class ScyllaServer:
                  logger: Union[logging.Logger, logging.LoggerAdapter],
                  cluster_name: str, ip_addr: str, seeds: List[str],
                  cmdline_options: List[str],
-                 config_options: Dict[str, str]) -> None:
+                 config_options: Dict[str, str],
+                 property_file: Optional[Dict[str, str]] = None) -> None:
         # pylint: disable=too-many-arguments
         self.server_id = ServerNum(ScyllaServer.newid())
         self.exe = pathlib.Path(exe).resolve()
@@ -221,6 +222,8 @@ class ScyllaServer:
         self.workdir = self.vardir / shortname
         self.log_filename = (self.vardir / shortname).with_suffix(".log")
         self.config_filename = self.workdir / "conf/scylla.yaml"
+        # Contents of conf/cassandra-rackdc.properties, read by GossipingPropertyFileSnitch
+        self.property_file = property_file
         # Sum of basic server configuration and the user-provided config options.
         self.config = make_scylla_conf(
                 workdir = self.workdir,
@@ -284,6 +287,8 @@ class ScyllaServer:
             self.workdir.mkdir(parents=True, exist_ok=True)
             self.config_filename.parent.mkdir(parents=True, exist_ok=True)
             self._write_config_file()
+            if self.property_file:
+                self._write_property_file()
 
             self.log_file = self.log_filename.open("wb")
         except:
@@ -566,6 +571,12 @@ class ScyllaServer:
         with self.config_filename.open('w') as config_file:
             yaml.dump(self.config, config_file)
 
+    def _write_property_file(self) -> None:
+        assert self.property_file
+        with (self.config_filename.parent / "cassandra-rackdc.properties").open('w') as property_file:
+            for key, value in self.property_file.items():
+                property_file.write(f"{key}={value}\n")
+
 
 class ScyllaCluster:
     """A cluster of Scylla servers providing an API for changes"""
@@ -584,6 +595,7 @@ class ScyllaCluster:
         seeds: List[str]
         config_from_test: dict[str, str]
         cmdline_from_test: List[str]
+        property_file: Optional[dict[str, str]]
 
     def __init__(self, logger: Union[logging.Logger, logging.LoggerAdapter],
                  host_registry: HostRegistry, replicas: int,
@@ -669,7 +681,8 @@ class ScyllaCluster:
     def _seeds(self) -> List[str]:
         return [server.ip_addr for server in self.running.values()]
 
-    async def add_server(self, replace_cfg: Optional[ReplaceConfig] = None, cmdline: Optional[List[str]] = None, config: Optional[dict[str, str]] = None, start: bool = True) -> ServerInfo:
+    async def add_server(self, replace_cfg: Optional[ReplaceConfig] = None, cmdline: Optional[List[str]] = None, config: Optional[dict[str, str]] = None, start: bool = True,
+                         property_file: Optional[dict[str, str]] = None) -> ServerInfo:
         """Add a new server to the cluster"""
         self.is_dirty = True
 
@@ -708,7 +721,8 @@ class ScyllaCluster:
             ip_addr = ip_addr,
             seeds = seeds,
             config_from_test = extra_config,
-            cmdline_from_test = cmdline or []
+            cmdline_from_test = cmdline or [],
+            property_file = property_file
         )
 
         try:
@@ -1127,7 +1141,8 @@ class ScyllaClusterManager:
         assert self.cluster
         data = await request.json()
         replace_cfg = ReplaceConfig(**data["replace_cfg"]) if "replace_cfg" in data else None
-        s_info = await self.cluster.add_server(replace_cfg, data.get('cmdline'), data.get('config'), data.get('start', True))
+        s_info = await self.cluster.add_server(replace_cfg, data.get('cmdline'), data.get('config'), data.get('start', True),
+                                              data.get('property_file'))
         return aiohttp.web.json_response({"server_id" : s_info.server_id,
                                           "ip_addr": s_info.ip_addr})
 
@@ -36,7 +36,6 @@ def test_hset_hget_delete(redis_host, redis_port):
     assert r.delete(key) == 1
     assert r.hget(key, field) == None 
 
-@pytest.mark.xfail(reason="HSET command does not support multiple key/field")
 def test_hset_multiple_key_field(redis_host, redis_port):
     # This test requires the library to support multiple mappings in one
     # command, or we cannot test this feature. This was added to redis-py
@@ -52,7 +51,6 @@ def test_hset_multiple_key_field(redis_host, redis_port):
 
     assert r.hset(key, None, None, {field: val, field2: val2}) == 2
 
-@pytest.mark.xfail(reason="HSET command does not support return of changes, it always return 1")
 def test_hset_return_changes(redis_host, redis_port):
     r = connect(redis_host, redis_port)
     key = random_string(10)
@@ -62,6 +60,22 @@ def test_hset_return_changes(redis_host, redis_port):
     assert r.hset(key, field, val) == 1
     assert r.hset(key, field, val) == 0
 
+def test_hset_multiple_return_changes(redis_host, redis_port):
+    if Version(redis.__version__) < Version('3.5.0'):
+        pytest.skip('redis-py library too old to run this test')
+    r = connect(redis_host, redis_port)
+    key = random_string(10)
+    field = random_string(10)
+    field2 = random_string(10)
+    field3 = random_string(10)
+    val = random_string(10)
+
+    assert r.hset(key, field, val) == 1
+    # Only the fields which didn't exist are counted.
+    assert r.hset(key, None, None, {field: random_string(10), field2: val, field3: val}) == 2
+    assert r.hset(key, None, None, {field2: val, field3: val}) == 0
+    assert r.hget(key, field2) == val
+
 def test_hget_nonexistent_key(redis_host, redis_port):
     r = connect(redis_host, redis_port)
     key = random_string(10)
@@ -231,3 +231,28 @@ def test_strlen_wrongtype(redis_host, redis_port):
         r.strlen(key1)
     except redis.exceptions.ResponseError as ex:
         assert str(ex) == 'WRONGTYPE Operation against a key holding the wrong kind of value'
+
+def test_pipeline(redis_host, redis_port):
+    r = connect(redis_host, redis_port)
+    keys = [random_string(10) for _ in range(20)]
+    vals = [random_string(10) for _ in range(20)]
+
+    # Commands touching different keys run concurrently, but those touching
+    # the same key run, and all replies come back, in the order sent.
+    p = r.pipeline(transaction=False)
+    for key, val in zip(keys, vals):
+        p.set(key, val)
+        p.get(key)
+    p.set(keys[0], 'overwritten')
+    p.get(keys[0])
+    p.delete(*keys[1:])
+    p.get(keys[1])
+    p.ping()
+    replies = p.execute()
+    expected = []
+    for val in vals:
+        expected += [True, val]
+    expected += [True, 'overwritten', len(keys) - 1, None, True]
+    assert replies == expected
+    assert r.get(keys[0]) == 'overwritten'
+    r.delete(keys[0])
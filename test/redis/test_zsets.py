@@ -0,0 +1,80 @@
+#
+# Copyright 2023-present ScyllaDB
+#
+# SPDX-License-Identifier: AGPL-3.0-or-later
+#
+
+import pytest
+import redis
+import logging
+from util import random_string, connect
+
+logger = logging.getLogger('redis-test')
+
+def test_zadd_zscore(redis_host, redis_port):
+    r = connect(redis_host, redis_port)
+    key = random_string(10)
+
+    with pytest.raises(redis.exceptions.ResponseError) as excinfo:
+        r.execute_command("ZADD testkey 1")
+    assert "wrong number of arguments for 'zadd' command" in str(excinfo.value)
+
+    with pytest.raises(redis.exceptions.ResponseError) as excinfo:
+        r.execute_command("ZADD testkey notafloat member")
+    assert "value is not a valid float" in str(excinfo.value)
+
+    assert r.zadd(key, {'a': 1, 'b': 2.5}) == 2
+    assert r.zscore(key, 'a') == 1
+    assert r.zscore(key, 'b') == 2.5
+    assert r.zscore(key, 'c') == None
+    assert r.zcard(key) == 2
+
+    # Updating a score doesn't add a member
+    assert r.zadd(key, {'a': 3, 'c': 0}) == 1
+    assert r.zscore(key, 'a') == 3
+    assert r.zcard(key) == 3
+    assert r.zrangebyscore(key, '-inf', '+inf') == ['c', 'b', 'a']
+
+    assert r.delete(key) == 1
+    assert r.zcard(key) == 0
+
+def test_zrem(redis_host, redis_port):
+    r = connect(redis_host, redis_port)
+    key = random_string(10)
+
+    r.zadd(key, {'a': 1, 'b': 2, 'c': 3})
+    assert r.zrem(key, 'a', 'c', 'nonexistent') == 2
+    assert r.zrem(key, 'a') == 0
+    assert r.zrangebyscore(key, '-inf', '+inf', withscores=True) == [('b', 2)]
+
+def test_zrangebyscore(redis_host, redis_port):
+    r = connect(redis_host, redis_port)
+    key = random_string(10)
+
+    # Members with the same score are ordered by member
+    r.zadd(key, {'e': 5, 'd': 4, 'c': 3, 'b2': 2, 'b1': 2, 'a': -1.5})
+    assert r.zrangebyscore(key, 2, 4) == ['b1', 'b2', 'c', 'd']
+    assert r.zrangebyscore(key, '(2', '(4') == ['c']
+    assert r.zrangebyscore(key, '-inf', 0, withscores=True) == [('a', -1.5)]
+    assert r.zrangebyscore(key, '(3', '+inf') == ['d', 'e']
+    assert r.zrangebyscore(key, 4, 2) == []
+    assert r.zrangebyscore(key, '(3', 3) == []
+    assert r.zrangebyscore(key, '+inf', '+inf') == []
+
+    assert r.zrangebyscore(key, '-inf', '+inf', start=1, num=3) == ['b1', 'b2', 'c']
+    assert r.zrangebyscore(key, '-inf', '+inf', start=4, num=-1) == ['d', 'e']
+    assert r.zrangebyscore(key, '-inf', '+inf', start=10, num=2) == []
+
+    with pytest.raises(redis.exceptions.ResponseError) as excinfo:
+        r.execute_command(f"ZRANGEBYSCORE {key} a 1")
+    assert "min or max is not a float" in str(excinfo.value)
+
+    with pytest.raises(redis.exceptions.ResponseError) as excinfo:
+        r.execute_command(f"ZRANGEBYSCORE {key} 1 2 BOGUS")
+    assert "syntax error" in str(excinfo.value)
+
+def test_zrangebyscore_nonexistent_key(redis_host, redis_port):
+    r = connect(redis_host, redis_port)
+    key = random_string(10)
+
+    assert r.zrangebyscore(key, '-inf', '+inf') == []
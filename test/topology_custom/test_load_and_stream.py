@@ -0,0 +1,82 @@
+#
+# Copyright (C) 2023-present ScyllaDB
+#
+# SPDX-License-Identifier: AGPL-3.0-or-later
+#
+"""
+Test load-and-stream (nodetool refresh --load-and-stream) of many sstables, which are streamed in batches.
+"""
+import glob
+import logging
+import os
+import shutil
+import time
+from test.pylib.manager_client import ManagerClient
+from test.pylib.rest_client import HTTPError, inject_error
+from test.pylib.util import unique_name
+from test.topology.util import wait_for_token_ring_and_group0_consistency
+from cassandra.query import SimpleStatement              # type: ignore
+from cassandra import ConsistencyLevel                   # type: ignore
+import pytest
+
+logger = logging.getLogger(__name__)
+
+# More than the 16 sstables of a batch, so a single shard streams several batches.
+NUM_SSTABLES = 40
+ROWS_PER_SSTABLE = 10
+
+
+def sstable_files(table_dir: str) -> set[str]:
+    """Names of the sstable components in the directory"""
+    return {f for f in os.listdir(table_dir) if f.endswith('.db') or f.endswith('.txt') or f.endswith('.crc32')}
+
+
+@pytest.mark.asyncio
+async def test_load_and_stream_batches(manager: ManagerClient) -> None:
+    """Load-and-stream sends all the data of several batches of sstables, to all the nodes, and
+       removes the sstables only once they were streamed. When a destination fails, the error
+       is returned and all the sstables are kept, so loading can be retried."""
+    server = await manager.server_add(cmdline=['--smp', '1'])
+    cql = manager.cql
+    assert cql
+    ks = unique_name()
+    await cql.run_async(f"CREATE KEYSPACE {ks} WITH REPLICATION = {{'class': 'SimpleStrategy', 'replication_factor': 1}}")
+    for table in ['src', 'dst']:
+        await cql.run_async(f"CREATE TABLE {ks}.{table} (pk int PRIMARY KEY, v int) WITH compaction = {{'class': 'NullCompactionStrategy'}}")
+
+    insert = cql.prepare(f"INSERT INTO {ks}.src (pk, v) VALUES (?, ?)")
+    for i in range(NUM_SSTABLES):
+        for pk in range(i * ROWS_PER_SSTABLE, (i + 1) * ROWS_PER_SSTABLE):
+            await cql.run_async(insert, [pk, pk])
+        await manager.api.keyspace_flush(server.ip_addr, ks, 'src')
+    expected = [(pk, pk) for pk in range(NUM_SSTABLES * ROWS_PER_SSTABLE)]
+
+    # The sstables of src, which has all the data while the node is alone, are loaded into dst
+    # once a second node owns part of the ring, so they are streamed to both nodes.
+    other = await manager.server_add()
+    await wait_for_token_ring_and_group0_consistency(manager, time.time() + 30)
+
+    tag = unique_name()
+    await manager.api.take_snapshot(server.ip_addr, ks, tag)
+    data_dir = os.path.join((await manager.server_get_config(server.server_id))['workdir'], 'data', ks)
+    [src_dir] = glob.glob(os.path.join(data_dir, 'src-*'))
+    [dst_dir] = glob.glob(os.path.join(data_dir, 'dst-*'))
+    snapshot_dir = os.path.join(src_dir, 'snapshots', tag)
+    upload_dir = os.path.join(dst_dir, 'upload')
+    files = sstable_files(snapshot_dir)
+    assert len([f for f in files if f.endswith('-Data.db')]) == NUM_SSTABLES
+    for f in files:
+        shutil.copy(os.path.join(snapshot_dir, f), upload_dir)
+
+    logger.info("Loading with a failing destination")
+    async with inject_error(manager.api, other.ip_addr, 'stream_mutation_fragments_rx_error'):
+        with pytest.raises(HTTPError, match="Failed to load new sstables"):
+            await manager.api.load_new_sstables(server.ip_addr, ks, 'dst', load_and_stream=True)
+    assert sstable_files(upload_dir) == files
+
+    logger.info("Loading again")
+    await manager.api.load_new_sstables(server.ip_addr, ks, 'dst', load_and_stream=True)
+    assert not sstable_files(upload_dir)
+
+    rows = await cql.run_async(SimpleStatement(f"SELECT pk, v FROM {ks}.dst", consistency_level=ConsistencyLevel.ALL))
+    assert sorted((r.pk, r.v) for r in rows) == expected
@@ -0,0 +1,70 @@
+#
+# Copyright (C) 2023-present ScyllaDB
+#
+# SPDX-License-Identifier: AGPL-3.0-or-later
+#
+"""
+Test batching of writes sent to replicas in other datacenters (remote_dc_write_batch_window_in_us).
+"""
+import asyncio
+import logging
+import time
+from test.pylib.manager_client import ManagerClient
+from test.pylib.rest_client import TCPRESTClient
+from test.pylib.util import unique_name
+from test.topology.util import wait_for_token_ring_and_group0_consistency
+from cassandra.query import SimpleStatement              # type: ignore
+from cassandra import ConsistencyLevel                   # type: ignore
+import pytest
+
+logger = logging.getLogger(__name__)
+
+
+async def sent_mutation_batches(ip_addr: str) -> dict[str, float]:
+    """Returns the number of mutation batches the node sent, by scheduling group"""
+    metrics = await TCPRESTClient(9180).get_text("/metrics", host=ip_addr)
+    ret: dict[str, float] = {}
+    for line in metrics.split('\n'):
+        if not line.startswith('scylla_storage_proxy_coordinator_sent_mutation_batches{'):
+            continue
+        labels, value = line[line.find('{') + 1:].split('}')
+        group = dict(kv.split('=') for kv in labels.split(','))['scheduling_group_name'].strip('"')
+        ret[group] = ret.get(group, 0) + float(value)
+    return ret
+
+
+@pytest.mark.asyncio
+async def test_remote_dc_write_batching(manager: ManagerClient) -> None:
+    """Concurrent writes to another datacenter share messages when the window is enabled,
+       and those messages are sent under the scheduling group of the writes, rather than
+       the one of the timer flushing them."""
+    config = {'endpoint_snitch': 'GossipingPropertyFileSnitch',
+              'remote_dc_write_batch_window_in_us': 10000}
+    servers = []
+    for dc in ['dc1', 'dc2']:
+        for _ in range(2):
+            servers.append(await manager.server_add(config=config, property_file={'dc': dc, 'rack': 'r1'}))
+    await wait_for_token_ring_and_group0_consistency(manager, time.time() + 30)
+
+    cql = manager.cql
+    assert cql
+    ks = unique_name()
+    await cql.run_async(f"CREATE KEYSPACE {ks} WITH REPLICATION = "
+                        "{'class': 'NetworkTopologyStrategy', 'dc1': 2, 'dc2': 2}")
+    await cql.run_async(f"CREATE TABLE {ks}.t (pk int PRIMARY KEY, v int)")
+
+    insert = cql.prepare(f"INSERT INTO {ks}.t (pk, v) VALUES (?, ?)")
+    insert.consistency_level = ConsistencyLevel.ALL
+    for _ in range(10):
+        await asyncio.gather(*[cql.run_async(insert, [pk, pk]) for pk in range(100)])
+
+    rows = await cql.run_async(SimpleStatement(f"SELECT pk, v FROM {ks}.t", consistency_level=ConsistencyLevel.ALL))
+    assert sorted((r.pk, r.v) for r in rows) == [(pk, pk) for pk in range(100)]
+
+    batches: dict[str, float] = {}
+    for s in servers:
+        for group, n in (await sent_mutation_batches(s.ip_addr)).items():
+            batches[group] = batches.get(group, 0) + n
+    logger.info(f"Sent mutation batches by scheduling group: {batches}")
+    assert sum(batches.values()) > 0
+    assert batches.get('main', 0) == 0
@@ -6,6 +6,7 @@
  * SPDX-License-Identifier: AGPL-3.0-or-later
  */
 
+#include <algorithm>
 #include <chrono>
 #include <boost/icl/interval.hpp>
 #include <boost/icl/interval_map.hpp>
@@ -54,6 +55,51 @@ void tombstone_gc_state::drop_repair_history_map_for_table(const table_id& id) {
     _repair_history_maps->erase(id);
 }
 
+tombstone_gc_watermarks::tombstone_gc_watermarks(table_id id, const repair_history_map* m, std::chrono::seconds propagation_delay)
+    : _table_id(id)
+{
+    if (!m) {
+        return;
+    }
+    _entries.reserve(m->map.iterative_size());
+    for (const auto& [interval, repair_time] : m->map) {
+        _entries.push_back(entry{
+            dht::token_range(locator::token_metadata::interval_to_range(interval)),
+            saturating_subtract(repair_time, propagation_delay)});
+    }
+}
+
+std::optional<gc_clock::time_point> tombstone_gc_watermarks::get_gc_before(const dht::token& t) const {
+    auto it = std::partition_point(_entries.begin(), _entries.end(), [&] (const entry& e) {
+        return e.range.after(t, dht::token_comparator{});
+    });
+    if (it == _entries.end() || it->range.before(t, dht::token_comparator{})) {
+        return std::nullopt;
+    }
+    return it->gc_before;
+}
+
+tombstone_gc_state tombstone_gc_state::with_watermarks(const schema& s) const {
+    const auto& options = s.tombstone_gc_options();
+    if (!_repair_history_maps || options.mode() != tombstone_gc_mode::repair) {
+        return *this;
+    }
+    auto m = get_repair_history_map_for_table(s.id());
+    auto ret = *this;
+    ret._watermarks = seastar::make_lw_shared<tombstone_gc_watermarks>(s.id(), m.get(), options.propagation_delay_in_seconds());
+    return ret;
+}
+
+void tombstone_gc_state::note_tombstone_retained_for_repair(const schema& s) noexcept {
+    if (_watermarks && _watermarks->id() == s.id()) {
+        _watermarks->note_tombstone_retained_for_repair();
+    }
+}
+
+uint64_t tombstone_gc_state::tombstones_retained_for_repair() const noexcept {
+    return _watermarks ? _watermarks->tombstones_retained_for_repair() : 0;
+}
+
 // This is useful for a sstable to query a gc_before for a range. The range is
 // defined by the first and last key in the sstable.
 //
@@ -140,6 +186,12 @@ gc_clock::time_point tombstone_gc_state::get_gc_before_for_key(schema_ptr s, con
         const std::chrono::seconds& propagation_delay = options.propagation_delay_in_seconds();
         auto gc_before = gc_clock::time_point::min();
         auto repair_timestamp = gc_clock::time_point::min();
+        if (_watermarks && _watermarks->id() == s->id()) {
+            gc_before = _watermarks->get_gc_before(dk.token()).value_or(gc_clock::time_point::min());
+            dblog.trace("Get gc_before for ks={}, table={}, dk={}, mode=repair, from watermarks, gc_before={}",
+                    s->ks_name(), s->cf_name(), dk, gc_before);
+            return gc_before;
+        }
         auto m = get_repair_history_map_for_table(s->id());
         if (m) {
             const auto it = m->map.find(dk.token());
@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include <optional>
+#include <vector>
 #include <seastar/core/shared_ptr.hh>
 #include "gc_clock.hh"
 #include "dht/token.hh"
@@ -34,8 +36,49 @@ using per_table_history_maps = std::unordered_map<table_id, seastar::lw_shared_p
 
 class tombstone_gc_options;
 
+// A flat copy of the repair history of a single table, with the propagation
+// delay already applied, taken once when a compaction starts. Looking up the
+// gc_before of a key is then a binary search over a sorted vector rather than
+// a lookup of the table's map in the shared per-table history maps.
+// Repairs finishing while the compaction runs are not seen, which only makes
+// it keep more tombstones than strictly needed.
+class tombstone_gc_watermarks {
+public:
+    struct entry {
+        dht::token_range range;
+        gc_clock::time_point gc_before;
+    };
+private:
+    table_id _table_id;
+    // Disjoint and sorted by token.
+    std::vector<entry> _entries;
+    uint64_t _tombstones_retained_for_repair = 0;
+public:
+    tombstone_gc_watermarks(table_id id, const repair_history_map* m, std::chrono::seconds propagation_delay);
+
+    const table_id& id() const noexcept {
+        return _table_id;
+    }
+    const std::vector<entry>& entries() const noexcept {
+        return _entries;
+    }
+    // Returns the gc_before of the repaired range containing the token,
+    // or std::nullopt if the token wasn't repaired yet.
+    std::optional<gc_clock::time_point> get_gc_before(const dht::token& t) const;
+
+    // Number of tombstones which could have been purged, if only the range
+    // they belong to was repaired.
+    uint64_t tombstones_retained_for_repair() const noexcept {
+        return _tombstones_retained_for_repair;
+    }
+    void note_tombstone_retained_for_repair() noexcept {
+        ++_tombstones_retained_for_repair;
+    }
+};
+
 class tombstone_gc_state {
     per_table_history_maps* _repair_history_maps;
+    seastar::lw_shared_ptr<tombstone_gc_watermarks> _watermarks;
 public:
     tombstone_gc_state() = delete;
     tombstone_gc_state(per_table_history_maps* maps) noexcept : _repair_history_maps(maps) {}
@@ -59,6 +102,18 @@ class tombstone_gc_state {
     gc_clock::time_point get_gc_before_for_key(schema_ptr s, const dht::decorated_key& dk, const gc_clock::time_point& query_time) const;
 
     void update_repair_time(table_id id, const dht::token_range& range, gc_clock::time_point repair_time);
+
+    // Returns a copy of this state which serves get_gc_before_for_key() for
+    // the table from a snapshot of its repair history, taken now.
+    // Copies of the returned state share the snapshot, along with its count
+    // of retained tombstones. The state is returned unchanged if the table
+    // doesn't use tombstone_gc_mode::repair.
+    tombstone_gc_state with_watermarks(const schema& s) const;
+
+    // Called by compaction for a tombstone it has to keep although
+    // its timestamp allows purging it, because the key has no repair time.
+    void note_tombstone_retained_for_repair(const schema& s) noexcept;
+    uint64_t tombstones_retained_for_repair() const noexcept;
 };
 
 void validate_tombstone_gc_options(const tombstone_gc_options* options, data_dictionary::database db, sstring ks_name);
@@ -8,9 +8,12 @@
 
 #include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/join.hpp>
+#include <boost/range/irange.hpp>
 #include <filesystem>
+#include <fstream>
 #include <source_location>
 #include <fmt/chrono.h>
+#include <fmt/ostream.h>
 #include <seastar/core/app-template.hh>
 #include <seastar/core/coroutine.hh>
 #include <seastar/util/closeable.hh>
@@ -36,6 +39,7 @@
 #include "tools/sstable_consumer.hh"
 #include "tools/utils.hh"
 #include "locator/host_id.hh"
+#include "partition_slice_builder.hh"
 
 using namespace seastar;
 
@@ -49,8 +53,6 @@ const auto app_name = "scylla-sstable";
 
 logging::logger sst_log(app_name);
 
-db::nop_large_data_handler large_data_handler;
-
 struct decorated_key_hash {
     std::size_t operator()(const dht::decorated_key& dk) const {
         return dht::token::to_int64(dk.token());
@@ -225,6 +227,59 @@ schema_ptr try_load_schema_autodetect(const bpo::variables_map& app_config) {
     return nullptr;
 }
 
+schema_ptr load_schema(const bpo::variables_map& app_config) {
+    unsigned schema_sources = 0;
+    schema_sources += !app_config["schema-file"].defaulted();
+    schema_sources += app_config.contains("system-schema");
+    schema_sources += app_config.contains("scylla-data-dir");
+    schema_sources += app_config.contains("scylla-yaml-file");
+
+    if (!schema_sources) {
+        sst_log.debug("No user-provided schema source, attempting to auto-detect it");
+        return try_load_schema_autodetect(app_config);
+    } else if (schema_sources == 1) {
+        sst_log.debug("Single schema source provided");
+        return try_load_schema_from_user_provided_source(app_config);
+    }
+    fmt::print(std::cerr, "Multiple schema sources provided, please provide exactly one of: --schema-file, --system-schema, --scylla-data-dir or --scylla-yaml-file (with the accompanying --keyspace and --table if necessary)\n");
+    return nullptr;
+}
+
+// The services needed to read and write sstables. Each shard reading sstables
+// has its own.
+class sstable_reading_environment {
+    db::config _dbcfg;
+    gms::feature_service _feature_service;
+    cache_tracker _tracker;
+    db::nop_large_data_handler _large_data_handler;
+    sstables::directory_semaphore _dir_sem;
+    sstables::sstables_manager _sst_man;
+    reader_concurrency_semaphore _rcs_sem;
+
+public:
+    sstable_reading_environment()
+        : _feature_service(gms::feature_config_from_db_config(_dbcfg))
+        , _dir_sem(1)
+        , _sst_man(_large_data_handler, _dbcfg, _feature_service, _tracker, memory::stats().total_memory(), _dir_sem)
+        , _rcs_sem(reader_concurrency_semaphore::no_limits{}, app_name)
+    {
+        _dbcfg.host_id = locator::host_id::create_random_id();
+    }
+
+    sstables::sstables_manager& manager() {
+        return _sst_man;
+    }
+
+    reader_permit make_permit(const schema_ptr& schema) {
+        return _rcs_sem.make_tracking_only_permit(schema.get(), app_name, db::no_timeout, {});
+    }
+
+    future<> stop() {
+        co_await _rcs_sem.stop();
+        co_await _sst_man.close();
+    }
+};
+
 const std::vector<sstables::shared_sstable> load_sstables(schema_ptr schema, sstables::sstables_manager& sst_man, const std::vector<sstring>& sstable_names) {
     std::vector<sstables::shared_sstable> sstables;
     sstables.resize(sstable_names.size());
@@ -555,49 +610,50 @@ namespace {
 class dumping_consumer : public sstable_consumer {
     class text_dumper : public sstable_consumer {
         const schema& _schema;
+        std::ostream& _os;
     public:
-        explicit text_dumper(const schema& s) : _schema(s) { }
+        text_dumper(const schema& s, std::ostream& os) : _schema(s), _os(os) { }
         virtual future<> consume_stream_start() override {
-            fmt::print("{{stream_start}}\n");
+            fmt::print(_os, "{{stream_start}}\n");
             return make_ready_future<>();
         }
         virtual future<stop_iteration> consume_sstable_start(const sstables::sstable* const sst) override {
-            fmt::print("{{sstable_start{}}}\n", sst ? fmt::format(": filename {}", sst->get_filename()) : "");
+            fmt::print(_os, "{{sstable_start{}}}\n", sst ? fmt::format(": filename {}", sst->get_filename()) : "");
             return make_ready_future<stop_iteration>(stop_iteration::no);
         }
         virtual future<stop_iteration> consume(partition_start&& ps) override {
-            fmt::print("{}\n", ps);
+            fmt::print(_os, "{}\n", ps);
             return make_ready_future<stop_iteration>(stop_iteration::no);
         }
         virtual future<stop_iteration> consume(static_row&& sr) override {
-            fmt::print("{}\n", static_row::printer(_schema, sr));
+            fmt::print(_os, "{}\n", static_row::printer(_schema, sr));
             return make_ready_future<stop_iteration>(stop_iteration::no);
         }
         virtual future<stop_iteration> consume(clustering_row&& cr) override {
-            fmt::print("{}\n", clustering_row::printer(_schema, cr));
+            fmt::print(_os, "{}\n", clustering_row::printer(_schema, cr));
             return make_ready_future<stop_iteration>(stop_iteration::no);
         }
         virtual future<stop_iteration> consume(range_tombstone_change&& rtc) override {
-            fmt::print("{}\n", rtc);
+            fmt::print(_os, "{}\n", rtc);
             return make_ready_future<stop_iteration>(stop_iteration::no);
         }
         virtual future<stop_iteration> consume(partition_end&& pe) override {
-            fmt::print("{{partition_end}}\n");
+            fmt::print(_os, "{{partition_end}}\n");
             return make_ready_future<stop_iteration>(stop_iteration::no);
         }
         virtual future<stop_iteration> consume_sstable_end() override {
-            fmt::print("{{sstable_end}}\n");
+            fmt::print(_os, "{{sstable_end}}\n");
             return make_ready_future<stop_iteration>(stop_iteration::no);
         }
         virtual future<> consume_stream_end() override {
-            fmt::print("{{stream_end}}\n");
+            fmt::print(_os, "{{stream_end}}\n");
             return make_ready_future<>();
         }
     };
     class json_dumper : public sstable_consumer {
         tools::mutation_fragment_json_writer _writer;
     public:
-        explicit json_dumper(const schema& s) : _writer(s) {}
+        json_dumper(const schema& s, std::ostream& os) : _writer(s, os) {}
         virtual future<> consume_stream_start() override {
             _writer.start_stream();
             return make_ready_future<>();
@@ -641,14 +697,13 @@ class dumping_consumer : public sstable_consumer {
     std::unique_ptr<sstable_consumer> _consumer;
 
 public:
-    explicit dumping_consumer(schema_ptr s, reader_permit, const bpo::variables_map& opts) : _schema(std::move(s)) {
-        _consumer = std::make_unique<text_dumper>(*_schema);
+    explicit dumping_consumer(schema_ptr s, reader_permit, const bpo::variables_map& opts, std::ostream& os = std::cout) : _schema(std::move(s)) {
         switch (get_output_format_from_options(opts, output_format::text)) {
             case output_format::text:
-                _consumer = std::make_unique<text_dumper>(*_schema);
+                _consumer = std::make_unique<text_dumper>(*_schema, os);
                 break;
             case output_format::json:
-                _consumer = std::make_unique<json_dumper>(*_schema);
+                _consumer = std::make_unique<json_dumper>(*_schema, os);
                 break;
         }
     }
@@ -751,6 +806,15 @@ class writetime_histogram_collecting_consumer : public sstable_consumer {
     }
 
 public:
+    // What a shard collected, merged into a single histogram in --parallel mode.
+    struct shard_result {
+        std::map<api::timestamp_type, uint64_t> histogram;
+        uint64_t partitions = 0;
+        uint64_t rows = 0;
+        uint64_t cells = 0;
+        uint64_t timestamps = 0;
+    };
+
     explicit writetime_histogram_collecting_consumer(schema_ptr s, reader_permit, const bpo::variables_map& vm) : _schema(std::move(s)) {
         auto it = vm.find("bucket");
         if (it != vm.end()) {
@@ -801,6 +865,18 @@ class writetime_histogram_collecting_consumer : public sstable_consumer {
     virtual future<stop_iteration> consume_sstable_end() override {
         return make_ready_future<stop_iteration>(stop_iteration::no);
     }
+    shard_result release_shard_result() {
+        return shard_result{std::exchange(_histogram, {}), _partitions, _rows, _cells, _timestamps};
+    }
+    void merge(const shard_result& r) {
+        for (const auto& [ts, count] : r.histogram) {
+            _histogram[ts] += count;
+        }
+        _partitions += r.partitions;
+        _rows += r.rows;
+        _cells += r.cells;
+        _timestamps += r.timestamps;
+    }
     virtual future<> consume_stream_end() override {
         if (_histogram.empty()) {
             sst_log.info("Histogram empty, no data to write");
@@ -883,7 +959,11 @@ stop_iteration consume_reader(flat_mutation_reader_v2 rd, sstable_consumer& cons
     return consumer.consume_sstable_end().get();
 }
 
+// Reads the partitions of pr and the clustering ranges of slice of the
+// sstables. The crawling reader reads everything, it can only be used with the
+// full range and slice.
 void consume_sstables(schema_ptr schema, reader_permit permit, std::vector<sstables::shared_sstable> sstables, bool merge, bool use_crawling_reader,
+        const dht::partition_range& pr, const query::partition_slice& slice,
         std::function<stop_iteration(flat_mutation_reader_v2&, sstables::sstable*)> reader_consumer) {
     sst_log.trace("consume_sstables(): {} sstables, merge={}, use_crawling_reader={}", sstables.size(), merge, use_crawling_reader);
     if (merge) {
@@ -893,7 +973,7 @@ void consume_sstables(schema_ptr schema, reader_permit permit, std::vector<sstab
             if (use_crawling_reader) {
                 readers.emplace_back(sst->make_crawling_reader(schema, permit));
             } else {
-                readers.emplace_back(sst->make_reader(schema, permit, query::full_partition_range, schema->full_slice()));
+                readers.emplace_back(sst->make_reader(schema, permit, pr, slice));
             }
         }
         auto rd = make_combined_reader(schema, permit, std::move(readers));
@@ -903,7 +983,7 @@ void consume_sstables(schema_ptr schema, reader_permit permit, std::vector<sstab
         for (const auto& sst : sstables) {
             auto rd = use_crawling_reader
                 ? sst->make_crawling_reader(schema, permit)
-                : sst->make_reader(schema, permit, query::full_partition_range, schema->full_slice());
+                : sst->make_reader(schema, permit, pr, slice);
 
             if (reader_consumer(rd, sst.get()) == stop_iteration::yes) {
                 break;
@@ -912,6 +992,12 @@ void consume_sstables(schema_ptr schema, reader_permit permit, std::vector<sstab
     }
 }
 
+void consume_sstables(schema_ptr schema, reader_permit permit, std::vector<sstables::shared_sstable> sstables, bool merge, bool use_crawling_reader,
+        std::function<stop_iteration(flat_mutation_reader_v2&, sstables::sstable*)> reader_consumer) {
+    consume_sstables(schema, std::move(permit), std::move(sstables), merge, use_crawling_reader, query::full_partition_range, schema->full_slice(),
+            std::move(reader_consumer));
+}
+
 using operation_func = void(*)(schema_ptr, reader_permit, const std::vector<sstables::shared_sstable>&, sstables::sstables_manager&, const bpo::variables_map&);
 
 class operation {
@@ -1371,6 +1457,7 @@ const char* to_string(sstables::scylla_metadata_type t) {
         case sstables::scylla_metadata_type::SSTableOrigin: return "sstable_origin";
         case sstables::scylla_metadata_type::ScyllaVersion: return "scylla_version";
         case sstables::scylla_metadata_type::ScyllaBuildId: return "scylla_build_id";
+        case sstables::scylla_metadata_type::ColumnValueStats: return "column_value_stats";
     }
     std::abort();
 }
@@ -1465,6 +1552,27 @@ class scylla_metadata_visitor : public boost::static_visitor<> {
         }
         _writer.EndObject();
     }
+    void operator()(const sstables::scylla_metadata::column_value_stats& val) const {
+        _writer.StartObject();
+        for (const auto& [k, v] : val.map) {
+            _writer.Key(disk_string_to_string(k));
+            _writer.StartObject();
+            _writer.Key("rows");
+            _writer.Uint64(v.rows);
+            _writer.Key("values");
+            _writer.Uint64(v.values);
+            _writer.Key("bounded");
+            _writer.Bool(v.bounded);
+            if (v.bounded) {
+                _writer.Key("min_value");
+                _writer.String(to_hex(v.min_value.value));
+                _writer.Key("max_value");
+                _writer.String(to_hex(v.max_value.value));
+            }
+            _writer.EndObject();
+        }
+        _writer.EndObject();
+    }
     template <typename Size>
     void operator()(const sstables::disk_string<Size>& val) const {
         _writer.String(disk_string_to_string(val));
@@ -2487,21 +2595,187 @@ void script_operation(schema_ptr schema, reader_permit permit, const std::vector
     consumer->consume_stream_end().get();
 }
 
+// The part of the ring selected by --start-token and --end-token (both
+// inclusive), or, if nr_shards > 1, the part of it the given shard reads in
+// --parallel mode. Disengaged if that part is empty.
+std::optional<dht::partition_range> get_partition_range(const bpo::variables_map& vm, unsigned shard = 0, unsigned nr_shards = 1) {
+    if (!vm.count("start-token") && !vm.count("end-token") && nr_shards == 1) {
+        return query::full_partition_range;
+    }
+    const int64_t first = vm.count("start-token") ? vm["start-token"].as<int64_t>() : std::numeric_limits<int64_t>::min();
+    const int64_t last = vm.count("end-token") ? vm["end-token"].as<int64_t>() : std::numeric_limits<int64_t>::max();
+    if (first > last) {
+        throw std::invalid_argument(fmt::format("error: start-token {} is greater than end-token {}", first, last));
+    }
+    const __int128 span = __int128(last) - first + 1;
+    const int64_t shard_first = first + span * shard / nr_shards;
+    const int64_t shard_last = first + span * (shard + 1) / nr_shards - 1;
+    if (shard_first > shard_last) {
+        return std::nullopt;
+    }
+    return dht::partition_range::make(
+            dht::ring_position::starting_at(dht::token::from_int64(shard_first)),
+            dht::ring_position::ending_at(dht::token::from_int64(shard_last)));
+}
+
+// The clustering range selected by --clustering-start and --clustering-end
+// (both inclusive).
+query::partition_slice get_partition_slice(const schema& schema, const bpo::variables_map& vm) {
+    if (!vm.count("clustering-start") && !vm.count("clustering-end")) {
+        return schema.full_slice();
+    }
+    auto get_bound = [&] (const char* name) -> std::optional<query::clustering_range::bound> {
+        if (!vm.count(name)) {
+            return std::nullopt;
+        }
+        auto ck_type = schema.clustering_key_prefix_type();
+        return query::clustering_range::bound(clustering_key_prefix::from_exploded(ck_type->components(managed_bytes_view(from_hex(vm[name].as<sstring>())))));
+    };
+    return partition_slice_builder(schema)
+        .with_range(query::clustering_range(get_bound("clustering-start"), get_bound("clustering-end")))
+        .build();
+}
+
+// Reads the part of the sstables within pr into the consumer, applying the
+// other filters of the command line.
+void consume_sstables_into(schema_ptr schema, reader_permit permit, const std::vector<sstables::shared_sstable>& sstables,
+        const bpo::variables_map& vm, const dht::partition_range& pr, sstable_consumer& consumer) {
+    const auto merge = vm.count("merge");
+    const auto no_skips = vm.count("no-skips");
+    const auto partitions = get_partitions(schema, vm);
+    const auto slice = get_partition_slice(*schema, vm);
+    const auto full_scan = pr.is_full() && !vm.count("clustering-start") && !vm.count("clustering-end");
+    const auto use_crawling_reader = full_scan && (no_skips || partitions.empty());
+    consume_sstables(schema, permit, sstables, merge, use_crawling_reader, pr, slice, [&] (flat_mutation_reader_v2& rd, sstables::sstable* sst) {
+        return consume_reader(std::move(rd), consumer, sst, partitions, no_skips);
+    });
+}
+
+// Runs func on all shards in parallel, each with its own schema, permit and
+// share of the sstables, and returns the results of the shards, in shard
+// order.
+//
+// The sstables are distributed among the shards round-robin, unless
+// all_sstables is set, in which case each shard reads all of them. Shard 0
+// gets the sstables loaded by the caller, the other shards load theirs.
+template <typename Func>
+auto run_on_all_shards(schema_ptr schema, reader_permit permit, const std::vector<sstables::shared_sstable>& sstables, const bpo::variables_map& vm,
+        bool all_sstables, Func func) {
+    using result_type = std::invoke_result_t<Func, schema_ptr, reader_permit, const std::vector<sstables::shared_sstable>&>;
+
+    auto share_of = [all_sstables] <typename T> (const std::vector<T>& v, unsigned shard) {
+        if (all_sstables) {
+            return v;
+        }
+        std::vector<T> share;
+        for (size_t i = shard; i < v.size(); i += smp::count) {
+            share.push_back(v[i]);
+        }
+        return share;
+    };
+    const auto& sstable_names = vm["sstables"].as<std::vector<sstring>>();
+
+    std::vector<result_type> results(smp::count);
+    parallel_for_each(boost::irange(0u, smp::count), [&] (unsigned shard) -> future<> {
+        if (shard == this_shard_id()) {
+            return async([&, shard] {
+                results[shard] = func(schema, permit, share_of(sstables, shard));
+            });
+        }
+        return smp::submit_to(shard, [&, shard] {
+            return async([&, shard] {
+                auto shard_schema = load_schema(vm);
+                if (!shard_schema) {
+                    throw std::runtime_error(fmt::format("error: failed to load the schema on shard {}", shard));
+                }
+                sstable_reading_environment env;
+                auto stop_env = deferred_stop(env);
+                const auto shard_sstables = load_sstables(shard_schema, env.manager(), share_of(sstable_names, shard));
+                return func(shard_schema, env.make_permit(shard_schema), shard_sstables);
+            });
+        }).then([&results, shard] (result_type result) {
+            results[shard] = std::move(result);
+        });
+    }).get();
+
+    return results;
+}
+
+// With --merge, the shards split the token range among them and each reads its
+// part of all the sstables. Otherwise each reads the whole of its share of the
+// sstables.
+std::optional<dht::partition_range> get_shard_partition_range(const bpo::variables_map& vm) {
+    return vm.count("merge") ? get_partition_range(vm, this_shard_id(), smp::count) : get_partition_range(vm);
+}
+
+// Reads the sstables on all shards in parallel, see --parallel.
+template <typename SstableConsumer>
+void consume_sstables_in_parallel(schema_ptr schema, reader_permit permit, const std::vector<sstables::shared_sstable>& sstables,
+        const bpo::variables_map& vm);
+
+// Each shard writes its own stream, into a file of the output directory.
+template <>
+void consume_sstables_in_parallel<dumping_consumer>(schema_ptr schema, reader_permit permit, const std::vector<sstables::shared_sstable>& sstables,
+        const bpo::variables_map& vm) {
+    const auto output_dir = std::filesystem::path(vm["output-dir"].as<std::string>());
+    const auto extension = get_output_format_from_options(vm, output_format::text) == output_format::json ? "json" : "txt";
+    const auto filenames = run_on_all_shards(schema, permit, sstables, vm, vm.count("merge"),
+            [&] (schema_ptr shard_schema, reader_permit shard_permit, const std::vector<sstables::shared_sstable>& shard_sstables) {
+        const auto filename = (output_dir / fmt::format("shard-{}.{}", this_shard_id(), extension)).native();
+        std::ofstream os(filename);
+        if (!os) {
+            throw std::runtime_error(fmt::format("error: failed to open output file {}", filename));
+        }
+        dumping_consumer consumer(shard_schema, shard_permit, vm, os);
+        consumer.consume_stream_start().get();
+        if (const auto pr = get_shard_partition_range(vm)) {
+            consume_sstables_into(shard_schema, shard_permit, shard_sstables, vm, *pr, consumer);
+        }
+        consumer.consume_stream_end().get();
+        os.close();
+        if (!os) {
+            throw std::runtime_error(fmt::format("error: failed to write output file {}", filename));
+        }
+        return filename;
+    });
+    for (const auto& filename : filenames) {
+        sst_log.info("Output written to {}", filename);
+    }
+}
+
+// The histograms collected by the shards are merged into a single one.
+template <>
+void consume_sstables_in_parallel<writetime_histogram_collecting_consumer>(schema_ptr schema, reader_permit permit,
+        const std::vector<sstables::shared_sstable>& sstables, const bpo::variables_map& vm) {
+    const auto results = run_on_all_shards(schema, permit, sstables, vm, vm.count("merge"),
+            [&] (schema_ptr shard_schema, reader_permit shard_permit, const std::vector<sstables::shared_sstable>& shard_sstables) {
+        writetime_histogram_collecting_consumer consumer(shard_schema, shard_permit, vm);
+        consumer.consume_stream_start().get();
+        if (const auto pr = get_shard_partition_range(vm)) {
+            consume_sstables_into(shard_schema, shard_permit, shard_sstables, vm, *pr, consumer);
+        }
+        return consumer.release_shard_result();
+    });
+    writetime_histogram_collecting_consumer consumer(schema, permit, vm);
+    for (const auto& result : results) {
+        consumer.merge(result);
+    }
+    consumer.consume_stream_end().get();
+}
+
 template <typename SstableConsumer>
 void sstable_consumer_operation(schema_ptr schema, reader_permit permit, const std::vector<sstables::shared_sstable>& sstables,
         sstables::sstables_manager& sst_man, const bpo::variables_map& vm) {
     if (sstables.empty()) {
         throw std::runtime_error("error: no sstables specified on the command line");
     }
-    const auto merge = vm.count("merge");
-    const auto no_skips = vm.count("no-skips");
-    const auto partitions = get_partitions(schema, vm);
-    const auto use_crawling_reader = no_skips || partitions.empty();
+    if (vm.count("parallel")) {
+        consume_sstables_in_parallel<SstableConsumer>(schema, permit, sstables, vm);
+        return;
+    }
     auto consumer = std::make_unique<SstableConsumer>(schema, permit, vm);
     consumer->consume_stream_start().get();
-    consume_sstables(schema, permit, sstables, merge, use_crawling_reader, [&, &consumer = *consumer] (flat_mutation_reader_v2& rd, sstables::sstable* sst) {
-        return consume_reader(std::move(rd), consumer, sst, partitions, no_skips);
-    });
+    consume_sstables_into(schema, permit, sstables, vm, *get_partition_range(vm), *consumer);
     consumer->consume_stream_end().get();
 }
 
@@ -2567,6 +2841,11 @@ const std::vector<option> all_options {
     typed_option<std::string>("validation-level", "clustering_key", "degree of validation on the output, one of (partition_region, token, partition_key, clustering_key)"),
     typed_option<std::string>("script-file", "script file to load and execute"),
     typed_option<program_options::string_map>("script-arg", {}, "parameter(s) for the script"),
+    typed_option<>("parallel", "read the sstables on all shards (see --smp) in parallel"),
+    typed_option<int64_t>("start-token", "first token of the token range to read (inclusive)"),
+    typed_option<int64_t>("end-token", "last token of the token range to read (inclusive)"),
+    typed_option<sstring>("clustering-start", "clustering key prefix the clustering range to read starts at (inclusive), in the hex format"),
+    typed_option<sstring>("clustering-end", "clustering key prefix the clustering range to read ends at (inclusive), in the hex format"),
 };
 
 const std::vector<operation> operations{
@@ -2585,10 +2864,38 @@ format.
 Supports both a text and JSON output. The text output uses the built-in scylla
 printers, which are also used when logging mutation-related data structures.
 
+With --parallel, all shards (see --smp) read the sstables in parallel and each
+writes its output into its own file, shard-$SHARD.txt or shard-$SHARD.json, in
+--output-dir. Without --merge, the sstables are distributed among the shards.
+With --merge, each shard reads its part of the token range from all the
+sstables, so the outputs of the shards, taken in shard order, are in token
+order.
+
 See https://docs.scylladb.com/operating-scylla/admin-tools/scylla-sstable#dump-data
 for more information on this operation, including the schema of the JSON output.
 )",
-            {"partition", "partitions-file", "merge", "no-skips", "output-format"},
+            {"partition", "partitions-file", "merge", "no-skips", "output-format", "parallel", "output-dir"},
+            sstable_consumer_operation<dumping_consumer>},
+/* query */
+    {"query",
+            "Dump the content of sstable(s) within a token range and a clustering range",
+R"(
+Same as dump-data, but only reads the partitions of the token range selected by
+--start-token and --end-token and, in them, the rows of the clustering range
+selected by --clustering-start and --clustering-end. All bounds are inclusive
+and optional. The clustering bounds are clustering key prefixes in the hex
+format, like the "raw" value of the clustering keys in the JSON output.
+
+Unlike the partitions filtered out by --partition and --partitions-file, the
+data outside the ranges is not read at all: the ranges are looked up in the
+index.
+
+With --parallel, the output is written like that of dump-data.
+
+See https://docs.scylladb.com/operating-scylla/admin-tools/scylla-sstable#query
+for more information on this operation.
+)",
+            {"partition", "partitions-file", "start-token", "end-token", "clustering-start", "clustering-end", "merge", "no-skips", "output-format", "parallel", "output-dir"},
             sstable_consumer_operation<dumping_consumer>},
 /* dump-index */
     {"dump-index",
@@ -2697,8 +3004,11 @@ following example python script:
      ax.bar(x, y)
 
      plt.show()
+
+With --parallel, the sstables are distributed among all shards (see --smp),
+which read them in parallel, and the histograms of the shards are merged.
 )",
-            {"bucket"},
+            {"bucket", "parallel"},
             sstable_consumer_operation<writetime_histogram_collecting_consumer>},
 /* validate */
     {"validate",
@@ -2876,6 +3186,9 @@ Generate a joint histogram for the specified partition:
 Validate the specified sstables:
 $ scylla sstable validate /path/to/md-123456-big-Data.db /path/to/md-123457-big-Data.db
 
+Dump the content of the sstables on 8 shards in parallel, into shard-0.json ... shard-7.json:
+$ scylla sstable dump-data --smp 8 --parallel --output-format json /path/to/*-Data.db
+
 
 )";
 
@@ -2923,47 +3236,22 @@ Validate the specified sstables:
 
             const auto& operation = *found_op;
 
-            schema_ptr schema;
-            {
-                unsigned schema_sources = 0;
-                schema_sources += !app_config["schema-file"].defaulted();
-                schema_sources += app_config.contains("system-schema");
-                schema_sources += app_config.contains("scylla-data-dir");
-                schema_sources += app_config.contains("scylla-yaml-file");
-
-                if (!schema_sources) {
-                    sst_log.debug("No user-provided schema source, attempting to auto-detect it");
-                    schema = try_load_schema_autodetect(app_config);
-                } else if (schema_sources == 1) {
-                    sst_log.debug("Single schema source provided");
-                    schema = try_load_schema_from_user_provided_source(app_config);
-                } else {
-                    fmt::print(std::cerr, "Multiple schema sources provided, please provide exactly one of: --schema-file, --system-schema, --scylla-data-dir or --scylla-yaml-file (with the accompanying --keyspace and --table if necessary)\n");
-                }
-            }
+            schema_ptr schema = load_schema(app_config);
             if (!schema) {
                 return 1;
             }
 
-            db::config dbcfg;
-            gms::feature_service feature_service(gms::feature_config_from_db_config(dbcfg));
-            cache_tracker tracker;
-            dbcfg.host_id = locator::host_id::create_random_id();
-            sstables::directory_semaphore dir_sem(1);
-            sstables::sstables_manager sst_man(large_data_handler, dbcfg, feature_service, tracker, memory::stats().total_memory(), dir_sem);
-            auto close_sst_man = deferred_close(sst_man);
+            sstable_reading_environment env;
+            auto stop_env = deferred_stop(env);
 
             std::vector<sstables::shared_sstable> sstables;
             if (app_config.count("sstables")) {
-                sstables = load_sstables(schema, sst_man, app_config["sstables"].as<std::vector<sstring>>());
+                sstables = load_sstables(schema, env.manager(), app_config["sstables"].as<std::vector<sstring>>());
             }
 
-            reader_concurrency_semaphore rcs_sem(reader_concurrency_semaphore::no_limits{}, app_name);
-            auto stop_semaphore = deferred_stop(rcs_sem);
-
-            const auto permit = rcs_sem.make_tracking_only_permit(schema.get(), app_name, db::no_timeout, {});
+            const auto permit = env.make_permit(schema);
 
-            operation(schema, permit, sstables, sst_man, app_config);
+            operation(schema, permit, sstables, env.manager(), app_config);
 
             return 0;
         });
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+#include <seastar/core/metrics.hh>
+#include "tracing/ring_buffer_backend.hh"
+#include "utils/class_registrator.hh"
+
+namespace tracing {
+
+static logging::logger tlogger("ring_buffer_backend");
+
+// Events of a session which is still running, kept until its session record
+// is ready so that the stored session is complete.
+struct ring_buffer_backend_session_state final : public backend_session_state_base {
+    std::vector<ring_buffer_backend::event> events;
+    virtual ~ring_buffer_backend_session_state() {}
+};
+
+ring_buffer_backend::ring_buffer_backend(tracing& tr)
+        : i_tracing_backend_helper(tr) {
+    namespace sm = seastar::metrics;
+
+    _metrics.add_group("tracing_ring_buffer", {
+        sm::make_counter("stored_sessions", [this] { return _stats.stored_sessions; },
+                        sm::description("Counts the tracing sessions stored in the in-memory ring.")),
+
+        sm::make_counter("evicted_sessions", [this] { return _stats.evicted_sessions; },
+                        sm::description("Counts the tracing sessions dropped from the in-memory ring to make room for newer ones.")),
+
+        sm::make_counter("dropped_events", [this] { return _stats.dropped_events; },
+                        sm::description("Counts the trace events which were not stored because their session already had too many.")),
+
+        sm::make_gauge("sessions", [this] { return _sessions.size(); },
+                        sm::description("Holds the number of tracing sessions currently in the in-memory ring.")),
+    });
+}
+
+void ring_buffer_backend::write_records_bulk(records_bulk& bulk) {
+    tlogger.trace("Storing {} sessions", bulk.size());
+    for (auto& records : bulk) {
+        auto num_records = records->size();
+        write_one_session_records(*records);
+        _local_tracing.write_complete(num_records);
+    }
+}
+
+void ring_buffer_backend::write_one_session_records(one_session_records& records) {
+    auto& state = *static_cast<ring_buffer_backend_session_state*>(records.backend_state_ptr.get());
+    for (auto& e : records.events_recs) {
+        if (state.events.size() < max_events_per_session) {
+            state.events.push_back(event{e.elapsed, std::move(e.message)});
+        } else {
+            ++_stats.dropped_events;
+        }
+    }
+    records.events_recs.clear();
+
+    bool session_record_is_ready = records.session_rec.ready();
+    records.data_consumed();
+    if (!session_record_is_ready) {
+        return;
+    }
+
+    const session_record& rec = records.session_rec;
+    if (_sessions.size() == max_sessions) {
+        _sessions.pop_front();
+        ++_stats.evicted_sessions;
+    }
+    _sessions.push_back(session{
+        .session_id = records.session_id,
+        .command = rec.command,
+        .started_at = rec.started_at,
+        .elapsed = rec.elapsed,
+        .client = rec.client,
+        .username = rec.username,
+        .request = rec.request,
+        .parameters = rec.parameters,
+        .events = std::move(state.events),
+        .slow = records.do_log_slow_query,
+    });
+    ++_stats.stored_sessions;
+    tlogger.trace("{}: stored a session with {} events", records.session_id, _sessions.back().events.size());
+}
+
+std::unique_ptr<backend_session_state_base> ring_buffer_backend::allocate_session_state() const {
+    return std::make_unique<ring_buffer_backend_session_state>();
+}
+
+using registry_ring_buffer = class_registrator<i_tracing_backend_helper, ring_buffer_backend, tracing&>;
+static registry_ring_buffer registrator_ring_buffer("ring_buffer_backend");
+
+}
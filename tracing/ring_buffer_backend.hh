@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+#pragma once
+
+#include <seastar/core/circular_buffer.hh>
+#include <seastar/core/metrics_registration.hh>
+#include "tracing/tracing.hh"
+
+namespace tracing {
+
+/**
+ * A tracing backend which keeps the last finished sessions of each shard in
+ * memory instead of writing them to system_traces.
+ *
+ * Storing a session only copies its records into a bounded per-shard ring, so
+ * unlike trace_keyspace_helper it costs no CQL writes, and the slow query
+ * logging can stay enabled on a loaded node: only the sessions which turned out
+ * to be slow (and the ones traced on purpose) reach the backend. The oldest
+ * sessions are dropped when the ring is full.
+ *
+ * The sessions are exposed through the system.recent_traces virtual table.
+ */
+class ring_buffer_backend final : public i_tracing_backend_helper {
+public:
+    // Number of sessions kept by each shard.
+    static constexpr size_t max_sessions = 1024;
+    // Events recorded by a session beyond this number are dropped.
+    static constexpr size_t max_events_per_session = 128;
+
+    struct event {
+        elapsed_clock::duration elapsed;
+        sstring message;
+    };
+
+    struct session {
+        utils::UUID session_id;
+        trace_type command;
+        std::chrono::system_clock::time_point started_at;
+        elapsed_clock::duration elapsed;
+        gms::inet_address client;
+        sstring username;
+        sstring request;
+        std::map<sstring, sstring> parameters;
+        std::vector<event> events;
+        // True if the session was stored because it exceeded the slow query threshold.
+        bool slow = false;
+    };
+
+private:
+    circular_buffer<session> _sessions;
+
+    struct stats {
+        uint64_t stored_sessions = 0;
+        uint64_t evicted_sessions = 0;
+        uint64_t dropped_events = 0;
+    } _stats;
+
+    seastar::metrics::metric_groups _metrics;
+
+public:
+    ring_buffer_backend(tracing& tr);
+
+    virtual future<> start(cql3::query_processor& qp) override {
+        return make_ready_future<>();
+    }
+
+    virtual future<> stop() override {
+        _sessions.clear();
+        return make_ready_future<>();
+    }
+
+    virtual void write_records_bulk(records_bulk& bulk) override;
+    virtual std::unique_ptr<backend_session_state_base> allocate_session_state() const override;
+
+    // The stored sessions, oldest first.
+    const circular_buffer<session>& sessions() const noexcept {
+        return _sessions;
+    }
+
+private:
+    void write_one_session_records(one_session_records& records);
+};
+
+}
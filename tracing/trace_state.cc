@@ -260,6 +260,9 @@ void trace_state::stop_foreground_and_write() noexcept {
             if (should_write_records()) {
                 try {
                     build_parameters_map();
+                    if (auto stages = stage_times_to_string(); !stages.empty()) {
+                        _records->session_rec.parameters.emplace("stages", std::move(stages));
+                    }
                 } catch (...) {
                     // Bump up an error counter, drop any pending records and
                     // continue
@@ -267,6 +270,16 @@ void trace_state::stop_foreground_and_write() noexcept {
                     _records->drop_records();
                 }
             }
+        } else if (should_write_records()) {
+            // A secondary session has no session record, so the stages of the
+            // replica side of the request are reported as its last event.
+            try {
+                if (auto stages = stage_times_to_string(); !stages.empty()) {
+                    trace(format("Stages: {}", stages));
+                }
+            } catch (...) {
+                ++_local_tracing_ptr->stats.trace_errors;
+            }
         }
 
         set_state(state::background);
@@ -281,6 +294,27 @@ void trace_state::stop_foreground_and_write() noexcept {
     }
 }
 
+sstring trace_state::stage_times_to_string() const {
+    static const char* stage_names[] = {
+        "queue",
+        "coordinator",
+        "replica_rpc",
+        "sstable_io",
+        "cache",
+    };
+    static_assert(std::size(stage_names) == latency_stages_count);
+
+    sstring ret;
+    for (size_t i = 0; i < latency_stages_count; ++i) {
+        if (_stage_times[i].count() == 0) {
+            continue;
+        }
+        ret += format("{}{}={:d}us", ret.empty() ? "" : ", ", stage_names[i],
+                std::chrono::duration_cast<std::chrono::microseconds>(_stage_times[i]).count());
+    }
+    return ret;
+}
+
 sstring trace_state::raw_value_to_sstring(const cql3::raw_value_view& v, bool is_unset, const data_type& t) {
     static constexpr int max_val_bytes = 64;
 
@@ -9,6 +9,7 @@
  */
 #pragma once
 
+#include <array>
 #include <deque>
 #include <unordered_set>
 #include <seastar/util/lazy.hh>
@@ -38,6 +39,24 @@ extern logging::logger trace_state_logger;
 
 using prepared_checked_weak_ptr = seastar::checked_ptr<seastar::weak_ptr<cql3::statements::prepared_statement>>;
 
+// Stages of a request whose time is accounted separately by a tracing session,
+// and reported among the parameters of its session and slow query log records.
+// The time of concurrent operations of the same stage is summed up.
+enum class latency_stage {
+    // Waiting for admission by the reader concurrency semaphore.
+    queue,
+    // Coordinating the request in storage_proxy, including replica_rpc.
+    coordinator,
+    // Waiting for the responses of the read requests sent to other replicas.
+    replica_rpc,
+    // Waiting for sstable reads.
+    sstable_io,
+    // Looking a partition up in the row cache.
+    cache,
+};
+
+constexpr size_t latency_stages_count = size_t(latency_stage::cache) + 1;
+
 class trace_state final {
 public:
     // A primary session may be in 3 states:
@@ -72,6 +91,7 @@ class trace_state final {
     trace_state_props_set _state_props;
     state _state = state::inactive;
     shared_ptr<tracing> _local_tracing_ptr;
+    std::array<elapsed_clock::duration, latency_stages_count> _stage_times{};
 
     struct params_values;
     struct params_values_deleter {
@@ -213,6 +233,14 @@ class trace_state final {
         return _records->events_recs.size();
     }
 
+    void add_stage_time(latency_stage stage, elapsed_clock::duration d) noexcept {
+        _stage_times[size_t(stage)] += d;
+    }
+
+    elapsed_clock::duration stage_time(latency_stage stage) const noexcept {
+        return _stage_times[size_t(stage)];
+    }
+
 private:
     /**
      * Stop a foreground state and write pending records to I/O.
@@ -233,6 +261,12 @@ class trace_state final {
         return full_tracing() || _records->do_log_slow_query;
     }
 
+    /**
+     * Returns the stages the session spent time in, as "<stage>=<microseconds>us"
+     * items, or an empty string if there are none.
+     */
+    sstring stage_times_to_string() const;
+
     /**
      * Returns the amount of time passed since the beginning of this tracing session.
      *
@@ -735,6 +769,33 @@ inline void add_prepared_query_options(const trace_state_ptr& state, const cql3:
     }
 }
 
+inline void add_stage_time(const trace_state_ptr& state, latency_stage stage, elapsed_clock::duration d) noexcept {
+    if (state) {
+        state->add_stage_time(stage, d);
+    }
+}
+
+// Adds the time elapsed between its construction and its destruction to a
+// stage of the tracing session, if there is one. The clock is not read otherwise.
+class stage_timer {
+    trace_state_ptr _state;
+    latency_stage _stage;
+    elapsed_clock::time_point _start;
+public:
+    stage_timer(const trace_state_ptr& state, latency_stage stage) noexcept
+        : _state(state)
+        , _stage(stage)
+        , _start(_state ? elapsed_clock::now() : elapsed_clock::time_point())
+    { }
+    stage_timer(stage_timer&&) noexcept = default;
+    stage_timer& operator=(stage_timer&&) = delete;
+    ~stage_timer() {
+        if (_state) {
+            _state->add_stage_time(_stage, elapsed_clock::now() - _start);
+        }
+    }
+};
+
 // global_trace_state_ptr is a helper class that may be used for creating spans
 // of an existing tracing session on other shards. When a tracing span on a
 // different shard is needed global_trace_state_ptr would create a secondary
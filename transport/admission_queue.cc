@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "transport/admission_queue.hh"
+
+#include <seastar/core/coroutine.hh>
+#include "seastarx.hh"
+
+namespace cql_transport {
+
+future<semaphore_units<>> admission_queue::admit(const sstring& flow_name, size_t size, semaphore::time_point deadline) {
+    if (_active.empty()) {
+        if (auto units = try_get_units(_memory, size)) {
+            return make_ready_future<semaphore_units<>>(std::move(*units));
+        }
+    }
+    auto [it, inserted] = _flows.try_emplace(flow_name);
+    if (inserted) {
+        _active.push_back(flow_name);
+    }
+    auto& w = it->second.waiters.emplace_back(waiter{size, deadline, clock_type::now(), {}});
+    auto fut = w.pr.get_future();
+    ++_waiters;
+    ++_stats.queued;
+    if (!_dispatching) {
+        // Runs while requests are queued, and queued requests keep their
+        // connections, and so the server, alive.
+        (void)dispatch();
+    }
+    return fut;
+}
+
+future<> admission_queue::dispatch() {
+    _dispatching = true;
+    while (!_active.empty()) {
+        auto& f = _flows.at(_active.front());
+        auto& w = f.waiters.front();
+        if (f.deficit < w.size) {
+            // The flow used its share of this round, move to the next one.
+            f.deficit += _quantum;
+            _active.push_back(std::move(_active.front()));
+            _active.pop_front();
+            continue;
+        }
+        f.deficit -= w.size;
+        // Requests queued in the meantime are added after w, so w and f
+        // stay valid.
+        try {
+            w.pr.set_value(co_await get_units(_memory, w.size, w.deadline));
+            _stats.wait_time_us += std::chrono::duration_cast<std::chrono::microseconds>(clock_type::now() - w.queued_at).count();
+        } catch (...) {
+            w.pr.set_exception(std::current_exception());
+        }
+        f.waiters.pop_front();
+        --_waiters;
+        if (f.waiters.empty()) {
+            _flows.erase(_active.front());
+            _active.pop_front();
+        }
+    }
+    _dispatching = false;
+}
+
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <chrono>
+#include <deque>
+#include <unordered_map>
+
+#include <seastar/core/semaphore.hh>
+#include <seastar/core/sstring.hh>
+
+namespace cql_transport {
+
+// Admits the requests of a shard into the memory of the transport, fairly
+// among the clients issuing them.
+//
+// Requests are admitted right away while memory is available. Once they
+// have to wait, they are queued by flow, e.g. the user issuing them, and
+// flows are served in deficit round robin order: each round, a flow may
+// admit requests worth up to a quantum of memory more than what it used so
+// far, so that a client pipelining many or large requests gets no more than
+// its share of the memory freed by the requests completing, and can't
+// starve the clients issuing few.
+//
+// Within a flow requests are admitted in the order they were queued.
+class admission_queue {
+public:
+    using clock_type = std::chrono::steady_clock;
+
+    struct stats {
+        // Requests which had to be queued.
+        uint64_t queued = 0;
+        // Sum of the time queued requests waited, in microseconds.
+        uint64_t wait_time_us = 0;
+    };
+private:
+    struct waiter {
+        size_t size;
+        seastar::semaphore::time_point deadline;
+        clock_type::time_point queued_at;
+        seastar::promise<seastar::semaphore_units<>> pr;
+    };
+    struct flow {
+        std::deque<waiter> waiters;
+        size_t deficit = 0;
+    };
+    seastar::semaphore& _memory;
+    size_t _quantum;
+    std::unordered_map<seastar::sstring, flow> _flows; // Flows with queued requests.
+    std::deque<seastar::sstring> _active; // Round robin order of _flows.
+    size_t _waiters = 0;
+    bool _dispatching = false;
+    stats _stats;
+private:
+    seastar::future<> dispatch();
+public:
+    admission_queue(seastar::semaphore& memory, size_t quantum) noexcept
+        : _memory(memory)
+        , _quantum(quantum)
+    { }
+
+    // Waits until size units of memory are available and it is the turn of
+    // flow to get them.
+    // Fails with seastar::semaphore_timed_out if deadline passes before.
+    seastar::future<seastar::semaphore_units<>> admit(const seastar::sstring& flow, size_t size,
+            seastar::semaphore::time_point deadline = seastar::semaphore::time_point::max());
+
+    // Requests queued.
+    size_t waiters() const noexcept {
+        return _waiters;
+    }
+
+    const stats& get_stats() const noexcept {
+        return _stats;
+    }
+};
+
+}
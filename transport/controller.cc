@@ -14,6 +14,7 @@
 #include "gms/gossiper.hh"
 #include "log.hh"
 #include "cql3/query_processor.hh"
+#include "cdc/log.hh"
 
 using namespace seastar;
 
@@ -24,11 +25,12 @@ static logging::logger logger("cql_server_controller");
 controller::controller(sharded<auth::service>& auth, sharded<service::migration_notifier>& mn,
         sharded<gms::gossiper>& gossiper, sharded<cql3::query_processor>& qp, sharded<service::memory_limiter>& ml,
         sharded<qos::service_level_controller>& sl_controller, sharded<service::endpoint_lifecycle_notifier>& elc_notif,
-        const db::config& cfg, scheduling_group_key cql_opcode_stats_key)
+        sharded<cdc::cdc_service>& cdc, const db::config& cfg, scheduling_group_key cql_opcode_stats_key)
     : _ops_sem(1)
     , _auth_service(auth)
     , _mnotifier(mn)
     , _lifecycle_notifier(elc_notif)
+    , _cdc(cdc)
     , _gossiper(gossiper)
     , _qp(qp)
     , _mem_limiter(ml)
@@ -219,13 +221,17 @@ future<> controller::subscribe_server(sharded<cql_server>& server) {
     return server.invoke_on_all([this] (cql_server& server) {
         _mnotifier.local().register_listener(server.get_migration_listener());
         _lifecycle_notifier.local().register_subscriber(server.get_lifecycle_listener());
+        _cdc.local().register_change_subscriber(server.get_cdc_change_subscriber());
         return make_ready_future<>();
     });
 }
 
 future<> controller::unsubscribe_server(sharded<cql_server>& server) {
     return server.invoke_on_all([this] (cql_server& server) {
-        return _mnotifier.local().unregister_listener(server.get_migration_listener()).then([this, &server]{
+        _cdc.local().unregister_change_subscriber(server.get_cdc_change_subscriber());
+        return server.stop_cdc_change_events().then([this, &server] {
+            return _mnotifier.local().unregister_listener(server.get_migration_listener());
+        }).then([this, &server]{
             return _lifecycle_notifier.local().unregister_subscriber(server.get_lifecycle_listener());
         });
     });
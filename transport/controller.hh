@@ -23,6 +23,7 @@ namespace service {
     class memory_limiter;
 }
 namespace gms { class gossiper; }
+namespace cdc { class cdc_service; }
 namespace cql3 { class query_processor; }
 namespace qos { class service_level_controller; }
 namespace db { class config; }
@@ -40,6 +41,7 @@ class controller : public protocol_server {
     sharded<auth::service>& _auth_service;
     sharded<service::migration_notifier>& _mnotifier;
     sharded<service::endpoint_lifecycle_notifier>& _lifecycle_notifier;
+    sharded<cdc::cdc_service>& _cdc;
     sharded<gms::gossiper>& _gossiper;
     sharded<cql3::query_processor>& _qp;
     sharded<service::memory_limiter>& _mem_limiter;
@@ -59,7 +61,7 @@ class controller : public protocol_server {
     controller(sharded<auth::service>&, sharded<service::migration_notifier>&, sharded<gms::gossiper>&,
             sharded<cql3::query_processor>&, sharded<service::memory_limiter>&,
             sharded<qos::service_level_controller>&, sharded<service::endpoint_lifecycle_notifier>&,
-            const db::config& cfg, scheduling_group_key cql_opcode_stats_key);
+            sharded<cdc::cdc_service>&, const db::config& cfg, scheduling_group_key cql_opcode_stats_key);
     virtual sstring name() const override;
     virtual sstring protocol() const override;
     virtual sstring protocol_version() const override;
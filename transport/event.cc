@@ -71,4 +71,12 @@ event::schema_change::schema_change(change_type change, target_type target, sstr
         break;
     }
 }
+
+event::cdc_change::cdc_change(sstring keyspace, sstring table, std::vector<bytes> stream_ids)
+    : event(event_type::CDC_CHANGE)
+    , keyspace(std::move(keyspace))
+    , table(std::move(table))
+    , stream_ids(std::move(stream_ids))
+{ }
+
 }
@@ -10,6 +10,7 @@
 
 #pragma once
 
+#include "bytes.hh"
 #include "gms/inet_address.hh"
 
 #include <seastar/core/sstring.hh>
@@ -22,7 +23,7 @@ namespace cql_transport {
 
 class event {
 public:
-    enum class event_type { TOPOLOGY_CHANGE, STATUS_CHANGE, SCHEMA_CHANGE };
+    enum class event_type { TOPOLOGY_CHANGE, STATUS_CHANGE, SCHEMA_CHANGE, CDC_CHANGE };
 
     const event_type type;
 private:
@@ -31,6 +32,7 @@ class event {
     class topology_change;
     class status_change;
     class schema_change;
+    class cdc_change;
 };
 
 class event::topology_change : public event {
@@ -82,4 +84,15 @@ class event::schema_change : public event {
         : schema_change(change, target, keyspace, std::vector<sstring>{std::move(arguments)...}) {}
 };
 
+// Streams of a CDC log table which have new changes, see the
+// SCYLLA_CDC_CHANGE_EVENTS protocol extension.
+class event::cdc_change : public event {
+public:
+    const sstring keyspace;
+    const sstring table;
+    const std::vector<bytes> stream_ids;
+
+    cdc_change(sstring keyspace, sstring table, std::vector<bytes> stream_ids);
+};
+
 }
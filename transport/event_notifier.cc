@@ -16,6 +16,11 @@ namespace cql_transport {
 
 static logging::logger elogger("event_notifier");
 
+cql_server::event_notifier::event_notifier(cql_server& s)
+    : _server(s)
+    , _cdc_changes_timer([this] { flush_cdc_changes(); })
+{ }
+
 void cql_server::event_notifier::register_event(event::event_type et, cql_server::connection* conn)
 {
     switch (et) {
@@ -28,6 +33,11 @@ void cql_server::event_notifier::register_event(event::event_type et, cql_server
     case event::event_type::SCHEMA_CHANGE:
         _schema_change_listeners.emplace(conn);
         break;
+    case event::event_type::CDC_CHANGE:
+        if (_cdc_change_listeners.emplace(conn).second) {
+            update_cdc_change_listeners(1);
+        }
+        break;
     }
 }
 
@@ -36,6 +46,85 @@ void cql_server::event_notifier::unregister_connection(cql_server::connection* c
     _topology_change_listeners.erase(conn);
     _status_change_listeners.erase(conn);
     _schema_change_listeners.erase(conn);
+    if (_cdc_change_listeners.erase(conn)) {
+        update_cdc_change_listeners(-1);
+    }
+}
+
+void cql_server::event_notifier::update_cdc_change_listeners(int64_t delta)
+{
+    if (_cdc_changes_gate.is_closed()) {
+        return;
+    }
+    (void)with_gate(_cdc_changes_gate, [this, delta] {
+        return _server.container().invoke_on_all([delta] (cql_server& server) {
+            server._notifier->_cdc_change_listeners_on_all_shards += delta;
+        });
+    }).handle_exception([] (std::exception_ptr ep) {
+        elogger.warn("Failed to update the CDC_CHANGE listeners of the other shards: {}", ep);
+    });
+}
+
+void cql_server::event_notifier::on_cdc_change(const schema& log_schema, const std::vector<bytes>& stream_ids)
+{
+    if (!_cdc_change_listeners_on_all_shards || _cdc_changes_gate.is_closed()) {
+        return;
+    }
+    auto& pending = _pending_cdc_changes[{log_schema.ks_name(), log_schema.cf_name()}];
+    pending.insert(stream_ids.begin(), stream_ids.end());
+    if (!_cdc_changes_timer.armed()) {
+        _cdc_changes_timer.arm(cdc_changes_interval);
+    }
+}
+
+void cql_server::event_notifier::flush_cdc_changes()
+{
+    if (_pending_cdc_changes.empty() || _cdc_changes_gate.is_closed()) {
+        return;
+    }
+    (void)with_gate(_cdc_changes_gate, [this, changes = std::exchange(_pending_cdc_changes, {})] () mutable {
+        return do_with(std::move(changes), [this] (const cdc_changes& changes) {
+            return _server.container().invoke_on_all([&changes] (cql_server& server) {
+                server._notifier->send_cdc_changes(changes);
+            });
+        });
+    }).handle_exception([] (std::exception_ptr ep) {
+        elogger.warn("Failed to send CDC_CHANGE events: {}", ep);
+    });
+}
+
+void cql_server::event_notifier::send_cdc_changes(const cdc_changes& changes)
+{
+    if (_cdc_change_listeners.empty()) {
+        return;
+    }
+    for (auto& [table, stream_ids] : changes) {
+        auto it = stream_ids.begin();
+        while (it != stream_ids.end()) {
+            std::vector<bytes> ids;
+            while (it != stream_ids.end() && ids.size() < max_stream_ids_per_event) {
+                ids.push_back(*it++);
+            }
+            event::cdc_change change{table.first, table.second, std::move(ids)};
+            for (auto&& conn : _cdc_change_listeners) {
+                if (!conn->_pending_requests_gate.is_closed()) {
+                    conn->write_response(conn->make_cdc_change_event(change));
+                };
+            }
+        }
+    }
+}
+
+future<> cql_server::event_notifier::stop_cdc_changes()
+{
+    _cdc_changes_timer.cancel();
+    _pending_cdc_changes.clear();
+    return _cdc_changes_gate.close();
+}
+
+future<> cql_server::stop_cdc_change_events()
+{
+    return _notifier->stop_cdc_changes();
 }
 
 void cql_server::event_notifier::on_create_keyspace(const sstring& ks_name)
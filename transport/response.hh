@@ -81,7 +81,11 @@ class response {
 
     // Make a non-owning scattered_message of the response. Remains valid as long
     // as the response object is alive.
-    scattered_message<char> make_message(uint8_t version, cql_compression compression);
+    // Compresses the body, unless that doesn't make it smaller. Returns
+    // whether it was compressed.
+    bool compress(cql_compression compression);
+
+    scattered_message<char> make_message(uint8_t version);
 
     cql_binary_opcode opcode() const {
         return _opcode;
@@ -90,9 +94,9 @@ class response {
         return _body.size();
     }
 private:
-    void compress(cql_compression compression);
-    void compress_lz4();
-    void compress_snappy();
+    bool compress_lz4();
+    bool compress_snappy();
+    bool compress_zstd();
 
     template <typename CqlFrameHeaderType>
     sstring make_frame_one(uint8_t version, size_t length) {
@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <array>
+#include <utility>
+
+#include <seastar/core/byteorder.hh>
+
+#include <lz4.h>
+#include <zlib.h>
+
+#include "transport/segment.hh"
+#include "seastarx.hh"
+
+namespace cql_transport {
+
+static constexpr size_t checksum_size = 4;
+static constexpr size_t crc24_size = 3;
+static constexpr size_t uncompressed_header_size = 3 + crc24_size;
+static constexpr size_t compressed_header_size = 5 + crc24_size;
+static constexpr uint64_t length_mask = (1 << 17) - 1;
+
+// The same CRC24 as the other implementations of the protocol, over the
+// first len bytes, starting from the lowest, of the header value v.
+static uint32_t crc24(uint64_t v, size_t len) noexcept {
+    uint32_t crc = 0x875060;
+    for (size_t i = 0; i < len; ++i) {
+        crc ^= (v & 0xff) << 16;
+        v >>= 8;
+        for (int j = 0; j < 8; ++j) {
+            crc <<= 1;
+            if (crc & 0x1000000) {
+                crc ^= 0x1974f0b;
+            }
+        }
+    }
+    return crc & 0xffffff;
+}
+
+// The CRC32 of payloads has initial bytes, so that a payload of zeros
+// doesn't have a checksum of zero.
+static uint32_t crc32(bytes_view payload) noexcept {
+    static constexpr std::array<unsigned char, 4> initial_bytes = {0xfa, 0x2d, 0x55, 0xca};
+    auto crc = ::crc32(0, initial_bytes.data(), initial_bytes.size());
+    return ::crc32(crc, reinterpret_cast<const unsigned char*>(payload.data()), payload.size());
+}
+
+static void write_le_bytes(char* p, uint64_t v, size_t len) noexcept {
+    for (size_t i = 0; i < len; ++i) {
+        p[i] = char(v >> (8 * i));
+    }
+}
+
+static uint64_t read_le_bytes(const int8_t* p, size_t len) noexcept {
+    uint64_t v = 0;
+    for (size_t i = 0; i < len; ++i) {
+        v |= uint64_t(uint8_t(p[i])) << (8 * i);
+    }
+    return v;
+}
+
+size_t segment_header_size(bool compressed) noexcept {
+    return compressed ? compressed_header_size : uncompressed_header_size;
+}
+
+void segment_writer::write_segment(bytes_view payload, bool self_contained) {
+    std::array<char, compressed_header_size> header;
+    size_t value_size;
+    uint64_t value;
+    bytes compressed;
+    bytes_view body = payload;
+    if (_compress) {
+        value_size = compressed_header_size - crc24_size;
+        compressed = bytes(bytes::initialized_later(), LZ4_compressBound(payload.size()));
+        auto len = LZ4_compress_default(reinterpret_cast<const char*>(payload.data()), reinterpret_cast<char*>(compressed.data()),
+                payload.size(), compressed.size());
+        if (len <= 0) {
+            throw std::runtime_error("CQL segment LZ4 compression failure");
+        }
+        // An uncompressed length of 0 means that the payload didn't
+        // compress and is stored as is.
+        uint64_t uncompressed_length = 0;
+        if (size_t(len) < payload.size()) {
+            body = bytes_view(compressed.data(), len);
+            uncompressed_length = payload.size();
+        }
+        value = body.size() | (uncompressed_length << 17) | (uint64_t(self_contained) << 34);
+    } else {
+        value_size = uncompressed_header_size - crc24_size;
+        value = payload.size() | (uint64_t(self_contained) << 17);
+    }
+    write_le_bytes(header.data(), value, value_size);
+    write_le_bytes(header.data() + value_size, crc24(value, value_size), crc24_size);
+    _out.write(header.data(), value_size + crc24_size);
+    _out.write(body);
+    std::array<char, checksum_size> checksum;
+    write_le<uint32_t>(checksum.data(), crc32(body));
+    _out.write(checksum.data(), checksum.size());
+}
+
+void segment_writer::add_frame(bytes_view frame) {
+    if (_pending.size() + frame.size() > max_payload_size && !_pending.empty()) {
+        write_segment(_pending.linearize(), true);
+        _pending.clear();
+    }
+    if (frame.size() <= max_payload_size) {
+        _pending.write(frame);
+        return;
+    }
+    while (!frame.empty()) {
+        auto len = std::min(frame.size(), max_payload_size);
+        write_segment(frame.substr(0, len), false);
+        frame.remove_prefix(len);
+    }
+}
+
+bytes_ostream segment_writer::flush() {
+    if (!_pending.empty()) {
+        write_segment(_pending.linearize(), true);
+        _pending.clear();
+    }
+    return std::exchange(_out, bytes_ostream());
+}
+
+std::optional<segment> read_segment(bytes_view& buf, bool compressed) {
+    auto header_size = segment_header_size(compressed);
+    if (buf.size() < header_size) {
+        return std::nullopt;
+    }
+    auto value_size = header_size - crc24_size;
+    auto value = read_le_bytes(buf.data(), value_size);
+    if (read_le_bytes(buf.data() + value_size, crc24_size) != crc24(value, value_size)) {
+        throw std::runtime_error("CQL segment header checksum mismatch");
+    }
+    size_t length = value & length_mask;
+    size_t uncompressed_length = compressed ? (value >> 17) & length_mask : 0;
+    bool self_contained = (value >> (compressed ? 34 : 17)) & 1;
+    if (buf.size() < header_size + length + checksum_size) {
+        return std::nullopt;
+    }
+    auto body = buf.substr(header_size, length);
+    if (read_le<uint32_t>(reinterpret_cast<const char*>(buf.data() + header_size + length)) != crc32(body)) {
+        throw std::runtime_error("CQL segment payload checksum mismatch");
+    }
+    buf.remove_prefix(header_size + length + checksum_size);
+
+    if (!uncompressed_length) {
+        return segment{bytes(body), self_contained};
+    }
+    bytes payload(bytes::initialized_later(), uncompressed_length);
+    auto ret = LZ4_decompress_safe(reinterpret_cast<const char*>(body.data()), reinterpret_cast<char*>(payload.data()),
+            body.size(), payload.size());
+    if (ret < 0 || size_t(ret) != uncompressed_length) {
+        throw std::runtime_error("CQL segment LZ4 uncompression failure");
+    }
+    return segment{std::move(payload), self_contained};
+}
+
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <optional>
+
+#include "bytes.hh"
+#include "bytes_ostream.hh"
+
+namespace cql_transport {
+
+// Segments are the outer framing of version 5 of the native protocol: once
+// a connection is ready, frames are carried in segments, each checksummed
+// and, if the connection negotiated compression, lz4 compressed as a whole.
+//
+// A self-contained segment holds one or more whole frames, so that many
+// small frames are checksummed, compressed and written together. A frame
+// larger than max_payload_size is split over several segments which aren't
+// self-contained.
+//
+// The header of a segment holds the length of its payload, and if
+// compressed, its uncompressed length, 0 if the payload didn't compress
+// and is sent as is, followed by its CRC24. The payload is followed by its
+// CRC32.
+class segment_writer {
+public:
+    static constexpr size_t max_payload_size = 128 * 1024 - 1;
+private:
+    bool _compress;
+    bytes_ostream _out;
+    // Payload of the self-contained segment being filled.
+    bytes_ostream _pending;
+private:
+    void write_segment(bytes_view payload, bool self_contained);
+public:
+    explicit segment_writer(bool compress) noexcept : _compress(compress) { }
+
+    // Adds a whole frame, header included.
+    void add_frame(bytes_view frame);
+
+    // Returns the segments carrying the frames added since the last call.
+    bytes_ostream flush();
+};
+
+struct segment {
+    bytes payload;
+    bool self_contained;
+};
+
+// Size of the header of segments, which holds the size of the rest.
+size_t segment_header_size(bool compressed) noexcept;
+
+// Parses the segment at the front of buf and removes it from buf. Returns
+// std::nullopt if buf doesn't hold a whole segment yet. Throws
+// std::runtime_error if the segment is corrupt.
+std::optional<segment> read_segment(bytes_view& buf, bool compressed);
+
+}
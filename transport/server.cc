@@ -53,6 +53,7 @@
 
 #include <snappy-c.h>
 #include <lz4.h>
+#include <zstd.h>
 
 #include "response.hh"
 #include "request.hh"
@@ -70,6 +71,10 @@ namespace cql_transport {
 
 static logging::logger clogger("cql_server");
 
+// Memory the flows of the admission queue may admit per round: a few
+// typical requests, or one large one.
+static constexpr size_t admission_quantum = 64 * 1024;
+
 /**
  * Skip registering CQL metrics for these SGs - these are internal scheduling groups that are not supposed to handle CQL
  * requests.
@@ -181,6 +186,8 @@ event::event_type parse_event_type(const sstring& value)
         return event::event_type::STATUS_CHANGE;
     } else if (value == "SCHEMA_CHANGE") {
         return event::event_type::SCHEMA_CHANGE;
+    } else if (value == "CDC_CHANGE") {
+        return event::event_type::CDC_CHANGE;
     } else {
         throw exceptions::protocol_exception(format("Invalid value '{}' for Event.Type", value));
     }
@@ -235,7 +242,11 @@ cql_server::cql_server(distributed<cql3::query_processor>& qp, auth::service& au
     , _config(std::move(config))
     , _max_request_size(_config.max_request_size)
     , _max_concurrent_requests(db_cfg.max_concurrent_requests_per_shard)
+    , _max_concurrent_requests_per_connection(db_cfg.max_concurrent_requests_per_connection)
+    , _compression_min_size(db_cfg.native_transport_compression_min_size)
     , _memory_available(ml.get_semaphore())
+    , _admission(_memory_available, admission_quantum)
+    , _latency_slo_guard(db_cfg.interactive_latency_target_ms)
     , _notifier(std::make_unique<event_notifier>(*this))
     , _auth_service(auth_service)
     , _sl_controller(sl_controller)
@@ -257,7 +268,7 @@ cql_server::cql_server(distributed<cql3::query_processor>& qp, auth::service& au
         sm::make_gauge("requests_serving", _stats.requests_serving,
                         sm::description("Holds a number of requests that are being processed right now.")),
 
-        sm::make_gauge("requests_blocked_memory_current", [this] { return _memory_available.waiters(); },
+        sm::make_gauge("requests_blocked_memory_current", [this] { return _admission.waiters() + _memory_available.waiters(); },
                         sm::description(
                             seastar::format("Holds the number of requests that are currently blocked due to reaching the memory quota limit ({}B). "
                                             "Non-zero value indicates that our bottleneck is memory and more specifically - the memory quota allocated for the \"CQL transport\" component.", _max_request_size))),
@@ -268,6 +279,27 @@ cql_server::cql_server(distributed<cql3::query_processor>& qp, auth::service& au
         sm::make_counter("requests_shed", _stats.requests_shed,
                         sm::description("Holds an incrementing counter with the requests that were shed due to overload (threshold configured via max_concurrent_requests_per_shard). "
                                             "The first derivative of this value shows how often we shed requests due to overload in the \"CQL transport\" component.")),
+        sm::make_counter("requests_shed_for_latency_target", [this] { return _latency_slo_guard.get_stats().batch_requests_shed; },
+                        sm::description("Counts the requests of batch workloads which were shed because the p99 latency of interactive workloads missed "
+                                        "interactive_latency_target_ms.")),
+        sm::make_gauge("interactive_latency_p99_us", [this] { return _latency_slo_guard.get_stats().interactive_p99_us; },
+                        sm::description("Holds the p99 latency of the requests of interactive workloads over the last second, if interactive_latency_target_ms is set.")),
+        sm::make_counter("requests_admission_queued", [this] { return _admission.get_stats().queued; },
+                        sm::description("Counts the requests which waited for memory in the admission queue, which admits the requests of different users "
+                                        "and connections fairly.")),
+        sm::make_counter("requests_admission_wait_time_us", [this] { return _admission.get_stats().wait_time_us; },
+                        sm::description("Counts the microseconds requests waited in the admission queue. "
+                                        "Divided by requests_admission_queued, gives the average wait time of queued requests.")),
+        sm::make_counter("compressed_responses", _stats.compressed_responses,
+                        sm::description("Counts the responses sent compressed.")),
+        sm::make_counter("uncompressed_responses", _stats.uncompressed_responses,
+                        sm::description("Counts the responses of connections which negotiated compression sent uncompressed, because they were smaller than "
+                                        "native_transport_compression_min_size or didn't get smaller when compressed.")),
+        sm::make_counter("compression_input_bytes", _stats.compression_input_bytes,
+                        sm::description("Counts the bytes of the responses sent compressed, before compression. "
+                                        "Divided by compression_output_bytes, gives the compression ratio.")),
+        sm::make_counter("compression_output_bytes", _stats.compression_output_bytes,
+                        sm::description("Counts the bytes of the responses sent compressed, after compression.")),
         sm::make_gauge("requests_memory_available", [this] { return _memory_available.current(); },
                         sm::description(
                             seastar::format("Holds the amount of available memory for admitting new requests (max is {}B)."
@@ -591,6 +623,7 @@ cql_server::connection::connection(cql_server& server, socket_address server_add
     , _server(server)
     , _server_addr(server_addr)
     , _client_state(service::client_state::external_tag{}, server._auth_service, &server._sl_controller, server.timeout_config(), addr)
+    , _anonymous_admission_flow(format("{}", addr))
 {
     _shedding_timer.set_callback([this] {
         clogger.debug("Shedding all incoming requests due to overload");
@@ -651,8 +684,24 @@ void cql_server::connection::handle_error(future<>&& f) {
     }
 }
 
+// Requests of logged in users share the flow of the user, so that opening
+// more connections doesn't give more memory. The connections of anonymous
+// users each have their own.
+const sstring& cql_server::connection::admission_flow() const {
+    const auto& user = _client_state.user();
+    return user && user->name ? *user->name : _anonymous_admission_flow;
+}
+
+future<> cql_server::connection::wait_for_request_slot() {
+    // The gate is also held by the loop reading the requests.
+    while (_pending_requests_gate.get_count() > _server._max_concurrent_requests_per_connection()) {
+        _request_completed.emplace();
+        co_await _request_completed->get_future();
+    }
+}
+
 future<> cql_server::connection::process_request() {
-    return read_frame().then_wrapped([this] (future<std::optional<cql_binary_frame_v3>>&& v) {
+    return wait_for_request_slot().then([this] { return read_frame(); }).then_wrapped([this] (future<std::optional<cql_binary_frame_v3>>&& v) {
         auto maybe_frame = v.get0();
         if (!maybe_frame) {
             // eof
@@ -662,6 +711,18 @@ future<> cql_server::connection::process_request() {
         auto& f = *maybe_frame;
 
         const bool allow_shedding = _client_state.get_workload_type() == service::client_state::workload_type::interactive;
+        if (_client_state.get_workload_type() == service::client_state::workload_type::batch && _server._latency_slo_guard.shed_batch_request()) {
+            ++_server._stats.requests_shed;
+            return _read_buf.skip(f.length).then([this, stream = f.stream] {
+                const char* message = "request shed to keep interactive workloads within interactive_latency_target_ms";
+                clogger.debug("{}: {}, stream {}", _client_state.get_remote_address(), message, stream);
+                write_response(make_error(stream, exceptions::exception_code::OVERLOADED,
+                    message, tracing::trace_state_ptr()));
+                return make_ready_future<>();
+            });
+        }
+        const bool measure_latency = allow_shedding && _server._latency_slo_guard.enabled();
+        const auto received_at = measure_latency ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
         if (allow_shedding && _shed_incoming_requests) {
             ++_server._stats.requests_shed;
             return _read_buf.skip(f.length).then([this, stream = f.stream] {
@@ -710,7 +771,7 @@ future<> cql_server::connection::process_request() {
 
         const auto shedding_timeout = std::chrono::milliseconds(50);
         auto fut = allow_shedding
-                ? get_units(_server._memory_available, mem_estimate, shedding_timeout).then_wrapped([this, length = f.length] (auto f) {
+                ? _server._admission.admit(admission_flow(), mem_estimate, semaphore::clock::now() + shedding_timeout).then_wrapped([this, length = f.length] (auto f) {
                     try {
                         return make_ready_future<semaphore_units<>>(f.get0());
                     } catch (semaphore_timed_out& sto) {
@@ -723,22 +784,22 @@ future<> cql_server::connection::process_request() {
                         });
                     }
                 })
-                : get_units(_server._memory_available, mem_estimate);
-        if (_server._memory_available.waiters()) {
+                : _server._admission.admit(admission_flow(), mem_estimate);
+        if (!fut.available()) {
             if (allow_shedding && !_shedding_timer.armed()) {
                 _shedding_timer.arm(shedding_timeout);
             }
             ++_server._stats.requests_blocked_memory;
         }
 
-        return fut.then_wrapped([this, length = f.length, flags = f.flags, op, stream, tracing_requested] (auto mem_permit_fut) {
+        return fut.then_wrapped([this, length = f.length, flags = f.flags, op, stream, tracing_requested, measure_latency, received_at] (auto mem_permit_fut) {
           if (mem_permit_fut.failed()) {
               // Ignore semaphore errors - they are expected if load shedding took place
               mem_permit_fut.ignore_ready_future();
               return make_ready_future<>();
           }
           semaphore_units<> mem_permit = mem_permit_fut.get0();
-          return this->read_and_decompress_frame(length, flags).then([this, op, stream, tracing_requested, mem_permit = make_service_permit(std::move(mem_permit))] (fragmented_temporary_buffer buf) mutable {
+          return this->read_and_decompress_frame(length, flags).then([this, op, stream, tracing_requested, measure_latency, received_at, mem_permit = make_service_permit(std::move(mem_permit))] (fragmented_temporary_buffer buf) mutable {
 
             ++_server._stats.requests_served;
             ++_server._stats.requests_serving;
@@ -748,6 +809,9 @@ future<> cql_server::connection::process_request() {
                 _shedding_timer.cancel();
                 _shed_incoming_requests = false;
                 _pending_requests_gate.leave();
+                if (_request_completed) {
+                    std::exchange(_request_completed, std::nullopt)->set_value();
+                }
             });
             auto istream = buf.get_istream();
 
@@ -763,7 +827,10 @@ future<> cql_server::connection::process_request() {
                     _process_request_stage(this, istream, op, stream, seastar::ref(_client_state), tracing_requested, mem_permit) :
                     process_request_one(istream, op, stream, seastar::ref(_client_state), tracing_requested, mem_permit);
 
-            future<> request_response_future = request_process_future.then_wrapped([this, buf = std::move(buf), mem_permit, leave = std::move(leave), stream] (future<foreign_ptr<std::unique_ptr<cql_server::response>>> response_f) mutable {
+            future<> request_response_future = request_process_future.then_wrapped([this, buf = std::move(buf), mem_permit, leave = std::move(leave), stream, measure_latency, received_at] (future<foreign_ptr<std::unique_ptr<cql_server::response>>> response_f) mutable {
+                if (measure_latency) {
+                    _server._latency_slo_guard.record_interactive_request(std::chrono::steady_clock::now() - received_at);
+                }
                 try {
                     if (response_f.failed()) {
                         const auto message = format("request processing failed, error [{}]", response_f.get_exception());
@@ -808,6 +875,32 @@ void on_compression_buffer_use() {
     }
 }
 
+// Fast, responses are compressed on the shard serving them.
+static constexpr int zstd_compression_level = 1;
+
+// Created on first use, few connections negotiate zstd.
+static ZSTD_CCtx* zstd_cctx() {
+    static thread_local std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> ctx(nullptr, &ZSTD_freeCCtx);
+    if (!ctx) {
+        ctx.reset(ZSTD_createCCtx());
+        if (!ctx) {
+            throw std::bad_alloc();
+        }
+    }
+    return ctx.get();
+}
+
+static ZSTD_DCtx* zstd_dctx() {
+    static thread_local std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> ctx(nullptr, &ZSTD_freeDCtx);
+    if (!ctx) {
+        ctx.reset(ZSTD_createDCtx());
+        if (!ctx) {
+            throw std::bad_alloc();
+        }
+    }
+    return ctx.get();
+}
+
 }
 
 future<fragmented_temporary_buffer> cql_server::connection::read_and_decompress_frame(size_t length, uint8_t flags)
@@ -857,6 +950,29 @@ future<fragmented_temporary_buffer> cql_server::connection::read_and_decompress_
                 on_compression_buffer_use();
                 return uncomp;
             });
+        } else if (_compression == cql_compression::zstd) {
+            return _buffer_reader.read_exactly(_read_buf, length).then([] (fragmented_temporary_buffer buf) {
+                auto in = input_buffer.get_linearized_view(fragmented_temporary_buffer::view(buf));
+                auto uncomp_len = ZSTD_getFrameContentSize(in.data(), in.size());
+                if (uncomp_len == ZSTD_CONTENTSIZE_UNKNOWN || uncomp_len == ZSTD_CONTENTSIZE_ERROR) {
+                    throw std::runtime_error("CQL frame zstd uncompressed size is unknown");
+                }
+                if (uncomp_len > uint64_t(std::numeric_limits<int32_t>::max())) {
+                    throw std::runtime_error(format("CQL frame zstd uncompressed size is too large: {}", uncomp_len));
+                }
+                auto uncomp = output_buffer.make_fragmented_temporary_buffer(uncomp_len, fragmented_temporary_buffer::default_fragment_size, [&] (bytes_mutable_view out) {
+                    auto ret = ZSTD_decompressDCtx(zstd_dctx(), out.data(), out.size(), in.data(), in.size());
+                    if (ZSTD_isError(ret)) {
+                        throw std::runtime_error(format("CQL frame zstd uncompression failure: {}", ZSTD_getErrorName(ret)));
+                    }
+                    if (ret != out.size()) {
+                        throw std::runtime_error("Malformed CQL frame - provided uncompressed size different than real uncompressed size");
+                    }
+                    return ret;
+                });
+                on_compression_buffer_use();
+                return uncomp;
+            });
         } else {
             throw exceptions::protocol_exception(format("Unknown compression algorithm"));
         }
@@ -875,6 +991,8 @@ future<std::unique_ptr<cql_server::response>> cql_server::connection::process_st
              _compression = cql_compression::lz4;
          } else if (compression == "snappy") {
              _compression = cql_compression::snappy;
+         } else if (compression == "zstd") {
+             _compression = cql_compression::zstd;
          } else {
              throw exceptions::protocol_exception(format("Unknown compression algorithm: {}", compression));
          }
@@ -951,9 +1069,15 @@ cql_server::connection::process_on_shard(::shared_ptr<messages::result_message::
                     cql3::computed_function_values& cached_vals) mutable {
             request_reader in(is, linearization_buffer);
             return process_fn(client_state, server._query_processor, in, stream, _version,
-                    /* FIXME */empty_service_permit(), std::move(trace_state), false, std::move(cached_vals)).then([] (auto msg) {
+                    /* FIXME */empty_service_permit(), trace_state, false, std::move(cached_vals)).then(
+                    [this, is, stream, &client_state, trace_state, process_fn] (auto msg) mutable {
+                // The shard a request was routed to before processing it may
+                // turn out not to own it after all.
+                if (auto* bounce_msg = std::get_if<shared_ptr<messages::result_message::bounce_to_shard>>(&msg)) {
+                    return process_on_shard(*bounce_msg, stream, is, client_state, empty_service_permit(), std::move(trace_state), process_fn);
+                }
                 // result here has to be foreign ptr
-                return std::get<cql_server::result_with_foreign_response_ptr>(std::move(msg));
+                return make_ready_future<cql_server::result_with_foreign_response_ptr>(std::get<cql_server::result_with_foreign_response_ptr>(std::move(msg)));
             });
         });
     });
@@ -1056,26 +1180,37 @@ future<std::unique_ptr<cql_server::response>> cql_server::connection::process_pr
     });
 }
 
+// The shard owning the partition a conditional modification writes to, if
+// the bound values alone tell it. Such requests can be routed to it right
+// away, instead of being authorized and prepared for paxos on this shard
+// only to be bounced.
+static std::optional<unsigned> conditional_statement_shard(const cql3::statements::prepared_statement& prepared, const cql3::query_options& options) {
+    auto stmt = dynamic_cast<const cql3::statements::modification_statement*>(prepared.statement.get());
+    if (!stmt || !stmt->has_conditions() || prepared.partition_key_bind_indices.empty()) {
+        return std::nullopt;
+    }
+    std::vector<managed_bytes> components;
+    components.reserve(prepared.partition_key_bind_indices.size());
+    for (auto idx : prepared.partition_key_bind_indices) {
+        if (options.is_unset(idx)) {
+            return std::nullopt;
+        }
+        auto value = to_managed_bytes_opt(options.get_value_at(idx));
+        if (!value) {
+            return std::nullopt;
+        }
+        components.push_back(std::move(*value));
+    }
+    auto key = partition_key::from_exploded(*stmt->s, components);
+    return service::storage_proxy::cas_shard(*stmt->s, dht::decorate_key(*stmt->s, key).token());
+}
+
 static future<process_fn_return_type>
-process_execute_internal(service::client_state& client_state, distributed<cql3::query_processor>& qp, request_reader in,
+process_execute_prepared(cql3::statements::prepared_statement::checked_weak_ptr prepared, bool needs_authorization,
+        cql3::prepared_cache_key_type cache_key, service::client_state& client_state, distributed<cql3::query_processor>& qp, request_reader in,
         uint16_t stream, cql_protocol_version_type version,
         service_permit permit, tracing::trace_state_ptr trace_state, bool init_trace, cql3::computed_function_values cached_pk_fn_calls) {
-    cql3::prepared_cache_key_type cache_key(in.read_short_bytes());
     auto& id = cql3::prepared_cache_key_type::cql_id(cache_key);
-    bool needs_authorization = false;
-
-    // First, try to lookup in the cache of already authorized statements. If the corresponding entry is not found there
-    // look for the prepared statement and then authorize it.
-    auto prepared = qp.local().get_prepared(client_state.user(), cache_key);
-    if (!prepared) {
-        needs_authorization = true;
-        prepared = qp.local().get_prepared(cache_key);
-    }
-
-    if (!prepared) {
-        throw exceptions::prepared_query_not_found_exception(id);
-    }
-
     auto q_state = std::make_unique<cql_query_state>(client_state, trace_state, std::move(permit));
     auto& query_state = q_state->query_state;
     q_state->options = in.read_options(version, qp.local().get_cql_config());
@@ -1110,6 +1245,12 @@ process_execute_internal(service::client_state& client_state, distributed<cql3::
 
     if (init_trace) {
         tracing::add_prepared_query_options(trace_state, options);
+
+        if (auto shard = conditional_statement_shard(*prepared, options); shard && *shard != this_shard_id()) {
+            tracing::trace(trace_state, "Routing the statement to shard {}", *shard);
+            return make_ready_future<process_fn_return_type>(
+                    dynamic_pointer_cast<messages::result_message::bounce_to_shard>(qp.local().bounce_to_shard(*shard, {})));
+        }
     }
 
     tracing::trace(trace_state, "Processing a statement");
@@ -1126,6 +1267,39 @@ process_execute_internal(service::client_state& client_state, distributed<cql3::
     });
 }
 
+static future<process_fn_return_type>
+process_execute_internal(service::client_state& client_state, distributed<cql3::query_processor>& qp, request_reader in,
+        uint16_t stream, cql_protocol_version_type version,
+        service_permit permit, tracing::trace_state_ptr trace_state, bool init_trace, cql3::computed_function_values cached_pk_fn_calls) {
+    cql3::prepared_cache_key_type cache_key(in.read_short_bytes());
+    bool needs_authorization = false;
+
+    // First, try to lookup in the cache of already authorized statements. If the corresponding entry is not found there
+    // look for the prepared statement and then authorize it.
+    auto prepared = qp.local().get_prepared(client_state.user(), cache_key);
+    if (!prepared) {
+        needs_authorization = true;
+        prepared = qp.local().get_prepared(cache_key);
+    }
+
+    if (prepared) {
+        return process_execute_prepared(std::move(prepared), needs_authorization, std::move(cache_key), client_state, qp, std::move(in),
+                stream, version, std::move(permit), std::move(trace_state), init_trace, std::move(cached_pk_fn_calls));
+    }
+
+    // The statement may have been evicted only from the cache of this shard.
+    auto f = qp.local().prepare_from_other_shards(cache_key, client_state);
+    return f.then([cache_key = std::move(cache_key), &client_state, &qp, in = std::move(in), stream, version, permit = std::move(permit),
+            trace_state = std::move(trace_state), init_trace, cached_pk_fn_calls = std::move(cached_pk_fn_calls)]
+            (cql3::statements::prepared_statement::checked_weak_ptr prepared) mutable {
+        if (!prepared) {
+            throw exceptions::prepared_query_not_found_exception(cql3::prepared_cache_key_type::cql_id(cache_key));
+        }
+        return process_execute_prepared(std::move(prepared), true, std::move(cache_key), client_state, qp, std::move(in),
+                stream, version, std::move(permit), std::move(trace_state), init_trace, std::move(cached_pk_fn_calls));
+    });
+}
+
 future<cql_server::result_with_foreign_response_ptr> cql_server::connection::process_execute(uint16_t stream, request_reader in,
         service::client_state& client_state, service_permit permit, tracing::trace_state_ptr trace_state) {
     return process(stream, in, client_state, std::move(permit), std::move(trace_state), process_execute_internal);
@@ -1260,6 +1434,9 @@ cql_server::connection::process_register(uint16_t stream, request_reader in, ser
     in.read_string_list(event_types);
     for (auto&& event_type : event_types) {
         auto et = parse_event_type(event_type);
+        if (et == event::event_type::CDC_CHANGE && !client_state.is_protocol_extension_set(cql_transport::cql_protocol_extension::CDC_CHANGE_EVENTS)) {
+            throw exceptions::protocol_exception("CDC_CHANGE events require the SCYLLA_CDC_CHANGE_EVENTS protocol extension");
+        }
         _server._notifier->register_event(et, this);
     }
     _ready = true;
@@ -1415,6 +1592,7 @@ std::unique_ptr<cql_server::response> cql_server::connection::make_supported(int
     opts.insert({"CQL_VERSION", cql3::query_processor::CQL_VERSION});
     opts.insert({"COMPRESSION", "lz4"});
     opts.insert({"COMPRESSION", "snappy"});
+    opts.insert({"COMPRESSION", "zstd"});
     if (_server._config.allow_shard_aware_drivers) {
         opts.insert({"SCYLLA_SHARD", format("{:d}", this_shard_id())});
         opts.insert({"SCYLLA_NR_SHARDS", format("{:d}", smp::count)});
@@ -1557,10 +1735,34 @@ cql_server::connection::make_schema_change_event(const event::schema_change& eve
     return response;
 }
 
+std::unique_ptr<cql_server::response>
+cql_server::connection::make_cdc_change_event(const event::cdc_change& event) const
+{
+    auto response = std::make_unique<cql_server::response>(-1, cql_binary_opcode::EVENT, tracing::trace_state_ptr());
+    response->write_string("CDC_CHANGE");
+    response->write_string(event.keyspace);
+    response->write_string(event.table);
+    response->write_short(event.stream_ids.size());
+    for (auto& stream_id : event.stream_ids) {
+        response->write_short_bytes(stream_id);
+    }
+    return response;
+}
+
 void cql_server::connection::write_response(foreign_ptr<std::unique_ptr<cql_server::response>>&& response, service_permit permit, cql_compression compression)
 {
     _ready_to_respond = _ready_to_respond.then([this, compression, response = std::move(response), permit = std::move(permit)] () mutable {
-        auto message = response->make_message(_version, compression);
+        if (compression != cql_compression::none) {
+            auto size = response->size();
+            if (size >= _server._compression_min_size() && response->compress(compression)) {
+                ++_server._stats.compressed_responses;
+                _server._stats.compression_input_bytes += size;
+                _server._stats.compression_output_bytes += response->size();
+            } else {
+                ++_server._stats.uncompressed_responses;
+            }
+        }
+        auto message = response->make_message(_version);
         message.on_delete([response = std::move(response)] { });
         return _write_buf.write(std::move(message)).then([this] {
             return _write_buf.flush();
@@ -1568,10 +1770,7 @@ void cql_server::connection::write_response(foreign_ptr<std::unique_ptr<cql_serv
     });
 }
 
-scattered_message<char> cql_server::response::make_message(uint8_t version, cql_compression compression) {
-    if (compression != cql_compression::none) {
-        compress(compression);
-    }
+scattered_message<char> cql_server::response::make_message(uint8_t version) {
     scattered_message<char> msg;
     auto frame = make_frame(version, _body.size());
     msg.append(std::move(frame));
@@ -1581,22 +1780,29 @@ scattered_message<char> cql_server::response::make_message(uint8_t version, cql_
     return msg;
 }
 
-void cql_server::response::compress(cql_compression compression)
+bool cql_server::response::compress(cql_compression compression)
 {
+    bool compressed;
     switch (compression) {
     case cql_compression::lz4:
-        compress_lz4();
+        compressed = compress_lz4();
         break;
     case cql_compression::snappy:
-        compress_snappy();
+        compressed = compress_snappy();
+        break;
+    case cql_compression::zstd:
+        compressed = compress_zstd();
         break;
     default:
         throw std::invalid_argument("Invalid CQL compression algorithm");
     }
-    set_frame_flag(cql_frame_flags::compression);
+    if (compressed) {
+        set_frame_flag(cql_frame_flags::compression);
+    }
+    return compressed;
 }
 
-void cql_server::response::compress_lz4()
+bool cql_server::response::compress_lz4()
 {
     using namespace compression_buffers;
     auto view = input_buffer.get_linearized_view(_body);
@@ -1604,7 +1810,7 @@ void cql_server::response::compress_lz4()
     size_t input_len = view.size();
 
     size_t output_len = LZ4_COMPRESSBOUND(input_len) + 4;
-    _body = output_buffer.make_buffer(output_len, [&] (bytes_mutable_view output_view) {
+    auto body = output_buffer.make_buffer(output_len, [&] (bytes_mutable_view output_view) {
         char* output = reinterpret_cast<char*>(output_view.data());
         output[0] = (input_len >> 24) & 0xFF;
         output[1] = (input_len >> 16) & 0xFF;
@@ -1617,9 +1823,14 @@ void cql_server::response::compress_lz4()
         return ret + 4;
     });
     on_compression_buffer_use();
+    if (body.size() >= input_len) {
+        return false;
+    }
+    _body = std::move(body);
+    return true;
 }
 
-void cql_server::response::compress_snappy()
+bool cql_server::response::compress_snappy()
 {
     using namespace compression_buffers;
     auto view = input_buffer.get_linearized_view(_body);
@@ -1627,7 +1838,7 @@ void cql_server::response::compress_snappy()
     size_t input_len = view.size();
 
     size_t output_len = snappy_max_compressed_length(input_len);
-    _body = output_buffer.make_buffer(output_len, [&] (bytes_mutable_view output_view) {
+    auto body = output_buffer.make_buffer(output_len, [&] (bytes_mutable_view output_view) {
         char* output = reinterpret_cast<char*>(output_view.data());
         if (snappy_compress(input, input_len, output, &output_len) != SNAPPY_OK) {
             throw std::runtime_error("CQL frame Snappy compression failure");
@@ -1635,6 +1846,33 @@ void cql_server::response::compress_snappy()
         return output_len;
     });
     on_compression_buffer_use();
+    if (body.size() >= input_len) {
+        return false;
+    }
+    _body = std::move(body);
+    return true;
+}
+
+bool cql_server::response::compress_zstd()
+{
+    using namespace compression_buffers;
+    auto view = input_buffer.get_linearized_view(_body);
+    size_t input_len = view.size();
+
+    // The frame header holds the uncompressed size, for the peer to allocate its output.
+    auto body = output_buffer.make_buffer(ZSTD_compressBound(input_len), [&] (bytes_mutable_view output_view) {
+        auto ret = ZSTD_compressCCtx(zstd_cctx(), output_view.data(), output_view.size(), view.data(), input_len, zstd_compression_level);
+        if (ZSTD_isError(ret)) {
+            throw std::runtime_error(format("CQL frame zstd compression failure: {}", ZSTD_getErrorName(ret)));
+        }
+        return ret;
+    });
+    on_compression_buffer_use();
+    if (body.size() >= input_len) {
+        return false;
+    }
+    _body = std::move(body);
+    return true;
 }
 
 void cql_server::response::serialize(const event::schema_change& event, uint8_t version)
@@ -12,10 +12,13 @@
 #include <seastar/core/seastar.hh>
 #include "service/endpoint_lifecycle_subscriber.hh"
 #include "service/migration_listener.hh"
+#include "cdc/log.hh"
 #include "auth/authenticator.hh"
 #include <seastar/core/distributed.hh>
 #include "timeout_config.hh"
 #include <seastar/core/semaphore.hh>
+#include <seastar/core/gate.hh>
+#include <seastar/core/timer.hh>
 #include <memory>
 #include <boost/intrusive/list.hpp>
 #include <seastar/net/tls.hh>
@@ -29,6 +32,8 @@
 #include "service/query_state.hh"
 #include "cql3/query_options.hh"
 #include "transport/messages/result_message.hh"
+#include "transport/admission_queue.hh"
+#include "service/qos/latency_slo_guard.hh"
 #include "utils/chunked_vector.hh"
 #include "exceptions/coordinator_result.hh"
 #include "db/operation_type.hh"
@@ -70,6 +75,8 @@ enum class cql_compression {
     none,
     lz4,
     snappy,
+    // Not in the CQL protocol, for the drivers which support it.
+    zstd,
 };
 
 enum cql_frame_flags {
@@ -139,6 +146,10 @@ class cql_server : public seastar::peering_sharded_service<cql_server>, public g
         uint32_t requests_serving = 0;
         uint64_t requests_blocked_memory = 0;
         uint64_t requests_shed = 0;
+        uint64_t compressed_responses = 0;
+        uint64_t uncompressed_responses = 0; // Small or incompressible, of connections with compression.
+        uint64_t compression_input_bytes = 0;
+        uint64_t compression_output_bytes = 0;
 
         std::unordered_map<exceptions::exception_code, uint64_t> errors;
     };
@@ -151,7 +162,11 @@ class cql_server : public seastar::peering_sharded_service<cql_server>, public g
     cql_server_config _config;
     size_t _max_request_size;
     utils::updateable_value<uint32_t> _max_concurrent_requests;
+    utils::updateable_value<uint32_t> _max_concurrent_requests_per_connection;
+    utils::updateable_value<uint32_t> _compression_min_size;
     semaphore& _memory_available;
+    admission_queue _admission;
+    qos::latency_slo_guard _latency_slo_guard;
     seastar::metrics::metric_groups _metrics;
     std::unique_ptr<event_notifier> _notifier;
 private:
@@ -173,6 +188,10 @@ class cql_server : public seastar::peering_sharded_service<cql_server>, public g
     using result_with_foreign_response_ptr = exceptions::coordinator_result<foreign_ptr<std::unique_ptr<cql_server::response>>>;
     service::endpoint_lifecycle_subscriber* get_lifecycle_listener() const noexcept;
     service::migration_listener* get_migration_listener() const noexcept;
+    cdc::change_subscriber* get_cdc_change_subscriber() const noexcept;
+    // Waits for the CDC_CHANGE events sent to the other shards, once this shard
+    // is no longer subscribed to the CDC changes.
+    future<> stop_cdc_change_events();
     cql_sg_stats::request_kind_stats& get_cql_opcode_stats(cql_binary_opcode op) {
         return scheduling_group_get_specific<cql_sg_stats>(_stats_key).get_cql_opcode_stats(op);
     }
@@ -196,6 +215,10 @@ class cql_server : public seastar::peering_sharded_service<cql_server>, public g
         unsigned _request_cpu = 0;
         bool _ready = false;
         bool _authenticating = false;
+        // Flow of the requests of anonymous users in the admission queue.
+        sstring _anonymous_admission_flow;
+        // Set while reading requests waits for one to complete.
+        std::optional<promise<>> _request_completed;
 
         enum class tracing_request_type : uint8_t {
             not_requested,
@@ -227,6 +250,8 @@ class cql_server : public seastar::peering_sharded_service<cql_server>, public g
         future<foreign_ptr<std::unique_ptr<cql_server::response>>> process_request_one(fragmented_temporary_buffer::istream buf, uint8_t op, uint16_t stream, service::client_state& client_state, tracing_request_type tracing_request, service_permit permit);
         unsigned frame_size() const;
         unsigned pick_request_cpu();
+        const sstring& admission_flow() const;
+        future<> wait_for_request_slot();
         cql_binary_frame_v3 parse_frame(temporary_buffer<char> buf) const;
         future<fragmented_temporary_buffer> read_and_decompress_frame(size_t length, uint8_t flags);
         future<std::optional<cql_binary_frame_v3>> read_frame();
@@ -254,6 +279,7 @@ class cql_server : public seastar::peering_sharded_service<cql_server>, public g
         std::unique_ptr<cql_server::response> make_topology_change_event(const cql_transport::event::topology_change& event) const;
         std::unique_ptr<cql_server::response> make_status_change_event(const cql_transport::event::status_change& event) const;
         std::unique_ptr<cql_server::response> make_schema_change_event(const cql_transport::event::schema_change& event) const;
+        std::unique_ptr<cql_server::response> make_cdc_change_event(const cql_transport::event::cdc_change& event) const;
         std::unique_ptr<cql_server::response> make_autheticate(int16_t, std::string_view, const tracing::trace_state_ptr& tr_state) const;
         std::unique_ptr<cql_server::response> make_auth_success(int16_t, bytes, const tracing::trace_state_ptr& tr_state) const;
         std::unique_ptr<cql_server::response> make_auth_challenge(int16_t, bytes, const tracing::trace_state_ptr& tr_state) const;
@@ -284,12 +310,29 @@ class cql_server : public seastar::peering_sharded_service<cql_server>, public g
 };
 
 class cql_server::event_notifier : public service::migration_listener,
-                                   public service::endpoint_lifecycle_subscriber
+                                   public service::endpoint_lifecycle_subscriber,
+                                   public cdc::change_subscriber
 {
-    const cql_server& _server;
+public:
+    // The streams with new changes, per keyspace and name of their log table.
+    using cdc_changes = std::map<std::pair<sstring, sstring>, std::unordered_set<bytes>>;
+    // CDC changes are sent to clients at most once per interval, so that a
+    // stream written to often is notified once per interval.
+    static constexpr std::chrono::milliseconds cdc_changes_interval{100};
+    static constexpr size_t max_stream_ids_per_event = 1024;
+private:
+    cql_server& _server;
     std::set<cql_server::connection*> _topology_change_listeners;
     std::set<cql_server::connection*> _status_change_listeners;
     std::set<cql_server::connection*> _schema_change_listeners;
+    std::set<cql_server::connection*> _cdc_change_listeners;
+    // Connections learn of the CDC changes coordinated by all shards, so
+    // shards collect them as long as any shard has listeners.
+    int64_t _cdc_change_listeners_on_all_shards = 0;
+    cdc_changes _pending_cdc_changes;
+    timer<lowres_clock> _cdc_changes_timer;
+    // Closed once this shard no longer sends CDC changes to the other shards.
+    gate _cdc_changes_gate;
     std::unordered_map<gms::inet_address, event::status_change::status_type> _last_status_change;
 
     // We want to delay sending NEW_NODE CQL event to clients until the new node
@@ -297,10 +340,14 @@ class cql_server::event_notifier : public service::migration_listener,
     std::unordered_set<gms::inet_address> _endpoints_pending_joined_notification;
 
     void send_join_cluster(const gms::inet_address& endpoint);
+    void update_cdc_change_listeners(int64_t delta);
+    void flush_cdc_changes();
+    void send_cdc_changes(const cdc_changes& changes);
 public:
-    explicit event_notifier(const cql_server& s) noexcept : _server(s) {}
+    explicit event_notifier(cql_server& s);
     void register_event(cql_transport::event::event_type et, cql_server::connection* conn);
     void unregister_connection(cql_server::connection* conn);
+    future<> stop_cdc_changes();
 
     virtual void on_create_keyspace(const sstring& ks_name) override;
     virtual void on_create_column_family(const sstring& ks_name, const sstring& cf_name) override;
@@ -327,8 +374,11 @@ class cql_server::event_notifier : public service::migration_listener,
     virtual void on_leave_cluster(const gms::inet_address& endpoint) override;
     virtual void on_up(const gms::inet_address& endpoint) override;
     virtual void on_down(const gms::inet_address& endpoint) override;
+
+    virtual void on_cdc_change(const schema& log_schema, const std::vector<bytes>& stream_ids) override;
 };
 
 inline service::endpoint_lifecycle_subscriber* cql_server::get_lifecycle_listener() const noexcept { return _notifier.get(); }
 inline service::migration_listener* cql_server::get_migration_listener() const noexcept { return _notifier.get(); }
+inline cdc::change_subscriber* cql_server::get_cdc_change_subscriber() const noexcept { return _notifier.get(); }
 }
@@ -93,8 +93,10 @@ std::optional<View> read_tuple_element(View& v) {
     return read_simple_bytes(v, s);
 }
 
+// Returns a view of the n-th element of a serialized tuple, skipping over the
+// preceding elements without deserializing them.
 template <FragmentedView View>
-bytes_opt get_nth_tuple_element(View v, size_t n) {
+std::optional<View> read_nth_tuple_element(View v, size_t n) {
     for (size_t i = 0; i < n; ++i) {
         if (v.empty()) {
             return std::nullopt;
@@ -104,7 +106,12 @@ bytes_opt get_nth_tuple_element(View v, size_t n) {
     if (v.empty()) {
         return std::nullopt;
     }
-    auto el = read_tuple_element(v);
+    return read_tuple_element(v);
+}
+
+template <FragmentedView View>
+bytes_opt get_nth_tuple_element(View v, size_t n) {
+    auto el = read_nth_tuple_element(v, n);
     if (el) {
         return linearized(*el);
     }
@@ -27,6 +27,7 @@
 #include <string>
 #include <boost/regex.hpp>
 #include <concepts>
+#include <bit>
 #include <ctime>
 #include <cstdlib>
 #include <fmt/chrono.h>
@@ -1814,8 +1815,20 @@ static void serialize_varint_aux(bytes::iterator& out, const boost::multiprecisi
     export_bits(num, inserter_with_prefix{out, mask}, 8);
 }
 
+// Values that fit in 64 bits, most of them in practice, are serialized natively
+// rather than through cpp_int's export_bits(). The output is the same minimal
+// big-endian two's complement representation.
+static void serialize_varint_int64(bytes::iterator& out, int64_t num) {
+    uint64_t magnitude = num < 0 ? ~uint64_t(num) : uint64_t(num);
+    size_t size = magnitude ? align_up(size_t(64 - std::countl_zero(magnitude)) + 1, size_t(8)) / 8 : 1;
+    auto u = net::hton(uint64_t(num));
+    out = std::copy_n(reinterpret_cast<const char*>(&u) + sizeof(u) - size, size, out);
+}
+
 static void serialize_varint(bytes::iterator& out, const boost::multiprecision::cpp_int& num) {
-    if (num < 0) {
+    if (num >= std::numeric_limits<int64_t>::min() && num <= std::numeric_limits<int64_t>::max()) {
+        serialize_varint_int64(out, num.convert_to<int64_t>());
+    } else if (num < 0) {
         serialize_varint_aux(out, -num - 1, 0xff);
     } else {
         serialize_varint_aux(out, num, 0);
@@ -2029,6 +2042,16 @@ utils::multiprecision_int deserialize_value(const varint_type_impl&, View v) {
     }
     skip_empty_fragments(v);
     bool negative = v.current_fragment().front() < 0;
+    if (v.size_bytes() <= sizeof(int64_t)) {
+        // Fast path for values fitting in 64 bits: sign-extend and read natively.
+        uint64_t u = negative ? ~uint64_t(0) : 0;
+        for (auto&& frag : fragment_range(v)) {
+            for (uint8_t b : frag) {
+                u = (u << 8) | b;
+            }
+        }
+        return utils::multiprecision_int(static_cast<long long>(int64_t(u)));
+    }
     utils::multiprecision_int num;
   while (v.size_bytes()) {
     for (uint8_t b : v.current_fragment()) {
@@ -2383,11 +2406,7 @@ struct compare_visitor {
 };
 }
 
-std::strong_ordering abstract_type::compare(bytes_view v1, bytes_view v2) const {
-    return compare(managed_bytes_view(v1), managed_bytes_view(v2));
-}
-
-std::strong_ordering abstract_type::compare(managed_bytes_view v1, managed_bytes_view v2) const {
+std::strong_ordering abstract_type::compare_slow(managed_bytes_view v1, managed_bytes_view v2) const {
     try {
         return visit(*this, compare_visitor{v1, v2});
     } catch (const marshal_exception&) {
@@ -345,6 +345,10 @@ class abstract_type : public enable_shared_from_this<abstract_type> {
     bool equal(managed_bytes_view v1, managed_bytes_view v2) const;
     std::strong_ordering compare(bytes_view v1, bytes_view v2) const;
     std::strong_ordering compare(managed_bytes_view v1, managed_bytes_view v2) const;
+private:
+    // Compares values of any type, see compare().
+    std::strong_ordering compare_slow(managed_bytes_view v1, managed_bytes_view v2) const;
+public:
 
 private:
     // Explicitly instantiated in .cc
@@ -483,6 +487,48 @@ inline bool operator==(const abstract_type& x, const abstract_type& y)
      return &x == &y;
 }
 
+inline std::strong_ordering abstract_type::compare(bytes_view v1, bytes_view v2) const {
+    return compare(managed_bytes_view(v1), managed_bytes_view(v2));
+}
+
+// Clustering keys are compared many times for each lookup in the row cache
+// and memtables, so contiguous values of the types they are most often made
+// of are compared here, without going through the visitor of the type.
+inline std::strong_ordering abstract_type::compare(managed_bytes_view v1, managed_bytes_view v2) const {
+    if (v1.current_fragment().size() != v1.size() || v2.current_fragment().size() != v2.size()) {
+        return compare_slow(v1, v2);
+    }
+    const bytes_view b1 = v1.current_fragment();
+    const bytes_view b2 = v2.current_fragment();
+    const auto* p1 = reinterpret_cast<const char*>(b1.data());
+    const auto* p2 = reinterpret_cast<const char*>(b2.data());
+    switch (_kind) {
+    case kind::ascii:
+    case kind::utf8:
+    case kind::bytes:
+        return compare_unsigned(b1, b2);
+    case kind::int32:
+        if (b1.size() == sizeof(int32_t) && b2.size() == sizeof(int32_t)) {
+            return seastar::read_be<int32_t>(p1) <=> seastar::read_be<int32_t>(p2);
+        }
+        break;
+    case kind::long_kind:
+    case kind::timestamp:
+        if (b1.size() == sizeof(int64_t) && b2.size() == sizeof(int64_t)) {
+            return seastar::read_be<int64_t>(p1) <=> seastar::read_be<int64_t>(p2);
+        }
+        break;
+    case kind::timeuuid:
+        if (b1.size() == 16 && b2.size() == 16) {
+            return utils::timeuuid_tri_compare(b1, b2);
+        }
+        break;
+    default:
+        break;
+    }
+    return compare_slow(v1, v2);
+}
+
 template <typename T>
 inline
 data_value
@@ -20,7 +20,7 @@
 
 namespace utils {
 
-static int64_t make_thread_local_node(int64_t node) {
+static int64_t local_thread_id() {
     // An atomic counter to issue thread identifiers.
     // We should take current core number into consideration
     // because create_time_safe() doesn't synchronize across cores and
@@ -28,6 +28,11 @@ static int64_t make_thread_local_node(int64_t node) {
     // seastar::this_shard_id() may not yet be available.
     static std::atomic<int64_t> thread_id_counter;
     static thread_local int64_t thread_id = thread_id_counter.fetch_add(1);
+    return thread_id;
+}
+
+static int64_t make_thread_local_node(int64_t node) {
+    auto thread_id = local_thread_id();
     // Mix in the core number into Organisational Unique
     // Identifier, to leave NIC intact, assuming tampering
     // with NIC is more likely to lead to collision within
@@ -107,8 +112,15 @@ static int64_t make_clock_seq_and_node()
     // since the epoch, and taking 14 bits of it. We don't do exactly
     // the same, but the idea is the same.
     //long clock = new Random(System.currentTimeMillis()).nextLong();
-    unsigned int seed = std::chrono::system_clock::now().time_since_epoch().count();
-    int clock = rand_r(&seed);
+    //
+    // The random part is drawn once per process and the thread identifier
+    // is added to it, so that every shard gets its own clock sequence
+    // (there are far fewer shards than 2^14 sequences). Seeding each
+    // thread from the clock instead could give shards started within the
+    // same tick the same sequence.
+    static unsigned int seed = std::chrono::system_clock::now().time_since_epoch().count();
+    static int process_clock = rand_r(&seed);
+    int64_t clock = process_clock + local_thread_id();
 
     long lsb = 0;
     lsb |= 0x8000000000000000L;                 // variant (2 bits)
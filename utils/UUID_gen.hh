@@ -84,18 +84,23 @@ class UUID_gen
         assert(clock_seq_and_node != 0);
     }
 
-    // Return decimicrosecond time based on the system time,
-    // in milliseconds. If the current millisecond hasn't change
-    // from the previous call, increment the previously used
-    // value by one decimicrosecond.
+    // Return decimicrosecond time based on the system time.
+    // If the clock hasn't advanced since the previous call (or went
+    // back), increment the previously used value by one decimicrosecond,
+    // so the time UUIDs generated by a shard are strictly monotonic.
+    // The original Java code used millisecond time here, which makes
+    // the result run ahead of the clock once more than 10000 UUIDs
+    // are generated in a millisecond; the system clock has a much
+    // finer resolution, so use all of it.
     // NOTE: In the original Java code this function was
     // "synchronized". This isn't needed since in Scylla we do not
     // need monotonicity between time UUIDs created at different
     // shards and UUID code uses thread local state on each shard.
+    // Time UUIDs of different shards cannot collide, since each
+    // shard has its own clock sequence and node.
     int64_t create_time_safe() {
         using std::chrono::system_clock;
-        auto millis = duration_cast<milliseconds>(system_clock::now().time_since_epoch());
-        decimicroseconds when = from_unix_timestamp(millis);
+        decimicroseconds when = from_unix_timestamp(system_clock::now().time_since_epoch());
         if (when > _last_used_time) {
             _last_used_time = when;
         } else {
@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/core/posix.hh>
+#include <unistd.h>
+
+#include "utils/alien_worker.hh"
+
+namespace utils {
+
+alien_worker::alien_worker(logging::logger& log, int niceness)
+    : _thread([this, &log, niceness] { run(log, niceness); })
+{ }
+
+alien_worker::~alien_worker() {
+    push(std::nullopt);
+    _thread.join();
+}
+
+void alien_worker::push(std::optional<seastar::noncopyable_function<void()>> item) {
+    std::unique_lock lock(_mutex);
+    _pending.push(std::move(item));
+    lock.unlock();
+    _cv.notify_one();
+}
+
+void alien_worker::run(logging::logger& log, int niceness) {
+    // Signals are for the reactors to handle.
+    sigset_t mask;
+    sigfillset(&mask);
+    auto r = ::pthread_sigmask(SIG_BLOCK, &mask, nullptr);
+    seastar::throw_pthread_error(r);
+
+    errno = 0;
+    if (nice(niceness) == -1 && errno != 0) {
+        log.warn("Unable to renice the alien worker thread (system error number {}); the thread will compete with the reactor. Try adding CAP_SYS_NICE", errno);
+    }
+
+    for (;;) {
+        std::unique_lock lock(_mutex);
+        _cv.wait(lock, [this] { return !_pending.empty(); });
+        auto item = std::move(_pending.front());
+        _pending.pop();
+        lock.unlock();
+        if (!item) {
+            break;
+        }
+        (*item)();
+    }
+}
+
+} // namespace utils
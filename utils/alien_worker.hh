@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <thread>
+#include <type_traits>
+
+#include <seastar/core/alien.hh>
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/future.hh>
+#include <seastar/core/reactor.hh>
+#include <seastar/util/noncopyable_function.hh>
+
+#include "log.hh"
+
+namespace utils {
+
+// Runs functions which can't be preempted and would stall the reactor, like
+// long computations in third party libraries, on a thread of its own, one at
+// a time, in the order they were submitted. The thread is niced, so it
+// yields to the reactors.
+class alien_worker {
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    // A disengaged item stops the thread.
+    std::queue<std::optional<seastar::noncopyable_function<void()>>> _pending;
+    std::thread _thread;
+private:
+    void push(std::optional<seastar::noncopyable_function<void()>> item);
+    void run(logging::logger& log, int niceness);
+public:
+    alien_worker(logging::logger& log, int niceness);
+    ~alien_worker();
+    alien_worker(const alien_worker&) = delete;
+    alien_worker& operator=(const alien_worker&) = delete;
+
+    // Runs func() on the worker thread, and resolves with its result on the
+    // calling shard. func must not use anything shard-local, and whatever it
+    // refers to has to be kept alive until the returned future resolves.
+    template <typename Func>
+    requires (!std::is_void_v<std::invoke_result_t<Func>>)
+    seastar::future<std::invoke_result_t<Func>> submit(Func func) {
+        using T = std::invoke_result_t<Func>;
+        // The promise is only touched on this shard, and lives in the
+        // coroutine frame until the thread resolves it.
+        seastar::promise<T> p;
+        auto f = p.get_future();
+        push([&p, func = std::move(func), &alien = seastar::engine().alien(), shard = seastar::this_shard_id()] () mutable {
+            try {
+                seastar::alien::run_on(alien, shard, [&p, v = func()] () mutable noexcept {
+                    p.set_value(std::move(v));
+                });
+            } catch (...) {
+                seastar::alien::run_on(alien, shard, [&p, ex = std::current_exception()] () noexcept {
+                    p.set_exception(ex);
+                });
+            }
+        });
+        co_return co_await std::move(f);
+    }
+};
+
+} // namespace utils
@@ -9,6 +9,7 @@
 #include "base64.hh"
 
 #include <ctype.h>
+#include <cstring>
 #include <seastar/core/print.hh>
 
 // Arrays for quickly converting to and from an integer between 0 and 63,
@@ -18,45 +19,46 @@ static class base64_chars {
     static constexpr const char to[] =
             "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
     static constexpr uint8_t invalid_char = 255;
-    uint8_t from[255];
+    uint8_t from[256];
+    // The two characters encoding each 12 bit integer, so that three bytes
+    // of input are encoded with two lookups.
+    char to_pair[4096][2];
     base64_chars() {
         static_assert(sizeof(to) == 64 + 1);
-        for (int i = 0; i < 255; i++) {
+        for (int i = 0; i < 256; i++) {
             from[i] = invalid_char; // signal invalid character
         }
         for (int i = 0; i < 64; i++) {
             from[(unsigned) to[i]] = i;
         }
+        for (int i = 0; i < 4096; i++) {
+            to_pair[i][0] = to[i >> 6];
+            to_pair[i][1] = to[i & 0x3f];
+        }
     }
 } base64_chars;
 
 std::string base64_encode(bytes_view in) {
     std::string ret;
-    ret.reserve(((4 * in.size() / 3) + 3) & ~3);
-    int i = 0;
-    unsigned char chunk3[3]; // chunk of input
-    for (auto byte : in) {
-        chunk3[i++] = byte;
-        if (i == 3) {
-            ret += base64_chars.to[ (chunk3[0] & 0xfc) >> 2 ];
-            ret += base64_chars.to[ ((chunk3[0] & 0x03) << 4) + ((chunk3[1] & 0xf0) >> 4) ];
-            ret += base64_chars.to[ ((chunk3[1] & 0x0f) << 2) + ((chunk3[2] & 0xc0) >> 6) ];
-            ret += base64_chars.to[ chunk3[2] & 0x3f ];
-            i = 0;
-        }
+    ret.resize((in.size() + 2) / 3 * 4);
+    auto out = ret.data();
+    auto p = reinterpret_cast<const uint8_t*>(in.data());
+    auto end = p + in.size() / 3 * 3;
+    for (; p != end; p += 3, out += 4) {
+        uint32_t chunk3 = (uint32_t(p[0]) << 16) | (uint32_t(p[1]) << 8) | p[2];
+        std::memcpy(out, base64_chars.to_pair[chunk3 >> 12], 2);
+        std::memcpy(out + 2, base64_chars.to_pair[chunk3 & 0xfff], 2);
     }
-    if (i) {
-        // i can be 1 or 2.
-        for(int j = i; j < 3; j++)
-            chunk3[j] = '\0';
-        ret += base64_chars.to[ ( chunk3[0] & 0xfc) >> 2 ];
-        ret += base64_chars.to[ ((chunk3[0] & 0x03) << 4) + ((chunk3[1] & 0xf0) >> 4) ];
-        if (i == 2) {
-            ret += base64_chars.to[ ((chunk3[1] & 0x0f) << 2) + ((chunk3[2] & 0xc0) >> 6) ];
-        } else {
-            ret += '=';
+    auto left = in.size() % 3;
+    if (left) {
+        // left can be 1 or 2.
+        uint32_t chunk3 = uint32_t(p[0]) << 16;
+        if (left == 2) {
+            chunk3 |= uint32_t(p[1]) << 8;
         }
-        ret += '=';
+        std::memcpy(out, base64_chars.to_pair[chunk3 >> 12], 2);
+        out[2] = left == 2 ? base64_chars.to[(chunk3 >> 6) & 0x3f] : '=';
+        out[3] = '=';
     }
     return ret;
 }
@@ -75,41 +77,67 @@ static void base64_trim_padding(std::string_view& str) {
     str.remove_suffix(base64_padding_len(str));
 }
 
-static std::string base64_decode_string(std::string_view in) {
-    base64_trim_padding(in);
-    int i = 0;
-    int8_t chunk4[4]; // chunk of input, each byte converted to 0..63;
-    std::string ret;
-    ret.reserve(in.size() * 3 / 4);
-    for (unsigned char c : in) {
-        uint8_t dc = base64_chars.from[c];
-        if (dc == base64_chars::invalid_char) {
-           throw std::invalid_argument(format("Invalid Base64 character: '{}'", char(c)));
+// Decodes in, without padding, into out, which has room for the decoded bytes.
+static void base64_decode_to(std::string_view in, char* out) {
+    auto invalid = [] (unsigned char c) {
+        return std::invalid_argument(format("Invalid Base64 character: '{}'", char(c)));
+    };
+    auto p = reinterpret_cast<const unsigned char*>(in.data());
+    auto end = p + in.size() / 4 * 4;
+    for (; p != end; p += 4, out += 3) {
+        uint8_t chunk4[4]; // chunk of input, each byte converted to 0..63;
+        for (int i = 0; i < 4; i++) {
+            chunk4[i] = base64_chars.from[p[i]];
         }
-        chunk4[i++] = dc;
-        if (i == 4) {
-            ret += (chunk4[0] << 2) + ((chunk4[1] & 0x30) >> 4);
-            ret += ((chunk4[1] & 0xf) << 4) + ((chunk4[2] & 0x3c) >> 2);
-            ret += ((chunk4[2] & 0x3) << 6) + chunk4[3];
-            i = 0;
+        // Valid characters are below 64, so any invalid one sets the high bits.
+        if ((chunk4[0] | chunk4[1] | chunk4[2] | chunk4[3]) & 0xc0) {
+            for (int i = 0; i < 4; i++) {
+                if (chunk4[i] == base64_chars::invalid_char) {
+                    throw invalid(p[i]);
+                }
+            }
         }
+        uint32_t chunk3 = (uint32_t(chunk4[0]) << 18) | (uint32_t(chunk4[1]) << 12) | (uint32_t(chunk4[2]) << 6) | chunk4[3];
+        out[0] = chunk3 >> 16;
+        out[1] = chunk3 >> 8;
+        out[2] = chunk3;
     }
-    if (i) {
-        // i can be 2 or 3, meaning 1 or 2 more output characters
-        if (i>=2)
-            ret += (chunk4[0] << 2) + ((chunk4[1] & 0x30) >> 4);
-        if (i==3)
-            ret += ((chunk4[1] & 0xf) << 4) + ((chunk4[2] & 0x3c) >> 2);
+    auto left = in.size() % 4;
+    if (left) {
+        // left can be 2 or 3, meaning 1 or 2 more output characters
+        uint8_t chunk4[3] = {0, 0, 0};
+        for (size_t i = 0; i < left; i++) {
+            chunk4[i] = base64_chars.from[p[i]];
+            if (chunk4[i] == base64_chars::invalid_char) {
+                throw invalid(p[i]);
+            }
+        }
+        if (left >= 2) {
+            *out++ = (chunk4[0] << 2) + ((chunk4[1] & 0x30) >> 4);
+        }
+        if (left == 3) {
+            *out++ = ((chunk4[1] & 0xf) << 4) + ((chunk4[2] & 0x3c) >> 2);
+        }
     }
+}
+
+static size_t base64_decoded_len_unpadded(std::string_view in) {
+    return in.size() / 4 * 3 + (in.size() % 4 ? in.size() % 4 - 1 : 0);
+}
+
+static std::string base64_decode_string(std::string_view in) {
+    base64_trim_padding(in);
+    std::string ret;
+    ret.resize(base64_decoded_len_unpadded(in));
+    base64_decode_to(in, ret.data());
     return ret;
 }
 
 bytes base64_decode(std::string_view in) {
-    // FIXME: This copy is sad. The problem is we need back "bytes"
-    // but "bytes" doesn't have efficient append and std::string.
-    // To fix this we need to use bytes' "uninitialized" feature.
-    std::string ret = base64_decode_string(in);
-    return bytes(ret.begin(), ret.end());
+    base64_trim_padding(in);
+    bytes ret(bytes::initialized_later(), base64_decoded_len_unpadded(in));
+    base64_decode_to(in, reinterpret_cast<char*>(ret.data()));
+    return ret;
 }
 
 size_t base64_decoded_len(std::string_view str) {
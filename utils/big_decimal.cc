@@ -12,6 +12,8 @@
 #include <seastar/core/print.hh>
 
 #include <regex>
+#include <optional>
+#include <limits>
 
 #ifdef __clang__
 
@@ -135,9 +137,53 @@ sstring big_decimal::to_string() const
     return str;
 }
 
+namespace {
+
+// Decimals used in practice have small unscaled values and scales that differ by
+// a few digits at most. For those, comparisons and additions are done in 128-bit
+// arithmetic, without allocating the cpp_int powers of ten needed to rescale.
+// Anything larger falls back to cpp_int.
+
+constexpr int64_t powers_of_ten[] = {
+    1LL, 10LL, 100LL, 1000LL, 10000LL, 100000LL, 1000000LL, 10000000LL, 100000000LL,
+    1000000000LL, 10000000000LL, 100000000000LL, 1000000000000LL, 10000000000000LL,
+    100000000000000LL, 1000000000000000LL, 10000000000000000LL, 100000000000000000LL,
+    1000000000000000000LL,
+};
+
+bool fits_int64(const boost::multiprecision::cpp_int& v) {
+    return v >= std::numeric_limits<int64_t>::min() && v <= std::numeric_limits<int64_t>::max();
+}
+
+// Returns v * 10^(to - from) when it cannot overflow a __int128: |v| < 2^63 and 10^18 < 2^60.
+std::optional<__int128> rescaled_int128(const boost::multiprecision::cpp_int& v, int32_t from, int32_t to) {
+    auto by = int64_t(to) - from;
+    if (by < 0 || by >= int64_t(std::size(powers_of_ten)) || !fits_int64(v)) {
+        return std::nullopt;
+    }
+    return __int128(v.convert_to<int64_t>()) * powers_of_ten[by];
+}
+
+boost::multiprecision::cpp_int from_int128(__int128 v) {
+    // Sums of two rescaled values are below 2^124 in magnitude.
+    auto negative = v < 0;
+    unsigned __int128 magnitude = negative ? -static_cast<unsigned __int128>(v) : v;
+    boost::multiprecision::cpp_int ret = uint64_t(magnitude >> 64);
+    ret <<= 64;
+    ret += uint64_t(magnitude);
+    return negative ? boost::multiprecision::cpp_int(-ret) : ret;
+}
+
+}
+
 std::strong_ordering big_decimal::operator<=>(const big_decimal& other) const
 {
     auto max_scale = std::max(_scale, other._scale);
+    auto fx = rescaled_int128(_unscaled_value, _scale, max_scale);
+    auto fy = fx ? rescaled_int128(other._unscaled_value, other._scale, max_scale) : std::nullopt;
+    if (fy) {
+        return *fx <=> *fy;
+    }
     boost::multiprecision::cpp_int rescale(10);
     boost::multiprecision::cpp_int x = _unscaled_value * boost::multiprecision::pow(rescale, max_scale - _scale);
     boost::multiprecision::cpp_int y = other._unscaled_value * boost::multiprecision::pow(rescale, max_scale - other._scale);
@@ -149,11 +195,17 @@ big_decimal& big_decimal::operator+=(const big_decimal& other)
     if (_scale == other._scale) {
         _unscaled_value += other._unscaled_value;
     } else {
-        boost::multiprecision::cpp_int rescale(10);
         auto max_scale = std::max(_scale, other._scale);
-        boost::multiprecision::cpp_int u = _unscaled_value * boost::multiprecision::pow(rescale,  max_scale - _scale);
-        boost::multiprecision::cpp_int v = other._unscaled_value * boost::multiprecision::pow(rescale, max_scale - other._scale);
-        _unscaled_value = u + v;
+        auto fu = rescaled_int128(_unscaled_value, _scale, max_scale);
+        auto fv = fu ? rescaled_int128(other._unscaled_value, other._scale, max_scale) : std::nullopt;
+        if (fv) {
+            _unscaled_value = from_int128(*fu + *fv);
+        } else {
+            boost::multiprecision::cpp_int rescale(10);
+            boost::multiprecision::cpp_int u = _unscaled_value * boost::multiprecision::pow(rescale,  max_scale - _scale);
+            boost::multiprecision::cpp_int v = other._unscaled_value * boost::multiprecision::pow(rescale, max_scale - other._scale);
+            _unscaled_value = u + v;
+        }
         _scale = max_scale;
     }
     return *this;
@@ -163,11 +215,17 @@ big_decimal& big_decimal::operator-=(const big_decimal& other) {
     if (_scale == other._scale) {
         _unscaled_value -= other._unscaled_value;
     } else {
-        boost::multiprecision::cpp_int rescale(10);
         auto max_scale = std::max(_scale, other._scale);
-        boost::multiprecision::cpp_int u = _unscaled_value * boost::multiprecision::pow(rescale,  max_scale - _scale);
-        boost::multiprecision::cpp_int v = other._unscaled_value * boost::multiprecision::pow(rescale, max_scale - other._scale);
-        _unscaled_value = u - v;
+        auto fu = rescaled_int128(_unscaled_value, _scale, max_scale);
+        auto fv = fu ? rescaled_int128(other._unscaled_value, other._scale, max_scale) : std::nullopt;
+        if (fv) {
+            _unscaled_value = from_int128(*fu - *fv);
+        } else {
+            boost::multiprecision::cpp_int rescale(10);
+            boost::multiprecision::cpp_int u = _unscaled_value * boost::multiprecision::pow(rescale,  max_scale - _scale);
+            boost::multiprecision::cpp_int v = other._unscaled_value * boost::multiprecision::pow(rescale, max_scale - other._scale);
+            _unscaled_value = u - v;
+        }
         _scale = max_scale;
     }
     return *this;
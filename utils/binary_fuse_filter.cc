@@ -0,0 +1,348 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "binary_fuse_filter.hh"
+#include "bloom_filter.hh"
+#include "bloom_calculations.hh"
+#include "log.hh"
+#include "utils/stall_free.hh"
+#include <seastar/core/thread.hh>
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <random>
+
+namespace utils {
+namespace filter {
+
+static logging::logger filterlog("binary_fuse_filter");
+
+thread_local binary_fuse_filter::stats binary_fuse_filter::_shard_stats;
+
+namespace {
+
+constexpr unsigned arity = 3;
+constexpr uint32_t max_segment_length = 1 << 18;
+constexpr int max_build_attempts = 100;
+
+uint32_t segment_length_for(int64_t num_elements) {
+    if (num_elements <= 1) {
+        return 4;
+    }
+    auto l = uint32_t(1) << int(std::floor(std::log(double(num_elements)) / std::log(3.33) + 2.25));
+    return std::min(l, max_segment_length);
+}
+
+double size_factor_for(int64_t num_elements) {
+    if (num_elements <= 1) {
+        return 0;
+    }
+    return std::max(1.125, 0.875 + 0.25 * std::log(1000000.0) / std::log(double(num_elements)));
+}
+
+// The number of segments slot ranges start in, so that the table spans two
+// more segments than that.
+uint32_t segment_count_for(int64_t num_elements, uint32_t segment_length) {
+    int64_t capacity = std::llround(num_elements * size_factor_for(num_elements));
+    int64_t segments = (capacity + segment_length - 1) / segment_length - int64_t(arity - 1);
+    return std::max<int64_t>(segments, 1);
+}
+
+uint64_t mask_of(unsigned fingerprint_bits) {
+    return fingerprint_bits == 64 ? ~uint64_t(0) : (uint64_t(1) << fingerprint_bits) - 1;
+}
+
+bool is_supported(unsigned fingerprint_bits) {
+    return std::ranges::find(binary_fuse_filter::supported_fingerprint_bits, fingerprint_bits) != std::end(binary_fuse_filter::supported_fingerprint_bits);
+}
+
+}
+
+binary_fuse_filter::binary_fuse_filter(unsigned fingerprint_bits, uint32_t segment_length, uint32_t segment_count_length)
+    : _seed(0)
+    , _fingerprint_bits(fingerprint_bits)
+    , _fingerprint_mask(mask_of(fingerprint_bits))
+    , _segment_length(segment_length)
+    , _segment_count_length(segment_count_length)
+{
+    _words.resize(header_words + (array_length() * _fingerprint_bits + 63) / 64);
+    _stats.memory_size += memory_size();
+}
+
+binary_fuse_filter::binary_fuse_filter(utils::chunked_vector<uint64_t> words)
+    : _words(std::move(words))
+{
+    if (_words.size() < header_words) {
+        throw std::invalid_argument(format("Binary fuse filter too short: {} words", _words.size()));
+    }
+    _seed = _words[0];
+    auto meta = _words[1];
+    _fingerprint_bits = meta & 0xff;
+    _segment_length = uint32_t(1) << ((meta >> 8) & 0x1f);
+    _segment_count_length = meta >> 32;
+    if (!is_supported(_fingerprint_bits)) {
+        throw std::invalid_argument(format("Unsupported binary fuse filter fingerprint size: {} bits", _fingerprint_bits));
+    }
+    _fingerprint_mask = mask_of(_fingerprint_bits);
+    auto expected_words = header_words + (array_length() * _fingerprint_bits + 63) / 64;
+    if (_segment_count_length % _segment_length || _words.size() != expected_words) {
+        throw std::invalid_argument(format("Inconsistent binary fuse filter: {} words, fingerprints of {} bits, segment length {}, segment count length {}",
+                _words.size(), _fingerprint_bits, _segment_length, _segment_count_length));
+    }
+    _stats.memory_size += memory_size();
+}
+
+binary_fuse_filter::~binary_fuse_filter() {
+    _stats.memory_size -= memory_size();
+}
+
+void binary_fuse_filter::write_header() {
+    _words[0] = _seed;
+    _words[1] = uint64_t(_fingerprint_bits) | (uint64_t(std::countr_zero(_segment_length)) << 8) | (uint64_t(_segment_count_length) << 32);
+}
+
+uint64_t binary_fuse_filter::mix(uint64_t key, uint64_t seed) noexcept {
+    // The murmur3 finalizer.
+    uint64_t h = key + seed;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+binary_fuse_filter::slots binary_fuse_filter::slots_of(uint64_t hash) const noexcept {
+    uint32_t mask = _segment_length - 1;
+    uint32_t h0 = (static_cast<unsigned __int128>(hash) * _segment_count_length) >> 64;
+    uint32_t h1 = h0 + _segment_length;
+    uint32_t h2 = h1 + _segment_length;
+    h1 ^= uint32_t(hash >> 18) & mask;
+    h2 ^= uint32_t(hash) & mask;
+    return {{h0, h1, h2}};
+}
+
+double binary_fuse_filter::bits_per_element(int64_t num_elements, unsigned fingerprint_bits) {
+    num_elements = std::max<int64_t>(num_elements, 1);
+    auto segment_length = segment_length_for(num_elements);
+    size_t slots = (segment_count_for(num_elements, segment_length) + arity - 1) * size_t(segment_length);
+    return double(slots * fingerprint_bits) / num_elements;
+}
+
+// Hypergraph peeling: a slot hit by a single key can be assigned last, so
+// that key is removed, which may leave other slots hit by a single key.
+// Once all keys are removed, the slots are assigned in the reverse order.
+bool binary_fuse_filter::try_build(const utils::chunked_vector<uint64_t>& keys) {
+    const size_t size = keys.size();
+    const size_t capacity = array_length();
+
+    // Per slot, the number of keys hitting it times 4 and the xor of the
+    // positions (0, 1 or 2) of the slot among those keys' slots.
+    utils::chunked_vector<uint8_t> t2count;
+    // Per slot, the xor of the hashes of the keys hitting it.
+    utils::chunked_vector<uint64_t> t2hash;
+    utils::chunked_vector<uint32_t> alone;
+    utils::chunked_vector<uint64_t> reverse_order;
+    utils::chunked_vector<uint8_t> reverse_h;
+    t2count.resize(capacity);
+    t2hash.resize(capacity);
+    alone.resize(capacity);
+    reverse_order.resize(size);
+    reverse_h.resize(size);
+
+    std::mt19937_64 rng(size);
+    for (int attempt = 0; attempt < max_build_attempts; ++attempt) {
+        _seed = rng();
+        if (attempt) {
+            std::fill(t2count.begin(), t2count.end(), 0);
+            std::fill(t2hash.begin(), t2hash.end(), 0);
+        }
+
+        bool overflow = false;
+        for (size_t i = 0; i < size; ++i) {
+            auto hash = mix(keys[i], _seed);
+            auto s = slots_of(hash);
+            for (unsigned j = 0; j < arity; ++j) {
+                t2count[s.h[j]] += 4;
+                t2count[s.h[j]] ^= j;
+                t2hash[s.h[j]] ^= hash;
+                overflow |= t2count[s.h[j]] < 4;
+            }
+            if ((i & 1023) == 0) {
+                seastar::thread::maybe_yield();
+            }
+        }
+        if (overflow) {
+            continue;
+        }
+
+        size_t qsize = 0;
+        for (size_t i = 0; i < capacity; ++i) {
+            alone[qsize] = i;
+            qsize += (t2count[i] >> 2) == 1;
+        }
+
+        size_t stack_size = 0;
+        while (qsize > 0) {
+            auto index = alone[--qsize];
+            if ((t2count[index] >> 2) != 1) {
+                continue;
+            }
+            auto hash = t2hash[index];
+            uint8_t found = t2count[index] & 3;
+            reverse_h[stack_size] = found;
+            reverse_order[stack_size] = hash;
+            ++stack_size;
+            auto s = slots_of(hash);
+            for (unsigned j = 1; j < arity; ++j) {
+                auto pos = (found + j) % arity;
+                auto other = s.h[pos];
+                alone[qsize] = other;
+                qsize += (t2count[other] >> 2) == 2;
+                t2count[other] -= 4;
+                t2count[other] ^= pos;
+                t2hash[other] ^= hash;
+            }
+            if ((stack_size & 1023) == 0) {
+                seastar::thread::maybe_yield();
+            }
+        }
+        if (stack_size != size) {
+            continue;
+        }
+
+        for (size_t i = size; i-- > 0;) {
+            auto hash = reverse_order[i];
+            auto s = slots_of(hash);
+            auto found = reverse_h[i];
+            set(s.h[found], fingerprint(hash) ^ get(s.h[(found + 1) % arity]) ^ get(s.h[(found + 2) % arity]));
+            if ((i & 1023) == 0) {
+                seastar::thread::maybe_yield();
+            }
+        }
+        write_header();
+        return true;
+    }
+    return false;
+}
+
+std::unique_ptr<binary_fuse_filter> binary_fuse_filter::build(const utils::chunked_vector<uint64_t>& keys, unsigned fingerprint_bits) {
+    assert(seastar::thread::running_in_thread());
+    if (!is_supported(fingerprint_bits)) {
+        throw std::invalid_argument(format("Unsupported binary fuse filter fingerprint size: {} bits", fingerprint_bits));
+    }
+    auto segment_length = segment_length_for(keys.size());
+    auto segment_count = segment_count_for(keys.size(), segment_length);
+    if (uint64_t(segment_count) * segment_length > std::numeric_limits<uint32_t>::max()) {
+        return nullptr;
+    }
+    auto f = std::unique_ptr<binary_fuse_filter>(new binary_fuse_filter(fingerprint_bits, segment_length, segment_count * segment_length));
+    if (!f->try_build(keys)) {
+        filterlog.warn("Failed to build a binary fuse filter of {} keys", keys.size());
+        return nullptr;
+    }
+    return f;
+}
+
+void binary_fuse_filter::add(const bytes_view& key) {
+    throw std::logic_error("Keys cannot be added to a binary fuse filter");
+}
+
+bool binary_fuse_filter::is_present(const bytes_view& key) {
+    return is_present(make_hashed_key(key));
+}
+
+bool binary_fuse_filter::is_present(hashed_key key) {
+    auto hash = mix(key_of(key), _seed);
+    auto s = slots_of(hash);
+    return (fingerprint(hash) ^ get(s.h[0]) ^ get(s.h[1]) ^ get(s.h[2])) == 0;
+}
+
+void binary_fuse_filter::prefetch(hashed_key key) {
+    auto s = slots_of(mix(key_of(key), _seed));
+    for (auto h : s.h) {
+        __builtin_prefetch(&_words[header_words + uint64_t(h) * _fingerprint_bits / 64]);
+    }
+}
+
+void binary_fuse_filter::clear() {
+    std::fill(_words.begin() + header_words, _words.end(), 0);
+}
+
+static_filter_builder::static_filter_builder(int64_t estimated_elements, double max_false_pos_probability, unsigned fingerprint_bits, filter_layout fallback_layout)
+    : _estimated_elements(estimated_elements)
+    , _max_false_pos_probability(max_false_pos_probability)
+    , _fingerprint_bits(fingerprint_bits)
+    , _fallback_layout(fallback_layout)
+{
+    _keys.reserve(std::min<int64_t>(estimated_elements, max_keys));
+}
+
+filter_ptr static_filter_builder::make_bloom(int64_t num_elements) const {
+    return i_filter::get_filter(num_elements, _max_false_pos_probability, filter_format::m_format, _fallback_layout);
+}
+
+void static_filter_builder::fall_back(int64_t num_elements) {
+    _fallback = make_bloom(num_elements);
+    auto& f = static_cast<bloom_filter&>(*_fallback);
+    for (auto& hk : _keys) {
+        f.add(hk);
+    }
+    _keys = {};
+}
+
+void static_filter_builder::add(const bytes_view& key) {
+    if (_fallback) {
+        _fallback->add(key);
+        return;
+    }
+    if (_keys.size() == max_keys) {
+        auto n = std::max<int64_t>(_estimated_elements, 2 * max_keys);
+        filterlog.info("More than {} keys, estimated {}, falling back to a bloom filter sized for {} keys", max_keys, _estimated_elements, n);
+        fall_back(n);
+        _fallback->add(key);
+        return;
+    }
+    _keys.push_back(make_hashed_key(key));
+}
+
+bool static_filter_builder::is_present(const bytes_view& key) {
+    return true;
+}
+
+bool static_filter_builder::is_present(hashed_key key) {
+    return true;
+}
+
+void static_filter_builder::clear() {
+    _keys.clear();
+    _fallback = {};
+}
+
+filter_ptr static_filter_builder::seal() {
+    if (_fallback) {
+        return std::move(_fallback);
+    }
+    utils::chunked_vector<uint64_t> keys;
+    keys.reserve(_keys.size());
+    for (auto& hk : _keys) {
+        keys.push_back(binary_fuse_filter::key_of(hk));
+    }
+    // Distinct partition keys may share the 64 bits the filter keeps.
+    utils::sort_gently(keys).get();
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    if (auto f = binary_fuse_filter::build(keys, _fingerprint_bits)) {
+        return f;
+    }
+    fall_back(_keys.size());
+    return std::move(_fallback);
+}
+
+}
+
+}
@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include "i_filter.hh"
+#include "utils/chunked_vector.hh"
+
+namespace utils {
+namespace filter {
+
+// A static approximate membership filter, as described in "Binary Fuse
+// Filters: Fast and Smaller Than Xor Filters" (Graf, Lemire, 2022).
+//
+// Each key maps to three fingerprint slots in adjacent segments of the
+// table, and the table is built so that the xor of the three slots is the
+// fingerprint of the key. With w-bit fingerprints, the false-positive rate
+// is 2^-w at about 1.125 * w bits per key, against 1.44 * log2(1/fp) bits per
+// key for an optimal bloom filter.
+//
+// The filter can only be built from the complete set of keys, which suits
+// sstables, whose filters are never modified after they are written. See
+// static_filter_builder.
+//
+// Filter.db keeps its format: the hash count is written as 0 and the words
+// hold a header followed by the packed fingerprints. A reader unaware of
+// sstable_feature::BinaryFuseFilter therefore sees a bloom filter without
+// hash functions, which is always present, rather than one giving false
+// negatives.
+class binary_fuse_filter : public i_filter {
+public:
+    // Fingerprint widths, which all divide 64 so a fingerprint never
+    // straddles a word.
+    static constexpr unsigned supported_fingerprint_bits[] = { 4, 8, 16, 32 };
+    // Words of the serialized form preceding the fingerprints.
+    static constexpr size_t header_words = 2;
+private:
+    // Header, then fingerprints.
+    utils::chunked_vector<uint64_t> _words;
+    uint64_t _seed;
+    unsigned _fingerprint_bits;
+    uint64_t _fingerprint_mask;
+    uint32_t _segment_length;
+    uint32_t _segment_count_length;
+
+    static thread_local struct stats {
+        uint64_t memory_size = 0;
+    } _shard_stats;
+    stats& _stats = _shard_stats;
+private:
+    struct slots {
+        uint32_t h[3];
+    };
+    binary_fuse_filter(unsigned fingerprint_bits, uint32_t segment_length, uint32_t segment_count_length);
+    static uint64_t mix(uint64_t key, uint64_t seed) noexcept;
+    uint64_t fingerprint(uint64_t hash) const noexcept {
+        return (hash ^ (hash >> 32)) & _fingerprint_mask;
+    }
+    slots slots_of(uint64_t hash) const noexcept;
+    uint64_t get(uint32_t slot) const noexcept {
+        auto bit = uint64_t(slot) * _fingerprint_bits;
+        return (_words[header_words + bit / 64] >> (bit % 64)) & _fingerprint_mask;
+    }
+    void set(uint32_t slot, uint64_t fp) noexcept {
+        auto bit = uint64_t(slot) * _fingerprint_bits;
+        auto& w = _words[header_words + bit / 64];
+        w = (w & ~(_fingerprint_mask << (bit % 64))) | (fp << (bit % 64));
+    }
+    size_t array_length() const noexcept {
+        return _segment_count_length + 2 * size_t(_segment_length);
+    }
+    void write_header();
+    bool try_build(const utils::chunked_vector<uint64_t>& keys);
+public:
+    // Loads a filter from its serialized form, as returned by words().
+    // Throws std::invalid_argument if the header is inconsistent.
+    explicit binary_fuse_filter(utils::chunked_vector<uint64_t> words);
+    ~binary_fuse_filter();
+
+    // Builds a filter containing the given keys, which must be distinct.
+    // Returns nullptr in the unlikely case the construction doesn't
+    // converge. Must be called in a seastar thread, and may yield.
+    static std::unique_ptr<binary_fuse_filter> build(const utils::chunked_vector<uint64_t>& keys, unsigned fingerprint_bits);
+
+    // The key the filter holds for a given hashed key.
+    static uint64_t key_of(hashed_key hk) noexcept {
+        return hk.hash()[0];
+    }
+
+    // Bits per key of a filter for num_elements keys.
+    static double bits_per_element(int64_t num_elements, unsigned fingerprint_bits);
+
+    unsigned fingerprint_bits() const noexcept {
+        return _fingerprint_bits;
+    }
+
+    const utils::chunked_vector<uint64_t>& words() const noexcept {
+        return _words;
+    }
+
+    // The filter is immutable.
+    virtual void add(const bytes_view& key) override;
+
+    virtual bool is_present(const bytes_view& key) override;
+
+    virtual bool is_present(hashed_key key) override;
+
+    virtual void prefetch(hashed_key key) override;
+
+    virtual void clear() override;
+
+    virtual void close() override { }
+
+    virtual size_t memory_size() override {
+        return sizeof(*this) + _words.memory_size();
+    }
+
+    static const stats& get_shard_stats() noexcept {
+        return _shard_stats;
+    }
+};
+
+// Collects the keys of an sstable being written and builds a
+// binary_fuse_filter of them when sealed.
+//
+// Falls back to a bloom filter when the sstable turns out to have more keys
+// than can be collected within the memory budget, which happens when the
+// partition count estimate was wrong, and when the binary fuse filter can't
+// be built.
+class static_filter_builder : public i_filter {
+public:
+    // The keys are kept in full, to be able to fall back to a bloom
+    // filter, and building the filter takes about 23 bytes per key, so
+    // this bounds the memory used to about 80MB.
+    static constexpr size_t max_keys = 2 << 20;
+private:
+    utils::chunked_vector<hashed_key> _keys;
+    filter_ptr _fallback;
+    int64_t _estimated_elements;
+    double _max_false_pos_probability;
+    unsigned _fingerprint_bits;
+    filter_layout _fallback_layout;
+private:
+    filter_ptr make_bloom(int64_t num_elements) const;
+    void fall_back(int64_t num_elements);
+public:
+    static_filter_builder(int64_t estimated_elements, double max_false_pos_probability, unsigned fingerprint_bits, filter_layout fallback_layout);
+
+    virtual void add(const bytes_view& key) override;
+
+    // Keys aren't queryable until the filter is sealed.
+    virtual bool is_present(const bytes_view& key) override;
+
+    virtual bool is_present(hashed_key key) override;
+
+    virtual void clear() override;
+
+    virtual void close() override { }
+
+    virtual size_t memory_size() override {
+        return _fallback ? _fallback->memory_size() : _keys.memory_size();
+    }
+
+    // Returns the filter of the collected keys. Must be called in a seastar
+    // thread. The builder must not be used afterwards.
+    filter_ptr seal();
+};
+
+}
+}
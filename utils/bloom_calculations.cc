@@ -8,6 +8,9 @@
  * SPDX-License-Identifier: (AGPL-3.0-or-later and Apache-2.0)
  */
 
+#include <cmath>
+#include <optional>
+
 #include "bloom_calculations.hh"
 
 namespace utils {
@@ -69,5 +72,81 @@ static std::vector<int> initialize_opt_k() {
 }
 
 const std::vector<int> opt_k_per_buckets = initialize_opt_k();
+
+// The false positive rate of a blocked bloom filter with the given parameters:
+// the load of a block is Poisson distributed with a mean of block_bits / c,
+// and a block holding i elements behaves like a classic bloom filter of
+// block_bits bits holding i elements.
+static double blocked_false_positive_rate(int c, int k, int block_bits) {
+    const double mean = double(block_bits) / c;
+    double fp = 0;
+    // Start at the mode of the distribution and walk both ways, until the
+    // probability of a load is too small to matter.
+    auto fp_for_load = [&] (int load) {
+        return std::pow(1 - std::pow(1 - 1.0 / block_bits, double(load) * k), k);
+    };
+    auto poisson = [&] (int load) {
+        return std::exp(load * std::log(mean) - mean - std::lgamma(load + 1.0));
+    };
+    int mode = int(mean);
+    for (int load = mode; load <= block_bits; ++load) {
+        auto p = poisson(load);
+        fp += p * fp_for_load(load);
+        if (p < 1e-12) {
+            break;
+        }
+    }
+    for (int load = mode - 1; load >= 0; --load) {
+        auto p = poisson(load);
+        fp += p * fp_for_load(load);
+        if (p < 1e-12) {
+            break;
+        }
+    }
+    return fp;
+}
+
+bloom_specification compute_blocked_bloom_spec(double max_false_pos_prob, int block_bits) {
+    // The computation isn't cheap, and is done for every sstable written,
+    // almost always with the same parameters.
+    struct cached_spec {
+        double max_false_pos_prob;
+        int block_bits;
+        bloom_specification spec;
+    };
+    static thread_local std::optional<cached_spec> cache;
+    if (cache && cache->max_false_pos_prob == max_false_pos_prob && cache->block_bits == block_bits) {
+        return cache->spec;
+    }
+
+    static constexpr int max_buckets = 64;
+    static constexpr int max_k = 16;
+    for (int c = min_buckets; c <= max_buckets; ++c) {
+        // The false positive rate is convex in k, find its minimum, then
+        // relax k as long as the requirement is still met, preferring
+        // fewer probes.
+        int best_k = min_k;
+        double best_fp = blocked_false_positive_rate(c, best_k, block_bits);
+        for (int k = min_k + 1; k <= max_k; ++k) {
+            auto fp = blocked_false_positive_rate(c, k, block_bits);
+            if (fp >= best_fp) {
+                break;
+            }
+            best_k = k;
+            best_fp = fp;
+        }
+        if (best_fp > max_false_pos_prob) {
+            continue;
+        }
+        while (best_k > min_k && blocked_false_positive_rate(c, best_k - 1, block_bits) <= max_false_pos_prob) {
+            --best_k;
+        }
+        cache.emplace(cached_spec{max_false_pos_prob, block_bits, bloom_specification(best_k, c)});
+        return cache->spec;
+    }
+    throw exceptions::unsupported_operation_exception(format("Unable to satisfy {:f} with a blocked bloom filter of up to {:d} buckets per element",
+            max_false_pos_prob, max_buckets));
+}
+
 }
 }
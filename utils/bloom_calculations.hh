@@ -107,6 +107,18 @@ namespace bloom_calculations {
         return bloom_specification(K, buckets_per_element);
     }
 
+    /**
+     * Same as compute_bloom_spec(), but for a blocked bloom filter (see
+     * utils::filter::blocked_bloom_filter), where all probes for an element
+     * fall into a single block of block_bits bits.
+     *
+     * Since elements are not spread evenly over the blocks, the false positive
+     * rate is that of the average over the distribution of block loads, so a
+     * blocked filter needs a few more buckets per element than a classic one
+     * to reach the same false positive rate.
+     */
+    bloom_specification compute_blocked_bloom_spec(double max_false_pos_prob, int block_bits = 512);
+
     /**
      * Calculates the maximum number of buckets per element that this implementation
      * can support.  Crucially, it will lower the bucket count if necessary to meet
@@ -25,19 +25,6 @@ namespace filter {
 
 thread_local bloom_filter::stats bloom_filter::_shard_stats;
 
-template<typename Func>
-void for_each_index(hashed_key hk, int count, int64_t max, filter_format format, Func&& func) {
-    auto h = hk.hash();
-    int64_t base = (format == filter_format::k_l_format) ? h[0] : h[1];
-    int64_t inc = (format == filter_format::k_l_format) ? h[1] : h[0];
-    for (int i = 0; i < count; i++) {
-        if (func(std::abs(base % max)) == stop_iteration::yes) {
-            break;
-        }
-        base = static_cast<int64_t>(static_cast<uint64_t>(base) + static_cast<uint64_t>(inc));
-    }
-}
-
 bloom_filter::bloom_filter(int hashes, bitmap&& bs, filter_format format) noexcept
     : _bitset(std::move(bs))
     , _hash_count(hashes)
@@ -62,8 +49,19 @@ bool bloom_filter::is_present(hashed_key key) {
     return result;
 }
 
+void bloom_filter::prefetch(hashed_key key) {
+    for_each_index(key, _hash_count, _bitset.size(), _format, [this] (auto i) {
+        _bitset.prefetch(i);
+        return stop_iteration::no;
+    });
+}
+
 void bloom_filter::add(const bytes_view& key) {
-    for_each_index(make_hashed_key(key), _hash_count, _bitset.size(), _format, [this] (auto i) {
+    add(make_hashed_key(key));
+}
+
+void bloom_filter::add(hashed_key key) {
+    for_each_index(key, _hash_count, _bitset.size(), _format, [this] (auto i) {
         _bitset.set(i);
         return stop_iteration::no;
     });
@@ -73,6 +71,69 @@ bool bloom_filter::is_present(const bytes_view& key) {
     return is_present(make_hashed_key(key));
 }
 
+namespace {
+
+// Maps the hash uniformly onto [0, nr_blocks) without a division.
+size_t block_of(hashed_key hk, size_t nr_blocks) {
+    return (static_cast<unsigned __int128>(hk.hash()[0]) * nr_blocks) >> 64;
+}
+
+}
+
+std::pair<size_t, blocked_bloom_filter::block_masks> blocked_bloom_filter::locate_in_block(hashed_key hk, int count, size_t nr_blocks) {
+    auto h = hk.hash();
+    size_t block = block_of(hk, nr_blocks);
+    // Double hashing within the block. The increment is odd, and the block
+    // size a power of two, so the first bits_per_block probes are distinct.
+    uint32_t base = h[1];
+    uint32_t inc = (h[1] >> 32) | 1;
+    block_masks masks{};
+    for (int i = 0; i < count; i++) {
+        auto bit = base % blocked_bloom_filter::bits_per_block;
+        masks[bit / 64] |= uint64_t(1) << (bit % 64);
+        base += inc;
+    }
+    return {block, masks};
+}
+
+bool blocked_bloom_filter::is_present(hashed_key key) {
+    auto& bs = bits();
+    auto [block, masks] = locate_in_block(key, num_hashes(), bs.size() / bits_per_block);
+    // Blocks are aligned to words_per_block words, which always divides the
+    // chunk size of the underlying storage, so a block is contiguous.
+    const uint64_t* words = &bs.get_storage()[block * words_per_block];
+    uint64_t missing = 0;
+    for (size_t i = 0; i < words_per_block; ++i) {
+        missing |= masks[i] & ~words[i];
+    }
+    return !missing;
+}
+
+void blocked_bloom_filter::prefetch(hashed_key key) {
+    auto& bs = bits();
+    // A block is the size of a cache line, but may straddle two of them,
+    // so both its ends are prefetched. They share a line when it's aligned.
+    auto first_bit = block_of(key, bs.size() / bits_per_block) * bits_per_block;
+    bs.prefetch(first_bit);
+    bs.prefetch(first_bit + bits_per_block - 1);
+}
+
+void blocked_bloom_filter::add(const bytes_view& key) {
+    add(make_hashed_key(key));
+}
+
+void blocked_bloom_filter::add(hashed_key key) {
+    auto& bs = bits();
+    auto [block, masks] = locate_in_block(key, num_hashes(), bs.size() / bits_per_block);
+    for (size_t i = 0; i < words_per_block; ++i) {
+        bs.set_word(block * words_per_block + i, masks[i]);
+    }
+}
+
+bool blocked_bloom_filter::is_present(const bytes_view& key) {
+    return is_present(make_hashed_key(key));
+}
+
 filter_ptr create_filter(int hash, large_bitset&& bitset, filter_format format) {
     return std::make_unique<murmur3_bloom_filter>(hash, std::move(bitset), format);
 }
@@ -83,5 +144,20 @@ filter_ptr create_filter(int hash, int64_t num_elements, int buckets_per, filter
     large_bitset bitset(num_bits);
     return std::make_unique<murmur3_bloom_filter>(hash, std::move(bitset), format);
 }
+
+filter_ptr create_blocked_filter(int hash, large_bitset&& bitset) {
+    if (bitset.size() == 0 || bitset.size() % blocked_bloom_filter::bits_per_block) {
+        throw std::invalid_argument(format("Invalid blocked bloom filter size {}: must be a non-zero multiple of {} bits",
+                bitset.size(), blocked_bloom_filter::bits_per_block));
+    }
+    return std::make_unique<blocked_bloom_filter>(hash, std::move(bitset));
+}
+
+filter_ptr create_blocked_filter(int hash, int64_t num_elements, int buckets_per) {
+    int64_t num_bits = (num_elements * buckets_per) + bloom_calculations::EXCESS;
+    num_bits = align_up<int64_t>(num_bits, blocked_bloom_filter::bits_per_block);
+    large_bitset bitset(num_bits);
+    return std::make_unique<blocked_bloom_filter>(hash, std::move(bitset));
+}
 }
 }
@@ -18,6 +18,7 @@
 #include <seastar/core/coroutine.hh>
 #include <seastar/coroutine/maybe_yield.hh>
 
+#include <bit>
 #include <map>
 
 using namespace seastar;
@@ -46,11 +47,16 @@ class cached_file {
 
     using offset_type = uint64_t;
 
+    // A stream which read this many pages starts reading ahead on misses.
+    static constexpr page_count_type sequential_readahead_threshold = 4;
+    static constexpr page_count_type max_readahead_pages = 32;
+
     struct metrics {
         uint64_t page_hits = 0;
         uint64_t page_misses = 0;
         uint64_t page_evictions = 0;
         uint64_t page_populations = 0;
+        uint64_t page_readaheads = 0; // pages populated before they were requested
         uint64_t cached_bytes = 0;
         uint64_t bytes_in_std = 0; // memory used by active temporary_buffer:s
     };
@@ -195,6 +201,13 @@ class cached_file {
                     }
                     if (!first_page) {
                         first_page = cp.share();
+                    } else if (it_and_flag.second) {
+                        // Pages read ahead may never be requested, so they go to the cold
+                        // segment of the LRU until they are, to not evict the requested ones.
+                        ++_metrics.page_readaheads;
+                        _metrics.bytes_in_std -= cp._buf.size();
+                        cp._buf = {};
+                        _lru.add_cold(cp);
                     }
                 }
                 return first_page;
@@ -244,12 +257,28 @@ class cached_file {
         offset_type _offset_in_page;
         offset_type _size_hint;
         tracing::trace_state_ptr _trace_state;
+        page_count_type _pages_read = 0;
     private:
         std::optional<reader_permit::resource_units> get_page_units(size_t size = page_size) {
             return _permit
                 ? std::make_optional(_permit->consume_memory(size))
                 : std::nullopt;
         }
+
+        // The stream reads pages sequentially, the more of them it has read
+        // the more are likely to follow. Once it is past sequential_readahead_threshold
+        // pages, a miss reads as many pages ahead as there were read so far,
+        // rounded down to a power of two and capped at max_readahead_pages.
+        // Pages which are cached already are not read again, so the window
+        // is effectively refilled once per window.
+        page_count_type pages_to_read() {
+            page_count_type ret = div_ceil(_size_hint, page_size);
+            _size_hint = page_size;
+            if (_pages_read >= sequential_readahead_threshold) {
+                ret = std::max(ret, std::min(std::bit_floor(_pages_read), max_readahead_pages));
+            }
+            return ret;
+        }
     public:
         // Creates an empty stream.
         stream()
@@ -276,9 +305,8 @@ class cached_file {
             if (!_cached_file || _page_idx > _cached_file->_last_page) {
                 return make_ready_future<temporary_buffer<char>>(temporary_buffer<char>());
             }
-            auto units = get_page_units(_size_hint);
-            page_count_type readahead = div_ceil(_size_hint, page_size);
-            _size_hint = page_size;
+            page_count_type readahead = pages_to_read();
+            auto units = get_page_units(readahead * page_size);
             return _cached_file->get_page(_page_idx, readahead, *_pc, _trace_state).then(
                     [units = std::move(units), this] (temporary_buffer<char> page) mutable {
                 if (_page_idx == _cached_file->_last_page) {
@@ -292,6 +320,7 @@ class cached_file {
                 page.trim_front(_offset_in_page);
                 _offset_in_page = 0;
                 ++_page_idx;
+                ++_pages_read;
                 return page;
             });
         }
@@ -304,9 +333,8 @@ class cached_file {
             if (!_cached_file || _page_idx > _cached_file->_last_page) {
                 return make_ready_future<page_view>(page_view());
             }
-            auto units = get_page_units(_size_hint);
-            page_count_type readahead = div_ceil(_size_hint, page_size);
-            _size_hint = page_size;
+            page_count_type readahead = pages_to_read();
+            auto units = get_page_units(readahead * page_size);
             return _cached_file->get_page_ptr(_page_idx, readahead, *_pc, _trace_state).then(
                     [this, units = std::move(units)] (cached_page::ptr_type page) mutable {
                 size_t size = _page_idx == _cached_file->_last_page
@@ -316,6 +344,7 @@ class cached_file {
                 page_view buf(_offset_in_page, size, std::move(page), std::move(units));
                 _offset_in_page = 0;
                 ++_page_idx;
+                ++_pages_read;
                 return buf;
             });
         }
@@ -411,7 +440,9 @@ class cached_file {
     ///
     /// Returns a stream with data which starts at position pos in the area managed by this instance.
     /// This cached_file instance must outlive the returned stream and buffers returned by the stream.
-    /// The stream does not do any read-ahead.
+    /// The stream reads size_hint bytes at once initially, and reads ahead once it has
+    /// read sequential_readahead_threshold pages, see stream::pages_to_read().
+    /// Pages read ahead are evicted before the requested ones until they are requested.
     ///
     /// \param pos The offset of the first byte to read, relative to the cached file area.
     /// \param permit Holds reader_permit under which returned buffers should be accounted.
@@ -427,6 +458,29 @@ class cached_file {
         return stream(*this, pc, std::move(permit), std::move(trace_state), page_idx, offset, size_hint);
     }
 
+    /// \brief Returns the contents of a page if it is cached, without reading the file.
+    ///
+    /// A hit is accounted as a hit and refreshes the page in the LRU. A miss is not accounted,
+    /// see populate(). Returns nullptr on a miss.
+    ///
+    /// The pointer is valid only until the LSA region associated with cached_file invalidates references.
+    const char* get_page_if_cached(page_idx_type idx) noexcept {
+        auto i = _cache.lower_bound(idx);
+        if (i == _cache.end() || i->idx != idx) {
+            return nullptr;
+        }
+        ++_metrics.page_hits;
+        if (i->is_linked()) {
+            _lru.touch(*i);
+        }
+        return i->_lsa_buf.get();
+    }
+
+    /// \brief Reads a page into the cache, unless it is already there.
+    future<> populate(page_idx_type idx, const io_priority_class& pc, tracing::trace_state_ptr trace_state = {}) {
+        return get_page_ptr(idx, 1, pc, std::move(trace_state)).discard_result();
+    }
+
     /// \brief Returns the number of bytes in the area managed by this instance.
     offset_type size() const {
         return _size;
@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <signal.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <mutex>
+
+#include <boost/functional/hash.hpp>
+#include <seastar/core/metrics.hh>
+
+#include "utils/cpu_profiler.hh"
+#include "log.hh"
+
+namespace utils {
+
+static logging::logger cplog("cpu_profiler");
+
+thread_local utils::UUID current_cpu_profiling_table;
+
+// The profiler of the shard, for the signal handler.
+static thread_local cpu_profiler* local_profiler = nullptr;
+
+static constexpr int profiler_signal = SIGPROF;
+static constexpr uint32_t max_frequency_hz = 1000;
+
+bool cpu_profiler::stack::operator==(const stack& o) const {
+    return scheduling_group == o.scheduling_group && table == o.table
+            && std::equal(frames.begin(), frames.end(), o.frames.begin(), o.frames.end(), [] (const seastar::frame& a, const seastar::frame& b) {
+        return a.so == b.so && a.addr == b.addr;
+    });
+}
+
+size_t cpu_profiler::stack_hash::operator()(const stack& s) const {
+    size_t h = std::hash<sstring>()(s.scheduling_group);
+    boost::hash_combine(h, std::hash<utils::UUID>()(s.table));
+    for (auto& f : s.frames) {
+        boost::hash_combine(h, f.addr);
+    }
+    return h;
+}
+
+cpu_profiler::cpu_profiler(utils::updateable_value<uint32_t> frequency_hz)
+        : _frequency_hz(std::move(frequency_hz))
+        , _frequency_hz_observer(_frequency_hz.observe([this] (const uint32_t& hz) { set_frequency(hz); }))
+        , _drain_timer([this] { drain(); }) {
+    namespace sm = seastar::metrics;
+    _metrics.add_group("cpu_profiler", {
+        sm::make_counter("samples", [this] { return _stats.samples; },
+                sm::description("Counts the CPU profiler samples aggregated into stacks.")),
+        sm::make_counter("dropped_samples", [this] { return _stats.dropped_samples.load(std::memory_order_relaxed); },
+                sm::description("Counts the CPU profiler samples dropped because the pending samples ring or the stacks table was full.")),
+        sm::make_gauge("stacks", [this] { return _stacks.size(); },
+                sm::description("Holds the number of distinct stacks sampled by the CPU profiler since the last reset.")),
+    });
+}
+
+cpu_profiler::~cpu_profiler() {
+    assert(!_timer);
+}
+
+future<> cpu_profiler::start() {
+    static std::once_flag handler_installed;
+    std::call_once(handler_installed, [] {
+        struct sigaction sa = {};
+        sa.sa_sigaction = &cpu_profiler::signal_handler;
+        sa.sa_flags = SA_SIGINFO | SA_RESTART;
+        sigemptyset(&sa.sa_mask);
+        if (sigaction(profiler_signal, &sa, nullptr) != 0) {
+            throw std::system_error(errno, std::system_category(), "cpu_profiler: sigaction");
+        }
+    });
+    // Reactor threads block all the signals they don't handle.
+    sigset_t set;
+    sigemptyset(&set);
+    sigaddset(&set, profiler_signal);
+    pthread_sigmask(SIG_UNBLOCK, &set, nullptr);
+
+    local_profiler = this;
+    set_frequency(_frequency_hz());
+    return make_ready_future<>();
+}
+
+future<> cpu_profiler::stop() {
+    _frequency_hz_observer.disconnect();
+    set_frequency(0);
+    local_profiler = nullptr;
+    return make_ready_future<>();
+}
+
+void cpu_profiler::set_frequency(uint32_t hz) {
+    hz = std::min(hz, max_frequency_hz);
+    if (!hz) {
+        if (_timer) {
+            timer_delete(*_timer);
+            _timer.reset();
+            _drain_timer.cancel();
+            drain();
+            cplog.info("Disabled");
+        }
+        return;
+    }
+    if (!_samples) {
+        _samples = std::make_unique<std::array<sample, max_pending_samples>>();
+    }
+    if (!_timer) {
+        struct sigevent sev = {};
+        sev.sigev_notify = SIGEV_THREAD_ID;
+        sev.sigev_signo = profiler_signal;
+        sev._sigev_un._tid = syscall(SYS_gettid);
+        timer_t timer;
+        if (timer_create(CLOCK_THREAD_CPUTIME_ID, &sev, &timer) != 0) {
+            cplog.warn("Failed to create the sampling timer: {}", std::system_error(errno, std::system_category()).what());
+            return;
+        }
+        _timer = timer;
+        _drain_timer.arm_periodic(std::chrono::seconds(1));
+    }
+    auto period = std::chrono::nanoseconds(std::chrono::seconds(1)) / hz;
+    struct itimerspec its = {};
+    its.it_interval.tv_sec = period.count() / 1'000'000'000;
+    its.it_interval.tv_nsec = period.count() % 1'000'000'000;
+    its.it_value = its.it_interval;
+    timer_settime(*_timer, 0, &its, nullptr);
+    cplog.info("Sampling at {} Hz", hz);
+}
+
+void cpu_profiler::signal_handler(int, siginfo_t*, void*) {
+    if (local_profiler) {
+        local_profiler->record_sample();
+    }
+}
+
+void cpu_profiler::record_sample() noexcept {
+    auto head = _head.load(std::memory_order_relaxed);
+    if (head - _tail >= max_pending_samples) {
+        _stats.dropped_samples.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    auto& s = (*_samples)[head % max_pending_samples];
+    s.nr_frames = 0;
+    seastar::backtrace([&s] (seastar::frame f) {
+        if (s.nr_frames < max_frames) {
+            s.frames[s.nr_frames++] = f;
+        }
+    });
+    s.sg = seastar::current_scheduling_group();
+    s.table = current_cpu_profiling_table;
+    std::atomic_signal_fence(std::memory_order_release);
+    _head.store(head + 1, std::memory_order_relaxed);
+}
+
+void cpu_profiler::drain() {
+    auto head = _head.load(std::memory_order_relaxed);
+    std::atomic_signal_fence(std::memory_order_acquire);
+    for (; _tail != head; ++_tail) {
+        auto& s = (*_samples)[_tail % max_pending_samples];
+        stack key{s.sg.name(), s.table, {}};
+        key.frames.reserve(s.nr_frames);
+        // A backtrace starts with the innermost frame, a folded stack with the outermost one.
+        std::reverse_copy(s.frames.begin(), s.frames.begin() + s.nr_frames, std::back_inserter(key.frames));
+        auto it = _stacks.find(key);
+        if (it != _stacks.end()) {
+            ++it->second;
+        } else if (_stacks.size() < max_stacks) {
+            _stacks.emplace(std::move(key), 1);
+        } else {
+            _stats.dropped_samples.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        ++_stats.samples;
+    }
+}
+
+const cpu_profiler::stacks& cpu_profiler::local_stacks() {
+    if (_samples) {
+        drain();
+    }
+    return _stacks;
+}
+
+void cpu_profiler::reset() {
+    if (_samples) {
+        drain();
+    }
+    _stacks.clear();
+}
+
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <unordered_map>
+#include <vector>
+#include <time.h>
+
+#include <seastar/core/metrics_registration.hh>
+#include <seastar/core/scheduling.hh>
+#include <seastar/core/sharded.hh>
+#include <seastar/core/timer.hh>
+#include <seastar/util/backtrace.hh>
+
+#include "utils/UUID.hh"
+#include "utils/updateable_value.hh"
+#include "seastarx.hh"
+
+namespace utils {
+
+// The table the shard is working for, or a null UUID if unknown.
+//
+// Set by reader permits while their reads use the CPU and recorded along the
+// samples of the cpu_profiler. When several reads are interleaved, it is the
+// one which used the CPU last.
+extern thread_local utils::UUID current_cpu_profiling_table;
+
+// A sampling CPU profiler of the reactor threads.
+//
+// While enabled, a timer measuring the CPU time of the shard's thread sends
+// it a signal frequency_hz times per CPU second, and the signal handler
+// records the backtrace of the interrupted code, the current scheduling group
+// and current_cpu_profiling_table into a preallocated ring. The ring is
+// drained every second into counts per distinct stack, so the profile of a
+// long period fits in bounded memory. Idle time is not sampled.
+//
+// The backtraces are made of the addresses seastar prints in its own
+// backtraces, to be resolved offline, e.g. with seastar-addr2line.
+class cpu_profiler {
+public:
+    static constexpr size_t max_frames = 32;
+    // Samples the ring can hold between two drains.
+    static constexpr size_t max_pending_samples = 1024;
+    // Distinct stacks kept; samples of new stacks beyond this are dropped.
+    static constexpr size_t max_stacks = 10000;
+
+    struct stack {
+        sstring scheduling_group;
+        utils::UUID table;
+        // Outermost frame first.
+        std::vector<seastar::frame> frames;
+
+        bool operator==(const stack&) const;
+    };
+
+    struct stack_hash {
+        size_t operator()(const stack&) const;
+    };
+
+    using stacks = std::unordered_map<stack, uint64_t, stack_hash>;
+
+private:
+    struct sample {
+        std::array<seastar::frame, max_frames> frames;
+        unsigned nr_frames;
+        seastar::scheduling_group sg;
+        utils::UUID table;
+    };
+
+    utils::updateable_value<uint32_t> _frequency_hz;
+    utils::observer<uint32_t> _frequency_hz_observer;
+    std::optional<timer_t> _timer;
+    std::unique_ptr<std::array<sample, max_pending_samples>> _samples;
+    // Written by the signal handler, which interrupts the shard's own thread.
+    std::atomic<uint64_t> _head = 0;
+    uint64_t _tail = 0;
+    stacks _stacks;
+    seastar::timer<lowres_clock> _drain_timer;
+
+    struct stats {
+        uint64_t samples = 0;
+        std::atomic<uint64_t> dropped_samples = 0;
+    } _stats;
+
+    seastar::metrics::metric_groups _metrics;
+
+    static void signal_handler(int, siginfo_t*, void*);
+    void record_sample() noexcept;
+    void drain();
+    void set_frequency(uint32_t hz);
+public:
+    explicit cpu_profiler(utils::updateable_value<uint32_t> frequency_hz);
+    ~cpu_profiler();
+
+    future<> start();
+    future<> stop();
+
+    bool enabled() const noexcept {
+        return bool(_timer);
+    }
+
+    // Returns the counts of the stacks sampled on this shard since the last reset.
+    const stacks& local_stacks();
+    void reset();
+};
+
+}
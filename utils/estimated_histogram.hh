@@ -20,6 +20,7 @@
 #include <seastar/core/bitops.hh>
 #include <limits>
 #include <array>
+#include <span>
 
 namespace utils {
 
@@ -353,6 +354,114 @@ inline time_estimated_histogram time_estimated_histogram_merge(time_estimated_hi
     return a.merge(b);
 }
 
+/*!
+ * \brief log-linear histogram of latencies, for estimating their quantiles
+ *
+ * Covers 16us to 33s with a precision of 8, so that a quantile is estimated
+ * within 12.5% also for sub-millisecond latencies, which time_estimated_histogram
+ * all counts in its first bucket.
+ *
+ * The number of values is kept up to date, so a quantile is found in a single
+ * pass over the buckets, which stops at the quantile, and quantiles() finds
+ * several quantiles in the same pass.
+ *
+ * Histograms are updated by their own shard only; merge() combines those of
+ * several shards, e.g. in a map_reduce().
+ */
+class latency_histogram {
+public:
+    using clock = std::chrono::steady_clock;
+    using duration = clock::duration;
+    using histogram = approx_exponential_histogram<16, 33554432, 8>;
+private:
+    histogram _histogram;
+    uint64_t _count = 0;
+private:
+    // The estimate for a value in the bucket: its upper limit, so that the
+    // estimated quantile is not lower than the real one.
+    static uint64_t bucket_estimate(const histogram& h, size_t bucket) {
+        return bucket == histogram::NUM_BUCKETS - 1 ? h.get_bucket_lower_limit(bucket) : h.get_bucket_upper_limit(bucket);
+    }
+public:
+    void add_micro(uint64_t n) {
+        _histogram.add(n);
+        ++_count;
+    }
+
+    void add(const duration& latency) {
+        add_micro(std::chrono::duration_cast<std::chrono::microseconds>(latency).count());
+    }
+
+    void clear() {
+        _histogram.clear();
+        _count = 0;
+    }
+
+    latency_histogram& merge(const latency_histogram& b) {
+        _histogram.merge(b._histogram);
+        _count += b._count;
+        return *this;
+    }
+
+    /*!
+     * \brief multiply all the buckets content by a constant, e.g. to decay old values
+     */
+    latency_histogram& operator*=(double v) {
+        _count = 0;
+        for (size_t i = 0; i < histogram::NUM_BUCKETS; i++) {
+            _histogram[i] *= v;
+            _count += _histogram.get(i);
+        }
+        return *this;
+    }
+
+    /*!
+     * \brief returns the total number of values inserted
+     */
+    uint64_t count() const noexcept {
+        return _count;
+    }
+
+    const histogram& buckets() const noexcept {
+        return _histogram;
+    }
+
+    /*!
+     * \brief get the estimated quantiles qs, in microseconds
+     *
+     * qs must be sorted in ascending order and each be between 0 and 1.
+     * out[i] is set to the estimated value at quantile qs[i], or to 0 if the histogram is empty.
+     */
+    void quantiles(std::span<const double> qs, std::span<uint64_t> out) const {
+        size_t q = 0;
+        if (_count) {
+            uint64_t elements = 0;
+            for (size_t i = 0; i < histogram::NUM_BUCKETS && q < qs.size(); i++) {
+                elements += _histogram.get(i);
+                while (q < qs.size() && elements && elements >= std::max(uint64_t(std::ceil(_count * qs[q])), uint64_t(1))) {
+                    out[q++] = bucket_estimate(_histogram, i);
+                }
+            }
+        }
+        std::fill(out.begin() + q, out.begin() + qs.size(), 0);
+    }
+
+    /*!
+     * \brief get the estimated value at quantile q (between 0 and 1), in microseconds
+     *
+     * It will return 0 if the histogram is empty.
+     */
+    uint64_t quantile(double q) const {
+        uint64_t ret;
+        quantiles(std::span<const double>(&q, 1), std::span<uint64_t>(&ret, 1));
+        return ret;
+    }
+};
+
+inline latency_histogram latency_histogram_merge(latency_histogram a, const latency_histogram& b) {
+    return a.merge(b);
+}
+
 struct estimated_histogram {
     using clock = std::chrono::steady_clock;
     using duration = clock::duration;
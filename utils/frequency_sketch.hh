@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+namespace utils {
+
+// Count-min sketch estimating how many times each key was recorded
+// recently, as used by TinyLFU admission policies.
+//
+// Keys are given as 64-bit hashes. Counters saturate at 255 and are all
+// halved once sample_size() keys were recorded since the last halving, so
+// that the estimates reflect the recent history only.
+class frequency_sketch {
+    static constexpr unsigned depth = 4;
+    static constexpr std::array<uint64_t, depth> seeds = {
+        0x9e3779b97f4a7c15ull, 0xc2b2ae3d27d4eb4full, 0x165667b19e3779f9ull, 0xd6e8feb86659fd93ull,
+    };
+    static constexpr unsigned samples_per_counter = 10;
+
+    std::vector<uint8_t> _counters;
+    size_t _width_mask;
+    size_t _sample_size;
+    size_t _recorded = 0;
+private:
+    size_t index(unsigned row, uint64_t hash) const noexcept {
+        auto h = hash * seeds[row];
+        h ^= h >> 32;
+        return row * (_width_mask + 1) + (h & _width_mask);
+    }
+
+    void halve() noexcept {
+        for (auto& c : _counters) {
+            c >>= 1;
+        }
+        _recorded = 0;
+    }
+public:
+    // width is rounded up to a power of two.
+    explicit frequency_sketch(size_t width)
+        : _counters(depth * std::bit_ceil(width))
+        , _width_mask(std::bit_ceil(width) - 1)
+        , _sample_size(samples_per_counter * std::bit_ceil(width))
+    { }
+
+    // Returns true iff the counters were halved.
+    bool record(uint64_t hash) noexcept {
+        for (unsigned row = 0; row < depth; ++row) {
+            auto& c = _counters[index(row, hash)];
+            if (c != UINT8_MAX) {
+                ++c;
+            }
+        }
+        if (++_recorded < _sample_size) {
+            return false;
+        }
+        halve();
+        return true;
+    }
+
+    unsigned estimate(uint64_t hash) const noexcept {
+        unsigned ret = UINT8_MAX;
+        for (unsigned row = 0; row < depth; ++row) {
+            ret = std::min<unsigned>(ret, _counters[index(row, hash)]);
+        }
+        return ret;
+    }
+
+    size_t sample_size() const noexcept {
+        return _sample_size;
+    }
+};
+
+}
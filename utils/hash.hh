@@ -9,6 +9,7 @@
 #ifndef UTILS_HASH_HH_
 #define UTILS_HASH_HH_
 
+#include <cstdint>
 #include <functional>
 
 namespace utils {
@@ -18,6 +19,13 @@ inline size_t hash_combine(size_t left, size_t right) {
     return left + 0x9e3779b9 + (right << 6) + (right >> 2);
 }
 
+// Multiplicative (Fibonacci) hashing: spreads the bits of x over the whole
+// result, the high bits in particular, so that slices of it can index tables
+// even when x itself (e.g. a token) isn't uniform in its low bits.
+inline uint64_t fibonacci_hash(uint64_t x) noexcept {
+    return x * 0x9e3779b97f4a7c15ull;
+}
+
 struct tuple_hash {
 private:
     // CMH. Add specializations here to handle recursive tuples
@@ -9,13 +9,16 @@
 
 #include "log.hh"
 #include "bloom_filter.hh"
+#include "binary_fuse_filter.hh"
 #include "bloom_calculations.hh"
 #include <seastar/core/thread.hh>
+#include <algorithm>
+#include <cmath>
 
 namespace utils {
 static logging::logger filterlog("bloom_filter");
 
-filter_ptr i_filter::get_filter(int64_t num_elements, double max_false_pos_probability, filter_format fformat) {
+filter_ptr i_filter::get_filter(int64_t num_elements, double max_false_pos_probability, filter_format fformat, filter_layout layout) {
     assert(seastar::thread::running_in_thread());
 
     if (max_false_pos_probability > 1.0) {
@@ -26,11 +29,38 @@ filter_ptr i_filter::get_filter(int64_t num_elements, double max_false_pos_proba
         return std::make_unique<filter::always_present_filter>();
     }
 
+    if (layout == filter_layout::blocked) {
+        auto spec = bloom_calculations::compute_blocked_bloom_spec(max_false_pos_probability);
+        return filter::create_blocked_filter(spec.K, num_elements, spec.buckets_per_element);
+    }
+
     int buckets_per_element = bloom_calculations::max_buckets_per_element(num_elements);
     auto spec = bloom_calculations::compute_bloom_spec(buckets_per_element, max_false_pos_probability);
     return filter::create_filter(spec.K, num_elements, spec.buckets_per_element, fformat);
 }
 
+filter_ptr i_filter::get_static_filter(int64_t num_elements, double max_false_pos_probability, filter_layout fallback_layout) {
+    assert(seastar::thread::running_in_thread());
+
+    if (max_false_pos_probability >= 1.0 || num_elements > int64_t(filter::static_filter_builder::max_keys)) {
+        return get_filter(num_elements, max_false_pos_probability, filter_format::m_format, fallback_layout);
+    }
+
+    // Use the narrowest fingerprint satisfying the false-positive rate, if
+    // it takes less memory than the bloom filter would.
+    auto& widths = filter::binary_fuse_filter::supported_fingerprint_bits;
+    auto it = std::ranges::find_if(widths, [&] (unsigned bits) { return std::ldexp(1.0, -int(bits)) <= max_false_pos_probability; });
+    if (it != std::end(widths)) {
+        double bloom_bits = fallback_layout == filter_layout::blocked
+                ? bloom_calculations::compute_blocked_bloom_spec(max_false_pos_probability).buckets_per_element
+                : bloom_calculations::compute_bloom_spec(bloom_calculations::max_buckets_per_element(num_elements), max_false_pos_probability).buckets_per_element;
+        if (filter::binary_fuse_filter::bits_per_element(num_elements, *it) < bloom_bits) {
+            return std::make_unique<filter::static_filter_builder>(num_elements, max_false_pos_probability, *it, fallback_layout);
+        }
+    }
+    return get_filter(num_elements, max_false_pos_probability, filter_format::m_format, fallback_layout);
+}
+
 hashed_key make_hashed_key(bytes_view b) {
     std::array<uint64_t, 2> h;
     utils::murmur_hash::hash3_x64_128(b, 0, h);
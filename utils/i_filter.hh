@@ -22,6 +22,13 @@ enum class filter_format {
     m_format,
 };
 
+enum class filter_layout {
+    // Probes are spread over the whole bitset, as in Cassandra.
+    classic,
+    // All probes for a key fall into a single cache-line sized block.
+    blocked,
+};
+
 class hashed_key {
 private:
     std::array<uint64_t, 2> _hash;
@@ -40,6 +47,10 @@ struct i_filter {
     virtual void add(const bytes_view& key) = 0;
     virtual bool is_present(const bytes_view& key) = 0;
     virtual bool is_present(hashed_key) = 0;
+    // Hints that is_present() is about to be called for the key, so
+    // that the memory it is going to look at can be brought into cache
+    // while other filters are being checked.
+    virtual void prefetch(hashed_key) {}
     virtual void clear() = 0;
     virtual void close() = 0;
 
@@ -52,6 +63,17 @@ struct i_filter {
      *         Asserts that the given probability can be satisfied using this
      *         filter.
      */
-    static filter_ptr get_filter(int64_t num_elements, double max_false_pos_prob, filter_format format);
+    static filter_ptr get_filter(int64_t num_elements, double max_false_pos_prob, filter_format format,
+            filter_layout layout = filter_layout::classic);
+
+    /**
+     * @return A builder of a static filter, such as a binary fuse filter,
+     *         for an sstable of about num_elements keys, or get_filter() when
+     *         a static filter wouldn't be smaller. The filter is usable once
+     *         returned by filter::static_filter_builder::seal(). Bloom
+     *         filters, including the fallback one, use the given layout.
+     */
+    static filter_ptr get_static_filter(int64_t num_elements, double max_false_pos_prob,
+            filter_layout fallback_layout = filter_layout::classic);
 };
 }
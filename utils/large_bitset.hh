@@ -50,6 +50,9 @@ class large_bitset {
         auto idx2 = idx;
         _storage[idx1] |= int_type(1) << idx2;
     }
+    void prefetch(size_t idx) const {
+        __builtin_prefetch(&_storage[idx / bits_per_int()]);
+    }
     void clear(size_t idx) {
         auto idx1 = idx / bits_per_int();
         idx %= bits_per_int();
@@ -58,6 +61,11 @@ class large_bitset {
     }
     void clear();
 
+    // Sets, in the idx-th word of the storage, the bits set in mask.
+    void set_word(size_t idx, int_type mask) {
+        _storage[idx] |= mask;
+    }
+
     const utils::chunked_vector<int_type>& get_storage() const {
         return _storage;
     }
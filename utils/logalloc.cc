@@ -35,6 +35,7 @@
 #include "utils/vle.hh"
 #include "utils/coarse_steady_clock.hh"
 
+#include <cstring>
 #include <random>
 #include <chrono>
 
@@ -358,13 +359,26 @@ using clock = std::chrono::steady_clock;
 
 class background_reclaimer {
     scheduling_group _sg;
-    noncopyable_function<void (size_t target)> _reclaim;
+    noncopyable_function<size_t (size_t target)> _reclaim;
     timer<lowres_clock> _adjust_shares_timer;
     // If engaged, main loop is not running, set_value() to wake it.
     promise<>* _main_loop_wait = nullptr;
     future<> _done;
     bool _stopping = false;
+    // Upper bound on the amount of memory released in a single step. Adjusted
+    // after every step so that a step takes no longer than step_budget.
+    size_t _step_size = max_step_size;
+    struct stats {
+        uint64_t steps = 0;
+        uint64_t steps_over_budget = 0;
+        uint64_t memory_reclaimed = 0;
+        clock::duration time{};
+    } _stats;
+    seastar::metrics::metric_groups _metrics;
     static constexpr size_t free_memory_threshold = 60'000'000;
+    static constexpr size_t min_step_size = segment_size;
+    static constexpr size_t max_step_size = 64 * segment_size;
+    static constexpr auto step_budget = 500us;
 private:
     bool have_work() const {
 #ifndef SEASTAR_DEFAULT_ALLOCATOR
@@ -380,6 +394,22 @@ class background_reclaimer {
             _main_loop_wait = nullptr;
         }
     }
+    void step() {
+        auto start = clock::now();
+        auto released = _reclaim(std::min(_step_size, free_memory_threshold - memory::free_memory()));
+        auto duration = clock::now() - start;
+        ++_stats.steps;
+        _stats.memory_reclaimed += released;
+        _stats.time += duration;
+        if (duration > step_budget) {
+            ++_stats.steps_over_budget;
+            _step_size = std::max(min_step_size, _step_size / 2);
+        } else if (duration < step_budget / 2) {
+            _step_size = std::min(max_step_size, _step_size * 2);
+        }
+        llogger.trace("background_reclaimer::step: released {} bytes in {} us, next step size {}",
+                released, duration / 1us, _step_size);
+    }
     future<> main_loop() {
         llogger.debug("background_reclaimer::main_loop: entry");
         while (true) {
@@ -394,7 +424,7 @@ class background_reclaimer {
             if (_stopping) {
                 break;
             }
-            _reclaim(free_memory_threshold - memory::free_memory());
+            step();
             co_await coroutine::maybe_yield();
         }
         llogger.debug("background_reclaimer::main_loop: exit");
@@ -409,8 +439,22 @@ class background_reclaimer {
             }
         }
     }
+    void register_metrics() {
+        namespace sm = seastar::metrics;
+        _metrics.add_group("lsa", {
+            sm::make_counter("background_reclaim_steps", _stats.steps,
+                           sm::description("Counts the steps of memory reclamation done in the background.")),
+            sm::make_counter("background_reclaim_steps_over_budget", _stats.steps_over_budget,
+                           sm::description("Counts the steps of background memory reclamation which took longer than their time budget.")),
+            sm::make_counter("background_reclaim_memory", _stats.memory_reclaimed,
+                           sm::description("Counts the number of bytes released by background memory reclamation.")),
+            sm::make_counter("background_reclaim_time_us", [this] { return _stats.time / 1us; },
+                           sm::description("Counts the time spent in background memory reclamation, in microseconds.")),
+        });
+    }
 public:
-    explicit background_reclaimer(scheduling_group sg, noncopyable_function<void (size_t target)> reclaim)
+    // reclaim(target) tries to release target bytes to the standard allocator, and returns how much it released.
+    explicit background_reclaimer(scheduling_group sg, noncopyable_function<size_t (size_t target)> reclaim)
             : _sg(sg)
             , _reclaim(std::move(reclaim))
             , _adjust_shares_timer(default_scheduling_group(), [this] { adjust_shares(); })
@@ -418,6 +462,7 @@ class background_reclaimer {
         if (sg != default_scheduling_group()) {
             _adjust_shares_timer.arm_periodic(50ms);
         }
+        register_metrics();
     }
     future<> stop() {
         _stopping = true;
@@ -439,6 +484,9 @@ class tracker::impl {
     bool _abort_on_bad_alloc = false;
     bool _sanitizer_report_backtrace = false;
     reclaim_timer* _active_timer = nullptr;
+    // Accounts for outermost reclaim_timer scopes only, so that nested reclamation is not counted twice.
+    uint64_t _reclaim_time_us = 0;
+    uint64_t _reclaim_stalls = 0;
 private:
     // Prevents tracker's reclaimer from running while live. Reclaimer may be
     // invoked synchronously with allocator. This guard ensures that this
@@ -500,7 +548,7 @@ class tracker::impl {
     void setup_background_reclaim(scheduling_group sg) {
         assert(!_background_reclaimer);
         _background_reclaimer.emplace(sg, [this] (size_t target) {
-            reclaim(target, is_preemptible::yes);
+            return reclaim(target, is_preemptible::yes);
         });
     }
     // const bool&, so interested parties can save a reference and see updates.
@@ -520,6 +568,10 @@ class tracker::impl {
         }
         return false;
     }
+    void account_reclaim(std::chrono::microseconds duration, bool stall_detected) noexcept {
+        _reclaim_time_us += duration.count();
+        _reclaim_stalls += stall_detected;
+    }
 private:
     // Like compact_and_evict() but assumes that reclaim_lock is held around the operation.
     size_t compact_and_evict_locked(size_t reserve_segments, size_t bytes, is_preemptible preempt);
@@ -622,16 +674,30 @@ static_assert(min_free_space_for_compaction >= max_managed_object_size,
 // everything below that value in the same bucket.
 extern constexpr log_heap_options segment_descriptor_hist_options(min_free_space_for_compaction, 3, segment_size);
 
+// Objects allocated with region_impl::alloc_small() which are larger than this are kept
+// in segments of their own, see segment_kind::large.
+static constexpr size_t max_small_object_size = 1024;
+
 enum segment_kind : int {
-    regular = 0, // Holds objects allocated with region_impl::alloc_small()
-    bufs = 1     // Holds objects allocated with region_impl::alloc_buf()
+    regular = 0, // Holds objects allocated with region_impl::alloc_small(), up to max_small_object_size
+    bufs = 1,    // Holds objects allocated with region_impl::alloc_buf()
+    large = 2,   // Holds objects allocated with region_impl::alloc_small(), larger than max_small_object_size
 };
 
+// Segregating objects by size keeps small objects, like cache rows, packed together
+// and away from blobs, so that freeing either kind leaves fewer partially used
+// segments behind and compaction has less data to move.
+static constexpr std::array<std::pair<segment_kind, const char*>, 3> segment_kinds = {{
+    {segment_kind::regular, "small"},
+    {segment_kind::large, "large"},
+    {segment_kind::bufs, "buffers"},
+}};
+
 struct segment_descriptor : public log_heap_hook<segment_descriptor_hist_options> {
     static constexpr segment::size_type free_space_mask = segment::size_mask;
     static constexpr unsigned bits_for_free_space = segment::size_shift + 1;
-    static constexpr segment::size_type segment_kind_mask = 1 << bits_for_free_space;
-    static constexpr unsigned bits_for_segment_kind = 1;
+    static constexpr segment::size_type segment_kind_mask = 3 << bits_for_free_space;
+    static constexpr unsigned bits_for_segment_kind = 2;
     static constexpr unsigned shift_for_segment_kind = bits_for_free_space;
     static_assert(sizeof(segment::size_type) * 8 >= bits_for_free_space + bits_for_segment_kind);
 
@@ -969,6 +1035,10 @@ class segment_pool {
     size_t _emergency_reserve_max = 30;
     bool _allocation_failure_flag = false;
     bool _allocation_enabled = true;
+    // Computed for all kinds in one walk over the segments, and reused by the
+    // metrics of the other kinds in the same scrape.
+    std::array<seastar::metrics::histogram, segment_kinds.size()> _occupancy_histograms;
+    lowres_clock::time_point _occupancy_histograms_computed_at = lowres_clock::time_point::min();
 
     struct allocation_lock {
         segment_pool& _pool;
@@ -1022,7 +1092,9 @@ class segment_pool {
 public:
     explicit segment_pool(logalloc::tracker::impl& tracker);
     logalloc::tracker::impl& tracker() { return _tracker; }
-    void prime(size_t available_memory, size_t min_free_memory);
+    void prime(size_t available_memory, size_t min_free_memory, use_huge_pages huge_pages);
+    // Advises huge pages for, and populates, the segments owned by the pool.
+    void back_with_huge_pages() noexcept;
     void use_standard_allocator_segment_pool_backend(size_t available_memory);
     segment* new_segment(region::impl* r);
     const segment_descriptor& descriptor(const segment* seg) const noexcept {
@@ -1070,6 +1142,8 @@ class segment_pool {
         desc._region = r;
     }
     size_t reclaim_segments(size_t target, is_preemptible preempt);
+    // Histogram of the occupancy of in-use segments of the given kind, in 10% buckets.
+    const seastar::metrics::histogram& occupancy_histogram(segment_kind kind);
     void reclaim_all_free_segments() {
         reclaim_segments(std::numeric_limits<size_t>::max(), is_preemptible::no);
     }
@@ -1362,7 +1436,7 @@ segment_pool::segment_pool(tracker::impl& tracker)
 {
 }
 
-void segment_pool::prime(size_t available_memory, size_t min_free_memory) {
+void segment_pool::prime(size_t available_memory, size_t min_free_memory, use_huge_pages huge_pages) {
     auto old_emergency_reserve = std::exchange(_emergency_reserve_max, std::numeric_limits<size_t>::max());
     try {
         // Allocate all of memory so that we occupy the top part. Afterwards, we'll start
@@ -1372,6 +1446,9 @@ void segment_pool::prime(size_t available_memory, size_t min_free_memory) {
     } catch (std::bad_alloc&) {
         _emergency_reserve_max = old_emergency_reserve;
     }
+    if (huge_pages) {
+        back_with_huge_pages();
+    }
     // We want to leave more free memory than just min_free_memory() in order to reduce
     // the frequency of expensive segment-migrating reclaim() called by the seastar allocator.
     size_t min_gap = 1 * 1024 * 1024;
@@ -1382,6 +1459,48 @@ void segment_pool::prime(size_t available_memory, size_t min_free_memory) {
     reclaim_segments(_store.non_lsa_reserve / segment::size, is_preemptible::no);
 }
 
+#ifndef MADV_POPULATE_WRITE
+#define MADV_POPULATE_WRITE 23 // Since Linux 5.14
+#endif
+
+void segment_pool::back_with_huge_pages() noexcept {
+    size_t advised = 0;
+    // Segments are mostly allocated from a contiguous area, so advise whole runs
+    // of adjacent segments, giving the kernel 2MB aligned ranges to work with.
+    auto advise = [&] (char* start, char* end) {
+        if (start == end) {
+            return true;
+        }
+        if (madvise(start, end - start, MADV_HUGEPAGE)) {
+            llogger.warn("Failed to advise huge pages for LSA memory: {}", std::strerror(errno));
+            return false;
+        }
+        // Fault the pages in now rather than on the allocation path. Older kernels
+        // don't support MADV_POPULATE_WRITE, the pages are then populated on first touch.
+        if (madvise(start, end - start, MADV_POPULATE_WRITE)) {
+            llogger.debug("Failed to populate LSA memory: {}", std::strerror(errno));
+        }
+        advised += end - start;
+        return true;
+    };
+    char* run_start = nullptr;
+    char* run_end = nullptr;
+    for (size_t idx = _lsa_owned_segments_bitmap.find_first_set(); idx != utils::dynamic_bitset::npos;
+            idx = _lsa_owned_segments_bitmap.find_next_set(idx)) {
+        auto seg = reinterpret_cast<char*>(segment_from_idx(idx));
+        if (seg != run_end) {
+            if (!advise(run_start, run_end)) {
+                return;
+            }
+            run_start = seg;
+        }
+        run_end = seg + segment::size;
+    }
+    if (advise(run_start, run_end)) {
+        llogger.info("Backed {} MiB of LSA memory with huge pages", advised >> 20);
+    }
+}
+
 void segment_pool::use_standard_allocator_segment_pool_backend(size_t available_memory) {
     if (_segments_in_use) {
         throw std::runtime_error("cannot change segment store backend after segments are in use");
@@ -1427,6 +1546,44 @@ size_t segment_pool::segments_in_use() const noexcept {
     return _segments_in_use;
 }
 
+const seastar::metrics::histogram& segment_pool::occupancy_histogram(segment_kind kind) {
+    static constexpr size_t buckets = 10;
+    auto now = lowres_clock::now();
+    if (now - _occupancy_histograms_computed_at >= std::chrono::seconds(1)) {
+        std::array<std::array<uint64_t, buckets>, segment_kinds.size()> counts{};
+        for (auto& h : _occupancy_histograms) {
+            h = {};
+        }
+        for (size_t idx = _lsa_owned_segments_bitmap.find_first_set(); idx != utils::dynamic_bitset::npos;
+                idx = _lsa_owned_segments_bitmap.find_next_set(idx)) {
+            if (_lsa_free_segments_bitmap.test(idx)) {
+                continue;
+            }
+            auto& desc = _segments[idx];
+            if (!desc._region) {
+                continue;
+            }
+            auto k = size_t(desc.kind());
+            auto used = desc.occupancy().used_fraction();
+            ++counts[k][std::min(buckets - 1, size_t(used * buckets))];
+            ++_occupancy_histograms[k].sample_count;
+            _occupancy_histograms[k].sample_sum += used;
+        }
+        for (size_t k = 0; k < segment_kinds.size(); ++k) {
+            auto& h = _occupancy_histograms[k];
+            uint64_t cumulative = 0;
+            h.buckets.resize(buckets);
+            for (size_t i = 0; i < buckets; ++i) {
+                cumulative += counts[k][i];
+                h.buckets[i].count = cumulative;
+                h.buckets[i].upper_bound = double(i + 1) / buckets;
+            }
+        }
+        _occupancy_histograms_computed_at = now;
+    }
+    return _occupancy_histograms[size_t(kind)];
+}
+
 reclaim_timer::reclaim_timer(const char* name, is_preemptible preemptible, size_t memory_to_release, size_t segments_to_release, tracker::impl& tracker, segment_pool& segment_pool, extra_logger extra_logs)
     : _duration_threshold(
             // We only report reclaim stalls when their measured duration is
@@ -1476,6 +1633,7 @@ reclaim_timer::~reclaim_timer() {
 
     _duration = clock::now() - _start;
     _stall_detected = _duration >= _duration_threshold;
+    _tracker.account_reclaim(std::chrono::duration_cast<std::chrono::microseconds>(_duration), _stall_detected);
     if (_debug_enabled || _stall_detected) {
         sample_stats(_end_stats);
         _stat_diff = _end_stats - _start_stats;
@@ -1648,6 +1806,9 @@ class region_impl final : public basic_region_impl {
     region_listener* _listener = nullptr;
     segment* _active = nullptr;
     size_t _active_offset;
+    // Active segment for objects larger than max_small_object_size.
+    segment* _large_active = nullptr;
+    size_t _large_active_offset;
     segment_descriptor_hist _segment_descs; // Contains only closed segments
     occupancy_stats _closed_occupancy;
     occupancy_stats _non_lsa_occupancy;
@@ -1681,32 +1842,43 @@ class region_impl final : public basic_region_impl {
     };
 
     void* alloc_small(const object_descriptor& desc, segment::size_type size, size_t alignment) {
-        if (!_active) {
-            _active = new_segment();
-            _active_offset = 0;
+        if (size > max_small_object_size) {
+            return alloc_small(_large_active, _large_active_offset, segment_kind::large, desc, size, alignment);
+        }
+        return alloc_small(_active, _active_offset, segment_kind::regular, desc, size, alignment);
+    }
+
+    void* alloc_small(segment*& active, size_t& active_offset, segment_kind kind, const object_descriptor& desc, segment::size_type size, size_t alignment) {
+        if (!active) {
+            active = new_segment(kind);
+            active_offset = 0;
         }
 
         auto desc_encoded_size = desc.encoded_size();
 
-        size_t obj_offset = align_up_for_asan(align_up(_active_offset + desc_encoded_size, alignment));
+        size_t obj_offset = align_up_for_asan(align_up(active_offset + desc_encoded_size, alignment));
         if (obj_offset + size > segment::size) {
-            close_and_open();
-            return alloc_small(desc, size, alignment);
+            close_and_open(active, active_offset, kind);
+            return alloc_small(active, active_offset, kind, desc, size, alignment);
         }
 
-        auto old_active_offset = _active_offset;
-        auto pos = _active->at<char>(_active_offset);
+        auto old_active_offset = active_offset;
+        auto pos = active->at<char>(active_offset);
         // Use non-canonical encoding to allow for alignment pad
-        desc.encode(pos, obj_offset - _active_offset, size);
+        desc.encode(pos, obj_offset - active_offset, size);
         unpoison(pos, size);
-        _active_offset = obj_offset + size;
+        active_offset = obj_offset + size;
 
         // Align the end of the value so that the next descriptor is aligned
-        _active_offset = align_up_for_asan(_active_offset);
-        segment_pool().descriptor(_active).record_alloc(_active_offset - old_active_offset);
+        active_offset = align_up_for_asan(active_offset);
+        segment_pool().descriptor(active).record_alloc(active_offset - old_active_offset);
         return pos;
     }
 
+    bool is_active(const segment* seg) const noexcept {
+        return seg == _active || seg == _large_active;
+    }
+
     template<typename Func>
     requires std::is_invocable_r_v<void, Func, const object_descriptor*, void*, size_t>
     void for_each_live(segment* seg, Func&& func) {
@@ -1726,21 +1898,26 @@ class region_impl final : public basic_region_impl {
         }
     }
 
-    void close_active() {
-        if (!_active) {
+    void close_active(segment*& active, size_t active_offset) {
+        if (!active) {
             return;
         }
-        if (_active_offset < segment::size) {
-            auto desc = object_descriptor::make_dead(segment::size - _active_offset);
-            auto pos =_active->at<char>(_active_offset);
+        if (active_offset < segment::size) {
+            auto desc = object_descriptor::make_dead(segment::size - active_offset);
+            auto pos = active->at<char>(active_offset);
             desc.encode(pos);
         }
-        auto& desc = segment_pool().descriptor(_active);
-        llogger.trace("Closing segment {}, used={}, waste={} [B]", fmt::ptr(_active), desc.occupancy(), segment::size - _active_offset);
+        auto& desc = segment_pool().descriptor(active);
+        llogger.trace("Closing segment {}, used={}, waste={} [B]", fmt::ptr(active), desc.occupancy(), segment::size - active_offset);
         _closed_occupancy += desc.occupancy();
 
         _segment_descs.push(desc);
-        _active = nullptr;
+        active = nullptr;
+    }
+
+    void close_active() {
+        close_active(_active, _active_offset);
+        close_active(_large_active, _large_active_offset);
     }
 
     void close_buf_active() {
@@ -1771,8 +1948,9 @@ class region_impl final : public basic_region_impl {
         }
     }
 
-    segment* new_segment() {
+    segment* new_segment(segment_kind kind = segment_kind::regular) {
         segment* seg = segment_pool().new_segment(this);
+        segment_pool().descriptor(seg).set_kind(kind);
         if (_listener) {
             _evictable_space += segment_size;
             _listener->increase_usage(_region, segment::size);
@@ -1881,11 +2059,11 @@ class region_impl final : public basic_region_impl {
         segment_pool().on_segment_compaction(seg_occupancy.used_space());
     }
 
-    void close_and_open() {
-        segment* new_active = new_segment();
-        close_active();
-        _active = new_active;
-        _active_offset = 0;
+    void close_and_open(segment*& active, size_t& active_offset, segment_kind kind) {
+        segment* new_active = new_segment(kind);
+        close_active(active, active_offset);
+        active = new_active;
+        active_offset = 0;
     }
 
     void new_buf_active() {
@@ -1950,6 +2128,11 @@ class region_impl final : public basic_region_impl {
             free_segment(_active);
             _active = nullptr;
         }
+        if (_large_active) {
+            assert(segment_pool().descriptor(_large_active).is_empty());
+            free_segment(_large_active);
+            _large_active = nullptr;
+        }
         if (_buf_active) {
             assert(segment_pool().descriptor(_buf_active).is_empty());
             free_segment(_buf_active);
@@ -1999,6 +2182,9 @@ class region_impl final : public basic_region_impl {
         if (_active) {
             total += segment_pool().descriptor(_active).occupancy();
         }
+        if (_large_active) {
+            total += segment_pool().descriptor(_large_active).occupancy();
+        }
         if (_buf_active) {
             total += segment_pool().descriptor(_buf_active).occupancy();
         }
@@ -2029,8 +2215,9 @@ class region_impl final : public basic_region_impl {
     bool is_compactible() const noexcept {
         return _reclaiming_enabled
             // We require 2 segments per allocation segregation group to ensure forward progress during compaction.
-            // There are currently two fixed groups, one for the allocation_strategy implementation and one for lsa_buffer:s.
-            && (_closed_occupancy.free_space() >= 4 * segment::size)
+            // There are currently three fixed groups, two for the allocation_strategy implementation (small and
+            // large objects) and one for lsa_buffer:s.
+            && (_closed_occupancy.free_space() >= 6 * segment::size)
             && _segment_descs.contains_above_min();
     }
 
@@ -2115,14 +2302,14 @@ class region_impl final : public basic_region_impl {
         desc.encode(npos);
         poison(pos, dead_size);
 
-        if (seg != _active) {
+        if (!is_active(seg)) {
             _closed_occupancy -= seg_desc.occupancy();
         }
 
         seg_desc.record_free(dead_size);
         pool.on_memory_deallocation(dead_size);
 
-        if (seg != _active) {
+        if (!is_active(seg)) {
             if (seg_desc.is_empty()) {
                 _segment_descs.erase(seg_desc);
                 free_segment(seg, seg_desc);
@@ -2161,20 +2348,23 @@ class region_impl final : public basic_region_impl {
 
         auto& pool = segment_pool();
 
-        if (_active && pool.descriptor(_active).is_empty()) {
-            pool.free_segment(_active);
-            _active = nullptr;
-        }
-        if (!_active) {
-            _active = other._active;
-            other._active = nullptr;
-            _active_offset = other._active_offset;
-            if (_active) {
-                pool.set_region(_active, this);
+        auto merge_active = [&] (segment*& active, size_t& active_offset, segment*& other_active, size_t other_active_offset) {
+            if (active && pool.descriptor(active).is_empty()) {
+                pool.free_segment(active);
+                active = nullptr;
             }
-        } else {
-            other.close_active();
-        }
+            if (!active) {
+                active = std::exchange(other_active, nullptr);
+                active_offset = other_active_offset;
+                if (active) {
+                    pool.set_region(active, this);
+                }
+            } else {
+                other.close_active(other_active, other_active_offset);
+            }
+        };
+        merge_active(_active, _active_offset, other._active, other._active_offset);
+        merge_active(_large_active, _large_active_offset, other._large_active, other._large_active_offset);
         other.close_buf_active();
 
         for (auto& desc : other._segment_descs) {
@@ -2218,7 +2408,7 @@ class region_impl final : public basic_region_impl {
     void full_compaction() {
         compaction_lock _(*this);
         llogger.debug("Full compaction, {}", occupancy());
-        close_and_open();
+        close_active();
         close_buf_active();
         segment_descriptor_hist all;
         std::swap(all, _segment_descs);
@@ -2234,7 +2424,9 @@ class region_impl final : public basic_region_impl {
     void compact_segment(segment* seg, segment_descriptor& desc) {
         compaction_lock _(*this);
         if (_active == seg) {
-            close_active();
+            close_active(_active, _active_offset);
+        } else if (_large_active == seg) {
+            close_active(_large_active, _large_active_offset);
         } else if (_buf_active == seg) {
             close_buf_active();
         }
@@ -2394,6 +2586,12 @@ void region::full_compaction() {
     get_impl().full_compaction();
 }
 
+bool region::is_in_large_object_segment(const void* obj) const noexcept {
+    auto& pool = get_impl().segment_pool();
+    auto& desc = pool.descriptor(pool.containing_segment(obj));
+    return desc._region == &get_impl() && desc.kind() == segment_kind::large;
+}
+
 memory::reclaiming_result region::evict_some() {
     if (get_impl().is_evictable()) {
         return get_impl().evict_some();
@@ -2799,7 +2997,22 @@ tracker::impl::impl() : _segment_pool(std::make_unique<logalloc::segment_pool>(*
 
         sm::make_counter("memory_freed", [this] { return _segment_pool->statistics().memory_freed; },
                         sm::description("Counts number of bytes which were requested to be freed in LSA.")),
+
+        sm::make_counter("reclaim_time_us", [this] { return _reclaim_time_us; },
+                        sm::description("Counts the time spent in memory reclamation, both on demand and in the background, in microseconds.")),
+
+        sm::make_counter("reclaim_stalls", [this] { return _reclaim_stalls; },
+                        sm::description("Counts memory reclamations which took longer than the reactor stall threshold (blocked-reactor-notify-ms).")),
     });
+
+    for (auto [kind, name] : segment_kinds) {
+        _metrics.add_group("lsa", {
+            sm::make_histogram("segment_occupancy", [this, kind = kind] { return _segment_pool->occupancy_histogram(kind); },
+                            sm::description("Histogram of the fraction of space used in segments, per size class. "
+                                            "Many segments in the low buckets indicate fragmentation."),
+                            {sm::label("size_class")(name)}),
+        });
+    }
 }
 
 tracker::impl::~impl() {
@@ -2910,9 +3123,9 @@ void allocating_section::set_std_reserve(size_t reserve) noexcept {
     _std_reserve = reserve;
 }
 
-future<> prime_segment_pool(size_t available_memory, size_t min_free_memory) {
+future<> prime_segment_pool(size_t available_memory, size_t min_free_memory, use_huge_pages huge_pages) {
     return smp::invoke_on_all([=] {
-        shard_tracker().get_impl().segment_pool().prime(available_memory, min_free_memory);
+        shard_tracker().get_impl().segment_pool().prime(available_memory, min_free_memory, huge_pages);
     });
 }
 
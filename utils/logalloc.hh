@@ -15,6 +15,7 @@
 #include <seastar/core/shared_ptr.hh>
 #include <seastar/core/shared_future.hh>
 #include <seastar/core/expiring_fifo.hh>
+#include <seastar/util/bool_class.hh>
 #include "allocation_strategy.hh"
 #include "seastarx.hh"
 #include "db/timeout_clock.hh"
@@ -373,6 +374,10 @@ class region {
     // Runs eviction function once. Mainly for testing.
     memory::reclaiming_result evict_some();
 
+    // Whether obj, allocated through allocator() of this region, is kept in a
+    // segment for large objects, rather than with the small ones. For testing.
+    bool is_in_large_object_segment(const void* obj) const noexcept;
+
     // Changes the reclaimability state of this region. When region is not
     // reclaimable, it won't be considered by tracker::reclaim(). By default region is
     // reclaimable after construction.
@@ -523,7 +528,15 @@ class allocating_section {
     }
 };
 
-future<> prime_segment_pool(size_t available_memory, size_t min_free_memory);
+using use_huge_pages = bool_class<struct use_huge_pages_tag>;
+
+// Allocates the LSA segments upfront, so that LSA memory occupies the top of the shard's memory.
+//
+// With use_huge_pages::yes, the kernel is also advised to back the segments with
+// transparent huge pages, and they are populated right away. This cuts TLB misses on
+// row cache and memtable accesses on large-memory nodes. For 1GB pages, run with
+// seastar's --hugepages option instead, which backs all of the shard's memory by hugetlbfs.
+future<> prime_segment_pool(size_t available_memory, size_t min_free_memory, use_huge_pages huge_pages = use_huge_pages::no);
 
 // Use the segment pool appropriate for the standard allocator.
 //
@@ -57,15 +57,23 @@ class lru {
         boost::intrusive::member_hook<evictable, evictable::lru_link_type, &evictable::_lru_link>,
         boost::intrusive::constant_time_size<false>>; // we need this to have bi::auto_unlink on hooks.
     lru_type _list;
+    // Elements added with add_cold() which were not touched since.
+    // They are all evicted before any element of _list.
+    lru_type _cold;
 public:
     using reclaiming_result = seastar::memory::reclaiming_result;
 
     ~lru() {
+        _cold.clear_and_dispose([] (evictable* e) {
+            e->on_evicted();
+        });
         _list.clear_and_dispose([] (evictable* e) {
             e->on_evicted();
         });
     }
 
+    // Works for elements of either segment, erasing from a list without
+    // constant-time size only unlinks the node.
     void remove(evictable& e) noexcept {
         _list.erase(_list.iterator_to(e));
     }
@@ -79,6 +87,14 @@ class lru {
         _list.insert(_list.iterator_to(more_recent), e);
     }
 
+    // Like add(e) but for elements which were not used yet, for example
+    // speculatively read-ahead ones. They are evicted before all the elements
+    // added with add(), so that they don't push out the ones which were used,
+    // until they are touched.
+    void add_cold(evictable& e) noexcept {
+        _cold.push_back(e);
+    }
+
     void touch(evictable& e) noexcept {
         remove(e);
         add(e);
@@ -87,11 +103,12 @@ class lru {
     // Evicts a single element from the LRU
     template <bool Shallow = false>
     reclaiming_result do_evict() noexcept {
-        if (_list.empty()) {
+        auto& list = _cold.empty() ? _list : _cold;
+        if (list.empty()) {
             return reclaiming_result::reclaimed_nothing;
         }
-        evictable& e = _list.front();
-        _list.pop_front();
+        evictable& e = list.front();
+        list.pop_front();
         if constexpr (!Shallow) {
             e.on_evicted();
         } else {
@@ -30,15 +30,27 @@ class chunked_content_stream {
 private:
     chunked_content _content;
     chunked_content::iterator _current_chunk;
+    // The unread part of the current chunk, empty at the end of the stream.
+    const char* _pos = nullptr;
+    const char* _end = nullptr;
     // _count only needed for Tell(). 32 bits is enough, we don't allow
     // more than 16 MB requests anyway.
-    unsigned _count;
+    unsigned _count = 0;
+private:
+    void set_current_chunk() {
+        if (!eof()) {
+            _pos = _current_chunk->begin();
+            _end = _current_chunk->end();
+        }
+    }
 public:
     typedef char Ch;
     chunked_content_stream(chunked_content&& content)
         : _content(std::move(content))
         , _current_chunk(_content.begin())
-    {}
+    {
+        set_current_chunk();
+    }
     bool eof() const {
         return _current_chunk == _content.end();
     }
@@ -53,19 +65,19 @@ class chunked_content_stream {
             // anyway can't include bare null characters.
             return '\0';
         } else {
-            return *_current_chunk->begin();
+            return *_pos;
         }
     }
     char Take() {
         if (eof()) {
             return '\0';
         } else {
-            char ret = *_current_chunk->begin();
-            _current_chunk->trim_front(1);
+            char ret = *_pos++;
             ++_count;
-            if (_current_chunk->empty()) {
+            if (_pos == _end) {
                 *_current_chunk = temporary_buffer<char>();
                 ++_current_chunk;
+                set_current_chunk();
             }
             return ret;
         }
@@ -81,6 +93,11 @@ class chunked_content_stream {
 
 };
 
+// Texts up to this size are copied to a null-terminated buffer before being
+// parsed, which lets rapidjson use its faster scanning of null-terminated
+// text. Larger ones are parsed in place, to avoid large allocations.
+static constexpr size_t max_null_terminated_parse_size = 128 * 1024;
+
 /*
  * This wrapper class adds nested level checks to rapidjson's handlers.
  * Each rapidjson handler implements functions for accepting JSON values,
@@ -125,18 +142,45 @@ struct guarded_yieldable_json_handler : public Handler {
         handler_base::Populate(dummy_generator);
     }
     void Parse(const char* str, size_t length) {
+        if (length <= max_null_terminated_parse_size) {
+            temporary_buffer<char> text(length + 1);
+            std::copy_n(str, length, text.get_write());
+            parse_null_terminated(std::move(text));
+            return;
+        }
         rapidjson::MemoryStream ms(static_cast<const char*>(str), length * sizeof(typename encoding::Ch));
         rapidjson::EncodedInputStream<encoding, rapidjson::MemoryStream> is(ms);
         Parse(is);
     }
 
     void Parse(chunked_content&& content) {
+        size_t length = 0;
+        for (const auto& chunk : content) {
+            length += chunk.size();
+        }
+        if (length <= max_null_terminated_parse_size) {
+            temporary_buffer<char> text(length + 1);
+            auto out = text.get_write();
+            for (auto& chunk : content) {
+                out = std::copy_n(chunk.get(), chunk.size(), out);
+                chunk = temporary_buffer<char>();
+            }
+            parse_null_terminated(std::move(text));
+            return;
+        }
         // Note that content was moved into this function. The intention is
         // that we free every chunk we are done with.
         chunked_content_stream is(std::move(content));
         Parse(is);
     }
 
+    // text holds the text to parse followed by room for its terminator.
+    void parse_null_terminated(temporary_buffer<char> text) {
+        text.get_write()[text.size() - 1] = '\0';
+        rapidjson::StringStream is(text.get());
+        Parse(is);
+    }
+
     bool StartObject() {
         ++_nested_level;
         check_nested_level();
@@ -291,6 +335,91 @@ future<> print(const rjson::value& value, seastar::output_stream<char>& os, size
     co_return co_await std::move(osb).finish();
 }
 
+class streaming_writer::impl {
+    // Implements the output Stream concept rapidjson's Writer expects.
+    struct chunked_stream {
+        static constexpr size_t chunk_size = 32 * 1024;
+        chunked_content _chunks;
+        temporary_buffer<char> _buf;
+        size_t _pos = 0;
+        size_t _size = 0;
+
+        #pragma GCC diagnostic push
+        #pragma GCC diagnostic ignored "-Wunused-local-typedefs"
+        using Ch = char;
+        #pragma GCC diagnostic pop
+
+        void close_chunk() {
+            if (_pos) {
+                _buf.trim(_pos);
+                _chunks.push_back(std::move(_buf));
+                _pos = 0;
+            }
+        }
+        void Put(char c) {
+            if (_pos == _buf.size()) {
+                close_chunk();
+                _buf = temporary_buffer<char>(chunk_size);
+            }
+            _buf.get_write()[_pos++] = c;
+            ++_size;
+        }
+        void Flush() {}
+    };
+public:
+    chunked_stream _stream;
+    rapidjson::Writer<chunked_stream, encoding, encoding, allocator> _writer{_stream};
+};
+
+streaming_writer::streaming_writer() : _impl(std::make_unique<impl>()) {}
+streaming_writer::streaming_writer(streaming_writer&&) noexcept = default;
+streaming_writer::~streaming_writer() = default;
+
+void streaming_writer::start_object() {
+    _impl->_writer.StartObject();
+}
+
+void streaming_writer::end_object() {
+    _impl->_writer.EndObject();
+}
+
+void streaming_writer::start_array() {
+    _impl->_writer.StartArray();
+}
+
+void streaming_writer::end_array() {
+    _impl->_writer.EndArray();
+}
+
+void streaming_writer::key(std::string_view name) {
+    _impl->_writer.Key(name.data(), name.size());
+}
+
+void streaming_writer::string(std::string_view str) {
+    _impl->_writer.String(str.data(), str.size());
+}
+
+void streaming_writer::number(uint64_t n) {
+    _impl->_writer.Uint64(n);
+}
+
+void streaming_writer::raw(std::string_view json) {
+    _impl->_writer.RawValue(json.data(), json.size(), rapidjson::kObjectType);
+}
+
+void streaming_writer::value(const rjson::value& v) {
+    v.Accept(_impl->_writer);
+}
+
+size_t streaming_writer::size() const noexcept {
+    return _impl->_stream._size;
+}
+
+chunked_content streaming_writer::finish() && {
+    _impl->_stream.close_chunk();
+    return std::move(_impl->_stream._chunks);
+}
+
 rjson::malformed_value::malformed_value(std::string_view name, const rjson::value& value)
     : malformed_value(name, print(value))
 {}
@@ -26,6 +26,7 @@
  * or calling Size() on a non-array value.
  */
 
+#include <memory>
 #include <string>
 #include <stdexcept>
 #include "utils/base64.hh"
@@ -59,6 +60,16 @@ class error : public std::exception {
 // quite costly if not inlined, by default rapidjson only enables it if NDEBUG
 // is defined which isn't the case for us.
 #define RAPIDJSON_FORCEINLINE __attribute__((always_inline))
+// Let rapidjson scan whitespace and strings of null-terminated text 16 bytes
+// at a time. Its SIMD loads may read past the terminator, within the same
+// aligned 16 bytes, which the address sanitizer would report.
+#ifndef SANITIZE
+#if defined(__SSE4_2__)
+#define RAPIDJSON_SSE42 1
+#elif defined(__ARM_NEON)
+#define RAPIDJSON_NEON 1
+#endif
+#endif
 
 #include <rapidjson/document.h>
 #include <rapidjson/writer.h>
@@ -189,6 +200,34 @@ using chunked_content = std::vector<temporary_buffer<char>>;
 rjson::value parse(chunked_content&&, size_t max_nested_level = default_max_nested_level);
 rjson::value parse_yieldable(chunked_content&&, size_t max_nested_level = default_max_nested_level);
 
+// Writes JSON text directly, as print() would print the value described by
+// the calls made to it, without building the value first. The text is kept
+// in chunks, so that large texts don't need large contiguous allocations.
+// Nesting isn't checked, and the calls have to describe valid JSON.
+class streaming_writer {
+    class impl;
+    std::unique_ptr<impl> _impl;
+public:
+    streaming_writer();
+    streaming_writer(streaming_writer&&) noexcept;
+    ~streaming_writer();
+
+    void start_object();
+    void end_object();
+    void start_array();
+    void end_array();
+    void key(std::string_view name);
+    void string(std::string_view str);
+    void number(uint64_t n);
+    // Writes json, which is already valid JSON text, as a value.
+    void raw(std::string_view json);
+    void value(const rjson::value& v);
+
+    // The length of the text written so far.
+    size_t size() const noexcept;
+    chunked_content finish() &&;
+};
+
 // Creates a JSON value (of JSON string type) out of internal string representations.
 // The string value is copied, so str's liveness does not need to be persisted.
 rjson::value from_string(const char* str, size_t size);
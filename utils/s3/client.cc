@@ -7,6 +7,7 @@
  */
 
 #include <rapidxml.h>
+#include <deque>
 #include <seastar/core/coroutine.hh>
 #include <seastar/core/semaphore.hh>
 #include <seastar/util/short_streams.hh>
@@ -150,15 +151,16 @@ class client::upload_sink : public data_sink_impl {
     // "Each part must be at least 5 MB in size, except the last part."
     // https://docs.aws.amazon.com/AmazonS3/latest/API/API_UploadPart.html
     static constexpr size_t minimum_part_size = 5 << 20;
-    static constexpr int flush_concurrency = 3;
 
     shared_ptr<client> _client;
     http::experimental::client& _http;
     sstring _object_name;
+    size_t _part_size;
+    unsigned _flush_concurrency;
     memory_data_sink_buffers _bufs;
     sstring _upload_id;
     utils::chunked_vector<sstring> _part_etags;
-    semaphore _flush_sem{flush_concurrency};
+    semaphore _flush_sem;
 
     future<> start_upload();
     future<> finalize_upload();
@@ -172,10 +174,13 @@ class client::upload_sink : public data_sink_impl {
     }
 
 public:
-    upload_sink(shared_ptr<client> cln, sstring object_name)
+    upload_sink(shared_ptr<client> cln, sstring object_name, upload_options opts)
         : _client(std::move(cln))
         , _http(_client->_http)
         , _object_name(std::move(object_name))
+        , _part_size(std::max(opts.part_size, minimum_part_size))
+        , _flush_concurrency(std::max(opts.concurrency, 1u))
+        , _flush_sem(_flush_concurrency)
     {
     }
 
@@ -207,7 +212,7 @@ class client::upload_sink : public data_sink_impl {
 };
 
 future<> client::upload_sink::maybe_flush() {
-    if (_bufs.size() >= minimum_part_size) {
+    if (_bufs.size() >= _part_size) {
         co_await do_flush();
     }
 }
@@ -359,7 +364,7 @@ future<> client::upload_sink::finalize_upload() {
     co_await do_flush();
 
     s3l.trace("wait for {} parts to complete (upload id {})", _part_etags.size(), _upload_id);
-    co_await _flush_sem.wait(flush_concurrency);
+    co_await _flush_sem.wait(_flush_concurrency);
 
     unsigned parts_xml_len = prepare_multipart_upload_parts(_part_etags);
     if (parts_xml_len == 0) {
@@ -385,8 +390,72 @@ future<> client::upload_sink::close() {
     }
 }
 
-data_sink client::make_upload_sink(sstring object_name) {
-    return data_sink(std::make_unique<upload_sink>(shared_from_this(), std::move(object_name)));
+data_sink client::make_upload_sink(sstring object_name, upload_options opts) {
+    return data_sink(std::make_unique<upload_sink>(shared_from_this(), std::move(object_name), opts));
+}
+
+class client::download_source : public data_source_impl {
+    shared_ptr<client> _client;
+    sstring _object_name;
+    size_t _part_size;
+    unsigned _readahead;
+    std::optional<uint64_t> _object_size;
+    // Offset of the next part to request
+    uint64_t _pos = 0;
+    // Requests of the parts following the consumed ones, in offset order
+    std::deque<future<temporary_buffer<char>>> _parts;
+
+    void request_parts() {
+        while (_parts.size() < _readahead && _pos < *_object_size) {
+            auto len = std::min<uint64_t>(_part_size, *_object_size - _pos);
+            s3l.trace("GET {} part [{}:{}) (readahead {})", _object_name, _pos, _pos + len, _parts.size());
+            _parts.push_back(_client->get_object_contiguous(_object_name, range{ _pos, len }).then([this, len] (temporary_buffer<char> buf) {
+                if (buf.size() != len) {
+                    throw std::runtime_error(format("short read of {}: got {} bytes of a {} bytes part", _object_name, buf.size(), len));
+                }
+                return buf;
+            }));
+            _pos += len;
+        }
+    }
+
+public:
+    download_source(shared_ptr<client> cln, sstring object_name, download_options opts)
+        : _client(std::move(cln))
+        , _object_name(std::move(object_name))
+        , _part_size(std::max<size_t>(opts.part_size, 1))
+        , _readahead(std::max(opts.readahead, 1u))
+    {
+    }
+
+    virtual future<temporary_buffer<char>> get() override {
+        if (!_object_size) {
+            _object_size = co_await _client->get_object_size(_object_name);
+        }
+        request_parts();
+        if (_parts.empty()) {
+            co_return temporary_buffer<char>();
+        }
+        auto part = std::move(_parts.front());
+        _parts.pop_front();
+        // Keep the readahead full while waiting for the part.
+        request_parts();
+        co_return co_await std::move(part);
+    }
+
+    virtual future<> close() override {
+        // Wait for the parts in flight, nobody is interested in them anymore.
+        for (auto& part : _parts) {
+            co_await std::move(part).discard_result().handle_exception([this] (std::exception_ptr ex) {
+                s3l.debug("ignoring failed read-ahead of {}: {}", _object_name, ex);
+            });
+        }
+        _parts.clear();
+    }
+};
+
+data_source client::make_download_source(sstring object_name, download_options opts) {
+    return data_source(std::make_unique<download_source>(shared_from_this(), std::move(object_name), opts));
 }
 
 class client::readable_file : public file_impl {
@@ -21,8 +21,23 @@ struct range {
     size_t len;
 };
 
+// The object is uploaded in parts of part_size bytes (at least the 5MB S3
+// requires), up to concurrency of them at a time.
+struct upload_options {
+    size_t part_size = 5 << 20;
+    unsigned concurrency = 3;
+};
+
+// The object is downloaded with ranged GETs of part_size bytes, the next
+// readahead of them being in flight while the current one is consumed.
+struct download_options {
+    size_t part_size = 1 << 20;
+    unsigned readahead = 4;
+};
+
 class client : public enable_shared_from_this<client> {
     class upload_sink;
+    class download_source;
     class readable_file;
     socket_address _addr;
     sstring _host;
@@ -41,7 +56,8 @@ class client : public enable_shared_from_this<client> {
     future<> delete_object(sstring object_name);
 
     file make_readable_file(sstring object_name);
-    data_sink make_upload_sink(sstring object_name);
+    data_sink make_upload_sink(sstring object_name, upload_options opts = {});
+    data_source make_download_source(sstring object_name, download_options opts = {});
 
     future<> close();
 };
@@ -10,10 +10,14 @@
 
 #include <list>
 #include <algorithm>
+#include <functional>
+#include <vector>
 #include <seastar/core/thread.hh>
 #include <seastar/core/future.hh>
 #include <seastar/core/future-util.hh>
 #include <seastar/core/sharded.hh>
+#include <seastar/core/coroutine.hh>
+#include <seastar/coroutine/maybe_yield.hh>
 #include "utils/collection-concepts.hh"
 
 using namespace seastar;
@@ -47,6 +51,47 @@ void merge_to_gently(std::list<T>& list1, const std::list<T>& list2, Compare com
     }
 }
 
+// Similar to std::sort but it does not stall, for sorting large vectors
+// (std::vector or utils::chunked_vector).
+// Runs of the vector are sorted, and then merged pairwise into a buffer of the
+// same size, yielding every sort_gently_run_size elements. Not stable.
+constexpr size_t sort_gently_run_size = 1024;
+
+template<typename Vector, class Compare = std::less<typename Vector::value_type>>
+requires LessComparable<typename Vector::value_type, typename Vector::value_type, Compare>
+future<> sort_gently(Vector& v, Compare comp = Compare()) {
+    const auto size = v.size();
+    for (size_t i = 0; i < size; i += sort_gently_run_size) {
+        std::sort(v.begin() + i, v.begin() + std::min(size, i + sort_gently_run_size), comp);
+        co_await coroutine::maybe_yield();
+    }
+    if (size <= sort_gently_run_size) {
+        co_return;
+    }
+    Vector buf;
+    buf.reserve(size);
+    for (size_t width = sort_gently_run_size; width < size; width *= 2) {
+        for (size_t lo = 0; lo < size; lo += 2 * width) {
+            const auto mid = std::min(size, lo + width);
+            const auto hi = std::min(size, lo + 2 * width);
+            auto a = lo;
+            auto b = mid;
+            while (a < mid || b < hi) {
+                if (b == hi || (a < mid && !comp(v[b], v[a]))) {
+                    buf.push_back(std::move(v[a++]));
+                } else {
+                    buf.push_back(std::move(v[b++]));
+                }
+                if (buf.size() % sort_gently_run_size == 0) {
+                    co_await coroutine::maybe_yield();
+                }
+            }
+        }
+        std::swap(v, buf);
+        buf.clear();
+    }
+}
+
 // The clear_gently functions are meant for
 // gently destroying the contents of containers.
 // The containers can be re-used after clear_gently
@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "utils/hash.hh"
+
+namespace utils {
+
+// Which of the two entries a two_choice_cache replaces when both slots of
+// an inserted key are taken.
+enum class two_choice_replacement {
+    oldest_insert,          // the one inserted earlier
+    least_recently_used,    // the one inserted or found earlier
+};
+
+// A cache of up to a fixed number of entries, each of which can be in one of
+// two slots picked from the hash of its key.
+//
+// Keys are given by their hash and a predicate matching the keys of entries,
+// so callers can compare keys which need a schema, or match several entries
+// with a weaker predicate when erasing. Entries of keys which hash to the same
+// value are all kept, up to two of them.
+//
+// capacity is rounded up to a power of two, 0 disables the cache. The slots
+// are allocated on the first insert(), in the current allocator.
+template <typename Key, typename Value, two_choice_replacement Replacement = two_choice_replacement::oldest_insert>
+class two_choice_cache {
+public:
+    struct entry {
+        Key key;
+        Value value;
+    };
+private:
+    struct slot {
+        std::optional<entry> e;
+        uint64_t stamp = 0;
+    };
+    size_t _capacity;
+    std::vector<slot> _slots;
+    uint64_t _clock = 0;
+    size_t _size = 0;
+private:
+    std::pair<size_t, size_t> slots_of(uint64_t hash) const noexcept {
+        auto h = fibonacci_hash(hash);
+        auto mask = _slots.size() - 1;
+        return {h & mask, (h >> 32) & mask};
+    }
+
+    template <typename Match>
+    const slot* find_slot(uint64_t hash, Match& match) const {
+        if (!_size) {
+            return nullptr;
+        }
+        auto [a, b] = slots_of(hash);
+        for (auto i : {a, b}) {
+            if (_slots[i].e && match(_slots[i].e->key)) {
+                return &_slots[i];
+            }
+        }
+        return nullptr;
+    }
+
+    void reset(slot& sl) noexcept {
+        sl.e.reset();
+        --_size;
+    }
+public:
+    explicit two_choice_cache(size_t capacity) noexcept
+        : _capacity(capacity ? std::bit_ceil(capacity) : 0)
+    { }
+
+    bool enabled() const noexcept {
+        return _capacity;
+    }
+
+    size_t size() const noexcept {
+        return _size;
+    }
+
+    // Returns the entry whose key has the given hash and satisfies match(const Key&).
+    template <typename Match>
+    const entry* find(uint64_t hash, Match&& match) const {
+        auto sl = find_slot(hash, match);
+        return sl ? &*sl->e : nullptr;
+    }
+
+    // Like the above, also counting as a use of the entry.
+    template <typename Match>
+    entry* find(uint64_t hash, Match&& match) {
+        auto sl = const_cast<slot*>(find_slot(hash, match));
+        if (!sl) {
+            return nullptr;
+        }
+        if constexpr (Replacement == two_choice_replacement::least_recently_used) {
+            sl->stamp = ++_clock;
+        }
+        return &*sl->e;
+    }
+
+    // Inserts an entry for key, replacing the one satisfying match(const Key&),
+    // if any. key and value are only moved from after match was called, so
+    // match may refer to key. Throws if memory can't be allocated, leaving the
+    // cache as it was.
+    template <typename Match, typename K, typename V>
+    void insert(uint64_t hash, Match&& match, K&& key, V&& value) {
+        if (!_capacity) {
+            return;
+        }
+        if (_slots.empty()) {
+            _slots.resize(_capacity);
+        }
+        auto [a, b] = slots_of(hash);
+        auto matches = [&] (size_t i) { return _slots[i].e && match(_slots[i].e->key); };
+        auto& sl = matches(a) ? _slots[a]
+                 : matches(b) ? _slots[b]
+                 : !_slots[a].e ? _slots[a]
+                 : !_slots[b].e ? _slots[b]
+                 : _slots[a].stamp <= _slots[b].stamp ? _slots[a] : _slots[b];
+        entry e{std::forward<K>(key), std::forward<V>(value)};
+        if (!sl.e) {
+            ++_size;
+        }
+        sl.e = std::move(e);
+        sl.stamp = ++_clock;
+    }
+
+    // Erases the entries whose keys have the given hash and satisfy match(const Key&).
+    template <typename Match>
+    void erase(uint64_t hash, Match&& match) noexcept {
+        if (!_size) {
+            return;
+        }
+        auto [a, b] = slots_of(hash);
+        for (auto i : {a, b}) {
+            if (_slots[i].e && match(_slots[i].e->key)) {
+                reset(_slots[i]);
+            }
+        }
+    }
+
+    // Erases the entries satisfying pred(const entry&). Visits all the slots.
+    template <typename Pred>
+    void erase_if(Pred&& pred) noexcept {
+        if (!_size) {
+            return;
+        }
+        for (auto& sl : _slots) {
+            if (sl.e && pred(*sl.e)) {
+                reset(sl);
+            }
+        }
+    }
+
+    void clear() noexcept {
+        for (auto& sl : _slots) {
+            sl.e.reset();
+        }
+        _size = 0;
+    }
+};
+
+}
@@ -14,6 +14,8 @@
 
 #include <algorithm>
 #include <array>
+#include <bit>
+#include <cstring>
 #include <limits>
 #include <type_traits>
 
@@ -141,6 +143,46 @@ uint64_t unsigned_vint::deserialize(bytes_view v) {
     return result;
 }
 
+size_t unsigned_vint::deserialize_batch(bytes_view v, std::span<uint64_t> out) noexcept {
+    auto src = reinterpret_cast<const uint8_t*>(v.data());
+    const auto end = src + v.size();
+
+    for (auto& dest : out) {
+        if (src == end) {
+            return 0;
+        }
+        const uint8_t first_byte = *src;
+        // Runs of small integers, like column indexes and lengths, are the common case.
+        if (first_byte < 0x80) {
+            dest = first_byte;
+            ++src;
+            continue;
+        }
+        const auto extra_bytes_size = vint_size_type(std::countl_one(first_byte));
+        const auto left = size_t(end - src);
+        if (left <= extra_bytes_size) {
+            return 0;
+        }
+        auto result = uint64_t(first_byte) & first_byte_value_mask(extra_bytes_size);
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        uint64_t value = 0;
+        // Overread when possible, as deserialize() does, instead of reading byte by byte.
+        std::memcpy(&value, src + 1, left >= sizeof(uint64_t) + 1 ? sizeof(uint64_t) : extra_bytes_size);
+        value = be_to_cpu(value << (64 - (extra_bytes_size * 8)));
+        result <<= (extra_bytes_size * 8) % 64;
+        result |= value;
+#else
+        for (vint_size_type index = 0; index < extra_bytes_size; ++index) {
+            result <<= 8;
+            result |= uint64_t(src[index + 1]);
+        }
+#endif
+        dest = result;
+        src += extra_bytes_size + 1;
+    }
+    return src - reinterpret_cast<const uint8_t*>(v.data());
+}
+
 vint_size_type unsigned_vint::serialized_size_from_first_byte(bytes::value_type first_byte) {
     int8_t first_byte_casted = first_byte;
     return 1 + (first_byte_casted >= 0 ? 0 : count_extra_bytes(first_byte_casted));
@@ -35,6 +35,7 @@
 #include "bytes.hh"
 
 #include <cstdint>
+#include <span>
 
 using vint_size_type = bytes::size_type;
 
@@ -49,6 +50,10 @@ struct unsigned_vint final {
 
     static value_type deserialize(bytes_view v);
 
+    // Deserializes out.size() consecutive vints from the front of v.
+    // Returns the number of bytes they take, or 0 if v doesn't hold all of them.
+    static size_t deserialize_batch(bytes_view v, std::span<value_type> out) noexcept;
+
     static vint_size_type serialized_size_from_first_byte(bytes::value_type first_byte);
 };
 
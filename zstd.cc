@@ -6,21 +6,61 @@
  * SPDX-License-Identifier: AGPL-3.0-or-later
  */
 
+#include <unordered_map>
+
 #include <seastar/core/aligned_buffer.hh>
+#include <seastar/core/weak_ptr.hh>
 
 // We need to use experimental features of the zstd library (to allocate compression/decompression context),
 // which are available only when the library is linked statically.
 #define ZSTD_STATIC_LINKING_ONLY
 #include "zstd.h"
+#include "zdict.h"
 
 #include "compress.hh"
+#include "log.hh"
+#include "utils/alien_worker.hh"
 #include "utils/class_registrator.hh"
 
+static logging::logger zstd_logger("zstd");
+
 static const sstring COMPRESSION_LEVEL = "compression_level";
+static const sstring DICTIONARY_SIZE_IN_KB = "dictionary_size_in_kb";
 static const sstring COMPRESSOR_NAME = compressor::namespace_prefix + "ZstdCompressor";
+static const sstring DICT_COMPRESSOR_NAME = compressor::namespace_prefix + "ZstdWithDictionaryCompressor";
+
+static constexpr int DEFAULT_COMPRESSION_LEVEL = 3;
+static constexpr size_t DEFAULT_DICTIONARY_SIZE = 32 * 1024;
+// zstd recommends sampling about 100 times the dictionary size; we settle
+// for less, since the samples are buffered in memory by the sstable writer.
+static constexpr size_t DICTIONARY_SAMPLE_RATIO = 32;
+// Bounds the memory held by the samples, and the time spent training on them.
+static constexpr size_t MAX_DICTIONARY_TRAINING_SIZE = 8 << 20;
+
+static int parse_compression_level(const compressor::opt_getter& opts) {
+    auto level = opts(COMPRESSION_LEVEL);
+    if (!level) {
+        return DEFAULT_COMPRESSION_LEVEL;
+    }
+    int compression_level;
+    try {
+        compression_level = std::stoi(*level);
+    } catch (const std::exception& e) {
+        throw exceptions::syntax_exception(
+            format("Invalid integer value {} for {}", *level, COMPRESSION_LEVEL));
+    }
+
+    auto min_level = ZSTD_minCLevel();
+    auto max_level = ZSTD_maxCLevel();
+    if (min_level > compression_level || compression_level > max_level) {
+        throw exceptions::configuration_exception(
+            format("{} must be between {} and {}, got {}", COMPRESSION_LEVEL, min_level, max_level, compression_level));
+    }
+    return compression_level;
+}
 
 class zstd_processor : public compressor {
-    int _compression_level = 3;
+    int _compression_level;
 
     // Manages memory for the compression context.
     std::unique_ptr<char[], free_deleter> _cctx_raw;
@@ -45,23 +85,8 @@ class zstd_processor : public compressor {
 };
 
 zstd_processor::zstd_processor(const opt_getter& opts)
-    : compressor(COMPRESSOR_NAME) {
-    auto level = opts(COMPRESSION_LEVEL);
-    if (level) {
-        try {
-            _compression_level = std::stoi(*level);
-        } catch (const std::exception& e) {
-            throw exceptions::syntax_exception(
-                format("Invalid integer value {} for {}", *level, COMPRESSION_LEVEL));
-        }
-
-        auto min_level = ZSTD_minCLevel();
-        auto max_level = ZSTD_maxCLevel();
-        if (min_level > _compression_level || _compression_level > max_level) {
-            throw exceptions::configuration_exception(
-                format("{} must be between {} and {}, got {}", COMPRESSION_LEVEL, min_level, max_level, _compression_level));
-        }
-    }
+    : compressor(COMPRESSOR_NAME)
+    , _compression_level(parse_compression_level(opts)) {
 
     auto chunk_len_kb = opts(compression_parameters::CHUNK_LENGTH_KB);
     if (!chunk_len_kb) {
@@ -121,3 +146,213 @@ std::map<sstring, sstring> zstd_processor::options() const {
 
 static const class_registrator<compressor, zstd_processor, const compressor::opt_getter&>
     registrator(COMPRESSOR_NAME);
+
+// A trained zstd dictionary, digested for both compression and decompression.
+//
+// Dictionaries are immutable once created, and digesting one is expensive, so
+// they are cached per shard and shared by all compressors using the same
+// dictionary (e.g. all readers of a given sstable).
+class zstd_dictionary : public enable_lw_shared_from_this<zstd_dictionary>, public weakly_referencable<zstd_dictionary> {
+    bytes _raw;
+    unsigned _id;
+    std::unique_ptr<ZSTD_CDict, decltype(&ZSTD_freeCDict)> _cdict;
+    std::unique_ptr<ZSTD_DDict, decltype(&ZSTD_freeDDict)> _ddict;
+
+    using cache_type = std::unordered_multimap<unsigned, weak_ptr<zstd_dictionary>>;
+    static thread_local cache_type _cache;
+public:
+    zstd_dictionary(bytes_view raw, int compression_level)
+        : _raw(raw)
+        , _id(ZSTD_getDictID_fromDict(_raw.data(), _raw.size()))
+        , _cdict(ZSTD_createCDict(_raw.data(), _raw.size(), compression_level), ZSTD_freeCDict)
+        , _ddict(ZSTD_createDDict(_raw.data(), _raw.size()), ZSTD_freeDDict) {
+        if (!_cdict || !_ddict) {
+            throw std::runtime_error("Unable to digest ZSTD dictionary");
+        }
+    }
+    ~zstd_dictionary() {
+        auto [first, last] = _cache.equal_range(_id);
+        for (auto it = first; it != last; ++it) {
+            if (it->second.get() == this) {
+                _cache.erase(it);
+                break;
+            }
+        }
+    }
+
+    const ZSTD_CDict* cdict() const noexcept { return _cdict.get(); }
+    const ZSTD_DDict* ddict() const noexcept { return _ddict.get(); }
+
+    // Returns the dictionary cached on this shard, digesting it if needed.
+    // The compression level is baked into the digested compression dictionary,
+    // but all compressors sharing a dictionary were created with the same options.
+    static lw_shared_ptr<zstd_dictionary> get(bytes_view raw, int compression_level) {
+        auto id = ZSTD_getDictID_fromDict(raw.data(), raw.size());
+        auto [first, last] = _cache.equal_range(id);
+        for (auto it = first; it != last; ++it) {
+            if (it->second && bytes_view(it->second->_raw) == raw) {
+                return it->second->shared_from_this();
+            }
+        }
+        auto dict = make_lw_shared<zstd_dictionary>(raw, compression_level);
+        _cache.emplace(id, dict->weak_from_this());
+        return dict;
+    }
+};
+
+thread_local zstd_dictionary::cache_type zstd_dictionary::_cache;
+
+// Same as zstd_processor, but compresses each chunk using a dictionary
+// trained on a sample of the data written to the sstable. Small chunks of
+// small rows compress poorly when compressed cold, but share a lot of
+// structure which the dictionary captures.
+//
+// Compression and decompression only happen on the owning shard, and never
+// across a preemption point, so all instances on a shard share the same
+// contexts.
+class zstd_dict_processor : public compressor {
+    int _compression_level;
+    size_t _dictionary_size;
+    lw_shared_ptr<zstd_dictionary> _dict;
+
+    static ZSTD_CCtx* local_cctx() {
+        static thread_local std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> cctx(ZSTD_createCCtx(), ZSTD_freeCCtx);
+        return cctx.get();
+    }
+    static ZSTD_DCtx* local_dctx() {
+        static thread_local std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> dctx(ZSTD_createDCtx(), ZSTD_freeDCtx);
+        return dctx.get();
+    }
+public:
+    zstd_dict_processor(const opt_getter&);
+    zstd_dict_processor(int compression_level, size_t dictionary_size, lw_shared_ptr<zstd_dictionary> dict)
+        : compressor(DICT_COMPRESSOR_NAME)
+        , _compression_level(compression_level)
+        , _dictionary_size(dictionary_size)
+        , _dict(std::move(dict))
+    {}
+
+    size_t uncompress(const char* input, size_t input_len, char* output,
+                    size_t output_len) const override;
+    size_t compress(const char* input, size_t input_len, char* output,
+                    size_t output_len) const override;
+    size_t compress_max_size(size_t input_len) const override;
+
+    std::set<sstring> option_names() const override;
+    std::map<sstring, sstring> options() const override;
+
+    bool uses_dictionary() const override;
+    size_t dictionary_training_size() const override;
+    future<bytes> train_dictionary(const std::vector<bytes_view>& samples) const override;
+    shared_ptr<compressor> with_dictionary(bytes_view dictionary) const override;
+};
+
+zstd_dict_processor::zstd_dict_processor(const opt_getter& opts)
+    : compressor(DICT_COMPRESSOR_NAME)
+    , _compression_level(parse_compression_level(opts))
+    , _dictionary_size(DEFAULT_DICTIONARY_SIZE) {
+    auto size_kb = opts(DICTIONARY_SIZE_IN_KB);
+    if (size_kb) {
+        int size;
+        try {
+            size = std::stoi(*size_kb);
+        } catch (const std::exception& e) {
+            throw exceptions::syntax_exception(
+                format("Invalid integer value {} for {}", *size_kb, DICTIONARY_SIZE_IN_KB));
+        }
+        if (size <= 0 || size > 1024) {
+            throw exceptions::configuration_exception(
+                format("{} must be between 1 and 1024, got {}", DICTIONARY_SIZE_IN_KB, size));
+        }
+        _dictionary_size = size * 1024;
+    }
+}
+
+size_t zstd_dict_processor::uncompress(const char* input, size_t input_len, char* output, size_t output_len) const {
+    auto ret = _dict
+        ? ZSTD_decompress_usingDDict(local_dctx(), output, output_len, input, input_len, _dict->ddict())
+        : ZSTD_decompressDCtx(local_dctx(), output, output_len, input, input_len);
+    if (ZSTD_isError(ret)) {
+        throw std::runtime_error( format("ZSTD decompression failure: {}", ZSTD_getErrorName(ret)));
+    }
+    return ret;
+}
+
+size_t zstd_dict_processor::compress(const char* input, size_t input_len, char* output, size_t output_len) const {
+    auto ret = _dict
+        ? ZSTD_compress_usingCDict(local_cctx(), output, output_len, input, input_len, _dict->cdict())
+        : ZSTD_compressCCtx(local_cctx(), output, output_len, input, input_len, _compression_level);
+    if (ZSTD_isError(ret)) {
+        throw std::runtime_error( format("ZSTD compression failure: {}", ZSTD_getErrorName(ret)));
+    }
+    return ret;
+}
+
+size_t zstd_dict_processor::compress_max_size(size_t input_len) const {
+    return ZSTD_compressBound(input_len);
+}
+
+std::set<sstring> zstd_dict_processor::option_names() const {
+    return {COMPRESSION_LEVEL, DICTIONARY_SIZE_IN_KB};
+}
+
+std::map<sstring, sstring> zstd_dict_processor::options() const {
+    return {
+        {COMPRESSION_LEVEL, std::to_string(_compression_level)},
+        {DICTIONARY_SIZE_IN_KB, std::to_string(_dictionary_size / 1024)},
+    };
+}
+
+bool zstd_dict_processor::uses_dictionary() const {
+    return true;
+}
+
+size_t zstd_dict_processor::dictionary_training_size() const {
+    return std::min(_dictionary_size * DICTIONARY_SAMPLE_RATIO, MAX_DICTIONARY_TRAINING_SIZE);
+}
+
+// Training takes hundreds of milliseconds for a few megabytes of samples,
+// and can't be preempted, so it runs on a thread of its own, shared by all
+// the shards.
+static utils::alien_worker& dictionary_trainer() {
+    static utils::alien_worker worker(zstd_logger, 10);
+    return worker;
+}
+
+future<bytes> zstd_dict_processor::train_dictionary(const std::vector<bytes_view>& samples) const {
+    if (samples.empty()) {
+        return make_ready_future<bytes>();
+    }
+    return dictionary_trainer().submit([&samples, dictionary_size = _dictionary_size] {
+        size_t total_size = 0;
+        for (auto s : samples) {
+            total_size += s.size();
+        }
+        bytes samples_buffer(bytes::initialized_later{}, total_size);
+        std::vector<size_t> sample_sizes;
+        sample_sizes.reserve(samples.size());
+        auto out = samples_buffer.begin();
+        for (auto s : samples) {
+            out = std::copy(s.begin(), s.end(), out);
+            sample_sizes.push_back(s.size());
+        }
+
+        bytes dict(bytes::initialized_later{}, dictionary_size);
+        auto ret = ZDICT_trainFromBuffer(dict.data(), dict.size(), samples_buffer.data(), sample_sizes.data(), sample_sizes.size());
+        if (ZDICT_isError(ret)) {
+            // Typically not enough samples, like for tiny sstables, which
+            // don't benefit from a dictionary anyway.
+            return bytes();
+        }
+        dict.resize(ret);
+        return dict;
+    });
+}
+
+shared_ptr<compressor> zstd_dict_processor::with_dictionary(bytes_view dictionary) const {
+    auto dict = dictionary.empty() ? nullptr : zstd_dictionary::get(dictionary, _compression_level);
+    return ::make_shared<zstd_dict_processor>(_compression_level, _dictionary_size, std::move(dict));
+}
+
+static const class_registrator<compressor, zstd_dict_processor, const compressor::opt_getter&>
+    dict_registrator(DICT_COMPRESSOR_NAME);